@@ -36,9 +36,11 @@
 
 %{
     #include "libdnf5/logger/memory_buffer_logger.hpp"
+    #include "libdnf5/base/span_recorder.hpp"
     #include "libdnf5/base/base.hpp"
     #include "libdnf5/base/solver_problems.hpp"
     #include "libdnf5/base/log_event.hpp"
+    #include "libdnf5/base/resolve_stats.hpp"
     #include "libdnf5/base/transaction.hpp"
     #include "libdnf5/base/transaction_package.hpp"
     #include "libdnf5/base/goal.hpp"
@@ -47,15 +49,19 @@
 
 #define CV __perl_CV
 
-%template(BaseWeakPtr) libdnf5::WeakPtr<libdnf5::Base, false>;
+%template(BaseWeakPtr) libdnf5::GenerationWeakPtr<libdnf5::Base>;
 %template(VarsWeakPtr) libdnf5::WeakPtr<libdnf5::Vars, false>;
 
+%ignore libdnf5::base::SpanRecorder::Scope;
+%include "libdnf5/base/span_recorder.hpp"
 %include "libdnf5/base/base.hpp"
 
 %include "libdnf5/base/solver_problems.hpp"
 %include "libdnf5/base/log_event.hpp"
+%include "libdnf5/base/resolve_stats.hpp"
 
 %ignore libdnf5::base::TransactionError;
+%ignore libdnf5::base::Transaction::get_transaction_packages_view;
 %include "libdnf5/base/transaction.hpp"
 
 %template(VectorLogEvent) std::vector<libdnf5::base::LogEvent>;
@@ -37,6 +37,11 @@
         return reinterpret_cast<intptr_t>($self->get());
     }
 }
+%extend libdnf5::GenerationWeakPtr {
+    intptr_t __hash__() const {
+        return reinterpret_cast<intptr_t>($self->get());
+    }
+}
 #endif
 
 // Cannot use %include <catch_error.i> here, SWIG includes each file only once,
@@ -120,6 +125,35 @@ class Iterator:
             value = self.cur.value()
             self.cur.next()
             return value
+
+
+class ChunkedIterator:
+    # Number of items fetched from the iterated container by one call
+    CHUNK_SIZE = 1024
+
+    def __init__(self, container, begin, end):
+        # Store a reference to the iterated container to prevent the Python
+        # gargabe collector from freeing the container from memory.
+        self.container = container
+
+        self.cur = begin
+        self.end = end
+        self.chunk = iter(())
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        value = next(self.chunk, None)
+        if value is None:
+            # The iterator returns the items of the next chunk and moves behind them, the items are then
+            # returned from the chunk without calling the library
+            chunk = self.cur.next_chunk(self.end, self.CHUNK_SIZE)
+            if not chunk:
+                raise StopIteration
+            self.chunk = iter(chunk)
+            value = next(self.chunk)
+        return value
 %}
 #endif
 
@@ -134,6 +168,18 @@ del ClassName##__iter__
 #endif
 %enddef
 
+// The iterator of the ClassName container must have the `next_chunk(end, max_count)` method
+%define add_chunked_iterator(ClassName)
+#if defined(SWIGPYTHON)
+%pythoncode %{
+def ClassName##__iter__(self):
+    return common.ChunkedIterator(self, self.begin(), self.end())
+ClassName.__iter__ = ClassName##__iter__
+del ClassName##__iter__
+%}
+#endif
+%enddef
+
 
 %{
     #include "libdnf5/common/sack/query.hpp"
@@ -33,6 +33,7 @@
     #include "libdnf5/repo/config_repo.hpp"
     #include "libdnf5/repo/download_callbacks.hpp"
     #include "libdnf5/repo/file_downloader.hpp"
+    #include "libdnf5/repo/memory_usage.hpp"
     #include "libdnf5/repo/package_downloader.hpp"
     #include "libdnf5/repo/repo.hpp"
     #include "libdnf5/repo/repo_cache.hpp"
@@ -54,7 +55,11 @@ wrap_unique_ptr(DownloadCallbacksUniquePtr, libdnf5::repo::DownloadCallbacks);
 %ignore FileDownloadError;
 %include "libdnf5/repo/file_downloader.hpp"
 
+%include "libdnf5/repo/memory_usage.hpp"
+%template(VectorRepoMemoryUsage) std::vector<libdnf5::repo::RepoMemoryUsage>;
+
 %ignore PackageDownloadError;
+%ignore libdnf5::repo::PackageDownloader::set_package_downloaded_callback;
 %include "libdnf5/repo/package_downloader.hpp"
 
 %ignore RepoCacheError;
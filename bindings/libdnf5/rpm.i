@@ -33,6 +33,7 @@
     #include "libdnf5/rpm/checksum.hpp"
     #include "libdnf5/rpm/nevra.hpp"
     #include "libdnf5/rpm/package.hpp"
+    #include "libdnf5/rpm/package_columns.hpp"
     #include "libdnf5/rpm/package_query.hpp"
     #include "libdnf5/rpm/package_sack.hpp"
     #include "libdnf5/rpm/package_set.hpp"
@@ -49,6 +50,8 @@
 %include "libdnf5/rpm/checksum.hpp"
 
 %ignore NevraIncorrectInputError;
+%ignore libdnf5::rpm::NevraView;
+%ignore libdnf5::rpm::NevraParser;
 %include "libdnf5/rpm/nevra.hpp"
 
 %template(VectorNevra) std::vector<libdnf5::rpm::Nevra>;
@@ -64,6 +67,34 @@
 %rename(value) libdnf5::rpm::ReldepListIterator::operator*();
 %include "libdnf5/rpm/reldep_list_iterator.hpp"
 %include "libdnf5/rpm/reldep_list.hpp"
+
+%template(VectorReldep) std::vector<libdnf5::rpm::Reldep>;
+
+%extend libdnf5::rpm::ReldepListIterator {
+    // Returns up to `max_count` reldeps starting at the iterator and moves the iterator behind them.
+    // An empty result means the `end` was reached.
+    std::vector<libdnf5::rpm::Reldep> next_chunk(const libdnf5::rpm::ReldepListIterator & end, std::size_t max_count) {
+        std::vector<libdnf5::rpm::Reldep> chunk;
+        chunk.reserve(max_count);
+        for (; chunk.size() < max_count && *$self != end; ++*$self) {
+            chunk.push_back(**$self);
+        }
+        return chunk;
+    }
+}
+// The views into the pool strings are of no use in the bindings, the strings are copied anyway
+%ignore libdnf5::rpm::Package::get_name_view;
+%ignore libdnf5::rpm::Package::get_epoch_view;
+%ignore libdnf5::rpm::Package::get_version_view;
+%ignore libdnf5::rpm::Package::get_release_view;
+%ignore libdnf5::rpm::Package::get_arch_view;
+%ignore libdnf5::rpm::Package::get_evr_view;
+%ignore libdnf5::rpm::Package::get_packager_view;
+%ignore libdnf5::rpm::Package::get_vendor_view;
+%ignore libdnf5::rpm::Package::get_url_view;
+%ignore libdnf5::rpm::Package::get_summary_view;
+%ignore libdnf5::rpm::Package::get_description_view;
+%ignore libdnf5::rpm::Package::for_each_file;
 %include "libdnf5/rpm/package.hpp"
 
 %template(VectorPackage) std::vector<libdnf5::rpm::Package>;
@@ -74,13 +105,57 @@
 %rename(next) libdnf5::rpm::PackageSetIterator::operator++();
 %rename(value) libdnf5::rpm::PackageSetIterator::operator*();
 %include "libdnf5/rpm/package_set_iterator.hpp"
+%extend libdnf5::rpm::PackageSetIterator {
+    // Returns up to `max_count` packages starting at the iterator and moves the iterator behind them.
+    // An empty result means the `end` was reached.
+    std::vector<libdnf5::rpm::Package> next_chunk(const libdnf5::rpm::PackageSetIterator & end, std::size_t max_count) {
+        std::vector<libdnf5::rpm::Package> chunk;
+        chunk.reserve(max_count);
+        for (; chunk.size() < max_count && *$self != end; ++*$self) {
+            chunk.push_back(**$self);
+        }
+        return chunk;
+    }
+}
+// The columns of string views and of Ids are replaced by copies, one call returns a whole column as a sequence
+// of str or int
+%ignore libdnf5::rpm::PackageColumns::get_ids;
+%ignore libdnf5::rpm::PackageColumns::get_strings;
+%ignore libdnf5::rpm::PackageColumns::get_numbers;
+%ignore libdnf5::rpm::PackageColumns::get_reldeps;
+%ignore libdnf5::rpm::PackageColumns::get_reldep_offsets;
+%ignore libdnf5::rpm::PackageColumns::operator=;
+%include "libdnf5/rpm/package_columns.hpp"
+
+%template(VectorPackageAttribute) std::vector<libdnf5::rpm::PackageAttribute>;
+%template(VectorInt) std::vector<int>;
+%template(VectorULongLong) std::vector<unsigned long long>;
+
+%extend libdnf5::rpm::PackageColumns {
+    std::vector<int> get_id_column() const {
+        std::vector<int> ids;
+        ids.reserve($self->size());
+        for (auto id : $self->get_ids()) {
+            ids.push_back(id.id);
+        }
+        return ids;
+    }
+    std::vector<std::string> get_string_column(libdnf5::rpm::PackageAttribute attribute) const {
+        const auto & column = $self->get_strings(attribute);
+        return std::vector<std::string>(column.begin(), column.end());
+    }
+    std::vector<unsigned long long> get_number_column(libdnf5::rpm::PackageAttribute attribute) const {
+        return $self->get_numbers(attribute);
+    }
+}
+
 %include "libdnf5/rpm/package_set.hpp"
 
 %ignore libdnf5::rpm::PackageQuery::PackageQuery(PackageQuery && src);
 %include "libdnf5/rpm/package_query.hpp"
 
-add_iterator(PackageSet)
-add_iterator(ReldepList)
+add_chunked_iterator(PackageSet)
+add_chunked_iterator(ReldepList)
 
 %feature("director") TransactionCallbacks;
 %include "libdnf5/rpm/transaction_callbacks.hpp"
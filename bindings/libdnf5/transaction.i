@@ -37,6 +37,7 @@
     #include "libdnf5/transaction/comps_group.hpp"
     #include "libdnf5/transaction/comps_environment.hpp"
     #include "libdnf5/transaction/rpm_package.hpp"
+    #include "libdnf5/transaction/transaction_timing.hpp"
 
     #include "libdnf5/transaction/transaction_history.hpp"
 
@@ -56,6 +57,7 @@
 %include "libdnf5/transaction/comps_group.hpp"
 %include "libdnf5/transaction/comps_environment.hpp"
 %include "libdnf5/transaction/rpm_package.hpp"
+%include "libdnf5/transaction/transaction_timing.hpp"
 
 %include "libdnf5/transaction/transaction_history.hpp"
 %template(TransactionHistoryWeakPtr) libdnf5::WeakPtr<libdnf5::transaction::TransactionHistory, false>;
@@ -65,3 +67,4 @@
 
 %template(VectorTransaction) std::vector<libdnf5::transaction::Transaction>;
 %template(VectorTransactionPackage) std::vector<libdnf5::transaction::Package>;
+%template(VectorTransactionTiming) std::vector<libdnf5::transaction::TransactionTiming>;
@@ -22,12 +22,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "utils/string.hpp"
 
 #include <dnf5/shared_options.hpp>
+#include <fmt/format.h>
 #include <libdnf5-cli/exception.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
 #include <rpm/rpmbuild.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 namespace dnf5 {
 
@@ -136,10 +140,13 @@ bool BuildDepCommand::add_from_spec_file(
 }
 
 bool BuildDepCommand::add_from_srpm_file(
-    std::set<std::string> & install_specs, std::set<std::string> & conflicts_specs, const char * srpm_file_name) {
+    std::set<std::string> & install_specs,
+    std::set<std::string> & conflicts_specs,
+    const char * srpm_file_name,
+    std::string & error) {
     auto fd = Fopen(srpm_file_name, "r");
     if (fd == NULL || Ferror(fd)) {
-        std::cerr << "Failed to open \"" << srpm_file_name << "\": " << Fstrerror(fd) << std::endl;
+        error = fmt::format("Failed to open \"{}\": {}", srpm_file_name, Fstrerror(fd));
         if (fd) {
             Fclose(fd);
             fd = nullptr;
@@ -170,7 +177,7 @@ bool BuildDepCommand::add_from_srpm_file(
         }
         rpmdsFree(conflicts_set);
     } else {
-        std::cerr << "Failed to read rpm file \"" << srpm_file_name << "\"." << std::endl;
+        error = fmt::format("Failed to read rpm file \"{}\".", srpm_file_name);
     }
 
     headerFree(header);
@@ -235,8 +242,42 @@ void BuildDepCommand::run() {
         }
     }
 
-    for (const auto & srpm : srpm_file_paths) {
-        parse_ok &= add_from_srpm_file(install_specs, conflicts_specs, srpm.c_str());
+    // the source rpm files are read concurrently, the spec files above share the global rpm macro context
+    struct SrpmDependencies {
+        std::set<std::string> install_specs;
+        std::set<std::string> conflicts_specs;
+        std::string error;
+        bool ok{true};
+    };
+    std::vector<SrpmDependencies> srpms_dependencies(srpm_file_paths.size());
+    std::atomic<std::size_t> next_idx{0};
+    auto read_srpms = [&]() {
+        for (auto idx = next_idx++; idx < srpms_dependencies.size(); idx = next_idx++) {
+            auto & dependencies = srpms_dependencies[idx];
+            dependencies.ok = add_from_srpm_file(
+                dependencies.install_specs,
+                dependencies.conflicts_specs,
+                srpm_file_paths[idx].c_str(),
+                dependencies.error);
+        }
+    };
+    auto num_workers = std::min<std::size_t>(
+        srpms_dependencies.size(), std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(read_srpms);
+    }
+    for (auto & worker : workers) {
+        worker.join();
+    }
+    // the dependencies shared by the inputs are merged into one goal job
+    for (auto & dependencies : srpms_dependencies) {
+        if (!dependencies.error.empty()) {
+            std::cerr << dependencies.error << std::endl;
+        }
+        parse_ok &= dependencies.ok;
+        install_specs.merge(dependencies.install_specs);
+        conflicts_specs.merge(dependencies.conflicts_specs);
     }
 
     for (const auto & pkg : pkg_specs) {
@@ -45,8 +45,13 @@ private:
     void parse_builddep_specs(int specs_count, const char * const specs[]);
     bool add_from_spec_file(
         std::set<std::string> & install_specs, std::set<std::string> & conflicts_specs, const char * spec_file_name);
-    bool add_from_srpm_file(
-        std::set<std::string> & install_specs, std::set<std::string> & conflicts_specs, const char * srpm_file_name);
+    /// Reads the dependencies of the source rpm file, it does not access the command state and can run concurrently.
+    /// The errors are stored in `error` instead of printing them.
+    static bool add_from_srpm_file(
+        std::set<std::string> & install_specs,
+        std::set<std::string> & conflicts_specs,
+        const char * srpm_file_name,
+        std::string & error);
     bool add_from_pkg(
         std::set<std::string> & install_specs, std::set<std::string> & conflicts_specs, const std::string & pkg_spec);
 
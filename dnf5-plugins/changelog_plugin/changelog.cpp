@@ -110,8 +110,15 @@ void ChangelogCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
-    context.base.get_config().get_optional_metadata_types_option().add(
-        libdnf5::Option::Priority::RUNTIME, libdnf5::OPTIONAL_METADATA_TYPES);
+    context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_OTHER});
+    // Only the repositories of the listed packages need their changelogs loaded
+    context.base.get_config().get_load_other_on_demand_option().set(libdnf5::Option::Priority::RUNTIME, true);
+    if (upgrades_option->get_value()) {
+        // Changelogs of all the installed versions are compared, load them with the system repo at once
+        // instead of reading them from the rpmdb package by package.
+        context.base.get_config().get_load_system_repo_changelogs_option().set(
+            libdnf5::Option::Priority::RUNTIME, true);
+    }
 }
 
 void ChangelogCommand::run() {
@@ -20,11 +20,72 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "download_file.hpp"
 
 #include <libdnf5/repo/file_downloader.hpp>
+#include <libdnf5/repo/repo_cache.hpp>
 
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+/// Subdirectory of the cachedir with the cached Copr API responses
+constexpr const char * RESPONSE_CACHE_DIR = "copr";
+
+std::filesystem::path get_response_cache_path(const std::filesystem::path & cache_dir, const std::string & url) {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(url) << ".json";
+    return cache_dir / name.str();
+}
+
+/// The cached response is used until it is older than "metadata_expire" or the cache is expired by "--refresh",
+/// which marks all the directories in the cachedir. With "cacheonly", any cached response is used.
+bool is_response_cache_usable(
+    libdnf5::Base & base, const std::filesystem::path & cache_dir, const std::filesystem::path & path) {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto & config = base.get_config();
+    if (config.get_cacheonly_option().get_value() != "none") {
+        return true;
+    }
+    libdnf5::repo::RepoCache cache(base.get_weak_ptr(), cache_dir);
+    if (cache.is_attribute(libdnf5::repo::RepoCache::ATTRIBUTE_EXPIRED)) {
+        return false;
+    }
+    auto metadata_expire = config.get_metadata_expire_option().get_value();
+    if (metadata_expire < 0) {
+        return true;
+    }
+    return std::filesystem::file_time_type::clock::now() - mtime < std::chrono::seconds(metadata_expire);
+}
+
+}  // namespace
 
 void download_file(libdnf5::Base & base, const std::string & url, const std::filesystem::path & path) {
     libdnf5::repo::FileDownloader downloader(base);
     downloader.add(url, path);
     downloader.download();
 }
+
+std::filesystem::path download_file_cached(libdnf5::Base & base, const std::string & url) {
+    std::filesystem::path cache_dir = base.get_config().get_cachedir_option().get_value();
+    cache_dir /= RESPONSE_CACHE_DIR;
+    auto path = get_response_cache_path(cache_dir, url);
+    if (is_response_cache_usable(base, cache_dir, path)) {
+        return path;
+    }
+
+    std::filesystem::create_directories(cache_dir);
+    auto part_path = path;
+    part_path += ".part";
+    download_file(base, url, part_path);
+    std::filesystem::rename(part_path, path);
+
+    libdnf5::repo::RepoCache cache(base.get_weak_ptr(), cache_dir);
+    cache.remove_attribute(libdnf5::repo::RepoCache::ATTRIBUTE_EXPIRED);
+    return path;
+}
@@ -26,4 +26,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 void download_file(libdnf5::Base & base, const std::string & url, const std::filesystem::path & path);
 
+/// Returns the path of the response to `url` cached in the cachedir, the response is downloaded when the cached one
+/// is missing or expired.
+std::filesystem::path download_file_cached(libdnf5::Base & base, const std::string & url);
+
 #endif  // DNF5_COMMANDS_COPR_DOWNLOAD_FILE_HPP
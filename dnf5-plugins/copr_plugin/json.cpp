@@ -20,18 +20,43 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "json.hpp"
 
 #include "download_file.hpp"
-#include "tempfile.hpp"
 
+#include <filesystem>
 #include <fstream>
-#include <iostream>
+
+namespace {
+
+/// Parses the JSON document in the file at `path` in chunks, without reading the whole file in memory first.
+/// Returns nullptr if the file cannot be read or parsed.
+struct json_object * parse_json_file(const std::filesystem::path & path) {
+    std::ifstream file(path, std::ios::binary);
+    struct json_tokener * tokener = json_tokener_new();
+    struct json_object * object = nullptr;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        object = json_tokener_parse_ex(tokener, buffer, static_cast<int>(file.gcount()));
+        if (json_tokener_get_error(tokener) != json_tokener_continue) {
+            break;
+        }
+    }
+    if (json_tokener_get_error(tokener) != json_tokener_success) {
+        json_object_put(object);
+        object = nullptr;
+    }
+    json_tokener_free(tokener);
+    return object;
+}
+
+}  // namespace
 
 Json::Json(libdnf5::Base & base, const std::string & url) {
-    auto temp_file = TempFile();
-    download_file(base, url, temp_file.path);
-    std::ifstream file(temp_file.path);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    root = json_tokener_parse(buffer.str().c_str());
+    auto path = download_file_cached(base, url);
+    root = parse_json_file(path);
+    if (!root) {
+        // Do not keep a damaged response in the cache
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
     this->cleanup = true;
 }
 
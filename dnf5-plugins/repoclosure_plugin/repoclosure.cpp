@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/conf/const.hpp>
 #include <libdnf5/rpm/package.hpp>
 #include <libdnf5/rpm/package_query.hpp>
+#include <libdnf5/rpm/reldep_span.hpp>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
 #include <libdnf5/utils/format.hpp>
 
@@ -99,8 +100,7 @@ void RepoclosureCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(false);
     // filelists needed because there are packages in repos with file requirements
-    context.base.get_config().get_optional_metadata_types_option().add_item(
-        libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_FILELISTS);
+    context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_FILELISTS});
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
 }
 
@@ -164,20 +164,20 @@ void RepoclosureCommand::run() {
     std::vector<std::pair<libdnf5::rpm::Package, std::vector<std::string>>> unresolved_packages;
     for (const auto & pkg : to_check_query) {
         std::vector<std::string> unsatisfied;
-        for (const auto & reldep : pkg.get_requires()) {
-            int reldep_id = reldep.get_id().id;
+        // walks the requires in the pool without creating a Reldep for each of them
+        libdnf5::rpm::ReldepSpan requires_span(pkg, libdnf5::rpm::PackageAttribute::REQUIRES);
+        for (std::size_t idx = 0; idx < requires_span.size(); ++idx) {
+            int reldep_id = requires_span.get_id(idx).id;
             auto resolved_it = resolved.find(reldep_id);
             bool satisfied;
             if (resolved_it == resolved.end()) {
-                libdnf5::rpm::PackageQuery reldep_q(available_query);
-                reldep_q.filter_provides(reldep);
-                satisfied = !reldep_q.empty();
+                satisfied = available_query.is_provided(requires_span.get_id(idx));
                 resolved.emplace(reldep_id, satisfied);
             } else {
                 satisfied = resolved_it->second;
             }
             if (!satisfied) {
-                unsatisfied.emplace_back(reldep.to_string());
+                unsatisfied.emplace_back(requires_span.to_string(idx));
             }
         }
         if (!unsatisfied.empty()) {
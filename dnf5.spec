@@ -60,6 +60,7 @@ Provides:       dnf5-command(advisory)
 Provides:       dnf5-command(clean)
 Provides:       dnf5-command(download)
 Provides:       dnf5-command(makecache)
+Provides:       dnf5-command(shell)
 
 
 # ========== build options ==========
@@ -122,6 +123,7 @@ BuildRequires:  pkgconfig(libcrypto)
 BuildRequires:  pkgconfig(librepo) >= %{librepo_version}
 BuildRequires:  pkgconfig(libsolv) >= %{libsolv_version}
 BuildRequires:  pkgconfig(libsolvext) >= %{libsolv_version}
+BuildRequires:  pkgconfig(libzstd)
 BuildRequires:  pkgconfig(rpm) >= 4.17.0
 BuildRequires:  pkgconfig(sqlite3) >= %{sqlite_version}
 BuildRequires:  toml11-static
@@ -267,6 +269,7 @@ It supports RPM packages, modulemd modules, and comps groups & environments.
 %{_mandir}/man8/dnf5-repo.8.*
 %{_mandir}/man8/dnf5-repoquery.8.*
 %{_mandir}/man8/dnf5-search.8.*
+%{_mandir}/man8/dnf5-shell.8.*
 %{_mandir}/man8/dnf5-swap.8.*
 %{_mandir}/man8/dnf5-upgrade.8.*
 %{_mandir}/man7/dnf5-comps.7.*
@@ -617,6 +620,7 @@ Core DNF5 plugins that enhance dnf5 with builddep, changelog, copr, and repoclos
 
 %files -n dnf5-plugins
 %{_libdir}/dnf5/plugins/*.so
+%{_libdir}/dnf5/plugins/*.manifest
 %{_mandir}/man8/dnf5-builddep.8.*
 %{_mandir}/man8/dnf5-copr.8.*
 %{_mandir}/man8/dnf5-repoclosure.8.*
@@ -23,10 +23,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5-cli/output/changelogs.hpp>
 #include <libdnf5-cli/output/package_list_sections.hpp>
 #include <libdnf5/conf/const.hpp>
+#include <libdnf5/repo/repo_sack.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
 
 #include <iostream>
+#include <string>
 
 namespace dnf5 {
 
@@ -79,12 +81,14 @@ void CheckUpgradeCommand::set_argument_parser() {
 
 void CheckUpgradeCommand::configure() {
     auto & context = get_context();
+    // Upgrades are found by name and architecture of the packages from primary metadata, the other metadata
+    // (filelists, comps) are not loaded. Updateinfo and changelogs are loaded only when an option needs them.
+    context.base.get_repo_sack()->require_optional_metadata_types({});
     context.update_repo_metadata_from_specs(pkg_specs);
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
     if (changelogs->get_value()) {
-        context.base.get_config().get_optional_metadata_types_option().add(
-            libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_OTHER);
+        context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_OTHER});
     }
     context.update_repo_metadata_from_advisory_options(
         advisory_name->get_value(),
@@ -95,6 +99,12 @@ void CheckUpgradeCommand::configure() {
         advisory_severity->get_value(),
         advisory_bz->get_value(),
         advisory_cve->get_value());
+
+    // The installed packages are read from the libsolv cache of the rpmdb unless it is disabled by configuration
+    auto & system_repo_cache = context.base.get_config().get_system_repo_cache_option();
+    if (system_repo_cache.get_priority() == libdnf5::Option::Priority::DEFAULT) {
+        system_repo_cache.set(libdnf5::Option::Priority::RUNTIME, true);
+    }
 }
 
 std::unique_ptr<libdnf5::cli::output::PackageListSections> CheckUpgradeCommand::create_output() {
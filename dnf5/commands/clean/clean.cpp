@@ -25,8 +25,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/utils/bgettext/bgettext-lib.h>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 
 namespace fs = std::filesystem;
@@ -130,43 +135,74 @@ void CleanCommand::run() {
     fs::path cachedir{ctx.base.get_config().get_cachedir_option().get_value()};
 
     std::error_code ec;
-    libdnf5::repo::RepoCache::RemoveStatistics statistics{};
+    std::vector<fs::path> repo_cache_dirs;
     for (const auto & dir_entry : std::filesystem::directory_iterator(cachedir, ec)) {
-        if (!dir_entry.is_directory()) {
-            continue;
+        if (dir_entry.is_directory()) {
+            repo_cache_dirs.push_back(dir_entry.path());
         }
-        libdnf5::repo::RepoCache cache(ctx.base.get_weak_ptr(), dir_entry.path());
+    }
 
-        try {
-            if (required_actions & CLEAN_ALL) {
-                statistics += cache.remove_all();
-                continue;
-            }
-            if (required_actions & CLEAN_METADATA) {
-                statistics += cache.remove_metadata();
-            }
-            if (required_actions & CLEAN_PACKAGES) {
-                statistics += cache.remove_packages();
-            }
-            if (required_actions & CLEAN_DBCACHE) {
-                statistics += cache.remove_solv_files();
-            }
-            if (required_actions & EXPIRE_CACHE) {
-                cache.write_attribute(libdnf5::repo::RepoCache::ATTRIBUTE_EXPIRED);
+    if (ec) {
+        throw std::runtime_error(fmt::format("Cannot iterate the cache directory: \"{}\"", cachedir.string()));
+    }
+
+    // The repository caches are cleaned concurrently, on networked storage the removal of each file costs
+    // a round-trip. The results are collected per directory and reported in the order of the directories.
+    std::vector<libdnf5::repo::RepoCache::RemoveStatistics> dirs_statistics(repo_cache_dirs.size());
+    std::vector<std::string> errors(repo_cache_dirs.size());
+    std::atomic<std::size_t> next_idx{0};
+
+    // The worker must not throw exceptions, the errors are returned to the calling thread
+    auto worker = [&]() {
+        for (auto idx = next_idx++; idx < repo_cache_dirs.size(); idx = next_idx++) {
+            libdnf5::repo::RepoCache cache(ctx.base.get_weak_ptr(), repo_cache_dirs[idx]);
+            auto & statistics = dirs_statistics[idx];
+            try {
+                if (required_actions & CLEAN_ALL) {
+                    statistics += cache.remove_all();
+                    continue;
+                }
+                if (required_actions & CLEAN_METADATA) {
+                    statistics += cache.remove_metadata();
+                }
+                if (required_actions & CLEAN_PACKAGES) {
+                    statistics += cache.remove_packages();
+                }
+                if (required_actions & CLEAN_DBCACHE) {
+                    statistics += cache.remove_solv_files();
+                }
+                if (required_actions & EXPIRE_CACHE) {
+                    cache.write_attribute(libdnf5::repo::RepoCache::ATTRIBUTE_EXPIRED);
+                }
+            } catch (const std::exception & ex) {
+                errors[idx] = ex.what();
             }
-        } catch (const std::exception & ex) {
+        }
+    };
+
+    const auto num_workers = std::min<std::size_t>(
+        repo_cache_dirs.size(), std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto & thread : workers) {
+        thread.join();
+    }
+
+    libdnf5::repo::RepoCache::RemoveStatistics statistics{};
+    for (std::size_t idx = 0; idx < repo_cache_dirs.size(); ++idx) {
+        statistics += dirs_statistics[idx];
+        if (!errors[idx].empty()) {
             std::cerr << libdnf5::utils::sformat(
                              _("Failed to cleanup repository cache in path \"{0}\": {1}"),
-                             dir_entry.path().native(),
-                             ex.what())
+                             repo_cache_dirs[idx].native(),
+                             errors[idx])
                       << std::endl;
         }
     }
 
-    if (ec) {
-        throw std::runtime_error(fmt::format("Cannot iterate the cache directory: \"{}\"", cachedir.string()));
-    }
-
     std::cout << fmt::format(
                      "Removed {} files, {} directories. {} errors occurred.",
                      statistics.files_removed,
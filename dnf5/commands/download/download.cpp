@@ -30,12 +30,32 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <map>
+#include <vector>
 
 
 namespace dnf5 {
 
 using namespace libdnf5::cli;
 
+namespace {
+
+/// Resolves the installation of the `packages` by one goal.
+libdnf5::base::Transaction resolve_install(libdnf5::Base & base, const std::vector<libdnf5::rpm::Package> & packages) {
+    libdnf5::Goal goal(base);
+    for (const auto & pkg : packages) {
+        goal.add_rpm_install(pkg, {});
+    }
+    return goal.resolve();
+}
+
+/// Returns whether the `transaction` has problems preventing the download, packages not found are ignored.
+bool has_resolve_problems(libdnf5::base::Transaction & transaction) {
+    auto problems = transaction.get_problems();
+    return problems != libdnf5::GoalProblem::NO_PROBLEM && problems != libdnf5::GoalProblem::NOT_FOUND;
+}
+
+}  // namespace
+
 void DownloadCommand::set_parent_command() {
     auto * arg_parser_parent_cmd = get_session().get_argument_parser().get_root_command();
     auto * arg_parser_this_cmd = get_argument_parser_command();
@@ -114,6 +134,7 @@ void DownloadCommand::run() {
     auto create_nevra_pkg_pair = [](const libdnf5::rpm::Package & pkg) { return std::make_pair(pkg.get_nevra(), pkg); };
 
     std::map<std::string, libdnf5::rpm::Package> download_pkgs;
+    std::vector<libdnf5::rpm::Package> matched_pkgs;
     libdnf5::rpm::PackageQuery full_pkg_query(ctx.base);
     for (auto & pattern : *patterns_to_download_options) {
         libdnf5::rpm::PackageQuery pkg_query(full_pkg_query);
@@ -124,25 +145,36 @@ void DownloadCommand::run() {
         pkg_query.filter_latest_evr();
 
         for (const auto & pkg : pkg_query) {
-            download_pkgs.insert(create_nevra_pkg_pair(pkg));
-
-            if (resolve_option->get_value()) {
-                auto goal = std::make_unique<libdnf5::Goal>(ctx.base);
-                goal->add_rpm_install(pkg, {});
-
-                auto transaction = goal->resolve();
-                auto transaction_problems = transaction.get_problems();
-                if (transaction_problems != libdnf5::GoalProblem::NO_PROBLEM) {
-                    if (transaction_problems != libdnf5::GoalProblem::NOT_FOUND) {
-                        throw GoalResolveError(transaction);
-                    }
+            if (download_pkgs.insert(create_nevra_pkg_pair(pkg)).second) {
+                matched_pkgs.push_back(pkg);
+            }
+        }
+    }
+
+    if (resolve_option->get_value() && !matched_pkgs.empty()) {
+        auto add_inbound_packages = [&](libdnf5::base::Transaction & transaction) {
+            for (const auto & tspkg : transaction.get_transaction_packages_view()) {
+                if (transaction_item_action_is_inbound(tspkg.get_action()) &&
+                    tspkg.get_package().get_repo()->get_type() != libdnf5::repo::Repo::Type::COMMANDLINE) {
+                    download_pkgs.insert(create_nevra_pkg_pair(tspkg.get_package()));
                 }
-                for (auto & tspkg : transaction.get_transaction_packages()) {
-                    if (transaction_item_action_is_inbound(tspkg.get_action()) &&
-                        tspkg.get_package().get_repo()->get_type() != libdnf5::repo::Repo::Type::COMMANDLINE) {
-                        download_pkgs.insert(create_nevra_pkg_pair(tspkg.get_package()));
-                    }
+            }
+        };
+
+        // All the matched packages are resolved by one goal. Only if they cannot be installed together
+        // (e.g. they conflict with each other), each of them is resolved by its own goal.
+        auto transaction = resolve_install(ctx.base, matched_pkgs);
+        if (!has_resolve_problems(transaction)) {
+            add_inbound_packages(transaction);
+        } else if (matched_pkgs.size() == 1) {
+            throw GoalResolveError(transaction);
+        } else {
+            for (const auto & pkg : matched_pkgs) {
+                auto pkg_transaction = resolve_install(ctx.base, {pkg});
+                if (has_resolve_problems(pkg_transaction)) {
+                    throw GoalResolveError(pkg_transaction);
                 }
+                add_inbound_packages(pkg_transaction);
             }
         }
     }
@@ -43,8 +43,7 @@ void EnvironmentInfoCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
-    context.base.get_config().get_optional_metadata_types_option().add_item(
-        libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_COMPS);
+    context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_COMPS});
 }
 
 void EnvironmentInfoCommand::run() {
@@ -42,6 +42,18 @@ public:
 };
 
 
+class TimingsOption : public libdnf5::cli::session::BoolOption {
+public:
+    explicit TimingsOption(libdnf5::cli::session::Command & command)
+        : BoolOption(
+              command,
+              "timings",
+              '\0',
+              _("Show the durations of the package installs, removals and scriptlets of the transactions."),
+              false) {}
+};
+
+
 }  // namespace dnf5
 
 
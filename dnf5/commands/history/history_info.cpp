@@ -34,6 +34,7 @@ void HistoryInfoCommand::set_argument_parser() {
 
     transaction_specs = std::make_unique<TransactionSpecArguments>(*this);
     reverse = std::make_unique<ReverseOption>(*this);
+    timings = std::make_unique<TimingsOption>(*this);
 }
 
 void HistoryInfoCommand::run() {
@@ -53,8 +54,14 @@ void HistoryInfoCommand::run() {
         std::sort(transactions.begin(), transactions.end());
     }
 
-    for (auto ts : transactions) {
+    // load the items of all the printed transactions at once
+    history.load_transaction_items(transactions);
+
+    for (auto & ts : transactions) {
         libdnf5::cli::output::print_transaction_info(ts);
+        if (timings->get_value()) {
+            libdnf5::cli::output::print_transaction_timings(ts);
+        }
         std::cout << std::endl;
     }
 }
@@ -43,16 +43,21 @@ void HistoryListCommand::run() {
     std::vector<libdnf5::transaction::Transaction> transactions;
 
     if (ts_specs.empty()) {
-        transactions = history.list_all_transactions();
+        // the transactions are ordered by the database query, the most recent first unless reversed
+        libdnf5::transaction::TransactionListFilter filter;
+        filter.descending = !reverse->get_value();
+        transactions = history.list_filtered_transactions(filter);
     } else {
         transactions = list_transactions_from_specs(history, transaction_specs->get_value());
+        if (reverse->get_value()) {
+            std::sort(transactions.begin(), transactions.end(), std::greater{});
+        } else {
+            std::sort(transactions.begin(), transactions.end());
+        }
     }
 
-    if (reverse->get_value()) {
-        std::sort(transactions.begin(), transactions.end(), std::greater{});
-    } else {
-        std::sort(transactions.begin(), transactions.end());
-    }
+    // the list prints the number of packages of each transaction, load them at once
+    history.load_transaction_items(transactions);
 
     libdnf5::cli::output::print_transaction_list(transactions);
 }
@@ -62,6 +62,14 @@ void ListCommand::set_argument_parser() {
     show_duplicates = std::make_unique<libdnf5::cli::session::BoolOption>(
         *this, "showduplicates", '\0', "Show all versions of the packages, not only the latest ones.", false);
 
+    stream = std::make_unique<libdnf5::cli::session::BoolOption>(
+        *this,
+        "stream",
+        '\0',
+        "Print the packages in blocks while they are being listed instead of all at once at the end. The widths of "
+        "the columns are computed from the first block.",
+        false);
+
     auto conflicts =
         parser.add_conflict_args_group(std::make_unique<std::vector<libdnf5::cli::ArgumentParser::Argument *>>());
 
@@ -135,6 +143,8 @@ void ListCommand::configure() {
     auto & context = get_context();
     context.set_load_available_repos(load_available);
     context.set_load_system_repo(load_system);
+    // The packages are listed from the primary metadata
+    context.base.get_repo_sack()->require_optional_metadata_types({});
 }
 
 std::unique_ptr<libdnf5::cli::output::PackageListSections> ListCommand::create_output() {
@@ -166,6 +176,9 @@ void ListCommand::run() {
     bool package_matched = false;
     // output table
     auto sections = create_output();
+    if (stream->get_value()) {
+        sections->enable_streaming();
+    }
 
     libdnf5::rpm::PackageQuery installed(base_query);
     installed.filter_installed();
@@ -63,6 +63,9 @@ private:
 
     // show all NEVRAs, not only the latest one
     std::unique_ptr<libdnf5::cli::session::BoolOption> show_duplicates{nullptr};
+
+    // print the packages while they are being listed
+    std::unique_ptr<libdnf5::cli::session::BoolOption> stream{nullptr};
 };
 
 
@@ -19,6 +19,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "makecache.hpp"
 
+#include "completion_cache.hpp"
+
 #include <dnf5/shared_options.hpp>
 #include <fmt/format.h>
 
@@ -35,8 +37,20 @@ void MakeCacheCommand::set_parent_command() {
 }
 
 void MakeCacheCommand::set_argument_parser() {
-    get_argument_parser_command()->set_description("Generate the metadata cache");
+    auto & ctx = get_context();
+    auto & parser = ctx.get_argument_parser();
+    auto & cmd = *get_argument_parser_command();
+
+    cmd.set_description("Generate the metadata cache");
     create_forcearch_option(*this);
+
+    auto background = parser.add_new_named_arg("background");
+    background->set_long_name("background");
+    background->set_description(
+        "Run with the lowest CPU and I/O priority, limited download speed and pauses under memory pressure");
+    background->set_const_value("true");
+    background->link_value(&ctx.base.get_config().get_background_mode_option());
+    cmd.register_named_arg(background);
 }
 
 void MakeCacheCommand::run() {
@@ -58,7 +72,13 @@ void MakeCacheCommand::run() {
         return;
     }
 
-    ctx.load_repos(false);
+    // The repositories are only updated, the package sack is not built. They are loaded from the fresh cache
+    // files only when the package names for completion have to be written.
+    auto num_updated = ctx.update_repos();
+    if (num_updated > 0 || is_available_completion_cache_missing(ctx)) {
+        ctx.base.get_repo_sack()->update_and_load_enabled_repos(false);
+        write_available_completion_cache(ctx);
+    }
 
     std::cout << "Metadata cache created." << std::endl;
 }
@@ -76,11 +76,13 @@ void MarkUserCommand::configure() {
 }
 
 void MarkUserCommand::run() {
-    auto goal = get_context().get_goal();
+    std::vector<std::string> specs;
+    specs.reserve(pkg_specs->size());
     for (auto & pattern : *pkg_specs) {
         auto option = dynamic_cast<libdnf5::OptionString *>(pattern.get());
-        goal->add_rpm_reason_change(option->get_value(), reason);
+        specs.push_back(option->get_value());
     }
+    get_context().get_goal()->add_rpm_reason_change(specs, reason);
 }
 
 
@@ -117,11 +119,13 @@ void MarkGroupCommand::set_argument_parser() {
 }
 
 void MarkGroupCommand::run() {
-    auto goal = get_context().get_goal();
+    std::vector<std::string> specs;
+    specs.reserve(pkg_specs->size());
     for (auto & pattern : *pkg_specs) {
         auto option = dynamic_cast<libdnf5::OptionString *>(pattern.get());
-        goal->add_rpm_reason_change(option->get_value(), reason, group_id);
+        specs.push_back(option->get_value());
     }
+    get_context().get_goal()->add_rpm_reason_change(specs, reason, group_id);
 }
 
 
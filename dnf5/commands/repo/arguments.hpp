@@ -50,6 +50,13 @@ public:
 };
 
 
+class RepoMemoryOption : public libdnf5::cli::session::BoolOption {
+public:
+    explicit RepoMemoryOption(libdnf5::cli::session::Command & command)
+        : BoolOption(command, "memory", '\0', _("Show memory used by the loaded metadata."), false) {}
+};
+
+
 class RepoSpecArguments : public libdnf5::cli::session::StringArgumentList {
 public:
     explicit RepoSpecArguments(libdnf5::cli::session::Command & command)
@@ -116,6 +116,11 @@ void RepoInfoCommand::print(const libdnf5::repo::RepoQuery & query, [[maybe_unus
         repo_info.print();
         std::cout << std::endl;
     }
+
+    if (memory->get_value()) {
+        std::cout << "Memory used by the loaded metadata:" << std::endl;
+        std::cout << get_context().base.get_repo_sack()->get_memory_usage().to_string();
+    }
 }
 
 }  // namespace dnf5
@@ -34,10 +34,13 @@ public:
     void set_argument_parser() override {
         RepoListCommand::set_argument_parser();
         get_argument_parser_command()->set_description("Print details about repositories");
+        memory = std::make_unique<RepoMemoryOption>(*this);
     }
 
     void configure() override;
 
+    std::unique_ptr<RepoMemoryOption> memory{nullptr};
+
 protected:
     void print(const libdnf5::repo::RepoQuery & query, [[maybe_unused]] bool with_status) override;
 };
@@ -295,6 +295,13 @@ void RepoqueryCommand::set_argument_parser() {
     recent = std::make_unique<libdnf5::cli::session::BoolOption>(
         *this, "recent", '\0', "Limit to only recently changed packages.", false);
 
+    recursive = std::make_unique<libdnf5::cli::session::BoolOption>(
+        *this,
+        "recursive",
+        '\0',
+        "Used with --whatrequires, extend the result by the packages that require it recursively.",
+        false);
+
     // TRANSFORMS:
 
     srpm = std::make_unique<libdnf5::cli::session::BoolOption>(
@@ -406,6 +413,8 @@ void RepoqueryCommand::configure() {
     }
 
     auto & context = get_context();
+    // The packages are queried in the primary metadata, the options needing more metadata declare them
+    context.base.get_repo_sack()->require_optional_metadata_types({});
     context.update_repo_metadata_from_specs(pkg_specs);
     system_repo_needed = installed_option->get_value() || userinstalled_option->get_value() ||
                          duplicates->get_value() || leaves_option->get_value() || unneeded->get_value() ||
@@ -432,14 +441,17 @@ void RepoqueryCommand::configure() {
     }
 
     if (changelogs->get_value()) {
-        context.base.get_config().get_optional_metadata_types_option().add_item(
-            libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_OTHER);
+        context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_OTHER});
+    }
+
+    if (recursive->get_value() && whatrequires->get_value().empty()) {
+        throw libdnf5::cli::ArgumentParserMissingDependentArgumentError(
+            M_("Option \"--recursive\" has to be used with \"--whatrequires\""));
     }
 
     if ((pkg_attr_option->get_value() == "files") ||
         (libdnf5::cli::output::requires_filelists(query_format_option->get_value()))) {
-        context.base.get_config().get_optional_metadata_types_option().add_item(
-            libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_FILELISTS);
+        context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_FILELISTS});
         return;
     }
     for (const auto & capabilities :
@@ -454,8 +466,7 @@ void RepoqueryCommand::configure() {
           whatsuggests->get_value()}) {
         for (const auto & capability : capabilities) {
             if (libdnf5::utils::is_file_pattern(capability)) {
-                context.base.get_config().get_optional_metadata_types_option().add_item(
-                    libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_FILELISTS);
+                context.base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_FILELISTS});
                 return;
             }
         }
@@ -644,6 +655,8 @@ void RepoqueryCommand::run() {
     }
 
     if (!whatrequires->get_value().empty()) {
+        // The packages the recursive closure can add, the same as for the direct requires
+        auto requires_candidates = result_query;
         if (exactdeps->get_value()) {
             result_query.filter_requires(whatrequires->get_value(), libdnf5::sack::QueryCmp::GLOB);
         } else {
@@ -654,6 +667,9 @@ void RepoqueryCommand::run() {
             result_query.filter_requires(whatrequires->get_value(), libdnf5::sack::QueryCmp::GLOB);
             result_query |= requires_resolved;
         }
+        if (recursive->get_value()) {
+            result_query.extend_by_required_by_closure(requires_candidates);
+        }
     }
 
     if (!whatobsoletes->get_value().empty()) {
@@ -703,6 +719,9 @@ void RepoqueryCommand::run() {
         result_query |= suggests_resolved;
     }
 
+    // The per-package filters are applied together ordered by their cost
+    result_query.defer_filters();
+
     if (!arch->get_value().empty()) {
         result_query.filter_arch(arch->get_value(), libdnf5::sack::QueryCmp::GLOB);
     }
@@ -711,6 +730,8 @@ void RepoqueryCommand::run() {
         result_query.filter_file(file->get_value(), libdnf5::sack::QueryCmp::GLOB);
     }
 
+    result_query.apply_deferred_filters();
+
     if (recent->get_value()) {
         auto & cfg_main = ctx.base.get_config();
         auto recent_limit_days = cfg_main.get_recent_option().get_value();
@@ -722,17 +743,9 @@ void RepoqueryCommand::run() {
     // They take a set of packages and turn it into a different set of packages
 
     if (srpm->get_value()) {
-        libdnf5::rpm::PackageQuery srpms(ctx.base, libdnf5::sack::ExcludeFlags::APPLY_EXCLUDES, true);
-        auto only_src_query = result_query;
-        only_src_query.filter_arch({"src"});
-        for (const auto & pkg : result_query) {
-            if (!pkg.get_sourcerpm().empty()) {
-                auto tmp_q = only_src_query;
-                tmp_q.filter_name({pkg.get_source_name()});
-                tmp_q.filter_evr({pkg.get_evr()});
-                srpms |= tmp_q;
-            }
-        }
+        auto srpms = result_query;
+        srpms.filter_arch({"src"});
+        srpms.filter_sources_of(result_query);
         result_query = srpms;
     }
 
@@ -72,6 +72,7 @@ private:
     std::unique_ptr<libdnf5::cli::session::BoolOption> extras{nullptr};
     std::unique_ptr<libdnf5::cli::session::BoolOption> upgrades{nullptr};
     std::unique_ptr<libdnf5::cli::session::BoolOption> recent{nullptr};
+    std::unique_ptr<libdnf5::cli::session::BoolOption> recursive{nullptr};
     std::unique_ptr<libdnf5::cli::session::BoolOption> installonly{nullptr};
     std::unique_ptr<libdnf5::cli::session::BoolOption> srpm{nullptr};
     std::unique_ptr<libdnf5::cli::session::BoolOption> disable_modular_filtering{nullptr};
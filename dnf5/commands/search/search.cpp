@@ -56,6 +56,12 @@ void SearchCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+    // Every pattern is searched in summaries (and descriptions with --all) of all packages,
+    // with more patterns building the trigram index once is cheaper than repeated full scans
+    auto & text_search_index = context.base.get_config().get_text_search_index_option();
+    if (patterns->get_value().size() > 1 && text_search_index.get_priority() == libdnf5::Option::Priority::DEFAULT) {
+        text_search_index.set(libdnf5::Option::Priority::RUNTIME, true);
+    }
 }
 
 void SearchCommand::run() {
@@ -22,9 +22,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <libdnf5/utils/patterns.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fnmatch.h>
 #include <functional>
+#include <iterator>
 #include <map>
-#include <set>
+#include <string_view>
 
 namespace dnf5 {
 
@@ -66,98 +71,118 @@ static auto get_matched_keys(int priority) {
     return matched_keys;
 }
 
-/// Get comparing method based on the pattern input representation.
-static auto get_cmp_from_pattern(const std::string & pattern) {
-    if (libdnf5::utils::is_glob_pattern(pattern.c_str())) {
-        return libdnf5::sack::QueryCmp::IGLOB;
-    } else {
-        return libdnf5::sack::QueryCmp::ICONTAINS;
-    }
-}
-
-SearchProcessor::SearchProcessor(
-    libdnf5::Base & base, std::vector<std::string> patterns, bool search_all, bool show_duplicates)
-    : base(base),
-      patterns(patterns),
-      search_all(search_all),
-      full_package_query(base),
-      showdupes(show_duplicates) {
-    if (!showdupes) {
-        full_package_query.filter_latest_evr();
+namespace {
+
+/// A search pattern prepared for matching against the package metadata fields.
+/// Glob patterns are matched case-insensitively as a whole, others are searched case-insensitively as substrings.
+class PatternMatcher {
+public:
+    explicit PatternMatcher(const std::string & pattern)
+        : pattern(pattern),
+          glob(libdnf5::utils::is_glob_pattern(pattern.c_str())) {
+        lowered_pattern.reserve(pattern.size());
+        for (char c : pattern) {
+            lowered_pattern.push_back(to_lower(c));
+        }
     }
-}
 
-libdnf5::rpm::PackageSet SearchProcessor::get_matches(
-    const std::string & pattern, int priority, filter_method_type filter) {
-    auto cmp = get_cmp_from_pattern(pattern);
+    bool is_glob() const noexcept { return glob; }
 
-    libdnf5::rpm::PackageQuery query_contains(full_package_query);
-    (query_contains.*filter)({pattern}, cmp);
-    update_priorities(query_contains, priority);
-
-    if (patterns.size() == 1 && cmp != libdnf5::sack::QueryCmp::IGLOB) {
-        libdnf5::rpm::PackageQuery query_exact(query_contains);
-        (query_exact.*filter)({pattern}, libdnf5::sack::QueryCmp::EXACT);
-        update_priorities(query_exact, (priority << 1));
+    /// @param buffer Reusable buffer for the null terminated copy of `value` needed by globs.
+    bool matches(std::string_view value, std::string & buffer) const {
+        if (glob) {
+            buffer.assign(value);
+            return fnmatch(pattern.c_str(), buffer.c_str(), FNM_CASEFOLD) == 0;
+        }
+        if (lowered_pattern.empty()) {
+            return true;
+        }
+        return std::search(
+                   value.begin(),
+                   value.end(),
+                   lowered_pattern.begin(),
+                   lowered_pattern.end(),
+                   [](char value_char, char pattern_char) { return to_lower(value_char) == pattern_char; }) !=
+               value.end();
     }
 
-    return query_contains;
-}
-
-libdnf5::rpm::PackageSet SearchProcessor::get_name_matches(const std::string & pattern) {
-    return get_matches(pattern, get_search_key_priority(SEARCH_KEY_NAME), &libdnf5::rpm::PackageQuery::filter_name);
-}
+    bool matches_exactly(std::string_view value) const noexcept { return value == pattern; }
 
-libdnf5::rpm::PackageSet SearchProcessor::get_summary_matches(const std::string & pattern) {
-    return get_matches(
-        pattern, get_search_key_priority(SEARCH_KEY_SUMMARY), &libdnf5::rpm::PackageQuery::filter_summary);
-}
+private:
+    static char to_lower(char c) noexcept {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
 
-libdnf5::rpm::PackageSet SearchProcessor::get_description_matches(const std::string & pattern) {
-    return get_matches(
-        pattern, get_search_key_priority(SEARCH_KEY_DESCRIPTION), &libdnf5::rpm::PackageQuery::filter_description);
-}
+    std::string pattern;
+    std::string lowered_pattern;
+    bool glob;
+};
 
-libdnf5::rpm::PackageSet SearchProcessor::get_url_matches(const std::string & pattern) {
-    return get_matches(pattern, get_search_key_priority(SEARCH_KEY_URL), &libdnf5::rpm::PackageQuery::filter_url);
-}
+}  // namespace
 
-void SearchProcessor::update_priorities(const libdnf5::rpm::PackageSet & packages, int priority) {
-    for (auto const & package : packages) {
-        packages_priorities[package.get_full_nevra()] |= priority;
+SearchProcessor::SearchProcessor(
+    libdnf5::Base & base, std::vector<std::string> patterns, bool search_all, bool show_duplicates)
+    : patterns(patterns),
+      search_all(search_all),
+      full_package_query(base),
+      showdupes(show_duplicates) {
+    if (!showdupes) {
+        full_package_query.filter_latest_evr();
     }
 }
 
 SearchResults SearchProcessor::get_results() {
-    libdnf5::rpm::PackageSet all_matches(base);
-
-    for (auto it = patterns.begin(); it != patterns.end(); ++it) {
-        libdnf5::rpm::PackageSet pattern_matches(base);
-        pattern_matches |= get_name_matches(*it);
-        pattern_matches |= get_summary_matches(*it);
+    std::vector<PatternMatcher> matchers(patterns.begin(), patterns.end());
+    // The exact matches are prioritized only when searching for a single pattern
+    bool match_exactly = matchers.size() == 1 && !matchers.front().is_glob();
+
+    // Description and URL are searched only with the "--all" option
+    const std::size_t num_keys = search_all ? std::size(SEARCH_KEYS) : 2;
+    std::array<int, std::size(SEARCH_KEYS)> key_priorities;
+    for (std::size_t key_idx = 0; key_idx < std::size(SEARCH_KEYS); ++key_idx) {
+        key_priorities[key_idx] = get_search_key_priority(SEARCH_KEYS[key_idx]);
+    }
 
+    // All patterns are matched against all keys of a package in one pass over the packages. The priority of
+    // a package is the bitmask of its matched keys, exact matches set the bit above the key priority.
+    // Packages are grouped by their priorities, the highest priorities first.
+    std::map<int, SearchPackages, std::greater<int>> priority_matches;
+    std::array<std::string_view, std::size(SEARCH_KEYS)> values;
+    std::string buffer;
+    for (const auto & package : full_package_query) {
+        values[0] = package.get_name_view();
+        values[1] = package.get_summary_view();
         if (search_all) {
-            pattern_matches |= get_description_matches(*it);
-            pattern_matches |= get_url_matches(*it);
+            values[2] = package.get_description_view();
+            values[3] = package.get_url_view();
         }
 
-        // For the first pattern we are always adding to the empty list.
-        // If we are using the "--all" option, we want any matches in the result.
-        // Otherwise we use an intersection (AND) with all previous results.
-        if (it == patterns.begin() || search_all) {
-            all_matches.update(std::move(pattern_matches));
-        } else {
-            all_matches.intersection(std::move(pattern_matches));
+        int priority = 0;
+        bool any_pattern_matched = false;
+        bool all_patterns_matched = true;
+        for (const auto & matcher : matchers) {
+            bool pattern_matched = false;
+            for (std::size_t key_idx = 0; key_idx < num_keys; ++key_idx) {
+                if (matcher.matches(values[key_idx], buffer)) {
+                    pattern_matched = true;
+                    priority |= key_priorities[key_idx];
+                    if (match_exactly && matcher.matches_exactly(values[key_idx])) {
+                        priority |= key_priorities[key_idx] << 1;
+                    }
+                }
+            }
+            any_pattern_matched |= pattern_matched;
+            all_patterns_matched &= pattern_matched;
+            // Without the "--all" option, all patterns have to be matched (AND)
+            if (!search_all && !all_patterns_matched) {
+                break;
+            }
         }
-    }
 
-    // Aggregate packages into the groups based on their priorities.
-    // This results in having packages grouped by the matched keys.
-    // Results are sorted with the highest priorities first.
-    std::map<int, SearchPackages, std::greater<int>> priority_matches;
-    for (auto const & package : all_matches) {
-        auto priority = packages_priorities[package.get_full_nevra()];
-        priority_matches[priority].packages.insert(std::move(package));
+        // With the "--all" option, we want any matches in the result
+        if (search_all ? any_pattern_matched : all_patterns_matched && !matchers.empty()) {
+            priority_matches[priority].packages.insert(package);
+        }
     }
 
     // In the end just push everything into the final result structure.
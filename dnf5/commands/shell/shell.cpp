@@ -0,0 +1,114 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "shell.hpp"
+
+#include <libdnf5-cli/argument_parser.hpp>
+#include <libdnf5-cli/exit-codes.hpp>
+#include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
+
+#include <cctype>
+
+namespace dnf5 {
+
+using namespace libdnf5::cli;
+
+void ShellCommand::set_parent_command() {
+    auto * arg_parser_parent_cmd = get_session().get_argument_parser().get_root_command();
+    auto * arg_parser_this_cmd = get_argument_parser_command();
+    arg_parser_parent_cmd->register_command(arg_parser_this_cmd);
+}
+
+void ShellCommand::set_argument_parser() {
+    auto & ctx = get_context();
+    auto & parser = ctx.get_argument_parser();
+
+    auto & cmd = *get_argument_parser_command();
+    cmd.set_description("Run commands read from a file or the standard input");
+    cmd.set_long_description(
+        "Runs the commands read from FILE or from the standard input, one command with its arguments per line. "
+        "The configuration and the repositories are loaded only once and reused by all the commands.");
+
+    auto input = parser.add_new_positional_arg("FILE", ArgumentParser::PositionalArg::OPTIONAL, nullptr, nullptr);
+    input->set_description("File with the commands, \"-\" or none for the standard input");
+    input->set_parse_hook_func([this](
+                                   [[maybe_unused]] ArgumentParser::PositionalArg * arg,
+                                   [[maybe_unused]] int argc,
+                                   const char * const argv[]) {
+        input_path = argv[0];
+        return true;
+    });
+    cmd.register_positional_arg(input);
+}
+
+void ShellCommand::run() {
+    // the shell is started by the main loop, it gets here only when used as a command inside the shell
+    throw CommandExitError(
+        static_cast<int>(ExitCode::ARGPARSER_ERROR), M_("The \"shell\" command cannot be used inside the shell"));
+}
+
+std::vector<std::string> split_shell_line(std::string_view line) {
+    std::vector<std::string> args;
+    std::string arg;
+    bool in_arg = false;
+    char quote = '\0';
+    for (std::size_t idx = 0; idx < line.size(); ++idx) {
+        char ch = line[idx];
+        if (quote == '\'') {
+            if (ch == '\'') {
+                quote = '\0';
+            } else {
+                arg += ch;
+            }
+        } else if (ch == '\\' && idx + 1 < line.size()) {
+            arg += line[++idx];
+            in_arg = true;
+        } else if (quote == '"') {
+            if (ch == '"') {
+                quote = '\0';
+            } else {
+                arg += ch;
+            }
+        } else if (ch == '\'' || ch == '"') {
+            quote = ch;
+            in_arg = true;
+        } else if (std::isspace(static_cast<unsigned char>(ch))) {
+            if (in_arg) {
+                args.push_back(std::move(arg));
+                arg.clear();
+                in_arg = false;
+            }
+        } else if (ch == '#' && !in_arg) {
+            break;
+        } else {
+            arg += ch;
+            in_arg = true;
+        }
+    }
+    if (quote != '\0') {
+        throw ArgumentParserError(M_("Unterminated quote in \"{}\""), std::string(line));
+    }
+    if (in_arg) {
+        args.push_back(std::move(arg));
+    }
+    return args;
+}
+
+}  // namespace dnf5
@@ -0,0 +1,56 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef DNF5_COMMANDS_SHELL_SHELL_HPP
+#define DNF5_COMMANDS_SHELL_SHELL_HPP
+
+#include <dnf5/context.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dnf5 {
+
+/// Runs the commands read from a file or from the standard input against a single base. The commands are run
+/// by the main loop of the program, this command only describes the arguments.
+class ShellCommand : public Command {
+public:
+    explicit ShellCommand(Context & context) : Command(context, "shell") {}
+    void set_parent_command() override;
+    void set_argument_parser() override;
+    void run() override;
+
+    /// Returns the path of the file with the commands, "-" stands for the standard input
+    const std::string & get_input_path() const noexcept { return input_path; }
+
+private:
+    std::string input_path{"-"};
+};
+
+/// Splits a `line` of the shell into arguments. The arguments are separated by whitespace, the quoting works
+/// as in the POSIX shell: single quotes preserve all characters, backslash escapes the next character outside
+/// single quotes. No expansions are done. Text following an unquoted `#` at the start of an argument is a comment.
+/// @throw libdnf5::cli::ArgumentParserError if a quote is not terminated
+std::vector<std::string> split_shell_line(std::string_view line);
+
+}  // namespace dnf5
+
+#endif  // DNF5_COMMANDS_SHELL_SHELL_HPP
@@ -0,0 +1,259 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "completion_cache.hpp"
+
+#include "utils.hpp"
+
+#include <fcntl.h>
+#include <libdnf5/rpm/package_query.hpp>
+#include <libdnf5/transaction/transaction_item_action.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace dnf5 {
+
+namespace {
+
+constexpr const char * COMPLETION_CACHE_DIR = "completion";
+constexpr const char * AVAILABLE_FILE_NAME = "available";
+constexpr const char * INSTALLED_FILE_NAME = "installed";
+
+/// Returns the completion cache directory, or an empty path if the configuration differs from the default one
+std::filesystem::path get_cache_dir(Context & ctx) {
+    auto & config = ctx.base.get_config();
+    if (config.get_installroot_option().get_value() != "/" || !ctx.setopts.empty() || !ctx.repos_from_path.empty()) {
+        return {};
+    }
+    return std::filesystem::path(config.get_system_cachedir_option().get_value()) / COMPLETION_CACHE_DIR;
+}
+
+/// Returns the cache line of the `package`: name and full NEVRA separated by a tab
+std::string get_cache_line(const libdnf5::rpm::Package & package) {
+    return package.get_name() + '\t' + package.get_full_nevra();
+}
+
+/// Writes the sorted `lines` to the cache file `file_name`, the file is replaced atomically
+void write_cache_file(Context & ctx, const char * file_name, const std::set<std::string> & lines) {
+    // the cache is stored in the system cache directory which only root can write
+    auto cache_dir = get_cache_dir(ctx);
+    if (cache_dir.empty() || !am_i_root()) {
+        return;
+    }
+    auto logger = ctx.base.get_logger();
+    try {
+        std::filesystem::create_directories(cache_dir);
+        auto path = cache_dir / file_name;
+        auto tmp_path = cache_dir / (std::string(file_name) + ".tmp");
+        {
+            std::ofstream file(tmp_path, std::ios::trunc);
+            for (const auto & line : lines) {
+                file << line << '\n';
+            }
+            file.close();
+            if (!file) {
+                throw std::runtime_error("write failed");
+            }
+        }
+        std::filesystem::rename(tmp_path, path);
+    } catch (const std::exception & ex) {
+        logger->warning("Cannot write completion cache file \"{}\": {}", (cache_dir / file_name).string(), ex.what());
+    }
+}
+
+/// Read-only memory mapping of a file
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path & path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            if (st.st_size == 0) {
+                valid = true;
+            } else {
+                auto size = static_cast<std::size_t>(st.st_size);
+                void * addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    data = std::string_view(static_cast<const char *>(addr), size);
+                    valid = true;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (!data.empty()) {
+            munmap(const_cast<char *>(data.data()), data.size());
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    bool is_valid() const noexcept { return valid; }
+    std::string_view get_data() const noexcept { return data; }
+
+private:
+    std::string_view data;
+    bool valid{false};
+};
+
+/// Returns the offset of the first line in the sorted `data` that is not less than `key`
+std::size_t lower_bound_line(std::string_view data, std::string_view key) {
+    // `low` is always the start of a line, all lines before it are less than `key`
+    std::size_t low = 0;
+    std::size_t high = data.size();
+    while (low < high) {
+        auto mid = low + (high - low) / 2;
+        auto line_start = mid;
+        while (line_start > low && data[line_start - 1] != '\n') {
+            --line_start;
+        }
+        auto line_end = data.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = data.size();
+        }
+        if (data.substr(line_start, line_end - line_start) < key) {
+            low = line_end + 1;
+        } else {
+            high = line_start;
+        }
+    }
+    return std::min(low, data.size());
+}
+
+/// Adds the lines of the sorted `data` that start with `pattern` to `lines`
+void add_matching_lines(std::string_view data, std::string_view pattern, std::vector<std::string_view> & lines) {
+    auto pos = lower_bound_line(data, pattern);
+    while (pos < data.size()) {
+        auto line_end = data.find('\n', pos);
+        if (line_end == std::string_view::npos) {
+            line_end = data.size();
+        }
+        auto line = data.substr(pos, line_end - pos);
+        if (!line.starts_with(pattern)) {
+            break;
+        }
+        lines.push_back(line);
+        pos = line_end + 1;
+    }
+}
+
+}  // namespace
+
+void write_available_completion_cache(Context & ctx) {
+    std::set<std::string> lines;
+    libdnf5::rpm::PackageQuery query(ctx.base);
+    query.filter_available();
+    for (const auto & package : query) {
+        lines.insert(get_cache_line(package));
+    }
+    write_cache_file(ctx, AVAILABLE_FILE_NAME, lines);
+}
+
+bool is_available_completion_cache_missing(Context & ctx) {
+    auto cache_dir = get_cache_dir(ctx);
+    return !cache_dir.empty() && am_i_root() && !std::filesystem::exists(cache_dir / AVAILABLE_FILE_NAME);
+}
+
+void write_installed_completion_cache(Context & ctx, const libdnf5::base::Transaction & transaction) {
+    std::set<std::string> lines;
+    libdnf5::rpm::PackageQuery query(ctx.base);
+    query.filter_installed();
+    for (const auto & package : query) {
+        lines.insert(get_cache_line(package));
+    }
+    auto transaction_packages = transaction.get_transaction_packages_view();
+    for (const auto & tspkg : transaction_packages) {
+        if (libdnf5::transaction::transaction_item_action_is_outbound(tspkg.get_action())) {
+            lines.erase(get_cache_line(tspkg.get_package()));
+        }
+    }
+    for (const auto & tspkg : transaction_packages) {
+        if (libdnf5::transaction::transaction_item_action_is_inbound(tspkg.get_action())) {
+            lines.insert(get_cache_line(tspkg.get_package()));
+        }
+    }
+    write_cache_file(ctx, INSTALLED_FILE_NAME, lines);
+}
+
+bool complete_from_cache(
+    Context & ctx,
+    const std::string & pattern,
+    bool installed,
+    bool available,
+    bool nevra_for_same_name,
+    std::set<std::string> & result) {
+    // the cache contains only names and NEVRAs, globs are resolved by the package query
+    auto cache_dir = get_cache_dir(ctx);
+    if (cache_dir.empty() || pattern.find_first_of("*?[") != std::string::npos) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<MappedFile>> files;
+    if (installed) {
+        files.push_back(std::make_unique<MappedFile>(cache_dir / INSTALLED_FILE_NAME));
+    }
+    if (available) {
+        files.push_back(std::make_unique<MappedFile>(cache_dir / AVAILABLE_FILE_NAME));
+    }
+    std::vector<std::string_view> lines;
+    for (const auto & file : files) {
+        if (!file->is_valid()) {
+            return false;
+        }
+        add_matching_lines(file->get_data(), pattern, lines);
+    }
+    // the pattern can also be a prefix of a NEVRA, the package query is used to find such matches
+    if (lines.empty()) {
+        return false;
+    }
+    std::sort(lines.begin(), lines.end());
+
+    // lines of packages with the same name are adjacent, the name is followed by a tab
+    for (auto it = lines.begin(); it != lines.end();) {
+        auto name = it->substr(0, it->find('\t'));
+        auto name_end = std::find_if(it, lines.end(), [&name](std::string_view line) {
+            return line.substr(0, line.find('\t')) != name;
+        });
+        if (nevra_for_same_name && name_end - it > 1) {
+            for (; it != name_end; ++it) {
+                result.emplace(it->substr(name.size() + 1));
+            }
+        } else {
+            result.emplace(name);
+            it = name_end;
+        }
+    }
+    return true;
+}
+
+}  // namespace dnf5
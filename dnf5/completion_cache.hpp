@@ -0,0 +1,61 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DNF5_COMPLETION_CACHE_HPP
+#define DNF5_COMPLETION_CACHE_HPP
+
+#include "dnf5/context.hpp"
+
+#include <libdnf5/base/transaction.hpp>
+
+#include <set>
+#include <string>
+
+namespace dnf5 {
+
+// The completion cache stores the names and NEVRAs of the available and installed packages in sorted files in
+// the system cache directory. It allows to complete package specs without setting up the Base and loading
+// the repositories. The available packages are written by `makecache`, the installed ones after each transaction.
+// The cache is used only with the default configuration of repositories and installroot.
+
+/// Writes the available packages of the loaded repositories to the completion cache.
+void write_available_completion_cache(Context & ctx);
+
+/// Returns whether the completion cache of the available packages can be written with the current configuration
+/// and does not exist yet.
+bool is_available_completion_cache_missing(Context & ctx);
+
+/// Writes the installed packages to the completion cache, the changes made by the successfully run `transaction`
+/// are applied to the loaded system repository.
+void write_installed_completion_cache(Context & ctx, const libdnf5::base::Transaction & transaction);
+
+/// Adds the names of the packages starting with `pattern` from the completion cache to `result`. If there are
+/// multiple packages with the same name and `nevra_for_same_name` is set, their NEVRAs are added instead.
+/// @return `false` if the cache cannot be used or no package name starts with the `pattern`.
+bool complete_from_cache(
+    Context & ctx,
+    const std::string & pattern,
+    bool installed,
+    bool available,
+    bool nevra_for_same_name,
+    std::set<std::string> & result);
+
+}  // namespace dnf5
+
+#endif
@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "dnf5/context.hpp"
 
+#include "completion_cache.hpp"
 #include "download_callbacks.hpp"
 #include "plugins.hpp"
 #include "utils.hpp"
@@ -125,20 +126,27 @@ void Context::print_info(std::string_view msg) const {
     }
 }
 
+void Context::reset_command_state() {
+    clear();
+    goal.reset();
+    transaction.reset();
+    load_system_repo = false;
+    load_available_repos = LoadAvailableRepos::NONE;
+}
+
 
 void Context::update_repo_metadata_from_specs(const std::vector<std::string> & pkg_specs) {
+    std::set<std::string> types;
     for (auto & spec : pkg_specs) {
         if (libdnf5::utils::is_file_pattern(spec)) {
-            base.get_config().get_optional_metadata_types_option().add_item(
-                libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_FILELISTS);
-            return;
-        }
-        if (spec.starts_with('@')) {
-            base.get_config().get_optional_metadata_types_option().add_item(
-                libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_COMPS);
-            return;
+            types.insert(libdnf5::METADATA_TYPE_FILELISTS);
+        } else if (spec.starts_with('@')) {
+            types.insert(libdnf5::METADATA_TYPE_COMPS);
         }
     }
+    if (!types.empty()) {
+        base.get_repo_sack()->require_optional_metadata_types(types);
+    }
 }
 
 void Context::update_repo_metadata_from_advisory_options(
@@ -153,8 +161,7 @@ void Context::update_repo_metadata_from_advisory_options(
     bool updateinfo_needed = !names.empty() || security || bugfix || enhancement || newpackage || !severity.empty() ||
                              !bzs.empty() || !cves.empty();
     if (updateinfo_needed) {
-        base.get_config().get_optional_metadata_types_option().add_item(
-            libdnf5::Option::Priority::RUNTIME, libdnf5::METADATA_TYPE_UPDATEINFO);
+        base.get_repo_sack()->require_optional_metadata_types({libdnf5::METADATA_TYPE_UPDATEINFO});
     }
 }
 
@@ -175,6 +182,23 @@ void Context::load_repos(bool load_system) {
     print_info("Repositories loaded.");
 }
 
+std::size_t Context::update_repos() {
+    libdnf5::repo::RepoQuery repos(base);
+    repos.filter_enabled(true);
+    repos.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+
+    for (auto & repo : repos) {
+        repo->set_callbacks(std::make_unique<dnf5::KeyImportRepoCB>(base.get_config()));
+    }
+
+    print_info("Updating repositories:");
+    auto num_updated = base.get_repo_sack()->update_repos(repos);
+    if (auto download_callbacks = dynamic_cast<DownloadCallbacks *>(base.get_download_callbacks())) {
+        download_callbacks->reset_progress_bar();
+    }
+    return num_updated;
+}
+
 namespace {
 
 class RpmTransCB : public libdnf5::rpm::TransactionCallbacks {
@@ -421,7 +445,7 @@ void Context::download_and_run(libdnf5::base::Transaction & transaction) {
     // Total number of actions = number of packages in the transaction +
     //                           action of verifying package files if new package files are present in the transaction +
     //                           action of preparing transaction
-    const auto & trans_packages = transaction.get_transaction_packages();
+    auto trans_packages = transaction.get_transaction_packages_view();
     auto num_of_actions = trans_packages.size() + 1;
     for (auto & trans_pkg : trans_packages) {
         if (libdnf5::transaction::transaction_item_action_is_inbound(trans_pkg.get_action())) {
@@ -457,6 +481,8 @@ void Context::download_and_run(libdnf5::base::Transaction & transaction) {
     for (auto const & entry : transaction.get_gpg_signature_problems()) {
         std::cerr << entry << std::endl;
     }
+
+    write_installed_completion_cache(*this, transaction);
     // TODO(mblaha): print a summary of successful transaction
 }
 
@@ -550,65 +576,69 @@ std::vector<std::string> match_specs(
     ctx.set_quiet(true);
 
     base.load_config();
-    base.setup();
 
     // optimization - disable the search for matching installed and available packages for file patterns
     if (libdnf5::utils::is_file_pattern(pattern)) {
         installed = available = false;
     }
 
-    if (installed) {
-        try {
-            base.get_repo_sack()->get_system_repo()->load();
-            base.get_rpm_package_sack()->load_config_excludes_includes();
-        } catch (...) {
-            // Ignores errors when completing installed packages, other completions may still work.
-        }
-    }
+    std::set<std::string> result_set;
+    if ((!installed && !available) ||
+        !complete_from_cache(ctx, pattern, installed, available, nevra_for_same_name, result_set)) {
+        base.setup();
 
-    if (available) {
-        try {
-            // create rpm repositories according configuration files
-            base.get_repo_sack()->create_repos_from_system_configuration();
-            base.get_config().get_optional_metadata_types_option().set(
-                libdnf5::Option::Priority::RUNTIME, libdnf5::OptionStringSet::ValueType{});
+        if (installed) {
+            try {
+                base.get_repo_sack()->get_system_repo()->load();
+                base.get_rpm_package_sack()->load_config_excludes_includes();
+            } catch (...) {
+                // Ignores errors when completing installed packages, other completions may still work.
+            }
+        }
 
-            ctx.apply_repository_setopts();
+        if (available) {
+            try {
+                // create rpm repositories according configuration files
+                base.get_repo_sack()->create_repos_from_system_configuration();
+                base.get_config().get_optional_metadata_types_option().set(
+                    libdnf5::Option::Priority::RUNTIME, libdnf5::OptionStringSet::ValueType{});
+
+                ctx.apply_repository_setopts();
+
+                libdnf5::repo::RepoQuery enabled_repos(base);
+                enabled_repos.filter_enabled(true);
+                enabled_repos.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+                for (auto & repo : enabled_repos.get_data()) {
+                    repo->set_sync_strategy(libdnf5::repo::Repo::SyncStrategy::ONLY_CACHE);
+                    repo->get_config().get_skip_if_unavailable_option().set(libdnf5::Option::Priority::RUNTIME, true);
+                }
 
-            libdnf5::repo::RepoQuery enabled_repos(base);
-            enabled_repos.filter_enabled(true);
-            enabled_repos.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
-            for (auto & repo : enabled_repos.get_data()) {
-                repo->set_sync_strategy(libdnf5::repo::Repo::SyncStrategy::ONLY_CACHE);
-                repo->get_config().get_skip_if_unavailable_option().set(libdnf5::Option::Priority::RUNTIME, true);
+                ctx.load_repos(false);
+            } catch (...) {
+                // Ignores errors when completing available packages, other completions may still work.
             }
-
-            ctx.load_repos(false);
-        } catch (...) {
-            // Ignores errors when completing available packages, other completions may still work.
         }
-    }
 
-    std::set<std::string> result_set;
-    {
-        libdnf5::rpm::PackageQuery matched_pkgs_query(base);
-        matched_pkgs_query.resolve_pkg_spec(
-            pattern + '*',
-            {.ignore_case = false, .with_provides = false, .with_filenames = false, .with_binaries = false},
-            true);
-
-        for (const auto & package : matched_pkgs_query) {
-            auto [it, inserted] = result_set.insert(package.get_name());
-
-            // Package name was already present - not inserted. There are multiple packages with the same name.
-            // If requested, removes the name and inserts a full nevra for these packages.
-            if (nevra_for_same_name && !inserted) {
-                result_set.erase(it);
-                libdnf5::rpm::PackageQuery name_query(matched_pkgs_query);
-                name_query.filter_name({package.get_name()});
-                for (const auto & pkg : name_query) {
-                    result_set.insert(pkg.get_full_nevra());
-                    matched_pkgs_query.remove(pkg);
+        {
+            libdnf5::rpm::PackageQuery matched_pkgs_query(base);
+            matched_pkgs_query.resolve_pkg_spec(
+                pattern + '*',
+                {.ignore_case = false, .with_provides = false, .with_filenames = false, .with_binaries = false},
+                true);
+
+            for (const auto & package : matched_pkgs_query) {
+                auto [it, inserted] = result_set.insert(package.get_name());
+
+                // Package name was already present - not inserted. There are multiple packages with the same name.
+                // If requested, removes the name and inserts a full nevra for these packages.
+                if (nevra_for_same_name && !inserted) {
+                    result_set.erase(it);
+                    libdnf5::rpm::PackageQuery name_query(matched_pkgs_query);
+                    name_query.filter_name({package.get_name()});
+                    for (const auto & pkg : name_query) {
+                        result_set.insert(pkg.get_full_nevra());
+                        matched_pkgs_query.remove(pkg);
+                    }
                 }
             }
         }
@@ -53,7 +53,8 @@ public:
     void apply_repository_setopts();
 
     /// Update required metadata types according to the provided `pkg_specs`.
-    /// If a `pkg_spec` is a file pattern, the file lists need to be loaded.
+    /// If a `pkg_spec` is a file pattern, the file lists need to be loaded, a group spec needs comps.
+    /// The types are declared by `RepoSack::require_optional_metadata_types()`.
     void update_repo_metadata_from_specs(const std::vector<std::string> & pkg_specs);
     /// Update required metadata types according to the provided advisory options.
     /// If any of the options is set we need to load updateinfo xml.
@@ -70,6 +71,11 @@ public:
     /// Sets callbacks for repositories and loads them, updating metadata if necessary.
     void load_repos(bool load_system);
 
+    /// Sets callbacks for the enabled available repositories, updates their metadata if necessary and writes
+    /// the libsolv cache files. The repositories are not loaded.
+    /// @return The number of repositories whose metadata were downloaded.
+    std::size_t update_repos();
+
     libdnf5::Base base;
     std::vector<std::pair<std::string, std::string>> setopts;
     std::vector<std::pair<std::string, std::string>> repos_from_path;
@@ -97,6 +103,25 @@ public:
 
     bool get_quiet() const { return quiet; }
 
+    /// Set to true to print the resolve timings and solver counters after the goal is resolved
+    /// and the summary of the time spent in the phases of the command when it ends.
+    void set_print_timings(bool print_timings) { this->print_timings = print_timings; }
+
+    bool get_print_timings() const { return print_timings; }
+
+    /// Sets the path of the file the recorded timing spans are written to when the command ends.
+    /// An empty path disables writing.
+    void set_timings_trace_path(std::filesystem::path path) { timings_trace_path = std::move(path); }
+
+    const std::filesystem::path & get_timings_trace_path() const { return timings_trace_path; }
+
+    /// Format of the timings trace file
+    enum class TimingsTraceFormat { CHROME, OTLP };
+
+    void set_timings_trace_format(TimingsTraceFormat format) { timings_trace_format = format; }
+
+    TimingsTraceFormat get_timings_trace_format() const { return timings_trace_format; }
+
     Plugins & get_plugins() { return *plugins; }
 
     libdnf5::Goal * get_goal(bool new_if_not_exist = true);
@@ -116,6 +141,11 @@ public:
     /// If quiet mode is not active, it will print `msg` to standard output.
     void print_info(std::string_view msg) const;
 
+    /// Removes all commands and drops the goal, the transaction and the repositories requested by the previously
+    /// run command. The base with the loaded repositories is kept, so another command line can be parsed and run.
+    /// The settings of the global options (e.g. quiet mode, comment) are kept as well.
+    void reset_command_state();
+
 private:
     /// Program arguments.
     size_t argc{0};
@@ -126,6 +156,11 @@ private:
 
     bool quiet{false};
 
+    bool print_timings{false};
+
+    std::filesystem::path timings_trace_path;
+    TimingsTraceFormat timings_trace_format{TimingsTraceFormat::CHROME};
+
     std::unique_ptr<Plugins> plugins;
     std::unique_ptr<libdnf5::Goal> goal;
     std::unique_ptr<libdnf5::base::Transaction> transaction;
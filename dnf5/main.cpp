@@ -40,6 +40,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "commands/repo/repo.hpp"
 #include "commands/repoquery/repoquery.hpp"
 #include "commands/search/search.hpp"
+#include "commands/shell/shell.hpp"
 #include "commands/swap/swap.hpp"
 #include "commands/upgrade/upgrade.hpp"
 #include "dnf5/context.hpp"
@@ -57,6 +58,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5-cli/utils/userconfirm.hpp>
 #include <libdnf5/base/base.hpp>
 #include <libdnf5/common/xdg.hpp>
+#include <libdnf5/logger/async_logger.hpp>
 #include <libdnf5/logger/factory.hpp>
 #include <libdnf5/logger/global_logger.hpp>
 #include <libdnf5/logger/memory_buffer_logger.hpp>
@@ -65,11 +67,17 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/version.hpp>
 #include <string.h>
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <cstring>
+#include <deque>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <optional>
 
 constexpr const char * DNF5_LOGGER_FILENAME = "dnf5.log";
 
@@ -146,6 +154,58 @@ void RootCommand::set_argument_parser() {
     });
     global_options_group->register_argument(quiet);
 
+    auto timings = parser.add_new_named_arg("timings");
+    timings->set_long_name("timings");
+    timings->set_description(
+        "Print the time spent in each phase of the dependency resolution and of the whole command to stderr.");
+    timings->set_parse_hook_func([&ctx](
+                                     [[maybe_unused]] ArgumentParser::NamedArg * arg,
+                                     [[maybe_unused]] const char * option,
+                                     [[maybe_unused]] const char * value) {
+        ctx.set_print_timings(true);
+        ctx.base.get_span_recorder().set_enabled(true);
+        return true;
+    });
+    global_options_group->register_argument(timings);
+
+    auto timings_trace = parser.add_new_named_arg("timings-trace");
+    timings_trace->set_long_name("timings-trace");
+    timings_trace->set_has_value(true);
+    timings_trace->set_arg_value_help("FILE");
+    timings_trace->set_description(
+        "Write the time spent in each phase of the command to FILE as a trace in the format selected by "
+        "--timings-trace-format.");
+    timings_trace->set_parse_hook_func(
+        [&ctx](
+            [[maybe_unused]] ArgumentParser::NamedArg * arg, [[maybe_unused]] const char * option, const char * value) {
+            ctx.set_timings_trace_path(value);
+            ctx.base.get_span_recorder().set_enabled(true);
+            return true;
+        });
+    global_options_group->register_argument(timings_trace);
+
+    auto timings_trace_format = parser.add_new_named_arg("timings-trace-format");
+    timings_trace_format->set_long_name("timings-trace-format");
+    timings_trace_format->set_has_value(true);
+    timings_trace_format->set_arg_value_help("FORMAT");
+    timings_trace_format->set_description(
+        "Format of the --timings-trace file: \"chrome\" (Chrome trace event format, the default) or \"otlp\" "
+        "(OpenTelemetry protocol JSON encoding).");
+    timings_trace_format->set_parse_hook_func(
+        [&ctx](
+            [[maybe_unused]] ArgumentParser::NamedArg * arg, [[maybe_unused]] const char * option, const char * value) {
+            if (std::strcmp(value, "chrome") == 0) {
+                ctx.set_timings_trace_format(Context::TimingsTraceFormat::CHROME);
+            } else if (std::strcmp(value, "otlp") == 0) {
+                ctx.set_timings_trace_format(Context::TimingsTraceFormat::OTLP);
+            } else {
+                throw libdnf5::cli::ArgumentParserError(
+                    M_("timings-trace-format: Unsupported format \"{}\", use \"chrome\" or \"otlp\""), value);
+            }
+            return true;
+        });
+    global_options_group->register_argument(timings_trace_format);
+
     auto cacheonly = parser.add_new_named_arg("cacheonly");
     cacheonly->set_long_name("cacheonly");
     cacheonly->set_short_name('C');
@@ -572,9 +632,54 @@ static void add_commands(Context & context) {
     context.add_and_initialize_command(std::make_unique<CleanCommand>(context));
     context.add_and_initialize_command(std::make_unique<DownloadCommand>(context));
     context.add_and_initialize_command(std::make_unique<MakeCacheCommand>(context));
+    context.add_and_initialize_command(std::make_unique<ShellCommand>(context));
 }
 
-static void load_plugins(Context & context) {
+/// Returns the name of the command the plugins with a manifest are loaded for. It is the first argument that is
+/// not an option. An empty string is returned when all the plugins are needed: completion, help of the root command,
+/// printing versions, the shell, or when the argument is not a known command (e.g. it is an alias or an option value).
+static std::string get_plugins_command(Context & context, int argc, char * argv[]) {
+    if (argc >= 2 && strncmp(argv[1], "--complete=", 11) == 0) {
+        return {};
+    }
+    for (int idx = 1; idx < argc; ++idx) {
+        if (argv[idx][0] == '-') {
+            continue;
+        }
+        std::string command = argv[idx];
+        // the commands run by the shell are not known in advance
+        if (command == "shell") {
+            return {};
+        }
+        for (const auto * cmd : context.get_argument_parser().get_root_command()->get_commands()) {
+            if (cmd->get_id() == command) {
+                return command;
+            }
+        }
+        for (const auto & manifest : context.get_plugins().get_deferred_plugins()) {
+            if (std::find(manifest.commands.begin(), manifest.commands.end(), command) != manifest.commands.end()) {
+                return command;
+            }
+        }
+        return {};
+    }
+    return {};
+}
+
+/// Adds the commands provided by the enabled plugins
+static void add_plugin_commands(Context & context) {
+    auto & plugins = context.get_plugins().get_plugins();
+    for (auto & plugin : plugins) {
+        if (plugin->get_enabled()) {
+            auto commands = plugin->get_iplugin()->create_commands();
+            for (auto & command : commands) {
+                context.add_and_initialize_command(std::move(command));
+            }
+        }
+    }
+}
+
+static void load_plugins(Context & context, int argc, char * argv[]) {
     auto & dnf5_plugins = context.get_plugins();
 
     const char * plugins_dir = std::getenv("DNF5_PLUGINS_DIR");
@@ -585,16 +690,14 @@ static void load_plugins(Context & context) {
     const std::filesystem::path plugins_directory = plugins_dir;
     if (std::filesystem::exists(plugins_directory) && std::filesystem::is_directory(plugins_directory)) {
         dnf5_plugins.load_plugins(plugins_directory);
+        // the plugins with a manifest are loaded only if they provide the command used on the command line
+        auto command = get_plugins_command(context, argc, argv);
+        dnf5_plugins.load_deferred_plugins([&command](const PluginManifest & manifest) {
+            return command.empty() ||
+                   std::find(manifest.commands.begin(), manifest.commands.end(), command) != manifest.commands.end();
+        });
         dnf5_plugins.init();
-        auto & plugins = dnf5_plugins.get_plugins();
-        for (auto & plugin : plugins) {
-            if (plugin->get_enabled()) {
-                auto commands = plugin->get_iplugin()->create_commands();
-                for (auto & command : commands) {
-                    context.add_and_initialize_command(std::move(command));
-                }
-            }
-        }
+        add_plugin_commands(context);
     }
 }
 
@@ -644,7 +747,7 @@ static void print_transaction_size_stats(Context & context) {
     int64_t install_size{0};
     int64_t remove_size{0};
 
-    for (const auto & trans_pkg : context.get_transaction()->get_transaction_packages()) {
+    for (const auto & trans_pkg : context.get_transaction()->get_transaction_packages_view()) {
         const auto pkg = trans_pkg.get_package();
         if (transaction_item_action_is_inbound(trans_pkg.get_action())) {
             const auto pkg_size = pkg.get_download_size();
@@ -695,10 +798,8 @@ static void print_transaction_size_stats(Context & context) {
     }
 }
 
-}  // namespace dnf5
-
-
-int main(int argc, char * argv[]) try {
+/// Creates the context of the program with the commands, the plugins and the aliases.
+static std::unique_ptr<Context> create_context(int argc, char * argv[]) {
     // Creates a vector of loggers with one circular memory buffer logger
     std::vector<std::unique_ptr<libdnf5::Logger>> loggers;
     const std::size_t max_log_items_to_keep = 10000;
@@ -708,126 +809,144 @@ int main(int argc, char * argv[]) try {
     loggers.front()->info("DNF5 start");
 
     // Creates a context and passes the loggers to it. We want to capture all messages from the context in the log.
-    dnf5::Context context(std::move(loggers));
-
-    libdnf5::Base & base = context.base;
-
-    auto & log_router = *base.get_logger();
+    auto context = std::make_unique<Context>(std::move(loggers));
 
     //TODO(jrohel) Logger verbosity is hardcoded to DEBUG. Use configuration.
-    libdnf5::GlobalLogger global_logger;
-    global_logger.set(log_router, libdnf5::Logger::Level::DEBUG);
+    libdnf5::GlobalLogger::set(*context->base.get_logger(), libdnf5::Logger::Level::DEBUG);
 
-    context.set_prg_arguments(static_cast<size_t>(argc), argv);
+    context->set_prg_arguments(static_cast<size_t>(argc), argv);
 
-    dnf5::add_commands(context);
-    dnf5::load_plugins(context);
-    dnf5::load_cmdline_aliases(context);
+    add_commands(*context);
+    load_plugins(*context, argc, argv);
+    load_cmdline_aliases(*context);
 
-    // Argument completion handler
-    // If the argument at position 1 is "--complete=<index>", this is a request to complete the argument
-    // at position <index>.
-    // The first two arguments are not subject to completion (skip them). The original arguments of the program
-    // (including the program name) start from position 2.
-    if (argc >= 2 && strncmp(argv[1], "--complete=", 11) == 0) {
-        context.get_argument_parser().complete(argc - 2, argv + 2, std::stoi(argv[1] + 11));
-        return 0;
-    }
+    return context;
+}
 
-    auto download_callbacks_uptr = std::make_unique<dnf5::DownloadCallbacks>();
-    auto * download_callbacks = download_callbacks_uptr.get();
+static void set_download_callbacks(Context & context) {
+    auto download_callbacks = std::make_unique<DownloadCallbacks>();
     download_callbacks->set_show_total_bar_limit(static_cast<std::size_t>(-1));
     if (!context.get_quiet()) {
-        base.set_download_callbacks(std::move(download_callbacks_uptr));
+        context.base.set_download_callbacks(std::move(download_callbacks));
     }
+}
 
-    // Parse command line arguments
-    {
-        auto & arg_parser = context.get_argument_parser();
-        try {
-            arg_parser.parse(argc, argv);
-        } catch (libdnf5::cli::ArgumentParserError & ex) {
-            // Error during parsing arguments. Try to find "--help"/"-h".
-            for (int idx = 1; idx < argc; ++idx) {
-                if (strcmp(argv[idx], "-h") == 0 || strcmp(argv[idx], "--help") == 0) {
-                    arg_parser.get_selected_command()->help();
-                    return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
-                }
+/// Parses the command line arguments, prints the help or the version if requested.
+/// @return The exit code if the program is done, an empty value if the selected command is to be run.
+static std::optional<int> parse_arguments(Context & context, int argc, const char * const argv[]) {
+    auto & arg_parser = context.get_argument_parser();
+    try {
+        arg_parser.parse(argc, argv);
+    } catch (libdnf5::cli::ArgumentParserError & ex) {
+        // Error during parsing arguments. Try to find "--help"/"-h".
+        for (int idx = 1; idx < argc; ++idx) {
+            if (strcmp(argv[idx], "-h") == 0 || strcmp(argv[idx], "--help") == 0) {
+                arg_parser.get_selected_command()->help();
+                return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
             }
-            std::cerr << ex.what() << _(". Add \"--help\" for more information about the arguments.") << std::endl;
-            if (auto * unknown_arg_ex = dynamic_cast<libdnf5::cli::ArgumentParserUnknownArgumentError *>(&ex)) {
-                if (unknown_arg_ex->get_command() == "dnf5" && unknown_arg_ex->get_argument()[0] != '-') {
-                    std::cout << fmt::format(
-                                     "It could be a command provided by a plugin, try: dnf install dnf5-command({})",
-                                     unknown_arg_ex->get_argument())
-                              << std::endl;
-                }
+        }
+        std::cerr << ex.what() << _(". Add \"--help\" for more information about the arguments.") << std::endl;
+        if (auto * unknown_arg_ex = dynamic_cast<libdnf5::cli::ArgumentParserUnknownArgumentError *>(&ex)) {
+            if (unknown_arg_ex->get_command() == "dnf5" && unknown_arg_ex->get_argument()[0] != '-') {
+                std::cout << fmt::format(
+                                 "It could be a command provided by a plugin, try: dnf install dnf5-command({})",
+                                 unknown_arg_ex->get_argument())
+                          << std::endl;
             }
-            return static_cast<int>(libdnf5::cli::ExitCode::ARGPARSER_ERROR);
         }
+        return static_cast<int>(libdnf5::cli::ExitCode::ARGPARSER_ERROR);
+    }
 
-        // print help of the selected command if --help was used
-        if (arg_parser.get_named_arg("help", false).get_parse_count() > 0) {
-            arg_parser.get_selected_command()->help();
-            return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
-        }
-        // print version of program if --version was used
-        if (arg_parser.get_named_arg("version", false).get_parse_count() > 0) {
-            dnf5::print_versions(context);
-            return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
-        }
+    // print help of the selected command if --help was used
+    if (arg_parser.get_named_arg("help", false).get_parse_count() > 0) {
+        arg_parser.get_selected_command()->help();
+        return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
     }
+    // print version of program if --version was used
+    if (arg_parser.get_named_arg("version", false).get_parse_count() > 0) {
+        print_versions(context);
+        return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
+    }
+    return std::nullopt;
+}
 
-    auto command = context.get_selected_command();
+/// Tracks the parts of the base that are ready. The commands run by the shell share them.
+struct BaseState {
+    /// The configuration is loaded, the base is set up and the repositories are created
+    bool set_up{false};
+    /// Gets set to true when any repository is created from configuration or a .repo file
+    bool any_repos_from_system_configuration{false};
+    bool system_repo_loaded{false};
+    bool available_repos_loaded{false};
+    /// A transaction was run, the loaded system repository is out of date
+    bool transaction_run{false};
+};
 
-    // Gets set to true when any repository is created from configuration or a
-    // .repo file
-    bool any_repos_from_system_configuration = false;
+/// Runs the command selected in the `context`. The base is set up and the repositories needed by the command
+/// are loaded unless the `state` says they are ready.
+/// @return The exit code of the command.
+static int run_command(Context & context, BaseState & state) {
+    auto & base = context.base;
+    auto & log_router = *base.get_logger();
+    auto command = context.get_selected_command();
+    libdnf5::base::SpanRecorder::Scope span(
+        base.get_span_recorder(), "run command", command->get_argument_parser_command()->get_id());
 
     try {
         command->pre_configure();
 
-        // Load main configuration
-        base.load_config();
-
-        // Try to open the current directory to see if we have
-        // read and execute access. If not, chdir to /
-        auto fd = open(".", O_RDONLY);
-        if (fd == -1) {
-            log_router.warning("No read/execute access in current directory, moving to /");
-            std::filesystem::current_path("/");
-        } else {
-            close(fd);
-        }
+        if (!state.set_up) {
+            // Load main configuration
+            base.load_config();
 
-        base.setup();
+            // Try to open the current directory to see if we have
+            // read and execute access. If not, chdir to /
+            auto fd = open(".", O_RDONLY);
+            if (fd == -1) {
+                log_router.warning("No read/execute access in current directory, moving to /");
+                std::filesystem::current_path("/");
+            } else {
+                close(fd);
+            }
 
-        auto file_logger = libdnf5::create_file_logger(base, DNF5_LOGGER_FILENAME);
-        // Swap to destination stream logger (log to file)
-        log_router.swap_logger(file_logger, 0);
-        // Write messages from memory buffer logger to stream logger
-        dynamic_cast<libdnf5::MemoryBufferLogger &>(*file_logger).write_to_logger(log_router);
+            base.setup();
 
-        auto repo_sack = base.get_repo_sack();
-        repo_sack->create_repos_from_system_configuration();
-        any_repos_from_system_configuration = repo_sack->size() > 0;
+            std::unique_ptr<libdnf5::Logger> file_logger = libdnf5::create_file_logger(base, DNF5_LOGGER_FILENAME);
+            if (base.get_config().get_log_async_option().get_value()) {
+                file_logger = std::make_unique<libdnf5::AsyncLogger>(std::move(file_logger));
+            }
+            // Swap to destination stream logger (log to file)
+            log_router.swap_logger(file_logger, 0);
+            // Write messages from memory buffer logger to stream logger
+            dynamic_cast<libdnf5::MemoryBufferLogger &>(*file_logger).write_to_logger(log_router);
+
+            auto repo_sack = base.get_repo_sack();
+            repo_sack->create_repos_from_system_configuration();
+            state.any_repos_from_system_configuration = repo_sack->size() > 0;
+
+            repo_sack->create_repos_from_paths(context.repos_from_path, libdnf5::Option::Priority::COMMANDLINE);
+            for (const auto & [id, path] : context.repos_from_path) {
+                context.setopts.emplace_back(id + ".enabled", "1");
+            }
 
-        repo_sack->create_repos_from_paths(context.repos_from_path, libdnf5::Option::Priority::COMMANDLINE);
-        for (const auto & [id, path] : context.repos_from_path) {
-            context.setopts.emplace_back(id + ".enabled", "1");
+            context.apply_repository_setopts();
+            state.set_up = true;
         }
 
-        context.apply_repository_setopts();
-
         // Run selected command
         command->configure();
         {
-            if (context.get_load_available_repos() != dnf5::Context::LoadAvailableRepos::NONE) {
-                context.load_repos(context.get_load_system_repo());
-            } else if (context.get_load_system_repo()) {
-                repo_sack->get_system_repo()->load();
+            bool load_system_repo = context.get_load_system_repo() && !state.system_repo_loaded;
+            if (context.get_load_available_repos() != dnf5::Context::LoadAvailableRepos::NONE &&
+                !state.available_repos_loaded) {
+                context.load_repos(load_system_repo);
+                state.available_repos_loaded = true;
+                state.system_repo_loaded = state.system_repo_loaded || load_system_repo;
+            } else if (load_system_repo) {
+                base.get_repo_sack()->get_system_repo()->load();
                 // TODO(lukash) this is inconvenient, we should try to call it automatically at the right time in libdnf
                 context.base.get_rpm_package_sack()->load_config_excludes_includes();
+                state.system_repo_loaded = true;
             }
         }
 
@@ -836,18 +955,23 @@ int main(int argc, char * argv[]) try {
         command->run();
         if (auto goal = context.get_goal(false)) {
             context.set_transaction(goal->resolve());
+            if (context.get_print_timings()) {
+                std::cerr << context.get_transaction()->get_resolve_stats().to_string();
+            }
 
             command->goal_resolved();
 
-            download_callbacks->reset_progress_bar();
-            download_callbacks->set_number_widget_visible(true);
-            download_callbacks->set_show_total_bar_limit(0);
+            if (auto * download_callbacks = dynamic_cast<DownloadCallbacks *>(base.get_download_callbacks())) {
+                download_callbacks->reset_progress_bar();
+                download_callbacks->set_number_widget_visible(true);
+                download_callbacks->set_show_total_bar_limit(0);
+            }
 
             if (!libdnf5::cli::output::print_transaction_table(*context.get_transaction())) {
                 return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
             }
 
-            dnf5::print_transaction_size_stats(context);
+            print_transaction_size_stats(context);
 
             if (base.get_config().get_downloadonly_option().get_value()) {
                 std::cout << "The operation will only download packages for the transaction." << std::endl;
@@ -866,10 +990,13 @@ int main(int argc, char * argv[]) try {
                 throw libdnf5::cli::AbortedByUserError();
             }
 
+            state.transaction_run = true;
+            libdnf5::base::SpanRecorder::Scope transaction_span(base.get_span_recorder(), "run transaction");
             context.download_and_run(*context.get_transaction());
         }
     } catch (libdnf5::cli::GoalResolveError & ex) {
-        if (!any_repos_from_system_configuration && base.get_config().get_installroot_option().get_value() != "/" &&
+        if (!state.any_repos_from_system_configuration &&
+            base.get_config().get_installroot_option().get_value() != "/" &&
             !base.get_config().get_use_host_config_option().get_value()) {
             std::cout << "No repositories were loaded from the installroot. To use the configuration and repositories "
                          "of the host system, pass --use-host-config."
@@ -891,9 +1018,152 @@ int main(int argc, char * argv[]) try {
         return static_cast<int>(libdnf5::cli::ExitCode::ERROR);
     }
 
-    log_router.info("DNF5 end");
-
     return static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
+}
+
+/// Prints the summary of the recorded timing spans and writes them to the trace file if requested by the options.
+/// The recorded spans are dropped then, so that the next command run by the shell is reported alone.
+static void report_timings(Context & context) {
+    auto & span_recorder = context.base.get_span_recorder();
+    if (!span_recorder.is_enabled()) {
+        return;
+    }
+    if (context.get_print_timings()) {
+        std::cerr << span_recorder.to_string();
+    }
+    if (const auto & trace_path = context.get_timings_trace_path(); !trace_path.empty()) {
+        std::ofstream trace_file(trace_path);
+        if (context.get_timings_trace_format() == Context::TimingsTraceFormat::OTLP) {
+            trace_file << span_recorder.to_otlp_json("dnf5");
+        } else {
+            trace_file << span_recorder.to_chrome_trace();
+        }
+        if (!trace_file) {
+            std::cerr << fmt::format("Cannot write timings trace file \"{}\"", trace_path.string()) << std::endl;
+        }
+    }
+    span_recorder.clear();
+}
+
+/// Runs the commands read by the `shell` command selected in the `context`, one command with its arguments per line.
+/// The commands share the base and the loaded repositories, only the commands are created again for each line.
+/// A transaction changes the system repository, the base is then created again for the following commands from
+/// the program arguments `argc` and `argv`. The available repositories are loaded from the local cache again.
+/// @return The exit code of the last failed command, `SUCCESS` if all the commands succeeded.
+static int run_shell(std::unique_ptr<Context> & context, int argc, char * argv[]) {
+    const auto input_path = static_cast<ShellCommand *>(context->get_selected_command())->get_input_path();
+    std::ifstream input_file;
+    std::istream * input = &std::cin;
+    if (input_path != "-") {
+        input_file.open(input_path);
+        if (!input_file) {
+            std::cerr << fmt::format("Cannot open file \"{}\": {}", input_path, std::strerror(errno)) << std::endl;
+            return static_cast<int>(libdnf5::cli::ExitCode::ERROR);
+        }
+        input = &input_file;
+    }
+    const bool interactive = input == &std::cin && isatty(STDIN_FILENO);
+
+    int exit_code = static_cast<int>(libdnf5::cli::ExitCode::SUCCESS);
+    BaseState state;
+    // The context keeps pointers to the parsed arguments (e.g. the comment), they are kept for the whole session
+    std::deque<std::string> args_storage;
+    std::string line;
+    while (true) {
+        if (interactive) {
+            std::cout << "> " << std::flush;
+        }
+        if (!std::getline(*input, line)) {
+            break;
+        }
+
+        std::vector<std::string> args;
+        try {
+            args = split_shell_line(line);
+        } catch (libdnf5::cli::ArgumentParserError & ex) {
+            std::cerr << ex.what() << std::endl;
+            exit_code = static_cast<int>(libdnf5::cli::ExitCode::ARGPARSER_ERROR);
+            continue;
+        }
+        if (args.empty()) {
+            continue;
+        }
+        if (args.size() == 1 && (args[0] == "exit" || args[0] == "quit")) {
+            break;
+        }
+
+        if (state.transaction_run) {
+            context = create_context(argc, argv);
+            set_download_callbacks(*context);
+            // the program arguments were already parsed successfully, this only applies the global options again
+            parse_arguments(*context, argc, argv);
+            state = BaseState();
+        }
+
+        std::vector<const char *> line_argv{argv[0]};
+        for (auto & arg : args) {
+            line_argv.push_back(args_storage.emplace_back(std::move(arg)).c_str());
+        }
+        const auto line_argc = static_cast<int>(line_argv.size());
+
+        context->reset_command_state();
+        add_commands(*context);
+        add_plugin_commands(*context);
+        load_cmdline_aliases(*context);
+        context->set_prg_arguments(line_argv.size(), line_argv.data());
+
+        auto line_exit_code = parse_arguments(*context, line_argc, line_argv.data());
+        if (!line_exit_code) {
+            line_exit_code = run_command(*context, state);
+            report_timings(*context);
+        }
+        if (*line_exit_code != static_cast<int>(libdnf5::cli::ExitCode::SUCCESS)) {
+            exit_code = *line_exit_code;
+        }
+    }
+
+    return exit_code;
+}
+
+}  // namespace dnf5
+
+
+int main(int argc, char * argv[]) try {
+    auto context = dnf5::create_context(argc, argv);
+    // unsets the global logger at the end, the logger of the context is set by create_context()
+    libdnf5::GlobalLogger global_logger;
+
+    // Argument completion handler
+    // If the argument at position 1 is "--complete=<index>", this is a request to complete the argument
+    // at position <index>.
+    // The first two arguments are not subject to completion (skip them). The original arguments of the program
+    // (including the program name) start from position 2.
+    if (argc >= 2 && strncmp(argv[1], "--complete=", 11) == 0) {
+        context->get_argument_parser().complete(argc - 2, argv + 2, std::stoi(argv[1] + 11));
+        return 0;
+    }
+
+    dnf5::set_download_callbacks(*context);
+
+    // Parse command line arguments
+    if (auto exit_code = dnf5::parse_arguments(*context, argc, argv)) {
+        return *exit_code;
+    }
+
+    int exit_code;
+    if (dynamic_cast<dnf5::ShellCommand *>(context->get_selected_command())) {
+        exit_code = dnf5::run_shell(context, argc, argv);
+    } else {
+        dnf5::BaseState state;
+        exit_code = dnf5::run_command(*context, state);
+        dnf5::report_timings(*context);
+    }
+
+    if (exit_code == static_cast<int>(libdnf5::cli::ExitCode::SUCCESS)) {
+        context->base.get_logger()->info("DNF5 end");
+    }
+
+    return exit_code;
 } catch (const libdnf5::Error & e) {
     std::cerr << libdnf5::format(e, libdnf5::FormatDetailLevel::WithName);
     return static_cast<int>(libdnf5::cli::ExitCode::ERROR);
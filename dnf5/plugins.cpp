@@ -23,11 +23,30 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "library.hpp"
 
 #include <fmt/format.h>
+#include <libdnf5/conf/config_parser.hpp>
+#include <libdnf5/conf/option_string_list.hpp>
 
 #include <filesystem>
 
 namespace dnf5 {
 
+namespace {
+
+constexpr const char * MANIFEST_EXTENSION = ".manifest";
+
+PluginManifest read_plugin_manifest(const std::filesystem::path & manifest_path, std::string library_path) {
+    libdnf5::ConfigParser parser;
+    parser.read(manifest_path);
+    PluginManifest manifest;
+    manifest.library_path = std::move(library_path);
+    manifest.name = parser.get_value("main", "name");
+    manifest.commands =
+        libdnf5::OptionStringList(std::vector<std::string>{}).from_string(parser.get_value("main", "commands"));
+    return manifest;
+}
+
+}  // namespace
+
 // Support for Plugin in the shared library.
 class PluginLibrary : public Plugin {
 public:
@@ -132,16 +151,50 @@ void Plugins::load_plugins(const std::string & dir_path) {
     }
     std::sort(lib_paths.begin(), lib_paths.end());
 
+    std::vector<std::string> loaded_lib_paths;
+    for (const auto & path : lib_paths) {
+        auto manifest_path = path;
+        manifest_path.replace_extension(MANIFEST_EXTENSION);
+        if (std::filesystem::exists(manifest_path)) {
+            try {
+                deferred_plugins.push_back(read_plugin_manifest(manifest_path, path.string()));
+                logger->debug("Deferred loading of dnf5 plugin file=\"{}\"", path.string());
+                continue;
+            } catch (const std::exception & ex) {
+                logger->warning("Cannot read dnf5 plugin manifest \"{}\": {}", manifest_path.string(), ex.what());
+            }
+        }
+        loaded_lib_paths.push_back(path.string());
+    }
+    load_plugin_libraries(loaded_lib_paths);
+}
+
+void Plugins::load_deferred_plugins(const std::function<bool(const PluginManifest &)> & filter) {
+    std::vector<std::string> lib_paths;
+    for (auto it = deferred_plugins.begin(); it != deferred_plugins.end();) {
+        if (filter(*it)) {
+            lib_paths.push_back(std::move(it->library_path));
+            it = deferred_plugins.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    load_plugin_libraries(lib_paths);
+}
+
+void Plugins::load_plugin_libraries(const std::vector<std::string> & lib_paths) {
+    auto logger = context->base.get_logger();
+
     std::string failed_filenames;
     for (const auto & path : lib_paths) {
         try {
             load_plugin(path);
         } catch (const std::exception & ex) {
-            logger->error("Cannot load dnf5 plugin \"{}\": {}", path.string(), ex.what());
+            logger->error("Cannot load dnf5 plugin \"{}\": {}", path, ex.what());
             if (!failed_filenames.empty()) {
                 failed_filenames += ", ";
             }
-            failed_filenames += path.filename();
+            failed_filenames += std::filesystem::path(path).filename();
         }
     }
     if (!failed_filenames.empty()) {
@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "dnf5/iplugin.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -70,6 +71,16 @@ protected:
 };
 
 
+/// Describes the plugin without loading its library.
+/// Read from the manifest file `<library name without ".so">.manifest` stored next to the library.
+struct PluginManifest {
+    std::string library_path;
+    std::string name;
+    /// Names of the commands created by the plugin
+    std::vector<std::string> commands;
+};
+
+
 /// Plugin manager
 class Plugins {
 public:
@@ -83,8 +94,15 @@ public:
     void load_plugin(const std::string & file_path);
 
     /// Loads plugins from libraries in the directory.
+    /// The loading of the libraries with a manifest file is deferred, see `load_deferred_plugins()`.
     void load_plugins(const std::string & dir_path);
 
+    /// Returns the manifests of the plugins whose loading was deferred by `load_plugins()`.
+    const std::vector<PluginManifest> & get_deferred_plugins() const noexcept { return deferred_plugins; }
+
+    /// Loads the deferred plugins for which the `filter` returns true.
+    void load_deferred_plugins(const std::function<bool(const PluginManifest &)> & filter);
+
     /// Returns the number of registered plugins.
     size_t count() const noexcept { return plugins.size(); }
 
@@ -100,8 +118,12 @@ public:
     void finish() noexcept;
 
 private:
+    /// Loads the libraries of the plugins at `lib_paths`, the failures are reported by an exception at the end.
+    void load_plugin_libraries(const std::vector<std::string> & lib_paths);
+
     dnf5::Context * context;
     std::vector<std::unique_ptr<Plugin>> plugins;
+    std::vector<PluginManifest> deferred_plugins;
 };
 
 
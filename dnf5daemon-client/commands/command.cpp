@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "dnf5daemon-server/dbus.hpp"
 #include "dnf5daemon-server/utils.hpp"
 #include "utils.hpp"
+#include "wrappers/dbus_call_pipeline.hpp"
 #include "wrappers/dbus_goal_wrapper.hpp"
 #include "wrappers/dbus_package_wrapper.hpp"
 
@@ -37,29 +38,40 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace dnfdaemon::client {
 
-void TransactionCommand::run_transaction() {
+void TransactionCommand::run_transaction(
+    const std::string & rpm_method,
+    const std::vector<std::string> & pkg_specs,
+    const dnfdaemon::KeyValueMap & rpm_options) {
     auto & ctx = get_context();
     dnfdaemon::KeyValueMap options = {};
 
+    // the server runs the calls of the session in order, the goal is filled before it is resolved
+    DbusCallPipeline pipeline(*ctx.session_proxy);
+    auto rpm_call = pipeline.create_call(dnfdaemon::INTERFACE_RPM, rpm_method);
+    rpm_call << pkg_specs << rpm_options;
+    auto rpm_reply = pipeline.send(rpm_call);
+
     // resolve the transaction
     options["allow_erasing"] = ctx.allow_erasing.get_value();
+    auto resolve_call = pipeline.create_call(dnfdaemon::INTERFACE_GOAL, "resolve");
+    resolve_call << options;
+    auto resolve_reply = pipeline.send(resolve_call);
+
+    // the resolving error messages are requested in advance, they are only read when the resolve fails
+    auto problems_call = pipeline.create_call(dnfdaemon::INTERFACE_GOAL, "get_transaction_problems_string");
+    auto problems_reply = pipeline.send(problems_call);
+
+    rpm_reply.get();
     std::vector<dnfdaemon::DbusTransactionItem> transaction;
     unsigned int result_int;
-    ctx.session_proxy->callMethod("resolve")
-        .onInterface(dnfdaemon::INTERFACE_GOAL)
-        .withTimeout(static_cast<uint64_t>(-1))
-        .withArguments(options)
-        .storeResultsTo(transaction, result_int);
+    resolve_reply.get() >> transaction >> result_int;
     dnfdaemon::ResolveResult result = static_cast<dnfdaemon::ResolveResult>(result_int);
     DbusGoalWrapper dbus_goal_wrapper(transaction);
 
     if (result != dnfdaemon::ResolveResult::NO_PROBLEM) {
         // retrieve and print resolving error messages
         std::vector<std::string> problems;
-        ctx.session_proxy->callMethod("get_transaction_problems_string")
-            .onInterface(dnfdaemon::INTERFACE_GOAL)
-            .withTimeout(static_cast<uint64_t>(-1))
-            .storeResultsTo(problems);
+        problems_reply.get() >> problems;
         if (result == dnfdaemon::ResolveResult::ERROR) {
             throw libdnf5::cli::GoalResolveError(problems);
         }
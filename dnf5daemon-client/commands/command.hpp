@@ -24,6 +24,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <dnf5daemon-server/dbus.hpp>
 
+#include <string>
+#include <vector>
+
 
 namespace dnfdaemon::client {
 
@@ -42,7 +45,14 @@ public:
 class TransactionCommand : public DaemonCommand {
 public:
     explicit TransactionCommand(Context & context, const std::string & name) : DaemonCommand(context, name){};
-    void run_transaction();
+
+    /// Fills the goal by the `rpm_method` of the Rpm interface with the `pkg_specs` and `rpm_options`, resolves
+    /// the transaction and runs it after the confirmation of the user. The goal call, the resolve and the request
+    /// for the resolve problems are sent together, without waiting for the replies in between.
+    void run_transaction(
+        const std::string & rpm_method,
+        const std::vector<std::string> & pkg_specs,
+        const dnfdaemon::KeyValueMap & rpm_options);
 };
 
 
@@ -53,20 +53,13 @@ void DistroSyncCommand::set_argument_parser() {
 }
 
 void DistroSyncCommand::run() {
-    auto & ctx = get_context();
-
     if (!am_i_root()) {
         throw UnprivilegedUserError();
     }
 
     dnfdaemon::KeyValueMap options = {};
 
-    ctx.session_proxy->callMethod("distro_sync")
-        .onInterface(dnfdaemon::INTERFACE_RPM)
-        .withTimeout(static_cast<uint64_t>(-1))
-        .withArguments(pkg_specs, options);
-
-    run_transaction();
+    run_transaction("distro_sync", pkg_specs, options);
 }
 
 }  // namespace dnfdaemon::client
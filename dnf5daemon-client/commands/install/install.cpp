@@ -69,8 +69,6 @@ void InstallCommand::set_argument_parser() {
 }
 
 void InstallCommand::run() {
-    auto & ctx = get_context();
-
     if (!am_i_root()) {
         throw UnprivilegedUserError();
     }
@@ -84,12 +82,7 @@ void InstallCommand::run() {
         options["skip_unavailable"] = skip_unavailable_option.get_value();
     }
 
-    ctx.session_proxy->callMethod("install")
-        .onInterface(dnfdaemon::INTERFACE_RPM)
-        .withTimeout(static_cast<uint64_t>(-1))
-        .withArguments(pkg_specs, options);
-
-    run_transaction();
+    run_transaction("install", pkg_specs, options);
 }
 
 }  // namespace dnfdaemon::client
@@ -53,20 +53,13 @@ void ReinstallCommand::set_argument_parser() {
 }
 
 void ReinstallCommand::run() {
-    auto & ctx = get_context();
-
     if (!am_i_root()) {
         throw UnprivilegedUserError();
     }
 
     dnfdaemon::KeyValueMap options = {};
 
-    ctx.session_proxy->callMethod("reinstall")
-        .onInterface(dnfdaemon::INTERFACE_RPM)
-        .withTimeout(static_cast<uint64_t>(-1))
-        .withArguments(pkg_specs, options);
-
-    run_transaction();
+    run_transaction("reinstall", pkg_specs, options);
 }
 
 }  // namespace dnfdaemon::client
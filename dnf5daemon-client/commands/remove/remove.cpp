@@ -57,20 +57,13 @@ void RemoveCommand::set_argument_parser() {
 }
 
 void RemoveCommand::run() {
-    auto & ctx = get_context();
-
     if (!am_i_root()) {
         throw UnprivilegedUserError();
     }
 
     dnfdaemon::KeyValueMap options = {};
 
-    ctx.session_proxy->callMethod("remove")
-        .onInterface(dnfdaemon::INTERFACE_RPM)
-        .withTimeout(static_cast<uint64_t>(-1))
-        .withArguments(pkg_specs, options);
-
-    run_transaction();
+    run_transaction("remove", pkg_specs, options);
 }
 
 }  // namespace dnfdaemon::client
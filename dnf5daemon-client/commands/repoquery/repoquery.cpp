@@ -113,28 +113,39 @@ void RepoqueryCommand::run() {
         }
     }
     options["patterns"] = patterns;
-    if (info_option->get_value()) {
-        options.insert(std::pair<std::string, std::vector<std::string>>(
-            "package_attrs",
-            {"name",
-             "epoch",
-             "version",
-             "release",
-             "arch",
-             "repo_id",
-             "install_size",
-             "download_size",
-             "sourcerpm",
-             "is_installed",
-             "summary",
-             "url",
-             "license",
-             "description",
-             "vendor"}));
-    } else {
-        options.insert(std::pair<std::string, std::vector<std::string>>("package_attrs", {"full_nevra"}));
+    if (!info_option->get_value()) {
+        // only the nevras are printed, the typed list returns them as (id, full_nevra) structs
+        options["package_attrs"] = std::vector<std::string>{"full_nevra"};
+        sdbus::Variant typed_packages;
+        ctx.session_proxy->callMethod("list_typed")
+            .onInterface(dnfdaemon::INTERFACE_RPM)
+            .withTimeout(static_cast<uint64_t>(-1))
+            .withArguments(options)
+            .storeResultsTo(typed_packages);
+        for (const auto & package : typed_packages.get<std::vector<sdbus::Struct<int, std::string>>>()) {
+            std::cout << std::get<1>(package) << std::endl;
+        }
+        return;
     }
 
+    options.insert(std::pair<std::string, std::vector<std::string>>(
+        "package_attrs",
+        {"name",
+         "epoch",
+         "version",
+         "release",
+         "arch",
+         "repo_id",
+         "install_size",
+         "download_size",
+         "sourcerpm",
+         "is_installed",
+         "summary",
+         "url",
+         "license",
+         "description",
+         "vendor"}));
+
     dnfdaemon::KeyValueMapList packages;
     ctx.session_proxy->callMethod("list")
         .onInterface(dnfdaemon::INTERFACE_RPM)
@@ -146,16 +157,12 @@ void RepoqueryCommand::run() {
     for (auto & raw_package : packages) {
         --num_packages;
         DbusPackageWrapper package(raw_package);
-        if (info_option->get_value()) {
-            auto out = libdnf5::cli::output::PackageInfoSections();
-            out.setup_cols();
-            out.add_package(package);
-            out.print();
-            if (num_packages) {
-                std::cout << std::endl;
-            }
-        } else {
-            std::cout << package.get_full_nevra() << std::endl;
+        auto out = libdnf5::cli::output::PackageInfoSections();
+        out.setup_cols();
+        out.add_package(package);
+        out.print();
+        if (num_packages) {
+            std::cout << std::endl;
         }
     }
 }
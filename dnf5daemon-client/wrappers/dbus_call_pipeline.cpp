@@ -0,0 +1,44 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dbus_call_pipeline.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+
+namespace dnfdaemon::client {
+
+std::future<sdbus::MethodReply> DbusCallPipeline::send(sdbus::MethodCall & call) {
+    auto promise = std::make_shared<std::promise<sdbus::MethodReply>>();
+    auto future = promise->get_future();
+    proxy.callMethod(
+        call,
+        [promise](sdbus::MethodReply & reply, const sdbus::Error * error) {
+            if (error) {
+                promise->set_exception(std::make_exception_ptr(*error));
+            } else {
+                promise->set_value(reply);
+            }
+        },
+        static_cast<uint64_t>(-1));
+    return future;
+}
+
+}  // namespace dnfdaemon::client
@@ -0,0 +1,52 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DNF5DAEMON_CLIENT_WRAPPERS_DBUS_CALL_PIPELINE_HPP
+#define DNF5DAEMON_CLIENT_WRAPPERS_DBUS_CALL_PIPELINE_HPP
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <future>
+#include <string>
+
+namespace dnfdaemon::client {
+
+/// Sends method calls to a session object without waiting for their replies. The server runs the methods
+/// of a session one after another in the order of the calls, so a call can be sent before the reply of the call
+/// it depends on arrives (e.g. `resolve` right after `install`). A chain of calls then takes a single round-trip.
+/// The replies are delivered by the event loop of the connection, which has to run in another thread.
+class DbusCallPipeline {
+public:
+    explicit DbusCallPipeline(sdbus::IProxy & proxy) : proxy(proxy) {}
+
+    /// Creates a call of the `method` on the `interface`, the arguments are appended by the `<<` operator.
+    sdbus::MethodCall create_call(const std::string & interface, const std::string & method) {
+        return proxy.createMethodCall(interface, method);
+    }
+
+    /// Sends the `call` and returns the future reply. When the method fails, the future rethrows the `sdbus::Error`.
+    std::future<sdbus::MethodReply> send(sdbus::MethodCall & call);
+
+private:
+    sdbus::IProxy & proxy;
+};
+
+}  // namespace dnfdaemon::client
+
+#endif
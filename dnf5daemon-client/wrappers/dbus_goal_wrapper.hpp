@@ -27,6 +27,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <libdnf5/transaction/transaction_item_action.hpp>
 
+#include <span>
 #include <vector>
 
 using namespace libdnf5::transaction;
@@ -38,6 +39,9 @@ public:
     DbusGoalWrapper(std::vector<dnfdaemon::DbusTransactionItem>);
 
     std::vector<DbusTransactionPackageWrapper> get_transaction_packages() const { return transaction_packages; };
+    std::span<const DbusTransactionPackageWrapper> get_transaction_packages_view() const {
+        return transaction_packages;
+    };
     std::vector<DbusTransactionGroupWrapper> get_transaction_groups() const { return transaction_groups; };
     std::vector<DbusTransactionEnvironmentWrapper> get_transaction_environments() const {
         return transaction_environments;
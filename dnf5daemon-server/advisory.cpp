@@ -114,62 +114,126 @@ KeyValueMapList collections_to_list(
     return collections;
 }
 
-KeyValueMap advisory_to_map(
+AdvisoryAttribute get_advisory_attribute(const std::string & attr) {
+    auto it = advisory_attributes.find(attr);
+    if (it == advisory_attributes.end()) {
+        throw std::runtime_error(fmt::format("Advisory attribute '{}' not supported", attr));
+    }
+    return it->second;
+}
+
+std::string advisory_attribute_signature(AdvisoryAttribute attribute) {
+    switch (attribute) {
+        case AdvisoryAttribute::advisoryid:
+            return sdbus::signature_of<int>::str();
+        case AdvisoryAttribute::buildtime:
+            return sdbus::signature_of<uint64_t>::str();
+        case AdvisoryAttribute::references:
+            return sdbus::signature_of<std::vector<AdvisoryReference>>::str();
+        case AdvisoryAttribute::collections:
+            return sdbus::signature_of<KeyValueMapList>::str();
+        case AdvisoryAttribute::name:
+        case AdvisoryAttribute::severity:
+        case AdvisoryAttribute::type:
+        case AdvisoryAttribute::vendor:
+        case AdvisoryAttribute::description:
+        case AdvisoryAttribute::title:
+        case AdvisoryAttribute::status:
+        case AdvisoryAttribute::rights:
+        case AdvisoryAttribute::message:
+            return sdbus::signature_of<std::string>::str();
+    }
+    throw std::runtime_error("Unknown advisory attribute");
+}
+
+// calls `add(attr, value)` for each of the `attributes` of the advisory, the value types match
+// advisory_attribute_signature()
+template <typename AddFn>
+void add_advisory_attributes(
     const libdnf5::advisory::Advisory & libdnf_advisory,
     const std::vector<std::string> & attributes,
-    const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions) {
-    KeyValueMap dbus_advisory;
-    // add advisory id by default
-    dbus_advisory.emplace("advisoryid", libdnf_advisory.get_id().id);
-    // attributes required by client
+    const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions,
+    AddFn && add) {
     for (auto & attr : attributes) {
-        auto it = advisory_attributes.find(attr);
-        if (it == advisory_attributes.end()) {
-            throw std::runtime_error(fmt::format("Advisory attribute '{}' not supported", attr));
-        }
-        switch (it->second) {
+        switch (get_advisory_attribute(attr)) {
             case AdvisoryAttribute::advisoryid:
-                // already added by default
+                add(attr, libdnf_advisory.get_id().id);
                 break;
             case AdvisoryAttribute::name:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_name());
+                add(attr, libdnf_advisory.get_name());
                 break;
             case AdvisoryAttribute::severity:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_severity());
+                add(attr, libdnf_advisory.get_severity());
                 break;
             case AdvisoryAttribute::type:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_type());
+                add(attr, libdnf_advisory.get_type());
                 break;
             case AdvisoryAttribute::buildtime:
-                dbus_advisory.emplace(attr, static_cast<uint64_t>(libdnf_advisory.get_buildtime()));
+                add(attr, static_cast<uint64_t>(libdnf_advisory.get_buildtime()));
                 break;
             case AdvisoryAttribute::vendor:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_vendor());
+                add(attr, libdnf_advisory.get_vendor());
                 break;
             case AdvisoryAttribute::description:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_description());
+                add(attr, libdnf_advisory.get_description());
                 break;
             case AdvisoryAttribute::title:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_title());
+                add(attr, libdnf_advisory.get_title());
                 break;
             case AdvisoryAttribute::status:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_status());
+                add(attr, libdnf_advisory.get_status());
                 break;
             case AdvisoryAttribute::rights:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_rights());
+                add(attr, libdnf_advisory.get_rights());
                 break;
             case AdvisoryAttribute::message:
-                dbus_advisory.emplace(attr, libdnf_advisory.get_message());
+                add(attr, libdnf_advisory.get_message());
                 break;
             case AdvisoryAttribute::collections:
-                dbus_advisory.emplace(attr, collections_to_list(libdnf_advisory, installed_versions));
+                add(attr, collections_to_list(libdnf_advisory, installed_versions));
                 break;
             case AdvisoryAttribute::references:
-                dbus_advisory.emplace(attr, references_to_list(libdnf_advisory));
+                add(attr, references_to_list(libdnf_advisory));
                 break;
         }
     }
+}
+
+KeyValueMap advisory_to_map(
+    const libdnf5::advisory::Advisory & libdnf_advisory,
+    const std::vector<std::string> & attributes,
+    const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions) {
+    KeyValueMap dbus_advisory;
+    // add advisory id by default
+    dbus_advisory.emplace("advisoryid", libdnf_advisory.get_id().id);
+    // attributes required by client, the already present advisoryid is not replaced
+    add_advisory_attributes(
+        libdnf_advisory, attributes, installed_versions, [&](const std::string & attr, auto && value) {
+            dbus_advisory.emplace(attr, value);
+        });
     return dbus_advisory;
 }
 
+std::string advisory_fields_signature(const std::vector<std::string> & attributes) {
+    std::string signature = advisory_attribute_signature(AdvisoryAttribute::advisoryid);
+    for (auto & attr : attributes) {
+        signature += advisory_attribute_signature(get_advisory_attribute(attr));
+    }
+    return signature;
+}
+
+void write_advisory(
+    TypedListWriter & writer,
+    const libdnf5::advisory::Advisory & libdnf_advisory,
+    const std::vector<std::string> & attributes,
+    const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions) {
+    writer.begin_item();
+    writer.add_field(libdnf_advisory.get_id().id);
+    add_advisory_attributes(
+        libdnf_advisory, attributes, installed_versions, [&writer](const std::string &, auto && value) {
+            writer.add_field(value);
+        });
+    writer.end_item();
+}
+
 }  // namespace dnfdaemon
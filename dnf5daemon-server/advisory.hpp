@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define DNF5DAEMON_SERVER_ADVISORY_HPP
 
 #include "dbus.hpp"
+#include "typed_list.hpp"
 
 #include <libdnf5/advisory/advisory.hpp>
 #include <libdnf5/rpm/package.hpp>
@@ -52,6 +53,16 @@ KeyValueMap advisory_to_map(
     const std::vector<std::string> & attributes,
     const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions);
 
+// D-Bus signature of the advisory id followed by the `attributes`
+std::string advisory_fields_signature(const std::vector<std::string> & attributes);
+
+// writes the advisory id followed by the `attributes` of the advisory as one item of the `writer`
+void write_advisory(
+    TypedListWriter & writer,
+    const libdnf5::advisory::Advisory & libdnf_advisory,
+    const std::vector<std::string> & attributes,
+    const std::unordered_map<std::string, libdnf5::rpm::Package> & installed_versions);
+
 }  // namespace dnfdaemon
 
 
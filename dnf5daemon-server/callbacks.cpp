@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "callbacks.hpp"
 
 #include "dbus.hpp"
+#include "metrics.hpp"
 #include "session.hpp"
 #include "transaction.hpp"
 
@@ -27,11 +28,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace dnf5daemon {
 
 
-DbusCallback::DbusCallback(Session & session) : session(session) {
+DbusCallback::DbusCallback(Session & session)
+    : session(session),
+      progress_interval(session.session_configuration_value<int>("progress_interval_ms", 400)),
+      progress_batch_signals(session.session_configuration_value<bool>("progress_batch_signals", false)) {
     dbus_object = session.get_dbus_object();
 }
 
@@ -42,7 +47,47 @@ sdbus::Signal DbusCallback::create_signal(std::string interface, std::string sig
     return signal;
 }
 
-std::chrono::time_point<std::chrono::steady_clock> DbusCallback::prev_print_time = std::chrono::steady_clock::now();
+void DbusCallback::queue_progress(
+    sdbus::Signal && signal,
+    const std::string & signal_name,
+    const std::string & item_id,
+    uint64_t amount,
+    uint64_t total) {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    queued_progress.insert_or_assign({signal_name, item_id}, QueuedProgress{std::move(signal), amount, total});
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_progress_emission >= progress_interval) {
+        last_progress_emission = now;
+        emit_queued_progress();
+    }
+}
+
+void DbusCallback::flush_progress() {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    emit_queued_progress();
+}
+
+void DbusCallback::emit_queued_progress() {
+    auto progress = std::move(queued_progress);
+    queued_progress.clear();
+    if (progress.empty()) {
+        return;
+    }
+    if (progress_batch_signals) {
+        std::vector<sdbus::Struct<std::string, std::string, uint64_t, uint64_t>> batch;
+        batch.reserve(progress.size());
+        for (const auto & [key, item_progress] : progress) {
+            batch.emplace_back(key.first, key.second, item_progress.amount, item_progress.total);
+        }
+        auto signal = create_signal(dnfdaemon::INTERFACE_BASE, dnfdaemon::SIGNAL_PROGRESS_BATCH);
+        signal << batch;
+        dbus_object->emitSignal(signal);
+    } else {
+        for (const auto & [key, item_progress] : progress) {
+            dbus_object->emitSignal(item_progress.signal);
+        }
+    }
+}
 
 
 sdbus::Signal DownloadCB::create_signal_download(const std::string & signal_name, void * user_data) {
@@ -56,6 +101,11 @@ sdbus::Signal DownloadCB::create_signal_download(const std::string & signal_name
 
 void * DownloadCB::add_new_download(void * user_data, const char * description, double total_to_download) {
     try {
+        if (user_data) {
+            auto * data = reinterpret_cast<DownloadUserData *>(user_data);
+            data->start_time = std::chrono::steady_clock::now();
+            data->downloaded = 0;
+        }
         auto signal = create_signal_download(dnfdaemon::SIGNAL_DOWNLOAD_ADD_NEW, user_data);
         signal << description;
         signal << static_cast<int64_t>(total_to_download);
@@ -67,12 +117,19 @@ void * DownloadCB::add_new_download(void * user_data, const char * description,
 
 int DownloadCB::progress(void * user_cb_data, double total_to_download, double downloaded) {
     try {
-        if (is_time_to_print()) {
-            auto signal = create_signal_download(dnfdaemon::SIGNAL_DOWNLOAD_PROGRESS, user_cb_data);
-            signal << static_cast<int64_t>(total_to_download);
-            signal << static_cast<int64_t>(downloaded);
-            dbus_object->emitSignal(signal);
+        auto signal = create_signal_download(dnfdaemon::SIGNAL_DOWNLOAD_PROGRESS, user_cb_data);
+        signal << static_cast<int64_t>(total_to_download);
+        signal << static_cast<int64_t>(downloaded);
+        auto * data = reinterpret_cast<DownloadUserData *>(user_cb_data);
+        if (data) {
+            data->downloaded = static_cast<uint64_t>(downloaded);
         }
+        queue_progress(
+            std::move(signal),
+            dnfdaemon::SIGNAL_DOWNLOAD_PROGRESS,
+            data ? data->download_id : "",
+            static_cast<uint64_t>(downloaded),
+            static_cast<uint64_t>(total_to_download));
     } catch (...) {
     }
     return 0;
@@ -80,6 +137,14 @@ int DownloadCB::progress(void * user_cb_data, double total_to_download, double d
 
 int DownloadCB::end(void * user_cb_data, TransferStatus status, const char * msg) {
     try {
+        flush_progress();
+        if (user_cb_data && status == TransferStatus::SUCCESSFUL) {
+            auto * data = reinterpret_cast<DownloadUserData *>(user_cb_data);
+            Metrics::get_instance().record_download(
+                data->downloaded,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - data->start_time));
+        }
         auto signal = create_signal_download(dnfdaemon::SIGNAL_DOWNLOAD_END, user_cb_data);
         signal << static_cast<int>(status);
         signal << msg;
@@ -140,21 +205,18 @@ void DbusTransactionCB::install_start(const libdnf5::rpm::TransactionItem & item
 
 void DbusTransactionCB::install_progress(const libdnf5::rpm::TransactionItem & item, uint64_t amount, uint64_t total) {
     try {
-        if (is_time_to_print()) {
-            auto signal = create_signal_pkg(
-                dnfdaemon::INTERFACE_RPM,
-                dnfdaemon::SIGNAL_TRANSACTION_ACTION_PROGRESS,
-                item.get_package().get_full_nevra());
-            signal << amount;
-            signal << total;
-            dbus_object->emitSignal(signal);
-        }
+        auto nevra = item.get_package().get_full_nevra();
+        auto signal = create_signal_pkg(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_ACTION_PROGRESS, nevra);
+        signal << amount;
+        signal << total;
+        queue_progress(std::move(signal), dnfdaemon::SIGNAL_TRANSACTION_ACTION_PROGRESS, nevra, amount, total);
     } catch (...) {
     }
 }
 
 void DbusTransactionCB::install_stop(const libdnf5::rpm::TransactionItem & item, uint64_t /*amount*/, uint64_t total) {
     try {
+        flush_progress();
         auto signal = create_signal_pkg(
             dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_ACTION_STOP, item.get_package().get_full_nevra());
         signal << total;
@@ -194,11 +256,11 @@ void DbusTransactionCB::script_stop(
 
 void DbusTransactionCB::elem_progress(const libdnf5::rpm::TransactionItem & item, uint64_t amount, uint64_t total) {
     try {
-        auto signal = create_signal_pkg(
-            dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_ELEM_PROGRESS, item.get_package().get_full_nevra());
+        auto nevra = item.get_package().get_full_nevra();
+        auto signal = create_signal_pkg(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_ELEM_PROGRESS, nevra);
         signal << amount;
         signal << total;
-        dbus_object->emitSignal(signal);
+        queue_progress(std::move(signal), dnfdaemon::SIGNAL_TRANSACTION_ELEM_PROGRESS, nevra, amount, total);
     } catch (...) {
     }
 }
@@ -209,6 +271,7 @@ void DbusTransactionCB::script_error(
     libdnf5::rpm::TransactionCallbacks::ScriptType type,
     uint64_t return_code) {
     try {
+        flush_progress();
         auto signal = create_signal_pkg(
             dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_SCRIPT_ERROR, to_full_nevra_string(nevra));
         signal << static_cast<int>(type);
@@ -233,13 +296,14 @@ void DbusTransactionCB::transaction_progress(uint64_t amount, uint64_t total) {
         auto signal = create_signal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_TRANSACTION_PROGRESS);
         signal << amount;
         signal << total;
-        dbus_object->emitSignal(signal);
+        queue_progress(std::move(signal), dnfdaemon::SIGNAL_TRANSACTION_TRANSACTION_PROGRESS, "", amount, total);
     } catch (...) {
     }
 }
 
 void DbusTransactionCB::transaction_stop(uint64_t total) {
     try {
+        flush_progress();
         auto signal = create_signal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_TRANSACTION_STOP);
         signal << total;
         dbus_object->emitSignal(signal);
@@ -262,13 +326,14 @@ void DbusTransactionCB::verify_progress(uint64_t amount, uint64_t total) {
         auto signal = create_signal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_VERIFY_PROGRESS);
         signal << amount;
         signal << total;
-        dbus_object->emitSignal(signal);
+        queue_progress(std::move(signal), dnfdaemon::SIGNAL_TRANSACTION_VERIFY_PROGRESS, "", amount, total);
     } catch (...) {
     }
 }
 
 void DbusTransactionCB::verify_stop(uint64_t total) {
     try {
+        flush_progress();
         auto signal = create_signal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_VERIFY_STOP);
         signal << total;
         dbus_object->emitSignal(signal);
@@ -279,6 +344,7 @@ void DbusTransactionCB::verify_stop(uint64_t total) {
 
 void DbusTransactionCB::unpack_error(const libdnf5::rpm::TransactionItem & item) {
     try {
+        flush_progress();
         auto signal = create_signal_pkg(
             dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_UNPACK_ERROR, item.get_package().get_full_nevra());
         dbus_object->emitSignal(signal);
@@ -288,6 +354,7 @@ void DbusTransactionCB::unpack_error(const libdnf5::rpm::TransactionItem & item)
 
 void DbusTransactionCB::finish() {
     try {
+        flush_progress();
         auto signal = create_signal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_FINISHED);
         dbus_object->emitSignal(signal);
     } catch (...) {
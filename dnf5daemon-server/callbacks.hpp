@@ -28,7 +28,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <sdbus-c++/sdbus-c++.h>
 
 #include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
 class Session;
 
@@ -37,6 +41,9 @@ namespace dnf5daemon {
 
 struct DownloadUserData {
     std::string download_id{};
+    // for the download metrics
+    std::chrono::steady_clock::time_point start_time{};
+    uint64_t downloaded{0};
 };
 
 class DbusCallback {
@@ -45,21 +52,41 @@ public:
     virtual ~DbusCallback() = default;
 
 protected:
-    static std::chrono::time_point<std::chrono::steady_clock> prev_print_time;
     Session & session;
     sdbus::IObject * dbus_object;
 
     virtual sdbus::Signal create_signal(std::string interface, std::string signal_name);
-    static bool is_time_to_print() {
-        auto now = std::chrono::steady_clock::now();
-        auto delta = now - prev_print_time;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(delta).count();
-        if (ms > 400) {
-            prev_print_time = now;
-            return true;
-        }
-        return false;
-    }
+
+    /// Queues the progress `signal` of the `item_id`, it replaces the queued progress of the same item. The queued
+    /// signals are emitted together once the progress interval of the session elapsed since the last emission.
+    void queue_progress(
+        sdbus::Signal && signal,
+        const std::string & signal_name,
+        const std::string & item_id,
+        uint64_t amount,
+        uint64_t total);
+
+    /// Emits the queued progress signals. Called before the events finishing a progress, so that the client
+    /// receives the final progress first.
+    void flush_progress();
+
+private:
+    struct QueuedProgress {
+        sdbus::Signal signal;
+        uint64_t amount;
+        uint64_t total;
+    };
+
+    void emit_queued_progress();
+
+    // interval between emissions of the progress signals
+    std::chrono::milliseconds progress_interval;
+    // emit the queued progress in one `progress_batch` signal instead of the separate signals
+    bool progress_batch_signals;
+    std::mutex progress_mutex;
+    std::chrono::steady_clock::time_point last_progress_emission{};
+    // map {(signal_name, item_id): progress}
+    std::map<std::pair<std::string, std::string>, QueuedProgress> queued_progress;
 };
 
 
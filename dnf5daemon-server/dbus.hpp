@@ -67,9 +67,12 @@ const char * const SIGNAL_DOWNLOAD_ADD_NEW = "download_add_new";
 const char * const SIGNAL_DOWNLOAD_PROGRESS = "download_progress";
 const char * const SIGNAL_DOWNLOAD_END = "download_end";
 const char * const SIGNAL_DOWNLOAD_MIRROR_FAILURE = "download_mirror_failure";
+const char * const SIGNAL_PROGRESS_BATCH = "progress_batch";
 
 const char * const SIGNAL_REPO_KEY_IMPORT_REQUEST = "repo_key_import_request";
 
+const char * const SIGNAL_PACKAGE_LIST_CHUNK = "package_list_chunk";
+
 const char * const SIGNAL_TRANSACTION_TRANSACTION_START = "transaction_transaction_start";
 const char * const SIGNAL_TRANSACTION_TRANSACTION_PROGRESS = "transaction_transaction_progress";
 const char * const SIGNAL_TRANSACTION_TRANSACTION_STOP = "transaction_transaction_stop";
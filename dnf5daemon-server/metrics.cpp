@@ -0,0 +1,60 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "metrics.hpp"
+
+#include <algorithm>
+
+Metrics & Metrics::get_instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+void Metrics::record_method_call(const std::string & method, std::chrono::microseconds duration, bool failed) {
+    auto bucket = static_cast<std::size_t>(
+        std::lower_bound(DURATION_BUCKETS_US.begin(), DURATION_BUCKETS_US.end(), duration.count()) -
+        DURATION_BUCKETS_US.begin());
+    std::lock_guard<std::mutex> lock(mutex);
+    auto & method_statistics = statistics.methods[method];
+    ++method_statistics.calls;
+    if (failed) {
+        ++method_statistics.failures;
+    }
+    method_statistics.total_time += duration;
+    ++method_statistics.histogram[bucket];
+}
+
+void Metrics::record_sack_load(std::chrono::microseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++statistics.sack_loads;
+    statistics.sack_load_total_time += duration;
+    statistics.sack_load_max_time = std::max(statistics.sack_load_max_time, duration);
+}
+
+void Metrics::record_download(std::uint64_t bytes, std::chrono::microseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++statistics.downloads;
+    statistics.downloaded_bytes += bytes;
+    statistics.download_time += duration;
+}
+
+Metrics::Statistics Metrics::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
@@ -0,0 +1,69 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DNF5DAEMON_SERVER_METRICS_HPP
+#define DNF5DAEMON_SERVER_METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+/// Operational metrics of the server collected from all the sessions.
+class Metrics {
+public:
+    /// Upper bounds of the buckets of the method call duration histograms, the last bucket is unbounded
+    static constexpr std::array<std::int64_t, 6> DURATION_BUCKETS_US{1000, 10000, 100000, 1000000, 10000000, 60000000};
+
+    struct MethodStatistics {
+        std::uint64_t calls{0};
+        std::uint64_t failures{0};
+        std::chrono::microseconds total_time{0};
+        /// Number of calls in each of `DURATION_BUCKETS_US` buckets and in the unbounded one
+        std::array<std::uint64_t, DURATION_BUCKETS_US.size() + 1> histogram{};
+    };
+
+    struct Statistics {
+        /// map {interface.method: statistics}
+        std::map<std::string, MethodStatistics> methods;
+        std::uint64_t sack_loads{0};
+        std::chrono::microseconds sack_load_total_time{0};
+        std::chrono::microseconds sack_load_max_time{0};
+        std::uint64_t downloads{0};
+        std::uint64_t downloaded_bytes{0};
+        std::chrono::microseconds download_time{0};
+    };
+
+    /// Returns the metrics of the server.
+    static Metrics & get_instance();
+
+    void record_method_call(const std::string & method, std::chrono::microseconds duration, bool failed);
+    void record_sack_load(std::chrono::microseconds duration);
+    void record_download(std::uint64_t bytes, std::chrono::microseconds duration);
+
+    Statistics get_statistics() const;
+
+private:
+    mutable std::mutex mutex;
+    Statistics statistics;
+};
+
+#endif
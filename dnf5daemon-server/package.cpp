@@ -20,6 +20,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "package.hpp"
 
 #include <fmt/format.h>
+#include <libdnf5/base/base.hpp>
+#include <libdnf5/rpm/package_sack.hpp>
 
 #include <map>
 
@@ -60,6 +62,7 @@ const std::map<std::string, PackageAttribute> package_attributes{
 
 std::vector<std::string> reldeplist_to_strings(const libdnf5::rpm::ReldepList & reldeps) {
     std::vector<std::string> lst;
+    lst.reserve(static_cast<std::size_t>(reldeps.size()));
     for (auto reldep : reldeps) {
         lst.emplace_back(reldep.to_string());
     }
@@ -76,6 +79,131 @@ std::vector<dnfdaemon::Changelog> changelogs_to_list(const libdnf5::rpm::Package
     return changelogs;
 }
 
+sdbus::Variant package_attribute_to_variant(const libdnf5::rpm::Package & libdnf_package, PackageAttribute attribute) {
+    switch (attribute) {
+        case PackageAttribute::name:
+            return sdbus::Variant(libdnf_package.get_name());
+        case PackageAttribute::epoch:
+            return sdbus::Variant(libdnf_package.get_epoch());
+        case PackageAttribute::version:
+            return sdbus::Variant(libdnf_package.get_version());
+        case PackageAttribute::release:
+            return sdbus::Variant(libdnf_package.get_release());
+        case PackageAttribute::arch:
+            return sdbus::Variant(libdnf_package.get_arch());
+        case PackageAttribute::repo_id:
+            return sdbus::Variant(libdnf_package.get_repo_id());
+        case PackageAttribute::from_repo_id:
+            return sdbus::Variant(libdnf_package.get_from_repo_id());
+        case PackageAttribute::is_installed:
+            return sdbus::Variant(libdnf_package.is_installed());
+        case PackageAttribute::install_size:
+            return sdbus::Variant(static_cast<uint64_t>(libdnf_package.get_install_size()));
+        case PackageAttribute::download_size:
+            return sdbus::Variant(static_cast<uint64_t>(libdnf_package.get_download_size()));
+        case PackageAttribute::sourcerpm:
+            return sdbus::Variant(libdnf_package.get_sourcerpm());
+        case PackageAttribute::summary:
+            return sdbus::Variant(libdnf_package.get_summary());
+        case PackageAttribute::url:
+            return sdbus::Variant(libdnf_package.get_url());
+        case PackageAttribute::license:
+            return sdbus::Variant(libdnf_package.get_license());
+        case PackageAttribute::description:
+            return sdbus::Variant(libdnf_package.get_description());
+        case PackageAttribute::files:
+            return sdbus::Variant(libdnf_package.get_files());
+        case PackageAttribute::changelogs:
+            return sdbus::Variant(changelogs_to_list(libdnf_package));
+        case PackageAttribute::provides:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_provides()));
+        case PackageAttribute::requires_all:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_requires()));
+        case PackageAttribute::requires_pre:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_requires_pre()));
+        case PackageAttribute::prereq_ignoreinst:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_prereq_ignoreinst()));
+        case PackageAttribute::regular_requires:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_regular_requires()));
+        case PackageAttribute::conflicts:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_conflicts()));
+        case PackageAttribute::obsoletes:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_obsoletes()));
+        case PackageAttribute::recommends:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_recommends()));
+        case PackageAttribute::suggests:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_suggests()));
+        case PackageAttribute::enhances:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_enhances()));
+        case PackageAttribute::supplements:
+            return sdbus::Variant(reldeplist_to_strings(libdnf_package.get_supplements()));
+        case PackageAttribute::evr:
+            return sdbus::Variant(libdnf_package.get_evr());
+        case PackageAttribute::nevra:
+            return sdbus::Variant(libdnf_package.get_nevra());
+        case PackageAttribute::full_nevra:
+            return sdbus::Variant(libdnf_package.get_full_nevra());
+        case PackageAttribute::reason:
+            return sdbus::Variant(
+                libdnf5::transaction::transaction_item_reason_to_string(libdnf_package.get_reason()));
+        case PackageAttribute::vendor:
+            return sdbus::Variant(libdnf_package.get_vendor());
+    }
+    throw std::runtime_error("Unknown package attribute");
+}
+
+std::string package_attribute_signature(PackageAttribute attribute) {
+    switch (attribute) {
+        case PackageAttribute::is_installed:
+            return sdbus::signature_of<bool>::str();
+        case PackageAttribute::install_size:
+        case PackageAttribute::download_size:
+            return sdbus::signature_of<uint64_t>::str();
+        case PackageAttribute::files:
+        case PackageAttribute::provides:
+        case PackageAttribute::requires_all:
+        case PackageAttribute::requires_pre:
+        case PackageAttribute::prereq_ignoreinst:
+        case PackageAttribute::regular_requires:
+        case PackageAttribute::conflicts:
+        case PackageAttribute::obsoletes:
+        case PackageAttribute::recommends:
+        case PackageAttribute::suggests:
+        case PackageAttribute::enhances:
+        case PackageAttribute::supplements:
+            return sdbus::signature_of<std::vector<std::string>>::str();
+        case PackageAttribute::changelogs:
+            return sdbus::signature_of<std::vector<dnfdaemon::Changelog>>::str();
+        case PackageAttribute::name:
+        case PackageAttribute::epoch:
+        case PackageAttribute::version:
+        case PackageAttribute::release:
+        case PackageAttribute::arch:
+        case PackageAttribute::repo_id:
+        case PackageAttribute::from_repo_id:
+        case PackageAttribute::sourcerpm:
+        case PackageAttribute::summary:
+        case PackageAttribute::url:
+        case PackageAttribute::license:
+        case PackageAttribute::description:
+        case PackageAttribute::evr:
+        case PackageAttribute::nevra:
+        case PackageAttribute::full_nevra:
+        case PackageAttribute::reason:
+        case PackageAttribute::vendor:
+            return sdbus::signature_of<std::string>::str();
+    }
+    throw std::runtime_error("Unknown package attribute");
+}
+
+PackageAttribute get_package_attribute(const std::string & attr) {
+    auto it = package_attributes.find(attr);
+    if (it == package_attributes.end()) {
+        throw std::runtime_error(fmt::format("Package attribute '{}' not supported", attr));
+    }
+    return it->second;
+}
+
 dnfdaemon::KeyValueMap package_to_map(
     const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes) {
     dnfdaemon::KeyValueMap dbus_package;
@@ -83,112 +211,64 @@ dnfdaemon::KeyValueMap package_to_map(
     dbus_package.emplace(std::make_pair("id", libdnf_package.get_id().id));
     // attributes required by client
     for (auto & attr : attributes) {
-        auto it = package_attributes.find(attr);
-        if (it == package_attributes.end()) {
-            throw std::runtime_error(fmt::format("Package attribute '{}' not supported", attr));
-        }
-        switch (it->second) {
-            case PackageAttribute::name:
-                dbus_package.emplace(attr, libdnf_package.get_name());
-                break;
-            case PackageAttribute::epoch:
-                dbus_package.emplace(attr, libdnf_package.get_epoch());
-                break;
-            case PackageAttribute::version:
-                dbus_package.emplace(attr, libdnf_package.get_version());
-                break;
-            case PackageAttribute::release:
-                dbus_package.emplace(attr, libdnf_package.get_release());
-                break;
-            case PackageAttribute::arch:
-                dbus_package.emplace(attr, libdnf_package.get_arch());
-                break;
-            case PackageAttribute::repo_id:
-                dbus_package.emplace(attr, libdnf_package.get_repo_id());
-                break;
-            case PackageAttribute::from_repo_id:
-                dbus_package.emplace(attr, libdnf_package.get_from_repo_id());
-                break;
-            case PackageAttribute::is_installed:
-                dbus_package.emplace(attr, libdnf_package.is_installed());
-                break;
-            case PackageAttribute::install_size:
-                dbus_package.emplace(attr, static_cast<uint64_t>(libdnf_package.get_install_size()));
-                break;
-            case PackageAttribute::download_size:
-                dbus_package.emplace(attr, static_cast<uint64_t>(libdnf_package.get_download_size()));
-                break;
-            case PackageAttribute::sourcerpm:
-                dbus_package.emplace(attr, libdnf_package.get_sourcerpm());
-                break;
-            case PackageAttribute::summary:
-                dbus_package.emplace(attr, libdnf_package.get_summary());
-                break;
-            case PackageAttribute::url:
-                dbus_package.emplace(attr, libdnf_package.get_url());
-                break;
-            case PackageAttribute::license:
-                dbus_package.emplace(attr, libdnf_package.get_license());
-                break;
-            case PackageAttribute::description:
-                dbus_package.emplace(attr, libdnf_package.get_description());
-                break;
-            case PackageAttribute::files:
-                dbus_package.emplace(attr, libdnf_package.get_files());
-                break;
-            case PackageAttribute::changelogs:
-                dbus_package.emplace(attr, changelogs_to_list(libdnf_package));
-                break;
-            case PackageAttribute::provides:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_provides()));
-                break;
-            case PackageAttribute::requires_all:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_requires()));
-                break;
-            case PackageAttribute::requires_pre:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_requires_pre()));
-                break;
-            case PackageAttribute::prereq_ignoreinst:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_prereq_ignoreinst()));
-                break;
-            case PackageAttribute::regular_requires:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_regular_requires()));
-                break;
-            case PackageAttribute::conflicts:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_conflicts()));
-                break;
-            case PackageAttribute::obsoletes:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_obsoletes()));
-                break;
-            case PackageAttribute::recommends:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_recommends()));
-                break;
-            case PackageAttribute::suggests:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_suggests()));
-                break;
-            case PackageAttribute::enhances:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_enhances()));
-                break;
-            case PackageAttribute::supplements:
-                dbus_package.emplace(attr, reldeplist_to_strings(libdnf_package.get_supplements()));
-                break;
-            case PackageAttribute::evr:
-                dbus_package.emplace(attr, libdnf_package.get_evr());
-                break;
-            case PackageAttribute::nevra:
-                dbus_package.emplace(attr, libdnf_package.get_nevra());
-                break;
-            case PackageAttribute::full_nevra:
-                dbus_package.emplace(attr, libdnf_package.get_full_nevra());
-                break;
-            case PackageAttribute::reason:
-                dbus_package.emplace(
-                    attr, libdnf5::transaction::transaction_item_reason_to_string(libdnf_package.get_reason()));
-                break;
-            case PackageAttribute::vendor:
-                dbus_package.emplace(attr, libdnf_package.get_vendor());
-                break;
+        dbus_package.emplace(attr, package_attribute_to_variant(libdnf_package, get_package_attribute(attr)));
+    }
+    return dbus_package;
+}
+
+void PackageAttributesCache::check_sack(const libdnf5::rpm::Package & libdnf_package) {
+    auto current_nsolvables = libdnf_package.get_base()->get_rpm_package_sack()->get_nsolvables();
+    if (current_nsolvables != nsolvables || cache.size() > MAX_ENTRIES) {
+        // the packages were added or removed, the ids can refer to other packages now
+        cache.clear();
+        nsolvables = current_nsolvables;
+    }
+}
+
+const sdbus::Variant & PackageAttributesCache::get_cached_attribute(
+    const libdnf5::rpm::Package & libdnf_package, PackageAttribute attribute) {
+    auto key = (static_cast<uint64_t>(libdnf_package.get_id().id) << 8) | static_cast<uint64_t>(attribute);
+    auto cached = cache.find(key);
+    if (cached == cache.end()) {
+        cached = cache.emplace(key, package_attribute_to_variant(libdnf_package, attribute)).first;
+    }
+    return cached->second;
+}
+
+dnfdaemon::KeyValueMap PackageAttributesCache::package_to_map(
+    const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes) {
+    dnfdaemon::KeyValueMap dbus_package;
+    dbus_package.emplace(std::make_pair("id", libdnf_package.get_id().id));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    check_sack(libdnf_package);
+    for (auto & attr : attributes) {
+        auto attribute = get_package_attribute(attr);
+        if (attribute == PackageAttribute::from_repo_id || attribute == PackageAttribute::reason) {
+            // the attributes depend on the state of the system, they are not cached
+            dbus_package.emplace(attr, package_attribute_to_variant(libdnf_package, attribute));
+            continue;
         }
+        dbus_package.emplace(attr, get_cached_attribute(libdnf_package, attribute));
     }
     return dbus_package;
 }
+
+void PackageAttributesCache::write_package(
+    TypedListWriter & writer,
+    const libdnf5::rpm::Package & libdnf_package,
+    const std::vector<PackageAttribute> & attributes) {
+    writer.begin_item();
+    writer.add_field(libdnf_package.get_id().id);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    check_sack(libdnf_package);
+    for (auto attribute : attributes) {
+        if (attribute == PackageAttribute::from_repo_id || attribute == PackageAttribute::reason) {
+            writer.add_field(package_attribute_to_variant(libdnf_package, attribute));
+            continue;
+        }
+        writer.add_field(get_cached_attribute(libdnf_package, attribute));
+    }
+    writer.end_item();
+}
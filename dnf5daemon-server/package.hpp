@@ -21,10 +21,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define DNF5DAEMON_SERVER_PACKAGE_HPP
 
 #include "dbus.hpp"
+#include "typed_list.hpp"
 
 #include <libdnf5/rpm/package.hpp>
 
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // TODO(mblaha): add all other package attributes
@@ -71,4 +75,39 @@ enum class PackageAttribute {
 dnfdaemon::KeyValueMap package_to_map(
     const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes);
 
+// throws std::runtime_error for an unsupported attribute name
+PackageAttribute get_package_attribute(const std::string & attr);
+
+// D-Bus signature of the attribute value
+std::string package_attribute_signature(PackageAttribute attribute);
+
+// Cache of the package attributes converted to D-Bus variants, keyed by the package id and the attribute.
+// The attributes depending on the state of the system (from_repo_id, reason) are not cached. The cache is dropped
+// when the number of solvables in the sack changes.
+class PackageAttributesCache {
+public:
+    dnfdaemon::KeyValueMap package_to_map(
+        const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes);
+
+    // writes the package id followed by the `attributes` of the package as one item of the `writer`
+    void write_package(
+        TypedListWriter & writer,
+        const libdnf5::rpm::Package & libdnf_package,
+        const std::vector<PackageAttribute> & attributes);
+
+private:
+    // drops the cache when the packages in the sack changed, the mutex has to be locked
+    void check_sack(const libdnf5::rpm::Package & libdnf_package);
+    // returns the cached attribute value, the mutex has to be locked
+    const sdbus::Variant & get_cached_attribute(
+        const libdnf5::rpm::Package & libdnf_package, PackageAttribute attribute);
+
+    // the cache is dropped when it grows over the limit
+    static constexpr std::size_t MAX_ENTRIES = 1000000;
+
+    std::mutex mutex;
+    int nsolvables{-1};
+    std::unordered_map<uint64_t, sdbus::Variant> cache;
+};
+
 #endif
@@ -24,6 +24,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "../../utils.hpp"
 #include "utils.hpp"
 
+#include <libdnf5/conf/const.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 #include <sdbus-c++/sdbus-c++.h>
 
@@ -34,6 +35,10 @@ void Advisory::dbus_register() {
     dbus_object->registerMethod(INTERFACE_ADVISORY, "list", "a{sv}", "aa{sv}", [this](sdbus::MethodCall call) -> void {
         session.get_threads_manager().handle_method(*this, &Advisory::list, call, session.session_locale);
     });
+    dbus_object->registerMethod(
+        INTERFACE_ADVISORY, "list_typed", "a{sv}", "v", [this](sdbus::MethodCall call) -> void {
+            session.get_threads_manager().handle_method(*this, &Advisory::list_typed, call, session.session_locale);
+        });
 }
 
 libdnf5::advisory::AdvisoryQuery Advisory::advisory_query_from_options(
@@ -134,27 +139,31 @@ libdnf5::advisory::AdvisoryQuery Advisory::advisory_query_from_options(
     return advisories;
 }
 
+// to decide whether particular advisory package is installed / available / unrelated
+// to the system we need the latest versions of each installed n.a
+std::unordered_map<std::string, libdnf5::rpm::Package> get_installed_versions(libdnf5::Base & base) {
+    libdnf5::rpm::PackageQuery installed_pkgs(base);
+    installed_pkgs.filter_installed();
+    installed_pkgs.filter_latest_evr();
+    // map installed na -> package
+    std::unordered_map<std::string, libdnf5::rpm::Package> installed_versions;
+    for (const auto & pkg : installed_pkgs) {
+        installed_versions.emplace(pkg.get_na(), std::move(pkg));
+    }
+    return installed_versions;
+}
+
 sdbus::MethodReply Advisory::list(sdbus::MethodCall & call) {
     // read options from dbus call
     KeyValueMap options;
     call >> options;
 
-    session.fill_sack();
+    session.fill_sack({libdnf5::METADATA_TYPE_UPDATEINFO});
 
     auto base = session.get_base();
     auto advisory_query = advisory_query_from_options(*base, options);
     auto opt_attrs = key_value_map_get<std::vector<std::string>>(options, "advisory_attrs", {});
-
-    // to decide whether particular advisory package is installed / available / unrelated
-    // to the system we need the latest versions of each installed n.a
-    libdnf5::rpm::PackageQuery installed_pkgs(*base);
-    installed_pkgs.filter_installed();
-    installed_pkgs.filter_latest_evr();
-    // map installed na -> package
-    std::unordered_map<std::string, libdnf5::rpm::Package> installed_versions;
-    for (const auto & pkg : installed_pkgs) {
-        installed_versions.emplace(pkg.get_na(), std::move(pkg));
-    }
+    auto installed_versions = get_installed_versions(*base);
 
     KeyValueMapList advisories;
 
@@ -167,4 +176,27 @@ sdbus::MethodReply Advisory::list(sdbus::MethodCall & call) {
     return reply;
 }
 
+sdbus::MethodReply Advisory::list_typed(sdbus::MethodCall & call) {
+    // read options from dbus call
+    KeyValueMap options;
+    call >> options;
+
+    auto opt_attrs = key_value_map_get<std::vector<std::string>>(options, "advisory_attrs", {});
+    auto fields_signature = advisory_fields_signature(opt_attrs);
+
+    session.fill_sack({libdnf5::METADATA_TYPE_UPDATEINFO});
+
+    auto base = session.get_base();
+    auto advisory_query = advisory_query_from_options(*base, options);
+    auto installed_versions = get_installed_versions(*base);
+
+    auto reply = call.createReply();
+    TypedListWriter writer(reply, fields_signature);
+    for (const auto & advisory : advisory_query) {
+        write_advisory(writer, advisory, opt_attrs, installed_versions);
+    }
+    writer.finish();
+    return reply;
+}
+
 }  // namespace dnfdaemon
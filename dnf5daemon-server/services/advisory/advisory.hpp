@@ -40,6 +40,7 @@ public:
 
 private:
     sdbus::MethodReply list(sdbus::MethodCall & call);
+    sdbus::MethodReply list_typed(sdbus::MethodCall & call);
 
     libdnf5::advisory::AdvisoryQuery advisory_query_from_options(libdnf5::Base & base, const KeyValueMap & options);
 };
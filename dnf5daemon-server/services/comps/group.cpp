@@ -20,9 +20,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "group.hpp"
 
 #include "dbus.hpp"
+#include "typed_list.hpp"
 
 #include <libdnf5/comps/group/group.hpp>
 #include <libdnf5/comps/group/query.hpp>
+#include <libdnf5/conf/const.hpp>
 #include <sdbus-c++/sdbus-c++.h>
 
 #include <iostream>
@@ -56,45 +58,71 @@ const std::map<std::string, GroupAttribute> group_attributes{
     {"repos", GroupAttribute::repos},
 };
 
-dnfdaemon::KeyValueMap group_to_map(libdnf5::comps::Group & libdnf_group, const std::vector<std::string> & attributes) {
-    dnfdaemon::KeyValueMap dbus_group;
-    // add group id by default
-    dbus_group.emplace(std::make_pair("groupid", libdnf_group.get_groupid()));
-    // attributes required by client
+namespace {
+
+GroupAttribute get_group_attribute(const std::string & attr) {
+    auto it = group_attributes.find(attr);
+    if (it == group_attributes.end()) {
+        throw std::runtime_error(fmt::format("Group attribute '{}' not supported", attr));
+    }
+    return it->second;
+}
+
+// D-Bus signature of the attribute value
+std::string group_attribute_signature(GroupAttribute attribute) {
+    switch (attribute) {
+        case GroupAttribute::groupid:
+        case GroupAttribute::name:
+        case GroupAttribute::description:
+        case GroupAttribute::order:
+        case GroupAttribute::langonly:
+            return sdbus::signature_of<std::string>::str();
+        case GroupAttribute::uservisible:
+        case GroupAttribute::is_default:
+        case GroupAttribute::installed:
+            return sdbus::signature_of<bool>::str();
+        case GroupAttribute::repos:
+            return sdbus::signature_of<std::vector<std::string>>::str();
+        case GroupAttribute::packages:
+            return sdbus::signature_of<dnfdaemon::KeyValueMapList>::str();
+    }
+    throw std::runtime_error("Unknown group attribute");
+}
+
+// calls `add(attr, value)` for each of the `attributes` of the group, the value types match group_attribute_signature()
+template <typename AddFn>
+void add_group_attributes(
+    libdnf5::comps::Group & libdnf_group, const std::vector<std::string> & attributes, AddFn && add) {
     for (auto & attr : attributes) {
-        auto it = group_attributes.find(attr);
-        if (it == group_attributes.end()) {
-            throw std::runtime_error(fmt::format("Group attribute '{}' not supported", attr));
-        }
-        switch (it->second) {
+        switch (get_group_attribute(attr)) {
             case GroupAttribute::groupid:
-                // groupid is always included
+                add(attr, libdnf_group.get_groupid());
                 break;
             case GroupAttribute::name:
-                dbus_group.emplace(attr, libdnf_group.get_name());
+                add(attr, libdnf_group.get_name());
                 break;
             case GroupAttribute::description:
-                dbus_group.emplace(attr, libdnf_group.get_description());
+                add(attr, libdnf_group.get_description());
                 break;
             case GroupAttribute::order:
-                dbus_group.emplace(attr, libdnf_group.get_order());
+                add(attr, libdnf_group.get_order());
                 break;
             case GroupAttribute::langonly:
-                dbus_group.emplace(attr, libdnf_group.get_langonly());
+                add(attr, libdnf_group.get_langonly());
                 break;
             case GroupAttribute::uservisible:
-                dbus_group.emplace(attr, libdnf_group.get_uservisible());
+                add(attr, libdnf_group.get_uservisible());
                 break;
             case GroupAttribute::is_default:
-                dbus_group.emplace(attr, libdnf_group.get_default());
+                add(attr, libdnf_group.get_default());
                 break;
             case GroupAttribute::installed:
-                dbus_group.emplace(attr, libdnf_group.get_installed());
+                add(attr, libdnf_group.get_installed());
                 break;
             case GroupAttribute::repos: {
                 auto repos_set = libdnf_group.get_repos();
                 std::vector<std::string> repos(repos_set.begin(), repos_set.end());
-                dbus_group.emplace(attr, repos);
+                add(attr, repos);
                 break;
             }
             case GroupAttribute::packages: {
@@ -106,11 +134,22 @@ dnfdaemon::KeyValueMap group_to_map(libdnf5::comps::Group & libdnf_group, const
                     package.emplace("condition", pkg.get_condition());
                     packages.push_back(std::move(package));
                 }
-                dbus_group.emplace(attr, packages);
+                add(attr, packages);
                 break;
             }
         }
     }
+}
+
+}  // namespace
+
+dnfdaemon::KeyValueMap group_to_map(libdnf5::comps::Group & libdnf_group, const std::vector<std::string> & attributes) {
+    dnfdaemon::KeyValueMap dbus_group;
+    // add group id by default
+    dbus_group.emplace(std::make_pair("groupid", libdnf_group.get_groupid()));
+    // attributes required by client, the already present groupid is not replaced
+    add_group_attributes(
+        libdnf_group, attributes, [&](const std::string & attr, auto && value) { dbus_group.emplace(attr, value); });
     return dbus_group;
 }
 
@@ -121,27 +160,35 @@ void Group::dbus_register() {
         dnfdaemon::INTERFACE_GROUP, "list", "a{sv}", "aa{sv}", [this](sdbus::MethodCall call) -> void {
             session.get_threads_manager().handle_method(*this, &Group::list, call, session.session_locale);
         });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_GROUP, "list_typed", "a{sv}", "v", [this](sdbus::MethodCall call) -> void {
+            session.get_threads_manager().handle_method(*this, &Group::list_typed, call, session.session_locale);
+        });
 }
 
-sdbus::MethodReply Group::list(sdbus::MethodCall & call) {
-    // read options from dbus call
-    dnfdaemon::KeyValueMap options;
-    call >> options;
-
-    session.fill_sack();
-    auto base = session.get_base();
-
+// returns the groups matching the `patterns` list() option
+libdnf5::comps::GroupQuery group_query_from_options(libdnf5::Base & base, const dnfdaemon::KeyValueMap & options) {
     // patterns to search
     std::vector<std::string> patterns =
         key_value_map_get<std::vector<std::string>>(options, "patterns", std::vector<std::string>());
 
-    libdnf5::comps::GroupQuery query(base->get_weak_ptr());
+    libdnf5::comps::GroupQuery query(base.get_weak_ptr());
     if (patterns.size() > 0) {
         libdnf5::comps::GroupQuery query_names(query);
         query_names.filter_name(patterns, libdnf5::sack::QueryCmp::IGLOB);
         query.filter_groupid(patterns, libdnf5::sack::QueryCmp::IGLOB);
         query |= query_names;
     }
+    return query;
+}
+
+sdbus::MethodReply Group::list(sdbus::MethodCall & call) {
+    // read options from dbus call
+    dnfdaemon::KeyValueMap options;
+    call >> options;
+
+    session.fill_sack({libdnf5::METADATA_TYPE_COMPS});
+    auto query = group_query_from_options(*session.get_base(), options);
 
     // create reply from the query
     dnfdaemon::KeyValueMapList out_groups;
@@ -155,3 +202,32 @@ sdbus::MethodReply Group::list(sdbus::MethodCall & call) {
     reply << out_groups;
     return reply;
 }
+
+sdbus::MethodReply Group::list_typed(sdbus::MethodCall & call) {
+    // read options from dbus call
+    dnfdaemon::KeyValueMap options;
+    call >> options;
+
+    // the group id is always the first field
+    std::vector<std::string> attributes =
+        key_value_map_get<std::vector<std::string>>(options, "attributes", std::vector<std::string>{});
+    std::string fields_signature = group_attribute_signature(GroupAttribute::groupid);
+    for (auto & attr : attributes) {
+        fields_signature += group_attribute_signature(get_group_attribute(attr));
+    }
+
+    session.fill_sack({libdnf5::METADATA_TYPE_COMPS});
+    auto query = group_query_from_options(*session.get_base(), options);
+
+    auto reply = call.createReply();
+    TypedListWriter writer(reply, fields_signature);
+    auto add_field = [&writer](const std::string &, auto && value) { writer.add_field(value); };
+    for (auto grp : query.list()) {
+        writer.begin_item();
+        writer.add_field(grp.get_groupid());
+        add_group_attributes(grp, attributes, add_field);
+        writer.end_item();
+    }
+    writer.finish();
+    return reply;
+}
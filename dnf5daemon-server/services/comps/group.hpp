@@ -33,6 +33,7 @@ public:
 
 private:
     sdbus::MethodReply list(sdbus::MethodCall & call);
+    sdbus::MethodReply list_typed(sdbus::MethodCall & call);
 };
 
 #endif
@@ -96,7 +96,7 @@ sdbus::MethodReply Goal::resolve(sdbus::MethodCall & call) {
             "install_size",
             "evr",
             "reason"};
-        for (auto & tspkg : transaction.get_transaction_packages()) {
+        for (const auto & tspkg : transaction.get_transaction_packages_view()) {
             dnfdaemon::KeyValueMap trans_item_attrs{};
             if (tspkg.get_reason_change_group_id()) {
                 trans_item_attrs.emplace("reason_change_group_id", *tspkg.get_reason_change_group_id());
@@ -210,7 +210,7 @@ void download_packages(Session & session, libdnf5::base::Transaction & transacti
 
     // container is owner of package callbacks user_data
     std::vector<std::unique_ptr<dnf5daemon::DownloadUserData>> user_data;
-    for (auto & tspkg : transaction.get_transaction_packages()) {
+    for (const auto & tspkg : transaction.get_transaction_packages_view()) {
         if (transaction_item_action_is_inbound(tspkg.get_action()) &&
             tspkg.get_package().get_repo()->get_type() != libdnf5::repo::Repo::Type::COMMANDLINE) {
             auto & data = user_data.emplace_back(std::make_unique<dnf5daemon::DownloadUserData>());
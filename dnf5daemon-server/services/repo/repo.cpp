@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "repo.hpp"
 
 #include "dbus.hpp"
+#include "typed_list.hpp"
 #include "utils.hpp"
 
 #include <fmt/format.h>
@@ -120,93 +121,135 @@ const static std::map<std::string, RepoAttribute> repo_attributes{
     {"mirrors", RepoAttribute::mirrors},
 };
 
-// converts Repo object to dbus map
-dnfdaemon::KeyValueMap repo_to_map(
+// D-Bus signature of the attribute value
+std::string repo_attribute_signature(RepoAttribute attribute) {
+    switch (attribute) {
+        case RepoAttribute::enabled:
+        case RepoAttribute::skip_if_unavailable:
+        case RepoAttribute::gpgcheck:
+        case RepoAttribute::repo_gpgcheck:
+            return sdbus::signature_of<bool>::str();
+        case RepoAttribute::priority:
+        case RepoAttribute::cost:
+        case RepoAttribute::metadata_expire:
+        case RepoAttribute::updated:
+            return sdbus::signature_of<int32_t>::str();
+        case RepoAttribute::cache_updated:
+            return sdbus::signature_of<int64_t>::str();
+        case RepoAttribute::size:
+        case RepoAttribute::pkgs:
+        case RepoAttribute::available_pkgs:
+            return sdbus::signature_of<uint64_t>::str();
+        case RepoAttribute::baseurl:
+        case RepoAttribute::excludepkgs:
+        case RepoAttribute::includepkgs:
+        case RepoAttribute::gpgkey:
+        case RepoAttribute::content_tags:
+        case RepoAttribute::distro_tags:
+        case RepoAttribute::mirrors:
+            return sdbus::signature_of<std::vector<std::string>>::str();
+        case RepoAttribute::id:
+        case RepoAttribute::name:
+        case RepoAttribute::type:
+        case RepoAttribute::metalink:
+        case RepoAttribute::mirrorlist:
+        case RepoAttribute::proxy:
+        case RepoAttribute::proxy_username:
+        case RepoAttribute::proxy_password:
+        case RepoAttribute::repofile:
+        case RepoAttribute::revision:
+            return sdbus::signature_of<std::string>::str();
+    }
+    throw std::runtime_error("Unknown repo attribute");
+}
+
+// calls `add(attr, value)` for each of the `attributes` of the repo, the value types match repo_attribute_signature()
+template <typename AddFn>
+void add_repo_attributes(
     libdnf5::Base & base,
     const libdnf5::WeakPtr<libdnf5::repo::Repo, false> libdnf_repo,
-    std::vector<std::string> & attributes) {
-    dnfdaemon::KeyValueMap dbus_repo;
-    // attributes required by client
+    const std::vector<std::string> & attributes,
+    AddFn && add) {
     for (auto & attr : attributes) {
         switch (repo_attributes.at(attr)) {
             // configuration
             case RepoAttribute::id:
-                dbus_repo.emplace(attr, libdnf_repo->get_id());
+                add(attr, libdnf_repo->get_id());
                 break;
             case RepoAttribute::name:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_name_option().get_value());
+                add(attr, libdnf_repo->get_config().get_name_option().get_value());
                 break;
             case RepoAttribute::type:
-                dbus_repo.emplace(attr, libdnf_repo->type_to_string(libdnf_repo->get_type()));
+                add(attr, libdnf_repo->type_to_string(libdnf_repo->get_type()));
                 break;
             case RepoAttribute::enabled:
-                dbus_repo.emplace(attr, libdnf_repo->is_enabled());
+                add(attr, libdnf_repo->is_enabled());
                 break;
             case RepoAttribute::priority:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_priority_option().get_value());
+                add(attr, libdnf_repo->get_config().get_priority_option().get_value());
                 break;
             case RepoAttribute::cost:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_cost_option().get_value());
+                add(attr, libdnf_repo->get_config().get_cost_option().get_value());
                 break;
             case RepoAttribute::baseurl:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_baseurl_option().get_value());
+                add(attr, libdnf_repo->get_config().get_baseurl_option().get_value());
                 break;
             case RepoAttribute::metalink: {
                 auto & opt = libdnf_repo->get_config().get_metalink_option();
-                dbus_repo.emplace(attr, (opt.empty() || opt.get_value().empty()) ? "" : opt.get_value());
+                add(attr, (opt.empty() || opt.get_value().empty()) ? "" : opt.get_value());
             } break;
             case RepoAttribute::mirrorlist: {
                 auto & opt = libdnf_repo->get_config().get_mirrorlist_option();
-                dbus_repo.emplace(attr, (opt.empty() || opt.get_value().empty()) ? "" : opt.get_value());
+                add(attr, (opt.empty() || opt.get_value().empty()) ? "" : opt.get_value());
             } break;
             case RepoAttribute::metadata_expire:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_metadata_expire_option().get_value());
+                add(attr, libdnf_repo->get_config().get_metadata_expire_option().get_value());
                 break;
             case RepoAttribute::cache_updated:
-                dbus_repo.emplace(attr, libdnf_repo->get_timestamp());
+                add(attr, libdnf_repo->get_timestamp());
                 break;
             case RepoAttribute::excludepkgs:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_excludepkgs_option().get_value());
+                add(attr, libdnf_repo->get_config().get_excludepkgs_option().get_value());
                 break;
             case RepoAttribute::includepkgs:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_includepkgs_option().get_value());
+                add(attr, libdnf_repo->get_config().get_includepkgs_option().get_value());
                 break;
             case RepoAttribute::skip_if_unavailable:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_skip_if_unavailable_option().get_value());
+                add(attr, libdnf_repo->get_config().get_skip_if_unavailable_option().get_value());
                 break;
 
             // pgp
             case RepoAttribute::gpgkey:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_gpgkey_option().get_value());
+                add(attr, libdnf_repo->get_config().get_gpgkey_option().get_value());
                 break;
             case RepoAttribute::gpgcheck:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_gpgcheck_option().get_value());
+                add(attr, libdnf_repo->get_config().get_gpgcheck_option().get_value());
                 break;
             case RepoAttribute::repo_gpgcheck:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_repo_gpgcheck_option().get_value());
+                add(attr, libdnf_repo->get_config().get_repo_gpgcheck_option().get_value());
                 break;
 
             // proxy
             case RepoAttribute::proxy:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_proxy_option().get_value());
+                add(attr, libdnf_repo->get_config().get_proxy_option().get_value());
                 break;
             case RepoAttribute::proxy_username:
                 //                dbus_repo.emplace(attr, libdnf_repo->get_config().get_proxy_username_option().get_value());
-                dbus_repo.emplace(attr, "user foo");
+                add(attr, "user foo");
                 break;
             case RepoAttribute::proxy_password:
-                dbus_repo.emplace(attr, libdnf_repo->get_config().get_proxy_password_option().get_value());
+                add(attr, libdnf_repo->get_config().get_proxy_password_option().get_value());
                 break;
 
             // require metadata loading
             case RepoAttribute::repofile:
-                dbus_repo.emplace(attr, libdnf_repo->get_repo_file_path());
+                add(attr, libdnf_repo->get_repo_file_path());
                 break;
             case RepoAttribute::revision:
-                dbus_repo.emplace(attr, libdnf_repo->get_revision());
+                add(attr, libdnf_repo->get_revision());
                 break;
             case RepoAttribute::content_tags:
-                dbus_repo.emplace(attr, libdnf_repo->get_content_tags());
+                add(attr, libdnf_repo->get_content_tags());
                 break;
             case RepoAttribute::distro_tags: {
                 // sdbus::Variant cannot accomodate a std::pair
@@ -215,10 +258,10 @@ dnfdaemon::KeyValueMap repo_to_map(
                     distro_tags.emplace_back(dt.first);
                     distro_tags.emplace_back(dt.second);
                 }
-                dbus_repo.emplace(attr, distro_tags);
+                add(attr, distro_tags);
             } break;
             case RepoAttribute::updated:
-                dbus_repo.emplace(attr, libdnf_repo->get_max_timestamp());
+                add(attr, libdnf_repo->get_max_timestamp());
                 break;
             case RepoAttribute::size: {
                 uint64_t size = 0;
@@ -228,26 +271,80 @@ dnfdaemon::KeyValueMap repo_to_map(
                 for (auto pkg : query) {
                     size += pkg.get_download_size();
                 }
-                dbus_repo.emplace(attr, size);
+                add(attr, size);
             } break;
             case RepoAttribute::pkgs: {
                 libdnf5::rpm::PackageQuery query(base, libdnf5::rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
                 query.filter_repo_id({libdnf_repo->get_id()});
-                dbus_repo.emplace(attr, query.size());
+                add(attr, query.size());
             } break;
             case RepoAttribute::available_pkgs: {
                 libdnf5::rpm::PackageQuery query(base);
                 query.filter_repo_id({libdnf_repo->get_id()});
-                dbus_repo.emplace(attr, query.size());
+                add(attr, query.size());
             } break;
             case RepoAttribute::mirrors:
-                dbus_repo.emplace(attr, libdnf_repo->get_mirrors());
+                add(attr, libdnf_repo->get_mirrors());
                 break;
         }
     }
+}
+
+// converts Repo object to dbus map
+dnfdaemon::KeyValueMap repo_to_map(
+    libdnf5::Base & base,
+    const libdnf5::WeakPtr<libdnf5::repo::Repo, false> libdnf_repo,
+    std::vector<std::string> & attributes) {
+    dnfdaemon::KeyValueMap dbus_repo;
+    // attributes required by client
+    add_repo_attributes(base, libdnf_repo, attributes, [&](const std::string & attr, auto && value) {
+        dbus_repo.emplace(attr, value);
+    });
     return dbus_repo;
 }
 
+// checks that the `attributes` are supported and returns whether any of them requires the loaded metadata
+bool is_fill_sack_needed(const std::vector<std::string> & attributes) {
+    bool fill_sack_needed = false;
+    for (auto & attr_str : attributes) {
+        if (repo_attributes.count(attr_str) == 0) {
+            throw std::runtime_error(fmt::format("Repo attribute '{}' not supported", attr_str));
+        }
+        if (!fill_sack_needed) {
+            fill_sack_needed = std::find(
+                                   metadata_required_attributes.begin(),
+                                   metadata_required_attributes.end(),
+                                   repo_attributes.at(attr_str)) != metadata_required_attributes.end();
+        }
+    }
+    return fill_sack_needed;
+}
+
+// returns the available repositories selected by the `enable_disable` and `patterns` list() options
+libdnf5::repo::RepoQuery repo_query_from_options(libdnf5::Base & base, const dnfdaemon::KeyValueMap & options) {
+    std::string enable_disable = key_value_map_get<std::string>(options, "enable_disable", "enabled");
+    std::vector<std::string> patterns =
+        key_value_map_get<std::vector<std::string>>(options, "patterns", std::vector<std::string>{});
+
+    libdnf5::repo::RepoQuery repos_query(base);
+
+    if (enable_disable == "enabled") {
+        repos_query.filter_enabled(true);
+    } else if (enable_disable == "disabled") {
+        repos_query.filter_enabled(false);
+    }
+
+    repos_query.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+
+    if (patterns.size() > 0) {
+        auto query_names = repos_query;
+        query_names.filter_name(patterns, libdnf5::sack::QueryCmp::IGLOB);
+        repos_query.filter_id(patterns, libdnf5::sack::QueryCmp::IGLOB);
+        repos_query |= query_names;
+    }
+    return repos_query;
+}
+
 bool keyval_repo_compare(const dnfdaemon::KeyValueMap & first, const dnfdaemon::KeyValueMap & second) {
     return key_value_map_get<std::string>(first, "id") < key_value_map_get<std::string>(second, "id");
 }
@@ -260,9 +357,13 @@ void Repo::dbus_register() {
         dnfdaemon::INTERFACE_REPO, "list", "a{sv}", "aa{sv}", [this](sdbus::MethodCall call) -> void {
             session.get_threads_manager().handle_method(*this, &Repo::list, call, session.session_locale);
         });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_REPO, "list_typed", "a{sv}", "v", [this](sdbus::MethodCall call) -> void {
+            session.get_threads_manager().handle_method(*this, &Repo::list_typed, call, session.session_locale);
+        });
     dbus_object->registerMethod(
         dnfdaemon::INTERFACE_REPO, "confirm_key", "sb", "", [this](sdbus::MethodCall call) -> void {
-            session.get_threads_manager().handle_method(*this, &Repo::confirm_key, call);
+            session.get_threads_manager().handle_method_concurrently(*this, &Repo::confirm_key, call);
         });
 }
 
@@ -283,60 +384,63 @@ sdbus::MethodReply Repo::confirm_key(sdbus::MethodCall & call) {
 sdbus::MethodReply Repo::list(sdbus::MethodCall & call) {
     dnfdaemon::KeyValueMap options;
     call >> options;
-    const std::vector<std::string> empty_list{};
 
-    // read options from dbus call
-    std::string enable_disable = key_value_map_get<std::string>(options, "enable_disable", "enabled");
-    std::vector<std::string> patterns = key_value_map_get<std::vector<std::string>>(options, "patterns", empty_list);
     // check demanded attributes
     std::vector<std::string> repo_attrs =
-        key_value_map_get<std::vector<std::string>>(options, "repo_attrs", empty_list);
-    bool fill_sack_needed = false;
-    for (auto & attr_str : repo_attrs) {
-        if (repo_attributes.count(attr_str) == 0) {
-            throw std::runtime_error(fmt::format("Repo attribute '{}' not supported", attr_str));
-        }
-        if (!fill_sack_needed) {
-            fill_sack_needed = std::find(
-                                   metadata_required_attributes.begin(),
-                                   metadata_required_attributes.end(),
-                                   repo_attributes.at(attr_str)) != metadata_required_attributes.end();
-        }
+        key_value_map_get<std::vector<std::string>>(options, "repo_attrs", std::vector<std::string>{});
+    if (is_fill_sack_needed(repo_attrs)) {
+        session.fill_sack();
     }
     // always return repoid
     repo_attrs.push_back("id");
-    if (fill_sack_needed) {
-        session.fill_sack();
-    }
 
-    // prepare repository query filtered by options
+    // create reply from the query
     auto base = session.get_base();
-    libdnf5::repo::RepoQuery repos_query(*base);
+    dnfdaemon::KeyValueMapList out_repositories;
 
-    if (enable_disable == "enabled") {
-        repos_query.filter_enabled(true);
-    } else if (enable_disable == "disabled") {
-        repos_query.filter_enabled(false);
+    for (auto & repo : repo_query_from_options(*base, options)) {
+        out_repositories.push_back(repo_to_map(*base, repo, repo_attrs));
     }
 
-    repos_query.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+    std::sort(out_repositories.begin(), out_repositories.end(), keyval_repo_compare);
+    auto reply = call.createReply();
+    reply << out_repositories;
+    return reply;
+}
 
-    if (patterns.size() > 0) {
-        auto query_names = repos_query;
-        query_names.filter_name(patterns, libdnf5::sack::QueryCmp::IGLOB);
-        repos_query.filter_id(patterns, libdnf5::sack::QueryCmp::IGLOB);
-        repos_query |= query_names;
-    }
+sdbus::MethodReply Repo::list_typed(sdbus::MethodCall & call) {
+    dnfdaemon::KeyValueMap options;
+    call >> options;
 
-    // create reply from the query
-    dnfdaemon::KeyValueMapList out_repositories;
+    std::vector<std::string> repo_attrs =
+        key_value_map_get<std::vector<std::string>>(options, "repo_attrs", std::vector<std::string>{});
+    if (is_fill_sack_needed(repo_attrs)) {
+        session.fill_sack();
+    }
+    // the repo id is always the first field
+    std::string fields_signature = repo_attribute_signature(RepoAttribute::id);
+    for (auto & attr : repo_attrs) {
+        fields_signature += repo_attribute_signature(repo_attributes.at(attr));
+    }
 
-    for (auto & repo : repos_query) {
-        out_repositories.push_back(repo_to_map(*base, repo, repo_attrs));
+    auto base = session.get_base();
+    std::vector<libdnf5::repo::RepoWeakPtr> repos;
+    for (auto & repo : repo_query_from_options(*base, options)) {
+        repos.push_back(repo);
     }
+    std::sort(repos.begin(), repos.end(), [](const auto & first, const auto & second) {
+        return first->get_id() < second->get_id();
+    });
 
-    std::sort(out_repositories.begin(), out_repositories.end(), keyval_repo_compare);
     auto reply = call.createReply();
-    reply << out_repositories;
+    TypedListWriter writer(reply, fields_signature);
+    auto add_field = [&writer](const std::string &, auto && value) { writer.add_field(value); };
+    for (auto & repo : repos) {
+        writer.begin_item();
+        writer.add_field(repo->get_id());
+        add_repo_attributes(*base, repo, repo_attrs, add_field);
+        writer.end_item();
+    }
+    writer.finish();
     return reply;
 }
@@ -45,6 +45,10 @@ void Rpm::dbus_register() {
         dnfdaemon::INTERFACE_RPM, "list", "a{sv}", "aa{sv}", [this](sdbus::MethodCall call) -> void {
             session.get_threads_manager().handle_method(*this, &Rpm::list, call, session.session_locale);
         });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_RPM, "list_typed", "a{sv}", "v", [this](sdbus::MethodCall call) -> void {
+            session.get_threads_manager().handle_method(*this, &Rpm::list_typed, call, session.session_locale);
+        });
     dbus_object->registerMethod(
         dnfdaemon::INTERFACE_RPM, "install", "asa{sv}", "", [this](sdbus::MethodCall call) -> void {
             session.get_threads_manager().handle_method(*this, &Rpm::install, call, session.session_locale);
@@ -61,6 +65,7 @@ void Rpm::dbus_register() {
         dnfdaemon::INTERFACE_RPM, "remove", "asa{sv}", "", [this](sdbus::MethodCall call) -> void {
             session.get_threads_manager().handle_method(*this, &Rpm::remove, call, session.session_locale);
         });
+    dbus_object->registerSignal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_PACKAGE_LIST_CHUNK, "oaa{sv}");
 }
 
 std::vector<std::string> get_filter_patterns(dnfdaemon::KeyValueMap options, const std::string & option) {
@@ -82,16 +87,10 @@ libdnf5::rpm::PackageQuery resolve_nevras(libdnf5::rpm::PackageQuery base_query,
     return result;
 }
 
-sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
-    // read options from dbus call
-    dnfdaemon::KeyValueMap options;
-    call >> options;
-
-    session.fill_sack();
-    auto base = session.get_base();
-
+// returns packages matching the scope, patterns and filters of the list() `options`
+libdnf5::rpm::PackageQuery package_query_from_options(libdnf5::Base & base, const dnfdaemon::KeyValueMap & options) {
     // start with all packages
-    libdnf5::rpm::PackageQuery query(*base);
+    libdnf5::rpm::PackageQuery query(base);
 
     // toplevel filtering - the scope
     // TODO(mblaha): support for other possible scopes?
@@ -117,7 +116,7 @@ sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
         key_value_map_get<std::vector<std::string>>(options, "patterns", std::vector<std::string>{});
 
     if (patterns.size() > 0) {
-        libdnf5::rpm::PackageQuery result(*base, libdnf5::sack::ExcludeFlags::APPLY_EXCLUDES, true);
+        libdnf5::rpm::PackageQuery result(base, libdnf5::sack::ExcludeFlags::APPLY_EXCLUDES, true);
         // packages matching flags
         bool with_src = key_value_map_get<bool>(options, "with_src", true);
         libdnf5::ResolveSpecSettings settings{
@@ -259,13 +258,76 @@ sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
         query.filter_latest_evr(key_value_map_get<int>(options, "latest-limit"));
     }
 
+    return query;
+}
+
+// calls `fn` for the packages of the `query` selected by the paging options of the list() `options`,
+// the packages are ordered by their ids
+template <typename PackageFn>
+void for_each_listed_package(
+    const libdnf5::rpm::PackageQuery & query, const dnfdaemon::KeyValueMap & options, PackageFn && fn) {
+    int after_id = key_value_map_get<int>(options, "after_id", -1);
+    int offset = key_value_map_get<int>(options, "offset", 0);
+    int limit = key_value_map_get<int>(options, "limit", -1);
+    if (offset < 0) {
+        throw sdbus::Error(dnfdaemon::ERROR, fmt::format("Invalid offset \"{}\".", offset));
+    }
+    int skipped = 0;
+    int returned = 0;
+    for (const auto & pkg : query) {
+        if (limit >= 0 && returned >= limit) {
+            break;
+        }
+        if (pkg.get_id().id <= after_id) {
+            continue;
+        }
+        if (skipped < offset) {
+            ++skipped;
+            continue;
+        }
+        fn(pkg);
+        ++returned;
+    }
+}
+
+sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
+    // read options from dbus call
+    dnfdaemon::KeyValueMap options;
+    call >> options;
+
+    session.fill_sack();
+    auto query = package_query_from_options(*session.get_base(), options);
+
+    int chunk_size = key_value_map_get<int>(options, "chunk_size", 0);
+    if (chunk_size < 0) {
+        throw sdbus::Error(dnfdaemon::ERROR, fmt::format("Invalid chunk size \"{}\".", chunk_size));
+    }
+
+    auto dbus_object = session.get_dbus_object();
+    auto emit_chunk = [&](const dnfdaemon::KeyValueMapList & packages) {
+        auto signal = dbus_object->createSignal(dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_PACKAGE_LIST_CHUNK);
+        signal.setDestination(session.get_sender());
+        signal << session.get_object_path();
+        signal << packages;
+        dbus_object->emitSignal(signal);
+    };
+
     // create reply from the query
     dnfdaemon::KeyValueMapList out_packages;
     std::vector<std::string> default_attrs{};
     std::vector<std::string> package_attrs =
         key_value_map_get<std::vector<std::string>>(options, "package_attrs", default_attrs);
-    for (const auto & pkg : query) {
-        out_packages.push_back(package_to_map(pkg, package_attrs));
+    auto & package_attributes_cache = session.get_package_attributes_cache();
+    for_each_listed_package(query, options, [&](const libdnf5::rpm::Package & pkg) {
+        out_packages.push_back(package_attributes_cache.package_to_map(pkg, package_attrs));
+        if (chunk_size > 0 && out_packages.size() >= static_cast<std::size_t>(chunk_size)) {
+            emit_chunk(out_packages);
+            out_packages.clear();
+        }
+    });
+    if (chunk_size > 0 && !out_packages.empty()) {
+        emit_chunk(out_packages);
+        out_packages.clear();
     }
 
     auto reply = call.createReply();
@@ -273,6 +335,33 @@ sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
     return reply;
 }
 
+sdbus::MethodReply Rpm::list_typed(sdbus::MethodCall & call) {
+    // read options from dbus call
+    dnfdaemon::KeyValueMap options;
+    call >> options;
+
+    // the attributes are resolved before the packages are listed, an unsupported one fails the call early
+    std::vector<PackageAttribute> package_attrs;
+    std::string fields_signature = sdbus::signature_of<int>::str();
+    for (const auto & attr :
+         key_value_map_get<std::vector<std::string>>(options, "package_attrs", std::vector<std::string>{})) {
+        package_attrs.push_back(get_package_attribute(attr));
+        fields_signature += package_attribute_signature(package_attrs.back());
+    }
+
+    session.fill_sack();
+    auto query = package_query_from_options(*session.get_base(), options);
+
+    auto reply = call.createReply();
+    TypedListWriter writer(reply, fields_signature);
+    auto & package_attributes_cache = session.get_package_attributes_cache();
+    for_each_listed_package(query, options, [&](const libdnf5::rpm::Package & pkg) {
+        package_attributes_cache.write_package(writer, pkg, package_attrs);
+    });
+    writer.finish();
+    return reply;
+}
+
 sdbus::MethodReply Rpm::distro_sync(sdbus::MethodCall & call) {
     std::vector<std::string> specs;
     call >> specs;
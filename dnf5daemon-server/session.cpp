@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "callbacks.hpp"
 #include "dbus.hpp"
+#include "metrics.hpp"
 #include "services/advisory/advisory.hpp"
 #include "services/base/base.hpp"
 #include "services/comps/group.hpp"
@@ -35,8 +36,24 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <chrono>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <string>
 
+namespace {
+
+/// Returns the mutex serializing the updates of the repositories stored in `cachedir`. The sessions are loaded
+/// one after another, so that only the first one downloads the metadata and writes the solv cache while the others
+/// load the cached files instead of downloading and parsing the same metadata concurrently.
+std::mutex & get_repos_update_mutex(const std::string & cachedir) {
+    static std::mutex mutexes_mutex;
+    static std::map<std::string, std::mutex> mutexes;
+    std::lock_guard<std::mutex> lock(mutexes_mutex);
+    return mutexes[cachedir];
+}
+
+}  // namespace
+
 
 Session::Session(
     std::vector<std::unique_ptr<libdnf5::Logger>> && loggers,
@@ -84,6 +101,9 @@ Session::Session(
     // load repo configuration
     base->get_repo_sack()->create_repos_from_system_configuration();
 
+    // the session goal is resolved repeatedly while clients adjust it
+    goal.set_incremental(true);
+
     // instantiate all services provided by the daemon
     services.emplace_back(std::make_unique<Base>(*this));
     services.emplace_back(std::make_unique<RepoConf>(*this));
@@ -150,6 +170,11 @@ void Session::fill_sack() {
     }
 }
 
+void Session::fill_sack(const std::set<std::string> & optional_metadata_types) {
+    fill_sack();
+    base->get_repo_sack()->require_optional_metadata_types(optional_metadata_types);
+}
+
 bool Session::read_all_repos() {
     while (repositories_status == dnfdaemon::RepoStatus::PENDING) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -162,15 +187,17 @@ bool Session::read_all_repos() {
     repositories_status = dnfdaemon::RepoStatus::PENDING;
 
     bool retval = true;
+    auto load_start = std::chrono::steady_clock::now();
 
     bool load_available_repos = session_configuration_value<bool>("load_available_repos", true);
     bool load_system_repo = session_configuration_value<bool>("load_system_repo", true);
     std::vector<std::string> optional_metadata_str =
         session_configuration_value<std::vector<std::string>>("optional_metadata_types", {});
     if (load_available_repos) {
-        auto optional_metadata_types_opt = base->get_config().get_optional_metadata_types_option();
-        for (const auto & type : optional_metadata_str) {
-            optional_metadata_types_opt.add_item(libdnf5::Option::Priority::RUNTIME, type);
+        // The client declares the optional metadata the session needs, the methods needing more load them on demand
+        if (!optional_metadata_str.empty()) {
+            base->get_repo_sack()->require_optional_metadata_types(
+                std::set<std::string>(optional_metadata_str.begin(), optional_metadata_str.end()));
         }
         //auto & logger = base->get_logger();
         libdnf5::repo::RepoQuery enabled_repos(*base);
@@ -185,6 +212,20 @@ bool Session::read_all_repos() {
             repo->set_callbacks(std::make_unique<dnf5daemon::KeyImportRepoCB>(*this));
         }
 
+        // Only downloading the metadata and replacing the cache files is serialized with the other sessions using
+        // the same cachedir. The keys of the repositories are not imported under the lock, the import waits for
+        // the confirmation of the client. A repository that failed here is downloaded again by the load below,
+        // which also imports its keys.
+        {
+            std::lock_guard<std::mutex> update_lock(
+                get_repos_update_mutex(base->get_config().get_cachedir_option().get_value()));
+            try {
+                base->get_repo_sack()->update_repos(enabled_repos, false);
+            } catch (const std::runtime_error & ex) {
+                base->get_logger()->debug("Updating repositories before loading failed: {}", ex.what());
+            }
+        }
+
         try {
             base->get_repo_sack()->update_and_load_enabled_repos(load_system_repo);
         } catch (const std::runtime_error & ex) {
@@ -194,10 +235,29 @@ bool Session::read_all_repos() {
         base->get_repo_sack()->get_system_repo()->load();
     }
 
+    Metrics::get_instance().record_sack_load(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - load_start));
+    if (retval) {
+        auto usage = base->get_repo_sack()->get_memory_usage();
+        std::lock_guard<std::mutex> lock(memory_usage_mutex);
+        memory_usage = std::move(usage);
+    }
     repositories_status = retval ? dnfdaemon::RepoStatus::READY : dnfdaemon::RepoStatus::ERROR;
     return retval;
 }
 
+int Session::get_loaded_solvables() {
+    if (repositories_status != dnfdaemon::RepoStatus::READY) {
+        return 0;
+    }
+    return base->get_rpm_package_sack()->get_nsolvables();
+}
+
+std::optional<libdnf5::repo::MemoryUsage> Session::get_memory_usage() {
+    std::lock_guard<std::mutex> lock(memory_usage_mutex);
+    return memory_usage;
+}
+
 bool Session::check_authorization(const std::string & actionid, const std::string & sender) {
     // create proxy for PolicyKit1 object
     const std::string destination_name = "org.freedesktop.PolicyKit1";
@@ -21,17 +21,21 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define DNF5DAEMON_SERVER_SESSION_HPP
 
 #include "dbus.hpp"
+#include "package.hpp"
 #include "threads_manager.hpp"
 #include "utils.hpp"
 
 #include <libdnf5/base/base.hpp>
 #include <libdnf5/base/goal.hpp>
+#include <libdnf5/repo/memory_usage.hpp>
 #include <sdbus-c++/sdbus-c++.h>
 
 #include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -78,10 +82,18 @@ public:
         transaction.reset(new libdnf5::base::Transaction(src));
     };
     std::string get_sender() const { return sender; };
+    PackageAttributesCache & get_package_attributes_cache() { return package_attributes_cache; };
 
     bool check_authorization(const std::string & actionid, const std::string & sender);
     void fill_sack();
+    /// Loads the repositories like `fill_sack()` and declares the optional metadata `types` needed by the call.
+    /// The types not loaded with the repositories yet are loaded into them on demand.
+    void fill_sack(const std::set<std::string> & optional_metadata_types);
     bool read_all_repos();
+    /// Returns the number of solvables in the sack of the session, 0 until the repositories are loaded
+    int get_loaded_solvables();
+    /// Returns the memory usage of the sack estimated when the repositories were loaded, empty until then
+    std::optional<libdnf5::repo::MemoryUsage> get_memory_usage();
     std::optional<std::string> session_locale;
     void confirm_key(const std::string & key_id, const bool confirmed);
     bool wait_for_key_confirmation(const std::string & key_id, sdbus::Signal & signal);
@@ -94,8 +106,13 @@ private:
     dnfdaemon::KeyValueMap session_configuration;
     std::string object_path;
     std::vector<std::unique_ptr<IDbusSessionService>> services{};
-    ThreadsManager threads_manager;
+    // the methods of a session are run in the order of the calls
+    ThreadsManager threads_manager{ThreadsManager::Mode::SERIALIZED};
+    PackageAttributesCache package_attributes_cache;
     std::atomic<dnfdaemon::RepoStatus> repositories_status{dnfdaemon::RepoStatus::NOT_READY};
+    // computed in the session thread, read by the session manager
+    std::mutex memory_usage_mutex;
+    std::optional<libdnf5::repo::MemoryUsage> memory_usage;
     std::unique_ptr<sdbus::IObject> dbus_object;
     std::string sender;
     // repository key import confirmation
@@ -20,23 +20,36 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "session_manager.hpp"
 
 #include "dbus.hpp"
+#include "metrics.hpp"
 #include "session.hpp"
 
+#include <fmt/format.h>
+#include <libdnf5/base/base.hpp>
 #include <libdnf5/logger/stream_logger.hpp>
+#include <libdnf5/repo/download_callbacks.hpp>
+#include <libdnf5/repo/repo_query.hpp>
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <random>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 SessionManager::SessionManager() {
     connection = sdbus::createSystemBusConnection(dnfdaemon::DBUS_NAME);
     dbus_register();
+    metadata_refresh_thread = std::thread([this]() { run_metadata_refresh(); });
 }
 
 SessionManager::~SessionManager() {
+    stop_metadata_refresh();
+    metadata_refresh_thread.join();
     dbus_object->unregister();
     threads_manager.finish();
 }
@@ -51,6 +64,22 @@ void SessionManager::dbus_register() {
         dnfdaemon::INTERFACE_SESSION_MANAGER, "close_session", "o", "b", [this](sdbus::MethodCall call) -> void {
             threads_manager.handle_method(*this, &SessionManager::close_session, call);
         });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_SESSION_MANAGER,
+        "get_worker_statistics",
+        "",
+        "a{sv}",
+        [this](sdbus::MethodCall call) -> void {
+            threads_manager.handle_method(*this, &SessionManager::get_worker_statistics, call);
+        });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_SESSION_MANAGER, "get_metrics", "", "a{sv}", [this](sdbus::MethodCall call) -> void {
+            threads_manager.handle_method(*this, &SessionManager::get_metrics, call);
+        });
+    dbus_object->registerMethod(
+        dnfdaemon::INTERFACE_SESSION_MANAGER, "get_metrics_text", "", "s", [this](sdbus::MethodCall call) -> void {
+            threads_manager.handle_method(*this, &SessionManager::get_metrics_text, call);
+        });
     dbus_object->finishRegistration();
 
     // register signal handler for NameOwnerChanged
@@ -144,6 +173,297 @@ sdbus::MethodReply SessionManager::close_session(sdbus::MethodCall & call) {
     return reply;
 }
 
+namespace {
+
+dnfdaemon::KeyValueMap worker_statistics_to_map(const WorkerPool::Statistics & statistics) {
+    dnfdaemon::KeyValueMap result;
+    result.emplace("workers", static_cast<uint64_t>(statistics.workers));
+    result.emplace("extra_workers", static_cast<uint64_t>(statistics.extra_workers));
+    result.emplace("running_tasks", static_cast<uint64_t>(statistics.running_tasks));
+    result.emplace("queued_tasks", static_cast<uint64_t>(statistics.queued_tasks));
+    result.emplace("max_queued_tasks", static_cast<uint64_t>(statistics.max_queued_tasks));
+    result.emplace("finished_tasks", static_cast<uint64_t>(statistics.finished_tasks));
+    result.emplace("total_wait_time_us", static_cast<int64_t>(statistics.total_wait_time.count()));
+    result.emplace("max_wait_time_us", static_cast<int64_t>(statistics.max_wait_time.count()));
+    result.emplace("total_run_time_us", static_cast<int64_t>(statistics.total_run_time.count()));
+    return result;
+}
+
+double to_seconds(std::chrono::microseconds duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+/// Sums the memory usage into the areas reported by the metrics
+std::map<std::string, uint64_t> memory_usage_to_areas(const libdnf5::repo::MemoryUsage & usage) {
+    uint64_t repos = 0;
+    for (const auto & repo : usage.repos) {
+        repos += repo.get_total_bytes();
+    }
+    return {
+        {"repos", repos},
+        {"pool", usage.pool_strings_bytes + usage.pool_reldeps_bytes + usage.pool_whatprovides_bytes},
+        {"comps_pool", usage.comps_pool_bytes},
+        {"module_pool", usage.module_pool_bytes},
+        {"indexes", usage.sorted_solvables_bytes + usage.package_indexes_bytes},
+        {"considered_maps", usage.considered_maps_bytes},
+        {"caches", usage.package_caches_bytes + usage.advisory_caches_bytes},
+        {"total", usage.get_total_bytes()}};
+}
+
+}  // namespace
+
+std::map<std::string, std::map<std::string, uint64_t>> SessionManager::get_sessions_memory() {
+    std::map<std::string, std::map<std::string, uint64_t>> result;
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    for (auto & [sender, sender_sessions] : sessions) {
+        for (auto & [session_id, session] : sender_sessions) {
+            if (auto usage = session->get_memory_usage()) {
+                result.emplace(session_id, memory_usage_to_areas(*usage));
+            }
+        }
+    }
+    return result;
+}
+
+std::map<std::string, int> SessionManager::get_sessions_solvables() {
+    std::map<std::string, int> result;
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    for (auto & [sender, sender_sessions] : sessions) {
+        for (auto & [session_id, session] : sender_sessions) {
+            result.emplace(session_id, session->get_loaded_solvables());
+        }
+    }
+    return result;
+}
+
+sdbus::MethodReply SessionManager::get_worker_statistics(sdbus::MethodCall & call) {
+    auto reply = call.createReply();
+    reply << worker_statistics_to_map(WorkerPool::get_instance().get_statistics());
+    return reply;
+}
+
+sdbus::MethodReply SessionManager::get_metrics(sdbus::MethodCall & call) {
+    auto sessions_solvables = get_sessions_solvables();
+    auto sessions_memory = get_sessions_memory();
+    auto statistics = Metrics::get_instance().get_statistics();
+
+    std::map<std::string, dnfdaemon::KeyValueMap> methods;
+    for (const auto & [method, method_statistics] : statistics.methods) {
+        dnfdaemon::KeyValueMap dbus_method;
+        dbus_method.emplace("calls", method_statistics.calls);
+        dbus_method.emplace("failures", method_statistics.failures);
+        dbus_method.emplace("total_time_us", static_cast<int64_t>(method_statistics.total_time.count()));
+        dbus_method.emplace(
+            "histogram",
+            std::vector<uint64_t>(method_statistics.histogram.begin(), method_statistics.histogram.end()));
+        methods.emplace(method, std::move(dbus_method));
+    }
+
+    dnfdaemon::KeyValueMap result;
+    result.emplace("sessions", static_cast<uint64_t>(sessions_solvables.size()));
+    result.emplace("session_solvables", sessions_solvables);
+    result.emplace("session_memory", sessions_memory);
+    result.emplace("methods", methods);
+    result.emplace(
+        "duration_buckets_us",
+        std::vector<int64_t>(Metrics::DURATION_BUCKETS_US.begin(), Metrics::DURATION_BUCKETS_US.end()));
+    result.emplace("sack_loads", statistics.sack_loads);
+    result.emplace("sack_load_total_time_us", static_cast<int64_t>(statistics.sack_load_total_time.count()));
+    result.emplace("sack_load_max_time_us", static_cast<int64_t>(statistics.sack_load_max_time.count()));
+    result.emplace("downloads", statistics.downloads);
+    result.emplace("downloaded_bytes", statistics.downloaded_bytes);
+    result.emplace("download_time_us", static_cast<int64_t>(statistics.download_time.count()));
+    result.emplace("workers", worker_statistics_to_map(WorkerPool::get_instance().get_statistics()));
+
+    auto reply = call.createReply();
+    reply << result;
+    return reply;
+}
+
+sdbus::MethodReply SessionManager::get_metrics_text(sdbus::MethodCall & call) {
+    auto sessions_solvables = get_sessions_solvables();
+    auto sessions_memory = get_sessions_memory();
+    auto statistics = Metrics::get_instance().get_statistics();
+    auto workers = WorkerPool::get_instance().get_statistics();
+
+    std::string text;
+    auto out = std::back_inserter(text);
+    fmt::format_to(out, "# TYPE dnf5daemon_sessions gauge\ndnf5daemon_sessions {}\n", sessions_solvables.size());
+    fmt::format_to(out, "# TYPE dnf5daemon_session_solvables gauge\n");
+    for (const auto & [session_id, solvables] : sessions_solvables) {
+        fmt::format_to(out, "dnf5daemon_session_solvables{{session=\"{}\"}} {}\n", session_id, solvables);
+    }
+    fmt::format_to(out, "# TYPE dnf5daemon_session_memory_bytes gauge\n");
+    for (const auto & [session_id, areas] : sessions_memory) {
+        for (const auto & [area, bytes] : areas) {
+            fmt::format_to(
+                out, "dnf5daemon_session_memory_bytes{{session=\"{}\",area=\"{}\"}} {}\n", session_id, area, bytes);
+        }
+    }
+
+    fmt::format_to(out, "# TYPE dnf5daemon_method_calls counter\n");
+    for (const auto & [method, method_statistics] : statistics.methods) {
+        fmt::format_to(out, "dnf5daemon_method_calls_total{{method=\"{}\"}} {}\n", method, method_statistics.calls);
+    }
+    fmt::format_to(out, "# TYPE dnf5daemon_method_failures counter\n");
+    for (const auto & [method, method_statistics] : statistics.methods) {
+        fmt::format_to(
+            out, "dnf5daemon_method_failures_total{{method=\"{}\"}} {}\n", method, method_statistics.failures);
+    }
+    fmt::format_to(out, "# TYPE dnf5daemon_method_duration_seconds histogram\n");
+    for (const auto & [method, method_statistics] : statistics.methods) {
+        uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < method_statistics.histogram.size(); ++i) {
+            cumulative += method_statistics.histogram[i];
+            auto bound = i < Metrics::DURATION_BUCKETS_US.size()
+                             ? fmt::format("{}", static_cast<double>(Metrics::DURATION_BUCKETS_US[i]) / 1e6)
+                             : std::string("+Inf");
+            fmt::format_to(
+                out,
+                "dnf5daemon_method_duration_seconds_bucket{{method=\"{}\",le=\"{}\"}} {}\n",
+                method,
+                bound,
+                cumulative);
+        }
+        fmt::format_to(
+            out,
+            "dnf5daemon_method_duration_seconds_sum{{method=\"{}\"}} {}\n",
+            method,
+            to_seconds(method_statistics.total_time));
+        fmt::format_to(
+            out, "dnf5daemon_method_duration_seconds_count{{method=\"{}\"}} {}\n", method, method_statistics.calls);
+    }
+
+    fmt::format_to(
+        out, "# TYPE dnf5daemon_sack_loads counter\ndnf5daemon_sack_loads_total {}\n", statistics.sack_loads);
+    fmt::format_to(
+        out,
+        "# TYPE dnf5daemon_sack_load_seconds counter\ndnf5daemon_sack_load_seconds_total {}\n",
+        to_seconds(statistics.sack_load_total_time));
+    fmt::format_to(
+        out,
+        "# TYPE dnf5daemon_sack_load_max_seconds gauge\ndnf5daemon_sack_load_max_seconds {}\n",
+        to_seconds(statistics.sack_load_max_time));
+    fmt::format_to(out, "# TYPE dnf5daemon_downloads counter\ndnf5daemon_downloads_total {}\n", statistics.downloads);
+    fmt::format_to(
+        out,
+        "# TYPE dnf5daemon_downloaded_bytes counter\ndnf5daemon_downloaded_bytes_total {}\n",
+        statistics.downloaded_bytes);
+    fmt::format_to(
+        out,
+        "# TYPE dnf5daemon_download_seconds counter\ndnf5daemon_download_seconds_total {}\n",
+        to_seconds(statistics.download_time));
+
+    fmt::format_to(out, "# TYPE dnf5daemon_workers gauge\ndnf5daemon_workers {}\n", workers.workers);
+    fmt::format_to(out, "# TYPE dnf5daemon_extra_workers gauge\ndnf5daemon_extra_workers {}\n", workers.extra_workers);
+    fmt::format_to(out, "# TYPE dnf5daemon_running_tasks gauge\ndnf5daemon_running_tasks {}\n", workers.running_tasks);
+    fmt::format_to(out, "# TYPE dnf5daemon_queued_tasks gauge\ndnf5daemon_queued_tasks {}\n", workers.queued_tasks);
+    fmt::format_to(
+        out, "# TYPE dnf5daemon_finished_tasks counter\ndnf5daemon_finished_tasks_total {}\n", workers.finished_tasks);
+    fmt::format_to(
+        out,
+        "# TYPE dnf5daemon_task_wait_seconds counter\ndnf5daemon_task_wait_seconds_total {}\n",
+        to_seconds(workers.total_wait_time));
+    fmt::format_to(out, "# EOF\n");
+
+    auto reply = call.createReply();
+    reply << text;
+    return reply;
+}
+
+namespace {
+
+/// Aborts the downloads of the background refresh once the daemon is stopping.
+class RefreshDownloadCallbacks : public libdnf5::repo::DownloadCallbacks {
+public:
+    explicit RefreshDownloadCallbacks(const std::atomic<bool> & stopping) : stopping(stopping) {}
+
+    // the return values are the librepo LrCbReturnCode, 1 is LR_CB_ABORT
+    int progress(void *, double, double) override { return stopping ? 1 : 0; }
+    int mirror_failure(void *, const char *, const char *, const char *) override { return stopping ? 1 : 0; }
+
+private:
+    const std::atomic<bool> & stopping;
+};
+
+/// Returns the interval of the background refresh in seconds. The refresh is opt-in, it is enabled only when
+/// `metadata_timer_sync` is explicitly set to a positive value in the configuration.
+int get_metadata_refresh_interval() {
+    try {
+        libdnf5::Base base;
+        base.load_config();
+        auto & timer_sync = base.get_config().get_metadata_timer_sync_option();
+        if (timer_sync.get_priority() <= libdnf5::Option::Priority::DEFAULT) {
+            return 0;
+        }
+        return timer_sync.get_value();
+    } catch (const std::exception & ex) {
+        std::cerr << fmt::format("Error reading the metadata refresh configuration: {}", ex.what()) << std::endl;
+    }
+    return 0;
+}
+
+/// Downloads the expired metadata of the enabled repositories and writes their solv cache, so that new sessions
+/// find the metadata fresh and only load the cached files.
+/// The metadata are downloaded into temporary directories and swapped into the cache under its file lock, so the
+/// refresh does not block the sessions. It stops as soon as possible once `stopping` is set.
+void refresh_metadata(const std::atomic<bool> & stopping) {
+    std::vector<std::unique_ptr<libdnf5::Logger>> loggers;
+    loggers.emplace_back(std::make_unique<libdnf5::StdCStreamLogger>(std::cerr));
+    libdnf5::Base base(std::move(loggers));
+    try {
+        base.load_config();
+        // the periodic refresh must not compete with the workload of the system, unless configured otherwise
+        auto & background_mode = base.get_config().get_background_mode_option();
+        if (background_mode.get_priority() <= libdnf5::Option::Priority::DEFAULT) {
+            background_mode.set(libdnf5::Option::Priority::RUNTIME, true);
+        }
+        base.setup();
+        base.set_download_callbacks(std::make_unique<RefreshDownloadCallbacks>(stopping));
+        base.get_repo_sack()->create_repos_from_system_configuration();
+        if (stopping) {
+            return;
+        }
+        libdnf5::repo::RepoQuery repos(base);
+        repos.filter_enabled(true);
+        repos.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+        // nobody can confirm a key import in the background
+        base.get_repo_sack()->update_repos(repos, false);
+    } catch (const std::exception & ex) {
+        if (!stopping) {
+            std::cerr << fmt::format("Error refreshing repositories metadata: {}", ex.what()) << std::endl;
+        }
+    }
+}
+
+}  // namespace
+
+void SessionManager::run_metadata_refresh() {
+    std::unique_lock<std::mutex> lock(metadata_refresh_mutex);
+    while (!metadata_refresh_stopping) {
+        lock.unlock();
+        auto interval = get_metadata_refresh_interval();
+        lock.lock();
+        if (interval <= 0) {
+            break;
+        }
+        // the first refresh is delayed as well, the daemon start must not trigger downloads
+        if (metadata_refresh_cond.wait_for(
+                lock, std::chrono::seconds(interval), [this]() { return metadata_refresh_stopping.load(); })) {
+            break;
+        }
+        lock.unlock();
+        refresh_metadata(metadata_refresh_stopping);
+        lock.lock();
+    }
+}
+
+void SessionManager::stop_metadata_refresh() {
+    std::lock_guard<std::mutex> lock(metadata_refresh_mutex);
+    metadata_refresh_stopping = true;
+    metadata_refresh_cond.notify_all();
+}
+
 void SessionManager::start_event_loop() {
     connection->enterEventLoop();
 };
@@ -154,6 +474,7 @@ void SessionManager::shut_down() {
     if (active) {
         // prevent opening a new session
         active = false;
+        stop_metadata_refresh();
         std::lock_guard<std::mutex> lock(sessions_mutex);
         // wait for current sessions to finish and delete them
         sessions.clear();
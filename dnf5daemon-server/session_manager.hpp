@@ -25,10 +25,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 class SessionManager {
 public:
@@ -51,10 +55,25 @@ private:
     // map {sender_address: {session_id: Session object}}
     std::map<std::string, std::map<std::string, std::unique_ptr<Session>>> sessions;
 
+    // background refresh of the repositories metadata
+    std::mutex metadata_refresh_mutex;
+    std::condition_variable metadata_refresh_cond;
+    std::atomic<bool> metadata_refresh_stopping{false};
+    std::thread metadata_refresh_thread;
+
     void dbus_register();
     sdbus::MethodReply open_session(sdbus::MethodCall & call);
     sdbus::MethodReply close_session(sdbus::MethodCall & call);
+    sdbus::MethodReply get_worker_statistics(sdbus::MethodCall & call);
+    sdbus::MethodReply get_metrics(sdbus::MethodCall & call);
+    sdbus::MethodReply get_metrics_text(sdbus::MethodCall & call);
+    /// Returns the number of loaded solvables of each session
+    std::map<std::string, int> get_sessions_solvables();
+    /// Returns the estimated memory usage in bytes of each session with loaded repositories, broken down by area
+    std::map<std::string, std::map<std::string, uint64_t>> get_sessions_memory();
     void on_name_owner_changed(sdbus::Signal & signal);
+    void run_metadata_refresh();
+    void stop_metadata_refresh();
 };
 
 #endif
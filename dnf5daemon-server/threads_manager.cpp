@@ -25,65 +25,148 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <chrono>
-#include <iostream>
-
-ThreadsManager::ThreadsManager() {
-    // collecting finished worker threads
-    running_threads_collector = std::thread([this]() {
-        while (!finish_collector) {
-            join_threads(true);
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    });
+
+namespace {
+
+// minimal number of the persistent workers, the D-Bus calls of the clients often wait for I/O
+constexpr std::size_t MIN_WORKERS = 4;
+
+}  // namespace
+
+
+WorkerPool & WorkerPool::get_instance() {
+    static WorkerPool pool(std::max<std::size_t>(std::thread::hardware_concurrency(), MIN_WORKERS));
+    return pool;
 }
 
-ThreadsManager::~ThreadsManager() {
-    finish();
+WorkerPool::WorkerPool(std::size_t num_workers) {
+    statistics.workers = num_workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back([this]() { run_worker(false); });
+    }
 }
 
-void ThreadsManager::register_thread(std::thread && thread) {
-    std::lock_guard<std::mutex> lock(running_threads_mutex);
-    running_threads.emplace_back(std::move(thread));
+WorkerPool::~WorkerPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        tasks_cond.notify_all();
+        extra_workers_cond.wait(lock, [this]() { return statistics.extra_workers == 0; });
+    }
+    for (auto & worker : workers) {
+        worker.join();
+    }
 }
 
-void ThreadsManager::mark_thread_finished(std::thread::id thread_id) {
-    std::lock_guard<std::mutex> lock(running_threads_mutex);
-    finished_threads.emplace_back(std::move(thread_id));
+void WorkerPool::submit(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back({std::move(task), std::chrono::steady_clock::now()});
+    statistics.max_queued_tasks = std::max(statistics.max_queued_tasks, tasks.size());
+    if (idle_workers >= tasks.size()) {
+        tasks_cond.notify_one();
+    } else {
+        // all the workers are busy, the extra worker exits once the queue is empty
+        ++statistics.extra_workers;
+        std::thread([this]() { run_worker(true); }).detach();
+    }
 }
 
-void ThreadsManager::join_threads(const bool only_finished) {
-    std::vector<std::thread> to_be_joined{};
+WorkerPool::Statistics WorkerPool::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto result = statistics;
+    result.queued_tasks = tasks.size();
+    return result;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(running_threads_mutex);
-        for (auto thread = running_threads.begin(); thread < running_threads.end();) {
-            auto in_finished = std::find(finished_threads.begin(), finished_threads.end(), thread->get_id());
-            if (thread->joinable() && (!only_finished || (in_finished != finished_threads.end()))) {
-                to_be_joined.push_back(std::move(*thread));
-                running_threads.erase(thread);
-                if (in_finished != finished_threads.end()) {
-                    finished_threads.erase(in_finished);
-                }
-            } else {
-                ++thread;
+void WorkerPool::run_worker(bool extra) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (tasks.empty()) {
+            if (extra || stopping) {
+                break;
             }
+            ++idle_workers;
+            tasks_cond.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            --idle_workers;
+            continue;
         }
-    }
 
-    for (auto thread = to_be_joined.begin(); thread < to_be_joined.end(); ++thread) {
-        // join the thread and remove it from registry
-        thread->join();
+        auto queued_task = std::move(tasks.front());
+        tasks.pop_front();
+        auto start_time = std::chrono::steady_clock::now();
+        auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(start_time - queued_task.queued_time);
+        statistics.total_wait_time += wait_time;
+        statistics.max_wait_time = std::max(statistics.max_wait_time, wait_time);
+        ++statistics.running_tasks;
+        lock.unlock();
+
+        queued_task.task();
+        auto run_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+        lock.lock();
+        --statistics.running_tasks;
+        ++statistics.finished_tasks;
+        statistics.total_run_time += run_time;
+    }
+    if (extra) {
+        --statistics.extra_workers;
+        extra_workers_cond.notify_all();
     }
 }
 
-void ThreadsManager::finish() {
-    if (!running_threads_collector.joinable()) {
+
+ThreadsManager::~ThreadsManager() {
+    finish();
+}
+
+void ThreadsManager::submit(std::function<void()> task, bool serialized) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finishing) {
+        return;
+    }
+    ++unfinished_tasks;
+    if (!serialized) {
+        WorkerPool::get_instance().submit([this, task = std::move(task)]() {
+            task();
+            task_finished();
+        });
         return;
     }
-    // join all threads
-    finish_collector = true;
-    join_threads(false);
-    running_threads_collector.join();
+    serialized_tasks.push_back(std::move(task));
+    if (!serialized_tasks_running) {
+        // only one worker at a time runs the serialized tasks to keep them in order
+        serialized_tasks_running = true;
+        WorkerPool::get_instance().submit([this]() { run_serialized_tasks(); });
+    }
+}
+
+void ThreadsManager::run_serialized_tasks() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!serialized_tasks.empty()) {
+        auto task = std::move(serialized_tasks.front());
+        serialized_tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        // the manager can be destroyed once the last task is finished and the mutex is unlocked
+        --unfinished_tasks;
+        finished_cond.notify_all();
+    }
+    serialized_tasks_running = false;
+}
+
+void ThreadsManager::task_finished() {
+    std::lock_guard<std::mutex> lock(mutex);
+    --unfinished_tasks;
+    finished_cond.notify_all();
+}
+
+void ThreadsManager::finish() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finishing = true;
+    finished_cond.wait(lock, [this]() { return unfinished_tasks == 0; });
 }
 
 
@@ -98,5 +181,7 @@ locale_t ThreadsManager::set_thread_locale(const std::string & thread_locale, lo
         freelocale(new_locale);
         throw libdnf5::SystemError(errno, M_("Failed to use locale \"{}\"."), thread_locale);
     }
+    // the translations cached by the worker thread can be in the locale of another session
+    b_gettext_cache_use_locale(thread_locale.c_str());
     return orig_locale;
 }
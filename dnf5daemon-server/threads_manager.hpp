@@ -21,92 +21,123 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
 
 #include "dbus.hpp"
+#include "metrics.hpp"
 
 #include <fmt/format.h>
+#include <libdnf5/utils/bgettext/bgettext-common.h>
 #include <locale.h>
 #include <sdbus-c++/sdbus-c++.h>
 
-#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <optional>
 #include <thread>
 #include <vector>
 
+/// Pool of worker threads shared by all the D-Bus method and signal handlers of the server. The persistent
+/// workers are started once and wait for tasks. When all of them are busy, an extra worker is started for the task
+/// and it exits when there are no more queued tasks. The tasks can block waiting for another task (e.g. a transaction
+/// waits for the confirmation of a key import), the extra workers prevent such tasks from starving the pool.
+class WorkerPool {
+public:
+    struct Statistics {
+        /// Number of persistent workers
+        std::size_t workers{0};
+        /// Number of extra workers currently running
+        std::size_t extra_workers{0};
+        /// Number of tasks being run
+        std::size_t running_tasks{0};
+        /// Number of tasks waiting for a worker
+        std::size_t queued_tasks{0};
+        /// Highest number of tasks waiting for a worker
+        std::size_t max_queued_tasks{0};
+        /// Number of finished tasks
+        std::uint64_t finished_tasks{0};
+        /// Total and highest time the tasks waited for a worker
+        std::chrono::microseconds total_wait_time{0};
+        std::chrono::microseconds max_wait_time{0};
+        /// Total time of running the tasks
+        std::chrono::microseconds total_run_time{0};
+    };
+
+    /// Returns the pool of the server, it is created with the first use.
+    static WorkerPool & get_instance();
+
+    explicit WorkerPool(std::size_t num_workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool & operator=(const WorkerPool &) = delete;
+
+    /// Queues the `task` to be run by a worker. The task must not throw exceptions.
+    void submit(std::function<void()> task);
+
+    Statistics get_statistics() const;
+
+private:
+    struct QueuedTask {
+        std::function<void()> task;
+        std::chrono::steady_clock::time_point queued_time;
+    };
+
+    /// Runs the queued tasks, an extra worker returns when the queue is empty.
+    void run_worker(bool extra);
+
+    mutable std::mutex mutex;
+    std::condition_variable tasks_cond;
+    std::deque<QueuedTask> tasks;
+    std::vector<std::thread> workers;
+    std::size_t idle_workers{0};
+    bool stopping{false};
+    Statistics statistics;
+    // notified when an extra worker exits
+    std::condition_variable extra_workers_cond;
+};
+
+/// Runs the D-Bus method and signal handlers of an object (the session manager or a session) in the workers
+/// of the `WorkerPool`. In the `SERIALIZED` mode the methods are run one after another in the order of the calls,
+/// different objects still run in parallel.
 class ThreadsManager {
 public:
-    ThreadsManager();
+    enum class Mode { CONCURRENT, SERIALIZED };
+
+    explicit ThreadsManager(Mode mode = Mode::CONCURRENT) : mode(mode) {}
     virtual ~ThreadsManager();
-    void register_thread(std::thread && thread);
-    void mark_thread_finished(std::thread::id thread_id);
-    void current_thread_finished() { mark_thread_finished(std::this_thread::get_id()); };
-    void join_threads(const bool only_finished);
+
+    /// Waits until all the submitted tasks are finished. No more tasks are accepted then.
     void finish();
 
+    /// Runs the `method` of the `service` as a reply to the `call`, in the order of the calls in the `SERIALIZED`
+    /// mode.
     template <class S>
     void handle_method(
         S & service,
         sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
         sdbus::MethodCall & call,
         std::optional<std::string> thread_locale = std::nullopt) {
-        auto worker = std::thread(
-            [this](
-                S & service,
-                sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
-                sdbus::MethodCall call,
-                std::optional<std::string> thread_locale = std::nullopt) {
-                locale_t new_locale{nullptr};
-                locale_t orig_locale{nullptr};
-                if (thread_locale) {
-                    orig_locale = set_thread_locale(thread_locale.value(), new_locale);
-                }
-
-                sdbus::MethodReply reply;
-                try {
-                    reply = (service.*method)(call);
-                } catch (const sdbus::Error & ex) {
-                    reply = call.createErrorReply(ex);
-                } catch (const std::exception & ex) {
-                    reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, ex.what()));
-                } catch (...) {
-                    reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, "Unknown exception caught"));
-                }
-                bool success = false;
-                std::string error_msg;
-                try {
-                    reply.send();
-                    success = true;
-                } catch (const std::exception & e) {
-                    error_msg = e.what();
-                } catch (...) {
-                    error_msg = "Unknown exception caught";
-                }
-                if (!success) {
-                    std::cerr << fmt::format(
-                                     "Error sending D-Bus reply to {}:{}() call: {}",
-                                     call.getInterfaceName(),
-                                     call.getMemberName(),
-                                     error_msg)
-                              << std::endl;
-                }
+        submit(make_method_task(service, method, call, std::move(thread_locale)), mode == Mode::SERIALIZED);
+    }
 
-                if (thread_locale) {
-                    uselocale(orig_locale);
-                    freelocale(new_locale);
-                }
-                current_thread_finished();
-            },
-            std::ref(service),
-            method,
-            call,
-            thread_locale);
-        register_thread(std::move(worker));
+    /// Runs the `method` of the `service` as a reply to the `call` immediately, even in the `SERIALIZED` mode.
+    /// Intended for the methods that answer a running method, e.g. the confirmation of a key import.
+    template <class S>
+    void handle_method_concurrently(
+        S & service,
+        sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
+        sdbus::MethodCall & call,
+        std::optional<std::string> thread_locale = std::nullopt) {
+        submit(make_method_task(service, method, call, std::move(thread_locale)), false);
     }
 
     template <class S>
     void handle_signal(S & service, void (S::*method)(sdbus::Signal &), sdbus::Signal & signal) {
-        auto worker = std::thread(
-            [this](S & service, void (S::*method)(sdbus::Signal &), sdbus::Signal signal) {
+        submit(
+            [&service, method, signal]() mutable {
                 bool success = false;
                 std::string error_msg;
                 try {
@@ -125,25 +156,88 @@ public:
                                      error_msg)
                               << std::endl;
                 }
-                current_thread_finished();
             },
-            std::ref(service),
-            method,
-            signal);
-        register_thread(std::move(worker));
+            false);
     }
 
 private:
-    std::mutex running_threads_mutex;
-    // flag whether to break the finished threads collector infinite loop
-    std::atomic<bool> finish_collector{false};
-    // thread that joins finished worker threads
-    std::thread running_threads_collector;
-    // vector of started worker threads
-    std::vector<std::thread> running_threads{};
-    // vector of finished threads id
-    std::vector<std::thread::id> finished_threads{};
+    template <class S>
+    static std::function<void()> make_method_task(
+        S & service,
+        sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
+        sdbus::MethodCall & call,
+        std::optional<std::string> thread_locale) {
+        return [&service, method, call, thread_locale]() mutable {
+            locale_t new_locale{nullptr};
+            locale_t orig_locale{nullptr};
+
+            sdbus::MethodReply reply;
+            bool failed = true;
+            auto start_time = std::chrono::steady_clock::now();
+            try {
+                if (thread_locale) {
+                    orig_locale = set_thread_locale(thread_locale.value(), new_locale);
+                }
+                reply = (service.*method)(call);
+                failed = false;
+            } catch (const sdbus::Error & ex) {
+                reply = call.createErrorReply(ex);
+            } catch (const std::exception & ex) {
+                reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, ex.what()));
+            } catch (...) {
+                reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, "Unknown exception caught"));
+            }
+            Metrics::get_instance().record_method_call(
+                fmt::format("{}.{}", call.getInterfaceName(), call.getMemberName()),
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time),
+                failed);
+            bool success = false;
+            std::string error_msg;
+            try {
+                reply.send();
+                success = true;
+            } catch (const std::exception & e) {
+                error_msg = e.what();
+            } catch (...) {
+                error_msg = "Unknown exception caught";
+            }
+            if (!success) {
+                std::cerr << fmt::format(
+                                 "Error sending D-Bus reply to {}:{}() call: {}",
+                                 call.getInterfaceName(),
+                                 call.getMemberName(),
+                                 error_msg)
+                          << std::endl;
+            }
+
+            if (orig_locale) {
+                uselocale(orig_locale);
+                b_gettext_cache_use_locale(nullptr);
+                freelocale(new_locale);
+            }
+        };
+    }
+
+    /// Submits the `task` to the pool, a `serialized` task is queued after the previous serialized tasks.
+    void submit(std::function<void()> task, bool serialized);
+
+    /// Runs the queued serialized tasks one after another until the queue is empty.
+    void run_serialized_tasks();
+
+    void task_finished();
+
     static locale_t set_thread_locale(const std::string & thread_locale, locale_t & new_locale);
+
+    const Mode mode;
+    std::mutex mutex;
+    std::condition_variable finished_cond;
+    // the serialized tasks waiting for the previous ones
+    std::deque<std::function<void()>> serialized_tasks;
+    // whether a worker is running the serialized tasks
+    bool serialized_tasks_running{false};
+    // number of the submitted tasks that are not finished yet
+    std::size_t unfinished_tasks{0};
+    bool finishing{false};
 };
 
 #endif
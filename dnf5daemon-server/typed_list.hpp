@@ -0,0 +1,64 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DNF5DAEMON_SERVER_TYPED_LIST_HPP
+#define DNF5DAEMON_SERVER_TYPED_LIST_HPP
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <string>
+#include <utility>
+
+// Writes a list of objects to a D-Bus message as a variant holding an array of structs. The fields of the structs
+// are the attributes requested by the client in the requested order, so the signature of the array is known only
+// at runtime. Unlike an array of key/value maps, the attribute names are not repeated for every object and
+// the values are not boxed in variants.
+class TypedListWriter {
+public:
+    // `fields_signature` is the D-Bus signature of the struct fields without the parentheses
+    TypedListWriter(sdbus::Message & message, std::string fields_signature)
+        : message(message),
+          fields_signature(std::move(fields_signature)) {
+        this->message.openVariant("a(" + this->fields_signature + ")");
+        this->message.openContainer("(" + this->fields_signature + ")");
+    }
+
+    void begin_item() { message.openStruct(fields_signature); }
+    void end_item() { message.closeStruct(); }
+
+    template <typename T>
+    void add_field(const T & value) {
+        message << value;
+    }
+
+    // the value of the variant is written as the struct field, without the variant wrapping
+    void add_field(const sdbus::Variant & value) { value.serializeTo(message); }
+
+    // closes the array and the variant, must be called once after the last item
+    void finish() {
+        message.closeContainer();
+        message.closeVariant();
+    }
+
+private:
+    sdbus::Message & message;
+    std::string fields_signature;
+};
+
+#endif
@@ -423,6 +423,7 @@ public:
     class Command : public Argument {
     public:
         using ParseHookFunc = std::function<bool(Command * arg, const char * cmd, int argc, const char * const argv[])>;
+        using SetupFunc = std::function<void()>;
 
         /// Parses input. The input may contain named arguments, (sub)commands and positional arguments.
         virtual void parse(const char * option, int argc, const char * const argv[]) = 0;
@@ -475,6 +476,14 @@ public:
         /// Gets the user function for parsing the argument.
         virtual const ParseHookFunc & get_parse_hook_func() const noexcept = 0;
 
+        /// Sets the function that registers the arguments and subcommands of the command. The function is called
+        /// once, right before they are needed: when the command is parsed, its help or completion is printed,
+        /// or its argument, group or subcommand is looked up by ID. Unused commands are never set up.
+        void set_setup_func(SetupFunc && func) { setup_func = std::move(func); }
+
+        /// Calls the setup function if it is set and was not called yet.
+        virtual void setup() const;
+
         /// Prints command help text.
         void help() const noexcept override;
 
@@ -515,6 +524,7 @@ public:
             const char * arg, std::vector<ArgumentParser::NamedArg *> named_args, size_t used_positional_arguments);
 
         Command * parent{nullptr};
+        mutable SetupFunc setup_func;
         std::string commands_help_header = "Commands:";
         std::string named_args_help_header = "Options:";
         std::string positional_args_help_header = "Arguments:";
@@ -604,6 +614,9 @@ public:
 
         void register_group(Group * grp) override { attached_command.register_group(grp); }
 
+        /// Calls the setup function of the attached command.
+        void setup() const override { attached_command.setup(); }
+
         std::vector<std::string> get_invocation() const noexcept override { return attached_command.get_invocation(); }
 
         /// Gets a list of registered commands.
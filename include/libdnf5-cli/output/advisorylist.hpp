@@ -45,7 +45,7 @@ void print_advisorylist_table(
     std::vector<AdvisoryPackage> & advisory_package_list_not_installed,
     std::vector<AdvisoryPackage> & advisory_package_list_installed) {
     struct libscols_table * table = create_advisorylist_table("Name");
-    for (auto adv_pkg : advisory_package_list_not_installed) {
+    for (const auto & adv_pkg : advisory_package_list_not_installed) {
         auto advisory = adv_pkg.get_advisory();
         add_line_into_advisorylist_table(
             table,
@@ -56,7 +56,7 @@ void print_advisorylist_table(
             advisory.get_buildtime(),
             false);
     }
-    for (auto adv_pkg : advisory_package_list_installed) {
+    for (const auto & adv_pkg : advisory_package_list_installed) {
         auto advisory = adv_pkg.get_advisory();
         add_line_into_advisorylist_table(
             table,
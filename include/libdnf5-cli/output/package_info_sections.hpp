@@ -89,6 +89,7 @@ public:
         // for info output keep each package as a separate section, which means
         // an empty line is printed between packages resulting in better readability
         sections.emplace_back(heading, first_line, last_line);
+        print_full_block();
         return true;
     }
     bool virtual add_section(
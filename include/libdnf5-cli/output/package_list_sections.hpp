@@ -26,7 +26,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/rpm/package_set.hpp>
 #include <libsmartcols/libsmartcols.h>
 
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace libdnf5::cli::output {
 
@@ -39,6 +42,12 @@ public:
     /// Print the table
     void print();
 
+    /// Enables the streaming output. The lines are printed in blocks of `block_size` lines while the sections are
+    /// being added and only the current block is kept in memory. The widths of the columns are computed from
+    /// the first block and kept as minimal widths for the following blocks, so a longer value in a later block
+    /// moves the following columns of its line.
+    void enable_streaming(std::size_t block_size = 1000);
+
     /// Adds a new section to the smartcols table
     /// @param heading Header of the section
     /// @param pkg_set List of packages to be printed in this section
@@ -55,9 +64,40 @@ public:
     void virtual setup_cols();
 
 protected:
+    /// A range of lines printed under a heading
+    struct Section {
+        Section(std::string heading, struct libscols_line * first, struct libscols_line * last, bool continued = false)
+            : heading(std::move(heading)),
+              first(first),
+              last(last),
+              continued(continued) {}
+
+        std::string heading;
+        struct libscols_line * first;
+        struct libscols_line * last;
+        /// The section continues the previously printed one, it is not separated by an empty line
+        bool continued;
+    };
+
+    /// In the streaming mode, prints the sections and removes their lines from the table once the table holds
+    /// a full block of lines.
+    void print_full_block();
+
+    /// Returns whether the streaming mode is enabled and the table holds a full block of lines.
+    bool is_block_full() const;
+
     struct libscols_table * table = nullptr;
     // keeps track of the first and the last line of sections
-    std::vector<std::tuple<std::string, struct libscols_line *, struct libscols_line *>> sections;
+    std::vector<Section> sections;
+
+private:
+    void print_streamed_sections();
+    void fix_column_widths();
+
+    bool streaming{false};
+    std::size_t streaming_block_size{0};
+    bool column_widths_fixed{false};
+    bool streamed_separator_needed{false};
 };
 
 
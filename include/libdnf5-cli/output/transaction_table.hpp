@@ -417,7 +417,13 @@ bool print_transaction_table(Transaction & transaction) {
 
     // TODO (nsella) split function into create/print if possible
     //static struct libscols_table * create_transaction_table(bool with_status) {}
-    auto tspkgs = transaction.get_transaction_packages();
+    // The packages are sorted through pointers, the transaction packages are not copied
+    auto tspkgs_view = transaction.get_transaction_packages_view();
+    std::vector<typename decltype(tspkgs_view)::pointer> tspkgs;
+    tspkgs.reserve(tspkgs_view.size());
+    for (const auto & tspkg : tspkgs_view) {
+        tspkgs.push_back(&tspkg);
+    }
     auto tsgrps = transaction.get_transaction_groups();
     auto tsenvs = transaction.get_transaction_environments();
     auto tsmodules = transaction.get_transaction_modules();
@@ -463,14 +469,17 @@ bool print_transaction_table(Transaction & transaction) {
     // TODO(dmach): consider reordering so the major changes (installs, obsoletes, removals) are at the bottom next to the confirmation question
     // TODO(jrohel): Print relations with obsoleted packages
 
-    std::sort(tspkgs.begin(), tspkgs.end(), transaction_package_cmp<decltype(*tspkgs.begin())>);
+    std::sort(tspkgs.begin(), tspkgs.end(), [](const auto * tspkg1, const auto * tspkg2) {
+        return transaction_package_cmp(*tspkg1, *tspkg2);
+    });
     std::sort(tsgrps.begin(), tsgrps.end(), transaction_group_cmp<decltype(*tsgrps.begin())>);
 
     struct libscols_line * header_ln = nullptr;
     TransactionSummary ts_summary;
     ActionHeaderPrinter action_header_printer(tb);
 
-    for (auto & tspkg : tspkgs) {
+    for (const auto * tspkg_ptr : tspkgs) {
+        const auto & tspkg = *tspkg_ptr;
         // TODO(lukash) handle OBSOLETED correctly throught the transaction table output
         if (tspkg.get_action() == libdnf5::transaction::TransactionItemAction::REPLACED) {
             ts_summary.add(tspkg.get_action());
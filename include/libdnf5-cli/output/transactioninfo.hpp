@@ -31,6 +31,9 @@ namespace libdnf5::cli::output {
 
 void print_transaction_info(libdnf5::transaction::Transaction & transaction);
 
+/// Print the wall times of the steps of the rpm transaction run, the slowest first
+void print_transaction_timings(libdnf5::transaction::Transaction & transaction);
+
 template <class Item>
 void print_transaction_item_table(std::vector<Item> items, const char * title) {
     std::unique_ptr<libscols_table, decltype(&scols_unref_table)> item_list(scols_new_table(), &scols_unref_table);
@@ -25,8 +25,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "download_progress_bar.hpp"
 #include "progress_bar.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 
@@ -41,15 +43,22 @@ public:
     ~MultiProgressBar();
 
     void add_bar(std::unique_ptr<ProgressBar> && bar);
-    void print() {
-        std::cout << *this;
-        std::cout << std::flush;
-    }
+    /// Prints the current state of the bars to the standard output. The frame is built in a buffer and written
+    /// by a single `write()`, only the lines that changed since the previous frame are rewritten.
+    /// The call is skipped when the previous frame was printed less than 1/max_fps seconds ago,
+    /// unless a bar finished in the meantime.
+    void print();
+
+    /// Prints the bars to the `stream`, only the lines that changed since the previous frame are rewritten.
+    /// The frame rate is not limited.
     friend std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar);
 
     /// Sets the minimum number of registered progress bars to show the total bar.
     void set_total_bar_visible_limit(std::size_t value) noexcept { total_bar_visible_limit = value; }
 
+    /// Sets the maximum number of frames per second printed by `print()`. Zero disables the limit.
+    void set_max_fps(unsigned int value) noexcept { max_fps = value; }
+
     /// Sets the visibility of number widget in the total bar.
     void set_total_bar_number_widget_visible(bool value) noexcept { total.set_number_widget_visible(value); }
 
@@ -68,7 +77,10 @@ private:
     std::vector<ProgressBar *> bars_done;
     DownloadProgressBar total;
     bool line_printed{false};
-    std::size_t num_of_lines_to_clear{0};
+    // lines of the previous frame that are redrawn by the next frame
+    std::vector<std::string> active_lines;
+    unsigned int max_fps{10};
+    std::chrono::time_point<std::chrono::steady_clock> prev_print_time;
 };
 
 
@@ -40,6 +40,8 @@ public:
     Session() : argument_parser(new libdnf5::cli::ArgumentParser) {}
 
     /// Store the command to the session and initialize it.
+    /// The command arguments and subcommands are set when the argument parser needs them,
+    /// see `libdnf5::cli::ArgumentParser::Command::set_setup_func()`.
     /// @since 5.0
     void add_and_initialize_command(std::unique_ptr<Command> && command);
 
@@ -67,6 +69,7 @@ public:
     libdnf5::cli::ArgumentParser & get_argument_parser();
 
     /// Remove all commands from the session and argument parser.
+    /// The session can be filled with new commands afterwards, e.g. to parse another command line.
     /// @since 5.0
     void clear();
 
@@ -87,6 +90,7 @@ public:
     virtual void set_parent_command() {}
 
     /// Set command arguments.
+    /// Called only when the command is used, e.g. selected on the command line, or its help is printed.
     /// @since 5.0
     virtual void set_argument_parser() {}
 
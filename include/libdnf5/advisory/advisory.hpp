@@ -140,6 +140,7 @@ private:
     friend class AdvisoryPackage;
     friend class AdvisorySetIterator;
     friend class AdvisorySet;
+    friend class AdvisorySack;
 
     BaseWeakPtr base;
 
@@ -33,8 +33,8 @@ namespace libdnf5::advisory {
 //TODO(amatej): add unit tests for AdvisoryCollection
 class AdvisoryCollection {
 public:
-    /// Whether this AdvisoryCollection is applicable. True when at least one AdvisoryModule in this
-    /// AdvisoryCollection is active on the system, False otherwise.
+    /// Whether this AdvisoryCollection is applicable. True when the AdvisoryCollection has no AdvisoryModule or
+    /// when at least one AdvisoryModule in this AdvisoryCollection has an active module stream, False otherwise.
     bool is_applicable() const;
 
     /// Get AdvisoryId of Advisory this AdvisoryCollection belongs to.
@@ -67,6 +67,7 @@ private:
     friend AdvisoryPackage;
     friend AdvisorySet;
     friend class AdvisoryQuery;
+    friend class AdvisorySack;
 
     AdvisoryCollection(const BaseWeakPtr & base, AdvisoryId advisory, int index);
 
@@ -120,6 +120,7 @@ public:
 private:
     friend class AdvisoryCollection;
     friend class AdvisoryQuery;
+    friend class AdvisorySack;
     friend class AdvisorySet;
     friend class libdnf5::rpm::PackageQuery;
     friend class libdnf5::Goal;
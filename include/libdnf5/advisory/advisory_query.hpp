@@ -75,6 +75,9 @@ public:
     /// @param pattern      Pattern to match with reference id.
     /// @param cmp_type     What comparator to use with pattern, allows: EQ, IEXACT, GLOB, IGLOB, CONTAINS, ICONTAINS.
     /// @param type         Possible reference types are: "bugzilla", "cve", "vendor". If none is specified it matches all.
+    ///
+    /// EQ patterns are looked up in an index of the references, many ids (e.g. hundreds of cves) can be
+    /// passed in one call using the std::vector overloads.
     void filter_reference(const std::string & pattern, sack::QueryCmp cmp_type = libdnf5::sack::QueryCmp::EQ);
     void filter_reference(
         const std::string & pattern, const std::string & type, sack::QueryCmp cmp_type = libdnf5::sack::QueryCmp::EQ);
@@ -93,6 +96,10 @@ public:
     void filter_severity(
         const std::vector<std::string> & severities, sack::QueryCmp cmp_type = libdnf5::sack::QueryCmp::EQ);
 
+    /// Filter out advisories that don't have at least one applicable AdvisoryCollection.
+    /// The applicability of all advisories is evaluated at once and shared by all queries.
+    void filter_applicable();
+
     /// Filter out advisories that don't contain at least one AdvisoryPackage that has a counterpart Package in package_set
     /// such that they have matching name and architecture and also their epoch-version-release complies to cmp_type.
     ///
@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF5_BASE_BASE_HPP
 
 #include "libdnf5/base/base_weak.hpp"
+#include "libdnf5/base/span_recorder.hpp"
 #include "libdnf5/common/exception.hpp"
 #include "libdnf5/common/impl_ptr.hpp"
 #include "libdnf5/common/weak_ptr.hpp"
@@ -117,7 +118,11 @@ public:
     /// Gets base variables. They can be used in configuration files. Syntax in the config - ${var_name} or $var_name.
     VarsWeakPtr get_vars() { return VarsWeakPtr(&vars, &vars_gurad); }
 
-    libdnf5::BaseWeakPtr get_weak_ptr() { return BaseWeakPtr(this, &base_guard); }
+    /// Gets the recorder of the time spent in the phases of the work (loading of the configuration and
+    /// repositories, resolving, downloading, running the transaction). The recording is disabled by default.
+    base::SpanRecorder & get_span_recorder();
+
+    libdnf5::BaseWeakPtr get_weak_ptr() { return BaseWeakPtr(this, base_guard); }
 
     class Impl;
 
@@ -136,7 +141,7 @@ private:
     void load_plugins();
 
 
-    WeakPtrGuard<Base, false> base_guard;
+    GenerationGuard base_guard;
     // Impl has to be the second data member (right after base_guard which is needed for its construction) because it
     // contains Pool and that has be destructed last.
     // See commit: https://github.com/rpm-software-management/dnf5/commit/c8e26cb545aed0d6ca66545d51eda7568efdf232
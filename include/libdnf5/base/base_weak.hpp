@@ -26,7 +26,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 namespace libdnf5 {
 
 class Base;
-using BaseWeakPtr = WeakPtr<Base, false>;
+// The Base pointer is copied by every package, advisory, group and query, it does not register at the Base.
+using BaseWeakPtr = GenerationWeakPtr<Base>;
 
 }  // namespace libdnf5
 
@@ -309,6 +309,20 @@ public:
         const std::string & group_id = {},
         const libdnf5::GoalJobSettings & settings = libdnf5::GoalJobSettings());
 
+    /// Add reason change requests for multiple specs to the goal. The specs are resolved together against
+    /// the installed packages, which is faster than adding them one by one when changing reasons of many packages.
+    ///
+    /// @param specs     Strings describing the requested packages
+    /// @param reason    New reason for the packages
+    /// @param group_id  Id of group the packages belong to (only relevant in case the reason is GROUP)
+    /// @param settings  A sructure to overrice default goal settings. Only ResolveSpecSettings values are used
+    /// @since 5.1.3
+    void add_rpm_reason_change(
+        const std::vector<std::string> & specs,
+        const libdnf5::transaction::TransactionItemReason reason,
+        const std::string & group_id = {},
+        const libdnf5::GoalJobSettings & settings = libdnf5::GoalJobSettings());
+
     /// Add group install request to the goal. The `spec` will be resolved to groups in the resolve() call.
     /// Also packages of the types specified in setting.group_package_types be installed.
     ///
@@ -360,6 +374,13 @@ public:
     /// Return the currets setting of allow_erasing
     bool get_allow_erasing() const;
 
+    /// When true, the goal keeps its solver between the calls of resolve(). It suits long-lived goals that are
+    /// resolved repeatedly with small changes of the jobs. The solver is recreated when the packages in the pool change.
+    void set_incremental(bool value);
+
+    /// Return the current setting of incremental
+    bool get_incremental() const;
+
     // TODO(jmracek) Move transaction reports to Transaction class
     /// Resolve all jobs and return a transaction object. Everytime it resolves specs (strings) to packages
     ///
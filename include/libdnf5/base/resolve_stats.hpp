@@ -0,0 +1,74 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_BASE_RESOLVE_STATS_HPP
+#define LIBDNF5_BASE_RESOLVE_STATS_HPP
+
+#include <chrono>
+#include <string>
+
+
+namespace libdnf5::base {
+
+/// Durations of the phases of `Goal::resolve()` and statistics of the libsolv solver.
+/// The solver statistics describe the last run of the solver, the strict mode resolve done to report skipped
+/// packages is accounted in the `problems` phase.
+/// @since 5.0
+struct ResolveStats {
+    /// Resolution of the module, package, group and reason change specs into solver jobs.
+    std::chrono::microseconds spec_resolution{0};
+    /// Setting of the goal flags, protected, user-installed and installonly packages and excluded weak dependencies.
+    std::chrono::microseconds goal_setup{0};
+    /// Construction of the solver job queue.
+    std::chrono::microseconds job_construction{0};
+    /// Creation and configuration of the solver.
+    std::chrono::microseconds solver_init{0};
+    /// Run of the solver, including the second run that limits the installonly packages.
+    std::chrono::microseconds solve{0};
+    /// Generation of the solver problems and the strict mode resolve.
+    std::chrono::microseconds problems{0};
+    /// Filling the transaction with the resolved packages, groups, environments and modules.
+    std::chrono::microseconds set_transaction{0};
+    /// The whole `Goal::resolve()`.
+    std::chrono::microseconds total{0};
+
+    /// Number of jobs passed to the solver.
+    int jobs{0};
+    /// Number of runs of the solver.
+    int solver_runs{0};
+    /// Number of decisions made by the solver.
+    int decisions{0};
+    /// Number of problems found by the solver.
+    int solver_problems{0};
+    /// Number of steps of the resulting libsolv transaction.
+    int transaction_steps{0};
+    /// Whether the solution was taken from the resolve cache, the solver did not run then.
+    bool from_resolve_cache{false};
+
+    /// The solver of the previous resolve of an incremental goal was reused
+    bool reused_solver{false};
+
+    /// @return Multi-line human readable description of the statistics.
+    std::string to_string() const;
+};
+
+}  // namespace libdnf5::base
+
+#endif  // LIBDNF5_BASE_RESOLVE_STATS_HPP
@@ -0,0 +1,133 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_BASE_SPAN_RECORDER_HPP
+#define LIBDNF5_BASE_SPAN_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf5::base {
+
+/// Records the time spent in the named phases (spans) of the work, e.g. loading of a repository, resolving
+/// the goal or running the rpm transaction. The recording is disabled by default, a disabled recorder costs only
+/// a check of a flag per span. Spans can be recorded from multiple threads.
+///
+/// The spans form a hierarchy by their nesting in time: the parent of a span is the innermost span of the same
+/// thread that contains it. The spans recorded by a worker thread outside of any other span of that thread are
+/// placed into the innermost containing span of the thread that enabled the recording.
+///
+/// Each thread records its spans into its own buffer, the threads do not contend for a common lock. When libdnf5 is
+/// built without the `WITH_SPAN_RECORDING` option, the recording cannot be enabled.
+/// @since 5.0
+class SpanRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// One recorded span
+    struct Span {
+        std::string name;
+        /// Specifies the subject of the span, e.g. the repository id, can be empty
+        std::string detail;
+        Clock::time_point start;
+        Clock::time_point end;
+        std::thread::id thread_id;
+    };
+
+    /// Records a span from the construction of the scope to its destruction.
+    class Scope {
+    public:
+        Scope(SpanRecorder & recorder, std::string_view name, std::string_view detail = {});
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+    private:
+        /// Null if the recording was disabled when the scope was created
+        SpanRecorder * recorder{nullptr};
+        std::string name;
+        std::string detail;
+        Clock::time_point start;
+    };
+
+    SpanRecorder();
+    ~SpanRecorder();
+
+    SpanRecorder(const SpanRecorder &) = delete;
+    SpanRecorder & operator=(const SpanRecorder &) = delete;
+
+    /// Enables or disables the recording. The thread calling it with `true` becomes the main thread of the recording.
+    /// It has no effect if libdnf5 was built without the span recording support.
+    void set_enabled(bool enabled);
+    bool is_enabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /// Records the span `name` from `start` to `end` if the recording is enabled.
+    /// Used for the phases measured in other ways, e.g. by the rpm transaction callbacks.
+    void add(std::string name, std::string detail, Clock::time_point start, Clock::time_point end);
+
+    /// @return Copy of the recorded spans of all the threads in the order in which they ended.
+    std::vector<Span> get_spans() const;
+
+    /// Drops the recorded spans.
+    void clear();
+
+    /// @return Multi-line human readable summary of the spans. The spans with the same name and detail under
+    ///         the same parent are merged, their count and total time are shown, the hierarchy is shown by indentation.
+    std::string to_string() const;
+
+    /// @return The spans in the JSON trace event format accepted by `chrome://tracing` and Perfetto.
+    std::string to_chrome_trace() const;
+
+    /// @param service_name The value of the `service.name` resource attribute.
+    /// @return The spans as one trace in the OpenTelemetry protocol (OTLP) JSON encoding of
+    ///         `ExportTraceServiceRequest`, as written by the file exporter of the OpenTelemetry collector.
+    ///         The parent of each span is set according to the hierarchy described above.
+    /// @since 5.1.3
+    std::string to_otlp_json(std::string_view service_name = "libdnf5") const;
+
+private:
+    struct ThreadBuffer;
+
+    /// Returns the buffer of the calling thread, it is created on the first use
+    ThreadBuffer & get_thread_buffer();
+
+    /// Identifies the recorder in the per-thread cache of the buffer, unlike the address it is never reused
+    const std::uint64_t id;
+    std::atomic<bool> enabled{false};
+    mutable std::mutex buffers_mutex;
+    std::thread::id main_thread_id;
+    /// The wall clock time corresponding to `enabled_time`, used to convert the span times to wall clock times
+    std::chrono::system_clock::time_point enabled_system_time;
+    Clock::time_point enabled_time;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+}  // namespace libdnf5::base
+
+#endif  // LIBDNF5_BASE_SPAN_RECORDER_HPP
@@ -24,15 +24,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/base/goal_elements.hpp"
 #include "libdnf5/base/log_event.hpp"
+#include "libdnf5/base/resolve_stats.hpp"
 #include "libdnf5/base/solver_problems.hpp"
 #include "libdnf5/common/proc.hpp"
 #include "libdnf5/rpm/transaction_callbacks.hpp"
 
 #include <optional>
+#include <span>
 
 
 namespace libdnf5::rpm {
 class KeyInfo;
+struct PackageId;
 }  // namespace libdnf5::rpm
 
 
@@ -83,10 +86,25 @@ public:
     /// @return A vector of string representations of problems.
     std::vector<std::string> get_resolve_logs_as_strings() const;
 
+    /// Returns timings and solver counters collected while the Goal was resolved.
+    /// @return The resolve statistics of this transaction.
+    const libdnf5::base::ResolveStats & get_resolve_stats() const;
+
     /// @return the transaction packages.
-    // TODO(jrohel): Return reference instead of copy?
     std::vector<libdnf5::base::TransactionPackage> get_transaction_packages() const;
 
+    /// Returns the transaction packages without copying them. The span is valid as long as the transaction exists.
+    /// @return the transaction packages.
+    /// @since 5.1.3
+    std::span<const libdnf5::base::TransactionPackage> get_transaction_packages_view() const;
+
+    /// Returns the transaction package of the package with the `package_id`. When the package is in the transaction
+    /// more than once, the first transaction package is returned.
+    /// @param package_id The id of the package.
+    /// @return The transaction package or `nullptr` when the package is not part of the transaction.
+    /// @since 5.1.3
+    const libdnf5::base::TransactionPackage * get_transaction_package(const libdnf5::rpm::PackageId & package_id) const;
+
     /// @return the number of transaction packages.
     std::size_t get_transaction_packages_count() const;
 
@@ -159,6 +177,27 @@ public:
     /// Retrieve a list of the problems that occurred during `check_gpg_signatures` procedure.
     std::vector<std::string> get_gpg_signature_problems() const noexcept;
 
+    /// Serializes the resolved transaction into a JSON document. It contains the packages with their NEVRAs, repository
+    /// ids, checksums and reasons, the group, environment and module changes and the cookie of the rpm database
+    /// the transaction was resolved against. The document can be replayed by `deserialize()` on other machines with
+    /// the same installed packages without resolving the goal again.
+    /// @return The serialized transaction.
+    /// @throws TransactionError when the rpm database cannot be opened.
+    /// @since 5.1.3
+    std::string serialize() const;
+
+    /// Creates a transaction from a document created by `serialize()` without running the solver. The inbound packages
+    /// are looked up by their NEVRAs in the loaded repositories with the same ids and must have the same checksums,
+    /// only the repositories referenced by the document need to be loaded. The outbound packages are looked up among
+    /// the installed packages. The module changes are applied to the module state.
+    /// @param base Base with the loaded repositories.
+    /// @param serialized The serialized transaction.
+    /// @return A transaction ready to be downloaded and run.
+    /// @throws TransactionError when the document is invalid, the cookie of the rpm database differs or a package,
+    /// group or environment is not found.
+    /// @since 5.1.3
+    static Transaction deserialize(const libdnf5::BaseWeakPtr & base, const std::string & serialized);
+
 private:
     friend class TransactionEnvironment;
     friend class TransactionGroup;
@@ -21,9 +21,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF5_UTILS_PRESERVE_ORDER_MAP_HPP
 
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 
@@ -31,6 +33,8 @@ namespace libdnf5 {
 
 /// PreserveOrderMap is an associative container that contains key-value pairs with unique unique keys.
 /// It is similar to standard std::map. But it preserves the order of items and the complexity is linear.
+/// With the default KeyEqual, a hash index of the keys is built when the map grows over INDEX_THRESHOLD items,
+/// then the lookups by key have constant average complexity. Erasing an item rebuilds the index.
 template <typename Key, typename T, class KeyEqual = std::equal_to<Key>>
 class PreserveOrderMap {
 public:
@@ -121,88 +125,146 @@ public:
     const_reverse_iterator rend() const noexcept { return const_reverse_iterator(items.rend()); }
     const_reverse_iterator crend() const noexcept { return const_reverse_iterator(items.crend()); }
 
-    void clear() noexcept { items.clear(); }
+    void clear() noexcept {
+        items.clear();
+        index.clear();
+    }
 
     std::pair<iterator, bool> insert(const value_type & value) {
-        auto it = find(value.first);
-        if (it == end()) {
-            it = iterator(items.insert(it.ci, value));
-            return {it, true};
+        auto pos = find_pos(value.first);
+        if (pos == items.size()) {
+            items.push_back(value);
+            index_last_item();
+            return {iterator(items.begin() + static_cast<difference_type>(pos)), true};
         }
-        return {it, false};
+        return {iterator(items.begin() + static_cast<difference_type>(pos)), false};
     }
 
-    iterator erase(const_iterator pos) { return iterator(items.erase(pos.ci)); }
-    iterator erase(iterator pos) { return iterator(items.erase(pos.ci)); }
-    iterator erase(const_iterator first, const_iterator last) { return iterator(items.erase(first.ci, last.ci)); }
+    iterator erase(const_iterator pos) {
+        auto it = items.erase(pos.ci);
+        return iterator(rebuild_index(it));
+    }
+    iterator erase(iterator pos) {
+        auto it = items.erase(pos.ci);
+        return iterator(rebuild_index(it));
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto it = items.erase(first.ci, last.ci);
+        return iterator(rebuild_index(it));
+    }
 
     size_type erase(const Key & key) {
-        auto it = find(key);
-        if (it == end()) {
+        auto pos = find_pos(key);
+        if (pos == items.size()) {
             return 0;
         }
-        items.erase(it.ci);
+        rebuild_index(items.erase(items.begin() + static_cast<difference_type>(pos)));
         return 1;
     }
 
-    size_type count(const Key & key) const { return find(key) != end() ? 1 : 0; }
+    size_type count(const Key & key) const { return find_pos(key) != items.size() ? 1 : 0; }
 
-    iterator find(const Key & key) {
-        auto it = begin();
-        while (it != end() && !KeyEqual()(it->first, key)) {
-            ++it;
-        }
-        return it;
-    }
+    iterator find(const Key & key) { return iterator(items.begin() + static_cast<difference_type>(find_pos(key))); }
 
     const_iterator find(const Key & key) const {
-        auto it = cbegin();
-        while (it != cend() && !KeyEqual()(it->first, key)) {
-            ++it;
-        }
-        return it;
+        return const_iterator(items.cbegin() + static_cast<difference_type>(find_pos(key)));
     }
 
     T & operator[](const Key & key) {
-        for (auto & item : items) {
-            if (KeyEqual()(item.first, key)) {
-                return item.second;
-            }
+        auto pos = find_pos(key);
+        if (pos != items.size()) {
+            return items[pos].second;
         }
         items.push_back({key, {}});
+        index_last_item();
         return items.back().second;
     }
 
     T & operator[](Key && key) {
-        for (auto & item : items) {
-            if (KeyEqual()(item.first, key)) {
-                return item.second;
-            }
+        auto pos = find_pos(key);
+        if (pos != items.size()) {
+            return items[pos].second;
         }
         items.push_back({std::move(key), {}});
+        index_last_item();
         return items.back().second;
     }
 
     T & at(const Key & key) {
-        for (auto & item : items) {
-            if (KeyEqual()(item.first, key)) {
-                return item.second;
-            }
+        auto pos = find_pos(key);
+        if (pos != items.size()) {
+            return items[pos].second;
         }
         throw std::out_of_range("PreserveOrderMap::at");
     }
 
     const T & at(const Key & key) const {
-        for (auto & item : items) {
-            if (KeyEqual()(item.first, key)) {
-                return item.second;
-            }
+        auto pos = find_pos(key);
+        if (pos != items.size()) {
+            return items[pos].second;
         }
         throw std::out_of_range("PreserveOrderMap::at");
     }
 
+    /// The number of items over which the hash index of the keys is built
+    static constexpr size_type INDEX_THRESHOLD = 16;
+
 private:
+    using difference_type = typename container_type::difference_type;
+
+    /// The hash index is used only with the default KeyEqual, a custom one does not have to be consistent
+    /// with std::hash
+    static constexpr bool HASHED_LOOKUP = std::is_same_v<KeyEqual, std::equal_to<Key>>;
+
+    struct NoIndex {
+        void clear() noexcept {}
+    };
+    using index_type =
+        std::conditional_t<HASHED_LOOKUP, std::unordered_map<Key, size_type>, NoIndex>;
+
+    /// Returns the position of the item with the `key` in `items`, or the size of `items` if there is no such item.
+    size_type find_pos(const Key & key) const {
+        if constexpr (HASHED_LOOKUP) {
+            if (!index.empty()) {
+                auto it = index.find(key);
+                return it == index.end() ? items.size() : it->second;
+            }
+        }
+        size_type pos = 0;
+        while (pos < items.size() && !KeyEqual()(items[pos].first, key)) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    /// Adds the last item to the index, the index is built when the map grows over the threshold.
+    void index_last_item() {
+        if constexpr (HASHED_LOOKUP) {
+            if (!index.empty()) {
+                index.emplace(items.back().first, items.size() - 1);
+            } else if (items.size() > INDEX_THRESHOLD) {
+                rebuild_index(items.end());
+            }
+        }
+    }
+
+    /// Rebuilds the index after erasing items, the positions of the following items changed.
+    /// Returns the passed iterator to `items`, it stays valid.
+    typename container_type::iterator rebuild_index(typename container_type::iterator it) {
+        if constexpr (HASHED_LOOKUP) {
+            index.clear();
+            if (items.size() > INDEX_THRESHOLD) {
+                index.reserve(items.size());
+                for (size_type pos = 0; pos < items.size(); ++pos) {
+                    index.emplace(items[pos].first, pos);
+                }
+            }
+        }
+        return it;
+    }
+
     container_type items;
+    index_type index;
 };
 
 }  // namespace libdnf5
@@ -22,6 +22,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "exception.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <unordered_set>
 
@@ -237,6 +239,88 @@ private:
     TWeakPtrGuard * guard;
 };
 
+
+template <typename TPtr>
+struct GenerationWeakPtr;
+
+
+/// GenerationGuard is a resource guard for GenerationWeakPtrs. Unlike WeakPtrGuard, it does not keep a registry
+/// of the weak pointers. The guard owns a slot with a generation counter which is incremented when the guard
+/// is cleared or destroyed. A GenerationWeakPtr remembers the slot and the generation and it is valid as long as
+/// they match. The slots are never freed, a slot released by a destroyed guard is reused by a new guard.
+/// Note on thread safety:
+/// Destroying the GenerationGuard while simultaneously using its GenerationWeakPtrs in another thread is not safe
+/// and can still trigger a race condition.
+class GenerationGuard {
+public:
+    GenerationGuard();
+    GenerationGuard(const GenerationGuard &) = delete;
+    GenerationGuard(GenerationGuard && src) noexcept = delete;
+    ~GenerationGuard();
+
+    GenerationGuard & operator=(const GenerationGuard & src) = delete;
+    GenerationGuard & operator=(GenerationGuard && src) noexcept = delete;
+
+    /// Invalidates all the weak pointers created from the guard so far.
+    void clear() noexcept;
+
+private:
+    template <typename TPtr>
+    friend struct GenerationWeakPtr;
+    std::atomic<std::uint64_t> * slot;
+};
+
+
+/// GenerationWeakPtr is a weak pointer to a resource guarded by a GenerationGuard. It does not register itself
+/// at the guard, so it is trivially copyable and its creation, copying and destruction take no lock and allocate
+/// no memory. The validity check is a single atomic load. It is intended for the pointers copied in hot paths,
+/// e.g. the Base pointer held by every package.
+/// Note on thread safety:
+/// It is safe to create, access and destroy GenerationWeakPtrs in multiple threads simultaneously.
+template <typename TPtr>
+struct GenerationWeakPtr {
+public:
+    GenerationWeakPtr() = default;
+
+    GenerationWeakPtr(TPtr * ptr, const GenerationGuard & guard)
+        : ptr(ptr),
+          slot(guard.slot),
+          generation(guard.slot->load(std::memory_order_acquire)) {}
+
+    /// Provides access to the managed object. Generates exception if object is not valid.
+    TPtr * operator->() const {
+        libdnf_assert(is_valid(), "Dereferencing an invalidated WeakPtr");
+        return ptr;
+    }
+
+    /// Returns a pointer to the managed object. Generates exception if object is not valid.
+    TPtr * get() const {
+        libdnf_assert(is_valid(), "Dereferencing an invalidated WeakPtr");
+        return ptr;
+    }
+
+    /// Checks if managed object is valid.
+    bool is_valid() const noexcept { return slot && slot->load(std::memory_order_acquire) == generation; }
+
+    /// Checks if the other GenerationWeakPtr instance was created from the same GenerationGuard.
+    bool has_same_guard(const GenerationWeakPtr & other) const noexcept {
+        return slot == other.slot && generation == other.generation;
+    }
+
+    TPtr & operator*() const { return *get(); }
+    bool operator==(const GenerationWeakPtr & other) const { return ptr == other.ptr; }
+    bool operator!=(const GenerationWeakPtr & other) const { return ptr != other.ptr; }
+    bool operator<(const GenerationWeakPtr & other) const { return ptr < other.ptr; }
+    bool operator>(const GenerationWeakPtr & other) const { return ptr > other.ptr; }
+    bool operator<=(const GenerationWeakPtr & other) const { return ptr <= other.ptr; }
+    bool operator>=(const GenerationWeakPtr & other) const { return ptr >= other.ptr; }
+
+private:
+    TPtr * ptr{nullptr};
+    const std::atomic<std::uint64_t> * slot{nullptr};
+    std::uint64_t generation{0};
+};
+
 }  // namespace libdnf5
 
 #endif
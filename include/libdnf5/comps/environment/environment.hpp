@@ -135,6 +135,12 @@ public:
     /// @since 5.0
     void serialize(const std::string & path);
 
+    /// Serialize the Environment into an xml document.
+    /// @return The xml document, the same as the contents of the file written by `serialize(path)`.
+    /// @exception utils::xml::XMLSaveError When the serialization fails.
+    /// @since 5.1.3
+    std::string serialize();
+
 protected:
     explicit Environment(const libdnf5::BaseWeakPtr & base);
     explicit Environment(libdnf5::Base & base);
@@ -43,21 +43,17 @@ public:
     explicit EnvironmentQuery(libdnf5::Base & base, bool empty = false);
 
     void filter_environmentid(const std::string & pattern, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::environmentid, pattern, cmp);
+        filter_environmentid(std::vector<std::string>{pattern}, cmp);
     }
 
     void filter_environmentid(
-        const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::environmentid, patterns, cmp);
-    }
+        const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ);
 
     void filter_name(const std::string & pattern, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::name, pattern, cmp);
+        filter_name(std::vector<std::string>{pattern}, cmp);
     }
 
-    void filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::name, patterns, cmp);
-    }
+    void filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ);
 
     void filter_installed(bool value) { filter(F::is_installed, value, sack::QueryCmp::EQ); }
 
@@ -68,6 +64,11 @@ private:
         static bool is_installed(const Environment & obj) { return obj.get_installed(); }
     };
 
+    /// Keeps only the environments found in the comps index by the id (or the name) equal to one of the `patterns`.
+    /// Used instead of comparing the strings of all the environments when the patterns are matched exactly.
+    /// @return `false` if the `patterns` and `cmp` cannot be matched exactly and the query was not filtered.
+    bool filter_by_index(const std::vector<std::string> & patterns, sack::QueryCmp cmp, bool by_name);
+
     libdnf5::BaseWeakPtr base;
 
     friend Environment;
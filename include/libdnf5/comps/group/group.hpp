@@ -150,6 +150,12 @@ public:
     /// @since 5.0
     void serialize(const std::string & path);
 
+    /// Serialize the Group into an xml document.
+    /// @return The xml document, the same as the contents of the file written by `serialize(path)`.
+    /// @exception utils::xml::XMLSaveError When the serialization fails.
+    /// @since 5.1.3
+    std::string serialize();
+
 protected:
     explicit Group(const BaseWeakPtr & base);
     explicit Group(libdnf5::Base & base);
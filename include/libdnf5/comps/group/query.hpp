@@ -43,15 +43,13 @@ public:
     explicit GroupQuery(libdnf5::Base & base, bool empty = false);
 
     void filter_groupid(const std::string & pattern, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::groupid, pattern, cmp);
+        filter_groupid(std::vector<std::string>{pattern}, cmp);
     }
 
-    void filter_groupid(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::groupid, patterns, cmp);
-    }
+    void filter_groupid(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ);
 
     void filter_name(const std::string & pattern, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::name, pattern, cmp);
+        filter_name(std::vector<std::string>{pattern}, cmp);
     }
 
     /// Filter groups by packages they contain. Keep only groups that contain packages with given names.
@@ -62,9 +60,7 @@ public:
     void filter_package_name(
         const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ);
 
-    void filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ) {
-        filter(F::name, patterns, cmp);
-    }
+    void filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp = libdnf5::sack::QueryCmp::EQ);
 
     void filter_uservisible(bool value) { filter(F::is_uservisible, value, sack::QueryCmp::EQ); }
     void filter_default(bool value) { filter(F::is_default, value, sack::QueryCmp::EQ); }
@@ -79,6 +75,11 @@ private:
         static bool is_installed(const Group & obj) { return obj.get_installed(); }
     };
 
+    /// Keeps only the groups found in the comps index by the id (or the name) equal to one of the `patterns`.
+    /// Used instead of comparing the strings of all the groups when the patterns are matched exactly.
+    /// @return `false` if the `patterns` and `cmp` cannot be matched exactly and the query was not filtered.
+    bool filter_by_index(const std::vector<std::string> & patterns, sack::QueryCmp cmp, bool by_name);
+
     libdnf5::BaseWeakPtr base;
 
     friend Group;
@@ -33,7 +33,9 @@ namespace libdnf5 {
 /// Base class for configurations objects
 class Config {
 public:
-    OptionBinds & opt_binds() noexcept { return binds; }
+    /// Returns the bindings of the option names to the options. The bindings registered by `register_opt_binds()`
+    /// are added on the first call.
+    OptionBinds & opt_binds();
 
     virtual ~Config() = default;
 
@@ -44,8 +46,20 @@ public:
         Logger & logger,
         Option::Priority priority);
 
+protected:
+    /// Registers the bindings of the option names on the first call of `opt_binds()`. Configurations with many
+    /// instances register them here instead of in the constructor, so that the instances whose options are accessed
+    /// only through getters do not allocate them.
+    /// @since 5.1.3
+    virtual void register_opt_binds(OptionBinds & option_binds);
+
+    /// Returns whether the bindings were already registered
+    /// @since 5.1.3
+    bool opt_binds_registered() const noexcept { return binds_registered; }
+
 private:
     OptionBinds binds;
+    bool binds_registered{false};
 };
 
 
@@ -62,6 +62,21 @@ public:
     const OptionPath & get_system_state_dir_option() const;
     OptionPath & get_transaction_history_dir_option();
     const OptionPath & get_transaction_history_dir_option() const;
+    /// Journal mode of the transaction history database, `wal`, `truncate` or `delete`.
+    /// In the `wal` mode the readers of the history run concurrently with a transaction being written.
+    OptionEnum<std::string> & get_history_db_journal_mode_option();
+    const OptionEnum<std::string> & get_history_db_journal_mode_option() const;
+    /// Synchronous mode of the transaction history database, `off`, `normal`, `full` or `extra`.
+    /// The `normal` mode in combination with the `wal` journal mode syncs the database less often, the last
+    /// transactions can be lost from the history on a power failure, but the database is not corrupted.
+    OptionEnum<std::string> & get_history_db_synchronous_option();
+    const OptionEnum<std::string> & get_history_db_synchronous_option() const;
+    /// Conversion of the dnf4 transaction history into the empty dnf5 history, `off` (default), `foreground` or
+    /// `background`. The `background` conversion runs in a thread started by `Base::setup()`, it is resumed by the
+    /// next run when the `Base` is destroyed before the conversion finishes. The conversion writes the history
+    /// database, it is meant to be enabled for the runs that perform transactions as root.
+    OptionEnum<std::string> & get_dnf4_history_conversion_option();
+    const OptionEnum<std::string> & get_dnf4_history_conversion_option() const;
     OptionBool & get_transformdb_option();
     const OptionBool & get_transformdb_option() const;
     OptionNumber<std::int32_t> & get_recent_option();
@@ -80,6 +95,9 @@ public:
     const OptionNumber<std::int32_t> & get_log_size_option() const;
     OptionNumber<std::int32_t> & get_log_rotate_option();
     const OptionNumber<std::int32_t> & get_log_rotate_option() const;
+    /// Write the log file in a background thread. Messages are dropped when the writer cannot keep up.
+    OptionBool & get_log_async_option();
+    const OptionBool & get_log_async_option() const;
     OptionPath & get_debugdir_option();
     const OptionPath & get_debugdir_option() const;
     OptionStringList & get_varsdir_option();
@@ -88,6 +106,14 @@ public:
     const OptionStringList & get_reposdir_option() const;
     OptionBool & get_debug_solver_option();
     const OptionBool & get_debug_solver_option() const;
+    /// Compression of the repositories in the solver debug data, `gzip` or `zstd`.
+    /// The `zstd` compression requires libsolv built with zstd support.
+    OptionEnum<std::string> & get_debugdata_compression_option();
+    const OptionEnum<std::string> & get_debugdata_compression_option() const;
+    /// Limit the available packages in the solver debug data to those reachable from the jobs
+    /// through requires and recommends. The installed packages are always stored.
+    OptionBool & get_debugdata_job_closure_option();
+    const OptionBool & get_debugdata_job_closure_option() const;
     OptionStringList & get_installonlypkgs_option();
     const OptionStringList & get_installonlypkgs_option() const;
     OptionStringList & get_group_package_types_option();
@@ -118,6 +144,24 @@ public:
     const OptionBool & get_diskspacecheck_option() const;
     OptionBool & get_localpkg_gpgcheck_option();
     const OptionBool & get_localpkg_gpgcheck_option() const;
+    /// Check the signatures of the downloaded packages in a background thread during `Transaction::download()`,
+    /// so that the signature checks of the transaction run do not have to be repeated for the passed packages.
+    OptionBool & get_gpgcheck_during_download_option();
+    const OptionBool & get_gpgcheck_during_download_option() const;
+    /// Number of threads checking the signatures of the transaction packages. The import of the repository keys
+    /// after a failed check stays serial. 0 or 1 means the signatures are checked by the calling thread only.
+    OptionNumber<std::uint32_t> & get_gpgcheck_threads_option();
+    const OptionNumber<std::uint32_t> & get_gpgcheck_threads_option() const;
+    /// Number of threads reading the headers of the package files added to the rpm transaction. The packages are
+    /// still added to the transaction in their order. 0 or 1 means the headers are read by the calling thread only.
+    OptionNumber<std::uint32_t> & get_header_read_threads_option();
+    const OptionNumber<std::uint32_t> & get_header_read_threads_option() const;
+    /// Check the rpm dependencies of the transaction and estimate its disk space from the repository metadata in
+    /// a background thread during `Transaction::download()`. The found problems are logged before the download
+    /// finishes. The check only reports problems early, the transaction run always checks the dependencies again.
+    /// @since 5.1.3
+    OptionBool & get_preflight_check_option();
+    const OptionBool & get_preflight_check_option() const;
     OptionBool & get_gpgkey_dns_verification_option();
     const OptionBool & get_gpgkey_dns_verification_option() const;
     OptionBool & get_obsoletes_option();
@@ -142,6 +186,12 @@ public:
     const OptionString & get_bugtracker_url_option() const;
     OptionBool & get_zchunk_option();
     const OptionBool & get_zchunk_option() const;
+    /// Directory of a zchunk store shared by the repositories and installroots. The zchunk metadata files are stored
+    /// there by their checksums and librepo takes the chunks of the refreshed metadata from all of them, so only
+    /// the changed chunks are downloaded. Empty disables the store, the cache directory is searched for the chunks.
+    /// @since 5.1.3
+    OptionPath & get_zchunk_store_dir_option();
+    const OptionPath & get_zchunk_store_dir_option() const;
     OptionEnum<std::string> & get_color_option();
     const OptionEnum<std::string> & get_color_option() const;
     OptionString & get_color_list_installed_older_option();
@@ -193,6 +243,17 @@ public:
     const OptionBool & get_upgrade_group_objects_upgrade_option() const;
     OptionPath & get_destdir_option();
     const OptionPath & get_destdir_option() const;
+    /// Directory of a package store shared by the repositories and installroots, the package files are stored
+    /// there by their checksums. A package found in the store is hardlinked (or reflinked, or copied) to its
+    /// destination instead of being downloaded, a downloaded package is added to the store. Empty disables the store.
+    OptionPath & get_package_store_dir_option();
+    const OptionPath & get_package_store_dir_option() const;
+    /// URL of a peer cache consulted before the repository mirrors, typically an HTTP server on the local network
+    /// serving a `package_store_dir` of another host. The packages are requested by their checksums from the repository
+    /// metadata and verified against them. A package missing in the peer cache is downloaded from the mirrors.
+    /// Empty disables the peer cache.
+    OptionString & get_peer_cache_url_option();
+    const OptionString & get_peer_cache_url_option() const;
     OptionString & get_comment_option();
     const OptionString & get_comment_option() const;
     OptionBool & get_downloadonly_option();
@@ -214,6 +275,91 @@ public:
     const OptionBool & get_protect_running_kernel_option() const;
     OptionBool & get_build_cache_option();
     const OptionBool & get_build_cache_option() const;
+    /// Write missing libsolv cache files of available repositories in a background thread instead of while loading
+    /// the repositories. The cache files are completed before the Base is destroyed.
+    OptionBool & get_build_cache_in_background_option();
+    const OptionBool & get_build_cache_in_background_option() const;
+    /// Maximum number of repositories whose metadata are downloaded concurrently
+    OptionNumber<std::uint32_t> & get_max_parallel_repo_downloads_option();
+    const OptionNumber<std::uint32_t> & get_max_parallel_repo_downloads_option() const;
+    /// Number of threads parsing metadata of repositories without valid libsolv cache files into the cache files
+    /// concurrently before the repositories are loaded. 0 means the metadata are parsed by the loader thread.
+    OptionNumber<std::uint32_t> & get_max_parallel_repo_cache_builds_option();
+    const OptionNumber<std::uint32_t> & get_max_parallel_repo_cache_builds_option() const;
+    /// Run the updates of repositories in the background mode: the threads downloading, parsing and writing
+    /// the metadata run with the lowest CPU and the idle I/O priority, the downloads are limited
+    /// by `background_bandwidth` and the update does not start while the memory pressure of the system
+    /// exceeds `background_memory_pressure_limit`.
+    /// @since 5.1.3
+    OptionBool & get_background_mode_option();
+    const OptionBool & get_background_mode_option() const;
+    /// Maximum download speed in the background mode in bytes per second, 0 means no limit.
+    /// A lower limit set by `throttle` is kept.
+    /// @since 5.1.3
+    OptionNumber<std::uint32_t> & get_background_bandwidth_option();
+    const OptionNumber<std::uint32_t> & get_background_bandwidth_option() const;
+    /// The "some avg10" memory pressure stall information of the system in percent above which the background
+    /// mode waits, at most five minutes, before it starts updating the repositories. 0 disables the waiting.
+    /// @since 5.1.3
+    OptionNumber<float> & get_background_memory_pressure_limit_option();
+    const OptionNumber<float> & get_background_memory_pressure_limit_option() const;
+    /// Read libsolv cache files into the page cache ahead of loading them and read them through a larger buffer.
+    /// The time and memory spent on loading each cache file are reported in the debug log.
+    OptionBool & get_solv_cache_prefetch_option();
+    const OptionBool & get_solv_cache_prefetch_option() const;
+    /// When filelists are enabled in "optional_metadata_types", do not load them with the repositories. They are loaded
+    /// the first time a query or the solver needs a file that is not in the primary filelist.
+    OptionBool & get_load_filelists_on_demand_option();
+    const OptionBool & get_load_filelists_on_demand_option() const;
+    /// When other metadata are enabled in "optional_metadata_types", do not load them with the repositories. They are
+    /// loaded for a repository the first time the changelogs of one of its packages are requested.
+    OptionBool & get_load_other_on_demand_option();
+    const OptionBool & get_load_other_on_demand_option() const;
+    /// Load the packages of the available repositories without their descriptions, URLs, licenses, packagers,
+    /// groups and build hosts. The packages are split into two libsolv cache files and the details of a repository
+    /// are loaded the first time they are requested. Intended for long-running processes, it needs "build_cache".
+    OptionBool & get_load_package_details_on_demand_option();
+    const OptionBool & get_load_package_details_on_demand_option() const;
+    /// Load changelogs of installed packages together with the system repository. When disabled, the changelogs
+    /// of an installed package are read from the rpmdb header the first time they are requested.
+    OptionBool & get_load_system_repo_changelogs_option();
+    const OptionBool & get_load_system_repo_changelogs_option() const;
+    /// Keep a libsolv cache file of the system repository in the system state directory. It is used as long as
+    /// the rpmdb cookie does not change, otherwise only the changed package headers are read from the rpmdb.
+    OptionBool & get_system_repo_cache_option();
+    const OptionBool & get_system_repo_cache_option() const;
+    /// Keep a snapshot of the parsed repository configuration files in the cache directory. It is used instead
+    /// of parsing the files as long as none of them and none of the repository directories changed.
+    OptionBool & get_repo_config_snapshot_option();
+    const OptionBool & get_repo_config_snapshot_option() const;
+    /// Build in-memory trigram indexes of package summaries and descriptions the first time they are searched.
+    /// Further searches match the patterns only against the packages shortlisted by the index.
+    OptionBool & get_text_search_index_option();
+    const OptionBool & get_text_search_index_option() const;
+    /// Build an in-memory index of the file paths in package filelists the first time packages are filtered
+    /// by a file. Further lookups of exact paths then check only the packages found in the index.
+    OptionBool & get_file_search_index_option();
+    const OptionBool & get_file_search_index_option() const;
+    /// Remember the results of the costly PackageQuery filters (provides, latest EVR, priority, upgrades, ...)
+    /// and reuse them when the same filter is applied to the same packages again. The results are dropped
+    /// when repositories are loaded or excludes change.
+    OptionBool & get_query_cache_option();
+    const OptionBool & get_query_cache_option() const;
+    /// Number of threads evaluating the expensive PackageQuery filters (summary, description and url searches,
+    /// name and arch globs and dependency matching) over large sets of packages. 0 or 1 means the filters are
+    /// evaluated by the calling thread only.
+    OptionNumber<std::uint32_t> & get_query_filter_threads_option();
+    const OptionNumber<std::uint32_t> & get_query_filter_threads_option() const;
+    /// Number of threads formatting large package lists for output (e.g. `repoquery --queryformat`). Only formats
+    /// reading the package name, EVR parts, arch and repository are formatted concurrently. 0 or 1 means
+    /// the packages are formatted by the calling thread only.
+    OptionNumber<std::uint32_t> & get_output_format_threads_option();
+    const OptionNumber<std::uint32_t> & get_output_format_threads_option() const;
+    /// Remember the solutions of the goal resolves and reuse them when a goal with the same jobs and solver settings
+    /// is resolved again against the same packages. The solutions are dropped when repositories are loaded
+    /// or excludes change. Not used when `debug_solver` is enabled.
+    OptionBool & get_resolve_cache_option();
+    const OptionBool & get_resolve_cache_option() const;
 
     // Repo main config
     OptionNumber<std::uint32_t> & get_retries_option();
@@ -222,6 +368,10 @@ public:
     const OptionPath & get_cachedir_option() const;
     OptionBool & get_fastestmirror_option();
     const OptionBool & get_fastestmirror_option() const;
+    /// Keep download statistics of the mirrors (latency, throughput and failures) in the cachedir across runs
+    /// and try the mirrors that were fast and reliable before first.
+    OptionBool & get_mirror_stats_option();
+    const OptionBool & get_mirror_stats_option() const;
     OptionStringList & get_excludepkgs_option();
     const OptionStringList & get_excludepkgs_option() const;
     OptionStringList & get_includepkgs_option();
@@ -264,6 +414,17 @@ public:
     const OptionSeconds & get_timeout_option() const;
     OptionNumber<std::uint32_t> & get_max_parallel_downloads_option();
     const OptionNumber<std::uint32_t> & get_max_parallel_downloads_option() const;
+    /// The largest number of packages downloaded from one mirror host at the same time. The remaining parallel
+    /// downloads go to other mirrors, a mirror that finishes its downloads sooner gets the next package sooner.
+    OptionNumber<std::uint32_t> & get_max_downloads_per_mirror_option();
+    const OptionNumber<std::uint32_t> & get_max_downloads_per_mirror_option() const;
+    /// Packages of at least this size are downloaded in byte range segments fetched concurrently from different
+    /// mirrors of the repository. The units 'k', 'M' and 'G' are accepted. 0 disables the segmented download.
+    OptionNumber<std::uint32_t> & get_segmented_download_min_size_option();
+    const OptionNumber<std::uint32_t> & get_segmented_download_min_size_option() const;
+    /// The largest number of segments of a package downloaded in segments, limited by the number of mirrors
+    OptionNumber<std::uint32_t> & get_segmented_download_segments_option();
+    const OptionNumber<std::uint32_t> & get_segmented_download_segments_option() const;
     OptionSeconds & get_metadata_expire_option();
     const OptionSeconds & get_metadata_expire_option() const;
     OptionString & get_sslcacert_option();
@@ -282,8 +443,12 @@ public:
     const OptionString & get_proxy_sslclientcert_option() const;
     OptionString & get_proxy_sslclientkey_option();
     const OptionString & get_proxy_sslclientkey_option() const;
+    /// Download delta RPMs from the presto metadata instead of the full packages when the base version is installed.
+    /// The packages are rebuilt from the deltas using `applydeltarpm` after the download. Deltas are not used
+    /// for an installroot other than "/" and require the "presto" optional metadata to be loaded.
     OptionBool & get_deltarpm_option();
     const OptionBool & get_deltarpm_option() const;
+    /// The largest size of a delta RPM used, in percent of the size of the full package. 0 disables delta RPMs.
     OptionNumber<std::uint32_t> & get_deltarpm_percentage_option();
     const OptionNumber<std::uint32_t> & get_deltarpm_percentage_option() const;
     OptionBool & get_skip_if_unavailable_option();
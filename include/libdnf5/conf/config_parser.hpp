@@ -101,6 +101,17 @@ public:
     */
     void read(const std::string & file_path);
     /**
+    * @brief Reads/parse one INI file
+    *
+    * Can be called repeately for reading/merge more INI files.
+    *
+    * @param file_path Name (with path) of file to read
+    * @param keep_raw_items If false, only sections and key-value pairs are stored. Comments, empty lines
+    *                       and the original formatting are dropped, it is faster for files that are not written back.
+    * @since 5.1.3
+    */
+    void read(const std::string & file_path, bool keep_raw_items);
+    /**
     * @brief Writes all data (all sections) to INI file
     *
     * @param file_path Name (with path) of file to write
@@ -117,7 +117,8 @@ protected:
     /// Tests new container item value and throws exception if the item value is not allowed.
     void test_item(const std::string & item) const;
 
-    std::optional<std::regex> regex_matcher;
+    /// The compiled `regex`, shared with the other options using the same expression
+    const std::regex * regex_matcher{nullptr};
     std::string regex;
     bool icase;
     std::optional<std::string> delimiters;
@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF5_CONF_VARS_HPP
 
 #include "libdnf5/base/base_weak.hpp"
+#include "libdnf5/common/impl_ptr.hpp"
 
 #include <map>
 #include <set>
@@ -60,11 +61,15 @@ public:
         Priority priority;
     };
 
-    Vars(const libdnf5::BaseWeakPtr & base) : base(base) {}
+    Vars(const libdnf5::BaseWeakPtr & base);
     Vars(libdnf5::Base & base);
+    ~Vars();
 
     /// @brief Substitute DNF vars in the input text.
     ///
+    /// The text is compiled into literal and variable segments once, the result is memoized until a variable
+    /// changes. The method can be called from several threads, also concurrently with `set()`.
+    ///
     /// @param text The text for substitution
     /// @return The substituted text
     std::string substitute(const std::string & text) const;
@@ -147,21 +152,21 @@ private:
         const std::function<const std::unique_ptr<const std::string>()> & get_value,
         Priority prio);
 
-    /// @brief Expand variables in a subexpression
-    ///
-    /// @param text String with variable expressions
-    /// @param depth The recursive depth
-    /// @return Pair of the resulting string and the number of characters scanned in `text`
-    std::pair<std::string, size_t> substitute_expression(std::string_view text, unsigned int depth) const;
-
     /// @brief Split releasever on the first "." into its "major" and "minor" components
     ///
     /// @param releasever A releasever string, possibly containing a "."
     /// @return releasever_major, releasever_minor
     static std::tuple<std::string, std::string> split_releasever(const std::string & releasever);
 
+    class SubstituteCache;
+
     BaseWeakPtr base;
+    // Changed by `set()` under the mutex of `substitute_cache`, so `substitute()` can run concurrently with `set()`.
+    // The other getters are not synchronized.
     std::map<std::string, Variable> variables;
+    // Used by the const `substitute()`. Added in 5.1.3, the member changed the size and layout of the class
+    // (ABI change).
+    mutable ImplPtr<SubstituteCache> substitute_cache;
 };
 
 }  // namespace libdnf5
@@ -0,0 +1,69 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_LOGGER_ASYNC_LOGGER_HPP
+#define LIBDNF5_LOGGER_ASYNC_LOGGER_HPP
+
+#include "logger.hpp"
+
+#include <memory>
+
+
+namespace libdnf5 {
+
+/// AsyncLogger is an implementation of logging class that passes incoming logging messages to a destination logger
+/// in a background writer thread. The callers only copy the messages into a bounded ring buffer of pre-allocated
+/// records, they do not wait for the destination logger (e.g. for file I/O).
+///
+/// When the buffer is full, new messages are dropped and the number of the dropped messages is logged by the writer
+/// thread. Critical messages are written before `write()` returns. Messages written in a forked child process are
+/// passed to the destination logger directly, the writer thread does not exist in the child.
+/// The remaining messages are written when the AsyncLogger is destroyed. Destroying it in a forked child does not
+/// wait for the writer thread, the messages buffered before the fork are left to the parent.
+///
+/// @since 5.1.3
+class AsyncLogger : public Logger {
+public:
+    /// Constructs a new AsyncLogger instance and starts its writer thread.
+    /// @param logger The destination logger.
+    /// @param capacity The number of messages the buffer can hold, it is rounded up to a power of two.
+    explicit AsyncLogger(std::unique_ptr<Logger> && logger, std::size_t capacity = 8192);
+    ~AsyncLogger();
+
+    void write(
+        const std::chrono::time_point<std::chrono::system_clock> & time,
+        pid_t pid,
+        Level level,
+        const std::string & message) noexcept override;
+
+    /// Waits until all the messages written so far are passed to the destination logger.
+    void flush() noexcept;
+
+    /// Returns the total number of messages dropped because the buffer was full.
+    std::size_t get_dropped_count() const noexcept;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+}  // namespace libdnf5
+
+#endif
@@ -30,6 +30,9 @@ namespace libdnf5 {
 
 /// MemoryBufferLogger is an implementation of logging class that stores incoming logging messages into memory buffer.
 /// It is usually used as temporary logger until a final logger is configured.
+///
+/// The messages are stored in a ring of records referring to one byte arena holding the message texts. When the
+/// ring or the arena is full, the oldest messages are dropped.
 class MemoryBufferLogger : public Logger {
 public:
     struct Item {
@@ -39,7 +42,14 @@ public:
         std::string message;
     };
 
-    explicit MemoryBufferLogger(std::size_t max_items_to_keep, std::size_t reserve = 0);
+    /// Average message size used to compute the default arena size
+    static constexpr std::size_t AVERAGE_MESSAGE_SIZE = 256;
+
+    /// @param max_items_to_keep The maximum number of kept messages, 0 means unlimited.
+    /// @param reserve The number of messages the buffer is pre-allocated for.
+    /// @param max_arena_size The maximum size of the stored message texts in bytes, 0 means
+    ///                       `max_items_to_keep * AVERAGE_MESSAGE_SIZE`. A longer message is truncated.
+    explicit MemoryBufferLogger(std::size_t max_items_to_keep, std::size_t reserve = 0, std::size_t max_arena_size = 0);
 
     void write(
         const std::chrono::time_point<std::chrono::system_clock> & time,
@@ -47,16 +57,37 @@ public:
         Level level,
         const std::string & message) noexcept override;
 
-    std::size_t get_items_count() const { return items.size(); }
-    const Item & get_item(std::size_t item_idx) const;
+    std::size_t get_items_count() const;
+    Item get_item(std::size_t item_idx) const;
+    /// Returns the number of messages dropped because the buffer was full.
+    /// @since 5.1.3
+    std::size_t get_dropped_count() const;
     void clear() noexcept;
     void write_to_logger(Logger & logger);
 
 private:
+    struct Record {
+        std::chrono::time_point<std::chrono::system_clock> time;
+        pid_t pid;
+        Level level;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    /// Returns the offset of `size` free bytes in the arena, grows the arena or drops the oldest records if needed.
+    std::size_t allocate(std::size_t size);
+    void drop_oldest() noexcept;
+    const Record & get_record(std::size_t item_idx) const noexcept;
+
     mutable std::mutex items_mutex;
     std::size_t max_items;  // rotation, oldest messages are replaced
-    std::size_t first_item_idx;
-    std::vector<Item> items;
+    std::size_t max_arena_size;
+    std::vector<Record> records;
+    std::size_t first_record_idx{0};
+    std::size_t records_count{0};
+    std::vector<char> arena;
+    std::size_t arena_head{0};
+    std::size_t dropped_count{0};
 };
 
 }  // namespace libdnf5
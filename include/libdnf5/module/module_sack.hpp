@@ -25,6 +25,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/module/module_item.hpp"
 #include "libdnf5/module/module_sack_weak.hpp"
 
+#include <cstdio>
 #include <map>
 #include <memory>
 #include <string>
@@ -123,6 +124,10 @@ private:
     /// all available repositories when modular metadata are available.
     void add(const std::string & file_content, const std::string & repo_id);
 
+    /// Load information about modules from the yaml stream (read till EOF) to ModuleSack. The stream is parsed
+    /// incrementally, without reading it into memory.
+    void add(FILE * yaml_stream, const std::string & repo_id);
+
     // TODO(pkratoch): Implement adding defaults from "/etc/dnf/modules.defaults.d/", which are defined by user.
     //                 They are added with priority 1000 after everything else is loaded.
     /// Add and resolve defaults.
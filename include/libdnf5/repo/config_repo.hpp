@@ -98,6 +98,8 @@ public:
     const OptionChild<OptionSeconds> & get_timeout_option() const;
     OptionChild<OptionNumber<std::uint32_t>> & get_max_parallel_downloads_option();
     const OptionChild<OptionNumber<std::uint32_t>> & get_max_parallel_downloads_option() const;
+    OptionChild<OptionNumber<std::uint32_t>> & get_max_downloads_per_mirror_option();
+    const OptionChild<OptionNumber<std::uint32_t>> & get_max_downloads_per_mirror_option() const;
     OptionChild<OptionSeconds> & get_metadata_expire_option();
     const OptionChild<OptionSeconds> & get_metadata_expire_option() const;
     OptionNumber<std::int32_t> & get_cost_option();
@@ -164,6 +166,11 @@ public:
         libdnf5::Logger & logger,
         Option::Priority priority = Option::Priority::REPOCONFIG) override;
 
+protected:
+    /// Registers the bindings of the repo options, the instances share a static table of them
+    /// @since 5.1.3
+    void register_opt_binds(OptionBinds & option_binds) override;
+
 private:
     class Impl;
     std::unique_ptr<Impl> p_impl;
@@ -0,0 +1,98 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_MEMORY_USAGE_HPP
+#define LIBDNF5_REPO_MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+/// Estimated memory used by the loaded metadata of one repository. The strings of the metadata are stored
+/// in the string space of the pool shared by all repositories, they are accounted in `MemoryUsage`.
+/// @since 5.1.3
+struct RepoMemoryUsage {
+    std::string repo_id;
+    /// Number of the solvables (packages, advisories, groups and environments) of the repository.
+    std::size_t solvables{0};
+    /// The solvable structures and the rpmdb ids of the installed packages.
+    std::size_t solvables_bytes{0};
+    /// The dependency id arrays of the solvables.
+    std::size_t idarray_bytes{0};
+    /// The repodata of the primary metadata (of the rpmdb for the system repository).
+    std::size_t primary_bytes{0};
+    /// The repodata of the filelists metadata.
+    std::size_t filelists_bytes{0};
+    /// The repodata of the other metadata (changelogs).
+    std::size_t other_bytes{0};
+    /// The repodata of the presto (delta rpm) metadata.
+    std::size_t presto_bytes{0};
+    /// The repodata of the updateinfo metadata.
+    std::size_t updateinfo_bytes{0};
+    /// The solvables and the repodata of the comps metadata in the comps pool.
+    std::size_t comps_bytes{0};
+
+    /// @return The sum of all the byte counts.
+    std::size_t get_total_bytes() const noexcept;
+};
+
+/// Estimated memory used by the loaded metadata and by the data structures libdnf5 builds over them.
+/// Only the memory of the main data structures is accounted, the estimate is therefore lower than the real usage.
+/// @since 5.1.3
+struct MemoryUsage {
+    /// The repositories with loaded metadata ordered by their ids
+    std::vector<RepoMemoryUsage> repos;
+
+    /// The string space and the string hash table of the package pool.
+    std::size_t pool_strings_bytes{0};
+    /// The dependency relations (reldeps) of the package pool.
+    std::size_t pool_reldeps_bytes{0};
+    /// The whatprovides index of the package pool.
+    std::size_t pool_whatprovides_bytes{0};
+    /// The string space, reldeps and whatprovides index of the comps pool, its solvables are accounted
+    /// in the repositories.
+    std::size_t comps_pool_bytes{0};
+    /// The string space, reldeps and solvables of the module pool.
+    std::size_t module_pool_bytes{0};
+
+    /// The sorted vectors of the package solvables used by the name and nevra filters.
+    std::size_t sorted_solvables_bytes{0};
+    /// The name arena and the text, file and upgrade indexes of the package solvables.
+    std::size_t package_indexes_bytes{0};
+    /// The excludes, includes and the considered maps of the package sack.
+    std::size_t considered_maps_bytes{0};
+    /// The query, resolve, unneeded and weak excludes caches of the package sack.
+    std::size_t package_caches_bytes{0};
+    /// The sorted packages, lookup indexes and applicability maps of the advisories.
+    std::size_t advisory_caches_bytes{0};
+
+    /// @return The sum of all the byte counts including the repositories.
+    std::size_t get_total_bytes() const noexcept;
+
+    /// @return Multi-line human readable description of the memory usage.
+    std::string to_string() const;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_MEMORY_USAGE_HPP
@@ -23,6 +23,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/conf/config_main.hpp"
 #include "libdnf5/rpm/package.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -55,6 +57,10 @@ public:
     /// Download the previously added packages.
     void download();
 
+    /// Returns the number of bytes transferred over the network by the last `download()`, including the failed
+    /// and repeated transfers. Packages found locally do not count.
+    std::uint64_t get_downloaded_bytes() const noexcept;
+
     /// Configure whether to fail the whole download on a first error or keep downloading.
     /// @param value If true, download will fail on the first error, otherwise it continues.
     /// This is set to true by default.
@@ -74,6 +80,12 @@ public:
     /// the next successful transaction.
     void force_keep_packages(bool value);
 
+    /// Sets a function called with each package whose file is ready after the download finished successfully or
+    /// the file was already downloaded. It is called from `download()` while the other packages are still being
+    /// downloaded, so it must not block.
+    /// @param callback The function to call, an empty function disables it.
+    void set_package_downloaded_callback(std::function<void(const libdnf5::rpm::Package & package)> callback);
+
 private:
     class Impl;
     std::unique_ptr<Impl> p_impl;
@@ -33,6 +33,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/rpm/package.hpp"
 
 #include <memory>
+#include <set>
+#include <string>
 
 
 namespace libdnf5::comps {
@@ -159,6 +161,25 @@ public:
     // @replaces libdnf:repo/Repo.hpp:method:Repo.downloadMetadata(const std::string & destdir)
     void download_metadata(const std::string & destdir);
 
+    /// Exports the cached metadata of the repository together with the solv cache files written for them into
+    /// the `bundle_dir` directory. The bundle can be imported on other machines to skip the download of
+    /// the metadata and the writing of the solv cache. A detached signature of the `bundle.toml` manifest
+    /// of the bundle can be stored as `bundle.toml.asc` next to it.
+    /// @param bundle_dir Path to the directory of the bundle, it is created if it does not exist.
+    /// @exception RepoError The repository was not loaded from the current metadata.
+    /// @since 5.1.3
+    void export_cache_bundle(const std::string & bundle_dir);
+
+    /// Replaces the cached metadata and solv cache files of the repository by the ones from a bundle written by
+    /// `export_cache_bundle()`. The files are checked against the manifest of the bundle, the solv cache files
+    /// must belong to the bundled metadata and to the libsolv in use. The signature of the manifest is checked
+    /// with the keys of the repository when present, it is required when `repo_gpgcheck` is enabled.
+    /// The imported cache is used by the next load of the repository.
+    /// @param bundle_dir Path to the directory of the bundle.
+    /// @exception RepoError The bundle is invalid, damaged, or is not for this repository.
+    /// @since 5.1.3
+    void import_cache_bundle(const std::string & bundle_dir);
+
     /// @deprecated It is going to be removed without a warning
     /// Loads the repository objects into sacks.
     ///
@@ -368,12 +389,25 @@ private:
     friend class FileDownloader;
     friend class PackageDownloader;
     friend class solv::Pool;
+    friend class SolvRepo;
 
     void make_solv_repo();
 
     void load_available_repo();
     void load_system_repo();
 
+    /// Loads the optional metadata `types` (e.g. "comps") of an available repository, the types already loaded
+    /// are skipped.
+    void load_optional_metadata(const std::set<std::string> & types);
+
+    /// Loads the optional metadata `types` into the already loaded available repository.
+    void load_optional_metadata_on_demand(const std::set<std::string> & types);
+
+    /// Creates missing or outdated libsolv cache files of an available repository in a private staging pool.
+    /// It does not touch the main pool, so it can run concurrently with loading of other repositories.
+    /// The following `load()` then only loads the cache files.
+    void build_solv_cache();
+
     void internalize();
 
     /// If the repository is not already marked as expired, it checks for the presence of the repository cache
@@ -397,6 +431,7 @@ private:
 
     WeakPtrGuard<Repo, false> data_guard;
     bool loaded{false};
+    std::set<std::string> loaded_optional_metadata_types;
 };
 
 }  // namespace libdnf5::repo
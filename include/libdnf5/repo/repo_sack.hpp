@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF5_RPM_REPO_SACK_HPP
 #define LIBDNF5_RPM_REPO_SACK_HPP
 
+#include "memory_usage.hpp"
 #include "repo.hpp"
 #include "repo_query.hpp"
 
@@ -28,6 +29,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/common/weak_ptr.hpp"
 #include "libdnf5/logger/logger.hpp"
 
+#include <optional>
+#include <set>
+#include <string>
+
 
 namespace libdnf5::repo {
 
@@ -76,7 +81,8 @@ public:
     /// "config_file_path" configuration option) and from directories defined by
     /// the "reposdir" configuration option.
     ///
-    /// Calls `create_repos_from_config_file()` and `create_repos_from_reposdir()`.
+    /// Calls `create_repos_from_config_file()` and `create_repos_from_reposdir()`. With the "repo_config_snapshot"
+    /// option the parsed files are stored in the cache directory and read from there while they do not change.
     void create_repos_from_system_configuration();
 
     /// Creates a new repository from a libsolv testcase file.
@@ -124,12 +130,55 @@ public:
     /// potentially downloads fresh metadata (by calling the
     /// `download_metadata()` method) and then queues them for loading. This
     /// speeds up the process by loading repos into memory while others are being
-    /// downloaded.
+    /// downloaded. Checking whether expired metadata are in sync with the origin
+    /// and downloading of the metadata is done concurrently for up to
+    /// "max_parallel_repo_downloads" repositories. If "max_parallel_repo_cache_builds"
+    /// is set, metadata of repositories without valid libsolv cache are parsed
+    /// into cache files by that many threads before being loaded.
     ///
     /// @param repos The repositories to update and load
     /// @param import_keys If true, attempts to download and import keys for repositories that failed key validation
     void update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool import_keys = true);
 
+    /// Downloads (if necessary) repository metadata and writes their libsolv cache files.
+    ///
+    /// Works like `update_and_load_repos()`, but the repositories are not loaded into the package sack.
+    /// The metadata of the repositories are downloaded only when they are expired according to their
+    /// "metadata_expire" option (and do not match the origin) or missing in the cache. The libsolv cache files
+    /// are written concurrently by at least "max_parallel_repo_downloads" threads, each repository is parsed in
+    /// a private pool. The system repository in `repos` is skipped. Intended for refreshing the cache.
+    ///
+    /// @param repos The repositories to update
+    /// @param import_keys If true, attempts to download and import keys for repositories that failed key validation
+    /// @return The number of repositories whose metadata were downloaded
+    std::size_t update_repos(libdnf5::repo::RepoQuery & repos, bool import_keys = true);
+
+    /// Limits the optional metadata loaded from the available repositories to the `types` (e.g. "updateinfo").
+    /// The metadata are still downloaded according to the "optional_metadata_types" configuration option,
+    /// so that the cached metadata stay complete for other operations. Intended for read-only operations
+    /// which need only a part of the metadata, it has to be set before the repositories are loaded.
+    /// @param types The types of the optional metadata to load, the other types are not loaded
+    void set_loaded_optional_metadata_types(std::set<std::string> types);
+
+    /// @return The types of the optional metadata loaded from the available repositories. These are the types
+    ///         declared by `require_optional_metadata_types()` and the types set by the "optional_metadata_types"
+    ///         configuration option (only when set by the user if anything was declared), limited by
+    ///         `set_loaded_optional_metadata_types()`.
+    std::set<std::string> get_loaded_optional_metadata_types() const;
+
+    /// Declares the optional metadata `types` (e.g. "comps" or "updateinfo") needed by the operation. Commands,
+    /// plugins and API users declare what they need, the demands are merged. Once anything is declared, the optional
+    /// metadata loaded from the available repositories are only the union of the declared types instead of the default
+    /// types of the "optional_metadata_types" option, the value of the option set by the user is still loaded.
+    /// Declaring empty `types` means that the primary metadata are enough. The declared types are downloaded
+    /// in addition to the types of the option.
+    ///
+    /// When the repositories are already loaded, the declared types which are not loaded yet are loaded into them
+    /// from the downloaded metadata.
+    /// @param types The types of the optional metadata needed by the operation
+    /// @since 5.1.3
+    void require_optional_metadata_types(const std::set<std::string> & types);
+
     RepoSackWeakPtr get_weak_ptr() { return RepoSackWeakPtr(this, &sack_guard); }
 
     /// @return The `Base` object to which this object belongs.
@@ -147,10 +196,17 @@ public:
     /// are created from info in system state.
     void fix_group_missing_xml();
 
+    /// Estimates the memory used by the loaded metadata of the repositories and by the package indexes
+    /// and caches built over them.
+    /// @return The memory usage broken down per repository and per data structure.
+    /// @since 5.1.3
+    MemoryUsage get_memory_usage();
+
 private:
     friend class libdnf5::Base;
     friend class RepoQuery;
     friend class rpm::PackageSack;
+    friend class RepoDownloader;
 
     explicit RepoSack(const libdnf5::BaseWeakPtr & base) : base(base) {}
     explicit RepoSack(libdnf5::Base & base);
@@ -163,11 +219,19 @@ private:
 
     void internalize_repos();
 
+    /// Creates the repositories from the sections of the configuration file at `path` parsed by `parser`.
+    void create_repos_from_parser(const std::string & path, const libdnf5::ConfigParser & parser);
+
+    /// Implements `update_and_load_repos()` and `update_repos()`, the repositories are loaded if `load` is set.
+    std::size_t update_repos_impl(libdnf5::repo::RepoQuery & repos, bool import_keys, bool load);
+
     BaseWeakPtr base;
 
     repo::Repo * system_repo{nullptr};
     repo::Repo * cmdline_repo{nullptr};
     bool repos_updated_and_loaded{false};
+    std::optional<std::set<std::string>> loaded_optional_metadata_types;
+    std::optional<std::set<std::string>> required_optional_metadata_types;
 };
 
 }  // namespace libdnf5::repo
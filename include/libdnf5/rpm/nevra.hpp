@@ -25,6 +25,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -120,6 +121,62 @@ inline std::vector<Nevra> Nevra::parse(const std::string & nevra_str) {
 }
 
 
+/// Non-owning NEVRA, its attributes reference the parsed string. It is valid only while the string exists.
+/// @since 5.1.3
+class NevraView {
+public:
+    NevraView() = default;
+
+    std::string_view get_name() const noexcept { return name; }
+    std::string_view get_epoch() const noexcept { return epoch; }
+    std::string_view get_version() const noexcept { return version; }
+    std::string_view get_release() const noexcept { return release; }
+    std::string_view get_arch() const noexcept { return arch; }
+
+    bool has_just_name() const noexcept {
+        return !name.empty() && epoch.empty() && version.empty() && release.empty() && arch.empty();
+    }
+
+    /// Returns a Nevra owning copies of the attributes
+    Nevra to_nevra() const;
+
+private:
+    friend class NevraParser;
+
+    std::string_view name;
+    std::string_view epoch;
+    std::string_view version;
+    std::string_view release;
+    std::string_view arch;
+};
+
+
+/// Parser of a NEVRA string in several forms without heap allocations. The string is scanned for the delimiters
+/// once during the construction, then each form is split into a NevraView referencing the string.
+/// The parsed string must outlive the parser and the views.
+/// @since 5.1.3
+class NevraParser {
+public:
+    /// Scans the `nevra_str` for the delimiters
+    /// @exception NevraIncorrectInputError The string contains ':' multiple times or an invalid character
+    explicit NevraParser(std::string_view nevra_str);
+
+    /// Splits the string in the `form`
+    /// @param form The form to split the string in
+    /// @param result The split parts, it is cleared when the string does not match the `form`
+    /// @return `true` if the string matches the `form`
+    bool parse(Nevra::Form form, NevraView & result) const noexcept;
+
+private:
+    std::string_view nevra_str;
+    // Positions of the delimiters in the string, `std::string_view::npos` when not found
+    std::size_t before_last_delim{std::string_view::npos};
+    std::size_t epoch_delim{std::string_view::npos};
+    std::size_t last_delim{std::string_view::npos};
+    std::size_t arch_delim{std::string_view::npos};
+};
+
+
 /// Create a full nevra string (always contains epoch) from an object
 template <typename T>
 inline std::string to_full_nevra_string(const T & obj) {
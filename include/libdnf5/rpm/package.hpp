@@ -27,8 +27,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/repo/repo_weak.hpp"
 #include "libdnf5/transaction/transaction_item_reason.hpp"
 
+#include <functional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -151,6 +153,34 @@ public:
     /// @since 5.0
     std::string get_na() const;
 
+    // The `*_view()` getters return the same values as the getters above, but instead of a copy they return a view
+    // into the strings stored in the package pool. The views are valid until the pool is modified, e.g. until
+    // a repository is loaded or a package is added.
+
+    /// @return RPM package Name (`RPMTAG_NAME`) without copying it, see `get_name()`.
+    /// @since 5.1.3
+    std::string_view get_name_view() const;
+
+    /// @return RPM package Epoch (`RPMTAG_EPOCH`) without copying it, see `get_epoch()`.
+    /// @since 5.1.3
+    std::string_view get_epoch_view() const;
+
+    /// @return RPM package Version (`RPMTAG_VERSION`) without copying it, see `get_version()`.
+    /// @since 5.1.3
+    std::string_view get_version_view() const;
+
+    /// @return RPM package Release (`RPMTAG_RELEASE`) without copying it, see `get_release()`.
+    /// @since 5.1.3
+    std::string_view get_release_view() const;
+
+    /// @return RPM package Arch (`RPMTAG_ARCH`) without copying it, see `get_arch()`.
+    /// @since 5.1.3
+    std::string_view get_arch_view() const;
+
+    /// @return RPM package EVR (Epoch:Version-Release) without copying it, see `get_evr()`.
+    /// @since 5.1.3
+    std::string_view get_evr_view() const;
+
     /// @return RPM package Group (`RPMTAG_GROUP`).
     /// @since 5.0
     //
@@ -263,6 +293,26 @@ public:
     // @replaces libdnf:libdnf/hy-package.h:function:dnf_package_get_description(DnfPackage * pkg)
     std::string get_description() const;
 
+    /// @return RPM package Packager without copying it, see `get_packager()` and `get_name_view()`.
+    /// @since 5.1.3
+    std::string_view get_packager_view() const;
+
+    /// @return RPM package Vendor without copying it, see `get_vendor()` and `get_name_view()`.
+    /// @since 5.1.3
+    std::string_view get_vendor_view() const;
+
+    /// @return RPM package URL without copying it, see `get_url()` and `get_name_view()`.
+    /// @since 5.1.3
+    std::string_view get_url_view() const;
+
+    /// @return RPM package Summary without copying it, see `get_summary()` and `get_name_view()`.
+    /// @since 5.1.3
+    std::string_view get_summary_view() const;
+
+    /// @return RPM package Description without copying it, see `get_description()` and `get_name_view()`.
+    /// @since 5.1.3
+    std::string_view get_description_view() const;
+
     // DEPENDENCIES
 
     /// @return List of RPM package Provides (`RPMTAG_PROVIDENAME`, `RPMTAG_PROVIDEFLAGS`, `RPMTAG_PROVIDEVERSION`).
@@ -355,10 +405,18 @@ public:
     // @replaces libdnf:libdnf/hy-package.h:function:dnf_package_get_files(DnfPackage * pkg)
     std::vector<std::string> get_files() const;
 
+    /// Calls `callback` for each file and directory the RPM package contains (`RPMTAG_FILENAMES`) without
+    /// building the whole list. The paths are read straight from the pool, a path is valid only during the call.
+    /// If file lists are not loaded, `callback` is not called.
+    /// @param callback  Function called with the path of each file, it must not modify the package sack.
+    /// @since 5.1.3
+    void for_each_file(const std::function<void(std::string_view path)> & callback) const;
+
     // ===== CHANGELOGS (other.xml) =====
 
     /// @return List of package changelog entries. If `other` repository metadata are
-    //          not loaded, empty list is returned.
+    //          not loaded, empty list is returned. With `load_other_on_demand`, the metadata
+    //          of the package repository are loaded by the first call.
     /// @since 5.0
     //
     // @replaces dnf:dnf/package.py:attribute:Package.changelogs
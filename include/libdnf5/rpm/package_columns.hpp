@@ -0,0 +1,119 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_COLUMNS_HPP
+#define LIBDNF5_RPM_PACKAGE_COLUMNS_HPP
+
+#include "package.hpp"
+#include "reldep.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Package attributes that can be extracted in a batch by `PackageSet::get_columns()`
+/// @since 5.1.3
+enum class PackageAttribute {
+    // string attributes, see `PackageColumns::get_strings()`
+    NAME,
+    EPOCH,
+    VERSION,
+    RELEASE,
+    ARCH,
+    EVR,
+    SUMMARY,
+    DESCRIPTION,
+    URL,
+    LICENSE,
+    PACKAGER,
+    VENDOR,
+    REPO_ID,
+    // numeric attributes, see `PackageColumns::get_numbers()`
+    DOWNLOAD_SIZE,
+    INSTALL_SIZE,
+    BUILD_TIME,
+    // reldep attributes, see `PackageColumns::get_reldeps()`
+    PROVIDES,
+    REQUIRES,
+    REQUIRES_PRE,
+    CONFLICTS,
+    OBSOLETES,
+    RECOMMENDS,
+    SUGGESTS,
+    ENHANCES,
+    SUPPLEMENTS
+};
+
+
+/// Attributes of the packages of a set extracted in a batch by `PackageSet::get_columns()`, one contiguous column
+/// per attribute. The row `i` of every column belongs to the package `get_ids()[i]`, the packages are ordered
+/// by their Ids as when iterating the set. The attributes have the same values as the corresponding getters
+/// of `Package`, the strings have the values of the `get_*_view()` getters and `requires` includes `requires_pre`.
+///
+/// The string views reference the strings stored in the pool, they are valid only until the pool is modified
+/// (e.g. by loading a repository). The reldep Ids are valid while the pool exists.
+/// @since 5.1.3
+class PackageColumns {
+public:
+    PackageColumns();
+    PackageColumns(const PackageColumns & src);
+    PackageColumns(PackageColumns && src) noexcept;
+    ~PackageColumns();
+
+    PackageColumns & operator=(const PackageColumns & src);
+    PackageColumns & operator=(PackageColumns && src) noexcept;
+
+    /// @return Number of rows, which is the number of packages.
+    std::size_t size() const noexcept;
+
+    /// @return Ids of the packages of the rows.
+    const std::vector<PackageId> & get_ids() const noexcept;
+
+    /// @return The column of a string `attribute`.
+    /// @exception libdnf5::UserAssertionError When the `attribute` was not extracted or is not a string attribute.
+    const std::vector<std::string_view> & get_strings(PackageAttribute attribute) const;
+
+    /// @return The column of a numeric `attribute`.
+    /// @exception libdnf5::UserAssertionError When the `attribute` was not extracted or is not a numeric attribute.
+    const std::vector<unsigned long long> & get_numbers(PackageAttribute attribute) const;
+
+    /// The reldeps of all rows are stored one after another, the reldeps of the row `i` are in the range
+    /// `[get_reldep_offsets(attribute)[i], get_reldep_offsets(attribute)[i + 1])`.
+    /// @return The reldeps of a reldep `attribute`.
+    /// @exception libdnf5::UserAssertionError When the `attribute` was not extracted or is not a reldep attribute.
+    const std::vector<ReldepId> & get_reldeps(PackageAttribute attribute) const;
+
+    /// @return The offsets of the rows in the `get_reldeps(attribute)` column, it has `size() + 1` items.
+    /// @exception libdnf5::UserAssertionError When the `attribute` was not extracted or is not a reldep attribute.
+    const std::vector<std::size_t> & get_reldep_offsets(PackageAttribute attribute) const;
+
+private:
+    friend class PackageSet;
+
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_COLUMNS_HPP
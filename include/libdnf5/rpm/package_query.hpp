@@ -285,6 +285,14 @@ public:
     void filter_provides(
         const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type = libdnf5::sack::QueryCmp::EQ);
 
+    /// Returns whether any package in the query provides the reldep. The result is the same as whether a copy
+    /// of the query filtered by `filter_provides()` with the reldep is not empty, but the providers are looked up
+    /// in the pool index and checked against the query directly, without creating a new query.
+    ///
+    /// @param reldep_id        Id of the reldep.
+    /// @since 5.1.3
+    bool is_provided(ReldepId reldep_id);
+
     /// Filter packages by their `requires`.
     ///
     /// @param reldep_list      ReldepList with RelDep objects the filter is matched against.
@@ -668,8 +676,63 @@ public:
     std::pair<bool, libdnf5::rpm::Nevra> resolve_pkg_spec(
         const std::string & pkg_spec, const libdnf5::ResolveSpecSettings & settings, bool with_src);
 
+    /// Resolve each of the specs according to provided settings the same way as `resolve_pkg_spec()` does.
+    /// The query itself is not modified. Specs that are plain package names are resolved together in a single
+    /// pass over the packages sorted by name. Specs that are globs of package names are matched against each distinct
+    /// package name of the query once. Other specs and the specs without a match are resolved one by one.
+    /// @param queries  Replaced by the queries with the packages matching each of the specs.
+    /// @return  The result of `resolve_pkg_spec()` for each of the specs.
+    std::vector<std::pair<bool, libdnf5::rpm::Nevra>> resolve_pkg_specs(
+        const std::vector<std::string> & pkg_specs,
+        const libdnf5::ResolveSpecSettings & settings,
+        bool with_src,
+        std::vector<PackageQuery> & queries);
+
     void swap(PackageQuery & other) noexcept;
 
+    /// Record the following calls of the filters that test every package on its own instead of applying them
+    /// immediately. These are the filters by strings (names, versions, reldeps, files, ...) and
+    /// `filter_installed()` / `filter_available()`. The recorded filters are applied by `apply_deferred_filters()`,
+    /// ordered by their estimated cost, so that expensive filters (e.g. by files or descriptions) only test
+    /// the packages left by the cheaper ones. The result is the same as if they were applied in the call order.
+    /// Any other filter applies the recorded filters first and recording continues after it. So do the methods
+    /// reading the content of the query (iteration, `size()`, `empty()`, `contains()`) and the set operations.
+    /// Passing the query where a PackageSet is expected (e.g. as the `other` operand of a set operation) requires
+    /// calling `apply_deferred_filters()` first.
+    /// The executed plan is written to the debug log.
+    void defer_filters();
+
+    /// Apply the filters recorded since `defer_filters()` and stop recording.
+    void apply_deferred_filters();
+
+    // The following methods hide the PackageSet ones to apply the filters recorded since `defer_filters()` first.
+
+    /// @since 5.1.3
+    iterator begin() const;
+    /// @since 5.1.3
+    iterator end() const;
+
+    /// @since 5.1.3
+    PackageQuery & operator|=(const PackageSet & other);
+    /// @since 5.1.3
+    PackageQuery & operator-=(const PackageSet & other);
+    /// @since 5.1.3
+    PackageQuery & operator&=(const PackageSet & other);
+
+    /// @since 5.1.3
+    void update(const PackageSet & other) { *this |= other; }
+    /// @since 5.1.3
+    void intersection(const PackageSet & other) { *this &= other; }
+    /// @since 5.1.3
+    void difference(const PackageSet & other) { *this -= other; }
+
+    /// @since 5.1.3
+    bool empty() const;
+    /// @since 5.1.3
+    bool contains(const Package & pkg) const;
+    /// @since 5.1.3
+    size_t size() const;
+
     /// Filter packages to keep only duplicates of installed packages. Packages are duplicate if they have the same `name` and `arch` but different `evr`.
     void filter_duplicates();
 
@@ -690,6 +753,36 @@ public:
     /// @return  Groups of one or more interdependent leaf packages.
     std::vector<std::vector<Package>> filter_leaves_groups();
 
+    /// Extend the query by the packages from `candidates` that provide, directly or transitively, the `requires`
+    /// of the packages in the query. Each dependency is looked up only once, so the whole closure is computed
+    /// in a single pass instead of repeated `filter_provides()` calls.
+    ///
+    /// @param candidates       Packages that can be added to the query.
+    /// @since 5.1.3
+    void extend_by_requires_closure(const PackageSet & candidates);
+
+    /// Extend the query by the packages from `candidates` that require, directly or transitively, any package
+    /// in the query. Each dependency is matched only once, so the whole closure is computed in a single pass
+    /// instead of repeated `filter_requires()` calls.
+    ///
+    /// @param candidates       Packages that can be added to the query.
+    /// @since 5.1.3
+    void extend_by_required_by_closure(const PackageSet & candidates);
+
+    /// Keep in the query only the source packages (`src` and `nosrc` architectures) from which any package
+    /// in the `package_set` was built. The packages are matched by their `sourcerpm`.
+    ///
+    /// @param package_set      Packages whose source packages are kept.
+    /// @since 5.1.3
+    void filter_sources_of(const PackageSet & package_set);
+
+    /// Keep in the query only the packages built from any source package in the `package_set`.
+    /// The packages are matched by their `sourcerpm`.
+    ///
+    /// @param package_set      Source packages whose built packages are kept.
+    /// @since 5.1.3
+    void filter_built_from(const PackageSet & package_set);
+
 private:
     std::vector<std::vector<Package>> filter_leaves(bool return_grouped_leaves);
 
@@ -30,6 +30,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/common/weak_ptr.hpp"
 #include "libdnf5/transaction/transaction_item_reason.hpp"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -60,6 +61,12 @@ class ModuleSack;
 
 }  // namespace libdnf5::module
 
+namespace libdnf5::repo {
+
+class RepoSack;
+
+}  // namespace libdnf5::repo
+
 namespace libdnf5::rpm::solv {
 
 class SolvPrivate;
@@ -94,6 +101,20 @@ public:
     /// Returns number of solvables in pool.
     int get_nsolvables() const noexcept;
 
+    /// Returns the number of PackageQuery filter results reused from the query cache.
+    /// The cache is enabled by the `query_cache` configuration option.
+    std::uint64_t get_query_cache_hits() const noexcept;
+
+    /// Returns the number of PackageQuery filter results computed because they were not in the query cache.
+    std::uint64_t get_query_cache_misses() const noexcept;
+
+    /// Returns the number of goal resolves whose solution was reused from the resolve cache.
+    /// The cache is enabled by the `resolve_cache` configuration option.
+    std::uint64_t get_resolve_cache_hits() const noexcept;
+
+    /// Returns the number of goal resolves that ran the solver because the solution was not in the resolve cache.
+    std::uint64_t get_resolve_cache_misses() const noexcept;
+
     /// Loads excluded and included package sets from the configuration.
     /// Uses the `disable_excludes`, `excludepkgs`, and `includepkgs` configuration options for calculation.
     /// @param only_main If `true`, the repository specific configurations are not used.
@@ -154,6 +175,7 @@ private:
     friend Reldep;
     friend class ReldepList;
     friend class repo::Repo;
+    friend class repo::RepoSack;
     friend class PackageQuery;
     friend class Transaction;
     friend libdnf5::Swdb;
@@ -23,12 +23,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include "package.hpp"
+#include "package_columns.hpp"
 #include "package_set_iterator.hpp"
 
 #include "libdnf5/common/exception.hpp"
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace libdnf5::advisory {
 
@@ -150,6 +152,14 @@ public:
     // @replaces libdnf:hy-packageset.h:function:dnf_packageset_count(DnfPackageSet * pset)
     size_t size() const noexcept;
 
+    /// Extracts the `attributes` of all packages in the set in a single pass over the packages.
+    /// It is cheaper than calling the getters of each `Package` for large sets.
+    ///
+    /// @param attributes The attributes to extract, each one is stored in its own column.
+    /// @return The columns of the attributes.
+    /// @since 5.1.3
+    PackageColumns get_columns(const std::vector<PackageAttribute> & attributes) const;
+
     void swap(PackageSet & other) noexcept;
 
 private:
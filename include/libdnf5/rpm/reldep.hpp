@@ -102,6 +102,7 @@ protected:
 private:
     friend class ReldepList;
     friend class ReldepListIterator;
+    friend class ReldepSpan;
 
     /// @brief Creates a reldep from name, version, and comparison type.
     ///
@@ -27,6 +27,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/base/base_weak.hpp"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 
 namespace libdnf5::rpm {
@@ -82,6 +84,15 @@ public:
     // @replaces libdnf/repo/solvable/DependencyContainer.hpp:method:addReldep(const char *reldepStr)
     bool add_reldep(const std::string & reldep_str);
 
+    /// @brief Adds the reldeps of all `reldep_strs` at once. The parsed dependency strings and the expanded
+    /// globs are cached in the pool, repeated strings are not parsed again.
+    ///
+    /// @param reldep_strs The dependency strings
+    /// @param with_glob When true, the strings containing a glob are expanded as by `add_reldep_with_glob()`
+    /// @return bool false if parsing or reldep creation of any of the strings fails, the others are added
+    /// @since 5.1.3
+    bool add_reldeps(const std::vector<std::string> & reldep_strs, bool with_glob = false);
+
     // @replaces libdnf/dnf-reldep-list.h:function:dnf_reldep_list_extend(DnfReldepList *rl1, DnfReldepList *rl2)
     // @replaces libdnf/repo/solvable/DependencyContainer.hpp:method:extend(DependencyContainer *container)
     void append(ReldepList & source);
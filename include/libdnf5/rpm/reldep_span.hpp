@@ -0,0 +1,118 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_RELDEP_SPAN_HPP
+#define LIBDNF5_RPM_RELDEP_SPAN_HPP
+
+#include "package.hpp"
+#include "package_columns.hpp"
+#include "reldep.hpp"
+
+#include "libdnf5/base/base_weak.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+
+namespace libdnf5::rpm {
+
+/// Non-owning view of the reldeps of one type of a package. It references the dependency array of the package
+/// stored in the pool, so it is created without copying the reldeps and the iteration yields their Ids without
+/// creating `Reldep` objects. The reldeps are the same as returned by the corresponding getter of `Package`,
+/// `requires` includes `requires_pre`.
+///
+/// The view is valid only until the packages in the pool are modified (e.g. by loading a repository
+/// or adding a package).
+/// @since 5.1.3
+class ReldepSpan {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = ReldepId;
+        using pointer = void;
+        using reference = ReldepId;
+
+        ReldepId operator*() const noexcept { return ReldepId(*current); }
+
+        iterator & operator++() noexcept {
+            if (++current == skipped) {
+                ++current;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const iterator & other) const noexcept { return current == other.current; }
+        bool operator!=(const iterator & other) const noexcept { return current != other.current; }
+
+    private:
+        friend ReldepSpan;
+
+        iterator(const int * current, const int * skipped) noexcept : current(current), skipped(skipped) {}
+
+        const int * current;
+        const int * skipped;
+    };
+
+    /// Creates the view of the reldeps of the `package` of a reldep `attribute`.
+    /// @exception libdnf5::UserAssertionError When the `attribute` is not a reldep attribute.
+    ReldepSpan(const Package & package, PackageAttribute attribute);
+
+    iterator begin() const noexcept { return iterator(first == skipped ? first + 1 : first, skipped); }
+    iterator end() const noexcept { return iterator(last, skipped); }
+
+    /// @return The number of the reldeps.
+    std::size_t size() const noexcept { return static_cast<std::size_t>(last - first) - (skipped ? 1 : 0); }
+
+    /// @return Whether there are no reldeps.
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @return The Id of the reldep at the `index`.
+    ReldepId get_id(std::size_t index) const noexcept {
+        const int * item = first + index;
+        return ReldepId(skipped && item >= skipped ? item[1] : *item);
+    }
+
+    /// @return The reldep at the `index`.
+    Reldep get(std::size_t index) const { return Reldep(base, get_id(index)); }
+
+    /// @return The string representation of the reldep at the `index`, as returned by `Reldep::to_string()`.
+    std::string to_string(std::size_t index) const;
+
+    libdnf5::BaseWeakPtr get_base() const { return base; }
+
+private:
+    BaseWeakPtr base;
+    const int * first{nullptr};
+    const int * last{nullptr};
+    /// The marker in the `[first, last)` range that separates two kinds of the reldeps and is skipped
+    const int * skipped{nullptr};
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_RELDEP_SPAN_HPP
@@ -24,6 +24,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "comps_group.hpp"
 #include "rpm_package.hpp"
 #include "transaction_item.hpp"
+#include "transaction_timing.hpp"
 
 #include "libdnf5/base/transaction_environment.hpp"
 #include "libdnf5/base/transaction_group.hpp"
@@ -152,6 +153,14 @@ public:
     // @replaces libdnf:transaction/Transaction.hpp:method:Transaction.getItems()
     std::vector<Package> & get_packages();
 
+    /// Return the wall times of the steps of the rpm transaction run: the whole run, its preparation,
+    /// the verification, the install and erase of every package and every scriptlet.
+    /// Empty for transactions recorded without timings.
+    std::vector<TransactionTiming> & get_timings();
+
+    /// Return the lines of the output of the scriptlets run by the transaction
+    std::vector<std::string> & get_console_output();
+
 private:
     friend Transformer;
     friend libdnf5::base::Transaction;
@@ -269,6 +278,16 @@ private:
     // @replaces libdnf:transaction/private/Transaction.hpp:method:Transaction.finish(libdnf::TransactionState state)
     void finish(TransactionState state);
 
+    /// Set the timings of the rpm transaction run, they are saved to the database by `finish()`
+    void set_timings(std::vector<TransactionTiming> && value) { timings = std::move(value); }
+
+    /// Set the output of the scriptlets, it is compressed and saved to the database by `finish()`
+    void set_console_output(std::string && value);
+
+    /// Set the output of the scriptlets already compressed by the reader of the output,
+    /// the chunks are saved to the database by `finish()`
+    void set_console_output_chunks(std::vector<std::string> && value) { console_output_chunks = std::move(value); }
+
     int64_t id{0};
 
     int64_t dt_begin = 0;
@@ -282,11 +301,13 @@ private:
     std::string comment;
     State state = State::STARTED;
 
-    std::optional<std::vector<std::pair<int, std::string>>> console_output;
+    std::optional<std::vector<std::string>> console_output;
+    std::vector<std::string> console_output_chunks;
 
     std::optional<std::vector<CompsEnvironment>> comps_environments;
     std::optional<std::vector<CompsGroup>> comps_groups;
     std::optional<std::vector<Package>> packages;
+    std::optional<std::vector<TransactionTiming>> timings;
 
     BaseWeakPtr base;
 };
@@ -25,12 +25,34 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/common/weak_ptr.hpp"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 
 namespace libdnf5::transaction {
 
 class TransactionHistory;
 using TransactionHistoryWeakPtr = libdnf5::WeakPtr<TransactionHistory, false>;
 
+/// Criteria of the transactions listed by `TransactionHistory::list_filtered_transactions()`.
+/// All the set criteria have to match. The filtering and the pagination are done by the database query,
+/// the items of the listed transactions are loaded on demand.
+struct TransactionListFilter {
+    /// Number of the matching transactions skipped from the start of the listing.
+    int64_t offset{0};
+    /// Maximal number of the listed transactions, 0 means no limit.
+    int64_t limit{0};
+    /// List the transactions from the most recent one, they are listed in the ascending order of ids otherwise.
+    bool descending{false};
+    /// List only the transactions started at or after this time (seconds since the epoch), 0 means no bound.
+    int64_t dt_begin_min{0};
+    /// List only the transactions started at or before this time (seconds since the epoch), 0 means no bound.
+    int64_t dt_begin_max{0};
+    /// List only the transactions with an rpm package of this name, empty means no filter.
+    std::string package_name;
+};
+
 /// A class for working with transactions recorded in the transaction history database.
 class TransactionHistory {
 public:
@@ -64,6 +86,29 @@ public:
     /// @return The listed transactions.
     std::vector<Transaction> list_all_transactions();
 
+    /// Lists one page of the transactions from the transaction history matching the `filter`.
+    ///
+    /// @param filter The criteria and the page of the listed transactions.
+    /// @return The listed transactions.
+    /// @since 5.2
+    std::vector<Transaction> list_filtered_transactions(const TransactionListFilter & filter);
+
+    /// Counts the transactions from the transaction history matching the `filter`, its `offset` and `limit`
+    /// are ignored.
+    ///
+    /// @param filter The criteria of the counted transactions.
+    /// @return The number of the matching transactions.
+    /// @since 5.2
+    int64_t count_filtered_transactions(const TransactionListFilter & filter);
+
+    /// Loads the packages, comps groups and comps environments of all the `transactions` at once, with one
+    /// database query per item type, instead of loading them lazily by a separate query per transaction.
+    /// The items already loaded are kept.
+    ///
+    /// @param transactions The transactions whose items are loaded.
+    /// @since 5.1.3
+    void load_transaction_items(std::vector<Transaction> & transactions);
+
     /// @return The `Base` object to which this object belongs.
     /// @since 5.0
     libdnf5::BaseWeakPtr get_base() const;
@@ -0,0 +1,91 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_TRANSACTION_TRANSACTION_TIMING_HPP
+#define LIBDNF5_TRANSACTION_TRANSACTION_TIMING_HPP
+
+#include "libdnf5/common/exception.hpp"
+
+#include <cstdint>
+#include <string>
+
+
+namespace libdnf5::transaction {
+
+/// Step of an rpm transaction run whose wall time is measured
+enum class TransactionTimingStep : int {
+    /// The whole rpm transaction run
+    TRANSACTION = 1,
+    /// Preparation of the rpm transaction (file conflicts, disk space checks)
+    PREPARE = 2,
+    /// Verification of the package files
+    VERIFY = 3,
+    /// Installation of a package
+    INSTALL = 4,
+    /// Removal of a package
+    ERASE = 5,
+    /// Run of a scriptlet of a package
+    SCRIPTLET = 6
+};
+
+
+class InvalidTransactionTimingStep : public libdnf5::Error {
+public:
+    InvalidTransactionTimingStep(const std::string & step);
+
+    const char * get_domain_name() const noexcept override { return "libdnf5::transaction"; }
+    const char * get_name() const noexcept override { return "InvalidTransactionTimingStep"; }
+};
+
+
+std::string transaction_timing_step_to_string(TransactionTimingStep step);
+TransactionTimingStep transaction_timing_step_from_string(const std::string & step);
+
+
+/// Wall time spent in a step of an rpm transaction run
+class TransactionTiming {
+public:
+    /// @param step The measured step.
+    /// @param nevra The full NEVRA of the package of the INSTALL, ERASE and SCRIPTLET steps, empty otherwise.
+    /// @param scriptlet The type of the scriptlet of the SCRIPTLET step (e.g. "post-install"), empty otherwise.
+    /// @param duration_us The wall time of the step in microseconds.
+    TransactionTiming(TransactionTimingStep step, std::string nevra, std::string scriptlet, int64_t duration_us);
+
+    /// Get the measured step
+    TransactionTimingStep get_step() const noexcept { return step; }
+
+    /// Get the full NEVRA of the package of the INSTALL, ERASE and SCRIPTLET steps, empty for the other steps
+    const std::string & get_nevra() const noexcept { return nevra; }
+
+    /// Get the type of the scriptlet of the SCRIPTLET step (e.g. "post-install"), empty for the other steps
+    const std::string & get_scriptlet() const noexcept { return scriptlet; }
+
+    /// Get the wall time of the step in microseconds
+    int64_t get_duration_us() const noexcept { return duration_us; }
+
+private:
+    TransactionTimingStep step;
+    std::string nevra;
+    std::string scriptlet;
+    int64_t duration_us;
+};
+
+}  // namespace libdnf5::transaction
+
+#endif  // LIBDNF5_TRANSACTION_TRANSACTION_TIMING_HPP
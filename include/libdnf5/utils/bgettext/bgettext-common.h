@@ -60,6 +60,17 @@ const char * b_dpgettext2(const char * domain, const char * ctxMsgId, size_t msg
 const char * b_dnpgettext2(
     const char * domain, const char * ctxMsgId, size_t msgIdOffset, const char * msgIdPlural, unsigned long int n);
 
+/// Returns `dgettext(domain, msgId)`. The translations are cached per thread and keyed by the address of
+/// the `msgId`, so it must be a string literal or otherwise never change its content. The _(), C_() and TM_() macros
+/// use it. The cache of a thread is dropped by b_gettext_cache_use_locale() when the thread switches to another
+/// locale. The global locale and the message catalogs bindings must be set up before the first translation.
+const char * b_dgettext_cached(const char * domain, const char * msgId);
+
+/// Tells the translation cache of the calling thread that the following translations are for the `locale`.
+/// The cache is dropped when the locale differs from the previous one. Intended to be called after changing
+/// the locale of the thread by `uselocale()`. NULL stands for the global locale.
+void b_gettext_cache_use_locale(const char * locale);
+
 #ifdef __cplusplus
 }
 #endif
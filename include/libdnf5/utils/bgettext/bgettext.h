@@ -22,7 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "bgettext-common.h"
 
-#define _(msgId)                  ((const char *)gettext(msgId))
+#define _(msgId)                  b_dgettext_cached(NULL, msgId)
 #define P_(msgId, msgIdPlural, n) ((const char *)ngettext(msgId, msgIdPlural, n))
 #define C_(context, msgId)        b_dpgettext2(NULL, context "\004" msgId, sizeof(context))
 #define CP_(context, msgId, msgIdPlural, n) \
@@ -357,6 +357,7 @@ void ArgumentParser::Command::print_complete(
             }
             auto & name = opt->get_id();
             if (name.compare(0, strlen(arg), arg) == 0) {
+                opt->setup();
                 help.add_line(name, '(' + opt->get_description() + ')', nullptr);
                 last = name + ' ';
             }
@@ -467,6 +468,7 @@ void ArgumentParser::CommandOrdinary::register_group(Group * grp) {
 }
 
 ArgumentParser::Command & ArgumentParser::CommandOrdinary::get_command(const std::string & id) const {
+    setup();
     if (auto ret = find_arg(cmds, id)) {
         return *ret;
     }
@@ -474,6 +476,7 @@ ArgumentParser::Command & ArgumentParser::CommandOrdinary::get_command(const std
 }
 
 ArgumentParser::NamedArg & ArgumentParser::CommandOrdinary::get_named_arg(const std::string & id) const {
+    setup();
     if (auto ret = find_arg(named_args, id)) {
         return *ret;
     }
@@ -482,6 +485,7 @@ ArgumentParser::NamedArg & ArgumentParser::CommandOrdinary::get_named_arg(const
 }
 
 ArgumentParser::PositionalArg & ArgumentParser::CommandOrdinary::get_positional_arg(const std::string & id) const {
+    setup();
     if (auto ret = find_arg(pos_args, id)) {
         return *ret;
     }
@@ -490,6 +494,7 @@ ArgumentParser::PositionalArg & ArgumentParser::CommandOrdinary::get_positional_
 }
 
 ArgumentParser::Group & ArgumentParser::CommandOrdinary::get_group(const std::string & id) const {
+    setup();
     if (auto ret = find_arg(groups, id)) {
         return *ret;
     }
@@ -497,6 +502,7 @@ ArgumentParser::Group & ArgumentParser::CommandOrdinary::get_group(const std::st
 }
 
 void ArgumentParser::CommandOrdinary::parse(const char * option, int argc, const char * const argv[]) {
+    setup();
     std::vector<NamedArg *> extended_named_args;
     bool inherit_named_args_from_parent = owner.inherit_named_args && parent;
     if (inherit_named_args_from_parent) {
@@ -606,6 +612,8 @@ void ArgumentParser::CommandOrdinary::parse(const char * option, int argc, const
 }
 
 void ArgumentParser::CommandAlias::parse(const char * option, int argc, const char * const argv[]) {
+    setup();
+
     // Invoke the attached named arguments
     for (auto & target_named_arg : attached_named_args) {
         auto & target_arg = owner.get_named_arg(target_named_arg.id_path, false);
@@ -763,8 +771,22 @@ std::vector<std::string> ArgumentParser::Command::get_invocation() const noexcep
     return invocation;
 }
 
+void ArgumentParser::Command::setup() const {
+    if (setup_func) {
+        // release the function before the call, so the lookups made by the function do not call it again
+        auto func = std::move(setup_func);
+        setup_func = nullptr;
+        func();
+    }
+}
+
 void ArgumentParser::Command::help() const noexcept {
+    setup();
     auto & cmds = get_commands();
+    // descriptions of the subcommands are set by their setup
+    for (const auto * cmd : cmds) {
+        cmd->setup();
+    }
     auto & named_args = get_named_args();
     auto & pos_args = get_positional_args();
     auto & groups = get_groups();
@@ -1012,6 +1034,7 @@ ArgumentParser::Command & ArgumentParser::get_command(const std::string & id_pat
 
     auto * cmd = root_command;
     if (id_path.empty()) {
+        cmd->setup();
         return *cmd;
     }
     std::string::size_type start_pos = 0;
@@ -1022,11 +1045,13 @@ ArgumentParser::Command & ArgumentParser::get_command(const std::string & id_pat
         dot_pos = id_path.find('.', start_pos);
     }
     cmd = &cmd->get_command(std::string(id_path, start_pos));
+    cmd->setup();
     return *cmd;
 }
 
 template <class Arg>
 static const std::vector<Arg *> & get_command_args(ArgumentParser::Command & command) {
+    command.setup();
     if constexpr (std::is_same<Arg, ArgumentParser::NamedArg>::value) {
         return command.get_named_args();
     }
@@ -79,10 +79,10 @@ void print_advisorylist_references_table(
         first_column_name = "Bugzilla";
     }
     struct libscols_table * table = create_advisorylist_table(first_column_name);
-    for (auto adv_pkg : advisory_package_list_not_installed) {
+    for (const auto & adv_pkg : advisory_package_list_not_installed) {
         auto advisory = adv_pkg.get_advisory();
         auto references = advisory.get_references({reference_type});
-        for (auto reference : references) {
+        for (const auto & reference : references) {
             add_line_into_advisorylist_table(
                 table,
                 reference.get_id().c_str(),
@@ -93,10 +93,10 @@ void print_advisorylist_references_table(
                 false);
         }
     }
-    for (auto adv_pkg : advisory_package_list_installed) {
+    for (const auto & adv_pkg : advisory_package_list_installed) {
         auto advisory = adv_pkg.get_advisory();
         auto references = advisory.get_references({reference_type});
-        for (auto reference : references) {
+        for (const auto & reference : references) {
             add_line_into_advisorylist_table(
                 table,
                 reference.get_id().c_str(),
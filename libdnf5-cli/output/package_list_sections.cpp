@@ -20,12 +20,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5-cli/output/package_list_sections.hpp"
 
 #include "libdnf5-cli/tty.hpp"
+#include "utils/utf8.hpp"
 
 #include <libdnf5/rpm/nevra.hpp>
 #include <libdnf5/rpm/package_set.hpp>
 #include <libsmartcols/libsmartcols.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <string>
 
@@ -46,18 +48,26 @@ PackageListSections::~PackageListSections() {
 
 
 void PackageListSections::print() {
+    if (streaming) {
+        print_streamed_sections();
+        if (streamed_separator_needed) {
+            std::cout << std::endl;
+        }
+        return;
+    }
+
     // smartcols does not support spanning the text among multiple cells to create
     // heading lines. To create sections, print the headings separately and than print
     // appropriate range of the table.
     bool separator_needed = false;
-    for (const auto & [heading, first, last] : sections) {
+    for (const auto & section : sections) {
         if (separator_needed) {
             std::cout << std::endl;
         }
-        if (!heading.empty()) {
-            std::cout << heading << std::endl;
+        if (!section.heading.empty()) {
+            std::cout << section.heading << std::endl;
         }
-        scols_table_print_range(table, first, last);
+        scols_table_print_range(table, section.first, section.last);
         separator_needed = true;
     }
     if (!sections.empty()) {
@@ -66,6 +76,67 @@ void PackageListSections::print() {
 }
 
 
+void PackageListSections::enable_streaming(std::size_t block_size) {
+    streaming = true;
+    streaming_block_size = std::max<std::size_t>(block_size, 1);
+}
+
+
+bool PackageListSections::is_block_full() const {
+    return streaming && scols_table_get_nlines(table) >= streaming_block_size;
+}
+
+
+void PackageListSections::print_full_block() {
+    if (is_block_full()) {
+        print_streamed_sections();
+    }
+}
+
+
+void PackageListSections::print_streamed_sections() {
+    for (const auto & section : sections) {
+        if (streamed_separator_needed && !section.continued) {
+            std::cout << std::endl;
+        }
+        if (!section.heading.empty()) {
+            std::cout << section.heading << std::endl;
+        }
+        scols_table_print_range(table, section.first, section.last);
+        streamed_separator_needed = true;
+    }
+    if (!column_widths_fixed && !sections.empty()) {
+        fix_column_widths();
+    }
+    sections.clear();
+    scols_table_remove_lines(table);
+    // The output to a pipe is not delayed until the buffer of the stream is full
+    std::cout.flush();
+    std::fflush(stdout);
+}
+
+
+void PackageListSections::fix_column_widths() {
+    // The last column does not affect the alignment of the others, its width is not fixed
+    auto num_columns = scols_table_get_ncols(table);
+    auto num_lines = scols_table_get_nlines(table);
+    for (std::size_t col_idx = 0; col_idx + 1 < num_columns; ++col_idx) {
+        std::size_t width = 0;
+        for (std::size_t line_idx = 0; line_idx < num_lines; ++line_idx) {
+            auto * cell = scols_line_get_cell(scols_table_get_line(table, line_idx), col_idx);
+            const char * data = cell ? scols_cell_get_data(cell) : nullptr;
+            if (data) {
+                width = std::max(width, libdnf5::cli::utils::utf8::width(data));
+            }
+        }
+        if (width > 0) {
+            scols_column_set_whint(scols_table_get_column(table, col_idx), static_cast<double>(width));
+        }
+    }
+    column_widths_fixed = true;
+}
+
+
 void PackageListSections::setup_cols() {
     scols_table_new_column(table, "Name", 1, 0);
     scols_table_new_column(table, "Version", 1, 0);
@@ -87,6 +158,9 @@ bool PackageListSections::add_section(
         }
         std::sort(packages.begin(), packages.end(), libdnf5::rpm::cmp_nevra<libdnf5::rpm::Package>);
 
+        // In the streaming mode, the section is printed in several blocks, only the first one has the heading
+        std::string block_heading = heading;
+        bool continued = false;
         struct libscols_line * first_line = nullptr;
         struct libscols_line * last_line = nullptr;
         for (const auto & pkg : packages) {
@@ -116,8 +190,18 @@ bool PackageListSections::add_section(
                     scols_line_set_data(ln, COL_REPO, pkg_ob.get_from_repo_id().c_str());
                 }
             }
+
+            if (is_block_full()) {
+                sections.emplace_back(std::move(block_heading), first_line, last_line, continued);
+                print_full_block();
+                block_heading.clear();
+                continued = true;
+                first_line = nullptr;
+            }
+        }
+        if (first_line) {
+            sections.emplace_back(std::move(block_heading), first_line, last_line, continued);
         }
-        sections.emplace_back(heading, first_line, last_line);
         return true;
     } else {
         return false;
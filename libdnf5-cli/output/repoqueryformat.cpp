@@ -18,40 +18,61 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 
-#include "fmt/args.h"
-
 #include "libdnf5-cli/output/repoquery.hpp"
 
+#include <libdnf5/base/base.hpp>
 #include <libdnf5/common/exception.hpp>
+#include <libdnf5/rpm/reldep_span.hpp>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <optional>
 #include <set>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 namespace libdnf5::cli::output {
 
 using StrGetter = std::string (libdnf5::rpm::Package::*)() const;
-using VecStrGetter = std::vector<std::string> (libdnf5::rpm::Package::*)() const;
+using StrViewGetter = std::string_view (libdnf5::rpm::Package::*)() const;
+// The strings are passed to a callback one by one, e.g. the files, without building a vector
+using StrCallbackGetter =
+    void (libdnf5::rpm::Package::*)(const std::function<void(std::string_view)> & callback) const;
 using UnsignedLongLongGetter = unsigned long long (libdnf5::rpm::Package::*)() const;
 using ReldepListGetter = libdnf5::rpm::ReldepList (libdnf5::rpm::Package::*)() const;
+// The reldeps of the attribute are read through a ReldepSpan, without copying them to a ReldepList
+using ReldepSpanAttribute = libdnf5::rpm::PackageAttribute;
 using TransactionItemReasonGetter = libdnf5::transaction::TransactionItemReason (libdnf5::rpm::Package::*)() const;
 using StrGetterLambda = std::function<std::string(const libdnf5::rpm::Package &)>;
 
 using Getter = std::variant<
     StrGetter,
-    VecStrGetter,
+    StrViewGetter,
+    StrCallbackGetter,
     UnsignedLongLongGetter,
     ReldepListGetter,
+    ReldepSpanAttribute,
     TransactionItemReasonGetter,
     StrGetterLambda>;
 
 static const std::unordered_map<std::string, Getter> NAME_TO_GETTER = {
-    {"name", &libdnf5::rpm::Package::get_name},
-    {"epoch", &libdnf5::rpm::Package::get_epoch},
-    {"version", &libdnf5::rpm::Package::get_version},
-    {"release", &libdnf5::rpm::Package::get_release},
-    {"arch", &libdnf5::rpm::Package::get_arch},
-    {"evr", &libdnf5::rpm::Package::get_evr},
+    {"name", &libdnf5::rpm::Package::get_name_view},
+    {"epoch", &libdnf5::rpm::Package::get_epoch_view},
+    {"version", &libdnf5::rpm::Package::get_version_view},
+    {"release", &libdnf5::rpm::Package::get_release_view},
+    {"arch", &libdnf5::rpm::Package::get_arch_view},
+    {"evr", &libdnf5::rpm::Package::get_evr_view},
     {"full_nevra", &libdnf5::rpm::Package::get_full_nevra},
     {"group", &libdnf5::rpm::Package::get_group},
     {"downloadsize", &libdnf5::rpm::Package::get_download_size},
@@ -60,22 +81,22 @@ static const std::unordered_map<std::string, Getter> NAME_TO_GETTER = {
     {"source_name", &libdnf5::rpm::Package::get_source_name},
     {"sourcerpm", &libdnf5::rpm::Package::get_sourcerpm},
     {"buildtime", &libdnf5::rpm::Package::get_build_time},
-    {"packager", &libdnf5::rpm::Package::get_packager},
-    {"vendor", &libdnf5::rpm::Package::get_vendor},
-    {"url", &libdnf5::rpm::Package::get_url},
-    {"summary", &libdnf5::rpm::Package::get_summary},
-    {"description", &libdnf5::rpm::Package::get_description},
-    {"provides", &libdnf5::rpm::Package::get_provides},
-    {"requires", &libdnf5::rpm::Package::get_requires},
-    {"requires_pre", &libdnf5::rpm::Package::get_requires_pre},
-    {"conflicts", &libdnf5::rpm::Package::get_conflicts},
-    {"obsoletes", &libdnf5::rpm::Package::get_obsoletes},
+    {"packager", &libdnf5::rpm::Package::get_packager_view},
+    {"vendor", &libdnf5::rpm::Package::get_vendor_view},
+    {"url", &libdnf5::rpm::Package::get_url_view},
+    {"summary", &libdnf5::rpm::Package::get_summary_view},
+    {"description", &libdnf5::rpm::Package::get_description_view},
+    {"provides", libdnf5::rpm::PackageAttribute::PROVIDES},
+    {"requires", libdnf5::rpm::PackageAttribute::REQUIRES},
+    {"requires_pre", libdnf5::rpm::PackageAttribute::REQUIRES_PRE},
+    {"conflicts", libdnf5::rpm::PackageAttribute::CONFLICTS},
+    {"obsoletes", libdnf5::rpm::PackageAttribute::OBSOLETES},
     {"prereq_ignoreinst", &libdnf5::rpm::Package::get_prereq_ignoreinst},
     {"regular_requires", &libdnf5::rpm::Package::get_regular_requires},
-    {"recommends", &libdnf5::rpm::Package::get_recommends},
-    {"suggests", &libdnf5::rpm::Package::get_suggests},
-    {"enhances", &libdnf5::rpm::Package::get_enhances},
-    {"supplements", &libdnf5::rpm::Package::get_supplements},
+    {"recommends", libdnf5::rpm::PackageAttribute::RECOMMENDS},
+    {"suggests", libdnf5::rpm::PackageAttribute::SUGGESTS},
+    {"enhances", libdnf5::rpm::PackageAttribute::ENHANCES},
+    {"supplements", libdnf5::rpm::PackageAttribute::SUPPLEMENTS},
     {"depends", &libdnf5::rpm::Package::get_depends},
     {"from_repo", &libdnf5::rpm::Package::get_from_repo_id},
     {"installtime", &libdnf5::rpm::Package::get_install_time},
@@ -84,7 +105,7 @@ static const std::unordered_map<std::string, Getter> NAME_TO_GETTER = {
     {"reason", &libdnf5::rpm::Package::get_reason},
     {"debug_name", &libdnf5::rpm::Package::get_debuginfo_name},
     {"source_debug_name", &libdnf5::rpm::Package::get_debuginfo_name_of_source},
-    {"files", &libdnf5::rpm::Package::get_files},
+    {"files", &libdnf5::rpm::Package::for_each_file},
     {"location",
      [](const libdnf5::rpm::Package & pkg) -> std::string {
          auto locs = pkg.get_remote_locations();
@@ -105,69 +126,92 @@ void print_available_pkg_attrs(std::FILE * target) {
     }
 }
 
-// Argument format contains partially copied and converted queryformat, for example: "name: %-30{{name".
-// We know the tag "name" is valid so this function check align spec "-30" and if it is valid
-// it overwrites the format with fmt formatting: "name: {:<30}".
-static bool replace_tag_in_format(
-    std::string & format,
-    std::string::size_type & format_size,
-    std::string::size_type tag_start,
-    std::string::size_type tag_name_start) {
-    std::string align_spec;
-    // Check if there is valid align spec between '%' and '{' -> ..%-30{...
-    if (tag_start + 1 != tag_name_start) {
-        align_spec = format.substr(tag_start + 1, tag_name_start - tag_start - 1);
-        auto iter = align_spec.begin();
-        // first char can be either a digit or '-' sign
-        if ((*iter != '-') && (std::isdigit(*iter) == 0)) {
-            return false;
-        }
-        // verify the rest is only digits
-        ++iter;
-        while (iter != align_spec.end() && (std::isdigit(*iter) != 0)) {
-            ++iter;
-        }
-        if (iter != align_spec.end()) {
-            return false;
-        }
-    }
+namespace {
+
+/// The attributes read only from the pool strings and the repository configuration. They can be read by several
+/// threads at once while the pool is not modified. The other getters can load repodata pages, use the pool
+/// temporary space or fill caches.
+const std::unordered_set<std::string_view> THREAD_SAFE_TAGS = {
+    "name", "epoch", "version", "release", "arch", "evr", "repoid", "reponame"};
+
+/// Minimal number of packages in one chunk formatted by a worker thread
+constexpr std::size_t MIN_PACKAGES_PER_WORKER = 10000;
+
+/// One item of a compiled queryformat: either a literal text or a package attribute tag
+struct QueryFormatItem {
+    /// The literal text, used when the item is not a tag
+    std::string text;
+    /// The getter of the tag, `nullptr` for a literal text
+    const Getter * getter{nullptr};
+    /// Whether the tag has an align spec, e.g. "%-30{name}"
+    bool aligned{false};
+    bool left_align{false};
+    std::size_t width{0};
+    /// Whether the item can be formatted by several threads at once
+    bool thread_safe{true};
+};
 
-    // Since we use positional args for fmt::vprint we have to remove the tag name.
-    // We do this by overwriting the previously copied tag.
-    format_size = tag_start;
-    format[format_size] = '{';
-    format_size++;
+/// The unique lines formatted from a chunk of packages, sorted. The lines are views of the buffer.
+struct FormattedChunk {
+    std::string buffer;
+    std::vector<std::string_view> lines;
+};
 
-    if (!align_spec.empty()) {
-        format[format_size] = ':';
-        format_size++;
+/// Position of one formatted package in the output buffer
+struct BufferEntry {
+    std::size_t offset;
+    std::size_t size;
+};
 
-        auto iter = align_spec.begin();
-        if (*iter == '-') {
-            format[format_size] = '<';
-            iter++;  //skip the sign
-        } else {
-            format[format_size] = '>';
-        }
-        format_size++;
-        while (iter != align_spec.end()) {
-            format[format_size] = *iter;
-            format_size++;
-            ++iter;
-        }
+/// Hashes and compares the buffer entries by their text, the entries stay valid when the buffer grows
+struct BufferEntryHash {
+    const std::string * buffer;
+    std::size_t operator()(const BufferEntry & entry) const noexcept {
+        return std::hash<std::string_view>{}(std::string_view(*buffer).substr(entry.offset, entry.size));
+    }
+};
+
+struct BufferEntryEqual {
+    const std::string * buffer;
+    bool operator()(const BufferEntry & lhs, const BufferEntry & rhs) const noexcept {
+        std::string_view view(*buffer);
+        return view.substr(lhs.offset, lhs.size) == view.substr(rhs.offset, rhs.size);
     }
+};
 
-    format[format_size] = '}';
-    format_size++;
+// The align spec is the text between '%' and '{' of a tag, for example "-30" in "%-30{name}".
+// It is valid if it is empty or if it consists of an optional '-' sign followed by digits.
+bool parse_align_spec(std::string_view align_spec, QueryFormatItem & item) {
+    if (align_spec.empty()) {
+        return true;
+    }
+    // first char can be either a digit or '-' sign
+    if ((align_spec[0] != '-') && (std::isdigit(align_spec[0]) == 0)) {
+        return false;
+    }
+    item.aligned = true;
+    item.left_align = align_spec[0] == '-';
+    // verify the rest is only digits
+    for (auto iter = align_spec.begin() + 1; iter != align_spec.end(); ++iter) {
+        if (std::isdigit(*iter) == 0) {
+            return false;
+        }
+    }
+    if (item.left_align) {
+        align_spec.remove_prefix(1);
+    }
+    for (char digit : align_spec) {
+        item.width = item.width * 10 + static_cast<std::size_t>(digit - '0');
+    }
     return true;
 }
 
-std::pair<std::vector<Getter>, std::string> parse_queryformat(const std::string & queryformat) {
-    std::vector<Getter> getters;
-    std::string format;
-    // format max possible len is 2 * queryformat.size() (if it contained just curly braces)
-    format.resize(2 * queryformat.size());
-    std::string::size_type format_size = 0;
+// Compiles the queryformat into a list of literal texts and tags. We try to match rpm query formatting.
+// For example: "%-30{name}%{evr}\n" is compiled into two tags, the first one left aligned to 30 characters,
+// and the "\n" literal.
+std::vector<QueryFormatItem> compile_queryformat(const std::string & queryformat) {
+    std::vector<QueryFormatItem> items;
+    std::string literal;
     std::string::size_type tag_start = 0;
     std::string::size_type tag_name_start = 0;
     char previous_qf_char = 0;
@@ -175,60 +219,130 @@ std::pair<std::vector<Getter>, std::string> parse_queryformat(const std::string
     enum State { OUTSIDE, IN_TAG, IN_TAG_NAME };
     State state = OUTSIDE;
 
-    // Prepare format string and getters.
-    // We try to match rpm query formatting.
-    // For example: "%-30{name}%{evr}" needs to be converted to "{:<30}{}" that is
-    // two positional fmt arguments (first one with align formatting) and we need
-    // get_name() and get_evr() getters.
     for (char qf_char : queryformat) {
         if (qf_char == '%') {  // start of tag
             state = IN_TAG;
-            tag_start = format_size;
+            tag_start = literal.size();
         } else if (qf_char == '{' && state == IN_TAG) {  // start of tag name
             state = IN_TAG_NAME;
-            tag_name_start = format_size;
+            tag_name_start = literal.size();
         } else if (qf_char == '}' && state == IN_TAG_NAME) {  // end of tag
             state = OUTSIDE;
-            // To get the name we add/subtract 2 becasue each tag name (after brace expansion) starts with "{{".
-            auto getter_name = format.substr(tag_name_start + 2, format_size - tag_name_start - 2);
-            auto getter = NAME_TO_GETTER.find(getter_name);
-            if (getter != NAME_TO_GETTER.end()) {
-                if (replace_tag_in_format(format, format_size, tag_start, tag_name_start)) {
-                    getters.push_back(getter->second);
-                    continue;  // continue to skip adding the current qf_char ('}')
+            auto getter = NAME_TO_GETTER.find(literal.substr(tag_name_start + 1));
+            QueryFormatItem tag;
+            if (getter != NAME_TO_GETTER.end() &&
+                parse_align_spec(
+                    std::string_view(literal).substr(tag_start + 1, tag_name_start - tag_start - 1), tag)) {
+                // The tag was copied to the literal text, remove it
+                literal.resize(tag_start);
+                if (!literal.empty()) {
+                    items.emplace_back().text = std::move(literal);
+                    literal.clear();
                 }
+                tag.getter = &getter->second;
+                tag.thread_safe = THREAD_SAFE_TAGS.contains(getter->first);
+                items.push_back(std::move(tag));
+                continue;  // continue to skip adding the current qf_char ('}')
             }
         }
 
-        // Copy each char of queryformat to format string with required changes.
-        if (qf_char == '{' || qf_char == '}') {
-            // double the brace -> escaping for fmt
-            format[format_size] = qf_char;
-            format_size++;
-            format[format_size] = qf_char;
-            format_size++;
-        } else if (previous_qf_char == '\\' && qf_char == 'n') {
+        if (previous_qf_char == '\\' && qf_char == 'n') {
             // replace new lines, two characters in input: '\' 'n' -> '\n'
-            format[format_size - 1] = '\n';  //replace the previous '\'
+            literal.back() = '\n';  //replace the previous '\'
         } else {
-            format[format_size] = qf_char;
-            format_size++;
+            literal.push_back(qf_char);
         }
 
         previous_qf_char = qf_char;
     }
 
-    // Resize the format to resulting size to trim excess characters.
-    format.resize(format_size);
+    if (!literal.empty()) {
+        items.emplace_back().text = std::move(literal);
+    }
 
-    return {getters, format};
+    return items;
 }
 
+// Appends the value of the attribute of the `package` to `out`. Multiple values are terminated by new lines.
+void append_attribute(std::string & out, const libdnf5::rpm::Package & package, const Getter & getter) {
+    std::visit(
+        [&out, &package](const auto & getter_func) {
+            using T = std::decay_t<decltype(getter_func)>;
+            if constexpr (std::is_same_v<T, ReldepListGetter>) {
+                for (const auto & reldep : (package.*getter_func)()) {
+                    out.append(reldep.to_string());
+                    out.push_back('\n');
+                }
+            } else if constexpr (std::is_same_v<T, ReldepSpanAttribute>) {
+                libdnf5::rpm::ReldepSpan reldeps(package, getter_func);
+                for (std::size_t idx = 0; idx < reldeps.size(); ++idx) {
+                    out.append(reldeps.to_string(idx));
+                    out.push_back('\n');
+                }
+            } else if constexpr (std::is_same_v<T, StrCallbackGetter>) {
+                (package.*getter_func)([&out](std::string_view str) {
+                    out.append(str);
+                    out.push_back('\n');
+                });
+            } else if constexpr (std::is_same_v<T, UnsignedLongLongGetter>) {
+                fmt::format_int number((package.*getter_func)());
+                out.append(number.data(), number.size());
+            } else if constexpr (std::is_same_v<T, TransactionItemReasonGetter>) {
+                out.append(transaction_item_reason_to_string((package.*getter_func)()));
+            } else if constexpr (std::is_same_v<T, StrGetterLambda>) {
+                out.append((getter_func)(package));
+            } else {
+                // The views reference the pool strings, they are appended without copying to a temporary string
+                out.append((package.*getter_func)());
+            }
+        },
+        getter);
+}
+
+// Formats the `packages` into the `chunk`, the duplicates are dropped right after they are formatted.
+void format_packages(
+    const std::vector<QueryFormatItem> & items,
+    std::span<const libdnf5::rpm::Package> packages,
+    FormattedChunk & chunk) {
+    auto & buffer = chunk.buffer;
+    std::string aligned_value;
+    std::unordered_set<BufferEntry, BufferEntryHash, BufferEntryEqual> entries(
+        packages.size(), BufferEntryHash{&buffer}, BufferEntryEqual{&buffer});
+    for (const auto & package : packages) {
+        auto offset = buffer.size();
+        for (const auto & item : items) {
+            if (!item.getter) {
+                buffer.append(item.text);
+            } else if (!item.aligned) {
+                append_attribute(buffer, package, *item.getter);
+            } else {
+                aligned_value.clear();
+                append_attribute(aligned_value, package, *item.getter);
+                if (item.left_align) {
+                    fmt::format_to(std::back_inserter(buffer), "{:<{}}", aligned_value, item.width);
+                } else {
+                    fmt::format_to(std::back_inserter(buffer), "{:>{}}", aligned_value, item.width);
+                }
+            }
+        }
+        if (!entries.insert({offset, buffer.size() - offset}).second) {
+            buffer.resize(offset);
+        }
+    }
+
+    chunk.lines.reserve(entries.size());
+    for (const auto & entry : entries) {
+        chunk.lines.push_back(std::string_view(buffer).substr(entry.offset, entry.size));
+    }
+    std::sort(chunk.lines.begin(), chunk.lines.end());
+}
+
+}  // namespace
+
 bool requires_filelists(const std::string & queryformat) {
-    auto [getters, _] = parse_queryformat(queryformat);
-    for (auto getter : getters) {
-        auto * getter_pointer = std::get_if<VecStrGetter>(&getter);
-        if (getter_pointer && (*getter_pointer == &libdnf5::rpm::Package::get_files)) {
+    for (const auto & item : compile_queryformat(queryformat)) {
+        auto * getter_pointer = item.getter ? std::get_if<StrCallbackGetter>(item.getter) : nullptr;
+        if (getter_pointer && (*getter_pointer == &libdnf5::rpm::Package::for_each_file)) {
             return true;
         }
     }
@@ -238,48 +352,79 @@ bool requires_filelists(const std::string & queryformat) {
 
 void print_pkg_set_with_format(
     std::FILE * target, const libdnf5::rpm::PackageSet & pkgs, const std::string & queryformat) {
-    auto [getters, format] = parse_queryformat(queryformat);
+    auto items = compile_queryformat(queryformat);
 
-    std::set<std::string> output;
-    // Format and print each package.
-    fmt::dynamic_format_arg_store<fmt::format_context> arg_store;
-    arg_store.reserve(getters.size(), getters.size());
+    // The packages are created by the calling thread, the workers only read them
+    std::vector<libdnf5::rpm::Package> packages;
+    packages.reserve(pkgs.size());
     for (auto package : pkgs) {
-        arg_store.clear();
-        for (const auto & getter : getters) {
-            std::visit(
-                [&arg_store, &package](const auto & getter_func) {
-                    using T = std::decay_t<decltype(getter_func)>;
-                    if constexpr (std::is_same_v<T, ReldepListGetter>) {
-                        std::string joined;
-                        for (const auto & reldep : (package.*getter_func)()) {
-                            joined.append(std::move(reldep.to_string()));
-                            joined.push_back('\n');
-                        }
-                        arg_store.push_back(joined);
-                    } else if constexpr (std::is_same_v<T, VecStrGetter>) {
-                        std::string joined;
-                        for (const auto & str : (package.*getter_func)()) {
-                            joined.append(std::move(str));
-                            joined.push_back('\n');
-                        }
-                        arg_store.push_back(joined);
-                    } else if constexpr (std::is_same_v<T, TransactionItemReasonGetter>) {
-                        arg_store.push_back(std::move(transaction_item_reason_to_string((package.*getter_func)())));
-                    } else if constexpr (std::is_same_v<T, StrGetterLambda>) {
-                        arg_store.push_back((getter_func)(package));
-                    } else {
-                        arg_store.push_back((package.*getter_func)());
+        packages.push_back(std::move(package));
+    }
+
+    std::size_t num_chunks = 1;
+    if (std::all_of(items.begin(), items.end(), [](const QueryFormatItem & item) { return item.thread_safe; })) {
+        auto max_workers = std::max<std::size_t>(
+            pkgs.get_base()->get_config().get_output_format_threads_option().get_value(), 1);
+        num_chunks = std::clamp<std::size_t>(packages.size() / MIN_PACKAGES_PER_WORKER, 1, max_workers);
+    }
+
+    std::vector<FormattedChunk> chunks(num_chunks);
+    auto format_chunk = [&items, &packages, &chunks, num_chunks](std::size_t idx) {
+        auto begin = packages.size() * idx / num_chunks;
+        auto end = packages.size() * (idx + 1) / num_chunks;
+        format_packages(items, std::span(packages).subspan(begin, end - begin), chunks[idx]);
+    };
+    if (num_chunks == 1) {
+        format_chunk(0);
+    } else {
+        std::vector<std::exception_ptr> errors(num_chunks);
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(num_chunks - 1);
+            for (std::size_t idx = 1; idx < num_chunks; ++idx) {
+                workers.emplace_back([&format_chunk, &errors, idx]() {
+                    try {
+                        format_chunk(idx);
+                    } catch (...) {
+                        errors[idx] = std::current_exception();
                     }
-                },
-                getter);
+                });
+            }
+            // The calling thread formats the first chunk, the workers are joined when leaving the scope
+            try {
+                format_chunk(0);
+            } catch (...) {
+                errors[0] = std::current_exception();
+            }
+        }
+        for (const auto & error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
         }
-
-        output.insert(fmt::vformat(format, arg_store));
     }
 
-    for (const auto & line : output) {
-        fmt::print(target, "{}", line);
+    // Merge the sorted chunks, the lines formatted in more chunks are printed once
+    std::vector<std::size_t> positions(num_chunks, 0);
+    std::optional<std::string_view> last_line;
+    while (true) {
+        const std::string_view * next_line = nullptr;
+        std::size_t next_chunk = 0;
+        for (std::size_t idx = 0; idx < num_chunks; ++idx) {
+            if (positions[idx] < chunks[idx].lines.size() &&
+                (!next_line || chunks[idx].lines[positions[idx]] < *next_line)) {
+                next_line = &chunks[idx].lines[positions[idx]];
+                next_chunk = idx;
+            }
+        }
+        if (!next_line) {
+            break;
+        }
+        ++positions[next_chunk];
+        if (last_line != *next_line) {
+            std::fwrite(next_line->data(), 1, next_line->size(), target);
+            last_line = *next_line;
+        }
     }
 }
 
@@ -298,16 +443,21 @@ void print_pkg_attr_uniq_sorted(
                     for (const auto & reldep : (package.*getter_func)()) {
                         output.insert(std::move(reldep.to_string()));
                     }
+                } else if constexpr (std::is_same_v<T, ReldepSpanAttribute>) {
+                    libdnf5::rpm::ReldepSpan reldeps(package, getter_func);
+                    for (std::size_t idx = 0; idx < reldeps.size(); ++idx) {
+                        output.insert(reldeps.to_string(idx));
+                    }
                 } else if constexpr (std::is_same_v<T, UnsignedLongLongGetter>) {
                     output.insert(std::move(std::to_string((package.*getter_func)())));
                 } else if constexpr (std::is_same_v<T, TransactionItemReasonGetter>) {
                     output.insert(std::move(transaction_item_reason_to_string((package.*getter_func)())));
-                } else if constexpr (std::is_same_v<T, VecStrGetter>) {
-                    for (const auto & str : (package.*getter_func)()) {
-                        output.insert(std::move(str));
-                    }
+                } else if constexpr (std::is_same_v<T, StrCallbackGetter>) {
+                    (package.*getter_func)([&output](std::string_view str) { output.emplace(str); });
                 } else if constexpr (std::is_same_v<T, StrGetterLambda>) {
                     output.insert(std::move((getter_func)(package)));
+                } else if constexpr (std::is_same_v<T, StrViewGetter>) {
+                    output.emplace((package.*getter_func)());
                 } else {
                     output.insert(std::move((package.*getter_func)()));
                 }
@@ -22,6 +22,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "fmt/chrono.h"
 
+#include <algorithm>
+
 
 namespace libdnf5::cli::output {
 
@@ -48,4 +50,35 @@ void print_transaction_info(libdnf5::transaction::Transaction & transaction) {
     print_transaction_item_table(transaction.get_comps_environments(), "Environments altered:");
 }
 
+void print_transaction_timings(libdnf5::transaction::Transaction & transaction) {
+    auto timings = transaction.get_timings();
+    std::stable_sort(timings.begin(), timings.end(), [](const auto & lhs, const auto & rhs) {
+        return lhs.get_duration_us() > rhs.get_duration_us();
+    });
+
+    std::unique_ptr<libscols_table, decltype(&scols_unref_table)> table(scols_new_table(), &scols_unref_table);
+    if (libdnf5::cli::tty::is_interactive()) {
+        scols_table_enable_colors(table.get(), 1);
+    }
+    scols_cell_set_data(scols_table_get_title(table.get()), "Timings:");
+
+    // The two spaces indent the table the same way as child lines in KeyValueTable
+    scols_table_new_column(table.get(), "  Step", 0, 0);
+    scols_table_new_column(table.get(), "Package", 0, 0);
+    scols_table_new_column(table.get(), "Scriptlet", 0, 0);
+    scols_table_new_column(table.get(), "Duration", 0, SCOLS_FL_RIGHT);
+
+    for (const auto & timing : timings) {
+        struct libscols_line * ln = scols_table_new_line(table.get(), NULL);
+        scols_line_set_data(
+            ln, 0, ("  " + libdnf5::transaction::transaction_timing_step_to_string(timing.get_step())).c_str());
+        scols_line_set_data(ln, 1, timing.get_nevra().c_str());
+        scols_line_set_data(ln, 2, timing.get_scriptlet().c_str());
+        scols_line_set_data(
+            ln, 3, fmt::format("{:.3f} s", static_cast<double>(timing.get_duration_us()) / 1000000).c_str());
+    }
+
+    scols_print_table(table.get());
+}
+
 }  // namespace libdnf5::cli::output
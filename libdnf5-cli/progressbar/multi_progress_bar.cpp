@@ -25,12 +25,50 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <iomanip>
+#include <sstream>
+#include <string_view>
 
 
 namespace libdnf5::cli::progressbar {
 
 
+namespace {
+
+/// Appends the lines printed by the `bar` to `lines`
+void append_bar_lines(std::vector<std::string> & lines, ProgressBar & bar) {
+    std::ostringstream bar_stream;
+    bar_stream << bar;
+    std::string_view text = bar_stream.view();
+    std::size_t line_begin = 0;
+    for (auto line_end = text.find('\n'); line_end != std::string_view::npos; line_end = text.find('\n', line_begin)) {
+        lines.emplace_back(text.substr(line_begin, line_end - line_begin));
+        line_begin = line_end + 1;
+    }
+    lines.emplace_back(text.substr(line_begin));
+}
+
+/// Writes the `data` to the standard output after the data buffered in `std::cout` and `stdout`
+void write_to_stdout(std::string_view data) {
+    std::cout.flush();
+    std::fflush(stdout);
+    while (!data.empty()) {
+        auto written = ::write(STDOUT_FILENO, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+}  // namespace
+
+
 MultiProgressBar::MultiProgressBar() : total(0, "Total") {
     total.set_auto_finish(false);
     total.start();
@@ -95,22 +133,29 @@ std::size_t MultiProgressBar::get_total_num_of_bars() const noexcept {
 }
 
 
+void MultiProgressBar::print() {
+    auto now = std::chrono::steady_clock::now();
+    if (max_fps > 0 && now - prev_print_time < std::chrono::milliseconds(1000) / max_fps) {
+        // the finished bars are printed without delay, they can be the last update of the bars
+        if (std::none_of(bars_todo.begin(), bars_todo.end(), [](ProgressBar * bar) { return bar->is_finished(); })) {
+            return;
+        }
+    }
+    prev_print_time = now;
+
+    std::ostringstream frame;
+    frame << *this;
+    write_to_stdout(frame.view());
+}
+
+
 std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar) {
     const bool is_interactive{tty::is_interactive()};
 
-    if (is_interactive) {
-        if (mbar.num_of_lines_to_clear > 0) {
-            stream << tty::clear_line;
-            for (std::size_t i = 1; i < mbar.num_of_lines_to_clear; i++) {
-                stream << tty::cursor_up << tty::clear_line;
-            }
-            stream << "\r";
-        } else if (mbar.line_printed) {
-            stream << std::endl;
-        }
-    }
-    mbar.num_of_lines_to_clear = 0;
-    mbar.line_printed = false;
+    // lines of the finished bars, they are printed once and scroll out with the following frames
+    std::vector<std::string> finished_lines;
+    // lines redrawn by the following frames
+    std::vector<std::string> active_lines;
 
     // store numbers of bars in progress
     std::vector<int32_t> numbers;
@@ -126,11 +171,7 @@ std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar) {
         }
         bar->set_number(numbers.back());
         numbers.pop_back();
-        if (mbar.line_printed) {
-            stream << std::endl;
-        }
-        stream << *bar;
-        mbar.line_printed = true;
+        append_bar_lines(finished_lines, *bar);
         mbar.bars_done.push_back(bar);
         // TODO(dmach): use iterator
         mbar.bars_todo.erase(mbar.bars_todo.begin() + static_cast<int>(i));
@@ -152,13 +193,7 @@ std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar) {
             bar->update();
             continue;
         }
-        if (mbar.line_printed) {
-            stream << std::endl;
-        }
-        stream << *bar;
-        mbar.line_printed = true;
-        mbar.num_of_lines_to_clear++;
-        mbar.num_of_lines_to_clear += bar->get_messages().size();
+        append_bar_lines(active_lines, *bar);
     }
 
     // then print the "total" progress bar
@@ -182,13 +217,12 @@ std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar) {
 
 
     if ((mbar.bars_all.size() >= mbar.total_bar_visible_limit) && (is_interactive || mbar.bars_todo.empty())) {
-        if (mbar.line_printed) {
-            stream << std::endl;
-        }
+        // the non-interactive output is never redrawn
+        auto & total_lines = is_interactive ? active_lines : finished_lines;
+
         // print divider
         int terminal_width = tty::get_width();
-        stream << std::string(static_cast<std::size_t>(terminal_width), '-');
-        stream << std::endl;
+        total_lines.emplace_back(static_cast<std::size_t>(terminal_width), '-');
 
         // print Total progress bar
         mbar.total.set_number(static_cast<int>(mbar.bars_done.size()));
@@ -201,10 +235,56 @@ std::ostream & operator<<(std::ostream & stream, MultiProgressBar & mbar) {
             mbar.total.set_state(ProgressBarState::SUCCESS);
         }
 
-        stream << mbar.total;
-        mbar.num_of_lines_to_clear += 2;
+        append_bar_lines(total_lines, mbar.total);
+    }
+
+    // move the cursor to the beginning of the lines printed by the previous frame
+    const auto & prev_lines = mbar.active_lines;
+    if (!prev_lines.empty()) {
+        for (std::size_t i = 1; i < prev_lines.size(); i++) {
+            stream << tty::cursor_up;
+        }
+        stream << '\r';
+    } else if (mbar.line_printed) {
+        stream << '\n';
+    }
+
+    // rewrite only the lines that differ from the lines of the previous frame at the same position
+    std::size_t line_idx = 0;
+    auto print_line = [&](const std::string & line) {
+        if (line_idx > 0) {
+            stream << '\n';
+        }
+        if (line_idx >= prev_lines.size() || prev_lines[line_idx] != line) {
+            stream << tty::clear_line << line;
+        }
+        ++line_idx;
+    };
+    for (const auto & line : finished_lines) {
+        print_line(line);
+    }
+    for (const auto & line : active_lines) {
+        print_line(line);
+    }
+
+    // clear the remaining lines of the previous frame and return the cursor back
+    if (line_idx < prev_lines.size()) {
+        std::size_t lines_down = 0;
+        for (std::size_t i = line_idx; i < prev_lines.size(); i++) {
+            if (i > 0) {
+                stream << '\n';
+                ++lines_down;
+            }
+            stream << tty::clear_line;
+        }
+        for (; lines_down > 0; --lines_down) {
+            stream << tty::cursor_up;
+        }
     }
 
+    mbar.line_printed = line_idx > 0;
+    mbar.active_lines = std::move(active_lines);
+
     return stream;
 }
 
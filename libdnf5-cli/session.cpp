@@ -42,8 +42,12 @@ void Session::add_and_initialize_command(std::unique_ptr<Command> && command) {
     });
 
     command->set_parent_command();
-    command->set_argument_parser();
-    command->register_subcommands();
+
+    // postpone the setup of the arguments and subcommands until the command is used
+    arg_parser_command->set_setup_func([command = command.get()]() {
+        command->set_argument_parser();
+        command->register_subcommands();
+    });
     commands.push_back(std::move(command));
 }
 
@@ -60,10 +64,13 @@ void Session::set_root_command(Command & command) {
 
 
 void Session::clear() {
+    selected_command = nullptr;
     for (auto & cmd : commands) {
         cmd.reset();
     }
-    argument_parser.reset();
+    commands.clear();
+    // replace the argument parser by an empty one, new commands can be added to the session
+    argument_parser.reset(new libdnf5::cli::ArgumentParser);
 }
 
 
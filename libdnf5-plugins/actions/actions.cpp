@@ -23,9 +23,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/common/exception.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/utils/bgettext/bgettext-mark-domain.h>
+#include <poll.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <filesystem>
@@ -33,6 +35,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -41,19 +44,68 @@ using namespace libdnf5;
 namespace {
 
 constexpr const char * PLUGIN_NAME = "actions";
-constexpr plugin::Version PLUGIN_VERSION{0, 2, 0};
+constexpr plugin::Version PLUGIN_VERSION{0, 3, 0};
 
 constexpr const char * attrs[]{"author.name", "author.email", "description", nullptr};
 constexpr const char * attrs_value[]{"Jaroslav Rohel", "jrohel@redhat.com", "Actions Plugin."};
 
+// Package attributes available in the ${pkg.<attribute>} variables
+enum class PkgAttr {
+    NAME,
+    ARCH,
+    VERSION,
+    RELEASE,
+    EPOCH,
+    NA,
+    EVR,
+    NEVRA,
+    FULL_NEVRA,
+    REPO_ID,
+    LICENSE,
+    LOCATION,
+    VENDOR,
+    ACTION,
+    UNKNOWN
+};
+
+constexpr std::pair<std::string_view, PkgAttr> PKG_ATTRS[]{
+    {"name", PkgAttr::NAME},
+    {"arch", PkgAttr::ARCH},
+    {"version", PkgAttr::VERSION},
+    {"release", PkgAttr::RELEASE},
+    {"epoch", PkgAttr::EPOCH},
+    {"na", PkgAttr::NA},
+    {"evr", PkgAttr::EVR},
+    {"nevra", PkgAttr::NEVRA},
+    {"full_nevra", PkgAttr::FULL_NEVRA},
+    {"repo_id", PkgAttr::REPO_ID},
+    {"license", PkgAttr::LICENSE},
+    {"location", PkgAttr::LOCATION},
+    {"vendor", PkgAttr::VENDOR},
+    {"action", PkgAttr::ACTION}};
+
+// Part of a command argument, either a text or a variable. The arguments are split into parts when the action file
+// is parsed, the substitution for each package only joins the parts.
+struct ArgPart {
+    enum class Type { TEXT, INCOMPLETE_VAR, PID, CONF, VAR, TMP, PKG, UNKNOWN_VAR } type{Type::TEXT};
+    // the text, or the variable name without the "conf.", "var." and "tmp." prefix
+    std::string value;
+    // the full variable name for error messages
+    std::string var_name;
+    PkgAttr pkg_attr{PkgAttr::UNKNOWN};
+};
+
 // Represents one line in action file
 struct Action {
     std::filesystem::path file_path;
     int line_number;
     std::string pkg_filter;
     enum class Direction { IN, OUT, ALL } direction;
+    // maximum number of the commands of the action executed at once, 1 means sequential execution
+    std::size_t max_parallel{1};
     std::string command;
     std::vector<std::string> args;
+    std::vector<std::vector<ArgPart>> args_parts;
 };
 
 
@@ -65,6 +117,14 @@ struct CommandToRun {
 };
 
 
+// Represents a started command whose output is being read
+struct RunningCommand {
+    pid_t pid{-1};
+    int output_fd{-1};
+    std::string output;
+};
+
+
 class Actions : public plugin::IPlugin {
 public:
     Actions(libdnf5::Base & base, libdnf5::ConfigParser &) : IPlugin(base) {}
@@ -106,18 +166,21 @@ private:
     void on_base_setup(const std::vector<Action> & trans_actions);
     void on_transaction(const libdnf5::base::Transaction & transaction, const std::vector<Action> & trans_actions);
     void execute_command(CommandToRun & command);
+    void execute_commands_concurrently(std::vector<CommandToRun> & commands, std::size_t max_parallel);
+    RunningCommand start_command(CommandToRun & command);
 
     [[nodiscard]] std::pair<std::string, bool> substitute(
         const libdnf5::base::TransactionPackage * trans_pkg,
         const libdnf5::rpm::Package * pkg,
-        std::string_view in,
-        std::filesystem::path file,
+        const std::vector<ArgPart> & parts,
+        const std::filesystem::path & file,
         int line_number);
 
     [[nodiscard]] std::pair<std::vector<std::string>, bool> substitute_args(
         const libdnf5::base::TransactionPackage * trans_pkg, const libdnf5::rpm::Package * pkg, const Action & action);
 
     void process_command_output_line(std::string_view line);
+    void process_command_output(std::string_view output);
 
     // Parsed actions for individual hooks
     std::vector<Action> pre_base_setup_actions;
@@ -182,115 +245,176 @@ std::vector<std::string> split(const std::string & str) {
     return ret;
 }
 
-std::pair<std::string, bool> Actions::substitute(
-    const libdnf5::base::TransactionPackage * trans_pkg,
-    const libdnf5::rpm::Package * pkg,
-    std::string_view in,
-    std::filesystem::path file,
-    int line_number) {
-    auto & base = get_base();
-    auto & logger = *base.get_logger();
-    std::string ret;
-    bool error = false;
+ArgPart compile_var(std::string_view var_name) {
+    ArgPart part;
+    part.type = ArgPart::Type::UNKNOWN_VAR;
+    part.var_name = var_name;
+    if (var_name == "pid") {
+        part.type = ArgPart::Type::PID;
+    } else if (var_name.starts_with("conf.")) {
+        part.type = ArgPart::Type::CONF;
+        part.value = var_name.substr(5);
+    } else if (var_name.starts_with("var.")) {
+        part.type = ArgPart::Type::VAR;
+        part.value = var_name.substr(4);
+    } else if (var_name.starts_with("tmp.")) {
+        part.type = ArgPart::Type::TMP;
+        part.value = var_name.substr(4);
+    } else if (var_name.starts_with("pkg.")) {
+        part.type = ArgPart::Type::PKG;
+        auto pkg_key = var_name.substr(4);
+        for (const auto & [name, attr] : PKG_ATTRS) {
+            if (pkg_key == name) {
+                part.pkg_attr = attr;
+                break;
+            }
+        }
+    }
+    return part;
+}
+
+// splits the command argument into texts and variables
+std::vector<ArgPart> compile_arg(std::string_view in) {
+    std::vector<ArgPart> parts;
     size_t pos = 0;
     do {
         auto var_pos = in.find("${", pos);
-        ret += in.substr(pos, var_pos - pos);
+        if (var_pos != pos) {
+            auto & text = parts.emplace_back();
+            text.value = in.substr(pos, var_pos - pos);
+        }
         if (var_pos == std::string::npos) {
             break;
         }
-        var_pos += 2;
-        auto var_end_pos = in.find('}', var_pos);
+        auto var_end_pos = in.find('}', var_pos + 2);
         if (var_end_pos == std::string::npos) {
-            logger.error(
-                "Actions plugin: Syntax error: Incomplete variable name \"{}\" in file \"{}\" on line {}",
-                std::string(in.substr(var_pos - 2)),
-                file.native(),
-                line_number);
-            error = true;
+            auto & incomplete_var = parts.emplace_back();
+            incomplete_var.type = ArgPart::Type::INCOMPLETE_VAR;
+            incomplete_var.value = in.substr(var_pos);
             break;
         }
+        parts.push_back(compile_var(in.substr(var_pos + 2, var_end_pos - var_pos - 2)));
+        pos = var_end_pos + 1;
+    } while (pos < in.size());
+    return parts;
+}
+
+std::optional<std::string> get_pkg_attr(
+    const libdnf5::base::TransactionPackage * trans_pkg, const libdnf5::rpm::Package * pkg, PkgAttr attr) {
+    if (attr == PkgAttr::ACTION) {
+        if (trans_pkg) {
+            return libdnf5::transaction::transaction_item_action_to_letter(trans_pkg->get_action());
+        }
+        return std::nullopt;
+    }
+    if (!pkg) {
+        return std::nullopt;
+    }
+    switch (attr) {
+        case PkgAttr::NAME:
+            return pkg->get_name();
+        case PkgAttr::ARCH:
+            return pkg->get_arch();
+        case PkgAttr::VERSION:
+            return pkg->get_version();
+        case PkgAttr::RELEASE:
+            return pkg->get_release();
+        case PkgAttr::EPOCH:
+            return pkg->get_epoch();
+        case PkgAttr::NA:
+            return pkg->get_na();
+        case PkgAttr::EVR:
+            return pkg->get_evr();
+        case PkgAttr::NEVRA:
+            return pkg->get_nevra();
+        case PkgAttr::FULL_NEVRA:
+            return pkg->get_full_nevra();
+        case PkgAttr::REPO_ID:
+            return pkg->get_repo_id();
+        case PkgAttr::LICENSE:
+            return pkg->get_license();
+        case PkgAttr::LOCATION:
+            return pkg->get_location();
+        case PkgAttr::VENDOR:
+            return pkg->get_vendor();
+        case PkgAttr::ACTION:
+        case PkgAttr::UNKNOWN:
+            break;
+    }
+    return std::nullopt;
+}
 
-        const auto var_name = in.substr(var_pos, var_end_pos - var_pos);
+std::pair<std::string, bool> Actions::substitute(
+    const libdnf5::base::TransactionPackage * trans_pkg,
+    const libdnf5::rpm::Package * pkg,
+    const std::vector<ArgPart> & parts,
+    const std::filesystem::path & file,
+    int line_number) {
+    auto & base = get_base();
+    auto & logger = *base.get_logger();
+    std::string ret;
+    for (const auto & part : parts) {
         std::optional<std::string> var_value;
-        if (var_name == "pid") {
-            var_value = std::to_string(getpid());
-        } else if (var_name.starts_with("conf.")) {
-            auto config_opts = base.get_config().opt_binds();
-            auto it = config_opts.find(std::string(var_name.substr(5)));
-            if (it != config_opts.end()) {
-                var_value = it->second.get_value_string();
-            }
-        } else if (var_name.starts_with("var.")) {
-            auto vars = base.get_vars();
-            try {
-                var_value = vars->get_value(std::string(var_name.substr(4)));
-            } catch (std::out_of_range &) {
-            }
-        } else if (var_name.starts_with("tmp.")) {
-            if (auto it = tmp_variables.find(std::string(var_name.substr(4))); it != tmp_variables.end()) {
-                var_value = it->second;
-            }
-        } else if (var_name.starts_with("pkg.")) {
-            auto pkg_key = var_name.substr(4);
-            if (pkg) {
-                if (pkg_key == "name") {
-                    var_value = pkg->get_name();
-                } else if (pkg_key == "arch") {
-                    var_value = pkg->get_arch();
-                } else if (pkg_key == "version") {
-                    var_value = pkg->get_version();
-                } else if (pkg_key == "release") {
-                    var_value = pkg->get_release();
-                } else if (pkg_key == "epoch") {
-                    var_value = pkg->get_epoch();
-                } else if (pkg_key == "na") {
-                    var_value = pkg->get_na();
-                } else if (pkg_key == "evr") {
-                    var_value = pkg->get_evr();
-                } else if (pkg_key == "nevra") {
-                    var_value = pkg->get_nevra();
-                } else if (pkg_key == "full_nevra") {
-                    var_value = pkg->get_full_nevra();
-                } else if (pkg_key == "repo_id") {
-                    var_value = pkg->get_repo_id();
-                } else if (pkg_key == "license") {
-                    var_value = pkg->get_license();
-                } else if (pkg_key == "location") {
-                    var_value = pkg->get_location();
-                } else if (pkg_key == "vendor") {
-                    var_value = pkg->get_vendor();
+        switch (part.type) {
+            case ArgPart::Type::TEXT:
+                ret += part.value;
+                continue;
+            case ArgPart::Type::INCOMPLETE_VAR:
+                logger.error(
+                    "Actions plugin: Syntax error: Incomplete variable name \"{}\" in file \"{}\" on line {}",
+                    part.value,
+                    file.native(),
+                    line_number);
+                return {ret, true};
+            case ArgPart::Type::PID:
+                var_value = std::to_string(getpid());
+                break;
+            case ArgPart::Type::CONF: {
+                auto config_opts = base.get_config().opt_binds();
+                auto it = config_opts.find(part.value);
+                if (it != config_opts.end()) {
+                    var_value = it->second.get_value_string();
                 }
+                break;
             }
-            if (trans_pkg) {
-                if (pkg_key == "action") {
-                    var_value = libdnf5::transaction::transaction_item_action_to_letter(trans_pkg->get_action());
+            case ArgPart::Type::VAR: {
+                auto vars = base.get_vars();
+                try {
+                    var_value = vars->get_value(part.value);
+                } catch (std::out_of_range &) {
                 }
+                break;
             }
+            case ArgPart::Type::TMP:
+                if (auto it = tmp_variables.find(part.value); it != tmp_variables.end()) {
+                    var_value = it->second;
+                }
+                break;
+            case ArgPart::Type::PKG:
+                var_value = get_pkg_attr(trans_pkg, pkg, part.pkg_attr);
+                break;
+            case ArgPart::Type::UNKNOWN_VAR:
+                break;
         }
-        if (var_value) {
-            ret += *var_value;
-        } else {
+        if (!var_value) {
             logger.error(
                 "Actions plugin: Unknown variable \"{}\" in file \"{}\" on line {}",
-                std::string(var_name),
+                part.var_name,
                 file.native(),
                 line_number);
-            error = true;
-            break;
+            return {ret, true};
         }
-
-        pos = var_end_pos + 1;
-    } while (pos < in.size());
-    return {ret, error};
+        ret += *var_value;
+    }
+    return {ret, false};
 }
 
 std::pair<std::vector<std::string>, bool> Actions::substitute_args(
     const libdnf5::base::TransactionPackage * trans_pkg, const libdnf5::rpm::Package * pkg, const Action & action) {
     std::vector<std::string> substituted_args;
     substituted_args.reserve(action.args.size());
-    for (const auto & arg : action.args) {
-        auto [value, subst_error] = substitute(trans_pkg, pkg, arg, action.file_path, action.line_number);
+    for (const auto & arg_parts : action.args_parts) {
+        auto [value, subst_error] = substitute(trans_pkg, pkg, arg_parts, action.file_path, action.line_number);
         if (subst_error) {
             return {substituted_args, true};
         }
@@ -473,12 +597,44 @@ void Actions::parse_action_files() {
                     direction);
             }
 
+            auto options = line.substr(reserved_pos, command_pos - reserved_pos - 1);
+            if (options == "parallel") {
+                act.max_parallel = std::max(std::thread::hardware_concurrency(), 1U);
+            } else if (options.starts_with("parallel=")) {
+                try {
+                    auto max_parallel = std::stoul(options.substr(9));
+                    if (max_parallel == 0) {
+                        throw std::invalid_argument("zero");
+                    }
+                    act.max_parallel = max_parallel;
+                } catch (const std::logic_error &) {
+                    throw ActionsPluginError(
+                        M_("Error in file \"{}\" on line {}: Invalid number of parallel commands \"{}\""),
+                        path.native(),
+                        line_number,
+                        options.substr(9));
+                }
+            } else if (!options.empty()) {
+                throw ActionsPluginError(
+                    M_("Error in file \"{}\" on line {}: Unknown option \"{}\""), path.native(), line_number, options);
+            }
+            if (act.max_parallel > 1 && pkg_filter.empty()) {
+                throw ActionsPluginError(
+                    M_("Error in file \"{}\" on line {}: Option \"parallel\" can only be used with package filter"),
+                    path.native(),
+                    line_number);
+            }
+
             act.args = split(line.substr(command_pos));
             if (act.args.empty()) {
                 throw ActionsPluginError(
                     M_("Error in file \"{}\" on line {}: Missing command"), path.native(), line_number);
             }
             act.command = act.args[0];
+            act.args_parts.reserve(act.args.size());
+            for (const auto & arg : act.args) {
+                act.args_parts.push_back(compile_arg(arg));
+            }
 
             switch (hook) {
                 case Hooks::PRE_BASE_SETUP:
@@ -545,21 +701,35 @@ void Actions::process_command_output_line(std::string_view line) {
     }
 }
 
-void Actions::execute_command(CommandToRun & command) {
+void Actions::process_command_output(std::string_view output) {
+    std::size_t line_begin_pos = 0;
+    while (line_begin_pos < output.size()) {
+        auto line_end_pos = output.find('\n', line_begin_pos);
+        if (line_end_pos == std::string_view::npos) {
+            process_command_output_line(output.substr(line_begin_pos));
+            break;
+        }
+        process_command_output_line(output.substr(line_begin_pos, line_end_pos - line_begin_pos));
+        line_begin_pos = line_end_pos + 1;
+    }
+}
+
+RunningCommand Actions::start_command(CommandToRun & command) {
     auto & base = get_base();
+    RunningCommand running;
 
     int pipe_out_from_child[2];
     int pipe_to_child[2];
     if (pipe(pipe_to_child) == -1) {
         base.get_logger()->error("Actions plugin: Cannot create pipe: {}", std::strerror(errno));
-        return;
+        return running;
     }
     if (pipe(pipe_out_from_child) == -1) {
         auto errnum = errno;
         close(pipe_to_child[1]);
         close(pipe_to_child[0]);
         base.get_logger()->error("Actions plugin: Cannot create pipe: {}", std::strerror(errnum));
-        return;
+        return running;
     }
 
     auto child_pid = fork();
@@ -610,39 +780,119 @@ void Actions::execute_command(CommandToRun & command) {
         close(pipe_to_child[1]);
 
         close(pipe_out_from_child[1]);
-        char read_buf[256];
-        std::string input;
-        std::size_t num_tested_chars = 0;
-        do {
-            auto len = read(pipe_out_from_child[0], read_buf, sizeof(read_buf));
-            if (len > 0) {
-                std::size_t line_begin_pos = 0;
-                input.append(read_buf, static_cast<std::size_t>(len));
-                std::string_view input_view(input);
-                do {
-                    auto line_end_pos = input_view.find('\n', num_tested_chars);
-                    if (line_end_pos == std::string::npos) {
-                        num_tested_chars = input_view.size();
-                    } else {
-                        process_command_output_line(input_view.substr(line_begin_pos, line_end_pos - line_begin_pos));
-                        num_tested_chars = line_begin_pos = line_end_pos + 1;
-                    }
-                } while (num_tested_chars < input_view.size());
+        running.pid = child_pid;
+        running.output_fd = pipe_out_from_child[0];
+    }
+    return running;
+}
 
-                // shift - erase processed lines from the input buffer
-                input.erase(0, line_begin_pos);
-                num_tested_chars -= line_begin_pos;
-                line_begin_pos = 0;
-            } else {
-                if (!input.empty()) {
-                    process_command_output_line(input);
+void Actions::execute_command(CommandToRun & command) {
+    auto running = start_command(command);
+    if (running.pid == -1) {
+        return;
+    }
+
+    char read_buf[256];
+    std::string input;
+    std::size_t num_tested_chars = 0;
+    do {
+        auto len = read(running.output_fd, read_buf, sizeof(read_buf));
+        if (len > 0) {
+            std::size_t line_begin_pos = 0;
+            input.append(read_buf, static_cast<std::size_t>(len));
+            std::string_view input_view(input);
+            do {
+                auto line_end_pos = input_view.find('\n', num_tested_chars);
+                if (line_end_pos == std::string::npos) {
+                    num_tested_chars = input_view.size();
+                } else {
+                    process_command_output_line(input_view.substr(line_begin_pos, line_end_pos - line_begin_pos));
+                    num_tested_chars = line_begin_pos = line_end_pos + 1;
                 }
-                break;
+            } while (num_tested_chars < input_view.size());
+
+            // shift - erase processed lines from the input buffer
+            input.erase(0, line_begin_pos);
+            num_tested_chars -= line_begin_pos;
+            line_begin_pos = 0;
+        } else {
+            if (!input.empty()) {
+                process_command_output_line(input);
             }
-        } while (true);
-        close(pipe_out_from_child[0]);
+            break;
+        }
+    } while (true);
+    close(running.output_fd);
+
+    waitpid(running.pid, nullptr, 0);
+}
 
-        waitpid(child_pid, nullptr, 0);
+// Executes up to `max_parallel` commands at once. The outputs of the commands are collected and processed
+// in the order of `commands` after all the commands have finished.
+void Actions::execute_commands_concurrently(std::vector<CommandToRun> & commands, std::size_t max_parallel) {
+    auto & base = get_base();
+    std::vector<RunningCommand> running(commands.size());
+    std::size_t next_idx = 0;
+    std::size_t num_running = 0;
+    std::vector<pollfd> poll_fds;
+    std::vector<std::size_t> poll_idxs;
+
+    auto finish = [&num_running](RunningCommand & cmd) {
+        close(cmd.output_fd);
+        cmd.output_fd = -1;
+        waitpid(cmd.pid, nullptr, 0);
+        --num_running;
+    };
+
+    while (next_idx < commands.size() || num_running > 0) {
+        while (next_idx < commands.size() && num_running < max_parallel) {
+            running[next_idx] = start_command(commands[next_idx]);
+            if (running[next_idx].pid != -1) {
+                ++num_running;
+            }
+            ++next_idx;
+        }
+        if (num_running == 0) {
+            continue;
+        }
+
+        poll_fds.clear();
+        poll_idxs.clear();
+        for (std::size_t idx = 0; idx < next_idx; ++idx) {
+            if (running[idx].output_fd != -1) {
+                poll_fds.push_back({.fd = running[idx].output_fd, .events = POLLIN, .revents = 0});
+                poll_idxs.push_back(idx);
+            }
+        }
+        if (poll(poll_fds.data(), poll_fds.size(), -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            base.get_logger()->error("Actions plugin: Cannot wait for command output: {}", std::strerror(errno));
+            // Wait for the started commands, the commands not started yet are dropped
+            for (auto idx : poll_idxs) {
+                finish(running[idx]);
+            }
+            break;
+        }
+
+        char read_buf[4096];
+        for (std::size_t i = 0; i < poll_fds.size(); ++i) {
+            if (poll_fds[i].revents == 0) {
+                continue;
+            }
+            auto & cmd = running[poll_idxs[i]];
+            auto len = read(cmd.output_fd, read_buf, sizeof(read_buf));
+            if (len > 0) {
+                cmd.output.append(read_buf, static_cast<std::size_t>(len));
+            } else if (len == 0 || errno != EINTR) {
+                finish(cmd);
+            }
+        }
+    }
+
+    for (const auto & cmd : running) {
+        process_command_output(cmd.output);
     }
 }
 
@@ -720,8 +970,12 @@ void Actions::on_transaction(
             }
 
             // execute commands
-            for (auto & cmd : commands_to_run) {
-                execute_command(cmd);
+            if (action.max_parallel > 1) {
+                execute_commands_concurrently(commands_to_run, action.max_parallel);
+            } else {
+                for (auto & cmd : commands_to_run) {
+                    execute_command(cmd);
+                }
             }
         }
     }
@@ -20,11 +20,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <Python.h>
 #include <fmt/format.h>
 #include <libdnf5/base/base.hpp>
+#include <libdnf5/conf/config_parser.hpp>
+#include <libdnf5/conf/option_string_list.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <mutex>
+#include <string>
+#include <vector>
 
 using namespace libdnf5;
 
@@ -33,7 +38,7 @@ namespace fs = std::filesystem;
 namespace {
 
 constexpr const char * PLUGIN_NAME = "python_plugin_loader";
-constexpr plugin::Version PLUGIN_VERSION{0, 1, 0};
+constexpr plugin::Version PLUGIN_VERSION{0, 2, 0};
 
 constexpr const char * attrs[]{"author.name", "author.email", "description", nullptr};
 constexpr const char * attrs_value[]{"Jaroslav Rohel", "jrohel@redhat.com", "Plugin for loading Python plugins."};
@@ -62,12 +67,34 @@ public:
 
     void load_plugins() override;
 
+    void pre_base_setup() override { load_deferred_plugins("pre_base_setup"); }
+
+    void post_base_setup() override { load_deferred_plugins("post_base_setup"); }
+
+    void pre_transaction(const libdnf5::base::Transaction &) override { load_deferred_plugins("pre_transaction"); }
+
+    void post_transaction(const libdnf5::base::Transaction &) override { load_deferred_plugins("post_transaction"); }
+
 private:
+    /// Python plugin with a manifest, it is imported when one of its `hooks` is called
+    struct DeferredPlugin {
+        fs::path file_path;
+        std::vector<std::string> hooks;
+    };
+
     void load_plugin_file(const fs::path & file);
+    void load_plugin_files(const std::vector<fs::path> & file_paths);
     void load_plugins_from_dir(const fs::path & dir_path);
+    void load_deferred_plugins(const std::string & hook);
+
+    /// Initializes the Python interpreter (shared by all the loaders) and adds `plugins_dir` to the module search path.
+    /// @return `false` if the interpreter cannot be initialized.
+    bool init_python();
 
     static int python_ref_counter;
     bool active{false};
+    fs::path plugins_dir;
+    std::vector<DeferredPlugin> deferred_plugins;
 };
 
 int PythonPluginLoader::python_ref_counter{0};
@@ -236,6 +263,26 @@ void PythonPluginLoader::load_plugin_file(const fs::path & file_path) {
 }
 
 
+void PythonPluginLoader::load_plugin_files(const std::vector<fs::path> & file_paths) {
+    auto & logger = *get_base().get_logger();
+
+    std::string error_msgs;
+    for (auto & p : file_paths) {
+        try {
+            load_plugin_file(p);
+        } catch (const std::exception & ex) {
+            std::string msg = fmt::format("Cannot load plugin \"{}\": {}", p.string(), ex.what());
+            logger.error(msg);
+            error_msgs += msg + '\n';
+        }
+    }
+
+    if (!error_msgs.empty()) {
+        throw std::runtime_error(error_msgs);
+    }
+}
+
+
 void PythonPluginLoader::load_plugins_from_dir(const fs::path & dir_path) {
     auto & logger = *get_base().get_logger();
 
@@ -255,35 +302,43 @@ void PythonPluginLoader::load_plugins_from_dir(const fs::path & dir_path) {
     }
     std::sort(lib_names.begin(), lib_names.end());
 
-    std::string error_msgs;
+    // A plugin with a manifest "<module name>.manifest" listing its hooks is imported when one of the hooks is called
+    std::vector<fs::path> eager_lib_names;
     for (auto & p : lib_names) {
-        try {
-            load_plugin_file(p);
-        } catch (const std::exception & ex) {
-            std::string msg = fmt::format("Cannot load plugin \"{}\": {}", p.string(), ex.what());
-            logger.error(msg);
-            error_msgs += msg + '\n';
+        auto manifest_path = fs::path(p).replace_extension(".manifest");
+        if (!fs::exists(manifest_path, ec)) {
+            eager_lib_names.emplace_back(p);
+            continue;
         }
+        libdnf5::ConfigParser parser;
+        parser.read(manifest_path);
+        DeferredPlugin deferred_plugin{p, {}};
+        if (parser.has_option("main", "hooks")) {
+            deferred_plugin.hooks =
+                libdnf5::OptionStringList(std::vector<std::string>{}).from_string(parser.get_value("main", "hooks"));
+        }
+        logger.debug("PythonPluginLoader: Deferred loading of plugin \"{}\"", p.string());
+        deferred_plugins.push_back(std::move(deferred_plugin));
     }
 
-    if (!error_msgs.empty()) {
-        throw std::runtime_error(error_msgs);
+    if (!eager_lib_names.empty()) {
+        if (!init_python()) {
+            return;
+        }
+        load_plugin_files(eager_lib_names);
     }
 }
 
-void PythonPluginLoader::load_plugins() {
-    const char * plugin_dir = std::getenv("LIBDNF_PYTHON_PLUGIN_DIR");
-    if (!plugin_dir) {
-        return;
-    }
-    const fs::path path(plugin_dir);
 
-    std::lock_guard<libdnf5::Base> guard(get_base());
+bool PythonPluginLoader::init_python() {
+    if (active) {
+        return true;
+    }
 
     if (python_ref_counter == 0) {
         Py_InitializeEx(0);
         if (!Py_IsInitialized()) {
-            return;
+            return false;
         }
     }
     active = true;
@@ -304,13 +359,47 @@ void PythonPluginLoader::load_plugins() {
     if (!path_object) {
         fetch_python_error_to_exception("PyDict_GetItemString(sys_dict, \"path\"): ");
     }
-    UniquePtrPyObject append(PyObject_CallMethod(path_object, "append", "(s)", path.c_str()));
+    UniquePtrPyObject append(PyObject_CallMethod(path_object, "append", "(s)", plugins_dir.c_str()));
     if (!append) {
         fetch_python_error_to_exception(
-            ("PyDict_CallMethod(path_object, \"append\", \"(s)\", " + path.string() + "): ").c_str());
+            ("PyDict_CallMethod(path_object, \"append\", \"(s)\", " + plugins_dir.string() + "): ").c_str());
+    }
+    return true;
+}
+
+
+void PythonPluginLoader::load_deferred_plugins(const std::string & hook) {
+    std::vector<fs::path> file_paths;
+    for (auto it = deferred_plugins.begin(); it != deferred_plugins.end();) {
+        if (std::find(it->hooks.begin(), it->hooks.end(), hook) == it->hooks.end()) {
+            ++it;
+            continue;
+        }
+        file_paths.push_back(std::move(it->file_path));
+        it = deferred_plugins.erase(it);
     }
+    if (file_paths.empty()) {
+        return;
+    }
+
+    std::lock_guard<libdnf5::Base> guard(get_base());
+    if (!init_python()) {
+        return;
+    }
+    load_plugin_files(file_paths);
+}
+
+
+void PythonPluginLoader::load_plugins() {
+    const char * plugin_dir = std::getenv("LIBDNF_PYTHON_PLUGIN_DIR");
+    if (!plugin_dir) {
+        return;
+    }
+    plugins_dir = plugin_dir;
+
+    std::lock_guard<libdnf5::Base> guard(get_base());
 
-    load_plugins_from_dir(path);
+    load_plugins_from_dir(plugins_dir);
 }
 
 
@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/advisory/advisory.hpp"
 
+#include "base/base_impl.hpp"
 #include "solv/pool.hpp"
 #include "utils/string.hpp"
 
@@ -33,7 +34,18 @@ namespace libdnf5::advisory {
 
 Advisory::Advisory(const libdnf5::BaseWeakPtr & base, AdvisoryId id) : base(base), id(id) {}
 
+/// Returns the cached fields of all advisories and the position of the fields of the `advisory` in them
+static std::pair<const AdvisoryFields &, std::size_t> get_cached_fields(
+    const libdnf5::BaseWeakPtr & base, AdvisoryId advisory) {
+    const auto & fields = InternalBaseUser::get_rpm_advisory_sack(base)->get_fields();
+    return {fields, fields.find(advisory.id)};
+}
+
 std::string Advisory::get_name() const {
+    if (auto [fields, pos] = get_cached_fields(base, id); pos != AdvisoryFields::npos) {
+        return fields.names[pos];
+    }
+
     const char * name;
     name = get_rpm_pool(base).lookup_str(id.id, SOLVABLE_NAME);
 
@@ -51,10 +63,16 @@ std::string Advisory::get_name() const {
 }
 
 std::string Advisory::get_type() const {
+    if (auto [fields, pos] = get_cached_fields(base, id); pos != AdvisoryFields::npos) {
+        return fields.types[pos];
+    }
     return std::string(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_PATCHCATEGORY));
 }
 
 std::string Advisory::get_severity() const {
+    if (auto [fields, pos] = get_cached_fields(base, id); pos != AdvisoryFields::npos) {
+        return fields.severities[pos];
+    }
     //TODO(amatej): should we call SolvPrivate::internalize_libsolv_repo(solvable->repo);
     //              before pool.lookup_str?
     //              If so do this just once in solv::advisroy_private
@@ -62,10 +80,16 @@ std::string Advisory::get_severity() const {
 }
 
 unsigned long long Advisory::get_buildtime() const {
+    if (auto [fields, pos] = get_cached_fields(base, id); pos != AdvisoryFields::npos) {
+        return fields.buildtimes[pos];
+    }
     return get_rpm_pool(base).lookup_num(id.id, SOLVABLE_BUILDTIME);
 }
 
 std::string Advisory::get_title() const {
+    if (auto [fields, pos] = get_cached_fields(base, id); pos != AdvisoryFields::npos) {
+        return fields.titles[pos];
+    }
     // SOLVABLE_SUMMARY is misnamed, it actually stores the title
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_SUMMARY));
 }
@@ -131,15 +155,8 @@ std::vector<AdvisoryCollection> Advisory::get_collections() const {
     return output;
 }
 
-//TODO(amatej): this could be possibly removed?
 bool Advisory::is_applicable() const {
-    for (const auto & collection : get_collections()) {
-        if (collection.is_applicable()) {
-            return true;
-        }
-    }
-
-    return false;
+    return InternalBaseUser::get_rpm_advisory_sack(base)->get_applicable_advisories().contains(id.id);
 }
 
 Advisory::~Advisory() = default;
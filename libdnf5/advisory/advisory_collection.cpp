@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "advisory/advisory_module_private.hpp"
 #include "advisory/advisory_package_private.hpp"
+#include "base/base_impl.hpp"
 
 
 namespace libdnf5::advisory {
@@ -32,8 +33,7 @@ AdvisoryCollection::AdvisoryCollection(const libdnf5::BaseWeakPtr & base, Adviso
       index(index) {}
 
 bool AdvisoryCollection::is_applicable() const {
-    //TODO(amatej): check if collection is applicable
-    return true;
+    return InternalBaseUser::get_rpm_advisory_sack(base)->is_collection_applicable(advisory, index);
 }
 
 std::vector<AdvisoryPackage> AdvisoryCollection::get_packages() {
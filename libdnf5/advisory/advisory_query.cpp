@@ -103,12 +103,61 @@ static void filter_dataiterator_internal(
     }
 }
 
+/// Returns whether all `patterns` are compared as exact strings, they can be then looked up in the indexes
+/// of AdvisorySack. `cmp_type` must not contain NOT.
+static bool is_exact_lookup(libdnf5::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    for (const auto & pattern : patterns) {
+        if (libsolv_cmp_flags(cmp_type, pattern.c_str()) != SEARCH_STRING) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Returns whether the reference `entry` matches the requested `type`, a reference without a type matches any type
+static bool reference_type_matches(const AdvisoryReferenceEntry & entry, const std::optional<std::string> & type) {
+    return !type || !entry.has_type || entry.type == *type;
+}
+
+static void filter_name_internal(
+    const libdnf5::BaseWeakPtr & base,
+    libdnf5::solv::SolvMap & candidates,
+    libdnf5::sack::QueryCmp cmp_type,
+    const std::vector<std::string> & prefixed_patterns) {
+    auto & pool = get_rpm_pool(base);
+
+    bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
+    auto cmp_type_without_not = cmp_not ? cmp_type - libdnf5::sack::QueryCmp::NOT : cmp_type;
+    if (!is_exact_lookup(cmp_type_without_not, prefixed_patterns)) {
+        filter_dataiterator_internal(*pool, SOLVABLE_NAME, candidates, cmp_type, prefixed_patterns);
+        return;
+    }
+
+    libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
+    const auto & name_index = InternalBaseUser::get_rpm_advisory_sack(base)->get_name_index();
+    for (const auto & pattern : prefixed_patterns) {
+        if (auto it = name_index.find(pattern); it != name_index.end()) {
+            for (Id advisory_id : it->second) {
+                filter_result.add_unsafe(advisory_id);
+            }
+        }
+    }
+
+    // Apply filter results to query
+    if (cmp_not) {
+        candidates -= filter_result;
+    } else {
+        candidates &= filter_result;
+    }
+}
+
 static void filter_reference_by_type_and_id(
-    libdnf5::solv::RpmPool & pool,
+    const libdnf5::BaseWeakPtr & base,
     libdnf5::solv::SolvMap & candidates,
     libdnf5::sack::QueryCmp cmp_type,
     const std::vector<std::string> & patterns,
     const std::optional<std::string> type) {
+    auto & pool = get_rpm_pool(base);
     libdnf5::solv::SolvMap filter_result((*pool)->nsolvables);
 
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
@@ -117,28 +166,41 @@ static void filter_reference_by_type_and_id(
         cmp_type = cmp_type - libdnf5::sack::QueryCmp::NOT;
     }
 
-    for (auto & pattern : patterns) {
-        int flags = libsolv_cmp_flags(cmp_type, pattern.c_str());
-
-        Dataiterator di;
-
-        for (Id candidate_id : candidates) {
-            dataiterator_init(&di, *pool, nullptr, candidate_id, UPDATE_REFERENCE_ID, pattern.c_str(), flags);
-            dataiterator_prepend_keyname(&di, UPDATE_REFERENCE);
-            while (dataiterator_step(&di) != 0) {
-                dataiterator_setpos_parent(&di);
-                const char * current_type = pool.lookup_str(SOLVID_POS, UPDATE_REFERENCE_TYPE);
-                if (type && current_type) {
-                    if (!strcmp(type->c_str(), current_type)) {
+    if (is_exact_lookup(cmp_type, patterns)) {
+        const auto & reference_index = InternalBaseUser::get_rpm_advisory_sack(base)->get_reference_index();
+        for (const auto & pattern : patterns) {
+            if (auto it = reference_index.find(pattern); it != reference_index.end()) {
+                for (const auto & entry : it->second) {
+                    if (reference_type_matches(entry, type)) {
+                        filter_result.add_unsafe(entry.advisory);
+                    }
+                }
+            }
+        }
+    } else {
+        for (auto & pattern : patterns) {
+            int flags = libsolv_cmp_flags(cmp_type, pattern.c_str());
+
+            Dataiterator di;
+
+            for (Id candidate_id : candidates) {
+                dataiterator_init(&di, *pool, nullptr, candidate_id, UPDATE_REFERENCE_ID, pattern.c_str(), flags);
+                dataiterator_prepend_keyname(&di, UPDATE_REFERENCE);
+                while (dataiterator_step(&di) != 0) {
+                    dataiterator_setpos_parent(&di);
+                    const char * current_type = pool.lookup_str(SOLVID_POS, UPDATE_REFERENCE_TYPE);
+                    if (type && current_type) {
+                        if (!strcmp(type->c_str(), current_type)) {
+                            filter_result.add_unsafe(candidate_id);
+                            break;
+                        }
+                    } else {
                         filter_result.add_unsafe(candidate_id);
                         break;
                     }
-                } else {
-                    filter_result.add_unsafe(candidate_id);
-                    break;
                 }
+                dataiterator_free(&di);
             }
-            dataiterator_free(&di);
         }
     }
 
@@ -151,12 +213,8 @@ static void filter_reference_by_type_and_id(
 }
 
 void AdvisoryQuery::filter_name(const std::string & pattern, sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(
-        *get_rpm_pool(base),
-        SOLVABLE_NAME,
-        *p_impl,
-        cmp_type,
-        {std::string(libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX) + pattern});
+    filter_name_internal(
+        base, *p_impl, cmp_type, {std::string(libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX) + pattern});
 }
 
 void AdvisoryQuery::filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp_type) {
@@ -164,7 +222,7 @@ void AdvisoryQuery::filter_name(const std::vector<std::string> & patterns, sack:
     for (std::string pattern : patterns) {
         prefixed_patterns.push_back(std::string(libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX) + pattern);
     }
-    filter_dataiterator_internal(*get_rpm_pool(base), SOLVABLE_NAME, *p_impl, cmp_type, prefixed_patterns);
+    filter_name_internal(base, *p_impl, cmp_type, prefixed_patterns);
 }
 
 void AdvisoryQuery::filter_type(const std::string & type, sack::QueryCmp cmp_type) {
@@ -176,17 +234,17 @@ void AdvisoryQuery::filter_type(const std::vector<std::string> & types, sack::Qu
 }
 
 void AdvisoryQuery::filter_reference(const std::string & pattern, sack::QueryCmp cmp_type) {
-    filter_reference_by_type_and_id(get_rpm_pool(base), *p_impl, cmp_type, {pattern}, std::nullopt);
+    filter_reference_by_type_and_id(base, *p_impl, cmp_type, {pattern}, std::nullopt);
 }
 void AdvisoryQuery::filter_reference(const std::string & pattern, const std::string & type, sack::QueryCmp cmp_type) {
-    filter_reference_by_type_and_id(get_rpm_pool(base), *p_impl, cmp_type, {pattern}, type);
+    filter_reference_by_type_and_id(base, *p_impl, cmp_type, {pattern}, type);
 }
 void AdvisoryQuery::filter_reference(const std::vector<std::string> & patterns, sack::QueryCmp cmp_type) {
-    filter_reference_by_type_and_id(get_rpm_pool(base), *p_impl, cmp_type, patterns, std::nullopt);
+    filter_reference_by_type_and_id(base, *p_impl, cmp_type, patterns, std::nullopt);
 }
 void AdvisoryQuery::filter_reference(
     const std::vector<std::string> & patterns, const std::string & type, sack::QueryCmp cmp_type) {
-    filter_reference_by_type_and_id(get_rpm_pool(base), *p_impl, cmp_type, patterns, type);
+    filter_reference_by_type_and_id(base, *p_impl, cmp_type, patterns, type);
 }
 
 void AdvisoryQuery::filter_severity(const std::string & severity, sack::QueryCmp cmp_type) {
@@ -196,6 +254,10 @@ void AdvisoryQuery::filter_severity(const std::vector<std::string> & severities,
     filter_dataiterator_internal(*get_rpm_pool(base), UPDATE_SEVERITY, *p_impl, cmp_type, severities);
 }
 
+void AdvisoryQuery::filter_applicable() {
+    *p_impl &= InternalBaseUser::get_rpm_advisory_sack(base)->get_applicable_advisories();
+}
+
 void AdvisoryQuery::filter_packages(const libdnf5::rpm::PackageSet & package_set, sack::QueryCmp cmp_type) {
     auto & pool = get_rpm_pool(base);
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
@@ -19,13 +19,45 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "advisory_sack.hpp"
 
+#include "advisory_package_private.hpp"
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
+#include "utils/string.hpp"
+
+#include "libdnf5/advisory/advisory.hpp"
+#include "libdnf5/advisory/advisory_collection.hpp"
+#include "libdnf5/module/module_item.hpp"
+#include "libdnf5/module/module_sack.hpp"
 
 #include <solv/dataiterator.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace libdnf5::advisory {
 
+/// Returns whether the collection at the current pool position (SOLVID_POS) is applicable
+static bool is_collection_at_pos_applicable(
+    libdnf5::solv::RpmPool & pool, const std::set<std::string> & active_module_streams) {
+    bool applicable = true;
+    Dataiterator di;
+    dataiterator_init(&di, *pool, 0, SOLVID_POS, UPDATE_MODULE, 0, 0);
+    while (dataiterator_step(&di)) {
+        dataiterator_setpos(&di);
+        std::string module_stream = pool.id2str(pool.lookup_id(SOLVID_POS, UPDATE_MODULE_NAME));
+        module_stream.append(":");
+        module_stream.append(pool.id2str(pool.lookup_id(SOLVID_POS, UPDATE_MODULE_STREAM)));
+        if (active_module_streams.contains(module_stream)) {
+            applicable = true;
+            break;
+        }
+        // The collection has a module, it is applicable only if some of its modules is active
+        applicable = false;
+    }
+    dataiterator_free(&di);
+    return applicable;
+}
+
 libdnf5::solv::SolvMap & AdvisorySack::get_solvables() {
     auto & pool = get_rpm_pool(base);
 
@@ -60,6 +92,221 @@ libdnf5::solv::SolvMap & AdvisorySack::get_solvables() {
     return data_map;
 }
 
+const std::vector<AdvisoryPackage> & AdvisorySack::get_sorted_packages() {
+    auto & pool = get_rpm_pool(base);
+
+    if (sorted_packages_solvables_size == pool.get_nsolvables()) {
+        return sorted_packages;
+    }
+
+    sorted_packages.clear();
+    for (Id advisory_id : get_solvables()) {
+        Advisory advisory(base, AdvisoryId(advisory_id));
+        for (auto & collection : advisory.get_collections()) {
+            collection.get_packages(sorted_packages);
+        }
+    }
+    std::sort(sorted_packages.begin(), sorted_packages.end(), AdvisoryPackage::Impl::nevra_compare_lower_id);
+
+    sorted_packages_solvables_size = pool.get_nsolvables();
+
+    return sorted_packages;
+}
+
+void AdvisorySack::update_lookup_indexes() {
+    auto & pool = get_rpm_pool(base);
+
+    if (lookup_indexes_solvables_size == pool.get_nsolvables()) {
+        return;
+    }
+
+    name_index.clear();
+    reference_index.clear();
+    for (Id advisory_id : get_solvables()) {
+        name_index[pool.get_name(advisory_id)].push_back(advisory_id);
+
+        Dataiterator di;
+        dataiterator_init(&di, *pool, 0, advisory_id, UPDATE_REFERENCE, 0, 0);
+        while (dataiterator_step(&di)) {
+            dataiterator_setpos(&di);
+            const char * reference_id = pool.lookup_str(SOLVID_POS, UPDATE_REFERENCE_ID);
+            if (reference_id == nullptr) {
+                continue;
+            }
+            const char * type = pool.lookup_str(SOLVID_POS, UPDATE_REFERENCE_TYPE);
+            reference_index[reference_id].push_back({advisory_id, type ? type : "", type != nullptr});
+        }
+        dataiterator_free(&di);
+    }
+
+    lookup_indexes_solvables_size = pool.get_nsolvables();
+}
+
+const std::unordered_map<std::string, std::vector<Id>> & AdvisorySack::get_name_index() {
+    update_lookup_indexes();
+    return name_index;
+}
+
+const std::unordered_map<std::string, std::vector<AdvisoryReferenceEntry>> & AdvisorySack::get_reference_index() {
+    update_lookup_indexes();
+    return reference_index;
+}
+
+bool AdvisorySack::update_active_module_streams() {
+    std::set<std::string> streams;
+    for (const auto * module_item : base->get_module_sack()->get_active_modules()) {
+        streams.insert(module_item->get_name() + ":" + module_item->get_stream());
+    }
+    if (streams == active_module_streams) {
+        return false;
+    }
+    active_module_streams = std::move(streams);
+    return true;
+}
+
+void AdvisorySack::update_applicability() {
+    auto & pool = get_rpm_pool(base);
+
+    bool streams_changed = update_active_module_streams();
+    if (!streams_changed && applicability_solvables_size == pool.get_nsolvables()) {
+        return;
+    }
+
+    // One pass over the collections of all advisories, the active module streams are collected only once
+    applicable_advisories = libdnf5::solv::SolvMap(pool.get_nsolvables());
+    partially_applicable_advisories = libdnf5::solv::SolvMap(pool.get_nsolvables());
+    for (Id advisory_id : get_solvables()) {
+        bool any_applicable = false;
+        bool all_applicable = true;
+
+        Dataiterator di;
+        dataiterator_init(&di, *pool, 0, advisory_id, UPDATE_COLLECTIONLIST, 0, 0);
+        while (dataiterator_step(&di)) {
+            dataiterator_setpos(&di);
+            if (is_collection_at_pos_applicable(pool, active_module_streams)) {
+                any_applicable = true;
+            } else {
+                all_applicable = false;
+            }
+        }
+        dataiterator_free(&di);
+
+        if (any_applicable) {
+            applicable_advisories.add_unsafe(advisory_id);
+            if (!all_applicable) {
+                partially_applicable_advisories.add_unsafe(advisory_id);
+            }
+        }
+    }
+
+    applicability_solvables_size = pool.get_nsolvables();
+}
+
+const libdnf5::solv::SolvMap & AdvisorySack::get_applicable_advisories() {
+    update_applicability();
+    return applicable_advisories;
+}
+
+const libdnf5::solv::SolvMap & AdvisorySack::get_partially_applicable_advisories() {
+    update_applicability();
+    return partially_applicable_advisories;
+}
+
+bool AdvisorySack::is_collection_applicable(AdvisoryId advisory, int index) {
+    update_applicability();
+    if (!applicable_advisories.contains(advisory.id)) {
+        return false;
+    }
+    if (!partially_applicable_advisories.contains(advisory.id)) {
+        return true;
+    }
+
+    auto & pool = get_rpm_pool(base);
+    bool applicable = false;
+    Dataiterator di;
+    dataiterator_init(&di, *pool, 0, advisory.id, UPDATE_COLLECTIONLIST, 0, 0);
+    for (int count = 0; dataiterator_step(&di); count++) {
+        if (count == index) {
+            dataiterator_setpos(&di);
+            applicable = is_collection_at_pos_applicable(pool, active_module_streams);
+            break;
+        }
+    }
+    dataiterator_free(&di);
+    return applicable;
+}
+
+std::size_t AdvisoryFields::find(Id advisory) const noexcept {
+    auto it = std::lower_bound(ids.begin(), ids.end(), advisory);
+    if (it == ids.end() || *it != advisory) {
+        return npos;
+    }
+    return static_cast<std::size_t>(it - ids.begin());
+}
+
+const AdvisoryFields & AdvisorySack::get_fields() {
+    auto & pool = get_rpm_pool(base);
+
+    if (fields_solvables_size == pool.get_nsolvables()) {
+        return fields;
+    }
+
+    fields = AdvisoryFields();
+    auto & advisories = get_solvables();
+    auto count = advisories.size();
+    fields.ids.reserve(count);
+    fields.names.reserve(count);
+    fields.types.reserve(count);
+    fields.severities.reserve(count);
+    fields.titles.reserve(count);
+    fields.buildtimes.reserve(count);
+    // The SolvMap is iterated in the ascending order of Ids, `ids` stay sorted
+    for (Id advisory_id : advisories) {
+        const char * name = pool.get_name(advisory_id);
+        if (strncmp(
+                name,
+                libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX,
+                libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX_LENGTH) != 0) {
+            // Not cached, Advisory::get_name() reports the bad solvable
+            continue;
+        }
+        fields.ids.push_back(advisory_id);
+        fields.names.emplace_back(name + libdnf5::solv::SOLVABLE_NAME_ADVISORY_PREFIX_LENGTH);
+        fields.types.push_back(libdnf5::utils::string::c_to_str(pool.lookup_str(advisory_id, SOLVABLE_PATCHCATEGORY)));
+        fields.severities.push_back(libdnf5::utils::string::c_to_str(pool.lookup_str(advisory_id, UPDATE_SEVERITY)));
+        // SOLVABLE_SUMMARY is misnamed, it actually stores the title
+        fields.titles.push_back(libdnf5::utils::string::c_to_str(pool.lookup_str(advisory_id, SOLVABLE_SUMMARY)));
+        fields.buildtimes.push_back(pool.lookup_num(advisory_id, SOLVABLE_BUILDTIME));
+    }
+
+    fields_solvables_size = pool.get_nsolvables();
+
+    return fields;
+}
+
+std::size_t AdvisorySack::get_memory_usage() const {
+    std::size_t bytes = data_map.get_memory_usage() + applicable_advisories.get_memory_usage() +
+                        partially_applicable_advisories.get_memory_usage();
+    bytes += sorted_packages.capacity() * (sizeof(AdvisoryPackage) + sizeof(AdvisoryPackage::Impl));
+    for (const auto & [name, ids] : name_index) {
+        bytes += sizeof(name) + name.capacity() + sizeof(ids) + ids.capacity() * sizeof(Id);
+    }
+    for (const auto & [reference, entries] : reference_index) {
+        bytes += sizeof(reference) + reference.capacity() + sizeof(entries);
+        for (const auto & entry : entries) {
+            bytes += sizeof(entry) + entry.type.capacity();
+        }
+    }
+    bytes += fields.ids.capacity() * sizeof(Id) + fields.buildtimes.capacity() * sizeof(unsigned long long);
+    for (const auto * strings : {&fields.names, &fields.types, &fields.severities, &fields.titles}) {
+        bytes += strings->capacity() * sizeof(std::string);
+        for (const auto & value : *strings) {
+            bytes += value.capacity();
+        }
+    }
+    return bytes;
+}
+
 AdvisorySack::AdvisorySack(const libdnf5::BaseWeakPtr & base) : base(base) {}
 
 AdvisorySackWeakPtr AdvisorySack::get_weak_ptr() {
@@ -22,9 +22,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "solv/solv_map.hpp"
 
+#include "libdnf5/advisory/advisory_package.hpp"
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/common/weak_ptr.hpp"
 
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 
 namespace libdnf5::advisory {
 
@@ -32,6 +38,35 @@ class AdvisorySack;
 using AdvisorySackWeakPtr = WeakPtr<AdvisorySack, false>;
 
 
+/// Advisory having a reference with the given id, an item of the reference index of AdvisorySack
+struct AdvisoryReferenceEntry {
+    Id advisory;
+    /// Type of the reference, e.g. "cve" or "bugzilla"
+    std::string type;
+    /// False when the reference has no type, such a reference matches any requested type
+    bool has_type;
+};
+
+
+/// The commonly displayed fields of the advisories stored as a struct of arrays. The fields of an advisory
+/// are at the position returned by `find()` in each of the arrays.
+struct AdvisoryFields {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// @return The position of the fields of the `advisory`, `npos` if the advisory is not cached.
+    std::size_t find(Id advisory) const noexcept;
+
+    /// Sorted Ids of the advisories
+    std::vector<Id> ids;
+    /// Names of the advisories without the advisory prefix
+    std::vector<std::string> names;
+    std::vector<std::string> types;
+    std::vector<std::string> severities;
+    std::vector<std::string> titles;
+    std::vector<unsigned long long> buildtimes;
+};
+
+
 class AdvisorySack {
 public:
     explicit AdvisorySack(const libdnf5::BaseWeakPtr & base);
@@ -45,12 +80,70 @@ public:
     /// @return All advisories from pool inside of base.
     libdnf5::solv::SolvMap & get_solvables();
 
+    /// @return The packages of all collections of all advisories sorted by name, arch and EVR Ids.
+    /// The index is built once after the updateinfo is loaded and shared by all queries.
+    const std::vector<AdvisoryPackage> & get_sorted_packages();
+
+    /// @return Index of the advisories by their solvable names (including the advisory prefix).
+    /// Several repositories can contain the same advisory, a name therefore maps to a list of Ids.
+    /// The index is built on first use after the updateinfo is loaded.
+    const std::unordered_map<std::string, std::vector<Id>> & get_name_index();
+
+    /// @return Index of the advisories by the ids of their references.
+    /// The index is built on first use after the updateinfo is loaded.
+    const std::unordered_map<std::string, std::vector<AdvisoryReferenceEntry>> & get_reference_index();
+
+    /// @return Advisories having at least one applicable collection, see AdvisoryCollection::is_applicable().
+    /// The applicability of all advisories is evaluated at once, by up to `query_filter_threads` threads.
+    /// It is evaluated again when the advisories or the active module streams change.
+    const libdnf5::solv::SolvMap & get_applicable_advisories();
+
+    /// @return Advisories having both applicable and not applicable collections.
+    /// Only the collections of these advisories need to be checked one by one.
+    const libdnf5::solv::SolvMap & get_partially_applicable_advisories();
+
+    /// @return Whether the collection with the given `index` of the `advisory` is applicable.
+    /// A collection without modules is always applicable, a collection with modules is applicable when
+    /// at least one of its module streams is active.
+    bool is_collection_applicable(AdvisoryId advisory, int index);
+
+    /// @return The commonly displayed fields of all advisories, used by the getters of Advisory.
+    /// The fields are read from the pool once after the updateinfo is loaded.
+    const AdvisoryFields & get_fields();
+
+    /// @return The estimated memory used by the advisory indexes and caches in bytes.
+    std::size_t get_memory_usage() const;
+
 private:
+    /// Builds the name and reference indexes if the advisories changed since they were built
+    void update_lookup_indexes();
+
+    /// Returns whether the active module streams changed since the last call, stores them as "name:stream"
+    bool update_active_module_streams();
+
+    /// Evaluates the applicability of all advisories if the advisories or the active module streams changed
+    void update_applicability();
+
     libdnf5::BaseWeakPtr base;
     WeakPtrGuard<AdvisorySack, false> sack_guard;
 
     libdnf5::solv::SolvMap data_map{0};
     int cached_solvables_size{0};
+
+    std::vector<AdvisoryPackage> sorted_packages;
+    int sorted_packages_solvables_size{0};
+
+    std::unordered_map<std::string, std::vector<Id>> name_index;
+    std::unordered_map<std::string, std::vector<AdvisoryReferenceEntry>> reference_index;
+    int lookup_indexes_solvables_size{0};
+
+    std::set<std::string> active_module_streams;
+    libdnf5::solv::SolvMap applicable_advisories{0};
+    libdnf5::solv::SolvMap partially_applicable_advisories{0};
+    int applicability_solvables_size{0};
+
+    AdvisoryFields fields;
+    int fields_solvables_size{0};
 };
 
 }  // namespace libdnf5::advisory
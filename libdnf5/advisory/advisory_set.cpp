@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "advisory/advisory_package_private.hpp"
 #include "advisory_set_impl.hpp"
+#include "base/base_impl.hpp"
 #include "base/base_private.hpp"
 #include "solv/solv_map.hpp"
 
@@ -119,20 +120,30 @@ BaseWeakPtr AdvisorySet::get_base() const {
 }
 
 std::vector<AdvisoryPackage> AdvisorySet::get_advisory_packages_sorted_by_name_arch_evr(bool only_applicable) const {
+    // The packages of the advisories in the set are picked from the sorted index, they stay sorted
+    auto advisory_sack = InternalBaseUser::get_rpm_advisory_sack(p_impl->base);
+    const auto & sorted_packages = advisory_sack->get_sorted_packages();
+    libdnf5::solv::SolvMap advisories(*p_impl);
+    const libdnf5::solv::SolvMap * partially_applicable = nullptr;
+    if (only_applicable) {
+        // Applicability of all advisories is evaluated at once, only the collections of partially applicable
+        // advisories are checked one by one
+        advisories &= advisory_sack->get_applicable_advisories();
+        partially_applicable = &advisory_sack->get_partially_applicable_advisories();
+    }
     std::vector<AdvisoryPackage> out;
-    for (Id candidate_id : *p_impl) {
-        Advisory advisory2 = Advisory(p_impl->base, AdvisoryId(candidate_id));
-        auto collections = advisory2.get_collections();
-        for (auto & collection : collections) {
-            if (only_applicable && !collection.is_applicable()) {
-                continue;
-            }
-            collection.get_packages(out);
+    for (const auto & adv_pkg : sorted_packages) {
+        Id advisory_id = adv_pkg.p_impl->get_advisory_id().id;
+        if (!advisories.contains(advisory_id)) {
+            continue;
+        }
+        if (partially_applicable && partially_applicable->contains(advisory_id) &&
+            !adv_pkg.get_advisory_collection().is_applicable()) {
+            continue;
         }
+        out.push_back(adv_pkg);
     }
 
-    std::sort(out.begin(), out.end(), AdvisoryPackage::Impl::nevra_compare_lower_id);
-
     return out;
 }
 
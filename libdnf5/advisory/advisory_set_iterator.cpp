@@ -29,7 +29,7 @@ namespace libdnf5::advisory {
 class AdvisorySetIterator::Impl : private libdnf5::solv::SolvMap::iterator {
 private:
     Impl(const AdvisorySet & advisory_set)
-        : libdnf5::solv::SolvMap::iterator(advisory_set.p_impl->get_map()),
+        : libdnf5::solv::SolvMap::iterator(*advisory_set.p_impl),
           advisory_set{&advisory_set} {}
 
     AdvisorySetIterator::Impl & operator++() {
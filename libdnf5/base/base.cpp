@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "base_impl.hpp"
 #include "conf/config.h"
 #include "solv/pool.hpp"
+#include "transaction/db/db.hpp"
 #include "utils/dnf4convert/dnf4convert.hpp"
 
 #include "libdnf5/conf/config_parser.hpp"
@@ -90,9 +91,16 @@ Base::Base(std::vector<std::unique_ptr<Logger>> && loggers)
       transaction_history(get_weak_ptr()),
       vars(get_weak_ptr()) {}
 
-Base::~Base() = default;
+Base::~Base() {
+    // Let the background writer complete the libsolv cache files before the repositories are destroyed.
+    p_impl->get_solv_cache_writer().finish();
+    // The background conversion of the dnf4 history is resumed by the next run.
+    if (p_impl->history_converter) {
+        p_impl->history_converter->stop();
+    }
+}
 
-Base::Impl::Impl(const libdnf5::BaseWeakPtr & base) : rpm_advisory_sack(base), plugins(*base) {}
+Base::Impl::Impl(const libdnf5::BaseWeakPtr & base) : rpm_advisory_sack(base), plugins(*base), mirror_stats(base) {}
 
 void Base::lock() {
     locked_base_mutex.lock();
@@ -112,6 +120,7 @@ Base * Base::get_locked_base() noexcept {
 }
 
 void Base::load_config() {
+    base::SpanRecorder::Scope span(p_impl->span_recorder, "load config");
     fs::path conf_file_path{config.get_config_file_path_option().get_value()};
     fs::path conf_dir_path{CONF_DIRECTORY};
     fs::path distribution_conf_dir_path{LIBDNF5_DISTRIBUTION_CONFIG_DIR};
@@ -132,7 +141,7 @@ void Base::load_config() {
     const auto paths = create_sorted_file_list({conf_dir_path, distribution_conf_dir_path}, ".conf");
     for (const auto & path : paths) {
         ConfigParser parser;
-        parser.read(path);
+        parser.read(path, false);
         config.load_from_parser(parser, "main", vars, *get_logger());
     }
 
@@ -140,7 +149,7 @@ void Base::load_config() {
     // it will be loaded.
     if (user_defined_config_file_name || fs::exists(conf_file_path)) {
         ConfigParser parser;
-        parser.read(conf_file_path);
+        parser.read(conf_file_path, false);
         config.load_from_parser(parser, "main", vars, *get_logger());
     }
 }
@@ -183,6 +192,7 @@ void Base::load_plugins() {
 void Base::setup() {
     auto & pool = p_impl->pool;
     libdnf_user_assert(!pool, "Base was already initialized");
+    base::SpanRecorder::Scope span(p_impl->span_recorder, "setup base");
 
     // Resolve installroot configuration
     std::string vars_installroot{"/"};
@@ -210,8 +220,11 @@ void Base::setup() {
         config.get_logdir_option().set(Option::Priority::INSTALLROOT, full_path);
     }
 
-    load_plugins();
-    p_impl->plugins.init();
+    {
+        base::SpanRecorder::Scope plugins_span(p_impl->span_recorder, "load libdnf5 plugins");
+        load_plugins();
+        p_impl->plugins.init();
+    }
 
     p_impl->plugins.pre_base_setup();
 
@@ -221,7 +234,10 @@ void Base::setup() {
     auto & installroot = config.get_installroot_option();
     installroot.lock("Locked by Base::setup()");
 
-    get_vars()->load(vars_installroot, config.get_varsdir_option().get_value());
+    {
+        base::SpanRecorder::Scope vars_span(p_impl->span_recorder, "load vars");
+        get_vars()->load(vars_installroot, config.get_varsdir_option().get_value());
+    }
 
     // TODO(mblaha) - move system state load closer to the system repo loading
     std::filesystem::path system_state_dir{config.get_system_state_dir_option().get_value()};
@@ -254,6 +270,26 @@ void Base::setup() {
         }
     }
 
+    auto & dnf4_history_conversion = config.get_dnf4_history_conversion_option().get_value();
+    if (dnf4_history_conversion != "off") {
+        std::filesystem::path dnf4_db_path{installroot.get_value()};
+        dnf4_db_path /= std::filesystem::path(config.get_persistdir_option().get_value()).relative_path();
+        dnf4_db_path /= "history.sqlite";
+        auto & history_converter = p_impl->history_converter.emplace(
+            dnf4_db_path,
+            libdnf5::transaction::transaction_db_get_path(*this),
+            libdnf5::transaction::transaction_db_get_open_options(*this));
+        if (dnf4_history_conversion == "foreground") {
+            try {
+                history_converter.convert();
+            } catch (const std::exception & ex) {
+                get_logger()->warning("Cannot convert dnf4 transaction history: {}", ex.what());
+            }
+        } else {
+            history_converter.start_background(*get_logger());
+        }
+    }
+
     config.get_varsdir_option().lock("Locked by Base::setup()");
     pool_setdisttype(**pool, DISTTYPE_RPM);
     // TODO(jmracek) - architecture variable is changable therefore architecture in vars must be synchronized with RpmPool
@@ -264,6 +300,10 @@ void Base::setup() {
     p_impl->plugins.post_base_setup();
 }
 
+base::SpanRecorder & Base::get_span_recorder() {
+    return p_impl->span_recorder;
+}
+
 bool Base::is_initialized() {
     return p_impl->pool.get() != nullptr;
 }
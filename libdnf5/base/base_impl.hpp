@@ -23,7 +23,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "../advisory/advisory_sack.hpp"
 #include "plugin/plugins.hpp"
+#include "repo/download_manifest.hpp"
+#include "repo/mirror_stats.hpp"
+#include "repo/solv_cache_writer.hpp"
 #include "system/state.hpp"
+#include "utils/dnf4convert/history_converter.hpp"
 
 #include "libdnf5/base/base.hpp"
 
@@ -56,6 +60,21 @@ public:
 
     plugin::Plugins & get_plugins() { return plugins; }
 
+    /// @return The background writer of libsolv cache files, used when "build_cache_in_background" is enabled.
+    repo::SolvCacheWriter & get_solv_cache_writer() { return solv_cache_writer; }
+
+    /// @return The persistent download statistics of the mirrors.
+    repo::MirrorStats & get_mirror_stats() { return mirror_stats; }
+
+    /// @return The records of the verified package files, loaded from the `cachedir` on the first use.
+    /// They are written by `PackageDownloader::download()`.
+    repo::DownloadManifest & get_download_manifest(const std::filesystem::path & cachedir) {
+        if (!download_manifest) {
+            download_manifest.emplace(cachedir);
+        }
+        return *download_manifest;
+    }
+
 private:
     friend class Base;
     Impl(const libdnf5::BaseWeakPtr & base);
@@ -77,6 +96,19 @@ private:
     libdnf5::advisory::AdvisorySack rpm_advisory_sack;
 
     plugin::Plugins plugins;
+
+    // The jobs of a repository are cancelled when its SolvRepo is destroyed. The writer is finished in ~Base()
+    // so that the queued jobs complete the cache files.
+    repo::SolvCacheWriter solv_cache_writer;
+
+    repo::MirrorStats mirror_stats;
+
+    std::optional<repo::DownloadManifest> download_manifest;
+
+    base::SpanRecorder span_recorder;
+
+    // Converter of the dnf4 transaction history, created by Base::setup() when the conversion is enabled
+    std::optional<dnf4convert::HistoryConverter> history_converter;
 };
 
 
@@ -86,6 +118,18 @@ public:
     static solv::CompsPool & get_comps_pool(const libdnf5::BaseWeakPtr & base) {
         return base->p_impl->get_comps_pool();
     }
+    static system::State & get_system_state(const libdnf5::BaseWeakPtr & base) {
+        return base->p_impl->get_system_state();
+    }
+    static advisory::AdvisorySackWeakPtr get_rpm_advisory_sack(const libdnf5::BaseWeakPtr & base) {
+        return base->p_impl->get_rpm_advisory_sack();
+    }
+    static repo::MirrorStats & get_mirror_stats(const libdnf5::BaseWeakPtr & base) {
+        return base->p_impl->get_mirror_stats();
+    }
+    static repo::DownloadManifest & get_download_manifest(const libdnf5::BaseWeakPtr & base) {
+        return base->p_impl->get_download_manifest(base->get_config().get_cachedir_option().get_value());
+    }
 };
 
 }  // namespace libdnf5
@@ -42,9 +42,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 #include "libdnf5/utils/patterns.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
 
@@ -86,6 +92,52 @@ inline bool name_arch_compare_lower_solvable(const Solvable * first, const Solva
     return first->arch < second->arch;
 }
 
+/// Return true when specs are resolved the same way with both settings
+bool same_resolve_spec_settings(const ResolveSpecSettings & first, const ResolveSpecSettings & second) {
+    return first.ignore_case == second.ignore_case && first.with_nevra == second.with_nevra &&
+           first.with_provides == second.with_provides && first.with_filenames == second.with_filenames &&
+           first.with_binaries == second.with_binaries && first.nevra_forms == second.nevra_forms;
+}
+
+/// The packages the spec of an rpm job is resolved against
+enum class SpecQuery { NONE, ALL, INSTALLED };
+
+inline SpecQuery get_spec_query(GoalAction action) {
+    switch (action) {
+        case GoalAction::INSTALL:
+        case GoalAction::INSTALL_BY_COMPS:
+        case GoalAction::REINSTALL:
+        case GoalAction::UPGRADE:
+        case GoalAction::UPGRADE_MINIMAL:
+        case GoalAction::DOWNGRADE:
+        case GoalAction::DISTRO_SYNC:
+            return SpecQuery::ALL;
+        case GoalAction::REMOVE:
+            return SpecQuery::INSTALLED;
+        default:
+            return SpecQuery::NONE;
+    }
+}
+
+/// Return true for the rich (boolean) dependency `dep`
+inline bool is_rich_dependency(::Pool * pool, Id dep) {
+    if (!ISRELDEP(dep)) {
+        return false;
+    }
+    switch (GETRELDEP(pool, dep)->flags) {
+        case REL_AND:
+        case REL_OR:
+        case REL_WITH:
+        case REL_WITHOUT:
+        case REL_COND:
+        case REL_UNLESS:
+        case REL_ELSE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 
 }  // namespace
 
@@ -106,18 +158,38 @@ public:
     GoalProblem add_module_specs_to_goal(base::Transaction & transaction);
     GoalProblem add_reason_change_specs_to_goal(base::Transaction & transaction);
 
+    /// The result of `resolve_pkg_spec()` and the query with the packages matching the spec
+    using ResolvedSpec = std::pair<std::pair<bool, libdnf5::rpm::Nevra>, rpm::PackageQuery>;
+
+    /// Resolve specs of the rpm jobs that are resolved against the same packages with the same resolve settings
+    /// together. Returns the resolved spec for each of `rpm_specs`, it is empty for jobs that are not resolved
+    /// in advance.
+    std::vector<std::optional<ResolvedSpec>> resolve_rpm_specs();
+
     std::pair<GoalProblem, libdnf5::solv::IdQueue> add_install_to_goal(
-        base::Transaction & transaction, GoalAction action, const std::string & spec, GoalJobSettings & settings);
+        base::Transaction & transaction,
+        GoalAction action,
+        const std::string & spec,
+        GoalJobSettings & settings,
+        ResolvedSpec * resolved_spec = nullptr);
     void add_provide_install_to_goal(const std::string & spec, GoalJobSettings & settings);
     GoalProblem add_reinstall_to_goal(
-        base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings);
-    void add_remove_to_goal(base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings);
+        base::Transaction & transaction,
+        const std::string & spec,
+        GoalJobSettings & settings,
+        ResolvedSpec * resolved_spec = nullptr);
+    void add_remove_to_goal(
+        base::Transaction & transaction,
+        const std::string & spec,
+        GoalJobSettings & settings,
+        ResolvedSpec * resolved_spec = nullptr);
     GoalProblem add_up_down_distrosync_to_goal(
         base::Transaction & transaction,
         GoalAction action,
         const std::string & spec,
         GoalJobSettings & settings,
-        bool minimal = false);
+        bool minimal = false,
+        ResolvedSpec * resolved_spec = nullptr);
     void add_rpms_to_goal(base::Transaction & transaction);
 
     static void filter_candidates_for_advisory_upgrade(
@@ -126,11 +198,13 @@ public:
         const libdnf5::advisory::AdvisoryQuery & advisories,
         bool add_obsoletes);
 
+    /// Adds the groups of the `group_query` to the goal and appends their packages to be installed to
+    /// `group_packages`, the packages are added to the goal later by `install_group_packages()`.
     void add_group_install_to_goal(
-        base::Transaction & transaction,
         const transaction::TransactionItemReason reason,
         comps::GroupQuery group_query,
-        GoalJobSettings & settings);
+        GoalJobSettings & settings,
+        std::vector<libdnf5::comps::Package> & group_packages);
     void add_group_remove_to_goal(
         std::vector<std::tuple<std::string, transaction::TransactionItemReason, comps::GroupQuery, GoalJobSettings>> &
             groups_to_remove);
@@ -150,7 +224,8 @@ public:
         const std::string & spec,
         const transaction::TransactionItemReason reason,
         const std::optional<std::string> & group_id,
-        GoalJobSettings & settings);
+        GoalJobSettings & settings,
+        ResolvedSpec * resolved_spec = nullptr);
 
     /// Parse the spec (package, group, remote or local rpm file) and process it.
     /// Repository packages and groups are directly added to rpm_specs / group_specs,
@@ -200,8 +275,12 @@ private:
 
     rpm::solv::GoalPrivate rpm_goal;
     bool allow_erasing{false};
+    bool incremental{false};
 
-    void install_group_package(base::Transaction & transaction, libdnf5::comps::Package pkg);
+    /// Adds the installation of the packages of comps groups to the goal. The names of all the packages are resolved
+    /// together, a package contained in several groups is installed by a single job.
+    void install_group_packages(
+        base::Transaction & transaction, const std::vector<libdnf5::comps::Package> & group_packages);
     void remove_group_packages(const rpm::PackageSet & remove_candidates);
 };
 
@@ -354,6 +433,20 @@ void Goal::add_rpm_reason_change(
     p_impl->rpm_reason_change_specs.push_back(std::make_tuple(reason, spec, group_id, settings));
 }
 
+void Goal::add_rpm_reason_change(
+    const std::vector<std::string> & specs,
+    const libdnf5::transaction::TransactionItemReason reason,
+    const std::string & group_id,
+    const libdnf5::GoalJobSettings & settings) {
+    libdnf_user_assert(
+        reason != libdnf5::transaction::TransactionItemReason::GROUP || !group_id.empty(),
+        "group_id is required for setting reason \"GROUP\"");
+    p_impl->rpm_reason_change_specs.reserve(p_impl->rpm_reason_change_specs.size() + specs.size());
+    for (const auto & spec : specs) {
+        p_impl->rpm_reason_change_specs.push_back(std::make_tuple(reason, spec, group_id, settings));
+    }
+}
+
 void Goal::add_provide_install(const std::string & spec, const GoalJobSettings & settings) {
     p_impl->rpm_specs.push_back(std::make_tuple(GoalAction::INSTALL_VIA_PROVIDE, spec, settings));
 }
@@ -474,11 +567,14 @@ GoalProblem Goal::Impl::add_specs_to_goal(base::Transaction & transaction) {
     auto sack = base->get_rpm_package_sack();
     auto & cfg_main = base->get_config();
     auto ret = GoalProblem::NO_PROBLEM;
-    for (auto & [action, spec, settings] : rpm_specs) {
+    auto resolved_specs = resolve_rpm_specs();
+    for (std::size_t idx = 0; idx < rpm_specs.size(); ++idx) {
+        auto & [action, spec, settings] = rpm_specs[idx];
+        auto * resolved_spec = resolved_specs[idx] ? &resolved_specs[idx].value() : nullptr;
         switch (action) {
             case GoalAction::INSTALL:
             case GoalAction::INSTALL_BY_COMPS: {
-                auto [problem, idqueue] = add_install_to_goal(transaction, action, spec, settings);
+                auto [problem, idqueue] = add_install_to_goal(transaction, action, spec, settings, resolved_spec);
                 rpm_goal.add_transaction_user_installed(idqueue);
                 ret |= problem;
             } break;
@@ -486,18 +582,18 @@ GoalProblem Goal::Impl::add_specs_to_goal(base::Transaction & transaction) {
                 add_provide_install_to_goal(spec, settings);
                 break;
             case GoalAction::REINSTALL:
-                ret |= add_reinstall_to_goal(transaction, spec, settings);
+                ret |= add_reinstall_to_goal(transaction, spec, settings, resolved_spec);
                 break;
             case GoalAction::REMOVE:
-                add_remove_to_goal(transaction, spec, settings);
+                add_remove_to_goal(transaction, spec, settings, resolved_spec);
                 break;
             case GoalAction::DISTRO_SYNC:
             case GoalAction::DOWNGRADE:
             case GoalAction::UPGRADE:
-                ret |= add_up_down_distrosync_to_goal(transaction, action, spec, settings);
+                ret |= add_up_down_distrosync_to_goal(transaction, action, spec, settings, false, resolved_spec);
                 break;
             case GoalAction::UPGRADE_MINIMAL:
-                ret |= add_up_down_distrosync_to_goal(transaction, action, spec, settings, true);
+                ret |= add_up_down_distrosync_to_goal(transaction, action, spec, settings, true, resolved_spec);
                 break;
             case GoalAction::UPGRADE_ALL:
             case GoalAction::UPGRADE_ALL_MINIMAL: {
@@ -698,11 +794,14 @@ void Goal::Impl::add_resolved_group_specs_to_goal(base::Transaction & transactio
     // process group removals first
     add_group_remove_to_goal(resolved_group_specs[GoalAction::REMOVE]);
 
+    // the packages of all the installed groups (including the groups of environments) are resolved together
+    std::vector<libdnf5::comps::Package> group_packages;
     for (const auto & action : std::vector<GoalAction>{GoalAction::INSTALL, GoalAction::INSTALL_BY_COMPS}) {
         for (auto & [spec, reason, group_query, settings] : resolved_group_specs[action]) {
-            add_group_install_to_goal(transaction, reason, group_query, settings);
+            add_group_install_to_goal(reason, group_query, settings, group_packages);
         }
     }
+    install_group_packages(transaction, group_packages);
 
     for (auto & [spec, reason, group_query, settings] : resolved_group_specs[GoalAction::UPGRADE]) {
         add_group_upgrade_to_goal(transaction, group_query, settings);
@@ -711,15 +810,108 @@ void Goal::Impl::add_resolved_group_specs_to_goal(base::Transaction & transactio
 
 
 GoalProblem Goal::Impl::add_reason_change_specs_to_goal(base::Transaction & transaction) {
+    // The specs with the same resolve settings are resolved together against the installed packages
+    std::vector<std::vector<std::size_t>> batches;
+    for (std::size_t idx = 0; idx < rpm_reason_change_specs.size(); ++idx) {
+        auto & settings = std::get<3>(rpm_reason_change_specs[idx]);
+        auto batch = std::find_if(batches.begin(), batches.end(), [&](const std::vector<std::size_t> & item) {
+            return same_resolve_spec_settings(std::get<3>(rpm_reason_change_specs[item.front()]), settings);
+        });
+        if (batch == batches.end()) {
+            batches.push_back({idx});
+        } else {
+            batch->push_back(idx);
+        }
+    }
+
+    std::vector<std::optional<ResolvedSpec>> resolved_specs(rpm_reason_change_specs.size());
+    for (const auto & spec_indexes : batches) {
+        // A single spec is resolved by add_reason_change_to_goal itself
+        if (spec_indexes.size() < 2) {
+            continue;
+        }
+        std::vector<std::string> batch_specs;
+        batch_specs.reserve(spec_indexes.size());
+        for (auto idx : spec_indexes) {
+            batch_specs.push_back(std::get<1>(rpm_reason_change_specs[idx]));
+        }
+        rpm::PackageQuery base_query(base);
+        base_query.filter_installed();
+        std::vector<rpm::PackageQuery> queries;
+        auto nevra_pairs = base_query.resolve_pkg_specs(
+            batch_specs, std::get<3>(rpm_reason_change_specs[spec_indexes.front()]), false, queries);
+        for (std::size_t batch_idx = 0; batch_idx < spec_indexes.size(); ++batch_idx) {
+            resolved_specs[spec_indexes[batch_idx]].emplace(
+                std::move(nevra_pairs[batch_idx]), std::move(queries[batch_idx]));
+        }
+    }
+
     auto ret = GoalProblem::NO_PROBLEM;
-    for (auto & [reason, spec, group_id, settings] : rpm_reason_change_specs) {
-        ret |= add_reason_change_to_goal(transaction, spec, reason, group_id, settings);
+    for (std::size_t idx = 0; idx < rpm_reason_change_specs.size(); ++idx) {
+        auto & [reason, spec, group_id, settings] = rpm_reason_change_specs[idx];
+        auto * resolved_spec = resolved_specs[idx] ? &resolved_specs[idx].value() : nullptr;
+        ret |= add_reason_change_to_goal(transaction, spec, reason, group_id, settings, resolved_spec);
     }
     return ret;
 }
 
+std::vector<std::optional<Goal::Impl::ResolvedSpec>> Goal::Impl::resolve_rpm_specs() {
+    // Indexes of the `rpm_specs` resolved together, the first one provides the settings of the batch
+    struct SpecBatch {
+        SpecQuery spec_query;
+        std::vector<std::size_t> spec_indexes;
+    };
+    std::vector<SpecBatch> batches;
+    for (std::size_t idx = 0; idx < rpm_specs.size(); ++idx) {
+        auto & [action, spec, settings] = rpm_specs[idx];
+        auto spec_query = get_spec_query(action);
+        if (spec_query == SpecQuery::NONE) {
+            continue;
+        }
+        auto batch = std::find_if(batches.begin(), batches.end(), [&](const SpecBatch & item) {
+            return item.spec_query == spec_query &&
+                   same_resolve_spec_settings(std::get<2>(rpm_specs[item.spec_indexes.front()]), settings);
+        });
+        if (batch == batches.end()) {
+            batches.push_back({spec_query, {idx}});
+        } else {
+            batch->spec_indexes.push_back(idx);
+        }
+    }
+
+    // The resolution of a spec does not depend on the other jobs, the results are used in the order of `rpm_specs`
+    std::vector<std::optional<ResolvedSpec>> resolved_specs(rpm_specs.size());
+    for (const auto & [spec_query, spec_indexes] : batches) {
+        // A single spec is resolved by the add_*_to_goal method itself
+        if (spec_indexes.size() < 2) {
+            continue;
+        }
+        std::vector<std::string> batch_specs;
+        batch_specs.reserve(spec_indexes.size());
+        for (auto idx : spec_indexes) {
+            batch_specs.push_back(std::get<1>(rpm_specs[idx]));
+        }
+        rpm::PackageQuery base_query(base);
+        if (spec_query == SpecQuery::INSTALLED) {
+            base_query.filter_installed();
+        }
+        std::vector<rpm::PackageQuery> queries;
+        auto nevra_pairs =
+            base_query.resolve_pkg_specs(batch_specs, std::get<2>(rpm_specs[spec_indexes.front()]), false, queries);
+        for (std::size_t batch_idx = 0; batch_idx < spec_indexes.size(); ++batch_idx) {
+            resolved_specs[spec_indexes[batch_idx]].emplace(
+                std::move(nevra_pairs[batch_idx]), std::move(queries[batch_idx]));
+        }
+    }
+    return resolved_specs;
+}
+
 std::pair<GoalProblem, libdnf5::solv::IdQueue> Goal::Impl::add_install_to_goal(
-    base::Transaction & transaction, GoalAction action, const std::string & spec, GoalJobSettings & settings) {
+    base::Transaction & transaction,
+    GoalAction action,
+    const std::string & spec,
+    GoalJobSettings & settings,
+    ResolvedSpec * resolved_spec) {
     auto sack = base->get_rpm_package_sack();
     auto & pool = get_rpm_pool(base);
     auto & cfg_main = base->get_config();
@@ -732,8 +924,8 @@ std::pair<GoalProblem, libdnf5::solv::IdQueue> Goal::Impl::add_install_to_goal(
     libdnf5::solv::IdQueue result_queue;
     rpm::PackageQuery base_query(base);
 
-    rpm::PackageQuery query(base_query);
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    rpm::PackageQuery query = resolved_spec ? std::move(resolved_spec->second) : base_query;
+    auto nevra_pair = resolved_spec ? std::move(resolved_spec->first) : query.resolve_pkg_spec(spec, settings, false);
     if (!nevra_pair.first) {
         auto problem = transaction.p_impl->report_not_found(action, spec, settings, log_level);
         if (skip_unavailable) {
@@ -976,7 +1168,10 @@ void Goal::Impl::add_provide_install_to_goal(const std::string & spec, GoalJobSe
 }
 
 GoalProblem Goal::Impl::add_reinstall_to_goal(
-    base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings) {
+    base::Transaction & transaction,
+    const std::string & spec,
+    GoalJobSettings & settings,
+    ResolvedSpec * resolved_spec) {
     // Resolve all settings before the first report => they will be storred in settings
     auto & cfg_main = base->get_config();
     bool skip_unavailable = settings.resolve_skip_unavailable(cfg_main);
@@ -984,8 +1179,8 @@ GoalProblem Goal::Impl::add_reinstall_to_goal(
     bool best = settings.resolve_best(cfg_main);
     bool clean_requirements_on_remove = settings.resolve_clean_requirements_on_remove();
     auto sack = base->get_rpm_package_sack();
-    rpm::PackageQuery query(base);
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    rpm::PackageQuery query = resolved_spec ? std::move(resolved_spec->second) : rpm::PackageQuery(base);
+    auto nevra_pair = resolved_spec ? std::move(resolved_spec->first) : query.resolve_pkg_spec(spec, settings, false);
     if (!nevra_pair.first) {
         auto problem = transaction.p_impl->report_not_found(GoalAction::REINSTALL, spec, settings, log_level);
         return skip_unavailable ? GoalProblem::NO_PROBLEM : problem;
@@ -1325,12 +1520,18 @@ void Goal::Impl::add_rpms_to_goal(base::Transaction & transaction) {
 
 
 void Goal::Impl::add_remove_to_goal(
-    base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings) {
+    base::Transaction & transaction,
+    const std::string & spec,
+    GoalJobSettings & settings,
+    ResolvedSpec * resolved_spec) {
     bool clean_requirements_on_remove = settings.resolve_clean_requirements_on_remove(base->get_config());
-    rpm::PackageQuery query(base);
-    query.filter_installed();
+    rpm::PackageQuery query = resolved_spec ? std::move(resolved_spec->second) : [this]() {
+        rpm::PackageQuery installed_query(base);
+        installed_query.filter_installed();
+        return installed_query;
+    }();
 
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    auto nevra_pair = resolved_spec ? std::move(resolved_spec->first) : query.resolve_pkg_spec(spec, settings, false);
     if (!nevra_pair.first) {
         transaction.p_impl->report_not_found(GoalAction::REMOVE, spec, settings, libdnf5::Logger::Level::WARNING);
         return;
@@ -1351,7 +1552,8 @@ GoalProblem Goal::Impl::add_up_down_distrosync_to_goal(
     GoalAction action,
     const std::string & spec,
     GoalJobSettings & settings,
-    bool minimal) {
+    bool minimal,
+    ResolvedSpec * resolved_spec) {
     // Get values before the first report to set in GoalJobSettings used values
     bool best = settings.resolve_best(base->get_config());
     bool skip_broken = action == GoalAction::UPGRADE ? true : settings.resolve_skip_broken(base->get_config());
@@ -1362,8 +1564,8 @@ GoalProblem Goal::Impl::add_up_down_distrosync_to_goal(
     rpm::PackageQuery base_query(base);
     auto obsoletes = base->get_config().get_obsoletes_option().get_value();
     libdnf5::solv::IdQueue tmp_queue;
-    rpm::PackageQuery query(base_query);
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    rpm::PackageQuery query = resolved_spec ? std::move(resolved_spec->second) : rpm::PackageQuery(base_query);
+    auto nevra_pair = resolved_spec ? std::move(resolved_spec->first) : query.resolve_pkg_spec(spec, settings, false);
     if (!nevra_pair.first) {
         auto problem = transaction.p_impl->report_not_found(action, spec, settings, libdnf5::Logger::Level::WARNING);
         return skip_unavailable ? GoalProblem::NO_PROBLEM : problem;
@@ -1540,7 +1742,12 @@ GoalProblem Goal::Impl::add_up_down_distrosync_to_goal(
     return GoalProblem::NO_PROBLEM;
 }
 
-void Goal::Impl::install_group_package(base::Transaction & transaction, libdnf5::comps::Package pkg) {
+void Goal::Impl::install_group_packages(
+    base::Transaction & transaction, const std::vector<libdnf5::comps::Package> & group_packages) {
+    if (group_packages.empty()) {
+        return;
+    }
+
     auto pkg_settings = GoalJobSettings();
     pkg_settings.with_provides = false;
     pkg_settings.with_filenames = false;
@@ -1548,25 +1755,63 @@ void Goal::Impl::install_group_package(base::Transaction & transaction, libdnf5:
     pkg_settings.nevra_forms.push_back(rpm::Nevra::Form::NAME);
 
     // TODO(mblaha): apply pkg.basearchonly when available in comps
-    auto pkg_name = pkg.get_name();
-    auto pkg_condition = pkg.get_condition();
-    if (pkg_condition.empty()) {
-        auto [pkg_problem, pkg_queue] =
-            // TODO(mblaha): add_install_to_goal needs group spec for better problems reporting
-            add_install_to_goal(transaction, GoalAction::INSTALL_BY_COMPS, pkg_name, pkg_settings);
-        rpm_goal.add_transaction_group_installed(pkg_queue);
-    } else {
-        // check whether condition can even be met
-        rpm::PackageQuery condition_query(base);
-        condition_query.filter_name(std::vector<std::string>{pkg_condition});
-        if (!condition_query.empty()) {
+    std::vector<std::string> pkg_names;
+    std::unordered_set<std::string> unique_pkg_names;
+    std::vector<std::pair<std::string, std::string>> conditional_pkgs;
+    std::set<std::pair<std::string, std::string>> unique_conditional_pkgs;
+    for (const auto & pkg : group_packages) {
+        auto pkg_name = pkg.get_name();
+        auto pkg_condition = pkg.get_condition();
+        if (pkg_condition.empty()) {
+            if (unique_pkg_names.insert(pkg_name).second) {
+                pkg_names.push_back(std::move(pkg_name));
+            }
+        } else if (unique_conditional_pkgs.emplace(pkg_name, pkg_condition).second) {
+            conditional_pkgs.emplace_back(std::move(pkg_name), std::move(pkg_condition));
+        }
+    }
+
+    if (!pkg_names.empty()) {
+        // resolve all the names in a single pass over the packages sorted by name
+        rpm::PackageQuery base_query(base);
+        std::vector<rpm::PackageQuery> queries;
+        auto nevra_pairs = base_query.resolve_pkg_specs(pkg_names, pkg_settings, false, queries);
+        for (std::size_t idx = 0; idx < pkg_names.size(); ++idx) {
+            ResolvedSpec resolved_spec{std::move(nevra_pairs[idx]), std::move(queries[idx])};
+            auto [pkg_problem, pkg_queue] =
+                // TODO(mblaha): add_install_to_goal needs group spec for better problems reporting
+                add_install_to_goal(
+                    transaction, GoalAction::INSTALL_BY_COMPS, pkg_names[idx], pkg_settings, &resolved_spec);
+            rpm_goal.add_transaction_group_installed(pkg_queue);
+        }
+    }
+
+    if (!conditional_pkgs.empty()) {
+        // find the packages of all the conditional packages and their conditions in a single query
+        std::vector<std::string> lookup_names;
+        for (const auto & [pkg_name, pkg_condition] : conditional_pkgs) {
+            lookup_names.push_back(pkg_name);
+            lookup_names.push_back(pkg_condition);
+        }
+        rpm::PackageQuery query(base);
+        query.filter_name(lookup_names);
+        auto & pool = get_rpm_pool(base);
+        std::unordered_map<Id, libdnf5::solv::IdQueue> name_packages;
+        for (auto package_id : *query.p_impl) {
+            name_packages[pool.id2solvable(package_id)->name].push_back(package_id);
+        }
+
+        for (const auto & [pkg_name, pkg_condition] : conditional_pkgs) {
+            // check whether condition can even be met
+            if (!name_packages.contains(pool.str2id(pkg_condition.c_str(), false))) {
+                continue;
+            }
             // remember names to identify GROUP reason of conditional packages
-            rpm::PackageQuery query(base);
-            query.filter_name(std::vector<std::string>{pkg_name});
-            // TODO(mblaha): log absence of pkg in case the query is empty
-            if (!query.empty()) {
+            auto pkg_packages = name_packages.find(pool.str2id(pkg_name.c_str(), false));
+            // TODO(mblaha): log absence of pkg in case there are no packages of the name
+            if (pkg_packages != name_packages.end()) {
                 add_provide_install_to_goal(fmt::format("({} if {})", pkg_name, pkg_condition), pkg_settings);
-                rpm_goal.add_transaction_group_installed(*query.p_impl);
+                rpm_goal.add_transaction_group_installed(pkg_packages->second);
             }
         }
     }
@@ -1608,10 +1853,10 @@ void Goal::Impl::remove_group_packages(const rpm::PackageSet & remove_candidates
 }
 
 void Goal::Impl::add_group_install_to_goal(
-    base::Transaction & transaction,
     const transaction::TransactionItemReason reason,
     comps::GroupQuery group_query,
-    GoalJobSettings & settings) {
+    GoalJobSettings & settings,
+    std::vector<libdnf5::comps::Package> & group_packages) {
     auto & cfg_main = base->get_config();
     auto allowed_package_types = settings.resolve_group_package_types(cfg_main);
     for (auto group : group_query) {
@@ -1619,16 +1864,12 @@ void Goal::Impl::add_group_install_to_goal(
         if (settings.group_no_packages) {
             continue;
         }
-        std::vector<libdnf5::comps::Package> packages;
         // TODO(mblaha): filter packages by p.arch attribute when supported by comps
-        for (const auto & p : group.get_packages()) {
+        for (auto & p : group.get_packages()) {
             if (any(allowed_package_types & p.get_type())) {
-                packages.emplace_back(std::move(p));
+                group_packages.emplace_back(std::move(p));
             }
         }
-        for (const auto & pkg : packages) {
-            install_group_package(transaction, pkg);
-        }
     }
 }
 
@@ -1702,6 +1943,7 @@ void Goal::Impl::add_group_upgrade_to_goal(
     rpm::PackageQuery query_installed(base);
     query_installed.filter_installed();
     rpm::PackageSet remove_candidates(base);
+    std::vector<libdnf5::comps::Package> group_packages;
 
     for (auto installed_group : group_query) {
         auto group_id = installed_group.get_groupid();
@@ -1737,7 +1979,7 @@ void Goal::Impl::add_group_upgrade_to_goal(
         // install packages newly added to the group
         for (const auto & pkg : available_group.get_packages_of_type(state_group.package_types)) {
             if (!old_set.contains(pkg.get_name())) {
-                install_group_package(transaction, pkg);
+                group_packages.push_back(pkg);
             }
         }
 
@@ -1771,6 +2013,7 @@ void Goal::Impl::add_group_upgrade_to_goal(
             installed_group.get_reason(),
             allowed_package_types);
     }
+    install_group_packages(transaction, group_packages);
     if (!remove_candidates.empty()) {
         remove_group_packages(remove_candidates);
     }
@@ -1970,13 +2213,19 @@ GoalProblem Goal::Impl::add_reason_change_to_goal(
     const std::string & spec,
     const transaction::TransactionItemReason reason,
     const std::optional<std::string> & group_id,
-    GoalJobSettings & settings) {
+    GoalJobSettings & settings,
+    ResolvedSpec * resolved_spec) {
     auto & cfg_main = base->get_config();
     bool skip_unavailable = settings.resolve_skip_unavailable(cfg_main);
     auto log_level = skip_unavailable ? libdnf5::Logger::Level::WARNING : libdnf5::Logger::Level::ERROR;
-    rpm::PackageQuery query(base);
-    query.filter_installed();
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    rpm::PackageQuery query = resolved_spec ? std::move(resolved_spec->second) : rpm::PackageQuery(base);
+    std::pair<bool, libdnf5::rpm::Nevra> nevra_pair;
+    if (resolved_spec) {
+        nevra_pair = std::move(resolved_spec->first);
+    } else {
+        query.filter_installed();
+        nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    }
     if (!nevra_pair.first) {
         auto problem = transaction.p_impl->report_not_found(GoalAction::REASON_CHANGE, spec, settings, log_level);
         if (skip_unavailable) {
@@ -2040,82 +2289,117 @@ void Goal::Impl::set_exclude_from_weak(const std::vector<std::string> & exclude_
 }
 
 void Goal::Impl::autodetect_unsatisfied_installed_weak_dependencies() {
-    rpm::PackageQuery installed_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-    installed_query.filter_installed();
-    if (installed_query.empty()) {
+    // The result depends only on the installed packages, the packages in the pool and the considered map.
+    // Changes of the pool and of the considered map drop the cached result.
+    auto & sack = *base->get_rpm_package_sack()->p_impl;
+    if (const auto * cached_excludes = sack.get_cached_weak_excludes()) {
+        if (!cached_excludes->empty()) {
+            rpm_goal.add_exclude_from_weak(*cached_excludes);
+        }
         return;
     }
-    rpm::PackageQuery base_query(base, rpm::PackageQuery::ExcludeFlags::APPLY_EXCLUDES);
-    rpm::ReldepList reldep_list(base);
 
-    std::vector<std::string> installed_names;
-    installed_names.reserve(installed_query.size());
+    auto & spool = get_rpm_pool(base);
+    ::Pool * pool = *spool;
+    libdnf5::solv::SolvMap excludes(spool.get_nsolvables());
+    ::Repo * installed = pool->installed;
+    if (!installed || installed->nsolvables == 0) {
+        sack.set_cached_weak_excludes(std::move(excludes));
+        return;
+    }
 
-    // Investigate uninstalled recommends of installed packages
-    for (const auto & pkg : installed_query) {
-        installed_names.push_back(pkg.get_name());
-        for (const auto & recommend : pkg.get_recommends()) {
-            if (libdnf5::rpm::Reldep::is_rich_dependency(recommend.to_string())) {
+    rpm::PackageQuery base_query(base, rpm::PackageQuery::ExcludeFlags::APPLY_EXCLUDES);
+    const auto & considered = *base_query.p_impl;
+    // The system repo also contains the solvables of the installed comps, only packages are investigated
+    const auto & packages = sack.get_solvables();
+    sack.make_provides_ready();
+
+    std::unordered_set<Id> installed_names;
+    std::unordered_set<Id> investigated_recommends;
+    libdnf5::solv::IdQueue deps;
+    Id p;
+    Id pp;
+
+    // Investigate uninstalled recommends of installed packages, each distinct recommend is investigated once
+    Id id;
+    Solvable * solvable;
+    FOR_REPO_SOLVABLES(installed, id, solvable) {
+        if (!packages.contains_unsafe(id)) {
+            continue;
+        }
+        installed_names.insert(solvable->name);
+        ::solvable_lookup_deparray(solvable, SOLVABLE_RECOMMENDS, &deps.get_queue(), 0);
+        for (Id recommend : deps) {
+            if (is_rich_dependency(pool, recommend)) {
                 // Rich dependencies are skipped because they are too complicated to provide correct result
                 continue;
-            };
-            rpm::PackageQuery query(base_query);
-
+            }
             //  There can be installed provider in a different version or upgraded package can recommend a different
             //  version therefore ignore the version and to search only using reldep name
-            if (auto version = recommend.get_version(); version && strlen(version) > 0) {
-                auto & pool = get_rpm_pool(base);
-                Id id = pool.str2id(recommend.get_name(), 0);
-                reldep_list.add(rpm::ReldepId(id));
-            } else {
-                reldep_list.add(recommend);
-            };
-            query.filter_provides(reldep_list);
-            reldep_list.clear();
-            // No providers of recommend => continue
-            if (query.empty()) {
+            if (ISRELDEP(recommend)) {
+                auto * reldep = GETRELDEP(pool, recommend);
+                if (reldep->flags <= (REL_GT | REL_EQ | REL_LT)) {
+                    recommend = reldep->name;
+                }
+            }
+            if (!investigated_recommends.insert(recommend).second) {
                 continue;
             }
-            rpm::PackageQuery test_installed(query);
-            test_installed.filter_installed();
+            bool has_provider = false;
+            bool has_installed_provider = false;
+            FOR_PROVIDES(p, pp, recommend) {
+                if (considered.contains_unsafe(p)) {
+                    has_provider = true;
+                    if (spool.id2solvable(p)->repo == installed) {
+                        has_installed_provider = true;
+                        break;
+                    }
+                }
+            }
             // when there is not installed any provider of recommend, exclude it
-            if (test_installed.empty()) {
-                rpm_goal.add_exclude_from_weak(*query.p_impl);
+            if (has_provider && !has_installed_provider) {
+                FOR_PROVIDES(p, pp, recommend) {
+                    if (considered.contains_unsafe(p)) {
+                        excludes.add_unsafe(p);
+                    }
+                }
             }
         }
     }
 
     // Investigate supplements of only available packages with a different name to installed packages
-    // We can use base_query, because it is not useful anymore
-    base_query.filter_name(installed_names, sack::QueryCmp::NEQ);
-    // We have to remove all installed packages from testing set
-    base_query -= installed_query;
-    rpm::PackageSet exclude_supplements(base);
-    for (const auto & pkg : base_query) {
-        auto supplements = pkg.get_supplements();
-        if (supplements.empty()) {
+    std::unordered_map<Id, bool> installed_supplements;
+    for (Id available_id : considered) {
+        Solvable * available = spool.id2solvable(available_id);
+        if (available->repo == installed || installed_names.contains(available->name)) {
             continue;
         }
-        for (const auto & supplement : supplements) {
-            if (libdnf5::rpm::Reldep::is_rich_dependency(supplement.to_string())) {
+        ::solvable_lookup_deparray(available, SOLVABLE_SUPPLEMENTS, &deps.get_queue(), 0);
+        for (Id supplement : deps) {
+            if (is_rich_dependency(pool, supplement)) {
                 // Rich dependencies are skipped because they are too complicated to provide correct result
                 continue;
-            };
-            reldep_list.add(supplement);
-        }
-        if (reldep_list.empty()) {
-            continue;
-        }
-        rpm::PackageQuery query(installed_query);
-        query.filter_provides(reldep_list);
-        reldep_list.clear();
-        if (!query.empty()) {
-            exclude_supplements.add(pkg);
+            }
+            auto [it, inserted] = installed_supplements.try_emplace(supplement, false);
+            if (inserted) {
+                FOR_PROVIDES(p, pp, supplement) {
+                    if (spool.id2solvable(p)->repo == installed && packages.contains_unsafe(p)) {
+                        it->second = true;
+                        break;
+                    }
+                }
+            }
+            if (it->second) {
+                excludes.add_unsafe(available_id);
+                break;
+            }
         }
     }
-    if (!exclude_supplements.empty()) {
-        rpm_goal.add_exclude_from_weak(*exclude_supplements.p_impl);
+
+    if (!excludes.empty()) {
+        rpm_goal.add_exclude_from_weak(excludes);
     }
+    sack.set_cached_weak_excludes(std::move(excludes));
 }
 
 void Goal::set_allow_erasing(bool value) {
@@ -2126,9 +2410,21 @@ bool Goal::get_allow_erasing() const {
     return p_impl->allow_erasing;
 }
 
+void Goal::set_incremental(bool value) {
+    p_impl->incremental = value;
+}
+
+bool Goal::get_incremental() const {
+    return p_impl->incremental;
+}
+
 base::Transaction Goal::resolve() {
     libdnf_user_assert(p_impl->base->is_initialized(), "Base instance was not fully initialized by Base::setup()");
 
+    auto & span_recorder = p_impl->base->get_span_recorder();
+    base::SpanRecorder::Scope span(span_recorder, "resolve goal");
+    auto resolve_start = std::chrono::steady_clock::now();
+    p_impl->rpm_goal.set_reuse_solver(p_impl->incremental);
     p_impl->rpm_goal = rpm::solv::GoalPrivate(p_impl->base);
 
     p_impl->add_paths_to_goal();
@@ -2165,6 +2461,7 @@ base::Transaction Goal::resolve() {
     p_impl->add_resolved_group_specs_to_goal(transaction);
 
     ret |= p_impl->add_reason_change_specs_to_goal(transaction);
+    auto goal_setup_start = std::chrono::steady_clock::now();
 
     auto & cfg_main = p_impl->base->get_config();
     // Set goal flags
@@ -2191,12 +2488,19 @@ base::Transaction Goal::resolve() {
         p_impl->rpm_goal.set_user_installed_packages(std::move(user_installed_packages));
     }
 
-    // Add protected packages
+    // Add protected packages, the packages matching the option are resolved again only when the packages
+    // in the pool change
     {
         auto & protected_packages = cfg_main.get_protected_packages_option().get_value();
-        rpm::PackageQuery protected_query(p_impl->base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-        protected_query.filter_name(protected_packages);
-        p_impl->rpm_goal.add_protected_packages(*protected_query.p_impl);
+        const auto * protected_map = sack->p_impl->get_cached_protected_packages(protected_packages);
+        if (!protected_map) {
+            rpm::PackageQuery protected_query(p_impl->base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+            protected_query.filter_name(protected_packages);
+            sack->p_impl->set_cached_protected_packages(
+                libdnf5::solv::SolvMap(*protected_query.p_impl), protected_packages);
+            protected_map = sack->p_impl->get_cached_protected_packages(protected_packages);
+        }
+        p_impl->rpm_goal.add_protected_packages(*protected_map);
     }
 
     // Set installonly packages
@@ -2214,7 +2518,19 @@ base::Transaction Goal::resolve() {
         }
     }
 
-    ret |= p_impl->rpm_goal.resolve();
+    // The solver debug data cannot be written for a goal resolved from the cache
+    if (cfg_main.get_resolve_cache_option().get_value() && !cfg_main.get_debug_solver_option().get_value()) {
+        p_impl->rpm_goal.set_resolve_cache(&sack->p_impl->get_resolve_cache());
+    }
+
+    auto goal_setup_end = std::chrono::steady_clock::now();
+    span_recorder.add("spec resolution", {}, resolve_start, goal_setup_start);
+    span_recorder.add("goal setup", {}, goal_setup_start, goal_setup_end);
+
+    {
+        base::SpanRecorder::Scope solve_span(span_recorder, "solve");
+        ret |= p_impl->rpm_goal.resolve();
+    }
 
     // Write debug solver data
     if (cfg_main.get_debug_solver_option().get_value()) {
@@ -2224,7 +2540,10 @@ base::Transaction Goal::resolve() {
         // Ensures the presence of the directory.
         std::filesystem::create_directories(abs_debug_dir);
 
-        p_impl->rpm_goal.write_debugdata(abs_debug_dir);
+        libdnf5::solv::DebugdataOptions debugdata_options;
+        debugdata_options.zstd = cfg_main.get_debugdata_compression_option().get_value() == "zstd";
+        debugdata_options.only_job_closure = cfg_main.get_debugdata_job_closure_option().get_value();
+        p_impl->rpm_goal.write_debugdata(abs_debug_dir, debugdata_options);
 
         transaction.p_impl->add_resolve_log(
             GoalAction::RESOLVE,
@@ -2236,7 +2555,23 @@ base::Transaction Goal::resolve() {
             libdnf5::Logger::Level::WARNING);
     }
 
-    transaction.p_impl->set_transaction(p_impl->rpm_goal, module_sack, ret);
+    {
+        base::SpanRecorder::Scope set_transaction_span(span_recorder, "set transaction");
+        transaction.p_impl->set_transaction(p_impl->rpm_goal, module_sack, ret);
+    }
+
+    auto & resolve_stats = transaction.p_impl->resolve_stats;
+    resolve_stats.spec_resolution =
+        std::chrono::duration_cast<std::chrono::microseconds>(goal_setup_start - resolve_start);
+    resolve_stats.goal_setup = std::chrono::duration_cast<std::chrono::microseconds>(goal_setup_end - goal_setup_start);
+    resolve_stats.total =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - resolve_start);
+
+    if (cfg_main.get_debug_solver_option().get_value()) {
+        auto debug_dir = std::filesystem::path(cfg_main.get_debugdir_option().get_value()) / "packages";
+        std::ofstream stats_file(std::filesystem::absolute(debug_dir) / "resolve_stats.txt");
+        stats_file << resolve_stats.to_string();
+    }
 
     return transaction;
 }
@@ -0,0 +1,50 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/base/resolve_stats.hpp"
+
+#include <fmt/format.h>
+
+
+namespace libdnf5::base {
+
+std::string ResolveStats::to_string() const {
+    auto ms = [](std::chrono::microseconds duration) { return static_cast<double>(duration.count()) / 1000.0; };
+
+    std::string out;
+    out += fmt::format("Spec resolution:  {:10.3f} ms\n", ms(spec_resolution));
+    out += fmt::format("Goal setup:       {:10.3f} ms\n", ms(goal_setup));
+    out += fmt::format("Job construction: {:10.3f} ms\n", ms(job_construction));
+    out += fmt::format("Solver init:      {:10.3f} ms\n", ms(solver_init));
+    out += fmt::format("Solve:            {:10.3f} ms\n", ms(solve));
+    out += fmt::format("Problems:         {:10.3f} ms\n", ms(problems));
+    out += fmt::format("Set transaction:  {:10.3f} ms\n", ms(set_transaction));
+    out += fmt::format("Total:            {:10.3f} ms\n", ms(total));
+    out += fmt::format("Jobs: {}\n", jobs);
+    out += fmt::format("Solver runs: {}\n", solver_runs);
+    out += fmt::format("Decisions: {}\n", decisions);
+    out += fmt::format("Solver problems: {}\n", solver_problems);
+    out += fmt::format("Transaction steps: {}\n", transaction_steps);
+    out += fmt::format("From resolve cache: {}\n", from_resolve_cache ? "yes" : "no");
+    out += fmt::format("Reused solver: {}\n", reused_solver ? "yes" : "no");
+    return out;
+}
+
+}  // namespace libdnf5::base
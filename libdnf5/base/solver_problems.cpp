@@ -25,6 +25,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 #include "libdnf5/utils/format.hpp"
 
+#include <algorithm>
+#include <set>
+#include <tuple>
+
 
 namespace libdnf5::base {
 
@@ -90,26 +94,14 @@ bool is_unique(
     return true;
 }
 
-bool is_unique(
-    const std::vector<std::vector<std::pair<ProblemRules, std::vector<std::string>>>> & problems,
-    const std::vector<std::pair<ProblemRules, std::vector<std::string>>> & new_element) {
-    auto new_element_size = new_element.size();
-    for (auto const & element : problems) {
-        if (element.size() != new_element_size) {
-            continue;
-        }
-        bool identical = true;
-        for (auto & [rule, strings] : element) {
-            if (is_unique(new_element, rule, strings)) {
-                identical = false;
-                break;
-            }
-        }
-        if (identical) {
-            return false;
-        }
-    }
-    return true;
+/// Returns true when `problem` was not inserted to `problem_keys` before. Problems with the same rules in a different
+/// order are identical.
+bool insert_unique_problem(
+    std::set<std::vector<std::pair<ProblemRules, std::vector<std::string>>>> & problem_keys,
+    const std::vector<std::pair<ProblemRules, std::vector<std::string>>> & problem) {
+    auto key = problem;
+    std::sort(key.begin(), key.end());
+    return problem_keys.insert(std::move(key)).second;
 }
 
 std::vector<std::pair<ProblemRules, std::vector<std::string>>> get_removal_of_protected(
@@ -125,7 +117,7 @@ std::vector<std::pair<ProblemRules, std::vector<std::string>>> get_removal_of_pr
         for (auto protected_id : *removal_of_protected) {
             if (protected_id == protected_running_kernel.id) {
                 std::vector<std::string> elements;
-                elements.emplace_back(pool.get_full_nevra(protected_id));
+                elements.emplace_back(pool.get_cached_full_nevra(protected_id));
                 if (is_unique(problem_output, ProblemRules::RULE_PKG_REMOVAL_OF_RUNNING_KERNEL, elements)) {
                     problem_output.push_back(
                         std::make_pair(ProblemRules::RULE_PKG_REMOVAL_OF_RUNNING_KERNEL, std::move(elements)));
@@ -152,7 +144,7 @@ std::vector<std::pair<ProblemRules, std::vector<std::string>>> get_removal_of_pr
     for (auto broken : broken_installed) {
         if (broken == protected_running_kernel.id) {
             std::vector<std::string> elements;
-            elements.emplace_back(pool.get_full_nevra(broken));
+            elements.emplace_back(pool.get_cached_full_nevra(broken));
             if (is_unique(problem_output, ProblemRules::RULE_PKG_REMOVAL_OF_RUNNING_KERNEL, elements)) {
                 problem_output.push_back(
                     std::make_pair(ProblemRules::RULE_PKG_REMOVAL_OF_RUNNING_KERNEL, std::move(elements)));
@@ -275,11 +267,19 @@ std::vector<std::vector<std::pair<libdnf5::ProblemRules, std::vector<std::string
     auto solver_problems = solved_goal.get_problems();
 
     std::vector<std::vector<std::pair<libdnf5::ProblemRules, std::vector<std::string>>>> problems;
+    std::set<std::vector<std::pair<ProblemRules, std::vector<std::string>>>> problem_keys;
 
     for (auto & problem : solver_problems) {
         std::vector<std::pair<ProblemRules, std::vector<std::string>>> problem_output;
+        // libsolv reports the same rule info for many rules of a problem. The duplicates are skipped
+        // by their Ids before they are rendered, the rendered rules are deduplicated by their strings.
+        std::set<std::tuple<ProblemRules, Id, Id, Id>> rule_ids;
+        std::set<std::pair<ProblemRules, std::vector<std::string>>> rule_strings;
 
         for (auto & [rule, source, dep, target, description] : problem) {
+            if (rule != ProblemRules::RULE_UNKNOWN && !rule_ids.emplace(rule, source, dep, target).second) {
+                continue;
+            }
             std::vector<std::string> elements;
             ProblemRules tmp_rule = rule;
             switch (rule) {
@@ -344,17 +344,17 @@ std::vector<std::vector<std::pair<libdnf5::ProblemRules, std::vector<std::string
                     // Rules are not generated by libsolv
                     break;
             }
-            if (is_unique(problem_output, tmp_rule, elements)) {
+            if (rule_strings.emplace(tmp_rule, elements).second) {
                 problem_output.push_back(std::make_pair(tmp_rule, std::move(elements)));
             }
         }
-        if (is_unique(problems, problem_output)) {
+        if (insert_unique_problem(problem_keys, problem_output)) {
             problems.push_back(std::move(problem_output));
         }
     }
     auto problem_protected = get_removal_of_protected(solved_goal, broken_installed);
     if (!problem_protected.empty()) {
-        if (is_unique(problems, problem_protected)) {
+        if (insert_unique_problem(problem_keys, problem_protected)) {
             problems.insert(problems.begin(), std::move(problem_protected));
         }
     }
@@ -0,0 +1,387 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/base/span_recorder.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+
+
+namespace libdnf5::base {
+
+/// Spans recorded by one thread
+struct SpanRecorder::ThreadBuffer {
+    std::thread::id thread_id;
+    /// Taken by the owning thread to add a span and by the readers of the spans, the recording threads do not
+    /// contend for it
+    std::mutex mutex;
+    std::vector<Span> spans;
+};
+
+namespace {
+
+#ifdef WITH_SPAN_RECORDING
+constexpr bool SPAN_RECORDING_SUPPORTED = true;
+#else
+constexpr bool SPAN_RECORDING_SUPPORTED = false;
+#endif
+
+std::atomic<std::uint64_t> next_recorder_id{1};
+
+/// Spans with the same name and detail under the same parent, merged for the summary
+struct SpanNode {
+    std::string label;
+    std::size_t count{0};
+    SpanRecorder::Clock::duration total{0};
+    std::vector<std::size_t> children;
+};
+
+constexpr std::size_t NO_PARENT = static_cast<std::size_t>(-1);
+
+/// Returns the indices of `spans` sorted by start time, the enclosing spans go before the enclosed ones
+std::vector<std::size_t> sorted_span_indices(const std::vector<SpanRecorder::Span> & spans) {
+    std::vector<std::size_t> order(spans.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&spans](std::size_t first, std::size_t second) {
+        if (spans[first].start != spans[second].start) {
+            return spans[first].start < spans[second].start;
+        }
+        return spans[first].end > spans[second].end;
+    });
+    return order;
+}
+
+bool contains(const SpanRecorder::Span & outer, const SpanRecorder::Span & inner) {
+    return outer.start <= inner.start && inner.end <= outer.end;
+}
+
+/// Returns the index of the parent of each span in `spans`, `NO_PARENT` for the top level spans
+std::vector<std::size_t> find_parents(
+    const std::vector<SpanRecorder::Span> & spans,
+    const std::vector<std::size_t> & order,
+    std::thread::id main_thread) {
+    std::vector<std::size_t> parents(spans.size(), NO_PARENT);
+
+    // the innermost containing span of the same thread, the spans of each thread are swept with a stack
+    std::unordered_map<std::thread::id, std::vector<std::size_t>> stacks;
+    std::vector<std::size_t> main_thread_spans;
+    for (auto idx : order) {
+        auto & stack = stacks[spans[idx].thread_id];
+        while (!stack.empty() && !contains(spans[stack.back()], spans[idx])) {
+            stack.pop_back();
+        }
+        if (!stack.empty()) {
+            parents[idx] = stack.back();
+        }
+        stack.push_back(idx);
+        if (spans[idx].thread_id == main_thread) {
+            main_thread_spans.push_back(idx);
+        }
+    }
+
+    // top level spans of the other threads belong to the innermost containing span of the main thread,
+    // it is the containing span that started last
+    for (auto idx : order) {
+        if (parents[idx] != NO_PARENT || spans[idx].thread_id == main_thread) {
+            continue;
+        }
+        for (auto it = main_thread_spans.rbegin(); it != main_thread_spans.rend(); ++it) {
+            if (contains(spans[*it], spans[idx])) {
+                parents[idx] = *it;
+                break;
+            }
+        }
+    }
+
+    return parents;
+}
+
+std::string span_label(const SpanRecorder::Span & span) {
+    return span.detail.empty() ? span.name : fmt::format("{} {}", span.name, span.detail);
+}
+
+void append_node(
+    std::string & out, const std::vector<SpanNode> & nodes, const std::vector<std::size_t> & node_indices, int depth) {
+    for (auto node_idx : node_indices) {
+        const auto & node = nodes[node_idx];
+        auto label = fmt::format("{:{}}{}", "", depth * 2, node.label);
+        auto ms = std::chrono::duration<double, std::milli>(node.total).count();
+        if (node.count > 1) {
+            out += fmt::format("{:<60} {:10.3f} ms ({} times)\n", label, ms, node.count);
+        } else {
+            out += fmt::format("{:<60} {:10.3f} ms\n", label, ms);
+        }
+        append_node(out, nodes, node.children, depth + 1);
+    }
+}
+
+void append_json_string(std::string & out, std::string_view value) {
+    out += '"';
+    for (char ch : value) {
+        switch (ch) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    out += fmt::format("\\u{:04x}", static_cast<unsigned>(ch));
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    out += '"';
+}
+
+}  // namespace
+
+
+SpanRecorder::Scope::Scope(SpanRecorder & recorder, std::string_view name, std::string_view detail) {
+    if (SPAN_RECORDING_SUPPORTED && recorder.is_enabled()) {
+        this->recorder = &recorder;
+        this->name = name;
+        this->detail = detail;
+        start = Clock::now();
+    }
+}
+
+SpanRecorder::Scope::~Scope() {
+    if (recorder) {
+        recorder->add(std::move(name), std::move(detail), start, Clock::now());
+    }
+}
+
+
+SpanRecorder::SpanRecorder() : id(next_recorder_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+SpanRecorder::~SpanRecorder() = default;
+
+
+SpanRecorder::ThreadBuffer & SpanRecorder::get_thread_buffer() {
+    // A thread usually records into a single recorder, the buffer used last is cached
+    thread_local std::uint64_t cached_recorder_id{0};
+    thread_local ThreadBuffer * cached_buffer{nullptr};
+    if (cached_recorder_id == id) {
+        return *cached_buffer;
+    }
+
+    auto thread_id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    auto it = std::find_if(
+        buffers.begin(), buffers.end(), [thread_id](const auto & buffer) { return buffer->thread_id == thread_id; });
+    if (it == buffers.end()) {
+        auto & buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        buffer->thread_id = thread_id;
+        it = std::prev(buffers.end());
+    }
+    cached_recorder_id = id;
+    cached_buffer = it->get();
+    return *cached_buffer;
+}
+
+
+void SpanRecorder::set_enabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    if (enabled) {
+        main_thread_id = std::this_thread::get_id();
+        enabled_time = Clock::now();
+        enabled_system_time = std::chrono::system_clock::now();
+    }
+    this->enabled.store(SPAN_RECORDING_SUPPORTED && enabled, std::memory_order_relaxed);
+}
+
+void SpanRecorder::add(std::string name, std::string detail, Clock::time_point start, Clock::time_point end) {
+    if (!SPAN_RECORDING_SUPPORTED || !is_enabled()) {
+        return;
+    }
+    auto & buffer = get_thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.spans.push_back({std::move(name), std::move(detail), start, end, buffer.thread_id});
+}
+
+std::vector<SpanRecorder::Span> SpanRecorder::get_spans() const {
+    std::vector<Span> spans;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        for (const auto & buffer : buffers) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            spans.insert(spans.end(), buffer->spans.begin(), buffer->spans.end());
+        }
+    }
+    std::stable_sort(spans.begin(), spans.end(), [](const Span & lhs, const Span & rhs) { return lhs.end < rhs.end; });
+    return spans;
+}
+
+void SpanRecorder::clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (auto & buffer : buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->spans.clear();
+    }
+}
+
+std::string SpanRecorder::to_string() const {
+    auto spans = get_spans();
+    std::thread::id main_thread;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        main_thread = main_thread_id;
+    }
+
+    auto order = sorted_span_indices(spans);
+    auto parents = find_parents(spans, order, main_thread);
+
+    // merge the spans into nodes, a parent span is always processed before its children
+    std::vector<SpanNode> nodes;
+    std::vector<std::size_t> top_nodes;
+    std::vector<std::size_t> span_nodes(spans.size(), NO_PARENT);
+    std::map<std::tuple<std::size_t, std::string_view, std::string_view>, std::size_t> node_by_key;
+    for (auto idx : order) {
+        const auto & span = spans[idx];
+        auto parent_node = parents[idx] == NO_PARENT ? NO_PARENT : span_nodes[parents[idx]];
+        auto [it, inserted] = node_by_key.try_emplace({parent_node, span.name, span.detail}, nodes.size());
+        if (inserted) {
+            nodes.push_back({span_label(span), 0, Clock::duration{0}, {}});
+            (parent_node == NO_PARENT ? top_nodes : nodes[parent_node].children).push_back(it->second);
+        }
+        auto & node = nodes[it->second];
+        ++node.count;
+        node.total += span.end - span.start;
+        span_nodes[idx] = it->second;
+    }
+
+    std::string out;
+    append_node(out, nodes, top_nodes, 0);
+    return out;
+}
+
+std::string SpanRecorder::to_chrome_trace() const {
+    auto spans = get_spans();
+
+    Clock::time_point origin = Clock::time_point::max();
+    for (const auto & span : spans) {
+        origin = std::min(origin, span.start);
+    }
+
+    // small thread numbers in the order of the first recorded span
+    std::unordered_map<std::thread::id, std::size_t> thread_numbers;
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    for (auto idx : sorted_span_indices(spans)) {
+        const auto & span = spans[idx];
+        auto tid = thread_numbers.try_emplace(span.thread_id, thread_numbers.size() + 1).first->second;
+        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(span.start - origin).count();
+        auto dur = std::chrono::duration_cast<std::chrono::microseconds>(span.end - span.start).count();
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":";
+        append_json_string(out, span.name);
+        out += fmt::format(",\"cat\":\"libdnf5\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,\"tid\":{}", ts, dur, tid);
+        if (!span.detail.empty()) {
+            out += ",\"args\":{\"detail\":";
+            append_json_string(out, span.detail);
+            out += '}';
+        }
+        out += '}';
+    }
+    out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out;
+}
+
+std::string SpanRecorder::to_otlp_json(std::string_view service_name) const {
+    auto spans = get_spans();
+    std::thread::id main_thread;
+    std::chrono::system_clock::time_point system_origin;
+    Clock::time_point origin;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        main_thread = main_thread_id;
+        system_origin = enabled_system_time;
+        origin = enabled_time;
+    }
+
+    auto order = sorted_span_indices(spans);
+    auto parents = find_parents(spans, order, main_thread);
+
+    auto unix_nano = [system_origin, origin](Clock::time_point time) {
+        auto system_time =
+            system_origin + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - origin);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(system_time.time_since_epoch()).count();
+    };
+
+    // The trace id is random, the span ids are made of a random prefix and the span index, they are never zero
+    std::random_device random;
+    auto trace_id = fmt::format("{:08x}{:08x}{:08x}{:08x}", random(), random(), random(), random());
+    auto span_id_prefix = random();
+    auto span_id = [span_id_prefix](std::size_t idx) { return fmt::format("{:08x}{:08x}", span_id_prefix, idx + 1); };
+
+    // small thread numbers in the order of the first recorded span
+    std::unordered_map<std::thread::id, std::size_t> thread_numbers;
+
+    std::string out = "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":\"service.name\",\"value\":{";
+    out += "\"stringValue\":";
+    append_json_string(out, service_name);
+    out += "}}]},\"scopeSpans\":[{\"scope\":{\"name\":\"libdnf5\"},\"spans\":[";
+    bool first = true;
+    for (auto idx : order) {
+        const auto & span = spans[idx];
+        auto thread_number = thread_numbers.try_emplace(span.thread_id, thread_numbers.size() + 1).first->second;
+        out += first ? "" : ",";
+        first = false;
+        out += fmt::format("{{\"traceId\":\"{}\",\"spanId\":\"{}\"", trace_id, span_id(idx));
+        if (parents[idx] != NO_PARENT) {
+            out += fmt::format(",\"parentSpanId\":\"{}\"", span_id(parents[idx]));
+        }
+        out += ",\"name\":";
+        append_json_string(out, span.name);
+        out += fmt::format(
+            ",\"kind\":1,\"startTimeUnixNano\":\"{}\",\"endTimeUnixNano\":\"{}\"",
+            unix_nano(span.start),
+            unix_nano(span.end));
+        out += fmt::format(
+            ",\"attributes\":[{{\"key\":\"thread.id\",\"value\":{{\"intValue\":\"{}\"}}}}", thread_number);
+        if (!span.detail.empty()) {
+            out += ",{\"key\":\"libdnf5.detail\",\"value\":{\"stringValue\":";
+            append_json_string(out, span.detail);
+            out += "}}";
+        }
+        out += "]}";
+    }
+    out += "]}]}]}\n";
+    return out;
+}
+
+}  // namespace libdnf5::base
@@ -24,11 +24,17 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "module/module_db.hpp"
 #include "module/module_sack_impl.hpp"
 #include "repo/temp_files_memory.hpp"
+#include "rpm/package_reasons.hpp"
 #include "rpm/package_set_impl.hpp"
+#include "rpm/preflight_check.hpp"
+#include "rpm/rpm_signature_private.hpp"
 #include "solv/pool.hpp"
 #include "solver_problems_internal.hpp"
+#include "transaction/db/console_output.hpp"
 #include "transaction_impl.hpp"
+#include "utils/fs/file_batch.hpp"
 #include "utils/locker.hpp"
+#include "utils/on_scope_exit.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf5/base/base.hpp"
@@ -43,11 +49,21 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <fmt/format.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory_resource>
 #include <ranges>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 
 namespace libdnf5::base {
@@ -83,6 +99,10 @@ const std::map<base::ImportRepoKeysResult, BgettextMessage> IMPORT_REPO_KEYS_RES
     {base::ImportRepoKeysResult::IMPORT_FAILED, M_("Public key import failed.")},
 };
 
+// Initial size of the arena of the temporary containers of `Transaction::Impl::set_transaction()` on the stack,
+// it covers transactions of several hundreds of packages without a heap allocation
+constexpr std::size_t SET_TRANSACTION_ARENA_INITIAL_SIZE = 32 * 1024;
+
 }  // namespace
 
 Transaction::Transaction(const BaseWeakPtr & base) : p_impl(new Impl(*this, base)) {}
@@ -112,13 +132,17 @@ Transaction::Impl::Impl(Transaction & transaction, const Impl & src)
       problems(src.problems),
       rpm_signature(src.rpm_signature),
       packages(src.packages),
+      package_index(src.package_index),
       groups(src.groups),
       environments(src.environments),
       modules(src.modules),
       module_db(src.module_db),
       resolve_logs(src.resolve_logs),
       transaction_problems(src.transaction_problems),
-      signature_problems(src.signature_problems) {}
+      signature_problems(src.signature_problems),
+      verified_package_files(src.verified_package_files),
+      tested_check_key(src.tested_check_key),
+      resolve_stats(src.resolve_stats) {}
 
 Transaction::Impl & Transaction::Impl::operator=(const Impl & other) {
     base = other.base;
@@ -126,6 +150,7 @@ Transaction::Impl & Transaction::Impl::operator=(const Impl & other) {
     problems = other.problems;
     rpm_signature = other.rpm_signature;
     packages = other.packages;
+    package_index = other.package_index;
     groups = other.groups;
     environments = other.environments;
     modules = other.modules;
@@ -133,6 +158,9 @@ Transaction::Impl & Transaction::Impl::operator=(const Impl & other) {
     resolve_logs = other.resolve_logs;
     transaction_problems = other.transaction_problems;
     signature_problems = other.signature_problems;
+    verified_package_files = other.verified_package_files;
+    tested_check_key = other.tested_check_key;
+    resolve_stats = other.resolve_stats;
     return *this;
 }
 
@@ -144,6 +172,15 @@ std::vector<TransactionPackage> Transaction::get_transaction_packages() const {
     return p_impl->packages;
 }
 
+std::span<const TransactionPackage> Transaction::get_transaction_packages_view() const {
+    return p_impl->packages;
+}
+
+const TransactionPackage * Transaction::get_transaction_package(const rpm::PackageId & package_id) const {
+    auto it = p_impl->package_index.find(package_id.id);
+    return it != p_impl->package_index.end() ? &p_impl->packages[it->second] : nullptr;
+}
+
 std::size_t Transaction::get_transaction_packages_count() const {
     return p_impl->packages.size();
 }
@@ -276,6 +313,10 @@ const std::vector<LogEvent> & Transaction::get_resolve_logs() const {
     return p_impl->resolve_logs;
 }
 
+const ResolveStats & Transaction::get_resolve_stats() const {
+    return p_impl->resolve_stats;
+}
+
 std::vector<std::string> Transaction::get_resolve_logs_as_strings() const {
     std::vector<std::string> logs;
     for (const auto & log : get_resolve_logs()) {
@@ -301,14 +342,50 @@ std::string Transaction::transaction_result_to_string(const TransactionRunResult
 }
 
 void Transaction::download() {
+    SpanRecorder::Scope span(p_impl->base->get_span_recorder(), "download packages");
     libdnf5::repo::PackageDownloader downloader(p_impl->base);
-    for (auto & tspkg : this->get_transaction_packages()) {
+    for (const auto & tspkg : p_impl->packages) {
         if (transaction_item_action_is_inbound(tspkg.get_action()) &&
             tspkg.get_package().get_repo()->get_type() != libdnf5::repo::Repo::Type::COMMANDLINE) {
             downloader.add(tspkg.get_package());
         }
     }
-    downloader.download();
+
+    // The dependencies and disk space of the transaction are checked from the metadata during the download
+    std::optional<libdnf5::rpm::PreflightCheck> preflight_check;
+    if (p_impl->base->get_config().get_preflight_check_option().get_value()) {
+        preflight_check.emplace(p_impl->base);
+        preflight_check->start(p_impl->packages);
+    }
+
+    auto download_start = std::chrono::steady_clock::now();
+    if (!p_impl->base->get_config().get_gpgcheck_during_download_option().get_value()) {
+        downloader.download();
+    } else {
+        // The signatures of the downloaded packages are checked while the other packages are being downloaded.
+        // The package paths are obtained in this thread, the worker thread does not access the package pool.
+        libdnf5::rpm::SignatureCheckWorker signature_check_worker(p_impl->base);
+        downloader.set_package_downloaded_callback([&signature_check_worker](const libdnf5::rpm::Package & package) {
+            if (libdnf5::rpm::is_signature_check_required(package)) {
+                signature_check_worker.add(package.get_package_path());
+            }
+        });
+        downloader.download();
+        p_impl->verified_package_files.merge(signature_check_worker.finish());
+    }
+
+    if (preflight_check) {
+        preflight_check->finish();
+    }
+
+    if (auto downloaded_bytes = downloader.get_downloaded_bytes(); downloaded_bytes > 0) {
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - download_start;
+        p_impl->base->get_logger()->info(
+            "Downloaded {} bytes of packages in {:.2f} s, throughput {:.0f} bytes/s",
+            downloaded_bytes,
+            duration.count(),
+            static_cast<double>(downloaded_bytes) / std::max(duration.count(), 0.001));
+    }
 }
 
 Transaction::TransactionRunResult Transaction::test() {
@@ -349,6 +426,8 @@ std::vector<std::string> Transaction::get_gpg_signature_problems() const noexcep
 
 void Transaction::Impl::set_transaction(
     rpm::solv::GoalPrivate & solved_goal, module::ModuleSack & module_sack, GoalProblem problems) {
+    resolve_stats = solved_goal.get_resolve_stats();
+    auto problems_start = std::chrono::steady_clock::now();
     auto solver_problems = process_solver_problems(base, solved_goal);
     if (!solver_problems.empty()) {
         add_resolve_log(GoalProblem::SOLVER_ERROR, solver_problems);
@@ -362,7 +441,16 @@ void Transaction::Impl::set_transaction(
         if (!solver_problems_strict.empty()) {
             add_resolve_log(GoalProblem::SOLVER_PROBLEM_STRICT_RESOLVEMENT, solver_problems_strict);
         }
+        resolve_stats.solver_runs += solved_goal_copy.get_resolve_stats().solver_runs;
     }
+    auto set_transaction_start = std::chrono::steady_clock::now();
+    resolve_stats.problems =
+        std::chrono::duration_cast<std::chrono::microseconds>(set_transaction_start - problems_start);
+    utils::OnScopeExit record_set_transaction_time([&]() noexcept {
+        resolve_stats.set_transaction = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - set_transaction_start);
+    });
+
     this->problems = problems;
     auto transaction = solved_goal.get_transaction();
     libsolv_transaction = transaction ? transaction_create_clone(transaction) : nullptr;
@@ -370,35 +458,41 @@ void Transaction::Impl::set_transaction(
         return;
     }
 
-    // std::map<replaced, replaced_by>
-    std::map<Id, std::vector<Id>> replaced;
+    // The temporary containers are allocated from one arena, which is released at once when the transaction is set
+    std::array<std::byte, SET_TRANSACTION_ARENA_INITIAL_SIZE> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena(arena_buffer.data(), arena_buffer.size());
 
-    rpm::PackageQuery installed_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-    installed_query.filter_installed();
+    // std::map<replaced, replaced_by>
+    std::pmr::map<Id, std::pmr::vector<Id>> replaced(&arena);
 
-    // The order of packages in the vector matters, we rely on outbound actions
-    // being at the end in Transaction::Impl::run()
-    for (auto id : solved_goal.list_installs()) {
-        packages.emplace_back(
-            make_transaction_package(id, TransactionPackage::Action::INSTALL, solved_goal, replaced, installed_query));
-    }
+    auto installs = solved_goal.list_installs();
+    auto reinstalls = solved_goal.list_reinstalls();
+    auto upgrades = solved_goal.list_upgrades();
+    auto downgrades = solved_goal.list_downgrades();
+    auto removes = solved_goal.list_removes();
 
-    for (auto id : solved_goal.list_reinstalls()) {
-        packages.emplace_back(make_transaction_package(
-            id, TransactionPackage::Action::REINSTALL, solved_goal, replaced, installed_query));
-    }
+    // The reasons of all the packages are resolved by the names and arches of the installed packages collected
+    // once, instead of querying the installed packages for each package
+    rpm::PackageReasons reasons(base, &arena);
 
-    for (auto id : solved_goal.list_upgrades()) {
-        packages.emplace_back(
-            make_transaction_package(id, TransactionPackage::Action::UPGRADE, solved_goal, replaced, installed_query));
-    }
+    auto inbound_count = installs.size() + reinstalls.size() + upgrades.size() + downgrades.size();
+    packages.reserve(packages.size() + static_cast<std::size_t>(inbound_count + removes.size()));
+    libdnf5::solv::IdQueue obsoletes;
 
-    for (auto id : solved_goal.list_downgrades()) {
-        packages.emplace_back(make_transaction_package(
-            id, TransactionPackage::Action::DOWNGRADE, solved_goal, replaced, installed_query));
+    // The order of packages in the vector matters, we rely on outbound actions
+    // being at the end in Transaction::Impl::run()
+    for (auto [action, ids] :
+         {std::pair{TransactionPackage::Action::INSTALL, &installs},
+          std::pair{TransactionPackage::Action::REINSTALL, &reinstalls},
+          std::pair{TransactionPackage::Action::UPGRADE, &upgrades},
+          std::pair{TransactionPackage::Action::DOWNGRADE, &downgrades}}) {
+        for (auto id : *ids) {
+            packages.emplace_back(
+                make_transaction_package(id, action, solved_goal, replaced, reasons, obsoletes));
+        }
     }
 
-    for (auto id : solved_goal.list_removes()) {
+    for (auto id : removes) {
         packages.emplace_back(TransactionPackage(
             rpm::Package(base, rpm::PackageId(id)), TransactionPackage::Action::REMOVE, solved_goal.get_reason(id)));
     }
@@ -406,7 +500,7 @@ void Transaction::Impl::set_transaction(
     // Add replaced packages to transaction
     for (const auto & [replaced_id, replaced_by_ids] : replaced) {
         rpm::Package obsoleted(base, rpm::PackageId(replaced_id));
-        TransactionPackage tspkg(obsoleted, TransactionPackage::Action::REPLACED, obsoleted.get_reason());
+        TransactionPackage tspkg(obsoleted, TransactionPackage::Action::REPLACED, reasons.get_reason(replaced_id));
         for (auto id : replaced_by_ids) {
             tspkg.replaced_by.emplace_back(rpm::Package(base, rpm::PackageId(id)));
         }
@@ -448,6 +542,11 @@ void Transaction::Impl::set_transaction(
         TransactionPackage tspkg(pkg, TransactionPackage::Action::REASON_CHANGE, reason, group_id);
         packages.emplace_back(std::move(tspkg));
     }
+
+    package_index.reserve(packages.size());
+    for (std::size_t idx = 0; idx < packages.size(); ++idx) {
+        package_index.try_emplace(packages[idx].get_package().get_id().id, idx);
+    }
 }
 
 
@@ -455,36 +554,35 @@ TransactionPackage Transaction::Impl::make_transaction_package(
     Id id,
     TransactionPackage::Action action,
     rpm::solv::GoalPrivate & solved_goal,
-    std::map<Id, std::vector<Id>> & replaced,
-    rpm::PackageQuery installed_query) {
-    auto obs = solved_goal.list_obsoleted_by_package(id);
+    std::pmr::map<Id, std::pmr::vector<Id>> & replaced,
+    rpm::PackageReasons & reasons,
+    libdnf5::solv::IdQueue & obsoletes) {
+    solved_goal.list_obsoleted_by_package(id, obsoletes);
 
     rpm::Package new_package(base, rpm::PackageId(id));
 
     transaction::TransactionItemReason reason;
     if (action == TransactionPackage::Action::INSTALL) {
-        reason = std::max(new_package.get_reason(), solved_goal.get_reason(id));
-
-        installed_query.filter_name({new_package.get_name()});
-        installed_query.filter_arch({new_package.get_arch()});
+        reason = std::max(reasons.get_reason(id), solved_goal.get_reason(id));
         // For installonly packages: if the NA is already on the system, but
         // not recorded in system state as installed, it was installed outside
         // DNF and we want to preserve NONE as reason
         // TODO(lukash) this is still required even with having EXTERNAL_USER
         // as a reason, because with --best the reason returned from the goal
         // is USER, which is wrong here
-        if (!installed_query.empty() && new_package.get_reason() == transaction::TransactionItemReason::EXTERNAL_USER) {
+        if (reasons.get_reason(id) == transaction::TransactionItemReason::EXTERNAL_USER) {
             reason = transaction::TransactionItemReason::EXTERNAL_USER;
         }
     } else {
-        reason = new_package.get_reason();
+        reason = reasons.get_reason(id);
     }
 
     TransactionPackage tspkg(new_package, action, reason);
 
-    for (auto replaced_id : obs) {
+    tspkg.replaces.reserve(static_cast<std::size_t>(obsoletes.size()));
+    for (auto replaced_id : obsoletes) {
         rpm::Package replaced_pkg(base, rpm::PackageId(replaced_id));
-        reason = std::max(reason, replaced_pkg.get_reason());
+        reason = std::max(reason, reasons.get_reason(replaced_id));
         tspkg.replaces.emplace_back(std::move(replaced_pkg));
         replaced[replaced_id].push_back(id);
     }
@@ -493,30 +591,48 @@ TransactionPackage Transaction::Impl::make_transaction_package(
     return tspkg;
 }
 
-// Reads the output of scriptlets from the file descriptor and processes them.
-static void process_scriptlets_output(int fd, Logger * logger) {
+// Reads the output of scriptlets from the file descriptor, logs it line by line and passes it to the `output`
+// compressor, so the output is compressed for the history database while the rpm transaction runs.
+// The pipe is read in large chunks appended to a buffer, the lines are logged as views into it
+// and a line split between two reads is logged once complete. Only the incomplete line stays in the buffer.
+static void process_scriptlets_output(int fd, Logger * logger, libdnf5::transaction::ConsoleOutputCompressor & output) {
+    constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
     try {
-        char buf[512];
+        std::string buffer;
+        std::string_view::size_type line_start = 0;
+        auto log_lines = [&buffer, &line_start, logger](bool flush) {
+            std::string_view str(buffer);
+            for (auto end = str.find('\n', line_start); end != std::string_view::npos;
+                 end = str.find('\n', line_start)) {
+                logger->info("[scriptlet] {}", str.substr(line_start, end - line_start));
+                line_start = end + 1;
+            }
+            if (flush && line_start < str.size()) {
+                logger->info("[scriptlet] {}", str.substr(line_start));
+                line_start = str.size();
+            }
+        };
         do {
-            auto len = read(fd, buf, sizeof(buf));
+            auto old_size = buffer.size();
+            buffer.resize(old_size + READ_CHUNK_SIZE);
+            auto len = read(fd, buffer.data() + old_size, READ_CHUNK_SIZE);
+            buffer.resize(old_size + static_cast<std::size_t>(std::max<ssize_t>(len, 0)));
             if (len > 0) {
-                std::string_view str(buf, static_cast<size_t>(len));
-                std::string_view::size_type start = 0;
-                do {
-                    auto end = str.find('\n', start);
-                    logger->info("[scriptlet] {}", str.substr(start, end - start));
-                    if (end == std::string_view::npos) {
-                        break;
-                    }
-                    start = end + 1;
-                } while (start < str.size());
+                output.append(std::string_view(buffer).substr(old_size));
+                log_lines(false);
+                buffer.erase(0, line_start);
+                line_start = 0;
             } else {
                 if (len == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
                     logger->error("Transaction::Run: Cannot read scriptlet output from pipe: {}", std::strerror(errno));
                 }
                 break;
             }
         } while (true);
+        log_lines(true);
     } catch (const std::exception & ex) {
         // The thread must not throw exceptions.
         logger->error("Transaction::Run: Exception while processing scriptlet output: {}", ex.what());
@@ -558,6 +674,10 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
 
     auto & config = base->get_config();
 
+    // Each phase replaces the span of the previous one
+    std::optional<SpanRecorder::Scope> phase_span;
+    phase_span.emplace(base->get_span_recorder(), "lock rpm transaction");
+
     // acquire the lock
     std::filesystem::path lock_file_path = config.get_installroot_option().get_value();
     lock_file_path /= "run/dnf/rpmtransaction.lock";
@@ -569,9 +689,14 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     }
 
     // fill and check the rpm transaction
+    phase_span.emplace(base->get_span_recorder(), "check rpm transaction");
     libdnf5::rpm::Transaction rpm_transaction(base);
     rpm_transaction.fill(*transaction);
-    if (!rpm_transaction.check()) {
+    // The check of a previous test run is not repeated while the rpm database and the filled transaction set are
+    // unchanged. Only the result is reused, every run fills a new rpm transaction.
+    auto check_key = rpm_transaction.get_db_cookie() + '\n' + rpm_transaction.get_elements_key();
+    bool check_passed = tested_check_key && *tested_check_key == check_key;
+    if (!check_passed && !rpm_transaction.check()) {
         for (auto it : rpm_transaction.get_problems()) {
             transaction_problems.emplace_back(it.to_string());
         }
@@ -600,6 +725,7 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     }
 
     // Run rpm transaction test
+    phase_span.emplace(base->get_span_recorder(), "test rpm transaction");
     rpm_transaction.set_flags(rpm_transaction_flags | RPMTRANS_FLAG_TEST);
     //TODO(jrohel): Do we want callbacks for transaction test?
     //rpm_transaction.set_callbacks(std::move(callbacks));
@@ -613,9 +739,11 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
 
     // With RPMTRANS_FLAG_TEST return just before anything is stored permanently
     if (test_only || rpm_transaction_flags & RPMTRANS_FLAG_TEST) {
+        tested_check_key = std::move(check_key);
         return TransactionRunResult::SUCCESS;
     }
 
+    phase_span.emplace(base->get_span_recorder(), "pre transaction");
     auto & plugins = base->p_impl->get_plugins();
     plugins.pre_transaction(*transaction);
 
@@ -698,7 +826,9 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     }
 
     // This thread processes the output of RPM scriptlets.
-    std::thread thread_processes_scriptlets_output(process_scriptlets_output, pipe_out_from_scriptlets[0], logger);
+    libdnf5::transaction::ConsoleOutputCompressor scriptlets_output;
+    std::thread thread_processes_scriptlets_output(
+        process_scriptlets_output, pipe_out_from_scriptlets[0], logger, std::ref(scriptlets_output));
 
     // Set file descriptor for output of scriptlets in transaction.
     rpm_transaction.set_script_out_fd(pipe_out_from_scriptlets[1]);
@@ -708,7 +838,8 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     rpm_transaction.set_callbacks(std::move(callbacks));
     rpm_transaction.set_flags(rpm_transaction_flags);
 
-    // execute rpm transaction
+    // execute rpm transaction, its steps are recorded by the rpm transaction
+    phase_span.reset();
     ret = rpm_transaction.run();
 
     // Reset/close file descriptor for output of RPM scriptlets. Required to end thread_processes_scriptlets_output.
@@ -716,6 +847,8 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
 
     thread_processes_scriptlets_output.join();
 
+    phase_span.emplace(base->get_span_recorder(), "post transaction");
+
     // TODO(mblaha): Handle ret == -1 and ret > 0, fill problems list
 
     if (ret == 0) {
@@ -725,6 +858,8 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
         rpm::PackageQuery installed_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
         installed_query.filter_installed();
         std::set<std::string> inbound_packages_reason_group{};
+        // The packages whose reason changes to GROUP by the group id, each group state is updated only once
+        std::map<std::string, std::vector<std::string>> reason_change_group_packages;
 
         // Iterate in reverse, inbound actions are first in the vector, we want to process outbound first
         for (auto it = packages.rbegin(); it != packages.rend(); ++it) {
@@ -771,19 +906,23 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
                 system_state.remove_package_nevra_state(pkg.get_nevra());
             } else if (tspkg.get_action() == TransactionPackage::Action::REASON_CHANGE) {
                 if (tspkg_reason == transaction::TransactionItemReason::GROUP) {
-                    auto group_id = *tspkg.get_reason_change_group_id();
-                    auto state = system_state.get_group_state(group_id);
-                    state.packages.emplace_back(pkg.get_name());
-                    system_state.set_group_state(group_id, state);
+                    reason_change_group_packages[*tspkg.get_reason_change_group_id()].push_back(pkg.get_name());
                 } else {
                     system_state.set_package_reason(pkg.get_na(), tspkg_reason);
                 }
             }
         }
 
+        for (auto & [group_id, package_names] : reason_change_group_packages) {
+            auto state = system_state.get_group_state(group_id);
+            state.packages.insert(state.packages.end(), package_names.begin(), package_names.end());
+            system_state.set_group_state(group_id, state);
+        }
+
         // Set correct system state for groups in the transaction
+        // The xml definitions of the installed groups and environments are written together after the loops
         auto comps_xml_dir = system_state.get_group_xml_dir();
-        std::filesystem::create_directories(comps_xml_dir);
+        libdnf5::utils::fs::FileBatch comps_xml_batch(comps_xml_dir);
         for (const auto & tsgroup : groups) {
             auto group = tsgroup.get_group();
             auto group_xml_path = comps_xml_dir / (group.get_groupid() + ".xml");
@@ -809,7 +948,7 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
                 }
                 system_state.set_group_state(group.get_groupid(), state);
                 // save the current xml group definition
-                group.serialize(group_xml_path);
+                comps_xml_batch.write(group.get_groupid() + ".xml", group.serialize());
             } else {
                 // delete system state data for removed groups
                 system_state.remove_group_state(group.get_groupid());
@@ -836,7 +975,7 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
                 }
                 system_state.set_environment_state(environment.get_environmentid(), state);
                 // save the current xml group definition
-                environment.serialize(environment_xml_path);
+                comps_xml_batch.write(environment.get_environmentid() + ".xml", environment.serialize());
             } else {
                 // delete system state data for removed groups
                 system_state.remove_environment_state(environment.get_environmentid());
@@ -851,6 +990,8 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
             }
         }
 
+        comps_xml_batch.flush();
+
         system_state.set_rpmdb_cookie(rpm_transaction.get_db_cookie());
 
         system_state.save();
@@ -862,6 +1003,8 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     // TODO(jrohel): Also save the rpm db cookie to system state.
     //               Possibility to detect rpm database change without the need for a history database.
     db_transaction.set_rpmdb_version_end(rpm_transaction.get_db_cookie());
+    db_transaction.set_timings(std::vector(rpm_transaction.get_timings()));
+    db_transaction.set_console_output_chunks(scriptlets_output.finish());
     db_transaction.finish(
         ret == 0 ? libdnf5::transaction::TransactionState::OK : libdnf5::transaction::TransactionState::ERROR);
 
@@ -870,17 +1013,10 @@ Transaction::TransactionRunResult Transaction::Impl::_run(
     if (ret == 0) {
         // removes any temporarily stored packages from the system
         libdnf5::repo::TempFilesMemory temp_files_memory(config.get_cachedir_option().get_value());
-        auto temp_files = temp_files_memory.get_files();
-        for (auto & file : temp_files) {
-            try {
-                if (!std::filesystem::remove(file)) {
-                    logger->debug("Temporary file \"{}\" doesn't exist.", file);
-                }
-            } catch (const std::filesystem::filesystem_error & ex) {
-                logger->debug("An error occurred when trying to remove a temporary file \"{}\": {}", file, ex.what());
-            }
+        for (const auto & [file, error] : temp_files_memory.remove_files()) {
+            logger->debug(
+                "An error occurred when trying to remove a temporary file \"{}\": {}", file, error.message());
         }
-        temp_files_memory.clear();
 
         return TransactionRunResult::SUCCESS;
     } else {
@@ -961,21 +1097,65 @@ ImportRepoKeysResult Transaction::Impl::import_repo_keys(libdnf5::repo::Repo & r
 }
 
 bool Transaction::Impl::check_gpg_signatures() {
+    SpanRecorder::Scope span(base->get_span_recorder(), "check signatures");
     bool result{true};
     // TODO(mblaha): DNSsec key verification
     libdnf5::rpm::RpmSignature rpm_signature(base);
     std::set<std::string> processed_repos{};
     int num_checks_skipped = 0;
+    auto & logger = *base->get_logger();
+
+    // With more threads the signatures are checked in parallel first. The results are then processed serially
+    // in the order of the packages below, including the import of the repository keys after failed checks.
+    std::unordered_map<std::string, libdnf5::rpm::RpmSignature::CheckResult> parallel_check_results;
+    const auto max_workers = base->get_config().get_gpgcheck_threads_option().get_value();
+    if (max_workers > 1) {
+        std::vector<std::string> paths;
+        for (const auto & trans_pkg : packages) {
+            if (transaction_item_action_is_inbound(trans_pkg.get_action()) &&
+                libdnf5::rpm::is_signature_check_required(trans_pkg.get_package())) {
+                auto package_path = trans_pkg.get_package().get_package_path();
+                if (!verified_package_files.contains(package_path)) {
+                    paths.push_back(std::move(package_path));
+                }
+            }
+        }
+        auto checks = libdnf5::rpm::check_files_signatures(base, paths, max_workers);
+        for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+            logger.debug(
+                "PGP check of \"{}\" took {} ms",
+                paths[idx],
+                std::chrono::duration<double, std::milli>(checks[idx].duration).count());
+            parallel_check_results.emplace(std::move(paths[idx]), checks[idx].result);
+        }
+    }
+
     for (const auto & trans_pkg : packages) {
         if (transaction_item_action_is_inbound(trans_pkg.get_action())) {
             auto const & pkg = trans_pkg.get_package();
             auto repo = pkg.get_repo();
+            auto package_path = pkg.get_package_path();
             auto err_msg = utils::sformat(
                 _("PGP check for package \"{}\" ({}) from repo \"{}\" has failed: "),
                 pkg.get_nevra(),
-                pkg.get_package_path(),
+                package_path,
                 repo->get_id());
-            auto check_result = rpm_signature.check_package_signature(pkg);
+            libdnf5::rpm::RpmSignature::CheckResult check_result;
+            if (verified_package_files.contains(package_path)) {
+                // the signature of the package file was checked already during the download
+                check_result = libdnf5::rpm::RpmSignature::CheckResult::OK;
+            } else if (auto it = parallel_check_results.find(package_path); it != parallel_check_results.end()) {
+                check_result = it->second;
+            } else {
+                auto start = std::chrono::steady_clock::now();
+                check_result = rpm_signature.check_package_signature(pkg);
+                if (check_result != libdnf5::rpm::RpmSignature::CheckResult::SKIPPED) {
+                    logger.debug(
+                        "PGP check of \"{}\" took {} ms",
+                        package_path,
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+            }
             if (check_result == libdnf5::rpm::RpmSignature::CheckResult::SKIPPED) {
                 num_checks_skipped += 1;
             } else if (check_result != libdnf5::rpm::RpmSignature::CheckResult::OK) {
@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include "module/module_db.hpp"
+#include "rpm/package_reasons.hpp"
 #include "rpm/solv/goal_private.hpp"
 
 #include "libdnf5/base/transaction.hpp"
@@ -34,6 +35,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <solv/transaction.h>
 
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 
 namespace libdnf5::base {
 
@@ -50,12 +58,16 @@ public:
     /// Set transaction according resolved goal and problems to EventLog
     void set_transaction(rpm::solv::GoalPrivate & solved_goal, module::ModuleSack & module_sack, GoalProblem problems);
 
+    /// Creates the transaction package of the inbound package `id` and records the packages it replaces
+    /// in `replaced`. The `reasons` resolve the reasons of the packages, the `obsoletes` queue is reused between
+    /// the calls.
     TransactionPackage make_transaction_package(
         Id id,
         TransactionPackage::Action action,
         rpm::solv::GoalPrivate & solved_goal,
-        std::map<Id, std::vector<Id>> & replaced,
-        rpm::PackageQuery installed_query);
+        std::pmr::map<Id, std::pmr::vector<Id>> & replaced,
+        rpm::PackageReasons & reasons,
+        libdnf5::solv::IdQueue & obsoletes);
 
     GoalProblem report_not_found(
         GoalAction action,
@@ -74,6 +86,12 @@ public:
         GoalProblem problem,
         std::vector<std::vector<std::pair<libdnf5::ProblemRules, std::vector<std::string>>>> problems);
 
+    /// Returns the transaction serialized into a JSON document
+    std::string serialize() const;
+
+    /// Sets the transaction according to the JSON document created by `serialize()`
+    void set_serialized_transaction(const std::string & serialized);
+
     TransactionRunResult test();
 
     TransactionRunResult run(
@@ -93,6 +111,8 @@ private:
     libdnf5::rpm::RpmSignature rpm_signature;
 
     std::vector<TransactionPackage> packages;
+    /// Index of the first transaction package of each package id in `packages`
+    std::unordered_map<int, std::size_t> package_index;
     std::vector<TransactionGroup> groups;
     std::vector<TransactionEnvironment> environments;
     std::vector<TransactionModule> modules;
@@ -104,6 +124,15 @@ private:
     std::vector<std::string> transaction_problems{};
     std::vector<std::string> signature_problems{};
 
+    /// Package files whose signatures passed the check done during `Transaction::download()`
+    std::unordered_set<std::string> verified_package_files;
+
+    /// The rpm database cookie and the transaction set elements the dependency check of a previous successful test
+    /// run passed with
+    std::optional<std::string> tested_check_key;
+
+    ResolveStats resolve_stats;
+
     // history db transaction id
     int64_t history_db_id = 0;
 
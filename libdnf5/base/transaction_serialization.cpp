@@ -0,0 +1,344 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "module/module_db.hpp"
+#include "module/module_sack_impl.hpp"
+#include "rpm/transaction.hpp"
+#include "transaction_impl.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/comps/environment/query.hpp"
+#include "libdnf5/comps/group/query.hpp"
+#include "libdnf5/rpm/package_query.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <fmt/format.h>
+#include <json.h>
+
+#include <memory>
+#include <unordered_map>
+
+
+namespace libdnf5::base {
+
+namespace {
+
+constexpr const char * SERIALIZED_TRANSACTION_VERSION = "1.0";
+
+using JsonObjectPtr = std::unique_ptr<json_object, decltype(&json_object_put)>;
+
+std::string get_checksum_id(const rpm::Package & package) {
+    auto checksum = package.get_checksum();
+    return fmt::format("{}:{}", checksum.get_type_str(), checksum.get_checksum());
+}
+
+void add_string(json_object * object, const char * key, const std::string & value) {
+    json_object_object_add(object, key, json_object_new_string(value.c_str()));
+}
+
+void add_string_array(json_object * object, const char * key, const std::vector<std::string> & values) {
+    auto * array = json_object_new_array();
+    for (const auto & value : values) {
+        json_object_array_add(array, json_object_new_string(value.c_str()));
+    }
+    json_object_object_add(object, key, array);
+}
+
+void add_nevra_array(json_object * object, const char * key, const std::vector<rpm::Package> & packages) {
+    std::vector<std::string> nevras;
+    nevras.reserve(packages.size());
+    for (const auto & package : packages) {
+        nevras.push_back(package.get_full_nevra());
+    }
+    add_string_array(object, key, nevras);
+}
+
+/// Returns the string member `key` of the `object`, `default_value` when it is missing
+std::string get_string(json_object * object, const char * key, const char * default_value = nullptr) {
+    json_object * value;
+    if (json_object_object_get_ex(object, key, &value) && json_object_is_type(value, json_type_string)) {
+        return json_object_get_string(value);
+    }
+    if (!default_value) {
+        throw TransactionError(M_("Invalid serialized transaction: missing string \"{}\""), std::string(key));
+    }
+    return default_value;
+}
+
+/// Returns the strings of the array member `key` of the `object`, an empty vector when it is missing
+std::vector<std::string> get_string_array(json_object * object, const char * key) {
+    std::vector<std::string> values;
+    json_object * array;
+    if (json_object_object_get_ex(object, key, &array) && json_object_is_type(array, json_type_array)) {
+        auto length = json_object_array_length(array);
+        for (std::size_t i = 0; i < length; ++i) {
+            auto * value = json_object_array_get_idx(array, i);
+            if (!json_object_is_type(value, json_type_string)) {
+                throw TransactionError(
+                    M_("Invalid serialized transaction: non-string item in \"{}\""), std::string(key));
+            }
+            values.emplace_back(json_object_get_string(value));
+        }
+    }
+    return values;
+}
+
+/// Returns the objects of the array member `key` of the `object`, an empty vector when it is missing
+std::vector<json_object *> get_object_array(json_object * object, const char * key) {
+    std::vector<json_object *> items;
+    json_object * array;
+    if (json_object_object_get_ex(object, key, &array) && json_object_is_type(array, json_type_array)) {
+        auto length = json_object_array_length(array);
+        items.reserve(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            auto * item = json_object_array_get_idx(array, i);
+            if (!json_object_is_type(item, json_type_object)) {
+                throw TransactionError(
+                    M_("Invalid serialized transaction: non-object item in \"{}\""), std::string(key));
+            }
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/// Returns the only package with the `nevra` in the `query`
+rpm::Package get_package(const rpm::PackageQuery & query, const std::string & nevra) {
+    rpm::PackageQuery nevra_query(query);
+    nevra_query.filter_nevra({nevra});
+    if (nevra_query.empty()) {
+        throw TransactionError(M_("Package \"{}\" from the serialized transaction was not found"), nevra);
+    }
+    return *nevra_query.begin();
+}
+
+}  // namespace
+
+
+std::string Transaction::serialize() const {
+    return p_impl->serialize();
+}
+
+
+Transaction Transaction::deserialize(const libdnf5::BaseWeakPtr & base, const std::string & serialized) {
+    Transaction transaction(base);
+    transaction.p_impl->set_serialized_transaction(serialized);
+    return transaction;
+}
+
+
+std::string Transaction::Impl::serialize() const {
+    JsonObjectPtr root(json_object_new_object(), json_object_put);
+    add_string(root.get(), "version", SERIALIZED_TRANSACTION_VERSION);
+    add_string(root.get(), "rpmdb_cookie", libdnf5::rpm::Transaction(base).get_db_cookie());
+
+    auto * rpms = json_object_new_array();
+    json_object_object_add(root.get(), "rpms", rpms);
+    for (const auto & tspkg : packages) {
+        auto * item = json_object_new_object();
+        json_object_array_add(rpms, item);
+        auto package = tspkg.get_package();
+        add_string(item, "nevra", package.get_full_nevra());
+        add_string(item, "action", transaction::transaction_item_action_to_string(tspkg.get_action()));
+        add_string(item, "reason", transaction::transaction_item_reason_to_string(tspkg.get_reason()));
+        add_string(item, "repo_id", package.get_repo_id());
+        if (transaction::transaction_item_action_is_inbound(tspkg.get_action())) {
+            add_string(item, "checksum", get_checksum_id(package));
+        }
+        if (!tspkg.replaces.empty()) {
+            add_nevra_array(item, "replaces", tspkg.replaces);
+        }
+        if (!tspkg.replaced_by.empty()) {
+            add_nevra_array(item, "replaced_by", tspkg.replaced_by);
+        }
+        if (tspkg.reason_change_group_id) {
+            add_string(item, "group_id", *tspkg.reason_change_group_id);
+        }
+    }
+
+    auto * groups_array = json_object_new_array();
+    json_object_object_add(root.get(), "groups", groups_array);
+    for (const auto & tsgrp : groups) {
+        auto * item = json_object_new_object();
+        json_object_array_add(groups_array, item);
+        add_string(item, "id", tsgrp.get_group().get_groupid());
+        add_string(item, "action", transaction::transaction_item_action_to_string(tsgrp.get_action()));
+        add_string(item, "reason", transaction::transaction_item_reason_to_string(tsgrp.get_reason()));
+        add_string_array(item, "package_types", comps::package_types_to_strings(tsgrp.get_package_types()));
+    }
+
+    auto * environments_array = json_object_new_array();
+    json_object_object_add(root.get(), "environments", environments_array);
+    for (const auto & tsenv : environments) {
+        auto * item = json_object_new_object();
+        json_object_array_add(environments_array, item);
+        add_string(item, "id", tsenv.get_environment().get_environmentid());
+        add_string(item, "action", transaction::transaction_item_action_to_string(tsenv.get_action()));
+        add_string(item, "reason", transaction::transaction_item_reason_to_string(tsenv.get_reason()));
+        json_object_object_add(item, "with_optional", json_object_new_boolean(tsenv.get_with_optional()));
+    }
+
+    auto * modules_array = json_object_new_array();
+    json_object_object_add(root.get(), "modules", modules_array);
+    for (const auto & tsmodule : modules) {
+        auto * item = json_object_new_object();
+        json_object_array_add(modules_array, item);
+        add_string(item, "name", tsmodule.get_module_name());
+        add_string(item, "stream", tsmodule.get_module_stream());
+        add_string(item, "action", transaction::transaction_item_action_to_string(tsmodule.get_action()));
+        add_string(item, "reason", transaction::transaction_item_reason_to_string(tsmodule.get_reason()));
+    }
+
+    return json_object_to_json_string_ext(root.get(), JSON_C_TO_STRING_PLAIN);
+}
+
+
+void Transaction::Impl::set_serialized_transaction(const std::string & serialized) {
+    JsonObjectPtr root(json_tokener_parse(serialized.c_str()), json_object_put);
+    if (!root || !json_object_is_type(root.get(), json_type_object)) {
+        throw TransactionError(M_("Invalid serialized transaction: not a JSON object"));
+    }
+    auto version = get_string(root.get(), "version");
+    if (version != SERIALIZED_TRANSACTION_VERSION) {
+        throw TransactionError(M_("Unsupported version of serialized transaction: {}"), version);
+    }
+    // The packages and the reasons were resolved against the installed packages of the serializing machine
+    auto rpmdb_cookie = get_string(root.get(), "rpmdb_cookie");
+    auto current_rpmdb_cookie = libdnf5::rpm::Transaction(base).get_db_cookie();
+    if (rpmdb_cookie != current_rpmdb_cookie) {
+        throw TransactionError(
+            M_("Serialized transaction was resolved for other installed packages, rpmdb cookie \"{}\" differs from "
+               "\"{}\""),
+            rpmdb_cookie,
+            current_rpmdb_cookie);
+    }
+
+    rpm::PackageQuery installed_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+    installed_query.filter_installed();
+    rpm::PackageQuery available_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+    available_query.filter_available();
+
+    // inbound packages by their NEVRA, they replace the outbound packages listed after them
+    std::unordered_map<std::string, rpm::Package> inbound_packages;
+    for (auto * item : get_object_array(root.get(), "rpms")) {
+        auto nevra = get_string(item, "nevra");
+        auto action = transaction::transaction_item_action_from_string(get_string(item, "action"));
+        auto reason = transaction::transaction_item_reason_from_string(get_string(item, "reason"));
+        auto inbound = transaction::transaction_item_action_is_inbound(action);
+
+        std::optional<rpm::Package> package;
+        if (inbound) {
+            rpm::PackageQuery repo_query(available_query);
+            repo_query.filter_repo_id({get_string(item, "repo_id")});
+            package = get_package(repo_query, nevra);
+            if (get_checksum_id(*package) != get_string(item, "checksum")) {
+                throw TransactionError(
+                    M_("Package \"{}\" from the serialized transaction has a different checksum"), nevra);
+            }
+        } else {
+            package = get_package(installed_query, nevra);
+        }
+
+        std::optional<std::string> group_id;
+        if (action == TransactionPackage::Action::REASON_CHANGE) {
+            auto group = get_string(item, "group_id", "");
+            if (!group.empty()) {
+                group_id = std::move(group);
+            }
+        }
+        TransactionPackage tspkg(*package, action, reason, group_id);
+        for (const auto & replaced_nevra : get_string_array(item, "replaces")) {
+            tspkg.replaces.push_back(get_package(installed_query, replaced_nevra));
+        }
+        for (const auto & replacing_nevra : get_string_array(item, "replaced_by")) {
+            auto it = inbound_packages.find(replacing_nevra);
+            if (it == inbound_packages.end()) {
+                throw TransactionError(
+                    M_("Package \"{}\" from the serialized transaction was not found"), replacing_nevra);
+            }
+            tspkg.replaced_by.push_back(it->second);
+        }
+        if (inbound) {
+            inbound_packages.emplace(nevra, *package);
+        }
+        packages.emplace_back(std::move(tspkg));
+    }
+
+    for (auto * item : get_object_array(root.get(), "groups")) {
+        auto id = get_string(item, "id");
+        auto action = transaction::transaction_item_action_from_string(get_string(item, "action"));
+        auto reason = transaction::transaction_item_reason_from_string(get_string(item, "reason"));
+        comps::GroupQuery query(base);
+        query.filter_groupid(id);
+        query.filter_installed(action == TransactionGroup::Action::REMOVE);
+        if (query.empty()) {
+            throw TransactionError(M_("Group \"{}\" from the serialized transaction was not found"), id);
+        }
+        auto package_types = comps::package_type_from_string(get_string_array(item, "package_types"));
+        groups.emplace_back(TransactionGroup(*query.list().begin(), action, reason, package_types));
+    }
+
+    for (auto * item : get_object_array(root.get(), "environments")) {
+        auto id = get_string(item, "id");
+        auto action = transaction::transaction_item_action_from_string(get_string(item, "action"));
+        auto reason = transaction::transaction_item_reason_from_string(get_string(item, "reason"));
+        comps::EnvironmentQuery query(base);
+        query.filter_environmentid(id);
+        query.filter_installed(action == TransactionEnvironment::Action::REMOVE);
+        if (query.empty()) {
+            throw TransactionError(M_("Environment \"{}\" from the serialized transaction was not found"), id);
+        }
+        json_object * with_optional;
+        bool optional = json_object_object_get_ex(item, "with_optional", &with_optional) &&
+                        json_object_get_boolean(with_optional);
+        environments.emplace_back(TransactionEnvironment(*query.list().begin(), action, reason, optional));
+    }
+
+    // Module changes are applied to the module state the same way the goal does
+    auto & module_sack_impl = *base->get_module_sack()->p_impl;
+    module_db = module_sack_impl.module_db->get_weak_ptr();
+    module_db->initialize();
+    for (auto * item : get_object_array(root.get(), "modules")) {
+        auto name = get_string(item, "name");
+        auto stream = get_string(item, "stream", "");
+        auto action = transaction::transaction_item_action_from_string(get_string(item, "action"));
+        auto reason = transaction::transaction_item_reason_from_string(get_string(item, "reason"));
+        switch (action) {
+            case TransactionModule::Action::ENABLE:
+                module_sack_impl.enable(name, stream);
+                break;
+            case TransactionModule::Action::DISABLE:
+            case TransactionModule::Action::RESET:
+                if (module_db->change_status(
+                        name,
+                        action == TransactionModule::Action::DISABLE ? module::ModuleStatus::DISABLED
+                                                                     : module::ModuleStatus::AVAILABLE)) {
+                    module_db->change_stream(name, "", true);
+                    module_db->clear_profiles(name);
+                }
+                break;
+            default:
+                throw TransactionError(
+                    M_("Invalid serialized transaction: unsupported action of module \"{}\""), name);
+        }
+        modules.emplace_back(TransactionModule(name, stream, action, reason));
+    }
+}
+
+}  // namespace libdnf5::base
@@ -0,0 +1,85 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf5/common/weak_ptr.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+namespace libdnf5 {
+
+namespace {
+
+/// The generation slots of the GenerationGuards. The slots are allocated in chunks which are never freed,
+/// so a GenerationWeakPtr can check its slot even after the guard was destroyed.
+class GenerationSlots {
+public:
+    std::atomic<std::uint64_t> * acquire() {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (free_slots.empty()) {
+            // value initialized to zero generation
+            auto * chunk = new std::atomic<std::uint64_t>[CHUNK_SIZE]();
+            for (std::size_t idx = CHUNK_SIZE; idx > 0; --idx) {
+                free_slots.push_back(&chunk[idx - 1]);
+            }
+        }
+        auto * slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    }
+
+    void release(std::atomic<std::uint64_t> * slot) noexcept {
+        std::lock_guard<std::mutex> guard(mutex);
+        // does not reallocate, the capacity is at least the number of the allocated slots
+        free_slots.push_back(slot);
+    }
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 64;
+
+    std::mutex mutex;
+    std::vector<std::atomic<std::uint64_t> *> free_slots;
+};
+
+
+GenerationSlots & get_generation_slots() {
+    // never destroyed, the guards of static objects can be destroyed after the function local statics
+    static auto * slots = new GenerationSlots;
+    return *slots;
+}
+
+}  // namespace
+
+
+GenerationGuard::GenerationGuard() : slot(get_generation_slots().acquire()) {}
+
+
+GenerationGuard::~GenerationGuard() {
+    clear();
+    get_generation_slots().release(slot);
+}
+
+
+void GenerationGuard::clear() noexcept {
+    slot->fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace libdnf5
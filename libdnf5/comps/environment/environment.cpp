@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/comps/environment/environment.hpp"
 
 #include "solv/pool.hpp"
+#include "utils/fs/file.hpp"
 #include "utils/xml.hpp"
 
 #include "libdnf5/base/base.hpp"
@@ -34,6 +35,7 @@ extern "C" {
 
 #include <libxml/tree.h>
 
+#include <filesystem>
 #include <set>
 #include <string>
 #include <string_view>
@@ -154,7 +156,7 @@ bool Environment::get_installed() const {
 }
 
 
-void Environment::serialize(const std::string & path) {
+std::string Environment::serialize() {
     // Create doc with root node "comps"
     xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
     xmlNodePtr node_comps = xmlNewNode(NULL, BAD_CAST "comps");
@@ -229,13 +231,29 @@ void Environment::serialize(const std::string & path) {
         node = utils::xml::add_subnode_with_text(node_optionlist, "groupid", group);
     }
 
-    // Save the document
-    if (xmlSaveFormatFileEnc(path.c_str(), doc, "utf-8", 1) == -1) {
-        throw utils::xml::XMLSaveError(M_("failed to save xml document for comps"));
-    }
+    // Dump the document
+    xmlChar * buffer = nullptr;
+    int size = 0;
+    xmlDocDumpFormatMemoryEnc(doc, &buffer, &size, "utf-8", 1);
 
     // Memory free
     xmlFreeDoc(doc);
+
+    if (buffer == nullptr) {
+        throw utils::xml::XMLSaveError(M_("failed to save xml document for comps"));
+    }
+    std::string xml(reinterpret_cast<const char *>(buffer), static_cast<std::size_t>(size));
+    xmlFree(buffer);
+    return xml;
+}
+
+void Environment::serialize(const std::string & path) {
+    auto xml = serialize();
+    try {
+        utils::fs::File(path, "w").write(xml);
+    } catch (const std::filesystem::filesystem_error &) {
+        throw utils::xml::XMLSaveError(M_("failed to save xml document for comps"));
+    }
 }
 
 }  // namespace libdnf5::comps
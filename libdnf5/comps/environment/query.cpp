@@ -25,15 +25,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/comps/comps.hpp"
 #include "libdnf5/comps/environment/environment.hpp"
 #include "libdnf5/comps/environment/sack.hpp"
+#include "libdnf5/utils/patterns.hpp"
 
 extern "C" {
 #include <solv/pool.h>
 }
 
-#include <map>
+#include <algorithm>
 #include <string>
-#include <string_view>
-#include <utility>
+#include <unordered_set>
 #include <vector>
 
 
@@ -45,56 +45,12 @@ EnvironmentQuery::EnvironmentQuery(const BaseWeakPtr & base, bool empty) : base(
         return;
     }
 
-    libdnf5::solv::CompsPool & pool = get_comps_pool(base);
-
-    // Map of available environments:
-    //     For each environmentid (SOLVABLE_NAME) have a vector of (repoid, solvable_id) pairs.
-    //     Each pair consists of one solvable_id that represents one definition of the environment
-    //     and repoid of its originating repository.
-    std::map<std::string, std::vector<std::pair<std::string_view, Id>>> available_map;
-    Id solvable_id;
-    Solvable * solvable;
-    std::pair<std::string, std::string> solvable_name_pair;
-    std::string_view repoid;
-
-    // Loop over all solvables
-    FOR_POOL_SOLVABLES(solvable_id) {
-        solvable = pool.id2solvable(solvable_id);
-
-        // Do not include solvables from disabled repositories
-        // TODO(pkratoch): Test this works
-        if (solvable->repo->disabled) {
-            continue;
-        }
-        // SOLVABLE_NAME is in a form "type:id"; include only solvables of type "environment"
-        solvable_name_pair = solv::CompsPool::split_solvable_name(pool.lookup_str(solvable_id, SOLVABLE_NAME));
-        if (solvable_name_pair.first != "environment") {
-            continue;
-        }
-
-        repoid = solvable->repo->name;
-
-        // Add installed environments directly, because there is only one solvable for each
-        if (repoid == "@System") {
-            Environment environment(base);
-            environment.environment_ids.push_back(EnvironmentId(solvable_id));
-            add(environment);
-        } else {
-            // Create map of available environments:
-            // for each environmentid (SOLVABLE_NAME), list all corresponding solvable_ids with repoids
-            available_map[solvable_name_pair.second].insert(
-                available_map[solvable_name_pair.second].end(), std::make_pair(repoid, solvable_id));
-        }
-    }
-
-    // Create environments based on the available_map
-    for (auto & item : available_map) {
+    // The environments are composed of the solvables by the comps index, installed environments have just one
+    // solvable, available environments have the solvables of all their definitions sorted by repoid
+    for (const auto & entry : get_comps_pool(base).get_comps_index().get_environments()) {
         Environment environment(base);
-        // Sort the vector of (repoid, solvable_id) pairs by repoid
-        std::sort(item.second.begin(), item.second.end(), std::greater<>());
-        // Create environment_ids vector from the sorted solvable_ids
-        for (const auto & solvableid_repoid_pair : item.second) {
-            environment.environment_ids.emplace_back(solvableid_repoid_pair.second);
+        for (auto solvable_id : entry.solvable_ids) {
+            environment.environment_ids.emplace_back(solvable_id);
         }
         add(environment);
     }
@@ -104,4 +60,49 @@ EnvironmentQuery::EnvironmentQuery(const BaseWeakPtr & base, bool empty) : base(
 EnvironmentQuery::EnvironmentQuery(Base & base, bool empty) : EnvironmentQuery(base.get_weak_ptr(), empty) {}
 
 
+void EnvironmentQuery::filter_environmentid(const std::vector<std::string> & patterns, sack::QueryCmp cmp) {
+    if (!filter_by_index(patterns, cmp, false)) {
+        filter(F::environmentid, patterns, cmp);
+    }
+}
+
+
+void EnvironmentQuery::filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp) {
+    if (!filter_by_index(patterns, cmp, true)) {
+        filter(F::name, patterns, cmp);
+    }
+}
+
+
+bool EnvironmentQuery::filter_by_index(const std::vector<std::string> & patterns, sack::QueryCmp cmp, bool by_name) {
+    // A glob without any wildcard matches only the equal string
+    if (cmp == sack::QueryCmp::GLOB) {
+        auto is_glob = [](const std::string & pattern) { return utils::is_glob_pattern(pattern.c_str()); };
+        if (std::ranges::any_of(patterns, is_glob)) {
+            return false;
+        }
+    } else if (cmp != sack::QueryCmp::EQ) {
+        return false;
+    }
+
+    auto & index = get_comps_pool(base).get_comps_index();
+    const auto & environments = index.get_environments();
+    std::unordered_set<Id> matching_ids;
+    for (const auto & pattern : patterns) {
+        auto positions = by_name ? index.find_environments_by_name(pattern) : index.find_environments_by_id(pattern);
+        if (positions) {
+            for (auto position : *positions) {
+                matching_ids.insert(environments[position].solvable_ids.front());
+            }
+        }
+    }
+
+    // The solvable ids are compared instead of the strings of the environments
+    std::erase_if(get_data(), [&matching_ids](const Environment & environment) {
+        return environment.environment_ids.empty() || !matching_ids.contains(environment.environment_ids.front().id);
+    });
+    return true;
+}
+
+
 }  // namespace libdnf5::comps
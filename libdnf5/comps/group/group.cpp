@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/comps/group/group.hpp"
 
 #include "solv/pool.hpp"
+#include "utils/fs/file.hpp"
 #include "utils/string.hpp"
 #include "utils/xml.hpp"
 
@@ -36,6 +37,7 @@ extern "C" {
 
 #include <libxml/tree.h>
 
+#include <filesystem>
 #include <set>
 #include <string>
 #include <vector>
@@ -122,6 +124,13 @@ std::vector<Package> Group::get_packages() {
 
     libdnf5::solv::CompsPool & pool = get_comps_pool(base);
 
+    // The package lists are shared by all the Group objects of the solvable through the comps index
+    auto & index = pool.get_comps_index();
+    if (auto cached_packages = index.lookup_group_packages(group_ids[0].id)) {
+        packages = *cached_packages;
+        return packages;
+    }
+
     // Use only the first (highest priority) solvable for package lists
     Solvable * solvable = pool.id2solvable(group_ids[0].id);
 
@@ -149,6 +158,7 @@ std::vector<Package> Group::get_packages() {
             }
         }
     }
+    index.store_group_packages(group_ids[0].id, packages);
     return packages;
 }
 
@@ -193,7 +203,7 @@ __attribute__((__format__(printf, 2, 0))) static void error_to_strings(void * ct
     xml_errors->push_back(buffer);
 }
 
-void Group::serialize(const std::string & path) {
+std::string Group::serialize() {
     std::vector<std::string> xml_errors;
     xmlSetGenericErrorFunc(&xml_errors, &error_to_strings);
 
@@ -272,22 +282,41 @@ void Group::serialize(const std::string & path) {
         }
     }
 
-    // Save the document
-    if (xmlSaveFormatFileEnc(path.c_str(), doc, "utf-8", 1) == -1) {
+    // Dump the document
+    xmlChar * buffer = nullptr;
+    int size = 0;
+    xmlDocDumpFormatMemoryEnc(doc, &buffer, &size, "utf-8", 1);
+
+    // Memory free
+    xmlFreeDoc(doc);
+    // reset the error handler to default
+    xmlSetGenericErrorFunc(NULL, NULL);
+
+    if (buffer == nullptr) {
         // There can be duplicit messages in the libxml2 errors so make them unique
         auto it = unique(xml_errors.begin(), xml_errors.end());
         xml_errors.resize(static_cast<size_t>(distance(xml_errors.begin(), it)));
         throw utils::xml::XMLSaveError(
-            M_("Failed to save xml document for group \"{}\" to file \"{}\": {}"),
+            M_("Failed to serialize xml document for group \"{}\": {}"),
             get_groupid(),
-            path,
             libdnf5::utils::string::join(xml_errors, ", "));
     }
+    std::string xml(reinterpret_cast<const char *>(buffer), static_cast<std::size_t>(size));
+    xmlFree(buffer);
+    return xml;
+}
 
-    // Memory free
-    xmlFreeDoc(doc);
-    // reset the error handler to default
-    xmlSetGenericErrorFunc(NULL, NULL);
+void Group::serialize(const std::string & path) {
+    auto xml = serialize();
+    try {
+        utils::fs::File(path, "w").write(xml);
+    } catch (const std::filesystem::filesystem_error & ex) {
+        throw utils::xml::XMLSaveError(
+            M_("Failed to save xml document for group \"{}\" to file \"{}\": {}"),
+            get_groupid(),
+            path,
+            std::string(ex.what()));
+    }
 }
 
 }  // namespace libdnf5::comps
@@ -26,15 +26,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/comps/comps.hpp"
 #include "libdnf5/comps/group/group.hpp"
 #include "libdnf5/comps/group/sack.hpp"
+#include "libdnf5/utils/patterns.hpp"
 
 extern "C" {
 #include <solv/pool.h>
 }
 
-#include <map>
+#include <algorithm>
 #include <string>
-#include <string_view>
-#include <utility>
+#include <unordered_set>
 #include <vector>
 
 
@@ -46,62 +46,60 @@ GroupQuery::GroupQuery(const BaseWeakPtr & base, bool empty) : base(base) {
         return;
     }
 
-    libdnf5::solv::CompsPool & pool = get_comps_pool(base);
-
-    // Map of available groups:
-    //     For each groupid (SOLVABLE_NAME) have a vector of (repoid, solvable_id) pairs.
-    //     Each pair consists of one solvable_id that represents one definition of the group
-    //     and repoid of its originating repository.
-    std::map<std::string, std::vector<std::pair<std::string_view, Id>>> available_map;
-    Id solvable_id;
-    Solvable * solvable;
-    std::pair<std::string, std::string> solvable_name_pair;
-    std::string_view repoid;
-
-    // Loop over all solvables
-    FOR_POOL_SOLVABLES(solvable_id) {
-        solvable = pool.id2solvable(solvable_id);
-
-        // Do not include solvables from disabled repositories
-        // TODO(pkratoch): Test this works
-        if (solvable->repo->disabled) {
-            continue;
-        }
-        // SOLVABLE_NAME is in a form "type:id"; include only solvables of type "group"
-        solvable_name_pair = solv::CompsPool::split_solvable_name(pool.lookup_str(solvable_id, SOLVABLE_NAME));
-        if (solvable_name_pair.first != "group") {
-            continue;
+    // The groups are composed of the solvables by the comps index, installed groups have just one solvable,
+    // available groups have the solvables of all their definitions sorted by repoid
+    for (const auto & entry : get_comps_pool(base).get_comps_index().get_groups()) {
+        Group group(base);
+        for (auto solvable_id : entry.solvable_ids) {
+            group.group_ids.emplace_back(solvable_id);
         }
+        add(group);
+    }
+}
 
-        repoid = solvable->repo->name;
+GroupQuery::GroupQuery(libdnf5::Base & base, bool empty) : GroupQuery(base.get_weak_ptr(), empty) {}
 
-        // Add installed groups directly, because there is only one solvable for each
-        if (repoid == "@System") {
-            Group group(base);
-            group.group_ids.push_back(GroupId(solvable_id));
-            add(group);
-        } else {
-            // Create map of available groups:
-            // for each groupid (SOLVABLE_NAME), list all corresponding solvable_ids with repoids
-            available_map[solvable_name_pair.second].insert(
-                available_map[solvable_name_pair.second].end(), std::make_pair(repoid, solvable_id));
+void GroupQuery::filter_groupid(const std::vector<std::string> & patterns, sack::QueryCmp cmp) {
+    if (!filter_by_index(patterns, cmp, false)) {
+        filter(F::groupid, patterns, cmp);
+    }
+}
+
+void GroupQuery::filter_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp) {
+    if (!filter_by_index(patterns, cmp, true)) {
+        filter(F::name, patterns, cmp);
+    }
+}
+
+bool GroupQuery::filter_by_index(const std::vector<std::string> & patterns, sack::QueryCmp cmp, bool by_name) {
+    // A glob without any wildcard matches only the equal string
+    if (cmp == sack::QueryCmp::GLOB) {
+        auto is_glob = [](const std::string & pattern) { return utils::is_glob_pattern(pattern.c_str()); };
+        if (std::ranges::any_of(patterns, is_glob)) {
+            return false;
         }
+    } else if (cmp != sack::QueryCmp::EQ) {
+        return false;
     }
 
-    // Create groups based on the available_map
-    for (auto & item : available_map) {
-        Group group(base);
-        // Sort the vector of (repoid, solvable_id) pairs by repoid
-        std::sort(item.second.begin(), item.second.end(), std::greater<>());
-        // Create group_ids vector from the sorted solvable_ids
-        for (const auto & solvableid_repoid_pair : item.second) {
-            group.group_ids.emplace_back(solvableid_repoid_pair.second);
+    auto & index = get_comps_pool(base).get_comps_index();
+    const auto & groups = index.get_groups();
+    std::unordered_set<Id> matching_ids;
+    for (const auto & pattern : patterns) {
+        auto positions = by_name ? index.find_groups_by_name(pattern) : index.find_groups_by_id(pattern);
+        if (positions) {
+            for (auto position : *positions) {
+                matching_ids.insert(groups[position].solvable_ids.front());
+            }
         }
-        add(group);
     }
-}
 
-GroupQuery::GroupQuery(libdnf5::Base & base, bool empty) : GroupQuery(base.get_weak_ptr(), empty) {}
+    // The solvable ids are compared instead of the strings of the groups
+    std::erase_if(get_data(), [&matching_ids](const Group & group) {
+        return group.group_ids.empty() || !matching_ids.contains(group.group_ids.front().id);
+    });
+    return true;
+}
 
 void GroupQuery::filter_package_name(const std::vector<std::string> & patterns, sack::QueryCmp cmp) {
     for (auto it = get_data().begin(); it != get_data().end();) {
@@ -22,6 +22,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf5 {
 
+OptionBinds & Config::opt_binds() {
+    if (!binds_registered) {
+        binds_registered = true;
+        register_opt_binds(binds);
+    }
+    return binds;
+}
+
+void Config::register_opt_binds([[maybe_unused]] OptionBinds & option_binds) {}
+
 void Config::load_from_parser(
     const ConfigParser & parser,
     const std::string & section,
@@ -31,8 +41,8 @@ void Config::load_from_parser(
     auto cfg_parser_data_iter = parser.get_data().find(section);
     if (cfg_parser_data_iter != parser.get_data().end()) {
         for (const auto & opt : cfg_parser_data_iter->second) {
-            auto opt_binds_iter = binds.find(opt.first);
-            if (opt_binds_iter != binds.end()) {
+            auto opt_binds_iter = opt_binds().find(opt.first);
+            if (opt_binds_iter != opt_binds().end()) {
                 try {
                     opt_binds_iter->second.new_string(priority, vars.substitute(opt.second));
                 } catch (const OptionError & ex) {
@@ -172,6 +172,9 @@ class ConfigMain::Impl {
     OptionPath persistdir{PERSISTDIR};
     OptionPath system_state_dir{SYSTEM_STATE_DIR};
     OptionPath transaction_history_dir{SYSTEM_STATE_DIR};
+    OptionEnum<std::string> history_db_journal_mode{"wal", {"wal", "truncate", "delete"}};
+    OptionEnum<std::string> history_db_synchronous{"full", {"off", "normal", "full", "extra"}};
+    OptionEnum<std::string> dnf4_history_conversion{"off", {"off", "foreground", "background"}};
     OptionBool transformdb{true};
     OptionNumber<std::int32_t> recent{7, 0};
     OptionBool reset_nice{true};
@@ -181,10 +184,13 @@ class ConfigMain::Impl {
     OptionPath logdir{geteuid() == 0 ? "/var/log" : libdnf5::xdg::get_user_state_dir()};
     OptionNumber<std::int32_t> log_size{1024 * 1024, str_to_bytes};
     OptionNumber<std::int32_t> log_rotate{4, 0};
+    OptionBool log_async{false};
     OptionPath debugdir{"./debugdata"};
     OptionStringList varsdir{VARS_DIRS};
     OptionStringList reposdir{REPOSITORY_CONF_DIRS};
     OptionBool debug_solver{false};
+    OptionEnum<std::string> debugdata_compression{"gzip", {"gzip", "zstd"}};
+    OptionBool debugdata_job_closure{false};
     OptionStringList installonlypkgs{INSTALLONLYPKGS};
     OptionStringList group_package_types{GROUP_PACKAGE_TYPES};
     OptionStringSet optional_metadata_types{
@@ -207,6 +213,10 @@ class ConfigMain::Impl {
     OptionBool defaultyes{false};
     OptionBool diskspacecheck{true};
     OptionBool localpkg_gpgcheck{false};
+    OptionBool gpgcheck_during_download{false};
+    OptionNumber<std::uint32_t> gpgcheck_threads{0};
+    OptionNumber<std::uint32_t> header_read_threads{0};
+    OptionBool preflight_check{false};
     OptionBool gpgkey_dns_verification{false};
     OptionBool obsoletes{true};
     OptionBool exit_on_lock{false};
@@ -219,6 +229,7 @@ class ConfigMain::Impl {
     OptionBool allow_downgrade{true};
     OptionString bugtracker_url{BUGTRACKER};
     OptionBool zchunk{true};
+    OptionPath zchunk_store_dir{nullptr};
 
     OptionEnum<std::string> color{"auto", {"auto", "never", "always"}, [](const std::string & value) {
                                       const std::array<const char *, 4> always{{"on", "yes", "1", "true"}};
@@ -268,6 +279,8 @@ class ConfigMain::Impl {
 
     OptionBool upgrade_group_objects_upgrade{true};  // :api
     OptionPath destdir{nullptr};
+    OptionPath package_store_dir{nullptr};
+    OptionString peer_cache_url{""};
     OptionString comment{nullptr};
     OptionBool downloadonly{false};  // runtime only option
     OptionBool ignorearch{false};
@@ -279,12 +292,32 @@ class ConfigMain::Impl {
     OptionBool countme{false};
     OptionBool protect_running_kernel{true};
     OptionBool build_cache{true};
+    OptionBool build_cache_in_background{false};
+    OptionNumber<std::uint32_t> max_parallel_repo_downloads{3, 1};
+    OptionNumber<std::uint32_t> max_parallel_repo_cache_builds{0};
+    OptionBool background_mode{false};
+    OptionNumber<std::uint32_t> background_bandwidth{1024 * 1024, str_to_bytes};
+    OptionNumber<float> background_memory_pressure_limit{10, 0, 100};
+    OptionBool solv_cache_prefetch{false};
+    OptionBool load_filelists_on_demand{false};
+    OptionBool load_other_on_demand{false};
+    OptionBool load_package_details_on_demand{false};
+    OptionBool load_system_repo_changelogs{false};
+    OptionBool system_repo_cache{false};
+    OptionBool repo_config_snapshot{false};
+    OptionBool text_search_index{false};
+    OptionBool file_search_index{false};
+    OptionBool query_cache{false};
+    OptionNumber<std::uint32_t> query_filter_threads{0};
+    OptionNumber<std::uint32_t> output_format_threads{0};
+    OptionBool resolve_cache{false};
 
     // Repo main config
 
     OptionNumber<std::uint32_t> retries{10};
     OptionPath cachedir{geteuid() == 0 ? SYSTEM_CACHEDIR : libdnf5::xdg::get_user_cache_dir() / "libdnf5"};
     OptionBool fastestmirror{false};
+    OptionBool mirror_stats{true};
     OptionStringList excludepkgs{std::vector<std::string>{}};
     OptionStringList includepkgs{std::vector<std::string>{}};
     OptionStringList exclude_from_weak{std::vector<std::string>{}};
@@ -333,6 +366,9 @@ class ConfigMain::Impl {
 
     OptionSeconds timeout{30};
     OptionNumber<std::uint32_t> max_parallel_downloads{3, 1};
+    OptionNumber<std::uint32_t> max_downloads_per_mirror{3, 1};
+    OptionNumber<std::uint32_t> segmented_download_min_size{0, str_to_bytes};
+    OptionNumber<std::uint32_t> segmented_download_segments{4, 2};
     OptionSeconds metadata_expire{60 * 60 * 48};
     OptionString sslcacert{""};
     OptionBool sslverify{true};
@@ -370,6 +406,9 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
         false);
 
     owner.opt_binds().add("transaction_history_dir", transaction_history_dir);
+    owner.opt_binds().add("history_db_journal_mode", history_db_journal_mode);
+    owner.opt_binds().add("history_db_synchronous", history_db_synchronous);
+    owner.opt_binds().add("dnf4_history_conversion", dnf4_history_conversion);
 
     owner.opt_binds().add("transformdb", transformdb);
     owner.opt_binds().add("recent", recent);
@@ -380,10 +419,13 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("logdir", logdir);
     owner.opt_binds().add("log_size", log_size);
     owner.opt_binds().add("log_rotate", log_rotate);
+    owner.opt_binds().add("log_async", log_async);
     owner.opt_binds().add("debugdir", debugdir);
     owner.opt_binds().add("varsdir", varsdir);
     owner.opt_binds().add("reposdir", reposdir);
     owner.opt_binds().add("debug_solver", debug_solver);
+    owner.opt_binds().add("debugdata_compression", debugdata_compression);
+    owner.opt_binds().add("debugdata_job_closure", debugdata_job_closure);
 
     owner.opt_binds().add(
         "installonlypkgs",
@@ -410,6 +452,10 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("defaultyes", defaultyes);
     owner.opt_binds().add("diskspacecheck", diskspacecheck);
     owner.opt_binds().add("localpkg_gpgcheck", localpkg_gpgcheck);
+    owner.opt_binds().add("gpgcheck_during_download", gpgcheck_during_download);
+    owner.opt_binds().add("gpgcheck_threads", gpgcheck_threads);
+    owner.opt_binds().add("header_read_threads", header_read_threads);
+    owner.opt_binds().add("preflight_check", preflight_check);
     owner.opt_binds().add("gpgkey_dns_verification", gpgkey_dns_verification);
     owner.opt_binds().add("obsoletes", obsoletes);
     owner.opt_binds().add("exit_on_lock", exit_on_lock);
@@ -422,6 +468,7 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("allow_downgrade", allow_downgrade);
     owner.opt_binds().add("bugtracker_url", bugtracker_url);
     owner.opt_binds().add("zchunk", zchunk);
+    owner.opt_binds().add("zchunk_store_dir", zchunk_store_dir);
     owner.opt_binds().add("color", color);
     owner.opt_binds().add("color_list_installed_older", color_list_installed_older);
     owner.opt_binds().add("color_list_installed_newer", color_list_installed_newer);
@@ -460,6 +507,8 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("history_list_view", history_list_view);
     owner.opt_binds().add("upgrade_group_objects_upgrade", upgrade_group_objects_upgrade);
     owner.opt_binds().add("destdir", destdir);
+    owner.opt_binds().add("package_store_dir", package_store_dir);
+    owner.opt_binds().add("peer_cache_url", peer_cache_url);
     owner.opt_binds().add("comment", comment);
     owner.opt_binds().add("ignorearch", ignorearch);
     owner.opt_binds().add("module_platform_id", module_platform_id);
@@ -469,12 +518,32 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("countme", countme);
     owner.opt_binds().add("protect_running_kernel", protect_running_kernel);
     owner.opt_binds().add("build_cache", build_cache);
+    owner.opt_binds().add("build_cache_in_background", build_cache_in_background);
+    owner.opt_binds().add("max_parallel_repo_downloads", max_parallel_repo_downloads);
+    owner.opt_binds().add("max_parallel_repo_cache_builds", max_parallel_repo_cache_builds);
+    owner.opt_binds().add("background_mode", background_mode);
+    owner.opt_binds().add("background_bandwidth", background_bandwidth);
+    owner.opt_binds().add("background_memory_pressure_limit", background_memory_pressure_limit);
+    owner.opt_binds().add("solv_cache_prefetch", solv_cache_prefetch);
+    owner.opt_binds().add("load_filelists_on_demand", load_filelists_on_demand);
+    owner.opt_binds().add("load_other_on_demand", load_other_on_demand);
+    owner.opt_binds().add("load_package_details_on_demand", load_package_details_on_demand);
+    owner.opt_binds().add("load_system_repo_changelogs", load_system_repo_changelogs);
+    owner.opt_binds().add("system_repo_cache", system_repo_cache);
+    owner.opt_binds().add("repo_config_snapshot", repo_config_snapshot);
+    owner.opt_binds().add("text_search_index", text_search_index);
+    owner.opt_binds().add("file_search_index", file_search_index);
+    owner.opt_binds().add("query_cache", query_cache);
+    owner.opt_binds().add("query_filter_threads", query_filter_threads);
+    owner.opt_binds().add("output_format_threads", output_format_threads);
+    owner.opt_binds().add("resolve_cache", resolve_cache);
 
     // Repo main config
 
     owner.opt_binds().add("retries", retries);
     owner.opt_binds().add("cachedir", cachedir);
     owner.opt_binds().add("fastestmirror", fastestmirror);
+    owner.opt_binds().add("mirror_stats", mirror_stats);
 
     owner.opt_binds().add(
         "excludepkgs",
@@ -553,6 +622,9 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("throttle", throttle);
     owner.opt_binds().add("timeout", timeout);
     owner.opt_binds().add("max_parallel_downloads", max_parallel_downloads);
+    owner.opt_binds().add("max_downloads_per_mirror", max_downloads_per_mirror);
+    owner.opt_binds().add("segmented_download_min_size", segmented_download_min_size);
+    owner.opt_binds().add("segmented_download_segments", segmented_download_segments);
     owner.opt_binds().add("metadata_expire", metadata_expire);
     owner.opt_binds().add("sslcacert", sslcacert);
     owner.opt_binds().add("sslverify", sslverify);
@@ -660,6 +732,27 @@ const OptionPath & ConfigMain::get_transaction_history_dir_option() const {
     return p_impl->transaction_history_dir;
 }
 
+OptionEnum<std::string> & ConfigMain::get_history_db_journal_mode_option() {
+    return p_impl->history_db_journal_mode;
+}
+const OptionEnum<std::string> & ConfigMain::get_history_db_journal_mode_option() const {
+    return p_impl->history_db_journal_mode;
+}
+
+OptionEnum<std::string> & ConfigMain::get_history_db_synchronous_option() {
+    return p_impl->history_db_synchronous;
+}
+const OptionEnum<std::string> & ConfigMain::get_history_db_synchronous_option() const {
+    return p_impl->history_db_synchronous;
+}
+
+OptionEnum<std::string> & ConfigMain::get_dnf4_history_conversion_option() {
+    return p_impl->dnf4_history_conversion;
+}
+const OptionEnum<std::string> & ConfigMain::get_dnf4_history_conversion_option() const {
+    return p_impl->dnf4_history_conversion;
+}
+
 
 OptionBool & ConfigMain::get_transformdb_option() {
     return p_impl->transformdb;
@@ -724,6 +817,13 @@ const OptionNumber<std::int32_t> & ConfigMain::get_log_rotate_option() const {
     return p_impl->log_rotate;
 }
 
+OptionBool & ConfigMain::get_log_async_option() {
+    return p_impl->log_async;
+}
+const OptionBool & ConfigMain::get_log_async_option() const {
+    return p_impl->log_async;
+}
+
 OptionPath & ConfigMain::get_debugdir_option() {
     return p_impl->debugdir;
 }
@@ -752,6 +852,20 @@ const OptionBool & ConfigMain::get_debug_solver_option() const {
     return p_impl->debug_solver;
 }
 
+OptionEnum<std::string> & ConfigMain::get_debugdata_compression_option() {
+    return p_impl->debugdata_compression;
+}
+const OptionEnum<std::string> & ConfigMain::get_debugdata_compression_option() const {
+    return p_impl->debugdata_compression;
+}
+
+OptionBool & ConfigMain::get_debugdata_job_closure_option() {
+    return p_impl->debugdata_job_closure;
+}
+const OptionBool & ConfigMain::get_debugdata_job_closure_option() const {
+    return p_impl->debugdata_job_closure;
+}
+
 OptionStringList & ConfigMain::get_installonlypkgs_option() {
     return p_impl->installonlypkgs;
 }
@@ -829,6 +943,34 @@ const OptionBool & ConfigMain::get_localpkg_gpgcheck_option() const {
     return p_impl->localpkg_gpgcheck;
 }
 
+OptionBool & ConfigMain::get_gpgcheck_during_download_option() {
+    return p_impl->gpgcheck_during_download;
+}
+const OptionBool & ConfigMain::get_gpgcheck_during_download_option() const {
+    return p_impl->gpgcheck_during_download;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_gpgcheck_threads_option() {
+    return p_impl->gpgcheck_threads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_gpgcheck_threads_option() const {
+    return p_impl->gpgcheck_threads;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_header_read_threads_option() {
+    return p_impl->header_read_threads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_header_read_threads_option() const {
+    return p_impl->header_read_threads;
+}
+
+OptionBool & ConfigMain::get_preflight_check_option() {
+    return p_impl->preflight_check;
+}
+const OptionBool & ConfigMain::get_preflight_check_option() const {
+    return p_impl->preflight_check;
+}
+
 OptionBool & ConfigMain::get_gpgkey_dns_verification_option() {
     return p_impl->gpgkey_dns_verification;
 }
@@ -913,6 +1055,13 @@ const OptionBool & ConfigMain::get_zchunk_option() const {
     return p_impl->zchunk;
 }
 
+OptionPath & ConfigMain::get_zchunk_store_dir_option() {
+    return p_impl->zchunk_store_dir;
+}
+const OptionPath & ConfigMain::get_zchunk_store_dir_option() const {
+    return p_impl->zchunk_store_dir;
+}
+
 OptionEnum<std::string> & ConfigMain::get_color_option() {
     return p_impl->color;
 }
@@ -1081,6 +1230,20 @@ const OptionPath & ConfigMain::get_destdir_option() const {
     return p_impl->destdir;
 }
 
+OptionPath & ConfigMain::get_package_store_dir_option() {
+    return p_impl->package_store_dir;
+}
+const OptionPath & ConfigMain::get_package_store_dir_option() const {
+    return p_impl->package_store_dir;
+}
+
+OptionString & ConfigMain::get_peer_cache_url_option() {
+    return p_impl->peer_cache_url;
+}
+const OptionString & ConfigMain::get_peer_cache_url_option() const {
+    return p_impl->peer_cache_url;
+}
+
 OptionString & ConfigMain::get_comment_option() {
     return p_impl->comment;
 }
@@ -1154,6 +1317,139 @@ const OptionBool & ConfigMain::get_build_cache_option() const {
     return p_impl->build_cache;
 }
 
+OptionBool & ConfigMain::get_build_cache_in_background_option() {
+    return p_impl->build_cache_in_background;
+}
+const OptionBool & ConfigMain::get_build_cache_in_background_option() const {
+    return p_impl->build_cache_in_background;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_max_parallel_repo_downloads_option() {
+    return p_impl->max_parallel_repo_downloads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_max_parallel_repo_downloads_option() const {
+    return p_impl->max_parallel_repo_downloads;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_max_parallel_repo_cache_builds_option() {
+    return p_impl->max_parallel_repo_cache_builds;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_max_parallel_repo_cache_builds_option() const {
+    return p_impl->max_parallel_repo_cache_builds;
+}
+
+OptionBool & ConfigMain::get_background_mode_option() {
+    return p_impl->background_mode;
+}
+const OptionBool & ConfigMain::get_background_mode_option() const {
+    return p_impl->background_mode;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_background_bandwidth_option() {
+    return p_impl->background_bandwidth;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_background_bandwidth_option() const {
+    return p_impl->background_bandwidth;
+}
+
+OptionNumber<float> & ConfigMain::get_background_memory_pressure_limit_option() {
+    return p_impl->background_memory_pressure_limit;
+}
+const OptionNumber<float> & ConfigMain::get_background_memory_pressure_limit_option() const {
+    return p_impl->background_memory_pressure_limit;
+}
+
+OptionBool & ConfigMain::get_solv_cache_prefetch_option() {
+    return p_impl->solv_cache_prefetch;
+}
+const OptionBool & ConfigMain::get_solv_cache_prefetch_option() const {
+    return p_impl->solv_cache_prefetch;
+}
+
+OptionBool & ConfigMain::get_load_filelists_on_demand_option() {
+    return p_impl->load_filelists_on_demand;
+}
+const OptionBool & ConfigMain::get_load_filelists_on_demand_option() const {
+    return p_impl->load_filelists_on_demand;
+}
+
+OptionBool & ConfigMain::get_load_other_on_demand_option() {
+    return p_impl->load_other_on_demand;
+}
+const OptionBool & ConfigMain::get_load_other_on_demand_option() const {
+    return p_impl->load_other_on_demand;
+}
+
+OptionBool & ConfigMain::get_load_package_details_on_demand_option() {
+    return p_impl->load_package_details_on_demand;
+}
+const OptionBool & ConfigMain::get_load_package_details_on_demand_option() const {
+    return p_impl->load_package_details_on_demand;
+}
+
+OptionBool & ConfigMain::get_load_system_repo_changelogs_option() {
+    return p_impl->load_system_repo_changelogs;
+}
+const OptionBool & ConfigMain::get_load_system_repo_changelogs_option() const {
+    return p_impl->load_system_repo_changelogs;
+}
+
+OptionBool & ConfigMain::get_system_repo_cache_option() {
+    return p_impl->system_repo_cache;
+}
+const OptionBool & ConfigMain::get_system_repo_cache_option() const {
+    return p_impl->system_repo_cache;
+}
+
+OptionBool & ConfigMain::get_repo_config_snapshot_option() {
+    return p_impl->repo_config_snapshot;
+}
+const OptionBool & ConfigMain::get_repo_config_snapshot_option() const {
+    return p_impl->repo_config_snapshot;
+}
+
+OptionBool & ConfigMain::get_text_search_index_option() {
+    return p_impl->text_search_index;
+}
+const OptionBool & ConfigMain::get_text_search_index_option() const {
+    return p_impl->text_search_index;
+}
+
+OptionBool & ConfigMain::get_file_search_index_option() {
+    return p_impl->file_search_index;
+}
+const OptionBool & ConfigMain::get_file_search_index_option() const {
+    return p_impl->file_search_index;
+}
+
+OptionBool & ConfigMain::get_query_cache_option() {
+    return p_impl->query_cache;
+}
+const OptionBool & ConfigMain::get_query_cache_option() const {
+    return p_impl->query_cache;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_query_filter_threads_option() {
+    return p_impl->query_filter_threads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_query_filter_threads_option() const {
+    return p_impl->query_filter_threads;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_output_format_threads_option() {
+    return p_impl->output_format_threads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_output_format_threads_option() const {
+    return p_impl->output_format_threads;
+}
+
+OptionBool & ConfigMain::get_resolve_cache_option() {
+    return p_impl->resolve_cache;
+}
+const OptionBool & ConfigMain::get_resolve_cache_option() const {
+    return p_impl->resolve_cache;
+}
+
 // Repo main config
 OptionNumber<std::uint32_t> & ConfigMain::get_retries_option() {
     return p_impl->retries;
@@ -1176,6 +1472,13 @@ const OptionBool & ConfigMain::get_fastestmirror_option() const {
     return p_impl->fastestmirror;
 }
 
+OptionBool & ConfigMain::get_mirror_stats_option() {
+    return p_impl->mirror_stats;
+}
+const OptionBool & ConfigMain::get_mirror_stats_option() const {
+    return p_impl->mirror_stats;
+}
+
 OptionStringList & ConfigMain::get_excludepkgs_option() {
     return p_impl->excludepkgs;
 }
@@ -1325,6 +1628,27 @@ const OptionNumber<std::uint32_t> & ConfigMain::get_max_parallel_downloads_optio
     return p_impl->max_parallel_downloads;
 }
 
+OptionNumber<std::uint32_t> & ConfigMain::get_max_downloads_per_mirror_option() {
+    return p_impl->max_downloads_per_mirror;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_max_downloads_per_mirror_option() const {
+    return p_impl->max_downloads_per_mirror;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_segmented_download_min_size_option() {
+    return p_impl->segmented_download_min_size;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_segmented_download_min_size_option() const {
+    return p_impl->segmented_download_min_size;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::get_segmented_download_segments_option() {
+    return p_impl->segmented_download_segments;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::get_segmented_download_segments_option() const {
+    return p_impl->segmented_download_segments;
+}
+
 OptionSeconds & ConfigMain::get_metadata_expire_option() {
     return p_impl->metadata_expire;
 }
@@ -31,22 +31,42 @@ namespace libdnf5 {
 static void read(ConfigParser & cfg_parser, IniParser & parser) {
     IniParser::ItemType readed_type;
     while ((readed_type = parser.next()) != IniParser::ItemType::END_OF_INPUT) {
-        auto section = parser.get_section();
+        std::string section(parser.get_section());
         if (readed_type == IniParser::ItemType::SECTION) {
-            cfg_parser.add_section(std::move(section), std::move(parser.get_raw_item()));
+            cfg_parser.add_section(std::move(section), std::string(parser.get_raw_item()));
         } else if (readed_type == IniParser::ItemType::KEY_VAL) {
             cfg_parser.set_value(
-                section, std::move(parser.get_key()), std::move(parser.get_value()), std::move(parser.get_raw_item()));
+                section,
+                std::string(parser.get_key()),
+                std::string(parser.get_value()),
+                std::string(parser.get_raw_item()));
         } else if (readed_type == IniParser::ItemType::COMMENT_LINE || readed_type == IniParser::ItemType::EMPTY_LINE) {
             if (section.empty()) {
                 cfg_parser.get_header() += parser.get_raw_item();
             } else {
-                cfg_parser.add_comment_line(section, std::move(parser.get_raw_item()));
+                cfg_parser.add_comment_line(section, std::string(parser.get_raw_item()));
             }
         }
     }
 }
 
+/// Reads only sections and key-value pairs. The section names and the keys are looked up and copied once per item,
+/// the values are copied directly from the parsed text.
+static void read_data(ConfigParser & cfg_parser, IniParser & parser) {
+    auto & data = cfg_parser.get_data();
+    ConfigParser::Container::mapped_type * section_data{nullptr};
+    IniParser::ItemType readed_type;
+    while ((readed_type = parser.next()) != IniParser::ItemType::END_OF_INPUT) {
+        if (readed_type == IniParser::ItemType::SECTION) {
+            std::string section(parser.get_section());
+            auto section_iter = data.find(section);
+            section_data = section_iter != data.end() ? &section_iter->second : &data[std::move(section)];
+        } else if (readed_type == IniParser::ItemType::KEY_VAL) {
+            (*section_data)[std::string(parser.get_key())] = parser.get_value();
+        }
+    }
+}
+
 ConfigParserSectionNotFoundError::ConfigParserSectionNotFoundError(const std::string & section)
     : ConfigParserError(M_("Section \"{}\" not found"), section) {}
 
@@ -54,9 +74,17 @@ ConfigParserOptionNotFoundError::ConfigParserOptionNotFoundError(
     const std::string & section, const std::string & option)
     : ConfigParserError(M_("Section \"{}\" does not contain option \"{}\""), section, option) {}
 
-void ConfigParser::read(const std::string & file_path) try {
-    IniParser parser(file_path);
-    ::libdnf5::read(*this, parser);
+void ConfigParser::read(const std::string & file_path) {
+    read(file_path, true);
+}
+
+void ConfigParser::read(const std::string & file_path, bool keep_raw_items) try {
+    IniParser parser(file_path, keep_raw_items);
+    if (keep_raw_items) {
+        ::libdnf5::read(*this, parser);
+    } else {
+        read_data(*this, parser);
+    }
 } catch (const std::filesystem::filesystem_error & e) {
     if (e.code().value() == ENOENT) {
         std::throw_with_nested(MissingConfigError(M_("Configuration file \"{}\" not found"), file_path));
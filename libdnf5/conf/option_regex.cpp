@@ -0,0 +1,48 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "option_regex.hpp"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+
+namespace libdnf5 {
+
+const std::regex & get_option_regex(const std::string & pattern, bool icase) {
+    static std::mutex mutex;
+    // The nodes of the map are never removed, the references to the expressions stay valid
+    static std::map<std::pair<std::string, bool>, std::regex> compiled;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto key = std::make_pair(pattern, icase);
+    auto it = compiled.find(key);
+    if (it == compiled.end()) {
+        auto flags = std::regex::ECMAScript | std::regex::nosubs;
+        if (icase) {
+            flags |= std::regex::icase;
+        }
+        it = compiled.emplace(std::move(key), std::regex(pattern, flags)).first;
+    }
+    return it->second;
+}
+
+}  // namespace libdnf5
@@ -0,0 +1,37 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_CONF_OPTION_REGEX_HPP
+#define LIBDNF5_CONF_OPTION_REGEX_HPP
+
+#include <regex>
+#include <string>
+
+
+namespace libdnf5 {
+
+/// Returns the regular expression `pattern` compiled for matching the values of options. Each pattern is compiled
+/// once per process and shared by all the options using it, e.g. the options of all the repositories. The returned
+/// expression lives until the end of the process.
+const std::regex & get_option_regex(const std::string & pattern, bool icase);
+
+}  // namespace libdnf5
+
+#endif  // LIBDNF5_CONF_OPTION_REGEX_HPP
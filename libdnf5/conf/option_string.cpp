@@ -19,6 +19,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/conf/option_string.hpp"
 
+#include "option_regex.hpp"
+
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
 #include <regex>
@@ -63,11 +65,7 @@ void OptionString::test(const std::string & value) const {
         return;
     }
 
-    auto flags = std::regex::ECMAScript | std::regex::nosubs;
-    if (icase) {
-        flags |= std::regex::icase;
-    }
-    if (!std::regex_match(value, std::regex(regex, flags))) {
+    if (!std::regex_match(value, get_option_regex(regex, icase))) {
         throw OptionValueNotAllowedError(
             M_("Input value \"{}\" not allowed, allowed values for this option are defined by regular expression "
                "\"{}\""),
@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/conf/option_string_list.hpp"
 
+#include "option_regex.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
@@ -77,6 +78,7 @@ OptionStringContainer<T>::OptionStringContainer(
 template <typename T>
 OptionStringContainer<T>::OptionStringContainer(const OptionStringContainer & src)
     : Option(src),
+      regex_matcher(src.regex_matcher),
       regex(src.regex),
       icase(src.icase),
       delimiters(src.delimiters),
@@ -90,6 +92,7 @@ OptionStringContainer<T> & OptionStringContainer<T>::operator=(const OptionStrin
     if (this == &src) {
         return *this;
     }
+    regex_matcher = src.regex_matcher;
     regex = src.regex;
     icase = src.icase;
     delimiters = src.delimiters;
@@ -104,11 +107,7 @@ void OptionStringContainer<T>::init_regex_matcher() {
         return;
     }
 
-    auto flags = std::regex::ECMAScript | std::regex::nosubs;
-    if (icase) {
-        flags |= std::regex::icase;
-    }
-    regex_matcher = std::regex(regex, flags);
+    regex_matcher = &get_option_regex(regex, icase);
 }
 
 template <typename T>
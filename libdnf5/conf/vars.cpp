@@ -38,7 +38,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <cstring>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
 #define ASCII_LOWERCASE "abcdefghijklmnopqrstuvwxyz"
 #define ASCII_UPPERCASE "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
@@ -184,42 +187,84 @@ Vars::Vars(Base & base) : Vars(base.get_weak_ptr()) {}
 
 const unsigned int MAXIMUM_EXPRESSION_DEPTH = 32;
 
-// Expand variables in a subexpression
+// The number of compiled texts after which the substitution cache is dropped
+constexpr std::size_t MAXIMUM_CACHED_TEXTS = 4096;
+
+namespace {
+
+// Segment of a text compiled for the variable substitution
+struct TemplateSegment {
+    enum class Type {
+        // Text copied to the result
+        LITERAL,
+        // $variable or ${variable}, the original text is kept if the variable is not set
+        VARIABLE,
+        // ${variable:-word}
+        DEFAULT_VALUE,
+        // ${variable:+word}
+        ALTERNATE_VALUE
+    };
+
+    Type type;
+    // The literal text or the original text of the variable expression
+    std::string text;
+    std::string name;
+    // The compiled word of the default and alternate value expressions
+    std::vector<TemplateSegment> word;
+};
+
+using Template = std::vector<TemplateSegment>;
+
+void append_literal(Template & tmpl, std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+    if (!tmpl.empty() && tmpl.back().type == TemplateSegment::Type::LITERAL) {
+        tmpl.back().text.append(text);
+    } else {
+        tmpl.push_back({TemplateSegment::Type::LITERAL, std::string(text), {}, {}});
+    }
+}
+
+// Compile a subexpression into literal and variable segments. The structure of the expression does not depend
+// on the values of the variables, the compiled template can be expanded with any of them.
 //
 // @param text String with variable expressions
 // @param depth The recursive depth
-// @return Pair of the resulting string and the number of characters scanned in `text`
-std::pair<std::string, size_t> Vars::substitute_expression(std::string_view text, unsigned int depth) const {
+// @return Pair of the compiled template and the number of characters scanned in `text`
+std::pair<Template, size_t> compile_template(std::string_view text, unsigned int depth) {
+    Template tmpl;
     if (depth > MAXIMUM_EXPRESSION_DEPTH) {
-        return std::make_pair(std::string(text), text.length());
+        append_literal(tmpl, text);
+        return std::make_pair(std::move(tmpl), text.length());
     }
-    std::string res{text};
 
-    // The total number of characters read in the replacee
+    // The total number of characters read in the text. It does not count the skipped parts of the incomplete
+    // variable expressions, a subexpression ends there for its parent.
     size_t total_scanned = 0;
 
     size_t pos = 0;
-    while (pos < res.length()) {
-        if (res[pos] == '}' && depth > 0) {
-            return std::make_pair(res.substr(0, pos), total_scanned);
+    while (pos < text.length()) {
+        if (text[pos] == '}' && depth > 0) {
+            return std::make_pair(std::move(tmpl), total_scanned);
         }
 
-        if (res[pos] == '\\') {
+        if (text[pos] == '\\') {
             // Escape the next character (if there is one)
-            if (pos + 1 >= res.length()) {
+            if (pos + 1 >= text.length()) {
                 break;
             }
-            res.erase(pos, 1);
+            append_literal(tmpl, text.substr(pos + 1, 1));
             total_scanned += 2;
-            pos += 1;
+            pos += 2;
             continue;
         }
-        if (res[pos] == '$') {
+        if (text[pos] == '$') {
             // variable expression starts after the $ and includes the braces
             //     ${variable:-word}
             //      ^-- pos_variable_expression
             size_t pos_variable_expression = pos + 1;
-            if (pos_variable_expression >= res.length()) {
+            if (pos_variable_expression >= text.length()) {
                 break;
             }
 
@@ -227,10 +272,10 @@ std::pair<std::string, size_t> Vars::substitute_expression(std::string_view text
             // starts one character after the start of the variable_expression
             bool has_braces;
             size_t pos_variable;
-            if (res[pos_variable_expression] == '{') {
+            if (text[pos_variable_expression] == '{') {
                 has_braces = true;
                 pos_variable = pos_variable_expression + 1;
-                if (pos_variable >= res.length()) {
+                if (pos_variable >= text.length()) {
                     break;
                 }
             } else {
@@ -239,103 +284,82 @@ std::pair<std::string, size_t> Vars::substitute_expression(std::string_view text
             }
 
             // Find the end of the variable name
-            auto it = std::find_if_not(res.begin() + static_cast<long>(pos_variable), res.end(), [](char c) {
+            auto it = std::find_if_not(text.begin() + static_cast<long>(pos_variable), text.end(), [](char c) {
                 return std::isalnum(c) != 0 || c == '_';
             });
-            auto pos_after_variable = static_cast<size_t>(std::distance(res.begin(), it));
+            auto pos_after_variable = static_cast<size_t>(std::distance(text.begin(), it));
 
-            // Find the substituting string and the end of the variable expression
-            auto variable_mapping = variables.find(res.substr(pos_variable, pos_after_variable - pos_variable));
-            const std::string * subst_str = nullptr;
+            TemplateSegment segment{
+                TemplateSegment::Type::VARIABLE,
+                {},
+                std::string(text.substr(pos_variable, pos_after_variable - pos_variable)),
+                {}};
 
+            // Find the end of the variable expression
             size_t pos_after_variable_expression;
 
             if (has_braces) {
-                if (pos_after_variable >= res.length()) {
+                if (pos_after_variable >= text.length()) {
                     break;
                 }
-                if (res[pos_after_variable] == ':') {
-                    if (pos_after_variable + 1 >= res.length()) {
+                if (text[pos_after_variable] == ':') {
+                    if (pos_after_variable + 1 >= text.length()) {
                         break;
                     }
-                    char expansion_mode = res[pos_after_variable + 1];
+                    char expansion_mode = text[pos_after_variable + 1];
                     size_t pos_word = pos_after_variable + 2;
-                    if (pos_word >= res.length()) {
+                    if (pos_word >= text.length()) {
                         break;
                     }
 
-                    // Expand the default/alternate expression
-                    auto word_str = std::string_view(res).substr(pos_word);
-                    auto [expanded_word, scanned] = substitute_expression(word_str, depth + 1);
+                    // Compile the default/alternate expression
+                    auto [word, scanned] = compile_template(text.substr(pos_word), depth + 1);
                     auto pos_after_word = pos_word + scanned;
-                    if (pos_after_word >= res.length()) {
+                    if (pos_after_word >= text.length()) {
                         break;
                     }
-                    if (res[pos_after_word] != '}') {
+                    if (text[pos_after_word] != '}') {
                         // The variable expression doesn't end in a '}',
                         // continue after the word and don't expand it
+                        append_literal(tmpl, text.substr(pos, pos_after_word - pos));
                         total_scanned += pos_after_word - pos;
                         pos = pos_after_word;
                         continue;
                     }
 
                     if (expansion_mode == '-') {
-                        // ${variable:-word} (default value)
-                        // If variable is unset or empty, the expansion of word is
-                        // substituted. Otherwise, the value of variable is
-                        // substituted.
-                        if (variable_mapping == variables.end() || variable_mapping->second.value.empty()) {
-                            subst_str = &expanded_word;
-                        } else {
-                            subst_str = &variable_mapping->second.value;
-                        }
+                        segment.type = TemplateSegment::Type::DEFAULT_VALUE;
                     } else if (expansion_mode == '+') {
-                        // ${variable:+word} (alternate value)
-                        // If variable is unset or empty nothing is substituted.
-                        // Otherwise, the expansion of word is substituted.
-                        if (variable_mapping == variables.end() || variable_mapping->second.value.empty()) {
-                            const std::string empty{};
-                            subst_str = &empty;
-                        } else {
-                            subst_str = &expanded_word;
-                        }
+                        segment.type = TemplateSegment::Type::ALTERNATE_VALUE;
                     } else {
                         // Unknown expansion mode, continue after the ':'
+                        append_literal(tmpl, text.substr(pos, pos_after_variable + 1 - pos));
                         pos = pos_after_variable + 1;
                         continue;
                     }
+                    segment.word = std::move(word);
                     pos_after_variable_expression = pos_after_word + 1;
-                } else if (res[pos_after_variable] == '}') {
+                } else if (text[pos_after_variable] == '}') {
                     // ${variable}
-                    if (variable_mapping != variables.end()) {
-                        subst_str = &variable_mapping->second.value;
-                    }
                     // Move past the closing '}'
                     pos_after_variable_expression = pos_after_variable + 1;
                 } else {
                     // Variable expression doesn't end in a '}', continue after the variable
+                    append_literal(tmpl, text.substr(pos, pos_after_variable - pos));
                     pos = pos_after_variable;
                     continue;
                 }
             } else {
                 // No braces, we have a $variable
-                if (variable_mapping != variables.end()) {
-                    subst_str = &variable_mapping->second.value;
-                }
                 pos_after_variable_expression = pos_after_variable;
             }
 
-            // If there is no substitution to make, move past the variable expression and continue.
-            if (subst_str == nullptr) {
-                total_scanned += pos_after_variable_expression - pos;
-                pos = pos_after_variable_expression;
-                continue;
-            }
-
-            res.replace(pos, pos_after_variable_expression - pos, *subst_str);
+            segment.text = text.substr(pos, pos_after_variable_expression - pos);
+            tmpl.push_back(std::move(segment));
             total_scanned += pos_after_variable_expression - pos;
-            pos += subst_str->length();
+            pos = pos_after_variable_expression;
         } else {
+            append_literal(tmpl, text.substr(pos, 1));
             total_scanned += 1;
             pos += 1;
         }
@@ -344,14 +368,108 @@ std::pair<std::string, size_t> Vars::substitute_expression(std::string_view text
     // We have reached the end of the text
     if (depth > 0) {
         // If we are in a subexpression and we didn't find a closing '}', make no substitutions.
-        return std::make_pair(std::string{text}, text.length());
+        Template literal;
+        append_literal(literal, text);
+        return std::make_pair(std::move(literal), text.length());
     }
 
-    return std::make_pair(res, text.length());
+    // The rest of an incomplete expression at the end of the text is kept
+    append_literal(tmpl, text.substr(pos));
+    return std::make_pair(std::move(tmpl), text.length());
+}
+
+// Expand the compiled template `tmpl` with the `variables` and append the result to `out`
+void expand_template(
+    const Template & tmpl, const std::map<std::string, Vars::Variable> & variables, std::string & out) {
+    for (const auto & segment : tmpl) {
+        if (segment.type == TemplateSegment::Type::LITERAL) {
+            out.append(segment.text);
+            continue;
+        }
+        auto variable_mapping = variables.find(segment.name);
+        bool is_set = variable_mapping != variables.end();
+        bool is_empty = !is_set || variable_mapping->second.value.empty();
+        switch (segment.type) {
+            case TemplateSegment::Type::VARIABLE:
+                out.append(is_set ? variable_mapping->second.value : segment.text);
+                break;
+            case TemplateSegment::Type::DEFAULT_VALUE:
+                // If variable is unset or empty, the expansion of word is
+                // substituted. Otherwise, the value of variable is
+                // substituted.
+                if (is_empty) {
+                    expand_template(segment.word, variables, out);
+                } else {
+                    out.append(variable_mapping->second.value);
+                }
+                break;
+            case TemplateSegment::Type::ALTERNATE_VALUE:
+                // If variable is unset or empty nothing is substituted.
+                // Otherwise, the expansion of word is substituted.
+                if (!is_empty) {
+                    expand_template(segment.word, variables, out);
+                }
+                break;
+            case TemplateSegment::Type::LITERAL:
+                break;
+        }
+    }
 }
 
+}  // namespace
+
+// The compiled texts and the memoized results of their substitution
+class Vars::SubstituteCache {
+public:
+    SubstituteCache() = default;
+    // A copy of the variables starts with an empty cache
+    SubstituteCache(const SubstituteCache &) {}
+    SubstituteCache & operator=(const SubstituteCache &) {
+        std::lock_guard<std::mutex> guard(mutex);
+        entries.clear();
+        ++generation;
+        return *this;
+    }
+
+    struct Entry {
+        Template tmpl;
+        // The generation of the variables the result was substituted with, 0 if there is no result yet
+        uint64_t result_generation{0};
+        std::string result;
+    };
+
+    std::mutex mutex;
+    // Incremented whenever a variable changes, the results substituted with older variables are not used
+    uint64_t generation{1};
+    std::unordered_map<std::string, Entry> entries;
+};
+
+Vars::Vars(const libdnf5::BaseWeakPtr & base) : base(base), substitute_cache(new SubstituteCache) {}
+
+Vars::~Vars() = default;
+
 std::string Vars::substitute(const std::string & text) const {
-    return substitute_expression(text, 0).first;
+    // Nothing to substitute or unescape
+    if (text.find_first_of("$\\") == std::string::npos) {
+        return text;
+    }
+
+    std::lock_guard<std::mutex> guard(substitute_cache->mutex);
+    auto & entries = substitute_cache->entries;
+    auto entry_it = entries.find(text);
+    if (entry_it == entries.end()) {
+        if (entries.size() >= MAXIMUM_CACHED_TEXTS) {
+            entries.clear();
+        }
+        entry_it = entries.emplace(text, SubstituteCache::Entry{compile_template(text, 0).first, 0, {}}).first;
+    }
+    auto & entry = entry_it->second;
+    if (entry.result_generation != substitute_cache->generation) {
+        entry.result.clear();
+        expand_template(entry.tmpl, variables, entry.result);
+        entry.result_generation = substitute_cache->generation;
+    }
+    return entry.result;
 }
 
 std::tuple<std::string, std::string> Vars::split_releasever(const std::string & releasever) {
@@ -404,7 +522,10 @@ void Vars::set(const std::string & name, const std::string & value, Priority pri
                 it->second.value = value;
                 it->second.priority = prio;
             }
+            ++substitute_cache->generation;
         };
+    // substitute() reads the variables under the mutex of the cache
+    std::lock_guard<std::mutex> guard(substitute_cache->mutex);
     set_unsafe(name, value, prio);
 }
 
@@ -0,0 +1,246 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/logger/async_logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+
+namespace libdnf5 {
+
+// The buffer is a bounded multi-producer single-consumer ring. Each slot has a sequence number telling whether it is
+// free for the producer of the position `pos` (sequence == pos) or filled for the consumer (sequence == pos + 1).
+class AsyncLogger::Impl {
+public:
+    Impl(std::unique_ptr<Logger> && logger, std::size_t capacity);
+
+    bool try_push(
+        const std::chrono::time_point<std::chrono::system_clock> & time,
+        pid_t pid,
+        Level level,
+        const std::string & message) noexcept;
+    void flush() noexcept;
+    void stop() noexcept;
+
+private:
+    friend AsyncLogger;
+
+    struct Record {
+        std::chrono::time_point<std::chrono::system_clock> time;
+        pid_t pid;
+        Level level;
+        std::string message;
+    };
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Record record;
+    };
+
+    void run() noexcept;
+    void drain() noexcept;
+
+    std::unique_ptr<Logger> logger;
+    const pid_t owner_pid;
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::size_t> enqueue_pos{0};
+    std::size_t dequeue_pos{0};  // accessed only by the writer thread
+    std::atomic<std::size_t> written_count{0};
+    std::atomic<std::size_t> pending_dropped{0};
+    std::atomic<std::size_t> total_dropped{0};
+    std::atomic<std::uint32_t> wake_counter{0};
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+};
+
+
+AsyncLogger::Impl::Impl(std::unique_ptr<Logger> && logger, std::size_t capacity)
+    : logger(std::move(logger)),
+      owner_pid(getpid()),
+      mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+      slots(new Slot[mask + 1]) {
+    for (std::size_t idx = 0; idx <= mask; ++idx) {
+        slots[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Impl::run, this);
+}
+
+
+bool AsyncLogger::Impl::try_push(
+    const std::chrono::time_point<std::chrono::system_clock> & time,
+    pid_t pid,
+    Level level,
+    const std::string & message) noexcept {
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot * slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the slot still holds a record from the previous round, the buffer is full
+            return false;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto & record = slot->record;
+    record.time = time;
+    record.pid = pid;
+    record.level = level;
+    try {
+        // reuses the capacity of the message string of the slot
+        record.message.assign(message);
+    } catch (...) {
+        record.message.clear();
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    wake_counter.fetch_add(1, std::memory_order_release);
+    wake_counter.notify_one();
+    return true;
+}
+
+
+void AsyncLogger::Impl::drain() noexcept {
+    if (auto dropped = pending_dropped.exchange(0, std::memory_order_relaxed); dropped > 0) {
+        try {
+            logger->write(
+                std::chrono::system_clock::now(),
+                owner_pid,
+                Level::WARNING,
+                "AsyncLogger: " + std::to_string(dropped) + " log messages dropped, the buffer was full");
+        } catch (...) {
+        }
+    }
+
+    while (true) {
+        auto & slot = slots[dequeue_pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+            // empty, or the producer of the position has not finished writing the record yet
+            break;
+        }
+        auto & record = slot.record;
+        logger->write(record.time, record.pid, record.level, record.message);
+        slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        ++dequeue_pos;
+    }
+
+    written_count.store(dequeue_pos, std::memory_order_release);
+    written_count.notify_all();
+}
+
+
+void AsyncLogger::Impl::run() noexcept {
+    while (true) {
+        auto wake = wake_counter.load(std::memory_order_acquire);
+        drain();
+        if (stopping.load(std::memory_order_acquire)) {
+            break;
+        }
+        wake_counter.wait(wake, std::memory_order_acquire);
+    }
+    drain();
+}
+
+
+void AsyncLogger::Impl::flush() noexcept {
+    if (!writer.joinable() || getpid() != owner_pid) {
+        return;
+    }
+    const auto target = enqueue_pos.load(std::memory_order_acquire);
+    wake_counter.fetch_add(1, std::memory_order_release);
+    wake_counter.notify_one();
+    for (auto written = written_count.load(std::memory_order_acquire); written < target;
+         written = written_count.load(std::memory_order_acquire)) {
+        written_count.wait(written, std::memory_order_acquire);
+    }
+}
+
+
+void AsyncLogger::Impl::stop() noexcept {
+    if (!writer.joinable()) {
+        return;
+    }
+    if (getpid() != owner_pid) {
+        // A forked child has a copy of the handle of the parent's writer thread, but not the thread. It can be neither
+        // joined nor detached, so the handle is moved out without a pthread call and left behind. The child wrote its
+        // own messages synchronously, the records remaining in the buffer are written by the parent.
+        static_cast<void>(new std::thread(std::move(writer)));
+        return;
+    }
+    stopping.store(true, std::memory_order_release);
+    wake_counter.fetch_add(1, std::memory_order_release);
+    wake_counter.notify_one();
+    writer.join();
+}
+
+
+AsyncLogger::AsyncLogger(std::unique_ptr<Logger> && logger, std::size_t capacity)
+    : p_impl(new Impl(std::move(logger), capacity)) {}
+
+
+AsyncLogger::~AsyncLogger() {
+    p_impl->stop();
+}
+
+
+void AsyncLogger::write(
+    const std::chrono::time_point<std::chrono::system_clock> & time,
+    pid_t pid,
+    Level level,
+    const std::string & message) noexcept {
+    if (getpid() != p_impl->owner_pid) {
+        // a forked child, the writer thread runs only in the parent process
+        p_impl->logger->write(time, pid, level, message);
+        return;
+    }
+    if (!p_impl->try_push(time, pid, level, message)) {
+        p_impl->pending_dropped.fetch_add(1, std::memory_order_relaxed);
+        p_impl->total_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (level == Level::CRITICAL) {
+        p_impl->flush();
+    }
+}
+
+
+void AsyncLogger::flush() noexcept {
+    p_impl->flush();
+}
+
+
+std::size_t AsyncLogger::get_dropped_count() const noexcept {
+    return p_impl->total_dropped.load(std::memory_order_relaxed);
+}
+
+}  // namespace libdnf5
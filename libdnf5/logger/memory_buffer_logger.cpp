@@ -19,13 +19,64 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/logger/memory_buffer_logger.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 namespace libdnf5 {
 
-MemoryBufferLogger::MemoryBufferLogger(std::size_t max_items_to_keep, std::size_t reserve)
+MemoryBufferLogger::MemoryBufferLogger(std::size_t max_items_to_keep, std::size_t reserve, std::size_t max_arena_size)
     : max_items(max_items_to_keep),
-      first_item_idx(0) {
+      max_arena_size(max_arena_size) {
+    if (this->max_arena_size == 0) {
+        this->max_arena_size =
+            max_items == 0 ? std::numeric_limits<std::size_t>::max() : max_items * AVERAGE_MESSAGE_SIZE;
+    }
     if (reserve > 0) {
-        items.reserve(reserve < max_items_to_keep ? reserve : max_items_to_keep);
+        if (max_items > 0) {
+            reserve = std::min(reserve, max_items);
+        }
+        records.reserve(reserve);
+        arena.resize(std::min(reserve * AVERAGE_MESSAGE_SIZE, this->max_arena_size));
+    }
+}
+
+
+void MemoryBufferLogger::drop_oldest() noexcept {
+    if (++first_record_idx >= records.size()) {
+        first_record_idx = 0;
+    }
+    --records_count;
+    ++dropped_count;
+}
+
+
+std::size_t MemoryBufferLogger::allocate(std::size_t size) {
+    while (true) {
+        if (records_count == 0) {
+            arena_head = 0;
+        }
+        const auto tail = records_count == 0 ? 0 : records[first_record_idx].offset;
+        if (records_count == 0 || arena_head > tail) {
+            // the used bytes are [tail, arena_head)
+            if (arena.size() - arena_head >= size) {
+                return arena_head;
+            }
+            if (arena.size() < max_arena_size) {
+                // the arena grows only before it is used as a ring, the stored texts keep their offsets
+                auto new_size = std::max(arena.size() * 2, arena_head + size);
+                arena.resize(std::min(std::max(new_size, AVERAGE_MESSAGE_SIZE), max_arena_size));
+                continue;
+            }
+            if (tail >= size) {
+                // wrap around, the bytes after arena_head are left unused
+                return 0;
+            }
+        } else if (tail - arena_head >= size) {
+            // the used bytes wrap around, [arena_head, tail) is free
+            return arena_head;
+        }
+        drop_oldest();
     }
 }
 
@@ -37,47 +88,84 @@ void MemoryBufferLogger::write(
     const std::string & message) noexcept {
     try {
         std::lock_guard<std::mutex> guard(items_mutex);
-        if (max_items == 0 || items.size() < max_items) {
-            items.push_back({time, pid, level, message});
+        if (max_items > 0 && records_count >= max_items) {
+            drop_oldest();
+        }
+
+        const auto size = std::min(message.size(), max_arena_size);
+        const auto offset = allocate(size);
+        std::memcpy(arena.data() + offset, message.data(), size);
+        arena_head = offset + size;
+
+        if (records_count == records.size()) {
+            // the ring of records is full, grow it and move its first record to the beginning
+            std::rotate(
+                records.begin(),
+                records.begin() + static_cast<std::ptrdiff_t>(first_record_idx),
+                records.end());
+            first_record_idx = 0;
+            records.push_back({time, pid, level, offset, size});
         } else {
-            items[first_item_idx] = {time, pid, level, message};
-            if (++first_item_idx >= max_items) {
-                first_item_idx = 0;
+            auto idx = first_record_idx + records_count;
+            if (idx >= records.size()) {
+                idx -= records.size();
             }
+            records[idx] = {time, pid, level, offset, size};
         }
+        ++records_count;
     } catch (...) {
     }
 }
 
-const MemoryBufferLogger::Item & MemoryBufferLogger::get_item(std::size_t item_idx) const {
-    if (item_idx >= items.size() || item_idx >= max_items) {
-        throw std::out_of_range("MemoryBufferLogger");
+
+const MemoryBufferLogger::Record & MemoryBufferLogger::get_record(std::size_t item_idx) const noexcept {
+    auto idx = first_record_idx + item_idx;
+    if (idx >= records.size()) {
+        idx -= records.size();
     }
+    return records[idx];
+}
+
+
+std::size_t MemoryBufferLogger::get_items_count() const {
+    std::lock_guard<std::mutex> guard(items_mutex);
+    return records_count;
+}
+
 
+MemoryBufferLogger::Item MemoryBufferLogger::get_item(std::size_t item_idx) const {
     std::lock_guard<std::mutex> guard(items_mutex);
-    auto idx = item_idx + first_item_idx;
-    if (idx >= max_items) {
-        idx -= max_items;
+    if (item_idx >= records_count) {
+        throw std::out_of_range("MemoryBufferLogger");
     }
-    return items[idx];
+    const auto & record = get_record(item_idx);
+    return {record.time, record.pid, record.level, std::string(arena.data() + record.offset, record.size)};
+}
+
+
+std::size_t MemoryBufferLogger::get_dropped_count() const {
+    std::lock_guard<std::mutex> guard(items_mutex);
+    return dropped_count;
 }
 
+
 void MemoryBufferLogger::write_to_logger(Logger & logger) {
     std::lock_guard<std::mutex> guard(items_mutex);
-    for (size_t idx = first_item_idx; idx < items.size(); ++idx) {
-        auto & msg = items[idx];
-        logger.write(msg.time, msg.pid, msg.level, msg.message);
-    }
-    for (size_t idx = 0; idx < first_item_idx; ++idx) {
-        auto & msg = items[idx];
-        logger.write(msg.time, msg.pid, msg.level, msg.message);
+    // one string reused for all the messages
+    std::string message;
+    for (std::size_t item_idx = 0; item_idx < records_count; ++item_idx) {
+        const auto & record = get_record(item_idx);
+        message.assign(arena.data() + record.offset, record.size);
+        logger.write(record.time, record.pid, record.level, message);
     }
 }
 
+
 void MemoryBufferLogger::clear() noexcept {
     std::lock_guard<std::mutex> guard(items_mutex);
-    first_item_idx = 0;
-    items.clear();
+    first_record_idx = 0;
+    records_count = 0;
+    arena_head = 0;
 }
 
 }  // namespace libdnf5
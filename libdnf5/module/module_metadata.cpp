@@ -84,13 +84,8 @@ ModuleMetadata::~ModuleMetadata() {
 }
 
 
-void ModuleMetadata::add_metadata_from_string(const std::string & yaml, int priority) {
-    GError * error = NULL;
-    g_autoptr(GPtrArray) failures = NULL;
-
-    ModulemdModuleIndex * module_index = modulemd_module_index_new();
-    gboolean success = modulemd_module_index_update_from_string(module_index, yaml.c_str(), FALSE, &failures, &error);
-    if (!success) {
+void ModuleMetadata::check_parse_result(ModulemdModuleIndex * module_index, GPtrArray * failures, GError * error) {
+    if (failures) {
         auto & logger = *base->get_logger();
         for (unsigned int i = 0; i < failures->len; i++) {
             ModulemdSubdocumentInfo * item = (ModulemdSubdocumentInfo *)(g_ptr_array_index(failures, i));
@@ -99,8 +94,38 @@ void ModuleMetadata::add_metadata_from_string(const std::string & yaml, int prio
         }
     }
     if (error) {
+        g_object_unref(module_index);
         throw ModuleResolveError(M_("Failed to update from string: {}"), error->message);
     }
+}
+
+
+void ModuleMetadata::add_metadata_from_string(const std::string & yaml, int priority) {
+    GError * error = NULL;
+    g_autoptr(GPtrArray) failures = NULL;
+
+    ModulemdModuleIndex * module_index = modulemd_module_index_new();
+    gboolean success = modulemd_module_index_update_from_string(module_index, yaml.c_str(), FALSE, &failures, &error);
+    check_parse_result(module_index, success ? NULL : failures, error);
+
+    add_metadata_from_index(module_index, priority);
+    g_object_unref(module_index);
+}
+
+
+ModulemdModuleIndex * ModuleMetadata::parse_metadata_from_stream(FILE * yaml_stream) {
+    GError * error = NULL;
+    g_autoptr(GPtrArray) failures = NULL;
+
+    ModulemdModuleIndex * module_index = modulemd_module_index_new();
+    gboolean success = modulemd_module_index_update_from_stream(module_index, yaml_stream, FALSE, &failures, &error);
+    check_parse_result(module_index, success ? NULL : failures, error);
+
+    return module_index;
+}
+
+
+void ModuleMetadata::add_metadata_from_index(ModulemdModuleIndex * module_index, int priority) {
     if (!module_merger) {
         module_merger = modulemd_module_index_merger_new();
         if (resulting_module_index) {
@@ -110,8 +135,8 @@ void ModuleMetadata::add_metadata_from_string(const std::string & yaml, int prio
         }
     }
 
+    // The merger keeps its own reference to the index
     modulemd_module_index_merger_associate_index(module_merger, module_index, priority);
-    g_object_unref(module_index);
     metadata_resolved = false;
 }
 
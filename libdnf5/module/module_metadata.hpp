@@ -27,6 +27,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <modulemd-2.0/modulemd-module-index.h>
 #include <modulemd-2.0/modulemd.h>
 
+#include <cstdio>
 #include <map>
 #include <string>
 #include <vector>
@@ -55,7 +56,18 @@ private:
 
     BaseWeakPtr get_base() const;
 
+    /// Logs the `failures` and throws if `error` is set. Unrefs the `module_index` when throwing.
+    void check_parse_result(ModulemdModuleIndex * module_index, GPtrArray * failures, GError * error);
+
     void add_metadata_from_string(const std::string & yaml, int priority);
+
+    /// Parses the yaml documents from `yaml_stream` (read till EOF) into a new module index, the caller owns
+    /// the returned reference. The stream is parsed incrementally, it is never read into memory as a whole.
+    ModulemdModuleIndex * parse_metadata_from_stream(FILE * yaml_stream);
+
+    /// Adds an already parsed `module_index`. The index is only referenced, so it can be added to more
+    /// ModuleMetadata objects without parsing the yaml again.
+    void add_metadata_from_index(ModulemdModuleIndex * module_index, int priority);
     void resolve_added_metadata();
 
     std::pair<std::vector<ModuleItem *>, std::vector<ModuleItem *>> get_all_module_items(
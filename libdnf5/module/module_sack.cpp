@@ -22,8 +22,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "module/module_goal_private.hpp"
 #include "module/module_metadata.hpp"
 #include "module/module_sack_impl.hpp"
+#include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
 #include "utils/fs/file.hpp"
+#include "utils/string.hpp"
 
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/base/base_weak.hpp"
@@ -34,6 +36,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/module/nsvcap.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <fmt/format.h>
 #include <modulemd-2.0/modulemd.h>
 
 extern "C" {
@@ -46,8 +49,12 @@ extern "C" {
 #include "libdnf5/repo/repo_weak.hpp"
 #include "libdnf5/rpm/package_query.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace libdnf5::module {
 
@@ -80,6 +87,7 @@ std::vector<ModuleItem *> ModuleSack::get_active_modules() {
 
 
 void ModuleSack::add(const std::string & file_content, const std::string & repo_id) {
+    p_impl->metadata_cacheable = false;
     ModuleMetadata md(get_base());
     try {
         md.add_metadata_from_string(file_content, 0);
@@ -91,25 +99,86 @@ void ModuleSack::add(const std::string & file_content, const std::string & repo_
             M_("Failed to load module metadata for repository \"{}\": {}"), repo_id, std::string(e.what()));
     }
 
+    p_impl->add_module_items(md, repo_id);
+}
+
+
+void ModuleSack::add(FILE * yaml_stream, const std::string & repo_id) {
+    // The metadata do not come from a registered file, the filtering data cannot be identified by the files
+    p_impl->metadata_cacheable = false;
+    p_impl->add_metadata_stream(yaml_stream, repo_id);
+}
+
+
+void ModuleSack::Impl::add_metadata_file(const std::string & path, const std::string & repo_id) {
+    std::error_code size_ec;
+    std::error_code mtime_ec;
+    auto size = std::filesystem::file_size(path, size_ec);
+    auto mtime = std::filesystem::last_write_time(path, mtime_ec);
+    if (size_ec || mtime_ec) {
+        metadata_cacheable = false;
+    } else {
+        metadata_files_key.append(fmt::format(
+            "{}\t{}\t{}\t{}\n", repo_id, path, size, static_cast<long long>(mtime.time_since_epoch().count())));
+    }
+    metadata_files.emplace_back(repo_id, path);
+}
+
+
+void ModuleSack::Impl::load_metadata_files() {
+    if (metadata_files.empty()) {
+        return;
+    }
+    // The list is cleared first, so a failed file is not parsed again on the next access
+    auto files = std::move(metadata_files);
+    metadata_files.clear();
+    for (const auto & [repo_id, path] : files) {
+        base->get_logger()->debug("Parsing modules metadata of repo {} from \"{}\"", repo_id, path);
+        // The (possibly compressed) file is decompressed and parsed as a stream without reading it into memory
+        libdnf5::utils::fs::File file(path, "r", true);
+        add_metadata_stream(file.get(), repo_id);
+    }
+}
+
+
+void ModuleSack::Impl::add_metadata_stream(FILE * yaml_stream, const std::string & repo_id) {
+    ModuleMetadata md(base);
+    try {
+        // The metadata are parsed only once, the resulting index is shared by `md` and `module_metadata`
+        // (used later to get all defaults).
+        ModulemdModuleIndex * module_index = md.parse_metadata_from_stream(yaml_stream);
+        md.add_metadata_from_index(module_index, 0);
+        module_metadata.add_metadata_from_index(module_index, 0);
+        g_object_unref(module_index);
+    } catch (const ModuleResolveError & e) {
+        throw ModuleResolveError(
+            M_("Failed to load module metadata for repository \"{}\": {}"), repo_id, std::string(e.what()));
+    }
+
+    add_module_items(md, repo_id);
+}
+
+
+void ModuleSack::Impl::add_module_items(ModuleMetadata & md, const std::string & repo_id) {
     Repo * repo;
-    auto repo_pair = p_impl->repositories.find(repo_id);
-    if (repo_pair == p_impl->repositories.end()) {
-        repo = repo_create(p_impl->pool, repo_id.c_str());
-        p_impl->repositories[repo_id] = int(repo->repoid);
+    auto repo_pair = repositories.find(repo_id);
+    if (repo_pair == repositories.end()) {
+        repo = repo_create(pool, repo_id.c_str());
+        repositories[repo_id] = int(repo->repoid);
     } else {
-        repo = pool_id2repo(p_impl->pool, Id(repo_pair->second));
+        repo = pool_id2repo(pool, Id(repo_pair->second));
     }
-    auto items = md.get_all_module_items(get_weak_ptr(), repo_id);
+    auto items = md.get_all_module_items(module_sack->get_weak_ptr(), repo_id);
     // Store module items with static context
     for (auto const & module_item_ptr : items.first) {
         std::unique_ptr<ModuleItem> module_item(module_item_ptr);
         module_item->create_solvable_and_dependencies();
-        p_impl->modules.push_back(std::move(module_item));
+        add_module(std::move(module_item));
     }
     // Store module items without static context
     for (auto const & module_item_ptr : items.second) {
         std::unique_ptr<ModuleItem> module_item(module_item_ptr);
-        p_impl->modules_without_static_context.push_back(std::move(module_item));
+        modules_without_static_context.push_back(std::move(module_item));
     }
 }
 
@@ -138,7 +207,7 @@ void ModuleSack::Impl::add_modules_without_static_context() {
             if (context_iterator != stream_iterator->second.end()) {
                 module_item->computed_static_context = context_iterator->second[0]->get_context();
                 module_item->create_solvable_and_dependencies();
-                modules.push_back(std::move(module_item));
+                add_module(std::move(module_item));
                 continue;
             }
         }
@@ -150,12 +219,58 @@ void ModuleSack::Impl::add_modules_without_static_context() {
         }
         module_item->computed_static_context = requires_string;
         module_item->create_solvable_and_dependencies();
-        modules.push_back(std::move(module_item));
+        add_module(std::move(module_item));
     }
     modules_without_static_context.clear();
 }
 
 
+void ModuleSack::Impl::add_module(std::unique_ptr<ModuleItem> && module_item) {
+    modules_by_name_stream[module_item->get_name()][module_item->get_stream()].push_back(module_item.get());
+    modules.push_back(std::move(module_item));
+}
+
+
+ModuleItem * ModuleSack::Impl::find_active_module(
+    const std::string & module_name, const std::vector<std::string> & streams) {
+    auto name_it = modules_by_name_stream.find(module_name);
+    if (name_it == modules_by_name_stream.end()) {
+        return nullptr;
+    }
+
+    ModuleItem * found = nullptr;
+    auto check_items = [&](const std::vector<ModuleItem *> & items) {
+        for (auto * module_item : items) {
+            if ((!found || module_item->id.id < found->id.id) && active_modules.contains(module_item->id.id)) {
+                found = module_item;
+            }
+        }
+    };
+
+    // Streams prefixed by '-' are conflicts, any of the other streams satisfies the dependency
+    bool any_stream = true;
+    for (const auto & stream : streams) {
+        if (!stream.starts_with('-')) {
+            any_stream = false;
+            if (auto stream_it = name_it->second.find(stream); stream_it != name_it->second.end()) {
+                check_items(stream_it->second);
+            }
+        }
+    }
+
+    // If there are only conflicts, any active stream that is not in conflict satisfies the dependency
+    if (any_stream) {
+        for (const auto & [stream, items] : name_it->second) {
+            if (std::find(streams.begin(), streams.end(), "-" + stream) == streams.end()) {
+                check_items(items);
+            }
+        }
+    }
+
+    return found;
+}
+
+
 ModuleSackWeakPtr ModuleSack::get_weak_ptr() {
     return ModuleSackWeakPtr(this, &data_guard);
 }
@@ -167,6 +282,7 @@ BaseWeakPtr ModuleSack::get_base() const {
 
 
 const std::string & ModuleSack::get_default_stream(const std::string & name) const {
+    p_impl->load_metadata_files();
     p_impl->module_defaults = p_impl->module_metadata.get_default_streams();
     auto it = p_impl->module_defaults.find(name);
     if (it == p_impl->module_defaults.end()) {
@@ -177,25 +293,20 @@ const std::string & ModuleSack::get_default_stream(const std::string & name) con
 
 
 std::vector<std::string> ModuleSack::get_default_profiles(std::string module_name, std::string module_stream) {
+    p_impl->load_metadata_files();
     return p_impl->module_metadata.get_default_profiles(module_name, module_stream);
 }
 
 
-std::tuple<
-    std::vector<std::string>,
-    std::vector<std::string>,
-    std::vector<std::string>,
-    std::vector<std::string>,
-    rpm::ReldepList>
-ModuleSack::Impl::collect_data_for_modular_filtering() {
+ModuleSack::Impl::ModularFilteringData ModuleSack::Impl::collect_data_for_modular_filtering() {
     // TODO(jmracek) Add support of demodularized RPMs
     // auto demodularizedNames = getDemodularizedRpms(modulePackageContainer, allPackages);
 
-    std::vector<std::string> include_NEVRAs;
-    std::vector<std::string> exclude_NEVRAs;
-    std::vector<std::string> names;
-    std::vector<std::string> src_names;
-    libdnf5::rpm::ReldepList reldep_name_list(base);
+    ModularFilteringData data;
+    auto & include_NEVRAs = data.include_nevras;
+    auto & exclude_NEVRAs = data.exclude_nevras;
+    auto & names = data.names;
+    auto & src_names = data.src_names;
     for (const auto & module : get_modules()) {
         auto artifacts = module->get_artifacts();
         if (module->is_active()) {
@@ -218,7 +329,6 @@ ModuleSack::Impl::collect_data_for_modular_filtering() {
                         src_names.push_back(nevra.get_name());
                     } else {
                         names.push_back(nevra.get_name());
-                        reldep_name_list.add_reldep(nevra.get_name());
                     }
                 }
             }
@@ -256,29 +366,175 @@ ModuleSack::Impl::collect_data_for_modular_filtering() {
         }
     }
 
-    return std::make_tuple(
-        std::move(include_NEVRAs),
-        std::move(exclude_NEVRAs),
-        std::move(names),
-        std::move(src_names),
-        std::move(reldep_name_list));
+    return data;
+}
+
+
+namespace {
+
+constexpr std::string_view MODULE_FILTERING_CACHE_MAGIC = "libdnf5 module filtering cache 1\n";
+constexpr const char * MODULE_FILTERING_CACHE_FILE_NAME = "module_filtering.cache";
+
+void append_cache_string(std::string & out, std::string_view value) {
+    auto size = static_cast<uint32_t>(value.size());
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+    }
+    out.append(value);
+}
+
+bool read_cache_string(std::string_view & in, std::string & value) {
+    if (in.size() < 4) {
+        return false;
+    }
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i) {
+        size |= static_cast<uint32_t>(static_cast<unsigned char>(in[static_cast<std::size_t>(i)])) << (8 * i);
+    }
+    in.remove_prefix(4);
+    if (in.size() < size) {
+        return false;
+    }
+    value.assign(in.substr(0, size));
+    in.remove_prefix(size);
+    return true;
+}
+
+void append_cache_list(std::string & out, const std::vector<std::string> & values) {
+    append_cache_string(out, std::to_string(values.size()));
+    for (const auto & value : values) {
+        append_cache_string(out, value);
+    }
+}
+
+bool read_cache_list(std::string_view & in, std::vector<std::string> & values) {
+    std::string count_str;
+    if (!read_cache_string(in, count_str)) {
+        return false;
+    }
+    std::size_t count = 0;
+    try {
+        count = std::stoul(count_str);
+    } catch (const std::exception &) {
+        return false;
+    }
+    values.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!read_cache_string(in, values.emplace_back())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Reads the modular filtering data stored with the `key` from the cache file at `path`.
+/// @return `false` if the file does not exist, is damaged or was stored with a different key.
+bool read_module_filtering_cache(
+    const std::filesystem::path & path,
+    const std::string & key,
+    bool & has_modules,
+    ModuleSack::Impl::ModularFilteringData & data) {
+    std::string content;
+    try {
+        content = utils::fs::File(path, "r").read();
+    } catch (const std::exception &) {
+        return false;
+    }
+    std::string_view in(content);
+    std::string value;
+    if (!read_cache_string(in, value) || value != key || !read_cache_string(in, value)) {
+        return false;
+    }
+    has_modules = value == "1";
+    return read_cache_list(in, data.include_nevras) && read_cache_list(in, data.exclude_nevras) &&
+           read_cache_list(in, data.names) && read_cache_list(in, data.src_names) && in.empty();
 }
 
+/// Atomically replaces the cache file at `path` with the modular filtering data stored with the `key`.
+void write_module_filtering_cache(
+    const std::filesystem::path & path,
+    const std::string & key,
+    bool has_modules,
+    const ModuleSack::Impl::ModularFilteringData & data) {
+    std::string out;
+    append_cache_string(out, key);
+    append_cache_string(out, has_modules ? "1" : "0");
+    append_cache_list(out, data.include_nevras);
+    append_cache_list(out, data.exclude_nevras);
+    append_cache_list(out, data.names);
+    append_cache_list(out, data.src_names);
+
+    auto temp_path = path;
+    temp_path += ".tmp";
+    std::filesystem::create_directories(path.parent_path());
+    utils::fs::File(temp_path, "w").write(out);
+    std::filesystem::rename(temp_path, path);
+}
+
+}  // namespace
+
+
+std::string ModuleSack::Impl::get_module_filtering_cache_key() const {
+    // The data cannot be identified when some metadata were added in another way than as a file or when the module
+    // states were already changed in this session
+    if (!metadata_cacheable || module_db->initialized) {
+        return {};
+    }
+    std::string key(MODULE_FILTERING_CACHE_MAGIC);
+    key.append(metadata_files_key);
+    key.append(fmt::format("platform\t{}\n", platform_id));
+    for (const auto & [name, state] : base->p_impl->get_system_state().get_module_states()) {
+        key.append(fmt::format("state\t{}\t{}\t{}\n", name, state.enabled_stream, static_cast<int>(state.status)));
+    }
+    return key;
+}
+
+
 void ModuleSack::Impl::module_filtering() {
-    if (get_modules().empty()) {
+    if (metadata_files.empty() && modules.empty() && modules_without_static_context.empty()) {
         return;
     }
 
     // Try to automatically detect platform id
     if (!platform_detected) {
-        auto platform_id = detect_platform_name_and_stream();
-        if (platform_id) {
-            ModuleItem::create_platform_solvable(module_sack->get_weak_ptr(), platform_id->first, platform_id->second);
+        auto detected_platform_id = detect_platform_name_and_stream();
+        if (detected_platform_id) {
+            ModuleItem::create_platform_solvable(
+                module_sack->get_weak_ptr(), detected_platform_id->first, detected_platform_id->second);
+            platform_id = detected_platform_id->first + ":" + detected_platform_id->second;
             platform_detected = true;
         }
     }
 
-    auto [include_NEVRAs, exclude_NEVRAs, names, src_names, reldep_name_list] = collect_data_for_modular_filtering();
+    // The cache is only used while the modules are not parsed yet, otherwise the data are cheap to collect
+    std::string cache_key;
+    if (!metadata_files.empty() && modules.empty()) {
+        cache_key = get_module_filtering_cache_key();
+    }
+    std::filesystem::path cache_path =
+        std::filesystem::path(base->get_config().get_cachedir_option().get_value()) / MODULE_FILTERING_CACHE_FILE_NAME;
+
+    ModularFilteringData data;
+    bool has_modules = true;
+    if (cache_key.empty() || !read_module_filtering_cache(cache_path, cache_key, has_modules, data)) {
+        has_modules = !get_modules().empty();
+        if (has_modules) {
+            data = collect_data_for_modular_filtering();
+        }
+        if (!cache_key.empty()) {
+            try {
+                write_module_filtering_cache(cache_path, cache_key, has_modules, data);
+            } catch (const std::exception & ex) {
+                base->get_logger()->debug(
+                    "Cannot write module filtering cache \"{}\": {}", cache_path.string(), ex.what());
+            }
+        }
+    } else {
+        base->get_logger()->debug("Modular filtering data loaded from cache \"{}\"", cache_path.string());
+    }
+    if (!has_modules) {
+        return;
+    }
 
     // Packages from system, commandline, and hotfix repositories are not targets for modular filterring
     libdnf5::rpm::PackageQuery target_packages(base);
@@ -298,6 +554,25 @@ void ModuleSack::Impl::module_filtering() {
         keep_repo_ids.push_back(repo->get_id());
     }
 
+    // The data read from the cache are identified by the cache key, the collected ones by the module solving inputs
+    auto excludes_key = fmt::format(
+        "{}\n{}\n{}",
+        cache_key.empty() ? module_solve_key : cache_key,
+        get_rpm_pool(base).get_nsolvables(),
+        utils::string::join(keep_repo_ids, ","));
+    if (applied_module_excludes && excludes_key == module_excludes_key) {
+        return;
+    }
+
+    auto & include_NEVRAs = data.include_nevras;
+    auto & exclude_NEVRAs = data.exclude_nevras;
+    auto & names = data.names;
+    auto & src_names = data.src_names;
+    libdnf5::rpm::ReldepList reldep_name_list(base);
+    for (const auto & name : names) {
+        reldep_name_list.add_reldep(name);
+    }
+
     target_packages.filter_repo_id(keep_repo_ids, libdnf5::sack::QueryCmp::NEQ);
 
     libdnf5::rpm::PackageQuery include_query(base);
@@ -332,9 +607,11 @@ void ModuleSack::Impl::module_filtering() {
     exclude_names_query.update(exclude_src_names_query);
     exclude_names_query.difference(include_query);
 
-    base->get_rpm_package_sack()->p_impl->set_module_excludes(exclude_query);
-    base->get_rpm_package_sack()->p_impl->add_module_excludes(exclude_provides_query);
-    base->get_rpm_package_sack()->p_impl->add_module_excludes(exclude_names_query);
+    libdnf5::rpm::PackageSet module_excludes(exclude_query);
+    module_excludes |= exclude_provides_query;
+    module_excludes |= exclude_names_query;
+    apply_module_excludes(module_excludes);
+    module_excludes_key = std::move(excludes_key);
 
     // TODO(jmracek) Store also includes or data more structuralized - module not actave packages,
     // filtered out not modular packages or so on
@@ -343,6 +620,45 @@ void ModuleSack::Impl::module_filtering() {
 }
 
 
+void ModuleSack::Impl::apply_module_excludes(const rpm::PackageSet & module_excludes) {
+    auto & package_sack = *base->get_rpm_package_sack()->p_impl;
+    if (!applied_module_excludes) {
+        package_sack.set_module_excludes(module_excludes);
+    } else {
+        // Updating the considered map by the difference is cheaper than recomputing it from all the excludes
+        rpm::PackageSet removed(*applied_module_excludes);
+        removed -= module_excludes;
+        rpm::PackageSet added(module_excludes);
+        added -= *applied_module_excludes;
+        if (!removed.empty()) {
+            package_sack.remove_module_excludes(removed);
+        }
+        if (!added.empty()) {
+            package_sack.add_module_excludes(added);
+        }
+    }
+    applied_module_excludes = module_excludes;
+}
+
+
+std::string ModuleSack::Impl::get_module_solve_key() const {
+    // The default streams come from the metadata, they are covered by the number of modules
+    auto key = fmt::format("platform\t{}\nmodules\t{}\n", platform_id, modules.size());
+    for (const auto & [name, state] : module_db->runtime_module_states) {
+        key.append(fmt::format(
+            "state\t{}\t{}\t{}\n", name, state.changed.enabled_stream, static_cast<int>(state.changed.status)));
+    }
+    for (const auto & queue : modules_to_enable) {
+        key.append("enable");
+        for (auto id : queue) {
+            key.append(fmt::format("\t{}", id));
+        }
+        key.push_back('\n');
+    }
+    return key;
+}
+
+
 void ModuleSack::Impl::make_provides_ready() {
     if (provides_ready) {
         return;
@@ -404,7 +720,6 @@ void ModuleSack::Impl::set_active_modules(ModuleGoalPrivate & goal) {
 }
 
 
-// TODO(pkratoch): Could be done more efficiently, e.g. dnf4 used PackageSets
 void ModuleSack::Impl::enable_dependent_modules() {
     std::map<std::string, std::vector<std::string>> modules_to_enable;
 
@@ -424,28 +739,23 @@ void ModuleSack::Impl::enable_dependent_modules() {
         }
     }
 
-    // While there are some modules to enable, search for corresponding active module items and enable them + process their dependencies
+    // While there are some modules to enable, look up the corresponding active module items in the index, enable them
+    // and process their dependencies. Dependencies not satisfied by any active module item are left to the solver.
     while (!modules_to_enable.empty()) {
-        for (const auto & active_module : active_modules) {
-            const auto & module_name = active_module.second->get_name();
-            const auto & module_stream = active_module.second->get_stream();
-            const auto & module_to_enable = modules_to_enable.find(module_name);
-            // If this module_item is in the modules_to_enable, enable it + process its dependencies
-            if (module_to_enable != modules_to_enable.end() &&
-                std::find(module_to_enable->second.begin(), module_to_enable->second.end(), module_stream) !=
-                    module_to_enable->second.end()) {
-                modules_to_enable.erase(module_to_enable);
-                module_db->change_status(module_name, ModuleStatus::ENABLED);
-                module_db->change_stream(module_name, module_stream);
-                for (const auto & dependency : active_module.second->get_module_dependencies()) {
-                    try {
-                        if (module_db->get_status(dependency.get_module_name()) == ModuleStatus::AVAILABLE) {
-                            modules_to_enable.emplace(dependency.get_module_name(), dependency.get_streams());
-                        }
-                    } catch (NoModuleError &) {
-                        ;
-                    }
+        auto module_to_enable = modules_to_enable.extract(modules_to_enable.begin());
+        auto * module_item = find_active_module(module_to_enable.key(), module_to_enable.mapped());
+        if (!module_item) {
+            continue;
+        }
+        module_db->change_status(module_item->get_name(), ModuleStatus::ENABLED);
+        module_db->change_stream(module_item->get_name(), module_item->get_stream());
+        for (const auto & dependency : module_item->get_module_dependencies()) {
+            try {
+                if (module_db->get_status(dependency.get_module_name()) == ModuleStatus::AVAILABLE) {
+                    modules_to_enable.emplace(dependency.get_module_name(), dependency.get_streams());
                 }
+            } catch (NoModuleError &) {
+                ;
             }
         }
     }
@@ -712,9 +1022,15 @@ std::optional<std::pair<std::string, std::string>> ModuleSack::Impl::detect_plat
 
 std::pair<std::vector<std::vector<std::string>>, ModuleSack::ModuleErrorType>
 ModuleSack::resolve_active_module_items() {
+    p_impl->module_db->initialize();
+    auto solve_key = p_impl->get_module_solve_key();
+    if (active_modules_resolved && solve_key == p_impl->module_solve_key) {
+        // Neither the modules nor their states changed, the active modules are still valid
+        return p_impl->module_solve_result;
+    }
+
     p_impl->considered_uptodate = false;
     p_impl->excludes.reset(new libdnf5::solv::SolvMap(p_impl->pool->nsolvables));
-    p_impl->module_db->initialize();
 
     ModuleStatus status;
     std::vector<ModuleItem *> module_items_to_solve;
@@ -733,9 +1049,10 @@ ModuleSack::resolve_active_module_items() {
         }
     }
 
-    auto problems = p_impl->module_solve(module_items_to_solve);
+    p_impl->module_solve_result = p_impl->module_solve(module_items_to_solve);
+    p_impl->module_solve_key = std::move(solve_key);
     active_modules_resolved = true;
-    return problems;
+    return p_impl->module_solve_result;
 }
 
 
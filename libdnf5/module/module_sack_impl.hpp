@@ -28,12 +28,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/module/module_sack.hpp"
+#include "libdnf5/rpm/package_set.hpp"
 #include "libdnf5/rpm/reldep_list.hpp"
 
 extern "C" {
 #include <solv/pool.h>
 }
 
+#include <map>
 #include <optional>
 
 
@@ -75,28 +77,56 @@ public:
 
     const std::vector<std::unique_ptr<ModuleItem>> & get_modules();
 
+    /// Inputs of the modular filtering collected from the modules
+    struct ModularFilteringData {
+        /// Artifacts of the active modules
+        std::vector<std::string> include_nevras;
+        /// Artifacts of the not active modules
+        std::vector<std::string> exclude_nevras;
+        /// Names of the artifacts of the active modules that are not source
+        std::vector<std::string> names;
+        /// Names of the artifacts of the active modules that are source
+        std::vector<std::string> src_names;
+    };
+
     /// Apply modular filtering to package set. For proper functionality, all repositories must be loaded and active
     /// modules must be resolved (modular solver).
+    ///
+    /// The excludes are recomputed only when the filtering data or the packages changed since the last call and only
+    /// their difference is passed to the package sack.
+    ///
+    /// The collected filtering data are stored in a cache file in the cachedir. As long as the metadata files,
+    /// the module states and the platform do not change, the data are read from the cache and neither the metadata
+    /// are parsed nor the active modules are resolved.
     void module_filtering();
 
     /// Supporting method that iterates over all modules and creates filtering sets for modular filtering
-    /// include_NEVRAs contains artifacts from active modules
-    /// exclude_NEVRAs contains artifacts from not active modules
-    /// names and reldep_name_list contain names from include_NEVRAs that are not source
-    /// src_names contains names from include_NEVRAs that are source
-    ///
-    /// @return <include_NEVRAs>, <exclude_NEVRAs>, <names>, <src_names>, <reldep_name_list>
-    std::tuple<
-        std::vector<std::string>,
-        std::vector<std::string>,
-        std::vector<std::string>,
-        std::vector<std::string>,
-        rpm::ReldepList>
-    collect_data_for_modular_filtering();
+    ModularFilteringData collect_data_for_modular_filtering();
+
+    /// Registers the modules metadata file `path` of the repo `repo_id`. The file is parsed the first time
+    /// the modules are needed.
+    void add_metadata_file(const std::string & path, const std::string & repo_id);
+
+    /// Parses the registered metadata files that were not parsed yet.
+    void load_metadata_files();
+
+    /// Parses the modules metadata from `yaml_stream` and adds the modules of the repo `repo_id`.
+    void add_metadata_stream(FILE * yaml_stream, const std::string & repo_id);
+
+    /// Creates module items (and their solvables in the repo `repo_id`) from metadata `md` and stores them.
+    void add_module_items(ModuleMetadata & md, const std::string & repo_id);
 
     // Compute static context for older modules and move these modules to `ModuleSack.modules`.
     void add_modules_without_static_context();
 
+    /// Stores the module item in `modules` and adds it to the `modules_by_name_stream` index.
+    void add_module(std::unique_ptr<ModuleItem> && module_item);
+
+    /// Returns the active module item which satisfies the dependency on module `module_name` with `streams`
+    /// (as returned by `ModuleDependency::get_streams()`), the one with the lowest id if there are more of them.
+    /// Returns nullptr if there is no such active module item.
+    ModuleItem * find_active_module(const std::string & module_name, const std::vector<std::string> & streams);
+
     void make_provides_ready();
     void recompute_considered_in_pool();
 
@@ -157,6 +187,8 @@ private:
     BaseWeakPtr base;
     ModuleMetadata module_metadata;
     std::vector<std::unique_ptr<ModuleItem>> modules;
+    // Index of `modules` by module name and stream, the module items are in the order of `modules`.
+    std::map<std::string, std::map<std::string, std::vector<ModuleItem *>>> modules_by_name_stream;
     Pool * pool;
     // Repositories containing any modules. Key is repoid, value is Id of the repo in libsolv.
     // This is needed in `ModuleItem::create_solvable` for creating solvable in the correct repository.
@@ -182,9 +214,41 @@ private:
     /// @return If platform id was detected, it returns a pair where the first item is the platform
     ///         module name and second is the platform stream. Otherwise std::nullopt is returned.
     std::optional<std::pair<std::string, std::string>> detect_platform_name_and_stream() const;
+
+    /// @return The key identifying the inputs of the modular filtering data, empty if the data cannot be cached.
+    std::string get_module_filtering_cache_key() const;
+
+    /// @return The key identifying the inputs of the module solving: the modules, the platform, the runtime module
+    ///         states and the module items requested to enable.
+    std::string get_module_solve_key() const;
+
+    /// Replaces the module excludes of the package sack by `module_excludes`. Only the packages added or removed
+    /// since the previous call are passed to the package sack.
+    void apply_module_excludes(const rpm::PackageSet & module_excludes);
+
+    /// The registered metadata files that were not parsed yet, pairs of the repo id and the path
+    std::vector<std::pair<std::string, std::string>> metadata_files;
+
+    /// Identifies all the registered metadata files by their repo ids, paths, sizes and modification times
+    std::string metadata_files_key;
+
+    /// `false` if some metadata were not added as a file and the modular filtering data cannot be cached
+    bool metadata_cacheable = true;
+
+    /// "name:stream" of the detected platform, empty if it was not detected
+    std::string platform_id;
+
+    /// The key of the last module solving and its result, the solving is skipped while the key does not change
+    std::string module_solve_key;
+    std::pair<std::vector<std::vector<std::string>>, ModuleSack::ModuleErrorType> module_solve_result;
+
+    /// The key of the inputs of the last applied module excludes and the excludes
+    std::string module_excludes_key;
+    std::optional<rpm::PackageSet> applied_module_excludes;
 };
 
 inline const std::vector<std::unique_ptr<ModuleItem>> & ModuleSack::Impl::get_modules() {
+    load_metadata_files();
     add_modules_without_static_context();
     return modules;
 }
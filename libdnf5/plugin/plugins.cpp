@@ -22,8 +22,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "utils/library.hpp"
 
 #include "libdnf5/base/base.hpp"
+#include "libdnf5/conf/option_string_list.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <algorithm>
 #include <filesystem>
 
 namespace libdnf5::plugin {
@@ -163,9 +165,58 @@ void Plugins::load_plugin(const std::string & config_file_path) {
     }
 
     auto library_path = find_plugin_library(config_file_path);
+
+    if (parser.has_option("main", "hooks")) {
+        std::vector<Hook> hooks;
+        for (const auto & hook_name :
+             OptionStringList(std::vector<std::string>{}).from_string(parser.get_value("main", "hooks"))) {
+            if (hook_name == "pre_base_setup") {
+                hooks.push_back(Hook::PRE_BASE_SETUP);
+            } else if (hook_name == "post_base_setup") {
+                hooks.push_back(Hook::POST_BASE_SETUP);
+            } else if (hook_name == "pre_transaction") {
+                hooks.push_back(Hook::PRE_TRANSACTION);
+            } else if (hook_name == "post_transaction") {
+                hooks.push_back(Hook::POST_TRANSACTION);
+            } else {
+                throw PluginError(M_("Unknown hook \"{}\" in option hooks"), hook_name);
+            }
+        }
+        logger.debug("Deferred loading of plugin library file=\"{}\"", library_path);
+        deferred_plugins.push_back({std::move(parser), std::move(library_path), std::move(hooks)});
+        return;
+    }
+
     load_plugin_library(std::move(parser), library_path);
 }
 
+void Plugins::load_deferred_plugins(Hook hook) {
+    auto & logger = *base->get_logger();
+    for (auto it = deferred_plugins.begin(); it != deferred_plugins.end();) {
+        if (std::find(it->hooks.begin(), it->hooks.end(), hook) == it->hooks.end()) {
+            ++it;
+            continue;
+        }
+        auto deferred_plugin = std::move(*it);
+        it = deferred_plugins.erase(it);
+        try {
+            auto first_new_plugin = plugins.size();
+            load_plugin_library(std::move(deferred_plugin.parser), deferred_plugin.library_path);
+            // the library can load more plugins
+            for (auto idx = first_new_plugin; idx < plugins.size(); ++idx) {
+                if (plugins[idx]->get_enabled()) {
+                    plugins[idx]->init();
+                }
+            }
+        } catch (const std::exception & ex) {
+            logger.error("Cannot load plugin \"{}\": {}", deferred_plugin.library_path, ex.what());
+            throw PluginError(
+                M_("Cannot load plugins: {}"),
+                std::filesystem::path(deferred_plugin.library_path).filename().string());
+        }
+    }
+}
+
 void Plugins::load_plugins(const std::string & config_dir_path) {
     auto & logger = *base->get_logger();
     if (config_dir_path.empty())
@@ -207,36 +258,40 @@ bool Plugins::init() {
     return true;
 }
 
-void Plugins::pre_base_setup() {
-    for (auto & plugin : plugins) {
-        if (plugin->get_enabled()) {
-            plugin->pre_base_setup();
+void Plugins::call_hook(const std::function<void(Plugin &)> & hook) {
+    // A plugin can register more plugins in the hook (e.g. the Python plugins loader). They are appended to `plugins`,
+    // so they are initialized and get the hook called in this loop as well.
+    const auto num_initialized_plugins = plugins.size();
+    for (std::size_t idx = 0; idx < plugins.size(); ++idx) {
+        auto & plugin = *plugins[idx];
+        if (!plugin.get_enabled()) {
+            continue;
+        }
+        if (idx >= num_initialized_plugins) {
+            plugin.init();
         }
+        hook(plugin);
     }
 }
 
+void Plugins::pre_base_setup() {
+    load_deferred_plugins(Hook::PRE_BASE_SETUP);
+    call_hook([&](Plugin & plugin) { plugin.pre_base_setup(); });
+}
+
 void Plugins::post_base_setup() {
-    for (auto & plugin : plugins) {
-        if (plugin->get_enabled()) {
-            plugin->post_base_setup();
-        }
-    }
+    load_deferred_plugins(Hook::POST_BASE_SETUP);
+    call_hook([&](Plugin & plugin) { plugin.post_base_setup(); });
 }
 
 void Plugins::pre_transaction(const libdnf5::base::Transaction & transaction) {
-    for (auto & plugin : plugins) {
-        if (plugin->get_enabled()) {
-            plugin->pre_transaction(transaction);
-        }
-    }
+    load_deferred_plugins(Hook::PRE_TRANSACTION);
+    call_hook([&](Plugin & plugin) { plugin.pre_transaction(transaction); });
 }
 
 void Plugins::post_transaction(const libdnf5::base::Transaction & transaction) {
-    for (auto & plugin : plugins) {
-        if (plugin->get_enabled()) {
-            plugin->post_transaction(transaction);
-        }
-    }
+    load_deferred_plugins(Hook::POST_TRANSACTION);
+    call_hook([&](Plugin & plugin) { plugin.post_transaction(transaction); });
 }
 
 void Plugins::finish() noexcept {
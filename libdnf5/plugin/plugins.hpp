@@ -24,6 +24,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/conf/config_parser.hpp"
 #include "libdnf5/plugin/iplugin.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -80,6 +81,8 @@ public:
     void register_plugin(std::unique_ptr<Plugin> && plugin);
 
     /// Loads the plugin from the library defined by the configuration file config_file_path.
+    /// If the "hooks" option in the "main" section of the configuration lists the hooks needed by the plugin,
+    /// the library is loaded only when the first of the listed hooks is called.
     void load_plugin(const std::string & config_file_path);
 
     /// Loads plugins defined by configuration files in the directory.
@@ -104,13 +107,29 @@ public:
     void finish() noexcept;
 
 private:
+    enum class Hook { PRE_BASE_SETUP, POST_BASE_SETUP, PRE_TRANSACTION, POST_TRANSACTION };
+
+    /// Plugin whose library is loaded when one of its `hooks` is called
+    struct DeferredPlugin {
+        ConfigParser parser;
+        std::string library_path;
+        std::vector<Hook> hooks;
+    };
+
     std::string find_plugin_library(const std::string & plugin_conf_path);
 
     /// Loads the plugin from the library defined by the file path.
     void load_plugin_library(ConfigParser && parser, const std::string & file_path);
 
+    /// Loads and initializes the deferred plugins that need the `hook`.
+    void load_deferred_plugins(Hook hook);
+
+    /// Calls `hook` on all the enabled plugins, including the plugins registered during the calls.
+    void call_hook(const std::function<void(Plugin &)> & hook);
+
     Base * base;
     std::vector<std::unique_ptr<Plugin>> plugins;
+    std::vector<DeferredPlugin> deferred_plugins;
 };
 
 
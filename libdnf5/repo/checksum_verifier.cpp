@@ -0,0 +1,97 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "checksum_verifier.hpp"
+
+#include "utils/on_scope_exit.hpp"
+
+#include <fcntl.h>
+#include <librepo/librepo.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+
+namespace libdnf5::repo {
+
+bool verify_file_checksum(
+    const std::filesystem::path & path,
+    libdnf5::rpm::Checksum::Type checksum_type,
+    const std::string & checksum,
+    std::uint64_t size) {
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    utils::OnScopeExit close_fd([fd]() noexcept { ::close(fd); });
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) ||
+        static_cast<std::uint64_t>(file_stat.st_size) != size) {
+        return false;
+    }
+
+    // The whole file is hashed from the beginning to the end, a bigger read-ahead window saves the seeks
+    // of the disks when several files are verified at once
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+
+    gboolean matches{FALSE};
+    GError * err{nullptr};
+    bool ok = lr_checksum_fd_cmp(
+        static_cast<LrChecksumType>(checksum_type), fd, checksum.c_str(), FALSE, &matches, &err);
+    if (err) {
+        g_error_free(err);
+    }
+    return ok && matches;
+}
+
+
+void verify_file_checksums(std::vector<ChecksumCheck> & checks, std::size_t max_workers) {
+    std::atomic<std::size_t> next_idx{0};
+
+    // The worker must not throw exceptions, a file that cannot be verified does not match
+    auto worker = [&checks, &next_idx]() noexcept {
+        for (auto idx = next_idx++; idx < checks.size(); idx = next_idx++) {
+            auto & check = checks[idx];
+            try {
+                check.matches = verify_file_checksum(check.path, check.checksum_type, check.checksum, check.size);
+            } catch (...) {
+                check.matches = false;
+            }
+        }
+    };
+
+    const auto num_workers = std::clamp<std::size_t>(max_workers, 1, std::max<std::size_t>(checks.size(), 1));
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers - 1);
+    for (std::size_t i = 1; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    // The calling thread is one of the workers
+    worker();
+    for (auto & thread : workers) {
+        thread.join();
+    }
+}
+
+}  // namespace libdnf5::repo
@@ -0,0 +1,61 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_REPO_CHECKSUM_VERIFIER_HPP
+#define LIBDNF5_REPO_CHECKSUM_VERIFIER_HPP
+
+#include "libdnf5/rpm/checksum.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+/// Verification of a file against the checksum of a package
+struct ChecksumCheck {
+    std::filesystem::path path;
+    libdnf5::rpm::Checksum::Type checksum_type{libdnf5::rpm::Checksum::Type::UNKNOWN};
+    /// Checksum in hex
+    std::string checksum;
+    std::uint64_t size{0};
+    /// Result of the verification
+    bool matches{false};
+};
+
+/// Returns whether the file at `path` has the `size` and the `checksum`. The size is checked first, the file is
+/// read only when it matches. The kernel is advised to read the file ahead sequentially. The hash is computed
+/// by librepo, whose OpenSSL backend uses the SHA extensions of x86_64 and the cryptography extensions of ARMv8
+/// when the CPU has them.
+bool verify_file_checksum(
+    const std::filesystem::path & path,
+    libdnf5::rpm::Checksum::Type checksum_type,
+    const std::string & checksum,
+    std::uint64_t size);
+
+/// Sets the `matches` of the `checks`, the files are verified by up to `max_workers` threads at once. The function
+/// does not use the package pool, it can be called with paths and checksums collected beforehand.
+void verify_file_checksums(std::vector<ChecksumCheck> & checks, std::size_t max_workers);
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_CHECKSUM_VERIFIER_HPP
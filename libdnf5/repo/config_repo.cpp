@@ -28,13 +28,38 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <solv/util.h>
 
 #include <filesystem>
+#include <string_view>
 
 namespace libdnf5::repo {
 
 class ConfigRepo::Impl {
     friend class ConfigRepo;
 
-    Impl(Config & owner, ConfigMain & main_config, const std::string & id);
+    Impl(ConfigMain & main_config, const std::string & id) : main_config(main_config), id(id) {}
+
+    /// Binding of an option name to an option, the `new_string` function processes a new value instead of
+    /// `Option::set()` when it is set
+    struct OptionDescriptor {
+        std::string_view name;
+        Option & (*get_option)(Impl & impl);
+        void (*new_string)(Impl & impl, Option::Priority priority, const std::string & value);
+        bool add_value;
+    };
+
+    /// The bindings of all the repo options, shared by all the instances
+    static const OptionDescriptor OPTIONS[];
+
+    static const OptionDescriptor * find_option(std::string_view name);
+
+    template <auto member>
+    static Option & get_option(Impl & impl) {
+        return impl.*member;
+    }
+
+    static void append_excludepkgs(Impl & impl, Option::Priority priority, const std::string & value);
+    static void append_includepkgs(Impl & impl, Option::Priority priority, const std::string & value);
+    static void set_proxy(Impl & impl, Option::Priority priority, const std::string & value);
+    static void set_proxy_auth_method(Impl & impl, Option::Priority priority, const std::string & value);
 
     ConfigMain & main_config;
     std::string id;
@@ -68,6 +93,8 @@ class ConfigRepo::Impl {
     OptionChild<OptionNumber<float>> throttle{main_config.get_throttle_option()};
     OptionChild<OptionSeconds> timeout{main_config.get_timeout_option()};
     OptionChild<OptionNumber<std::uint32_t>> max_parallel_downloads{main_config.get_max_parallel_downloads_option()};
+    OptionChild<OptionNumber<std::uint32_t>> max_downloads_per_mirror{
+        main_config.get_max_downloads_per_mirror_option()};
     OptionChild<OptionSeconds> metadata_expire{main_config.get_metadata_expire_option()};
     OptionNumber<std::int32_t> cost{1000};
     OptionNumber<std::int32_t> priority{99};
@@ -90,116 +117,97 @@ class ConfigRepo::Impl {
     OptionChild<OptionBool> build_cache{main_config.get_build_cache_option()};
 };
 
-ConfigRepo::Impl::Impl(Config & owner, ConfigMain & main_config, const std::string & id)
-    : main_config(main_config),
-      id(id) {
-    owner.opt_binds().add("name", name);
-    owner.opt_binds().add("enabled", enabled);
-    owner.opt_binds().add("cachedir", basecachedir);
-    owner.opt_binds().add("baseurl", baseurl);
-    owner.opt_binds().add("mirrorlist", mirrorlist);
-    owner.opt_binds().add("metalink", metalink);
-    owner.opt_binds().add("type", type);
-    owner.opt_binds().add("mediaid", mediaid);
-    owner.opt_binds().add("gpgkey", gpgkey);
-
-    owner.opt_binds().add(
-        "excludepkgs",
-        excludepkgs,
-        [&](Option::Priority priority, const std::string & value) {
-            option_T_list_append(excludepkgs, priority, value);
-        },
-        nullptr,
-        true);
-    //compatibility with yum
-    owner.opt_binds().add(
-        "exclude",
-        excludepkgs,
-        [&](Option::Priority priority, const std::string & value) {
-            option_T_list_append(excludepkgs, priority, value);
-        },
-        nullptr,
-        true);
-
-    owner.opt_binds().add(
-        "includepkgs",
-        includepkgs,
-        [&](Option::Priority priority, const std::string & value) {
-            option_T_list_append(includepkgs, priority, value);
-        },
-        nullptr,
-        true);
-
-    owner.opt_binds().add("fastestmirror", fastestmirror);
-
-    owner.opt_binds().add(
-        "proxy",
-        proxy,
-        [&](Option::Priority priority, const std::string & value) {
-            auto tmp_value(value);
-            for (auto & ch : tmp_value) {
-                ch = static_cast<char>(std::tolower(ch));
-            }
-            if (tmp_value == "_none_") {
-                proxy.set(priority, "");
-            } else {
-                proxy.set(priority, value);
-            }
-        },
-        nullptr,
-        false);
-
-    owner.opt_binds().add("proxy_username", proxy_username);
-    owner.opt_binds().add("proxy_password", proxy_password);
-
-    owner.opt_binds().add(
-        "proxy_auth_method",
-        proxy_auth_method,
-        [&](Option::Priority priority, const std::string & value) {
-            if (priority >= proxy_auth_method.get_priority()) {
-                auto tmp = value;
-                std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
-                proxy_auth_method.set(priority, tmp);
-            }
-        },
-        nullptr,
-        false);
-
-    owner.opt_binds().add("username", username);
-    owner.opt_binds().add("password", password);
-    owner.opt_binds().add("protected_packages", protected_packages);
-    owner.opt_binds().add("gpgcheck", gpgcheck);
-    owner.opt_binds().add("repo_gpgcheck", repo_gpgcheck);
-    owner.opt_binds().add("enablegroups", enablegroups);
-    owner.opt_binds().add("retries", retries);
-    owner.opt_binds().add("bandwidth", bandwidth);
-    owner.opt_binds().add("minrate", minrate);
-    owner.opt_binds().add("ip_resolve", ip_resolve);
-    owner.opt_binds().add("throttle", throttle);
-    owner.opt_binds().add("timeout", timeout);
-    owner.opt_binds().add("max_parallel_downloads", max_parallel_downloads);
-    owner.opt_binds().add("metadata_expire", metadata_expire);
-    owner.opt_binds().add("cost", cost);
-    owner.opt_binds().add("priority", priority);
-    owner.opt_binds().add("module_hotfixes", module_hotfixes);
-    owner.opt_binds().add("sslcacert", sslcacert);
-    owner.opt_binds().add("sslverify", sslverify);
-    owner.opt_binds().add("sslclientcert", sslclientcert);
-    owner.opt_binds().add("sslclientkey", sslclientkey);
-    owner.opt_binds().add("proxy_sslcacert", proxy_sslcacert);
-    owner.opt_binds().add("proxy_sslverify", proxy_sslverify);
-    owner.opt_binds().add("proxy_sslclientcert", proxy_sslclientcert);
-    owner.opt_binds().add("proxy_sslclientkey", proxy_sslclientkey);
-    owner.opt_binds().add("deltarpm", deltarpm);
-    owner.opt_binds().add("deltarpm_percentage", deltarpm_percentage);
-    owner.opt_binds().add("skip_if_unavailable", skip_if_unavailable);
-    owner.opt_binds().add("enabled_metadata", enabled_metadata);
-    owner.opt_binds().add("user_agent", user_agent);
-    owner.opt_binds().add("countme", countme);
-    owner.opt_binds().add("build_cache", build_cache);
-}
-
-ConfigRepo::ConfigRepo(ConfigMain & main_config, const std::string & id) : p_impl(new Impl(*this, main_config, id)) {}
+const ConfigRepo::Impl::OptionDescriptor ConfigRepo::Impl::OPTIONS[] = {
+    {"name", &get_option<&Impl::name>, nullptr, false},
+    {"enabled", &get_option<&Impl::enabled>, nullptr, false},
+    {"cachedir", &get_option<&Impl::basecachedir>, nullptr, false},
+    {"baseurl", &get_option<&Impl::baseurl>, nullptr, false},
+    {"mirrorlist", &get_option<&Impl::mirrorlist>, nullptr, false},
+    {"metalink", &get_option<&Impl::metalink>, nullptr, false},
+    {"type", &get_option<&Impl::type>, nullptr, false},
+    {"mediaid", &get_option<&Impl::mediaid>, nullptr, false},
+    {"gpgkey", &get_option<&Impl::gpgkey>, nullptr, false},
+    {"excludepkgs", &get_option<&Impl::excludepkgs>, append_excludepkgs, true},
+    {"exclude", &get_option<&Impl::excludepkgs>, append_excludepkgs, true},
+    {"includepkgs", &get_option<&Impl::includepkgs>, append_includepkgs, true},
+    {"fastestmirror", &get_option<&Impl::fastestmirror>, nullptr, false},
+    {"proxy", &get_option<&Impl::proxy>, set_proxy, false},
+    {"proxy_username", &get_option<&Impl::proxy_username>, nullptr, false},
+    {"proxy_password", &get_option<&Impl::proxy_password>, nullptr, false},
+    {"proxy_auth_method", &get_option<&Impl::proxy_auth_method>, set_proxy_auth_method, false},
+    {"username", &get_option<&Impl::username>, nullptr, false},
+    {"password", &get_option<&Impl::password>, nullptr, false},
+    {"protected_packages", &get_option<&Impl::protected_packages>, nullptr, false},
+    {"gpgcheck", &get_option<&Impl::gpgcheck>, nullptr, false},
+    {"repo_gpgcheck", &get_option<&Impl::repo_gpgcheck>, nullptr, false},
+    {"enablegroups", &get_option<&Impl::enablegroups>, nullptr, false},
+    {"retries", &get_option<&Impl::retries>, nullptr, false},
+    {"bandwidth", &get_option<&Impl::bandwidth>, nullptr, false},
+    {"minrate", &get_option<&Impl::minrate>, nullptr, false},
+    {"ip_resolve", &get_option<&Impl::ip_resolve>, nullptr, false},
+    {"throttle", &get_option<&Impl::throttle>, nullptr, false},
+    {"timeout", &get_option<&Impl::timeout>, nullptr, false},
+    {"max_parallel_downloads", &get_option<&Impl::max_parallel_downloads>, nullptr, false},
+    {"max_downloads_per_mirror", &get_option<&Impl::max_downloads_per_mirror>, nullptr, false},
+    {"metadata_expire", &get_option<&Impl::metadata_expire>, nullptr, false},
+    {"cost", &get_option<&Impl::cost>, nullptr, false},
+    {"priority", &get_option<&Impl::priority>, nullptr, false},
+    {"module_hotfixes", &get_option<&Impl::module_hotfixes>, nullptr, false},
+    {"sslcacert", &get_option<&Impl::sslcacert>, nullptr, false},
+    {"sslverify", &get_option<&Impl::sslverify>, nullptr, false},
+    {"sslclientcert", &get_option<&Impl::sslclientcert>, nullptr, false},
+    {"sslclientkey", &get_option<&Impl::sslclientkey>, nullptr, false},
+    {"proxy_sslcacert", &get_option<&Impl::proxy_sslcacert>, nullptr, false},
+    {"proxy_sslverify", &get_option<&Impl::proxy_sslverify>, nullptr, false},
+    {"proxy_sslclientcert", &get_option<&Impl::proxy_sslclientcert>, nullptr, false},
+    {"proxy_sslclientkey", &get_option<&Impl::proxy_sslclientkey>, nullptr, false},
+    {"deltarpm", &get_option<&Impl::deltarpm>, nullptr, false},
+    {"deltarpm_percentage", &get_option<&Impl::deltarpm_percentage>, nullptr, false},
+    {"skip_if_unavailable", &get_option<&Impl::skip_if_unavailable>, nullptr, false},
+    {"enabled_metadata", &get_option<&Impl::enabled_metadata>, nullptr, false},
+    {"user_agent", &get_option<&Impl::user_agent>, nullptr, false},
+    {"countme", &get_option<&Impl::countme>, nullptr, false},
+    {"build_cache", &get_option<&Impl::build_cache>, nullptr, false},
+};
+
+const ConfigRepo::Impl::OptionDescriptor * ConfigRepo::Impl::find_option(std::string_view name) {
+    for (const auto & descriptor : OPTIONS) {
+        if (descriptor.name == name) {
+            return &descriptor;
+        }
+    }
+    return nullptr;
+}
+
+void ConfigRepo::Impl::append_excludepkgs(Impl & impl, Option::Priority priority, const std::string & value) {
+    option_T_list_append(impl.excludepkgs, priority, value);
+}
+
+void ConfigRepo::Impl::append_includepkgs(Impl & impl, Option::Priority priority, const std::string & value) {
+    option_T_list_append(impl.includepkgs, priority, value);
+}
+
+void ConfigRepo::Impl::set_proxy(Impl & impl, Option::Priority priority, const std::string & value) {
+    auto tmp_value(value);
+    for (auto & ch : tmp_value) {
+        ch = static_cast<char>(std::tolower(ch));
+    }
+    if (tmp_value == "_none_") {
+        impl.proxy.set(priority, "");
+    } else {
+        impl.proxy.set(priority, value);
+    }
+}
+
+void ConfigRepo::Impl::set_proxy_auth_method(Impl & impl, Option::Priority priority, const std::string & value) {
+    if (priority >= impl.proxy_auth_method.get_priority()) {
+        auto tmp = value;
+        std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
+        impl.proxy_auth_method.set(priority, tmp);
+    }
+}
+
+ConfigRepo::ConfigRepo(ConfigMain & main_config, const std::string & id) : p_impl(new Impl(main_config, id)) {}
 ConfigRepo::~ConfigRepo() = default;
 ConfigRepo::ConfigRepo(ConfigRepo && src) : p_impl(std::move(src.p_impl)) {}
 
@@ -416,6 +424,13 @@ const OptionChild<OptionNumber<std::uint32_t>> & ConfigRepo::get_max_parallel_do
     return p_impl->max_parallel_downloads;
 }
 
+OptionChild<OptionNumber<std::uint32_t>> & ConfigRepo::get_max_downloads_per_mirror_option() {
+    return p_impl->max_downloads_per_mirror;
+}
+const OptionChild<OptionNumber<std::uint32_t>> & ConfigRepo::get_max_downloads_per_mirror_option() const {
+    return p_impl->max_downloads_per_mirror;
+}
+
 OptionChild<OptionSeconds> & ConfigRepo::get_metadata_expire_option() {
     return p_impl->metadata_expire;
 }
@@ -606,7 +621,50 @@ void ConfigRepo::load_from_parser(
     const Vars & vars,
     Logger & logger,
     Option::Priority priority) {
-    Config::load_from_parser(parser, section, vars, logger, priority);
+    // The bindings may have been changed by the user, they are used once they exist
+    if (opt_binds_registered()) {
+        Config::load_from_parser(parser, section, vars, logger, priority);
+        return;
+    }
+
+    auto cfg_parser_data_iter = parser.get_data().find(section);
+    if (cfg_parser_data_iter == parser.get_data().end()) {
+        return;
+    }
+    for (const auto & [key, value] : cfg_parser_data_iter->second) {
+        const auto * descriptor = Impl::find_option(key);
+        if (!descriptor) {
+            continue;
+        }
+        try {
+            if (descriptor->new_string) {
+                descriptor->new_string(*p_impl, priority, vars.substitute(value));
+            } else {
+                descriptor->get_option(*p_impl).set(priority, vars.substitute(value));
+            }
+        } catch (const OptionError & ex) {
+            logger.warning("Config error in section \"{}\" key \"{}\": {}", section, key, ex.what());
+        }
+    }
+}
+
+void ConfigRepo::register_opt_binds(OptionBinds & option_binds) {
+    auto * impl = p_impl.get();
+    for (const auto & descriptor : Impl::OPTIONS) {
+        auto & option = descriptor.get_option(*impl);
+        if (descriptor.new_string) {
+            option_binds.add(
+                std::string(descriptor.name),
+                option,
+                [impl, new_string = descriptor.new_string](Option::Priority priority, const std::string & value) {
+                    new_string(*impl, priority, value);
+                },
+                nullptr,
+                descriptor.add_value);
+        } else {
+            option_binds.add(std::string(descriptor.name), option);
+        }
+    }
 }
 
 }  // namespace libdnf5::repo
@@ -0,0 +1,205 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "deltarpm.hpp"
+
+#include "solv/pool.hpp"
+#include "utils/on_scope_exit.hpp"
+#include "utils/string.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+extern "C" {
+#include <solv/chksum.h>
+#include <solv/dataiterator.h>
+#include <solv/knownid.h>
+#include <solv/pool.h>
+#include <solv/repo.h>
+}
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+
+extern char ** environ;
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+constexpr const char * APPLYDELTARPM_PATH = "/usr/bin/applydeltarpm";
+
+LrChecksumType solv_checksum_type_to_lr(Id type) {
+    switch (type) {
+        case REPOKEY_TYPE_MD5:
+            return LR_CHECKSUM_MD5;
+        case REPOKEY_TYPE_SHA1:
+            return LR_CHECKSUM_SHA1;
+        case REPOKEY_TYPE_SHA224:
+            return LR_CHECKSUM_SHA224;
+        case REPOKEY_TYPE_SHA256:
+            return LR_CHECKSUM_SHA256;
+        case REPOKEY_TYPE_SHA384:
+            return LR_CHECKSUM_SHA384;
+        case REPOKEY_TYPE_SHA512:
+            return LR_CHECKSUM_SHA512;
+        default:
+            return LR_CHECKSUM_UNKNOWN;
+    }
+}
+
+}  // namespace
+
+
+bool is_applydeltarpm_available() {
+    return access(APPLYDELTARPM_PATH, X_OK) == 0;
+}
+
+
+std::optional<DeltaRpm> find_delta_rpm(const libdnf5::rpm::Package & package, unsigned max_percentage) {
+    if (max_percentage == 0) {
+        return std::nullopt;
+    }
+
+    auto & pool = get_rpm_pool(package.get_base());
+    ::Pool * spool = *pool;
+    if (!spool->installed) {
+        return std::nullopt;
+    }
+    Solvable * solvable = pool.id2solvable(package.get_id().id);
+    libdnf5::solv::get_repo(solvable).internalize();
+
+    // The versions of the package installed in the system, the bases a delta can be applied to
+    std::vector<Id> installed_evrs;
+    Id installed_id;
+    Solvable * installed_solvable;
+    FOR_REPO_SOLVABLES(spool->installed, installed_id, installed_solvable) {
+        if (installed_solvable->name == solvable->name && installed_solvable->arch == solvable->arch) {
+            installed_evrs.push_back(installed_solvable->evr);
+        }
+    }
+    if (installed_evrs.empty()) {
+        return std::nullopt;
+    }
+
+    std::optional<DeltaRpm> result;
+    Dataiterator di;
+    dataiterator_init(
+        &di, spool, solvable->repo, SOLVID_META, DELTA_PACKAGE_NAME, pool.id2str(solvable->name), SEARCH_STRING);
+    dataiterator_prepend_keyname(&di, REPOSITORY_DELTAINFO);
+    while (dataiterator_step(&di)) {
+        dataiterator_setpos_parent(&di);
+        if (pool_lookup_id(spool, SOLVID_POS, DELTA_PACKAGE_EVR) != solvable->evr ||
+            pool_lookup_id(spool, SOLVID_POS, DELTA_PACKAGE_ARCH) != solvable->arch) {
+            continue;
+        }
+        auto base_evr = pool_lookup_id(spool, SOLVID_POS, DELTA_BASE_EVR);
+        if (std::find(installed_evrs.begin(), installed_evrs.end(), base_evr) == installed_evrs.end()) {
+            continue;
+        }
+        auto download_size = pool_lookup_num(spool, SOLVID_POS, DELTA_DOWNLOADSIZE, 0);
+        if (result && download_size >= result->download_size) {
+            continue;
+        }
+        Id checksum_type{0};
+        const unsigned char * checksum = pool_lookup_bin_checksum(spool, SOLVID_POS, DELTA_CHECKSUM, &checksum_type);
+        if (!checksum) {
+            continue;
+        }
+
+        DeltaRpm delta;
+        delta.location = libdnf5::utils::string::c_to_str(pool_lookup_deltalocation(spool, SOLVID_POS, nullptr));
+        delta.baseurl = libdnf5::utils::string::c_to_str(pool_lookup_str(spool, SOLVID_POS, DELTA_LOCATION_BASE));
+        delta.checksum_type = solv_checksum_type_to_lr(checksum_type);
+        delta.checksum = pool_bin2hex(spool, checksum, solv_chksum_len(checksum_type));
+        delta.download_size = download_size;
+        result = std::move(delta);
+    }
+    dataiterator_free(&di);
+
+    if (result && result->download_size * 100 > package.get_download_size() * max_percentage) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+
+void apply_delta_rpm(
+    const std::string & arch,
+    LrChecksumType checksum_type,
+    const std::string & checksum,
+    const std::string & delta_path,
+    const std::string & rpm_path) try {
+    // The output of the tool is dropped, a failure is reported by its exit status
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    utils::OnScopeExit destroy_file_actions(
+        [&file_actions]() noexcept { posix_spawn_file_actions_destroy(&file_actions); });
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&file_actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    std::vector<char *> argv{
+        const_cast<char *>(APPLYDELTARPM_PATH),
+        const_cast<char *>("-a"),
+        const_cast<char *>(arch.c_str()),
+        const_cast<char *>(delta_path.c_str()),
+        const_cast<char *>(rpm_path.c_str()),
+        nullptr};
+    pid_t pid;
+    if (auto err = posix_spawn(&pid, APPLYDELTARPM_PATH, &file_actions, nullptr, argv.data(), environ); err != 0) {
+        throw RuntimeError(M_("Cannot run \"{}\": {}"), std::string(APPLYDELTARPM_PATH), std::string(strerror(err)));
+    }
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            throw RuntimeError(
+                M_("Cannot wait for \"{}\": {}"), std::string(APPLYDELTARPM_PATH), std::string(strerror(errno)));
+        }
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw RuntimeError(M_("Cannot rebuild \"{}\" from delta RPM \"{}\""), rpm_path, delta_path);
+    }
+
+    auto fd = open(rpm_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw RuntimeError(M_("Cannot open rebuilt package \"{}\": {}"), rpm_path, std::string(strerror(errno)));
+    }
+    utils::OnScopeExit close_fd([fd]() noexcept { ::close(fd); });
+    gboolean matches{FALSE};
+    if (!lr_checksum_fd_cmp(checksum_type, fd, checksum.c_str(), FALSE, &matches, nullptr) || !matches) {
+        throw RuntimeError(M_("Checksum of the package \"{}\" rebuilt from delta RPM does not match"), rpm_path);
+    }
+} catch (...) {
+    std::error_code ec;
+    std::filesystem::remove(rpm_path, ec);
+    throw;
+}
+
+}  // namespace libdnf5::repo
@@ -0,0 +1,68 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_DELTARPM_HPP
+#define LIBDNF5_REPO_DELTARPM_HPP
+
+#include "libdnf5/rpm/package.hpp"
+
+#include <librepo/librepo.h>
+
+#include <optional>
+#include <string>
+
+
+namespace libdnf5::repo {
+
+/// Delta RPM from the presto metadata of a repository. It rebuilds a package from the files of its installed
+/// base version.
+struct DeltaRpm {
+    std::string location;
+    std::string baseurl;
+    LrChecksumType checksum_type{LR_CHECKSUM_UNKNOWN};
+    std::string checksum;
+    unsigned long long download_size{0};
+};
+
+/// Returns whether the `applydeltarpm` tool rebuilding the packages from delta RPMs is installed
+bool is_applydeltarpm_available();
+
+/// Returns the smallest delta RPM of the `package` from the presto metadata of its repository whose base version
+/// is installed. Nothing is returned when there is no such delta or when its size exceeds `max_percentage` percent
+/// of the size of the package.
+std::optional<DeltaRpm> find_delta_rpm(const libdnf5::rpm::Package & package, unsigned max_percentage);
+
+/// Rebuilds the package file `rpm_path` from the delta RPM at `delta_path` and the installed files of the base
+/// version using `applydeltarpm`, the rebuilt file is checked against the checksum of the package.
+/// It does not access the package pool and can run in a thread other than the one owning the base.
+/// @param arch The architecture of the package.
+/// @param checksum_type The type of the checksum of the package.
+/// @param checksum The checksum of the package in hex format.
+/// @exception libdnf5::RuntimeError When the rebuild fails, the file at `rpm_path` is removed.
+void apply_delta_rpm(
+    const std::string & arch,
+    LrChecksumType checksum_type,
+    const std::string & checksum,
+    const std::string & delta_path,
+    const std::string & rpm_path);
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_DELTARPM_HPP
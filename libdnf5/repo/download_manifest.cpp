@@ -0,0 +1,162 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "download_manifest.hpp"
+
+#include "utils/fs/file.hpp"
+
+#include <sys/stat.h>
+#include <toml.hpp>
+
+#include <optional>
+#include <system_error>
+#include <utility>
+
+
+namespace toml {
+
+template <>
+struct from<libdnf5::repo::DownloadManifest::Record> {
+    static libdnf5::repo::DownloadManifest::Record from_toml(const value & v) {
+        libdnf5::repo::DownloadManifest::Record record;
+
+        record.checksum = toml::find<std::string>(v, "checksum");
+        record.size = static_cast<std::uint64_t>(toml::find<std::int64_t>(v, "size"));
+        record.mtime = toml::find<std::int64_t>(v, "mtime");
+        // The records written by older versions have no inode, they do not match any file
+        record.inode = static_cast<std::uint64_t>(toml::find_or<std::int64_t>(v, "inode", 0));
+
+        return record;
+    }
+};
+
+
+template <>
+struct into<libdnf5::repo::DownloadManifest::Record> {
+    static toml::value into_toml(const libdnf5::repo::DownloadManifest::Record & record) {
+        toml::value res;
+
+        res["checksum"] = record.checksum;
+        res["size"] = static_cast<std::int64_t>(record.size);
+        res["mtime"] = record.mtime;
+        res["inode"] = static_cast<std::int64_t>(record.inode);
+
+        return res;
+    }
+};
+
+}  // namespace toml
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+constexpr const char * FILES_TOML_KEY = "files";
+
+struct FileState {
+    std::int64_t mtime;
+    std::uint64_t size;
+    std::uint64_t inode;
+};
+
+/// Returns the modification time, the size and the inode of the file at `path`, nullopt when the file cannot be
+/// accessed
+std::optional<FileState> get_file_state(const std::filesystem::path & path) {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    struct stat file_stat;
+    if (::stat(path.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+        return std::nullopt;
+    }
+    return FileState{
+        static_cast<std::int64_t>(mtime.time_since_epoch().count()),
+        static_cast<std::uint64_t>(file_stat.st_size),
+        static_cast<std::uint64_t>(file_stat.st_ino)};
+}
+
+}  // namespace
+
+
+DownloadManifest::DownloadManifest(const std::filesystem::path & dir) : path(dir / FILENAME) {
+    try {
+        if (std::filesystem::exists(path)) {
+            records = toml::find<std::map<std::string, Record>>(toml::parse(path), FILES_TOML_KEY);
+        }
+    } catch (const std::exception &) {
+        // A broken manifest is replaced by the next save
+        records.clear();
+        changed = true;
+    }
+}
+
+
+bool DownloadManifest::is_verified(
+    const std::filesystem::path & path, const std::string & checksum, std::uint64_t size) const {
+    auto it = records.find(path.string());
+    if (it == records.end() || it->second.checksum != checksum || it->second.size != size) {
+        return false;
+    }
+    auto state = get_file_state(path);
+    return state && state->mtime == it->second.mtime && state->size == size && state->inode == it->second.inode;
+}
+
+
+void DownloadManifest::set_verified(
+    const std::filesystem::path & path, const std::string & checksum, std::uint64_t size) {
+    auto state = get_file_state(path);
+    if (!state || state->size != size) {
+        return;
+    }
+    records[path.string()] = {checksum, size, state->mtime, state->inode};
+    changed = true;
+}
+
+
+std::string DownloadManifest::get_checksum_id(const libdnf5::rpm::Checksum & checksum) {
+    return checksum.get_type_str() + ":" + checksum.get_checksum();
+}
+
+
+void DownloadManifest::save() {
+    for (auto it = records.begin(); it != records.end();) {
+        if (std::filesystem::exists(it->first)) {
+            ++it;
+        } else {
+            it = records.erase(it);
+            changed = true;
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    // write new contents to a temporary file and then move the new file atomically
+    std::filesystem::create_directories(path.parent_path());
+    auto temporary_path = path.string() + ".temp";
+    utils::fs::File(temporary_path, "w").write(toml::format(toml::value({{FILES_TOML_KEY, records}})));
+    std::filesystem::rename(temporary_path, path);
+    changed = false;
+}
+
+}  // namespace libdnf5::repo
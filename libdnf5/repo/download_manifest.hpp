@@ -0,0 +1,80 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_DOWNLOAD_MANIFEST_HPP
+#define LIBDNF5_REPO_DOWNLOAD_MANIFEST_HPP
+
+#include "libdnf5/rpm/checksum.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+
+namespace libdnf5::repo {
+
+/// Records of the package files whose download finished and which were verified against their checksums, stored
+/// in a TOML file in the cachedir. A rerun of an interrupted download uses a recorded file without reading it
+/// again, when the file still has the recorded inode, size and modification time.
+class DownloadManifest {
+public:
+    /// Filename in which the records are stored.
+    static constexpr const char * FILENAME = "download_manifest.toml";
+
+    struct Record {
+        /// Checksum of the file in the "<type>:<hex>" form
+        std::string checksum;
+        std::uint64_t size{0};
+        /// Modification time of the file when it was verified, in ticks of `std::filesystem::file_time_type`
+        std::int64_t mtime{0};
+        /// Inode of the file when it was verified, a file replaced by another one of the same size and
+        /// modification time is not verified by the record
+        std::uint64_t inode{0};
+    };
+
+    /// Returns the `checksum` in the "<type>:<hex>" form used by the records.
+    static std::string get_checksum_id(const libdnf5::rpm::Checksum & checksum);
+
+    /// Loads the records from the manifest in `dir`. A missing or broken manifest gives no records, the manifest
+    /// is only a hint.
+    explicit DownloadManifest(const std::filesystem::path & dir);
+
+    /// Returns whether the file at `path` was verified to have the `checksum` and the `size` and it was not changed
+    /// since then. Only the metadata of the file are read.
+    bool is_verified(const std::filesystem::path & path, const std::string & checksum, std::uint64_t size) const;
+
+    /// Records that the file at `path` was verified to have the `checksum` and the `size`.
+    void set_verified(const std::filesystem::path & path, const std::string & checksum, std::uint64_t size);
+
+    /// Writes the records to the manifest when they changed, the records of the files that no longer exist are
+    /// dropped. The manifest is replaced atomically.
+    /// @exception std::filesystem::filesystem_error When an error occurs during writing the manifest.
+    void save();
+
+private:
+    std::filesystem::path path;
+    std::map<std::string, Record> records;
+    bool changed{false};
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_DOWNLOAD_MANIFEST_HPP
@@ -146,8 +146,10 @@ void FileDownloader::download() try {
     std::vector<std::unique_ptr<LrDownloadTarget>> lr_targets;
     lr_targets.reserve(p_impl->targets.size());
 
-    LibrepoHandle local_handle;
-    local_handle.init_remote(config);
+    // The handle for the targets without a repository comes from the process-wide pool, the downloads with
+    // the same transfer settings do not set up a new one
+    auto & handle_pool = LibrepoHandlePool::get_instance();
+    auto local_handle = handle_pool.acquire(config);
 
     auto * download_callbacks = p_impl->base->get_download_callbacks();
 
@@ -156,7 +158,7 @@ void FileDownloader::download() try {
         if (file_target.repo.is_valid()) {
             handle = file_target.repo->downloader->get_cached_handle().get();
         } else {
-            handle = local_handle.get();
+            handle = local_handle.get().get();
         }
 
         if (download_callbacks) {
@@ -198,6 +200,10 @@ void FileDownloader::download() try {
     if (!lr_download(list, p_impl->fail_fast, &err)) {
         throw LibrepoError(std::unique_ptr<GError>(err));
     }
+
+    auto pool_stats = handle_pool.get_stats();
+    p_impl->base->get_logger()->debug(
+        "Librepo handle pool: {} handles created, {} reused", pool_stats.created, pool_stats.reused);
 } catch (const RepoCacheonlyError & e) {
     throw;
 } catch (const std::runtime_error & e) {
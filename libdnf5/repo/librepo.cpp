@@ -19,9 +19,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "librepo.hpp"
 
+#include "libdnf5/repo/config_repo.hpp"
 #include "libdnf5/repo/repo_errors.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <string_view>
+
 namespace libdnf5::repo {
 
 // Map string from config option proxy_auth_method to librepo LrAuth value
@@ -108,6 +111,24 @@ LibrepoHandle & LibrepoHandle::operator=(LibrepoHandle && other) noexcept {
     return *this;
 }
 
+static const libdnf5::ConfigMain & get_main_config(const libdnf5::ConfigMain & config) {
+    return config;
+}
+
+static const libdnf5::ConfigMain & get_main_config(const libdnf5::repo::ConfigRepo & config) {
+    return config.get_main_config();
+}
+
+/// Returns the download speed limit of the background mode, 0 when the mode is disabled or the speed is not limited
+template <typename C>
+static float get_background_maxspeed(const C & config) {
+    const auto & main_config = get_main_config(config);
+    if (!main_config.get_background_mode_option().get_value()) {
+        return 0;
+    }
+    return static_cast<float>(main_config.get_background_bandwidth_option().get_value());
+}
+
 template <typename C>
 static void init_remote(LibrepoHandle & handle, const C & config) {
     handle.set_opt(LRO_USERAGENT, config.get_user_agent_option().get_value().c_str());
@@ -117,6 +138,10 @@ static void init_remote(LibrepoHandle & handle, const C & config) {
     if (maxspeed > 0 && maxspeed <= 1) {
         maxspeed *= static_cast<float>(config.get_bandwidth_option().get_value());
     }
+    auto background_maxspeed = get_background_maxspeed(config);
+    if (background_maxspeed > 0 && (maxspeed == 0 || maxspeed > background_maxspeed)) {
+        maxspeed = background_maxspeed;
+    }
     if (maxspeed != 0 && maxspeed < static_cast<float>(minrate)) {
         // TODO(lukash) not the best class for the error, possibly check in config parser?
         throw libdnf5::repo::RepoDownloadError(
@@ -125,6 +150,8 @@ static void init_remote(LibrepoHandle & handle, const C & config) {
     }
     handle.set_opt(LRO_LOWSPEEDLIMIT, static_cast<int64_t>(minrate));
     handle.set_opt(LRO_MAXSPEED, static_cast<int64_t>(maxspeed));
+    handle.set_opt(
+        LRO_MAXDOWNLOADSPERMIRROR, static_cast<long>(config.get_max_downloads_per_mirror_option().get_value()));
 
     long timeout = config.get_timeout_option().get_value();
     if (timeout > 0) {
@@ -202,6 +229,45 @@ static void init_remote(LibrepoHandle & handle, const C & config) {
 }
 
 
+/// Returns the key of the transfer settings applied by `init_remote()`
+template <typename C>
+static std::string get_remote_key(const C & config) {
+    auto value_or_empty = [](const auto & option) { return option.empty() ? std::string() : option.get_value(); };
+
+    std::string key;
+    auto add = [&key](std::string_view value) {
+        key += value;
+        key.push_back('\n');
+    };
+    add(config.get_user_agent_option().get_value());
+    add(std::to_string(config.get_minrate_option().get_value()));
+    add(std::to_string(config.get_throttle_option().get_value()));
+    add(std::to_string(config.get_bandwidth_option().get_value()));
+    add(std::to_string(get_background_maxspeed(config)));
+    add(std::to_string(config.get_timeout_option().get_value()));
+    add(config.get_ip_resolve_option().get_value());
+    add(config.get_username_option().get_value());
+    add(config.get_password_option().get_value());
+    add(config.get_sslcacert_option().get_value());
+    add(config.get_sslclientcert_option().get_value());
+    add(config.get_sslclientkey_option().get_value());
+    add(config.get_sslverify_option().get_value() ? "1" : "0");
+    add(value_or_empty(config.get_proxy_option()));
+    if (!config.get_proxy_auth_method_option().empty()) {
+        for (const auto & method : config.get_proxy_auth_method_option().get_value()) {
+            add(method);
+        }
+    }
+    add(value_or_empty(config.get_proxy_username_option()));
+    add(value_or_empty(config.get_proxy_password_option()));
+    add(config.get_proxy_sslcacert_option().get_value());
+    add(config.get_proxy_sslclientcert_option().get_value());
+    add(config.get_proxy_sslclientkey_option().get_value());
+    add(config.get_proxy_sslverify_option().get_value() ? "1" : "0");
+    add(std::to_string(config.get_max_downloads_per_mirror_option().get_value()));
+    return key;
+}
+
 void LibrepoHandle::init_remote(const libdnf5::ConfigMain & config) {
     repo::init_remote(*this, config);
 }
@@ -210,6 +276,47 @@ void LibrepoHandle::init_remote(const libdnf5::repo::ConfigRepo & config) {
     repo::init_remote(*this, config);
 }
 
+LibrepoHandlePool::Lease::~Lease() {
+    if (handle) {
+        pool.release(std::move(key), std::move(handle));
+    }
+}
+
+LibrepoHandlePool & LibrepoHandlePool::get_instance() {
+    static LibrepoHandlePool pool;
+    return pool;
+}
+
+LibrepoHandlePool::Lease LibrepoHandlePool::acquire(const libdnf5::ConfigMain & config) {
+    auto key = get_remote_key(config);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = idle_handles.find(key); it != idle_handles.end()) {
+            auto handle = std::move(it->second);
+            idle_handles.erase(it);
+            ++stats.reused;
+            return Lease(*this, std::move(key), std::move(handle));
+        }
+    }
+
+    // The handle is set up outside the lock, it can fail on invalid settings
+    auto handle = std::make_unique<LibrepoHandle>();
+    handle->init_remote(config);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++stats.created;
+    return Lease(*this, std::move(key), std::move(handle));
+}
+
+LibrepoHandlePool::Stats LibrepoHandlePool::get_stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void LibrepoHandlePool::release(std::string && key, std::unique_ptr<LibrepoHandle> && handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle_handles.emplace(std::move(key), std::move(handle));
+}
+
 LibrepoResult LibrepoHandle::perform() {
     LibrepoResult result;
     GError * err_p{nullptr};
@@ -25,7 +25,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <librepo/librepo.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace std {
 
@@ -114,6 +117,61 @@ private:
     LrHandle * handle;
 };
 
+
+/// Process-wide pool of librepo handles initialized by `init_remote()` from the main configuration. The handles
+/// are keyed by the transfer settings applied by `init_remote()` (proxy, TLS, credentials, speed limits, ...),
+/// so the downloads with the same settings reuse a handle instead of setting up a new one.
+///
+/// A handle is leased exclusively, librepo changes the state of the handle during a download.
+class LibrepoHandlePool {
+public:
+    struct Stats {
+        /// Number of the handles created by the pool
+        std::size_t created{0};
+        /// Number of the leases served by an already created handle
+        std::size_t reused{0};
+    };
+
+    /// Exclusive use of a pooled handle, the handle returns to the pool when the lease is destroyed.
+    class Lease {
+    public:
+        Lease(const Lease &) = delete;
+        Lease(Lease && other) noexcept = default;
+        Lease & operator=(const Lease &) = delete;
+        Lease & operator=(Lease &&) = delete;
+        ~Lease();
+
+        LibrepoHandle & get() noexcept { return *handle; }
+
+    private:
+        friend LibrepoHandlePool;
+        Lease(LibrepoHandlePool & pool, std::string && key, std::unique_ptr<LibrepoHandle> && handle)
+            : pool(pool),
+              key(std::move(key)),
+              handle(std::move(handle)) {}
+
+        LibrepoHandlePool & pool;
+        std::string key;
+        std::unique_ptr<LibrepoHandle> handle;
+    };
+
+    static LibrepoHandlePool & get_instance();
+
+    /// Leases a handle with the transfer settings of the `config`.
+    Lease acquire(const libdnf5::ConfigMain & config);
+
+    Stats get_stats();
+
+private:
+    LibrepoHandlePool() = default;
+
+    void release(std::string && key, std::unique_ptr<LibrepoHandle> && handle);
+
+    std::mutex mutex;
+    std::multimap<std::string, std::unique_ptr<LibrepoHandle>> idle_handles;
+    Stats stats;
+};
+
 }  // namespace libdnf5::repo
 
 #endif  // LIBDNF5_REPO_LIBREPO_PRIVATE_HPP
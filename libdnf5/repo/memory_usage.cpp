@@ -0,0 +1,75 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/repo/memory_usage.hpp"
+
+#include <fmt/format.h>
+
+
+namespace libdnf5::repo {
+
+std::size_t RepoMemoryUsage::get_total_bytes() const noexcept {
+    return solvables_bytes + idarray_bytes + primary_bytes + filelists_bytes + other_bytes + presto_bytes +
+           updateinfo_bytes + comps_bytes;
+}
+
+
+std::size_t MemoryUsage::get_total_bytes() const noexcept {
+    std::size_t total = pool_strings_bytes + pool_reldeps_bytes + pool_whatprovides_bytes + comps_pool_bytes +
+                        module_pool_bytes + sorted_solvables_bytes + package_indexes_bytes + considered_maps_bytes +
+                        package_caches_bytes + advisory_caches_bytes;
+    for (const auto & repo : repos) {
+        total += repo.get_total_bytes();
+    }
+    return total;
+}
+
+
+std::string MemoryUsage::to_string() const {
+    auto mib = [](std::size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+
+    std::string out;
+    for (const auto & repo : repos) {
+        out += fmt::format(
+            "Repository {} ({} solvables): {:.3f} MiB\n", repo.repo_id, repo.solvables, mib(repo.get_total_bytes()));
+        out += fmt::format("  Solvables:        {:10.3f} MiB\n", mib(repo.solvables_bytes));
+        out += fmt::format("  Id arrays:        {:10.3f} MiB\n", mib(repo.idarray_bytes));
+        out += fmt::format("  Primary:          {:10.3f} MiB\n", mib(repo.primary_bytes));
+        out += fmt::format("  Filelists:        {:10.3f} MiB\n", mib(repo.filelists_bytes));
+        out += fmt::format("  Other:            {:10.3f} MiB\n", mib(repo.other_bytes));
+        out += fmt::format("  Presto:           {:10.3f} MiB\n", mib(repo.presto_bytes));
+        out += fmt::format("  Updateinfo:       {:10.3f} MiB\n", mib(repo.updateinfo_bytes));
+        out += fmt::format("  Comps:            {:10.3f} MiB\n", mib(repo.comps_bytes));
+    }
+    out += fmt::format("Pool strings:       {:10.3f} MiB\n", mib(pool_strings_bytes));
+    out += fmt::format("Pool reldeps:       {:10.3f} MiB\n", mib(pool_reldeps_bytes));
+    out += fmt::format("Pool whatprovides:  {:10.3f} MiB\n", mib(pool_whatprovides_bytes));
+    out += fmt::format("Comps pool:         {:10.3f} MiB\n", mib(comps_pool_bytes));
+    out += fmt::format("Module pool:        {:10.3f} MiB\n", mib(module_pool_bytes));
+    out += fmt::format("Sorted solvables:   {:10.3f} MiB\n", mib(sorted_solvables_bytes));
+    out += fmt::format("Package indexes:    {:10.3f} MiB\n", mib(package_indexes_bytes));
+    out += fmt::format("Considered maps:    {:10.3f} MiB\n", mib(considered_maps_bytes));
+    out += fmt::format("Package caches:     {:10.3f} MiB\n", mib(package_caches_bytes));
+    out += fmt::format("Advisory caches:    {:10.3f} MiB\n", mib(advisory_caches_bytes));
+    out += fmt::format("Total:              {:10.3f} MiB\n", mib(get_total_bytes()));
+    return out;
+}
+
+}  // namespace libdnf5::repo
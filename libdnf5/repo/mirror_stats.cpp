@@ -0,0 +1,222 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "mirror_stats.hpp"
+
+#include "utils/fs/file.hpp"
+
+#include "libdnf5/base/base.hpp"
+
+#include <toml.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+
+namespace toml {
+
+template <>
+struct from<libdnf5::repo::MirrorStats::Record> {
+    static libdnf5::repo::MirrorStats::Record from_toml(const value & v) {
+        libdnf5::repo::MirrorStats::Record record;
+
+        record.latency = toml::find_or<double>(v, "latency", 0);
+        record.throughput = toml::find_or<double>(v, "throughput", 0);
+        record.failure_rate = toml::find_or<double>(v, "failure_rate", 0);
+        record.successes = toml::find_or<std::int64_t>(v, "successes", 0);
+        record.failures = toml::find_or<std::int64_t>(v, "failures", 0);
+
+        return record;
+    }
+};
+
+
+template <>
+struct into<libdnf5::repo::MirrorStats::Record> {
+    static toml::value into_toml(const libdnf5::repo::MirrorStats::Record & record) {
+        toml::value res;
+
+        res["latency"] = record.latency;
+        res["throughput"] = record.throughput;
+        res["failure_rate"] = record.failure_rate;
+        res["successes"] = record.successes;
+        res["failures"] = record.failures;
+
+        return res;
+    }
+};
+
+}  // namespace toml
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+constexpr const char * MIRRORS_TOML_KEY = "mirrors";
+
+/// Time in seconds lost by a failed download before it is retried on another mirror, the default timeout
+constexpr double FAILURE_COST = 30;
+
+double ewma(double average, double sample) {
+    return average == 0 ? sample : (1 - MirrorStats::EWMA_WEIGHT) * average + MirrorStats::EWMA_WEIGHT * sample;
+}
+
+/// Returns the rank of the mirror in the order of the mirrors, lower is better. The first item is the group
+/// of the mirror: measured, succeeded without measurements, unknown and only failed. The second one orders
+/// the mirrors within the group.
+std::tuple<int, double> get_rank(const MirrorStats::Record * record) {
+    if (!record) {
+        return {2, 0};
+    }
+    if (record->successes == 0) {
+        return {3, static_cast<double>(record->failures)};
+    }
+    if (record->latency <= 0 && record->throughput <= 0) {
+        return {1, record->failure_rate};
+    }
+    double expected_time = record->latency;
+    if (record->throughput > 0) {
+        expected_time += MirrorStats::REFERENCE_DOWNLOAD_SIZE / record->throughput;
+    }
+    return {0, expected_time + FAILURE_COST * record->failure_rate};
+}
+
+}  // namespace
+
+
+std::string MirrorStats::get_mirror_key(std::string_view url) {
+    auto host_start = url.find("://");
+    host_start = host_start == std::string_view::npos ? 0 : host_start + 3;
+    auto host_end = url.find('/', host_start);
+    return std::string(url.substr(0, host_end));
+}
+
+
+void MirrorStats::add_success(std::string_view url, double latency, double throughput) {
+    if (!is_enabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+    auto & record = records[get_mirror_key(url)];
+    if (latency > 0) {
+        record.latency = ewma(record.latency, latency);
+    }
+    if (throughput > 0) {
+        record.throughput = ewma(record.throughput, throughput);
+    }
+    record.failure_rate *= 1 - EWMA_WEIGHT;
+    ++record.successes;
+    changed = true;
+}
+
+
+void MirrorStats::add_failure(std::string_view url) {
+    if (!is_enabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+    auto & record = records[get_mirror_key(url)];
+    record.failure_rate = (1 - EWMA_WEIGHT) * record.failure_rate + EWMA_WEIGHT;
+    ++record.failures;
+    changed = true;
+}
+
+
+std::optional<MirrorStats::Record> MirrorStats::get_record(std::string_view url) {
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+    auto it = records.find(get_mirror_key(url));
+    if (it == records.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+
+bool MirrorStats::sort_urls(std::vector<std::string> & urls) {
+    if (!is_enabled() || urls.size() < 2) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+
+    std::vector<std::pair<std::tuple<int, double>, std::string>> ranked_urls;
+    ranked_urls.reserve(urls.size());
+    bool known{false};
+    for (auto & url : urls) {
+        auto it = records.find(get_mirror_key(url));
+        const Record * record = it == records.end() ? nullptr : &it->second;
+        known = known || record;
+        ranked_urls.emplace_back(get_rank(record), std::move(url));
+    }
+    std::stable_sort(ranked_urls.begin(), ranked_urls.end(), [](const auto & lhs, const auto & rhs) {
+        return lhs.first < rhs.first;
+    });
+    for (std::size_t idx = 0; idx < urls.size(); ++idx) {
+        urls[idx] = std::move(ranked_urls[idx].second);
+    }
+    return known;
+}
+
+
+void MirrorStats::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!changed) {
+        return;
+    }
+    try {
+        std::filesystem::create_directories(path.parent_path());
+        // write new contents to a temporary file and then move the new file atomically
+        auto temporary_path = path.string() + ".temp";
+        utils::fs::File(temporary_path, "w").write(toml::format(toml::value({{MIRRORS_TOML_KEY, records}})));
+        std::filesystem::rename(temporary_path, path);
+        changed = false;
+    } catch (const std::exception & ex) {
+        base->get_logger()->debug("Cannot save mirror statistics to \"{}\": {}", path.string(), ex.what());
+    }
+}
+
+
+bool MirrorStats::is_enabled() const {
+    return base->get_config().get_mirror_stats_option().get_value();
+}
+
+
+void MirrorStats::load() {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    path = std::filesystem::path(base->get_config().get_cachedir_option().get_value()) / FILENAME;
+    try {
+        if (std::filesystem::exists(path)) {
+            records = toml::find<std::map<std::string, Record>>(toml::parse(path), MIRRORS_TOML_KEY);
+        }
+    } catch (const std::exception & ex) {
+        base->get_logger()->warning(
+            "Cannot load mirror statistics from \"{}\", starting from scratch: {}", path.string(), ex.what());
+        records.clear();
+    }
+}
+
+}  // namespace libdnf5::repo
@@ -0,0 +1,110 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_MIRROR_STATS_HPP
+#define LIBDNF5_REPO_MIRROR_STATS_HPP
+
+#include "libdnf5/base/base_weak.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+/// Download statistics of the mirrors collected across runs and stored in a TOML file in the cachedir. They are
+/// used to put the mirrors that were fast and reliable in the past first. A mirror is identified by the scheme
+/// and the host of its URL, so the statistics are shared by all the repositories served by the host.
+///
+/// Nothing is recorded and the mirrors are not reordered when the `mirror_stats` option is disabled.
+/// The file is loaded on the first use and written by `save()`. All the methods are thread-safe.
+class MirrorStats {
+public:
+    /// Filename in which the statistics are stored.
+    static constexpr const char * FILENAME = "mirror_stats.toml";
+
+    /// Weight of a new sample in the exponentially weighted moving averages.
+    static constexpr double EWMA_WEIGHT = 0.3;
+
+    /// Size of the download used to compare the mirrors, the expected time of such a download is the latency
+    /// plus the time of the transfer at the average throughput.
+    static constexpr double REFERENCE_DOWNLOAD_SIZE = 1024 * 1024;
+
+    struct Record {
+        /// Moving average of the time to the first byte of a download in seconds, 0 when not measured yet
+        double latency{0};
+        /// Moving average of the download speed in bytes per second, 0 when not measured yet
+        double throughput{0};
+        /// Moving average of the download failures, from 0 (no failures) to 1 (all the downloads failed)
+        double failure_rate{0};
+        std::int64_t successes{0};
+        std::int64_t failures{0};
+    };
+
+    explicit MirrorStats(const libdnf5::BaseWeakPtr & base) : base(base) {}
+    MirrorStats(const MirrorStats &) = delete;
+    MirrorStats & operator=(const MirrorStats &) = delete;
+
+    /// Returns the key of the mirror serving the `url`, its scheme and host.
+    static std::string get_mirror_key(std::string_view url);
+
+    /// Records a successful download from the mirror serving the `url`.
+    /// @param latency Time to the first byte in seconds, not recorded when not positive.
+    /// @param throughput Download speed in bytes per second, not recorded when not positive.
+    void add_success(std::string_view url, double latency, double throughput);
+
+    /// Records a failed download from the mirror serving the `url`.
+    void add_failure(std::string_view url);
+
+    /// Returns the statistics of the mirror serving the `url`.
+    std::optional<Record> get_record(std::string_view url);
+
+    /// Reorders the `urls` by the statistics of their mirrors. The mirrors that succeeded before go first, the fastest
+    /// one first, then the unknown mirrors and the mirrors that only failed go last. The order of the mirrors with
+    /// equal statistics is kept.
+    /// @return `true` when any of the mirrors has statistics.
+    bool sort_urls(std::vector<std::string> & urls);
+
+    /// Writes the statistics to the file when they changed. The file is replaced atomically. Errors are logged,
+    /// the statistics are only a hint.
+    void save();
+
+private:
+    bool is_enabled() const;
+    /// Loads the statistics from the file, the caller holds the mutex.
+    void load();
+
+    libdnf5::BaseWeakPtr base;
+    std::mutex mutex;
+    std::filesystem::path path;
+    bool loaded{false};
+    bool changed{false};
+    std::map<std::string, Record> records;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_MIRROR_STATS_HPP
@@ -19,8 +19,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/repo/package_downloader.hpp"
 
+#include "base/base_impl.hpp"
+#include "deltarpm.hpp"
+#include "checksum_verifier.hpp"
+#include "download_manifest.hpp"
+#include "mirror_stats.hpp"
+#include "package_store.hpp"
 #include "repo_downloader.hpp"
 #include "temp_files_memory.hpp"
+#include "utils/on_scope_exit.hpp"
 
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/common/exception.hpp"
@@ -31,8 +38,17 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <librepo/librepo.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <list>
+#include <thread>
+#include <unordered_set>
 
 
 namespace std {
@@ -54,16 +70,103 @@ public:
           destination(destination),
           user_data(user_data) {}
 
+    /// Path of the downloaded package file
+    std::filesystem::path get_package_path() const {
+        return std::filesystem::path(destination) / std::filesystem::path(package.get_location()).filename();
+    }
+
+    /// Path of the downloaded delta RPM file
+    std::filesystem::path get_delta_path() const {
+        return std::filesystem::path(destination) / std::filesystem::path(delta->location).filename();
+    }
+
     libdnf5::rpm::Package package;
     std::string destination;
     void * user_data;
     void * user_cb_data{nullptr};
+    const std::function<void(const libdnf5::rpm::Package & package)> * downloaded_callback{nullptr};
+    /// The delta RPM downloaded instead of the package, the package is rebuilt from it after the download
+    std::optional<DeltaRpm> delta;
+    /// Bytes transferred for the package by all its downloads
+    double transferred{0};
+    /// Downloaded bytes reported by the last progress callback of the current download
+    double last_downloaded{0};
+    /// The package file was downloaded and verified against its checksum
+    bool verified{false};
+    /// Time of the first progress report of the download, the start of its span
+    std::optional<std::chrono::steady_clock::time_point> start_time;
+};
+
+class SegmentedDownload;
+
+/// Byte range of a package downloaded from one mirror
+struct DownloadSegment {
+    SegmentedDownload * download;
+    std::size_t index;
+    /// The first and the last byte of the range, inclusive
+    std::uint64_t start;
+    std::uint64_t end;
+    double downloaded{0};
+    bool done{false};
+    /// Mirror URL of the package used by the current attempt
+    std::string url{};
+    /// Times of the first progress report, of the first downloaded byte and of the end of the current attempt
+    std::optional<std::chrono::steady_clock::time_point> start_time{};
+    std::optional<std::chrono::steady_clock::time_point> first_byte_time{};
+    std::optional<std::chrono::steady_clock::time_point> end_time{};
+};
+
+/// Package downloaded in byte range segments from several mirrors in parallel, the segments are concatenated
+/// into the package file after the download
+class SegmentedDownload {
+public:
+    SegmentedDownload(PackageTarget & pkg_target, std::vector<std::string> && mirror_urls, std::size_t max_segments)
+        : pkg_target(&pkg_target),
+          mirror_urls(std::move(mirror_urls)) {
+        const std::uint64_t size = pkg_target.package.get_download_size();
+        const auto count = std::min(max_segments, this->mirror_urls.size());
+        const auto segment_size = (size + count - 1) / count;
+        segments.reserve(count);
+        for (std::size_t idx = 0; idx < count && idx * segment_size < size; ++idx) {
+            segments.push_back(
+                {this, idx, idx * segment_size, std::min<std::uint64_t>((idx + 1) * segment_size, size) - 1});
+        }
+    }
+    SegmentedDownload(const SegmentedDownload &) = delete;
+    SegmentedDownload & operator=(const SegmentedDownload &) = delete;
+
+    /// Path of the downloaded file of the segment
+    std::filesystem::path get_segment_path(const DownloadSegment & segment) const {
+        auto path = pkg_target->get_package_path();
+        path += ".segment" + std::to_string(segment.index);
+        return path;
+    }
+
+    PackageTarget * pkg_target;
+    std::vector<std::string> mirror_urls;
+    std::vector<DownloadSegment> segments;
 };
 
 static int end_callback(void * data, LrTransferStatus status, const char * msg) {
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
+    auto & span_recorder = package_target->package.get_base()->get_span_recorder();
+    if (span_recorder.is_enabled() && package_target->start_time) {
+        span_recorder.add(
+            "download package",
+            package_target->package.get_full_nevra(),
+            *package_target->start_time,
+            std::chrono::steady_clock::now());
+    }
+    package_target->start_time.reset();
+    // A delta RPM is verified, the package is verified after it is rebuilt
+    if (status != LR_TRANSFER_ERROR && !package_target->delta) {
+        package_target->verified = true;
+    }
+    if (package_target->downloaded_callback && status != LR_TRANSFER_ERROR) {
+        (*package_target->downloaded_callback)(package_target->package);
+    }
     auto cb_status = static_cast<DownloadCallbacks::TransferStatus>(status);
     if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
         return download_callbacks->end(package_target->user_cb_data, cb_status, msg);
@@ -75,6 +178,11 @@ static int progress_callback(void * data, double total_to_download, double downl
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
+    if (!package_target->start_time) {
+        package_target->start_time = std::chrono::steady_clock::now();
+    }
+    package_target->transferred += std::max(downloaded - package_target->last_downloaded, 0.0);
+    package_target->last_downloaded = downloaded;
     if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
         return download_callbacks->progress(package_target->user_cb_data, total_to_download, downloaded);
     }
@@ -85,12 +193,82 @@ static int mirror_failure_callback(void * data, const char * msg, const char * u
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
+    if (url) {
+        InternalBaseUser::get_mirror_stats(package_target->package.get_base()).add_failure(url);
+    }
     if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
         return download_callbacks->mirror_failure(package_target->user_cb_data, msg, url, nullptr);
     }
     return 0;
 }
 
+static int segment_end_callback(void * data, LrTransferStatus status, [[maybe_unused]] const char * msg) {
+    libdnf_assert(data != nullptr, "data in callback must be set");
+
+    // The download of the package ends after the segments are concatenated
+    auto * segment = static_cast<DownloadSegment *>(data);
+    segment->done = status != LR_TRANSFER_ERROR;
+    segment->end_time = std::chrono::steady_clock::now();
+    return 0;
+}
+
+static int segment_progress_callback(void * data, [[maybe_unused]] double total_to_download, double downloaded) {
+    libdnf_assert(data != nullptr, "data in callback must be set");
+
+    auto * segment = static_cast<DownloadSegment *>(data);
+    auto now = std::chrono::steady_clock::now();
+    if (!segment->start_time) {
+        segment->start_time = now;
+    }
+    if (downloaded > 0 && !segment->first_byte_time) {
+        segment->first_byte_time = now;
+    }
+    auto & pkg_target = *segment->download->pkg_target;
+    pkg_target.transferred += std::max(downloaded - segment->downloaded, 0.0);
+    segment->downloaded = downloaded;
+    if (auto * download_callbacks = pkg_target.package.get_base()->get_download_callbacks()) {
+        double package_downloaded{0};
+        for (const auto & item : segment->download->segments) {
+            package_downloaded += item.downloaded;
+        }
+        return download_callbacks->progress(
+            pkg_target.user_cb_data, static_cast<double>(pkg_target.package.get_download_size()), package_downloaded);
+    }
+    return 0;
+}
+
+static int segment_mirror_failure_callback(void * data, const char * msg, const char * url) {
+    libdnf_assert(data != nullptr, "data in callback must be set");
+
+    auto * segment = static_cast<DownloadSegment *>(data);
+    return mirror_failure_callback(segment->download->pkg_target, msg, url);
+}
+
+
+/// Package requested from the peer cache
+struct PeerCacheTarget {
+    PackageTarget * pkg_target;
+    bool found{false};
+};
+
+static int peer_cache_end_callback(void * data, LrTransferStatus status, [[maybe_unused]] const char * msg) {
+    libdnf_assert(data != nullptr, "data in callback must be set");
+
+    // A package missing in the peer cache is not an error, it is downloaded from the mirrors
+    auto * peer_target = static_cast<PeerCacheTarget *>(data);
+    peer_target->found = status != LR_TRANSFER_ERROR;
+    return 0;
+}
+
+static int peer_cache_progress_callback(void * data, [[maybe_unused]] double total_to_download, double downloaded) {
+    libdnf_assert(data != nullptr, "data in callback must be set");
+
+    auto & pkg_target = *static_cast<PeerCacheTarget *>(data)->pkg_target;
+    pkg_target.transferred += std::max(downloaded - pkg_target.last_downloaded, 0.0);
+    pkg_target.last_downloaded = downloaded;
+    return 0;
+}
+
 
 class PackageDownloader::Impl {
 public:
@@ -99,12 +277,26 @@ public:
 private:
     friend PackageDownloader;
 
+    /// Rebuilds the packages of the `delta_targets` from their downloaded delta RPMs, the packages whose rebuild
+    /// failed are downloaded in full
+    void download_delta_targets(const std::vector<PackageTarget *> & delta_targets, LrPackageDownloadFlag flags);
+
+    /// Downloads the `targets` from the peer cache when it is configured, the downloaded targets are removed from
+    /// `targets`. The packages are requested by their checksums and verified against them.
+    void download_from_peer_cache(std::vector<PackageTarget *> & targets);
+
+    /// Downloads the `segmented_downloads` in byte range segments from several mirrors, the packages whose segments
+    /// failed on all the mirrors or whose assembled file does not match the checksum are downloaded in full
+    void download_segmented(std::list<SegmentedDownload> & segmented_downloads, LrPackageDownloadFlag flags);
+
     BaseWeakPtr base;
 
     std::vector<PackageTarget> targets;
     std::optional<bool> keep_packages;
+    std::function<void(const libdnf5::rpm::Package & package)> downloaded_callback;
     bool fail_fast;
     bool resume;
+    std::uint64_t downloaded_bytes{0};
 };
 
 
@@ -129,43 +321,55 @@ void PackageDownloader::add(const libdnf5::rpm::Package & package, const std::st
 }
 
 
-void PackageDownloader::download() try {
-    if (p_impl->targets.empty()) {
-        return;
-    }
+/// Returns the checksum of the `package` in the "<type>:<hex>" form
+static std::string get_checksum_id(const libdnf5::rpm::Package & package) {
+    return DownloadManifest::get_checksum_id(package.get_checksum());
+}
 
-    auto & config = p_impl->base->get_config();
-    auto use_cache_only = config.get_cacheonly_option().get_value() == "all";
 
-    GError * err{nullptr};
+/// Reports the package of `pkg_target` whose file is ready without a download to the download callbacks
+static void report_present_package(
+    PackageTarget & pkg_target,
+    const char * msg,
+    const std::function<void(const libdnf5::rpm::Package & package)> & downloaded_callback) {
+    if (auto * download_callbacks = pkg_target.package.get_base()->get_download_callbacks()) {
+        pkg_target.user_cb_data = download_callbacks->add_new_download(
+            pkg_target.user_data,
+            pkg_target.package.get_full_nevra().c_str(),
+            static_cast<double>(pkg_target.package.get_download_size()));
+        download_callbacks->end(pkg_target.user_cb_data, DownloadCallbacks::TransferStatus::ALREADYEXISTS, msg);
+    }
+    if (downloaded_callback) {
+        downloaded_callback(pkg_target.package);
+    }
+}
 
-    std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
-    lr_targets.reserve(p_impl->targets.size());
-    for (auto & pkg_target : p_impl->targets) {
-        if (use_cache_only && !pkg_target.package.is_available_locally()) {
-            throw RepoCacheonlyError(
-                M_("Cannot download the \"{0}\" package, cacheonly option is activated."),
-                pkg_target.package.get_nevra());
-        }
 
-        std::filesystem::create_directory(pkg_target.destination);
+/// Creates the librepo target downloading the package of `pkg_target`, or its delta RPM when it is set
+static std::unique_ptr<LrPackageTarget> new_lr_package_target(PackageTarget & pkg_target, bool resume) {
+    auto & package = pkg_target.package;
+    const auto & delta = pkg_target.delta;
+    pkg_target.last_downloaded = 0;
 
-        if (auto * download_callbacks = pkg_target.package.get_base()->get_download_callbacks()) {
-            pkg_target.user_cb_data = download_callbacks->add_new_download(
-                pkg_target.user_data,
-                pkg_target.package.get_full_nevra().c_str(),
-                static_cast<double>(pkg_target.package.get_download_size()));
-        }
+    if (auto * download_callbacks = package.get_base()->get_download_callbacks()) {
+        pkg_target.user_cb_data = download_callbacks->add_new_download(
+            pkg_target.user_data,
+            package.get_full_nevra().c_str(),
+            static_cast<double>(delta ? delta->download_size : package.get_download_size()));
+    }
 
-        auto * lr_target = lr_packagetarget_new_v3(
-            pkg_target.package.get_repo()->downloader->get_cached_handle().get(),
-            pkg_target.package.get_location().c_str(),
+    GError * err{nullptr};
+    LrPackageTarget * lr_target;
+    if (delta) {
+        lr_target = lr_packagetarget_new_v3(
+            package.get_repo()->downloader->get_cached_handle().get(),
+            delta->location.c_str(),
             pkg_target.destination.c_str(),
-            static_cast<LrChecksumType>(pkg_target.package.get_checksum().get_type()),
-            pkg_target.package.get_checksum().get_checksum().c_str(),
-            static_cast<int64_t>(pkg_target.package.get_download_size()),
-            pkg_target.package.get_baseurl().empty() ? nullptr : pkg_target.package.get_baseurl().c_str(),
-            p_impl->resume,
+            delta->checksum_type,
+            delta->checksum.c_str(),
+            static_cast<int64_t>(delta->download_size),
+            delta->baseurl.empty() ? nullptr : delta->baseurl.c_str(),
+            resume,
             progress_callback,
             &pkg_target,
             end_callback,
@@ -173,14 +377,35 @@ void PackageDownloader::download() try {
             0,
             0,
             &err);
+    } else {
+        lr_target = lr_packagetarget_new_v3(
+            package.get_repo()->downloader->get_cached_handle().get(),
+            package.get_location().c_str(),
+            pkg_target.destination.c_str(),
+            static_cast<LrChecksumType>(package.get_checksum().get_type()),
+            package.get_checksum().get_checksum().c_str(),
+            static_cast<int64_t>(package.get_download_size()),
+            package.get_baseurl().empty() ? nullptr : package.get_baseurl().c_str(),
+            resume,
+            progress_callback,
+            &pkg_target,
+            end_callback,
+            mirror_failure_callback,
+            0,
+            0,
+            &err);
+    }
 
-        if (!lr_target) {
-            throw LibrepoError(std::unique_ptr<GError>(err));
-        }
-
-        lr_targets.emplace_back(lr_target);
+    if (!lr_target) {
+        throw LibrepoError(std::unique_ptr<GError>(err));
     }
+    return std::unique_ptr<LrPackageTarget>(lr_target);
+}
 
+
+/// Downloads the librepo targets
+static void download_lr_package_targets(
+    const std::vector<std::unique_ptr<LrPackageTarget>> & lr_targets, LrPackageDownloadFlag flags) {
     // Adding items to the end of GSList is slow. We go from the back and add items to the beginning.
     GSList * list{nullptr};
     for (auto it = lr_targets.rbegin(); it != lr_targets.rend(); ++it) {
@@ -188,9 +413,205 @@ void PackageDownloader::download() try {
     }
     std::unique_ptr<GSList, decltype(&g_slist_free)> list_holder(list, &g_slist_free);
 
-    LrPackageDownloadFlag flags = static_cast<LrPackageDownloadFlag>(0);
-    if (p_impl->fail_fast) {
-        flags = static_cast<LrPackageDownloadFlag>(flags | LR_PACKAGEDOWNLOAD_FAILFAST);
+    GError * err{nullptr};
+    if (!lr_download_packages(list, flags, &err)) {
+        throw LibrepoError(std::unique_ptr<GError>(err));
+    }
+}
+
+
+/// Rebuilds the packages of the `delta_targets` from their downloaded delta RPMs in parallel, the number of threads
+/// is bounded by the number of CPUs. The delta RPM files are removed.
+/// @return The error messages of the rebuilds in the order of `delta_targets`, empty for the rebuilt packages.
+static std::vector<std::string> rebuild_from_delta_rpms(const std::vector<PackageTarget *> & delta_targets) {
+    struct RebuildJob {
+        std::string arch;
+        LrChecksumType checksum_type;
+        std::string checksum;
+        std::string delta_path;
+        std::string rpm_path;
+    };
+
+    // The package pool is accessed by the calling thread only, the workers get plain data
+    std::vector<RebuildJob> jobs;
+    jobs.reserve(delta_targets.size());
+    for (const auto * pkg_target : delta_targets) {
+        auto checksum = pkg_target->package.get_checksum();
+        jobs.push_back(
+            {pkg_target->package.get_arch(),
+             static_cast<LrChecksumType>(checksum.get_type()),
+             checksum.get_checksum(),
+             pkg_target->get_delta_path(),
+             pkg_target->get_package_path()});
+    }
+
+    std::vector<std::string> errors(jobs.size());
+    std::atomic<std::size_t> next_idx{0};
+
+    // The worker must not throw exceptions, the errors are returned to the calling thread
+    auto worker = [&]() {
+        for (auto idx = next_idx++; idx < jobs.size(); idx = next_idx++) {
+            const auto & job = jobs[idx];
+            try {
+                apply_delta_rpm(job.arch, job.checksum_type, job.checksum, job.delta_path, job.rpm_path);
+            } catch (const std::exception & ex) {
+                errors[idx] = ex.what();
+            }
+            std::error_code ec;
+            std::filesystem::remove(job.delta_path, ec);
+        }
+    };
+
+    const auto num_workers =
+        std::min<std::size_t>(jobs.size(), std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto & thread : workers) {
+        thread.join();
+    }
+
+    return errors;
+}
+
+
+void PackageDownloader::download() try {
+    p_impl->downloaded_bytes = 0;
+    if (p_impl->targets.empty()) {
+        return;
+    }
+
+    auto & config = p_impl->base->get_config();
+
+    // The verified packages are recorded also when the download is interrupted, a rerun skips them
+    auto & manifest = InternalBaseUser::get_download_manifest(p_impl->base);
+    utils::OnScopeExit finish_download([this, &manifest]() noexcept {
+        double transferred{0};
+        for (const auto & pkg_target : p_impl->targets) {
+            transferred += pkg_target.transferred;
+        }
+        p_impl->downloaded_bytes = static_cast<std::uint64_t>(transferred);
+        try {
+            for (const auto & pkg_target : p_impl->targets) {
+                if (pkg_target.verified) {
+                    manifest.set_verified(
+                        pkg_target.get_package_path(),
+                        get_checksum_id(pkg_target.package),
+                        pkg_target.package.get_download_size());
+                }
+            }
+            manifest.save();
+        } catch (...) {
+        }
+        try {
+            InternalBaseUser::get_mirror_stats(p_impl->base).save();
+        } catch (...) {
+        }
+    });
+
+    auto use_cache_only = config.get_cacheonly_option().get_value() == "all";
+
+    // Delta RPMs rebuild the packages from the files installed in the system, they are not usable for other
+    // installroots
+    const bool deltarpm_usable = config.get_deltarpm_option().get_value() &&
+                                 config.get_installroot_option().get_value() == "/" && is_applydeltarpm_available();
+
+    std::optional<PackageStore> package_store;
+    if (auto & store_dir_option = config.get_package_store_dir_option(); !store_dir_option.empty()) {
+        package_store.emplace(store_dir_option.get_value());
+    }
+
+    std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
+    std::vector<PackageTarget *> delta_targets;
+    std::vector<PackageTarget *> stored_targets;
+    std::vector<PackageTarget *> verified_targets;
+    // The segments keep pointers to their downloads, the list does not move its items
+    std::list<SegmentedDownload> segmented_downloads;
+    const auto segmented_min_size = config.get_segmented_download_min_size_option().get_value();
+    const auto segmented_max_segments = config.get_segmented_download_segments_option().get_value();
+    lr_targets.reserve(p_impl->targets.size());
+
+    // librepo starts the downloads in the order of the targets. The largest packages go first so that they do not
+    // become a long tail running alone after all the small ones are finished.
+    std::vector<PackageTarget *> sorted_targets;
+    sorted_targets.reserve(p_impl->targets.size());
+    for (auto & pkg_target : p_impl->targets) {
+        sorted_targets.push_back(&pkg_target);
+    }
+    std::stable_sort(sorted_targets.begin(), sorted_targets.end(), [](const auto * lhs, const auto * rhs) {
+        return lhs->package.get_download_size() > rhs->package.get_download_size();
+    });
+
+    std::vector<PackageTarget *> network_targets;
+    network_targets.reserve(sorted_targets.size());
+    // The files of the full size found in the destinations, they are verified in parallel below
+    std::vector<PackageTarget *> local_targets;
+    std::vector<ChecksumCheck> local_checks;
+    for (auto * pkg_target_ptr : sorted_targets) {
+        auto & pkg_target = *pkg_target_ptr;
+        std::filesystem::create_directory(pkg_target.destination);
+
+        // A package verified by an earlier download is used without reading it
+        if (manifest.is_verified(
+                pkg_target.get_package_path(),
+                get_checksum_id(pkg_target.package),
+                pkg_target.package.get_download_size())) {
+            verified_targets.push_back(&pkg_target);
+            continue;
+        }
+
+        // A package found in the store does not need the network
+        if (package_store && !std::filesystem::exists(pkg_target.get_package_path()) &&
+            package_store->link_to(
+                pkg_target.package.get_checksum(),
+                pkg_target.package.get_download_size(),
+                pkg_target.get_package_path())) {
+            stored_targets.push_back(&pkg_target);
+            continue;
+        }
+
+        std::error_code ec;
+        if (std::filesystem::file_size(pkg_target.get_package_path(), ec) == pkg_target.package.get_download_size() &&
+            !ec) {
+            auto checksum = pkg_target.package.get_checksum();
+            local_targets.push_back(&pkg_target);
+            local_checks.push_back(
+                {pkg_target.get_package_path(),
+                 checksum.get_type(),
+                 checksum.get_checksum(),
+                 pkg_target.package.get_download_size()});
+            continue;
+        }
+
+        if (use_cache_only && !pkg_target.package.is_available_locally()) {
+            throw RepoCacheonlyError(
+                M_("Cannot download the \"{0}\" package, cacheonly option is activated."),
+                pkg_target.package.get_nevra());
+        }
+
+        network_targets.push_back(&pkg_target);
+    }
+
+    // The files left by an earlier run are verified by several threads, a file that does not match is downloaded
+    if (!local_checks.empty()) {
+        libdnf5::base::SpanRecorder::Scope span(p_impl->base->get_span_recorder(), "verify local packages");
+        verify_file_checksums(local_checks, std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+    }
+    for (std::size_t idx = 0; idx < local_targets.size(); ++idx) {
+        auto & pkg_target = *local_targets[idx];
+        if (local_checks[idx].matches) {
+            pkg_target.verified = true;
+            verified_targets.push_back(&pkg_target);
+            continue;
+        }
+        if (use_cache_only && pkg_target.package.get_repo()->get_type() != Repo::Type::COMMANDLINE) {
+            throw RepoCacheonlyError(
+                M_("Cannot download the \"{0}\" package, cacheonly option is activated."),
+                pkg_target.package.get_nevra());
+        }
+        network_targets.push_back(&pkg_target);
     }
 
     // Store file paths of packages we don't want to keep cached.
@@ -213,8 +634,79 @@ void PackageDownloader::download() try {
         temp_files_memory.add_files(package_paths);
     }
 
-    if (!lr_download_packages(list, flags, &err)) {
-        throw LibrepoError(std::unique_ptr<GError>(err));
+    auto & span_recorder = p_impl->base->get_span_recorder();
+    {
+        libdnf5::base::SpanRecorder::Scope span(span_recorder, "download from peer cache");
+        p_impl->download_from_peer_cache(network_targets);
+    }
+
+    for (auto * pkg_target_ptr : network_targets) {
+        auto & pkg_target = *pkg_target_ptr;
+
+        if (deltarpm_usable && !std::filesystem::exists(pkg_target.get_package_path())) {
+            const auto & repo_config = pkg_target.package.get_repo()->get_config();
+            if (repo_config.get_deltarpm_option().get_value()) {
+                pkg_target.delta = find_delta_rpm(
+                    pkg_target.package, repo_config.get_deltarpm_percentage_option().get_value());
+            }
+        }
+
+        if (!pkg_target.delta && segmented_min_size > 0 &&
+            pkg_target.package.get_download_size() >= segmented_min_size &&
+            !std::filesystem::exists(pkg_target.get_package_path())) {
+            auto mirror_urls = pkg_target.package.get_remote_locations({"https", "http", "ftp"});
+            InternalBaseUser::get_mirror_stats(p_impl->base).sort_urls(mirror_urls);
+            if (mirror_urls.size() >= 2) {
+                segmented_downloads.emplace_back(pkg_target, std::move(mirror_urls), segmented_max_segments);
+                continue;
+            }
+        }
+
+        if (pkg_target.delta) {
+            // The package file is ready only after it is rebuilt from the delta RPM
+            delta_targets.push_back(&pkg_target);
+        } else if (p_impl->downloaded_callback) {
+            pkg_target.downloaded_callback = &p_impl->downloaded_callback;
+        }
+
+        lr_targets.emplace_back(new_lr_package_target(pkg_target, p_impl->resume));
+    }
+
+    LrPackageDownloadFlag flags = static_cast<LrPackageDownloadFlag>(0);
+    if (p_impl->fail_fast) {
+        flags = static_cast<LrPackageDownloadFlag>(flags | LR_PACKAGEDOWNLOAD_FAILFAST);
+    }
+
+    for (auto * pkg_target : verified_targets) {
+        report_present_package(*pkg_target, "Already downloaded and verified", p_impl->downloaded_callback);
+    }
+    for (auto * pkg_target : stored_targets) {
+        report_present_package(*pkg_target, "Found in package store", p_impl->downloaded_callback);
+    }
+
+    if (!lr_targets.empty()) {
+        libdnf5::base::SpanRecorder::Scope span(span_recorder, "librepo download packages");
+        download_lr_package_targets(lr_targets, flags);
+    }
+    if (!delta_targets.empty()) {
+        libdnf5::base::SpanRecorder::Scope span(span_recorder, "rebuild from delta rpms");
+        p_impl->download_delta_targets(delta_targets, flags);
+    }
+    if (!segmented_downloads.empty()) {
+        libdnf5::base::SpanRecorder::Scope span(span_recorder, "segmented download");
+        p_impl->download_segmented(segmented_downloads, flags);
+    }
+
+    // Add the packages verified against their checksums to the store. A failed download can leave a file of
+    // the full size when it is not stopped on the first failure.
+    if (package_store) {
+        for (auto & pkg_target : p_impl->targets) {
+            if (!pkg_target.verified &&
+                std::find(verified_targets.begin(), verified_targets.end(), &pkg_target) == verified_targets.end()) {
+                continue;
+            }
+            package_store->add(pkg_target.package.get_checksum(), pkg_target.get_package_path());
+        }
     }
 } catch (const RepoCacheonlyError & e) {
     throw;
@@ -222,6 +714,298 @@ void PackageDownloader::download() try {
     throw_with_nested(PackageDownloadError(M_("Failed to download packages")));
 }
 
+
+void PackageDownloader::Impl::download_delta_targets(
+    const std::vector<PackageTarget *> & delta_targets, LrPackageDownloadFlag flags) {
+    if (delta_targets.empty()) {
+        return;
+    }
+
+    auto errors = rebuild_from_delta_rpms(delta_targets);
+    auto & logger = *base->get_logger();
+    std::vector<std::unique_ptr<LrPackageTarget>> fallback_lr_targets;
+    for (std::size_t idx = 0; idx < delta_targets.size(); ++idx) {
+        auto & pkg_target = *delta_targets[idx];
+        if (errors[idx].empty()) {
+            pkg_target.verified = true;
+            if (downloaded_callback) {
+                downloaded_callback(pkg_target.package);
+            }
+            continue;
+        }
+        logger.warning(
+            "Cannot use delta RPM for \"{}\", downloading the full package: {}",
+            pkg_target.package.get_full_nevra(),
+            errors[idx]);
+        pkg_target.delta.reset();
+        if (downloaded_callback) {
+            pkg_target.downloaded_callback = &downloaded_callback;
+        }
+        fallback_lr_targets.emplace_back(new_lr_package_target(pkg_target, resume));
+    }
+    if (!fallback_lr_targets.empty()) {
+        download_lr_package_targets(fallback_lr_targets, flags);
+    }
+}
+
+
+void PackageDownloader::Impl::download_from_peer_cache(std::vector<PackageTarget *> & targets) {
+    auto & config = base->get_config();
+    const auto & peer_cache_url = config.get_peer_cache_url_option().get_value();
+    if (peer_cache_url.empty() || targets.empty()) {
+        return;
+    }
+
+    auto handle = LibrepoHandlePool::get_instance().acquire(config);
+    // The librepo targets keep pointers to the peer targets, the vector must not reallocate
+    std::vector<PeerCacheTarget> peer_targets;
+    peer_targets.reserve(targets.size());
+    std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
+    for (auto * pkg_target : targets) {
+        auto checksum = pkg_target->package.get_checksum();
+        auto relative_path = PackageStore::get_relative_path(checksum);
+        if (relative_path.empty() || std::filesystem::exists(pkg_target->get_package_path())) {
+            continue;
+        }
+        auto & peer_target = peer_targets.emplace_back(PeerCacheTarget{pkg_target});
+        pkg_target->last_downloaded = 0;
+        GError * err{nullptr};
+        auto * lr_target = lr_packagetarget_new_v3(
+            handle.get().get(),
+            relative_path.generic_string().c_str(),
+            pkg_target->get_package_path().c_str(),
+            static_cast<LrChecksumType>(checksum.get_type()),
+            checksum.get_checksum().c_str(),
+            static_cast<int64_t>(pkg_target->package.get_download_size()),
+            peer_cache_url.c_str(),
+            false,
+            peer_cache_progress_callback,
+            &peer_target,
+            peer_cache_end_callback,
+            nullptr,
+            0,
+            0,
+            &err);
+        if (!lr_target) {
+            throw LibrepoError(std::unique_ptr<GError>(err));
+        }
+        lr_targets.emplace_back(lr_target);
+    }
+    if (lr_targets.empty()) {
+        return;
+    }
+
+    try {
+        download_lr_package_targets(lr_targets, static_cast<LrPackageDownloadFlag>(0));
+    } catch (const LibrepoError & ex) {
+        base->get_logger()->warning("Download from the peer cache \"{}\" failed: {}", peer_cache_url, ex.what());
+    }
+
+    std::unordered_set<const PackageTarget *> found_targets;
+    for (auto & peer_target : peer_targets) {
+        auto & pkg_target = *peer_target.pkg_target;
+        if (!peer_target.found) {
+            std::error_code ec;
+            std::filesystem::remove(pkg_target.get_package_path(), ec);
+            continue;
+        }
+        found_targets.insert(&pkg_target);
+        pkg_target.verified = true;
+        if (auto * download_callbacks = pkg_target.package.get_base()->get_download_callbacks()) {
+            pkg_target.user_cb_data = download_callbacks->add_new_download(
+                pkg_target.user_data,
+                pkg_target.package.get_full_nevra().c_str(),
+                static_cast<double>(pkg_target.package.get_download_size()));
+            download_callbacks->end(
+                pkg_target.user_cb_data, DownloadCallbacks::TransferStatus::SUCCESSFUL, "Downloaded from peer cache");
+        }
+        if (downloaded_callback) {
+            downloaded_callback(pkg_target.package);
+        }
+    }
+    base->get_logger()->debug(
+        "Found {} of {} packages in the peer cache \"{}\"", found_targets.size(), peer_targets.size(), peer_cache_url);
+
+    std::erase_if(targets, [&found_targets](const PackageTarget * pkg_target) {
+        return found_targets.contains(pkg_target);
+    });
+}
+
+
+void PackageDownloader::Impl::download_segmented(
+    std::list<SegmentedDownload> & segmented_downloads, LrPackageDownloadFlag flags) {
+    if (segmented_downloads.empty()) {
+        return;
+    }
+
+    for (auto & download : segmented_downloads) {
+        auto & package = download.pkg_target->package;
+        if (auto * download_callbacks = package.get_base()->get_download_callbacks()) {
+            download.pkg_target->user_cb_data = download_callbacks->add_new_download(
+                download.pkg_target->user_data,
+                package.get_full_nevra().c_str(),
+                static_cast<double>(package.get_download_size()));
+        }
+    }
+
+    auto & mirror_stats = InternalBaseUser::get_mirror_stats(base);
+
+    // Each attempt moves the failed segments to the next mirror, a segment is tried at most once on every mirror.
+    // The segments of the other packages keep going when one of them fails, fail fast is not used.
+    for (std::size_t attempt = 0;; ++attempt) {
+        std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
+        for (auto & download : segmented_downloads) {
+            if (attempt >= download.mirror_urls.size()) {
+                continue;
+            }
+            for (auto & segment : download.segments) {
+                if (segment.done) {
+                    continue;
+                }
+                segment.downloaded = 0;
+                segment.url = download.mirror_urls[(segment.index + attempt) % download.mirror_urls.size()];
+                segment.start_time.reset();
+                segment.first_byte_time.reset();
+                segment.end_time.reset();
+                GError * err{nullptr};
+                auto * lr_target = lr_packagetarget_new_v3(
+                    download.pkg_target->package.get_repo()->downloader->get_cached_handle().get(),
+                    segment.url.c_str(),
+                    download.get_segment_path(segment).c_str(),
+                    LR_CHECKSUM_UNKNOWN,
+                    nullptr,
+                    0,
+                    nullptr,
+                    false,
+                    segment_progress_callback,
+                    &segment,
+                    segment_end_callback,
+                    segment_mirror_failure_callback,
+                    static_cast<int64_t>(segment.start),
+                    static_cast<int64_t>(segment.end),
+                    &err);
+                if (!lr_target) {
+                    throw LibrepoError(std::unique_ptr<GError>(err));
+                }
+                lr_targets.emplace_back(lr_target);
+            }
+        }
+        if (lr_targets.empty()) {
+            break;
+        }
+        try {
+            download_lr_package_targets(lr_targets, static_cast<LrPackageDownloadFlag>(0));
+        } catch (const LibrepoError & ex) {
+            base->get_logger()->warning("Segmented download of packages failed: {}", ex.what());
+        }
+
+        // The mirror of each segment is known, the segments measure the mirrors
+        for (auto & download : segmented_downloads) {
+            for (auto & segment : download.segments) {
+                if (!segment.done || !segment.end_time) {
+                    continue;
+                }
+                double latency{0};
+                double throughput{0};
+                if (segment.start_time && segment.first_byte_time) {
+                    latency = std::chrono::duration<double>(*segment.first_byte_time - *segment.start_time).count();
+                    auto transfer_time = std::chrono::duration<double>(*segment.end_time - *segment.first_byte_time);
+                    if (transfer_time.count() > 0) {
+                        throughput = static_cast<double>(segment.end - segment.start + 1) / transfer_time.count();
+                    }
+                }
+                mirror_stats.add_success(segment.url, latency, throughput);
+                segment.end_time.reset();
+            }
+        }
+    }
+
+    auto & logger = *base->get_logger();
+    std::vector<std::unique_ptr<LrPackageTarget>> fallback_lr_targets;
+    for (auto & download : segmented_downloads) {
+        auto & pkg_target = *download.pkg_target;
+        auto & package = pkg_target.package;
+        const auto package_path = pkg_target.get_package_path();
+
+        std::string error;
+        if (std::all_of(download.segments.begin(), download.segments.end(), [](const auto & segment) {
+                return segment.done;
+            })) {
+            {
+                std::ofstream output(package_path, std::ios::binary | std::ios::trunc);
+                for (const auto & segment : download.segments) {
+                    std::ifstream input(download.get_segment_path(segment), std::ios::binary);
+                    output << input.rdbuf();
+                }
+                if (!output.flush()) {
+                    error = "cannot write the package file";
+                }
+            }
+            if (error.empty()) {
+                auto checksum = package.get_checksum();
+                gboolean matches{FALSE};
+                GError * err{nullptr};
+                int fd = open(package_path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd == -1 || !lr_checksum_fd_cmp(
+                                    static_cast<LrChecksumType>(checksum.get_type()),
+                                    fd,
+                                    checksum.get_checksum().c_str(),
+                                    FALSE,
+                                    &matches,
+                                    &err)) {
+                    error = err ? err->message : "cannot read the package file";
+                } else if (!matches) {
+                    error = "checksum of the assembled file does not match";
+                }
+                if (err) {
+                    g_error_free(err);
+                }
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+        } else {
+            error = "segments failed on all mirrors";
+        }
+
+        std::error_code ec;
+        for (const auto & segment : download.segments) {
+            std::filesystem::remove(download.get_segment_path(segment), ec);
+        }
+
+        auto * download_callbacks = package.get_base()->get_download_callbacks();
+        if (error.empty()) {
+            pkg_target.verified = true;
+            if (downloaded_callback) {
+                downloaded_callback(package);
+            }
+            if (download_callbacks) {
+                download_callbacks->end(
+                    pkg_target.user_cb_data, DownloadCallbacks::TransferStatus::SUCCESSFUL, nullptr);
+            }
+            continue;
+        }
+
+        logger.warning(
+            "Segmented download of \"{}\" failed, downloading the full package: {}", package.get_full_nevra(), error);
+        std::filesystem::remove(package_path, ec);
+        if (download_callbacks) {
+            download_callbacks->end(pkg_target.user_cb_data, DownloadCallbacks::TransferStatus::ERROR, error.c_str());
+        }
+        if (downloaded_callback) {
+            pkg_target.downloaded_callback = &downloaded_callback;
+        }
+        fallback_lr_targets.emplace_back(new_lr_package_target(pkg_target, resume));
+    }
+    if (!fallback_lr_targets.empty()) {
+        download_lr_package_targets(fallback_lr_targets, flags);
+    }
+}
+
+std::uint64_t PackageDownloader::get_downloaded_bytes() const noexcept {
+    return p_impl->downloaded_bytes;
+}
+
 void PackageDownloader::set_fail_fast(bool value) {
     p_impl->fail_fast = value;
 }
@@ -234,4 +1018,9 @@ void PackageDownloader::force_keep_packages(bool value) {
     p_impl->keep_packages = value;
 }
 
+void PackageDownloader::set_package_downloaded_callback(
+    std::function<void(const libdnf5::rpm::Package & package)> callback) {
+    p_impl->downloaded_callback = std::move(callback);
+}
+
 }  // namespace libdnf5::repo
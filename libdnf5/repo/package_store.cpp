@@ -0,0 +1,142 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "package_store.hpp"
+
+#include "checksum_verifier.hpp"
+#include "utils/on_scope_exit.hpp"
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <string>
+#include <system_error>
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+/// Creates `dest` sharing the data of `src` using the FICLONE ioctl supported by copy-on-write file systems
+bool reflink(const std::filesystem::path & src, const std::filesystem::path & dest) {
+    auto src_fd = open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) {
+        return false;
+    }
+    utils::OnScopeExit close_src([src_fd]() noexcept { ::close(src_fd); });
+    auto dest_fd = open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (dest_fd == -1) {
+        return false;
+    }
+    auto cloned = ioctl(dest_fd, FICLONE, src_fd) == 0;
+    ::close(dest_fd);
+    if (!cloned) {
+        std::error_code ec;
+        std::filesystem::remove(dest, ec);
+    }
+    return cloned;
+}
+
+}  // namespace
+
+
+bool link_store_file(const std::filesystem::path & src, const std::filesystem::path & dest, bool allow_copy) {
+    auto tmp_path = dest;
+    tmp_path += ".tmp-" + std::to_string(getpid());
+    std::error_code ec;
+    std::filesystem::remove(tmp_path, ec);
+
+    std::filesystem::create_hard_link(src, tmp_path, ec);
+    if (ec && !reflink(src, tmp_path)) {
+        if (!allow_copy) {
+            return false;
+        }
+        std::filesystem::copy_file(src, tmp_path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, dest, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+
+std::filesystem::path PackageStore::get_relative_path(const libdnf5::rpm::Checksum & checksum) {
+    const auto & hex = checksum.get_checksum();
+    if (checksum.get_type() == libdnf5::rpm::Checksum::Type::UNKNOWN || hex.size() < 3) {
+        return {};
+    }
+    return std::filesystem::path(checksum.get_type_str()) / hex.substr(0, 2) / hex;
+}
+
+
+std::filesystem::path PackageStore::get_path(const libdnf5::rpm::Checksum & checksum) const {
+    auto relative_path = get_relative_path(checksum);
+    if (relative_path.empty()) {
+        return {};
+    }
+    return dir / relative_path;
+}
+
+
+bool PackageStore::link_to(
+    const libdnf5::rpm::Checksum & checksum, unsigned long long size, const std::filesystem::path & path) const {
+    auto stored_path = get_path(checksum);
+    if (stored_path.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    if (!std::filesystem::exists(stored_path, ec)) {
+        return false;
+    }
+    // A truncated or corrupted entry is dropped, the package is downloaded and stored again
+    if (!verify_file_checksum(stored_path, checksum.get_type(), checksum.get_checksum(), size)) {
+        std::filesystem::remove(stored_path, ec);
+        return false;
+    }
+    return link_store_file(stored_path, path, true);
+}
+
+
+void PackageStore::add(const libdnf5::rpm::Checksum & checksum, const std::filesystem::path & path) const {
+    auto stored_path = get_path(checksum);
+    if (stored_path.empty()) {
+        return;
+    }
+    std::error_code ec;
+    if (std::filesystem::exists(stored_path, ec)) {
+        return;
+    }
+    std::filesystem::create_directories(stored_path.parent_path(), ec);
+    if (ec) {
+        return;
+    }
+    link_store_file(path, stored_path, false);
+}
+
+}  // namespace libdnf5::repo
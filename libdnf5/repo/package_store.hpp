@@ -0,0 +1,67 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_PACKAGE_STORE_HPP
+#define LIBDNF5_REPO_PACKAGE_STORE_HPP
+
+#include "libdnf5/rpm/checksum.hpp"
+
+#include <filesystem>
+#include <utility>
+
+
+namespace libdnf5::repo {
+
+/// Creates `dest` as a hardlink or a reflink of `src`, or as its copy if `allow_copy` is set. The file is created
+/// under a temporary name and renamed, so that a concurrent reader never sees a partial file.
+bool link_store_file(const std::filesystem::path & src, const std::filesystem::path & dest, bool allow_copy);
+
+/// Content-addressed store of package files shared by the repositories and installroots. The files are stored
+/// as `<dir>/<checksum type>/<first two hex digits>/<checksum>` and linked to and from the package destinations.
+class PackageStore {
+public:
+    explicit PackageStore(std::filesystem::path dir) : dir(std::move(dir)) {}
+
+    /// Links the stored file with the `checksum` to `path`. A hardlink is tried first, then a reflink and finally
+    /// the file is copied. The stored file is verified against the `size` and the `checksum` before, a file that
+    /// does not match them is removed from the store.
+    /// @return `true` if the file was linked, `false` if it is not stored, does not match or cannot be linked.
+    bool link_to(const libdnf5::rpm::Checksum & checksum, unsigned long long size, const std::filesystem::path & path)
+        const;
+
+    /// Adds the package file at `path` with the `checksum` to the store as a hardlink or a reflink. The file is not
+    /// copied, a file that cannot be linked is not stored. An already stored file is kept.
+    /// The file has to be verified against the `checksum` by the caller.
+    void add(const libdnf5::rpm::Checksum & checksum, const std::filesystem::path & path) const;
+
+    /// Returns the path of the file with the `checksum` relative to the store directory, empty for an unknown
+    /// checksum type. A store served over HTTP has the same layout.
+    static std::filesystem::path get_relative_path(const libdnf5::rpm::Checksum & checksum);
+
+private:
+    /// Returns the path of the stored file with the `checksum`, empty for an unknown checksum type
+    std::filesystem::path get_path(const libdnf5::rpm::Checksum & checksum) const;
+
+    std::filesystem::path dir;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_PACKAGE_STORE_HPP
@@ -19,11 +19,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 constexpr const char * REPOID_CHARS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_.:";
 
+#include "module/module_sack_impl.hpp"
 #include "repo_cache_private.hpp"
 #include "repo_downloader.hpp"
 #include "rpm/package_sack_impl.hpp"
+#include "solv_cache_bundle.hpp"
 #include "solv_repo.hpp"
 #include "utils/fs/file.hpp"
+#include "utils/locker.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf5/common/exception.hpp"
@@ -49,6 +52,7 @@ extern "C" {
 #include <unistd.h>
 #include <utime.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cctype>
@@ -211,12 +215,23 @@ void Repo::download_metadata(const std::string & destdir) {
     downloader->download_metadata(destdir);
 }
 
+void Repo::export_cache_bundle(const std::string & bundle_dir) {
+    export_solv_cache_bundle(*base->get_logger(), config, bundle_dir);
+}
+
+void Repo::import_cache_bundle(const std::string & bundle_dir) {
+    import_solv_cache_bundle(*base->get_logger(), config, bundle_dir);
+}
+
 void Repo::load() {
     // Each repository can only be loaded once. This one has already loaded, so just return instantly
     if (loaded) {
         return;
     }
 
+    libdnf5::base::SpanRecorder::Scope span(
+        base->get_span_recorder(), type == Type::SYSTEM ? "load system repo" : "load repo", get_id());
+
     make_solv_repo();
 
     if (type == Type::AVAILABLE) {
@@ -252,7 +267,11 @@ bool Repo::get_use_includes() const {
 }
 
 void Repo::set_use_includes(bool enabled) {
-    use_includes = enabled;
+    if (use_includes != enabled) {
+        use_includes = enabled;
+        // the packages of the repository are considered according to the includes now
+        base->get_rpm_package_sack()->p_impl->invalidate_considered();
+    }
 }
 
 int Repo::get_cost() const {
@@ -410,34 +429,60 @@ void Repo::make_solv_repo() {
 }
 
 
-void Repo::load_available_repo() {
-    auto primary_fn = downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
-    if (primary_fn.empty()) {
-        throw RepoError(M_("Failed to load repository: \"primary\" data not present or in unsupported format"));
-    }
-
-    solv_repo->load_repo_main(downloader->repomd_filename, primary_fn);
-
-    auto optional_metadata = config.get_main_config().get_optional_metadata_types_option().get_value();
-
+// Returns the types of extended repodata stored in the libsolv cache files, in the order they are loaded.
+static std::vector<RepodataType> get_solv_cache_types(const BaseWeakPtr & base) {
+    // same order as in load_available_repo()
+    std::vector<RepodataType> types;
+    auto optional_metadata = base->get_repo_sack()->get_loaded_optional_metadata_types();
     if (optional_metadata.contains(libdnf5::METADATA_TYPE_FILELISTS)) {
-        solv_repo->load_repo_ext(RepodataType::FILELISTS, *downloader.get());
+        types.push_back(RepodataType::FILELISTS);
     }
-
     if (optional_metadata.contains(libdnf5::METADATA_TYPE_OTHER)) {
-        solv_repo->load_repo_ext(RepodataType::OTHER, *downloader.get());
+        types.push_back(RepodataType::OTHER);
     }
-
     if (optional_metadata.contains(libdnf5::METADATA_TYPE_PRESTO)) {
-        solv_repo->load_repo_ext(RepodataType::PRESTO, *downloader.get());
+        types.push_back(RepodataType::PRESTO);
     }
-
     if (optional_metadata.contains(libdnf5::METADATA_TYPE_UPDATEINFO)) {
-        solv_repo->load_repo_ext(RepodataType::UPDATEINFO, *downloader.get());
+        types.push_back(RepodataType::UPDATEINFO);
+    }
+    return types;
+}
+
+
+// The metadata in the cache can be replaced by another process refreshing the repository. They are loaded under
+// a shared lock, the replacement waits for it. A cache the user cannot lock (e.g. the system cache used
+// by an unprivileged user) is loaded without the lock.
+static void read_lock_cache(libdnf5::utils::Locker & cache_locker, Logger & logger, const std::string & repo_id) {
+    try {
+        cache_locker.read_lock(true);
+    } catch (const SystemError & e) {
+        logger.debug("Loading repo \"{}\" without the cache lock: {}", repo_id, e.what());
+    }
+}
+
+
+void Repo::load_available_repo() {
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(config.get_cachedir()), false);
+    read_lock_cache(cache_locker, *base->get_logger(), config.get_id());
+
+    auto primary_fn = downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+    if (!primary_fn.empty() && !std::filesystem::exists(primary_fn)) {
+        // The metadata were replaced since they were read, read the new ones
+        read_metadata_cache();
+        primary_fn = downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+    }
+    if (primary_fn.empty()) {
+        throw RepoError(M_("Failed to load repository: \"primary\" data not present or in unsupported format"));
     }
 
-    if (optional_metadata.contains(libdnf5::METADATA_TYPE_COMPS)) {
-        solv_repo->load_repo_ext(RepodataType::COMPS, *downloader.get());
+    solv_repo->load_repo_main(downloader->repomd_filename, primary_fn);
+
+    load_optional_metadata(base->get_repo_sack()->get_loaded_optional_metadata_types());
+
+    if (config.get_build_cache_option().get_value() &&
+        config.get_main_config().get_build_cache_in_background_option().get_value()) {
+        solv_repo->build_cache_in_background(downloader->repomd_filename, *downloader, get_solv_cache_types(base));
     }
 
     // Load module metadata
@@ -453,33 +498,56 @@ void Repo::load_available_repo() {
     logger.debug(
         "Loading {} extension for repo {} from \"{}\"", RepoDownloader::MD_FILENAME_MODULES, config.get_id(), ext_fn);
 
-    libdnf5::utils::fs::File file;
-    std::string yaml_content;
+    // The file is parsed only when the modules are needed, the modular filtering data can be read from the cache
+    base->get_module_sack()->p_impl->add_metadata_file(ext_fn, config.get_id());
+#endif
+}
 
-    // TODO(pkratoch): Replace this by implementation in libdnf5::utils::fs::File.
-    // If the file is comressed, `std::fseek` doesn't work with the way libsolv decompresses the file, so read it by
-    // chunks.
-    if (solv_xfopen_iscompressed(ext_fn.c_str()) == 1) {
-        file = libdnf5::utils::fs::File(ext_fn, "r", true);
 
-        constexpr size_t buffer_size = 4096;
-        char buffer[buffer_size];
-        std::ostringstream ss;
-        size_t bytes_read;
+void Repo::load_optional_metadata(const std::set<std::string> & types) {
+    // same order as in get_solv_cache_types()
+    static constexpr std::pair<const char *, RepodataType> OPTIONAL_TYPES[]{
+        {libdnf5::METADATA_TYPE_FILELISTS, RepodataType::FILELISTS},
+        {libdnf5::METADATA_TYPE_OTHER, RepodataType::OTHER},
+        {libdnf5::METADATA_TYPE_PRESTO, RepodataType::PRESTO},
+        {libdnf5::METADATA_TYPE_UPDATEINFO, RepodataType::UPDATEINFO},
+        {libdnf5::METADATA_TYPE_COMPS, RepodataType::COMPS}};
 
-        do {
-            bytes_read = file.read(buffer, buffer_size);
-            ss.write(buffer, long(bytes_read));
-        } while (bytes_read == buffer_size);
+    for (const auto & [type_name, repodata_type] : OPTIONAL_TYPES) {
+        if (types.contains(type_name) && !loaded_optional_metadata_types.contains(type_name)) {
+            solv_repo->load_repo_ext(repodata_type, *downloader.get());
+            loaded_optional_metadata_types.insert(type_name);
+        }
+    }
+}
 
-        yaml_content.append(ss.str());
-    } else {
-        file = libdnf5::utils::fs::File(ext_fn, "r", false);
-        yaml_content = file.read();
+
+void Repo::load_optional_metadata_on_demand(const std::set<std::string> & types) {
+    if (!loaded || type != Type::AVAILABLE ||
+        std::all_of(types.begin(), types.end(), [this](const std::string & type_name) {
+            return loaded_optional_metadata_types.contains(type_name);
+        })) {
+        return;
     }
 
-    base->get_module_sack()->add(yaml_content, config.get_id());
-#endif
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "load repo optional metadata", get_id());
+
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(config.get_cachedir()), false);
+    read_lock_cache(cache_locker, *base->get_logger(), config.get_id());
+
+    load_optional_metadata(types);
+
+    solv_repo->set_needs_internalizing();
+    base->get_rpm_package_sack()->p_impl->invalidate_provides();
+}
+
+
+void Repo::build_solv_cache() {
+    if (type != Type::AVAILABLE || loaded) {
+        return;
+    }
+
+    SolvRepo::build_cache(base, config, downloader->repomd_filename, *downloader, get_solv_cache_types(base));
 }
 
 
@@ -506,7 +574,7 @@ rpm::Package Repo::add_rpm_package(const std::string & path, bool with_hdrid) {
     }
 
     solv_repo->set_needs_internalizing();
-    base->get_rpm_package_sack()->p_impl->invalidate_provides();
+    base->get_rpm_package_sack()->p_impl->invalidate_provides_appended();
 
     return rpm::Package(base, rpm::PackageId(new_id));
 }
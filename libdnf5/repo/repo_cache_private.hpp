@@ -22,6 +22,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/repo/repo_cache.hpp"
 
+#include <filesystem>
+#include <string>
+
 
 namespace libdnf5::repo {
 
@@ -32,6 +35,18 @@ constexpr const char * CACHE_METADATA_DIR = "repodata";
 constexpr const char * CACHE_PACKAGES_DIR = "packages";
 constexpr const char * CACHE_SOLV_FILES_DIR = "solv";
 
+/// Returns the path of the lock file of the repository cache directory `cache_dir`, it is placed next to
+/// the directory. The cached metadata are read under a shared lock and replaced under an exclusive lock, so that
+/// a reader never sees the metadata of a repository half replaced. Downloads run without the lock.
+inline std::filesystem::path get_cache_lock_path(const std::string & cache_dir) {
+    std::filesystem::path path(cache_dir);
+    if (!path.has_filename()) {
+        path = path.parent_path();
+    }
+    path += ".lock";
+    return path;
+}
+
 }  // namespace
 
 
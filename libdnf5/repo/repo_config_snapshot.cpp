@@ -0,0 +1,203 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "repo_config_snapshot.hpp"
+
+#include "utils/fs/file.hpp"
+
+#include <fmt/format.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <string_view>
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+/// Returns the state of the file or directory at `path`, "-" if it does not exist
+std::string get_path_state(const std::string & path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return "-";
+    }
+    return fmt::format(
+        "{}\t{}\t{}.{:09}\t{}.{:09}",
+        static_cast<unsigned long long>(st.st_ino),
+        static_cast<long long>(st.st_size),
+        static_cast<long long>(st.st_mtim.tv_sec),
+        static_cast<long long>(st.st_mtim.tv_nsec),
+        static_cast<long long>(st.st_ctim.tv_sec),
+        static_cast<long long>(st.st_ctim.tv_nsec));
+}
+
+void append_snapshot_string(std::string & out, std::string_view value) {
+    auto size = static_cast<uint32_t>(value.size());
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+    }
+    out.append(value);
+}
+
+bool read_snapshot_string(std::string_view & in, std::string & value) {
+    if (in.size() < 4) {
+        return false;
+    }
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i) {
+        size |= static_cast<uint32_t>(static_cast<unsigned char>(in[static_cast<std::size_t>(i)])) << (8 * i);
+    }
+    in.remove_prefix(4);
+    if (in.size() < size) {
+        return false;
+    }
+    value.assign(in.substr(0, size));
+    in.remove_prefix(size);
+    return true;
+}
+
+void append_snapshot_count(std::string & out, std::size_t count) {
+    append_snapshot_string(out, std::to_string(count));
+}
+
+bool read_snapshot_count(std::string_view & in, std::size_t & count) {
+    std::string count_str;
+    if (!read_snapshot_string(in, count_str)) {
+        return false;
+    }
+    try {
+        count = std::stoul(count_str);
+    } catch (const std::exception &) {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+
+void RepoConfigSnapshot::add_input(const std::string & path) {
+    inputs.emplace_back(path, get_path_state(path));
+}
+
+
+void RepoConfigSnapshot::add_file(const std::string & path) {
+    add_input(path);
+    ConfigParser parser;
+    parser.read(path, false);
+    files.push_back({path, std::move(parser)});
+}
+
+
+bool RepoConfigSnapshot::read(const std::filesystem::path & path, const std::string & key) {
+    std::string content;
+    try {
+        content = utils::fs::File(path, "r").read();
+    } catch (const std::exception &) {
+        return false;
+    }
+    std::string_view in(content);
+    std::string value;
+    if (!read_snapshot_string(in, value) || value != key) {
+        return false;
+    }
+
+    std::size_t inputs_count = 0;
+    if (!read_snapshot_count(in, inputs_count)) {
+        return false;
+    }
+    std::vector<std::pair<std::string, std::string>> read_inputs;
+    for (std::size_t i = 0; i < inputs_count; ++i) {
+        auto & [input_path, state] = read_inputs.emplace_back();
+        if (!read_snapshot_string(in, input_path) || !read_snapshot_string(in, state) ||
+            get_path_state(input_path) != state) {
+            return false;
+        }
+    }
+
+    std::size_t files_count = 0;
+    if (!read_snapshot_count(in, files_count)) {
+        return false;
+    }
+    std::vector<File> read_files;
+    for (std::size_t i = 0; i < files_count; ++i) {
+        auto & file = read_files.emplace_back();
+        std::size_t sections_count = 0;
+        if (!read_snapshot_string(in, file.path) || !read_snapshot_count(in, sections_count)) {
+            return false;
+        }
+        for (std::size_t j = 0; j < sections_count; ++j) {
+            std::string section;
+            std::size_t options_count = 0;
+            if (!read_snapshot_string(in, section) || !read_snapshot_count(in, options_count)) {
+                return false;
+            }
+            file.parser.add_section(section);
+            for (std::size_t k = 0; k < options_count; ++k) {
+                std::string option;
+                if (!read_snapshot_string(in, option) || !read_snapshot_string(in, value)) {
+                    return false;
+                }
+                file.parser.set_value(section, std::move(option), std::move(value));
+            }
+        }
+    }
+    if (!in.empty()) {
+        return false;
+    }
+
+    inputs = std::move(read_inputs);
+    files = std::move(read_files);
+    return true;
+}
+
+
+void RepoConfigSnapshot::write(const std::filesystem::path & path, const std::string & key) const {
+    std::string out;
+    append_snapshot_string(out, key);
+    append_snapshot_count(out, inputs.size());
+    for (const auto & [input_path, state] : inputs) {
+        append_snapshot_string(out, input_path);
+        append_snapshot_string(out, state);
+    }
+    append_snapshot_count(out, files.size());
+    for (const auto & file : files) {
+        append_snapshot_string(out, file.path);
+        const auto & data = file.parser.get_data();
+        append_snapshot_count(out, data.size());
+        for (const auto & [section, options] : data) {
+            append_snapshot_string(out, section);
+            append_snapshot_count(out, options.size());
+            for (const auto & [option, value] : options) {
+                append_snapshot_string(out, option);
+                append_snapshot_string(out, value);
+            }
+        }
+    }
+
+    auto temp_path = path;
+    temp_path += ".tmp";
+    std::filesystem::create_directories(path.parent_path());
+    utils::fs::File(temp_path, "w").write(out);
+    std::filesystem::rename(temp_path, path);
+}
+
+}  // namespace libdnf5::repo
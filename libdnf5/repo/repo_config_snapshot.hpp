@@ -0,0 +1,74 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_REPO_REPO_CONFIG_SNAPSHOT_HPP
+#define LIBDNF5_REPO_REPO_CONFIG_SNAPSHOT_HPP
+
+#include "libdnf5/conf/config_parser.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+/// Parsed repository configuration files stored in a cache file. The snapshot records the state (inode, size,
+/// modification and change time) of the parsed files and of the directories they were listed from. It is read only
+/// while none of them changed, a file added to or removed from a directory changes the directory.
+///
+/// Only the options are stored, comments and raw lines are dropped. The values are stored as written in the files,
+/// the variables are substituted when the repositories are created.
+class RepoConfigSnapshot {
+public:
+    /// Parsed repository configuration file
+    struct File {
+        std::string path;
+        ConfigParser parser;
+    };
+
+    /// Records the state of the file or directory at `path`. A missing one is recorded too, the snapshot is outdated
+    /// once it is created.
+    void add_input(const std::string & path);
+
+    /// Records the state of the configuration file at `path`, parses it and adds it to the snapshot.
+    /// The exceptions of `ConfigParser::read()` are passed to the caller.
+    void add_file(const std::string & path);
+
+    const std::vector<File> & get_files() const noexcept { return files; }
+
+    /// Reads the snapshot stored with the `key` from the cache file at `path`.
+    /// @return `false` if the file does not exist, is damaged, was stored with a different key or any of the recorded
+    ///         files and directories changed since.
+    bool read(const std::filesystem::path & path, const std::string & key);
+
+    /// Atomically replaces the cache file at `path` with the snapshot stored with the `key`.
+    void write(const std::filesystem::path & path, const std::string & key) const;
+
+private:
+    /// Paths and states of the recorded files and directories
+    std::vector<std::pair<std::string, std::string>> inputs;
+    std::vector<File> files;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_REPO_CONFIG_SNAPSHOT_HPP
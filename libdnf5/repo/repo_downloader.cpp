@@ -19,8 +19,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "repo_downloader.hpp"
 
+#include "base/base_impl.hpp"
+#include "repo_cache_private.hpp"
+#include "utils/fs/file.hpp"
 #include "utils/fs/temp.hpp"
 #include "utils/fs/utils.hpp"
+#include "utils/locker.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf5/base/base.hpp"
@@ -32,9 +36,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <solv/chksum.h>
 #include <solv/util.h>
 
+#include <fcntl.h>
+
+#include <cerrno>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <random>
+#include <system_error>
 
 
 #define METADATA_RELATIVE_DIR "repodata"
@@ -47,6 +57,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf5::repo {
 
+// Metadata of several repositories can be downloaded concurrently (see `RepoSack::update_and_load_repos`).
+// The user-provided download callbacks are not required to be thread-safe, so calls into them are serialized.
+static std::mutex download_callbacks_mutex;
+
 static void str_vector_to_char_array(const std::vector<std::string> & vec, const char * arr[]) {
     for (size_t i = 0; i < vec.size(); ++i) {
         arr[i] = vec[i].c_str();
@@ -66,6 +80,22 @@ static LrYumRepoMd * get_yum_repomd(LibrepoResult & result) {
     return yum_repomd;
 }
 
+void replace_cache_item(const std::filesystem::path & new_item, const std::filesystem::path & target_item) {
+    if (std::filesystem::exists(std::filesystem::symlink_status(target_item))) {
+        if (::renameat2(AT_FDCWD, new_item.c_str(), AT_FDCWD, target_item.c_str(), RENAME_EXCHANGE) == 0) {
+            std::filesystem::remove_all(new_item);
+            return;
+        }
+        // The exchange is not supported by the filesystem or the kernel, fall back to remove and move.
+        if (errno != EINVAL && errno != ENOSYS && errno != EXDEV) {
+            throw std::filesystem::filesystem_error(
+                "renameat2", new_item, target_item, std::error_code(errno, std::system_category()));
+        }
+        std::filesystem::remove_all(target_item);
+    }
+    utils::fs::move_recursive(new_item, target_item);
+}
+
 
 int RepoDownloader::progress_cb(void * data, double total_to_download, double downloaded) {
     if (!data) {
@@ -73,6 +103,7 @@ int RepoDownloader::progress_cb(void * data, double total_to_download, double do
     }
     auto repo_downloader = static_cast<RepoDownloader *>(data);
     if (auto * download_callbacks = repo_downloader->base->get_download_callbacks()) {
+        std::lock_guard<std::mutex> lock(download_callbacks_mutex);
         // "total_to_download" and "downloaded" from librepo are related to the currently downloaded file.
         // We add the size of previously downloaded files.
         // ignore zero progress events at the beginning of the download, so we don't start with 100% progress
@@ -116,6 +147,7 @@ void RepoDownloader::fastest_mirror_cb(void * data, LrFastestMirrorStages stage,
         } else {
             msg = nullptr;
         }
+        std::lock_guard<std::mutex> lock(download_callbacks_mutex);
         download_callbacks->fastest_mirror(
             repo_downloader->user_cb_data, static_cast<DownloadCallbacks::FastestMirrorStage>(stage), msg);
     }
@@ -127,7 +159,11 @@ int RepoDownloader::mirror_failure_cb(
         return 0;
     }
     auto repo_downloader = static_cast<RepoDownloader *>(data);
+    if (url) {
+        InternalBaseUser::get_mirror_stats(repo_downloader->base).add_failure(url);
+    }
     if (auto * download_callbacks = repo_downloader->base->get_download_callbacks()) {
+        std::lock_guard<std::mutex> lock(download_callbacks_mutex);
         return download_callbacks->mirror_failure(repo_downloader->user_cb_data, msg, url, metadata);
     }
     return 0;
@@ -152,17 +188,41 @@ void RepoDownloader::download_metadata(const std::string & destdir) try {
     std::filesystem::create_directories(destdir);
     libdnf5::utils::fs::TempDir tmpdir(destdir, "tmpdir");
 
+    auto zchunk_store = get_zchunk_store();
+    if (zchunk_store) {
+        // The current metadata of the repository are a source of chunks for the new ones
+        zchunk_store->add_files(std::filesystem::path(destdir) / CACHE_METADATA_DIR);
+    }
+
     LibrepoHandle h(init_remote_handle(tmpdir.get_path().c_str()));
-    perform(h, config.get_repo_gpgcheck_option().get_value());
+    auto result = perform(h);
+    if (config.get_repo_gpgcheck_option().get_value()) {
+        verify_repomd_signature(result, &h);
+    }
 
-    // move all downloaded object from tmpdir to destdir
-    for (auto & dir : std::filesystem::directory_iterator(tmpdir.get_path())) {
-        auto tmp_item = dir.path();
+    if (zchunk_store) {
+        // The hardlinks in the store stay valid when the files are moved to destdir
+        zchunk_store->add_files(tmpdir.get_path() / CACHE_METADATA_DIR);
+        zchunk_store->remove_unused();
+    }
 
-        auto target_item = destdir / tmp_item.filename();
-        std::filesystem::remove_all(target_item);
+    auto & mirror_stats = InternalBaseUser::get_mirror_stats(base);
+    if (auto * yum_repo = get_yum_repo(result); yum_repo && yum_repo->url) {
+        mirror_stats.add_success(yum_repo->url, 0, 0);
+    }
+    mirror_stats.save();
 
-        utils::fs::move_recursive(tmp_item, target_item);
+    // Move all downloaded objects from tmpdir to destdir. Readers of the cache hold a shared lock while they load
+    // the metadata, the replacement waits for them and does not let them see the metadata half replaced.
+    // The exchanged old items are removed from tmpdir, so the items are listed before the replacement.
+    std::vector<std::filesystem::path> tmp_items;
+    for (auto & dir : std::filesystem::directory_iterator(tmpdir.get_path())) {
+        tmp_items.push_back(dir.path());
+    }
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(destdir), false);
+    cache_locker.write_lock(true);
+    for (const auto & tmp_item : tmp_items) {
+        replace_cache_item(tmp_item, destdir / tmp_item.filename());
     }
 } catch (const std::runtime_error & e) {
     auto src = get_source_info();
@@ -180,7 +240,7 @@ bool RepoDownloader::is_metalink_in_sync() try {
     LibrepoHandle h(init_remote_handle(tmpdir.get_path().c_str()));
 
     h.set_opt(LRO_FETCHMIRRORS, 1L);
-    perform(h, false);
+    perform(h);
     LrMetalink * metalink;
     h.get_info(LRI_METALINK, &metalink);
     if (!metalink) {
@@ -256,7 +316,8 @@ bool RepoDownloader::is_repomd_in_sync() try {
     LibrepoHandle h(init_remote_handle(tmpdir.get_path().c_str()));
 
     h.set_opt(LRO_YUMDLIST, dlist);
-    auto result = perform(h, config.get_repo_gpgcheck_option().get_value());
+    // The signature is not verified, only the repomd.xml verified earlier is used when they are the same
+    auto result = perform(h);
     result.get_info(LRR_YUM_REPO, &yum_repo);
 
     auto same = utils::fs::have_files_same_content_noexcept(repomd_filename.c_str(), yum_repo->repomd);
@@ -278,7 +339,10 @@ bool RepoDownloader::is_repomd_in_sync() try {
 void RepoDownloader::load_local() try {
     LibrepoHandle h(init_local_handle());
 
-    auto result = perform(h, config.get_repo_gpgcheck_option().get_value());
+    auto result = perform(h);
+    if (config.get_repo_gpgcheck_option().get_value()) {
+        verify_repomd_signature(result, nullptr);
+    }
 
     repomd_filename = libdnf5::utils::string::c_to_str(get_yum_repo(result)->repomd);
 
@@ -352,7 +416,10 @@ void RepoDownloader::reset_loaded() {
 //              (eg metalink) we won't know about it.
 LibrepoHandle & RepoDownloader::get_cached_handle() {
     if (!handle) {
-        handle = init_remote_handle(nullptr, true, false);
+        // The mirrors resolved with the metadata are used directly when their statistics can order them
+        auto sorted_mirrors = mirrors;
+        bool use_mirrors = InternalBaseUser::get_mirror_stats(base).sort_urls(sorted_mirrors);
+        handle = init_remote_handle(nullptr, !use_mirrors, false);
     }
     apply_http_headers(*handle);
     return *handle;
@@ -441,14 +508,18 @@ LibrepoHandle RepoDownloader::init_remote_handle(const char * destdir, bool mirr
             fastest_mirror_cache_dir += "fastestmirror.cache";
             h.set_opt(LRO_FASTESTMIRRORCACHE, fastest_mirror_cache_dir.c_str());
         } else {
-            // use already resolved mirror list
-            const char * c_mirrors[mirrors.size() + 1];
-            str_vector_to_char_array(mirrors, c_mirrors);
+            // use already resolved mirror list, ordered by the statistics of the mirrors
+            auto sorted_mirrors = mirrors;
+            InternalBaseUser::get_mirror_stats(base).sort_urls(sorted_mirrors);
+            const char * c_mirrors[sorted_mirrors.size() + 1];
+            str_vector_to_char_array(sorted_mirrors, c_mirrors);
             h.set_opt(LRO_URLS, c_mirrors);
         }
     } else if (!config.get_baseurl_option().get_value().empty()) {
-        const char * urls[config.get_baseurl_option().get_value().size() + 1];
-        str_vector_to_char_array(config.get_baseurl_option().get_value(), urls);
+        auto baseurls = config.get_baseurl_option().get_value();
+        InternalBaseUser::get_mirror_stats(base).sort_urls(baseurls);
+        const char * urls[baseurls.size() + 1];
+        str_vector_to_char_array(baseurls, urls);
         h.set_opt(LRO_URLS, urls);
     } else {
         throw RepoDownloadError(
@@ -456,12 +527,13 @@ LibrepoHandle RepoDownloader::init_remote_handle(const char * destdir, bool mirr
     }
 
     if (set_callbacks) {
+        // The mirror failures are recorded in the mirror statistics even without download callbacks
+        h.set_opt(LRO_PROGRESSDATA, this);
+        h.set_opt(LRO_HMFCB, static_cast<LrHandleMirrorFailureCb>(mirror_failure_cb));
         if (base->get_download_callbacks()) {
             h.set_opt(LRO_PROGRESSCB, static_cast<LrProgressCb>(progress_cb));
-            h.set_opt(LRO_PROGRESSDATA, this);
             h.set_opt(LRO_FASTESTMIRRORCB, static_cast<LrFastestMirrorCb>(fastest_mirror_cb));
             h.set_opt(LRO_FASTESTMIRRORDATA, this);
-            h.set_opt(LRO_HMFCB, static_cast<LrHandleMirrorFailureCb>(mirror_failure_cb));
         }
     }
 
@@ -502,7 +574,6 @@ void RepoDownloader::common_handle_setup(LibrepoHandle & h) {
     h.set_opt(LRO_REPOTYPE, LR_YUMREPO);
     h.set_opt(LRO_YUMDLIST, dlist.data());
     h.set_opt(LRO_INTERRUPTIBLE, 1L);
-    h.set_opt(LRO_GPGCHECK, config.get_repo_gpgcheck_option().get_value());
     h.set_opt(LRO_MAXMIRRORTRIES, static_cast<long>(max_mirror_tries));
     h.set_opt(LRO_MAXPARALLELDOWNLOADS, config.get_max_parallel_downloads_option().get_value());
 
@@ -521,9 +592,14 @@ void RepoDownloader::common_handle_setup(LibrepoHandle & h) {
     h.set_opt(LRO_VARSUB, substs);
 
 #ifdef LRO_SUPPORTS_CACHEDIR
-    // If zchunk is enabled, set librepo cache dir
+    // If zchunk is enabled, set librepo cache dir, the chunks of the downloaded zchunk files are searched for
+    // in the zchunk files under it
     if (config.get_main_config().get_zchunk_option().get_value()) {
-        h.set_opt(LRO_CACHEDIR, config.get_basecachedir_option().get_value().c_str());
+        if (auto zchunk_store = get_zchunk_store()) {
+            h.set_opt(LRO_CACHEDIR, zchunk_store->get_dir().c_str());
+        } else {
+            h.set_opt(LRO_CACHEDIR, config.get_basecachedir_option().get_value().c_str());
+        }
     }
 #endif
 }
@@ -555,11 +631,8 @@ void RepoDownloader::apply_http_headers(LibrepoHandle & handle) {
 }
 
 
-LibrepoResult RepoDownloader::perform(LibrepoHandle & handle, bool set_gpg_home_dir) {
-    if (set_gpg_home_dir) {
-        auto pubringdir = pgp.get_keyring_dir();
-        handle.set_opt(LRO_GNUPGHOMEDIR, pubringdir.c_str());
-    }
+LibrepoResult RepoDownloader::perform(LibrepoHandle & handle) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "librepo perform", config.get_id());
 
     // Start and end is called only if progress callback is set in handle.
     LrProgressCb progress_func;
@@ -570,6 +643,7 @@ LibrepoResult RepoDownloader::perform(LibrepoHandle & handle, bool set_gpg_home_
     add_countme_flag(handle);
 
     if (progress_func && download_callbacks) {
+        std::lock_guard<std::mutex> lock(download_callbacks_mutex);
         user_cb_data = download_callbacks->add_new_download(
             user_data,
             !config.get_name_option().get_value().empty()
@@ -584,11 +658,13 @@ LibrepoResult RepoDownloader::perform(LibrepoHandle & handle, bool set_gpg_home_
     try {
         auto result = handle.perform();
         if (progress_func && download_callbacks) {
+            std::lock_guard<std::mutex> lock(download_callbacks_mutex);
             download_callbacks->end(user_cb_data, DownloadCallbacks::TransferStatus::SUCCESSFUL, nullptr);
         }
         return result;
     } catch (const LibrepoError & ex) {
         if (progress_func && download_callbacks) {
+            std::lock_guard<std::mutex> lock(download_callbacks_mutex);
             download_callbacks->end(user_cb_data, DownloadCallbacks::TransferStatus::ERROR, ex.what());
         }
         throw;
@@ -597,6 +673,8 @@ LibrepoResult RepoDownloader::perform(LibrepoHandle & handle, bool set_gpg_home_
 
 
 void RepoDownloader::download_url(const char * url, int fd) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "download url", url);
+
     auto * download_callbacks = base->get_download_callbacks();
 
     if (download_callbacks) {
@@ -626,6 +704,49 @@ void RepoDownloader::download_url(const char * url, int fd) {
 }
 
 
+void RepoDownloader::verify_repomd_signature(LibrepoResult & result, LibrepoHandle * handle) {
+    auto * yum_repo = get_yum_repo(result);
+    std::filesystem::path repomd_path = yum_repo->repomd;
+    auto signature_path = repomd_path;
+    signature_path += ".asc";
+
+    // The failures are reported with the librepo code, the keys of the repository are imported and
+    // the metadata loaded again on LRE_BADGPG
+    auto throw_bad_signature = [](const std::string & message) {
+        throw LibrepoError(std::unique_ptr<GError>(g_error_new_literal(LR_GPG_ERROR, LRE_BADGPG, message.c_str())));
+    };
+
+    if (handle) {
+        // Downloaded from the same mirror as the repomd.xml
+        auto url = libdnf5::utils::string::c_to_str(yum_repo->url);
+        while (url.ends_with('/')) {
+            url.pop_back();
+        }
+        url += "/repodata/repomd.xml.asc";
+
+        libdnf5::utils::fs::File signature_file(signature_path, "w");
+        GError * err_p{nullptr};
+        if (!lr_download_url(handle->get(), url.c_str(), signature_file.get_fd(), &err_p)) {
+            std::unique_ptr<GError> err(err_p);
+            signature_file.close();
+            std::filesystem::remove(signature_path);
+            throw_bad_signature(
+                std::string("GPG verification is enabled, but GPG signature is not available. This may be an error "
+                            "or the repository does not support GPG verification: ") +
+                err->message);
+        }
+    } else if (!std::filesystem::exists(signature_path)) {
+        throw_bad_signature("GPG verification is enabled, but GPG signature of repomd.xml is not in the cache");
+    }
+
+    try {
+        RepoPgp::verify_signature(pgp.get_keyring_dir(), repomd_path, signature_path);
+    } catch (const RepoPgpError & e) {
+        throw_bad_signature(std::string("repomd.xml GPG signature verification error: ") + e.what());
+    }
+}
+
+
 std::pair<std::string, std::string> RepoDownloader::get_source_info() const {
     if (!config.get_metalink_option().empty() && !config.get_metalink_option().get_value().empty()) {
         return {"metalink", config.get_metalink_option().get_value()};
@@ -776,8 +897,35 @@ std::set<std::string> RepoDownloader::get_optional_metadata() const {
     if (repo_type == Repo::Type::SYSTEM) {
         return libdnf5::OPTIONAL_METADATA_TYPES;
     } else {
-        return config.get_main_config().get_optional_metadata_types_option().get_value();
+        auto types = config.get_main_config().get_optional_metadata_types_option().get_value();
+        // The types declared by the operation are downloaded in addition to the configured ones, the configured
+        // types keep the cached metadata complete for other operations
+        auto & required_types = base->get_repo_sack()->required_optional_metadata_types;
+        if (required_types) {
+            types.insert(required_types->begin(), required_types->end());
+        }
+        return types;
+    }
+}
+
+
+std::optional<ZchunkStore> RepoDownloader::get_zchunk_store() const {
+    auto & main_config = config.get_main_config();
+    auto & store_dir_option = main_config.get_zchunk_store_dir_option();
+    if (!main_config.get_zchunk_option().get_value() || store_dir_option.empty()) {
+        return std::nullopt;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(store_dir_option.get_value(), ec);
+    if (ec) {
+        base->get_logger()->debug(
+            "Cannot use zchunk store \"{}\" for repo \"{}\": {}",
+            store_dir_option.get_value(),
+            config.get_id(),
+            ec.message());
+        return std::nullopt;
     }
+    return ZchunkStore(store_dir_option.get_value());
 }
 
 
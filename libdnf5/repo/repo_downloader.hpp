@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "librepo.hpp"
 #include "repo_pgp.hpp"
+#include "zchunk_store.hpp"
 
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/common/exception.hpp"
@@ -31,6 +32,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <librepo/librepo.h>
 
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <optional>
@@ -41,6 +43,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf5::repo {
 
+/// Replaces `target_item` in a repository cache by `new_item`. An existing target is atomically exchanged with
+/// the new item and removed afterwards from its new location, so that the target path always refers to a complete
+/// item. The caller holds the exclusive lock of the cache.
+void replace_cache_item(const std::filesystem::path & new_item, const std::filesystem::path & target_item);
+
 /// Handles downloading and loading of repository metadata.
 /// @exception RepoDownloadError (public) All public methods should throw this exception,
 ///                                       under which a lower-level exception can often be nested.
@@ -86,7 +93,12 @@ private:
 
     void apply_http_headers(LibrepoHandle & handle);
 
-    LibrepoResult perform(LibrepoHandle & handle, bool set_gpg_home_dir);
+    LibrepoResult perform(LibrepoHandle & handle);
+
+    /// Verifies the signature of the repomd.xml loaded by `result` in-process, instead of librepo calling gpg.
+    /// With `handle` the signature is downloaded next to the repomd.xml first, otherwise the cached one is used.
+    /// @exception LibrepoError With the LRE_BADGPG code when the signature is missing or not valid.
+    void verify_repomd_signature(LibrepoResult & result, LibrepoHandle * handle);
 
     void download_url(const char * url, int fd);
 
@@ -99,6 +111,10 @@ private:
 
     std::set<std::string> get_optional_metadata() const;
 
+    /// Returns the zchunk store set by the "zchunk_store_dir" option when zchunk is enabled, the directory
+    /// of the store is created. Empty when the store is disabled or its directory cannot be created.
+    std::optional<ZchunkStore> get_zchunk_store() const;
+
     libdnf5::BaseWeakPtr base;
     const ConfigRepo & config;
     Repo::Type repo_type;
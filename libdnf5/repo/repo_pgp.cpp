@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "repo_pgp.hpp"
 
+#include "utils/fs/file.hpp"
 #include "utils/fs/temp.hpp"
 
 #include "libdnf5/base/base.hpp"
@@ -26,7 +27,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/repo/repo_errors.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <rpm/rpmkeyring.h>
+#include <rpm/rpmpgp.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace libdnf5::repo {
 
@@ -83,14 +91,78 @@ std::vector<Key> RepoPgp::rawkey2infos(int fd, const std::string & url, const st
 }
 
 
-std::vector<std::string> RepoPgp::load_keys_ids_from_keyring() {
-    std::vector<std::string> keys_ids;
+namespace {
 
-    auto keyring_dir = get_keyring_dir();
-    if (std::filesystem::is_directory(keyring_dir)) {
+using RpmPubkeyPtr = std::unique_ptr<rpmPubkey_s, decltype(&rpmPubkeyFree)>;
+
+struct ParsedKey {
+    std::filesystem::file_time_type mtime;
+    RpmPubkeyPtr pubkey;
+};
+
+// The keys parsed by all the repositories of the process, identified by the paths of the key files
+std::mutex parsed_keys_mutex;
+std::map<std::filesystem::path, ParsedKey> parsed_keys;
+
+// Returns the parsed key from the key file, the key is parsed again only when the file changes.
+// The caller gets its own reference, the cached key can be replaced by another thread meanwhile.
+RpmPubkeyPtr get_parsed_key(const std::filesystem::path & key_path) {
+    auto mtime = std::filesystem::last_write_time(key_path);
+
+    std::lock_guard<std::mutex> lock(parsed_keys_mutex);
+    auto it = parsed_keys.find(key_path);
+    if (it != parsed_keys.end() && it->second.mtime == mtime) {
+        return RpmPubkeyPtr{rpmPubkeyLink(it->second.pubkey.get()), &rpmPubkeyFree};
+    }
+
+    auto armored_key = libdnf5::utils::fs::File(key_path, "r").read();
+    uint8_t * pkt = nullptr;
+    size_t pkt_len{0};
+    if (pgpParsePkts(armored_key.c_str(), &pkt, &pkt_len) != PGPARMOR_PUBKEY) {
+        free(pkt);
+        throw RepoPgpError(M_("\"{}\": key is not an armored public key"), key_path.string());
+    }
+    RpmPubkeyPtr pubkey{rpmPubkeyNew(pkt, pkt_len), &rpmPubkeyFree};
+    free(pkt);
+    if (!pubkey) {
+        throw RepoPgpError(M_("\"{}\": failed to parse public key"), key_path.string());
+    }
+
+    auto & parsed_key = parsed_keys.insert_or_assign(key_path, ParsedKey{mtime, std::move(pubkey)}).first->second;
+    return RpmPubkeyPtr{rpmPubkeyLink(parsed_key.pubkey.get()), &rpmPubkeyFree};
+}
+
+// Writes the key file atomically, the readers never see it incomplete
+void write_key_file(const std::filesystem::path & key_path, const std::string & raw_key) {
+    auto tmp_path = key_path;
+    tmp_path += ".tmp";
+    libdnf5::utils::fs::File key_file(tmp_path, "w");
+    key_file.write(raw_key);
+    key_file.close();
+    std::filesystem::rename(tmp_path, key_path);
+}
+
+}  // namespace
+
+
+std::vector<std::string> RepoPgp::load_keyring_fingerprints(const std::filesystem::path & keyring_dir) {
+    std::vector<std::string> fingerprints;
+
+    if (!std::filesystem::is_directory(keyring_dir)) {
+        return fingerprints;
+    }
+
+    for (const auto & entry : std::filesystem::directory_iterator(keyring_dir)) {
+        if (entry.path().extension() == KEY_FILE_EXTENSION) {
+            fingerprints.emplace_back(entry.path().stem().string());
+        }
+    }
+
+    if (fingerprints.empty() && (std::filesystem::exists(keyring_dir / "pubring.kbx") ||
+                                 std::filesystem::exists(keyring_dir / "pubring.gpg"))) {
         GError * err = NULL;
         std::unique_ptr<LrGpgKey, decltype(&lr_gpg_keys_free)> lr_keys{
-            lr_gpg_list_keys(FALSE, keyring_dir.c_str(), &err), &lr_gpg_keys_free};
+            lr_gpg_list_keys(TRUE, keyring_dir.c_str(), &err), &lr_gpg_keys_free};
         if (err) {
             throw_repo_pgp_error(M_("Failed to list pgp keys: {}"), err);
         }
@@ -100,14 +172,72 @@ std::vector<std::string> RepoPgp::load_keys_ids_from_keyring() {
                  lr_subkey = lr_gpg_subkey_get_next(lr_subkey)) {
                 // get first signing subkey
                 if (lr_gpg_subkey_get_can_sign(lr_subkey)) {
-                    keys_ids.emplace_back(lr_gpg_subkey_get_id(lr_subkey));
+                    // the raw key is missing when gpg fails to export it, the key has to be imported again
+                    const char * raw_key = lr_gpg_key_get_raw_key(lr_key);
+                    if (!raw_key) {
+                        break;
+                    }
+                    std::string fingerprint = lr_gpg_subkey_get_fingerprint(lr_subkey);
+                    write_key_file(keyring_dir / (fingerprint + KEY_FILE_EXTENSION), raw_key);
+                    fingerprints.emplace_back(std::move(fingerprint));
                     break;
                 }
             }
         }
     }
 
-    return keys_ids;
+    return fingerprints;
+}
+
+
+void RepoPgp::verify_signature(
+    const std::filesystem::path & keyring_dir,
+    const std::filesystem::path & data_path,
+    const std::filesystem::path & signature_path) {
+    auto armored_signature = libdnf5::utils::fs::File(signature_path, "r").read();
+    uint8_t * pkt = nullptr;
+    size_t pkt_len{0};
+    if (pgpParsePkts(armored_signature.c_str(), &pkt, &pkt_len) != PGPARMOR_SIGNATURE) {
+        free(pkt);
+        throw RepoPgpError(M_("\"{}\": not an armored signature"), signature_path.string());
+    }
+    pgpDigParams sig_params = nullptr;
+    int parse_rc = pgpPrtParams(pkt, pkt_len, PGPTAG_SIGNATURE, &sig_params);
+    free(pkt);
+    std::unique_ptr<pgpDigParams_s, decltype(&pgpDigParamsFree)> sig{sig_params, &pgpDigParamsFree};
+    if (parse_rc != 0) {
+        throw RepoPgpError(M_("\"{}\": failed to parse signature"), signature_path.string());
+    }
+
+    std::unique_ptr<rpmKeyring_s, decltype(&rpmKeyringFree)> keyring{rpmKeyringNew(), &rpmKeyringFree};
+    for (const auto & fingerprint : load_keyring_fingerprints(keyring_dir)) {
+        auto pubkey = get_parsed_key(keyring_dir / (fingerprint + KEY_FILE_EXTENSION));
+        rpmKeyringAddKey(keyring.get(), pubkey.get());
+    }
+
+    auto digest_deleter = [](DIGEST_CTX ctx) { rpmDigestFinal(ctx, nullptr, nullptr, 0); };
+    std::unique_ptr<DIGEST_CTX_s, decltype(digest_deleter)> digest{
+        rpmDigestInit(static_cast<int>(pgpDigParamsAlgo(sig.get(), PGPVAL_HASHALGO)), RPMDIGEST_NONE),
+        digest_deleter};
+    if (!digest) {
+        throw RepoPgpError(M_("\"{}\": unsupported signature hash algorithm"), signature_path.string());
+    }
+    libdnf5::utils::fs::File data_file(data_path, "r");
+    char buf[BUFSIZ];
+    while (auto len = data_file.read(buf, sizeof(buf))) {
+        rpmDigestUpdate(digest.get(), buf, len);
+    }
+
+    switch (rpmKeyringVerifySig(keyring.get(), sig.get(), digest.get())) {
+        case RPMRC_OK:
+            return;
+        case RPMRC_NOKEY: {
+            std::unique_ptr<char, decltype(&free)> key_id{pgpHexStr(pgpDigParamsSignID(sig.get()), 8), &free};
+            throw RepoPgpError(M_("Signing key 0x{} not found in keyring \"{}\""), key_id.get(), keyring_dir.string());
+        }
+        default:
+            throw RepoPgpError(M_("Bad signature \"{}\" of \"{}\""), signature_path.string(), data_path.string());
+    }
 }
 
 
@@ -119,9 +249,11 @@ void RepoPgp::import_key(int fd, const std::string & url) {
 
     auto key_infos = rawkey2infos(fd, url);
 
-    auto known_keys = load_keys_ids_from_keyring();
+    auto keyring_dir = get_keyring_dir();
+    auto known_fingerprints = load_keyring_fingerprints(keyring_dir);
     for (auto & key_info : key_infos) {
-        if (std::find(known_keys.begin(), known_keys.end(), key_info.get_key_id()) != known_keys.end()) {
+        if (std::find(known_fingerprints.begin(), known_fingerprints.end(), key_info.get_fingerprint()) !=
+            known_fingerprints.end()) {
             logger.debug("Pgp key 0x{} for repository {} already imported.", key_info.get_key_id(), config.get_id());
             continue;
         }
@@ -130,17 +262,11 @@ void RepoPgp::import_key(int fd, const std::string & url) {
             continue;
         }
 
-        auto keyring_dir = get_keyring_dir();
-
         if (!std::filesystem::is_directory(keyring_dir)) {
             std::filesystem::create_directories(keyring_dir);
         }
 
-        GError * err = NULL;
-        if (!lr_gpg_import_key_from_memory(
-                key_info.get_raw_key().c_str(), key_info.get_raw_key().size(), keyring_dir.c_str(), &err)) {
-            throw_repo_pgp_error(M_("Failed to import pgp keys: {}"), err);
-        }
+        write_key_file(keyring_dir / (key_info.get_fingerprint() + KEY_FILE_EXTENSION), key_info.get_raw_key());
 
         if (callbacks) {
             callbacks->repokey_imported(key_info);
@@ -41,9 +41,13 @@ public:
 };
 
 /// Wraps pgp in a higher-level interface.
+/// The keyring of a repository is a directory with one armored public key per file, the files are named
+/// by the fingerprints of the keys.
 /// @exception RepoPgpError (public) Thrown on any pgp-related error.
 class RepoPgp {
 public:
+    static constexpr const char * KEY_FILE_EXTENSION = ".asc";
+
     RepoPgp(const BaseWeakPtr & base, const ConfigRepo & config);
 
     void set_callbacks(RepoCallbacks * callbacks) noexcept { this->callbacks = callbacks; }
@@ -53,8 +57,20 @@ public:
     void import_key(int fd, const std::string & url);
     static std::vector<Key> rawkey2infos(int fd, const std::string & url, const std::string & path = "");
 
+    /// Verifies the detached armored signature `signature_path` of the file `data_path` in-process with the keys
+    /// of the keyring in `keyring_dir`. The parsed keys are cached in memory by the paths of the key files for the
+    /// whole process, a key file is parsed again only when it changes.
+    /// @exception RepoPgpError When the signature is malformed, its key is not in the keyring or it does not match.
+    static void verify_signature(
+        const std::filesystem::path & keyring_dir,
+        const std::filesystem::path & data_path,
+        const std::filesystem::path & signature_path);
+
+    /// Returns the fingerprints of the keys in `keyring_dir`. A keyring left by the previous gpg based
+    /// verification is converted to the key files first.
+    static std::vector<std::string> load_keyring_fingerprints(const std::filesystem::path & keyring_dir);
+
 private:
-    std::vector<std::string> load_keys_ids_from_keyring();
     BaseWeakPtr base;
     const ConfigRepo & config;
     RepoCallbacks * callbacks = nullptr;
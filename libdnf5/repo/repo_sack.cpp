@@ -20,13 +20,17 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/repo/repo_sack.hpp"
 
 #include "../module/module_sack_impl.hpp"
+#include "base/base_impl.hpp"
 #include "repo_cache_private.hpp"
+#include "repo_config_snapshot.hpp"
 #include "repo_downloader.hpp"
 #include "rpm/package_sack_impl.hpp"
 #include "solv/solver.hpp"
 #include "solv_repo.hpp"
+#include "utils/background.hpp"
 #include "utils/fs/file.hpp"
 #include "utils/fs/temp.hpp"
+#include "utils/on_scope_exit.hpp"
 #include "utils/string.hpp"
 #include "utils/url.hpp"
 #include "utils/xml.hpp"
@@ -36,6 +40,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/comps/environment/query.hpp"
 #include "libdnf5/comps/group/query.hpp"
 #include "libdnf5/conf/config_parser.hpp"
+#include "libdnf5/conf/const.hpp"
 #include "libdnf5/conf/option_bool.hpp"
 #include "libdnf5/repo/file_downloader.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
@@ -44,13 +49,21 @@ extern "C" {
 #include <solv/testcase.h>
 }
 
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <condition_variable>
 #include <filesystem>
 #include <mutex>
+#include <optional>
 #include <sstream>
+#include <string_view>
 #include <thread>
+#include <tuple>
 
 
 using LibsolvRepo = ::Repo;
@@ -101,6 +114,24 @@ RepoWeakPtr RepoSack::get_cmdline_repo() {
 }
 
 
+/// Asks the kernel to read the package files at `paths` ahead. The files are then read concurrently in the background
+/// while the packages are added to the command line repo one by one, which cannot be done in parallel.
+static void advise_read_ahead(const std::vector<std::string> & paths) {
+    if (paths.size() <= 1) {
+        return;
+    }
+    for (const auto & path : paths) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            // The error is reported when the package is added
+            continue;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+}
+
+
 std::map<std::string, libdnf5::rpm::Package> RepoSack::add_cmdline_packages(
     const std::vector<std::string> & paths, bool calculate_checksum) {
     // find remote URLs and local file paths in the input
@@ -168,6 +199,12 @@ std::map<std::string, libdnf5::rpm::Package> RepoSack::add_cmdline_packages(
         }
         downloader.download();
 
+        std::vector<std::string> downloaded_paths;
+        for (const auto & [url, path] : url_to_path) {
+            downloaded_paths.push_back(path.string());
+        }
+        advise_read_ahead(downloaded_paths);
+
         // fill the command line repo with downloaded URLs
         for (const auto & [url, path] : url_to_path) {
             path_to_package.emplace(url, cmdline_repo->add_rpm_package(path.string(), calculate_checksum));
@@ -175,6 +212,7 @@ std::map<std::string, libdnf5::rpm::Package> RepoSack::add_cmdline_packages(
     }
 
     // fill the command line repo with local files
+    advise_read_ahead(rpm_filepaths);
     for (const auto & path : rpm_filepaths) {
         if (!path_to_package.contains(path)) {
             path_to_package.emplace(path, cmdline_repo->add_rpm_package(path, calculate_checksum));
@@ -201,6 +239,89 @@ RepoWeakPtr RepoSack::get_system_repo() {
     return system_repo->get_weak_ptr();
 }
 
+/// Runs `task` for each repository in `repos` in up to `max_workers` worker threads.
+/// The `on_finished(repo, result, except_ptr)` callback is called in the calling thread for each repository
+/// in the order in which the tasks finished. `result` is the value returned by the `task`, `except_ptr` holds
+/// an exception thrown by the `task` (or is null).
+/// If `on_finished` throws, no new tasks are started and the exception is propagated after all running tasks finish.
+template <typename Task, typename OnFinished>
+static void process_repos_concurrently(
+    const std::vector<Repo *> & repos, std::size_t max_workers, Task task, OnFinished on_finished) {
+    if (repos.empty()) {
+        return;
+    }
+
+    // index of the next repository to be processed by a worker
+    std::size_t next_repo_idx{0};
+    // repositories whose task finished (in order of completion), the result of the task and a possible error
+    std::vector<std::tuple<Repo *, bool, std::exception_ptr>> finished_repos;
+    // set to true when workers must not start new tasks
+    bool stop_workers{false};
+    // mutex for the variables above
+    std::mutex repos_mutex;
+    // signals that next item is added into finished_repos
+    std::condition_variable signal_finished_repo;
+
+    finished_repos.reserve(repos.size());
+
+    auto worker = [&]() {
+        while (true) {
+            Repo * repo;
+            {
+                std::lock_guard<std::mutex> lock(repos_mutex);
+                if (stop_workers || next_repo_idx >= repos.size()) {
+                    break;
+                }
+                repo = repos[next_repo_idx++];
+            }
+
+            // The worker must not throw exceptions. Pass them to the calling thread using exception_ptr.
+            bool result{false};
+            std::exception_ptr except_ptr;
+            try {
+                result = task(repo);
+            } catch (...) {
+                except_ptr = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(repos_mutex);
+                finished_repos.emplace_back(repo, result, except_ptr);
+            }
+            signal_finished_repo.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    // Waits for the workers to finish running tasks. It is also called when an exception is being
+    // propagated from `on_finished`, the workers must not outlive the local variables they reference.
+    utils::OnScopeExit join_workers([&]() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(repos_mutex);
+            stop_workers = true;
+        }
+        for (auto & thread : workers) {
+            thread.join();
+        }
+    });
+
+    const auto num_workers = std::min(repos.size(), std::max<std::size_t>(max_workers, 1));
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    for (std::size_t idx = 0; idx < repos.size(); ++idx) {
+        std::unique_lock<std::mutex> lock(repos_mutex);
+        signal_finished_repo.wait(lock, [&]() { return finished_repos.size() > idx; });
+        auto [repo, result, except_ptr] = finished_repos[idx];
+        lock.unlock();
+
+        on_finished(repo, result, except_ptr);
+    }
+}
+
 /**
  *
  * @param repos Set of repositories to load
@@ -208,7 +329,32 @@ RepoWeakPtr RepoSack::get_system_repo() {
  * @warning This function should not be used to load and update repositories. Instead, use `RepoSack::update_and_load_enabled_repos`
  */
 void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool import_keys) {
+    update_repos_impl(repos, import_keys, true);
+}
+
+
+std::size_t RepoSack::update_repos(libdnf5::repo::RepoQuery & repos, bool import_keys) {
+    return update_repos_impl(repos, import_keys, false);
+}
+
+
+std::size_t RepoSack::update_repos_impl(libdnf5::repo::RepoQuery & repos, bool import_keys, bool load) {
     auto logger = base->get_logger();
+    auto & span_recorder = base->get_span_recorder();
+    libdnf5::base::SpanRecorder::Scope span(span_recorder, load ? "load repos" : "update repos");
+
+    // In the background mode the priorities are lowered before any thread is started, the download, cache builder
+    // and sack loader threads inherit them.
+    // The update waits for the memory pressure once, before any thread is started and any cache is locked. A wait
+    // in the threads would hold up the repositories being processed by the others.
+    auto & config = base->get_config();
+    utils::wait_for_memory_pressure(*logger, utils::get_memory_pressure_limit(config));
+    std::optional<utils::BackgroundPriority> background_priority;
+    if (config.get_background_mode_option().get_value()) {
+        background_priority.emplace(*logger);
+    }
+
+    std::atomic<std::size_t> num_repos_downloaded{0};
 
     std::atomic<bool> except_in_main_thread{false};  // set to true if an exception occurred in the main thread
     std::exception_ptr except_ptr;                   // for pass exception from thread_sack_loader to main thread,
@@ -236,7 +382,10 @@ void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool impo
                     break;  // nullptr mark - work is done, or exception in main thread
                 }
 
-                repo->load();
+                // Without loading, the cache builders already wrote the libsolv cache files of the repository
+                if (load) {
+                    repo->load();
+                }
                 ++num_repos_loaded;
             }
         } catch (std::runtime_error & ex) {
@@ -246,7 +395,7 @@ void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool impo
     });
 
     // Add repository to array of repositories prepared to load into solv sack.
-    auto send_to_sack_loader = [&](repo::Repo * repo) {
+    auto add_prepared_repo = [&](repo::Repo * repo) {
         {
             std::lock_guard<std::mutex> lock(prepared_repos_mutex);
             prepared_repos.push_back(repo);
@@ -254,9 +403,92 @@ void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool impo
         signal_prepared_repo.notify_one();
     };
 
+    // Optional cache builder threads. They parse metadata of available repositories without valid libsolv cache
+    // files into private staging pools concurrently and write the cache files. Then they pass the repositories
+    // to the thread_sack_loader, which only loads the cache files into the main pool.
+    std::vector<Repo *> repos_to_stage;            // array of repositories to be processed by cache builders
+    std::size_t num_repos_staged{0};               // number of repositories already taken by cache builders
+    bool no_more_repos_to_stage{false};            // set to true when all repositories were added into array
+    std::mutex repos_to_stage_mutex;               // mutex for the variables above
+    std::condition_variable signal_repo_to_stage;  // signals that next item is added into array
+    std::vector<std::thread> cache_builders;
+
+    auto cache_builder = [&]() {
+        while (true) {
+            Repo * repo;
+            {
+                std::unique_lock<std::mutex> lock(repos_to_stage_mutex);
+                signal_repo_to_stage.wait(
+                    lock, [&]() { return num_repos_staged < repos_to_stage.size() || no_more_repos_to_stage; });
+                if (num_repos_staged >= repos_to_stage.size()) {
+                    break;  // work is done
+                }
+                repo = repos_to_stage[num_repos_staged++];
+            }
+
+            if (!except_in_main_thread) {
+                try {
+                    libdnf5::base::SpanRecorder::Scope build_span(span_recorder, "build solv cache", repo->get_id());
+                    repo->build_solv_cache();
+                } catch (const std::exception & ex) {
+                    // Not fatal. The sack loader parses the metadata again and reports the error if it persists.
+                    // Without loading the error is only reported, the metadata are parsed again when loaded.
+                    if (load) {
+                        logger->debug("Failed to build solv cache for repo \"{}\": {}", repo->get_id(), ex.what());
+                    } else {
+                        logger->warning("Failed to build solv cache for repo \"{}\": {}", repo->get_id(), ex.what());
+                    }
+                }
+            }
+
+            add_prepared_repo(repo);
+        }
+    };
+
+    // Waits for the cache builders to process all repositories added into array.
+    auto join_cache_builders = [&]() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(repos_to_stage_mutex);
+            no_more_repos_to_stage = true;
+        }
+        signal_repo_to_stage.notify_all();
+        for (auto & builder : cache_builders) {
+            if (builder.joinable()) {
+                builder.join();
+            }
+        }
+    };
+
+    // The cache builders must not outlive the local variables even if an exception is propagated.
+    utils::OnScopeExit cache_builders_guard([&]() noexcept { join_cache_builders(); });
+
+    auto num_cache_builders = base->get_config().get_max_parallel_repo_cache_builds_option().get_value();
+    if (!load) {
+        // Only the cache builders write the cache files, they keep up with the concurrent downloads
+        num_cache_builders = std::max(
+            num_cache_builders, base->get_config().get_max_parallel_repo_downloads_option().get_value());
+    }
+    for (std::uint32_t i = 0; i < num_cache_builders; ++i) {
+        cache_builders.emplace_back(cache_builder);
+    }
+
+    // Send repository to the sack loader. Available repositories are passed through cache builders if enabled.
+    auto send_to_sack_loader = [&](repo::Repo * repo) {
+        if (!cache_builders.empty() && repo->get_type() == Repo::Type::AVAILABLE) {
+            {
+                std::lock_guard<std::mutex> lock(repos_to_stage_mutex);
+                repos_to_stage.push_back(repo);
+            }
+            signal_repo_to_stage.notify_one();
+        } else {
+            add_prepared_repo(repo);
+        }
+    };
+
     // Adds information that all repos are updated (nullptr tag) and is waiting for thread_sack_loader to complete.
     auto finish_sack_loader = [&]() {
-        send_to_sack_loader(nullptr);
+        join_cache_builders();
+        add_prepared_repo(nullptr);
         thread_sack_loader.join();  // waits for the thread_sack_loader to finish its execution
     };
 
@@ -312,7 +544,10 @@ void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool impo
                         repos_for_processing.emplace_back(repo.get());
                         break;
                     case Repo::Type::SYSTEM:
-                        send_to_sack_loader(repo.get());
+                        // the system repository has no metadata to update
+                        if (load) {
+                            send_to_sack_loader(repo.get());
+                        }
                         break;
                     case Repo::Type::COMMANDLINE:;
                 }
@@ -411,72 +646,112 @@ void RepoSack::update_and_load_repos(libdnf5::repo::RepoQuery & repos, bool impo
             }
         }
 
-        // Prepares repositories that are expired but match the original.
-        for (std::size_t idx = 0; idx < repos_for_processing.size();) {
-            auto * const repo = repos_for_processing[idx];
-            catch_thread_sack_loader_exceptions();
-            try {
-                if (!repo->downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).empty() &&
-                    repo->is_in_sync()) {
-                    // the expired metadata still reflect the origin
-                    utimes(repo->downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).c_str(), nullptr);
-                    RepoCache(base, repo->config.get_cachedir()).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
-                    repo->expired = false;
-                    repos_for_processing.erase(repos_for_processing.begin() + static_cast<ssize_t>(idx));
+        const std::size_t max_parallel_repos = base->get_config().get_max_parallel_repo_downloads_option().get_value();
 
-                    logger->debug(
-                        "Using cache for repo \"{}\". It is expired, but matches the original.", repo->config.get_id());
-                    send_to_sack_loader(repo);
+        // Prepares repositories that are expired but match the original.
+        // The sync checks of the repositories are performed concurrently, so that the total cost is
+        // approximately one round-trip instead of one round-trip per repository.
+        {
+            std::vector<Repo *> repos_to_check;     // repositories with cached metadata
+            std::vector<Repo *> repos_to_download;  // repositories that need new metadata
+            for (auto * repo : repos_for_processing) {
+                if (repo->downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).empty()) {
+                    repos_to_download.emplace_back(repo);
                 } else {
-                    ++idx;
+                    repos_to_check.emplace_back(repo);
                 }
-
-            } catch (const RepoDownloadError & e) {
-                if (handle_repo_download_error(repo, e, import_keys)) {
-                    repos_with_bad_signature.emplace_back(repo);
-                }
-                repos_for_processing.erase(repos_for_processing.begin() + static_cast<ssize_t>(idx));
-            } catch (const std::runtime_error & e) {
-                except_in_main_thread = true;
-                finish_sack_loader();
-                throw;
             }
+
+            process_repos_concurrently(
+                repos_to_check,
+                max_parallel_repos,
+                [&span_recorder](Repo * repo) {
+                    libdnf5::base::SpanRecorder::Scope check_span(span_recorder, "check metadata", repo->get_id());
+                    return repo->is_in_sync();
+                },
+                [&](Repo * repo, bool in_sync, const std::exception_ptr & except_ptr) {
+                    catch_thread_sack_loader_exceptions();
+                    try {
+                        if (except_ptr) {
+                            std::rethrow_exception(except_ptr);
+                        }
+                        if (in_sync) {
+                            // the expired metadata still reflect the origin
+                            utimes(
+                                repo->downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).c_str(),
+                                nullptr);
+                            RepoCache(base, repo->config.get_cachedir())
+                                .remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
+                            repo->expired = false;
+
+                            logger->debug(
+                                "Using cache for repo \"{}\". It is expired, but matches the original.",
+                                repo->config.get_id());
+                            send_to_sack_loader(repo);
+                        } else {
+                            repos_to_download.emplace_back(repo);
+                        }
+                    } catch (const RepoDownloadError & e) {
+                        if (handle_repo_download_error(repo, e, import_keys)) {
+                            repos_with_bad_signature.emplace_back(repo);
+                        }
+                    } catch (const std::runtime_error & e) {
+                        except_in_main_thread = true;
+                        finish_sack_loader();
+                        throw;
+                    }
+                });
+
+            repos_for_processing = std::move(repos_to_download);
         }
 
         // Prepares (downloads) remaining repositories.
-        for (std::size_t idx = 0; idx < repos_for_processing.size();) {
-            auto * const repo = repos_for_processing[idx];
-            catch_thread_sack_loader_exceptions();
-            try {
+        // Metadata of up to "max_parallel_repo_downloads" repositories are downloaded concurrently. The repositories
+        // are passed to the sack loader in the order in which their download finished.
+        process_repos_concurrently(
+            repos_for_processing,
+            max_parallel_repos,
+            [&](Repo * repo) {
                 logger->debug("Downloading metadata for repo \"{}\"", repo->config.get_id());
+                libdnf5::base::SpanRecorder::Scope download_span(span_recorder, "download metadata", repo->get_id());
                 auto cache_dir = repo->config.get_cachedir();
                 repo->download_metadata(cache_dir);
+                ++num_repos_downloaded;
                 RepoCache(base, cache_dir).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
                 repo->timestamp = -1;
                 repo->read_metadata_cache();
                 repo->expired = false;
-
-                repos_for_processing.erase(repos_for_processing.begin() + static_cast<ssize_t>(idx));
-                send_to_sack_loader(repo);
-            } catch (const RepoDownloadError & e) {
-                if (handle_repo_download_error(repo, e, import_keys)) {
-                    repos_with_bad_signature.emplace_back(repo);
+                return true;
+            },
+            [&](Repo * repo, [[maybe_unused]] bool result, const std::exception_ptr & except_ptr) {
+                catch_thread_sack_loader_exceptions();
+                try {
+                    if (except_ptr) {
+                        std::rethrow_exception(except_ptr);
+                    }
+                    send_to_sack_loader(repo);
+                } catch (const RepoDownloadError & e) {
+                    if (handle_repo_download_error(repo, e, import_keys)) {
+                        repos_with_bad_signature.emplace_back(repo);
+                    }
+                } catch (const std::runtime_error & e) {
+                    except_in_main_thread = true;
+                    finish_sack_loader();
+                    throw;
                 }
-                repos_for_processing.erase(repos_for_processing.begin() + static_cast<ssize_t>(idx));
-            } catch (const std::runtime_error & e) {
-                except_in_main_thread = true;
-                finish_sack_loader();
-                throw;
-            }
-        }
+            });
     };
 
     finish_sack_loader();
     catch_thread_sack_loader_exceptions();
 
-    fix_group_missing_xml();
+    if (load) {
+        fix_group_missing_xml();
+
+        base->get_rpm_package_sack()->load_config_excludes_includes();
+    }
 
-    base->get_rpm_package_sack()->load_config_excludes_includes();
+    return num_repos_downloaded;
 }
 
 
@@ -506,14 +781,47 @@ void RepoSack::update_and_load_enabled_repos(bool load_system) {
 
 void RepoSack::dump_debugdata(const std::string & dir) {
     libdnf5::solv::Solver solver{get_rpm_pool(base)};
-    solver.write_debugdata(dir, false);
+    libdnf5::solv::DebugdataOptions options;
+    options.zstd = base->get_config().get_debugdata_compression_option().get_value() == "zstd";
+    solver.write_debugdata(dir, false, options);
+}
+
+
+namespace {
+
+constexpr std::string_view REPO_CONFIG_SNAPSHOT_MAGIC = "libdnf5 repo config snapshot 1\n";
+constexpr const char * REPO_CONFIG_SNAPSHOT_FILE_NAME = "repo_config.snapshot";
+
+/// Returns the sorted paths of the repository configuration files in the directory `dir_path`.
+/// @return `std::nullopt` if the directory cannot be read, a warning is logged.
+std::optional<std::vector<std::filesystem::path>> get_repo_file_paths(const std::string & dir_path, Logger & logger) {
+    std::error_code ec;
+    std::filesystem::directory_iterator di(dir_path, ec);
+    if (ec) {
+        logger.warning("Cannot read repositories from directory \"{}\": {}", dir_path, ec.message());
+        return std::nullopt;
+    }
+    std::vector<std::filesystem::path> paths;
+    for (auto & dentry : di) {
+        auto & path = dentry.path();
+        if (dentry.is_regular_file() && path.extension() == ".repo") {
+            paths.push_back(path);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
 }
 
+}  // namespace
 
 void RepoSack::create_repos_from_file(const std::string & path) {
-    auto & logger = *base->get_logger();
     ConfigParser parser;
-    parser.read(path);
+    parser.read(path, false);
+    create_repos_from_parser(path, parser);
+}
+
+void RepoSack::create_repos_from_parser(const std::string & path, const ConfigParser & parser) {
+    auto & logger = *base->get_logger();
     const auto & cfg_parser_data = parser.get_data();
     for (const auto & cfg_parser_data_iter : cfg_parser_data) {
         const auto & section = cfg_parser_data_iter.first;
@@ -548,23 +856,11 @@ void RepoSack::create_repos_from_config_file() {
 }
 
 void RepoSack::create_repos_from_dir(const std::string & dir_path) {
-    std::error_code ec;
-    std::filesystem::directory_iterator di(dir_path, ec);
-    if (ec) {
-        base->get_logger()->warning("Cannot read repositories from directory \"{}\": {}", dir_path, ec.message());
-        return;
-    }
-    std::vector<std::filesystem::path> paths;
-    for (auto & dentry : di) {
-        auto & path = dentry.path();
-        if (dentry.is_regular_file() && path.extension() == ".repo") {
-            paths.push_back(path);
+    if (auto paths = get_repo_file_paths(dir_path, *base->get_logger())) {
+        for (auto & path : *paths) {
+            create_repos_from_file(path);
         }
     }
-    std::sort(paths.begin(), paths.end());
-    for (auto & path : paths) {
-        create_repos_from_file(path);
-    }
 }
 
 void RepoSack::create_repos_from_reposdir() {
@@ -588,14 +884,109 @@ void RepoSack::create_repos_from_paths(
 }
 
 void RepoSack::create_repos_from_system_configuration() {
-    create_repos_from_config_file();
-    create_repos_from_reposdir();
+    auto & config = base->get_config();
+    if (!config.get_repo_config_snapshot_option().get_value()) {
+        create_repos_from_config_file();
+        create_repos_from_reposdir();
+        return;
+    }
+
+    auto & logger = *base->get_logger();
+    const auto & reposdirs = config.get_reposdir_option().get_value();
+
+    // The key identifies the configuration files to read, the snapshot records their state
+    std::string snapshot_key(REPO_CONFIG_SNAPSHOT_MAGIC);
+    base->with_config_file_path(std::function<void(const std::string &)>{
+        [&snapshot_key](const std::string & path) { snapshot_key.append(fmt::format("config\t{}\n", path)); }});
+    for (const auto & dir : reposdirs) {
+        snapshot_key.append(fmt::format("reposdir\t{}\n", dir));
+    }
+
+    std::filesystem::path snapshot_path =
+        std::filesystem::path(config.get_cachedir_option().get_value()) / REPO_CONFIG_SNAPSHOT_FILE_NAME;
+    RepoConfigSnapshot snapshot;
+    if (snapshot.read(snapshot_path, snapshot_key)) {
+        logger.debug("Repositories configuration loaded from snapshot \"{}\"", snapshot_path.string());
+    } else {
+        snapshot = RepoConfigSnapshot();
+        base->with_config_file_path(std::function<void(const std::string &)>{
+            [&snapshot](const std::string & path) { snapshot.add_file(path); }});
+        // A directory that cannot be read is reported on each run, the snapshot is not stored
+        bool complete = true;
+        for (const auto & dir : reposdirs) {
+            snapshot.add_input(dir);
+            if (!std::filesystem::exists(dir)) {
+                continue;
+            }
+            if (auto paths = get_repo_file_paths(dir, logger)) {
+                for (auto & path : *paths) {
+                    snapshot.add_file(path);
+                }
+            } else {
+                complete = false;
+            }
+        }
+        if (complete) {
+            try {
+                snapshot.write(snapshot_path, snapshot_key);
+            } catch (const std::exception & ex) {
+                logger.debug(
+                    "Cannot write repositories configuration snapshot \"{}\": {}", snapshot_path.string(), ex.what());
+            }
+        }
+    }
+
+    for (const auto & file : snapshot.get_files()) {
+        create_repos_from_parser(file.path, file.parser);
+    }
 }
 
 BaseWeakPtr RepoSack::get_base() const {
     return base;
 }
 
+void RepoSack::set_loaded_optional_metadata_types(std::set<std::string> types) {
+    loaded_optional_metadata_types = std::move(types);
+}
+
+std::set<std::string> RepoSack::get_loaded_optional_metadata_types() const {
+    const auto & types_option = base->get_config().get_optional_metadata_types_option();
+    std::set<std::string> types;
+    // The option is used also with declared types when the user set it
+    if (!required_optional_metadata_types || types_option.get_priority() > Option::Priority::DEFAULT) {
+        types = types_option.get_value();
+    }
+    if (required_optional_metadata_types) {
+        types.insert(required_optional_metadata_types->begin(), required_optional_metadata_types->end());
+    }
+    if (loaded_optional_metadata_types) {
+        std::erase_if(
+            types, [this](const std::string & type) { return !loaded_optional_metadata_types->contains(type); });
+    }
+    return types;
+}
+
+void RepoSack::require_optional_metadata_types(const std::set<std::string> & types) {
+    if (!required_optional_metadata_types) {
+        required_optional_metadata_types.emplace();
+    }
+    required_optional_metadata_types->insert(types.begin(), types.end());
+
+    // The repositories loaded before the declaration are upgraded to the required types
+    bool loaded_on_demand = false;
+    RepoQuery loaded_repos(base);
+    loaded_repos.filter_type(Repo::Type::AVAILABLE);
+    for (auto & repo : loaded_repos.get_data()) {
+        if (repo->loaded) {
+            repo->load_optional_metadata_on_demand(types);
+            loaded_on_demand = true;
+        }
+    }
+    if (loaded_on_demand && types.contains(libdnf5::METADATA_TYPE_COMPS)) {
+        fix_group_missing_xml();
+    }
+}
+
 void RepoSack::enable_source_repos() {
     RepoQuery enabled_repos(base);
     enabled_repos.filter_enabled(true);
@@ -618,6 +1009,37 @@ void RepoSack::enable_source_repos() {
     }
 }
 
+MemoryUsage RepoSack::get_memory_usage() {
+    MemoryUsage usage;
+
+    // The system and cmdline repositories are items of the sack as well
+    for (const auto & repo : get_data()) {
+        if (repo->solv_repo) {
+            usage.repos.push_back(repo->solv_repo->get_memory_usage());
+        }
+    }
+    std::sort(usage.repos.begin(), usage.repos.end(), [](const auto & lhs, const auto & rhs) {
+        return lhs.repo_id < rhs.repo_id;
+    });
+
+    auto rpm_pool = solv::get_pool_memory_usage(*get_rpm_pool(base));
+    usage.pool_strings_bytes = rpm_pool.strings;
+    usage.pool_reldeps_bytes = rpm_pool.reldeps;
+    usage.pool_whatprovides_bytes = rpm_pool.whatprovides;
+
+    auto comps_pool = solv::get_pool_memory_usage(*get_comps_pool(base));
+    usage.comps_pool_bytes = comps_pool.strings + comps_pool.reldeps + comps_pool.whatprovides;
+
+    auto module_pool = solv::get_pool_memory_usage(base->get_module_sack()->p_impl->pool);
+    usage.module_pool_bytes =
+        module_pool.strings + module_pool.reldeps + module_pool.whatprovides + module_pool.solvables;
+
+    base->get_rpm_package_sack()->p_impl->add_memory_usage(usage);
+    usage.advisory_caches_bytes = InternalBaseUser::get_rpm_advisory_sack(base)->get_memory_usage();
+
+    return usage;
+}
+
 void RepoSack::internalize_repos() {
     auto rq = RepoQuery(base);
     for (auto & repo : rq.get_data()) {
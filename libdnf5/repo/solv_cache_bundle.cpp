@@ -0,0 +1,263 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solv_cache_bundle.hpp"
+
+#include "repo_cache_private.hpp"
+#include "repo_downloader.hpp"
+#include "repo_pgp.hpp"
+#include "solv_repo.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+#include "utils/locker.hpp"
+
+#include "libdnf5/repo/repo_errors.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <toml.hpp>
+
+extern "C" {
+#include <solv/chksum.h>
+#include <solv/knownid.h>
+#include <solv/solvversion.h>
+#include <solv/util.h>
+}
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+constexpr const char * CACHE_BUNDLE_VERSION = "1.0";
+
+struct BundleFile {
+    /// Path relative to the bundle and to the repository cache directory
+    std::string path;
+    std::uint64_t size;
+    std::string sha256;
+};
+
+std::string checksum_to_hex(const unsigned char * checksum, std::size_t size) {
+    std::string hex(size * 2, '\0');
+    solv_bin2hex(checksum, static_cast<int>(size), hex.data());
+    return hex;
+}
+
+/// Returns the sha256 checksum of the file at `path` in hex
+std::string file_sha256(const std::filesystem::path & path) {
+    utils::fs::File file(path, "r");
+    std::unique_ptr<Chksum, void (*)(Chksum *)> chksum(
+        solv_chksum_create(REPOKEY_TYPE_SHA256), [](Chksum * ptr) { solv_chksum_free(ptr, nullptr); });
+    std::array<char, 65536> buffer;
+    while (auto read = file.read(buffer.data(), buffer.size())) {
+        solv_chksum_add(chksum.get(), buffer.data(), static_cast<int>(read));
+    }
+    int length;
+    auto * bytes = solv_chksum_get(chksum.get(), &length);
+    return checksum_to_hex(bytes, static_cast<std::size_t>(length));
+}
+
+/// Returns the checksum of the repomd.xml file the solv cache files are tied to in hex
+std::string repomd_checksum_hex(const std::filesystem::path & repomd_path, unsigned char * checksum) {
+    SolvRepo::repomd_checksum_calc(repomd_path, checksum);
+    return checksum_to_hex(checksum, CHKSUM_BYTES);
+}
+
+/// Only plain files directly in the metadata and the solv cache directories are accepted, so that a manifest
+/// cannot place files elsewhere in the cache
+bool is_valid_bundle_path(const std::filesystem::path & path) {
+    auto it = path.begin();
+    if (path.is_absolute() || it == path.end() || (*it != CACHE_METADATA_DIR && *it != CACHE_SOLV_FILES_DIR)) {
+        return false;
+    }
+    if (++it == path.end() || it->empty() || *it == "." || *it == "..") {
+        return false;
+    }
+    return ++it == path.end();
+}
+
+void check_signature(libdnf5::Logger & logger, const ConfigRepo & config, const std::filesystem::path & bundle_dir) {
+    auto signature_path = bundle_dir / CACHE_BUNDLE_SIGNATURE;
+    if (!std::filesystem::exists(signature_path)) {
+        if (config.get_repo_gpgcheck_option().get_value()) {
+            throw RepoError(
+                M_("Solv cache bundle for repository \"{}\" is not signed and repo_gpgcheck is enabled"),
+                config.get_id());
+        }
+        return;
+    }
+    auto keyring_dir = std::filesystem::path(config.get_cachedir()) / "pubring";
+    try {
+        RepoPgp::verify_signature(keyring_dir, bundle_dir / CACHE_BUNDLE_MANIFEST, signature_path);
+    } catch (const RepoPgpError & e) {
+        throw RepoError(
+            M_("Bad signature of solv cache bundle for repository \"{}\": {}"), config.get_id(), std::string(e.what()));
+    }
+    logger.debug("Signature of solv cache bundle for repository \"{}\" verified", config.get_id());
+}
+
+}  // namespace
+
+
+void export_solv_cache_bundle(
+    libdnf5::Logger & logger, const ConfigRepo & config, const std::filesystem::path & bundle_dir) {
+    std::filesystem::path cache_dir = config.get_cachedir();
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(config.get_cachedir()), false);
+    cache_locker.read_lock(true);
+
+    auto repomd_path = cache_dir / CACHE_METADATA_DIR / "repomd.xml";
+    if (!std::filesystem::exists(repomd_path)) {
+        throw RepoError(M_("Repository \"{}\" has no metadata in cache to export"), config.get_id());
+    }
+    unsigned char repomd_checksum[CHKSUM_BYTES];
+    auto repomd_checksum_str = repomd_checksum_hex(repomd_path, repomd_checksum);
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto & entry : std::filesystem::directory_iterator(cache_dir / CACHE_METADATA_DIR)) {
+        if (entry.is_regular_file()) {
+            paths.push_back(std::filesystem::path(CACHE_METADATA_DIR) / entry.path().filename());
+        }
+    }
+    bool has_main_solv = false;
+    auto main_solv_name = config.get_id() + ".solv";
+    std::error_code ec;
+    for (const auto & entry : std::filesystem::directory_iterator(cache_dir / CACHE_SOLV_FILES_DIR, ec)) {
+        if (!entry.is_regular_file() || !SolvRepo::is_solv_cache_of(entry.path(), repomd_checksum)) {
+            logger.debug("Skipping stale solv cache file \"{}\" in bundle", entry.path().native());
+            continue;
+        }
+        has_main_solv |= entry.path().filename() == main_solv_name;
+        paths.push_back(std::filesystem::path(CACHE_SOLV_FILES_DIR) / entry.path().filename());
+    }
+    if (!has_main_solv) {
+        throw RepoError(
+            M_("Repository \"{}\" has no solv cache for its metadata to export, load the repository first"),
+            config.get_id());
+    }
+
+    toml::array files;
+    for (const auto & path : paths) {
+        auto target = bundle_dir / path;
+        std::filesystem::create_directories(target.parent_path());
+        std::filesystem::copy_file(cache_dir / path, target, std::filesystem::copy_options::overwrite_existing);
+        files.push_back(toml::value{
+            {"path", path.string()},
+            {"size", static_cast<std::int64_t>(std::filesystem::file_size(target))},
+            {"sha256", file_sha256(target)}});
+    }
+    toml::value manifest{
+        {"version", CACHE_BUNDLE_VERSION},
+        {"repo_id", config.get_id()},
+        {"repomd_checksum", repomd_checksum_str},
+        {"solv_toolversion", solv_toolversion},
+        {"files", files}};
+    utils::fs::File(bundle_dir / CACHE_BUNDLE_MANIFEST, "w").write(toml::format(manifest));
+    // An outdated signature would fail the import, the bundle is signed again after the export
+    std::filesystem::remove(bundle_dir / CACHE_BUNDLE_SIGNATURE);
+}
+
+
+void import_solv_cache_bundle(
+    libdnf5::Logger & logger, const ConfigRepo & config, const std::filesystem::path & bundle_dir) {
+    check_signature(logger, config, bundle_dir);
+
+    std::string repomd_checksum_str;
+    std::vector<BundleFile> files;
+    try {
+        auto manifest = toml::parse(bundle_dir / CACHE_BUNDLE_MANIFEST);
+        auto version = toml::find<std::string>(manifest, "version");
+        if (version != CACHE_BUNDLE_VERSION) {
+            throw RepoError(M_("Unsupported version of solv cache bundle: {}"), version);
+        }
+        auto repo_id = toml::find<std::string>(manifest, "repo_id");
+        if (repo_id != config.get_id()) {
+            throw RepoError(M_("Solv cache bundle is for repository \"{}\", not \"{}\""), repo_id, config.get_id());
+        }
+        auto toolversion = toml::find<std::string>(manifest, "solv_toolversion");
+        if (toolversion != solv_toolversion) {
+            throw RepoError(
+                M_("Solv cache bundle was written by libsolv tool version \"{}\", \"{}\" is used"),
+                toolversion,
+                std::string(solv_toolversion));
+        }
+        repomd_checksum_str = toml::find<std::string>(manifest, "repomd_checksum");
+        for (const auto & file : toml::find<toml::array>(manifest, "files")) {
+            files.push_back(
+                {toml::find<std::string>(file, "path"),
+                 static_cast<std::uint64_t>(toml::find<std::int64_t>(file, "size")),
+                 toml::find<std::string>(file, "sha256")});
+        }
+    } catch (const toml::exception & ex) {
+        throw RepoError(M_("Invalid manifest of solv cache bundle: {}"), std::string(ex.what()));
+    } catch (const std::out_of_range & ex) {
+        throw RepoError(M_("Invalid manifest of solv cache bundle: {}"), std::string(ex.what()));
+    }
+
+    // The files are validated in a temporary directory in the cache, the replacement is then a rename
+    std::filesystem::path cache_dir = config.get_cachedir();
+    std::filesystem::create_directories(cache_dir);
+    utils::fs::TempDir staging_dir(cache_dir, "bundle");
+    for (const auto & file : files) {
+        if (!is_valid_bundle_path(file.path)) {
+            throw RepoError(M_("Invalid path \"{}\" in solv cache bundle"), file.path);
+        }
+        auto target = staging_dir.get_path() / file.path;
+        std::filesystem::create_directories(target.parent_path());
+        std::filesystem::copy_file(bundle_dir / file.path, target);
+        if (std::filesystem::file_size(target) != file.size || file_sha256(target) != file.sha256) {
+            throw RepoError(M_("File \"{}\" in solv cache bundle is damaged"), file.path);
+        }
+    }
+
+    // The solv cache files must have been written for the bundled repomd.xml by the used libsolv
+    auto repomd_path = staging_dir.get_path() / CACHE_METADATA_DIR / "repomd.xml";
+    if (!std::filesystem::exists(repomd_path)) {
+        throw RepoError(M_("Solv cache bundle for repository \"{}\" has no repomd.xml"), config.get_id());
+    }
+    unsigned char repomd_checksum[CHKSUM_BYTES];
+    if (repomd_checksum_hex(repomd_path, repomd_checksum) != repomd_checksum_str) {
+        throw RepoError(M_("Solv cache bundle for repository \"{}\" has a damaged repomd.xml"), config.get_id());
+    }
+    auto main_solv_path = staging_dir.get_path() / CACHE_SOLV_FILES_DIR / (config.get_id() + ".solv");
+    if (!std::filesystem::exists(main_solv_path)) {
+        throw RepoError(M_("Solv cache bundle for repository \"{}\" has no main solv file"), config.get_id());
+    }
+    for (const auto & entry : std::filesystem::directory_iterator(staging_dir.get_path() / CACHE_SOLV_FILES_DIR)) {
+        if (!SolvRepo::is_solv_cache_of(entry.path(), repomd_checksum)) {
+            throw RepoError(
+                M_("Solv cache file \"{}\" in bundle was not written for the bundled metadata"),
+                entry.path().filename().string());
+        }
+    }
+
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(config.get_cachedir()), false);
+    cache_locker.write_lock(true);
+    for (const auto * dir : {CACHE_METADATA_DIR, CACHE_SOLV_FILES_DIR}) {
+        replace_cache_item(staging_dir.get_path() / dir, cache_dir / dir);
+    }
+    logger.debug("Imported solv cache bundle of {} files for repository \"{}\"", files.size(), config.get_id());
+}
+
+}  // namespace libdnf5::repo
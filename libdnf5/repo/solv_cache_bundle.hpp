@@ -0,0 +1,51 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_REPO_SOLV_CACHE_BUNDLE_HPP
+#define LIBDNF5_REPO_SOLV_CACHE_BUNDLE_HPP
+
+#include "libdnf5/logger/logger.hpp"
+#include "libdnf5/repo/config_repo.hpp"
+
+#include <filesystem>
+
+
+namespace libdnf5::repo {
+
+/// Name of the manifest of a solv cache bundle
+constexpr const char * CACHE_BUNDLE_MANIFEST = "bundle.toml";
+/// Name of the optional detached armored signature of the manifest
+constexpr const char * CACHE_BUNDLE_SIGNATURE = "bundle.toml.asc";
+
+/// Copies the metadata files and the solv cache files written for them from the cache directory of the repository
+/// with the `config` into `bundle_dir` and writes the manifest listing the files with their sizes and sha256
+/// checksums, the checksum of the repomd.xml file and the libsolv tool version. The stale solv cache files are
+/// skipped. The files are read under the shared lock of the cache.
+void export_solv_cache_bundle(
+    libdnf5::Logger & logger, const ConfigRepo & config, const std::filesystem::path & bundle_dir);
+
+/// Validates the bundle in `bundle_dir` and replaces the metadata and the solv cache files in the cache directory of
+/// the repository with the `config` by its files. The signature of the manifest is verified by the keys in
+/// the repository keyring when it is present, it is required when `repo_gpgcheck` is enabled.
+void import_solv_cache_bundle(
+    libdnf5::Logger & logger, const ConfigRepo & config, const std::filesystem::path & bundle_dir);
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_SOLV_CACHE_BUNDLE_HPP
@@ -0,0 +1,95 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solv_cache_writer.hpp"
+
+
+namespace libdnf5::repo {
+
+SolvCacheWriter::~SolvCacheWriter() {
+    finish();
+}
+
+
+void SolvCacheWriter::add_job(const void * owner, std::function<void()> && job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back({owner, std::move(job)});
+    if (!thread.joinable()) {
+        stopping = false;
+        thread = std::thread(&SolvCacheWriter::run, this);
+    }
+    jobs_cond.notify_one();
+}
+
+
+void SolvCacheWriter::cancel_jobs(const void * owner) {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::erase_if(jobs, [owner](const Job & job) { return job.owner == owner; });
+    job_done_cond.wait(lock, [this, owner] { return running_owner != owner; });
+}
+
+
+void SolvCacheWriter::finish() {
+    stop(false);
+}
+
+
+void SolvCacheWriter::abandon() {
+    stop(true);
+}
+
+
+void SolvCacheWriter::stop(bool drop_jobs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (drop_jobs) {
+            jobs.clear();
+        }
+        stopping = true;
+    }
+    jobs_cond.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+
+void SolvCacheWriter::run() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobs_cond.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front().func);
+            running_owner = jobs.front().owner;
+            jobs.pop_front();
+        }
+        job();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running_owner = nullptr;
+        }
+        job_done_cond.notify_all();
+    }
+}
+
+}  // namespace libdnf5::repo
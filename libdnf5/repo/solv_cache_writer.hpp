@@ -0,0 +1,79 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_REPO_SOLV_CACHE_WRITER_HPP
+#define LIBDNF5_REPO_SOLV_CACHE_WRITER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace libdnf5::repo {
+
+/// Runs jobs writing libsolv cache files in a background thread, one after another, so that they are not on
+/// the critical path of loading repositories. The thread is started with the first added job.
+///
+/// The jobs have to write the cache files atomically (to a temporary file renamed at the end) and must not
+/// throw, so that an abandoned or failed job never leaves a broken cache file behind.
+class SolvCacheWriter {
+public:
+    SolvCacheWriter() = default;
+    SolvCacheWriter(const SolvCacheWriter &) = delete;
+    SolvCacheWriter & operator=(const SolvCacheWriter &) = delete;
+
+    /// Calls `finish()`.
+    ~SolvCacheWriter();
+
+    /// Queues the `job` of the `owner` to be run in the background thread.
+    void add_job(const void * owner, std::function<void()> && job);
+
+    /// Drops the queued jobs of the `owner` and waits for its running job. The other jobs continue.
+    void cancel_jobs(const void * owner);
+
+    /// Waits until all the queued jobs are done and stops the background thread.
+    void finish();
+
+    /// Drops the queued jobs that have not been started yet, waits for the running job and stops
+    /// the background thread.
+    void abandon();
+
+private:
+    void run();
+    void stop(bool drop_jobs);
+
+    struct Job {
+        const void * owner;
+        std::function<void()> func;
+    };
+
+    std::mutex mutex;
+    std::condition_variable jobs_cond;
+    std::condition_variable job_done_cond;
+    std::deque<Job> jobs;
+    const void * running_owner{nullptr};
+    bool stopping{false};
+    std::thread thread;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_SOLV_CACHE_WRITER_HPP
@@ -21,13 +21,34 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "base/base_impl.hpp"
 #include "repo_cache_private.hpp"
+#include "rpm/transaction.hpp"
 #include "solv/pool.hpp"
 #include "utils/fs/temp.hpp"
+#include "utils/locker.hpp"
 
 #include "libdnf5/base/base.hpp"
+#include "libdnf5/repo/repo.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 #include "libdnf5/utils/to_underlying.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 extern "C" {
 #include <solv/chksum.h>
 #include <solv/repo_comps.h>
@@ -50,6 +71,101 @@ namespace fs = libdnf5::utils::fs;
 constexpr auto CHKSUM_TYPE = REPOKEY_TYPE_SHA256;
 constexpr const char * CHKSUM_IDENT = "H000";
 
+// Size of the stdio buffer used for reading solv cache files when "solv_cache_prefetch" is enabled.
+constexpr std::size_t SOLV_CACHE_READ_BUFFER_SIZE = 1024 * 1024;
+
+// Types of the .solvx caches the packages are split into when "load_package_details_on_demand" is enabled
+constexpr const char * PACKAGE_CORE_CACHE_TYPE = "core";
+constexpr const char * PACKAGE_DETAILS_CACHE_TYPE = "details";
+
+// First word of the header of the added file provides cache, the number is the version of the format
+constexpr const char * FILEPROVIDES_CACHE_MAGIC = "dnf-fileprovides 2";
+
+// Keys of the package details stored in the details cache, with their types. They are not needed for resolving
+// the dependencies or for listing the packages.
+constexpr std::array<std::pair<Id, Id>, 6> PACKAGE_DETAILS_KEYS{{
+    {SOLVABLE_DESCRIPTION, REPOKEY_TYPE_STR},
+    {SOLVABLE_URL, REPOKEY_TYPE_STR},
+    {SOLVABLE_LICENSE, REPOKEY_TYPE_ID},
+    {SOLVABLE_PACKAGER, REPOKEY_TYPE_ID},
+    {SOLVABLE_GROUP, REPOKEY_TYPE_ID},
+    {SOLVABLE_BUILDHOST, REPOKEY_TYPE_ID},
+}};
+
+
+// Escapes the backslash and the characters separating the fields and the lines of the added file provides cache
+static std::string escape_fileprovides_path(const char * path) {
+    std::string escaped;
+    for (; *path; ++path) {
+        switch (*path) {
+            case '\\':
+                escaped.append("\\\\");
+                break;
+            case '\t':
+                escaped.append("\\t");
+                break;
+            case '\n':
+                escaped.append("\\n");
+                break;
+            case '\r':
+                escaped.append("\\r");
+                break;
+            default:
+                escaped.push_back(*path);
+        }
+    }
+    return escaped;
+}
+
+
+// Reverts escape_fileprovides_path(), returns std::nullopt for an invalid escape sequence
+static std::optional<std::string> unescape_fileprovides_path(std::string_view escaped) {
+    std::string path;
+    for (std::size_t i = 0; i < escaped.size(); ++i) {
+        if (escaped[i] != '\\') {
+            path.push_back(escaped[i]);
+            continue;
+        }
+        if (++i == escaped.size()) {
+            return std::nullopt;
+        }
+        switch (escaped[i]) {
+            case '\\':
+                path.push_back('\\');
+                break;
+            case 't':
+                path.push_back('\t');
+                break;
+            case 'n':
+                path.push_back('\n');
+                break;
+            case 'r':
+                path.push_back('\r');
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+    return path;
+}
+
+
+static bool is_package_details_key(Id keyname) {
+    return std::any_of(PACKAGE_DETAILS_KEYS.begin(), PACKAGE_DETAILS_KEYS.end(), [keyname](const auto & key) {
+        return key.first == keyname;
+    });
+}
+
+
+// Repowriter key filters of the core and the details caches
+static int package_core_keyfilter(::Repo * repo, Repokey * key, void * kfdata) {
+    return is_package_details_key(key->name) ? KEY_STORAGE_DROPPED : repo_write_stdkeyfilter(repo, key, kfdata);
+}
+
+static int package_details_keyfilter(::Repo * repo, Repokey * key, void * kfdata) {
+    return is_package_details_key(key->name) ? repo_write_stdkeyfilter(repo, key, kfdata) : KEY_STORAGE_DROPPED;
+}
+
 
 static std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> get_padded_solv_toolversion() {
     std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> padded_solv_toolversion{};
@@ -60,6 +176,11 @@ static std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> get_padded_solv_too
 }
 
 void SolvRepo::userdata_fill(SolvUserdata * userdata) {
+    userdata_fill(userdata, checksum, repomd_fingerprint);
+}
+
+void SolvRepo::userdata_fill(
+    SolvUserdata * userdata, const unsigned char * repomd_checksum, const RepomdFingerprint & fingerprint) {
     if (strlen(solv_toolversion) > SOLV_USERDATA_SOLV_TOOLVERSION_SIZE) {
         libdnf_throw_assertion(
             "Libsolv's solv_toolvesion is: {} long but we expect max of: {}",
@@ -70,12 +191,18 @@ void SolvRepo::userdata_fill(SolvUserdata * userdata) {
     memcpy(userdata->dnf_magic, SOLV_USERDATA_MAGIC.data(), SOLV_USERDATA_MAGIC.size());
     memcpy(userdata->dnf_version, SOLV_USERDATA_DNF_VERSION.data(), SOLV_USERDATA_DNF_VERSION.size());
     memcpy(userdata->libsolv_version, get_padded_solv_toolversion().data(), SOLV_USERDATA_SOLV_TOOLVERSION_SIZE);
-    memcpy(userdata->checksum, checksum, CHKSUM_BYTES);
+    memcpy(userdata->checksum, repomd_checksum, CHKSUM_BYTES);
+    userdata->repomd_inode = fingerprint.inode;
+    userdata->repomd_size = fingerprint.size;
+    userdata->repomd_mtime_ns = fingerprint.mtime_ns;
 }
 
 bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cache) {
-    auto & logger = *base->get_logger();
+    return can_use_solvfile_cache(*base->get_logger(), pool, solvfile_cache, checksum);
+}
 
+bool SolvRepo::can_use_solvfile_cache(
+    libdnf5::Logger & logger, solv::Pool & pool, fs::File & solvfile_cache, const unsigned char * repomd_checksum) {
     if (!solvfile_cache) {
         logger.debug(("Missing solvfile cache: \"{}\""), solvfile_cache.get_path().native());
         return false;
@@ -136,11 +263,11 @@ bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cac
     }
 
     // check solvfile checksum
-    if (memcmp(solv_userdata->checksum, checksum, CHKSUM_BYTES) != 0) {
+    if (memcmp(solv_userdata->checksum, repomd_checksum, CHKSUM_BYTES) != 0) {
         logger.debug(
             "Solvfile's repomd checksum doesn't match, read: \"{}\" vs. expected repomd checksum: \"{}\" for: {}",
             pool_bin2hex(*pool, solv_userdata->checksum, sizeof solv_userdata->checksum),
-            pool_bin2hex(*pool, checksum, sizeof checksum),
+            pool_bin2hex(*pool, repomd_checksum, CHKSUM_BYTES),
             solvfile_cache.get_path().native());
         return false;
     }
@@ -168,6 +295,89 @@ void checksum_calc(unsigned char * out, fs::File & file) {
 }
 
 
+RepomdFingerprint SolvRepo::get_repomd_fingerprint(const std::string & repomd_fn) {
+    struct stat st;
+    if (stat(repomd_fn.c_str(), &st) != 0) {
+        return {};
+    }
+    return {
+        static_cast<std::uint64_t>(st.st_ino),
+        static_cast<std::uint64_t>(st.st_size),
+        static_cast<std::uint64_t>(st.st_mtim.tv_sec) * 1000000000 + static_cast<std::uint64_t>(st.st_mtim.tv_nsec)};
+}
+
+
+void SolvRepo::repomd_checksum_calc(
+    libdnf5::Logger & logger,
+    const std::filesystem::path & main_cache_path,
+    const std::string & repomd_fn,
+    const RepomdFingerprint & fingerprint,
+    unsigned char * out) {
+    if (fingerprint.is_valid()) {
+        const auto & path = main_cache_path;
+        try {
+            fs::File cache_file(path, "r");
+
+            unsigned char * userdata_read;
+            int userdata_len_read;
+            if (solv_read_userdata(cache_file.get(), &userdata_read, &userdata_len_read) == 0) {
+                std::unique_ptr<SolvUserdata, decltype(&solv_free)> solv_userdata(
+                    reinterpret_cast<SolvUserdata *>(userdata_read), &solv_free);
+                if (userdata_len_read == SOLV_USERDATA_SIZE &&
+                    memcmp(solv_userdata->dnf_magic, SOLV_USERDATA_MAGIC.data(), SOLV_USERDATA_MAGIC.size()) == 0 &&
+                    memcmp(
+                        solv_userdata->dnf_version,
+                        SOLV_USERDATA_DNF_VERSION.data(),
+                        SOLV_USERDATA_DNF_VERSION.size()) == 0 &&
+                    fingerprint == RepomdFingerprint{
+                                       solv_userdata->repomd_inode,
+                                       solv_userdata->repomd_size,
+                                       solv_userdata->repomd_mtime_ns}) {
+                    logger.trace(
+                        "Repomd fingerprint matches solv cache file \"{}\", skipping repomd checksum computation",
+                        path.native());
+                    memcpy(out, solv_userdata->checksum, CHKSUM_BYTES);
+                    return;
+                }
+            }
+        } catch (const std::filesystem::filesystem_error & e) {
+            // No usable cache file, the checksum is computed below.
+        }
+    }
+
+    fs::File repomd_file(repomd_fn, "r");
+    checksum_calc(out, repomd_file);
+}
+
+
+void SolvRepo::repomd_checksum_calc(const std::string & repomd_fn, unsigned char * out) {
+    fs::File repomd_file(repomd_fn, "r");
+    checksum_calc(out, repomd_file);
+}
+
+
+bool SolvRepo::is_solv_cache_of(const std::filesystem::path & path, const unsigned char * repomd_checksum) {
+    fs::File cache_file(path, "r");
+    unsigned char * userdata_read;
+    int userdata_len_read;
+    if (solv_read_userdata(cache_file.get(), &userdata_read, &userdata_len_read) != 0) {
+        return false;
+    }
+    std::unique_ptr<SolvUserdata, decltype(&solv_free)> solv_userdata(
+        reinterpret_cast<SolvUserdata *>(userdata_read), &solv_free);
+    if (userdata_len_read != SOLV_USERDATA_SIZE ||
+        memcmp(solv_userdata->dnf_magic, SOLV_USERDATA_MAGIC.data(), SOLV_USERDATA_MAGIC.size()) != 0 ||
+        memcmp(solv_userdata->dnf_version, SOLV_USERDATA_DNF_VERSION.data(), SOLV_USERDATA_DNF_VERSION.size()) != 0) {
+        return false;
+    }
+    return memcmp(
+               solv_userdata->libsolv_version,
+               get_padded_solv_toolversion().data(),
+               SOLV_USERDATA_SOLV_TOOLVERSION_SIZE) == 0 &&
+           memcmp(solv_userdata->checksum, repomd_checksum, CHKSUM_BYTES) == 0;
+}
+
+
 static const char * repodata_type_to_name(RepodataType type) {
     switch (type) {
         case RepodataType::FILELISTS:
@@ -229,28 +439,44 @@ SolvRepo::SolvRepo(const libdnf5::BaseWeakPtr & base, const ConfigRepo & config,
 
 
 SolvRepo::~SolvRepo() {
+    base->p_impl->get_solv_cache_writer().cancel_jobs(this);
     repo->appdata = nullptr;
     comps_repo->appdata = nullptr;
 }
 
 
 void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string & primary_fn) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "load repo main", config.get_id());
     auto & logger = *base->get_logger();
     auto & pool = get_rpm_pool(base);
 
-    fs::File repomd_file(repomd_fn, "r");
-
-    checksum_calc(checksum, repomd_file);
+    repomd_fingerprint = get_repomd_fingerprint(repomd_fn);
+    repomd_checksum_calc(logger, solv_file_path(config, nullptr), repomd_fn, repomd_fingerprint, checksum);
 
+    const bool details_on_demand = base->get_config().get_load_package_details_on_demand_option().get_value();
     int solvables_start = pool->nsolvables;
 
+    if (details_on_demand && load_package_core_cache(pool)) {
+        main_solvables_start = solvables_start;
+        main_solvables_end = pool->nsolvables;
+        load_fileprovides_cache();
+
+        return;
+    }
+
     if (load_solv_cache(pool, nullptr, 0)) {
         main_solvables_start = solvables_start;
         main_solvables_end = pool->nsolvables;
+        load_fileprovides_cache();
+
+        if (details_on_demand) {
+            write_package_core_caches();
+        }
 
         return;
     }
 
+    fs::File repomd_file(repomd_fn, "r");
     fs::File primary_file(primary_fn, "r", true);
 
     logger.debug("Loading repomd and primary for repo \"{}\"", config.get_id());
@@ -272,10 +498,16 @@ void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string &
 
     main_solvables_start = solvables_start;
     main_solvables_end = pool->nsolvables;
+    load_fileprovides_cache();
 
-    if (config.get_build_cache_option().get_value()) {
+    if (config.get_build_cache_option().get_value() &&
+        !base->get_config().get_build_cache_in_background_option().get_value()) {
         write_main(true);
     }
+
+    if (details_on_demand) {
+        write_package_core_caches();
+    }
 }
 
 
@@ -285,9 +517,23 @@ void SolvRepo::load_system_repo_ext(RepodataType type) {
         case RepodataType::COMPS: {
             // get installed groups from system state and load respective xml files
             // to the libsolv pool
+            auto & logger = *base->get_logger();
+            auto & comps_pool = get_comps_pool(base);
             auto & system_state = base->p_impl->get_system_state();
             auto comps_dir = system_state.get_group_xml_dir();
-            for (auto & group_id : system_state.get_installed_groups()) {
+            auto group_ids = system_state.get_installed_groups();
+            auto environment_ids = system_state.get_installed_environments();
+
+            // The solvables parsed from the xml files are cached as long as the xml files do not change
+            const auto cache_path = system_state.get_system_comps_cache_path();
+            unsigned char comps_checksum[CHKSUM_BYTES];
+            const bool use_cache = system_comps_checksum_calc(comps_dir, group_ids, environment_ids, comps_checksum);
+            if (use_cache && load_system_comps_cache(cache_path, comps_checksum)) {
+                break;
+            }
+
+            int solvables_start = comps_pool->nsolvables;
+            for (auto & group_id : group_ids) {
                 auto ext_fn = comps_dir / (group_id + ".xml");
                 if (!read_group_solvable_from_xml(ext_fn)) {
                     // The group xml file either not exists or is not parseable by
@@ -295,7 +541,7 @@ void SolvRepo::load_system_repo_ext(RepodataType type) {
                     groups_missing_xml.push_back(std::move(group_id));
                 }
             }
-            for (auto & environment_id : system_state.get_installed_environments()) {
+            for (auto & environment_id : environment_ids) {
                 auto ext_fn = comps_dir / (environment_id + ".xml");
                 if (!read_group_solvable_from_xml(ext_fn)) {
                     // The environment xml file either not exists or is not parseable by
@@ -303,6 +549,17 @@ void SolvRepo::load_system_repo_ext(RepodataType type) {
                     environments_missing_xml.push_back(std::move(environment_id));
                 }
             }
+
+            // Solvables re-created by RepoSack::fix_group_missing_xml() are not cached, the next load reads
+            // the re-created xml files and writes the cache.
+            if (use_cache && groups_missing_xml.empty() && environments_missing_xml.empty()) {
+                try {
+                    write_system_comps_cache(cache_path, comps_checksum, solvables_start, comps_pool->nsolvables);
+                } catch (const std::exception & ex) {
+                    // e.g. a user without write access to the system state directory
+                    logger.debug("Cannot write system comps cache \"{}\": {}", cache_path.native(), ex.what());
+                }
+            }
             break;
         }
         case RepodataType::FILELISTS:
@@ -315,6 +572,7 @@ void SolvRepo::load_system_repo_ext(RepodataType type) {
 
 
 void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloader) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "load repo ext", config.get_id());
     auto & logger = *base->get_logger();
     solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base))
                                                     : static_cast<solv::Pool &>(get_rpm_pool(base));
@@ -337,6 +595,12 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
         return;
     }
 
+    if ((type == RepodataType::FILELISTS && base->get_config().get_load_filelists_on_demand_option().get_value()) ||
+        (type == RepodataType::OTHER && base->get_config().get_load_other_on_demand_option().get_value())) {
+        add_ext_stub(type, std::string(ext_fn));
+        return;
+    }
+
     int solvables_start = pool->nsolvables;
 
     if (load_solv_cache(pool, type_name, repodata_type_to_flags(type))) {
@@ -344,6 +608,9 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
             updateinfo_solvables_start = solvables_start;
             updateinfo_solvables_end = pool->nsolvables;
         }
+        if (type != RepodataType::COMPS) {
+            ext_repodata.emplace_back(repo->nrepodata - 1, type);
+        }
 
         return;
     }
@@ -382,11 +649,516 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
             pool_errstr(*get_rpm_pool(base)));
     }
 
-    if (config.get_build_cache_option().get_value()) {
+    if (type != RepodataType::COMPS) {
+        ext_repodata.emplace_back(repo->nrepodata - 1, type);
+    }
+
+    // The comps cache is not written by build_cache(), it is always written here.
+    if (config.get_build_cache_option().get_value() &&
+        (type == RepodataType::COMPS || !base->get_config().get_build_cache_in_background_option().get_value())) {
         if (type == RepodataType::COMPS) {
-            write_ext(comps_repo->nrepodata - 1, type);
+            write_ext(comps_repo->nrepodata - 1, type, true);
         } else {
-            write_ext(repo->nrepodata - 1, type);
+            write_ext(repo->nrepodata - 1, type, true);
+        }
+    }
+}
+
+
+void SolvRepo::add_ext_stub(RepodataType type, const std::string & ext_fn) {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+
+    const auto type_name = repodata_type_to_name(type);
+    logger.debug("Registering on demand loaded {} for repo \"{}\"", type_name, config.get_id());
+
+    // The same description of the external repodata as libsolv uses for repomd extensions. The stub created from it
+    // provides the listed keys. For filelists, the filtered filelist from primary is used until the stub is loaded.
+    Repodata * meta_data = repo_add_repodata(repo, 0);
+    Id handle = repodata_new_handle(meta_data);
+    repodata_set_poolstr(meta_data, handle, REPOSITORY_REPOMD_TYPE, type_name);
+    if (type == RepodataType::FILELISTS) {
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, SOLVABLE_FILELIST);
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, REPOKEY_TYPE_DIRSTRARRAY);
+    } else {
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, SOLVABLE_CHANGELOG);
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, REPOKEY_TYPE_FLEXARRAY);
+    }
+    repodata_add_flexarray(meta_data, SOLVID_META, REPOSITORY_EXTERNAL, handle);
+    repodata_internalize(meta_data);
+    repodata_create_stubs(meta_data);
+
+    auto & stub = type == RepodataType::FILELISTS ? filelists_stub : other_stub;
+    stub.repodata_id = repo->nrepodata - 1;
+    stub.fn = ext_fn;
+
+    pool_setloadcallback(*pool, &SolvRepo::load_stub_callback, nullptr);
+}
+
+
+RepoMemoryUsage SolvRepo::get_memory_usage() const {
+    RepoMemoryUsage usage;
+    usage.repo_id = config.get_id();
+
+    auto get_repodata_bytes = [this, &usage](Id repodata_id) -> std::size_t & {
+        auto type = RepodataType::FILELISTS;
+        if (repodata_id == filelists_stub.repodata_id) {
+            type = RepodataType::FILELISTS;
+        } else if (repodata_id == other_stub.repodata_id) {
+            type = RepodataType::OTHER;
+        } else {
+            auto it = std::find_if(ext_repodata.begin(), ext_repodata.end(), [repodata_id](const auto & item) {
+                return item.first == repodata_id;
+            });
+            if (it == ext_repodata.end()) {
+                return usage.primary_bytes;
+            }
+            type = it->second;
+        }
+        switch (type) {
+            case RepodataType::FILELISTS:
+                return usage.filelists_bytes;
+            case RepodataType::OTHER:
+                return usage.other_bytes;
+            case RepodataType::PRESTO:
+                return usage.presto_bytes;
+            case RepodataType::UPDATEINFO:
+                return usage.updateinfo_bytes;
+            case RepodataType::COMPS:
+                return usage.comps_bytes;
+        }
+        return usage.primary_bytes;
+    };
+
+    usage.solvables = static_cast<std::size_t>(repo->nsolvables);
+    usage.solvables_bytes = usage.solvables * sizeof(Solvable);
+    if (repo->rpmdbid) {
+        usage.solvables_bytes += static_cast<std::size_t>(repo->end - repo->start) * sizeof(Id);
+    }
+    usage.idarray_bytes = static_cast<std::size_t>(repo->idarraysize) * sizeof(Id);
+    Id repodata_id;
+    Repodata * data;
+    FOR_REPODATAS(repo, repodata_id, data) {
+        get_repodata_bytes(repodata_id) += repodata_memused(data);
+    }
+
+    usage.solvables += static_cast<std::size_t>(comps_repo->nsolvables);
+    usage.comps_bytes += static_cast<std::size_t>(comps_repo->nsolvables) * sizeof(Solvable) +
+                         static_cast<std::size_t>(comps_repo->idarraysize) * sizeof(Id);
+    FOR_REPODATAS(comps_repo, repodata_id, data) {
+        usage.comps_bytes += repodata_memused(data);
+    }
+    return usage;
+}
+
+
+Id SolvRepo::get_first_stub_meta_id() const noexcept {
+    // Each stub is preceded by its description
+    Id first_stub_id = 0;
+    for (Id stub_id : {filelists_stub.repodata_id, other_stub.repodata_id, details_stub.repodata_id}) {
+        if (stub_id != 0 && (first_stub_id == 0 || stub_id < first_stub_id)) {
+            first_stub_id = stub_id;
+        }
+    }
+    return first_stub_id == 0 ? 0 : first_stub_id - 1;
+}
+
+
+int SolvRepo::load_stub_callback(::Pool * /*pool*/, Repodata * data, void * /*cbdata*/) {
+    auto * libdnf_repo = static_cast<libdnf5::repo::Repo *>(data->repo->appdata);
+    if (!libdnf_repo || !libdnf_repo->solv_repo) {
+        return 0;
+    }
+    return libdnf_repo->solv_repo->load_ext_stub(data) ? 1 : 0;
+}
+
+
+bool SolvRepo::load_ext_stub(Repodata * data) noexcept {
+    if (details_stub.repodata_id != 0 && data->repodataid == details_stub.repodata_id) {
+        auto & logger = *base->get_logger();
+        ++details_stub.loads;
+        try {
+            const int flags = REPO_EXTEND_SOLVABLES | REPO_LOCALPOOL | REPO_USE_LOADING;
+            if (load_solv_cache(get_rpm_pool(base), PACKAGE_DETAILS_CACHE_TYPE, flags)) {
+                logger.debug("Loaded on demand package details for repo \"{}\" from solv cache", config.get_id());
+                return true;
+            }
+            logger.warning(
+                "Failed to load on demand package details for repo \"{}\": the cache \"{}\" is not usable",
+                config.get_id(),
+                details_stub.fn);
+        } catch (const std::exception & ex) {
+            logger.warning("Failed to load on demand package details for repo \"{}\": {}", config.get_id(), ex.what());
+        }
+        return false;
+    }
+
+    RepodataType type;
+    if (filelists_stub.repodata_id != 0 && data->repodataid == filelists_stub.repodata_id) {
+        type = RepodataType::FILELISTS;
+    } else if (other_stub.repodata_id != 0 && data->repodataid == other_stub.repodata_id) {
+        type = RepodataType::OTHER;
+    } else {
+        return false;
+    }
+    auto & stub = type == RepodataType::FILELISTS ? filelists_stub : other_stub;
+
+    auto & logger = *base->get_logger();
+    const auto type_name = repodata_type_to_name(type);
+    // REPO_USE_LOADING makes libsolv fill the stub repodata being loaded instead of creating a new one
+    const int flags = repodata_type_to_flags(type) | REPO_USE_LOADING;
+
+    ++stub.loads;
+
+    try {
+        auto & pool = get_rpm_pool(base);
+        if (load_solv_cache(pool, type_name, flags)) {
+            logger.debug("Loaded on demand {} for repo \"{}\" from solv cache", type_name, config.get_id());
+            return true;
+        }
+
+        fs::File ext_file(stub.fn, "r", true);
+        logger.debug("Loading on demand {} for repo \"{}\" from \"{}\"", type_name, config.get_id(), stub.fn);
+        const char * language = type == RepodataType::FILELISTS ? "FL" : nullptr;
+        if (repo_add_rpmmd(repo, ext_file.get(), language, flags) != 0) {
+            logger.warning(
+                "Failed to load on demand {} for repo \"{}\" from \"{}\": {}",
+                type_name,
+                config.get_id(),
+                stub.fn,
+                pool_errstr(*pool));
+            return false;
+        }
+
+        if (config.get_build_cache_option().get_value() &&
+            !base->get_config().get_build_cache_in_background_option().get_value()) {
+            // The loaded data cannot be replaced while libsolv is loading the stub
+            write_ext(stub.repodata_id, type, false);
+        }
+    } catch (const std::exception & ex) {
+        logger.warning("Failed to load on demand {} for repo \"{}\": {}", type_name, config.get_id(), ex.what());
+        return false;
+    }
+
+    return true;
+}
+
+
+SolvCacheSource::SolvCacheSource(
+    const ConfigRepo & config,
+    const std::string & repomd_fn,
+    const RepoDownloader & downloader,
+    std::vector<RepodataType> types)
+    : repoid(config.get_id()),
+      cachedir(config.get_cachedir()),
+      repomd_fn(repomd_fn),
+      types(std::move(types)) {
+    metadata_paths.emplace(
+        RepoDownloader::MD_FILENAME_PRIMARY, downloader.get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY));
+    for (auto type : this->types) {
+        auto type_name = repodata_type_to_name(type);
+        metadata_paths.emplace(type_name, downloader.get_metadata_path(type_name));
+    }
+}
+
+
+const std::string & SolvCacheSource::get_metadata_path(const std::string & type) const {
+    static const std::string empty;
+    auto it = metadata_paths.find(type);
+    return it != metadata_paths.end() ? it->second : empty;
+}
+
+
+void SolvRepo::build_cache_in_background(
+    const std::string & repomd_fn, const RepoDownloader & downloader, std::vector<RepodataType> types) {
+    auto & solv_cache_writer = base->p_impl->get_solv_cache_writer();
+    // a job queued by the previous load of the repo would write the cache of the replaced metadata
+    solv_cache_writer.cancel_jobs(this);
+    solv_cache_writer.add_job(
+        this, [base = base, source = SolvCacheSource(config, repomd_fn, downloader, std::move(types))]() {
+            try {
+                build_cache(base, source);
+            } catch (const std::exception & ex) {
+                base->get_logger()->warning(
+                    "Failed to write libsolv cache files of repo \"{}\" in background: {}", source.repoid, ex.what());
+            }
+        });
+}
+
+
+// Writes the data selected by `writer` to the solv cache file `solvfile_path`.
+// The data are written to a temporary file in the same directory first and then the file is renamed.
+// Returns `false` if libsolv failed to write the data.
+static bool write_solv_file(Repowriter * writer, const std::filesystem::path & solvfile_path) {
+    const auto solvfile_parent_dir = solvfile_path.parent_path();
+
+    std::filesystem::create_directory(solvfile_parent_dir);
+
+    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
+    auto & cache_file = cache_tmp_file.open_as_file("w+");
+
+    if (repowriter_write(writer, cache_file.get()) != 0) {
+        return false;
+    }
+
+    cache_tmp_file.close();
+
+    std::filesystem::rename(cache_tmp_file.get_path(), solvfile_path);
+    cache_tmp_file.release();
+    return true;
+}
+
+
+bool SolvRepo::load_package_core_cache(solv::Pool & pool) {
+    // The details are loaded on demand, only the validity of their cache is checked now
+    try {
+        fs::File details_file(solv_file_path(PACKAGE_DETAILS_CACHE_TYPE), "r");
+        if (!can_use_solvfile_cache(pool, details_file)) {
+            return false;
+        }
+    } catch (const std::filesystem::filesystem_error & e) {
+        return false;
+    }
+
+    if (!load_solv_cache(pool, PACKAGE_CORE_CACHE_TYPE, 0)) {
+        return false;
+    }
+
+    add_package_details_stub();
+    return true;
+}
+
+
+void SolvRepo::write_package_core_caches() {
+    auto & logger = *base->get_logger();
+    if (!config.get_build_cache_option().get_value()) {
+        logger.debug(
+            "Package details of repo \"{}\" cannot be loaded on demand, building of the cache is disabled",
+            config.get_id());
+        return;
+    }
+
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "write solv cache", config.get_id());
+
+    SolvUserdata solv_userdata{};
+    userdata_fill(&solv_userdata);
+
+    try {
+        // The core cache is used only together with the details cache, the details are written first
+        for (const char * type : {PACKAGE_DETAILS_CACHE_TYPE, PACKAGE_CORE_CACHE_TYPE}) {
+            const bool details = type == PACKAGE_DETAILS_CACHE_TYPE;
+            std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(repowriter_create(repo), &repowriter_free);
+            repowriter_set_userdata(writer.get(), &solv_userdata, SOLV_USERDATA_SIZE);
+            repowriter_set_solvablerange(writer.get(), main_solvables_start, main_solvables_end);
+            repowriter_set_keyfilter(
+                writer.get(), details ? &package_details_keyfilter : &package_core_keyfilter, nullptr);
+            if (details) {
+                repowriter_set_flags(writer.get(), REPOWRITER_NO_STORAGE_SOLVABLE);
+            }
+
+            const auto solvfile_path = solv_file_path(type);
+            logger.trace(
+                "Writing package {} cache for repo \"{}\" to \"{}\"", type, config.get_id(), solvfile_path.native());
+            if (!write_solv_file(writer.get(), solvfile_path)) {
+                logger.warning(
+                    "Failed to write package {} cache for repo \"{}\": {}",
+                    type,
+                    config.get_id(),
+                    pool_errstr(*get_rpm_pool(base)));
+                return;
+            }
+        }
+    } catch (const std::exception & ex) {
+        logger.warning("Failed to write package core caches for repo \"{}\": {}", config.get_id(), ex.what());
+    }
+}
+
+
+void SolvRepo::add_package_details_stub() {
+    auto & pool = get_rpm_pool(base);
+    base->get_logger()->debug("Registering on demand loaded package details for repo \"{}\"", config.get_id());
+
+    // The same description of the external repodata as in `add_ext_stub()`, listing the keys of the details
+    Repodata * meta_data = repo_add_repodata(repo, 0);
+    Id handle = repodata_new_handle(meta_data);
+    repodata_set_poolstr(meta_data, handle, REPOSITORY_REPOMD_TYPE, PACKAGE_DETAILS_CACHE_TYPE);
+    for (const auto & [keyname, keytype] : PACKAGE_DETAILS_KEYS) {
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, keyname);
+        repodata_add_idarray(meta_data, handle, REPOSITORY_KEYS, keytype);
+    }
+    repodata_add_flexarray(meta_data, SOLVID_META, REPOSITORY_EXTERNAL, handle);
+    repodata_internalize(meta_data);
+    repodata_create_stubs(meta_data);
+
+    details_stub.repodata_id = repo->nrepodata - 1;
+    details_stub.fn = solv_file_path(PACKAGE_DETAILS_CACHE_TYPE);
+
+    pool_setloadcallback(*pool, &SolvRepo::load_stub_callback, nullptr);
+}
+
+
+void SolvRepo::build_cache(
+    const libdnf5::BaseWeakPtr & base,
+    const ConfigRepo & config,
+    const std::string & repomd_fn,
+    const RepoDownloader & downloader,
+    const std::vector<RepodataType> & types) {
+    if (!config.get_build_cache_option().get_value()) {
+        return;
+    }
+    build_cache(base, SolvCacheSource(config, repomd_fn, downloader, types));
+}
+
+
+void SolvRepo::build_cache(const libdnf5::BaseWeakPtr & base, const SolvCacheSource & source) {
+    auto & logger = *base->get_logger();
+    const auto & repoid = source.repoid;
+    const auto & repomd_fn = source.repomd_fn;
+    auto cache_path = [&source](const char * type) {
+        return solv_file_path(source.cachedir, source.repoid, type);
+    };
+
+    // The metadata are parsed under a shared lock of the cache, see `Repo::load_available_repo()`
+    libdnf5::utils::Locker cache_locker(get_cache_lock_path(source.cachedir), false);
+    try {
+        cache_locker.read_lock(true);
+    } catch (const SystemError & e) {
+        logger.debug("Building cache of repo \"{}\" without the cache lock: {}", repoid, e.what());
+    }
+
+    unsigned char repomd_checksum[CHKSUM_BYTES];
+    const auto fingerprint = get_repomd_fingerprint(repomd_fn);
+    repomd_checksum_calc(logger, cache_path(nullptr), repomd_fn, fingerprint, repomd_checksum);
+
+    SolvUserdata solv_userdata{};
+    userdata_fill(&solv_userdata, repomd_checksum, fingerprint);
+
+    auto is_cache_valid = [&](solv::Pool & pool, const char * type, fs::File & cache_file) {
+        try {
+            cache_file = fs::File(cache_path(type), "r");
+            return can_use_solvfile_cache(logger, pool, cache_file, repomd_checksum);
+        } catch (const std::filesystem::filesystem_error & e) {
+            return false;
+        }
+    };
+
+    // The private staging pool, it is destroyed (with all the parsed data) at the end of the method.
+    solv::RpmPool pool;
+    ::Repo * staging_repo = repo_create(*pool, repoid.c_str());
+
+    // The main repodata are needed in the staging pool even if the .solv cache is valid,
+    // the extended repodata extend the main solvables.
+    fs::File main_cache_file;
+    if (is_cache_valid(pool, nullptr, main_cache_file)) {
+        if (repo_add_solv(staging_repo, main_cache_file.get(), 0) != 0) {
+            throw SolvError(
+                M_("Failed to load {} cache for repo \"{}\" from \"{}\": {}"),
+                "primary",
+                repoid,
+                main_cache_file.get_path().native(),
+                pool_errstr(*pool));
+        }
+    } else {
+        auto primary_fn = source.get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+        fs::File repomd_file(repomd_fn, "r");
+        fs::File primary_file(primary_fn, "r", true);
+
+        logger.debug("Staging repomd and primary for repo \"{}\"", repoid);
+        if (repo_add_repomdxml(staging_repo, repomd_file.get(), 0) != 0) {
+            throw SolvError(
+                M_("Failed to load repomd for repo \"{}\" from \"{}\": {}."),
+                repoid,
+                repomd_fn,
+                pool_errstr(*pool));
+        }
+
+        int main_start = pool->nsolvables;
+        if (repo_add_rpmmd(staging_repo, primary_file.get(), 0, 0) != 0) {
+            throw SolvError(
+                M_("Failed to load primary for repo \"{}\" from \"{}\": {}."),
+                repoid,
+                primary_fn,
+                pool_errstr(*pool));
+        }
+
+        Repowriter * writer = repowriter_create(staging_repo);
+        repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
+        repowriter_set_solvablerange(writer, main_start, pool->nsolvables);
+        bool written = write_solv_file(writer, cache_path(nullptr));
+        repowriter_free(writer);
+
+        if (!written) {
+            throw SolvError(
+                M_("Failed to write primary cache for repo \"{}\" to \"{}\": {}"),
+                repoid,
+                cache_path(nullptr).native(),
+                pool_errstr(*pool));
+        }
+    }
+
+    for (auto type : source.types) {
+        libdnf_assert(type != RepodataType::COMPS, "Comps repodata cannot be staged");
+
+        auto type_name = repodata_type_to_name(type);
+        const auto & ext_fn = source.get_metadata_path(type_name);
+        if (ext_fn.empty()) {
+            continue;
+        }
+
+        fs::File ext_cache_file;
+        if (is_cache_valid(pool, type_name, ext_cache_file)) {
+            continue;
+        }
+
+        fs::File ext_file(ext_fn, "r", true);
+        logger.debug("Staging {} extension for repo \"{}\" from \"{}\"", type_name, repoid, ext_fn);
+
+        int solvables_start = pool->nsolvables;
+        int res = 0;
+        switch (type) {
+            case RepodataType::FILELISTS:
+                res = repo_add_rpmmd(staging_repo, ext_file.get(), "FL", REPO_EXTEND_SOLVABLES);
+                break;
+            case RepodataType::PRESTO:
+                res = repo_add_deltainfoxml(staging_repo, ext_file.get(), 0);
+                break;
+            case RepodataType::UPDATEINFO:
+                res = repo_add_updateinfoxml(staging_repo, ext_file.get(), 0);
+                break;
+            case RepodataType::OTHER:
+                res = repo_add_rpmmd(staging_repo, ext_file.get(), 0, REPO_EXTEND_SOLVABLES);
+                break;
+            case RepodataType::COMPS:
+                break;
+        }
+
+        if (res != 0) {
+            throw SolvError(
+                M_("Failed to load {} extension for repo \"{}\" from \"{}\": {}"),
+                type_name,
+                repoid,
+                ext_fn,
+                pool_errstr(*pool));
+        }
+
+        Repowriter * writer = repowriter_create(staging_repo);
+        repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
+        repowriter_set_repodatarange(writer, staging_repo->nrepodata - 1, staging_repo->nrepodata);
+        if (type == RepodataType::UPDATEINFO) {
+            repowriter_set_solvablerange(writer, solvables_start, pool->nsolvables);
+        } else {
+            repowriter_set_flags(writer, REPOWRITER_NO_STORAGE_SOLVABLE);
+        }
+        bool written = write_solv_file(writer, cache_path(type_name));
+        repowriter_free(writer);
+
+        if (!written) {
+            throw SolvError(
+                M_("Failed to write {} cache for repo \"{}\" to \"{}\": {}"),
+                type_name,
+                repoid,
+                cache_path(type_name).native(),
+                pool_errstr(*pool));
         }
     }
 }
@@ -406,13 +1178,40 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
 
     int solvables_start = pool->nsolvables;
 
-    // TODO(egoode) investigate performance hit of RPM_ADD_WITH_CHANGELOG, possibly make this configurable
-    int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR | RPM_ADD_WITH_CHANGELOG;
-    if (repo_add_rpmdb(repo, nullptr, flagsrpm) != 0) {
-        throw SolvError(
-            M_("Failed to load system repo from root \"{}\": {}"),
-            rootdir.empty() ? "/" : rootdir,
-            pool_errstr(*get_rpm_pool(base)));
+    // Changelogs inflate both the rpmdb read time and the pool, by default they are read from the rpmdb
+    // on demand by Package::get_changelogs(). Extra system repos from other roots always load them.
+    const bool with_changelogs =
+        !rootdir.empty() || base->get_config().get_load_system_repo_changelogs_option().get_value();
+    int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR;
+    if (with_changelogs) {
+        flagsrpm |= RPM_ADD_WITH_CHANGELOG;
+    }
+
+    // The cache contains only the packages of the installroot rpmdb
+    bool use_cache = false;
+    if (rootdir.empty() && base->get_config().get_system_repo_cache_option().get_value()) {
+        use_cache = init_system_repo_cache(with_changelogs);
+    } else {
+        system_repo_cache_path.clear();
+    }
+
+    bool loaded_from_cache = use_cache && load_solv_cache(pool, nullptr, 0);
+    if (!loaded_from_cache) {
+        // The outdated cache is used as a reference, libsolv then reads only the headers that changed
+        fs::File ref_file;
+        if (use_cache) {
+            try {
+                ref_file.open(system_repo_cache_path, "r");
+            } catch (const std::filesystem::filesystem_error & e) {
+                logger.trace("System repo cache \"{}\" not available as a reference", system_repo_cache_path.native());
+            }
+        }
+        if (repo_add_rpmdb_reffp(repo, ref_file.get(), flagsrpm) != 0) {
+            throw SolvError(
+                M_("Failed to load system repo from root \"{}\": {}"),
+                rootdir.empty() ? "/" : rootdir,
+                pool_errstr(*get_rpm_pool(base)));
+        }
     }
 
     if (!rootdir.empty()) {
@@ -424,6 +1223,153 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
 
     main_solvables_start = solvables_start;
     main_solvables_end = pool->nsolvables;
+
+    if (!with_changelogs) {
+        lazy_changelogs_start = solvables_start;
+        lazy_changelogs_end = pool->nsolvables;
+    }
+
+    if (use_cache) {
+        load_fileprovides_cache();
+    }
+
+    if (use_cache && !loaded_from_cache) {
+        try {
+            write_main(false);
+        } catch (const std::exception & ex) {
+            // e.g. a user without write access to the system state directory
+            logger.debug("Cannot write system repo cache \"{}\": {}", system_repo_cache_path.native(), ex.what());
+        }
+    }
+}
+
+
+bool SolvRepo::init_system_repo_cache(bool with_changelogs) {
+    auto & logger = *base->get_logger();
+
+    std::string cookie;
+    try {
+        cookie = libdnf5::rpm::Transaction(base).get_db_cookie();
+    } catch (const std::exception & ex) {
+        logger.debug("Cannot get rpmdb cookie, not using system repo cache: {}", ex.what());
+        system_repo_cache_path.clear();
+        return false;
+    }
+
+    // The checksum of the cookie takes place of the repomd checksum in the solv userdata
+    auto h = solv_chksum_create(CHKSUM_TYPE);
+    solv_chksum_add(h, CHKSUM_IDENT, strlen(CHKSUM_IDENT));
+    solv_chksum_add(h, cookie.data(), static_cast<int>(cookie.size()));
+    solv_chksum_free(h, checksum);
+    repomd_fingerprint = {};
+
+    system_repo_cache_path = base->p_impl->get_system_state().get_system_repo_cache_path(with_changelogs);
+    return true;
+}
+
+
+bool SolvRepo::system_comps_checksum_calc(
+    const std::filesystem::path & comps_dir,
+    const std::vector<std::string> & group_ids,
+    const std::vector<std::string> & environment_ids,
+    unsigned char * out) {
+    auto & logger = *base->get_logger();
+
+    // The checksum covers the ids of the installed groups and environments and the fingerprints of their
+    // xml files, it takes place of the repomd checksum in the solv userdata
+    auto h = solv_chksum_create(CHKSUM_TYPE);
+    solv_chksum_add(h, CHKSUM_IDENT, strlen(CHKSUM_IDENT));
+    bool all_files_present = true;
+    auto add_file = [&](const char * prefix, const std::string & id) {
+        auto xml_path = comps_dir / (id + ".xml");
+        auto fingerprint = get_repomd_fingerprint(xml_path);
+        if (!fingerprint.is_valid()) {
+            all_files_present = false;
+            return;
+        }
+        solv_chksum_add(h, prefix, static_cast<int>(strlen(prefix)));
+        // including the terminating '\0' to separate the id from the fingerprint
+        solv_chksum_add(h, id.c_str(), static_cast<int>(id.size() + 1));
+        solv_chksum_add(h, &fingerprint.inode, sizeof(fingerprint.inode));
+        solv_chksum_add(h, &fingerprint.size, sizeof(fingerprint.size));
+        solv_chksum_add(h, &fingerprint.mtime_ns, sizeof(fingerprint.mtime_ns));
+    };
+    for (const auto & group_id : group_ids) {
+        add_file("group:", group_id);
+    }
+    for (const auto & environment_id : environment_ids) {
+        add_file("environment:", environment_id);
+    }
+    solv_chksum_free(h, out);
+
+    if (!all_files_present) {
+        logger.trace("Some installed groups xml files are missing, not using system comps cache");
+    }
+    return all_files_present;
+}
+
+
+bool SolvRepo::load_system_comps_cache(const std::filesystem::path & path, const unsigned char * comps_checksum) {
+    auto & logger = *base->get_logger();
+    solv::Pool & pool = static_cast<solv::Pool &>(get_comps_pool(base));
+
+    try {
+        fs::File cache_file(path, "r");
+        if (!can_use_solvfile_cache(logger, pool, cache_file, comps_checksum)) {
+            return false;
+        }
+        logger.debug("Loading system comps cache file: \"{}\"", path.native());
+        if (repo_add_solv(comps_repo, cache_file.get(), 0) != 0) {
+            // the failed read can leave a part of the solvables in the repo
+            repo_empty(comps_repo, 1);
+            logger.warning("Failed to load system comps cache \"{}\": {}", path.native(), pool_errstr(*pool));
+            return false;
+        }
+    } catch (const std::filesystem::filesystem_error & e) {
+        if (e.code().default_error_condition() == std::errc::no_such_file_or_directory) {
+            logger.trace("Cache file \"{}\" not found", path.native());
+        } else {
+            logger.warning("Error opening cache file, ignoring: {}", e.what());
+        }
+        return false;
+    }
+
+    return true;
+}
+
+
+void SolvRepo::write_system_comps_cache(
+    const std::filesystem::path & path, const unsigned char * comps_checksum, int solvables_start, int solvables_end) {
+    auto & logger = *base->get_logger();
+    solv::Pool & pool = static_cast<solv::Pool &>(get_comps_pool(base));
+
+    const auto solvfile_parent_dir = path.parent_path();
+    std::filesystem::create_directories(solvfile_parent_dir);
+
+    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, path.filename());
+    auto & cache_file = cache_tmp_file.open_as_file("w+");
+
+    logger.trace("Writing system comps cache to \"{}\"", cache_tmp_file.get_path().native());
+
+    SolvUserdata solv_userdata{};
+    userdata_fill(&solv_userdata, comps_checksum, {});
+
+    Repowriter * writer = repowriter_create(comps_repo);
+    repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_solvablerange(writer, solvables_start, solvables_end);
+    int res = repowriter_write(writer, cache_file.get());
+    repowriter_free(writer);
+
+    if (res != 0) {
+        throw SolvError(
+            M_("Failed to write system comps cache to \"{}\": {}"),
+            cache_tmp_file.get_path().native(),
+            pool_errstr(*pool));
+    }
+
+    cache_tmp_file.close();
+    std::filesystem::rename(cache_tmp_file.get_path(), path);
+    cache_tmp_file.release();
 }
 
 
@@ -453,11 +1399,15 @@ void SolvRepo::rewrite_repo(libdnf5::solv::IdQueue & fileprovides) {
     auto & logger = *base->get_logger();
     auto & pool = get_rpm_pool(base);
 
-    logger.debug("Rewriting repo \"{}\" with added file provides", config.get_id());
+    logger.debug("Storing added file provides of repo \"{}\"", config.get_id());
 
     if (!config.get_build_cache_option().get_value() || main_solvables_start == 0 || fileprovides.size() == 0) {
         return;
     }
+    // The checksum of the system repo identifies the rpmdb only when the system repo cache is used
+    if (repo == pool->installed && system_repo_cache_path.empty()) {
+        return;
+    }
 
     libdnf5::solv::IdQueue fileprovidesq;
     libdnf5::solv::SolvMap providedids(pool->ss.nstrings);
@@ -471,7 +1421,146 @@ void SolvRepo::rewrite_repo(libdnf5::solv::IdQueue & fileprovides) {
     repodata_set_idarray(data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, &fileprovides.get_queue());
     repodata_internalize(data);
 
-    write_main(false);
+    write_fileprovides_cache(fileprovides);
+}
+
+
+std::filesystem::path SolvRepo::fileprovides_cache_path() {
+    return solv_file_path().replace_extension(".fileprovides");
+}
+
+
+std::string SolvRepo::get_fileprovides_cache_header() {
+    auto & pool = get_rpm_pool(base);
+    return fmt::format(
+        "{} {} {}",
+        FILEPROVIDES_CACHE_MAGIC,
+        pool_bin2hex(*pool, checksum, CHKSUM_BYTES),
+        main_solvables_end - main_solvables_start);
+}
+
+
+void SolvRepo::write_fileprovides_cache(const libdnf5::solv::IdQueue & fileprovides) {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+
+    // The file provides follow the SOLVABLE_FILEMARKER in the provides of the solvables
+    std::unordered_map<Id, std::vector<int>> providers;
+    for (Id file_id : fileprovides) {
+        providers.emplace(file_id, std::vector<int>());
+    }
+    for (int id = main_solvables_start; id < main_solvables_end; ++id) {
+        Solvable * solvable = pool_id2solvable(*pool, id);
+        if (solvable->repo != repo || !solvable->dep_provides) {
+            continue;
+        }
+        bool after_marker = false;
+        for (Id * dep = repo->idarraydata + solvable->dep_provides; *dep; ++dep) {
+            if (*dep == SOLVABLE_FILEMARKER) {
+                after_marker = true;
+            } else if (auto it = providers.find(*dep); after_marker && it != providers.end()) {
+                it->second.push_back(id - main_solvables_start);
+            }
+        }
+    }
+
+    const auto path = fileprovides_cache_path();
+    std::filesystem::create_directories(path.parent_path());
+    auto cache_tmp_file = fs::TempFile(path.parent_path(), path.filename());
+    auto & cache_file = cache_tmp_file.open_as_file("w");
+    cache_file.write(get_fileprovides_cache_header() + '\n');
+    // One line per file provide: the escaped path, a tab and the space separated offsets of its providers.
+    // The list of the offsets is empty for the provides not provided by this repo.
+    for (Id file_id : fileprovides) {
+        std::string line = escape_fileprovides_path(pool_id2str(*pool, file_id));
+        line.push_back('\t');
+        const auto & offsets = providers[file_id];
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            if (i > 0) {
+                line.push_back(' ');
+            }
+            line.append(std::to_string(offsets[i]));
+        }
+        line.push_back('\n');
+        cache_file.write(line);
+    }
+    cache_tmp_file.close();
+    std::filesystem::rename(cache_tmp_file.get_path(), path);
+    cache_tmp_file.release();
+
+    logger.trace(
+        "Written {} added file provides of repo \"{}\" to \"{}\"", fileprovides.size(), config.get_id(), path.native());
+}
+
+
+void SolvRepo::load_fileprovides_cache() {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+    const auto path = fileprovides_cache_path();
+    const int nsolvables = main_solvables_end - main_solvables_start;
+
+    std::vector<std::pair<std::string, std::vector<int>>> entries;
+    try {
+        fs::File cache_file(path, "r");
+        std::string line;
+        if (!cache_file.read_line(line) || line != get_fileprovides_cache_header()) {
+            logger.trace("File provides cache \"{}\" does not belong to the loaded repo", path.native());
+            return;
+        }
+        while (cache_file.read_line(line)) {
+            auto tab = line.find('\t');
+            auto file = tab == std::string::npos ? std::nullopt : unescape_fileprovides_path(line.substr(0, tab));
+            if (!file) {
+                logger.warning("Invalid file provides cache \"{}\", ignoring", path.native());
+                return;
+            }
+            auto & offsets = entries.emplace_back(std::move(*file), std::vector<int>()).second;
+            std::istringstream offsets_stream(line.substr(tab + 1));
+            int offset;
+            while (offsets_stream >> offset) {
+                if (offset < 0 || offset >= nsolvables) {
+                    logger.warning("Invalid file provides cache \"{}\", ignoring", path.native());
+                    return;
+                }
+                offsets.push_back(offset);
+            }
+        }
+    } catch (const std::filesystem::filesystem_error & e) {
+        if (e.code().default_error_condition() != std::errc::no_such_file_or_directory) {
+            logger.warning("Error opening file provides cache, ignoring: {}", e.what());
+        }
+        return;
+    }
+
+    std::vector<Id> file_ids;
+    for (const auto & [file, offsets] : entries) {
+        Id file_id = pool_str2id(*pool, file.c_str(), 1);
+        for (auto offset : offsets) {
+            Solvable * solvable = pool_id2solvable(*pool, main_solvables_start + offset);
+            solvable->dep_provides = repo_addid_dep(repo, solvable->dep_provides, file_id, SOLVABLE_FILEMARKER);
+        }
+        file_ids.push_back(file_id);
+    }
+
+    // Marks the provides as added, so that libsolv does not search the file lists for them again.
+    // The main cache written by older versions can contain added file provides too.
+    Repodata * data = repo_id2repodata(repo, 1);
+    libdnf5::solv::IdQueue fileprovides;
+    repodata_lookup_idarray(data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, &fileprovides.get_queue());
+    for (Id file_id : fileprovides) {
+        file_ids.push_back(file_id);
+    }
+    std::sort(file_ids.begin(), file_ids.end());
+    file_ids.erase(std::unique(file_ids.begin(), file_ids.end()), file_ids.end());
+    fileprovides.clear();
+    for (Id file_id : file_ids) {
+        fileprovides.push_back(file_id);
+    }
+    repodata_set_idarray(data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, &fileprovides.get_queue());
+    repodata_internalize(data);
+
+    logger.debug(
+        "Loaded {} added file provides of repo \"{}\" from \"{}\"", entries.size(), config.get_id(), path.native());
 }
 
 
@@ -494,16 +1583,156 @@ void SolvRepo::set_subpriority(int subpriority) {
 }
 
 
+// Returns the resident set size of the current process in KiB, or -1 if it cannot be determined.
+static long get_rss_kib() {
+    long size{0};
+    long resident{0};
+    FILE * statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return -1;
+    }
+    int res = std::fscanf(statm, "%ld %ld", &size, &resident);
+    std::fclose(statm);
+    if (res != 2) {
+        return -1;
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+
+namespace {
+
+/// Paths of the valid solv cache files loaded or written in the process by the repomd checksum and the cache type.
+/// Bases with different cache directories, e.g. for different installroots, link them into their caches instead
+/// of parsing the same metadata again.
+class SharedSolvCaches {
+public:
+    static SharedSolvCaches & get_instance() {
+        static SharedSolvCaches instance;
+        return instance;
+    }
+
+    void add(const std::string & key, const std::filesystem::path & path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        paths[key] = path;
+    }
+
+    std::filesystem::path get(const std::string & key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = paths.find(key);
+        return it == paths.end() ? std::filesystem::path() : it->second;
+    }
+
+    /// Removes the `path` of the `key` unless it was replaced in the meantime
+    void remove(const std::string & key, const std::filesystem::path & path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = paths.find(key); it != paths.end() && it->second == path) {
+            paths.erase(it);
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::filesystem::path> paths;
+};
+
+}  // namespace
+
+
+std::string SolvRepo::get_shared_solv_cache_key(const char * type) {
+    return fmt::format("{}:{}", pool_bin2hex(*get_rpm_pool(base), checksum, CHKSUM_BYTES), type ? type : "");
+}
+
+
+void SolvRepo::share_solv_cache(const char * type) {
+    // The system repo cache is tied to the rpmdb of the installroot
+    if (type == nullptr && !system_repo_cache_path.empty()) {
+        return;
+    }
+    SharedSolvCaches::get_instance().add(get_shared_solv_cache_key(type), solv_file_path(type));
+}
+
+
+bool SolvRepo::link_shared_solv_cache(const char * type) {
+    if (type == nullptr && !system_repo_cache_path.empty()) {
+        return false;
+    }
+    auto & logger = *base->get_logger();
+    auto & shared_caches = SharedSolvCaches::get_instance();
+    const auto key = get_shared_solv_cache_key(type);
+    const auto shared_path = shared_caches.get(key);
+    const auto path = solv_file_path(type);
+    if (shared_path.empty() || shared_path == path) {
+        return false;
+    }
+
+    // The file is replaced by a rename when the cache is written again, so the linked caches never change
+    // under each other. The hard link shares the page cache of the lazily loaded data, a copy is the fallback
+    // for different filesystems.
+    try {
+        std::filesystem::create_directories(path.parent_path());
+        fs::TempFile tmp_file(path.parent_path(), path.filename());
+        tmp_file.close();
+        std::filesystem::remove(tmp_file.get_path());
+        std::error_code ec;
+        std::filesystem::create_hard_link(shared_path, tmp_file.get_path(), ec);
+        if (ec) {
+            std::filesystem::copy_file(shared_path, tmp_file.get_path());
+        }
+        std::filesystem::rename(tmp_file.get_path(), path);
+        tmp_file.release();
+    } catch (const std::filesystem::filesystem_error & ex) {
+        logger.debug("Cannot use shared solv cache file \"{}\": {}", shared_path.native(), ex.what());
+        shared_caches.remove(key, shared_path);
+        return false;
+    }
+    logger.debug("Using solv cache file \"{}\" shared in the process as \"{}\"", shared_path.native(), path.native());
+    return true;
+}
+
+
 bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type, int flags) {
+    if (load_solv_cache_file(pool, type, flags)) {
+        share_solv_cache(type);
+        return true;
+    }
+    // A cache file shared by another base is validated the same way as the own one
+    return link_shared_solv_cache(type) && load_solv_cache_file(pool, type, flags);
+}
+
+
+bool SolvRepo::load_solv_cache_file(solv::Pool & pool, const char * type, int flags) {
     auto & logger = *base->get_logger();
+    const bool prefetch = base->get_config().get_solv_cache_prefetch_option().get_value();
 
     auto path = solv_file_path(type);
 
+    // Must outlive `cache_file`, the stream reads through it.
+    std::vector<char> read_buffer;
+
     try {
         fs::File cache_file(path, "r");
 
+        if (prefetch) {
+            // libsolv copies the data it reads into its own structures, only the paged (vertical) data are read
+            // later on demand using the file descriptor. Ask the kernel to read the whole file into the page cache
+            // (which is shared with other processes reading the same cache) and read it in larger chunks.
+            posix_fadvise(cache_file.get_fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+            posix_fadvise(cache_file.get_fd(), 0, 0, POSIX_FADV_WILLNEED);
+            read_buffer.resize(SOLV_CACHE_READ_BUFFER_SIZE);
+            std::setvbuf(cache_file.get(), read_buffer.data(), _IOFBF, read_buffer.size());
+        }
+
         if (can_use_solvfile_cache(pool, cache_file)) {
             logger.debug("Loading solv cache file: \"{}\"", path.native());
+            // The statistics compare the prefetching with the plain load, they are collected only when prefetching
+            // is enabled to keep the default path free of the extra /proc reads
+            long rss_before{-1};
+            std::chrono::steady_clock::time_point time_before;
+            if (prefetch) {
+                rss_before = get_rss_kib();
+                time_before = std::chrono::steady_clock::now();
+            }
             if (repo_add_solv(type == RepoDownloader::MD_FILENAME_GROUP ? comps_repo : repo, cache_file.get(), flags) !=
                 0) {
                 throw SolvError(
@@ -513,6 +1742,15 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type, int flags)
                     path.native(),
                     pool_errstr(*get_rpm_pool(base)));
             }
+            if (prefetch) {
+                const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - time_before);
+                logger.debug(
+                    "Loaded prefetched solv cache file \"{}\" in {} us, RSS change: {} KiB",
+                    path.native(),
+                    elapsed.count(),
+                    rss_before < 0 ? 0 : get_rss_kib() - rss_before);
+            }
             return true;
         }
     } catch (const std::filesystem::filesystem_error & e) {
@@ -528,6 +1766,7 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type, int flags)
 
 
 void SolvRepo::write_main(bool load_after_write) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "write solv cache", config.get_id());
     auto & logger = *base->get_logger();
     auto & pool = get_rpm_pool(base);
 
@@ -553,6 +1792,10 @@ void SolvRepo::write_main(bool load_after_write) {
     Repowriter * writer = repowriter_create(repo);
     repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
     repowriter_set_solvablerange(writer, main_solvables_start, main_solvables_end);
+    if (auto first_stub_meta_id = get_first_stub_meta_id(); first_stub_meta_id != 0) {
+        // Keep the on demand repodata (and the descriptions of the stubs preceding them) out of the main cache.
+        repowriter_set_repodatarange(writer, 1, first_stub_meta_id);
+    }
     int res = repowriter_write(writer, cache_file.get());
     repowriter_free(writer);
 
@@ -584,11 +1827,13 @@ void SolvRepo::write_main(bool load_after_write) {
 
     std::filesystem::rename(cache_tmp_file.get_path(), solvfile_path);
     cache_tmp_file.release();
+    share_solv_cache(nullptr);
 }
 
 
-void SolvRepo::write_ext(Id repodata_id, RepodataType type) {
+void SolvRepo::write_ext(Id repodata_id, RepodataType type, bool load_after_write) {
     libdnf_assert(repodata_id != 0, "0 is not a valid repodata id");
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "write solv cache", config.get_id());
 
     auto & logger = *base->get_logger();
     solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base))
@@ -644,7 +1889,7 @@ void SolvRepo::write_ext(Id repodata_id, RepodataType type) {
 
     cache_tmp_file.close();
 
-    if (is_one_piece(repo) && type != RepodataType::UPDATEINFO && type != RepodataType::COMPS) {
+    if (load_after_write && is_one_piece(repo) && type != RepodataType::UPDATEINFO && type != RepodataType::COMPS) {
         // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
         // keeps the file open and lazily loads some data on-demand.
         fs::File file(cache_tmp_file.get_path(), "r");
@@ -667,20 +1912,35 @@ void SolvRepo::write_ext(Id repodata_id, RepodataType type) {
 
     std::filesystem::rename(cache_tmp_file.get_path(), solvfile_path);
     cache_tmp_file.release();
+    share_solv_cache(type_name);
 }
 
 
-std::string SolvRepo::solv_file_name(const char * type) {
+static std::string solv_file_name(const std::string & repoid, const char * type) {
     if (type != nullptr) {
-        return fmt::format("{}-{}.solvx", config.get_id(), type);
+        return fmt::format("{}-{}.solvx", repoid, type);
     } else {
-        return config.get_id() + ".solv";
+        return repoid + ".solv";
     }
 }
 
 
 std::filesystem::path SolvRepo::solv_file_path(const char * type) {
-    return std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / solv_file_name(type);
+    if (type == nullptr && !system_repo_cache_path.empty()) {
+        return system_repo_cache_path;
+    }
+    return solv_file_path(config, type);
+}
+
+
+std::filesystem::path SolvRepo::solv_file_path(const ConfigRepo & config, const char * type) {
+    return solv_file_path(config.get_cachedir(), config.get_id(), type);
+}
+
+
+std::filesystem::path SolvRepo::solv_file_path(
+    const std::string & cachedir, const std::string & repoid, const char * type) {
+    return std::filesystem::path(cachedir) / CACHE_SOLV_FILES_DIR / solv_file_name(repoid, type);
 }
 
 bool SolvRepo::read_group_solvable_from_xml(const std::string & path) {
@@ -27,26 +27,37 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/common/exception.hpp"
+#include "libdnf5/logger/logger.hpp"
 #include "libdnf5/repo/config_repo.hpp"
+#include "libdnf5/repo/memory_usage.hpp"
 
 #include <solv/repo.h>
 
+#include <cstdint>
 #include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
 
 
 static const constexpr size_t CHKSUM_BYTES = 32;
 static const constexpr size_t SOLV_USERDATA_SOLV_TOOLVERSION_SIZE{8};
 static const constexpr std::array<char, 4> SOLV_USERDATA_MAGIC{'\0', 'd', 'n', 'f'};
-static const constexpr std::array<char, 4> SOLV_USERDATA_DNF_VERSION{'\0', '1', '.', '0'};
+static const constexpr std::array<char, 4> SOLV_USERDATA_DNF_VERSION{'\0', '1', '.', '1'};
 
-static constexpr const size_t SOLV_USERDATA_SIZE =
-    SOLV_USERDATA_SOLV_TOOLVERSION_SIZE + SOLV_USERDATA_MAGIC.size() + SOLV_USERDATA_DNF_VERSION.size() + CHKSUM_BYTES;
+static constexpr const size_t SOLV_USERDATA_SIZE = SOLV_USERDATA_SOLV_TOOLVERSION_SIZE + SOLV_USERDATA_MAGIC.size() +
+                                                   SOLV_USERDATA_DNF_VERSION.size() + CHKSUM_BYTES +
+                                                   3 * sizeof(std::uint64_t);
 
 struct SolvUserdata {
     char dnf_magic[SOLV_USERDATA_MAGIC.size()];
     char dnf_version[SOLV_USERDATA_DNF_VERSION.size()];
     char libsolv_version[SOLV_USERDATA_SOLV_TOOLVERSION_SIZE];
     unsigned char checksum[CHKSUM_BYTES];
+    // Fingerprint of the repomd.xml file the checksum was computed from
+    std::uint64_t repomd_inode;
+    std::uint64_t repomd_size;
+    std::uint64_t repomd_mtime_ns;
 } __attribute__((packed));
 
 namespace libdnf5::repo {
@@ -55,6 +66,42 @@ using LibsolvRepo = ::Repo;
 enum class RepodataType { FILELISTS, PRESTO, UPDATEINFO, COMPS, OTHER };
 
 
+/// Identifies a version of the repomd.xml file without reading it. A zero-initialized fingerprint is
+/// never trusted.
+struct RepomdFingerprint {
+    std::uint64_t inode{0};
+    std::uint64_t size{0};
+    std::uint64_t mtime_ns{0};
+
+    bool operator==(const RepomdFingerprint & other) const noexcept {
+        return inode == other.inode && size == other.size && mtime_ns == other.mtime_ns;
+    }
+    bool is_valid() const noexcept { return inode != 0 || size != 0 || mtime_ns != 0; }
+};
+
+
+/// The inputs of `SolvRepo::build_cache()` copied from the repo configuration and downloader, so that the cache
+/// can be built by a background job that does not refer to the repo.
+struct SolvCacheSource {
+    SolvCacheSource(
+        const ConfigRepo & config,
+        const std::string & repomd_fn,
+        const RepoDownloader & downloader,
+        std::vector<RepodataType> types);
+
+    /// Returns the path to the metadata of the `type`, empty when the metadata are not present
+    const std::string & get_metadata_path(const std::string & type) const;
+
+    std::string repoid;
+    std::string cachedir;
+    std::string repomd_fn;
+    /// Types of extended repodata to stage in addition to the main repodata
+    std::vector<RepodataType> types;
+    /// Paths to the primary metadata and to the metadata of the `types` by the metadata type name
+    std::map<std::string, std::string> metadata_paths;
+};
+
+
 class SolvError : public Error {
     using Error::Error;
 
@@ -74,15 +121,58 @@ public:
     /// Loads additional metadata (filelist, others, ...) from available repo.
     void load_repo_ext(RepodataType type, const RepoDownloader & downloader);
 
+    /// Returns the estimated memory used by the loaded metadata of the repo in the libsolv pools.
+    RepoMemoryUsage get_memory_usage() const;
+
+    /// Creates missing or outdated libsolv cache files (.solv and .solvx) of an available repo.
+    ///
+    /// The metadata are parsed into a private staging pool, the main pool is not touched. It means the method
+    /// can be called concurrently for several repositories from worker threads. A subsequent call of
+    /// `load_repo_main()` and `load_repo_ext()` then only loads the cache files into the main pool.
+    /// The comps metadata are loaded into a separate pool and are not staged.
+    ///
+    /// @param repomd_fn Path to the repomd.xml file of the repo
+    /// @param downloader The downloader with loaded paths to the metadata files
+    /// @param types Types of extended repodata to stage in addition to the main repodata
+    static void build_cache(
+        const libdnf5::BaseWeakPtr & base,
+        const ConfigRepo & config,
+        const std::string & repomd_fn,
+        const RepoDownloader & downloader,
+        const std::vector<RepodataType> & types);
+
+    /// Queues `build_cache()` of the repo to the background writer of the Base. Used instead of writing
+    /// the cache files while loading when "build_cache_in_background" is enabled. Errors are logged.
+    /// The job works with copies of the paths and the configuration values. The previous job of the repo is
+    /// cancelled before the new one is queued, and the queued or running job is cancelled when the SolvRepo is
+    /// destroyed.
+    ///
+    /// @param repomd_fn Path to the repomd.xml file of the repo
+    /// @param downloader The downloader with loaded paths to the metadata files
+    /// @param types Types of extended repodata to write in addition to the main repodata
+    void build_cache_in_background(
+        const std::string & repomd_fn, const RepoDownloader & downloader, std::vector<RepodataType> types);
+
+    /// Computes the checksum of the repomd.xml file `repomd_fn` which the .solv and .solvx cache files are tied to.
+    static void repomd_checksum_calc(const std::string & repomd_fn, unsigned char * out);
+
+    /// Returns whether the .solv or .solvx cache file `path` was written by this version of dnf and libsolv for
+    /// the repomd.xml file with the `repomd_checksum`. Only the userdata of the file are read.
+    static bool is_solv_cache_of(const std::filesystem::path & path, const unsigned char * repomd_checksum);
+
     /// Loads system repository into the pool.
     ///
     /// @param rootdir If empty, loads the installroot rpmdb, if not loads rpmdb from this root path
-    /// TODO(jrohel): Performance: Implement libsolv cache ("build_cache" argument) of system repo in future.
+    /// With "system_repo_cache" enabled, the installroot rpmdb is loaded from a libsolv cache file in the system
+    /// state directory validated by the rpmdb cookie.
     void load_system_repo(const std::string & rootdir = "");
 
     /// Loads additional system repo metadata (comps, modules)
     void load_system_repo_ext(RepodataType type);
 
+    /// Marks the `fileprovides` added by libsolv to the solvables of the repo as added and stores them in a small
+    /// cache file next to the main .solv cache, the main cache is not rewritten. Nothing is done when the added
+    /// file provides are already marked.
     void rewrite_repo(libdnf5::solv::IdQueue & fileprovides);
 
     // Internalize repository if needed.
@@ -94,8 +184,26 @@ public:
     // Checksum of data in .solv file. Used for validity check of .solvx files.
     unsigned char checksum[CHKSUM_BYTES];
 
+    // Fingerprint of the repomd.xml file the `checksum` belongs to. Stored in the written cache files.
+    RepomdFingerprint repomd_fingerprint;
+
     void set_needs_internalizing() { needs_internalizing = true; };
 
+    /// @return `true` if the changelogs of the installed package `id` were not loaded with the system repo and have to
+    ///         be read from the rpmdb of the installroot.
+    bool has_lazy_changelogs(Id id) const noexcept { return id >= lazy_changelogs_start && id < lazy_changelogs_end; }
+
+    /// @return Number of times the on demand filelists stub of the repo was loaded (0 or 1 unless loading failed).
+    std::size_t get_filelists_stub_loads() const noexcept { return filelists_stub.loads; }
+
+    /// @return Number of times the on demand other (changelogs) stub of the repo was loaded (0 or 1 unless loading
+    ///         failed).
+    std::size_t get_other_stub_loads() const noexcept { return other_stub.loads; }
+
+    /// @return Number of times the on demand package details stub of the repo was loaded (0 or 1 unless loading
+    ///         failed).
+    std::size_t get_details_stub_loads() const noexcept { return details_stub.loads; }
+
     /// @return  Vector of group ids of system repo groups without valid xml
     std::vector<std::string> & get_groups_missing_xml() { return groups_missing_xml; };
 
@@ -121,17 +229,91 @@ public:
     bool read_group_solvable_from_xml(const std::string & path);
 
 private:
+    /// Loads the solv cache file of the `type`. When the own cache file cannot be used, a valid cache file of
+    /// the same metadata loaded or written by another base in the process is linked into the cache and loaded.
     bool load_solv_cache(solv::Pool & pool, const char * type, int flags);
+    bool load_solv_cache_file(solv::Pool & pool, const char * type, int flags);
+
+    /// Returns the key of the solv cache file of the `type` among the solv cache files shared in the process
+    std::string get_shared_solv_cache_key(const char * type);
+    /// Offers the valid solv cache file of the `type` to other bases in the process
+    void share_solv_cache(const char * type);
+    /// Links the solv cache file of the `type` shared by another base in the process into the own cache
+    /// @return `true` if a shared cache file was linked
+    bool link_shared_solv_cache(const char * type);
+
+    /// Computes the `checksum` of the system repo cache from the rpmdb cookie and sets `system_repo_cache_path`.
+    /// @return `false` if the cookie is not available and the cache cannot be used.
+    bool init_system_repo_cache(bool with_changelogs);
+
+    /// Computes the checksum identifying the xml files of the installed groups and environments in `comps_dir`
+    /// by their ids, inodes, sizes and modification times. The files are not read.
+    /// @return `false` if some of the xml files is missing and the cache cannot be used.
+    bool system_comps_checksum_calc(
+        const std::filesystem::path & comps_dir,
+        const std::vector<std::string> & group_ids,
+        const std::vector<std::string> & environment_ids,
+        unsigned char * out);
+
+    /// Loads the installed groups and environments from the cache file `path` if it was written for `comps_checksum`.
+    /// @return `false` if the cache is missing, outdated or failed to load.
+    bool load_system_comps_cache(const std::filesystem::path & path, const unsigned char * comps_checksum);
+
+    /// Writes the installed groups and environments solvables in the range [`solvables_start`, `solvables_end`)
+    /// to the cache file `path`.
+    void write_system_comps_cache(
+        const std::filesystem::path & path,
+        const unsigned char * comps_checksum,
+        int solvables_start,
+        int solvables_end);
 
     /// Writes libsolv's .solv cache file with main libsolv repodata.
     void write_main(bool load_after_write);
 
     /// Writes libsolv's .solvx cache file with extended libsolv repodata.
-    void write_ext(Id repodata_id, RepodataType type);
+    void write_ext(Id repodata_id, RepodataType type, bool load_after_write);
+
+    /// Registers the filelists or other `ext_fn` as a stub repodata. It is loaded the first time libsolv needs
+    /// the files or the changelogs of a package from the repo.
+    void add_ext_stub(RepodataType type, const std::string & ext_fn);
+
+    /// Loads the packages of the repo without their details (description, url, license, ...) from the core .solvx
+    /// cache and registers the details cache as a stub repodata, see "load_package_details_on_demand".
+    /// @return `false` if the core or the details cache is missing or outdated, nothing is loaded then.
+    bool load_package_core_cache(solv::Pool & pool);
+
+    /// Writes the main repodata of the packages split into the core and the details .solvx caches, they are used
+    /// by `load_package_core_cache()` during the next load of the repo.
+    void write_package_core_caches();
+
+    /// Registers the details cache as a stub repodata. It is loaded the first time libsolv needs the details
+    /// of a package from the repo.
+    void add_package_details_stub();
+
+    /// The libsolv pool load callback, dispatches the loading to the SolvRepo owning the stub `data`.
+    static int load_stub_callback(::Pool * pool, Repodata * data, void * cbdata);
+
+    /// Loads the stub `data` from the .solvx cache or from the xml.
+    /// @return `false` if `data` is not a stub of this repo or it failed to load.
+    bool load_ext_stub(Repodata * data) noexcept;
 
-    std::string solv_file_name(const char * type = nullptr);
     std::filesystem::path solv_file_path(const char * type = nullptr);
 
+    /// Path of the cache of the file provides added to the main solvables, next to the main .solv cache
+    std::filesystem::path fileprovides_cache_path();
+    /// Returns the first line of the added file provides cache, it ties the cache to the loaded main solvables
+    std::string get_fileprovides_cache_header();
+    /// Writes the added `fileprovides` with the offsets of their providers among the main solvables
+    void write_fileprovides_cache(const libdnf5::solv::IdQueue & fileprovides);
+    /// Adds the file provides from the added file provides cache to the main solvables if the cache belongs to them
+    void load_fileprovides_cache();
+    static std::filesystem::path solv_file_path(const ConfigRepo & config, const char * type);
+    static std::filesystem::path solv_file_path(
+        const std::string & cachedir, const std::string & repoid, const char * type);
+
+    /// Implements the public `build_cache()` with the inputs copied to the `source`
+    static void build_cache(const libdnf5::BaseWeakPtr & base, const SolvCacheSource & source);
+
     libdnf5::BaseWeakPtr base;
     const ConfigRepo & config;
 
@@ -143,8 +325,52 @@ private:
     int updateinfo_solvables_start{0};
     int updateinfo_solvables_end{0};
 
+    /// Extended repodata loaded on demand, see `add_ext_stub()`
+    struct ExtStub {
+        Id repodata_id{0};
+        std::string fn;
+        std::size_t loads{0};
+    };
+    ExtStub filelists_stub;
+    ExtStub other_stub;
+    ExtStub details_stub;
+
+    /// Ids and types of the extended repodata loaded by `load_repo_ext()` into `repo`, the stubs are not included.
+    /// The repodata not listed are created from the primary metadata.
+    std::vector<std::pair<Id, RepodataType>> ext_repodata;
+
+    /// @return The id of the description of the first stub repodata, or 0 if the repo has no stubs.
+    Id get_first_stub_meta_id() const noexcept;
+
+    /// Path of the system repo cache used instead of the cache in the cachedir, empty if not used
+    std::filesystem::path system_repo_cache_path;
+
+    /// Range of installed solvables loaded without changelogs, see `has_lazy_changelogs()`
+    int lazy_changelogs_start{0};
+    int lazy_changelogs_end{0};
+
     bool can_use_solvfile_cache(solv::Pool & pool, utils::fs::File & solvfile_cache);
+    static bool can_use_solvfile_cache(
+        libdnf5::Logger & logger,
+        solv::Pool & pool,
+        utils::fs::File & solvfile_cache,
+        const unsigned char * repomd_checksum);
     void userdata_fill(SolvUserdata * userdata);
+    static void userdata_fill(
+        SolvUserdata * userdata, const unsigned char * repomd_checksum, const RepomdFingerprint & fingerprint);
+
+    /// Returns the fingerprint of the file `repomd_fn`, or a zero-initialized fingerprint if stat fails.
+    static RepomdFingerprint get_repomd_fingerprint(const std::string & repomd_fn);
+
+    /// Computes the checksum of the repomd.xml file. If the main .solv cache file `main_cache_path` was created
+    /// from a repomd.xml file with the same `fingerprint`, the checksum stored in the cache file is used
+    /// instead and the repomd.xml file is not read at all.
+    static void repomd_checksum_calc(
+        libdnf5::Logger & logger,
+        const std::filesystem::path & main_cache_path,
+        const std::string & repomd_fn,
+        const RepomdFingerprint & fingerprint,
+        unsigned char * out);
 
     /// List of system repo groups without valid file with xml definition
     std::vector<std::string> groups_missing_xml;
@@ -26,48 +26,144 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <toml.hpp>
 
+#include <algorithm>
+#include <cstdint>
+
 
 namespace libdnf5::repo {
 
+namespace {
+
+/// Size of the journal above which its compaction is considered
+constexpr std::uintmax_t COMPACTION_THRESHOLD = 1024 * 1024;
+
+void sort_and_deduplicate(std::vector<std::string> & files) {
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+}
+
+}  // namespace
+
 TempFilesMemory::TempFilesMemory(const std::string & parent_dir)
-    : full_memory_path(std::filesystem::path(parent_dir) / MEMORY_FILENAME) {
+    : full_memory_path(std::filesystem::path(parent_dir) / MEMORY_FILENAME),
+      legacy_memory_path(std::filesystem::path(parent_dir) / LEGACY_MEMORY_FILENAME) {
     std::filesystem::create_directories(parent_dir);
 }
 
 TempFilesMemory::~TempFilesMemory() = default;
 
-std::vector<std::string> TempFilesMemory::get_files() const {
-    if (!std::filesystem::exists(full_memory_path)) {
+std::vector<std::string> TempFilesMemory::get_legacy_files() const {
+    if (!std::filesystem::exists(legacy_memory_path)) {
         return {};
     }
 
     try {
-        auto toml_data = toml::parse(full_memory_path);
+        auto toml_data = toml::parse(legacy_memory_path);
         return toml::get<std::vector<std::string>>(toml_data[FILE_PATHS_TOML_KEY]);
     } catch (const toml::exception & e) {
         throw libdnf5::Error(
             M_("An error occurred when parsing the temporary files memory file at '{}': {}"),
-            full_memory_path.string(),
+            legacy_memory_path.string(),
             std::string(e.what()));
     }
 }
 
-void TempFilesMemory::add_files(const std::vector<std::string> & paths) {
-    auto files = get_files();
-    files.insert(files.end(), paths.begin(), paths.end());
+std::vector<std::string> TempFilesMemory::get_journal_files() const {
+    std::vector<std::string> files;
+    if (!std::filesystem::exists(full_memory_path)) {
+        return files;
+    }
 
-    // sort and deduplicate resulting vector
-    std::sort(files.begin(), files.end());
-    files.erase(std::unique(files.begin(), files.end()), files.end());
+    utils::fs::File journal(full_memory_path, "r");
+    std::string line;
+    while (journal.read_line(line)) {
+        // an empty line is left by a write interrupted before its newline was appended
+        if (!line.empty()) {
+            files.push_back(line);
+        }
+    }
+    return files;
+}
+
+void TempFilesMemory::write_journal(const std::vector<std::string> & paths) {
+    std::string data;
+    for (const auto & path : paths) {
+        data.append(path).push_back('\n');
+    }
 
     // write new contents to a temporary file and then move the new file atomically
     auto temporary_path = full_memory_path.string() + ".temp";
-    utils::fs::File(temporary_path, "w").write(toml::format(toml::value({{FILE_PATHS_TOML_KEY, files}})));
+    utils::fs::File(temporary_path, "w").write(data);
     std::filesystem::rename(temporary_path, full_memory_path);
 }
 
+std::vector<std::string> TempFilesMemory::get_files() const {
+    auto files = get_legacy_files();
+    auto journal_files = get_journal_files();
+    files.insert(files.end(), journal_files.begin(), journal_files.end());
+    sort_and_deduplicate(files);
+    return files;
+}
+
+void TempFilesMemory::add_files(const std::vector<std::string> & paths) {
+    // move the paths of the legacy memory file to the journal
+    if (std::filesystem::exists(legacy_memory_path)) {
+        write_journal(get_files());
+        std::filesystem::remove(legacy_memory_path);
+    }
+
+    std::string data;
+    // a line left unterminated by an interrupted write is not joined with the first new path
+    data.push_back('\n');
+    for (const auto & path : paths) {
+        data.append(path).push_back('\n');
+    }
+    utils::fs::File(full_memory_path, "a").write(data);
+
+    if (std::filesystem::file_size(full_memory_path) <= COMPACTION_THRESHOLD) {
+        return;
+    }
+
+    // rewrite the journal only when it is made mostly of duplicates, a journal of unique paths would be
+    // rewritten by every call otherwise
+    auto files = get_journal_files();
+    auto journal_size = files.size();
+    sort_and_deduplicate(files);
+    if (files.size() * 2 < journal_size) {
+        write_journal(files);
+    }
+}
+
+std::vector<std::pair<std::string, std::error_code>> TempFilesMemory::remove_files() {
+    std::vector<std::pair<std::string, std::error_code>> failures;
+    auto remove_file = [&failures](const std::string & path) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        if (ec) {
+            failures.emplace_back(path, ec);
+        }
+    };
+
+    for (const auto & path : get_legacy_files()) {
+        remove_file(path);
+    }
+    if (std::filesystem::exists(full_memory_path)) {
+        utils::fs::File journal(full_memory_path, "r");
+        std::string line;
+        while (journal.read_line(line)) {
+            if (!line.empty()) {
+                remove_file(line);
+            }
+        }
+    }
+
+    clear();
+    return failures;
+}
+
 void TempFilesMemory::clear() {
     std::filesystem::remove(full_memory_path);
+    std::filesystem::remove(legacy_memory_path);
 }
 
 }  // namespace libdnf5::repo
@@ -21,20 +21,28 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF5_REPO_TEMP_FILES_MEMORY_HPP
 
 #include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 
 namespace libdnf5::repo {
 
-/// @brief A class for storing paths of temporary files in a TOML file.
-/// It behaves in a stateless way, meaning no data are cached within the
-/// class.
+/// @brief A class for storing paths of temporary files in a journal file.
+/// The paths are appended to the journal one per line, the journal is compacted
+/// when it grows too large. It behaves in a stateless way, meaning no data are
+/// cached within the class.
 class TempFilesMemory {
 public:
-    /// @brief Filename in which the paths are stored.
-    static constexpr const char * MEMORY_FILENAME = "temporary_files.toml";
+    /// @brief Filename of the journal in which the paths are stored.
+    static constexpr const char * MEMORY_FILENAME = "temporary_files.journal";
 
-    /// @brief TOML key used for the array of stored paths.
+    /// @brief Filename of the TOML file in which the paths were stored by older versions.
+    /// Its paths are read together with the journal and they are moved to the journal by `add_files()`.
+    static constexpr const char * LEGACY_MEMORY_FILENAME = "temporary_files.toml";
+
+    /// @brief TOML key used for the array of stored paths in the legacy memory file.
     static constexpr const char * FILE_PATHS_TOML_KEY = "files";
 
     /// @brief Create the object for managing temporary files' paths.
@@ -45,26 +53,38 @@ public:
     ~TempFilesMemory();
 
     /// @brief Retrieve stored paths of temporary files.
-    /// @return A vector of parsed paths of temporary files.
-    /// @exception libdnf5::Error When an error occurs during parsing of the file with temporary files.
+    /// @return A sorted and deduplicated vector of paths of temporary files.
+    /// @exception libdnf5::Error When an error occurs during parsing of the legacy memory file.
     /// @exception std::filesystem::filesystem_error When an error occurs during accessing the memory file.
     std::vector<std::string> get_files() const;
 
-    /// @brief Add a list of file paths into the memory file.
-    /// The memory file is created if it didn't exist before.
-    /// Existing paths are loaded first using the `get_files()` method.
-    /// The resulting list contains both existing and new paths and it's sorted and deduplicated before storing in the file.
+    /// @brief Append a list of file paths to the journal.
+    /// The journal is created if it didn't exist before. Existing paths are not loaded, unless the journal
+    /// exceeds the compaction threshold. Then it is rewritten sorted and deduplicated if the duplicate
+    /// paths make up most of it.
     /// @param paths A list of file paths to be added into the memory file.
-    /// @exception libdnf5::Error When an error occurs during parsing of the file with temporary files.
+    /// @exception libdnf5::Error When an error occurs during parsing of the legacy memory file.
     /// @exception std::filesystem::filesystem_error When an error occurs during accessing or writing the memory file.
     void add_files(const std::vector<std::string> & paths);
 
+    /// @brief Removes the stored files and then deletes the memory file.
+    /// The journal is streamed without sorting, files that don't exist are skipped.
+    /// @return The paths of the files that could not be removed together with the errors.
+    /// @exception libdnf5::Error When an error occurs during parsing of the legacy memory file.
+    /// @exception std::filesystem::filesystem_error When an error occurs during accessing or deleting the memory file.
+    std::vector<std::pair<std::string, std::error_code>> remove_files();
+
     /// @brief Deletes the memory file.
     /// @exception std::filesystem::filesystem_error When an error occurs during deleting the memory file.
     void clear();
 
 private:
+    std::vector<std::string> get_legacy_files() const;
+    std::vector<std::string> get_journal_files() const;
+    void write_journal(const std::vector<std::string> & paths);
+
     std::filesystem::path full_memory_path;
+    std::filesystem::path legacy_memory_path;
 };
 
 
@@ -0,0 +1,115 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "zchunk_store.hpp"
+
+#include "package_store.hpp"
+#include "repo_cache_private.hpp"
+#include "utils/fs/file.hpp"
+
+extern "C" {
+#include <solv/chksum.h>
+#include <solv/util.h>
+}
+
+#include <array>
+#include <memory>
+#include <string>
+#include <system_error>
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+/// Returns the sha256 checksum of the file at `path` in hex
+std::string file_sha256(const std::filesystem::path & path) {
+    utils::fs::File file(path, "r");
+    std::unique_ptr<Chksum, void (*)(Chksum *)> chksum(
+        solv_chksum_create(REPOKEY_TYPE_SHA256), [](Chksum * ptr) { solv_chksum_free(ptr, nullptr); });
+    std::array<char, 65536> buffer;
+    while (auto read = file.read(buffer.data(), buffer.size())) {
+        solv_chksum_add(chksum.get(), buffer.data(), static_cast<int>(read));
+    }
+    int length;
+    auto * bytes = solv_chksum_get(chksum.get(), &length);
+    std::string hex(static_cast<std::size_t>(length) * 2, '\0');
+    solv_bin2hex(bytes, length, hex.data());
+    return hex;
+}
+
+}  // namespace
+
+
+void ZchunkStore::add_files(const std::filesystem::path & repodata_dir) const {
+    // Other processes can add and remove the entries concurrently, the errors are not fatal
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(repodata_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto & entry = *it;
+        const auto & path = entry.path();
+        std::error_code entry_ec;
+        if (path.extension() != ".zck" || !entry.is_regular_file(entry_ec) || entry.hard_link_count(entry_ec) > 1) {
+            continue;
+        }
+        std::string checksum;
+        try {
+            checksum = file_sha256(path);
+        } catch (const std::exception &) {
+            continue;
+        }
+        auto entry_dir = dir / checksum / CACHE_METADATA_DIR;
+        auto stored_path = entry_dir / path.filename();
+        if (std::filesystem::exists(stored_path, entry_ec)) {
+            continue;
+        }
+        std::filesystem::create_directories(entry_dir, entry_ec);
+        if (!entry_ec) {
+            link_store_file(path, stored_path, false);
+        }
+    }
+}
+
+
+void ZchunkStore::remove_unused(std::chrono::seconds max_age) const {
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto & entry = *it;
+        std::error_code entry_ec;
+        auto entry_time = entry.last_write_time(entry_ec);
+        if (entry_ec || now - entry_time < max_age) {
+            continue;
+        }
+        // An entry is used while its files are linked from a repository cache
+        bool used = false;
+        for (std::filesystem::directory_iterator file_it(entry.path() / CACHE_METADATA_DIR, entry_ec), file_end;
+             !entry_ec && file_it != file_end;
+             file_it.increment(entry_ec)) {
+            if (file_it->hard_link_count(entry_ec) > 1) {
+                used = true;
+                break;
+            }
+        }
+        if (!used) {
+            std::filesystem::remove_all(entry.path(), entry_ec);
+        }
+    }
+}
+
+}  // namespace libdnf5::repo
@@ -0,0 +1,59 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_REPO_ZCHUNK_STORE_HPP
+#define LIBDNF5_REPO_ZCHUNK_STORE_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <utility>
+
+
+namespace libdnf5::repo {
+
+/// Content-addressed store of zchunk metadata files shared by the repositories and installroots. librepo looks
+/// for the chunks of a zchunk file being downloaded in the zchunk files under its cache directory, the store is
+/// used as that directory. Identical chunks of related repositories are then downloaded only once.
+///
+/// The files are stored as `<dir>/<sha256>/repodata/<file name>`, the name is kept as librepo matches the files
+/// by their type. The stored files are hardlinks (or reflinks) of the files in the repository caches.
+class ZchunkStore {
+public:
+    /// How long an entry not linked from any repository cache is kept
+    static constexpr std::chrono::hours UNUSED_ENTRY_MAX_AGE{24 * 7};
+
+    explicit ZchunkStore(std::filesystem::path dir) : dir(std::move(dir)) {}
+
+    const std::filesystem::path & get_dir() const noexcept { return dir; }
+
+    /// Adds the zchunk files (`*.zck`) in `repodata_dir` to the store as hardlinks or reflinks, files are never
+    /// copied. A file having other hardlinks is considered stored already and it is not hashed again.
+    void add_files(const std::filesystem::path & repodata_dir) const;
+
+    /// Removes the entries which are not linked from any repository cache and are older than `max_age`.
+    /// The entries can be removed while other processes use them, an open file stays readable.
+    void remove_unused(std::chrono::seconds max_age = UNUSED_ENTRY_MAX_AGE) const;
+
+private:
+    std::filesystem::path dir;
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_ZCHUNK_STORE_HPP
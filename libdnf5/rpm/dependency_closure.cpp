@@ -0,0 +1,99 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dependency_closure.hpp"
+
+extern "C" {
+#include <solv/knownid.h>
+#include <solv/repo.h>
+}
+
+#include <cstddef>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+libdnf5::solv::SolvMap requires_closure(
+    const libdnf5::solv::RpmPool & pool,
+    const libdnf5::solv::SolvMap & start,
+    const libdnf5::solv::SolvMap & candidates) {
+    libdnf5::solv::SolvMap closure(start);
+    closure.grow(pool.get_nsolvables());
+    std::vector<Id> frontier(start.begin(), start.end());
+    std::vector<Id> next_frontier;
+
+    // Strings and reldeps share one index space: strings first, followed by reldeps
+    auto nstrings = static_cast<std::size_t>(pool->ss.nstrings);
+    std::vector<bool> evaluated_deps(nstrings + static_cast<std::size_t>(pool->nrels), false);
+
+    while (!frontier.empty()) {
+        for (Id package_id : frontier) {
+            const Solvable * solvable = pool.id2solvable(package_id);
+            if (!solvable->repo || !solvable->dep_requires) {
+                continue;
+            }
+            for (const Id * dep = solvable->repo->idarraydata + solvable->dep_requires; *dep != 0; ++dep) {
+                if (*dep == SOLVABLE_PREREQMARKER) {
+                    continue;
+                }
+                auto dep_idx = ISRELDEP(*dep) ? nstrings + static_cast<std::size_t>(GETRELID(*dep))
+                                              : static_cast<std::size_t>(*dep);
+                if (evaluated_deps[dep_idx]) {
+                    continue;
+                }
+                evaluated_deps[dep_idx] = true;
+                for (const Id * provider = pool_whatprovides_ptr(*pool, *dep); *provider != 0; ++provider) {
+                    if (candidates.contains(*provider) && !closure.contains_unsafe(*provider)) {
+                        closure.add_unsafe(*provider);
+                        next_frontier.push_back(*provider);
+                    }
+                }
+            }
+        }
+        frontier.swap(next_frontier);
+        next_frontier.clear();
+    }
+    return closure;
+}
+
+
+libdnf5::solv::SolvMap required_by_closure(
+    const libdnf5::solv::RpmPool & pool,
+    const PackageReverseDepIndex & index,
+    const libdnf5::solv::SolvMap & start,
+    const libdnf5::solv::SolvMap & candidates) {
+    auto nsolvables = pool.get_nsolvables();
+    libdnf5::solv::SolvMap closure(start);
+    closure.grow(nsolvables);
+    libdnf5::solv::SolvMap frontier(start);
+    std::vector<bool> matched_deps;
+
+    while (!frontier.empty()) {
+        libdnf5::solv::SolvMap next_frontier(nsolvables);
+        index.add_new_dependents(pool, frontier, matched_deps, next_frontier);
+        next_frontier &= candidates;
+        next_frontier -= closure;
+        closure |= next_frontier;
+        frontier.swap(next_frontier);
+    }
+    return closure;
+}
+
+}  // namespace libdnf5::rpm
@@ -0,0 +1,49 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_DEPENDENCY_CLOSURE_HPP
+#define LIBDNF5_RPM_DEPENDENCY_CLOSURE_HPP
+
+#include "package_reverse_dep_index.hpp"
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+
+namespace libdnf5::rpm {
+
+/// Returns `start` extended by the packages from `candidates` that provide, directly or transitively, the `requires`
+/// of the packages in `start`. The closure is computed level by level from the newly added packages and every
+/// dependency is looked up in whatprovides only once. The provides of the pool have to be ready.
+libdnf5::solv::SolvMap requires_closure(
+    const libdnf5::solv::RpmPool & pool,
+    const libdnf5::solv::SolvMap & start,
+    const libdnf5::solv::SolvMap & candidates);
+
+/// Returns `start` extended by the packages from `candidates` that require, directly or transitively, any package
+/// in `start`. The dependents of each level are found in the reverse `requires` index `index` from the newly added
+/// packages only and every dependency is matched only once. The provides of the pool have to be ready.
+libdnf5::solv::SolvMap required_by_closure(
+    const libdnf5::solv::RpmPool & pool,
+    const PackageReverseDepIndex & index,
+    const libdnf5::solv::SolvMap & start,
+    const libdnf5::solv::SolvMap & candidates);
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_DEPENDENCY_CLOSURE_HPP
@@ -24,6 +24,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <rpm/rpmver.h>
 
+#include <cstddef>
+
 
 namespace libdnf5::rpm {
 
@@ -37,215 +39,181 @@ const std::vector<Nevra::Form> & Nevra::get_default_pkg_spec_forms() {
 
 std::vector<Nevra> Nevra::parse(const std::string & nevra_str, const std::vector<Form> & forms) {
     std::vector<Nevra> result;
-    const char * before_last_delim = nullptr;
-    const char * epoch_delim = nullptr;
-    const char * last_delim = nullptr;
-    const char * arch_delim = nullptr;
-    const char * end;
-
-    // parse nevra
-    const char * nevra_pattern = nevra_str.c_str();
+    NevraParser parser(nevra_str);
+    NevraView nevra;
+    for (auto form : forms) {
+        if (parser.parse(form, nevra)) {
+            result.push_back(nevra.to_nevra());
+        }
+    }
+    return result;
+}
+
+
+Nevra NevraView::to_nevra() const {
+    Nevra nevra;
+    nevra.set_name(std::string(name));
+    nevra.set_epoch(std::string(epoch));
+    nevra.set_version(std::string(version));
+    nevra.set_release(std::string(release));
+    nevra.set_arch(std::string(arch));
+    return nevra;
+}
+
+
+NevraParser::NevraParser(std::string_view nevra_str) : nevra_str(nevra_str) {
     // detect whether string contains a glob range [a-z]
     bool start_range = false;
-    for (end = nevra_pattern; *end != '\0'; ++end) {
+    for (std::size_t idx = 0; idx < nevra_str.size(); ++idx) {
+        const char chr = nevra_str[idx];
         // skip all characteres before glob range is closed
         if (start_range) {
-            if (*end == ']') {
+            if (chr == ']') {
                 start_range = false;
             } else {
                 continue;
             }
         }
-        if (*end == '[') {
+        if (chr == '[') {
             start_range = true;
-        } else if (*end == '-') {
+        } else if (chr == '-') {
             before_last_delim = last_delim;
-            last_delim = end;
-        } else if (*end == '.') {
-            arch_delim = end;
-        } else if (*end == ':') {
+            last_delim = idx;
+        } else if (chr == '.') {
+            arch_delim = idx;
+        } else if (chr == ':') {
             // ':' can be only once in nevra
-            if (epoch_delim != nullptr) {
-                throw NevraIncorrectInputError(M_("NEVRA string \"{}\" contains ':' multiple times"), nevra_str);
+            if (epoch_delim != std::string_view::npos) {
+                throw NevraIncorrectInputError(
+                    M_("NEVRA string \"{}\" contains ':' multiple times"), std::string(nevra_str));
             }
-            epoch_delim = end;
-        } else if (*end == '(' || *end == '/' || *end == '=' || *end == '<' || *end == '>' || *end == ' ') {
-            throw NevraIncorrectInputError(M_("Invalid character '{}' in NEVRA string \"{}\""), *end, nevra_str);
+            epoch_delim = idx;
+        } else if (chr == '(' || chr == '/' || chr == '=' || chr == '<' || chr == '>' || chr == ' ') {
+            throw NevraIncorrectInputError(
+                M_("Invalid character '{}' in NEVRA string \"{}\""), chr, std::string(nevra_str));
         }
     }
-    for (auto form : forms) {
-        Nevra nevra;
-        switch (form) {
-            case Form::NEVRA: {
-                if (before_last_delim == nullptr || last_delim == nullptr || arch_delim == nullptr) {
-                    continue;
-                }
-
-                // test name presence
-                if (before_last_delim == nevra_pattern) {
-                    continue;
-                }
-
-                const char * evr_delim_for_nevra = before_last_delim;
-                const char * release_delim_for_nevra = last_delim;
-                const char * arch_delim_for_nevra = arch_delim;
-
-                nevra.name.assign(nevra_pattern, evr_delim_for_nevra);
-                ++evr_delim_for_nevra;
-
-                // test presence of epoch (optional)
-                if (epoch_delim != nullptr) {
-                    // test that ':' was in range of evr. ':' sign is only allowed in evr as an epoch deliminator
-                    if (epoch_delim - evr_delim_for_nevra < 1 || release_delim_for_nevra - epoch_delim < 2) {
-                        continue;
-                    }
-                    nevra.epoch.assign(evr_delim_for_nevra, epoch_delim);
-                    evr_delim_for_nevra = epoch_delim + 1;
-                }
-
-                // test presence of version
-                if (release_delim_for_nevra - evr_delim_for_nevra < 1) {
-                    continue;
-                }
-                nevra.version.assign(evr_delim_for_nevra, release_delim_for_nevra);
-                ++release_delim_for_nevra;
-
-                // test presence of release
-                if (arch_delim_for_nevra - release_delim_for_nevra < 1) {
-                    continue;
-                }
-                nevra.release.assign(release_delim_for_nevra, arch_delim_for_nevra);
-                ++arch_delim_for_nevra;
-
-                // test presence of arch
-                if (end - arch_delim_for_nevra < 1) {
-                    continue;
-                }
-                nevra.arch.assign(arch_delim_for_nevra);
-
-                result.push_back(std::move(nevra));
-            } break;
-            case Form::NEVR: {
-                if (before_last_delim == nullptr || last_delim == nullptr) {
-                    continue;
-                }
-
-                // test name presence
-                if (before_last_delim == nevra_pattern) {
-                    continue;
-                }
-
-                const char * evr_delim_for_nevr = before_last_delim;
-                const char * release_delim_for_nevr = last_delim;
-
-                nevra.name.assign(nevra_pattern, evr_delim_for_nevr);
-                ++evr_delim_for_nevr;
-
-                // test presence of epoch (optional)
-                if (epoch_delim != nullptr) {
-                    // test that ':' was in range of evr. ':' sign is only allowed in evr as an epoch deliminator
-                    if (epoch_delim - evr_delim_for_nevr < 1 || release_delim_for_nevr - epoch_delim < 2) {
-                        continue;
-                    }
-                    nevra.epoch.assign(evr_delim_for_nevr, epoch_delim);
-                    evr_delim_for_nevr = epoch_delim + 1;
-                }
-
-                // test presence of version
-                if (release_delim_for_nevr - evr_delim_for_nevr < 1) {
-                    continue;
-                }
-                nevra.version.assign(evr_delim_for_nevr, release_delim_for_nevr);
-                ++release_delim_for_nevr;
-
-                // test presence of release
-                if (end - release_delim_for_nevr < 1) {
-                    continue;
-                }
-                nevra.release.assign(release_delim_for_nevr);
-
-                result.push_back(std::move(nevra));
-            } break;
-            case Form::NEV: {
-                if (last_delim == nullptr) {
-                    continue;
-                }
-
-                // test name presence
-                if (before_last_delim == nevra_pattern) {
-                    continue;
-                }
-
-                const char * evr_delim_for_nev = last_delim;
-
-                nevra.name.assign(nevra_pattern, evr_delim_for_nev);
-                ++evr_delim_for_nev;
-
-                // test presence of epoch (optional)
-                if (epoch_delim != nullptr) {
-                    // test that ':' was in range of evr. ':' sign is only allowed in evr as an epoch deliminator
-                    if (epoch_delim - evr_delim_for_nev < 1 || end - epoch_delim < 2) {
-                        continue;
-                    }
-                    nevra.epoch.assign(evr_delim_for_nev, epoch_delim);
-                    evr_delim_for_nev = epoch_delim + 1;
-                }
-
-                // test presence of version
-                if (end - evr_delim_for_nev < 1) {
-                    continue;
-                }
-                nevra.version.assign(evr_delim_for_nev);
-
-                result.push_back(std::move(nevra));
-            } break;
-            case Form::NA: {
-                if (arch_delim == nullptr) {
-                    continue;
-                }
-                // test: NA cannot contain ':'
-                if (epoch_delim != nullptr) {
-                    continue;
-                }
-
-                // test name presence
-                if (arch_delim == nevra_pattern) {
-                    continue;
-                }
-
-                // test arch for absence of '-'
-                if (last_delim != nullptr && last_delim > arch_delim) {
-                    continue;
-                }
-
-                // test arch presence
-                if (end - arch_delim == 1) {
-                    continue;
-                }
-
-                nevra.name.assign(nevra_pattern, arch_delim);
-                nevra.arch.assign(arch_delim + 1);
-
-                result.push_back(std::move(nevra));
-            } break;
-            case Form::NAME:
-                // test: Name cannot contain ':'
-                if (epoch_delim != nullptr) {
-                    continue;
-                }
-
-                // test name presence
-                if (end == nevra_pattern) {
-                    continue;
-                }
-
-                nevra.name.assign(nevra_pattern);
-
-                result.push_back(std::move(nevra));
-                break;
+}
+
+
+bool NevraParser::parse(Nevra::Form form, NevraView & result) const noexcept {
+    constexpr auto npos = std::string_view::npos;
+    const std::size_t end = nevra_str.size();
+    // signed distance between the positions, the delimiters are not ordered
+    auto distance = [](std::size_t from, std::size_t to) {
+        return static_cast<std::ptrdiff_t>(to) - static_cast<std::ptrdiff_t>(from);
+    };
+    auto part = [this](std::size_t from, std::size_t to) { return nevra_str.substr(from, to - from); };
+
+    // Splits the optional epoch and the version ending at `version_end`, moves `evr_start` past the epoch
+    auto split_epoch_version = [&](NevraView & nevra, std::size_t & evr_start, std::size_t version_end) {
+        // test presence of epoch (optional)
+        if (epoch_delim != npos) {
+            // test that ':' was in range of evr. ':' sign is only allowed in evr as an epoch deliminator
+            if (distance(evr_start, epoch_delim) < 1 || distance(epoch_delim, version_end) < 2) {
+                return false;
+            }
+            nevra.epoch = part(evr_start, epoch_delim);
+            evr_start = epoch_delim + 1;
         }
+
+        // test presence of version
+        if (distance(evr_start, version_end) < 1) {
+            return false;
+        }
+        nevra.version = part(evr_start, version_end);
+        return true;
+    };
+
+    NevraView nevra;
+    bool matches = false;
+    switch (form) {
+        case Nevra::Form::NEVRA: {
+            // test name presence
+            if (before_last_delim == npos || last_delim == npos || arch_delim == npos || before_last_delim == 0) {
+                break;
+            }
+            nevra.name = part(0, before_last_delim);
+
+            std::size_t evr_start = before_last_delim + 1;
+            if (!split_epoch_version(nevra, evr_start, last_delim)) {
+                break;
+            }
+
+            // test presence of release
+            if (distance(last_delim + 1, arch_delim) < 1) {
+                break;
+            }
+            nevra.release = part(last_delim + 1, arch_delim);
+
+            // test presence of arch
+            if (distance(arch_delim + 1, end) < 1) {
+                break;
+            }
+            nevra.arch = part(arch_delim + 1, end);
+            matches = true;
+        } break;
+        case Nevra::Form::NEVR: {
+            // test name presence
+            if (before_last_delim == npos || last_delim == npos || before_last_delim == 0) {
+                break;
+            }
+            nevra.name = part(0, before_last_delim);
+
+            std::size_t evr_start = before_last_delim + 1;
+            if (!split_epoch_version(nevra, evr_start, last_delim)) {
+                break;
+            }
+
+            // test presence of release
+            if (distance(last_delim + 1, end) < 1) {
+                break;
+            }
+            nevra.release = part(last_delim + 1, end);
+            matches = true;
+        } break;
+        case Nevra::Form::NEV: {
+            // test name presence
+            if (last_delim == npos || before_last_delim == 0) {
+                break;
+            }
+            nevra.name = part(0, last_delim);
+
+            std::size_t evr_start = last_delim + 1;
+            matches = split_epoch_version(nevra, evr_start, end);
+        } break;
+        case Nevra::Form::NA: {
+            // test: NA cannot contain ':', test name presence
+            if (arch_delim == npos || epoch_delim != npos || arch_delim == 0) {
+                break;
+            }
+
+            // test arch for absence of '-'
+            if (last_delim != npos && last_delim > arch_delim) {
+                break;
+            }
+
+            // test arch presence
+            if (end - arch_delim == 1) {
+                break;
+            }
+
+            nevra.name = part(0, arch_delim);
+            nevra.arch = part(arch_delim + 1, end);
+            matches = true;
+        } break;
+        case Nevra::Form::NAME:
+            // test: Name cannot contain ':', test name presence
+            if (epoch_delim != npos || end == 0) {
+                break;
+            }
+            nevra.name = nevra_str;
+            matches = true;
+            break;
     }
-    return result;
+
+    result = matches ? nevra : NevraView();
+    return matches;
 }
 
 
@@ -23,6 +23,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "base/base_impl.hpp"
 #include "package_sack_impl.hpp"
 #include "reldep_list_impl.hpp"
+#include "repo/checksum_verifier.hpp"
+#include "repo/download_manifest.hpp"
+#include "repo/solv_repo.hpp"
+#include "rpm_log_guard.hpp"
 #include "solv/pool.hpp"
 #include "utils/on_scope_exit.hpp"
 #include "utils/string.hpp"
@@ -31,31 +35,24 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/rpm/package_query.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
-#include <fcntl.h>
-#include <librepo/checksum.h>
 #include <librepo/util.h>
-#include <unistd.h>
+#include <rpm/header.h>
+#include <rpm/rpmdb.h>
+#include <rpm/rpmtd.h>
+#include <rpm/rpmts.h>
 
 #include <filesystem>
 
 
-static inline void reldeps_for(Solvable * solvable, libdnf5::solv::IdQueue & queue, Id type) {
-    Id marker = -1;
-    Id solv_type = type;
+namespace libdnf5::rpm {
 
-    if (type == SOLVABLE_REQUIRES) {
-        marker = -1;
-    }
+namespace {
 
-    if (type == SOLVABLE_PREREQMARKER) {
-        solv_type = SOLVABLE_REQUIRES;
-        marker = 1;
-    }
-    solvable_lookup_deparray(solvable, solv_type, &queue.get_queue(), marker);
+std::string_view c_to_str_view(const char * c_str) {
+    return c_str ? std::string_view(c_str) : std::string_view();
 }
 
-
-namespace libdnf5::rpm {
+}  // namespace
 
 std::string Package::get_name() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).get_name(id.id));
@@ -86,16 +83,44 @@ std::string Package::get_nevra() const {
 }
 
 std::string Package::get_full_nevra() const {
-    return get_rpm_pool(base).get_full_nevra(id.id);
+    return std::string(get_rpm_pool(base).get_cached_full_nevra(id.id));
 }
 
 std::string Package::get_na() const {
-    std::string res = get_name();
+    auto name = get_name_view();
+    auto arch = get_arch_view();
+    std::string res;
+    res.reserve(name.size() + 1 + arch.size());
+    res.append(name);
     res.append(".");
-    res.append(get_arch());
+    res.append(arch);
     return res;
 }
 
+std::string_view Package::get_name_view() const {
+    return get_rpm_pool(base).get_name(id.id);
+}
+
+std::string_view Package::get_epoch_view() const {
+    return libdnf5::solv::split_evr_view(get_evr_view()).e_def();
+}
+
+std::string_view Package::get_version_view() const {
+    return libdnf5::solv::split_evr_view(get_evr_view()).v;
+}
+
+std::string_view Package::get_release_view() const {
+    return libdnf5::solv::split_evr_view(get_evr_view()).r;
+}
+
+std::string_view Package::get_arch_view() const {
+    return get_rpm_pool(base).get_arch(id.id);
+}
+
+std::string_view Package::get_evr_view() const {
+    return get_rpm_pool(base).get_evr(id.id);
+}
+
 std::string Package::get_group() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_GROUP));
 }
@@ -114,7 +139,7 @@ std::string Package::get_license() const {
 
 std::string Package::get_source_name() const {
     const char * source_name = get_rpm_pool(base).lookup_str(id.id, SOLVABLE_SOURCENAME);
-    return source_name ? source_name : get_name();
+    return std::string(source_name ? source_name : get_name_view());
 }
 
 std::string Package::get_sourcerpm() const {
@@ -130,11 +155,11 @@ std::string Package::get_debuginfo_name_of_source() const {
 }
 
 std::string Package::get_debuginfo_name() const {
-    if (libdnf5::utils::string::ends_with(get_name(), DEBUGINFO_SUFFIX)) {
-        return get_name();
+    auto name = get_name();
+    if (libdnf5::utils::string::ends_with(name, DEBUGINFO_SUFFIX)) {
+        return name;
     }
 
-    auto name = get_name();
     if (libdnf5::utils::string::ends_with(name, DEBUGSOURCE_SUFFIX)) {
         name.resize(name.size() - strlen(DEBUGSOURCE_SUFFIX));
     }
@@ -154,46 +179,118 @@ std::string Package::get_packager() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_PACKAGER));
 }
 
+std::string_view Package::get_packager_view() const {
+    return c_to_str_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_PACKAGER));
+}
+
 std::string Package::get_vendor() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_VENDOR));
 }
 
+std::string_view Package::get_vendor_view() const {
+    return c_to_str_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_VENDOR));
+}
+
 std::string Package::get_url() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_URL));
 }
 
+std::string_view Package::get_url_view() const {
+    return c_to_str_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_URL));
+}
+
 std::string Package::get_summary() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_SUMMARY));
 }
 
+std::string_view Package::get_summary_view() const {
+    return c_to_str_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_SUMMARY));
+}
+
 std::string Package::get_description() const {
     return libdnf5::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_DESCRIPTION));
 }
 
+std::string_view Package::get_description_view() const {
+    return c_to_str_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_DESCRIPTION));
+}
+
 std::vector<std::string> Package::get_files() const {
+    std::vector<std::string> ret;
+    for_each_file([&ret](std::string_view path) { ret.emplace_back(path); });
+    return ret;
+}
+
+void Package::for_each_file(const std::function<void(std::string_view path)> & callback) const {
     auto & pool = get_rpm_pool(base);
 
     Solvable * solvable = pool.id2solvable(id.id);
     libdnf5::solv::get_repo(solvable).internalize();
 
-    std::vector<std::string> ret;
-
     Dataiterator di;
     dataiterator_init(
         &di, *pool, solvable->repo, id.id, SOLVABLE_FILELIST, nullptr, SEARCH_FILES | SEARCH_COMPLETE_FILELIST);
+    utils::OnScopeExit free_di([&di]() noexcept { dataiterator_free(&di); });
     while (dataiterator_step(&di) != 0) {
-        ret.emplace_back(di.kv.str);
+        callback(di.kv.str);
     }
-    dataiterator_free(&di);
+}
 
-    return ret;
+// Reads the changelogs of the installed package `rpmdbid` directly from its header in the installroot rpmdb.
+static std::vector<libdnf5::rpm::Changelog> read_changelogs_from_rpmdb(const BaseWeakPtr & base, unsigned int rpmdbid) {
+    std::vector<libdnf5::rpm::Changelog> changelogs;
+
+    libdnf5::rpm::RpmLogGuard rpm_log_guard(base);
+
+    auto ts = rpmtsCreate();
+    utils::OnScopeExit free_ts([ts]() noexcept { rpmtsFree(ts); });
+    rpmtsSetRootDir(ts, base->get_config().get_installroot_option().get_value().c_str());
+
+    auto iter = rpmtsInitIterator(ts, RPMDBI_PACKAGES, &rpmdbid, sizeof(rpmdbid));
+    if (!iter) {
+        return changelogs;
+    }
+    utils::OnScopeExit free_iter([iter]() noexcept { rpmdbFreeIterator(iter); });
+
+    // the header is owned by the iterator
+    Header hdr = rpmdbNextIterator(iter);
+    if (!hdr) {
+        return changelogs;
+    }
+
+    auto times = rpmtdNew();
+    auto names = rpmtdNew();
+    auto texts = rpmtdNew();
+    utils::OnScopeExit free_tds([times, names, texts]() noexcept {
+        rpmtdFree(times);
+        rpmtdFree(names);
+        rpmtdFree(texts);
+    });
+
+    if (headerGet(hdr, RPMTAG_CHANGELOGTIME, times, HEADERGET_MINMEM) &&
+        headerGet(hdr, RPMTAG_CHANGELOGNAME, names, HEADERGET_MINMEM) &&
+        headerGet(hdr, RPMTAG_CHANGELOGTEXT, texts, HEADERGET_MINMEM)) {
+        while (const uint32_t * timestamp = rpmtdNextUint32(times)) {
+            const char * author = rpmtdNextString(names);
+            const char * text = rpmtdNextString(texts);
+            changelogs.emplace_back(static_cast<time_t>(*timestamp), author ? author : "", text ? text : "");
+        }
+    }
+
+    return changelogs;
 }
 
 std::vector<libdnf5::rpm::Changelog> Package::get_changelogs() const {
     std::vector<libdnf5::rpm::Changelog> changelogs;
     auto & pool = get_rpm_pool(base);
     Solvable * solvable = pool.id2solvable(id.id);
-    libdnf5::solv::get_repo(solvable).internalize();
+    auto & repo = libdnf5::solv::get_repo(solvable);
+
+    if (repo.solv_repo->has_lazy_changelogs(id.id)) {
+        return read_changelogs_from_rpmdb(base, static_cast<unsigned int>(get_rpmdbid()));
+    }
+
+    repo.internalize();
 
     Dataiterator di;
     dataiterator_init(&di, *pool, solvable->repo, id.id, SOLVABLE_CHANGELOG, nullptr, 0);
@@ -220,7 +317,7 @@ ReldepList Package::get_requires() const {
     ReldepList list(base);
     reldeps_for(solvable, list.p_impl->queue, SOLVABLE_REQUIRES);
 
-    libdnf5::solv::IdQueue tmp_queue;
+    libdnf5::solv::InlineIdQueue<16> tmp_queue;
     reldeps_for(solvable, tmp_queue, SOLVABLE_PREREQMARKER);
     list.p_impl->queue += tmp_queue;
 
@@ -380,23 +477,19 @@ bool Package::is_available_locally() const {
 }
 
 bool Package::is_cached() const {
-    gboolean cached{FALSE};
-    if (auto fd = ::open(get_package_path().c_str(), O_RDONLY); fd != -1) {
-        utils::OnScopeExit close_fd([fd]() noexcept { ::close(fd); });
-        auto length = static_cast<unsigned long long>(lseek(fd, 0, SEEK_END));
-        if (length == get_download_size()) {
-            lseek(fd, 0, SEEK_SET);
-            auto checksum = get_checksum();
-            lr_checksum_fd_cmp(
-                static_cast<LrChecksumType>(checksum.get_type()),
-                fd,
-                checksum.get_checksum().c_str(),
-                FALSE,
-                &cached,
-                NULL);
-        }
+    // A file verified earlier, also by a previous run, is not read again while it is not changed
+    auto path = get_package_path();
+    auto checksum = get_checksum();
+    auto checksum_id = repo::DownloadManifest::get_checksum_id(checksum);
+    auto & manifest = InternalBaseUser::get_download_manifest(base);
+    if (manifest.is_verified(path, checksum_id, get_download_size())) {
+        return true;
+    }
+    if (!repo::verify_file_checksum(path, checksum.get_type(), checksum.get_checksum(), get_download_size())) {
+        return false;
     }
-    return cached;
+    manifest.set_verified(path, checksum_id, get_download_size());
+    return true;
 }
 
 bool Package::is_installed() const {
@@ -0,0 +1,273 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/rpm/package_columns.hpp"
+
+#include "package_set_impl.hpp"
+#include "reldep_list_impl.hpp"
+#include "solv/pool.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/rpm/package_set.hpp"
+
+#include <map>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+enum class AttributeKind { STRING, NUMBER, RELDEP };
+
+AttributeKind get_attribute_kind(PackageAttribute attribute) {
+    switch (attribute) {
+        case PackageAttribute::DOWNLOAD_SIZE:
+        case PackageAttribute::INSTALL_SIZE:
+        case PackageAttribute::BUILD_TIME:
+            return AttributeKind::NUMBER;
+        case PackageAttribute::PROVIDES:
+        case PackageAttribute::REQUIRES:
+        case PackageAttribute::REQUIRES_PRE:
+        case PackageAttribute::CONFLICTS:
+        case PackageAttribute::OBSOLETES:
+        case PackageAttribute::RECOMMENDS:
+        case PackageAttribute::SUGGESTS:
+        case PackageAttribute::ENHANCES:
+        case PackageAttribute::SUPPLEMENTS:
+            return AttributeKind::RELDEP;
+        default:
+            return AttributeKind::STRING;
+    }
+}
+
+Id get_attribute_keyname(PackageAttribute attribute) {
+    switch (attribute) {
+        case PackageAttribute::SUMMARY:
+            return SOLVABLE_SUMMARY;
+        case PackageAttribute::DESCRIPTION:
+            return SOLVABLE_DESCRIPTION;
+        case PackageAttribute::URL:
+            return SOLVABLE_URL;
+        case PackageAttribute::LICENSE:
+            return SOLVABLE_LICENSE;
+        case PackageAttribute::PACKAGER:
+            return SOLVABLE_PACKAGER;
+        case PackageAttribute::VENDOR:
+            return SOLVABLE_VENDOR;
+        case PackageAttribute::DOWNLOAD_SIZE:
+            return SOLVABLE_DOWNLOADSIZE;
+        case PackageAttribute::INSTALL_SIZE:
+            return SOLVABLE_INSTALLSIZE;
+        case PackageAttribute::BUILD_TIME:
+            return SOLVABLE_BUILDTIME;
+        case PackageAttribute::PROVIDES:
+            return SOLVABLE_PROVIDES;
+        case PackageAttribute::REQUIRES:
+            return SOLVABLE_REQUIRES;
+        case PackageAttribute::REQUIRES_PRE:
+            return SOLVABLE_PREREQMARKER;
+        case PackageAttribute::CONFLICTS:
+            return SOLVABLE_CONFLICTS;
+        case PackageAttribute::OBSOLETES:
+            return SOLVABLE_OBSOLETES;
+        case PackageAttribute::RECOMMENDS:
+            return SOLVABLE_RECOMMENDS;
+        case PackageAttribute::SUGGESTS:
+            return SOLVABLE_SUGGESTS;
+        case PackageAttribute::ENHANCES:
+            return SOLVABLE_ENHANCES;
+        case PackageAttribute::SUPPLEMENTS:
+            return SOLVABLE_SUPPLEMENTS;
+        default:
+            return 0;
+    }
+}
+
+}  // namespace
+
+
+class PackageColumns::Impl {
+public:
+    struct ReldepColumn {
+        std::vector<ReldepId> reldeps;
+        std::vector<std::size_t> offsets;
+    };
+
+    std::vector<PackageId> ids;
+    std::map<PackageAttribute, std::vector<std::string_view>> strings;
+    std::map<PackageAttribute, std::vector<unsigned long long>> numbers;
+    std::map<PackageAttribute, ReldepColumn> reldeps;
+};
+
+
+PackageColumns::PackageColumns() : p_impl(new Impl()) {}
+
+PackageColumns::PackageColumns(const PackageColumns & src) : p_impl(new Impl(*src.p_impl)) {}
+
+PackageColumns::PackageColumns(PackageColumns && src) noexcept = default;
+
+PackageColumns::~PackageColumns() = default;
+
+PackageColumns & PackageColumns::operator=(const PackageColumns & src) {
+    *p_impl = *src.p_impl;
+    return *this;
+}
+
+PackageColumns & PackageColumns::operator=(PackageColumns && src) noexcept = default;
+
+std::size_t PackageColumns::size() const noexcept {
+    return p_impl->ids.size();
+}
+
+const std::vector<PackageId> & PackageColumns::get_ids() const noexcept {
+    return p_impl->ids;
+}
+
+const std::vector<std::string_view> & PackageColumns::get_strings(PackageAttribute attribute) const {
+    auto it = p_impl->strings.find(attribute);
+    libdnf_user_assert(
+        it != p_impl->strings.end(), "String attribute {} was not extracted", static_cast<int>(attribute));
+    return it->second;
+}
+
+const std::vector<unsigned long long> & PackageColumns::get_numbers(PackageAttribute attribute) const {
+    auto it = p_impl->numbers.find(attribute);
+    libdnf_user_assert(
+        it != p_impl->numbers.end(), "Numeric attribute {} was not extracted", static_cast<int>(attribute));
+    return it->second;
+}
+
+const std::vector<ReldepId> & PackageColumns::get_reldeps(PackageAttribute attribute) const {
+    auto it = p_impl->reldeps.find(attribute);
+    libdnf_user_assert(
+        it != p_impl->reldeps.end(), "Reldep attribute {} was not extracted", static_cast<int>(attribute));
+    return it->second.reldeps;
+}
+
+const std::vector<std::size_t> & PackageColumns::get_reldep_offsets(PackageAttribute attribute) const {
+    auto it = p_impl->reldeps.find(attribute);
+    libdnf_user_assert(
+        it != p_impl->reldeps.end(), "Reldep attribute {} was not extracted", static_cast<int>(attribute));
+    return it->second.offsets;
+}
+
+
+PackageColumns PackageSet::get_columns(const std::vector<PackageAttribute> & attributes) const {
+    auto & pool = get_rpm_pool(p_impl->base);
+    PackageColumns columns;
+    auto & ids = columns.p_impl->ids;
+    ids.reserve(size());
+
+    // The repositories are internalized once, the columns then read the solvables directly
+    const ::Repo * last_repo = nullptr;
+    for (Id id : *p_impl) {
+        ids.emplace_back(id);
+        Solvable * solvable = pool.id2solvable(id);
+        if (solvable->repo != last_repo) {
+            last_repo = solvable->repo;
+            pool.internalize_repo(id);
+        }
+    }
+
+    // Fills a column with the values returned by `get_value(solvable)`
+    auto fill = [&pool, &ids](auto & column, auto get_value) {
+        column.clear();
+        column.reserve(ids.size());
+        for (auto id : ids) {
+            column.push_back(get_value(pool.id2solvable(id.id)));
+        }
+    };
+    auto c_to_str_view = [](const char * str) { return std::string_view(str ? str : ""); };
+
+    libdnf5::solv::IdQueue queue;
+    for (auto attribute : attributes) {
+        const Id keyname = get_attribute_keyname(attribute);
+        switch (get_attribute_kind(attribute)) {
+            case AttributeKind::STRING: {
+                auto & column = columns.p_impl->strings[attribute];
+                switch (attribute) {
+                    case PackageAttribute::NAME:
+                        fill(column, [&pool](Solvable * solvable) { return pool.id2str(solvable->name); });
+                        break;
+                    case PackageAttribute::EPOCH:
+                        fill(column, [&pool](Solvable * solvable) {
+                            return libdnf5::solv::split_evr_view(pool.id2str(solvable->evr)).e_def();
+                        });
+                        break;
+                    case PackageAttribute::VERSION:
+                        fill(column, [&pool](Solvable * solvable) {
+                            return libdnf5::solv::split_evr_view(pool.id2str(solvable->evr)).v;
+                        });
+                        break;
+                    case PackageAttribute::RELEASE:
+                        fill(column, [&pool](Solvable * solvable) {
+                            return libdnf5::solv::split_evr_view(pool.id2str(solvable->evr)).r;
+                        });
+                        break;
+                    case PackageAttribute::ARCH:
+                        fill(column, [&pool](Solvable * solvable) { return pool.id2str(solvable->arch); });
+                        break;
+                    case PackageAttribute::EVR:
+                        fill(column, [&pool](Solvable * solvable) { return pool.id2str(solvable->evr); });
+                        break;
+                    case PackageAttribute::REPO_ID:
+                        // the libsolv repositories are named by the repository ids
+                        fill(column, [](Solvable * solvable) { return solvable->repo->name; });
+                        break;
+                    default:
+                        fill(column, [keyname, &c_to_str_view](Solvable * solvable) {
+                            return c_to_str_view(solvable_lookup_str(solvable, keyname));
+                        });
+                }
+            } break;
+            case AttributeKind::NUMBER:
+                fill(columns.p_impl->numbers[attribute], [keyname](Solvable * solvable) {
+                    return solvable_lookup_num(solvable, keyname, 0);
+                });
+                break;
+            case AttributeKind::RELDEP: {
+                auto & column = columns.p_impl->reldeps[attribute];
+                column.reldeps.clear();
+                column.offsets.clear();
+                column.offsets.reserve(ids.size() + 1);
+                column.offsets.push_back(0);
+                auto append = [&column](const libdnf5::solv::IdQueue & reldeps) {
+                    for (Id reldep_id : reldeps) {
+                        column.reldeps.emplace_back(reldep_id);
+                    }
+                };
+                for (auto id : ids) {
+                    Solvable * solvable = pool.id2solvable(id.id);
+                    reldeps_for(solvable, queue, keyname);
+                    append(queue);
+                    if (attribute == PackageAttribute::REQUIRES) {
+                        reldeps_for(solvable, queue, SOLVABLE_PREREQMARKER);
+                        append(queue);
+                    }
+                    column.offsets.push_back(column.reldeps.size());
+                }
+            } break;
+        }
+    }
+
+    return columns;
+}
+
+}  // namespace libdnf5::rpm
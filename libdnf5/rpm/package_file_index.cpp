@@ -0,0 +1,80 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_file_index.hpp"
+
+extern "C" {
+#include <solv/dataiterator.h>
+#include <solv/knownid.h>
+}
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <string_view>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+std::size_t path_hash(std::string_view path, std::string & buffer) {
+    buffer.assign(path);
+    std::transform(buffer.begin(), buffer.end(), buffer.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return std::hash<std::string>{}(buffer);
+}
+
+}  // namespace
+
+
+PackageFileIndex::PackageFileIndex(libdnf5::solv::Pool & pool, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()) {
+    std::string buffer;
+    Dataiterator di;
+    // A single iterator over all solvables, instead of one per solvable
+    dataiterator_init(&di, *pool, nullptr, 0, SOLVABLE_FILELIST, nullptr, SEARCH_FILES | SEARCH_COMPLETE_FILELIST);
+    while (dataiterator_step(&di) != 0) {
+        if (package_solvables.contains(di.solvid)) {
+            entries.emplace_back(path_hash(di.kv.str, buffer), di.solvid);
+        }
+    }
+    dataiterator_free(&di);
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    entries.shrink_to_fit();
+}
+
+
+libdnf5::solv::SolvMap PackageFileIndex::shortlist(
+    const std::string & path, const libdnf5::solv::SolvMap & candidates) const {
+    std::string buffer;
+    auto hash = path_hash(path, buffer);
+    libdnf5::solv::SolvMap result(nsolvables);
+    auto low = std::lower_bound(entries.begin(), entries.end(), std::make_pair(hash, Id{0}));
+    for (; low != entries.end() && low->first == hash; ++low) {
+        if (candidates.contains(low->second)) {
+            result.add_unsafe(low->second);
+        }
+    }
+    return result;
+}
+
+}  // namespace libdnf5::rpm
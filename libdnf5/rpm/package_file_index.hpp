@@ -0,0 +1,60 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_FILE_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_FILE_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Index of the file paths in the filelists of package solvables. It keeps the solvables sorted by a hash
+/// of the lowercased path, so the packages that may contain a path are found by binary search.
+/// The found packages still have to be matched against the path, because of hash collisions and case.
+class PackageFileIndex {
+public:
+    /// Builds the index of the filelists of the `package_solvables`.
+    /// Filelists that are not loaded yet (stub repodata) are loaded.
+    PackageFileIndex(libdnf5::solv::Pool & pool, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Returns the subset of `candidates` that may contain the file `path` (compared case-insensitively).
+    libdnf5::solv::SolvMap shortlist(const std::string & path, const libdnf5::solv::SolvMap & candidates) const;
+
+    /// Returns the number of solvables in the pool at the time the index was built.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept { return entries.capacity() * sizeof(entries[0]); }
+
+private:
+    int nsolvables;
+    /// Sorted pairs of <hash of lowercased path, solvable>
+    std::vector<std::pair<std::size_t, Id>> entries;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_FILE_INDEX_HPP
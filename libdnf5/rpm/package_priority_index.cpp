@@ -0,0 +1,132 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_priority_index.hpp"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+
+namespace libdnf5::rpm {
+
+PackagePriorityIndex::PackagePriorityIndex(
+    const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()),
+      installed_repo(pool->installed),
+      repo_priorities(read_repo_priorities(pool)),
+      top(nsolvables),
+      group_of(static_cast<std::size_t>(nsolvables), NO_GROUP) {
+    std::vector<Solvable *> sorted;
+    for (Id solvable_id : package_solvables) {
+        Solvable * solvable = pool.id2solvable(solvable_id);
+        if (!pool.is_installed(solvable)) {
+            sorted.push_back(solvable);
+        }
+    }
+    // Sort by name, arch and descending priority
+    std::sort(sorted.begin(), sorted.end(), [](const Solvable * first, const Solvable * second) {
+        return std::make_tuple(first->name, first->arch, -first->repo->priority) <
+               std::make_tuple(second->name, second->arch, -second->repo->priority);
+    });
+
+    group_members.reserve(sorted.size());
+    Id name = 0;
+    Id arch = 0;
+    int priority = 0;
+    for (Solvable * solvable : sorted) {
+        if (group_offsets.empty() || solvable->name != name || solvable->arch != arch) {
+            name = solvable->name;
+            arch = solvable->arch;
+            priority = solvable->repo->priority;
+            group_offsets.push_back(group_members.size());
+        }
+        Id solvable_id = pool.solvable2id(solvable);
+        if (solvable->repo->priority == priority) {
+            top.add_unsafe(solvable_id);
+        }
+        group_of[static_cast<std::size_t>(solvable_id)] = static_cast<std::uint32_t>(group_offsets.size() - 1);
+        group_members.push_back(solvable_id);
+    }
+    group_offsets.push_back(group_members.size());
+}
+
+
+void PackagePriorityIndex::filter(const libdnf5::solv::RpmPool & pool, libdnf5::solv::SolvMap & candidates) const {
+    // The candidates from the top repos stay, the installed ones too
+    libdnf5::solv::SolvMap rest(candidates);
+    rest -= top;
+
+    // Highest priority among the candidates of the groups seen in `rest`
+    std::map<std::uint32_t, int> best_priorities;
+    for (Id candidate_id : rest) {
+        auto group = group_of[static_cast<std::size_t>(candidate_id)];
+        if (group == NO_GROUP) {
+            continue;
+        }
+        auto [it, inserted] = best_priorities.try_emplace(group, 0);
+        if (inserted) {
+            // The members are sorted by descending priority, the first one among the candidates is the best
+            for (auto idx = group_offsets[group]; idx < group_offsets[group + 1]; ++idx) {
+                if (candidates.contains_unsafe(group_members[idx])) {
+                    it->second = pool.id2solvable(group_members[idx])->repo->priority;
+                    break;
+                }
+            }
+        }
+        if (pool.id2solvable(candidate_id)->repo->priority != it->second) {
+            candidates.remove_unsafe(candidate_id);
+        }
+    }
+}
+
+
+bool PackagePriorityIndex::is_valid(const libdnf5::solv::RpmPool & pool) const noexcept {
+    if (nsolvables != pool.get_nsolvables() || installed_repo != pool->installed ||
+        repo_priorities.size() != static_cast<std::size_t>(pool->nrepos)) {
+        return false;
+    }
+    for (int repo_id = 1; repo_id < pool->nrepos; ++repo_id) {
+        const ::Repo * repo = pool->repos[repo_id];
+        if (repo_priorities[static_cast<std::size_t>(repo_id)] != (repo ? repo->priority : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+std::vector<int> PackagePriorityIndex::read_repo_priorities(const libdnf5::solv::RpmPool & pool) {
+    std::vector<int> priorities(static_cast<std::size_t>(pool->nrepos), 0);
+    for (int repo_id = 1; repo_id < pool->nrepos; ++repo_id) {
+        if (const ::Repo * repo = pool->repos[repo_id]) {
+            priorities[static_cast<std::size_t>(repo_id)] = repo->priority;
+        }
+    }
+    return priorities;
+}
+
+
+std::size_t PackagePriorityIndex::get_memory_usage() const noexcept {
+    return top.get_memory_usage() + repo_priorities.capacity() * sizeof(int) +
+           group_of.capacity() * sizeof(std::uint32_t) + group_offsets.capacity() * sizeof(std::size_t) +
+           group_members.capacity() * sizeof(Id);
+}
+
+}  // namespace libdnf5::rpm
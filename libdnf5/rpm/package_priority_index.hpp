@@ -0,0 +1,77 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_PRIORITY_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_PRIORITY_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Partition of the available package solvables into the groups of the same name and arch used by the priority
+/// filter. The solvables from the repos with the highest priority in their group are precomputed, so the filter
+/// is an intersection with them. Only the candidates outside of them, whose group lost all its highest priority
+/// solvables to earlier filters, have to be compared with the other candidates of the group.
+class PackagePriorityIndex {
+public:
+    /// Builds the index of the `package_solvables`, the installed ones are not a part of any group.
+    PackagePriorityIndex(const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Keeps in `candidates` the installed ones and those from the repos with the highest priority among
+    /// the `candidates` of the same name and arch.
+    void filter(const libdnf5::solv::RpmPool & pool, libdnf5::solv::SolvMap & candidates) const;
+
+    /// Returns whether the index matches the `pool`: the number of solvables, the installed repo
+    /// and the priorities of the repos are the same as when the index was built.
+    bool is_valid(const libdnf5::solv::RpmPool & pool) const noexcept;
+
+    /// Returns the priorities of the repos indexed by the repo ids at the time the index was built.
+    const std::vector<int> & get_repo_priorities() const noexcept { return repo_priorities; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept;
+
+private:
+    static constexpr std::uint32_t NO_GROUP = UINT32_MAX;
+
+    /// Returns the priorities of the repos of the `pool` indexed by the repo ids
+    static std::vector<int> read_repo_priorities(const libdnf5::solv::RpmPool & pool);
+
+    int nsolvables;
+    const ::Repo * installed_repo;
+    std::vector<int> repo_priorities;
+    /// The solvables from the repos with the highest priority in their group
+    libdnf5::solv::SolvMap top;
+    /// For each solvable id the index of its group
+    std::vector<std::uint32_t> group_of;
+    /// The members of group `i` sorted by descending priority are
+    /// `group_members[group_offsets[i]]` ... `group_members[group_offsets[i + 1] - 1]`
+    std::vector<std::size_t> group_offsets;
+    std::vector<Id> group_members;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_PRIORITY_INDEX_HPP
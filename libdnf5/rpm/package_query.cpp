@@ -18,18 +18,24 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "advisory/advisory_package_private.hpp"
+#include "base/base_impl.hpp"
 #include "base/base_private.hpp"
 #include "common/sack/query_cmp_private.hpp"
+#include "dependency_closure.hpp"
 #include "package_query_impl.hpp"
 #include "package_set_impl.hpp"
+#include "solv/concurrent_filter.hpp"
 #include "solv/solver.hpp"
 #include "utils/convert.hpp"
+#include "utils/on_scope_exit.hpp"
 
 #include "libdnf5/advisory/advisory_query.hpp"
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/common/exception.hpp"
 #include "libdnf5/utils/patterns.hpp"
 
+#include <fmt/format.h>
+
 extern "C" {
 #include <solv/evr.h>
 #include <solv/selection.h>
@@ -38,13 +44,52 @@ extern "C" {
 }
 
 #include <fnmatch.h>
+#include <strings.h>
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 namespace libdnf5::rpm {
 
 namespace {
 
+/// Calls `func(begin, end)` for the ranges [begin, end) of the solvable ids of the `repo`. The solvables of a repo
+/// are contiguous unless solvables of another repo were added in between, e.g. the command line packages added
+/// while the repo was loaded. Only the range of such a repo is scanned for the solvables that belong to it.
+template <typename Func>
+void for_each_repo_range(const ::Pool * pool, const ::Repo * repo, Func func) {
+    if (repo->nsolvables == 0) {
+        return;
+    }
+    if (repo->end - repo->start == repo->nsolvables) {
+        func(repo->start, repo->end);
+        return;
+    }
+    Id range_start = repo->start;
+    bool in_range = false;
+    for (Id id = repo->start; id < repo->end; ++id) {
+        bool belongs = pool->solvables[id].repo == repo;
+        if (belongs && !in_range) {
+            range_start = id;
+        } else if (!belongs && in_range) {
+            func(range_start, id);
+        }
+        in_range = belongs;
+    }
+    if (in_range) {
+        func(range_start, repo->end);
+    }
+}
 
 inline bool is_valid_candidate(libdnf5::sack::QueryCmp cmp_type, const char * c_pattern, const char * candidate) {
     switch (cmp_type) {
@@ -123,100 +168,40 @@ inline libdnf5::sack::QueryCmp remove_glob_when_unneeded(
     return cmp_type;
 }
 
-/**
- * Return id of a package that can be upgraded with pkg.
- *
- * The returned package Id fulfills the following criteria:
- * :: it is installed
- * :: has the same name as pkg
- * :: arch of the installed pkg is upgradable to the new pkg. In RPM world that
- *    roughly means: if both packages are colored (contains ELF binaries and was
- *    built with internal dependency generator), they are not upgradable to each
- *    other (i.e. i386 package can not be upgraded to x86_64, neither the other
- *    way round). If one of them is noarch and the other one colored then the
- *    pkg is upgradable (i.e. one can upgrade .noarch to .x86_64 and then again
- *    to a new version that is .noarch)
- * :: is of lower version than pkg.
- * :: if there are multiple packages of that name return the highest version
- *    (implying we won't claim we can upgrade an old package with an already
- *    installed version, e.g kernel).
- *
- * Or 0 if none such package is installed.
- */
-Id what_upgrades(libdnf5::solv::RpmPool & spool, const Solvable * solvable) {
-    ::Pool * pool = *spool;
-    Id l = 0;
-    Id l_evr = 0;
-    Id p;
-    Id pp;
-    const Solvable * updated;
+inline bool name_compare_lower_id(const Solvable * first, Id id_name) {
+    return first->name < id_name;
+}
 
-    libdnf_assert(spool->installed != nullptr, "installed repo has not been set for libsolv pool");
-    libdnf_assert(spool->whatprovides != nullptr, "whatprovides have not been created for libsolv pool");
+inline bool name_compare_icase_lower_id(const std::pair<Id, Solvable *> first, Id id_name) {
+    return first.first < id_name;
+}
 
-    FOR_PROVIDES(p, pp, solvable->name) {
-        updated = spool.id2solvable(p);
-        if (updated->repo != spool->installed || updated->name != solvable->name) {
-            continue;
-        }
-        if (updated->arch != solvable->arch && updated->arch != ARCH_NOARCH && solvable->arch != ARCH_NOARCH) {
-            continue;
-        }
-        if (spool.evrcmp(updated->evr, solvable->evr, EVRCMP_COMPARE) >= 0) {
-            // >= version installed, this pkg can not be used for upgrade
-            return 0;
-        }
-        if (l == 0 || spool.evrcmp(updated->evr, l_evr, EVRCMP_COMPARE) > 0) {
-            l = p;
-            l_evr = updated->evr;
+/// Return true when the spec can be parsed only as the NAME form of NEVRA. Such spec contains no glob characters,
+/// no NEVRA separators and it is neither a file path nor a rich dependency.
+bool is_plain_name_spec(const std::string & pkg_spec) {
+    if (pkg_spec.empty()) {
+        return false;
+    }
+    for (auto ch : pkg_spec) {
+        if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '_' && ch != '+') {
+            return false;
         }
     }
-    return l;
+    return true;
 }
 
-/// Return id of a package that can be upgraded with pkg.
-///
-/// The returned package Id fulfills the following criteria:
-/// :: it is installed
-/// :: has the same name and arch as pkg
-/// :: is of higher version than pkg.
-/// :: if there are multiple such packages return the lowest version (so we won't
-///    claim we can downgrade a package when a lower version is already
-///    installed)
-///
-/// Or 0 if none such package is installed.
-Id what_downgrades(libdnf5::solv::RpmPool & spool, const Solvable * solvable) {
-    ::Pool * pool = *spool;
-    Id l = 0;
-    Id l_evr = 0;
-    Id p;
-    Id pp;
-    Solvable * updated;
-
-    libdnf_assert(spool->installed != nullptr, "installed repo has not been set for libsolv pool");
-    libdnf_assert(spool->whatprovides != nullptr, "whatprovides have not been created for libsolv pool");
-
-    FOR_PROVIDES(p, pp, solvable->name) {
-        updated = spool.id2solvable(p);
-        if (updated->repo != spool->installed || updated->name != solvable->name || updated->arch != solvable->arch)
-            continue;
-        if (spool.evrcmp(updated->evr, solvable->evr, EVRCMP_COMPARE) <= 0)
-            // <= version installed, this pkg can not be used for downgrade
-            return 0;
-        if (l == 0 || spool.evrcmp(updated->evr, l_evr, EVRCMP_COMPARE) < 0) {
-            l = p;
-            l_evr = updated->evr;
+/// Return true when the spec is a glob that can be parsed only as the NAME form of NEVRA. Such spec contains only
+/// the characters allowed in plain names and the `*` and `?` wildcards.
+bool is_name_glob_spec(const std::string & pkg_spec) {
+    bool has_wildcard = false;
+    for (auto ch : pkg_spec) {
+        if (ch == '*' || ch == '?') {
+            has_wildcard = true;
+        } else if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '_' && ch != '+') {
+            return false;
         }
     }
-    return l;
-}
-
-inline bool name_compare_lower_id(const Solvable * first, Id id_name) {
-    return first->name < id_name;
-}
-
-inline bool name_compare_icase_lower_id(const std::pair<Id, Solvable *> first, Id id_name) {
-    return first.first < id_name;
+    return has_wildcard;
 }
 
 template <typename T>
@@ -227,172 +212,171 @@ static inline bool name_arch_compare_lower(const Solvable * first, const T * sec
     return first->arch < second->arch;
 }
 
+/// Dependency graph of packages in the compressed sparse row format. The edges of the node `i` are stored
+/// in `edges` from the index `offsets[i]` up to `offsets[i + 1]`.
+struct DependencyGraph {
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> edges;
+};
+
+/// Index of a solvable that is not a node of the graph
+constexpr unsigned int NO_NODE = std::numeric_limits<unsigned int>::max();
+
 void add_edges(
-    Base & base,
-    std::set<unsigned int> & edges,
-    const PackageQuery & full_query,
-    const std::map<PackageId, unsigned int> & pkg_id2idx,
-    const ReldepList & deps) {
+    ::Pool * pool,
+    const std::vector<unsigned int> & id2idx,
+    const libdnf5::solv::IdQueue & deps,
+    DependencyGraph & graph) {
     // resolve dependencies and add an edge if there is exactly one package satisfying it
     for (int i = 0; i < deps.size(); ++i) {
-        ReldepList req_in_list(base);
-        req_in_list.add(deps.get_id(i));
-        PackageQuery query(full_query);
-        query.filter_provides(req_in_list);
-        if (query.size() == 1) {
-            auto pkg = *query.begin();
-            edges.insert(pkg_id2idx.at(pkg.get_id()));
+        unsigned int provider = NO_NODE;
+        Id p;
+        Id pp;
+        FOR_PROVIDES(p, pp, deps[i]) {
+            auto idx = id2idx[static_cast<std::size_t>(p)];
+            if (idx == NO_NODE || idx == provider) {
+                continue;
+            }
+            if (provider != NO_NODE) {
+                provider = NO_NODE;
+                break;
+            }
+            provider = idx;
+        }
+        if (provider != NO_NODE) {
+            graph.edges.push_back(provider);
         }
     }
 }
 
-std::vector<std::vector<unsigned int>> build_graph(
-    Base & base, const PackageQuery & full_query, const std::vector<Package> & pkgs, bool use_recommends) {
-    // create pkg_id2idx to map Packages to their index in pkgs
-    std::map<PackageId, unsigned int> pkg_id2idx;
-    for (size_t i = 0; i < pkgs.size(); ++i) {
-        pkg_id2idx.emplace(pkgs[i].get_id(), i);
+/// Builds the graph of the `pkgs`, a package requires (or recommends) a package of the graph if it is the only
+/// package of the graph satisfying the dependency. The whatprovides index of the pool has to be ready.
+DependencyGraph build_graph(libdnf5::solv::RpmPool & pool, const std::vector<Package> & pkgs, bool use_recommends) {
+    // map the solvable Ids to the indexes of the packages in pkgs
+    std::vector<unsigned int> id2idx(static_cast<std::size_t>(pool.get_nsolvables()), NO_NODE);
+    for (unsigned int i = 0; i < pkgs.size(); ++i) {
+        id2idx[static_cast<std::size_t>(pkgs[i].get_id().id)] = i;
     }
 
-    std::vector<std::vector<unsigned int>> graph;
-    graph.reserve(pkgs.size());
+    DependencyGraph graph;
+    graph.offsets.reserve(pkgs.size() + 1);
+    graph.offsets.push_back(0);
 
+    libdnf5::solv::IdQueue deps;
     for (unsigned int i = 0; i < pkgs.size(); ++i) {
-        std::set<unsigned int> edges;
-        const auto & package = pkgs[i];
-        add_edges(base, edges, full_query, pkg_id2idx, package.get_requires());
+        Solvable * solvable = pool.id2solvable(pkgs[i].get_id().id);
+        auto node_begin = static_cast<std::ptrdiff_t>(graph.edges.size());
+        // the requires without and with the prereq marker, as returned by Package::get_requires()
+        solvable_lookup_deparray(solvable, SOLVABLE_REQUIRES, &deps.get_queue(), -1);
+        add_edges(*pool, id2idx, deps, graph);
+        solvable_lookup_deparray(solvable, SOLVABLE_REQUIRES, &deps.get_queue(), 1);
+        add_edges(*pool, id2idx, deps, graph);
         if (use_recommends) {
-            add_edges(base, edges, full_query, pkg_id2idx, package.get_recommends());
+            solvable_lookup_deparray(solvable, SOLVABLE_RECOMMENDS, &deps.get_queue(), -1);
+            add_edges(*pool, id2idx, deps, graph);
         }
-        edges.erase(i);  // remove self-edges
-        graph.emplace_back(edges.begin(), edges.end());
-    }
 
-    return graph;
-}
-
-std::vector<std::vector<unsigned int>> reverse_graph(const std::vector<std::vector<unsigned int>> & graph) {
-    std::vector<std::vector<unsigned int>> rgraph(graph.size());
-
-    // pre-allocate (reserve) memory to prevent reallocations
-    std::vector<unsigned int> lengths(graph.size(), 0);
-    for (const auto & edges : graph) {
-        for (auto edge : edges) {
-            ++lengths[edge];
-        }
-    }
-    for (unsigned int i = 0; i < graph.size(); ++i) {
-        rgraph[i].reserve(lengths[i]);
-    }
-
-    // reverse graph
-    for (unsigned int i = 0; i < graph.size(); ++i) {
-        for (auto edge : graph[i]) {
-            rgraph[edge].push_back(i);
-        }
+        // remove duplicate edges and self-edges
+        auto node_edges = graph.edges.begin() + node_begin;
+        std::sort(node_edges, graph.edges.end());
+        graph.edges.erase(std::unique(node_edges, graph.edges.end()), graph.edges.end());
+        graph.edges.erase(std::remove(node_edges, graph.edges.end(), i), graph.edges.end());
+        graph.offsets.push_back(static_cast<unsigned int>(graph.edges.size()));
     }
 
-    return rgraph;
+    return graph;
 }
 
-std::vector<std::vector<unsigned int>> kosaraju(const std::vector<std::vector<unsigned int>> & graph) {
-    const auto N = static_cast<unsigned int>(graph.size());
-    std::vector<unsigned int> rstack(N);
-    std::vector<unsigned int> stack(N);
-    std::vector<bool> tag(N, false);
-    unsigned int r = N;
-    unsigned int top = 0;
-
-    // do depth-first searches in the graph and push nodes to rstack
-    // "on the way up" until all nodes have been pushed.
-    // tag nodes as they're processed so we don't visit them more than once
-    for (unsigned int i = 0; i < N; ++i) {
-        if (tag[i]) {
+/// Finds the strongly connected components of the graph by Tarjan's algorithm in a single iterative depth-first
+/// search and returns the components without incoming edges from other components. The nodes of each returned
+/// component are sorted, the components are ordered by their first node.
+std::vector<std::vector<unsigned int>> find_leaf_components(const DependencyGraph & graph) {
+    const auto N = static_cast<unsigned int>(graph.offsets.size() - 1);
+    constexpr unsigned int NONE = std::numeric_limits<unsigned int>::max();
+
+    // depth-first search order of the nodes, NONE for nodes not visited yet
+    std::vector<unsigned int> order(N, NONE);
+    // the lowest order of a node reachable from the node's subtree that is still on the component stack
+    std::vector<unsigned int> lowlink(N);
+    // component of the node, NONE while the node is on the component stack or not visited yet
+    std::vector<unsigned int> component(N, NONE);
+    // visited nodes without a component
+    std::vector<unsigned int> component_stack;
+    // pairs of <node, position of the next edge to follow> of the nodes on the search path
+    std::vector<std::pair<unsigned int, unsigned int>> search_path;
+    unsigned int next_order = 0;
+    unsigned int num_components = 0;
+
+    for (unsigned int root = 0; root < N; ++root) {
+        if (order[root] != NONE) {
             continue;
         }
 
-        unsigned int u = i;
-        unsigned int j = 0;
-        tag[u] = true;
-        while (true) {
-            const auto & edges = graph[u];
-            if (j < edges.size()) {
-                const auto v = edges[j++];
-                if (!tag[v]) {
-                    rstack[top] = j;
-                    stack[top++] = u;
-                    u = v;
-                    j = 0;
-                    tag[u] = true;
-                }
-            } else {
-                rstack[--r] = u;
-                if (top == 0) {
-                    break;
+        order[root] = lowlink[root] = next_order++;
+        component_stack.push_back(root);
+        search_path.emplace_back(root, graph.offsets[root]);
+        while (!search_path.empty()) {
+            auto [u, edge_pos] = search_path.back();
+            if (edge_pos < graph.offsets[u + 1]) {
+                ++search_path.back().second;
+                const auto v = graph.edges[edge_pos];
+                if (order[v] == NONE) {
+                    order[v] = lowlink[v] = next_order++;
+                    component_stack.push_back(v);
+                    search_path.emplace_back(v, graph.offsets[v]);
+                } else if (component[v] == NONE) {
+                    // v is on the component stack
+                    lowlink[u] = std::min(lowlink[u], order[v]);
                 }
-                u = stack[--top];
-                j = rstack[top];
+                continue;
+            }
+
+            // all edges of u were followed, u is the root of a component if it does not reach an earlier node
+            if (lowlink[u] == order[u]) {
+                unsigned int w;
+                do {
+                    w = component_stack.back();
+                    component_stack.pop_back();
+                    component[w] = num_components;
+                } while (w != u);
+                ++num_components;
+            }
+            search_path.pop_back();
+            if (!search_path.empty()) {
+                auto parent = search_path.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[u]);
             }
         }
     }
 
-    if (r != 0) {
-        throw std::logic_error("leaves: kosaraju(): r != 0");
+    // a component is a leaf if no node of another component has an edge into it
+    std::vector<bool> has_incoming(num_components, false);
+    for (unsigned int u = 0; u < N; ++u) {
+        for (auto pos = graph.offsets[u]; pos < graph.offsets[u + 1]; ++pos) {
+            const auto v = graph.edges[pos];
+            if (component[u] != component[v]) {
+                has_incoming[component[v]] = true;
+            }
+        }
     }
 
-    // now searches beginning at nodes popped from rstack in the graph with all
-    // edges reversed will give us the strongly connected components.
-    // this time all nodes are tagged, so let's remove the tags as we visit each
-    // node.
-    // the incoming edges to each component is the union of incoming edges to
-    // each node in the component minus the incoming edges from component nodes
-    // themselves.
-    // if there are no such incoming edges the component is a leaf and we
-    // add it to the array of leaves.
-    auto rgraph = reverse_graph(graph);
-    std::set<unsigned int> sccredges;
+    std::vector<unsigned int> leaf_idx(num_components, NONE);
     std::vector<std::vector<unsigned int>> leaves;
-    for (; r < N; ++r) {
-        unsigned int u = rstack[r];
-        if (!tag[u]) {
+    for (unsigned int u = 0; u < N; ++u) {
+        const auto c = component[u];
+        if (has_incoming[c]) {
             continue;
         }
-
-        stack[top++] = u;
-        tag[u] = false;
-        unsigned int s = N;
-        while (top) {
-            u = stack[--s] = stack[--top];
-            const auto & redges = rgraph[u];
-            for (unsigned int j = 0; j < redges.size(); ++j) {
-                const unsigned int v = redges[j];
-                sccredges.insert(v);
-                if (!tag[v]) {
-                    continue;
-                }
-
-                stack[top++] = v;
-                tag[v] = false;
-            }
-        }
-
-        for (unsigned int i = s; i < N; ++i) {
-            sccredges.erase(stack[i]);
-        }
-
-        if (sccredges.empty()) {
-            std::vector scc(stack.begin() + s, stack.end());
-            std::sort(scc.begin(), scc.end());
-            leaves.emplace_back(std::move(scc));
-        } else {
-            sccredges.clear();
+        if (leaf_idx[c] == NONE) {
+            leaf_idx[c] = static_cast<unsigned int>(leaves.size());
+            leaves.emplace_back();
         }
+        leaves[leaf_idx[c]].push_back(u);
     }
 
     return leaves;
 }
 
-
 }  //  namespace
 
 
@@ -417,9 +401,9 @@ PackageQuery::PackageQuery(const BaseWeakPtr & base, ExcludeFlags flags, bool em
         case ExcludeFlags::IGNORE_EXCLUDES:
             break;
         default: {
-            auto considered = base->get_rpm_package_sack()->p_impl->compute_considered_map(flags);
+            const auto & considered = base->get_rpm_package_sack()->p_impl->get_considered_map(flags);
             if (considered) {
-                p_pq_impl->considered_cache = std::move(considered);
+                p_pq_impl->considered_cache = *considered;
                 if (!empty) {
                     *p_impl &= *p_pq_impl->considered_cache;
                 }
@@ -457,22 +441,110 @@ PackageQuery & PackageQuery::operator=(PackageQuery && src) noexcept = default;
 
 PackageQuery::~PackageQuery() = default;
 
+/// Returns the number of threads evaluating the expensive filters set by the `query_filter_threads` option.
+static std::size_t get_query_filter_threads(const libdnf5::BaseWeakPtr & base) {
+    return base->get_config().get_query_filter_threads_option().get_value();
+}
+
+/// The candidates are matched by up to `max_workers` threads. It can be used only with getters that do not use
+/// the pool temporary space (the name and the arch), see the contract in solv/concurrent_filter.hpp.
 template <const char * (libdnf5::solv::Pool::*getter)(Id) const>
 inline static void filter_glob_internal(
     libdnf5::solv::Pool & pool,
     const char * c_pattern,
     const libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result,
-    int fnm_flags) {
-    for (Id candidate_id : candidates) {
-        const char * candidate_str = (pool.*getter)(candidate_id);
-        if (fnmatch(c_pattern, candidate_str, fnm_flags) == 0) {
+    int fnm_flags,
+    std::size_t max_workers = 0) {
+    libdnf5::solv::filter_concurrently(
+        candidates, filter_result, max_workers, [&pool, c_pattern, fnm_flags](Id candidate_id) {
+            return fnmatch(c_pattern, (pool.*getter)(candidate_id), fnm_flags) == 0;
+        });
+}
+
+/// Returns the literal part of the glob `pattern` preceding the first wildcard or escape character.
+static std::string_view get_glob_literal_prefix(std::string_view pattern) {
+    return pattern.substr(0, pattern.find_first_of("*?[\\"));
+}
+
+/// Same as filter_glob_internal(), but only the candidates whose name starts case-insensitively with `name_prefix`
+/// are matched. They are looked up by binary search in the list of solvables sorted by name.
+template <const char * (libdnf5::solv::Pool::*getter)(Id) const>
+static void filter_glob_name_prefix_internal(
+    libdnf5::solv::Pool & pool,
+    const std::vector<Solvable *> & name_sorted_solvables,
+    std::string_view name_prefix,
+    const char * c_pattern,
+    const libdnf5::solv::SolvMap & candidates,
+    libdnf5::solv::SolvMap & filter_result,
+    int fnm_flags,
+    std::size_t max_workers = 0) {
+    if (name_prefix.empty()) {
+        filter_glob_internal<getter>(pool, c_pattern, candidates, filter_result, fnm_flags, max_workers);
+        return;
+    }
+    auto cmp_name_prefix = [&pool, &name_prefix](const Solvable * solvable) {
+        return strncasecmp(pool.id2str(solvable->name), name_prefix.data(), name_prefix.size());
+    };
+    auto low = std::lower_bound(
+        name_sorted_solvables.begin(),
+        name_sorted_solvables.end(),
+        name_prefix,
+        [&cmp_name_prefix](const Solvable * solvable, std::string_view) { return cmp_name_prefix(solvable) < 0; });
+    for (; low != name_sorted_solvables.end() && cmp_name_prefix(*low) == 0; ++low) {
+        Id candidate_id = pool.solvable2id(*low);
+        if (candidates.contains_unsafe(candidate_id) &&
+            fnmatch(c_pattern, (pool.*getter)(candidate_id), fnm_flags) == 0) {
             filter_result.add_unsafe(candidate_id);
         }
     }
 }
 
+/// Adds candidates whose name contains `pattern` to `filter_result`. The pattern is searched in the whole
+/// name arena at once, every hit is mapped by binary search to the name and then to the solvables with that name.
+static void filter_name_contains_internal(
+    libdnf5::solv::Pool & pool,
+    const PackageNameArena & arena,
+    const std::vector<Solvable *> & sorted_solvables,
+    const std::string & pattern,
+    bool icase,
+    const libdnf5::solv::SolvMap & candidates,
+    libdnf5::solv::SolvMap & filter_result) {
+    std::string needle = pattern;
+    if (icase) {
+        std::transform(needle.begin(), needle.end(), needle.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+    }
+    const std::string & haystack = icase ? arena.icase_names : arena.names;
+    size_t pos = 0;
+    while (pos < haystack.size()) {
+        auto * hit = static_cast<const char *>(
+            memmem(haystack.data() + pos, haystack.size() - pos, needle.data(), needle.size()));
+        if (!hit) {
+            break;
+        }
+        // The needle contains no '\0', so the hit lies within a single name
+        auto name_idx = static_cast<size_t>(
+            std::upper_bound(
+                arena.name_offsets.begin(), arena.name_offsets.end(), static_cast<size_t>(hit - haystack.data())) -
+            arena.name_offsets.begin() - 1);
+        for (size_t idx = arena.solvable_offsets[name_idx]; idx < arena.solvable_offsets[name_idx + 1]; ++idx) {
+            Id candidate_id = pool.solvable2id(sorted_solvables[idx]);
+            if (candidates.contains_unsafe(candidate_id)) {
+                filter_result.add_unsafe(candidate_id);
+            }
+        }
+        // Continue with the next name
+        pos = arena.name_offsets[name_idx + 1];
+    }
+}
+
 void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_name, patterns, cmp_type)) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     auto sack = p_impl->base->get_rpm_package_sack();
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
@@ -523,28 +595,47 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
                     ++low;
                 }
             } break;
-            case libdnf5::sack::QueryCmp::ICONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strcasestr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            } break;
+            case libdnf5::sack::QueryCmp::ICONTAINS:
+                filter_name_contains_internal(
+                    pool,
+                    sack->p_impl->get_name_arena(),
+                    sack->p_impl->get_sorted_solvables(),
+                    pattern,
+                    true,
+                    *p_impl,
+                    filter_result);
+                break;
             case libdnf5::sack::QueryCmp::IGLOB:
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_name>(
-                    pool, c_pattern, *p_impl, filter_result, FNM_CASEFOLD);
+                filter_glob_name_prefix_internal<&libdnf5::solv::RpmPool::get_name>(
+                    pool,
+                    sack->p_impl->get_name_sorted_solvables(),
+                    get_glob_literal_prefix(pattern),
+                    c_pattern,
+                    *p_impl,
+                    filter_result,
+                    FNM_CASEFOLD,
+                    get_query_filter_threads(p_impl->base));
+                break;
+            case libdnf5::sack::QueryCmp::CONTAINS:
+                filter_name_contains_internal(
+                    pool,
+                    sack->p_impl->get_name_arena(),
+                    sack->p_impl->get_sorted_solvables(),
+                    pattern,
+                    false,
+                    *p_impl,
+                    filter_result);
                 break;
-            case libdnf5::sack::QueryCmp::CONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strstr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            } break;
             case libdnf5::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_name>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_name_prefix_internal<&libdnf5::solv::RpmPool::get_name>(
+                    pool,
+                    sack->p_impl->get_name_sorted_solvables(),
+                    get_glob_literal_prefix(pattern),
+                    c_pattern,
+                    *p_impl,
+                    filter_result,
+                    0,
+                    get_query_filter_threads(p_impl->base));
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -560,6 +651,7 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
 }
 
 void PackageQuery::filter_name(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     if (cmp_type != sack::QueryCmp::EQ && cmp_type != sack::QueryCmp::NEQ) {
         libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
     }
@@ -590,6 +682,7 @@ void PackageQuery::filter_name(const PackageSet & package_set, libdnf5::sack::Qu
 }
 
 void PackageQuery::filter_name_arch(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     if (cmp_type != sack::QueryCmp::EQ && cmp_type != sack::QueryCmp::NEQ) {
         libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
     }
@@ -640,15 +733,26 @@ inline static bool cmp_lte(int cmp) {
     return cmp <= 0;
 }
 
+/// Minimal number of compared packages for which an outdated EVR rank table is updated. For fewer packages
+/// the table is used as it is, the EVRs it does not know are compared by the strings.
+constexpr std::size_t EVR_RANK_TABLE_MIN_PACKAGES = 1024;
+
+inline static const libdnf5::solv::EvrRankTable & get_evr_rank_table(
+    libdnf5::solv::RpmPool & pool, libdnf5::solv::EvrRankTable::Part part, const libdnf5::solv::SolvMap & packages) {
+    return pool.get_evr_rank_table(part, packages.size() >= EVR_RANK_TABLE_MIN_PACKAGES);
+}
+
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_evr_internal(
     libdnf5::solv::RpmPool & pool, const std::vector<std::string> & patterns, libdnf5::solv::SolvMap & query_result) {
     libdnf5::solv::SolvMap filter_result(static_cast<int>(pool->nsolvables));
+    auto & evr_ranks = get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::EVR, query_result);
     for (auto & pattern : patterns) {
         const char * pattern_c_str = pattern.c_str();
+        int pattern_rank = evr_ranks.get_rank(pattern_c_str);
         for (Id candidate_id : query_result) {
             Solvable * solvable = pool.id2solvable(candidate_id);
-            int cmp = pool.evrcmp_str(pool.id2str(solvable->evr), pattern_c_str, EVRCMP_COMPARE);
+            int cmp = evr_ranks.compare(solvable->evr, pattern_c_str, pattern_rank);
             if (cmp_fnc(cmp)) {
                 filter_result.add_unsafe(candidate_id);
             }
@@ -659,6 +763,10 @@ inline static void filter_evr_internal(
 }
 
 void PackageQuery::filter_evr(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_evr, patterns, cmp_type)) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     switch (cmp_type) {
         case libdnf5::sack::QueryCmp::GT:
@@ -682,6 +790,10 @@ void PackageQuery::filter_evr(const std::vector<std::string> & patterns, libdnf5
 }
 
 void PackageQuery::filter_arch(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_arch, patterns, cmp_type)) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
@@ -714,7 +826,8 @@ void PackageQuery::filter_arch(const std::vector<std::string> & patterns, libdnf
                 }
             } break;
             case libdnf5::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_arch>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_internal<&libdnf5::solv::RpmPool::get_arch>(
+                    pool, c_pattern, *p_impl, filter_result, 0, get_query_filter_threads(p_impl->base));
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -823,6 +936,7 @@ static inline bool nevra_compare_lower_id(const Solvable * first, const NevraID
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_nevra_internal_solvable(
     libdnf5::solv::RpmPool & pool,
+    const libdnf5::solv::EvrRankTable & evr_ranks,
     Solvable * pattern_solvable,
     const std::vector<Solvable *> & sorted_solvables,
     libdnf5::solv::SolvMap & filter_result) {
@@ -830,7 +944,7 @@ inline static void filter_nevra_internal_solvable(
         sorted_solvables.begin(), sorted_solvables.end(), pattern_solvable, name_arch_compare_lower<Solvable>);
     while (low != sorted_solvables.end() && (*low)->name == pattern_solvable->name &&
            (*low)->arch == pattern_solvable->arch) {
-        int cmp = pool.evrcmp((*low)->evr, pattern_solvable->evr, EVRCMP_COMPARE);
+        int cmp = evr_ranks.compare((*low)->evr, pattern_solvable->evr);
         if (cmp_fnc(cmp)) {
             filter_result.add_unsafe(pool.solvable2id(*low));
         }
@@ -848,10 +962,13 @@ inline static void filter_nevra_internal_str(
     if (!nevra_id.parse(pool, c_pattern, false)) {
         return;
     }
+    // Only the packages of one name and arch are compared, the rank table is not updated for them
+    auto & evr_ranks = pool.get_evr_rank_table(libdnf5::solv::EvrRankTable::Part::EVR, false);
+    int pattern_rank = evr_ranks.get_rank(nevra_id.evr_str.c_str());
     auto low =
         std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), &nevra_id, name_arch_compare_lower<NevraID>);
     while (low != sorted_solvables.end() && (*low)->name == nevra_id.name && (*low)->arch == nevra_id.arch) {
-        int cmp = pool.evrcmp_str(pool.id2str((*low)->evr), nevra_id.evr_str.c_str(), EVRCMP_COMPARE);
+        int cmp = evr_ranks.compare((*low)->evr, nevra_id.evr_str.c_str(), pattern_rank);
         if (cmp_fnc(cmp)) {
             filter_result.add_unsafe(pool.solvable2id(*low));
         }
@@ -861,7 +978,53 @@ inline static void filter_nevra_internal_str(
 
 }  // namespace
 
+
+class PackageQuery::PQImpl::CachedFilter {
+public:
+    /// @param signature  The filter name and its arguments.
+    CachedFilter(
+        const BaseWeakPtr & base,
+        libdnf5::solv::SolvMap & packages,
+        libdnf5::sack::ExcludeFlags flags,
+        std::string_view signature)
+        : packages(packages) {
+        if (!base->get_config().get_query_cache_option().get_value()) {
+            return;
+        }
+        cache = &base->get_rpm_package_sack()->p_impl->get_query_cache();
+        this->signature = fmt::format(
+            "{}\n{}\n{}", signature, static_cast<unsigned>(flags), get_rpm_pool(base).get_nsolvables());
+        hit = cache->lookup(this->signature, packages);
+        if (!hit) {
+            input.emplace(packages);
+        }
+    }
+
+    ~CachedFilter() {
+        if (input && std::uncaught_exceptions() == uncaught_exceptions) {
+            cache->store(signature, *input, packages);
+        }
+    }
+
+    CachedFilter(const CachedFilter &) = delete;
+    CachedFilter & operator=(const CachedFilter &) = delete;
+
+    bool is_hit() const noexcept { return hit; }
+
+private:
+    libdnf5::solv::SolvMap & packages;
+    PackageQueryCache * cache{nullptr};
+    std::string signature;
+    std::optional<libdnf5::solv::SolvMap> input;
+    bool hit{false};
+    int uncaught_exceptions{std::uncaught_exceptions()};
+};
+
 void PackageQuery::filter_nevra(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_nevra, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -888,6 +1051,7 @@ void PackageQuery::filter_nevra(const std::vector<std::string> & patterns, libdn
 }
 
 void PackageQuery::filter_nevra(const libdnf5::rpm::Nevra & pattern, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -898,7 +1062,7 @@ void PackageQuery::filter_nevra(const libdnf5::rpm::Nevra & pattern, libdnf5::sa
 
     libdnf5::solv::SolvMap filter_result(get_rpm_pool(p_impl->base).get_nsolvables());
 
-    PQImpl::filter_nevra(*this, pattern, cmp_glob, cmp_type, filter_result, true);
+    PQImpl::filter_nevra(*this, NevraPattern(pattern), cmp_glob, cmp_type, filter_result, true);
 
     // Apply filter results to query
     if (cmp_not) {
@@ -909,6 +1073,7 @@ void PackageQuery::filter_nevra(const libdnf5::rpm::Nevra & pattern, libdnf5::sa
 }
 
 void PackageQuery::filter_nevra(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     libdnf_assert_same_base(p_impl->base, package_set.get_base());
 
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
@@ -921,6 +1086,7 @@ void PackageQuery::filter_nevra(const PackageSet & package_set, libdnf5::sack::Q
     libdnf5::solv::SolvMap filter_result(sack->p_impl->get_nsolvables());
 
     auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
+    auto & evr_ranks = get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::EVR, *package_set.p_impl);
 
     switch (cmp_type) {
         case libdnf5::sack::QueryCmp::EQ: {
@@ -938,25 +1104,29 @@ void PackageQuery::filter_nevra(const PackageSet & package_set, libdnf5::sack::Q
         case libdnf5::sack::QueryCmp::GT: {
             for (Id pattern_id : *package_set.p_impl) {
                 Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_gt>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_gt>(
+                    pool, evr_ranks, pattern_solvable, sorted_solvables, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::GTE: {
             for (Id pattern_id : *package_set.p_impl) {
                 Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_gte>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_gte>(
+                    pool, evr_ranks, pattern_solvable, sorted_solvables, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::LT: {
             for (Id pattern_id : *package_set.p_impl) {
                 Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_lt>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_lt>(
+                    pool, evr_ranks, pattern_solvable, sorted_solvables, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::LTE: {
             for (Id pattern_id : *package_set.p_impl) {
                 Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_lte>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_lte>(
+                    pool, evr_ranks, pattern_solvable, sorted_solvables, filter_result);
             }
         } break;
         default:
@@ -978,10 +1148,10 @@ inline static void filter_version_internal(
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result) {
     char * formatted_c_pattern = solv_dupjoin(c_pattern, "-0", nullptr);
+    auto & version_ranks = get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::VERSION, candidates);
+    int pattern_rank = version_ranks.get_rank(formatted_c_pattern);
     for (Id candidate_id : candidates) {
-        std::string vr(pool.split_evr(pool.get_evr(candidate_id)).v);
-        vr.append("-0");
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+        int cmp = version_ranks.compare(pool.id2solvable(candidate_id)->evr, formatted_c_pattern, pattern_rank);
         if (cmp_eq(cmp)) {
             filter_result.add_unsafe(candidate_id);
         }
@@ -990,6 +1160,10 @@ inline static void filter_version_internal(
 }
 
 void PackageQuery::filter_version(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_version, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1046,10 +1220,10 @@ inline static void filter_release_internal(
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result) {
     char * formatted_c_pattern = solv_dupjoin("0-", c_pattern, nullptr);
+    auto & release_ranks = get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::RELEASE, candidates);
+    int pattern_rank = release_ranks.get_rank(formatted_c_pattern);
     for (Id candidate_id : candidates) {
-        std::string vr("0-");
-        vr.append(pool.split_evr(pool.get_evr(candidate_id)).r);
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+        int cmp = release_ranks.compare(pool.id2solvable(candidate_id)->evr, formatted_c_pattern, pattern_rank);
         if (cmp_eq(cmp)) {
             filter_result.add_unsafe(candidate_id);
         }
@@ -1058,6 +1232,10 @@ inline static void filter_release_internal(
 }
 
 void PackageQuery::filter_release(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_release, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1108,6 +1286,10 @@ void PackageQuery::filter_release(const std::vector<std::string> & patterns, lib
 }
 
 void PackageQuery::filter_repo_id(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_repo_id, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1152,10 +1334,12 @@ void PackageQuery::filter_repo_id(const std::vector<std::string> & patterns, lib
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
         }
     }
-    for (Id candidate_id : *p_impl) {
-        auto * solvable = pool.id2solvable(candidate_id);
-        if (solvable->repo && repo_ids[solvable->repo->repoid]) {
-            filter_result.add_unsafe(candidate_id);
+    // The solvables of the selected repos are added range by range, the candidates are not visited
+    ::Repo * r;
+    FOR_REPOS(repo_id, r) {
+        if (repo_ids[repo_id]) {
+            for_each_repo_range(
+                *pool, r, [&filter_result](Id begin, Id end) { filter_result.add_range_unsafe(begin, end); });
         }
     }
 
@@ -1168,6 +1352,10 @@ void PackageQuery::filter_repo_id(const std::vector<std::string> & patterns, lib
 }
 
 void PackageQuery::filter_sourcerpm(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::ATTRIBUTE, &PackageQuery::filter_sourcerpm, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1175,6 +1363,7 @@ void PackageQuery::filter_sourcerpm(const std::vector<std::string> & patterns, l
     }
 
     auto & pool = get_rpm_pool(p_impl->base);
+    auto & source_index = p_impl->base->get_rpm_package_sack()->p_impl->get_source_index();
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_glob = (cmp_type & libdnf5::sack::QueryCmp::GLOB) == libdnf5::sack::QueryCmp::GLOB;
 
@@ -1187,29 +1376,19 @@ void PackageQuery::filter_sourcerpm(const std::vector<std::string> & patterns, l
         }
         switch (tmp_cmp_type) {
             case libdnf5::sack::QueryCmp::EQ:
-                for (Id candidate_id : *p_impl) {
-                    auto * solvable = pool.id2solvable(candidate_id);
-                    const char * name = solvable_lookup_str(solvable, SOLVABLE_SOURCENAME);
-                    if (name == nullptr) {
-                        name = pool.id2str(solvable->name);
-                    }
-                    auto name_len = strlen(name);
-
-                    if (strncmp(c_pattern, name, name_len) != 0) {  // early check -> performance
-                        continue;
-                    }
-                    auto * sourcerpm = pool.get_sourcerpm(candidate_id);
-                    if (sourcerpm && strcmp(c_pattern, sourcerpm) == 0) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
+                source_index.add_binaries(pattern, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::GLOB:
-                for (Id candidate_id : *p_impl) {
-                    auto * sourcerpm = pool.get_sourcerpm(candidate_id);
-                    if (sourcerpm && (fnmatch(c_pattern, sourcerpm, 0) == 0)) {
-                        filter_result.add_unsafe(candidate_id);
+                // Match either the candidates or the distinct source rpm names, whichever are fewer
+                if (source_index.prefer_candidates(p_impl->size())) {
+                    for (Id candidate_id : *p_impl) {
+                        auto * sourcerpm = source_index.get_sourcerpm(candidate_id);
+                        if (sourcerpm && (fnmatch(c_pattern, sourcerpm->c_str(), 0) == 0)) {
+                            filter_result.add_unsafe(candidate_id);
+                        }
                     }
+                } else {
+                    source_index.add_binaries_glob(pattern, filter_result);
                 }
                 break;
             default:
@@ -1226,6 +1405,10 @@ void PackageQuery::filter_sourcerpm(const std::vector<std::string> & patterns, l
 }
 
 void PackageQuery::filter_epoch(const std::vector<unsigned long> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_epoch, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1299,6 +1482,10 @@ void PackageQuery::filter_epoch(const std::vector<unsigned long> & patterns, lib
 }
 
 void PackageQuery::filter_epoch(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::SOLVABLE, &PackageQuery::filter_epoch, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1348,33 +1535,42 @@ void PackageQuery::filter_epoch(const std::vector<std::string> & patterns, libdn
     }
 }
 
+/// The candidates are matched by up to `max_workers` threads. Full file names are composed in the pool temporary
+/// space, `max_workers` can't be used with `SEARCH_FILES` on `SOLVABLE_FILELIST`.
 static void filter_dataiterator(
     Pool * pool,
     Id keyname,
     int flags,
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result,
-    const char * c_pattern) {
-    Dataiterator di;
-
-    for (Id candidate_id : candidates) {
-        dataiterator_init(&di, pool, nullptr, candidate_id, keyname, c_pattern, flags);
-        while (dataiterator_step(&di) != 0) {
-            filter_result.add_unsafe(candidate_id);
-            break;
-        }
-        dataiterator_free(&di);
-    }
-}
-
+    const char * c_pattern,
+    std::size_t max_workers = 0) {
+    libdnf5::solv::filter_concurrently(
+        candidates, filter_result, max_workers, [pool, keyname, flags, c_pattern](Id candidate_id) {
+            Dataiterator di;
+            dataiterator_init(&di, pool, nullptr, candidate_id, keyname, c_pattern, flags);
+            bool found = dataiterator_step(&di) != 0;
+            dataiterator_free(&di);
+            return found;
+        });
+}
+
+/// When `shortlist` is given, only the candidates it returns are matched with the data iterator.
+/// The candidates are matched by up to `max_workers` threads, it can't be used for `SOLVABLE_FILELIST`.
 static void filter_dataiterator_internal(
     Pool * pool,
     Id keyname,
     libdnf5::solv::SolvMap & candidates,
     libdnf5::sack::QueryCmp cmp_type,
-    const std::vector<std::string> & patterns) {
+    const std::vector<std::string> & patterns,
+    const ShortlistFunction & shortlist = nullptr,
+    std::size_t max_workers = 0) {
     libdnf5::solv::SolvMap filter_result(pool->nsolvables);
 
+    if (max_workers > 1) {
+        libdnf5::solv::prepare_concurrent_lookup(pool, keyname);
+    }
+
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and more effective
@@ -1414,7 +1610,13 @@ static void filter_dataiterator_internal(
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
         }
-        filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
+        if (shortlist) {
+            if (auto shortlisted = shortlist(pattern, flags, candidates)) {
+                filter_dataiterator(pool, keyname, flags, *shortlisted, filter_result, c_pattern, max_workers);
+                continue;
+            }
+        }
+        filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern, max_workers);
     }
 
     // Apply filter results to query
@@ -1425,23 +1627,93 @@ static void filter_dataiterator_internal(
     }
 }
 
+ShortlistFunction PackageQuery::PQImpl::get_file_index_shortlist(const libdnf5::BaseWeakPtr & base) {
+    if (!base->get_config().get_file_search_index_option().get_value()) {
+        return nullptr;
+    }
+    return [base](const std::string & pattern, int flags, const libdnf5::solv::SolvMap & candidates)
+               -> std::optional<libdnf5::solv::SolvMap> {
+        if ((flags & SEARCH_STRINGMASK) != SEARCH_STRING) {
+            return std::nullopt;
+        }
+        return base->get_rpm_package_sack()->p_impl->get_file_index().shortlist(pattern, candidates);
+    };
+}
+
+ShortlistFunction PackageQuery::PQImpl::get_text_index_shortlist(const libdnf5::BaseWeakPtr & base, Id keyname) {
+    if (!base->get_config().get_text_search_index_option().get_value()) {
+        return nullptr;
+    }
+    auto & text_index = base->get_rpm_package_sack()->p_impl->get_text_index(keyname);
+    return [&text_index](const std::string & pattern, int flags, const libdnf5::solv::SolvMap & candidates) {
+        return text_index.shortlist(pattern, (flags & SEARCH_GLOB) != 0, candidates);
+    };
+}
+
 void PackageQuery::filter_file(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_FILELIST, *p_impl, cmp_type, patterns);
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::FILELIST, &PackageQuery::filter_file, patterns, cmp_type)) {
+        return;
+    }
+    filter_dataiterator_internal(
+        *get_rpm_pool(p_impl->base),
+        SOLVABLE_FILELIST,
+        *p_impl,
+        cmp_type,
+        patterns,
+        PQImpl::get_file_index_shortlist(p_impl->base));
 }
 
 void PackageQuery::filter_description(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_DESCRIPTION, *p_impl, cmp_type, patterns);
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::ATTRIBUTE, &PackageQuery::filter_description, patterns, cmp_type)) {
+        return;
+    }
+    filter_dataiterator_internal(
+        *get_rpm_pool(p_impl->base),
+        SOLVABLE_DESCRIPTION,
+        *p_impl,
+        cmp_type,
+        patterns,
+        PQImpl::get_text_index_shortlist(p_impl->base, SOLVABLE_DESCRIPTION),
+        get_query_filter_threads(p_impl->base));
 }
 
 void PackageQuery::filter_summary(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_SUMMARY, *p_impl, cmp_type, patterns);
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::ATTRIBUTE, &PackageQuery::filter_summary, patterns, cmp_type)) {
+        return;
+    }
+    filter_dataiterator_internal(
+        *get_rpm_pool(p_impl->base),
+        SOLVABLE_SUMMARY,
+        *p_impl,
+        cmp_type,
+        patterns,
+        PQImpl::get_text_index_shortlist(p_impl->base, SOLVABLE_SUMMARY),
+        get_query_filter_threads(p_impl->base));
 }
 
 void PackageQuery::filter_url(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_URL, *p_impl, cmp_type, patterns);
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::ATTRIBUTE, &PackageQuery::filter_url, patterns, cmp_type)) {
+        return;
+    }
+    filter_dataiterator_internal(
+        *get_rpm_pool(p_impl->base),
+        SOLVABLE_URL,
+        *p_impl,
+        cmp_type,
+        patterns,
+        nullptr,
+        get_query_filter_threads(p_impl->base));
 }
 
 void PackageQuery::filter_location(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::ATTRIBUTE, &PackageQuery::filter_location, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1477,6 +1749,15 @@ void PackageQuery::filter_location(const std::vector<std::string> & patterns, li
 }
 
 void PackageQuery::filter_provides(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto signature = fmt::format("{} {}", __func__, static_cast<unsigned>(cmp_type));
+    for (int idx = 0; idx < reldep_list.size(); ++idx) {
+        signature += fmt::format(" {}", reldep_list.get_id(idx).id);
+    }
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, signature);
+    if (cached.is_hit()) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1498,11 +1779,26 @@ void PackageQuery::filter_provides(const ReldepList & reldep_list, libdnf5::sack
 }
 
 void PackageQuery::filter_provides(const Reldep & reldep, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     libdnf5::rpm::ReldepList reldep_list{p_impl->base};
     reldep_list.add(reldep.get_id());
     filter_provides(reldep_list, cmp_type);
 }
 
+bool PackageQuery::is_provided(ReldepId reldep_id) {
+    p_pq_impl->flush_deferred_filters(*this);
+    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    ::Pool * pool = *get_rpm_pool(p_impl->base);
+    Id p;
+    Id pp;
+    FOR_PROVIDES(p, pp, reldep_id.id) {
+        if (p_impl->contains_unsafe(p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /// Provide libdnf5::sack::QueryCmp without NOT flag
 void PackageQuery::PQImpl::str2reldep_internal(
     ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type, bool cmp_glob, const std::string & pattern) {
@@ -1537,6 +1833,10 @@ void PackageQuery::PQImpl::str2reldep_internal(
 }
 
 void PackageQuery::filter_provides(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_provides, patterns, cmp_type)) {
+        return;
+    }
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparisons easier and effective
@@ -1616,27 +1916,35 @@ void PackageQuery::PQImpl::filter_reldep(
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
 
-    libdnf5::solv::IdQueue rco;
+    auto max_workers = get_query_filter_threads(base);
+    if (max_workers > 1) {
+        libdnf5::solv::prepare_concurrent_lookup(*pool, libsolv_key);
+    }
 
-    for (Id candidate_id : *pkg_set.p_impl) {
-        Solvable * solvable = pool.id2solvable(candidate_id);
-        auto reldep_list_size = reldep_list.size();
-        for (int index = 0; index < reldep_list_size; ++index) {
-            Id reldep_filter_id = reldep_list.get_id(index).id;
+    // Each worker uses its own copy of the lambda including the `rco` queue
+    libdnf5::solv::filter_concurrently(
+        *pkg_set.p_impl,
+        filter_result,
+        max_workers,
+        [&pool, &reldep_list, libsolv_key, rco = libdnf5::solv::IdQueue()](Id candidate_id) mutable {
+            Solvable * solvable = pool.id2solvable(candidate_id);
+            auto reldep_list_size = reldep_list.size();
+            for (int index = 0; index < reldep_list_size; ++index) {
+                Id reldep_filter_id = reldep_list.get_id(index).id;
 
-            rco.clear();
-            solvable_lookup_idarray(solvable, libsolv_key, &rco.get_queue());
-            auto rco_size = rco.size();
-            for (int index_j = 0; index_j < rco_size; ++index_j) {
-                Id reldep_id_from_solvable = rco[index_j];
+                rco.clear();
+                solvable_lookup_idarray(solvable, libsolv_key, &rco.get_queue());
+                auto rco_size = rco.size();
+                for (int index_j = 0; index_j < rco_size; ++index_j) {
+                    Id reldep_id_from_solvable = rco[index_j];
 
-                if (pool_match_dep(*pool, reldep_filter_id, reldep_id_from_solvable) != 0) {
-                    filter_result.add_unsafe(candidate_id);
-                    break;
+                    if (pool_match_dep(*pool, reldep_filter_id, reldep_id_from_solvable) != 0) {
+                        return true;
+                    }
                 }
             }
-        }
-    }
+            return false;
+        });
 
     // Apply filter results to query
     if (cmp_not) {
@@ -1664,32 +1972,12 @@ void PackageQuery::PQImpl::filter_reldep(
     auto base = pkg_set.get_base();
     auto & pool = get_rpm_pool(base);
 
-    base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    auto & sack_impl = *base->get_rpm_package_sack()->p_impl;
+    sack_impl.make_provides_ready();
 
+    // The reverse index limits the work to the dependencies that the provides of `package_set` can satisfy
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
-
-    libdnf5::solv::IdQueue out;
-
-    for (auto package_id : *package_set.p_impl) {
-        out.clear();
-
-        // queue_push2 because we are creating a selection, which contains pairs
-        // of <flags, Id>, SOLVER_SOOLVABLE_ALL is a special flag which includes
-        // all packages from specified pool, Id is ignored.
-        queue_push2(&out.get_queue(), SOLVER_SOLVABLE_ALL, 0);
-
-        int flags = 0;
-        flags |= SELECTION_FILTER | SELECTION_WITH_ALL;
-        selection_make_matchsolvable(*pool, &out.get_queue(), package_id, flags, libsolv_key, 0);
-
-        // Queue from selection_make_matchsolvable is a selection, which means
-        // it conntains pairs <flags, Id>, flags refers to how was the Id
-        // matched, that is not important here, so skip it and iterate just
-        // over the Ids.
-        for (int j = 1; j < out.size(); j += 2) {
-            filter_result.add_unsafe(out[j]);
-        }
-    }
+    sack_impl.get_reverse_dep_index(libsolv_key).add_dependents(pool, *package_set.p_impl, filter_result);
 
     // Apply filter results to query
     if (cmp_not) {
@@ -1699,9 +1987,37 @@ void PackageQuery::PQImpl::filter_reldep(
     }
 }
 
+NevraPattern::NevraPattern(const Nevra & nevra)
+    : name(nevra.get_name()),
+      epoch(nevra.get_epoch()),
+      version(nevra.get_version()),
+      release(nevra.get_release()),
+      arch(nevra.get_arch()) {}
+
+NevraPattern::NevraPattern(const NevraView & nevra) {
+    const std::size_t size = nevra.get_name().size() + nevra.get_epoch().size() + nevra.get_version().size() +
+                             nevra.get_release().size() + nevra.get_arch().size() + 5;
+    char * buffer = small_buffer;
+    if (size > SMALL_BUFFER_SIZE) {
+        large_buffer.reset(new char[size]);
+        buffer = large_buffer.get();
+    }
+    auto copy = [&buffer](std::string_view src) {
+        std::string_view dest(buffer, src.size());
+        buffer = std::copy(src.begin(), src.end(), buffer);
+        *buffer++ = '\0';
+        return dest;
+    };
+    name = copy(nevra.get_name());
+    epoch = copy(nevra.get_epoch());
+    version = copy(nevra.get_version());
+    release = copy(nevra.get_release());
+    arch = copy(nevra.get_arch());
+}
+
 void PackageQuery::PQImpl::filter_nevra(
     PackageSet & pkg_set,
-    const Nevra & pattern,
+    const NevraPattern & pattern,
     bool cmp_glob,
     libdnf5::sack::QueryCmp cmp_type,
     libdnf5::solv::SolvMap & filter_result,
@@ -1710,31 +2026,31 @@ void PackageQuery::PQImpl::filter_nevra(
     auto & pool = get_rpm_pool(base);
     auto sack = base->get_rpm_package_sack();
 
-    auto & name = pattern.get_name();
-    const char * name_c_pattern = name.c_str();
+    auto name = pattern.get_name();
+    const char * name_c_pattern = name.data();
     auto name_cmp_type = remove_glob_when_unneeded(cmp_type, name_c_pattern, cmp_glob);
     bool all_names = cmp_glob && (name == "*");
 
-    auto & epoch = pattern.get_epoch();
-    const char * epoch_c_pattern = epoch.c_str();
+    auto epoch = pattern.get_epoch();
+    const char * epoch_c_pattern = epoch.data();
     auto epoch_cmp_type = remove_glob_when_unneeded(cmp_type, epoch_c_pattern, cmp_glob);
     bool all_epoch = cmp_glob && (epoch == "*");
     bool test_epoch = !all_epoch && !epoch.empty();
 
-    auto & version = pattern.get_version();
-    const char * version_c_pattern = version.c_str();
+    auto version = pattern.get_version();
+    const char * version_c_pattern = version.data();
     auto version_cmp_type = remove_glob_when_unneeded(cmp_type, version_c_pattern, cmp_glob);
     bool all_version = cmp_glob && (version == "*");
     bool test_version = !all_version && !version.empty();
 
-    auto & release = pattern.get_release();
-    const char * release_c_pattern = release.c_str();
+    auto release = pattern.get_release();
+    const char * release_c_pattern = release.data();
     auto release_cmp_type = remove_glob_when_unneeded(cmp_type, release_c_pattern, cmp_glob);
     bool all_release = cmp_glob && (release == "*");
     bool test_release = !all_release && !release.empty();
 
-    auto & arch = pattern.get_arch();
-    const char * arch_c_pattern = arch.c_str();
+    auto arch = pattern.get_arch();
+    const char * arch_c_pattern = arch.data();
     auto arch_cmp_type = remove_glob_when_unneeded(cmp_type, arch_c_pattern, cmp_glob);
     bool all_arch = cmp_glob && (arch == "*");
     bool test_arch = !all_arch && !arch.empty();
@@ -1843,7 +2159,7 @@ void PackageQuery::PQImpl::filter_nevra(
             } break;
             case libdnf5::sack::QueryCmp::IGLOB: {
                 auto & sorted_icase_solvables = sack->p_impl->get_sorted_icase_solvables();
-                auto icase_name = libdnf5::utils::to_lowercase(name);
+                auto icase_name = libdnf5::utils::to_lowercase(std::string(name));
                 auto icase_name_cstring = icase_name.c_str();
                 for (auto const & [name_id, solvable] : sorted_icase_solvables) {
                     auto candidate_name = pool.id2str(name_id);
@@ -1942,24 +2258,22 @@ void PackageQuery::PQImpl::filter_nevra(
         case libdnf5::sack::QueryCmp::LTE:
             filter_nevra_internal_str<cmp_lte>(pool, c_pattern, sorted_solvables, filter_result);
             break;
-        case libdnf5::sack::QueryCmp::GLOB: {
-            auto found = pattern.find(':');
-            if (found == std::string::npos) {
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_nevra_without_epoch>(
-                    pool, c_pattern, *pkg_set.p_impl, filter_result, 0);
-            } else {
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_nevra_with_epoch>(
-                    pool, c_pattern, *pkg_set.p_impl, filter_result, 0);
-            }
-        } break;
+        case libdnf5::sack::QueryCmp::GLOB:
         case libdnf5::sack::QueryCmp::IGLOB: {
+            int fnm_flags = tmp_cmp_type == libdnf5::sack::QueryCmp::IGLOB ? FNM_CASEFOLD : 0;
+            // The literal prefix of the pattern is matched by the name, unless it also covers the dash
+            // separating the name from the version. The name is then a prefix of the part before that dash.
+            auto name_prefix = get_glob_literal_prefix(pattern);
+            name_prefix = name_prefix.substr(0, name_prefix.find('-'));
+            auto & name_sorted_solvables =
+                pkg_set.get_base()->get_rpm_package_sack()->p_impl->get_name_sorted_solvables();
             auto found = pattern.find(':');
             if (found == std::string::npos) {
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_nevra_without_epoch>(
-                    pool, c_pattern, *pkg_set.p_impl, filter_result, FNM_CASEFOLD);
+                filter_glob_name_prefix_internal<&libdnf5::solv::RpmPool::get_nevra_without_epoch>(
+                    pool, name_sorted_solvables, name_prefix, c_pattern, *pkg_set.p_impl, filter_result, fnm_flags);
             } else {
-                filter_glob_internal<&libdnf5::solv::RpmPool::get_nevra_with_epoch>(
-                    pool, c_pattern, *pkg_set.p_impl, filter_result, FNM_CASEFOLD);
+                filter_glob_name_prefix_internal<&libdnf5::solv::RpmPool::get_nevra_with_epoch>(
+                    pool, name_sorted_solvables, name_prefix, c_pattern, *pkg_set.p_impl, filter_result, fnm_flags);
             }
         } break;
         case libdnf5::sack::QueryCmp::IEXACT: {
@@ -2011,6 +2325,9 @@ void PackageQuery::PQImpl::filter_sorted_advisory_pkgs(
         case libdnf5::sack::QueryCmp::LTE:
         case libdnf5::sack::QueryCmp::LT:
         case libdnf5::sack::QueryCmp::GT: {
+            // Advisory packages mostly have EVRs of the packages, the strings are interned to the same Ids
+            auto & evr_ranks = pool.get_evr_rank_table(
+                libdnf5::solv::EvrRankTable::Part::EVR, adv_pkgs.size() >= EVR_RANK_TABLE_MIN_PACKAGES);
             for (auto & adv_pkg : adv_pkgs) {
                 auto low = std::lower_bound(
                     sorted_solvables.begin(),
@@ -2019,7 +2336,7 @@ void PackageQuery::PQImpl::filter_sorted_advisory_pkgs(
                     libdnf5::advisory::AdvisoryPackage::Impl::name_arch_compare_lower_solvable);
                 while (low != sorted_solvables.end() && (*low)->name == adv_pkg.p_impl.get()->get_name_id() &&
                        (*low)->arch == adv_pkg.p_impl.get()->get_arch_id()) {
-                    int libsolv_cmp = pool.evrcmp((*low)->evr, adv_pkg.p_impl.get()->get_evr_id(), EVRCMP_COMPARE);
+                    int libsolv_cmp = evr_ranks.compare((*low)->evr, adv_pkg.p_impl.get()->get_evr_id());
                     if (((libsolv_cmp > 0) && ((cmp_type & sack::QueryCmp::GT) == sack::QueryCmp::GT)) ||
                         ((libsolv_cmp < 0) && ((cmp_type & sack::QueryCmp::LT) == sack::QueryCmp::LT)) ||
                         ((libsolv_cmp == 0) && ((cmp_type & sack::QueryCmp::EQ) == sack::QueryCmp::EQ))) {
@@ -2042,38 +2359,56 @@ void PackageQuery::PQImpl::filter_sorted_advisory_pkgs(
 }
 
 void PackageQuery::filter_conflicts(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_CONFLICTS, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_conflicts(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_conflicts, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_CONFLICTS, cmp_type, patterns);
 }
 
 void PackageQuery::filter_conflicts(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_CONFLICTS, cmp_type, package_set);
 }
 
 void PackageQuery::filter_enhances(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_ENHANCES, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_enhances(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_enhances, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_ENHANCES, cmp_type, patterns);
 }
 
 void PackageQuery::filter_enhances(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_ENHANCES, cmp_type, package_set);
 }
 
 void PackageQuery::filter_obsoletes(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_OBSOLETES, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_obsoletes(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_obsoletes, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_OBSOLETES, cmp_type, patterns);
 }
 
 void PackageQuery::filter_obsoletes(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     bool cmp_not;
     switch (cmp_type) {
         case libdnf5::sack::QueryCmp::EQ:
@@ -2128,55 +2463,80 @@ void PackageQuery::filter_obsoletes(const PackageSet & package_set, libdnf5::sac
 }
 
 void PackageQuery::filter_recommends(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_RECOMMENDS, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_recommends(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_recommends, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_RECOMMENDS, cmp_type, patterns);
 }
 
 void PackageQuery::filter_recommends(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_RECOMMENDS, cmp_type, package_set);
 }
 
 void PackageQuery::filter_requires(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_REQUIRES, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_requires(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_requires, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_REQUIRES, cmp_type, patterns);
 }
 
 void PackageQuery::filter_requires(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_REQUIRES, cmp_type, package_set);
 }
 
 void PackageQuery::filter_suggests(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_SUGGESTS, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_suggests(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_suggests, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_SUGGESTS, cmp_type, patterns);
 }
 
 void PackageQuery::filter_suggests(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_SUGGESTS, cmp_type, package_set);
 }
 
 void PackageQuery::filter_supplements(const ReldepList & reldep_list, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_SUPPLEMENTS, cmp_type, reldep_list);
 }
 
 void PackageQuery::filter_supplements(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
+    if (p_pq_impl->defer(
+            *this, __func__, PQImpl::FilterCost::RELDEP, &PackageQuery::filter_supplements, patterns, cmp_type)) {
+        return;
+    }
     PQImpl::filter_reldep(*this, SOLVABLE_SUPPLEMENTS, cmp_type, patterns);
 }
 
 void PackageQuery::filter_supplements(const PackageSet & package_set, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     PQImpl::filter_reldep(*this, SOLVABLE_SUPPLEMENTS, cmp_type, package_set);
 }
 
 void PackageQuery::filter_advisories(
     const libdnf5::advisory::AdvisoryQuery & advisory_query, libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     std::vector<libdnf5::advisory::AdvisoryPackage> adv_pkgs =
         advisory_query.get_advisory_packages_sorted_by_name_arch_evr();
     PQImpl::filter_sorted_advisory_pkgs(*this, adv_pkgs, cmp_type);
@@ -2186,6 +2546,7 @@ void PackageQuery::filter_latest_unresolved_advisories(
     const libdnf5::advisory::AdvisoryQuery & advisory_query,
     PackageQuery & installed,
     libdnf5::sack::QueryCmp cmp_type) {
+    p_pq_impl->flush_deferred_filters(*this);
     auto adv_pkgs = advisory_query.get_advisory_packages_sorted_by_name_arch_evr();
     std::vector<libdnf5::advisory::AdvisoryPackage> latest_unresolved_adv_pkgs;
     for (std::vector<libdnf5::advisory::AdvisoryPackage>::iterator i = adv_pkgs.begin(); i != adv_pkgs.end(); ++i) {
@@ -2206,6 +2567,14 @@ void PackageQuery::filter_latest_unresolved_advisories(
 }
 
 void PackageQuery::filter_installed() {
+    if (p_pq_impl->defer(
+            *this,
+            __func__,
+            PQImpl::FilterCost::SOLVABLE,
+            true,
+            [](PackageQuery & query) { query.filter_installed(); })) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     auto * installed_repo = pool->installed;
     if (installed_repo == nullptr) {
@@ -2213,44 +2582,39 @@ void PackageQuery::filter_installed() {
         return;
     }
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
-    auto it = p_impl->begin();
-    auto end = p_impl->end();
-    for (it.jump(installed_repo->start); it != end; ++it) {
-        Solvable * solvable = pool.id2solvable(*it);
-        if (solvable->repo == installed_repo) {
-            filter_result.add_unsafe(*it);
-            continue;
-        }
-        if (*it >= installed_repo->end) {
-            break;
-        }
-    }
-    // TODO(jrohel): The optimization replaces the original query_result buffer. Is it OK?
-    // Or we need to use a slower version "*p_impl &= filter_result;"
-    p_impl->swap(filter_result);
+    for_each_repo_range(*pool, installed_repo, [&filter_result](Id begin, Id end) {
+        filter_result.add_range_unsafe(begin, end);
+    });
+    *p_impl &= filter_result;
 }
 
 void PackageQuery::filter_available() {
+    if (p_pq_impl->defer(
+            *this,
+            __func__,
+            PQImpl::FilterCost::SOLVABLE,
+            true,
+            [](PackageQuery & query) { query.filter_available(); })) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     auto * installed_repo = pool->installed;
     if (installed_repo == nullptr) {
         return;
     }
-    auto it = p_impl->begin();
-    auto end = p_impl->end();
-    for (it.jump(installed_repo->start); it != end; ++it) {
-        Solvable * solvable = pool.id2solvable(*it);
-        if (solvable->repo == installed_repo) {
-            p_impl->remove_unsafe(*it);
-            continue;
-        }
-        if (*it >= installed_repo->end) {
-            break;
-        }
-    }
+    // The query can be older than solvables added to the pool later
+    auto size = p_impl->allocated_size();
+    for_each_repo_range(*pool, installed_repo, [this, size](Id begin, Id end) {
+        p_impl->remove_range_unsafe(std::min(begin, size), std::min(end, size));
+    });
 }
 
 void PackageQuery::filter_upgrades() {
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, __func__);
+    if (cached.is_hit()) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     auto * installed_repo = pool->installed;
     if (installed_repo == nullptr) {
@@ -2258,7 +2622,7 @@ void PackageQuery::filter_upgrades() {
         return;
     }
 
-    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    auto & upgrade_index = p_impl->base->get_rpm_package_sack()->p_impl->get_upgrade_index();
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
 
@@ -2267,7 +2631,7 @@ void PackageQuery::filter_upgrades() {
         if (solvable->repo == installed_repo) {
             continue;
         }
-        if (what_upgrades(pool, solvable) > 0) {
+        if (upgrade_index.what_upgrades(pool, solvable) > 0) {
             filter_result.add_unsafe(candidate_id);
         }
     }
@@ -2275,6 +2639,11 @@ void PackageQuery::filter_upgrades() {
 }
 
 void PackageQuery::filter_downgrades() {
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, __func__);
+    if (cached.is_hit()) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
     auto * installed_repo = pool->installed;
 
@@ -2283,7 +2652,7 @@ void PackageQuery::filter_downgrades() {
         return;
     }
 
-    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    auto & upgrade_index = p_impl->base->get_rpm_package_sack()->p_impl->get_upgrade_index();
 
     for (Id candidate_id : *p_impl) {
         Solvable * solvable = pool.id2solvable(candidate_id);
@@ -2291,27 +2660,30 @@ void PackageQuery::filter_downgrades() {
             p_impl->remove_unsafe(candidate_id);
             continue;
         }
-        if (what_downgrades(pool, solvable) <= 0) {
+        if (upgrade_index.what_downgrades(pool, solvable) <= 0) {
             p_impl->remove_unsafe(candidate_id);
         }
     }
 }
 
 void PackageQuery::filter_upgradable() {
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, __func__);
+    if (cached.is_hit()) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
-    auto * installed_repo = pool->installed;
-
     if (pool->installed == nullptr) {
         clear();
         return;
     }
 
-    auto sack = p_impl->base->get_rpm_package_sack();
-    sack->p_impl->make_provides_ready();
+    auto & upgrade_index = p_impl->base->get_rpm_package_sack()->p_impl->get_upgrade_index();
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
 
-    for (auto pkg_id : sack->p_impl->get_solvables()) {
+    // only the available packages with the name of an installed package can upgrade or downgrade it
+    for (auto pkg_id : upgrade_index.get_available()) {
         if (p_pq_impl->flags == ExcludeFlags::APPLY_EXCLUDES) {
             if (pool.is_considered_map_active() && !pool.get_considered_map().contains_unsafe(pkg_id)) {
                 continue;
@@ -2322,11 +2694,7 @@ void PackageQuery::filter_upgradable() {
             }
         }
 
-        Solvable * solvable = pool.id2solvable(pkg_id);
-        if (solvable->repo == installed_repo) {
-            continue;
-        }
-        Id what = what_upgrades(pool, solvable);
+        Id what = upgrade_index.what_upgrades(pool, pool.id2solvable(pkg_id));
         if (what != 0) {
             filter_result.add_unsafe(what);
         }
@@ -2335,20 +2703,23 @@ void PackageQuery::filter_upgradable() {
 }
 
 void PackageQuery::filter_downgradable() {
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, __func__);
+    if (cached.is_hit()) {
+        return;
+    }
     auto & pool = get_rpm_pool(p_impl->base);
-    auto * installed_repo = pool->installed;
-
     if (pool->installed == nullptr) {
         clear();
         return;
     }
 
-    auto sack = p_impl->base->get_rpm_package_sack();
-    sack->p_impl->make_provides_ready();
+    auto & upgrade_index = p_impl->base->get_rpm_package_sack()->p_impl->get_upgrade_index();
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
 
-    for (auto pkg_id : sack->p_impl->get_solvables()) {
+    // only the available packages with the name of an installed package can upgrade or downgrade it
+    for (auto pkg_id : upgrade_index.get_available()) {
         if (p_pq_impl->flags == ExcludeFlags::APPLY_EXCLUDES) {
             if (pool.is_considered_map_active() && !pool.get_considered_map().contains_unsafe(pkg_id)) {
                 continue;
@@ -2359,11 +2730,7 @@ void PackageQuery::filter_downgradable() {
             }
         }
 
-        Solvable * solvable = pool.id2solvable(pkg_id);
-        if (solvable->repo == installed_repo) {
-            continue;
-        }
-        Id what = what_downgrades(pool, solvable);
+        Id what = upgrade_index.what_downgrades(pool, pool.id2solvable(pkg_id));
         if (what != 0) {
             filter_result.add_unsafe(what);
         }
@@ -2419,9 +2786,14 @@ static void add_block_to_map(
     }
 }
 
-static int latest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+struct EvrSortData {
+    libdnf5::solv::RpmPool & pool;
+    const libdnf5::solv::EvrRankTable & evr_ranks;
+};
+
+static int latest_cmp(const Id * ap, const Id * bp, const EvrSortData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
@@ -2429,15 +2801,15 @@ static int latest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * poo
     r = sa->arch - sb->arch;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
+    r = data->evr_ranks.compare(sb->evr, sa->evr);
     if (r)
         return r;
     return *ap - *bp;
 }
 
-static int earliest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+static int earliest_cmp(const Id * ap, const Id * bp, const EvrSortData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
@@ -2445,7 +2817,7 @@ static int earliest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * p
     r = sa->arch - sb->arch;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
+    r = data->evr_ranks.compare(sb->evr, sa->evr);
     if (r > 0)
         return -1;
     if (r < 0)
@@ -2456,13 +2828,14 @@ static int earliest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * p
 static void filter_first_sorted_by(
     libdnf5::solv::RpmPool & pool,
     int limit,
-    int (*cmp)(const Id * a, const Id * b, libdnf5::solv::RpmPool * pool),
+    int (*cmp)(const Id * a, const Id * b, const EvrSortData * data),
     libdnf5::solv::SolvMap & data) {
     libdnf5::solv::IdQueue samename;
     for (Id candidate_id : data) {
         samename.push_back(candidate_id);
     }
-    samename.sort(cmp, &pool);
+    const EvrSortData sort_data{pool, get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::EVR, data)};
+    samename.sort(cmp, &sort_data);
 
     data.clear();
     // Create blocks per name, arch
@@ -2489,56 +2862,41 @@ static void filter_first_sorted_by(
 }
 
 void PackageQuery::filter_latest_evr(int limit) {
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, fmt::format("{} {}", __func__, limit));
+    if (cached.is_hit()) {
+        return;
+    }
     filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, latest_cmp, *p_impl);
 }
 
 void PackageQuery::filter_earliest_evr(int limit) {
-    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, earliest_cmp, *p_impl);
-}
-
-static inline bool priority_solvable_cmp_key(const Solvable * first, const Solvable * second) {
-    if (first->name != second->name) {
-        return first->name < second->name;
-    }
-    if (first->arch != second->arch) {
-        return first->arch < second->arch;
+    p_pq_impl->flush_deferred_filters(*this);
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, fmt::format("{} {}", __func__, limit));
+    if (cached.is_hit()) {
+        return;
     }
-    return first->repo->priority > second->repo->priority;
+    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, earliest_cmp, *p_impl);
 }
 
 void PackageQuery::filter_priority() {
-    auto & pool = get_rpm_pool(p_impl->base);
-
-    std::vector<Solvable *> sorted_priority;
-    for (Id candidate_id : *p_impl) {
-        Solvable * considered = pool.id2solvable(candidate_id);
-        if (pool.is_installed(considered)) {
-            continue;
-        }
-        p_impl->remove_unsafe(candidate_id);
-        sorted_priority.push_back(considered);
-    }
-    std::sort(sorted_priority.begin(), sorted_priority.end(), priority_solvable_cmp_key);
-
-    Id name = 0;
-    Id arch = 0;
-    int priority = 0;
-    for (Solvable * candidate : sorted_priority) {
-        if (candidate->name == name && candidate->arch == arch) {
-            if (candidate->repo->priority == priority) {
-                p_impl->add_unsafe(pool.solvable2id(candidate));
-            }
-        } else {
-            name = candidate->name;
-            arch = candidate->arch;
-            priority = candidate->repo->priority;
-            p_impl->add_unsafe(pool.solvable2id(candidate));
-        }
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & priority_index = p_impl->base->get_rpm_package_sack()->p_impl->get_priority_index();
+    // The result depends on the repo priorities, they are a part of the cache signature
+    std::string signature(__func__);
+    for (int priority : priority_index.get_repo_priorities()) {
+        signature.append(" ").append(std::to_string(priority));
+    }
+    PQImpl::CachedFilter cached(p_impl->base, *p_impl, p_pq_impl->flags, signature);
+    if (cached.is_hit()) {
+        return;
     }
+    priority_index.filter(get_rpm_pool(p_impl->base), *p_impl);
 }
 
 std::pair<bool, libdnf5::rpm::Nevra> PackageQuery::resolve_pkg_spec(
     const std::string & pkg_spec, const ResolveSpecSettings & settings, bool with_src) {
+    p_pq_impl->flush_deferred_filters(*this);
     auto & pool = get_rpm_pool(p_impl->base);
     auto sack = p_impl->base->get_rpm_package_sack();
 
@@ -2550,11 +2908,16 @@ std::pair<bool, libdnf5::rpm::Nevra> PackageQuery::resolve_pkg_spec(
         const std::vector<Nevra::Form> & test_forms =
             settings.nevra_forms.empty() ? Nevra::get_default_pkg_spec_forms() : settings.nevra_forms;
         try {
-            auto nevras = rpm::Nevra::parse(pkg_spec, test_forms);
-            for (auto & nevra_obj : nevras) {
+            // The forms are split without allocations, only the matching one is copied into the result
+            NevraParser parser(pkg_spec);
+            NevraView nevra_view;
+            for (auto form : test_forms) {
+                if (!parser.parse(form, nevra_view)) {
+                    continue;
+                }
                 PQImpl::filter_nevra(
                     *this,
-                    nevra_obj,
+                    NevraPattern(nevra_view),
                     glob,
                     settings.ignore_case ? (cmp | libdnf5::sack::QueryCmp::ICASE) : cmp,
                     filter_result,
@@ -2563,7 +2926,7 @@ std::pair<bool, libdnf5::rpm::Nevra> PackageQuery::resolve_pkg_spec(
                 if (!filter_result.empty()) {
                     // Apply filter results to query
                     *p_impl &= filter_result;
-                    return {true, libdnf5::rpm::Nevra(nevra_obj)};
+                    return {true, nevra_view.to_nevra()};
                 }
             }
             // When parsed nevra search failed only string with glob can match full nevra
@@ -2652,12 +3015,252 @@ std::pair<bool, libdnf5::rpm::Nevra> PackageQuery::resolve_pkg_spec(
     return {false, libdnf5::rpm::Nevra()};
 }
 
+std::vector<std::pair<bool, libdnf5::rpm::Nevra>> PackageQuery::resolve_pkg_specs(
+    const std::vector<std::string> & pkg_specs,
+    const ResolveSpecSettings & settings,
+    bool with_src,
+    std::vector<PackageQuery> & queries) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & pool = get_rpm_pool(p_impl->base);
+    auto sack = p_impl->base->get_rpm_package_sack();
+
+    std::vector<std::pair<bool, libdnf5::rpm::Nevra>> results(pkg_specs.size(), {false, libdnf5::rpm::Nevra()});
+    queries.clear();
+    queries.reserve(pkg_specs.size());
+    for (std::size_t idx = 0; idx < pkg_specs.size(); ++idx) {
+        queries.emplace_back(p_impl->base, p_pq_impl->flags, true);
+    }
+
+    // Plain names can be parsed only as the NAME form, they are resolved together when the form is tested
+    const std::vector<Nevra::Form> & test_forms =
+        settings.nevra_forms.empty() ? Nevra::get_default_pkg_spec_forms() : settings.nevra_forms;
+    bool resolve_plain_names =
+        settings.with_nevra && std::find(test_forms.begin(), test_forms.end(), Nevra::Form::NAME) != test_forms.end();
+
+    // Pairs of the name id (the lowercase name id when ignoring case) and the index of the spec
+    std::vector<std::pair<Id, std::size_t>> plain_names;
+    if (resolve_plain_names) {
+        for (std::size_t idx = 0; idx < pkg_specs.size(); ++idx) {
+            auto & pkg_spec = pkg_specs[idx];
+            if (!is_plain_name_spec(pkg_spec)) {
+                continue;
+            }
+            Id name_id = settings.ignore_case ? pool.id_to_lowercase_id(pkg_spec.c_str(), false)
+                                              : pool.str2id(pkg_spec.c_str(), false);
+            if (name_id != 0) {
+                plain_names.emplace_back(name_id, idx);
+            }
+        }
+        std::sort(plain_names.begin(), plain_names.end());
+    }
+
+    Id src = with_src ? 0 : pool.str2id("src", false);
+
+    // Both the plain names and the solvables are sorted by the name id, all plain names are resolved
+    // in a single forward pass over the solvables.
+    auto resolve_plain_names_in = [&](const auto & sorted_solvables, auto compare, auto get_name, auto get_solvable) {
+        auto low = sorted_solvables.begin();
+        for (auto name = plain_names.begin(); name != plain_names.end();) {
+            auto name_id = name->first;
+            auto name_end = name;
+            while (name_end != plain_names.end() && name_end->first == name_id) {
+                ++name_end;
+            }
+            low = std::lower_bound(low, sorted_solvables.end(), name_id, compare);
+            for (; low != sorted_solvables.end() && get_name(*low) == name_id; ++low) {
+                Solvable * solvable = get_solvable(*low);
+                Id candidate_id = pool.solvable2id(solvable);
+                if ((src != 0 && solvable->arch == src) || !p_impl->contains_unsafe(candidate_id)) {
+                    continue;
+                }
+                for (auto spec = name; spec != name_end; ++spec) {
+                    queries[spec->second].p_impl->add_unsafe(candidate_id);
+                }
+            }
+            for (auto spec = name; spec != name_end; ++spec) {
+                if (!queries[spec->second].empty()) {
+                    libdnf5::rpm::Nevra nevra;
+                    nevra.set_name(pkg_specs[spec->second]);
+                    results[spec->second] = {true, std::move(nevra)};
+                }
+            }
+            name = name_end;
+        }
+    };
+    if (settings.ignore_case) {
+        resolve_plain_names_in(
+            sack->p_impl->get_sorted_icase_solvables(),
+            name_compare_icase_lower_id,
+            [](const std::pair<Id, Solvable *> & item) { return item.first; },
+            [](const std::pair<Id, Solvable *> & item) { return item.second; });
+    } else {
+        resolve_plain_names_in(
+            sack->p_impl->get_sorted_solvables(),
+            name_compare_lower_id,
+            [](const Solvable * solvable) { return solvable->name; },
+            [](Solvable * solvable) { return solvable; });
+    }
+
+    // Name globs are tested against each distinct package name in the query only once, all of them in a single pass
+    // over the query. The globs without a match can still match full NEVRAs, they are left to the one by one
+    // resolution.
+    std::vector<std::size_t> name_globs;
+    if (resolve_plain_names && !settings.ignore_case) {
+        for (std::size_t idx = 0; idx < pkg_specs.size(); ++idx) {
+            if (is_name_glob_spec(pkg_specs[idx])) {
+                name_globs.push_back(idx);
+            }
+        }
+    }
+    if (!name_globs.empty()) {
+        // Indices of the name globs matching the name, by the name id
+        std::unordered_map<Id, std::vector<std::size_t>> matching_globs;
+        for (Id candidate_id : *p_impl) {
+            Solvable * solvable = pool.id2solvable(candidate_id);
+            if (src != 0 && solvable->arch == src) {
+                continue;
+            }
+            auto [matching_iter, inserted] = matching_globs.try_emplace(solvable->name);
+            if (inserted) {
+                const char * name = pool.id2str(solvable->name);
+                for (auto idx : name_globs) {
+                    if (fnmatch(pkg_specs[idx].c_str(), name, 0) == 0) {
+                        matching_iter->second.push_back(idx);
+                    }
+                }
+            }
+            for (auto idx : matching_iter->second) {
+                queries[idx].p_impl->add_unsafe(candidate_id);
+            }
+        }
+        for (auto idx : name_globs) {
+            if (!queries[idx].empty()) {
+                libdnf5::rpm::Nevra nevra;
+                nevra.set_name(pkg_specs[idx]);
+                results[idx] = {true, std::move(nevra)};
+            }
+        }
+    }
+
+    // The remaining specs, including plain names and name globs that do not match any package name, are resolved
+    // one by one
+    for (std::size_t idx = 0; idx < pkg_specs.size(); ++idx) {
+        if (!results[idx].first) {
+            PackageQuery query(*this);
+            results[idx] = query.resolve_pkg_spec(pkg_specs[idx], settings, with_src);
+            queries[idx] = std::move(query);
+        }
+    }
+    return results;
+}
+
 void PackageQuery::swap(PackageQuery & other) noexcept {
     PackageSet::swap(other);
     p_pq_impl.swap(other.p_pq_impl);
 }
 
+
+bool PackageQuery::PQImpl::defer(
+    PackageQuery & query,
+    const char * filter_name,
+    FilterCost cost,
+    bool exact,
+    std::function<void(PackageQuery &)> && filter) {
+    if (!deferring) {
+        return false;
+    }
+    deferred_filters.push_back({filter_name, cost, exact, std::move(filter)});
+    query.p_impl->deferred_filters_pending = true;
+    return true;
+}
+
+void PackageQuery::PQImpl::flush_deferred_filters(PackageQuery & query) {
+    if (deferred_filters.empty()) {
+        return;
+    }
+    auto filters = std::move(deferred_filters);
+    deferred_filters.clear();
+    query.p_impl->deferred_filters_pending = false;
+    std::stable_sort(filters.begin(), filters.end(), [](const DeferredFilter & first, const DeferredFilter & second) {
+        if (first.cost != second.cost) {
+            return first.cost < second.cost;
+        }
+        return first.exact && !second.exact;
+    });
+
+    auto logger = query.get_base()->get_logger();
+    bool was_deferring = std::exchange(deferring, false);
+    utils::OnScopeExit restore_deferring([this, was_deferring]() noexcept { deferring = was_deferring; });
+    for (std::size_t idx = 0; idx < filters.size(); ++idx) {
+        auto start = std::chrono::steady_clock::now();
+        filters[idx].filter(query);
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        logger->debug(
+            "Deferred query filter {}/{}: {} took {} us, {} packages left",
+            idx + 1,
+            filters.size(),
+            filters[idx].name,
+            duration.count(),
+            query.p_impl->size());
+    }
+}
+
+void PackageQuery::defer_filters() {
+    p_pq_impl->deferring = true;
+}
+
+void PackageQuery::apply_deferred_filters() {
+    p_pq_impl->flush_deferred_filters(*this);
+    p_pq_impl->deferring = false;
+}
+
+// Applying the recorded filters in the const methods doesn't change the content the caller observes,
+// the content of the query is the result of all the filters called on it.
+PackageQuery::iterator PackageQuery::begin() const {
+    p_pq_impl->flush_deferred_filters(const_cast<PackageQuery &>(*this));
+    return PackageSet::begin();
+}
+
+PackageQuery::iterator PackageQuery::end() const {
+    p_pq_impl->flush_deferred_filters(const_cast<PackageQuery &>(*this));
+    return PackageSet::end();
+}
+
+PackageQuery & PackageQuery::operator|=(const PackageSet & other) {
+    p_pq_impl->flush_deferred_filters(*this);
+    PackageSet::operator|=(other);
+    return *this;
+}
+
+PackageQuery & PackageQuery::operator-=(const PackageSet & other) {
+    p_pq_impl->flush_deferred_filters(*this);
+    PackageSet::operator-=(other);
+    return *this;
+}
+
+PackageQuery & PackageQuery::operator&=(const PackageSet & other) {
+    p_pq_impl->flush_deferred_filters(*this);
+    PackageSet::operator&=(other);
+    return *this;
+}
+
+bool PackageQuery::empty() const {
+    p_pq_impl->flush_deferred_filters(const_cast<PackageQuery &>(*this));
+    return PackageSet::empty();
+}
+
+bool PackageQuery::contains(const Package & pkg) const {
+    p_pq_impl->flush_deferred_filters(const_cast<PackageQuery &>(*this));
+    return PackageSet::contains(pkg);
+}
+
+size_t PackageQuery::size() const {
+    p_pq_impl->flush_deferred_filters(const_cast<PackageQuery &>(*this));
+    return PackageSet::size();
+}
+
 void PackageQuery::filter_duplicates() {
+    p_pq_impl->flush_deferred_filters(*this);
     auto & pool = get_rpm_pool(p_impl->base);
 
     filter_installed();
@@ -2666,7 +3269,8 @@ void PackageQuery::filter_duplicates() {
     for (Id candidate_id : *p_impl) {
         samename.push_back(candidate_id);
     }
-    samename.sort(latest_cmp, &pool);
+    const EvrSortData sort_data{pool, get_evr_rank_table(pool, libdnf5::solv::EvrRankTable::Part::EVR, *p_impl)};
+    samename.sort(latest_cmp, &sort_data);
 
     p_impl->clear();
     // Create blocks per name, arch
@@ -2695,6 +3299,7 @@ void PackageQuery::filter_duplicates() {
 }
 
 std::vector<std::vector<Package>> PackageQuery::filter_leaves(bool return_grouped_leaves) {
+    p_pq_impl->flush_deferred_filters(*this);
     std::vector<std::vector<Package>> grouped_leaves;
     auto & pool = get_rpm_pool(p_impl->base);
 
@@ -2703,11 +3308,11 @@ std::vector<std::vector<Package>> PackageQuery::filter_leaves(bool return_groupe
 
     // build the directed graph of dependencies
     bool use_recommends = p_impl->base->get_config().get_install_weak_deps_option().get_value();
-    auto graph = build_graph(*p_impl->base, *this, pkgs, use_recommends);
+    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    auto graph = build_graph(pool, pkgs, use_recommends);
 
-    // run Kosaraju's algorithm to find strongly connected components
-    // without any incoming edges
-    auto leaves = kosaraju(graph);
+    // find strongly connected components without any incoming edges
+    auto leaves = find_leaf_components(graph);
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     if (return_grouped_leaves) {
@@ -2735,14 +3340,45 @@ std::vector<std::vector<Package>> PackageQuery::filter_leaves(bool return_groupe
 }
 
 void PackageQuery::filter_leaves() {
+    p_pq_impl->flush_deferred_filters(*this);
     filter_leaves(false);
 }
 
 std::vector<std::vector<Package>> PackageQuery::filter_leaves_groups() {
+    p_pq_impl->flush_deferred_filters(*this);
     return filter_leaves(true);
 }
 
+void PackageQuery::extend_by_requires_closure(const PackageSet & candidates) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & pool = get_rpm_pool(p_impl->base);
+    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    *p_impl = requires_closure(pool, *p_impl, *candidates.p_impl);
+}
+
+void PackageQuery::extend_by_required_by_closure(const PackageSet & candidates) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & pool = get_rpm_pool(p_impl->base);
+    auto & sack_impl = *p_impl->base->get_rpm_package_sack()->p_impl;
+    sack_impl.make_provides_ready();
+    auto & index = sack_impl.get_reverse_dep_index(SOLVABLE_REQUIRES);
+    *p_impl = required_by_closure(pool, index, *p_impl, *candidates.p_impl);
+}
+
+void PackageQuery::filter_sources_of(const PackageSet & package_set) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & source_index = p_impl->base->get_rpm_package_sack()->p_impl->get_source_index();
+    source_index.filter_sources_of(*p_impl, *package_set.p_impl);
+}
+
+void PackageQuery::filter_built_from(const PackageSet & package_set) {
+    p_pq_impl->flush_deferred_filters(*this);
+    auto & source_index = p_impl->base->get_rpm_package_sack()->p_impl->get_source_index();
+    source_index.filter_built_from(*p_impl, *package_set.p_impl);
+}
+
 void PackageQuery::filter_recent(const time_t timestamp) {
+    p_pq_impl->flush_deferred_filters(*this);
     auto & pool = get_rpm_pool(p_impl->base);
     const unsigned long long time_long = static_cast<unsigned long long>(timestamp);
 
@@ -2756,6 +3392,7 @@ void PackageQuery::filter_recent(const time_t timestamp) {
 }
 
 void PackageQuery::filter_userinstalled() {
+    p_pq_impl->flush_deferred_filters(*this);
     auto & pool = get_rpm_pool(p_impl->base);
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     filter_installed();
@@ -2770,6 +3407,7 @@ void PackageQuery::filter_userinstalled() {
 }
 
 void PackageQuery::filter_unneeded() {
+    p_pq_impl->flush_deferred_filters(*this);
     auto & pool = get_rpm_pool(p_impl->base);
 
     auto * installed_repo = pool->installed;
@@ -2778,6 +3416,22 @@ void PackageQuery::filter_unneeded() {
         return;
     }
 
+    // The unneeded packages depend only on the installed packages, the considered map and the package reasons.
+    // Changes of the first two drop the cached set, the reasons are checked by their generation.
+    auto & sack = *p_impl->base->get_rpm_package_sack()->p_impl;
+    const auto reasons_generation = InternalBaseUser::get_system_state(p_impl->base).get_package_reasons_generation();
+    auto & cfg_main = p_impl->base->get_config();
+    const bool debug_solver = cfg_main.get_debug_solver_option().get_value();
+    std::optional<libdnf5::solv::SolvMap> validated_unneeded;
+    if (const auto * cached_unneeded = sack.get_cached_unneeded(reasons_generation)) {
+        if (sack.get_validate_unneeded_cache()) {
+            validated_unneeded = *cached_unneeded;
+        } else if (!debug_solver) {
+            *p_impl &= *cached_unneeded;
+            return;
+        }
+    }
+
     libdnf5::solv::IdQueue job_userinstalled;
     PackageQuery user_installed(p_impl->base);
     user_installed.filter_userinstalled();
@@ -2791,8 +3445,7 @@ void PackageQuery::filter_unneeded() {
     solver.solve(job_userinstalled);
 
     // write autoremove debug data if required
-    auto & cfg_main = p_impl->base->get_config();
-    if (cfg_main.get_debug_solver_option().get_value()) {
+    if (debug_solver) {
         auto debug_dir =
             std::filesystem::absolute(std::filesystem::path(cfg_main.get_debugdir_option().get_value()) / "autoremove");
         solver.write_debugdata(debug_dir);
@@ -2806,10 +3459,24 @@ void PackageQuery::filter_unneeded() {
         unneeded_solv_map.add(unneeded_queue[i]);
     }
 
+    if (validated_unneeded) {
+        auto stale = *validated_unneeded;
+        stale -= unneeded_solv_map;
+        auto missing = unneeded_solv_map;
+        missing -= *validated_unneeded;
+        libdnf_assert(
+            stale.empty() && missing.empty(),
+            "Cached unneeded packages differ from the recomputed ones: {} stale, {} missing",
+            stale.size(),
+            missing.size());
+    }
+
     *p_impl &= unneeded_solv_map;
+    sack.set_cached_unneeded(std::move(unneeded_solv_map), reasons_generation);
 }
 
 void PackageQuery::filter_extras(const bool exact_evr) {
+    p_pq_impl->flush_deferred_filters(*this);
     filter_installed();
     // Create query with available packages without non-modular excludes.
     // As extras should be considered also packages in non-active modules.
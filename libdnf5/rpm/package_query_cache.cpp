@@ -0,0 +1,79 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_query_cache.hpp"
+
+#include <functional>
+#include <string_view>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+std::string_view map_bytes(const libdnf5::solv::SolvMap & map) {
+    auto & solv_map = map.get_map();
+    return {reinterpret_cast<const char *>(solv_map.map), static_cast<std::size_t>(solv_map.size)};
+}
+
+}  // namespace
+
+
+std::string PackageQueryCache::make_key(const std::string & signature, const libdnf5::solv::SolvMap & input) {
+    auto input_hash = std::hash<std::string_view>{}(map_bytes(input));
+    return signature + '\0' + std::to_string(input_hash);
+}
+
+
+bool PackageQueryCache::lookup(const std::string & signature, libdnf5::solv::SolvMap & packages) {
+    auto it = entries.find(make_key(signature, packages));
+    // The input is compared to rule out hash collisions
+    if (it == entries.end() || map_bytes(it->second.input) != map_bytes(packages)) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    packages = it->second.result;
+    return true;
+}
+
+
+void PackageQueryCache::store(
+    const std::string & signature, const libdnf5::solv::SolvMap & input, const libdnf5::solv::SolvMap & result) {
+    if (entries.size() >= MAX_ENTRIES) {
+        entries.clear();
+    }
+    entries.insert_or_assign(make_key(signature, input), Entry{input, result});
+}
+
+
+void PackageQueryCache::invalidate() noexcept {
+    entries.clear();
+}
+
+std::size_t PackageQueryCache::get_memory_usage() const noexcept {
+    std::size_t bytes = 0;
+    for (const auto & [key, entry] : entries) {
+        bytes += sizeof(key) + key.capacity() + sizeof(entry) + entry.input.get_memory_usage() +
+                 entry.result.get_memory_usage();
+    }
+    return bytes;
+}
+
+}  // namespace libdnf5::rpm
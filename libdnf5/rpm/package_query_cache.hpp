@@ -0,0 +1,74 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_QUERY_CACHE_HPP
+#define LIBDNF5_RPM_PACKAGE_QUERY_CACHE_HPP
+
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+
+namespace libdnf5::rpm {
+
+/// Cache of the results of PackageQuery filters. A result is stored for the filter signature (the filter,
+/// its arguments and the exclude flags of the query) and the input packages. All results are dropped
+/// by `invalidate()`, which has to be called whenever anything the filters depend on changes.
+class PackageQueryCache {
+public:
+    /// Maximal number of stored results, the cache is cleared when it is reached.
+    static constexpr std::size_t MAX_ENTRIES = 256;
+
+    /// Looks up the result of the filter `signature` applied to `packages`.
+    /// On a hit, `packages` are replaced by the result and true is returned.
+    bool lookup(const std::string & signature, libdnf5::solv::SolvMap & packages);
+
+    /// Stores the `result` of the filter `signature` applied to `input`.
+    void store(
+        const std::string & signature, const libdnf5::solv::SolvMap & input, const libdnf5::solv::SolvMap & result);
+
+    /// Drops all stored results.
+    void invalidate() noexcept;
+
+    std::uint64_t get_hits() const noexcept { return hits; }
+    std::uint64_t get_misses() const noexcept { return misses; }
+
+    /// Returns the memory used by the stored results in bytes.
+    std::size_t get_memory_usage() const noexcept;
+
+private:
+    struct Entry {
+        libdnf5::solv::SolvMap input;
+        libdnf5::solv::SolvMap result;
+    };
+
+    /// Returns the key of the filter `signature` applied to `input`.
+    static std::string make_key(const std::string & signature, const libdnf5::solv::SolvMap & input);
+
+    std::unordered_map<std::string, Entry> entries;
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_QUERY_CACHE_HPP
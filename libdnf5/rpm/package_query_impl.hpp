@@ -28,11 +28,53 @@ extern "C" {
 #include <solv/solvable.h>
 }
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace libdnf5::rpm {
 
 
+/// Returns the subset of candidates that may match the pattern searched with the data iterator flags,
+/// or std::nullopt when all candidates have to be matched.
+using ShortlistFunction = std::function<std::optional<libdnf5::solv::SolvMap>(
+    const std::string & pattern, int flags, const libdnf5::solv::SolvMap & candidates)>;
+
+
+/// NEVRA pattern with NUL-terminated attributes as required by libsolv and fnmatch(). The attributes of a Nevra
+/// are referenced, the attributes of a NevraView are copied into a buffer that is allocated on the heap only
+/// for long patterns. Each returned view is followed by '\0'.
+class NevraPattern {
+public:
+    explicit NevraPattern(const Nevra & nevra);
+    explicit NevraPattern(const NevraView & nevra);
+
+    NevraPattern(const NevraPattern &) = delete;
+    NevraPattern & operator=(const NevraPattern &) = delete;
+
+    std::string_view get_name() const noexcept { return name; }
+    std::string_view get_epoch() const noexcept { return epoch; }
+    std::string_view get_version() const noexcept { return version; }
+    std::string_view get_release() const noexcept { return release; }
+    std::string_view get_arch() const noexcept { return arch; }
+
+private:
+    static constexpr std::size_t SMALL_BUFFER_SIZE = 256;
+
+    std::string_view name;
+    std::string_view epoch;
+    std::string_view version;
+    std::string_view release;
+    std::string_view arch;
+    char small_buffer[SMALL_BUFFER_SIZE];
+    std::unique_ptr<char[]> large_buffer;
+};
+
+
 class PackageQuery::PQImpl {
 public:
     static void filter_provides(
@@ -53,7 +95,7 @@ public:
     /// @param cmp_glob performance optimization - it must be in synchronization with cmp_type
     static void filter_nevra(
         PackageSet & pkg_set,
-        const Nevra & pattern,
+        const NevraPattern & pattern,
         bool cmp_glob,
         libdnf5::sack::QueryCmp cmp_type,
         libdnf5::solv::SolvMap & filter_result,
@@ -78,10 +120,71 @@ public:
         const std::vector<libdnf5::advisory::AdvisoryPackage> & adv_pkgs,
         libdnf5::sack::QueryCmp cmp_type);
 
+    /// Returns shortlisting by the file index if it is enabled by the `file_search_index` option.
+    /// The index is used only for exact paths.
+    static ShortlistFunction get_file_index_shortlist(const BaseWeakPtr & base);
+
+    /// Returns shortlisting by the trigram index of the `keyname` attribute if it is enabled by the
+    /// `text_search_index` option.
+    static ShortlistFunction get_text_index_shortlist(const BaseWeakPtr & base, Id keyname);
+
+    /// Takes the result of a filter from the query cache of the package sack when the `query_cache` option is
+    /// enabled. When the result is not cached yet, it is stored at the end of the scope unless the filter throws.
+    class CachedFilter;
+
+    /// Estimated cost of testing a package by a filter, from the cheapest
+    enum class FilterCost {
+        SOLVABLE,   // Ids and strings stored directly in the solvable
+        RELDEP,     // dependencies of the solvable
+        ATTRIBUTE,  // strings looked up in the repodata (summary, url, ...)
+        FILELIST    // all files of the solvable
+    };
+
+    /// When recording is enabled, records the `filter` of the `query` and returns true.
+    /// @param exact  Whether the filter compares for equality.
+    bool defer(
+        PackageQuery & query,
+        const char * filter_name,
+        FilterCost cost,
+        bool exact,
+        std::function<void(PackageQuery &)> && filter);
+
+    /// When recording is enabled, records the call of the `filter` method with `patterns` and returns true.
+    template <typename T>
+    bool defer(
+        PackageQuery & query,
+        const char * filter_name,
+        FilterCost cost,
+        void (PackageQuery::*filter)(const std::vector<T> &, libdnf5::sack::QueryCmp),
+        const std::vector<T> & patterns,
+        libdnf5::sack::QueryCmp cmp_type) {
+        if (!deferring) {
+            return false;
+        }
+        bool exact = (cmp_type == libdnf5::sack::QueryCmp::EQ || cmp_type == libdnf5::sack::QueryCmp::IEXACT);
+        return defer(query, filter_name, cost, exact, [filter, patterns, cmp_type](PackageQuery & query) {
+            (query.*filter)(patterns, cmp_type);
+        });
+    }
+
+    /// Applies the recorded filters to the `query`, recording stays enabled.
+    void flush_deferred_filters(PackageQuery & query);
+
 private:
     friend PackageQuery;
+
+    struct DeferredFilter {
+        const char * name;
+        FilterCost cost;
+        /// Equality comparisons are expected to be more selective than globs or substrings
+        bool exact;
+        std::function<void(PackageQuery &)> filter;
+    };
+
     ExcludeFlags flags;
     std::optional<libdnf5::solv::SolvMap> considered_cache;
+    bool deferring{false};
+    std::vector<DeferredFilter> deferred_filters;
 };
 
 
@@ -0,0 +1,74 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_reasons.hpp"
+
+#include "base/base_impl.hpp"
+#include "solv/pool.hpp"
+
+#include "libdnf5/rpm/package_query.hpp"
+
+#include <string>
+
+
+namespace libdnf5::rpm {
+
+PackageReasons::PackageReasons(const BaseWeakPtr & base, std::pmr::memory_resource * resource)
+    : base(base),
+      installed_reasons(resource) {
+    if (!get_rpm_pool(base)->installed) {
+        return;
+    }
+    PackageQuery installed_query(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+    installed_query.filter_installed();
+    installed_reasons.reserve(installed_query.size());
+    for (const auto & pkg : installed_query) {
+        installed_reasons.try_emplace(get_name_arch_key(pkg.get_id().id));
+    }
+}
+
+
+std::uint64_t PackageReasons::get_name_arch_key(Id id) const {
+    auto * solvable = get_rpm_pool(base).id2solvable(id);
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(solvable->name)) << 32) |
+           static_cast<std::uint32_t>(solvable->arch);
+}
+
+
+transaction::TransactionItemReason PackageReasons::get_reason(Id id) {
+    auto it = installed_reasons.find(get_name_arch_key(id));
+    if (it == installed_reasons.end()) {
+        return transaction::TransactionItemReason::NONE;
+    }
+    if (!it->second) {
+        auto & pool = get_rpm_pool(base);
+        auto * solvable = pool.id2solvable(id);
+        std::string na = pool.id2str(solvable->name);
+        na.push_back('.');
+        na.append(pool.id2str(solvable->arch));
+        auto reason = InternalBaseUser::get_system_state(base).get_package_reason(na);
+        if (reason == transaction::TransactionItemReason::NONE) {
+            reason = transaction::TransactionItemReason::EXTERNAL_USER;
+        }
+        it->second = reason;
+    }
+    return *it->second;
+}
+
+}  // namespace libdnf5::rpm
@@ -0,0 +1,58 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_REASONS_HPP
+#define LIBDNF5_RPM_PACKAGE_REASONS_HPP
+
+#include "libdnf5/base/base_weak.hpp"
+#include "libdnf5/transaction/transaction_item_reason.hpp"
+
+#include <solv/pooltypes.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+
+
+namespace libdnf5::rpm {
+
+/// Resolves the reasons of many packages at once, with the same results as `Package::get_reason()`.
+/// The names and arches of the installed packages are collected once by their ids. The reason of a name and arch
+/// is read from the system state on the first request only. The reasons must not change during the lifetime.
+class PackageReasons {
+public:
+    /// @param resource The memory resource of the collected names and arches.
+    explicit PackageReasons(
+        const BaseWeakPtr & base, std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+
+    /// Returns the reason of the package `id`, `NONE` when no package of its name and arch is installed.
+    transaction::TransactionItemReason get_reason(Id id);
+
+private:
+    std::uint64_t get_name_arch_key(Id id) const;
+
+    BaseWeakPtr base;
+    /// The reasons by the combined name and arch ids of the installed packages, unset until requested
+    std::pmr::unordered_map<std::uint64_t, std::optional<transaction::TransactionItemReason>> installed_reasons;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_REASONS_HPP
@@ -0,0 +1,213 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_reverse_dep_index.hpp"
+
+#include "solv/id_queue.hpp"
+
+extern "C" {
+#include <solv/knownid.h>
+#include <solv/repo.h>
+}
+
+#include <algorithm>
+#include <utility>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+/// Appends to `names` the names of the provides that can satisfy dependency `dep`.
+/// Returns false when the providers of the dependency are not determined by names (e.g. namespace dependencies).
+bool collect_dep_names(const ::Pool * pool, Id dep, std::vector<Id> & names) {
+    if (!ISRELDEP(dep)) {
+        names.push_back(dep);
+        return true;
+    }
+    const ::Reldep * rd = GETRELDEP(pool, dep);
+    switch (rd->flags) {
+        case REL_GT:
+        case REL_EQ:
+        case REL_LT:
+        case REL_GT | REL_EQ:
+        case REL_LT | REL_EQ:
+        case REL_GT | REL_LT:
+        case REL_GT | REL_LT | REL_EQ:
+        case REL_ARCH:
+            return collect_dep_names(pool, rd->name, names);
+        case REL_AND:
+        case REL_OR:
+        case REL_WITH:
+        case REL_WITHOUT:
+        case REL_COND:
+        case REL_UNLESS:
+        case REL_ELSE:
+            // The providers of a rich dependency are a subset of the providers of its operands
+            return collect_dep_names(pool, rd->name, names) && collect_dep_names(pool, rd->evr, names);
+        default:
+            return false;
+    }
+}
+
+/// Returns the name of the provide `provide`.
+Id provide_name(const ::Pool * pool, Id provide) {
+    while (ISRELDEP(provide)) {
+        provide = GETRELDEP(pool, provide)->name;
+    }
+    return provide;
+}
+
+}  // namespace
+
+
+PackageReverseDepIndex::PackageReverseDepIndex(
+    const libdnf5::solv::RpmPool & pool, Id keyname, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()) {
+    std::vector<std::pair<Id, Id>> dep_solvable_pairs;
+    libdnf5::solv::IdQueue dep_ids;
+    for (Id solvable_id : package_solvables) {
+        solvable_lookup_idarray(pool.id2solvable(solvable_id), keyname, &dep_ids.get_queue());
+        for (Id dep : dep_ids) {
+            if (dep != SOLVABLE_PREREQMARKER && dep != SOLVABLE_FILEMARKER) {
+                dep_solvable_pairs.emplace_back(dep, solvable_id);
+            }
+        }
+    }
+    std::sort(dep_solvable_pairs.begin(), dep_solvable_pairs.end());
+    dep_solvable_pairs.erase(
+        std::unique(dep_solvable_pairs.begin(), dep_solvable_pairs.end()), dep_solvable_pairs.end());
+
+    dep_solvables.reserve(dep_solvable_pairs.size());
+    for (const auto & [dep, solvable_id] : dep_solvable_pairs) {
+        if (deps.empty() || deps.back() != dep) {
+            deps.push_back(dep);
+            dep_offsets.push_back(dep_solvables.size());
+        }
+        dep_solvables.push_back(solvable_id);
+    }
+    dep_offsets.push_back(dep_solvables.size());
+
+    std::vector<std::pair<Id, std::size_t>> name_dep_pairs;
+    std::vector<Id> dep_names;
+    for (std::size_t dep_idx = 0; dep_idx < deps.size(); ++dep_idx) {
+        dep_names.clear();
+        if (!collect_dep_names(*pool, deps[dep_idx], dep_names)) {
+            unnamed_deps.push_back(dep_idx);
+            continue;
+        }
+        for (Id name : dep_names) {
+            name_dep_pairs.emplace_back(name, dep_idx);
+        }
+    }
+    std::sort(name_dep_pairs.begin(), name_dep_pairs.end());
+    name_dep_pairs.erase(std::unique(name_dep_pairs.begin(), name_dep_pairs.end()), name_dep_pairs.end());
+
+    name_deps.reserve(name_dep_pairs.size());
+    for (const auto & [name, dep_idx] : name_dep_pairs) {
+        if (names.empty() || names.back() != name) {
+            names.push_back(name);
+            name_offsets.push_back(name_deps.size());
+        }
+        name_deps.push_back(dep_idx);
+    }
+    name_offsets.push_back(name_deps.size());
+
+    deps.shrink_to_fit();
+    dep_offsets.shrink_to_fit();
+    names.shrink_to_fit();
+    name_offsets.shrink_to_fit();
+    unnamed_deps.shrink_to_fit();
+}
+
+
+void PackageReverseDepIndex::add_dependents(
+    const libdnf5::solv::RpmPool & pool,
+    const libdnf5::solv::SolvMap & packages,
+    libdnf5::solv::SolvMap & result) const {
+    std::vector<bool> matched_deps;
+    add_new_dependents(pool, packages, matched_deps, result);
+}
+
+
+void PackageReverseDepIndex::add_new_dependents(
+    const libdnf5::solv::RpmPool & pool,
+    const libdnf5::solv::SolvMap & packages,
+    std::vector<bool> & matched_deps,
+    libdnf5::solv::SolvMap & result) const {
+    matched_deps.resize(deps.size(), false);
+    // A dependency is tested only once even when several packages provide its names
+    std::vector<bool> checked_deps(deps.size(), false);
+    auto check_dep = [&](std::size_t dep_idx) {
+        if (!checked_deps[dep_idx] && !matched_deps[dep_idx]) {
+            checked_deps[dep_idx] = true;
+            matched_deps[dep_idx] = add_dep_dependents(pool, dep_idx, packages, result);
+        }
+    };
+    for (Id package_id : packages) {
+        const Solvable * solvable = pool.id2solvable(package_id);
+        if (!solvable->repo || !solvable->dep_provides) {
+            continue;
+        }
+        // The provides contain also the file provides added by `pool_addfileprovides()`
+        for (const Id * provide = solvable->repo->idarraydata + solvable->dep_provides; *provide != 0; ++provide) {
+            if (*provide == SOLVABLE_FILEMARKER) {
+                continue;
+            }
+            auto name = provide_name(*pool, *provide);
+            auto it = std::lower_bound(names.begin(), names.end(), name);
+            if (it == names.end() || *it != name) {
+                continue;
+            }
+            auto name_idx = static_cast<std::size_t>(it - names.begin());
+            for (auto idx = name_offsets[name_idx]; idx < name_offsets[name_idx + 1]; ++idx) {
+                check_dep(name_deps[idx]);
+            }
+        }
+    }
+    for (auto dep_idx : unnamed_deps) {
+        check_dep(dep_idx);
+    }
+}
+
+
+bool PackageReverseDepIndex::add_dep_dependents(
+    const libdnf5::solv::RpmPool & pool,
+    std::size_t dep_idx,
+    const libdnf5::solv::SolvMap & packages,
+    libdnf5::solv::SolvMap & result) const {
+    for (const Id * provider = pool_whatprovides_ptr(*pool, deps[dep_idx]); *provider != 0; ++provider) {
+        if (packages.contains(*provider)) {
+            for (auto idx = dep_offsets[dep_idx]; idx < dep_offsets[dep_idx + 1]; ++idx) {
+                result.add_unsafe(dep_solvables[idx]);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+std::size_t PackageReverseDepIndex::get_memory_usage() const noexcept {
+    return (deps.capacity() + dep_solvables.capacity() + names.capacity()) * sizeof(Id) +
+           (dep_offsets.capacity() + name_offsets.capacity() + name_deps.capacity() + unnamed_deps.capacity()) *
+               sizeof(std::size_t);
+}
+
+}  // namespace libdnf5::rpm
@@ -0,0 +1,89 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_REVERSE_DEP_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_REVERSE_DEP_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Reverse index of one kind of dependencies (e.g. requires) of package solvables. It maps each dependency
+/// to the solvables that have it and each name to the dependencies that a provide of the name can satisfy,
+/// so the packages depending on a set of packages are found from the provides of the set instead of testing
+/// every dependency of every package in the pool.
+class PackageReverseDepIndex {
+public:
+    /// Builds the index of the `keyname` dependencies of the `package_solvables`.
+    PackageReverseDepIndex(
+        const libdnf5::solv::RpmPool & pool, Id keyname, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Adds to `result` the solvables with a dependency that is provided by any of the `packages`.
+    void add_dependents(
+        const libdnf5::solv::RpmPool & pool,
+        const libdnf5::solv::SolvMap & packages,
+        libdnf5::solv::SolvMap & result) const;
+
+    /// Adds to `result` the solvables with a dependency that is provided by any of the `packages` and is not
+    /// marked in `matched_deps` yet. The matched dependencies are marked, so that the repeated calls computing
+    /// a transitive closure match each dependency only once. Pass an empty `matched_deps` to the first call.
+    void add_new_dependents(
+        const libdnf5::solv::RpmPool & pool,
+        const libdnf5::solv::SolvMap & packages,
+        std::vector<bool> & matched_deps,
+        libdnf5::solv::SolvMap & result) const;
+
+    /// Returns the number of solvables in the pool at the time the index was built.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept;
+
+private:
+    /// Adds the solvables of dependency `dep_idx` to `result` when one of its providers is in `packages`.
+    /// Returns whether the dependency matched.
+    bool add_dep_dependents(
+        const libdnf5::solv::RpmPool & pool,
+        std::size_t dep_idx,
+        const libdnf5::solv::SolvMap & packages,
+        libdnf5::solv::SolvMap & result) const;
+
+    int nsolvables;
+    /// Sorted distinct dependencies, the solvables of `deps[i]` are
+    /// `dep_solvables[dep_offsets[i]]` ... `dep_solvables[dep_offsets[i + 1] - 1]`
+    std::vector<Id> deps;
+    std::vector<std::size_t> dep_offsets;
+    std::vector<Id> dep_solvables;
+    /// Sorted distinct names, the indexes of dependencies satisfiable by a provide of `names[i]` are
+    /// `name_deps[name_offsets[i]]` ... `name_deps[name_offsets[i + 1] - 1]`
+    std::vector<Id> names;
+    std::vector<std::size_t> name_offsets;
+    std::vector<std::size_t> name_deps;
+    /// Indexes of dependencies that cannot be assigned to names (e.g. namespace dependencies)
+    std::vector<std::size_t> unnamed_deps;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_REVERSE_DEP_INDEX_HPP
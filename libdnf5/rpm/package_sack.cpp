@@ -20,9 +20,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "package_sack_impl.hpp"
 #include "package_set_impl.hpp"
+#include "base/base_impl.hpp"
 #include "repo/solv_repo.hpp"
+#include "rpm/transaction.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/solv_map.hpp"
+#include "solv/whatprovides.hpp"
 
 #include "libdnf5/common/exception.hpp"
 #include "libdnf5/rpm/package_query.hpp"
@@ -53,6 +56,7 @@ void PackageSack::Impl::make_provides_ready() {
     if (provides_ready) {
         return;
     }
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "make provides ready");
 
     // Temporarily replaces the considered map with an empty one. Ignores "excludes" during calculation provides.
     libdnf5::solv::SolvMap original_considered_map(0);
@@ -60,11 +64,35 @@ void PackageSack::Impl::make_provides_ready() {
 
     base->get_repo_sack()->internalize_repos();
 
+    auto & pool = get_rpm_pool(base);
+    // The index is extended when only packages were appended to the pool since it was created
+    if (!provides_extendable ||
+        !libdnf5::solv::extend_whatprovides(*pool, provides_nsolvables, provides_file_deps)) {
+        create_provides();
+    }
+    provides_nsolvables = pool.get_nsolvables();
+    provides_extendable = true;
+    provides_ready = true;
+
+    // Sets the original considered map.
+    get_rpm_pool(base).swap_considered_map(original_considered_map);
+}
+
+void PackageSack::Impl::create_provides() {
     auto & pool = get_rpm_pool(base);
     libdnf5::solv::IdQueue addedfileprovides;
     libdnf5::solv::IdQueue addedfileprovides_inst;
     pool_addfileprovides_queue(*pool, &addedfileprovides.get_queue(), &addedfileprovides_inst.get_queue());
 
+    provides_file_deps.clear();
+    for (Id file_dep : addedfileprovides) {
+        provides_file_deps.push_back(file_dep);
+    }
+    for (Id file_dep : addedfileprovides_inst) {
+        provides_file_deps.push_back(file_dep);
+    }
+    std::sort(provides_file_deps.begin(), provides_file_deps.end());
+
     if (base->get_repo_sack()->has_system_repo() && !addedfileprovides_inst.empty()) {
         auto system_repo = base->get_repo_sack()->get_system_repo();
         // TODO(lukash) handle the existence of solv_repo in a unified manner?
@@ -84,14 +112,10 @@ void PackageSack::Impl::make_provides_ready() {
     }
 
     pool_createwhatprovides(*pool);
-    provides_ready = true;
-
-    // Sets the original considered map.
-    get_rpm_pool(base).swap_considered_map(original_considered_map);
 }
 
 void PackageSack::Impl::load_config_excludes_includes(bool only_main) {
-    considered_uptodate = false;
+    invalidate_considered();
 
     const auto & main_config = base->get_config();
     const auto & disable_excludes = main_config.get_disable_excludes_option().get_value();
@@ -113,6 +137,24 @@ void PackageSack::Impl::load_config_excludes_includes(bool only_main) {
         .with_filenames = false,
         .with_binaries = false};
 
+    // Adds the packages of the `query` matching any of the `patterns` to the `result`. The patterns are resolved
+    // together, see `PackageQuery::resolve_pkg_specs()`. Returns whether any package matched.
+    std::vector<PackageQuery> pattern_queries;
+    auto resolve_patterns = [&](PackageQuery & query, const std::vector<std::string> & patterns, PackageSet & result) {
+        if (patterns.empty()) {
+            return false;
+        }
+        bool found = false;
+        auto results = query.resolve_pkg_specs(patterns, resolve_settings, true, pattern_queries);
+        for (std::size_t idx = 0; idx < patterns.size(); ++idx) {
+            if (results[idx].first) {
+                result |= pattern_queries[idx];
+                found = true;
+            }
+        }
+        return found;
+    };
+
     // first evaluate repo specific includes/excludes
     if (!only_main) {
         libdnf5::repo::RepoQuery rq(base);
@@ -121,30 +163,47 @@ void PackageSack::Impl::load_config_excludes_includes(bool only_main) {
             rq.filter_id(disable_excludes, libdnf5::sack::QueryCmp::NOT_GLOB);
         }
         for (const auto & repo : rq) {
-            if (!repo->get_config().get_includepkgs_option().get_value().empty()) {
+            const auto & repo_includepkgs = repo->get_config().get_includepkgs_option().get_value();
+            const auto & repo_excludepkgs = repo->get_config().get_excludepkgs_option().get_value();
+            if (!repo_includepkgs.empty()) {
                 repo->set_use_includes(true);
                 includes_used = true;
             }
+            if (repo_includepkgs.empty() && repo_excludepkgs.empty()) {
+                continue;
+            }
 
-            PackageQuery query_repo_pkgs(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-            query_repo_pkgs.filter_repo_id({repo->get_id()});
-
-            for (const auto & name : repo->get_config().get_includepkgs_option().get_value()) {
-                PackageQuery query(query_repo_pkgs);
-                const auto & [found, nevra] = query.resolve_pkg_spec(name, resolve_settings, true);
-                if (found) {
-                    includes |= query;
-                    includes_exist = true;
-                }
+            // The matches depend only on the packages of the repository, they are reused while its solvables
+            // and the options are unchanged
+            ::Repo * solv_repo = repo->solv_repo ? repo->solv_repo->repo : nullptr;
+            auto & matches = repo_config_matches[repo->get_id()];
+            if (matches.includepkgs != repo_includepkgs || matches.excludepkgs != repo_excludepkgs ||
+                matches.solv_repo != solv_repo || !solv_repo || matches.solvables_start != solv_repo->start ||
+                matches.solvables_end != solv_repo->end || matches.nsolvables != solv_repo->nsolvables) {
+                PackageQuery query_repo_pkgs(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+                query_repo_pkgs.filter_repo_id({repo->get_id()});
+
+                PackageSet repo_includes(base);
+                PackageSet repo_excludes(base);
+                matches.includes_exist = resolve_patterns(query_repo_pkgs, repo_includepkgs, repo_includes);
+                matches.excludes_exist = resolve_patterns(query_repo_pkgs, repo_excludepkgs, repo_excludes);
+                matches.includes = *repo_includes.p_impl;
+                matches.excludes = *repo_excludes.p_impl;
+                matches.includepkgs = repo_includepkgs;
+                matches.excludepkgs = repo_excludepkgs;
+                matches.solv_repo = solv_repo;
+                matches.solvables_start = solv_repo ? solv_repo->start : 0;
+                matches.solvables_end = solv_repo ? solv_repo->end : 0;
+                matches.nsolvables = solv_repo ? solv_repo->nsolvables : 0;
             }
 
-            for (const auto & name : repo->get_config().get_excludepkgs_option().get_value()) {
-                PackageQuery query(query_repo_pkgs);
-                const auto & [found, nevra] = query.resolve_pkg_spec(name, resolve_settings, true);
-                if (found) {
-                    excludes |= query;
-                    excludes_exist = true;
-                }
+            if (matches.includes_exist) {
+                *includes.p_impl |= matches.includes;
+                includes_exist = true;
+            }
+            if (matches.excludes_exist) {
+                *excludes.p_impl |= matches.excludes;
+                excludes_exist = true;
             }
         }
     }
@@ -152,25 +211,15 @@ void PackageSack::Impl::load_config_excludes_includes(bool only_main) {
     // then main (global) includes/excludes because they can mask
     // repo specific settings
     if (std::find(disable_excludes.begin(), disable_excludes.end(), "main") == disable_excludes.end()) {
-        for (const auto & name : main_config.get_includepkgs_option().get_value()) {
-            PackageQuery query(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-            const auto & [found, nevra] = query.resolve_pkg_spec(name, resolve_settings, true);
-            if (found) {
-                includes |= query;
-                includes_exist = true;
-            }
+        const auto & main_includepkgs = main_config.get_includepkgs_option().get_value();
+        const auto & main_excludepkgs = main_config.get_excludepkgs_option().get_value();
+        if (!main_includepkgs.empty() || !main_excludepkgs.empty()) {
+            PackageQuery query_all_pkgs(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+            includes_exist |= resolve_patterns(query_all_pkgs, main_includepkgs, includes);
+            excludes_exist |= resolve_patterns(query_all_pkgs, main_excludepkgs, excludes);
         }
 
-        for (const auto & name : main_config.get_excludepkgs_option().get_value()) {
-            PackageQuery query(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
-            const auto & [found, nevra] = query.resolve_pkg_spec(name, resolve_settings, true);
-            if (found) {
-                excludes |= query;
-                excludes_exist = true;
-            }
-        }
-
-        if (!main_config.get_includepkgs_option().get_value().empty()) {
+        if (!main_includepkgs.empty()) {
             // enable the use of includes for all repositories
             for (const auto & repo : base->get_repo_sack()->get_data()) {
                 repo->set_use_includes(true);
@@ -205,7 +254,7 @@ const PackageSet PackageSack::Impl::get_user_excludes() {
 void PackageSack::Impl::add_user_excludes(const PackageSet & excludes) {
     if (user_excludes) {
         *user_excludes |= *excludes.p_impl;
-        considered_uptodate = false;
+        update_considered(*excludes.p_impl);
     } else {
         set_user_excludes(excludes);
     }
@@ -214,18 +263,18 @@ void PackageSack::Impl::add_user_excludes(const PackageSet & excludes) {
 void PackageSack::Impl::remove_user_excludes(const PackageSet & excludes) {
     if (user_excludes) {
         *user_excludes -= *excludes.p_impl;
-        considered_uptodate = false;
+        update_considered(*excludes.p_impl);
     }
 }
 
 void PackageSack::Impl::set_user_excludes(const PackageSet & excludes) {
     user_excludes.reset(new libdnf5::solv::SolvMap(*excludes.p_impl));
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 void PackageSack::Impl::clear_user_excludes() {
     user_excludes.reset();
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 const PackageSet PackageSack::Impl::get_user_includes() {
@@ -239,7 +288,7 @@ const PackageSet PackageSack::Impl::get_user_includes() {
 void PackageSack::Impl::add_user_includes(const PackageSet & includes) {
     if (user_includes) {
         *user_includes |= *includes.p_impl;
-        considered_uptodate = false;
+        update_considered(*includes.p_impl);
     } else {
         set_user_includes(includes);
     }
@@ -248,7 +297,7 @@ void PackageSack::Impl::add_user_includes(const PackageSet & includes) {
 void PackageSack::Impl::remove_user_includes(const PackageSet & includes) {
     if (user_includes) {
         *user_includes -= *includes.p_impl;
-        considered_uptodate = false;
+        update_considered(*includes.p_impl);
     }
 }
 
@@ -258,12 +307,12 @@ void PackageSack::Impl::set_user_includes(const PackageSet & includes) {
     for (const auto & repo : base->get_repo_sack()->get_data()) {
         repo->set_use_includes(true);
     }
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 void PackageSack::Impl::clear_user_includes() {
     user_includes.reset();
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 const PackageSet PackageSack::Impl::get_module_excludes() {
@@ -277,7 +326,7 @@ const PackageSet PackageSack::Impl::get_module_excludes() {
 void PackageSack::Impl::add_module_excludes(const PackageSet & excludes) {
     if (module_excludes) {
         *module_excludes |= *excludes.p_impl;
-        considered_uptodate = false;
+        update_considered(*excludes.p_impl);
     } else {
         set_module_excludes(excludes);
     }
@@ -286,18 +335,18 @@ void PackageSack::Impl::add_module_excludes(const PackageSet & excludes) {
 void PackageSack::Impl::remove_module_excludes(const PackageSet & excludes) {
     if (module_excludes) {
         *module_excludes -= *excludes.p_impl;
-        considered_uptodate = false;
+        update_considered(*excludes.p_impl);
     }
 }
 
 void PackageSack::Impl::set_module_excludes(const PackageSet & excludes) {
     module_excludes.reset(new libdnf5::solv::SolvMap(*excludes.p_impl));
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 void PackageSack::Impl::clear_module_excludes() {
     module_excludes.reset();
-    considered_uptodate = false;
+    invalidate_considered();
 }
 
 std::optional<libdnf5::solv::SolvMap> PackageSack::Impl::compute_considered_map(
@@ -373,14 +422,135 @@ std::optional<libdnf5::solv::SolvMap> PackageSack::Impl::compute_considered_map(
     return considered;
 }
 
+const std::optional<libdnf5::solv::SolvMap> & PackageSack::Impl::get_considered_map(
+    libdnf5::sack::ExcludeFlags flags) {
+    auto nsolvables = get_nsolvables();
+    if (nsolvables != cached_considered_maps_size) {
+        cached_considered_maps.clear();
+        cached_considered_maps_size = nsolvables;
+    }
+    auto it = cached_considered_maps.find(flags);
+    if (it == cached_considered_maps.end()) {
+        it = cached_considered_maps.emplace(flags, compute_considered_map(flags)).first;
+    }
+    return it->second;
+}
+
+void PackageSack::Impl::add_memory_usage(libdnf5::repo::MemoryUsage & usage) const {
+    auto solv_map_bytes = [](const std::unique_ptr<libdnf5::solv::SolvMap> & map) -> std::size_t {
+        return map ? map->get_memory_usage() : 0;
+    };
+
+    usage.sorted_solvables_bytes += cached_sorted_solvables.capacity() * sizeof(Solvable *) +
+                                    cached_sorted_icase_solvables.capacity() * sizeof(std::pair<Id, Solvable *>) +
+                                    cached_name_sorted_solvables.capacity() * sizeof(Solvable *);
+
+    usage.package_indexes_bytes += cached_name_arena.names.capacity() + cached_name_arena.icase_names.capacity() +
+                                   cached_name_arena.name_offsets.capacity() * sizeof(size_t) +
+                                   cached_name_arena.solvable_offsets.capacity() * sizeof(size_t);
+    for (const auto & [keyname, index] : cached_text_indexes) {
+        usage.package_indexes_bytes += index.get_memory_usage();
+    }
+    if (cached_file_index) {
+        usage.package_indexes_bytes += cached_file_index->get_memory_usage();
+    }
+    for (const auto & [keyname, index] : cached_reverse_dep_indexes) {
+        usage.package_indexes_bytes += index.get_memory_usage();
+    }
+    if (cached_source_index) {
+        usage.package_indexes_bytes += cached_source_index->get_memory_usage();
+    }
+    if (cached_priority_index) {
+        usage.package_indexes_bytes += cached_priority_index->get_memory_usage();
+    }
+    if (cached_upgrade_index) {
+        usage.package_indexes_bytes += cached_upgrade_index->get_memory_usage();
+    }
+
+    usage.considered_maps_bytes += solv_map_bytes(config_excludes) + solv_map_bytes(config_includes) +
+                                   solv_map_bytes(user_excludes) + solv_map_bytes(user_includes) +
+                                   solv_map_bytes(repo_excludes) + solv_map_bytes(module_excludes);
+    for (const auto & [flags, map] : cached_considered_maps) {
+        if (map) {
+            usage.considered_maps_bytes += map->get_memory_usage();
+        }
+    }
+
+    usage.package_caches_bytes += query_cache.get_memory_usage() + resolve_cache.get_memory_usage() +
+                                  cached_solvables.get_memory_usage();
+    if (cached_unneeded) {
+        usage.package_caches_bytes += cached_unneeded->unneeded.get_memory_usage();
+    }
+    if (cached_weak_excludes) {
+        usage.package_caches_bytes += cached_weak_excludes->excludes.get_memory_usage();
+    }
+    if (cached_protected_packages) {
+        usage.package_caches_bytes += cached_protected_packages->packages.get_memory_usage();
+    }
+}
+
+bool PackageSack::Impl::is_considered(Id id, libdnf5::sack::ExcludeFlags flags) const {
+    auto contains = [id](const std::unique_ptr<libdnf5::solv::SolvMap> & map) { return map && map->contains(id); };
+
+    if (!static_cast<bool>(flags & libdnf5::sack::ExcludeFlags::IGNORE_MODULAR_EXCLUDES) && contains(module_excludes)) {
+        return false;
+    }
+    if (!static_cast<bool>(flags & libdnf5::sack::ExcludeFlags::USE_DISABLED_REPOSITORIES) && contains(repo_excludes)) {
+        return false;
+    }
+    if (static_cast<bool>(flags & libdnf5::sack::ExcludeFlags::IGNORE_REGULAR_EXCLUDES)) {
+        return true;
+    }
+    if (contains(config_excludes) || contains(user_excludes)) {
+        return false;
+    }
+    if (!config_includes && !user_includes) {
+        return true;
+    }
+    if (contains(config_includes) || contains(user_includes)) {
+        return true;
+    }
+
+    // All solvables from repositories which do not use "includes" are included
+    auto * solvable = get_rpm_pool(base).id2solvable(id);
+    if (solvable->repo == nullptr || solvable->repo->appdata == nullptr) {
+        return false;
+    }
+    return !libdnf5::solv::get_repo(solvable).get_use_includes();
+}
+
+void PackageSack::Impl::update_considered(const libdnf5::solv::SolvMap & changed) {
+    if (get_nsolvables() != cached_considered_maps_size) {
+        cached_considered_maps.clear();
+    }
+    for (auto & [flags, considered] : cached_considered_maps) {
+        // Without a map no existing excludes or includes apply to the flags, the change does not apply either
+        if (!considered) {
+            continue;
+        }
+        for (Id id : changed) {
+            if (id >= cached_considered_maps_size) {
+                break;
+            }
+            if (is_considered(id, flags)) {
+                considered->add_unsafe(id);
+            } else {
+                considered->remove_unsafe(id);
+            }
+        }
+    }
+    invalidate_considered_results();
+}
+
 void PackageSack::Impl::recompute_considered_in_pool() {
     if (considered_uptodate) {
         return;
     }
 
-    auto considered = compute_considered_map(libdnf5::sack::ExcludeFlags::APPLY_EXCLUDES);
+    const auto & considered = get_considered_map(libdnf5::sack::ExcludeFlags::APPLY_EXCLUDES);
     if (considered) {
-        get_rpm_pool(base).swap_considered_map(*considered);
+        libdnf5::solv::SolvMap considered_copy(*considered);
+        get_rpm_pool(base).swap_considered_map(considered_copy);
     } else {
         libdnf5::solv::SolvMap empty_map(0);
         get_rpm_pool(base).swap_considered_map(empty_map);
@@ -401,6 +571,22 @@ int PackageSack::get_nsolvables() const noexcept {
     return p_impl->get_nsolvables();
 };
 
+std::uint64_t PackageSack::get_query_cache_hits() const noexcept {
+    return p_impl->query_cache.get_hits();
+}
+
+std::uint64_t PackageSack::get_query_cache_misses() const noexcept {
+    return p_impl->query_cache.get_misses();
+}
+
+std::uint64_t PackageSack::get_resolve_cache_hits() const noexcept {
+    return p_impl->resolve_cache.get_hits();
+}
+
+std::uint64_t PackageSack::get_resolve_cache_misses() const noexcept {
+    return p_impl->resolve_cache.get_misses();
+}
+
 PackageSack::PackageSack(const BaseWeakPtr & base) : p_impl{new Impl(base)} {}
 
 PackageSack::PackageSack(libdnf5::Base & base) : PackageSack(base.get_weak_ptr()) {}
@@ -477,8 +663,31 @@ rpm::PackageId PackageSack::Impl::get_running_kernel_id() {
         return running_kernel;
     }
 
+    std::string un_release = un.release;
+
+    // The package of the running kernel found by a previous run is reused while the kernel and the installed
+    // packages stay the same, the file provides of the installed packages are not queried then
+    auto & system_state = InternalBaseUser::get_system_state(base);
+    std::string rpmdb_cookie;
+    try {
+        rpmdb_cookie = libdnf5::rpm::Transaction(base).get_db_cookie();
+        auto cached_nevra = system_state.get_running_kernel_nevra(un_release, rpmdb_cookie);
+        if (!cached_nevra.empty()) {
+            libdnf5::rpm::PackageQuery cached_query(base, libdnf5::rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+            cached_query.filter_installed();
+            cached_query.filter_nevra(std::vector<std::string>{cached_nevra});
+            if (!cached_query.empty()) {
+                libdnf5::rpm::Package kernel_pkg = *cached_query.begin();
+                running_kernel = kernel_pkg.get_id();
+                logger.debug("Found running kernel: {}", kernel_pkg.get_full_nevra());
+                return running_kernel;
+            }
+        }
+    } catch (const std::exception & ex) {
+        logger.debug("Cannot use the cached running kernel package: {}", ex.what());
+    }
+
     std::string fn("/boot/vmlinuz-");
-    auto un_release = un.release;
     fn.append(un_release);
     auto query = running_kernel_check_path(base, fn);
 
@@ -496,6 +705,14 @@ rpm::PackageId PackageSack::Impl::get_running_kernel_id() {
         libdnf5::rpm::Package kernel_pkg = *query.begin();
         running_kernel = kernel_pkg.get_id();
         logger.debug("Found running kernel: {}", kernel_pkg.get_full_nevra());
+        if (!rpmdb_cookie.empty()) {
+            try {
+                system_state.set_running_kernel_nevra(un_release, rpmdb_cookie, kernel_pkg.get_nevra());
+            } catch (const std::exception & ex) {
+                // e.g. a user without write access to the system state directory
+                logger.debug("Cannot store the running kernel package: {}", ex.what());
+            }
+        }
     }
     return running_kernel;
 }
@@ -20,19 +20,35 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF5_RPM_PACKAGE_SACK_IMPL_HPP
 #define LIBDNF5_RPM_PACKAGE_SACK_IMPL_HPP
 
+#include "package_file_index.hpp"
+#include "package_priority_index.hpp"
+#include "package_query_cache.hpp"
+#include "package_reverse_dep_index.hpp"
+#include "package_source_index.hpp"
+#include "package_text_index.hpp"
+#include "package_upgrade_index.hpp"
+#include "rpm/solv/resolve_cache.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
 
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/common/sack/exclude_flags.hpp"
+#include "libdnf5/repo/memory_usage.hpp"
 #include "libdnf5/rpm/package.hpp"
 
 extern "C" {
 #include <solv/pool.h>
 }
 
+#include <strings.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <map>
 #include <optional>
+#include <string>
 #include <vector>
 
 
@@ -60,6 +76,19 @@ static inline bool nevra_solvable_cmp_icase_key(
 
 namespace libdnf5::rpm {
 
+/// Distinct names of all package solvables stored one after another in a contiguous memory.
+/// Allows to search for a substring in all names at once instead of per solvable.
+struct PackageNameArena {
+    /// Names in the order of `get_sorted_solvables()`, each one terminated by '\0'
+    std::string names;
+    /// The same as `names` converted to lowercase, the offsets of the names are identical
+    std::string icase_names;
+    /// Offset of the i-th name in `names`, the last item is the size of `names`
+    std::vector<size_t> name_offsets;
+    /// Index of the first solvable with the i-th name in `get_sorted_solvables()`, the last item is their count
+    std::vector<size_t> solvable_offsets;
+};
+
 class PackageSack::Impl {
 public:
     explicit Impl(const BaseWeakPtr & base) : base(base) {}
@@ -76,9 +105,93 @@ public:
     /// Return sorted list of all package solvables in format pair<id_of_lowercase_name, Solvable *>
     std::vector<std::pair<Id, Solvable *>> & get_sorted_icase_solvables();
 
+    /// Return the generation of the sorted solvable indices, it changes whenever the set of package solvables
+    /// in the indices changes. Updates the indices first.
+    uint64_t get_sorted_solvables_generation() {
+        get_sorted_solvables();
+        return sorted_solvables_generation;
+    }
+
+    /// Return list of all package solvables sorted case-insensitively by the name string.
+    /// Solvables with a common name prefix form a continuous range, which allows narrowing of glob filters.
+    std::vector<Solvable *> & get_name_sorted_solvables();
+
+    /// Return the arena with distinct names of all package solvables
+    const PackageNameArena & get_name_arena();
+
+    /// Return the trigram index of the `keyname` attribute of all package solvables
+    const PackageTextIndex & get_text_index(Id keyname);
+
+    /// Return the index of the filelists of all package solvables
+    const PackageFileIndex & get_file_index();
+
+    /// Return the reverse index of the `keyname` dependencies of all package solvables
+    const PackageReverseDepIndex & get_reverse_dep_index(Id keyname);
+
+    /// Return the index between the source rpms and all package solvables
+    const PackageSourceIndex & get_source_index();
+
+    /// Return the partition of the available package solvables used by the priority filter
+    const PackagePriorityIndex & get_priority_index();
+
+    /// Return the index of the installed package solvables used by the upgrade and downgrade filters
+    const PackageUpgradeIndex & get_upgrade_index();
+
+    /// Return the cache of the PackageQuery filter results
+    PackageQueryCache & get_query_cache() noexcept { return query_cache; }
+
+    /// Return the cache of the solutions of the goal resolves
+    solv::ResolveCache & get_resolve_cache() noexcept { return resolve_cache; }
+
+    /// Return the cached set of unneeded installed packages computed for the `reasons_generation` of the system
+    /// state package reasons, `nullptr` if the set has to be recomputed
+    const libdnf5::solv::SolvMap * get_cached_unneeded(uint64_t reasons_generation);
+
+    /// Store the set of unneeded installed packages computed for the `reasons_generation`
+    void set_cached_unneeded(libdnf5::solv::SolvMap && unneeded, uint64_t reasons_generation);
+
+    /// Return the cached packages excluded from weak dependencies by the `exclude_from_weak_autodetect` option,
+    /// `nullptr` if they have to be recomputed
+    const libdnf5::solv::SolvMap * get_cached_weak_excludes();
+
+    /// Store the packages excluded from weak dependencies by the `exclude_from_weak_autodetect` option
+    void set_cached_weak_excludes(libdnf5::solv::SolvMap && excludes);
+
+    /// Return the cached packages matching the `protected_packages` option value `names`, `nullptr` if they have
+    /// to be recomputed
+    const libdnf5::solv::SolvMap * get_cached_protected_packages(const std::vector<std::string> & names);
+
+    /// Store the packages matching the `protected_packages` option value `names`
+    void set_cached_protected_packages(libdnf5::solv::SolvMap && packages, const std::vector<std::string> & names);
+
+    /// When enabled, the cached set of unneeded packages is always recomputed and compared with the new result
+    bool get_validate_unneeded_cache() const noexcept { return validate_unneeded_cache; }
+    void set_validate_unneeded_cache(bool validate) noexcept { validate_unneeded_cache = validate; }
+
     void make_provides_ready();
 
-    void invalidate_provides() { provides_ready = false; }
+    void invalidate_provides() {
+        provides_extendable = false;
+        invalidate_provides_appended();
+    }
+
+    /// Invalidates the provides after packages were only appended to the pool (`Repo::add_rpm_package()`).
+    /// The whatprovides index is then extended by the new packages instead of being recomputed.
+    void invalidate_provides_appended() {
+        provides_ready = false;
+        query_cache.invalidate();
+        resolve_cache.invalidate();
+        cached_unneeded.reset();
+        cached_weak_excludes.reset();
+        cached_protected_packages.reset();
+        get_rpm_pool(base).get_reldep_cache().invalidate_globs();
+    }
+
+    /// Marks the considered map as out of date, drops the cached considered maps and query results.
+    void invalidate_considered() noexcept {
+        cached_considered_maps.clear();
+        invalidate_considered_results();
+    }
 
     PackageId get_running_kernel_id();
 
@@ -113,12 +226,45 @@ public:
     /// If there are no excluded packages, the considered map may not be present in the return value.
     std::optional<libdnf5::solv::SolvMap> compute_considered_map(libdnf5::sack::ExcludeFlags flags) const;
 
+    /// Returns the considered map for `flags`. The maps are computed by `compute_considered_map()` on first use
+    /// and kept up to date by the delta updates of the excludes and includes.
+    const std::optional<libdnf5::solv::SolvMap> & get_considered_map(libdnf5::sack::ExcludeFlags flags);
+
     /// If the considered map in the pool is out of date - `considered_uptodate == false` - it will recompute it.
     /// And sets `considered_uptodate` to` true`.
     void recompute_considered_in_pool();
 
 private:
+    /// Marks the considered map in the pool as out of date and drops the query results derived from it,
+    /// the cached considered maps stay valid.
+    void invalidate_considered_results() noexcept {
+        considered_uptodate = false;
+        query_cache.invalidate();
+        resolve_cache.invalidate();
+        cached_unneeded.reset();
+        cached_weak_excludes.reset();
+    }
+
+    /// Re-evaluates the `changed` packages in the cached considered maps after they were added to or removed
+    /// from one of the existing excludes or includes. The other packages are not affected by such a change.
+    void update_considered(const libdnf5::solv::SolvMap & changed);
+
+    /// Adds the estimated memory used by the package indexes, considered maps and caches to `usage`.
+    void add_memory_usage(libdnf5::repo::MemoryUsage & usage) const;
+
+    /// Evaluates whether the package `id` is considered using the same rules as `compute_considered_map()`.
+    bool is_considered(Id id, libdnf5::sack::ExcludeFlags flags) const;
+
+    /// Adds the file provides and creates the whatprovides index of the whole pool
+    void create_provides();
+
     bool provides_ready{false};
+    /// Whether only packages were appended to the pool since the whatprovides index was created
+    bool provides_extendable{false};
+    /// Number of solvables in the whatprovides index
+    Id provides_nsolvables{0};
+    /// Sorted Ids of the file dependencies the file provides were added for
+    std::vector<Id> provides_file_deps;
 
     BaseWeakPtr base;
 
@@ -127,6 +273,23 @@ private:
     std::unique_ptr<libdnf5::solv::SolvMap> config_excludes;  // packages explicitly excluded by configuration
     std::unique_ptr<libdnf5::solv::SolvMap> config_includes;  // packages explicitly included by configuration
 
+    /// Packages of a repository matching its `includepkgs` and `excludepkgs` options. They are reused by the next
+    /// calls of `load_config_excludes_includes()` while the packages of the repository and the options are the same.
+    struct RepoConfigMatches {
+        ::Repo * solv_repo;
+        int solvables_start;
+        int solvables_end;
+        int nsolvables;
+        std::vector<std::string> includepkgs;
+        std::vector<std::string> excludepkgs;
+        libdnf5::solv::SolvMap includes{0};
+        libdnf5::solv::SolvMap excludes{0};
+        bool includes_exist;
+        bool excludes_exist;
+    };
+    /// Cached matches of the repositories options, by the repository id
+    std::map<std::string, RepoConfigMatches> repo_config_matches;
+
     std::unique_ptr<libdnf5::solv::SolvMap> user_excludes;  // packages explicitly excluded by API user
     std::unique_ptr<libdnf5::solv::SolvMap> user_includes;  // packages explicitly included by API user
 
@@ -139,11 +302,67 @@ private:
 
     bool considered_uptodate = true;
 
+    /// Considered maps for the requested ExcludeFlags combinations, valid for `cached_considered_maps_size` solvables
+    std::map<libdnf5::sack::ExcludeFlags, std::optional<libdnf5::solv::SolvMap>> cached_considered_maps;
+    int cached_considered_maps_size{0};
+
+    /// Results of the PackageQuery filters, used when the `query_cache` option is enabled
+    PackageQueryCache query_cache;
+    /// Solutions of the goal resolves, used when the `resolve_cache` option is enabled
+    solv::ResolveCache resolve_cache;
+
+    /// Return the package solvables added since an index was updated for `cached_size` solvables and contained
+    /// `cached_count` packages. Returns std::nullopt if solvables were removed and the index has to be rebuilt.
+    /// The pointers stored in the index are updated in case the pool reallocated its solvables.
+    template <typename T, typename GetSolvable>
+    std::optional<std::vector<Solvable *>> get_added_solvables(
+        std::vector<T> & index, int cached_size, Solvable *& cached_pool_solvables, GetSolvable get_solvable);
+
     std::vector<Solvable *> cached_sorted_solvables;
     int cached_sorted_solvables_size{0};
+    Solvable * cached_sorted_solvables_pool{nullptr};
     /// pair<id_of_lowercase_name, Solvable *>
     std::vector<std::pair<Id, Solvable *>> cached_sorted_icase_solvables;
     int cached_sorted_icase_solvables_size{0};
+    Solvable * cached_sorted_icase_solvables_pool{nullptr};
+    uint64_t sorted_solvables_generation{0};
+    std::vector<Solvable *> cached_name_sorted_solvables;
+    int cached_name_sorted_solvables_size{0};
+    PackageNameArena cached_name_arena;
+    int cached_name_arena_size{0};
+    std::map<Id, PackageTextIndex> cached_text_indexes;
+    std::optional<PackageFileIndex> cached_file_index;
+    std::map<Id, PackageReverseDepIndex> cached_reverse_dep_indexes;
+    std::optional<PackageSourceIndex> cached_source_index;
+    std::optional<PackagePriorityIndex> cached_priority_index;
+    std::optional<PackageUpgradeIndex> cached_upgrade_index;
+
+    /// Result of `PackageQuery::filter_unneeded()`, valid for the recorded installed repo, number of solvables
+    /// and generation of the package reasons
+    struct UnneededCache {
+        libdnf5::solv::SolvMap unneeded{0};
+        ::Repo * installed_repo{nullptr};
+        int nsolvables{0};
+        uint64_t reasons_generation{0};
+    };
+    std::optional<UnneededCache> cached_unneeded;
+    /// Packages excluded from weak dependencies by `exclude_from_weak_autodetect`, valid for the recorded
+    /// installed repo and number of solvables
+    struct WeakExcludesCache {
+        libdnf5::solv::SolvMap excludes{0};
+        ::Repo * installed_repo{nullptr};
+        int nsolvables{0};
+    };
+    std::optional<WeakExcludesCache> cached_weak_excludes;
+    /// Packages matching the `protected_packages` option, valid for the recorded option value and generation
+    /// of the package solvables
+    struct ProtectedPackagesCache {
+        libdnf5::solv::SolvMap packages{0};
+        std::vector<std::string> names;
+        uint64_t solvables_generation{0};
+    };
+    std::optional<ProtectedPackagesCache> cached_protected_packages;
+    bool validate_unneeded_cache{false};
     libdnf5::solv::SolvMap cached_solvables{0};
     int cached_solvables_size{0};
     PackageId running_kernel;
@@ -157,20 +376,73 @@ private:
     friend class Transaction;
 };
 
+template <typename T, typename GetSolvable>
+std::optional<std::vector<Solvable *>> PackageSack::Impl::get_added_solvables(
+    std::vector<T> & index, int cached_size, Solvable *& cached_pool_solvables, GetSolvable get_solvable) {
+    auto & pool = get_rpm_pool(base);
+    auto & solvables_map = get_solvables();
+    auto nsolvables = get_nsolvables();
+    if (nsolvables < cached_size) {
+        return std::nullopt;
+    }
+
+    // Adding solvables may reallocate the solvables of the pool, the relative positions stay the same
+    auto * pool_solvables = pool->solvables;
+    if (pool_solvables != cached_pool_solvables) {
+        auto old_base = reinterpret_cast<std::uintptr_t>(cached_pool_solvables);
+        for (auto & item : index) {
+            auto & solvable = get_solvable(item);
+            solvable = pool_solvables + (reinterpret_cast<std::uintptr_t>(solvable) - old_base) / sizeof(Solvable);
+        }
+        cached_pool_solvables = pool_solvables;
+    }
+
+    // libsolv appends new solvables at the end of the pool, removed ones leave free slots or shrink it
+    std::vector<Solvable *> added;
+    for (Id id = cached_size; id < nsolvables; ++id) {
+        if (solvables_map.contains_unsafe(id)) {
+            added.push_back(pool.id2solvable(id));
+        }
+    }
+    if (index.size() + added.size() != solvables_map.size()) {
+        return std::nullopt;
+    }
+    return added;
+}
+
 inline std::vector<Solvable *> & PackageSack::Impl::get_sorted_solvables() {
     auto nsolvables = get_nsolvables();
     if (nsolvables == cached_sorted_solvables_size) {
         return cached_sorted_solvables;
     }
-    auto & solvables_map = get_solvables();
-    cached_sorted_solvables.clear();
-    cached_sorted_solvables.reserve(static_cast<size_t>(nsolvables));
-    auto & pool = get_rpm_pool(base);
-    for (Id id : solvables_map) {
-        cached_sorted_solvables.push_back(pool.id2solvable(id));
+    auto added = get_added_solvables(
+        cached_sorted_solvables,
+        cached_sorted_solvables_size,
+        cached_sorted_solvables_pool,
+        [](Solvable *& solvable) -> Solvable *& { return solvable; });
+    if (added) {
+        // Sort only the new solvables and merge them with the already sorted ones
+        std::sort(added->begin(), added->end(), nevra_solvable_cmp_key);
+        auto middle = static_cast<std::ptrdiff_t>(cached_sorted_solvables.size());
+        cached_sorted_solvables.insert(cached_sorted_solvables.end(), added->begin(), added->end());
+        std::inplace_merge(
+            cached_sorted_solvables.begin(),
+            cached_sorted_solvables.begin() + middle,
+            cached_sorted_solvables.end(),
+            nevra_solvable_cmp_key);
+    } else {
+        auto & solvables_map = get_solvables();
+        cached_sorted_solvables.clear();
+        cached_sorted_solvables.reserve(static_cast<size_t>(nsolvables));
+        auto & pool = get_rpm_pool(base);
+        for (Id id : solvables_map) {
+            cached_sorted_solvables.push_back(pool.id2solvable(id));
+        }
+        std::sort(cached_sorted_solvables.begin(), cached_sorted_solvables.end(), nevra_solvable_cmp_key);
     }
-    std::sort(cached_sorted_solvables.begin(), cached_sorted_solvables.end(), nevra_solvable_cmp_key);
     cached_sorted_solvables_size = nsolvables;
+    cached_sorted_solvables_pool = get_rpm_pool(base)->solvables;
+    ++sorted_solvables_generation;
     return cached_sorted_solvables;
 }
 
@@ -180,19 +452,197 @@ inline std::vector<std::pair<Id, Solvable *>> & PackageSack::Impl::get_sorted_ic
     if (nsolvables == cached_sorted_icase_solvables_size) {
         return cached_sorted_icase_solvables;
     }
+    auto added = get_added_solvables(
+        cached_sorted_icase_solvables,
+        cached_sorted_icase_solvables_size,
+        cached_sorted_icase_solvables_pool,
+        [](std::pair<Id, Solvable *> & item) -> Solvable *& { return item.second; });
+    std::vector<std::pair<Id, Solvable *>> new_items;
+    auto & solvables = added ? *added : get_sorted_solvables();
+    new_items.reserve(solvables.size());
     Id name = 0;
     Id icase_name = 0;
-    for (auto * solvable : get_sorted_solvables()) {
+    for (auto * solvable : solvables) {
         if (solvable->name != name) {
-            icase_name = pool.id_to_lowercase_id(solvable->name, 1);
+            name = solvable->name;
+            icase_name = pool.id_to_lowercase_id(name, 1);
         }
-        cached_sorted_icase_solvables.emplace_back(std::make_pair(icase_name, solvable));
+        new_items.emplace_back(icase_name, solvable);
+    }
+    std::sort(new_items.begin(), new_items.end(), nevra_solvable_cmp_icase_key);
+    if (added) {
+        auto middle = static_cast<std::ptrdiff_t>(cached_sorted_icase_solvables.size());
+        cached_sorted_icase_solvables.insert(cached_sorted_icase_solvables.end(), new_items.begin(), new_items.end());
+        std::inplace_merge(
+            cached_sorted_icase_solvables.begin(),
+            cached_sorted_icase_solvables.begin() + middle,
+            cached_sorted_icase_solvables.end(),
+            nevra_solvable_cmp_icase_key);
+    } else {
+        cached_sorted_icase_solvables = std::move(new_items);
     }
-    std::sort(cached_sorted_icase_solvables.begin(), cached_sorted_icase_solvables.end(), nevra_solvable_cmp_icase_key);
     cached_sorted_icase_solvables_size = nsolvables;
+    cached_sorted_icase_solvables_pool = pool->solvables;
     return cached_sorted_icase_solvables;
 }
 
+inline std::vector<Solvable *> & PackageSack::Impl::get_name_sorted_solvables() {
+    auto nsolvables = get_nsolvables();
+    if (nsolvables == cached_name_sorted_solvables_size) {
+        return cached_name_sorted_solvables;
+    }
+    auto & pool = get_rpm_pool(base);
+    // Start from the list sorted by name id, so that equal names stay grouped together
+    cached_name_sorted_solvables = get_sorted_solvables();
+    std::stable_sort(
+        cached_name_sorted_solvables.begin(),
+        cached_name_sorted_solvables.end(),
+        [&pool](const Solvable * first, const Solvable * second) {
+            return first->name != second->name &&
+                   strcasecmp(pool.id2str(first->name), pool.id2str(second->name)) < 0;
+        });
+    cached_name_sorted_solvables_size = nsolvables;
+    return cached_name_sorted_solvables;
+}
+
+inline const PackageNameArena & PackageSack::Impl::get_name_arena() {
+    auto nsolvables = get_nsolvables();
+    if (nsolvables == cached_name_arena_size) {
+        return cached_name_arena;
+    }
+    auto & pool = get_rpm_pool(base);
+    auto & sorted_solvables = get_sorted_solvables();
+    auto & arena = cached_name_arena;
+    arena.names.clear();
+    arena.icase_names.clear();
+    arena.name_offsets.clear();
+    arena.solvable_offsets.clear();
+    Id name = 0;
+    for (size_t idx = 0; idx < sorted_solvables.size(); ++idx) {
+        if (sorted_solvables[idx]->name == name) {
+            continue;
+        }
+        name = sorted_solvables[idx]->name;
+        arena.name_offsets.push_back(arena.names.size());
+        arena.solvable_offsets.push_back(idx);
+        arena.names.append(pool.id2str(name));
+        arena.names.push_back('\0');
+    }
+    arena.name_offsets.push_back(arena.names.size());
+    arena.solvable_offsets.push_back(sorted_solvables.size());
+    arena.icase_names.resize(arena.names.size());
+    std::transform(arena.names.begin(), arena.names.end(), arena.icase_names.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    cached_name_arena_size = nsolvables;
+    return arena;
+}
+
+inline const PackageTextIndex & PackageSack::Impl::get_text_index(Id keyname) {
+    auto nsolvables = get_nsolvables();
+    auto it = cached_text_indexes.find(keyname);
+    if (it != cached_text_indexes.end()) {
+        if (it->second.get_nsolvables() == nsolvables) {
+            return it->second;
+        }
+        cached_text_indexes.erase(it);
+    }
+    return cached_text_indexes.emplace(keyname, PackageTextIndex(get_rpm_pool(base), keyname, get_solvables()))
+        .first->second;
+}
+
+inline const PackageFileIndex & PackageSack::Impl::get_file_index() {
+    if (!cached_file_index || cached_file_index->get_nsolvables() != get_nsolvables()) {
+        // Reset first, the old index can be big
+        cached_file_index.reset();
+        cached_file_index.emplace(get_rpm_pool(base), get_solvables());
+    }
+    return *cached_file_index;
+}
+
+inline const PackageReverseDepIndex & PackageSack::Impl::get_reverse_dep_index(Id keyname) {
+    auto nsolvables = get_nsolvables();
+    auto it = cached_reverse_dep_indexes.find(keyname);
+    if (it != cached_reverse_dep_indexes.end()) {
+        if (it->second.get_nsolvables() == nsolvables) {
+            return it->second;
+        }
+        cached_reverse_dep_indexes.erase(it);
+    }
+    return cached_reverse_dep_indexes
+        .emplace(keyname, PackageReverseDepIndex(get_rpm_pool(base), keyname, get_solvables()))
+        .first->second;
+}
+
+inline const PackageSourceIndex & PackageSack::Impl::get_source_index() {
+    if (!cached_source_index || cached_source_index->get_nsolvables() != get_nsolvables()) {
+        cached_source_index.reset();
+        cached_source_index.emplace(get_rpm_pool(base), get_solvables());
+    }
+    return *cached_source_index;
+}
+
+inline const PackagePriorityIndex & PackageSack::Impl::get_priority_index() {
+    auto & pool = get_rpm_pool(base);
+    if (!cached_priority_index || !cached_priority_index->is_valid(pool)) {
+        cached_priority_index.reset();
+        cached_priority_index.emplace(pool, get_solvables());
+    }
+    return *cached_priority_index;
+}
+
+inline const PackageUpgradeIndex & PackageSack::Impl::get_upgrade_index() {
+    auto & pool = get_rpm_pool(base);
+    if (!cached_upgrade_index || cached_upgrade_index->get_nsolvables() != get_nsolvables() ||
+        cached_upgrade_index->get_installed_repo() != pool->installed) {
+        cached_upgrade_index.reset();
+        cached_upgrade_index.emplace(pool, get_solvables());
+    }
+    return *cached_upgrade_index;
+}
+
+inline const libdnf5::solv::SolvMap * PackageSack::Impl::get_cached_unneeded(uint64_t reasons_generation) {
+    if (!cached_unneeded || cached_unneeded->nsolvables != get_nsolvables() ||
+        cached_unneeded->installed_repo != get_rpm_pool(base)->installed ||
+        cached_unneeded->reasons_generation != reasons_generation) {
+        return nullptr;
+    }
+    return &cached_unneeded->unneeded;
+}
+
+inline void PackageSack::Impl::set_cached_unneeded(libdnf5::solv::SolvMap && unneeded, uint64_t reasons_generation) {
+    cached_unneeded.emplace(UnneededCache{
+        std::move(unneeded), get_rpm_pool(base)->installed, get_nsolvables(), reasons_generation});
+}
+
+inline const libdnf5::solv::SolvMap * PackageSack::Impl::get_cached_weak_excludes() {
+    if (!cached_weak_excludes || cached_weak_excludes->nsolvables != get_nsolvables() ||
+        cached_weak_excludes->installed_repo != get_rpm_pool(base)->installed) {
+        return nullptr;
+    }
+    return &cached_weak_excludes->excludes;
+}
+
+inline void PackageSack::Impl::set_cached_weak_excludes(libdnf5::solv::SolvMap && excludes) {
+    cached_weak_excludes.emplace(
+        WeakExcludesCache{std::move(excludes), get_rpm_pool(base)->installed, get_nsolvables()});
+}
+
+inline const libdnf5::solv::SolvMap * PackageSack::Impl::get_cached_protected_packages(
+    const std::vector<std::string> & names) {
+    if (!cached_protected_packages || cached_protected_packages->names != names ||
+        cached_protected_packages->solvables_generation != get_sorted_solvables_generation()) {
+        return nullptr;
+    }
+    return &cached_protected_packages->packages;
+}
+
+inline void PackageSack::Impl::set_cached_protected_packages(
+    libdnf5::solv::SolvMap && packages, const std::vector<std::string> & names) {
+    cached_protected_packages.emplace(
+        ProtectedPackagesCache{std::move(packages), names, get_sorted_solvables_generation()});
+}
+
 inline libdnf5::solv::SolvMap & PackageSack::Impl::get_solvables() {
     auto & spool = get_rpm_pool(base);
     ::Pool * pool = *spool;
@@ -60,6 +60,8 @@ PackageSet & PackageSet::operator=(PackageSet && other) {
 
 PackageSet & PackageSet::operator|=(const PackageSet & other) {
     libdnf_assert_same_base(p_impl->base, other.p_impl->base);
+    p_impl->assert_no_deferred_filters();
+    other.p_impl->assert_no_deferred_filters();
 
     *p_impl |= *other.p_impl;
     return *this;
@@ -68,6 +70,8 @@ PackageSet & PackageSet::operator|=(const PackageSet & other) {
 
 PackageSet & PackageSet::operator-=(const PackageSet & other) {
     libdnf_assert_same_base(p_impl->base, other.p_impl->base);
+    p_impl->assert_no_deferred_filters();
+    other.p_impl->assert_no_deferred_filters();
 
     *p_impl -= *other.p_impl;
     return *this;
@@ -76,6 +80,8 @@ PackageSet & PackageSet::operator-=(const PackageSet & other) {
 
 PackageSet & PackageSet::operator&=(const PackageSet & other) {
     libdnf_assert_same_base(p_impl->base, other.p_impl->base);
+    p_impl->assert_no_deferred_filters();
+    other.p_impl->assert_no_deferred_filters();
 
     *p_impl &= *other.p_impl;
     return *this;
@@ -25,6 +25,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
 
+#include "libdnf5/common/exception.hpp"
 #include "libdnf5/rpm/package_set.hpp"
 
 extern "C" {
@@ -54,11 +55,22 @@ public:
     Impl & operator=(const libdnf5::solv::SolvMap & map);
     Impl & operator=(libdnf5::solv::SolvMap && map);
 
+    /// The filters recorded by `PackageQuery::defer_filters()` are applied by the PackageQuery methods, not when
+    /// the query is used as a PackageSet.
+    void assert_no_deferred_filters() const {
+        libdnf_assert(
+            !deferred_filters_pending,
+            "PackageQuery with deferred filters used as a PackageSet, apply_deferred_filters() has to be called first");
+    }
+
 private:
     friend PackageSet;
     friend PackageQuery;
 
     BaseWeakPtr base;
+    /// Set while the PackageQuery owning the set has filters recorded by `PackageQuery::defer_filters()` that are
+    /// not applied, the content of the set is not valid then
+    bool deferred_filters_pending{false};
 };
 
 
@@ -70,21 +82,27 @@ inline PackageSet::Impl::Impl(const BaseWeakPtr & base, libdnf5::solv::SolvMap &
     : libdnf5::solv::SolvMap::SolvMap(solv_map),
       base(base) {}
 
-inline PackageSet::Impl::Impl(const Impl & other) : libdnf5::solv::SolvMap::SolvMap(other), base(other.base) {}
+inline PackageSet::Impl::Impl(const Impl & other)
+    : libdnf5::solv::SolvMap::SolvMap(other),
+      base(other.base),
+      deferred_filters_pending(other.deferred_filters_pending) {}
 
 inline PackageSet::Impl::Impl(Impl && other)
     : libdnf5::solv::SolvMap::SolvMap(std::move(other)),
-      base(std::move(other.base)) {}
+      base(std::move(other.base)),
+      deferred_filters_pending(other.deferred_filters_pending) {}
 
 inline PackageSet::Impl & PackageSet::Impl::operator=(const Impl & other) {
     libdnf5::solv::SolvMap::operator=(other);
     base = other.base;
+    deferred_filters_pending = other.deferred_filters_pending;
     return *this;
 }
 
 inline PackageSet::Impl & PackageSet::Impl::operator=(Impl && other) {
     libdnf5::solv::SolvMap::operator=(std::move(other));
     base = std::move(other.base);
+    deferred_filters_pending = other.deferred_filters_pending;
     return *this;
 }
 
@@ -29,7 +29,7 @@ namespace libdnf5::rpm {
 class PackageSetIterator::Impl : private libdnf5::solv::SolvMap::iterator {
 private:
     Impl(const PackageSet & package_set)
-        : libdnf5::solv::SolvMap::iterator(package_set.p_impl->get_map()),
+        : libdnf5::solv::SolvMap::iterator(*package_set.p_impl),
           package_set{&package_set} {}
 
     PackageSetIterator::Impl & operator++() {
@@ -57,6 +57,7 @@ PackageSetIterator & PackageSetIterator::operator=(const PackageSetIterator & ot
 
 
 PackageSetIterator PackageSetIterator::begin(const PackageSet & package_set) {
+    package_set.p_impl->assert_no_deferred_filters();
     PackageSetIterator it(package_set);
     it.begin();
     return it;
@@ -0,0 +1,177 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_source_index.hpp"
+
+extern "C" {
+#include <solv/knownid.h>
+}
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+/// Returns the rpm file name of the source package `solvable`, the same as the `sourcerpm` of its binaries.
+std::string source_package_file_name(const libdnf5::solv::RpmPool & pool, const Solvable * solvable) {
+    std::string_view evr = pool.id2str(solvable->evr);
+    // The `sourcerpm` does not contain the epoch
+    auto colon = evr.find(':');
+    if (colon != std::string_view::npos &&
+        std::all_of(evr.begin(), evr.begin() + static_cast<std::ptrdiff_t>(colon), [](char c) {
+            return c >= '0' && c <= '9';
+        })) {
+        evr.remove_prefix(colon + 1);
+    }
+    std::string file_name(pool.id2str(solvable->name));
+    file_name.append("-").append(evr).append(".").append(pool.id2str(solvable->arch)).append(".rpm");
+    return file_name;
+}
+
+}  // namespace
+
+
+PackageSourceIndex::PackageSourceIndex(
+    const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()),
+      built_from(static_cast<std::size_t>(nsolvables), NO_SOURCE),
+      source_of(static_cast<std::size_t>(nsolvables), NO_SOURCE) {
+    std::vector<std::pair<std::string, Id>> source_binary_pairs;
+    std::vector<Id> source_packages;
+    for (Id solvable_id : package_solvables) {
+        auto * solvable = pool.id2solvable(solvable_id);
+        if (solvable->arch == ARCH_SRC || solvable->arch == ARCH_NOSRC) {
+            source_packages.push_back(solvable_id);
+        } else if (auto * sourcerpm = pool.get_sourcerpm(solvable_id)) {
+            source_binary_pairs.emplace_back(sourcerpm, solvable_id);
+        }
+    }
+    std::sort(source_binary_pairs.begin(), source_binary_pairs.end());
+
+    binaries.reserve(source_binary_pairs.size());
+    for (auto & [sourcerpm, solvable_id] : source_binary_pairs) {
+        if (sources.empty() || sources.back() != sourcerpm) {
+            sources.push_back(std::move(sourcerpm));
+            binary_offsets.push_back(binaries.size());
+        }
+        built_from[static_cast<std::size_t>(solvable_id)] = static_cast<std::uint32_t>(sources.size() - 1);
+        binaries.push_back(solvable_id);
+    }
+    binary_offsets.push_back(binaries.size());
+    sources.shrink_to_fit();
+
+    for (Id solvable_id : source_packages) {
+        source_of[static_cast<std::size_t>(solvable_id)] =
+            find_source(source_package_file_name(pool, pool.id2solvable(solvable_id)));
+    }
+}
+
+
+std::uint32_t PackageSourceIndex::find_source(const std::string & sourcerpm) const {
+    auto it = std::lower_bound(sources.begin(), sources.end(), sourcerpm);
+    if (it == sources.end() || *it != sourcerpm) {
+        return NO_SOURCE;
+    }
+    return static_cast<std::uint32_t>(it - sources.begin());
+}
+
+
+const std::string * PackageSourceIndex::get_sourcerpm(Id id) const noexcept {
+    auto source_idx = built_from[static_cast<std::size_t>(id)];
+    return source_idx == NO_SOURCE ? nullptr : &sources[source_idx];
+}
+
+
+void PackageSourceIndex::add_binaries(const std::string & sourcerpm, libdnf5::solv::SolvMap & result) const {
+    auto source_idx = find_source(sourcerpm);
+    if (source_idx == NO_SOURCE) {
+        return;
+    }
+    for (auto idx = binary_offsets[source_idx]; idx < binary_offsets[source_idx + 1]; ++idx) {
+        result.add_unsafe(binaries[idx]);
+    }
+}
+
+
+void PackageSourceIndex::add_binaries_glob(const std::string & pattern, libdnf5::solv::SolvMap & result) const {
+    for (std::size_t source_idx = 0; source_idx < sources.size(); ++source_idx) {
+        if (fnmatch(pattern.c_str(), sources[source_idx].c_str(), 0) == 0) {
+            for (auto idx = binary_offsets[source_idx]; idx < binary_offsets[source_idx + 1]; ++idx) {
+                result.add_unsafe(binaries[idx]);
+            }
+        }
+    }
+}
+
+
+void PackageSourceIndex::filter_sources_of(
+    libdnf5::solv::SolvMap & packages, const libdnf5::solv::SolvMap & binaries) const {
+    std::vector<bool> wanted_sources(sources.size(), false);
+    for (Id binary_id : binaries) {
+        auto source_idx = built_from[static_cast<std::size_t>(binary_id)];
+        if (source_idx != NO_SOURCE) {
+            wanted_sources[source_idx] = true;
+        }
+    }
+    libdnf5::solv::SolvMap result(nsolvables);
+    for (Id package_id : packages) {
+        auto source_idx = source_of[static_cast<std::size_t>(package_id)];
+        if (source_idx != NO_SOURCE && wanted_sources[source_idx]) {
+            result.add_unsafe(package_id);
+        }
+    }
+    packages &= result;
+}
+
+
+void PackageSourceIndex::filter_built_from(
+    libdnf5::solv::SolvMap & packages, const libdnf5::solv::SolvMap & source_packages) const {
+    libdnf5::solv::SolvMap result(nsolvables);
+    std::vector<bool> added_sources(sources.size(), false);
+    for (Id source_id : source_packages) {
+        auto source_idx = source_of[static_cast<std::size_t>(source_id)];
+        if (source_idx != NO_SOURCE && !added_sources[source_idx]) {
+            added_sources[source_idx] = true;
+            for (auto idx = binary_offsets[source_idx]; idx < binary_offsets[source_idx + 1]; ++idx) {
+                result.add_unsafe(binaries[idx]);
+            }
+        }
+    }
+    packages &= result;
+}
+
+
+std::size_t PackageSourceIndex::get_memory_usage() const noexcept {
+    std::size_t usage = sources.capacity() * sizeof(std::string) + binary_offsets.capacity() * sizeof(std::size_t) +
+                        binaries.capacity() * sizeof(Id) +
+                        (built_from.capacity() + source_of.capacity()) * sizeof(std::uint32_t);
+    for (const auto & source : sources) {
+        usage += source.capacity();
+    }
+    return usage;
+}
+
+}  // namespace libdnf5::rpm
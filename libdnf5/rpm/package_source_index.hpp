@@ -0,0 +1,88 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_SOURCE_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_SOURCE_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Index between the source rpms and the package solvables in both directions. Each package built from a source
+/// rpm refers to the source rpm file name (its `sourcerpm`, e.g. "pkg-1.2-3.src.rpm") and each source package
+/// (`src` or `nosrc` architecture) to its own file name, so the packages and the source packages are mapped
+/// to each other without building the source rpm names again.
+class PackageSourceIndex {
+public:
+    /// Builds the index of the `package_solvables`.
+    PackageSourceIndex(const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Returns the `sourcerpm` of the package `id`, nullptr for the source packages and the packages without it.
+    const std::string * get_sourcerpm(Id id) const noexcept;
+
+    /// Adds to `result` the packages with the `sourcerpm` equal to `sourcerpm`.
+    void add_binaries(const std::string & sourcerpm, libdnf5::solv::SolvMap & result) const;
+
+    /// Adds to `result` the packages with the `sourcerpm` matching the glob `pattern`.
+    void add_binaries_glob(const std::string & pattern, libdnf5::solv::SolvMap & result) const;
+
+    /// Returns whether the source packages are the minority of the indexed names and thus it is cheaper
+    /// to match `candidates_count` candidates one by one than all the source rpm names.
+    bool prefer_candidates(std::size_t candidates_count) const noexcept { return candidates_count < sources.size(); }
+
+    /// Keeps in `packages` only the source packages from which any of the `binaries` was built.
+    void filter_sources_of(libdnf5::solv::SolvMap & packages, const libdnf5::solv::SolvMap & binaries) const;
+
+    /// Keeps in `packages` only the packages built from any of the `source_packages`.
+    void filter_built_from(libdnf5::solv::SolvMap & packages, const libdnf5::solv::SolvMap & source_packages) const;
+
+    /// Returns the number of solvables in the pool at the time the index was built.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept;
+
+private:
+    static constexpr std::uint32_t NO_SOURCE = UINT32_MAX;
+
+    /// Returns the index of `sourcerpm` in `sources`, `NO_SOURCE` if it is not there.
+    std::uint32_t find_source(const std::string & sourcerpm) const;
+
+    int nsolvables;
+    /// Sorted distinct source rpm names referred by the packages, the packages built from `sources[i]` are
+    /// `binaries[binary_offsets[i]]` ... `binaries[binary_offsets[i + 1] - 1]`
+    std::vector<std::string> sources;
+    std::vector<std::size_t> binary_offsets;
+    std::vector<Id> binaries;
+    /// For each solvable id the index of its `sourcerpm` in `sources`
+    std::vector<std::uint32_t> built_from;
+    /// For each solvable id of a source package the index of its file name in `sources`
+    std::vector<std::uint32_t> source_of;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_SOURCE_INDEX_HPP
@@ -0,0 +1,176 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_text_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+/// Appends the trigrams of lowercased `str` to `out`.
+void add_trigrams(std::string_view str, std::vector<std::uint32_t> & out) {
+    if (str.size() < 3) {
+        return;
+    }
+    auto lower = [](char c) { return static_cast<std::uint32_t>(std::tolower(static_cast<unsigned char>(c))); };
+    std::uint32_t trigram = lower(str[0]) << 8 | lower(str[1]);
+    for (std::size_t idx = 2; idx < str.size(); ++idx) {
+        trigram = (trigram << 8 | lower(str[idx])) & 0xFFFFFF;
+        out.push_back(trigram);
+    }
+}
+
+void sort_unique(std::vector<std::uint32_t> & values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+/// Splits the glob `pattern` into the literal substrings that every matching string contains.
+/// Returns false when the pattern is not understood.
+bool split_glob_literals(const std::string & pattern, std::vector<std::string> & literals) {
+    std::string literal;
+    for (std::size_t idx = 0; idx < pattern.size(); ++idx) {
+        char c = pattern[idx];
+        if (c == '*' || c == '?' || c == '[') {
+            literals.push_back(std::move(literal));
+            literal.clear();
+            if (c == '[') {
+                // Skip the bracket expression, "]" right after "[", "[!" or "[^" is a part of the set
+                std::size_t end = idx + 1;
+                if (end < pattern.size() && (pattern[end] == '!' || pattern[end] == '^')) {
+                    ++end;
+                }
+                if (end < pattern.size() && pattern[end] == ']') {
+                    ++end;
+                }
+                end = pattern.find(']', end);
+                if (end == std::string::npos) {
+                    return false;
+                }
+                idx = end;
+            }
+        } else if (c == '\\' && idx + 1 < pattern.size()) {
+            literal.push_back(pattern[++idx]);
+        } else {
+            literal.push_back(c);
+        }
+    }
+    literals.push_back(std::move(literal));
+    return true;
+}
+
+}  // namespace
+
+
+PackageTextIndex::PackageTextIndex(
+    const libdnf5::solv::Pool & pool, Id keyname, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()) {
+    std::vector<std::pair<std::uint32_t, Id>> entries;
+    std::vector<std::uint32_t> solvable_trigrams;
+    for (Id id : package_solvables) {
+        const char * value = pool.lookup_str(id, keyname);
+        if (!value) {
+            continue;
+        }
+        solvable_trigrams.clear();
+        add_trigrams(value, solvable_trigrams);
+        sort_unique(solvable_trigrams);
+        for (auto trigram : solvable_trigrams) {
+            entries.emplace_back(trigram, id);
+        }
+    }
+    // Solvables are iterated in ascending order, the stable sort keeps the lists of solvables sorted
+    std::stable_sort(entries.begin(), entries.end(), [](const auto & first, const auto & second) {
+        return first.first < second.first;
+    });
+
+    solvables.reserve(entries.size());
+    for (const auto & [trigram, id] : entries) {
+        if (trigrams.empty() || trigrams.back() != trigram) {
+            trigrams.push_back(trigram);
+            offsets.push_back(solvables.size());
+        }
+        solvables.push_back(id);
+    }
+    offsets.push_back(solvables.size());
+}
+
+
+std::optional<libdnf5::solv::SolvMap> PackageTextIndex::shortlist(
+    const std::string & pattern, bool glob, const libdnf5::solv::SolvMap & candidates) const {
+    std::vector<std::uint32_t> pattern_trigrams;
+    if (glob) {
+        std::vector<std::string> literals;
+        if (!split_glob_literals(pattern, literals)) {
+            return std::nullopt;
+        }
+        for (const auto & literal : literals) {
+            add_trigrams(literal, pattern_trigrams);
+        }
+    } else {
+        add_trigrams(pattern, pattern_trigrams);
+    }
+    sort_unique(pattern_trigrams);
+    if (pattern_trigrams.empty()) {
+        return std::nullopt;
+    }
+
+    // Solvable lists of the pattern trigrams, the shortest one first
+    std::vector<std::pair<const Id *, const Id *>> lists;
+    for (auto trigram : pattern_trigrams) {
+        auto it = std::lower_bound(trigrams.begin(), trigrams.end(), trigram);
+        if (it == trigrams.end() || *it != trigram) {
+            return libdnf5::solv::SolvMap(nsolvables);
+        }
+        auto idx = static_cast<std::size_t>(it - trigrams.begin());
+        lists.emplace_back(solvables.data() + offsets[idx], solvables.data() + offsets[idx + 1]);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto & first, const auto & second) {
+        return first.second - first.first < second.second - second.first;
+    });
+
+    std::vector<Id> matches;
+    for (auto * id = lists[0].first; id != lists[0].second; ++id) {
+        if (candidates.contains(*id)) {
+            matches.push_back(*id);
+        }
+    }
+    std::vector<Id> intersection;
+    for (std::size_t idx = 1; idx < lists.size() && !matches.empty(); ++idx) {
+        intersection.clear();
+        std::set_intersection(
+            matches.begin(), matches.end(), lists[idx].first, lists[idx].second, std::back_inserter(intersection));
+        std::swap(matches, intersection);
+    }
+
+    libdnf5::solv::SolvMap result(nsolvables);
+    for (Id id : matches) {
+        result.add_unsafe(id);
+    }
+    return result;
+}
+
+}  // namespace libdnf5::rpm
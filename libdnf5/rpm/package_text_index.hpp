@@ -0,0 +1,71 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Trigram index of a string attribute (e.g. summary or description) of package solvables.
+/// For every trigram of the lowercased attribute values it keeps a sorted list of solvables containing it.
+/// It is used to shortlist the solvables that may match a substring or glob pattern, the shortlisted solvables
+/// still have to be matched against the pattern.
+class PackageTextIndex {
+public:
+    /// Builds the index of the `keyname` attribute of the `package_solvables`.
+    PackageTextIndex(const libdnf5::solv::Pool & pool, Id keyname, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Returns the subset of `candidates` that contain all trigrams of the substrings that any value matching
+    /// `pattern` must contain. With `glob` the pattern is a glob pattern, otherwise it is a substring.
+    /// Returns std::nullopt when the pattern does not provide any trigram and all candidates have to be matched.
+    std::optional<libdnf5::solv::SolvMap> shortlist(
+        const std::string & pattern, bool glob, const libdnf5::solv::SolvMap & candidates) const;
+
+    /// Returns the number of solvables in the pool at the time the index was built.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept {
+        return trigrams.capacity() * sizeof(std::uint32_t) + offsets.capacity() * sizeof(std::size_t) +
+               solvables.capacity() * sizeof(Id);
+    }
+
+private:
+    int nsolvables;
+    /// Sorted distinct trigrams
+    std::vector<std::uint32_t> trigrams;
+    /// Offsets of the solvable lists of the trigrams in `solvables`, the last item is the size of `solvables`
+    std::vector<std::size_t> offsets;
+    /// Sorted lists of solvables for each trigram, stored one after another
+    std::vector<Id> solvables;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
@@ -0,0 +1,133 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_upgrade_index.hpp"
+
+extern "C" {
+#include <solv/evr.h>
+#include <solv/knownid.h>
+}
+
+#include <algorithm>
+#include <utility>
+
+
+namespace libdnf5::rpm {
+
+PackageUpgradeIndex::PackageUpgradeIndex(
+    const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables)
+    : nsolvables(pool.get_nsolvables()),
+      installed_repo(pool->installed) {
+    if (installed_repo == nullptr) {
+        return;
+    }
+
+    // pairs of <name, installed solvable>
+    std::vector<std::pair<Id, Id>> entries;
+    for (Id id : package_solvables) {
+        const Solvable * solvable = pool.id2solvable(id);
+        if (solvable->repo == installed_repo) {
+            entries.emplace_back(solvable->name, id);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [&pool](const auto & first, const auto & second) {
+        if (first.first != second.first) {
+            return first.first < second.first;
+        }
+        auto cmp =
+            pool.evrcmp(pool.id2solvable(first.second)->evr, pool.id2solvable(second.second)->evr, EVRCMP_COMPARE);
+        if (cmp != 0) {
+            return cmp < 0;
+        }
+        return first.second > second.second;
+    });
+
+    installed.reserve(entries.size());
+    for (const auto & [name, id] : entries) {
+        if (names.empty() || names.back() != name) {
+            names.push_back(name);
+            offsets.push_back(installed.size());
+        }
+        installed.push_back(id);
+    }
+    offsets.push_back(installed.size());
+
+    for (Id id : package_solvables) {
+        const Solvable * solvable = pool.id2solvable(id);
+        if (solvable->repo != installed_repo && std::binary_search(names.begin(), names.end(), solvable->name)) {
+            available.push_back(id);
+        }
+    }
+}
+
+
+std::span<const Id> PackageUpgradeIndex::get_installed(Id name) const noexcept {
+    auto it = std::lower_bound(names.begin(), names.end(), name);
+    if (it == names.end() || *it != name) {
+        return {};
+    }
+    auto idx = static_cast<std::size_t>(it - names.begin());
+    return std::span<const Id>(installed).subspan(offsets[idx], offsets[idx + 1] - offsets[idx]);
+}
+
+
+Id PackageUpgradeIndex::what_upgrades(const libdnf5::solv::RpmPool & pool, const Solvable * solvable) const {
+    auto same_name = get_installed(solvable->name);
+    // The installed package of a compatible arch with the highest version decides. Of the packages with
+    // the same version the one with the lowest id is found first.
+    for (auto it = same_name.rbegin(); it != same_name.rend(); ++it) {
+        const Solvable * updated = pool.id2solvable(*it);
+        if (updated->arch != solvable->arch && updated->arch != ARCH_NOARCH && solvable->arch != ARCH_NOARCH) {
+            continue;
+        }
+        if (pool.evrcmp(updated->evr, solvable->evr, EVRCMP_COMPARE) >= 0) {
+            // >= version installed, this pkg can not be used for upgrade
+            return 0;
+        }
+        return *it;
+    }
+    return 0;
+}
+
+
+Id PackageUpgradeIndex::what_downgrades(const libdnf5::solv::RpmPool & pool, const Solvable * solvable) const {
+    // The installed package of the same arch with the lowest version decides. Of the packages with the same
+    // version the one with the lowest id is found last.
+    const Solvable * lowest = nullptr;
+    Id lowest_id = 0;
+    for (Id id : get_installed(solvable->name)) {
+        const Solvable * updated = pool.id2solvable(id);
+        if (updated->arch != solvable->arch) {
+            continue;
+        }
+        if (lowest == nullptr) {
+            if (pool.evrcmp(updated->evr, solvable->evr, EVRCMP_COMPARE) <= 0) {
+                // <= version installed, this pkg can not be used for downgrade
+                return 0;
+            }
+        } else if (pool.evrcmp(updated->evr, lowest->evr, EVRCMP_COMPARE) != 0) {
+            break;
+        }
+        lowest = updated;
+        lowest_id = id;
+    }
+    return lowest_id;
+}
+
+}  // namespace libdnf5::rpm
@@ -0,0 +1,90 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PACKAGE_UPGRADE_INDEX_HPP
+#define LIBDNF5_RPM_PACKAGE_UPGRADE_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Index of the installed package solvables by name. It pairs the available solvables with the installed
+/// solvables of the same name in the upgrade and downgrade filters, instead of looking up the providers
+/// of the name and comparing the EVRs of all installed providers for each available solvable.
+class PackageUpgradeIndex {
+public:
+    /// Builds the index of the `package_solvables`, the installed ones are those in the installed repo of the `pool`.
+    PackageUpgradeIndex(const libdnf5::solv::RpmPool & pool, const libdnf5::solv::SolvMap & package_solvables);
+
+    /// Returns id of an installed package that can be upgraded with the available `solvable`, or 0.
+    ///
+    /// The returned package has the same name as `solvable` and a compatible arch (the same one, or noarch
+    /// on either side) and is of lower version than `solvable`. If there are multiple such packages, the highest
+    /// version is returned. No package is returned when a package of a compatible arch with the same or a higher
+    /// version is installed.
+    Id what_upgrades(const libdnf5::solv::RpmPool & pool, const Solvable * solvable) const;
+
+    /// Returns id of an installed package that can be downgraded with the available `solvable`, or 0.
+    ///
+    /// The returned package has the same name and arch as `solvable` and is of higher version than `solvable`.
+    /// If there are multiple such packages, the lowest version is returned. No package is returned when
+    /// a package of the same arch with the same or a lower version is installed.
+    Id what_downgrades(const libdnf5::solv::RpmPool & pool, const Solvable * solvable) const;
+
+    /// Returns the sorted available solvables with the name of an installed solvable, only they can be upgrades
+    /// or downgrades of the installed solvables.
+    const std::vector<Id> & get_available() const noexcept { return available; }
+
+    /// Returns the number of solvables in the pool at the time the index was built.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the memory used by the index in bytes.
+    std::size_t get_memory_usage() const noexcept {
+        return (names.capacity() + installed.capacity() + available.capacity()) * sizeof(Id) +
+               offsets.capacity() * sizeof(std::size_t);
+    }
+
+    /// Returns the installed repo of the pool at the time the index was built.
+    const ::Repo * get_installed_repo() const noexcept { return installed_repo; }
+
+private:
+    /// Returns the installed solvables named `name` sorted by EVR.
+    std::span<const Id> get_installed(Id name) const noexcept;
+
+    int nsolvables;
+    const ::Repo * installed_repo;
+    /// Sorted distinct names of the installed solvables
+    std::vector<Id> names;
+    /// Offsets of the solvable lists of the names in `installed`, the last item is the size of `installed`
+    std::vector<std::size_t> offsets;
+    /// Installed solvables of each name sorted by EVR (solvables with equal EVR by Id in descending order),
+    /// stored one after another
+    std::vector<Id> installed;
+    std::vector<Id> available;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PACKAGE_UPGRADE_INDEX_HPP
@@ -0,0 +1,237 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "preflight_check.hpp"
+
+#include "rpm_log_guard.hpp"
+#include "transaction.hpp"
+
+#include "libdnf5/base/base.hpp"
+#include "libdnf5/rpm/package.hpp"
+#include "libdnf5/rpm/reldep_list.hpp"
+#include "libdnf5/transaction/transaction_item_action.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <fmt/format.h>
+#include <rpm/header.h>
+#include <rpm/rpmdb.h>
+#include <rpm/rpmds.h>
+#include <rpm/rpmtag.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <system_error>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+void put_dependencies(
+    Header header, rpmTagVal name_tag, rpmTagVal flags_tag, rpmTagVal version_tag, const ReldepList & deps) {
+    for (const auto & dep : deps) {
+        std::string name;
+        std::string version;
+        rpm_flag_t flags{RPMSENSE_ANY};
+        std::string_view relation = dep.get_relation();
+        if (std::ranges::any_of(relation, [](char c) { return std::isalpha(static_cast<unsigned char>(c)); })) {
+            // a rich dependency is stored whole in the name
+            name = dep.to_string();
+            if (!name.starts_with('(')) {
+                name = "(" + name + ")";
+            }
+        } else {
+            name = dep.get_name();
+            version = dep.get_version();
+            if (relation.find('<') != std::string_view::npos) {
+                flags |= RPMSENSE_LESS;
+            }
+            if (relation.find('>') != std::string_view::npos) {
+                flags |= RPMSENSE_GREATER;
+            }
+            if (relation.find('=') != std::string_view::npos) {
+                flags |= RPMSENSE_EQUAL;
+            }
+        }
+        headerPutString(header, name_tag, name.c_str());
+        headerPutUint32(header, flags_tag, &flags, 1);
+        headerPutString(header, version_tag, version.c_str());
+    }
+}
+
+// Creates the header of the `package` from the repository metadata with the tags the rpm dependency check uses.
+// The file list is complete only when the filelists metadata are loaded.
+Header create_metadata_header(const Package & package) {
+    Header header = headerNew();
+    headerPutString(header, RPMTAG_NAME, package.get_name().c_str());
+    if (auto epoch = static_cast<uint32_t>(std::stoul(package.get_epoch())); epoch != 0) {
+        headerPutUint32(header, RPMTAG_EPOCH, &epoch, 1);
+    }
+    headerPutString(header, RPMTAG_VERSION, package.get_version().c_str());
+    headerPutString(header, RPMTAG_RELEASE, package.get_release().c_str());
+    headerPutString(header, RPMTAG_ARCH, package.get_arch().c_str());
+    headerPutString(header, RPMTAG_OS, "linux");
+    // rpm treats a header without the source rpm as a source package
+    auto sourcerpm = package.get_sourcerpm();
+    headerPutString(header, RPMTAG_SOURCERPM, sourcerpm.empty() ? "(none)" : sourcerpm.c_str());
+
+    put_dependencies(header, RPMTAG_PROVIDENAME, RPMTAG_PROVIDEFLAGS, RPMTAG_PROVIDEVERSION, package.get_provides());
+    put_dependencies(header, RPMTAG_REQUIRENAME, RPMTAG_REQUIREFLAGS, RPMTAG_REQUIREVERSION, package.get_requires());
+    put_dependencies(
+        header, RPMTAG_CONFLICTNAME, RPMTAG_CONFLICTFLAGS, RPMTAG_CONFLICTVERSION, package.get_conflicts());
+    put_dependencies(
+        header, RPMTAG_OBSOLETENAME, RPMTAG_OBSOLETEFLAGS, RPMTAG_OBSOLETEVERSION, package.get_obsoletes());
+
+    std::map<std::string, uint32_t> dir_indexes;
+    for (const auto & file : package.get_files()) {
+        std::filesystem::path file_path(file);
+        auto dir = file_path.parent_path().string();
+        if (!dir.ends_with('/')) {
+            dir += '/';
+        }
+        auto [it, inserted] = dir_indexes.emplace(dir, static_cast<uint32_t>(dir_indexes.size()));
+        if (inserted) {
+            headerPutString(header, RPMTAG_DIRNAMES, dir.c_str());
+        }
+        headerPutString(header, RPMTAG_BASENAMES, file_path.filename().c_str());
+        headerPutUint32(header, RPMTAG_DIRINDEXES, &it->second, 1);
+    }
+
+    return header;
+}
+
+// Returns the space available in the filesystem of `path`, the path does not have to exist yet
+std::uintmax_t get_available_space(std::filesystem::path path) {
+    std::error_code ec;
+    while (!std::filesystem::exists(path, ec) && path.has_relative_path()) {
+        path = path.parent_path();
+    }
+    return std::filesystem::space(path, ec).available;
+}
+
+}  // namespace
+
+
+PreflightCheck::~PreflightCheck() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (ts) {
+        rpmtsFree(ts);
+    }
+}
+
+void PreflightCheck::start(const std::vector<libdnf5::base::TransactionPackage> & packages) try {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "fill preflight rpm transaction");
+    RpmLogGuard rpm_log_guard{base};
+
+    auto & config = base->get_config();
+    installroot = config.get_installroot_option().get_value();
+    check_disk_space = config.get_diskspacecheck_option().get_value();
+
+    ts = rpmtsCreate();
+    if (rpmtsSetRootDir(ts, installroot.c_str()) != 0) {
+        throw TransactionError(M_("Cannot set root directory \"{}\""), installroot);
+    }
+    if (rpmtsOpenDB(ts, rpmtsGetDBMode(ts)) != 0) {
+        throw TransactionError(M_("Cannot open rpm database"));
+    }
+
+    for (const auto & tspkg : packages) {
+        auto action = tspkg.get_action();
+        const auto & package = tspkg.get_package();
+        if (transaction_item_action_is_inbound(action)) {
+            auto * header = create_metadata_header(package);
+            int rc;
+            if (action == libdnf5::transaction::TransactionItemAction::REINSTALL) {
+                rc = rpmtsAddReinstallElement(ts, header, nullptr);
+            } else {
+                bool upgrade = action != libdnf5::transaction::TransactionItemAction::INSTALL;
+                rc = rpmtsAddInstallElement(ts, header, nullptr, upgrade ? 1 : 0, nullptr);
+            }
+            headerFree(header);
+            if (rc != 0) {
+                throw TransactionError(M_("Cannot add package \"{}\""), package.get_full_nevra());
+            }
+            needed_space += static_cast<long long>(package.get_install_size());
+        } else if (transaction_item_action_is_outbound(action)) {
+            // an element already added by rpm for an upgrade is not added twice
+            auto rpmdb_id = static_cast<unsigned int>(package.get_rpmdbid());
+            auto * iter = rpmtsInitIterator(ts, RPMDBI_PACKAGES, &rpmdb_id, sizeof(rpmdb_id));
+            auto * header = iter ? rpmdbNextIterator(iter) : nullptr;
+            auto rc = header ? rpmtsAddEraseElement(ts, header, -1) : 1;
+            rpmdbFreeIterator(iter);
+            if (rc != 0) {
+                throw TransactionError(M_("Cannot remove package \"{}\""), package.get_full_nevra());
+            }
+            needed_space -= static_cast<long long>(package.get_install_size());
+        }
+    }
+
+    thread = std::thread(&PreflightCheck::run, this);
+} catch (const std::exception & ex) {
+    base->get_logger()->warning("Preflight check of the transaction skipped: {}", ex.what());
+}
+
+void PreflightCheck::finish() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void PreflightCheck::run() noexcept {
+    // The thread must not throw exceptions
+    auto & logger = *base->get_logger();
+    try {
+        std::vector<std::string> problems;
+        {
+            RpmLogGuard rpm_log_guard{base};
+            if (rpmtsCheck(ts) != 0) {
+                for (auto problem : RpmProblemSet(rpmtsProblems(ts))) {
+                    problems.push_back(problem.to_string());
+                }
+            }
+        }
+
+        if (check_disk_space && needed_space > 0) {
+            auto available_space = get_available_space(installroot);
+            if (static_cast<std::uintmax_t>(needed_space) > available_space) {
+                problems.push_back(fmt::format(
+                    "not enough free space in \"{}\": the packages need {:.1f} MiB, {:.1f} MiB available",
+                    installroot,
+                    static_cast<double>(needed_space) / 1048576,
+                    static_cast<double>(available_space) / 1048576));
+            }
+        }
+
+        if (!problems.empty()) {
+            logger.warning("Preflight check of the transaction found problems:");
+            for (const auto & problem : problems) {
+                logger.warning(" " + problem);
+            }
+        }
+    } catch (const std::exception & ex) {
+        logger.warning("Preflight check of the transaction failed: {}", ex.what());
+    }
+}
+
+}  // namespace libdnf5::rpm
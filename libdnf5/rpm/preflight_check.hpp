@@ -0,0 +1,71 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_PREFLIGHT_CHECK_HPP
+#define LIBDNF5_RPM_PREFLIGHT_CHECK_HPP
+
+#include "libdnf5/base/base_weak.hpp"
+#include "libdnf5/base/transaction_package.hpp"
+
+#include <rpm/rpmts.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Checks the rpm dependencies of a transaction and estimates its disk space in a background thread, so that
+/// the problems are found while the packages are still being downloaded. The inbound packages are represented
+/// by headers created from the repository metadata, the outbound ones by their headers from the rpm database.
+///
+/// The rpm transaction set is filled by `start()` in the calling thread, the background thread does not access
+/// the package pool.
+class PreflightCheck {
+public:
+    explicit PreflightCheck(const BaseWeakPtr & base) : base(base) {}
+    PreflightCheck(const PreflightCheck &) = delete;
+    PreflightCheck & operator=(const PreflightCheck &) = delete;
+
+    /// Waits for the running check.
+    ~PreflightCheck();
+
+    /// Fills the rpm transaction set with the `packages` and starts the check in the background thread.
+    /// The found problems are logged as soon as the check ends.
+    void start(const std::vector<libdnf5::base::TransactionPackage> & packages);
+
+    /// Waits until the check is done.
+    void finish();
+
+private:
+    void run() noexcept;
+
+    BaseWeakPtr base;
+    std::string installroot;
+    bool check_disk_space{false};
+    rpmts ts{nullptr};
+    /// Disk space the transaction needs according to the package sizes in the metadata
+    long long needed_space{0};
+    std::thread thread;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_PREFLIGHT_CHECK_HPP
@@ -86,12 +86,20 @@ ReldepId Reldep::get_reldep_id(
 }
 
 ReldepId Reldep::get_reldep_id(const BaseWeakPtr & base, const std::string & reldep_str, int create) {
+    auto & pool = get_rpm_pool(base);
+    // Only the created Ids are cached, an unknown name can be created later
+    auto & reldep_cache = pool.get_reldep_cache();
+    if (Id id = reldep_cache.lookup(reldep_str)) {
+        return ReldepId(id);
+    }
+
     if (is_rich_dependency(reldep_str)) {
-        Id id = pool_parserpmrichdep(*get_rpm_pool(base), reldep_str.c_str());
+        Id id = pool_parserpmrichdep(*pool, reldep_str.c_str());
         // TODO(jmracek) Replace runtime_error. Do we need to throw an error?
         if (id == 0) {
             throw RuntimeError(M_("Cannot parse a dependency string"));
         }
+        reldep_cache.store(reldep_str, id);
         return ReldepId(id);
     }
 
@@ -99,8 +107,12 @@ ReldepId Reldep::get_reldep_id(const BaseWeakPtr & base, const std::string & rel
     if (!dep_splitter.parse(reldep_str)) {
         throw RuntimeError(M_("Cannot parse a dependency string"));
     }
-    return get_reldep_id(
+    auto id = get_reldep_id(
         base, dep_splitter.get_name_cstr(), dep_splitter.get_evr_cstr(), dep_splitter.get_cmp_type(), create);
+    if (id.id != 0) {
+        reldep_cache.store(reldep_str, id.id);
+    }
+    return id;
 }
 
 }  // namespace libdnf5::rpm
@@ -25,6 +25,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "solv/reldep_parser.hpp"
 
 #include "libdnf5/rpm/reldep.hpp"
+#include "libdnf5/utils/patterns.hpp"
 
 // libsolv
 extern "C" {
@@ -32,6 +33,8 @@ extern "C" {
 #include <solv/queue.h>
 }
 
+#include <utility>
+
 
 namespace libdnf5::rpm {
 
@@ -89,13 +92,23 @@ void ReldepList::add(ReldepId id) {
 }
 
 bool ReldepList::add_reldep_with_glob(const std::string & reldep_str) {
+    auto & pool = get_rpm_pool(p_impl->base);
+    auto & reldep_cache = pool.get_reldep_cache();
+    if (auto * cached_ids = reldep_cache.lookup_glob(reldep_str)) {
+        p_impl->queue.reserve(p_impl->queue.size() + static_cast<int>(cached_ids->size()));
+        for (Id id : *cached_ids) {
+            p_impl->queue.push_back(id);
+        }
+        return true;
+    }
+
     libdnf5::solv::ReldepParser dep_splitter;
     if (!dep_splitter.parse(reldep_str))
         return false;
 
+    std::vector<Id> ids;
     Dataiterator di;
-    dataiterator_init(
-        &di, *get_rpm_pool(p_impl->base), 0, 0, 0, dep_splitter.get_name_cstr(), SEARCH_STRING | SEARCH_GLOB);
+    dataiterator_init(&di, *pool, 0, 0, 0, dep_splitter.get_name_cstr(), SEARCH_STRING | SEARCH_GLOB);
     while (dataiterator_step(&di)) {
         switch (di.key->name) {
             case SOLVABLE_PROVIDES:
@@ -106,12 +119,19 @@ bool ReldepList::add_reldep_with_glob(const std::string & reldep_str) {
             case SOLVABLE_SUGGESTS:
             case SOLVABLE_SUPPLEMENTS:
             case SOLVABLE_ENHANCES:
-            case SOLVABLE_FILELIST:
-                add(Reldep::get_reldep_id(
-                    p_impl->base, di.kv.str, dep_splitter.get_evr_cstr(), dep_splitter.get_cmp_type()));
+            case SOLVABLE_FILELIST: {
+                auto id = Reldep::get_reldep_id(
+                    p_impl->base, di.kv.str, dep_splitter.get_evr_cstr(), dep_splitter.get_cmp_type());
+                ids.push_back(id.id);
+            }
         }
     }
     dataiterator_free(&di);
+
+    for (Id id : ids) {
+        p_impl->queue.push_back(id);
+    }
+    reldep_cache.store_glob(reldep_str, std::move(ids));
     return true;
 }
 
@@ -129,6 +149,21 @@ bool ReldepList::add_reldep(const std::string & reldep_str, int create) {
     }
 }
 
+bool ReldepList::add_reldeps(const std::vector<std::string> & reldep_strs, bool with_glob) {
+    p_impl->queue.reserve(p_impl->queue.size() + static_cast<int>(reldep_strs.size()));
+    bool all_added = true;
+    for (const auto & reldep_str : reldep_strs) {
+        bool added;
+        if (with_glob && libdnf5::utils::is_glob_pattern(reldep_str.c_str())) {
+            added = add_reldep_with_glob(reldep_str);
+        } else {
+            added = add_reldep(reldep_str);
+        }
+        all_added = all_added && added;
+    }
+    return all_added;
+}
+
 void ReldepList::append(ReldepList & source) {
     libdnf_assert_same_base(p_impl->base, source.get_base());
     p_impl->queue += source.p_impl->queue;
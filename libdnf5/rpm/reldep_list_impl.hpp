@@ -25,9 +25,30 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/rpm/reldep_list.hpp"
 
+extern "C" {
+#include <solv/solvable.h>
+}
+
 
 namespace libdnf5::rpm {
 
+/// Replaces the content of the `queue` with the reldeps of the `type` of the `solvable`. The `SOLVABLE_REQUIRES`
+/// type selects only the regular requires, the `SOLVABLE_PREREQMARKER` type selects the requires_pre.
+inline void reldeps_for(Solvable * solvable, libdnf5::solv::IdQueue & queue, Id type) {
+    Id marker = -1;
+    Id solv_type = type;
+
+    if (type == SOLVABLE_REQUIRES) {
+        marker = -1;
+    }
+
+    if (type == SOLVABLE_PREREQMARKER) {
+        solv_type = SOLVABLE_REQUIRES;
+        marker = 1;
+    }
+    solvable_lookup_deparray(solvable, solv_type, &queue.get_queue(), marker);
+}
+
 class ReldepList::Impl {
 public:
     Impl(const ReldepList::Impl & src) = default;
@@ -0,0 +1,107 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf5/rpm/reldep_span.hpp"
+
+#include "solv/pool.hpp"
+
+#include "libdnf5/common/exception.hpp"
+
+
+namespace libdnf5::rpm {
+
+ReldepSpan::ReldepSpan(const Package & package, PackageAttribute attribute) : base(package.get_base()) {
+    Solvable * solvable = get_rpm_pool(base).id2solvable(package.get_id().id);
+    Offset offset{0};
+    // The marker separating the reldeps in the array, see `solv_depmarker()`
+    Id marker{0};
+    switch (attribute) {
+        case PackageAttribute::PROVIDES:
+            offset = solvable->dep_provides;
+            marker = SOLVABLE_FILEMARKER;
+            break;
+        case PackageAttribute::REQUIRES:
+        case PackageAttribute::REQUIRES_PRE:
+            offset = solvable->dep_requires;
+            marker = SOLVABLE_PREREQMARKER;
+            break;
+        case PackageAttribute::CONFLICTS:
+            offset = solvable->dep_conflicts;
+            break;
+        case PackageAttribute::OBSOLETES:
+            offset = solvable->dep_obsoletes;
+            break;
+        case PackageAttribute::RECOMMENDS:
+            offset = solvable->dep_recommends;
+            break;
+        case PackageAttribute::SUGGESTS:
+            offset = solvable->dep_suggests;
+            break;
+        case PackageAttribute::ENHANCES:
+            offset = solvable->dep_enhances;
+            break;
+        case PackageAttribute::SUPPLEMENTS:
+            offset = solvable->dep_supplements;
+            break;
+        default:
+            libdnf_user_assert(false, "Attribute {} is not a reldep attribute", static_cast<int>(attribute));
+    }
+    if (offset == 0 || solvable->repo == nullptr) {
+        return;
+    }
+
+    first = solvable->repo->idarraydata + offset;
+    last = first;
+    while (*last != 0 && *last != marker) {
+        ++last;
+    }
+    if (*last == 0) {
+        // No marker, or the array has no items of the kind that follows it
+        if (attribute == PackageAttribute::REQUIRES_PRE) {
+            first = last;
+        }
+        return;
+    }
+
+    switch (attribute) {
+        case PackageAttribute::PROVIDES:
+            // The file provides added by `pool_addfileprovides_queue()` are not included
+            break;
+        case PackageAttribute::REQUIRES:
+            skipped = last;
+            while (*++last != 0) {
+            }
+            break;
+        case PackageAttribute::REQUIRES_PRE:
+            first = ++last;
+            while (*last != 0) {
+                ++last;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+std::string ReldepSpan::to_string(std::size_t index) const {
+    auto * cstring = get_rpm_pool(base).dep2str(get_id(index).id);
+    return cstring ? std::string(cstring) : std::string();
+}
+
+}  // namespace libdnf5::rpm
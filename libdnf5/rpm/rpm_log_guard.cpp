@@ -89,4 +89,28 @@ RpmLogGuardStrings::RpmLogGuardStrings() : RpmLogGuardBase() {
     rpmlogSetCallback(&rpmlog_callback_strings, this);
 }
 
+
+static thread_local std::vector<std::string> * thread_rpm_logs{nullptr};
+
+static int rpmlog_callback_thread_strings(rpmlogRec rec, [[maybe_unused]] rpmlogCallbackData data) {
+    if (!thread_rpm_logs) {
+        return 0;
+    }
+    std::string msg(rpmlogRecMessage(rec));
+    if (!msg.empty() && msg[msg.length() - 1] == '\n') {
+        msg.pop_back();
+    }
+
+    thread_rpm_logs->emplace_back(std::move(msg));
+    return 0;
+}
+
+RpmLogGuardThreadStrings::RpmLogGuardThreadStrings() : RpmLogGuardBase() {
+    rpmlogSetCallback(&rpmlog_callback_thread_strings, nullptr);
+}
+
+void RpmLogGuardThreadStrings::set_thread_logs(std::vector<std::string> * logs) noexcept {
+    thread_rpm_logs = logs;
+}
+
 }  // namespace libdnf5::rpm
@@ -59,6 +59,18 @@ private:
     std::vector<std::string> rpm_logs{};
 };
 
+/// Collects the rpm log messages separately for each thread, so that rpm operations whose result is parsed from
+/// the log messages can run in several threads at once. The threads register the vector for their messages by
+/// `set_thread_logs()`, the messages of other threads are dropped. The guard has to outlive the threads.
+class RpmLogGuardThreadStrings : public RpmLogGuardBase {
+public:
+    RpmLogGuardThreadStrings();
+    ~RpmLogGuardThreadStrings(){};
+
+    /// Registers `logs` for the rpm log messages of the calling thread, `nullptr` unregisters it.
+    static void set_thread_logs(std::vector<std::string> * logs) noexcept;
+};
+
 }  // namespace libdnf5::rpm
 
 #endif
@@ -21,7 +21,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "repo/repo_pgp.hpp"
 #include "rpm/rpm_log_guard.hpp"
+#include "rpm_signature_private.hpp"
 #include "utils/fs/temp.hpp"
+#include "utils/on_scope_exit.hpp"
 #include "utils/string.hpp"
 #include "utils/url.hpp"
 
@@ -37,6 +39,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <rpm/rpmpgp.h>
 #include <rpm/rpmts.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 namespace libdnf5::rpm {
 
 namespace {
@@ -105,39 +112,29 @@ std::string KeyInfo::get_short_key_id() const {
 }
 
 RpmSignature::CheckResult RpmSignature::check_package_signature(rpm::Package pkg) const {
-    // is package gpg check even required?
-    auto repo = pkg.get_repo();
-    if (repo->get_type() == libdnf5::repo::Repo::Type::COMMANDLINE) {
-        if (!base->get_config().get_localpkg_gpgcheck_option().get_value()) {
-            return CheckResult::SKIPPED;
-        }
-    } else {
-        auto & repo_config = repo->get_config();
-        if (!repo_config.get_gpgcheck_option().get_value()) {
-            return CheckResult::SKIPPED;
-        }
+    if (!is_signature_check_required(pkg)) {
+        return CheckResult::SKIPPED;
     }
+    return check_file_signature(base, pkg.get_package_path());
+}
 
-    // rpmcliVerifySignatures is the only API rpm provides for signature verification.
-    // Unfortunatelly to distinguish key_missing/not_signed/verification_failed cases
-    // we need to temporarily increase log level to RPMLOG_INFO, collect the log
-    // messages and parse them.
-    // This code is only slightly better than running `rpmkeys --checksig` tool
-    // and parsing it's output :(
-
-    // This guard acquires the rpm log mutex and collects all rpm log messages into
-    // the vector of strings.
-    libdnf5::rpm::RpmLogGuardStrings rpm_log_guard;
-
-    auto ts_ptr = create_transaction(base);
-    auto oldmask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
+bool is_signature_check_required(const Package & package) {
+    auto repo = package.get_repo();
+    if (repo->get_type() == libdnf5::repo::Repo::Type::COMMANDLINE) {
+        return package.get_base()->get_config().get_localpkg_gpgcheck_option().get_value();
+    }
+    return repo->get_config().get_gpgcheck_option().get_value();
+}
 
-    rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
-    std::string path = pkg.get_package_path();
-    char * const path_array[2] = {&path[0], NULL};
-    auto rc = rpmcliVerifySignatures(ts_ptr.get(), path_array);
+/// Verifies the signatures of the package file at `path` using `ts`. The rpm log messages of the verification
+/// have to be collected into `rpm_logs` with the log mask up to RPMLOG_INFO.
+static RpmSignature::CheckResult verify_file_signature(
+    rpmts ts, const std::string & path, const std::vector<std::string> & rpm_logs) {
+    using CheckResult = RpmSignature::CheckResult;
 
-    rpmlogSetMask(oldmask);
+    std::string path_copy = path;
+    char * const path_array[2] = {&path_copy[0], NULL};
+    auto rc = rpmcliVerifySignatures(ts, path_array);
 
     if (rc == RPMRC_OK) {
         return CheckResult::OK;
@@ -158,7 +155,7 @@ RpmSignature::CheckResult RpmSignature::check_package_signature(rpm::Package pkg
     bool missing_key{false};
     bool not_trusted{false};
     bool not_signed{false};
-    for (const auto & line : rpm_log_guard.get_rpm_logs()) {
+    for (const auto & line : rpm_logs) {
         std::string_view line_v{line};
         if (line_v.starts_with(path)) {
             continue;
@@ -186,6 +183,88 @@ RpmSignature::CheckResult RpmSignature::check_package_signature(rpm::Package pkg
     return CheckResult::FAILED;
 }
 
+RpmSignature::CheckResult check_file_signature(const BaseWeakPtr & base, const std::string & path) {
+    // rpmcliVerifySignatures is the only API rpm provides for signature verification.
+    // Unfortunatelly to distinguish key_missing/not_signed/verification_failed cases
+    // we need to temporarily increase log level to RPMLOG_INFO, collect the log
+    // messages and parse them.
+    // This code is only slightly better than running `rpmkeys --checksig` tool
+    // and parsing it's output :(
+
+    // This guard acquires the rpm log mutex and collects all rpm log messages into
+    // the vector of strings.
+    libdnf5::rpm::RpmLogGuardStrings rpm_log_guard;
+
+    auto ts_ptr = create_transaction(base);
+    auto oldmask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
+    utils::OnScopeExit restore_mask([oldmask]() noexcept { rpmlogSetMask(oldmask); });
+
+    rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
+    return verify_file_signature(ts_ptr.get(), path, rpm_log_guard.get_rpm_logs());
+}
+
+std::vector<FileSignatureCheck> check_files_signatures(
+    const BaseWeakPtr & base, const std::vector<std::string> & paths, std::size_t max_workers) {
+    std::vector<FileSignatureCheck> checks(paths.size());
+    if (paths.empty()) {
+        return checks;
+    }
+
+    // The rpm log messages are collected for each worker thread separately, the guard holds the rpm log mutex
+    // until all the workers finish
+    libdnf5::rpm::RpmLogGuardThreadStrings rpm_log_guard;
+    auto oldmask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
+    utils::OnScopeExit restore_mask([oldmask]() noexcept { rpmlogSetMask(oldmask); });
+
+    // The keyring is loaded from the rpm database only once and shared by the transactions of the workers
+    auto keyring_ts_ptr = create_transaction(base);
+    std::unique_ptr<rpmKeyring_s, decltype(&rpmKeyringFree)> keyring(
+        rpmtsGetKeyring(keyring_ts_ptr.get(), 1), &rpmKeyringFree);
+
+    std::atomic<std::size_t> next_idx{0};
+    std::mutex except_mutex;
+    std::exception_ptr except_ptr;
+
+    // The worker must not throw exceptions. The first one is passed to the calling thread using exception_ptr.
+    auto worker = [&]() {
+        std::vector<std::string> rpm_logs;
+        libdnf5::rpm::RpmLogGuardThreadStrings::set_thread_logs(&rpm_logs);
+        try {
+            auto ts_ptr = create_transaction(base);
+            rpmtsSetKeyring(ts_ptr.get(), keyring.get());
+            rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
+            for (auto idx = next_idx++; idx < paths.size(); idx = next_idx++) {
+                rpm_logs.clear();
+                auto start = std::chrono::steady_clock::now();
+                checks[idx].result = verify_file_signature(ts_ptr.get(), paths[idx], rpm_logs);
+                checks[idx].duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(except_mutex);
+            if (!except_ptr) {
+                except_ptr = std::current_exception();
+            }
+        }
+        libdnf5::rpm::RpmLogGuardThreadStrings::set_thread_logs(nullptr);
+    };
+
+    const auto num_workers = std::min(paths.size(), std::max<std::size_t>(max_workers, 1));
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto & thread : workers) {
+        thread.join();
+    }
+
+    if (except_ptr) {
+        std::rethrow_exception(except_ptr);
+    }
+    return checks;
+}
+
 bool RpmSignature::key_present(const KeyInfo & key) const {
     libdnf5::rpm::RpmLogGuard rpm_log_guard{base};
     auto ts_ptr = create_transaction(base);
@@ -254,4 +333,60 @@ std::string RpmSignature::check_result_to_string(CheckResult result) {
     return {};
 }
 
+SignatureCheckWorker::~SignatureCheckWorker() {
+    stop(true);
+}
+
+void SignatureCheckWorker::add(std::string path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    paths.push_back(std::move(path));
+    if (!thread.joinable()) {
+        stopping = false;
+        thread = std::thread(&SignatureCheckWorker::run, this);
+    }
+    paths_cond.notify_one();
+}
+
+std::unordered_set<std::string> SignatureCheckWorker::finish() {
+    stop(false);
+    return std::move(verified_paths);
+}
+
+void SignatureCheckWorker::stop(bool drop_paths) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (drop_paths) {
+            paths.clear();
+        }
+        stopping = true;
+    }
+    paths_cond.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SignatureCheckWorker::run() {
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            paths_cond.wait(lock, [this] { return stopping || !paths.empty(); });
+            if (paths.empty()) {
+                return;
+            }
+            path = std::move(paths.front());
+            paths.pop_front();
+        }
+        // The thread must not throw exceptions, a file whose check cannot be done is checked again later
+        try {
+            if (check_file_signature(base, path) == RpmSignature::CheckResult::OK) {
+                std::lock_guard<std::mutex> lock(mutex);
+                verified_paths.insert(std::move(path));
+            }
+        } catch (...) {
+        }
+    }
+}
+
 }  // namespace libdnf5::rpm
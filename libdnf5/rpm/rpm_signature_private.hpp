@@ -0,0 +1,94 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_RPM_RPM_SIGNATURE_PRIVATE_HPP
+#define LIBDNF5_RPM_RPM_SIGNATURE_PRIVATE_HPP
+
+#include "libdnf5/rpm/rpm_signature.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Returns whether the signature of the `package` has to be checked according to the `gpgcheck` option of its repo
+/// or the `localpkg_gpgcheck` option for commandline packages.
+bool is_signature_check_required(const Package & package);
+
+/// Checks the signature of the package file at `path` using public keys stored in rpm database.
+/// It does not access the package pool and can run in a thread other than the one owning the `base`.
+RpmSignature::CheckResult check_file_signature(const BaseWeakPtr & base, const std::string & path);
+
+/// Result of the signature check of a package file
+struct FileSignatureCheck {
+    RpmSignature::CheckResult result{RpmSignature::CheckResult::FAILED};
+    /// Duration of the check
+    std::chrono::microseconds duration{0};
+};
+
+/// Checks the signatures of the package files at `paths` in up to `max_workers` threads. The rpm keyring is loaded
+/// once and shared by the threads. The rpm log mutex is held until all the checks are done.
+/// @return The results of the checks in the order of `paths`.
+std::vector<FileSignatureCheck> check_files_signatures(
+    const BaseWeakPtr & base, const std::vector<std::string> & paths, std::size_t max_workers);
+
+/// Checks the signatures of package files in a background thread, one after another, so that the checks of
+/// the already downloaded packages overlap with the download of the others. The thread is started with the first
+/// added file.
+///
+/// Only the passed checks are recorded. A failed check is repeated by `RpmSignature::check_package_signature()`,
+/// which can resolve it by importing the repository keys.
+class SignatureCheckWorker {
+public:
+    explicit SignatureCheckWorker(const BaseWeakPtr & base) : base(base) {}
+    SignatureCheckWorker(const SignatureCheckWorker &) = delete;
+    SignatureCheckWorker & operator=(const SignatureCheckWorker &) = delete;
+
+    /// Drops the queued checks and waits for the running one.
+    ~SignatureCheckWorker();
+
+    /// Queues the check of the package file at `path`.
+    void add(std::string path);
+
+    /// Waits until all the queued checks are done and returns the paths of the files that passed the check.
+    std::unordered_set<std::string> finish();
+
+private:
+    void run();
+    void stop(bool drop_paths);
+
+    BaseWeakPtr base;
+    std::mutex mutex;
+    std::condition_variable paths_cond;
+    std::deque<std::string> paths;
+    std::unordered_set<std::string> verified_paths;
+    bool stopping{false};
+    std::thread thread;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_RPM_SIGNATURE_PRIVATE_HPP
@@ -21,9 +21,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "solv/pool.hpp"
 
+#include "libdnf5/base/base.hpp"
 #include "libdnf5/common/exception.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
 extern "C" {
 #include <solv/evr.h>
 #include <solv/testcase.h>
@@ -57,6 +66,36 @@ void allow_uninstall_all_but_protected(
     }
 }
 
+/// Returns the time elapsed since `start`
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+/// Appends the binary representation of `value` to the resolve cache `key`
+template <typename T>
+void append_to_key(std::string & key, const T & value) {
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append_queue_to_key(std::string & key, const libdnf5::solv::IdQueue & queue) {
+    const auto & ids = queue.get_queue();
+    append_to_key(key, ids.count);
+    key.append(reinterpret_cast<const char *>(ids.elements), static_cast<std::size_t>(ids.count) * sizeof(Id));
+}
+
+void append_map_to_key(std::string & key, const Map * map) {
+    if (map == nullptr) {
+        append_to_key(key, -1);
+        return;
+    }
+    append_to_key(key, map->size);
+    key.append(reinterpret_cast<const char *>(map->map), static_cast<std::size_t>(map->size));
+}
+
+void append_map_to_key(std::string & key, const libdnf5::solv::SolvMap * map) {
+    append_map_to_key(key, map ? &map->get_map() : nullptr);
+}
+
 void construct_job(
     Pool * pool,
     libdnf5::solv::IdQueue & job,
@@ -93,9 +132,7 @@ void construct_job(
     //         job->pushBack(SOLVER_VERIFY|SOLVER_SOLVABLE_ALL, 0);
 }
 
-void init_solver(libdnf5::solv::Pool & pool, libdnf5::solv::Solver & solver) {
-    solver.init(pool);
-
+void set_default_solver_flags(libdnf5::solv::Solver & solver) {
     /* don't erase packages that are no longer in repo during distupgrade */
     solver.set_flag(SOLVER_FLAG_KEEP_ORPHANS, 1);
     /* no arch change for forcebest */
@@ -127,66 +164,15 @@ bool can_depend_on(Pool * pool, Solvable * sa, Id b) {
     return false;
 }
 
-static void same_name_subqueue(libdnf5::solv::RpmPool & pool, Queue * in, Queue * out) {
-    Id el = queue_pop(in);
-    Id name = pool.id2solvable(el)->name;
-    queue_empty(out);
-    queue_push(out, el);
-    while (in->count && pool.id2solvable(in->elements[in->count - 1])->name == name)
-        // reverses the order so packages are sorted by descending version
-        queue_push(out, queue_pop(in));
-}
 
-
-struct InstallonlyCmpData {
-    libdnf5::solv::RpmPool & pool;
-    Id running_kernel;
-};
+// The comparators use the EVR rank table of the pool as it is, the few compared packages do not justify its update
 
 struct ObsoleteCmpData {
     libdnf5::solv::RpmPool & pool;
+    const libdnf5::solv::EvrRankTable & evr_ranks;
     Id obsolete;
 };
 
-int installonly_cmp(const Id * ap, const Id * bp, const InstallonlyCmpData * s_cb) {
-    Id a = *ap;
-    Id b = *bp;
-    auto & pool = s_cb->pool;
-    Id kernel = s_cb->running_kernel;
-    Solvable * sa = pool.id2solvable(a);
-    Solvable * sb = pool.id2solvable(b);
-
-    // if the names are different sort them differently, particular order does not matter as long as it's consistent.
-    int name_diff = sa->name - sb->name;
-    if (name_diff)
-        return name_diff;
-
-    // same name, if one is/depends on the running kernel put it last
-
-    // move available packages to end of the list
-    if (pool->installed != sa->repo)
-        return 1;
-
-    if (pool->installed != sb->repo)
-        return -1;
-
-    if (kernel >= 0) {
-        if (a == kernel || can_depend_on(*pool, sa, kernel))
-            return 1;
-        if (b == kernel || can_depend_on(*pool, sb, kernel))
-            return -1;
-        // if package has same evr as kernel try them to keep (kernel-devel packages)
-        Solvable * kernelSolvable = pool.id2solvable(kernel);
-        if (sa->evr == kernelSolvable->evr) {
-            return 1;
-        }
-        if (sb->evr == kernelSolvable->evr) {
-            return -1;
-        }
-    }
-    return pool.evrcmp(sa->evr, sb->evr, EVRCMP_COMPARE);
-}
-
 int obsq_cmp(const Id * ap, const Id * bp, const ObsoleteCmpData * s_cb) {
     auto & pool = s_cb->pool;
 
@@ -207,7 +193,7 @@ int obsq_cmp(const Id * ap, const Id * bp, const ObsoleteCmpData * s_cb) {
         }
         return strcmp(pool.id2str(ap_solvable->name), pool.id2str(obs->name));
     }
-    int r = pool.evrcmp(ap_solvable->evr, obs->evr, EVRCMP_COMPARE);
+    int r = s_cb->evr_ranks.compare(ap_solvable->evr, obs->evr);
     if (r) {
         return -r; /* highest version first */
     }
@@ -237,56 +223,87 @@ bool GoalPrivate::limit_installonly_packages(libdnf5::solv::IdQueue & job, Id ru
 
     auto & spool = get_rpm_pool();
     ::Pool * pool = *spool;
-    bool reresolve = false;
+    auto limit = static_cast<std::ptrdiff_t>(installonly_limit);
 
+    // Collect the packages of the installonly provides with more than the limit of packages when some
+    // of the packages is being installed. A package with several installonly provides is collected once.
+    libdnf5::solv::SolvMap collected(spool->nsolvables);
+    std::vector<Id> candidates;
+    std::vector<Id> provide_packages;
     for (int i = 0; i < installonly.size(); ++i) {
         Id p;
         Id pp;
-        libdnf5::solv::IdQueue q;
-        libdnf5::solv::IdQueue installing;
+        bool installing = false;
+        provide_packages.clear();
         FOR_PROVIDES(p, pp, installonly[i]) {
             // TODO(jmracek)  Replase the test by cached data from sack.p_impl->get_solvables()
             if (!spool.is_package(p)) {
                 continue;
             }
             if (libsolv_solver.get_decisionlevel(p) > 0) {
-                q.push_back(p);
+                provide_packages.push_back(p);
+                installing = installing || spool->installed != spool.id2solvable(p)->repo;
             }
         }
-        if (q.size() <= static_cast<int>(installonly_limit)) {
+        if (!installing || static_cast<std::ptrdiff_t>(provide_packages.size()) <= limit) {
             continue;
         }
-        for (int k = 0; k < q.size(); ++k) {
-            Id id = q[k];
-            Solvable * s = spool.id2solvable(id);
-            if (spool->installed != s->repo) {
-                installing.push_back(id);
-                break;
+        for (auto id : provide_packages) {
+            if (!collected.contains_unsafe(id)) {
+                collected.add_unsafe(id);
+                candidates.push_back(id);
             }
         }
-        if (!installing.size()) {
-            continue;
+    }
+    if (candidates.empty()) {
+        return false;
+    }
+
+    // Packages of a name are ordered from the ones kept first: the available packages, the running kernel
+    // and the packages depending on it, the packages with the EVR of the running kernel (kernel-devel)
+    // and then the other installed packages from the highest EVR. The keys are computed once per package.
+    enum class Keep { OTHER, KERNEL_EVR, KERNEL, AVAILABLE };
+    struct InstallonlyKey {
+        Id name;
+        Keep keep;
+        int evr_rank;
+        Id id;
+    };
+    const auto & evr_ranks = spool.get_evr_rank_table(libdnf5::solv::EvrRankTable::Part::EVR);
+    Solvable * kernel_solvable = running_kernel > 0 ? spool.id2solvable(running_kernel) : nullptr;
+    std::vector<InstallonlyKey> keys;
+    keys.reserve(candidates.size());
+    for (auto id : candidates) {
+        Solvable * solvable = spool.id2solvable(id);
+        Keep keep = Keep::OTHER;
+        if (spool->installed != solvable->repo) {
+            keep = Keep::AVAILABLE;
+        } else if (kernel_solvable) {
+            if (id == running_kernel || can_depend_on(pool, solvable, running_kernel)) {
+                keep = Keep::KERNEL;
+            } else if (solvable->evr == kernel_solvable->evr) {
+                keep = Keep::KERNEL_EVR;
+            }
         }
+        keys.push_back({solvable->name, keep, evr_ranks.get_rank(solvable->evr), id});
+    }
+    std::sort(keys.begin(), keys.end(), [](const InstallonlyKey & a, const InstallonlyKey & b) {
+        return std::tie(a.name, b.keep, b.evr_rank, a.id) < std::tie(b.name, a.keep, a.evr_rank, b.id);
+    });
 
-        const InstallonlyCmpData installonly_cmp_data{spool, running_kernel};
-        q.sort(&installonly_cmp, &installonly_cmp_data);
-
-        libdnf5::solv::IdQueue same_names;
-        while (q.size() > 0) {
-            same_name_subqueue(spool, &q.get_queue(), &same_names.get_queue());
-            if (same_names.size() <= static_cast<int>(installonly_limit)) {
-                continue;
-            }
+    bool reresolve = false;
+    for (auto begin = keys.begin(); begin != keys.end();) {
+        auto end = std::find_if(begin, keys.end(), [&begin](const InstallonlyKey & key) {
+            return key.name != begin->name;
+        });
+        if (end - begin > limit) {
             reresolve = true;
-            for (int j = 0; j < same_names.size(); ++j) {
-                Id id = same_names[j];
-                Id action = SOLVER_ERASE;
-                if (j < static_cast<int>(installonly_limit)) {
-                    action = SOLVER_INSTALL;
-                }
-                job.push_back(action | SOLVER_SOLVABLE, id);
+            for (auto it = begin; it != end; ++it) {
+                Id action = it - begin < limit ? SOLVER_INSTALL : SOLVER_ERASE;
+                job.push_back(action | SOLVER_SOLVABLE, it->id);
             }
         }
+        begin = end;
     }
     return reresolve;
 }
@@ -333,6 +350,11 @@ libdnf5::solv::IdQueue GoalPrivate::list_results(Id type_filter1, Id type_filter
 
 libdnf5::GoalProblem GoalPrivate::resolve() {
     auto & pool = get_rpm_pool();
+    resolve_stats = {};
+    // Each phase replaces the span of the previous one, the last span ends with the function
+    std::optional<libdnf5::base::SpanRecorder::Scope> phase_span;
+    phase_span.emplace(base->get_span_recorder(), "construct job");
+    auto phase_start = std::chrono::steady_clock::now();
     libdnf5::solv::IdQueue job(staging);
     construct_job(
         *pool,
@@ -354,7 +376,9 @@ libdnf5::GoalProblem GoalPrivate::resolve() {
         libsolv_transaction = NULL;
     }
 
-    init_solver(pool, libsolv_solver);
+    resolved_from_cache = false;
+    cached_reasons.clear();
+    cleandeps.reset();
 
     // Remove SOLVER_WEAK and add SOLVER_BEST to all transactions to allow report skipped packages and best candidates
     // with broken dependenies
@@ -365,6 +389,37 @@ libdnf5::GoalProblem GoalPrivate::resolve() {
         }
     }
 
+    resolve_stats.jobs = job.size() / 2;
+
+    std::string resolve_cache_key;
+    if (resolve_cache) {
+        resolve_cache_key = make_resolve_cache_key(job);
+        if (auto solution = resolve_cache->lookup(resolve_cache_key)) {
+            libsolv_solver.reset();
+            resolved_from_cache = true;
+            cached_reasons = solution->reasons;
+            libsolv_transaction = transaction_create_clone(solution->transaction.get());
+            resolve_stats.job_construction = elapsed_since(phase_start);
+            resolve_stats.from_resolve_cache = true;
+            resolve_stats.transaction_steps = libsolv_transaction->steps.count;
+            return protected_in_removals();
+        }
+    }
+    resolve_stats.job_construction = elapsed_since(phase_start);
+
+    phase_span.emplace(base->get_span_recorder(), "init solver");
+    phase_start = std::chrono::steady_clock::now();
+    if (reuse_solver && libsolv_solver.is_initialized() && solver_nsolvables == pool->nsolvables &&
+        solver_installed == pool->installed) {
+        // The solver was created for the same pool, solver_solve() rebuilds the rules for the new job
+        resolve_stats.reused_solver = true;
+    } else {
+        libsolv_solver.init(pool);
+        solver_nsolvables = pool->nsolvables;
+        solver_installed = pool->installed;
+    }
+    set_default_solver_flags(libsolv_solver);
+
     int ignore_weak_deps = install_weak_deps ? 0 : 1;
     libsolv_solver.set_flag(SOLVER_FLAG_IGNORE_RECOMMENDED, ignore_weak_deps);
 
@@ -375,8 +430,14 @@ libdnf5::GoalProblem GoalPrivate::resolve() {
     int vendor_change = allow_vendor_change ? 1 : 0;
     libsolv_solver.set_flag(SOLVER_FLAG_ALLOW_VENDORCHANGE, vendor_change);
     libsolv_solver.set_flag(SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE, vendor_change);
+    resolve_stats.solver_init = elapsed_since(phase_start);
 
+    phase_span.emplace(base->get_span_recorder(), "run solver");
+    phase_start = std::chrono::steady_clock::now();
+    ++resolve_stats.solver_runs;
     if (libsolv_solver.solve(job)) {
+        resolve_stats.solve = elapsed_since(phase_start);
+        resolve_stats.solver_problems = static_cast<int>(libsolv_solver.problem_count());
         return libdnf5::GoalProblem::SOLVER_ERROR;
     }
 
@@ -384,16 +445,72 @@ libdnf5::GoalProblem GoalPrivate::resolve() {
     if (limit_installonly_packages(job, protected_running_kernel.id)) {
         // allow erasing non-installonly packages that depend on a kernel about to be erased
         allow_uninstall_all_but_protected(*pool, job, protected_packages.get(), protected_running_kernel);
+        ++resolve_stats.solver_runs;
         if (libsolv_solver.solve(job)) {
+            resolve_stats.solve = elapsed_since(phase_start);
+            resolve_stats.solver_problems = static_cast<int>(libsolv_solver.problem_count());
             return libdnf5::GoalProblem::SOLVER_ERROR;
         }
     }
 
     libsolv_transaction = libsolv_solver.create_transaction();
+    resolve_stats.solve = elapsed_since(phase_start);
+    resolve_stats.decisions = libsolv_solver.get_decisionqueue().size();
+    resolve_stats.transaction_steps = libsolv_transaction->steps.count;
+
+    // Only solutions without problems are stored, the problems are described by the solver
+    if (resolve_cache && libsolv_solver.problem_count() == 0) {
+        ResolveCache::Solution solution;
+        solution.transaction.reset(transaction_create_clone(libsolv_transaction));
+        for (int i = 0; i < libsolv_transaction->steps.count; ++i) {
+            Id id = libsolv_transaction->steps.elements[i];
+            solution.reasons.emplace(id, get_reason(id));
+        }
+        resolve_cache->store(resolve_cache_key, std::move(solution));
+    }
 
     return protected_in_removals();
 }
 
+std::string GoalPrivate::make_resolve_cache_key(const libdnf5::solv::IdQueue & job) {
+    auto & pool = get_rpm_pool();
+    std::string key;
+
+    // Inputs of the solver
+    append_queue_to_key(key, job);
+    append_queue_to_key(key, installonly);
+    append_to_key(key, installonly_limit);
+    append_to_key(key, protected_running_kernel.id);
+    append_map_to_key(key, protected_packages.get());
+    append_queue_to_key(key, user_installed_packages ? *user_installed_packages : libdnf5::solv::IdQueue());
+    append_map_to_key(key, transaction_user_installed.get());
+    append_map_to_key(key, transaction_group_installed.get());
+    append_map_to_key(key, exclude_from_weak.get());
+    append_to_key(key, allow_downgrade);
+    append_to_key(key, allow_erasing);
+    append_to_key(key, allow_vendor_change);
+    append_to_key(key, install_weak_deps);
+    append_to_key(key, run_in_strict_mode);
+
+    // State of the pool, the cache is also invalidated by the package sack when it changes
+    append_to_key(key, pool->nsolvables);
+    append_to_key(key, pool->installed);
+    Repo * repo;
+    Id repo_id;
+    FOR_REPOS(repo_id, repo) {
+        append_to_key(key, repo);
+        append_to_key(key, repo->start);
+        append_to_key(key, repo->end);
+        append_to_key(key, repo->nsolvables);
+        // the solver prefers the packages of the repositories with higher priority and lower cost
+        append_to_key(key, repo->priority);
+        append_to_key(key, repo->subpriority);
+    }
+    append_map_to_key(key, pool->considered);
+
+    return key;
+}
+
 libdnf5::solv::IdQueue GoalPrivate::list_installs() {
     return list_results(SOLVER_TRANSACTION_INSTALL, SOLVER_TRANSACTION_OBSOLETES);
 }
@@ -418,8 +535,10 @@ libdnf5::solv::IdQueue GoalPrivate::list_obsoleted() {
     return list_results(SOLVER_TRANSACTION_OBSOLETED, 0);
 }
 
-void GoalPrivate::write_debugdata(const std::filesystem::path & abs_dest_dir) {
-    libsolv_solver.write_debugdata(abs_dest_dir);
+void GoalPrivate::write_debugdata(
+    const std::filesystem::path & abs_dest_dir, const libdnf5::solv::DebugdataOptions & options) {
+    libdnf_assert(!resolved_from_cache, "Solver debug data cannot be written for a goal resolved from cache");
+    libsolv_solver.write_debugdata(abs_dest_dir, true, options);
 }
 
 // PackageSet
@@ -451,6 +570,11 @@ std::vector<std::vector<std::tuple<ProblemRules, Id, Id, Id, std::string>>> Goal
 
     libdnf_assert_goal_resolved();
 
+    // Only solutions without problems are stored in the resolve cache
+    if (resolved_from_cache) {
+        return {};
+    }
+
     auto count_problems = static_cast<int>(libsolv_solver.problem_count());
     if (count_problems == 0) {
         return {};
@@ -666,6 +790,11 @@ transaction::TransactionItemReason GoalPrivate::get_reason(Id id) {
     //solver_get_recommendations
     libdnf_assert_goal_resolved();
 
+    if (resolved_from_cache) {
+        auto it = cached_reasons.find(id);
+        return it == cached_reasons.end() ? transaction::TransactionItemReason::DEPENDENCY : it->second;
+    }
+
     Id info;
     int reason = libsolv_solver.describe_decision(id, &info);
 
@@ -686,24 +815,38 @@ transaction::TransactionItemReason GoalPrivate::get_reason(Id id) {
         return transaction::TransactionItemReason::CLEAN;
     if (reason == SOLVER_REASON_WEAKDEP)
         return transaction::TransactionItemReason::WEAK_DEPENDENCY;
-    auto cleanDepsQueue = libsolv_solver.get_cleandeps();
-    for (int i = 0; i < cleanDepsQueue.size(); ++i) {
-        if (cleanDepsQueue[i] == id) {
-            return transaction::TransactionItemReason::CLEAN;
+    // The queue of the clean dependencies is built by the solver on each call, it is collected once for all
+    // the packages of the transaction
+    if (!cleandeps) {
+        cleandeps = std::make_unique<libdnf5::solv::SolvMap>(get_rpm_pool().get_nsolvables());
+        for (Id clean_id : libsolv_solver.get_cleandeps()) {
+            cleandeps->add_unsafe(clean_id);
         }
     }
+    if (cleandeps->contains(id)) {
+        return transaction::TransactionItemReason::CLEAN;
+    }
     return transaction::TransactionItemReason::DEPENDENCY;
 }
 
 libdnf5::solv::IdQueue GoalPrivate::list_obsoleted_by_package(Id id) {
+    libdnf5::solv::IdQueue obsoletes;
+    list_obsoleted_by_package(id, obsoletes);
+    return obsoletes;
+}
+
+void GoalPrivate::list_obsoleted_by_package(Id id, libdnf5::solv::IdQueue & obsoletes) {
     if (!libsolv_transaction) {
         throw RuntimeError(M_("no solution possible"));
     }
-    libdnf5::solv::IdQueue obsoletes;
+    // transaction_all_obs_pkgs() empties the queue, its allocated space is kept
     transaction_all_obs_pkgs(libsolv_transaction, id, &obsoletes.get_queue());
-    const ObsoleteCmpData obsoete_cmp_data{get_rpm_pool(), id};
-    obsoletes.sort(&obsq_cmp, &obsoete_cmp_data);
-    return obsoletes;
+    if (obsoletes.size() > 1) {
+        auto & pool = get_rpm_pool();
+        const ObsoleteCmpData obsoete_cmp_data{
+            pool, pool.get_evr_rank_table(libdnf5::solv::EvrRankTable::Part::EVR, false), id};
+        obsoletes.sort(&obsq_cmp, &obsoete_cmp_data);
+    }
 }
 
 }  // namespace libdnf5::rpm::solv
@@ -20,12 +20,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF5_RPM_SOLV_GOAL_PRIVATE_HPP
 #define LIBDNF5_RPM_SOLV_GOAL_PRIVATE_HPP
 
+#include "resolve_cache.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
 #include "solv/solver.hpp"
 
 #include "libdnf5/base/goal_elements.hpp"
+#include "libdnf5/base/resolve_stats.hpp"
 #include "libdnf5/comps/environment/environment.hpp"
 #include "libdnf5/comps/group/group.hpp"
 #include "libdnf5/rpm/package_sack.hpp"
@@ -35,9 +37,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <solv/solver.h>
 
 #include <filesystem>
+#include <string>
+#include <unordered_map>
 
-#define libdnf_assert_goal_resolved() \
-    libdnf_assert(libsolv_solver.is_initialized(), "Performing an operation that requires Goal to be resolved");
+#define libdnf_assert_goal_resolved()                           \
+    libdnf_assert(                                              \
+        libsolv_solver.is_initialized() || resolved_from_cache, \
+        "Performing an operation that requires Goal to be resolved");
 
 namespace libdnf5::rpm::solv {
 
@@ -121,7 +127,9 @@ public:
     };
 
     /// @param abs_dest_dir Destination directory. Requires a full existing path.
-    void write_debugdata(const std::filesystem::path & abs_dest_dir);
+    /// @param options Compression of the repositories and the packages that are dumped
+    void write_debugdata(
+        const std::filesystem::path & abs_dest_dir, const libdnf5::solv::DebugdataOptions & options = {});
 
     /// Get protected running kernel
     /// PackageId.id == 0 => not set
@@ -162,6 +170,8 @@ public:
     transaction::TransactionItemReason get_reason(Id id);
     /// Returns IDs sorted by name, evr, arch of given id to bring the "same name" obsoleters (i.e. upgraders) to front
     libdnf5::solv::IdQueue list_obsoleted_by_package(Id id);
+    /// Stores the result of `list_obsoleted_by_package(id)` in `obsoletes`, so that the queue can be reused
+    void list_obsoleted_by_package(Id id, libdnf5::solv::IdQueue & obsoletes);
 
     ::Transaction * get_transaction() { return libsolv_transaction; }
 
@@ -177,11 +187,26 @@ public:
     /// Add packages that should not be used by solver to satisfy weak dependencies
     void add_exclude_from_weak(const libdnf5::solv::SolvMap & solvmap);
 
+    /// Durations of the solver phases and statistics of the solver of the last resolve()
+    const libdnf5::base::ResolveStats & get_resolve_stats() const noexcept { return resolve_stats; }
+
+    /// Set the cache of solutions used by resolve(), `nullptr` disables it.
+    /// A goal resolved from the cache has no solver, it cannot write the solver debug data.
+    void set_resolve_cache(ResolveCache * cache) { resolve_cache = cache; }
+
+    /// When enabled, the libsolv solver survives the assignment of new inputs and is reused by the next resolve()
+    /// as long as the number of solvables and the installed repo of the pool stay the same.
+    void set_reuse_solver(bool reuse) { reuse_solver = reuse; }
+
 private:
     bool limit_installonly_packages(libdnf5::solv::IdQueue & job, Id running_kernel);
 
     libdnf5::solv::IdQueue list_results(Id type_filter1, Id type_filter2);
 
+    /// Returns the key of the resolve cache, it serializes the `job` and all other inputs of the solver
+    /// together with the state of the pool
+    std::string make_resolve_cache_key(const libdnf5::solv::IdQueue & job);
+
     BaseWeakPtr base;
 
     libdnf5::solv::IdQueue staging;
@@ -199,6 +224,22 @@ private:
     libdnf5::solv::Solver libsolv_solver;
     ::Transaction * libsolv_transaction{nullptr};
 
+    // Keep libsolv_solver for the next resolve(), it is not copied to other goals
+    bool reuse_solver{false};
+    // The pool state libsolv_solver was created for
+    int solver_nsolvables{0};
+    ::Repo * solver_installed{nullptr};
+
+    ResolveCache * resolve_cache{nullptr};
+    // The goal was resolved from the resolve cache, libsolv_solver is not initialized in that case
+    bool resolved_from_cache{false};
+    // Reasons of the packages in the transaction taken from the resolve cache
+    std::unordered_map<Id, transaction::TransactionItemReason> cached_reasons;
+    // Packages erased as unneeded dependencies by the last resolve(), collected by the first get_reason()
+    std::unique_ptr<libdnf5::solv::SolvMap> cleandeps;
+
+    libdnf5::base::ResolveStats resolve_stats;
+
     std::unique_ptr<libdnf5::solv::SolvMap> protected_packages;
     std::unique_ptr<libdnf5::solv::SolvMap> removal_of_protected;
     PackageId protected_running_kernel{0};
@@ -239,6 +280,7 @@ inline GoalPrivate::GoalPrivate(const GoalPrivate & src)
       staging(src.staging),
       installonly(src.installonly),
       installonly_limit(src.installonly_limit),
+      resolve_cache(src.resolve_cache),
       protected_running_kernel(src.protected_running_kernel),
       allow_downgrade(src.allow_downgrade),
       allow_erasing(src.allow_erasing),
@@ -268,13 +310,18 @@ inline GoalPrivate & GoalPrivate::operator=(const GoalPrivate & src) {
         staging = src.staging;
         installonly = src.installonly;
         installonly_limit = src.installonly_limit;
-        if (libsolv_solver.is_initialized()) {
+        if (libsolv_solver.is_initialized() && !reuse_solver) {
             libsolv_solver.reset();
         }
         if (libsolv_transaction != nullptr) {
             transaction_free(libsolv_transaction);
             libsolv_transaction = nullptr;
         }
+        resolve_cache = src.resolve_cache;
+        resolved_from_cache = false;
+        cached_reasons.clear();
+        cleandeps.reset();
+        resolve_stats = {};
         protected_packages.reset(
             src.protected_packages ? new libdnf5::solv::SolvMap(*src.protected_packages) : nullptr);
         removal_of_protected.reset();
@@ -0,0 +1,62 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "resolve_cache.hpp"
+
+
+namespace libdnf5::rpm::solv {
+
+const ResolveCache::Solution * ResolveCache::lookup(const std::string & key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    return &it->second;
+}
+
+
+void ResolveCache::store(const std::string & key, Solution && solution) {
+    if (entries.size() >= MAX_ENTRIES) {
+        entries.clear();
+    }
+    entries.insert_or_assign(key, std::move(solution));
+}
+
+
+void ResolveCache::invalidate() noexcept {
+    entries.clear();
+}
+
+std::size_t ResolveCache::get_memory_usage() const noexcept {
+    std::size_t bytes = 0;
+    for (const auto & [key, solution] : entries) {
+        bytes += sizeof(key) + key.capacity() + sizeof(solution);
+        if (solution.transaction) {
+            const auto & steps = solution.transaction->steps;
+            bytes += sizeof(::Transaction) + static_cast<std::size_t>(steps.count + steps.left) * sizeof(Id);
+        }
+        bytes += solution.reasons.size() * (sizeof(Id) + sizeof(transaction::TransactionItemReason));
+    }
+    return bytes;
+}
+
+}  // namespace libdnf5::rpm::solv
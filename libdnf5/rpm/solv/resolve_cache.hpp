@@ -0,0 +1,80 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_RPM_SOLV_RESOLVE_CACHE_HPP
+#define LIBDNF5_RPM_SOLV_RESOLVE_CACHE_HPP
+
+#include "libdnf5/transaction/transaction_item_reason.hpp"
+
+#include <solv/transaction.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+namespace libdnf5::rpm::solv {
+
+/// Cache of the solutions found by `GoalPrivate::resolve()`. A solution is stored for the key serializing all
+/// inputs of the solver (the job, the solver flags, protected and user-installed packages) together with the state
+/// of the pool. Only solutions without problems are stored. All solutions are dropped by `invalidate()`, which has
+/// to be called whenever the packages in the pool or the considered packages change.
+class ResolveCache {
+public:
+    /// Maximal number of stored solutions, the cache is cleared when it is reached.
+    static constexpr std::size_t MAX_ENTRIES = 16;
+
+    struct Solution {
+        struct TransactionDeleter {
+            void operator()(::Transaction * transaction) const noexcept { transaction_free(transaction); }
+        };
+
+        /// The libsolv transaction created by the solver
+        std::unique_ptr<::Transaction, TransactionDeleter> transaction;
+        /// Reasons of the packages in the transaction, as they were described by the solver
+        std::unordered_map<Id, transaction::TransactionItemReason> reasons;
+    };
+
+    /// Looks up the solution stored for the `key`, returns `nullptr` when there is none.
+    const Solution * lookup(const std::string & key);
+
+    /// Stores the `solution` for the `key`.
+    void store(const std::string & key, Solution && solution);
+
+    /// Drops all stored solutions.
+    void invalidate() noexcept;
+
+    /// Returns the estimated memory used by the stored solutions in bytes.
+    std::size_t get_memory_usage() const noexcept;
+
+    std::uint64_t get_hits() const noexcept { return hits; }
+    std::uint64_t get_misses() const noexcept { return misses; }
+
+private:
+    std::unordered_map<std::string, Solution> entries;
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+};
+
+}  // namespace libdnf5::rpm::solv
+
+#endif  // LIBDNF5_RPM_SOLV_RESOLVE_CACHE_HPP
@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "transaction.hpp"
 
 #include "package_set_impl.hpp"
+#include "utils/on_scope_exit.hpp"
 
 #include "libdnf5/base/transaction.hpp"
 #include "libdnf5/common/exception.hpp"
@@ -33,14 +34,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <fmt/format.h>
 #include <rpm/rpmbuild.h>
 #include <rpm/rpmdb.h>
+#include <rpm/rpmkeyring.h>
 #include <rpm/rpmlib.h>
 #include <rpm/rpmpgp.h>
 #include <rpm/rpmtag.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <thread>
 #include <type_traits>
 
 
@@ -102,6 +107,7 @@ Transaction::Transaction(const BaseWeakPtr & base) : base(base), rpm_log_guard(b
 Transaction::Transaction(Base & base) : Transaction(base.get_weak_ptr()) {}
 
 Transaction::~Transaction() {
+    free_prefetched_headers();
     rpmtsFree(ts);
     if (script_fd) {
         Fclose(script_fd);
@@ -139,7 +145,20 @@ std::string Transaction::get_db_cookie() const {
     return rpmdb_cookie;
 }
 
+std::string Transaction::get_elements_key() const {
+    std::string key;
+    auto * iter = rpmtsiInit(ts);
+    while (auto * te = rpmtsiNext(iter, static_cast<rpmElementTypes>(0))) {
+        key += rpmteType(te) == TR_ADDED ? '+' : '-';
+        key += rpmteNEVRA(te);
+        key += '\n';
+    }
+    rpmtsiFree(iter);
+    return key;
+}
+
 void Transaction::fill(const base::Transaction & transaction) {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "fill rpm transaction");
     transaction_items = transaction.get_transaction_packages();
 
     // Auxilliary map name->package with the latest versions of currently
@@ -156,6 +175,9 @@ void Transaction::fill(const base::Transaction & transaction) {
         installonly_versions.insert(std::make_pair(pkg.get_name(), pkg));
     }
 
+    prefetch_pkg_headers(base->get_config().get_header_read_threads_option().get_value());
+    utils::OnScopeExit free_headers([this]() noexcept { free_prefetched_headers(); });
+
     for (auto & tspkg : transaction_items) {
         switch (tspkg.get_action()) {
             case libdnf5::transaction::TransactionItemAction::INSTALL:
@@ -202,6 +224,11 @@ void Transaction::fill(const base::Transaction & transaction) {
     };
 }
 
+bool Transaction::check() {
+    libdnf5::base::SpanRecorder::Scope span(base->get_span_recorder(), "check rpm dependencies");
+    return rpmtsCheck(ts) == 0;
+}
+
 int Transaction::run() {
     rpmprobFilterFlags ignore_set = RPMPROB_FILTER_NONE;
     if (downgrade_requested) {
@@ -210,14 +237,46 @@ int Transaction::run() {
     if (base->get_config().get_ignorearch_option().get_value()) {
         ignore_set |= RPMPROB_FILTER_IGNOREARCH;
     }
+    timing_starts.clear();
+    timings.clear();
     rpmtsSetNotifyStyle(ts, 1);
     rpmtsSetNotifyCallback(ts, ts_callback, &callbacks_holder);
+    timing_start(libdnf5::transaction::TransactionTimingStep::TRANSACTION, nullptr, 0);
     auto rc = rpmtsRun(ts, nullptr, ignore_set);
+    timing_stop(libdnf5::transaction::TransactionTimingStep::TRANSACTION, nullptr, 0, {}, {});
     rpmtsSetNotifyCallback(ts, nullptr, nullptr);
 
     return rc;
 }
 
+void Transaction::timing_start(libdnf5::transaction::TransactionTimingStep step, const void * te, rpm_loff_t tag) {
+    timing_starts[{step, te, tag}] = std::chrono::steady_clock::now();
+}
+
+void Transaction::timing_stop(
+    libdnf5::transaction::TransactionTimingStep step,
+    const void * te,
+    rpm_loff_t tag,
+    std::string nevra,
+    std::string scriptlet) {
+    auto it = timing_starts.find({step, te, tag});
+    if (it == timing_starts.end()) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - it->second);
+    auto & span_recorder = base->get_span_recorder();
+    if (span_recorder.is_enabled()) {
+        span_recorder.add(
+            "rpm " + libdnf5::transaction::transaction_timing_step_to_string(step),
+            scriptlet.empty() ? nevra : nevra + " " + scriptlet,
+            it->second,
+            end);
+    }
+    timing_starts.erase(it);
+    timings.emplace_back(step, std::move(nevra), std::move(scriptlet), duration.count());
+}
+
 void Transaction::set_script_out_fd(int fd) {
     FD_t script_fd;
 
@@ -261,6 +320,10 @@ BaseWeakPtr Transaction::get_base() const {
 }
 
 Header Transaction::read_pkg_header(const std::string & file_path) const {
+    return read_pkg_header(ts, file_path);
+}
+
+Header Transaction::read_pkg_header(rpmts ts, const std::string & file_path) {
     FD_t fd = Fopen(file_path.c_str(), "r.ufdio");
 
     if (!fd) {
@@ -289,6 +352,95 @@ Header Transaction::read_pkg_header(const std::string & file_path) const {
     return h;
 }
 
+void Transaction::prefetch_pkg_headers(std::size_t max_workers) {
+    if (max_workers <= 1) {
+        return;
+    }
+
+    std::vector<const TransactionItem *> items;
+    for (const auto & tspkg : transaction_items) {
+        switch (tspkg.get_action()) {
+            case libdnf5::transaction::TransactionItemAction::INSTALL:
+            case libdnf5::transaction::TransactionItemAction::UPGRADE:
+            case libdnf5::transaction::TransactionItemAction::DOWNGRADE:
+            case libdnf5::transaction::TransactionItemAction::REINSTALL:
+                items.push_back(&tspkg);
+                break;
+            default:
+                break;
+        }
+    }
+    if (items.size() <= 1) {
+        return;
+    }
+
+    // The package paths are obtained in this thread, the workers do not access the package pool
+    std::vector<std::string> paths;
+    paths.reserve(items.size());
+    for (const auto * item : items) {
+        paths.push_back(item->get_package().get_package_path());
+    }
+    std::vector<PrefetchedHeader> headers(items.size());
+
+    // The keyring is loaded once here and shared by the transaction sets of the workers
+    std::unique_ptr<rpmKeyring_s, decltype(&rpmKeyringFree)> keyring(rpmtsGetKeyring(ts, 1), &rpmKeyringFree);
+    const auto vsflags = rpmtsVSFlags(ts);
+    const auto vfyflags = rpmtsVfyFlags(ts);
+    const auto vfylevel = rpmtsVfyLevel(ts);
+
+    std::atomic<std::size_t> next_idx{0};
+    auto worker = [&]() noexcept {
+        std::unique_ptr<rpmts_s, decltype(&rpmtsFree)> worker_ts(rpmtsCreate(), &rpmtsFree);
+        rpmtsSetKeyring(worker_ts.get(), keyring.get());
+        rpmtsSetVSFlags(worker_ts.get(), vsflags);
+        rpmtsSetVfyFlags(worker_ts.get(), vfyflags);
+        rpmtsSetVfyLevel(worker_ts.get(), vfylevel);
+        for (auto idx = next_idx++; idx < paths.size(); idx = next_idx++) {
+            try {
+                headers[idx].header = read_pkg_header(worker_ts.get(), paths[idx]);
+            } catch (...) {
+                headers[idx].error = std::current_exception();
+            }
+        }
+    };
+
+    const auto num_workers = std::min(items.size(), max_workers);
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto & thread : workers) {
+        thread.join();
+    }
+
+    for (std::size_t idx = 0; idx < items.size(); ++idx) {
+        prefetched_headers.emplace(items[idx], std::move(headers[idx]));
+    }
+}
+
+Header Transaction::take_pkg_header(const TransactionItem & item) {
+    auto it = prefetched_headers.find(&item);
+    if (it == prefetched_headers.end()) {
+        return read_pkg_header(item.get_package().get_package_path());
+    }
+    auto prefetched = std::move(it->second);
+    prefetched_headers.erase(it);
+    if (prefetched.error) {
+        std::rethrow_exception(prefetched.error);
+    }
+    return prefetched.header;
+}
+
+void Transaction::free_prefetched_headers() noexcept {
+    for (auto & [item, prefetched] : prefetched_headers) {
+        if (prefetched.header) {
+            headerFree(prefetched.header);
+        }
+    }
+    prefetched_headers.clear();
+}
+
 Header Transaction::get_header(unsigned int rec_offset) {
     Header hdr = nullptr;
 
@@ -307,8 +459,7 @@ Header Transaction::get_header(unsigned int rec_offset) {
 }
 
 void Transaction::reinstall(TransactionItem & item) {
-    auto file_path = item.get_package().get_package_path();
-    auto * header = read_pkg_header(file_path);
+    auto * header = take_pkg_header(item);
     last_added_item = &item;
     last_item_added_ts_element = false;
     auto rc = rpmtsAddReinstallElement(ts, header, &item);
@@ -361,8 +512,7 @@ void Transaction::install_up_down(TransactionItem & item, libdnf5::transaction::
     } else {
         libdnf_throw_assertion("Unsupported action: {}", utils::to_underlying(action));
     }
-    auto file_path = item.get_package().get_package_path();
-    auto * header = read_pkg_header(file_path);
+    auto * header = take_pkg_header(item);
     last_added_item = &item;
     last_item_added_ts_element = false;
     auto rc = rpmtsAddInstallElement(ts, header, &item, upgrade ? 1 : 0, nullptr);
@@ -523,6 +673,7 @@ void * Transaction::ts_callback(
         case RPMCALLBACK_INST_START:
             // Install? Maybe upgrade/downgrade/...obsolete?
             libdnf_assert_transaction_item_set();
+            transaction.timing_start(libdnf5::transaction::TransactionTimingStep::INSTALL, te, 0);
             logger.info(
                 "RPM callback install start \"{}\" total {}",
                 to_full_nevra_string(trans_element_to_nevra(trans_element)),
@@ -555,12 +706,14 @@ void * Transaction::ts_callback(
             }
             break;
         case RPMCALLBACK_TRANS_START:
+            transaction.timing_start(libdnf5::transaction::TransactionTimingStep::PREPARE, nullptr, 0);
             logger.info("RPM callback transaction start, total {}", total);
             if (callbacks) {
                 callbacks->transaction_start(total);
             }
             break;
         case RPMCALLBACK_TRANS_STOP:
+            transaction.timing_stop(libdnf5::transaction::TransactionTimingStep::PREPARE, nullptr, 0, {}, {});
             logger.info("RPM callback transaction stop, total {}", total);
             if (callbacks) {
                 callbacks->transaction_stop(total);
@@ -574,6 +727,7 @@ void * Transaction::ts_callback(
             break;
         case RPMCALLBACK_UNINST_START:
             libdnf_assert_transaction_item_set();
+            transaction.timing_start(libdnf5::transaction::TransactionTimingStep::ERASE, te, 0);
             logger.info(
                 "RPM callback uninstall start \"{}\" total {}",
                 to_full_nevra_string(trans_element_to_nevra(trans_element)),
@@ -584,6 +738,12 @@ void * Transaction::ts_callback(
             break;
         case RPMCALLBACK_UNINST_STOP:
             libdnf_assert_transaction_item_set();
+            transaction.timing_stop(
+                libdnf5::transaction::TransactionTimingStep::ERASE,
+                te,
+                0,
+                to_full_nevra_string(trans_element_to_nevra(trans_element)),
+                {});
             logger.info(
                 "RPM callback uninstall stop \"{}\" amount {} total {}",
                 to_full_nevra_string(trans_element_to_nevra(trans_element)),
@@ -638,6 +798,7 @@ void * Transaction::ts_callback(
             // amount is script tag
             auto script_type = rpm_tag_to_script_type(static_cast<rpmTag_e>(amount));
             auto nevra = trans_element_to_nevra(trans_element);
+            transaction.timing_start(libdnf5::transaction::TransactionTimingStep::SCRIPTLET, te, amount);
             logger.info(
                 "RPM callback start {} scriptlet \"{}\"",
                 TransactionCallbacks::script_type_to_string(script_type),
@@ -652,6 +813,12 @@ void * Transaction::ts_callback(
             // total is return code - if (error && !RPMSCRIPT_FLAG_CRITICAL) return_code = RPMRC_NOTFOUND
             auto script_type = rpm_tag_to_script_type(static_cast<rpmTag_e>(amount));
             auto nevra = trans_element_to_nevra(trans_element);
+            transaction.timing_stop(
+                libdnf5::transaction::TransactionTimingStep::SCRIPTLET,
+                te,
+                amount,
+                to_full_nevra_string(nevra),
+                TransactionCallbacks::script_type_to_string(script_type));
             logger.info(
                 "RPM callback stop {} scriptlet \"{}\" return code {}",
                 TransactionCallbacks::script_type_to_string(script_type),
@@ -664,6 +831,12 @@ void * Transaction::ts_callback(
         }
         case RPMCALLBACK_INST_STOP:
             libdnf_assert_transaction_item_set();
+            transaction.timing_stop(
+                libdnf5::transaction::TransactionTimingStep::INSTALL,
+                te,
+                0,
+                to_full_nevra_string(trans_element_to_nevra(trans_element)),
+                {});
             logger.info(
                 "RPM callback install stop \"{}\" amount {} total {}",
                 to_full_nevra_string(trans_element_to_nevra(trans_element)),
@@ -685,12 +858,14 @@ void * Transaction::ts_callback(
             }
             break;
         case RPMCALLBACK_VERIFY_START:
+            transaction.timing_start(libdnf5::transaction::TransactionTimingStep::VERIFY, nullptr, 0);
             logger.info("RPM callback verify start, total {}", total);
             if (callbacks) {
                 callbacks->verify_start(total);
             }
             break;
         case RPMCALLBACK_VERIFY_STOP:
+            transaction.timing_stop(libdnf5::transaction::TransactionTimingStep::VERIFY, nullptr, 0, {}, {});
             logger.info("RPM callback verify stop, total {}", total);
             if (callbacks) {
                 callbacks->verify_stop(total);
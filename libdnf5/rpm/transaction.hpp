@@ -28,13 +28,19 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/common/exception.hpp"
 #include "libdnf5/rpm/package.hpp"
 #include "libdnf5/rpm/transaction_callbacks.hpp"
+#include "libdnf5/transaction/transaction_timing.hpp"
 
 #include <rpm/header.h>
 #include <rpm/rpmprob.h>
 #include <rpm/rpmps.h>
 #include <rpm/rpmts.h>
 
+#include <chrono>
+#include <exception>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <unordered_map>
 
 // Required for building with fmt >= 10
 // See: https://github.com/fmtlib/fmt/blob/10.0.0/ChangeLog.rst?plain=1#L68
@@ -271,6 +277,11 @@ public:
     /// @return rpm database cookie
     std::string get_db_cookie() const;
 
+    /// Describes the elements of the filled transaction set, including the ones added by librpm itself.
+    /// Two transaction sets with an equal key install and erase the same packages.
+    /// @return  one line with the element type and NEVRA per element
+    std::string get_elements_key() const;
+
     /// Get transaction id, i.e. transaction time stamp.
     /// @return  transaction id
     rpm_tid_t get_id() const { return rpmtsGetTid(ts); }
@@ -290,7 +301,7 @@ public:
     /// a dependency check can be performed to make sure that all package dependencies are satisfied.
     /// Any found problems can be examined by retrieving the problem set with rpmtsProblems().
     /// @return  true on dependencies are ok
-    bool check() { return rpmtsCheck(ts) == 0; }
+    bool check();
 
     /// Process all package elements in a transaction set.
     /// Before calling run() be sure to have:
@@ -323,6 +334,10 @@ public:
     /// @since 5.0
     BaseWeakPtr get_base() const;
 
+    /// Get the wall times of the steps of the last run(): the whole run, its preparation, the verification,
+    /// the install and erase of every package and every scriptlet.
+    const std::vector<libdnf5::transaction::TransactionTiming> & get_timings() const noexcept { return timings; }
+
 private:
     struct CallbacksHolder {
         std::unique_ptr<TransactionCallbacks> callbacks;
@@ -344,6 +359,29 @@ private:
 
     RpmLogGuard rpm_log_guard;
 
+    /// Header of an inbound package read ahead by `prefetch_pkg_headers()`, or the error of reading it
+    struct PrefetchedHeader {
+        Header header{nullptr};
+        std::exception_ptr error;
+    };
+    std::unordered_map<const TransactionItem *, PrefetchedHeader> prefetched_headers;
+
+    /// Step measured by ts_callback(), the transaction element and the scriptlet tag
+    using TimingKey = std::tuple<libdnf5::transaction::TransactionTimingStep, const void *, rpm_loff_t>;
+    /// Start times of the running steps
+    std::map<TimingKey, std::chrono::steady_clock::time_point> timing_starts;
+    std::vector<libdnf5::transaction::TransactionTiming> timings;
+
+    /// Record the start of the `step` of the transaction element `te`, `tag` distinguishes scriptlets
+    void timing_start(libdnf5::transaction::TransactionTimingStep step, const void * te, rpm_loff_t tag);
+
+    /// Record the wall time of the `step` started by timing_start(), a step without a recorded start is ignored
+    void timing_stop(
+        libdnf5::transaction::TransactionTimingStep step,
+        const void * te,
+        rpm_loff_t tag,
+        std::string nevra,
+        std::string scriptlet);
 
     /// Return header from package.
     /// @param path  file path
@@ -351,6 +389,21 @@ private:
     /// @return  package header
     Header read_pkg_header(const std::string & file_path) const;
 
+    /// Return header from package read using the transaction set `ts`.
+    static Header read_pkg_header(rpmts ts, const std::string & file_path);
+
+    /// Reads the headers of the inbound packages of `transaction_items` in up to `max_workers` threads. Every thread
+    /// reads the files using its own transaction set with the signature verification settings and the keyring
+    /// of `ts`.
+    void prefetch_pkg_headers(std::size_t max_workers);
+
+    /// Return the header of the package of the inbound `item`, the prefetched one if available.
+    /// The errors of the prefetch are thrown here, so they are reported in the order of the items.
+    Header take_pkg_header(const TransactionItem & item);
+
+    /// Frees the prefetched headers that were not taken
+    void free_prefetched_headers() noexcept;
+
     /// Get header of package at offset in the rpmdbi database
     Header get_header(unsigned int rec_offset);
 
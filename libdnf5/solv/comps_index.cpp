@@ -0,0 +1,181 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "comps_index.hpp"
+
+#include "pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string_view>
+#include <utility>
+
+
+namespace libdnf5::solv {
+
+namespace {
+
+using Definitions = std::map<std::string, std::vector<std::pair<std::string_view, Id>>>;
+
+/// Appends the entry composed of `solvable_ids` to `entries` and registers its position under `id` and its name
+void add_entry(
+    ::Pool * pool,
+    std::vector<CompsIndex::Entry> & entries,
+    std::unordered_map<std::string, std::vector<std::size_t>> & by_id,
+    std::unordered_map<std::string, std::vector<std::size_t>> & by_name,
+    const std::string & id,
+    std::vector<Id> && solvable_ids) {
+    auto position = entries.size();
+    by_id[id].push_back(position);
+    // The same name as returned by `Group::get_name()`, the first one found in the definitions
+    for (auto solvable_id : solvable_ids) {
+        if (auto name = pool_lookup_str(pool, solvable_id, SOLVABLE_SUMMARY)) {
+            by_name[name].push_back(position);
+            break;
+        }
+    }
+    entries.push_back({std::move(solvable_ids)});
+}
+
+/// Returns the solvable ids of the available definitions sorted by repoid in descending order
+std::vector<Id> sorted_solvable_ids(std::vector<std::pair<std::string_view, Id>> & definitions) {
+    std::sort(definitions.begin(), definitions.end(), std::greater<>());
+    std::vector<Id> solvable_ids;
+    solvable_ids.reserve(definitions.size());
+    for (const auto & [repoid, solvable_id] : definitions) {
+        solvable_ids.push_back(solvable_id);
+    }
+    return solvable_ids;
+}
+
+}  // namespace
+
+
+void CompsIndex::update(::Pool * pool) {
+    std::vector<RepoStamp> stamps;
+    stamps.reserve(static_cast<std::size_t>(pool->nrepos));
+    int repo_id;
+    ::Repo * repo;
+    FOR_REPOS(repo_id, repo) {
+        stamps.push_back({repo, repo->disabled != 0, repo->nsolvables, repo->nrepodata, repo->start, repo->end});
+    }
+    if (initialized && nsolvables == pool->nsolvables && stamps == repo_stamps) {
+        return;
+    }
+
+    repo_stamps = std::move(stamps);
+    nsolvables = pool->nsolvables;
+    rebuild(pool);
+    initialized = true;
+}
+
+
+void CompsIndex::rebuild(::Pool * pool) {
+    groups.clear();
+    environments.clear();
+    groups_by_id.clear();
+    groups_by_name.clear();
+    environments_by_id.clear();
+    environments_by_name.clear();
+    group_packages.clear();
+
+    // For each id the (repoid, solvable_id) pairs of its definitions in the available repositories
+    Definitions available_groups;
+    Definitions available_environments;
+
+    Id solvable_id;
+    FOR_POOL_SOLVABLES(solvable_id) {
+        Solvable * solvable = pool_id2solvable(pool, solvable_id);
+
+        // Do not include solvables from disabled repositories
+        if (solvable->repo->disabled) {
+            continue;
+        }
+        // SOLVABLE_NAME is in a form "type:id"
+        const char * solvable_name = pool_lookup_str(pool, solvable_id, SOLVABLE_NAME);
+        if (!solvable_name) {
+            continue;
+        }
+        auto [type, id] = CompsPool::split_solvable_name(solvable_name);
+        bool is_group = type == "group";
+        if (!is_group && type != "environment") {
+            continue;
+        }
+
+        std::string_view repoid = solvable->repo->name;
+        if (repoid == "@System") {
+            // There is only one installed definition for each id
+            if (is_group) {
+                add_entry(pool, groups, groups_by_id, groups_by_name, id, {solvable_id});
+            } else {
+                add_entry(pool, environments, environments_by_id, environments_by_name, id, {solvable_id});
+            }
+        } else {
+            auto & definitions = is_group ? available_groups : available_environments;
+            definitions[std::move(id)].emplace_back(repoid, solvable_id);
+        }
+    }
+
+    for (auto & [id, definitions] : available_groups) {
+        add_entry(pool, groups, groups_by_id, groups_by_name, id, sorted_solvable_ids(definitions));
+    }
+    for (auto & [id, definitions] : available_environments) {
+        add_entry(pool, environments, environments_by_id, environments_by_name, id, sorted_solvable_ids(definitions));
+    }
+}
+
+
+const std::vector<std::size_t> * CompsIndex::find(const PositionsMap & map, const std::string & key) {
+    auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+}
+
+
+const std::vector<std::size_t> * CompsIndex::find_groups_by_id(const std::string & groupid) const {
+    return find(groups_by_id, groupid);
+}
+
+
+const std::vector<std::size_t> * CompsIndex::find_groups_by_name(const std::string & name) const {
+    return find(groups_by_name, name);
+}
+
+
+const std::vector<std::size_t> * CompsIndex::find_environments_by_id(const std::string & environmentid) const {
+    return find(environments_by_id, environmentid);
+}
+
+
+const std::vector<std::size_t> * CompsIndex::find_environments_by_name(const std::string & name) const {
+    return find(environments_by_name, name);
+}
+
+
+const std::vector<comps::Package> * CompsIndex::lookup_group_packages(Id solvable_id) const {
+    auto it = group_packages.find(solvable_id);
+    return it == group_packages.end() ? nullptr : &it->second;
+}
+
+
+void CompsIndex::store_group_packages(Id solvable_id, const std::vector<comps::Package> & packages) {
+    group_packages.insert_or_assign(solvable_id, packages);
+}
+
+}  // namespace libdnf5::solv
@@ -0,0 +1,116 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_COMPS_INDEX_HPP
+#define LIBDNF5_SOLV_COMPS_INDEX_HPP
+
+#include "libdnf5/comps/group/package.hpp"
+
+extern "C" {
+#include <solv/pool.h>
+}
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Index of the groups and environments composed from the solvables of the comps pool. The queries and the goal
+/// look the groups up by their id or name instead of composing and comparing all of them each time.
+///
+/// The index is rebuilt by `update()` whenever the comps solvables or the enabled repositories change, which also
+/// drops the cached package lists of the groups.
+///
+/// The index is not thread-safe.
+class CompsIndex {
+public:
+    /// A group or an environment composed of its definitions in the repositories
+    struct Entry {
+        /// The solvable ids of the definitions, an installed entry has just one, the available definitions are
+        /// sorted by repoid in descending order
+        std::vector<Id> solvable_ids;
+    };
+
+    /// Rebuilds the index if the solvables of the `pool` or the enabled repositories changed since the last call.
+    void update(::Pool * pool);
+
+    /// Returns the installed and available groups of the enabled repositories.
+    const std::vector<Entry> & get_groups() const noexcept { return groups; }
+
+    /// Returns the installed and available environments of the enabled repositories.
+    const std::vector<Entry> & get_environments() const noexcept { return environments; }
+
+    /// Returns the positions in `get_groups()` of the groups with `groupid`, or `nullptr` if there is none.
+    const std::vector<std::size_t> * find_groups_by_id(const std::string & groupid) const;
+
+    /// Returns the positions in `get_groups()` of the groups with untranslated `name`, or `nullptr` if there is none.
+    const std::vector<std::size_t> * find_groups_by_name(const std::string & name) const;
+
+    /// Returns the positions in `get_environments()` of the environments with `environmentid`, or `nullptr` if there
+    /// is none.
+    const std::vector<std::size_t> * find_environments_by_id(const std::string & environmentid) const;
+
+    /// Returns the positions in `get_environments()` of the environments with untranslated `name`, or `nullptr`
+    /// if there is none.
+    const std::vector<std::size_t> * find_environments_by_name(const std::string & name) const;
+
+    /// Returns the cached packages of the group solvable `solvable_id` or `nullptr` if they are not cached.
+    const std::vector<comps::Package> * lookup_group_packages(Id solvable_id) const;
+
+    /// Stores the packages of the group solvable `solvable_id`.
+    void store_group_packages(Id solvable_id, const std::vector<comps::Package> & packages);
+
+private:
+    /// The state of a repository the index was built from
+    struct RepoStamp {
+        const ::Repo * repo;
+        bool disabled;
+        int nsolvables;
+        int nrepodata;
+        Id start;
+        Id end;
+
+        bool operator==(const RepoStamp & other) const noexcept = default;
+    };
+
+    using PositionsMap = std::unordered_map<std::string, std::vector<std::size_t>>;
+
+    static const std::vector<std::size_t> * find(const PositionsMap & map, const std::string & key);
+
+    void rebuild(::Pool * pool);
+
+    bool initialized{false};
+    int nsolvables{0};
+    std::vector<RepoStamp> repo_stamps;
+
+    std::vector<Entry> groups;
+    std::vector<Entry> environments;
+    PositionsMap groups_by_id;
+    PositionsMap groups_by_name;
+    PositionsMap environments_by_id;
+    PositionsMap environments_by_name;
+    std::unordered_map<Id, std::vector<comps::Package>> group_packages;
+};
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_COMPS_INDEX_HPP
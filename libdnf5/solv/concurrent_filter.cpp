@@ -0,0 +1,45 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "concurrent_filter.hpp"
+
+extern "C" {
+#include <solv/repo.h>
+#include <solv/repodata.h>
+}
+
+
+namespace libdnf5::solv {
+
+void prepare_concurrent_lookup(::Pool * pool, Id keyname) {
+    Repo * repo;
+    Id repo_id;
+    FOR_REPOS(repo_id, repo) {
+        Repodata * data;
+        Id data_id;
+        FOR_REPODATAS(repo, data_id, data) {
+            if (repodata_has_keyname(data, keyname)) {
+                // Loads the stub and reads all pages of the repodata
+                repodata_disable_paging(data);
+            }
+        }
+    }
+}
+
+}  // namespace libdnf5::solv
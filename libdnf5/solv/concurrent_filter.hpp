@@ -0,0 +1,129 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_CONCURRENT_FILTER_HPP
+#define LIBDNF5_SOLV_CONCURRENT_FILTER_HPP
+
+#include "solv_map.hpp"
+#include "utils/on_scope_exit.hpp"
+
+#include "libdnf5/common/exception.hpp"
+
+#include <solv/pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+// Thread-safety contract of the concurrent read-only access to the libsolv pool
+//
+// libsolv is not thread-safe, but reading a pool that is not modified can be done from several threads when:
+// - Nothing modifies the pool while the workers run. No strings or reldeps are created (`pool_str2id()` and
+//   `pool_rel2id()` are only called with `create == 0`), no repositories or solvables are added or removed and the
+//   whatprovides index is not recreated (`make_provides_ready()` has to be called before the workers start).
+// - The pool temporary space (`pool_alloctmpspace()`) is not used, it is a ring buffer shared by all threads.
+//   It rules out the EVR splitting getters of `libdnf5::solv::Pool`, `get_nevra()` and the data iterators
+//   composing full file names (`SEARCH_FILES` on `SOLVABLE_FILELIST`).
+// - The repodata storing the searched key are loaded in memory. Stubs are loaded on demand and paged repodata read
+//   their pages while they are accessed, `prepare_concurrent_lookup()` has to be called for the key before.
+// - Each worker uses its own `Dataiterator`, `Queue` and other libsolv iteration state.
+// - A `SolvMap` shared by the workers is only read by `contains()`, `size()`, `empty()` and the iterators.
+//   `SolvMap::get_map()` converts a small set to the bitmap in place, it has to be called before the workers start.
+
+namespace libdnf5::solv {
+
+/// Minimal number of Ids in the range of candidates for which a filter is evaluated concurrently
+constexpr std::size_t CONCURRENT_FILTER_MIN_IDS = 4096;
+
+/// Number of Ids in one chunk of candidates. It is a multiple of 64, chunks are aligned to 64-bit words of the map.
+constexpr std::size_t CONCURRENT_FILTER_CHUNK_IDS = 1024;
+
+/// Loads in memory all repodata of the `pool` that store the `keyname` attribute, so that they can be read by
+/// several threads at once. The stubs are loaded and the paging is disabled.
+void prepare_concurrent_lookup(::Pool * pool, Id keyname);
+
+/// Adds to `filter_result` the `candidates` for which `match(candidate_id)` returns true.
+/// The candidates are split into chunks evaluated by up to `max_workers` threads (including the calling thread),
+/// the evaluation has to follow the thread-safety contract above. Every worker uses its own copy of `match`,
+/// which can therefore hold per-worker state. A chunk sets only its own bytes of `filter_result`, so the workers
+/// write into it without locking. `match` must not throw.
+template <typename Match>
+void filter_concurrently(
+    const SolvMap & candidates, SolvMap & filter_result, std::size_t max_workers, const Match & match) {
+    // `get_map()` converts small sets to the bitmap, the workers then only read and set its bits. The bitmap
+    // of `filter_result` is not shared, the workers can't copy it on write. Both maps are converted here,
+    // before the workers start, the conversion is not safe to run from several threads.
+    const auto & candidates_map = candidates.get_map();
+    const auto map_bytes =
+        static_cast<std::size_t>(std::min(candidates_map.size, filter_result.get_writable_map().size));
+    libdnf_assert(
+        !candidates.is_sparse() && !filter_result.is_sparse(), "The maps must be converted before the workers start");
+
+    auto filter_chunk = [&candidates_map, &filter_result](Match & chunk_match, std::size_t begin, std::size_t end) {
+        for (auto byte_idx = begin; byte_idx < end; ++byte_idx) {
+            unsigned int byte = candidates_map.map[byte_idx];
+            for (Id candidate_id = static_cast<Id>(byte_idx * 8); byte != 0; byte >>= 1, ++candidate_id) {
+                if ((byte & 1) != 0 && chunk_match(candidate_id)) {
+                    filter_result.add_unsafe(candidate_id);
+                }
+            }
+        }
+    };
+
+    if (max_workers <= 1 || map_bytes * 8 < CONCURRENT_FILTER_MIN_IDS) {
+        Match worker_match(match);
+        filter_chunk(worker_match, 0, map_bytes);
+        return;
+    }
+
+    constexpr std::size_t chunk_bytes = CONCURRENT_FILTER_CHUNK_IDS / 8;
+    const auto num_chunks = (map_bytes + chunk_bytes - 1) / chunk_bytes;
+    std::atomic<std::size_t> next_chunk{0};
+
+    auto worker = [&]() noexcept {
+        Match worker_match(match);
+        for (auto chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+            auto begin = chunk * chunk_bytes;
+            filter_chunk(worker_match, begin, std::min(begin + chunk_bytes, map_bytes));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    // The workers must not outlive the local variables they reference, even if starting a thread fails.
+    utils::OnScopeExit join_workers([&]() noexcept {
+        for (auto & thread : workers) {
+            thread.join();
+        }
+    });
+
+    const auto num_workers = std::min(max_workers, num_chunks);
+    workers.reserve(num_workers - 1);
+    for (std::size_t idx = 1; idx < num_workers; ++idx) {
+        workers.emplace_back(worker);
+    }
+    // The calling thread is one of the workers
+    worker();
+}
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_CONCURRENT_FILTER_HPP
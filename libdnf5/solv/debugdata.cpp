@@ -0,0 +1,208 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "debugdata.hpp"
+
+#include "id_queue.hpp"
+#include "utils/fs/file.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <fmt/format.h>
+
+extern "C" {
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/solv_xfopen.h>
+#include <solv/solvable.h>
+#include <solv/testcase.h>
+}
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+namespace {
+
+constexpr const char * TESTCASE_FILE_NAME = "testcase.t";
+constexpr std::string_view TESTCASE_DISABLE_PKG = "disable pkg ";
+constexpr std::string_view TESTCASE_REPO = "repo ";
+constexpr std::string_view TESTTAGS_PKG = "=Pkg: ";
+
+/// Returns the `=Pkg:` line that starts the record of the `solvable` written by `testcase_write_testtags()`
+std::string get_testtags_pkg_line(::Pool * pool, Solvable * solvable) {
+    std::string_view evr = pool_id2str(pool, solvable->evr);
+    auto release_pos = evr.rfind('-');
+    auto version = evr.substr(0, release_pos == std::string_view::npos ? evr.size() : release_pos);
+    std::string_view release =
+        release_pos != std::string_view::npos && release_pos + 1 < evr.size() ? evr.substr(release_pos + 1) : "-";
+    const char * arch = solvable->arch ? pool_id2str(pool, solvable->arch) : "-";
+    return fmt::format("{}{} {} {} {}", TESTTAGS_PKG, pool_id2str(pool, solvable->name), version, release, arch);
+}
+
+/// Returns the path of the temporary file replacing `file_name` in `dir`, the suffix selecting the compression
+/// of the file is kept
+std::filesystem::path get_new_file_path(const std::filesystem::path & dir, std::string_view file_name) {
+    return dir / fmt::format("new-{}", file_name);
+}
+
+/// Returns the name of the repository file with the `.gz` suffix replaced by `.zst`
+std::string get_zstd_file_name(std::string_view file_name) {
+    if (file_name.ends_with(".gz")) {
+        file_name.remove_suffix(3);
+    }
+    return fmt::format("{}.zst", file_name);
+}
+
+/// Copies the repository `src` in the testtags format to `dest`, only the records of the packages with
+/// the `=Pkg:` line in `kept_pkg_lines` are copied when it is set
+void copy_testtags(
+    const std::filesystem::path & src,
+    const std::filesystem::path & dest,
+    const std::unordered_set<std::string> * kept_pkg_lines) {
+    utils::fs::File input(src, "r", true);
+    utils::fs::File output(dest, "w", true);
+    // The lines before the first record are the header of the file
+    bool keep_record = true;
+    std::string line;
+    while (input.read_line(line)) {
+        if (kept_pkg_lines && line.starts_with(TESTTAGS_PKG)) {
+            keep_record = kept_pkg_lines->contains(line);
+        }
+        if (keep_record) {
+            line.push_back('\n');
+            output.write(line);
+        }
+    }
+    output.close();
+}
+
+}  // namespace
+
+SolvMap compute_job_closure(::Solver * solver) {
+    ::Pool * pool = solver->pool;
+    SolvMap closure(pool->nsolvables);
+    std::vector<Id> pending;
+    auto add = [&closure, &pending](Id id) {
+        if (!closure.contains_unsafe(id)) {
+            closure.add_unsafe(id);
+            pending.push_back(id);
+        }
+    };
+
+    if (pool->installed) {
+        Id id;
+        Solvable * solvable;
+        FOR_REPO_SOLVABLES(pool->installed, id, solvable) {
+            add(id);
+        }
+    }
+
+    IdQueue job_solvables;
+    for (int i = 0; i + 1 < solver->job.count; i += 2) {
+        ::pool_job2solvables(pool, &job_solvables.get_queue(), solver->job.elements[i], solver->job.elements[i + 1]);
+        for (auto id : job_solvables) {
+            add(id);
+        }
+    }
+
+    IdQueue deps;
+    while (!pending.empty()) {
+        Solvable * solvable = pool_id2solvable(pool, pending.back());
+        pending.pop_back();
+        Id p;
+        Id pp;
+        FOR_PROVIDES(p, pp, solvable->name) {
+            if (pool->solvables[p].name == solvable->name) {
+                add(p);
+            }
+        }
+        for (Id keyname : {SOLVABLE_REQUIRES, SOLVABLE_RECOMMENDS}) {
+            ::solvable_lookup_deparray(solvable, keyname, &deps.get_queue(), 0);
+            for (auto dep : deps) {
+                if (dep == SOLVABLE_PREREQMARKER) {
+                    continue;
+                }
+                FOR_PROVIDES(p, pp, dep) {
+                    add(p);
+                }
+            }
+        }
+    }
+    return closure;
+}
+
+void rewrite_testcase(
+    ::Pool * pool, const std::filesystem::path & debug_dir, const SolvMap * kept_packages, bool zstd) {
+    if (zstd && ::solv_xfopen_iscompressed("testcase.zst") != 1) {
+        throw RuntimeError(M_("Cannot write zstd compressed solver debug data, libsolv does not support zstd"));
+    }
+
+    std::unordered_set<std::string> kept_pkg_lines;
+    std::unordered_set<std::string> kept_solvable_strs;
+    if (kept_packages) {
+        for (auto id : *kept_packages) {
+            Solvable * solvable = pool_id2solvable(pool, id);
+            if (!solvable->repo) {
+                continue;
+            }
+            kept_pkg_lines.insert(get_testtags_pkg_line(pool, solvable));
+            kept_solvable_strs.insert(::testcase_solvid2str(pool, id));
+        }
+    }
+
+    auto testcase_path = debug_dir / TESTCASE_FILE_NAME;
+    auto new_testcase_path = get_new_file_path(debug_dir, TESTCASE_FILE_NAME);
+    {
+        utils::fs::File input(testcase_path, "r");
+        utils::fs::File output(new_testcase_path, "w");
+        std::string line;
+        while (input.read_line(line)) {
+            if (kept_packages && line.starts_with(TESTCASE_DISABLE_PKG) &&
+                !kept_solvable_strs.contains(line.substr(TESTCASE_DISABLE_PKG.size()))) {
+                continue;
+            }
+            if (line.starts_with(TESTCASE_REPO)) {
+                // repo <name> <priority> <subpriority> testtags <file>
+                auto file_pos = line.rfind(' ') + 1;
+                auto file_name = line.substr(file_pos);
+                auto src = debug_dir / file_name;
+                if (zstd) {
+                    file_name = get_zstd_file_name(file_name);
+                    line.replace(file_pos, std::string::npos, file_name);
+                }
+                auto dest = get_new_file_path(debug_dir, file_name);
+                copy_testtags(src, dest, kept_packages ? &kept_pkg_lines : nullptr);
+                std::filesystem::remove(src);
+                std::filesystem::rename(dest, debug_dir / file_name);
+            }
+            line.push_back('\n');
+            output.write(line);
+        }
+        output.close();
+    }
+    std::filesystem::rename(new_testcase_path, testcase_path);
+}
+
+}  // namespace libdnf5::solv
@@ -0,0 +1,57 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_DEBUGDATA_HPP
+#define LIBDNF5_SOLV_DEBUGDATA_HPP
+
+#include "solv_map.hpp"
+
+#include <filesystem>
+
+extern "C" {
+#include <solv/solver.h>
+}
+
+
+namespace libdnf5::solv {
+
+/// Options of the solver debug data
+struct DebugdataOptions {
+    /// Store the repositories compressed by zstd instead of gzip
+    bool zstd{false};
+    /// Store only the installed packages and the packages reachable from the job of the solver
+    bool only_job_closure{false};
+};
+
+/// Returns the installed packages and the packages reachable from the job of the `solver`. The packages are reached
+/// through the providers of requires and recommends and through other versions of the reached package names.
+/// Packages pulled in only by their supplements are not reached, a testcase limited to the closure can resolve
+/// differently in such cases.
+SolvMap compute_job_closure(::Solver * solver);
+
+/// Rewrites the testcase written by libsolv `testcase_write()` into `debug_dir`. When `kept_packages` is set,
+/// the records of other packages are dropped from the repositories and from the `disable` lines of the testcase.
+/// When `zstd` is set, the repositories are recompressed by zstd and the testcase refers to the new files.
+/// The repositories are streamed line by line, they are never loaded in memory.
+void rewrite_testcase(
+    ::Pool * pool, const std::filesystem::path & debug_dir, const SolvMap * kept_packages, bool zstd);
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_DEBUGDATA_HPP
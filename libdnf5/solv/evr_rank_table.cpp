@@ -0,0 +1,138 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "evr_rank_table.hpp"
+
+extern "C" {
+#include <solv/evr.h>
+}
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+
+namespace libdnf5::solv {
+
+void EvrRankTable::update() {
+    nsolvables = pool->nsolvables;
+
+    std::vector<Id> evrs;
+    for (Id id = 2; id < pool->nsolvables; ++id) {
+        const Solvable * solvable = pool->solvables + id;
+        if (solvable->repo != nullptr && solvable->evr > 0) {
+            evrs.push_back(solvable->evr);
+        }
+    }
+    std::sort(evrs.begin(), evrs.end());
+    evrs.erase(std::unique(evrs.begin(), evrs.end()), evrs.end());
+
+    // pairs of <key, EVR Id>
+    std::vector<std::pair<std::string, Id>> items;
+    items.reserve(evrs.size());
+    for (Id evr : evrs) {
+        items.emplace_back(get_key(evr), evr);
+    }
+    std::sort(items.begin(), items.end(), [this](const auto & first, const auto & second) {
+        return pool_evrcmp_str(pool, first.first.c_str(), second.first.c_str(), EVRCMP_COMPARE) < 0;
+    });
+
+    ranks.assign(evrs.empty() ? 0 : static_cast<std::size_t>(evrs.back()) + 1, UNKNOWN_RANK);
+    keys.clear();
+    for (auto & [key, evr] : items) {
+        // Different strings can compare as equal (e.g. "1.01" and "1.1"), they share the rank
+        if (keys.empty() || pool_evrcmp_str(pool, keys.back().c_str(), key.c_str(), EVRCMP_COMPARE) != 0) {
+            keys.push_back(std::move(key));
+        }
+        ranks[static_cast<std::size_t>(evr)] = static_cast<int>(keys.size() * 2 - 1);
+    }
+}
+
+
+int EvrRankTable::get_rank(const char * key) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key, [this](const std::string & item, const char * key) {
+        return pool_evrcmp_str(pool, item.c_str(), key, EVRCMP_COMPARE) < 0;
+    });
+    auto idx = static_cast<int>(it - keys.begin());
+    if (it != keys.end() && pool_evrcmp_str(pool, it->c_str(), key, EVRCMP_COMPARE) == 0) {
+        return idx * 2 + 1;
+    }
+    return idx * 2;
+}
+
+
+int EvrRankTable::compare(Id evr1, Id evr2) const {
+    if (evr1 == evr2) {
+        return 0;
+    }
+    auto rank1 = get_rank(evr1);
+    auto rank2 = get_rank(evr2);
+    if (rank1 != UNKNOWN_RANK && rank2 != UNKNOWN_RANK) {
+        return (rank1 > rank2) - (rank1 < rank2);
+    }
+    if (part == Part::EVR) {
+        return pool_evrcmp(pool, evr1, evr2, EVRCMP_COMPARE);
+    }
+    return pool_evrcmp_str(pool, get_key(evr1).c_str(), get_key(evr2).c_str(), EVRCMP_COMPARE);
+}
+
+
+int EvrRankTable::compare(Id evr, const char * key, int key_rank) const {
+    auto rank = get_rank(evr);
+    if (rank != UNKNOWN_RANK) {
+        return (rank > key_rank) - (rank < key_rank);
+    }
+    if (part == Part::EVR) {
+        return pool_evrcmp_str(pool, pool_id2str(pool, evr), key, EVRCMP_COMPARE);
+    }
+    return pool_evrcmp_str(pool, get_key(evr).c_str(), key, EVRCMP_COMPARE);
+}
+
+
+std::string EvrRankTable::get_key(Id evr) const {
+    std::string_view evr_str = pool_id2str(pool, evr);
+    if (part == Part::EVR) {
+        return std::string(evr_str);
+    }
+
+    // The EVR is split the same way as by `Pool::split_evr()`
+    std::string_view version = evr_str;
+    std::string_view release;
+    auto separator = evr_str.empty() ? std::string_view::npos : evr_str.find_first_of(":-", 1);
+    if (separator != std::string_view::npos) {
+        if (evr_str[separator] == ':') {
+            version = evr_str.substr(separator + 1);
+            auto release_separator = version.empty() ? std::string_view::npos : version.find('-', 1);
+            if (release_separator != std::string_view::npos) {
+                release = version.substr(release_separator + 1);
+                version = version.substr(0, release_separator);
+            }
+        } else {
+            version = evr_str.substr(0, separator);
+            release = evr_str.substr(separator + 1);
+        }
+    }
+
+    if (part == Part::VERSION) {
+        return std::string(version) + "-0";
+    }
+    return "0-" + std::string(release);
+}
+
+}  // namespace libdnf5::solv
@@ -0,0 +1,91 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_EVR_RANK_TABLE_HPP
+#define LIBDNF5_SOLV_EVR_RANK_TABLE_HPP
+
+extern "C" {
+#include <solv/pool.h>
+}
+
+#include <string>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Dense integer ranks of the EVRs of the solvables in the pool, ordered as by `pool_evrcmp()`. Comparing the ranks
+/// replaces parsing of the EVR strings on every comparison.
+///
+/// The ranks are assigned to EVR Ids, which are never reused by the pool. A table therefore stays correct when
+/// solvables are added, only the EVRs added since `update()` are not ranked and compare by the strings.
+/// The Ids have odd ranks, a string that is not in the table gets the even rank between its neighbours.
+class EvrRankTable {
+public:
+    /// The part of the EVR that is ranked
+    enum class Part {
+        EVR,      // the whole EVR
+        VERSION,  // the version, compared as "<version>-0"
+        RELEASE   // the release, compared as "0-<release>"
+    };
+
+    /// Rank of an EVR Id which is not in the table
+    static constexpr int UNKNOWN_RANK = -1;
+
+    /// Creates an empty table, all comparisons are done by the strings until `update()` is called.
+    EvrRankTable(::Pool * pool, Part part) : pool(pool), part(part) {}
+
+    /// Ranks the EVRs of all solvables in the pool.
+    void update();
+
+    /// Returns the number of solvables in the pool at the time of the last `update()`.
+    int get_nsolvables() const noexcept { return nsolvables; }
+
+    /// Returns the rank of the EVR Id, or `UNKNOWN_RANK`.
+    int get_rank(Id evr) const noexcept {
+        return evr > 0 && static_cast<std::size_t>(evr) < ranks.size() ? ranks[static_cast<std::size_t>(evr)]
+                                                                        : UNKNOWN_RANK;
+    }
+
+    /// Returns the rank of the `key`, which is an EVR string formatted as the ranked part (see `Part`).
+    /// Ranks of the EVR Ids compare with it as the strings would.
+    int get_rank(const char * key) const;
+
+    /// Compares the ranked part of the EVRs like `pool_evrcmp_str()` with `EVRCMP_COMPARE`.
+    int compare(Id evr1, Id evr2) const;
+
+    /// Compares the ranked part of the `evr` with the `key` of the `key_rank` returned by `get_rank(key)`.
+    int compare(Id evr, const char * key, int key_rank) const;
+
+    /// Returns the ranked part of the `evr` formatted as described in `Part`.
+    std::string get_key(Id evr) const;
+
+private:
+    ::Pool * pool;
+    Part part;
+    int nsolvables{0};
+    /// Ranks indexed by the EVR Ids
+    std::vector<int> ranks;
+    /// Keys of the ranks (the key of the rank `2 * i + 1` is at the index `i`)
+    std::vector<std::string> keys;
+};
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_EVR_RANK_TABLE_HPP
@@ -0,0 +1,115 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "full_nevra_cache.hpp"
+
+#include <cstring>
+
+
+namespace libdnf5::solv {
+
+void append_full_nevra(std::string & out, const char * name, const char * evr, const char * arch) {
+    bool add_zero_epoch = true;
+    if (*evr != '\0') {
+        for (const char * e = evr + 1; *e != '-' && *e != '\0'; ++e) {
+            if (*e == ':') {
+                add_zero_epoch = false;
+                break;
+            }
+        }
+    }
+
+    // potentially wasting up to 4 bytes (2 for the zero epoch and 2 for a '-' and a '.')
+    out.reserve(out.size() + strlen(name) + strlen(evr) + strlen(arch) + 4);
+
+    out.append(name);
+
+    if (*evr != '\0') {
+        out.append("-");
+
+        if (add_zero_epoch) {
+            out.append("0:");
+        }
+
+        out.append(evr);
+    }
+
+    if (*arch != '\0') {
+        out.append(".");
+        out.append(arch);
+    }
+}
+
+
+std::string_view FullNevraCache::get(Id id) {
+    const Solvable * solvable = pool_id2solvable(pool, id);
+    const auto idx = static_cast<std::size_t>(id);
+    if (idx >= entries.size()) {
+        entries.resize(static_cast<std::size_t>(pool->nsolvables) > idx ? static_cast<std::size_t>(pool->nsolvables)
+                                                                        : idx + 1);
+    }
+
+    auto & entry = entries[idx];
+    if (entry.str == nullptr || entry.name != solvable->name || entry.evr != solvable->evr ||
+        entry.arch != solvable->arch) {
+        buffer.clear();
+        append_full_nevra(
+            buffer,
+            pool_id2str(pool, solvable->name),
+            pool_id2str(pool, solvable->evr),
+            pool_id2str(pool, solvable->arch));
+        entry.str = intern(buffer);
+        entry.size = buffer.size();
+        entry.name = solvable->name;
+        entry.evr = solvable->evr;
+        entry.arch = solvable->arch;
+        ++formatted_count;
+    }
+
+    return {entry.str, entry.size};
+}
+
+
+void FullNevraCache::clear() {
+    entries.clear();
+    blocks.clear();
+    last_block_used = BLOCK_SIZE;
+}
+
+
+const char * FullNevraCache::intern(std::string_view str) {
+    char * dest;
+    if (str.size() > BLOCK_SIZE) {
+        // A dedicated block, the rest of the current block is not used anymore
+        blocks.emplace_back(new char[str.size()]);
+        dest = blocks.back().get();
+        last_block_used = BLOCK_SIZE;
+    } else {
+        if (blocks.empty() || BLOCK_SIZE - last_block_used < str.size()) {
+            blocks.emplace_back(new char[BLOCK_SIZE]);
+            last_block_used = 0;
+        }
+        dest = blocks.back().get() + last_block_used;
+        last_block_used += str.size();
+    }
+    std::memcpy(dest, str.data(), str.size());
+    return dest;
+}
+
+}  // namespace libdnf5::solv
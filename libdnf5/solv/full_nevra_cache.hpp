@@ -0,0 +1,90 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_FULL_NEVRA_CACHE_HPP
+#define LIBDNF5_SOLV_FULL_NEVRA_CACHE_HPP
+
+extern "C" {
+#include <solv/pool.h>
+}
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Appends to `out` the full NEVRA ("name-epoch:version-release.arch", the epoch is always present)
+/// composed of the `name`, `evr` and `arch` strings.
+void append_full_nevra(std::string & out, const char * name, const char * evr, const char * arch);
+
+/// Lazily populated cache of the full NEVRA strings of the solvables in the pool. A NEVRA is formatted
+/// the first time it is requested, the following requests return the stored string.
+///
+/// The strings are interned in an arena of blocks that are never reallocated, the returned views stay valid
+/// until `clear()` is called or the cache is destroyed. A solvable Id can be reused for another package when
+/// solvables are freed, the entries therefore remember the name, EVR and arch Ids they were formatted from
+/// and a changed solvable is formatted again.
+///
+/// The cache is not thread-safe, `get()` modifies it.
+class FullNevraCache {
+public:
+    explicit FullNevraCache(::Pool * pool) : pool(pool) {}
+
+    /// Returns the full NEVRA of the solvable `id`.
+    std::string_view get(Id id);
+
+    /// Drops all the cached strings.
+    void clear();
+
+    /// Returns the number of the formatted NEVRAs, including the ones formatted again for a reused Id.
+    std::size_t get_formatted_count() const noexcept { return formatted_count; }
+
+private:
+    /// Size of one block of the arena, longer strings get their own block
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Entry {
+        const char * str{nullptr};
+        std::size_t size{0};
+        Id name{0};
+        Id evr{0};
+        Id arch{0};
+    };
+
+    /// Copies the `str` into the arena
+    const char * intern(std::string_view str);
+
+    ::Pool * pool;
+    /// Entries indexed by the solvable Ids
+    std::vector<Entry> entries;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    /// Number of used bytes of the last block
+    std::size_t last_block_used{BLOCK_SIZE};
+    std::size_t formatted_count{0};
+    /// Buffer reused for formatting
+    std::string buffer;
+};
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_FULL_NEVRA_CACHE_HPP
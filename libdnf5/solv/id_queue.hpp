@@ -157,6 +157,23 @@ private:
 };
 
 
+/// IdQueue that stores up to `N` Ids in an inline buffer, so that the short queues do not allocate memory.
+/// The Ids are moved to a heap allocated buffer when the inline one is full. The queue refers to its own
+/// buffer, it must not be copied, moved or move-assigned through a reference to the base `IdQueue`.
+template <int N>
+class InlineIdQueue : public IdQueue {
+public:
+    InlineIdQueue() { queue_init_buffer(&get_queue(), buffer, N); }
+
+    InlineIdQueue(const InlineIdQueue & src) = delete;
+    InlineIdQueue & operator=(const InlineIdQueue & src) = delete;
+    InlineIdQueue & operator=(IdQueue && src) = delete;
+
+private:
+    Id buffer[N];
+};
+
+
 inline bool IdQueue::operator==(const IdQueue & other) const {
     if (size() != other.size()) {
         return false;
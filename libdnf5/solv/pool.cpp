@@ -74,11 +74,56 @@ TempEvr::~TempEvr() {
 }
 
 
+PoolMemoryUsage get_pool_memory_usage(const ::Pool * pool) noexcept {
+    PoolMemoryUsage usage;
+    const auto nstrings = static_cast<std::size_t>(pool->ss.nstrings);
+    const auto nrels = static_cast<std::size_t>(pool->nrels);
+    usage.strings = static_cast<std::size_t>(pool->ss.sstrings) + nstrings * sizeof(Offset);
+    if (pool->ss.stringhashtbl) {
+        usage.strings += (static_cast<std::size_t>(pool->ss.stringhashmask) + 1) * sizeof(Id);
+    }
+    usage.reldeps = nrels * sizeof(Reldep);
+    if (pool->whatprovides) {
+        usage.whatprovides += nstrings * sizeof(Offset);
+    }
+    if (pool->whatprovides_rel) {
+        usage.whatprovides += nrels * sizeof(Offset);
+    }
+    if (pool->whatprovidesdata) {
+        auto whatprovidesdata_size = static_cast<std::size_t>(pool->whatprovidesdataoff) +
+                                     static_cast<std::size_t>(pool->whatprovidesdataleft);
+        usage.whatprovides += whatprovidesdata_size * sizeof(Id);
+    }
+    usage.solvables = static_cast<std::size_t>(pool->nsolvables) * sizeof(Solvable);
+    return usage;
+}
+
+
 Pool::~Pool() {
     pool_free(pool);
 }
 
 
+const EvrRankTable & RpmPool::get_evr_rank_table(EvrRankTable::Part part, bool update) {
+    auto & table = evr_rank_tables[static_cast<std::size_t>(part)];
+    if (!table) {
+        table = std::make_unique<EvrRankTable>(pool, part);
+    }
+    if (update && table->get_nsolvables() != get_nsolvables()) {
+        table->update();
+    }
+    return *table;
+}
+
+
+std::string_view RpmPool::get_cached_full_nevra(Id id) {
+    if (!full_nevra_cache) {
+        full_nevra_cache = std::make_unique<FullNevraCache>(pool);
+    }
+    return full_nevra_cache->get(id);
+}
+
+
 /// Returns a temporary object allocated by pool_alloctmpspace
 const char * pool_solvable_epoch_optional_2str(
     const Pool * pool, ::Pool * libsolv_pool, Id id, bool with_epoch) noexcept {
@@ -182,41 +227,8 @@ unsigned long Pool::get_epoch_num(Id id) const {
 
 std::string Pool::get_full_nevra(Id id) const {
     Solvable * solvable = id2solvable(id);
-    const char * name = id2str(solvable->name);
-    const char * evr = id2str(solvable->evr);
-    const char * arch = id2str(solvable->arch);
-
-    bool add_zero_epoch = true;
-    if (*evr != '\0') {
-        for (const char * e = evr + 1; *e != '-' && *e != '\0'; ++e) {
-            if (*e == ':') {
-                add_zero_epoch = false;
-                break;
-            }
-        }
-    }
-
     std::string res;
-    // potentially wasting up to 4 bytes (2 for the zero epoch and 2 for a '-' and a '.')
-    res.reserve(strlen(name) + strlen(evr) + strlen(arch) + 4);
-
-    res.append(name);
-
-    if (*evr != '\0') {
-        res.append("-");
-
-        if (add_zero_epoch) {
-            res.append("0:");
-        }
-
-        res.append(evr);
-    }
-
-    if (*arch != '\0') {
-        res.append(".");
-        res.append(arch);
-    }
-
+    append_full_nevra(res, id2str(solvable->name), id2str(solvable->evr), id2str(solvable->arch));
     return res;
 }
 
@@ -21,12 +21,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF5_SOLV_POOL_HPP
 
 #include "base/base_impl.hpp"
+#include "comps_index.hpp"
+#include "evr_rank_table.hpp"
+#include "full_nevra_cache.hpp"
 #include "id_queue.hpp"
+#include "reldep_cache.hpp"
 
 #include "libdnf5/repo/repo.hpp"
 
+#include <array>
 #include <climits>
 #include <memory>
+#include <string_view>
 
 extern "C" {
 #include <solv/dataiterator.h>
@@ -53,8 +59,56 @@ inline repo::Repo & get_repo(Solvable * solvable) {
 }
 
 
+/// Estimated memory used by the data of a libsolv pool, the data of its repositories are not included
+struct PoolMemoryUsage {
+    /// The string space and the string hash table
+    std::size_t strings{0};
+    /// The dependency relations
+    std::size_t reldeps{0};
+    /// The whatprovides index, it exists only after `pool_createwhatprovides()`
+    std::size_t whatprovides{0};
+    /// The solvable structures
+    std::size_t solvables{0};
+};
+
+/// Returns the estimated memory used by the data of the `pool`
+PoolMemoryUsage get_pool_memory_usage(const ::Pool * pool) noexcept;
+
+
 class Pool;
 
+/// Epoch, Version and Release parts of an EVR string
+struct EvrView {
+    std::string_view e;
+    std::string_view v;
+    std::string_view r;
+
+    std::string_view e_def() const noexcept { return e.empty() ? ZERO_EPOCH : e; }
+};
+
+/// Splits `evr` the same way as TempEvr does, but the parts are views into `evr` instead of copies.
+inline EvrView split_evr_view(std::string_view evr) noexcept {
+    EvrView result;
+    auto pos = evr.find_first_of(":-", 1);
+    if (pos == std::string_view::npos) {
+        result.v = evr;
+    } else if (evr[pos] == '-') {
+        result.v = evr.substr(0, pos);
+        result.r = evr.substr(pos + 1);
+    } else {  // evr[pos] == ':'
+        result.e = evr.substr(0, pos);
+        auto version_release = evr.substr(pos + 1);
+        auto dash = version_release.find('-', 1);
+        if (dash == std::string_view::npos) {
+            result.v = version_release;
+        } else {
+            result.v = version_release.substr(0, dash);
+            result.r = version_release.substr(dash + 1);
+        }
+    }
+    return result;
+}
+
 class TempEvr {
 public:
     char * e = nullptr;
@@ -120,6 +174,9 @@ public:
 
     Id rel2id(Id name, Id evr, int flags, bool create) const { return pool_rel2id(pool, name, evr, flags, create); }
 
+    /// Internalizes the repository of the solvable `id`, its data can be then read directly from the repodata
+    void internalize_repo(Id id) const { libdnf5::solv::get_repo(id2solvable(id)).internalize(); }
+
     Id lookup_id(Id id, Id keyname) const {
         if (id > 0) {
             libdnf5::solv::get_repo(id2solvable(id)).internalize();
@@ -255,7 +312,7 @@ public:
         if (considered.allocated_size() == 0) {
             pool->considered = nullptr;
         } else {
-            pool->considered = const_cast<::Map *>(&considered.get_map());
+            pool->considered = &considered.get_writable_map();
         }
     }
 
@@ -267,6 +324,24 @@ protected:
 
 class RpmPool : public Pool {
     // TODO(mblaha): Move rpm specific methods from parent Pool class here
+public:
+    /// Returns the table of ranks of the `part` of the EVRs of the solvables. When `update` is true, the table
+    /// is updated if solvables were added or removed since it was built. An outdated table is still correct,
+    /// the EVRs it does not know are compared by the strings.
+    const EvrRankTable & get_evr_rank_table(EvrRankTable::Part part, bool update = true);
+
+    /// Returns the full NEVRA of the solvable `id` from the lazily populated cache, so that the NEVRAs reported
+    /// many times (e.g. by the transaction callbacks) are formatted only once. The view stays valid
+    /// as long as the pool. Not thread-safe.
+    std::string_view get_cached_full_nevra(Id id);
+
+    /// Returns the cache of the reldep Ids created from the dependency strings.
+    ReldepCache & get_reldep_cache() noexcept { return reldep_cache; }
+
+private:
+    std::array<std::unique_ptr<EvrRankTable>, 3> evr_rank_tables;
+    std::unique_ptr<FullNevraCache> full_nevra_cache;
+    ReldepCache reldep_cache;
 };
 
 
@@ -311,6 +386,15 @@ public:
     }
 
     static std::pair<std::string, std::string> split_solvable_name(std::string_view solvable_name);
+
+    /// Returns the index of the groups and environments, it is updated to the current solvables first.
+    CompsIndex & get_comps_index() {
+        comps_index.update(pool);
+        return comps_index;
+    }
+
+private:
+    CompsIndex comps_index;
 };
 
 }  // namespace libdnf5::solv
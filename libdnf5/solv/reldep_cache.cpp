@@ -0,0 +1,61 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "reldep_cache.hpp"
+
+#include <utility>
+
+
+namespace libdnf5::solv {
+
+Id ReldepCache::lookup(const std::string & reldep_str) {
+    auto it = ids.find(reldep_str);
+    if (it == ids.end()) {
+        ++misses;
+        return 0;
+    }
+    ++hits;
+    return it->second;
+}
+
+void ReldepCache::store(const std::string & reldep_str, Id id) {
+    if (ids.size() >= MAX_ENTRIES) {
+        ids.clear();
+    }
+    ids.emplace(reldep_str, id);
+}
+
+const std::vector<Id> * ReldepCache::lookup_glob(const std::string & reldep_str) {
+    auto it = globs.find(reldep_str);
+    if (it == globs.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    return &it->second;
+}
+
+void ReldepCache::store_glob(const std::string & reldep_str, std::vector<Id> && ids) {
+    if (globs.size() >= MAX_ENTRIES) {
+        globs.clear();
+    }
+    globs.insert_or_assign(reldep_str, std::move(ids));
+}
+
+}  // namespace libdnf5::solv
@@ -0,0 +1,78 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_RELDEP_CACHE_HPP
+#define LIBDNF5_SOLV_RELDEP_CACHE_HPP
+
+extern "C" {
+#include <solv/pooltypes.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Cache of the reldep Ids created from the dependency strings, so that the patterns of the string-based reldep
+/// filters repeated by the goal and the commands are not parsed again on every call.
+///
+/// A parsed dependency string always maps to the same Id, the strings and reldeps are never removed from the pool.
+/// These entries are therefore valid for the whole lifetime of the pool. The expansions of the glob patterns
+/// depend on the packages in the pool and are dropped by `invalidate_globs()` whenever the packages change.
+///
+/// The cache is not thread-safe.
+class ReldepCache {
+public:
+    /// Maximal number of stored dependency strings (and separately glob patterns), the entries are cleared
+    /// when it is reached.
+    static constexpr std::size_t MAX_ENTRIES = 16384;
+
+    /// Returns the Id of the `reldep_str` or 0 if it is not cached.
+    Id lookup(const std::string & reldep_str);
+
+    /// Stores the non-zero `id` of the `reldep_str`.
+    void store(const std::string & reldep_str, Id id);
+
+    /// Returns the reldep Ids the glob `reldep_str` was expanded to or `nullptr` if it is not cached.
+    /// The pointer is valid until the next call of a non-const method.
+    const std::vector<Id> * lookup_glob(const std::string & reldep_str);
+
+    /// Stores the reldep Ids the glob `reldep_str` was expanded to.
+    void store_glob(const std::string & reldep_str, std::vector<Id> && ids);
+
+    /// Drops the glob expansions, has to be called whenever the packages in the pool change.
+    void invalidate_globs() noexcept { globs.clear(); }
+
+    std::uint64_t get_hits() const noexcept { return hits; }
+    std::uint64_t get_misses() const noexcept { return misses; }
+
+private:
+    std::unordered_map<std::string, Id> ids;
+    std::unordered_map<std::string, std::vector<Id>> globs;
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+};
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_RELDEP_CACHE_HPP
@@ -0,0 +1,361 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solv_map.hpp"
+
+#include <solv/util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <utility>
+
+
+// The kernels are compiled also for AVX2 (and POPCNT) on x86_64, the variant matching the CPU is selected
+// by the dynamic loader. The ifunc resolvers run before the ThreadSanitizer runtime is initialized, so only
+// the default variant is built with it.
+#if defined(__x86_64__) && defined(__has_attribute) && !defined(__SANITIZE_THREAD__)
+#if __has_attribute(target_clones)
+#define LIBDNF5_SOLV_MAP_AVX2_CLONES __attribute__((target_clones("avx2", "default")))
+#define LIBDNF5_SOLV_MAP_POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#endif
+#endif
+
+#ifndef LIBDNF5_SOLV_MAP_AVX2_CLONES
+#define LIBDNF5_SOLV_MAP_AVX2_CLONES
+#define LIBDNF5_SOLV_MAP_POPCNT_CLONES
+#endif
+
+
+namespace libdnf5::solv {
+
+namespace {
+
+std::atomic<std::size_t> shared_bitmaps{0};
+std::atomic<std::size_t> bitmaps_copied_on_write{0};
+
+/// Frees the bitmap allocated by libsolv unless it was handed back to a libsolv Map by `release()`
+struct BitmapDeleter {
+    void operator()(unsigned char * bytes) const noexcept {
+        if (!released) {
+            solv_free(bytes);
+        }
+    }
+
+    bool released{false};
+};
+
+/// Hands the bitmap owned only by `bitmap` back to the caller, the caller frees it
+unsigned char * release(std::shared_ptr<unsigned char> & bitmap) noexcept {
+    auto * bytes = bitmap.get();
+    std::get_deleter<BitmapDeleter>(bitmap)->released = true;
+    bitmap.reset();
+    return bytes;
+}
+
+/// 256 bits of a bitmap processed at once, it is a single AVX2 register or a pair of SSE2 / NEON registers
+typedef std::uint64_t Block __attribute__((vector_size(32)));
+
+// The values are passed by reference, the ABI of passing vectors by value depends on the enabled instructions
+
+template <typename T>
+inline void load(T & value, const unsigned char * bytes) noexcept {
+    std::memcpy(&value, bytes, sizeof(value));
+}
+
+template <typename T>
+inline void store(unsigned char * bytes, const T & value) noexcept {
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+/// Calls `operation(target_bits, source_bits)`, which modifies the target bits, block by block, then word by word
+/// and byte by byte at the end of the bitmaps.
+template <typename T, typename Operation>
+inline void bitmap_apply_step(unsigned char * target, const unsigned char * source, Operation & operation) noexcept {
+    T target_bits;
+    T source_bits;
+    load(target_bits, target);
+    load(source_bits, source);
+    operation(target_bits, source_bits);
+    store(target, target_bits);
+}
+
+template <typename Operation>
+inline void bitmap_apply(
+    unsigned char * target, const unsigned char * source, std::size_t size, Operation operation) noexcept {
+    std::size_t idx = 0;
+    for (; idx + sizeof(Block) <= size; idx += sizeof(Block)) {
+        bitmap_apply_step<Block>(target + idx, source + idx, operation);
+    }
+    for (; idx + sizeof(std::uint64_t) <= size; idx += sizeof(std::uint64_t)) {
+        bitmap_apply_step<std::uint64_t>(target + idx, source + idx, operation);
+    }
+    for (; idx < size; ++idx) {
+        unsigned int target_bits = target[idx];
+        operation(target_bits, unsigned{source[idx]});
+        target[idx] = static_cast<unsigned char>(target_bits);
+    }
+}
+
+/// Sets the bits of the items in the range [begin, end) to `value`, the bytes in between the boundary bytes
+/// are filled by memset.
+void bitmap_fill_range(unsigned char * bytes, std::size_t begin, std::size_t end, bool value) noexcept {
+    if (begin >= end) {
+        return;
+    }
+    auto first_byte = begin >> 3;
+    auto last_byte = (end - 1) >> 3;
+    unsigned first_mask = (0xFFu << (begin & 7)) & 0xFFu;
+    unsigned last_mask = 0xFFu >> (7 - ((end - 1) & 7));
+    auto apply = [bytes, value](std::size_t idx, unsigned mask) {
+        bytes[idx] = static_cast<unsigned char>(value ? (bytes[idx] | mask) : (bytes[idx] & ~mask));
+    };
+    if (first_byte == last_byte) {
+        apply(first_byte, first_mask & last_mask);
+        return;
+    }
+    apply(first_byte, first_mask);
+    std::memset(bytes + first_byte + 1, value ? 0xFF : 0, last_byte - first_byte - 1);
+    apply(last_byte, last_mask);
+}
+
+}  // namespace
+
+
+LIBDNF5_SOLV_MAP_AVX2_CLONES
+void bitmap_and(unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    bitmap_apply(
+        target, source, size, [](auto & target_bits, const auto & source_bits) { target_bits &= source_bits; });
+}
+
+
+LIBDNF5_SOLV_MAP_AVX2_CLONES
+void bitmap_or(unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    bitmap_apply(
+        target, source, size, [](auto & target_bits, const auto & source_bits) { target_bits |= source_bits; });
+}
+
+
+LIBDNF5_SOLV_MAP_AVX2_CLONES
+void bitmap_subtract(unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    bitmap_apply(
+        target, source, size, [](auto & target_bits, const auto & source_bits) { target_bits &= ~source_bits; });
+}
+
+
+LIBDNF5_SOLV_MAP_POPCNT_CLONES
+std::size_t bitmap_count(const unsigned char * bitmap, std::size_t size) noexcept {
+    std::size_t result = 0;
+    std::size_t idx = 0;
+    for (; idx + sizeof(std::uint64_t) <= size; idx += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        load(word, bitmap + idx);
+        result += static_cast<std::size_t>(std::popcount(word));
+    }
+    for (; idx < size; ++idx) {
+        result += static_cast<std::size_t>(std::popcount(unsigned{bitmap[idx]}));
+    }
+    return result;
+}
+
+
+SolvMapCopyStats get_solv_map_copy_stats() noexcept {
+    SolvMapCopyStats stats;
+    stats.shared = shared_bitmaps.load(std::memory_order_relaxed);
+    stats.copied_on_write = bitmaps_copied_on_write.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
+void SolvMap::make_sparse(std::vector<Id> && ids) noexcept {
+    release_bitmap();
+    sparse_ids = std::move(ids);
+}
+
+
+void SolvMap::assign_bitmap(const SolvMap & other) {
+    if (other.writable_map_returned) {
+        map_init_clone(&map, &other.map);
+        adopt_bitmap();
+        return;
+    }
+    map.map = other.map.map;
+    map.size = other.map.size;
+    bitmap = other.bitmap;
+    shared_bitmaps.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void SolvMap::adopt_bitmap() const {
+    bitmap.reset(map.map, BitmapDeleter());
+}
+
+
+void SolvMap::release_bitmap() noexcept {
+    bitmap.reset();
+    map.map = nullptr;
+    writable_map_returned = false;
+}
+
+
+void SolvMap::copy_shared_bitmap() {
+    Map copy;
+    map_init_clone(&copy, &map);
+    map.map = copy.map;
+    adopt_bitmap();
+    bitmaps_copied_on_write.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void SolvMap::grow_bitmap(int size) {
+    make_bitmap_exclusive();
+    // the bitmap is reallocated by libsolv
+    map.map = release(bitmap);
+    map_grow(&map, size);
+    adopt_bitmap();
+}
+
+
+void SolvMap::sparse_to_dense() const {
+    map_init(&map, map.size << 3);
+    adopt_bitmap();
+    for (auto id : sparse_ids) {
+        MAPSET(&map, id);
+    }
+    // release the memory of the vector, the set is not expected to shrink back soon
+    std::vector<Id>().swap(sparse_ids);
+}
+
+
+void SolvMap::sparse_add(Id id) {
+    // the items are usually added in ascending order
+    if (sparse_ids.empty() || sparse_ids.back() < id) {
+        sparse_ids.push_back(id);
+    } else {
+        auto it = std::lower_bound(sparse_ids.begin(), sparse_ids.end(), id);
+        if (*it == id) {
+            return;
+        }
+        sparse_ids.insert(it, id);
+    }
+    if (sparse_ids.size() > SPARSE_MAX_ITEMS) {
+        sparse_to_dense();
+    }
+}
+
+
+void SolvMap::sparse_remove(Id id) noexcept {
+    auto it = std::lower_bound(sparse_ids.begin(), sparse_ids.end(), id);
+    if (it != sparse_ids.end() && *it == id) {
+        sparse_ids.erase(it);
+    }
+}
+
+
+void SolvMap::add_range_unsafe(Id begin, Id end) {
+    if (begin >= end) {
+        return;
+    }
+    if (is_sparse()) {
+        if (sparse_ids.size() + static_cast<std::size_t>(end - begin) <= SPARSE_MAX_ITEMS) {
+            for (Id id = begin; id < end; ++id) {
+                sparse_add(id);
+            }
+            return;
+        }
+        sparse_to_dense();
+    }
+    make_bitmap_exclusive();
+    bitmap_fill_range(map.map, static_cast<std::size_t>(begin), static_cast<std::size_t>(end), true);
+}
+
+
+void SolvMap::remove_range_unsafe(Id begin, Id end) {
+    if (begin >= end) {
+        return;
+    }
+    if (is_sparse()) {
+        sparse_ids.erase(
+            std::lower_bound(sparse_ids.begin(), sparse_ids.end(), begin),
+            std::lower_bound(sparse_ids.begin(), sparse_ids.end(), end));
+        return;
+    }
+    make_bitmap_exclusive();
+    bitmap_fill_range(map.map, static_cast<std::size_t>(begin), static_cast<std::size_t>(end), false);
+}
+
+
+SolvMap & SolvMap::operator|=(const SolvMap & other) {
+    if (is_same_set(other)) {
+        return *this;
+    }
+    if (!other.is_sparse()) {
+        *this |= other.map;
+        return *this;
+    }
+    grow(other.map.size << 3);
+    for (auto id : other.sparse_ids) {
+        add_unsafe(id);
+    }
+    return *this;
+}
+
+
+SolvMap & SolvMap::operator-=(const SolvMap & other) {
+    if (is_same_set(other)) {
+        clear();
+    } else if (is_sparse()) {
+        std::erase_if(sparse_ids, [&other](Id id) { return other.contains(id); });
+    } else if (other.is_sparse()) {
+        make_bitmap_exclusive();
+        for (auto id : other.sparse_ids) {
+            if (id < allocated_size()) {
+                map_clr(&map, id);
+            }
+        }
+    } else {
+        *this -= other.map;
+    }
+    return *this;
+}
+
+
+SolvMap & SolvMap::operator&=(const SolvMap & other) {
+    if (is_same_set(other)) {
+        return *this;
+    }
+    if (is_sparse()) {
+        std::erase_if(sparse_ids, [&other](Id id) { return !other.contains(id); });
+    } else if (other.is_sparse()) {
+        // the intersection is not bigger than the small set, the bitmap is replaced by the sorted vector
+        std::vector<Id> ids;
+        ids.reserve(other.sparse_ids.size());
+        for (auto id : other.sparse_ids) {
+            if (contains(id)) {
+                ids.push_back(id);
+            }
+        }
+        make_sparse(std::move(ids));
+    } else {
+        *this &= other.map;
+    }
+    return *this;
+}
+
+}  // namespace libdnf5::solv
@@ -25,21 +25,58 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <solv/bitmap.h>
 #include <solv/pooltypes.h>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 
 namespace libdnf5::solv {
 
-// clang-format off
-// see http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetTable
-static const unsigned char BIT_COUNT_LOOKUP[256] = {
-    #define B2(n) n, n + 1, n + 1, n + 2
-    #define B4(n) B2(n), B2(n + 1), B2(n + 1), B2(n + 2)
-    #define B6(n) B4(n), B4(n + 1), B4(n + 1), B4(n + 2)
-    B6(0), B6(1), B6(1), B6(2)
+// Word-at-a-time kernels of the bitmap operations, `size` is in bytes. On x86_64 there are also AVX2 (and POPCNT)
+// variants selected at runtime according to the CPU.
+
+/// target &= source
+void bitmap_and(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// target |= source
+void bitmap_or(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// target &= ~source
+void bitmap_subtract(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// @return the number of bits set in the bitmap.
+std::size_t bitmap_count(const unsigned char * bitmap, std::size_t size) noexcept;
+
+/// Loads 64 bits of the bitmap starting at `bytes`. The lowest bit of the result is the lowest bit of `bytes[0]`.
+inline std::uint64_t bitmap_load_word(const unsigned char * bytes) noexcept {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        word = __builtin_bswap64(word);
+    }
+    return word;
+}
+
+
+/// Counters of the copies of the SolvMap bitmaps in the process
+struct SolvMapCopyStats {
+    /// Copies of the maps that share the bitmap of the source map
+    std::size_t shared{0};
+    /// Shared bitmaps that were copied because one of the maps sharing them was modified
+    std::size_t copied_on_write{0};
 };
-// clang-format on
+
+/// @return the counters of the copies of the SolvMap bitmaps, `shared - copied_on_write` bitmap copies were avoided.
+SolvMapCopyStats get_solv_map_copy_stats() noexcept;
+
+
+class SolvMap;
 
 
 class ConstMapIterator {
@@ -83,15 +120,11 @@ public:
     /// Sets the iterator to the first contained item or to the end if there are no items.
     void begin() noexcept {
         current_value = BEGIN;
-        map_current = map->map;
         ++*this;
     }
 
     /// Sets the iterator to the end.
-    void end() noexcept {
-        current_value = END;
-        map_current = map_end;
-    }
+    void end() noexcept { current_value = END; }
 
     /// Sets the iterator to the first contained item in the range <id, end>.
     void jump(Id id) noexcept;
@@ -99,16 +132,25 @@ public:
 protected:
     explicit ConstMapIterator(const Map & map) noexcept : map{&map}, map_end{map.map + map.size} {}
 
+    /// Iterates the items of `solv_map` in any of its representations.
+    explicit ConstMapIterator(const SolvMap & solv_map) noexcept;
+
 private:
+    friend SolvMap;
+
     constexpr static int BEGIN = -1;
     constexpr static int END = -2;
 
+    /// Updates `map` and `map_end` to the bitmap of `solv_map`, it can be converted between the steps.
+    /// @return false if the items of `solv_map` are stored in the sorted vector.
+    bool sync_map() noexcept;
+
+    // the iterated SolvMap, nullptr when a libsolv Map is iterated
+    const SolvMap * solv_map{nullptr};
+
     // pointer to a map owned by SolvMap
     const Map * map;
 
-    // current address in the map
-    const unsigned char * map_current;
-
     // the last address in the map
     const unsigned char * map_end;
 
@@ -117,46 +159,116 @@ private:
 };
 
 
+/// Set of Ids in the range <0, allocated_size()).
+///
+/// A small set stores its items in a sorted vector, the bitmap of the whole range is allocated only when the set
+/// grows over `SPARSE_MAX_ITEMS` items, when an operation needs it or when the libsolv Map is requested
+/// by `get_map()`. A new map and a copy of a small set thus do not allocate, zero or copy the bitmap.
+/// A bitmap is converted back to the sorted vector when it is intersected with a small set or assigned one.
+///
+/// The bitmap is reference counted and copy-on-write. A copy of the map shares the bitmap of the source,
+/// the bitmap is copied only when one of the maps sharing it is modified.
 class SolvMap {
 public:
     using iterator = ConstMapIterator;
     using const_iterator = ConstMapIterator;
 
-    explicit SolvMap(int size) { map_init(&map, size); }
+    /// Maximal number of items stored in the sorted vector, a bigger set is stored in the bitmap.
+    static constexpr std::size_t SPARSE_MAX_ITEMS = 128;
 
-    SolvMap(const SolvMap & other) : SolvMap(other.get_map()) {}
+    explicit SolvMap(int size) noexcept {
+        map.map = nullptr;
+        map.size = (size + 7) >> 3;
+    }
+
+    SolvMap(const SolvMap & other);
 
     /// Clones from an existing libsolv Map.
-    explicit SolvMap(const Map & map) { map_init_clone(&this->map, &map); }
+    explicit SolvMap(const Map & map) {
+        map_init_clone(&this->map, &map);
+        adopt_bitmap();
+    }
 
-    SolvMap(SolvMap && other) noexcept {
-        map = other.map;
+    SolvMap(SolvMap && other) noexcept
+        : map{other.map},
+          bitmap{std::move(other.bitmap)},
+          writable_map_returned{other.writable_map_returned},
+          sparse_ids{std::move(other.sparse_ids)} {
         other.map.map = nullptr;
         other.map.size = 0;
+        other.sparse_ids.clear();
     }
 
-    ~SolvMap() { map_free(&map); }
+    ~SolvMap() = default;
 
-    SolvMap & operator=(const SolvMap & other) noexcept;
-    SolvMap & operator=(SolvMap && other) noexcept;
+    SolvMap & operator=(const SolvMap & other);
+    SolvMap & operator=(SolvMap && other);
 
-    [[nodiscard]] const_iterator begin() const { return const_iterator::begin(map); }
-    [[nodiscard]] const_iterator end() const { return const_iterator::end(map); }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        const_iterator it(*this);
+        it.begin();
+        return it;
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        const_iterator it(*this);
+        it.end();
+        return it;
+    }
 
     // GENERIC OPERATIONS
 
     /// Grows the map to a bigger size.
     ///
     /// @param size The new size to grow to.
-    void grow(int size) { map_grow(&map, size); };
+    void grow(int size) {
+        if (is_sparse()) {
+            map.size = std::max(map.size, (size + 7) >> 3);
+        } else if (((size + 7) >> 3) > map.size) {
+            grow_bitmap(size);
+        }
+    };
 
     /// Sets all bits in the map to 1.
-    void set_all() { map_setall(&map); };
+    void set_all() {
+        make_dense();
+        make_bitmap_exclusive();
+        map_setall(&map);
+    };
 
     /// Sets all bits in the map to 0.
-    void clear() noexcept { map_empty(&map); }
+    void clear() noexcept {
+        if (is_sparse()) {
+            sparse_ids.clear();
+        } else if (bitmap.use_count() > 1) {
+            // the shared bitmap is left to the other maps
+            make_sparse({});
+        } else {
+            map_empty(&map);
+        }
+    }
+
+    /// Returns the libsolv Map, a set stored in the sorted vector is converted to the bitmap.
+    /// The bitmap can be shared with copies of the map, it must not be modified.
+    /// The conversion modifies the map although the method is const. Several threads can read the map at once
+    /// only when it is not converted by them, `get_map()` has to be called before the threads start
+    /// (as `filter_concurrently()` does). The other const methods do not modify the map.
+    [[nodiscard]] const Map & get_map() const {
+        make_dense();
+        return map;
+    }
+
+    /// Returns the libsolv Map which can be modified directly, e.g. by libsolv or by several threads setting
+    /// different bytes. The bitmap is not shared with other maps then, also the later copies of the map copy it.
+    [[nodiscard]] Map & get_writable_map() {
+        make_dense();
+        make_bitmap_exclusive();
+        writable_map_returned = true;
+        return map;
+    }
 
-    [[nodiscard]] const Map & get_map() const noexcept { return map; }
+    /// @return whether the items are stored in the sorted vector instead of the bitmap.
+    [[nodiscard]] bool is_sparse() const noexcept { return map.map == nullptr; }
 
     /// @return the number of solvables in the SolvMap (number of 1s in the bitmap).
     [[nodiscard]] std::size_t size() const noexcept;
@@ -164,6 +276,11 @@ public:
     /// @return the size allocated for the map in memory (in number of items, not bytes).
     [[nodiscard]] int allocated_size() const noexcept { return map.size << 3; }
 
+    /// @return the memory used by the items of the map in bytes.
+    [[nodiscard]] std::size_t get_memory_usage() const noexcept {
+        return is_sparse() ? sparse_ids.capacity() * sizeof(Id) : static_cast<std::size_t>(map.size);
+    }
+
     /// @return whether the map is empty.
     [[nodiscard]] bool empty() const noexcept;
 
@@ -174,62 +291,101 @@ public:
         add_unsafe(id);
     }
 
-    void add_unsafe(Id id) noexcept { map_set(&map, id); }
+    void add_unsafe(Id id) {
+        if (is_sparse()) {
+            sparse_add(id);
+        } else {
+            make_bitmap_exclusive();
+            map_set(&map, id);
+        }
+    }
 
     [[nodiscard]] bool contains(Id id) const noexcept;
 
-    [[nodiscard]] bool contains_unsafe(Id id) const noexcept { return MAPTST(&map, id); }
+    [[nodiscard]] bool contains_unsafe(Id id) const noexcept {
+        if (is_sparse()) {
+            return std::binary_search(sparse_ids.begin(), sparse_ids.end(), id);
+        }
+        return MAPTST(&map, id);
+    }
 
     void remove(Id id) {
         check_id_in_bitmap_range(id);
         remove_unsafe(id);
     }
 
-    void remove_unsafe(Id id) noexcept { map_clr(&map, id); }
+    void remove_unsafe(Id id) {
+        if (is_sparse()) {
+            sparse_remove(id);
+        } else {
+            make_bitmap_exclusive();
+            map_clr(&map, id);
+        }
+    }
+
+    /// Adds the items in the range [begin, end). The whole bytes of the bitmap are set at once.
+    void add_range_unsafe(Id begin, Id end);
+
+    /// Removes the items in the range [begin, end). The whole bytes of the bitmap are cleared at once.
+    void remove_range_unsafe(Id begin, Id end);
 
     // SET OPERATIONS - Map
 
     /// Union operator
-    SolvMap & operator|=(const Map & other) noexcept {
-        map_or(&map, &other);
+    SolvMap & operator|=(const Map & other) {
+        grow(other.size << 3);
+        make_dense();
+        make_bitmap_exclusive();
+        bitmap_or(map.map, other.map, static_cast<std::size_t>(other.size));
         return *this;
     }
 
     /// Difference operator
-    SolvMap & operator-=(const Map & other) noexcept {
-        map_subtract(&map, &other);
+    SolvMap & operator-=(const Map & other) {
+        if (is_sparse()) {
+            std::erase_if(sparse_ids, [&other](Id id) { return map_contains(other, id); });
+            return *this;
+        }
+        make_bitmap_exclusive();
+        bitmap_subtract(map.map, other.map, static_cast<std::size_t>(std::min(map.size, other.size)));
         return *this;
     }
 
     /// Intersection operator
-    SolvMap & operator&=(const Map & other) noexcept {
-        map_and(&map, &other);
+    SolvMap & operator&=(const Map & other) {
+        if (is_sparse()) {
+            std::erase_if(sparse_ids, [&other](Id id) { return !map_contains(other, id); });
+            return *this;
+        }
+        make_bitmap_exclusive();
+        auto common_size = std::min(map.size, other.size);
+        bitmap_and(map.map, other.map, static_cast<std::size_t>(common_size));
+        // the items beyond the size of the other map are not in the intersection
+        if (map.size > common_size) {
+            std::memset(map.map + common_size, 0, static_cast<std::size_t>(map.size - common_size));
+        }
         return *this;
     }
 
     // SET OPERATIONS - SolvMap
 
     /// Union operator
-    SolvMap & operator|=(const SolvMap & other) noexcept {
-        *this |= other.get_map();
-        return *this;
-    }
+    SolvMap & operator|=(const SolvMap & other);
 
     /// Difference operator
-    SolvMap & operator-=(const SolvMap & other) noexcept {
-        *this -= other.get_map();
-        return *this;
-    }
+    SolvMap & operator-=(const SolvMap & other);
 
     /// Intersection operator
-    SolvMap & operator&=(const SolvMap & other) noexcept {
-        *this &= other.get_map();
-        return *this;
+    SolvMap & operator&=(const SolvMap & other);
+
+    /// Swaps the underlying libsolv Map pointers and the sorted vectors.
+    void swap(SolvMap & other) noexcept {
+        std::swap(map, other.map);
+        bitmap.swap(other.bitmap);
+        std::swap(writable_map_returned, other.writable_map_returned);
+        sparse_ids.swap(other.sparse_ids);
     }
 
-    /// Swaps the underlying libsolv Map pointers.
-    void swap(SolvMap & other) noexcept { std::swap(map, other.map); }
-
 protected:
     /// Check if `id` is in bitmap range.
     ///
@@ -237,44 +393,134 @@ protected:
     void check_id_in_bitmap_range(Id id) const;
 
 private:
-    Map map;
-};
+    friend ConstMapIterator;
 
+    /// @return whether the libsolv Map `map` contains `id`, `id` can be out of its range.
+    [[nodiscard]] static bool map_contains(const Map & map, Id id) noexcept {
+        return id >= 0 && (id >> 3) < map.size && MAPTST(&map, id);
+    }
 
-inline ConstMapIterator & ConstMapIterator::operator++() noexcept {
-    if (current_value >= 0) {
-        // make a copy of byte with the previous match to avoid changing the map
-        unsigned char byte = *map_current;
+    /// Converts the sorted vector to the bitmap. It does nothing if the bitmap is already used.
+    void make_dense() const {
+        if (is_sparse()) {
+            sparse_to_dense();
+        }
+    }
 
-        // reset previously seen bits to 0
-        byte = static_cast<unsigned char>(byte >> ((current_value & 7) + 1));
+    /// Frees the bitmap and stores the sorted unique `ids` instead. The size of the map is kept.
+    void make_sparse(std::vector<Id> && ids) noexcept;
 
-        auto bit = ffs(byte << ((current_value & 7) + 1));
-        if (bit) {
-            // return (current byte * 8) + bit position - 1
-            current_value = (static_cast<int>(map_current - map->map) << 3) + bit - 1;
-            return *this;
-        }
+    void sparse_to_dense() const;
+    void sparse_add(Id id);
+    void sparse_remove(Id id) noexcept;
 
-        // no following bit was set in the current byte
-        // move to the next byte and start searching in the next bytes
-        map_current++;
+    /// @return whether the `other` map is this map or a copy sharing its bitmap.
+    [[nodiscard]] bool is_same_set(const SolvMap & other) const noexcept {
+        return this == &other || (!is_sparse() && map.map == other.map.map);
     }
 
-    while (map_current < map_end) {
-        // skip all empty bytes
-        if (!*map_current) {
-            // move to the next byte
-            map_current++;
-            continue;
+    /// Makes the map the only owner of the bitmap before it is modified, a shared bitmap is copied.
+    void make_bitmap_exclusive() {
+        if (bitmap.use_count() > 1) {
+            copy_shared_bitmap();
         }
+    }
+
+    /// Shares the bitmap of the `other` map or copies it if it can be modified directly.
+    void assign_bitmap(const SolvMap & other);
+
+    /// Takes the ownership of the bitmap just allocated in `map.map`.
+    void adopt_bitmap() const;
+
+    /// Releases the bitmap, the map is left without the bitmap and the sorted vector is used. `map.size` is kept.
+    void release_bitmap() noexcept;
+
+    void copy_shared_bitmap();
+    void grow_bitmap(int size);
+
+    // The bitmap, `map.map` is nullptr while the items are stored in `sparse_ids`. `map.size` (in bytes) is
+    // the range of the map in both representations. The members are mutable, `get_map()` converts them.
+    mutable Map map;
+
+    // The owner of the bitmap `map.map`, it is shared by the copies of the map
+    mutable std::shared_ptr<unsigned char> bitmap;
+
+    // Whether the map returned by `get_writable_map()` can modify the bitmap
+    bool writable_map_returned{false};
+
+    // The sorted items of a small set
+    mutable std::vector<Id> sparse_ids;
+};
+
+
+inline ConstMapIterator::ConstMapIterator(const SolvMap & solv_map) noexcept
+    : solv_map{&solv_map},
+      map{&solv_map.map},
+      map_end{solv_map.map.map + solv_map.map.size} {}
+
+
+inline bool ConstMapIterator::sync_map() noexcept {
+    if (solv_map == nullptr) {
+        return true;
+    }
+    if (solv_map->is_sparse()) {
+        return false;
+    }
+    map = &solv_map->map;
+    map_end = map->map + map->size;
+    return true;
+}
 
-        // now we have a byte that has at least one bit set
-        // return (current byte * 8) + bit position - 1
-        current_value = (static_cast<int>(map_current - map->map) << 3) + ffs(*map_current) - 1;
+
+inline ConstMapIterator & ConstMapIterator::operator++() noexcept {
+    if (current_value == END) {
         return *this;
     }
 
+    if (!sync_map()) {
+        // the next item in the sorted vector, BEGIN is smaller than any item
+        const auto & ids = solv_map->sparse_ids;
+        auto it = std::upper_bound(ids.begin(), ids.end(), current_value);
+        current_value = it == ids.end() ? END : *it;
+        return *this;
+    }
+
+    const unsigned char * bytes = map->map;
+    const auto size = static_cast<std::size_t>(map_end - bytes);
+
+    // the first item that can be returned
+    const auto next = current_value < 0 ? std::size_t{0} : static_cast<std::size_t>(current_value) + 1;
+    auto byte_idx = next >> 3;
+
+    auto found = [this](std::size_t item) { current_value = static_cast<Id>(item); };
+
+    if (byte_idx < size) {
+        // the rest of the byte containing the next item, previously seen bits are shifted out
+        unsigned int byte = bytes[byte_idx] >> (next & 7);
+        if (byte != 0) {
+            found(next + static_cast<std::size_t>(std::countr_zero(byte)));
+            return *this;
+        }
+        ++byte_idx;
+
+        // skip empty 64-bit words, the first set bit of a word is found by counting its trailing zeros
+        for (; byte_idx + sizeof(std::uint64_t) <= size; byte_idx += sizeof(std::uint64_t)) {
+            auto word = bitmap_load_word(bytes + byte_idx);
+            if (word != 0) {
+                found((byte_idx << 3) + static_cast<std::size_t>(std::countr_zero(word)));
+                return *this;
+            }
+        }
+
+        // the bytes at the end of the map that do not fill a whole word
+        for (; byte_idx < size; ++byte_idx) {
+            if (bytes[byte_idx] != 0) {
+                found((byte_idx << 3) + static_cast<std::size_t>(std::countr_zero(unsigned{bytes[byte_idx]})));
+                return *this;
+            }
+        }
+    }
+
     // not found
     current_value = END;
     return *this;
@@ -287,6 +533,13 @@ inline void ConstMapIterator::jump(Id id) noexcept {
         return;
     }
 
+    if (!sync_map()) {
+        const auto & ids = solv_map->sparse_ids;
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        current_value = it == ids.end() ? END : *it;
+        return;
+    }
+
     const unsigned char * current = map->map + (id >> 3);
 
     if (current >= map_end) {
@@ -295,7 +548,6 @@ inline void ConstMapIterator::jump(Id id) noexcept {
     }
 
     current_value = id;
-    map_current = current;
 
     // If the element with requested id does not exist in the map, it moves to the next.
     if (!(*current & (1 << (id & 7)))) {
@@ -304,25 +556,39 @@ inline void ConstMapIterator::jump(Id id) noexcept {
 }
 
 
-inline SolvMap & SolvMap::operator=(const SolvMap & other) noexcept {
+inline SolvMap::SolvMap(const SolvMap & other) : sparse_ids(other.sparse_ids) {
+    map.map = nullptr;
+    map.size = other.map.size;
+    if (!other.is_sparse()) {
+        assign_bitmap(other);
+    }
+}
+
+
+inline SolvMap & SolvMap::operator=(const SolvMap & other) {
     if (this != &other) {
-        if (map.size == other.map.size) {
-            memcpy(map.map, other.map.map, static_cast<size_t>(map.size));
+        if (other.is_sparse()) {
+            make_sparse(std::vector<Id>(other.sparse_ids));
+            map.size = other.map.size;
         } else {
-            map_free(&map);
-            map_init_clone(&map, &other.map);
+            release_bitmap();
+            sparse_ids.clear();
+            assign_bitmap(other);
         }
     }
     return *this;
 }
 
 
-inline SolvMap & SolvMap::operator=(SolvMap && other) noexcept {
+inline SolvMap & SolvMap::operator=(SolvMap && other) {
     if (this != &other) {
-        map_free(&map);
         map = other.map;
+        bitmap = std::move(other.bitmap);
+        writable_map_returned = other.writable_map_returned;
+        sparse_ids = std::move(other.sparse_ids);
         other.map.map = nullptr;
         other.map.size = 0;
+        other.sparse_ids.clear();
     }
     return *this;
 }
@@ -345,32 +611,35 @@ inline bool SolvMap::contains(Id id) const noexcept {
 
 
 inline bool SolvMap::empty() const noexcept {
-    const unsigned char * byte = map.map;
-    const unsigned char * end = byte + map.size;
+    if (is_sparse()) {
+        return sparse_ids.empty();
+    }
 
-    // iterate through the whole bitmap by moving the address
-    while (byte < end) {
-        if (*byte++) {
+    const auto size = static_cast<std::size_t>(map.size);
+    std::size_t byte_idx = 0;
+
+    // iterate through the whole bitmap a word at a time
+    for (; byte_idx + sizeof(std::uint64_t) <= size; byte_idx += sizeof(std::uint64_t)) {
+        if (bitmap_load_word(map.map + byte_idx) != 0) {
             // return false if a non-zero bit was found
             return false;
         }
     }
+    for (; byte_idx < size; ++byte_idx) {
+        if (map.map[byte_idx] != 0) {
+            return false;
+        }
+    }
     // all bits were zero, return true
     return true;
 }
 
 
 inline std::size_t SolvMap::size() const noexcept {
-    unsigned char * byte = map.map;
-    unsigned char * end = byte + map.size;
-    std::size_t result = 0;
-
-    // iterate through the whole bitmap by moving the address
-    while (byte < end) {
-        // add number of bits in each byte
-        result += BIT_COUNT_LOOKUP[*byte++];
+    if (is_sparse()) {
+        return sparse_ids.size();
     }
-    return result;
+    return bitmap_count(map.map, static_cast<std::size_t>(map.size));
 }
 
 }  // namespace libdnf5::solv
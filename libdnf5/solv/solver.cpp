@@ -61,7 +61,8 @@ void Solver::reset() {
     }
 }
 
-void Solver::write_debugdata(std::filesystem::path debug_dir, bool with_transaction) {
+void Solver::write_debugdata(
+    std::filesystem::path debug_dir, bool with_transaction, const DebugdataOptions & options) {
     solver_initialized_assert();
     std::error_code ec;
     std::filesystem::create_directories(debug_dir, ec);
@@ -78,6 +79,12 @@ void Solver::write_debugdata(std::filesystem::path debug_dir, bool with_transact
         const auto * libsolv_err_msg = ::pool_errstr(solver->pool);
         throw RuntimeError(M_("Writing debugsolver data into \"{}\" failed: {}"), debug_dir.native(), libsolv_err_msg);
     }
+    if (options.only_job_closure) {
+        auto closure = compute_job_closure(solver);
+        rewrite_testcase(solver->pool, debug_dir, &closure, options.zstd);
+    } else if (options.zstd) {
+        rewrite_testcase(solver->pool, debug_dir, nullptr, true);
+    }
 }
 
 int Solver::solve(IdQueue & job) {
@@ -149,4 +156,11 @@ IdQueue Solver::get_cleandeps() {
     return deps;
 }
 
+IdQueue Solver::get_decisionqueue() {
+    solver_initialized_assert();
+    IdQueue decisions;
+    ::solver_get_decisionqueue(solver, &decisions.get_queue());
+    return decisions;
+}
+
 }  // namespace libdnf5::solv
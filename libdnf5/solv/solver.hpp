@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF5_SOLV_SOLVER_HPP
 #define LIBDNF5_SOLV_SOLVER_HPP
 
+#include "debugdata.hpp"
 #include "id_queue.hpp"
 #include "pool.hpp"
 
@@ -64,7 +65,9 @@ public:
 
     /// Write solver debug data to given directory
     /// @param with_transaction Whether transaction data are dumped
-    void write_debugdata(std::filesystem::path debug_dir, bool with_transaction = true);
+    /// @param options Compression of the repositories and the packages that are dumped
+    void write_debugdata(
+        std::filesystem::path debug_dir, bool with_transaction = true, const DebugdataOptions & options = {});
 
     /// Wrap libsolv solver_solve() method
     /// @param job Solver job
@@ -98,6 +101,9 @@ public:
     /// Wrap libsolv solver_get_cleandeps() method
     IdQueue get_cleandeps();
 
+    /// Wrap libsolv solver_get_decisionqueue() method
+    IdQueue get_decisionqueue();
+
     /// Wrap libsolv problemruleinfo2str() method
     const char * problemruleinfo2str(SolverRuleinfo type, Id source, Id target, Id dep);
 
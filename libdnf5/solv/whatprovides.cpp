@@ -0,0 +1,190 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "whatprovides.hpp"
+
+extern "C" {
+#include <solv/dataiterator.h>
+#include <solv/queue.h>
+#include <solv/repo.h>
+}
+
+#include <algorithm>
+#include <utility>
+
+
+namespace libdnf5::solv {
+
+namespace {
+
+/// Returns true when the `dep`, including the parts of a rich dependency, names only the files in `file_deps`
+bool has_only_known_files(::Pool * pool, Id dep, const std::vector<Id> & file_deps) {
+    while (ISRELDEP(dep)) {
+        const Reldep * rd = GETRELDEP(pool, dep);
+        switch (rd->flags) {
+            case REL_AND:
+            case REL_OR:
+            case REL_WITH:
+            case REL_WITHOUT:
+            case REL_COND:
+            case REL_UNLESS:
+            case REL_ELSE:
+                if (!has_only_known_files(pool, rd->evr, file_deps)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+        dep = rd->name;
+    }
+    return *pool_id2str(pool, dep) != '/' || std::binary_search(file_deps.begin(), file_deps.end(), dep);
+}
+
+bool has_only_known_files(::Pool * pool, const Solvable * solvable, Offset deps, const std::vector<Id> & file_deps) {
+    if (deps == 0) {
+        return true;
+    }
+    for (const Id * dep = solvable->repo->idarraydata + deps; *dep != 0; ++dep) {
+        if (!has_only_known_files(pool, *dep, file_deps)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool provides_id(const Solvable * solvable, Id id) {
+    if (solvable->dep_provides == 0) {
+        return false;
+    }
+    for (const Id * dep = solvable->repo->idarraydata + solvable->dep_provides; *dep != 0; ++dep) {
+        if (*dep == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Mirrors `pool_installable_whatprovides()` of libsolv with the considered map unset
+bool is_indexed(const ::Pool * pool, Solvable * solvable) {
+    if (solvable->repo == pool->installed) {
+        return true;
+    }
+    return solvable->arch != ARCH_SRC && solvable->arch != ARCH_NOSRC && !pool_badarch_solvable(pool, solvable);
+}
+
+}  // namespace
+
+
+bool extend_whatprovides(::Pool * pool, Id first_new_solvable, const std::vector<Id> & file_deps) {
+    if (pool->whatprovides == nullptr || first_new_solvable < 2 || first_new_solvable > pool->nsolvables) {
+        return false;
+    }
+
+    // Nothing is modified before all new solvables are checked
+    for (Id id = first_new_solvable; id < pool->nsolvables; ++id) {
+        const Solvable * solvable = pool->solvables + id;
+        if (solvable->repo == nullptr) {
+            continue;
+        }
+        for (Offset deps :
+             {solvable->dep_requires,
+              solvable->dep_conflicts,
+              solvable->dep_obsoletes,
+              solvable->dep_recommends,
+              solvable->dep_suggests,
+              solvable->dep_supplements,
+              solvable->dep_enhances}) {
+            if (!has_only_known_files(pool, solvable, deps, file_deps)) {
+                return false;
+            }
+        }
+    }
+
+    // Pairs of the provided name and the providing solvable
+    std::vector<std::pair<Id, Id>> new_providers;
+    Queue file_provides;
+    queue_init(&file_provides);
+    for (Id id = first_new_solvable; id < pool->nsolvables; ++id) {
+        Solvable * solvable = pool->solvables + id;
+        if (solvable->repo == nullptr) {
+            continue;
+        }
+
+        // The files of the file list that other solvables depend on are added to the provides
+        queue_empty(&file_provides);
+        Dataiterator di;
+        dataiterator_init(
+            &di, pool, solvable->repo, id, SOLVABLE_FILELIST, nullptr, SEARCH_FILES | SEARCH_COMPLETE_FILELIST);
+        while (dataiterator_step(&di) != 0) {
+            Id file_id = pool_str2id(pool, di.kv.str, 0);
+            if (file_id != 0 && std::binary_search(file_deps.begin(), file_deps.end(), file_id)) {
+                queue_pushunique(&file_provides, file_id);
+            }
+        }
+        dataiterator_free(&di);
+        for (int idx = 0; idx < file_provides.count; ++idx) {
+            Id file_id = file_provides.elements[idx];
+            if (!provides_id(solvable, file_id)) {
+                solvable->dep_provides =
+                    repo_addid_dep(solvable->repo, solvable->dep_provides, file_id, SOLVABLE_FILEMARKER);
+            }
+        }
+
+        if (!is_indexed(pool, solvable) || solvable->dep_provides == 0) {
+            continue;
+        }
+        for (const Id * dep = solvable->repo->idarraydata + solvable->dep_provides; *dep != 0; ++dep) {
+            Id name = *dep;
+            while (ISRELDEP(name)) {
+                name = GETRELDEP(pool, name)->name;
+            }
+            new_providers.emplace_back(name, id);
+        }
+    }
+    queue_free(&file_provides);
+
+    // The providers of each name are ordered by the solvable Ids, the new solvables follow the old ones
+    std::sort(new_providers.begin(), new_providers.end());
+    new_providers.erase(std::unique(new_providers.begin(), new_providers.end()), new_providers.end());
+
+    Queue providers;
+    queue_init(&providers);
+    for (auto it = new_providers.begin(); it != new_providers.end();) {
+        const Id name = it->first;
+        queue_empty(&providers);
+        // Not `pool_whatprovides()`, it would search the file lists, including the new solvables, for a file
+        // that has no providers yet
+        if (const Offset old_providers = pool->whatprovides[name]; old_providers != 0) {
+            for (const Id * old = pool->whatprovidesdata + old_providers; *old != 0; ++old) {
+                queue_push(&providers, *old);
+            }
+        }
+        for (; it != new_providers.end() && it->first == name; ++it) {
+            queue_push(&providers, it->second);
+        }
+        // also invalidates the cached providers of the relations using the name
+        pool_set_whatprovides(pool, name, pool_queuetowhatprovides(pool, &providers));
+    }
+    queue_free(&providers);
+
+    return true;
+}
+
+}  // namespace libdnf5::solv
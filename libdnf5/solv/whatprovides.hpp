@@ -0,0 +1,49 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_SOLV_WHATPROVIDES_HPP
+#define LIBDNF5_SOLV_WHATPROVIDES_HPP
+
+extern "C" {
+#include <solv/pool.h>
+}
+
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Adds the solvables appended to the `pool` since its whatprovides index was created by `pool_createwhatprovides()`
+/// to the index, so that adding a few packages (e.g. from the command line) does not recompute the index
+/// of the whole pool. The solvables `[first_new_solvable, pool->nsolvables)` are added, the index must not
+/// contain them yet and must still be allocated (`repo_create()`, for example, frees it).
+///
+/// `file_deps` are the sorted Ids of the file dependencies found by the last `pool_addfileprovides_queue()`.
+/// The new solvables providing them in their file lists get the file provides, as `pool_addfileprovides_queue()`
+/// would add them. When a new solvable depends on a file that is not in `file_deps`, the file lists of the other
+/// solvables would have to be searched again, nothing is changed and `false` is returned. The caller then has to
+/// recompute the whole index.
+///
+/// The index is extended as if the considered map was not set, the repositories of the new solvables have
+/// to be internalized.
+bool extend_whatprovides(::Pool * pool, Id first_new_solvable, const std::vector<Id> & file_deps);
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_WHATPROVIDES_HPP
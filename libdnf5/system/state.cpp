@@ -27,6 +27,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/comps/group/package.hpp>
 #include <toml.hpp>
 
+#include <algorithm>
+#include <optional>
+#include <string_view>
+
 
 namespace toml {
 
@@ -204,6 +208,34 @@ struct into<libdnf5::system::SystemState> {
     }
 };
 
+
+template <>
+struct from<libdnf5::system::RunningKernelState> {
+    static libdnf5::system::RunningKernelState from_toml(const value & v) {
+        libdnf5::system::RunningKernelState running_kernel_state;
+
+        running_kernel_state.uname_release = toml::find<std::string>(v, "uname_release");
+        running_kernel_state.rpmdb_cookie = toml::find<std::string>(v, "rpmdb_cookie");
+        running_kernel_state.nevra = toml::find<std::string>(v, "nevra");
+
+        return running_kernel_state;
+    }
+};
+
+
+template <>
+struct into<libdnf5::system::RunningKernelState> {
+    static toml::value into_toml(const libdnf5::system::RunningKernelState & running_kernel_state) {
+        toml::value res;
+
+        res["uname_release"] = running_kernel_state.uname_release;
+        res["rpmdb_cookie"] = running_kernel_state.rpmdb_cookie;
+        res["nevra"] = running_kernel_state.nevra;
+
+        return res;
+    }
+};
+
 }  // namespace toml
 
 
@@ -212,6 +244,8 @@ namespace libdnf5::system {
 const constexpr uint8_t version_major{1};
 const constexpr uint8_t version_minor{0};
 
+constexpr std::string_view SNAPSHOT_MAGIC{"libdnf5 state snapshot 1\n"};
+
 
 static std::string make_version() {
     return fmt::format("{}.{}", version_major, version_minor);
@@ -237,6 +271,58 @@ static std::pair<uint64_t, uint64_t> parse_version(const std::string & version)
 }
 
 
+void PackageGroupsIndex::add_group(const std::string & group_id, const std::vector<std::string> & packages) {
+    auto group_index = intern(group_id);
+    for (const auto & name : packages) {
+        auto & groups = package_groups[name];
+        if (std::find(groups.begin(), groups.end(), group_index) == groups.end()) {
+            groups.push_back(group_index);
+        }
+    }
+}
+
+
+void PackageGroupsIndex::remove_group(const std::string & group_id, const std::vector<std::string> & packages) {
+    auto group_it = group_id_indexes.find(group_id);
+    if (group_it == group_id_indexes.end()) {
+        return;
+    }
+    for (const auto & name : packages) {
+        auto it = package_groups.find(name);
+        if (it == package_groups.end()) {
+            continue;
+        }
+        auto & groups = it->second;
+        groups.erase(std::remove(groups.begin(), groups.end(), group_it->second), groups.end());
+        // only the packages of some group are kept, so that contains() can be used to test the group membership
+        if (groups.empty()) {
+            package_groups.erase(it);
+        }
+    }
+}
+
+
+std::set<std::string> PackageGroupsIndex::get_groups(const std::string & name) const {
+    std::set<std::string> result;
+    auto it = package_groups.find(name);
+    if (it != package_groups.end()) {
+        for (auto group_index : it->second) {
+            result.emplace(group_ids[group_index]);
+        }
+    }
+    return result;
+}
+
+
+uint32_t PackageGroupsIndex::intern(const std::string & group_id) {
+    auto [it, inserted] = group_id_indexes.try_emplace(group_id, static_cast<uint32_t>(group_ids.size()));
+    if (inserted) {
+        group_ids.push_back(group_id);
+    }
+    return it->second;
+}
+
+
 StateNotFoundError::StateNotFoundError(const std::string & type, const std::string & key)
     : libdnf5::Error(M_("{} state for \"{}\" not found."), type, key) {}
 
@@ -249,12 +335,13 @@ State::State(const std::filesystem::path & path) : path(path) {
 bool State::packages_import_required() {
     // TODO(mblaha) - detect by absence of toml file instead of empty nevra_states?
     // Because even empty nevra_states is a valid state.
-    return nevra_states.empty();
+    return loaded_nevra_states().empty();
 }
 
 
 transaction::TransactionItemReason State::get_package_reason(const std::string & na) {
     transaction::TransactionItemReason packages_reason = transaction::TransactionItemReason::NONE;
+    auto & package_states = loaded_package_states();
     auto it = package_states.find(na);
     if (it != package_states.end()) {
         // TODO(lukash) this allows more reasons than valid here, assert?
@@ -269,7 +356,7 @@ transaction::TransactionItemReason State::get_package_reason(const std::string &
         if (dot_pos != name.npos) {
             name = name.substr(0, dot_pos);
         }
-        if (get_package_groups_cache().contains(name)) {
+        if (get_package_groups_index().contains(name)) {
             return transaction::TransactionItemReason::GROUP;
         }
     }
@@ -288,15 +375,20 @@ void State::set_package_reason(const std::string & na, transaction::TransactionI
         "Unexpected system state package reason: \"{}\"",
         reason_str);
 
-    package_states[na].reason = reason_str;
+    auto & package_state = loaded_package_states()[na];
+    if (package_state.reason == reason_str) {
+        return;
+    }
+    package_state.reason = reason_str;
+    dirty_files |= PACKAGES_FILE;
+    ++package_reasons_generation;
 }
 
 
 std::set<std::string> State::get_packages_by_reason(const std::set<transaction::TransactionItemReason> & reasons) {
     std::set<std::string> packages;
     if (reasons.contains(transaction::TransactionItemReason::GROUP)) {
-        auto & package_groups = get_package_groups_cache();
-        for (const auto & pkg : package_groups) {
+        for (const auto & pkg : get_package_groups_index().get_package_groups()) {
             packages.emplace(pkg.first);
         }
     }
@@ -304,7 +396,7 @@ std::set<std::string> State::get_packages_by_reason(const std::set<transaction::
     for (const auto & reason : reasons) {
         reasons_str.emplace(transaction::transaction_item_reason_to_string(reason));
     }
-    for (const auto & [na, pkg_state] : package_states) {
+    for (const auto & [na, pkg_state] : loaded_package_states()) {
         if (reasons_str.contains(pkg_state.reason)) {
             packages.emplace(na);
         }
@@ -314,11 +406,15 @@ std::set<std::string> State::get_packages_by_reason(const std::set<transaction::
 
 
 void State::remove_package_na_state(const std::string & na) {
-    package_states.erase(na);
+    if (loaded_package_states().erase(na) > 0) {
+        dirty_files |= PACKAGES_FILE;
+        ++package_reasons_generation;
+    }
 }
 
 
 std::string State::get_package_from_repo(const std::string & nevra) {
+    auto & nevra_states = loaded_nevra_states();
     auto it = nevra_states.find(nevra);
     if (it == nevra_states.end()) {
         throw StateNotFoundError("NEVRA", nevra);
@@ -329,12 +425,18 @@ std::string State::get_package_from_repo(const std::string & nevra) {
 
 
 void State::set_package_from_repo(const std::string & nevra, const std::string & from_repo) {
-    nevra_states[nevra].from_repo = from_repo;
+    auto [it, inserted] = loaded_nevra_states().try_emplace(nevra);
+    if (!inserted && it->second.from_repo == from_repo) {
+        return;
+    }
+    it->second.from_repo = from_repo;
+    dirty_files |= NEVRAS_FILE;
 }
 
-
 void State::remove_package_nevra_state(const std::string & nevra) {
-    nevra_states.erase(nevra);
+    if (loaded_nevra_states().erase(nevra) > 0) {
+        dirty_files |= NEVRAS_FILE;
+    }
 }
 
 
@@ -349,14 +451,30 @@ GroupState State::get_group_state(const std::string & id) {
 
 
 void State::set_group_state(const std::string & id, const GroupState & group_state) {
-    group_states[id] = group_state;
-    package_groups_cache.reset();
+    auto [it, inserted] = group_states.try_emplace(id);
+    if (package_groups_index) {
+        if (!inserted) {
+            package_groups_index->remove_group(id, it->second.packages);
+        }
+        package_groups_index->add_group(id, group_state.packages);
+    }
+    it->second = group_state;
+    dirty_files |= GROUPS_FILE;
+    ++package_reasons_generation;
 }
 
 
 void State::remove_group_state(const std::string & id) {
-    group_states.erase(id);
-    package_groups_cache.reset();
+    auto it = group_states.find(id);
+    if (it == group_states.end()) {
+        return;
+    }
+    if (package_groups_index) {
+        package_groups_index->remove_group(id, it->second.packages);
+    }
+    group_states.erase(it);
+    dirty_files |= GROUPS_FILE;
+    ++package_reasons_generation;
 }
 
 
@@ -372,22 +490,18 @@ EnvironmentState State::get_environment_state(const std::string & id) {
 
 void State::set_environment_state(const std::string & id, const EnvironmentState & environment_state) {
     environment_states[id] = environment_state;
+    dirty_files |= ENVIRONMENTS_FILE;
 }
 
 
 void State::remove_environment_state(const std::string & id) {
     environment_states.erase(id);
+    dirty_files |= ENVIRONMENTS_FILE;
 }
 
 
 std::set<std::string> State::get_package_groups(const std::string & name) {
-    auto & package_groups = get_package_groups_cache();
-    auto it = package_groups.find(name);
-    if (it == package_groups.end()) {
-        return {};
-    } else {
-        return it->second;
-    }
+    return get_package_groups_index().get_groups(name);
 }
 
 
@@ -439,11 +553,13 @@ ModuleState State::get_module_state(const std::string & name) {
 
 void State::set_module_state(const std::string & name, const ModuleState & module_state) {
     module_states[name] = module_state;
+    dirty_files |= MODULES_FILE;
 }
 
 
 void State::remove_module_state(const std::string & name) {
     module_states.erase(name);
+    dirty_files |= MODULES_FILE;
 }
 
 
@@ -453,7 +569,125 @@ std::string State::get_rpmdb_cookie() const {
 
 
 void State::set_rpmdb_cookie(const std::string & cookie) {
-    system_state.rpmdb_cookie = cookie;
+    if (system_state.rpmdb_cookie != cookie) {
+        system_state.rpmdb_cookie = cookie;
+        dirty_files |= SYSTEM_FILE;
+    }
+}
+
+
+/// Returns the path of the binary snapshot of the toml file at `toml_path`
+static std::filesystem::path get_snapshot_path(const std::filesystem::path & toml_path) {
+    return toml_path.string() + ".snapshot";
+}
+
+
+/// Returns the header of the snapshot of the toml file at `toml_path`, the snapshot is valid only for the same
+/// modification time and size of the toml file
+static std::string make_snapshot_header(const std::filesystem::path & toml_path) {
+    return fmt::format(
+        "{}{} {}\n",
+        SNAPSHOT_MAGIC,
+        std::filesystem::last_write_time(toml_path).time_since_epoch().count(),
+        std::filesystem::file_size(toml_path));
+}
+
+
+static void append_snapshot_string(std::string & data, std::string_view str) {
+    auto size = static_cast<uint32_t>(str.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        data.push_back(static_cast<char>((size >> shift) & 0xff));
+    }
+    data.append(str);
+}
+
+
+static bool read_snapshot_string(std::string_view & data, std::string & str) {
+    if (data.size() < 4) {
+        return false;
+    }
+    uint32_t size = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        size |= static_cast<uint32_t>(static_cast<unsigned char>(data[0])) << shift;
+        data.remove_prefix(1);
+    }
+    if (data.size() < size) {
+        return false;
+    }
+    str.assign(data.substr(0, size));
+    data.remove_prefix(size);
+    return true;
+}
+
+
+/// Writes the snapshot of the `states` loaded from the toml file at `toml_path`. The values of the map have
+/// a single string member `field`.
+template <typename T>
+static void write_snapshot(
+    const std::filesystem::path & toml_path, const std::map<std::string, T> & states, std::string T::*field) {
+    try {
+        auto data = make_snapshot_header(toml_path);
+        for (const auto & [key, state] : states) {
+            append_snapshot_string(data, key);
+            append_snapshot_string(data, state.*field);
+        }
+        auto snapshot_path = get_snapshot_path(toml_path);
+        auto temporary_path = snapshot_path.string() + ".temp";
+        utils::fs::File(temporary_path, "w").write(data);
+        std::filesystem::rename(temporary_path, snapshot_path);
+    } catch (const std::exception &) {
+        // the snapshot is only a cache, a user without write access to the state keeps parsing the toml file
+    }
+}
+
+
+/// Reads the snapshot of the toml file at `toml_path`, returns `std::nullopt` when the snapshot is missing,
+/// damaged or made from another version of the toml file
+template <typename T>
+static std::optional<std::map<std::string, T>> read_snapshot(
+    const std::filesystem::path & toml_path, std::string T::*field) {
+    std::string data;
+    try {
+        auto snapshot_path = get_snapshot_path(toml_path);
+        if (!std::filesystem::exists(snapshot_path)) {
+            return std::nullopt;
+        }
+        data = utils::fs::File(snapshot_path, "r").read();
+        if (!data.starts_with(make_snapshot_header(toml_path))) {
+            return std::nullopt;
+        }
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+
+    std::string_view input{data};
+    input.remove_prefix(input.find('\n', SNAPSHOT_MAGIC.size()) + 1);
+    std::map<std::string, T> states;
+    std::string key;
+    T state;
+    while (!input.empty()) {
+        if (!read_snapshot_string(input, key) || !read_snapshot_string(input, state.*field)) {
+            return std::nullopt;
+        }
+        states.emplace_hint(states.end(), key, state);
+    }
+    return states;
+}
+
+
+/// Returns whether the snapshot of the toml file at `toml_path` exists and was made from its current version.
+/// Only the header of the snapshot is read.
+static bool is_snapshot_current(const std::filesystem::path & toml_path) {
+    try {
+        auto snapshot_path = get_snapshot_path(toml_path);
+        if (!std::filesystem::exists(toml_path) || !std::filesystem::exists(snapshot_path)) {
+            return false;
+        }
+        auto header = make_snapshot_header(toml_path);
+        return utils::fs::File(snapshot_path, "r").read(header.size()) == header;
+    } catch (const std::exception &) {
+        return false;
+    }
 }
 
 
@@ -468,16 +702,51 @@ static std::string toml_format(const toml::value & value) {
 }
 
 
+/// Writes the `value` to the toml file at `path`, a reader of the file sees either the old or the new contents
+template <typename T>
+static void write_toml_file(const std::filesystem::path & path, const std::string & key, const T & value) {
+    // write new contents to a temporary file and then move the new file atomically
+    auto temporary_path = path.string() + ".temp";
+    utils::fs::File(temporary_path, "w").write(toml_format(make_top_value(key, value)));
+    std::filesystem::rename(temporary_path, path);
+}
+
+
 void State::save() {
+    if (dirty_files == 0) {
+        return;
+    }
+
     std::filesystem::create_directories(path);
 
-    utils::fs::File(get_package_state_path(), "w").write(toml_format(make_top_value("packages", package_states)));
-    utils::fs::File(get_nevra_state_path(), "w").write(toml_format(make_top_value("nevras", nevra_states)));
-    utils::fs::File(get_group_state_path(), "w").write(toml_format(make_top_value("groups", group_states)));
-    utils::fs::File(get_environment_state_path(), "w")
-        .write(toml_format(make_top_value("environments", environment_states)));
-    utils::fs::File(get_module_state_path(), "w").write(toml_format(make_top_value("modules", module_states)));
-    utils::fs::File(get_system_state_path(), "w").write(toml_format(make_top_value("system", system_state)));
+    // the flag of a file is cleared once it is written, a failed save is completed by the next one
+    if (dirty_files & PACKAGES_FILE) {
+        write_toml_file(get_package_state_path(), "packages", loaded_package_states());
+        // the snapshot of the file is written only when the file is, never by a read-only command
+        write_snapshot(get_package_state_path(), package_states, &PackageState::reason);
+        dirty_files &= static_cast<uint8_t>(~PACKAGES_FILE);
+    }
+    if (dirty_files & NEVRAS_FILE) {
+        write_toml_file(get_nevra_state_path(), "nevras", loaded_nevra_states());
+        write_snapshot(get_nevra_state_path(), nevra_states, &NevraState::from_repo);
+        dirty_files &= static_cast<uint8_t>(~NEVRAS_FILE);
+    }
+    if (dirty_files & GROUPS_FILE) {
+        write_toml_file(get_group_state_path(), "groups", group_states);
+        dirty_files &= static_cast<uint8_t>(~GROUPS_FILE);
+    }
+    if (dirty_files & ENVIRONMENTS_FILE) {
+        write_toml_file(get_environment_state_path(), "environments", environment_states);
+        dirty_files &= static_cast<uint8_t>(~ENVIRONMENTS_FILE);
+    }
+    if (dirty_files & MODULES_FILE) {
+        write_toml_file(get_module_state_path(), "modules", module_states);
+        dirty_files &= static_cast<uint8_t>(~MODULES_FILE);
+    }
+    if (dirty_files & SYSTEM_FILE) {
+        write_toml_file(get_system_state_path(), "system", system_state);
+        dirty_files &= static_cast<uint8_t>(~SYSTEM_FILE);
+    }
 }
 
 
@@ -503,28 +772,102 @@ static T load_toml_data(const std::string & path, const std::string & key) {
 }
 
 
+/// Loads the map from the toml file at `path`, using its snapshot when it is up to date. The snapshot is not
+/// written here, the load is also done by read-only commands.
+template <typename T>
+static std::map<std::string, T> load_toml_map_with_snapshot(
+    const std::filesystem::path & path, const std::string & key, std::string T::*field) {
+    if (auto snapshot = read_snapshot(path, field)) {
+        return std::move(*snapshot);
+    }
+    return load_toml_data<std::map<std::string, T>>(path, key);
+}
+
+
+std::map<std::string, PackageState> & State::loaded_package_states() {
+    if (!(loaded_files & PACKAGES_FILE)) {
+        package_states = load_toml_map_with_snapshot(get_package_state_path(), "packages", &PackageState::reason);
+        loaded_files |= PACKAGES_FILE;
+    }
+    return package_states;
+}
+
+
+std::map<std::string, NevraState> & State::loaded_nevra_states() {
+    if (!(loaded_files & NEVRAS_FILE)) {
+        nevra_states = load_toml_map_with_snapshot(get_nevra_state_path(), "nevras", &NevraState::from_repo);
+        loaded_files |= NEVRAS_FILE;
+    }
+    return nevra_states;
+}
+
+
+std::string State::get_running_kernel_nevra(const std::string & uname_release, const std::string & rpmdb_cookie) {
+    if (!running_kernel_state) {
+        running_kernel_state = load_toml_data<RunningKernelState>(get_running_kernel_state_path(), "running_kernel");
+    }
+    if (running_kernel_state->uname_release != uname_release || running_kernel_state->rpmdb_cookie != rpmdb_cookie) {
+        return {};
+    }
+    return running_kernel_state->nevra;
+}
+
+
+void State::set_running_kernel_nevra(
+    const std::string & uname_release, const std::string & rpmdb_cookie, const std::string & nevra) {
+    running_kernel_state = RunningKernelState{uname_release, rpmdb_cookie, nevra};
+    std::filesystem::create_directories(path);
+    write_toml_file(get_running_kernel_state_path(), "running_kernel", *running_kernel_state);
+}
+
+
 void State::load() {
-    package_states = load_toml_data<std::map<std::string, PackageState>>(get_package_state_path(), "packages");
-    nevra_states = load_toml_data<std::map<std::string, NevraState>>(get_nevra_state_path(), "nevras");
+    // The packages and nevras files with an up to date snapshot were validated when the snapshot was written,
+    // they are read from the snapshot on the first access to their data. The other files are parsed here,
+    // a damaged file or a file of an unsupported version is reported by the load.
+    loaded_files = 0;
+    if (!is_snapshot_current(get_package_state_path())) {
+        package_states = load_toml_data<std::map<std::string, PackageState>>(get_package_state_path(), "packages");
+        loaded_files |= PACKAGES_FILE;
+    }
+    if (!is_snapshot_current(get_nevra_state_path())) {
+        nevra_states = load_toml_data<std::map<std::string, NevraState>>(get_nevra_state_path(), "nevras");
+        loaded_files |= NEVRAS_FILE;
+    }
     group_states = load_toml_data<std::map<std::string, GroupState>>(get_group_state_path(), "groups");
     environment_states =
         load_toml_data<std::map<std::string, EnvironmentState>>(get_environment_state_path(), "environments");
     module_states = load_toml_data<std::map<std::string, ModuleState>>(get_module_state_path(), "modules");
     system_state = load_toml_data<SystemState>(get_system_state_path(), "system");
-    package_groups_cache.reset();
+    running_kernel_state.reset();
+
+    // the missing files are created by the next save
+    dirty_files = 0;
+    for (auto [file_path, flag] : {
+             std::pair{get_package_state_path(), PACKAGES_FILE},
+             std::pair{get_nevra_state_path(), NEVRAS_FILE},
+             std::pair{get_group_state_path(), GROUPS_FILE},
+             std::pair{get_environment_state_path(), ENVIRONMENTS_FILE},
+             std::pair{get_module_state_path(), MODULES_FILE},
+             std::pair{get_system_state_path(), SYSTEM_FILE}}) {
+        if (!std::filesystem::exists(file_path)) {
+            dirty_files |= flag;
+        }
+    }
+
+    package_groups_index.reset();
+    ++package_reasons_generation;
 }
 
-const std::map<std::string, std::set<std::string>> & State::get_package_groups_cache() {
-    if (!package_groups_cache) {
-        std::map<std::string, std::set<std::string>> cache;
+
+const PackageGroupsIndex & State::get_package_groups_index() {
+    if (!package_groups_index) {
+        auto & index = package_groups_index.emplace();
         for (const auto & [group_id, group_state] : group_states) {
-            for (const auto & pkg : group_state.packages) {
-                cache[pkg].emplace(group_id);
-            }
+            index.add_group(group_id, group_state.packages);
         }
-        package_groups_cache.emplace(std::move(cache));
     }
-    return package_groups_cache.value();
+    return *package_groups_index;
 }
 
 
@@ -533,35 +876,50 @@ std::filesystem::path State::get_group_xml_dir() {
 }
 
 
-std::filesystem::path State::get_package_state_path() {
+std::filesystem::path State::get_system_repo_cache_path(bool with_changelogs) {
+    return path / (with_changelogs ? "system_repo-changelogs.solv" : "system_repo.solv");
+}
+
+
+std::filesystem::path State::get_system_comps_cache_path() {
+    return path / "system_comps.solv";
+}
+
+
+std::filesystem::path State::get_package_state_path() const {
     return path / "packages.toml";
 }
 
 
-std::filesystem::path State::get_nevra_state_path() {
+std::filesystem::path State::get_nevra_state_path() const {
     return path / "nevras.toml";
 }
 
 
-std::filesystem::path State::get_group_state_path() {
+std::filesystem::path State::get_group_state_path() const {
     return path / "groups.toml";
 }
 
 
-std::filesystem::path State::get_environment_state_path() {
+std::filesystem::path State::get_environment_state_path() const {
     return path / "environments.toml";
 }
 
 
-std::filesystem::path State::get_module_state_path() {
+std::filesystem::path State::get_module_state_path() const {
     return path / "modules.toml";
 }
 
 
-std::filesystem::path State::get_system_state_path() {
+std::filesystem::path State::get_system_state_path() const {
     return path / "system.toml";
 }
 
+
+std::filesystem::path State::get_running_kernel_state_path() const {
+    return path / "running_kernel.toml";
+}
+
 void State::reset_packages_states(
     std::map<std::string, libdnf5::system::PackageState> && package_states,
     std::map<std::string, libdnf5::system::NevraState> && nevra_states,
@@ -571,6 +929,10 @@ void State::reset_packages_states(
     this->nevra_states = std::move(nevra_states);
     this->group_states = std::move(group_states);
     this->environment_states = std::move(environment_states);
+    loaded_files |= PACKAGES_FILE | NEVRAS_FILE;
+    dirty_files |= PACKAGES_FILE | NEVRAS_FILE | GROUPS_FILE | ENVIRONMENTS_FILE;
+    package_groups_index.reset();
+    ++package_reasons_generation;
 
     // Try to save the new system state.
     // dnf can be used without root priviledges or with read-only system state location.
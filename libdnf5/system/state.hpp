@@ -27,11 +27,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/rpm/package.hpp"
 #include "libdnf5/transaction/transaction_item_reason.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -72,6 +74,15 @@ public:
     std::string rpmdb_cookie;
 };
 
+class RunningKernelState {
+public:
+    /// The release of the running kernel reported by `uname`
+    std::string uname_release;
+    /// The rpmdb cookie of the installed packages the kernel package was found in
+    std::string rpmdb_cookie;
+    std::string nevra;
+};
+
 
 class StateNotFoundError : public libdnf5::Error {
 public:
@@ -100,6 +111,36 @@ public:
 };
 
 
+/// Inverted index of the packages of the installed groups: package name -> the groups containing the package.
+/// The group ids are interned, the index is updated incrementally with the changes of the group states.
+class PackageGroupsIndex {
+public:
+    /// Adds the group `group_id` to the groups of its `packages`.
+    void add_group(const std::string & group_id, const std::vector<std::string> & packages);
+
+    /// Removes the group `group_id` from the groups of its `packages`.
+    void remove_group(const std::string & group_id, const std::vector<std::string> & packages);
+
+    /// @return Whether the package `name` is part of an installed group.
+    bool contains(const std::string & name) const { return package_groups.contains(name); }
+
+    /// @return The ids of the installed groups the package `name` is part of.
+    std::set<std::string> get_groups(const std::string & name) const;
+
+    /// @return The map {package name -> [interned ids of the groups containing the package]}.
+    const std::unordered_map<std::string, std::vector<uint32_t>> & get_package_groups() const noexcept {
+        return package_groups;
+    }
+
+private:
+    uint32_t intern(const std::string & group_id);
+
+    std::unordered_map<std::string, uint32_t> group_id_indexes;
+    std::vector<std::string> group_ids;
+    std::unordered_map<std::string, std::vector<uint32_t>> package_groups;
+};
+
+
 /// A class providing information and allowing modification of the DNF system
 /// state. The state consists of a list of userinstalled packages, installed
 /// groups and their packages etc.
@@ -132,6 +173,10 @@ public:
     /// @since 5.0
     void remove_package_na_state(const std::string & na);
 
+    /// @return The generation of the package reasons. It is incremented whenever a change of the package
+    /// or group states can change the reason of a package, results derived from the reasons can be cached with it.
+    uint64_t get_package_reasons_generation() const noexcept { return package_reasons_generation; }
+
     /// @return The repository from which a package NEVRA was installed.
     /// @param nevra The NEVRA to get the repository for.
     /// @since 5.0
@@ -160,6 +205,13 @@ public:
     /// @since 5.0
     std::filesystem::path get_group_xml_dir();
 
+    /// @return The path to the libsolv cache file of the system repository.
+    /// @param with_changelogs Whether the path of the cache containing the changelogs of the packages is requested.
+    std::filesystem::path get_system_repo_cache_path(bool with_changelogs);
+
+    /// @return The path to the libsolv cache file of the installed groups and environments.
+    std::filesystem::path get_system_comps_cache_path();
+
     /// @return The state for a group id.
     /// @param id The group id to get the state for.
     /// @since 5.0
@@ -228,7 +280,20 @@ public:
     /// @since 5.0
     void set_rpmdb_cookie(const std::string & cookie);
 
+    /// @return The NEVRA of the package of the running kernel recorded for the `uname_release` of the kernel and
+    /// the `rpmdb_cookie` of the installed packages, an empty string if there is no such record.
+    /// @since 5.1.3
+    std::string get_running_kernel_nevra(const std::string & uname_release, const std::string & rpmdb_cookie);
+
+    /// Records the `nevra` of the package of the running kernel for the `uname_release` of the kernel and
+    /// the `rpmdb_cookie` of the installed packages. The record is written to its own toml file immediately,
+    /// it does not wait for `save()` and it does not touch the other files of the state.
+    /// @since 5.1.3
+    void set_running_kernel_nevra(
+        const std::string & uname_release, const std::string & rpmdb_cookie, const std::string & nevra);
+
     /// Saves the system state to the filesystem path specified in constructor.
+    /// Only the files whose data changed since they were loaded or saved are rewritten, each one atomically.
     /// @since 5.0
     void save();
 
@@ -243,7 +308,10 @@ private:
     /// Reset modules states to match given new values.
     /// @param new_states New values for modules states.
     /// @since 5.0
-    void reset_module_states(std::map<std::string, ModuleState> new_states) { module_states = new_states; }
+    void reset_module_states(std::map<std::string, ModuleState> new_states) {
+        module_states = new_states;
+        dirty_files |= MODULES_FILE;
+    }
 
     /// Reset packages system state to match given values.
     /// @param installed_packages Vector of tuples <rpm::Nevra nevra, TransactionItemReason reason, std::string repository_id> of currently installed packages
@@ -257,37 +325,47 @@ private:
         std::map<std::string, libdnf5::system::EnvironmentState> && environment_states);
 
     /// Loads the system state from the filesystem path given in constructor.
+    /// The large packages and nevras files with up to date binary snapshots are read lazily from the snapshots,
+    /// the other toml files are parsed immediately.
     /// @since 5.0
     void load();
 
+    /// Accessors of the packages and nevras data, which are read from their snapshots on the first access.
+    std::map<std::string, PackageState> & loaded_package_states();
+    std::map<std::string, NevraState> & loaded_nevra_states();
+
     /// @return The path to the toml file containing the list of userinstalled packages.
     /// @since 5.0
-    std::filesystem::path get_package_state_path();
+    std::filesystem::path get_package_state_path() const;
 
     /// @return The path to the toml file containing the per-nevra data.
     /// @since 5.0
-    std::filesystem::path get_nevra_state_path();
+    std::filesystem::path get_nevra_state_path() const;
 
     /// @return The path to the toml file containing the group data.
     /// @since 5.0
-    std::filesystem::path get_group_state_path();
+    std::filesystem::path get_group_state_path() const;
 
     /// @return The path to the toml file containing the environment data.
     /// @since 5.0
-    std::filesystem::path get_environment_state_path();
+    std::filesystem::path get_environment_state_path() const;
 
     /// @return The path to the toml file containing the module data.
     /// @since 5.0
-    std::filesystem::path get_module_state_path();
+    std::filesystem::path get_module_state_path() const;
 
     /// @return The path to the toml file containing the system data.
     /// @since 5.0
-    std::filesystem::path get_system_state_path();
+    std::filesystem::path get_system_state_path() const;
+
+    /// @return The path to the toml file containing the record of the running kernel package.
+    /// @since 5.1.3
+    std::filesystem::path get_running_kernel_state_path() const;
 
-    /// Cache to speed-up searching the group packages in group_states map
-    /// @return The map {package_name -> [id of groups the package_name is part of]}
+    /// Index to speed-up searching the group packages in group_states map, built on the first use
+    /// @return The index {package_name -> [id of groups the package_name is part of]}
     /// @since 5.0
-    const std::map<std::string, std::set<std::string>> & get_package_groups_cache();
+    const PackageGroupsIndex & get_package_groups_index();
 
     std::filesystem::path path;
 
@@ -297,7 +375,23 @@ private:
     std::map<std::string, EnvironmentState> environment_states;
     std::map<std::string, ModuleState> module_states;
     SystemState system_state;
-    std::optional<std::map<std::string, std::set<std::string>>> package_groups_cache;
+    std::optional<RunningKernelState> running_kernel_state;
+    std::optional<PackageGroupsIndex> package_groups_index;
+
+    /// Flags of the toml files of the state
+    enum StateFile : uint8_t {
+        PACKAGES_FILE = 1 << 0,
+        NEVRAS_FILE = 1 << 1,
+        GROUPS_FILE = 1 << 2,
+        ENVIRONMENTS_FILE = 1 << 3,
+        MODULES_FILE = 1 << 4,
+        SYSTEM_FILE = 1 << 5
+    };
+    /// The files whose data changed since they were loaded or saved, `save()` rewrites only these files
+    uint8_t dirty_files{0};
+    /// The files whose data were already parsed
+    uint8_t loaded_files{0};
+    uint64_t package_reasons_generation{0};
 };
 
 }  // namespace libdnf5::system
@@ -17,73 +17,75 @@ You should have received a copy of the GNU Lesser General Public License
 along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-// TODO(dmach): keep refactoring and deliver something that works with the new code base
-// the whole file is disabled via the SKIP macro because it doesn't compile with the new code
-#ifdef SKIP
-
 #ifndef LIBDNF5_TRANSACTION_MERGEDTRANSACTION_HPP
 #define LIBDNF5_TRANSACTION_MERGEDTRANSACTION_HPP
 
-#include <map>
-#include <memory>
-#include <set>
+#include "libdnf5/transaction/rpm_package.hpp"
+#include "libdnf5/transaction/transaction.hpp"
+
+#include <cstdint>
 #include <string>
 #include <vector>
 
-namespace libdnf5::transaction {
 
-class MergedTransaction;
-typedef std::shared_ptr<MergedTransaction> MergedTransactionPtr;
-}  // namespace libdnf5::transaction
+namespace libdnf5::transaction {
 
-#include "rpm_package.hpp"
-#include "transaction.hpp"
-#include "transaction_item.hpp"
+/// Package of a merged transaction with the action and reason resulting from the merged transactions
+struct MergedPackage {
+    /// The package record in one of the merged transactions
+    const Package * package;
+    TransactionItemAction action;
+    TransactionItemReason reason;
+};
 
-namespace libdnf5::transaction {
 
+/// Merges consecutive transactions into a single one with the overall effect of the transactions on the system.
+/// The merged transactions are referenced, they have to outlive the MergedTransaction.
 class MergedTransaction {
 public:
     explicit MergedTransaction(Transaction & trans);
+
+    /// Merges `trans` into this transaction, the transactions are kept sorted by their ids
     void merge(Transaction & trans);
 
-    std::vector<int64_t> listIds() const;
-    std::vector<uint32_t> listUserIds() const;
-    std::vector<std::string> listCmdlines() const;
-    std::vector<TransactionState> listStates() const;
-    std::vector<std::string> listReleasevers() const;
+    /// @return The ids of the merged transactions in ascending order.
+    std::vector<int64_t> list_ids() const;
+
+    /// @return The UIDs of the users who performed the transactions, sorted by the transaction ids.
+    std::vector<uint32_t> list_user_ids() const;
+
+    /// @return The descriptions of the transactions, sorted by the transaction ids.
+    std::vector<std::string> list_descriptions() const;
+
+    /// @return The states of the transactions, sorted by the transaction ids.
+    std::vector<TransactionState> list_states() const;
+
+    /// @return The releasevers of the transactions, sorted by the transaction ids.
+    std::vector<std::string> list_releasevers() const;
+
     int64_t get_dt_begin() const noexcept;
     int64_t get_dt_end() const noexcept;
     const std::string & get_rpmdb_version_begin() const noexcept;
     const std::string & get_rpmdb_version_end() const noexcept;
-    std::set<std::string> get_runtime_packages() const;
-    std::vector<std::pair<int, std::string>> get_console_output();
-
-    std::vector<std::unique_ptr<CompsEnvironment>> get_comps_environments();
-    std::vector<std::unique_ptr<CompsGroup>> get_comps_groups();
-    std::vector<std::unique_ptr<Package>> get_packages();
 
-protected:
+    /// @return The console output of all the transactions, sorted by the transaction ids.
+    std::vector<std::string> get_console_output();
+
+    /// Computes the overall effect of the transactions on the installed packages. The packages are matched by
+    /// their name and arch, every transaction item is processed once in the order of the transactions:
+    ///
+    /// - Install -> Remove = (nothing)
+    /// - Install -> Upgrade/Downgrade = Install (of the new version)
+    /// - Remove -> Install = Reinstall, Upgrade or Downgrade, depending on the versions
+    /// - Reinstall/Reason change -> (new action) = (new action)
+    ///
+    /// @return The merged packages grouped by name and arch in the order of their first appearance.
+    std::vector<MergedPackage> get_packages();
+
+private:
     std::vector<Transaction *> transactions;
-
-    class ItemPair {
-    public:
-        ItemPair(TransactionItem * first, TransactionItem * second) : first{first}, second{second} {}
-        //ItemPair(){};
-        TransactionItem * first = nullptr;
-        TransactionItem * second = nullptr;
-    };
-
-    using ItemPairMap = std::map<std::string, ItemPair>;
-
-    void mergeItem(ItemPairMap & itemPairMap, TransactionItem * transItem);
-    void resolveRPMDifference(ItemPair & previousItemPair, TransactionItem * mTransItem);
-    void resolveErase(ItemPair & previousItemPair, TransactionItem * mTransItem);
-    void resolveAltered(ItemPair & previousItemPair, TransactionItem * mTransItem);
 };
 
 }  // namespace libdnf5::transaction
 
-#endif  // LIBDNF5_TRANSACTION_TRANSACTION_HPP
-
-#endif
+#endif  // LIBDNF5_TRANSACTION_MERGEDTRANSACTION_HPP
@@ -36,6 +36,7 @@ namespace libdnf5::transaction {
 static constexpr const char * SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_SELECT = R"**(
     SELECT
         "ti"."id",
+        "ti"."trans_id",
         "trans_item_action"."name" AS "action",
         "trans_item_reason"."name" AS "reason",
         "trans_item_state"."name" AS "state",
@@ -51,33 +52,50 @@ static constexpr const char * SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_SELECT = R"
     LEFT JOIN "trans_item_action" ON "ti"."action_id" = "trans_item_action"."id"
     LEFT JOIN "trans_item_reason" ON "ti"."reason_id" = "trans_item_reason"."id"
     LEFT JOIN "trans_item_state" ON "ti"."state_id" = "trans_item_state"."id"
-    WHERE "ti"."trans_id" = ?
+    WHERE "ti"."trans_id"
 )**";
 
 
-static std::unique_ptr<libdnf5::utils::SQLite3::Query> comps_environment_transaction_item_select_new_query(
-    libdnf5::utils::SQLite3 & conn, int64_t transaction_id) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_SELECT);
-    query->bindv(transaction_id);
-    return query;
-}
+static constexpr const char * SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_ORDER = R"**(
+    ORDER BY "ti"."id"
+)**";
 
 
 std::vector<CompsEnvironment> CompsEnvironmentDbUtils::get_transaction_comps_environments(
     libdnf5::utils::SQLite3 & conn, Transaction & trans) {
-    std::vector<CompsEnvironment> result;
-
-    auto query = comps_environment_transaction_item_select_new_query(conn, trans.get_id());
-    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        CompsEnvironment ti(trans);
-        TransItemDbUtils::transaction_item_select(*query, ti);
-        ti.set_environment_id(query->get<std::string>("environmentid"));
-        ti.set_name(query->get<std::string>("name"));
-        ti.set_translated_name(query->get<std::string>("translated_name"));
-        ti.set_package_types(static_cast<comps::PackageType>(query->get<int>("pkg_types")));
-        CompsEnvironmentGroupDbUtils::comps_environment_groups_select(conn, ti);
-        result.push_back(std::move(ti));
+    auto environments = get_transactions_comps_environments(conn, {&trans});
+    auto it = environments.find(trans.get_id());
+    return it != environments.end() ? std::move(it->second) : std::vector<CompsEnvironment>();
+}
+
+
+std::unordered_map<int64_t, std::vector<CompsEnvironment>> CompsEnvironmentDbUtils::get_transactions_comps_environments(
+    libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions) {
+    std::unordered_map<int64_t, std::vector<CompsEnvironment>> result;
+
+    TransItemDbUtils::transactions_items_select(
+        conn,
+        SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_SELECT,
+        SQL_COMPS_ENVIRONMENT_TRANSACTION_ITEM_ORDER,
+        transactions,
+        [&result](libdnf5::utils::SQLite3::Query & query, Transaction & trans) {
+            CompsEnvironment ti(trans);
+            TransItemDbUtils::transaction_item_select(query, ti);
+            ti.set_environment_id(query.get<std::string>("environmentid"));
+            ti.set_name(query.get<std::string>("name"));
+            ti.set_translated_name(query.get<std::string>("translated_name"));
+            ti.set_package_types(static_cast<comps::PackageType>(query.get<int>("pkg_types")));
+            result[trans.get_id()].push_back(std::move(ti));
+        });
+
+    // the groups of all the environments are loaded together once the environments are collected
+    std::vector<CompsEnvironment *> environments;
+    for (auto & [trans_id, trans_environments] : result) {
+        for (auto & environment : trans_environments) {
+            environments.push_back(&environment);
+        }
     }
+    CompsEnvironmentGroupDbUtils::comps_environments_groups_select(conn, environments);
 
     return result;
 }
@@ -108,8 +126,7 @@ static std::unique_ptr<libdnf5::utils::SQLite3::Statement> comps_environment_ins
 int64_t CompsEnvironmentDbUtils::comps_environment_insert(
     libdnf5::utils::SQLite3::Statement & query, CompsEnvironment & grp) {
     // insert a record to the 'item' table first
-    auto query_item_insert = item_insert_new_query(query.get_db());
-    auto item_id = item_insert(*query_item_insert);
+    auto item_id = item_insert(query.get_db());
 
     query.bindv(
         item_id,
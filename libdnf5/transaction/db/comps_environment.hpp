@@ -24,7 +24,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/sqlite3/sqlite3.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 namespace libdnf5::transaction {
@@ -40,6 +43,12 @@ public:
     static std::vector<CompsEnvironment> get_transaction_comps_environments(
         libdnf5::utils::SQLite3 & conn, Transaction & trans);
 
+    /// Return the comps environments of all the `transactions` mapped by the transaction ids, the environments
+    /// and their groups are selected by one query each. The transactions without environments are missing
+    /// in the result.
+    static std::unordered_map<int64_t, std::vector<CompsEnvironment>> get_transactions_comps_environments(
+        libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions);
+
     /// Use a query to insert a new record to the 'comps_environment' table
     static int64_t comps_environment_insert(libdnf5::utils::SQLite3::Statement & query, CompsEnvironment & env);
 
@@ -20,12 +20,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "comps_environment_group.hpp"
 
+#include "db.hpp"
+
 #include "libdnf5/comps/group/package.hpp"
 #include "libdnf5/transaction/transaction.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 
 
 namespace libdnf5::transaction {
@@ -34,37 +37,55 @@ namespace libdnf5::transaction {
 static constexpr const char * SQL_COMPS_ENVIRONMENT_GROUP_SELECT = R"**(
     SELECT
         "id",
+        "environment_id",
         "groupid",
         "installed",
         "group_type"
     FROM
         "comps_environment_group"
     WHERE
-        "environment_id" = ?
+        "environment_id"
+)**";
+
+
+static constexpr const char * SQL_COMPS_ENVIRONMENT_GROUP_ORDER = R"**(
     ORDER BY
         "id"
 )**";
 
 
-static std::unique_ptr<libdnf5::utils::SQLite3::Query> comps_environment_group_select_new_query(
-    libdnf5::utils::SQLite3 & conn) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_COMPS_ENVIRONMENT_GROUP_SELECT);
-    return query;
+void CompsEnvironmentGroupDbUtils::comps_environment_groups_select(
+    libdnf5::utils::SQLite3 & conn, CompsEnvironment & env) {
+    comps_environments_groups_select(conn, {&env});
 }
 
 
-void CompsEnvironmentGroupDbUtils::comps_environment_groups_select(
-    libdnf5::utils::SQLite3 & conn, CompsEnvironment & env) {
-    auto query = comps_environment_group_select_new_query(conn);
-    query->bindv(env.get_item_id());
-
-    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        auto & grp = env.new_group();
-        grp.set_id(query->get<int64_t>("id"));
-        grp.set_group_id(query->get<std::string>("groupid"));
-        grp.set_installed(query->get<bool>("installed"));
-        grp.set_group_type(static_cast<comps::PackageType>(query->get<int>("group_type")));
+void CompsEnvironmentGroupDbUtils::comps_environments_groups_select(
+    libdnf5::utils::SQLite3 & conn, const std::vector<CompsEnvironment *> & environments) {
+    std::unordered_map<int64_t, std::vector<CompsEnvironment *>> item_id_to_environments;
+    std::vector<int64_t> item_ids;
+    for (auto * env : environments) {
+        auto & item_environments = item_id_to_environments[env->get_item_id()];
+        if (item_environments.empty()) {
+            item_ids.push_back(env->get_item_id());
+        }
+        item_environments.push_back(env);
     }
+
+    transaction_db_select_by_ids(
+        conn,
+        SQL_COMPS_ENVIRONMENT_GROUP_SELECT,
+        item_ids,
+        SQL_COMPS_ENVIRONMENT_GROUP_ORDER,
+        [&item_id_to_environments](libdnf5::utils::SQLite3::Query & query) {
+            for (auto * env : item_id_to_environments.at(query.get<int64_t>("environment_id"))) {
+                auto & grp = env->new_group();
+                grp.set_id(query.get<int64_t>("id"));
+                grp.set_group_id(query.get<std::string>("groupid"));
+                grp.set_installed(query.get<bool>("installed"));
+                grp.set_group_type(static_cast<comps::PackageType>(query.get<int>("group_type")));
+            }
+        });
 }
 
 
@@ -26,6 +26,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/transaction/comps_environment.hpp"
 
+#include <vector>
+
 
 namespace libdnf5::transaction {
 
@@ -34,6 +36,10 @@ public:
     /// Load EnvironmentGroup objects from the database to the CompsEnvironment object
     static void comps_environment_groups_select(libdnf5::utils::SQLite3 & conn, CompsEnvironment & env);
 
+    /// Load EnvironmentGroup objects from the database to all the `environments` by a single query
+    static void comps_environments_groups_select(
+        libdnf5::utils::SQLite3 & conn, const std::vector<CompsEnvironment *> & environments);
+
     /// Insert EnvironmentGroup objects associated with a CompsEnvironment into the database
     static void comps_environment_groups_insert(libdnf5::utils::SQLite3 & conn, CompsEnvironment & env);
 };
@@ -36,6 +36,7 @@ namespace libdnf5::transaction {
 static constexpr const char * SQL_COMPS_GROUP_TRANSACTION_ITEM_SELECT = R"**(
     SELECT
         "ti"."id",
+        "ti"."trans_id",
         "trans_item_action"."name" AS "action",
         "trans_item_reason"."name" AS "reason",
         "trans_item_state"."name" AS "state",
@@ -51,37 +52,50 @@ static constexpr const char * SQL_COMPS_GROUP_TRANSACTION_ITEM_SELECT = R"**(
     LEFT JOIN "trans_item_action" ON "ti"."action_id" = "trans_item_action"."id"
     LEFT JOIN "trans_item_reason" ON "ti"."reason_id" = "trans_item_reason"."id"
     LEFT JOIN "trans_item_state" ON "ti"."state_id" = "trans_item_state"."id"
-    WHERE "ti"."trans_id" = ?
+    WHERE "ti"."trans_id"
 )**";
 
 
-static std::unique_ptr<libdnf5::utils::SQLite3::Query> comps_group_transaction_item_select_new_query(
-    libdnf5::utils::SQLite3 & conn, int64_t transaction_id) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_COMPS_GROUP_TRANSACTION_ITEM_SELECT);
-    query->bindv(transaction_id);
-    return query;
-}
+static constexpr const char * SQL_COMPS_GROUP_TRANSACTION_ITEM_ORDER = R"**(
+    ORDER BY "ti"."id"
+)**";
 
 
 std::vector<CompsGroup> CompsGroupDbUtils::get_transaction_comps_groups(
     libdnf5::utils::SQLite3 & conn, Transaction & trans) {
-    std::vector<CompsGroup> result;
-
-    auto query = comps_group_transaction_item_select_new_query(conn, trans.get_id());
-
-    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        CompsGroup ti(trans);
-        TransItemDbUtils::transaction_item_select(*query, ti);
-        //        auto trans_item = std::make_shared< TransactionItem >(trans);
-        //        auto item = std::make_shared< CompsGroup >(trans);
-        //        trans_item->setItem(item);
-        ti.set_group_id(query->get<std::string>("groupid"));
-        ti.set_name(query->get<std::string>("name"));
-        ti.set_translated_name(query->get<std::string>("translated_name"));
-        ti.set_package_types(static_cast<comps::PackageType>(query->get<int>("pkg_types")));
-        CompsGroupPackageDbUtils::comps_group_packages_select(conn, ti);
-        result.push_back(std::move(ti));
+    auto groups = get_transactions_comps_groups(conn, {&trans});
+    auto it = groups.find(trans.get_id());
+    return it != groups.end() ? std::move(it->second) : std::vector<CompsGroup>();
+}
+
+
+std::unordered_map<int64_t, std::vector<CompsGroup>> CompsGroupDbUtils::get_transactions_comps_groups(
+    libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions) {
+    std::unordered_map<int64_t, std::vector<CompsGroup>> result;
+
+    TransItemDbUtils::transactions_items_select(
+        conn,
+        SQL_COMPS_GROUP_TRANSACTION_ITEM_SELECT,
+        SQL_COMPS_GROUP_TRANSACTION_ITEM_ORDER,
+        transactions,
+        [&result](libdnf5::utils::SQLite3::Query & query, Transaction & trans) {
+            CompsGroup ti(trans);
+            TransItemDbUtils::transaction_item_select(query, ti);
+            ti.set_group_id(query.get<std::string>("groupid"));
+            ti.set_name(query.get<std::string>("name"));
+            ti.set_translated_name(query.get<std::string>("translated_name"));
+            ti.set_package_types(static_cast<comps::PackageType>(query.get<int>("pkg_types")));
+            result[trans.get_id()].push_back(std::move(ti));
+        });
+
+    // the packages of all the groups are loaded together once the groups are collected
+    std::vector<CompsGroup *> groups;
+    for (auto & [trans_id, trans_groups] : result) {
+        for (auto & group : trans_groups) {
+            groups.push_back(&group);
+        }
     }
+    CompsGroupPackageDbUtils::comps_groups_packages_select(conn, groups);
 
     return result;
 }
@@ -111,8 +125,7 @@ static std::unique_ptr<libdnf5::utils::SQLite3::Statement> comps_group_insert_ne
 
 int64_t CompsGroupDbUtils::comps_group_insert(libdnf5::utils::SQLite3::Statement & query, CompsGroup & grp) {
     // insert a record to the 'item' table first
-    auto query_item_insert = item_insert_new_query(query.get_db());
-    auto item_id = item_insert(*query_item_insert);
+    auto item_id = item_insert(query.get_db());
 
     query.bindv(
         item_id,
@@ -24,7 +24,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/sqlite3/sqlite3.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 namespace libdnf5::transaction {
@@ -39,6 +42,12 @@ public:
     static std::vector<CompsGroup> get_transaction_comps_groups(libdnf5::utils::SQLite3 & conn, Transaction & trans);
 
 
+    /// Return the comps groups of all the `transactions` mapped by the transaction ids, the groups and their
+    /// packages are selected by one query each. The transactions without groups are missing in the result.
+    static std::unordered_map<int64_t, std::vector<CompsGroup>> get_transactions_comps_groups(
+        libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions);
+
+
     /// Use a query to insert a new record to the 'comps_group' table
     static int64_t comps_group_insert(libdnf5::utils::SQLite3::Statement & query, CompsGroup & grp);
 
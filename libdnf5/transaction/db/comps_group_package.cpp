@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "comps_group_package.hpp"
 
+#include "db.hpp"
 #include "pkg_name.hpp"
 
 #include "libdnf5/comps/group/package.hpp"
@@ -27,6 +28,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 
 
 namespace libdnf5::transaction {
@@ -35,6 +37,7 @@ namespace libdnf5::transaction {
 static constexpr const char * SQL_COMPS_GROUP_PACKAGE_SELECT = R"**(
     SELECT
         "cgp"."id",
+        "cgp"."group_id",
         "pkg_name"."name",
         "cgp"."installed",
         "cgp"."pkg_type"
@@ -42,30 +45,47 @@ static constexpr const char * SQL_COMPS_GROUP_PACKAGE_SELECT = R"**(
         "comps_group_package" "cgp"
     LEFT JOIN "pkg_name" ON "cgp"."name_id" = "pkg_name"."id"
     WHERE
-        "cgp"."group_id" = ?
+        "cgp"."group_id"
+)**";
+
+
+static constexpr const char * SQL_COMPS_GROUP_PACKAGE_ORDER = R"**(
     ORDER BY
         "cgp"."id"
 )**";
 
 
-static std::unique_ptr<libdnf5::utils::SQLite3::Query> comps_group_package_select_new_query(
-    libdnf5::utils::SQLite3 & conn) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_COMPS_GROUP_PACKAGE_SELECT);
-    return query;
+void CompsGroupPackageDbUtils::comps_group_packages_select(libdnf5::utils::SQLite3 & conn, CompsGroup & group) {
+    comps_groups_packages_select(conn, {&group});
 }
 
 
-void CompsGroupPackageDbUtils::comps_group_packages_select(libdnf5::utils::SQLite3 & conn, CompsGroup & group) {
-    auto query = comps_group_package_select_new_query(conn);
-    query->bindv(group.get_item_id());
-
-    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        auto & pkg = group.new_package();
-        pkg.set_id(query->get<int64_t>("id"));
-        pkg.set_name(query->get<std::string>("name"));
-        pkg.set_installed(query->get<bool>("installed"));
-        pkg.set_package_type(static_cast<comps::PackageType>(query->get<int>("pkg_type")));
+void CompsGroupPackageDbUtils::comps_groups_packages_select(
+    libdnf5::utils::SQLite3 & conn, const std::vector<CompsGroup *> & groups) {
+    std::unordered_map<int64_t, std::vector<CompsGroup *>> item_id_to_groups;
+    std::vector<int64_t> item_ids;
+    for (auto * group : groups) {
+        auto & item_groups = item_id_to_groups[group->get_item_id()];
+        if (item_groups.empty()) {
+            item_ids.push_back(group->get_item_id());
+        }
+        item_groups.push_back(group);
     }
+
+    transaction_db_select_by_ids(
+        conn,
+        SQL_COMPS_GROUP_PACKAGE_SELECT,
+        item_ids,
+        SQL_COMPS_GROUP_PACKAGE_ORDER,
+        [&item_id_to_groups](libdnf5::utils::SQLite3::Query & query) {
+            for (auto * group : item_id_to_groups.at(query.get<int64_t>("group_id"))) {
+                auto & pkg = group->new_package();
+                pkg.set_id(query.get<int64_t>("id"));
+                pkg.set_name(query.get<std::string>("name"));
+                pkg.set_installed(query.get<bool>("installed"));
+                pkg.set_package_type(static_cast<comps::PackageType>(query.get<int>("pkg_type")));
+            }
+        });
 }
 
 
@@ -26,6 +26,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/transaction/comps_group.hpp"
 
+#include <vector>
+
 
 namespace libdnf5::transaction {
 
@@ -36,6 +38,10 @@ public:
     static void comps_group_packages_select(libdnf5::utils::SQLite3 & conn, CompsGroup & group);
 
 
+    /// Load GroupPackage objects from the database to all the `groups` by a single query
+    static void comps_groups_packages_select(libdnf5::utils::SQLite3 & conn, const std::vector<CompsGroup *> & groups);
+
+
     /// Insert GroupPackage objects associated with a CompsGroup into the database
     static void comps_group_packages_insert(libdnf5::utils::SQLite3 & conn, CompsGroup & group);
 };
@@ -0,0 +1,160 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "console_output.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/transaction/transaction.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <zstd.h>
+
+#include <memory>
+#include <utility>
+
+
+namespace libdnf5::transaction {
+
+// The zstd default level, the output of scriptlets compresses well even with the fast levels
+static constexpr int CONSOLE_OUTPUT_COMPRESSION_LEVEL = 3;
+
+
+static constexpr const char * SQL_CONSOLE_OUTPUT_SELECT = R"**(
+    SELECT
+        "line"
+    FROM
+        "console_output"
+    WHERE
+        "trans_id" = ?
+    ORDER BY
+        "id"
+)**";
+
+
+static constexpr const char * SQL_CONSOLE_OUTPUT_CHUNK_SELECT = R"**(
+    SELECT
+        "data"
+    FROM
+        "console_output_chunk"
+    WHERE
+        "trans_id" = ?
+    ORDER BY
+        "id"
+)**";
+
+
+std::vector<std::string> ConsoleOutputDbUtils::console_output_select(
+    libdnf5::utils::SQLite3 & conn, Transaction & trans) {
+    std::vector<std::string> result;
+
+    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_CONSOLE_OUTPUT_SELECT);
+    query->bindv(trans.get_id());
+    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+        result.emplace_back(query->get<std::string>("line"));
+    }
+
+    auto chunk_query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_CONSOLE_OUTPUT_CHUNK_SELECT);
+    chunk_query->bindv(trans.get_id());
+    std::string text;
+    while (chunk_query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+        auto data = chunk_query->get<libdnf5::utils::SQLite3::Blob>("data");
+        auto text_size = ZSTD_getFrameContentSize(data.data, data.size);
+        if (text_size == ZSTD_CONTENTSIZE_ERROR || text_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+            throw RuntimeError(M_("Invalid chunk of the console output of transaction {}"), trans.get_id());
+        }
+        text.resize(static_cast<std::size_t>(text_size));
+        auto len = ZSTD_decompress(text.data(), text.size(), data.data, data.size);
+        if (ZSTD_isError(len)) {
+            throw RuntimeError(
+                M_("Failed to decompress the console output of transaction {}: {}"),
+                trans.get_id(),
+                std::string(ZSTD_getErrorName(len)));
+        }
+        // each line of a chunk is terminated by a newline
+        std::string_view lines(text.data(), len);
+        for (auto end = lines.find('\n'); end != std::string_view::npos; end = lines.find('\n')) {
+            result.emplace_back(lines.substr(0, end));
+            lines.remove_prefix(end + 1);
+        }
+    }
+
+    return result;
+}
+
+
+static constexpr const char * SQL_CONSOLE_OUTPUT_CHUNK_INSERT = R"**(
+    INSERT INTO
+        "console_output_chunk" (
+            "trans_id",
+            "data"
+        )
+    VALUES
+        (?, ?)
+)**";
+
+
+void ConsoleOutputDbUtils::console_output_insert(
+    libdnf5::utils::SQLite3 & conn, Transaction & trans, const std::vector<std::string> & chunks) {
+    auto query = std::make_unique<libdnf5::utils::SQLite3::Statement>(conn, SQL_CONSOLE_OUTPUT_CHUNK_INSERT);
+    for (const auto & chunk : chunks) {
+        query->bindv(trans.get_id(), libdnf5::utils::SQLite3::Blob{chunk.size(), chunk.data()});
+        query->step();
+        query->reset();
+    }
+}
+
+
+void ConsoleOutputCompressor::append(std::string_view output) {
+    pending.append(output);
+    if (pending.size() < CHUNK_SIZE) {
+        return;
+    }
+    // a chunk contains only complete lines, a very long line waits for its end
+    auto last_newline = pending.rfind('\n');
+    if (last_newline != std::string::npos) {
+        compress_pending(last_newline + 1);
+    }
+}
+
+
+std::vector<std::string> ConsoleOutputCompressor::finish() {
+    if (!pending.empty()) {
+        if (pending.back() != '\n') {
+            pending.push_back('\n');
+        }
+        compress_pending(pending.size());
+    }
+    return std::move(chunks);
+}
+
+
+void ConsoleOutputCompressor::compress_pending(std::size_t size) {
+    std::string chunk(ZSTD_compressBound(size), '\0');
+    auto len = ZSTD_compress(chunk.data(), chunk.size(), pending.data(), size, CONSOLE_OUTPUT_COMPRESSION_LEVEL);
+    if (ZSTD_isError(len)) {
+        throw RuntimeError(M_("Failed to compress the console output: {}"), std::string(ZSTD_getErrorName(len)));
+    }
+    chunk.resize(len);
+    chunks.emplace_back(std::move(chunk));
+    pending.erase(0, size);
+}
+
+
+}  // namespace libdnf5::transaction
@@ -0,0 +1,75 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TRANSACTION_DB_CONSOLE_OUTPUT_HPP
+#define LIBDNF5_TRANSACTION_DB_CONSOLE_OUTPUT_HPP
+
+
+#include "utils/sqlite3/sqlite3.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf5::transaction {
+
+
+class Transaction;
+
+class ConsoleOutputDbUtils {
+public:
+    /// Load the lines of the console output of the transaction from the database.
+    /// The lines stored one per row by older versions are followed by the lines of the compressed chunks.
+    static std::vector<std::string> console_output_select(libdnf5::utils::SQLite3 & conn, Transaction & trans);
+
+    /// Insert the compressed `chunks` of the console output of the transaction into the database
+    static void console_output_insert(
+        libdnf5::utils::SQLite3 & conn, Transaction & trans, const std::vector<std::string> & chunks);
+};
+
+
+/// Compresses the console output into zstd frames, each holding whole lines of about `CHUNK_SIZE` bytes.
+/// Each frame is stored as one row of the "console_output_chunk" table.
+class ConsoleOutputCompressor {
+public:
+    /// The uncompressed size of the lines collected into one chunk
+    static constexpr std::size_t CHUNK_SIZE = 256 * 1024;
+
+    /// Append the `output` to the pending lines, the complete lines are compressed once there is a full chunk of them.
+    /// The `output` does not have to end at a line boundary.
+    void append(std::string_view output);
+
+    /// Compress the pending lines and return all the chunks, a pending unterminated line is completed.
+    std::vector<std::string> finish();
+
+private:
+    /// Compress the first `size` bytes of the pending lines into a new chunk
+    void compress_pending(std::size_t size);
+
+    std::string pending;
+    std::vector<std::string> chunks;
+};
+
+}  // namespace libdnf5::transaction
+
+
+#endif  // LIBDNF5_TRANSACTION_DB_CONSOLE_OUTPUT_HPP
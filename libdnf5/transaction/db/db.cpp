@@ -23,7 +23,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <string>
 
 
 namespace libdnf5::transaction {
@@ -34,6 +36,21 @@ static constexpr const char * SQL_CREATE_TABLES =
     ;
 
 
+// Tables added after the schema version 1.1, they are created in existing databases as well
+static constexpr const char * SQL_CREATE_TRANS_TIMING =
+#include "sql/create_trans_timing.sql"
+    ;
+
+static constexpr const char * SQL_CREATE_CONSOLE_OUTPUT =
+#include "sql/create_console_output.sql"
+    ;
+
+// Indexes added after the schema version 1.1 for the paginated history queries
+static constexpr const char * SQL_CREATE_TRANS_INDEXES =
+#include "sql/create_trans_indexes.sql"
+    ;
+
+
 static constexpr const char * SQL_TABLE_CONFIG_EXISTS = R"**(
     SELECT
         "name"
@@ -72,21 +89,109 @@ static void transaction_db_create(libdnf5::utils::SQLite3 & conn) {
     }
 
     // TODO(dmach): migrations
+
+    conn.exec(SQL_CREATE_TRANS_TIMING);
+    conn.exec(SQL_CREATE_CONSOLE_OUTPUT);
+    conn.exec(SQL_CREATE_TRANS_INDEXES);
+}
+
+
+static constexpr const char * SQL_LATEST_SCHEMA_EXISTS = R"**(
+    SELECT
+        COUNT(*)
+    FROM
+        "sqlite_master"
+    WHERE
+        ("type" = 'table' AND "name" IN ('trans_timing', 'console_output', 'console_output_chunk'))
+        OR ("type" = 'index' AND "name" = 'trans_dt_begin')
+)**";
+
+
+// Check that the tables and indexes created in existing databases by transaction_db_create() exist,
+// a read-only connection cannot create them.
+static bool transaction_db_has_latest_schema(libdnf5::utils::SQLite3 & conn) {
+    libdnf5::utils::SQLite3::Statement query(conn, SQL_LATEST_SCHEMA_EXISTS);
+    return query.step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW && query.get<int>(0) == 4;
 }
 
 
-std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(libdnf5::Base & base) {
+std::filesystem::path transaction_db_get_path(libdnf5::Base & base) {
     auto & config = base.get_config();
     config.get_installroot_option().lock("installroot locked by transaction_db_connect");
 
     std::filesystem::path path{config.get_installroot_option().get_value()};
     path /= std::filesystem::path(config.get_transaction_history_dir_option().get_value()).relative_path();
-    std::filesystem::create_directories(path);
+    path /= "transaction_history.sqlite";
+    return path;
+}
+
 
-    auto conn = std::make_unique<libdnf5::utils::SQLite3>((path / "transaction_history.sqlite").native());
+libdnf5::utils::SQLite3::OpenOptions transaction_db_get_open_options(libdnf5::Base & base) {
+    auto & config = base.get_config();
+    libdnf5::utils::SQLite3::OpenOptions options;
+    options.journal_mode = config.get_history_db_journal_mode_option().get_value();
+    options.synchronous = config.get_history_db_synchronous_option().get_value();
+    return options;
+}
+
+
+std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(
+    const std::filesystem::path & path, const libdnf5::utils::SQLite3::OpenOptions & options) {
+    std::filesystem::create_directories(path.parent_path());
+    auto conn = std::make_unique<libdnf5::utils::SQLite3>(path.native(), options);
     transaction_db_create(*conn);
     return conn;
 }
 
 
+std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(libdnf5::Base & base, bool read_only) {
+    auto path = transaction_db_get_path(base);
+    auto options = transaction_db_get_open_options(base);
+
+    if (read_only && std::filesystem::exists(path)) {
+        options.read_only = true;
+        auto conn = std::make_unique<libdnf5::utils::SQLite3>(path.native(), options);
+        if (transaction_db_has_latest_schema(*conn)) {
+            return conn;
+        }
+        // the database has to be upgraded by a read-write connection first
+        options.read_only = false;
+    }
+
+    return transaction_db_connect(path, options);
+}
+
+
+// Maximal number of ids bound to a single statement, older SQLite versions limit the number of bound parameters to 999
+static constexpr std::size_t SELECT_BY_IDS_CHUNK = 500;
+
+
+void transaction_db_select_by_ids(
+    libdnf5::utils::SQLite3 & conn,
+    std::string_view sql_select,
+    const std::vector<int64_t> & ids,
+    std::string_view sql_order,
+    const std::function<void(libdnf5::utils::SQLite3::Query & query)> & row_callback) {
+    for (std::size_t chunk_begin = 0; chunk_begin < ids.size(); chunk_begin += SELECT_BY_IDS_CHUNK) {
+        auto chunk_end = std::min(chunk_begin + SELECT_BY_IDS_CHUNK, ids.size());
+
+        std::string sql(sql_select);
+        sql += " IN (";
+        for (auto idx = chunk_begin; idx < chunk_end; ++idx) {
+            sql += idx == chunk_begin ? "?" : ", ?";
+        }
+        sql += ")";
+        sql += sql_order;
+
+        libdnf5::utils::SQLite3::Query query(conn, sql);
+        for (auto idx = chunk_begin; idx < chunk_end; ++idx) {
+            query.bind(static_cast<int>(idx - chunk_begin + 1), ids[idx]);
+        }
+        while (query.step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+            row_callback(query);
+        }
+    }
+}
+
+
 }  // namespace libdnf5::transaction
@@ -24,7 +24,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/sqlite3/sqlite3.hpp"
 
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 
 namespace libdnf5 {
@@ -35,9 +40,38 @@ class Base;
 namespace libdnf5::transaction {
 
 
+/// Return the path of the transaction database, the 'transaction_history.sqlite' file in the
+/// 'transaction_history_dir' directory of the installroot.
+std::filesystem::path transaction_db_get_path(libdnf5::Base & base);
+
+
+/// Return the options of the connections to the transaction database set by the configuration.
+libdnf5::utils::SQLite3::OpenOptions transaction_db_get_open_options(libdnf5::Base & base);
+
+
+/// Create a read-write connection to the transaction database at `path`, the database is created or its schema
+/// is upgraded if needed. It doesn't access the `Base` and can be used from any thread.
+std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(
+    const std::filesystem::path & path, const libdnf5::utils::SQLite3::OpenOptions & options);
+
+
 /// Create a connection to transaction database in the 'persistdir' directory.
 /// The file is named 'transaction_history.sqlite'.
-std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(libdnf5::Base & base);
+/// The `read_only` connection suits queries, it skips the schema creation, which takes the write lock
+/// of the database, and so it doesn't contend with a running transaction. A read-write connection is
+/// created instead when the database doesn't exist yet or its schema has to be upgraded.
+std::unique_ptr<libdnf5::utils::SQLite3> transaction_db_connect(libdnf5::Base & base, bool read_only = false);
+
+
+/// Run the query `sql_select` followed by an "IN (...)" list of the `ids` and by `sql_order`, and call `row_callback`
+/// for each returned row. The `sql_select` ends with the column matched against the ids. The ids are split
+/// into chunks which fit the limit of bound parameters, each chunk runs its own query.
+void transaction_db_select_by_ids(
+    libdnf5::utils::SQLite3 & conn,
+    std::string_view sql_select,
+    const std::vector<int64_t> & ids,
+    std::string_view sql_order,
+    const std::function<void(libdnf5::utils::SQLite3::Query & query)> & row_callback);
 
 
 }  // namespace libdnf5::transaction
@@ -46,4 +46,9 @@ int64_t item_insert(libdnf5::utils::SQLite3::Statement & query) {
 }
 
 
+int64_t item_insert(libdnf5::utils::SQLite3 & conn) {
+    return item_insert(conn.get_cached_statement(SQL_ITEM_INSERT));
+}
+
+
 }  // namespace libdnf5::transaction
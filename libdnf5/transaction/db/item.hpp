@@ -38,6 +38,10 @@ std::unique_ptr<libdnf5::utils::SQLite3::Statement> item_insert_new_query(libdnf
 int64_t item_insert(libdnf5::utils::SQLite3::Statement & query);
 
 
+/// Insert a new record to the 'item' table using the statement cached by the connection
+int64_t item_insert(libdnf5::utils::SQLite3 & conn);
+
+
 }  // namespace libdnf5::transaction
 
 
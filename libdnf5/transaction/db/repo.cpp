@@ -77,4 +77,13 @@ int64_t repo_select_pk(libdnf5::utils::SQLite3::Statement & query, const std::st
 }
 
 
+int64_t repo_select_pk_or_insert(libdnf5::utils::SQLite3 & conn, const std::string & repoid) {
+    auto repo_id = repo_select_pk(conn.get_cached_statement(SQL_REPO_SELECT_PK), repoid);
+    if (!repo_id) {
+        repo_id = repo_insert(conn.get_cached_statement(SQL_REPO_INSERT), repoid);
+    }
+    return repo_id;
+}
+
+
 }  // namespace libdnf5::transaction
@@ -48,6 +48,11 @@ std::unique_ptr<libdnf5::utils::SQLite3::Statement> repo_select_pk_new_query(lib
 int64_t repo_select_pk(libdnf5::utils::SQLite3::Statement & query, const std::string & repoid);
 
 
+/// Return the primary key of the record in table 'repo' that matches the repoid, the record is inserted
+/// if it doesn't exist. The statements are cached by the connection.
+int64_t repo_select_pk_or_insert(libdnf5::utils::SQLite3 & conn, const std::string & repoid);
+
+
 }  // namespace libdnf5::transaction
 
 
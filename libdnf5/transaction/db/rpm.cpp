@@ -28,6 +28,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/transaction/rpm_package.hpp"
 #include "libdnf5/transaction/transaction.hpp"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 
 namespace libdnf5::transaction {
 
@@ -35,6 +41,7 @@ namespace libdnf5::transaction {
 static constexpr const char * SQL_RPM_TRANSACTION_ITEM_SELECT = R"**(
     SELECT
         "ti"."id",
+        "ti"."trans_id",
         "trans_item_action"."name" AS "action",
         "trans_item_reason"."name" AS "reason",
         "trans_item_state"."name" AS "state",
@@ -53,17 +60,13 @@ static constexpr const char * SQL_RPM_TRANSACTION_ITEM_SELECT = R"**(
     LEFT JOIN "trans_item_state" ON "ti"."state_id" = "trans_item_state"."id"
     LEFT JOIN "pkg_name" ON "i"."name_id" = "pkg_name"."id"
     LEFT JOIN "arch" ON "i"."arch_id" = "arch"."id"
-    WHERE "ti"."trans_id" = ?
+    WHERE "ti"."trans_id"
 )**";
 
 
-// Create a query that returns all rpm transaction items for a transaction
-static std::unique_ptr<libdnf5::utils::SQLite3::Query> rpm_transaction_item_select_new_query(
-    libdnf5::utils::SQLite3 & conn, int64_t transaction_id) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_RPM_TRANSACTION_ITEM_SELECT);
-    query->bindv(transaction_id);
-    return query;
-}
+static constexpr const char * SQL_RPM_TRANSACTION_ITEM_ORDER = R"**(
+    ORDER BY "ti"."id"
+)**";
 
 
 int64_t RpmDbUtils::rpm_transaction_item_select(libdnf5::utils::SQLite3::Query & query, Package & pkg) {
@@ -109,41 +112,6 @@ int64_t RpmDbUtils::rpm_insert(libdnf5::utils::SQLite3::Statement & query, const
 }
 
 
-static constexpr const char * SQL_RPM_SELECT_PK = R"**(
-    SELECT
-        "item_id"
-    FROM
-        "rpm"
-    LEFT JOIN "pkg_name" ON "rpm"."name_id" = "pkg_name"."id"
-    LEFT JOIN "arch" ON "rpm"."arch_id" = "arch"."id"
-    WHERE
-        "pkg_name"."name" = ?
-        AND "epoch" = ?
-        AND "version" = ?
-        AND "release" = ?
-        AND "arch"."name" = ?
-)**";
-
-
-// Create a query that returns primary keys from table 'rpm'
-static std::unique_ptr<libdnf5::utils::SQLite3::Statement> rpm_select_pk_new_query(libdnf5::utils::SQLite3 & conn) {
-    auto query = std::make_unique<libdnf5::utils::SQLite3::Statement>(conn, SQL_RPM_SELECT_PK);
-    return query;
-}
-
-
-int64_t RpmDbUtils::rpm_select_pk(libdnf5::utils::SQLite3::Statement & query, const Package & rpm) {
-    query.bindv(rpm.get_name(), rpm.get_epoch_int(), rpm.get_version(), rpm.get_release(), rpm.get_arch());
-
-    int64_t result = 0;
-    if (query.step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        result = query.get<int64_t>(0);
-    }
-    query.reset();
-    return result;
-}
-
-
 bool RpmDbUtils::rpm_select(libdnf5::utils::SQLite3::Query & query, int64_t rpm_id, Package & rpm) {
     bool result = false;
     query.bindv(rpm_id);
@@ -164,38 +132,134 @@ bool RpmDbUtils::rpm_select(libdnf5::utils::SQLite3::Query & query, int64_t rpm_
 
 
 std::vector<Package> RpmDbUtils::get_transaction_packages(libdnf5::utils::SQLite3 & conn, Transaction & trans) {
-    std::vector<Package> result;
+    auto packages = get_transactions_packages(conn, {&trans});
+    auto it = packages.find(trans.get_id());
+    return it != packages.end() ? std::move(it->second) : std::vector<Package>();
+}
+
+
+std::unordered_map<int64_t, std::vector<Package>> RpmDbUtils::get_transactions_packages(
+    libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions) {
+    std::unordered_map<int64_t, std::vector<Package>> result;
+
+    TransItemDbUtils::transactions_items_select(
+        conn,
+        SQL_RPM_TRANSACTION_ITEM_SELECT,
+        SQL_RPM_TRANSACTION_ITEM_ORDER,
+        transactions,
+        [&result](libdnf5::utils::SQLite3::Query & query, Transaction & trans) {
+            Package trans_item(trans);
+            rpm_transaction_item_select(query, trans_item);
+            result[trans.get_id()].push_back(std::move(trans_item));
+        });
+
+    return result;
+}
 
-    auto query = rpm_transaction_item_select_new_query(conn, trans.get_id());
-    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
-        Package trans_item(trans);
-        rpm_transaction_item_select(*query, trans_item);
-        result.push_back(std::move(trans_item));
-    }
 
+// Maximal number of package names bound to a single SQL_RPM_SELECT_PK_BY_NAMES statement,
+// older SQLite versions limit the number of bound parameters to 999
+static constexpr std::size_t SELECT_PK_BY_NAMES_CHUNK = 500;
+
+
+static constexpr const char * SQL_RPM_SELECT_PK_BY_NAMES = R"**(
+    SELECT
+        "item_id",
+        "pkg_name"."name",
+        "epoch",
+        "version",
+        "release",
+        "arch"."name"
+    FROM
+        "rpm"
+    JOIN "pkg_name" ON "rpm"."name_id" = "pkg_name"."id"
+    JOIN "arch" ON "rpm"."arch_id" = "arch"."id"
+    WHERE
+        "pkg_name"."name" IN (
+)**";
+
+
+// Return a key identifying a record in table 'rpm' by its name, epoch, version, release and arch
+static std::string get_rpm_key(
+    const std::string & name,
+    uint32_t epoch,
+    const std::string & version,
+    const std::string & release,
+    const std::string & arch) {
+    return fmt::format("{}\n{}\n{}\n{}\n{}", name, epoch, version, release, arch);
+}
+
+
+// Return the primary keys of the records in table 'rpm' with the given names, the keys are mapped by get_rpm_key()
+static std::unordered_map<std::string, int64_t> rpm_select_pks_by_names(
+    libdnf5::utils::SQLite3 & conn, const std::vector<std::string> & names) {
+    std::unordered_map<std::string, int64_t> result;
+    for (std::size_t chunk_begin = 0; chunk_begin < names.size(); chunk_begin += SELECT_PK_BY_NAMES_CHUNK) {
+        auto chunk_end = std::min(chunk_begin + SELECT_PK_BY_NAMES_CHUNK, names.size());
+
+        // the full chunks have the same SQL text and share the cached statement
+        std::string sql = SQL_RPM_SELECT_PK_BY_NAMES;
+        for (auto idx = chunk_begin; idx < chunk_end; ++idx) {
+            sql += idx == chunk_begin ? "?" : ", ?";
+        }
+        sql += ")";
+
+        auto & query = conn.get_cached_statement(sql);
+        for (auto idx = chunk_begin; idx < chunk_end; ++idx) {
+            query.bind(static_cast<int>(idx - chunk_begin + 1), names[idx]);
+        }
+        while (query.step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+            auto key = get_rpm_key(
+                query.get<std::string>(1),
+                query.get<uint32_t>(2),
+                query.get<std::string>(3),
+                query.get<std::string>(4),
+                query.get<std::string>(5));
+            result.emplace(std::move(key), query.get<int64_t>(0));
+        }
+        query.reset();
+    }
     return result;
 }
 
 
 void RpmDbUtils::insert_transaction_packages(libdnf5::utils::SQLite3 & conn, Transaction & trans) {
-    auto query_rpm_select_pk = rpm_select_pk_new_query(conn);
-    auto query_item_insert = item_insert_new_query(conn);
+    auto & packages = trans.get_packages();
+
+    // insert the package and arch names that don't exist, each distinct name only once
+    std::vector<std::string> names;
+    std::unordered_set<std::string> seen_names;
+    std::unordered_set<std::string> seen_arches;
     auto query_pkg_name_insert_if_not_exists = pkg_name_insert_if_not_exists_new_query(conn);
     auto query_arch_insert_if_not_exists = arch_insert_if_not_exists_new_query(conn);
+    for (auto & pkg : packages) {
+        if (seen_names.insert(pkg.get_name()).second) {
+            names.push_back(pkg.get_name());
+            pkg_name_insert_if_not_exists(*query_pkg_name_insert_if_not_exists, pkg.get_name());
+        }
+        if (seen_arches.insert(pkg.get_arch()).second) {
+            arch_insert_if_not_exists(*query_arch_insert_if_not_exists, pkg.get_arch());
+        }
+    }
+
+    // look up the existing 'rpm' records of all the names at once instead of one query per package
+    auto item_ids = rpm_select_pks_by_names(conn, names);
+
+    auto query_item_insert = item_insert_new_query(conn);
     auto query_rpm_insert = rpm_insert_new_query(conn);
     auto query_trans_item_insert = TransItemDbUtils::trans_item_insert_new_query(conn);
-
-    for (auto & pkg : trans.get_packages()) {
-        pkg.set_item_id(rpm_select_pk(*query_rpm_select_pk, pkg));
-        if (pkg.get_item_id() == 0) {
+    for (auto & pkg : packages) {
+        auto [it, inserted] = item_ids.try_emplace(
+            get_rpm_key(pkg.get_name(), pkg.get_epoch_int(), pkg.get_version(), pkg.get_release(), pkg.get_arch()),
+            0);
+        if (inserted) {
             // insert into 'item' table, create item_id
             pkg.set_item_id(item_insert(*query_item_insert));
-            // insert package name into 'pkg_name' table if not exists
-            pkg_name_insert_if_not_exists(*query_pkg_name_insert_if_not_exists, pkg.get_name());
-            // insert arch name into 'arch' table if not exists
-            arch_insert_if_not_exists(*query_arch_insert_if_not_exists, pkg.get_arch());
             // insert into 'rpm' table
             rpm_insert(*query_rpm_insert, pkg);
+            it->second = pkg.get_item_id();
+        } else {
+            pkg.set_item_id(it->second);
         }
         TransItemDbUtils::transaction_item_insert(*query_trans_item_insert, pkg);
     }
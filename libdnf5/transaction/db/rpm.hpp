@@ -24,7 +24,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/sqlite3/sqlite3.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 
@@ -44,11 +46,6 @@ public:
     static int64_t rpm_insert(libdnf5::utils::SQLite3::Statement & query, const Package & rpm);
 
 
-    /// Find a primary key of a recod in table 'rpm' that matches the Package.
-    /// Return an existing primary key or 0 if the record was not found.
-    static int64_t rpm_select_pk(libdnf5::utils::SQLite3::Statement & query, const Package & rpm);
-
-
     /// Use a query to select a record from 'rpm' table and populate a Package
     static bool rpm_select(libdnf5::utils::SQLite3::Query & query, int64_t rpm_id, Package & rpm);
 
@@ -57,7 +54,14 @@ public:
     static std::vector<Package> get_transaction_packages(libdnf5::utils::SQLite3 & conn, Transaction & trans);
 
 
-    /// Insert Package objects associated with a transaction into the database
+    /// Return the packages of all the `transactions` selected by a single query, mapped by the transaction ids.
+    /// The transactions without packages are missing in the result.
+    static std::unordered_map<int64_t, std::vector<Package>> get_transactions_packages(
+        libdnf5::utils::SQLite3 & conn, const std::vector<Transaction *> & transactions);
+
+
+    /// Insert Package objects associated with a transaction into the database.
+    /// The existing 'rpm' records of the packages are looked up by their names in bulk.
     static void insert_transaction_packages(libdnf5::utils::SQLite3 & conn, Transaction & trans);
 };
 
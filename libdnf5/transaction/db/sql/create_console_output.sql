@@ -0,0 +1,23 @@
+R"**(
+    BEGIN TRANSACTION;
+
+    CREATE TABLE IF NOT EXISTS "console_output" (
+        "id" INTEGER,
+        "trans_id" INTEGER NOT NULL,
+        "line" TEXT NOT NULL,                             /* a line of the output of the scriptlets */
+        PRIMARY KEY("id" AUTOINCREMENT),
+        FOREIGN KEY("trans_id") REFERENCES "trans"("id")
+    );
+
+    CREATE INDEX IF NOT EXISTS "console_output_trans_id" ON "console_output"("trans_id");
+    CREATE TABLE IF NOT EXISTS "console_output_chunk" (
+        "id" INTEGER,
+        "trans_id" INTEGER NOT NULL,
+        "data" BLOB NOT NULL,                             /* zstd compressed lines of the output of the scriptlets */
+        PRIMARY KEY("id" AUTOINCREMENT),
+        FOREIGN KEY("trans_id") REFERENCES "trans"("id")
+    );
+    CREATE INDEX IF NOT EXISTS "console_output_chunk_trans_id" ON "console_output_chunk"("trans_id");
+
+    COMMIT;
+)**"
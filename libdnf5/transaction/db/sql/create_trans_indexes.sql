@@ -0,0 +1,7 @@
+R"**(
+    BEGIN TRANSACTION;
+
+    CREATE INDEX IF NOT EXISTS "trans_dt_begin" ON "trans"("dt_begin");
+
+    COMMIT;
+)**"
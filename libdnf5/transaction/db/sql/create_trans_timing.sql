@@ -0,0 +1,18 @@
+R"**(
+    BEGIN TRANSACTION;
+
+    CREATE TABLE IF NOT EXISTS "trans_timing" (
+        "id" INTEGER,
+        "trans_id" INTEGER NOT NULL,
+        "step" TEXT NOT NULL,                             /* (enum) the measured step of the rpm transaction */
+        "nevra" TEXT NOT NULL,                            /* package of the install, erase and scriptlet steps */
+        "scriptlet" TEXT NOT NULL,                        /* scriptlet type of the scriptlet steps */
+        "duration_us" INTEGER NOT NULL,                   /* wall time of the step in microseconds */
+        PRIMARY KEY("id" AUTOINCREMENT),
+        FOREIGN KEY("trans_id") REFERENCES "trans"("id")
+    );
+
+    CREATE INDEX IF NOT EXISTS "trans_timing_trans_id" ON "trans_timing"("trans_id");
+
+    COMMIT;
+)**"
@@ -23,6 +23,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "db.hpp"
 
 #include "libdnf5/transaction/transaction.hpp"
+#include "libdnf5/transaction/transaction_history.hpp"
+
+#include <variant>
 
 
 namespace libdnf5::transaction {
@@ -46,7 +49,7 @@ static constexpr const char * select_sql = R"**(
 
 
 std::vector<int64_t> TransactionDbUtils::select_transaction_ids(const BaseWeakPtr & base) {
-    auto conn = transaction_db_connect(*base);
+    auto conn = transaction_db_connect(*base, true);
 
     auto query = libdnf5::utils::SQLite3::Query(*conn, "SELECT \"id\" FROM \"trans\" ORDER BY \"id\"");
 
@@ -84,7 +87,7 @@ std::vector<Transaction> TransactionDbUtils::load_from_select(
 
 std::vector<Transaction> TransactionDbUtils::select_transactions_by_ids(
     const BaseWeakPtr & base, const std::vector<int64_t> & ids) {
-    auto conn = transaction_db_connect(*base);
+    auto conn = transaction_db_connect(*base, true);
 
     std::string sql = select_sql;
 
@@ -112,7 +115,7 @@ std::vector<Transaction> TransactionDbUtils::select_transactions_by_ids(
 
 std::vector<Transaction> TransactionDbUtils::select_transactions_by_range(
     const BaseWeakPtr & base, int64_t start, int64_t end) {
-    auto conn = transaction_db_connect(*base);
+    auto conn = transaction_db_connect(*base, true);
 
     std::string sql = std::string(select_sql) + " WHERE \"trans\".\"id\" >= ? AND \"trans\".\"id\" <= ?";
 
@@ -123,6 +126,84 @@ std::vector<Transaction> TransactionDbUtils::select_transactions_by_range(
 }
 
 
+// Append the conditions of the filter to the `sql` selecting from the 'trans' table, the returned values
+// are bound to the parameters of the conditions in the order of the returned vector
+static std::vector<std::variant<int64_t, std::string>> append_filter_conditions(
+    std::string & sql, const TransactionListFilter & filter) {
+    std::vector<std::variant<int64_t, std::string>> params;
+    std::vector<std::string> conditions;
+    if (filter.dt_begin_min > 0) {
+        conditions.emplace_back("\"trans\".\"dt_begin\" >= ?");
+        params.emplace_back(filter.dt_begin_min);
+    }
+    if (filter.dt_begin_max > 0) {
+        conditions.emplace_back("\"trans\".\"dt_begin\" <= ?");
+        params.emplace_back(filter.dt_begin_max);
+    }
+    if (!filter.package_name.empty()) {
+        // uses the indexes on "pkg_name"("name"), "rpm"("name_id", ...) and "trans_item"("item_id")
+        conditions.emplace_back(R"**("trans"."id" IN (
+            SELECT "ti"."trans_id"
+            FROM "trans_item" "ti"
+            JOIN "rpm" ON "ti"."item_id" = "rpm"."item_id"
+            JOIN "pkg_name" ON "rpm"."name_id" = "pkg_name"."id"
+            WHERE "pkg_name"."name" = ?))**");
+        params.emplace_back(filter.package_name);
+    }
+    for (std::size_t idx = 0; idx < conditions.size(); ++idx) {
+        sql += idx == 0 ? " WHERE " : " AND ";
+        sql += conditions[idx];
+    }
+    return params;
+}
+
+
+static void bind_params(
+    libdnf5::utils::SQLite3::Statement & query, const std::vector<std::variant<int64_t, std::string>> & params) {
+    int pos = 0;
+    for (const auto & param : params) {
+        std::visit([&query, &pos](const auto & value) { query.bind(++pos, value); }, param);
+    }
+}
+
+
+std::vector<Transaction> TransactionDbUtils::select_transactions_by_filter(
+    const BaseWeakPtr & base, const TransactionListFilter & filter) {
+    auto conn = transaction_db_connect(*base, true);
+
+    std::string sql = select_sql;
+    auto params = append_filter_conditions(sql, filter);
+    sql += filter.descending ? " ORDER BY \"trans\".\"id\" DESC" : " ORDER BY \"trans\".\"id\"";
+    // a negative limit means no limit in SQLite
+    sql += " LIMIT ? OFFSET ?";
+    params.emplace_back(filter.limit > 0 ? filter.limit : -1);
+    params.emplace_back(filter.offset);
+
+    auto query = libdnf5::utils::SQLite3::Query(*conn, sql);
+    bind_params(query, params);
+
+    return TransactionDbUtils::load_from_select(base, query);
+}
+
+
+int64_t TransactionDbUtils::count_transactions_by_filter(
+    const BaseWeakPtr & base, const TransactionListFilter & filter) {
+    auto conn = transaction_db_connect(*base, true);
+
+    std::string sql = "SELECT COUNT(*) FROM \"trans\"";
+    auto params = append_filter_conditions(sql, filter);
+
+    auto query = libdnf5::utils::SQLite3::Statement(*conn, sql);
+    bind_params(query, params);
+
+    int64_t result = 0;
+    if (query.step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+        result = query.get<int64_t>(0);
+    }
+    return result;
+}
+
+
 static constexpr const char * SQL_TRANS_INSERT = R"**(
     INSERT INTO
         "trans" (
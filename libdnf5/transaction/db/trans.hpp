@@ -33,6 +33,7 @@ namespace libdnf5::transaction {
 
 
 class Transaction;
+struct TransactionListFilter;
 
 class TransactionDbUtils {
 public:
@@ -51,6 +52,13 @@ public:
     /// Selects transactions with ids within the [start, end] range (inclusive).
     static std::vector<Transaction> select_transactions_by_range(const BaseWeakPtr & base, int64_t start, int64_t end);
 
+    /// Selects one page of the transactions matching the filter.
+    static std::vector<Transaction> select_transactions_by_filter(
+        const BaseWeakPtr & base, const TransactionListFilter & filter);
+
+    /// Counts the transactions matching the filter, the page of the filter is ignored.
+    static int64_t count_transactions_by_filter(const BaseWeakPtr & base, const TransactionListFilter & filter);
+
     /// Create a query for inserting records to the 'trans' table
     static std::unique_ptr<libdnf5::utils::SQLite3::Statement> trans_insert_new_query(libdnf5::utils::SQLite3 & conn);
 
@@ -20,11 +20,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "trans_item.hpp"
 
+#include "db.hpp"
 #include "repo.hpp"
 
 #include "libdnf5/transaction/transaction.hpp"
 #include "libdnf5/transaction/transaction_item.hpp"
 
+#include <unordered_map>
+
 
 namespace libdnf5::transaction {
 
@@ -39,6 +42,26 @@ void TransItemDbUtils::transaction_item_select(libdnf5::utils::SQLite3::Query &
 }
 
 
+void TransItemDbUtils::transactions_items_select(
+    libdnf5::utils::SQLite3 & conn,
+    const char * sql_select,
+    const char * sql_order,
+    const std::vector<Transaction *> & transactions,
+    const std::function<void(libdnf5::utils::SQLite3::Query & query, Transaction & trans)> & row_callback) {
+    std::unordered_map<int64_t, Transaction *> id_to_transaction;
+    std::vector<int64_t> ids;
+    for (auto * trans : transactions) {
+        if (id_to_transaction.emplace(trans->get_id(), trans).second) {
+            ids.push_back(trans->get_id());
+        }
+    }
+
+    transaction_db_select_by_ids(conn, sql_select, ids, sql_order, [&](libdnf5::utils::SQLite3::Query & query) {
+        row_callback(query, *id_to_transaction.at(query.get<int64_t>("trans_id")));
+    });
+}
+
+
 static constexpr const char * SQL_TRANS_ITEM_INSERT = R"**(
     INSERT INTO
         "trans_item" (
@@ -70,15 +93,8 @@ std::unique_ptr<libdnf5::utils::SQLite3::Statement> TransItemDbUtils::trans_item
 
 
 int64_t TransItemDbUtils::transaction_item_insert(libdnf5::utils::SQLite3::Statement & query, TransactionItem & ti) {
-    // try to find an existing repo
-    auto query_repo_select_pkg = repo_select_pk_new_query(query.get_db());
-    auto repo_id = repo_select_pk(*query_repo_select_pkg, ti.get_repoid());
-
-    if (!repo_id) {
-        // if an existing repo was not found, insert a new record
-        auto query_repo_insert = repo_insert_new_query(query.get_db());
-        repo_id = repo_insert(*query_repo_insert, ti.get_repoid());
-    }
+    // find an existing repo or insert a new record
+    auto repo_id = repo_select_pk_or_insert(query.get_db(), ti.get_repoid());
 
     // save the transaction item
     query.bindv(
@@ -24,12 +24,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/sqlite3/sqlite3.hpp"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 
 namespace libdnf5::transaction {
 
 
+class Transaction;
 class TransactionItem;
 
 class TransItemDbUtils {
@@ -38,6 +41,17 @@ public:
     static void transaction_item_select(libdnf5::utils::SQLite3::Query & query, TransactionItem & ti);
 
 
+    /// Run the query `sql_select` of transaction items, which ends with the matched "trans_id" column, for all
+    /// the `transactions` at once and call `row_callback` with each returned row and the transaction it belongs to.
+    /// The query has to return the "trans_id" column.
+    static void transactions_items_select(
+        libdnf5::utils::SQLite3 & conn,
+        const char * sql_select,
+        const char * sql_order,
+        const std::vector<Transaction *> & transactions,
+        const std::function<void(libdnf5::utils::SQLite3::Query & query, Transaction & trans)> & row_callback);
+
+
     /// Create a query (statement) that inserts new records to the 'trans_item' table
     static std::unique_ptr<libdnf5::utils::SQLite3::Statement> trans_item_insert_new_query(
         libdnf5::utils::SQLite3 & conn);
@@ -0,0 +1,95 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "trans_timing.hpp"
+
+#include "libdnf5/transaction/transaction.hpp"
+
+#include <memory>
+
+
+namespace libdnf5::transaction {
+
+
+static constexpr const char * SQL_TRANS_TIMING_SELECT = R"**(
+    SELECT
+        "step",
+        "nevra",
+        "scriptlet",
+        "duration_us"
+    FROM
+        "trans_timing"
+    WHERE
+        "trans_id" = ?
+    ORDER BY
+        "id"
+)**";
+
+
+std::vector<TransactionTiming> TransTimingDbUtils::trans_timings_select(
+    libdnf5::utils::SQLite3 & conn, Transaction & trans) {
+    std::vector<TransactionTiming> result;
+
+    auto query = std::make_unique<libdnf5::utils::SQLite3::Query>(conn, SQL_TRANS_TIMING_SELECT);
+    query->bindv(trans.get_id());
+
+    while (query->step() == libdnf5::utils::SQLite3::Statement::StepResult::ROW) {
+        result.emplace_back(
+            transaction_timing_step_from_string(query->get<std::string>("step")),
+            query->get<std::string>("nevra"),
+            query->get<std::string>("scriptlet"),
+            query->get<int64_t>("duration_us"));
+    }
+
+    return result;
+}
+
+
+static constexpr const char * SQL_TRANS_TIMING_INSERT = R"**(
+    INSERT INTO
+        "trans_timing" (
+            "trans_id",
+            "step",
+            "nevra",
+            "scriptlet",
+            "duration_us"
+        )
+    VALUES
+        (?, ?, ?, ?, ?)
+)**";
+
+
+void TransTimingDbUtils::trans_timings_insert(libdnf5::utils::SQLite3 & conn, Transaction & trans) {
+    auto query = std::make_unique<libdnf5::utils::SQLite3::Statement>(conn, SQL_TRANS_TIMING_INSERT);
+    for (const auto & timing : trans.get_timings()) {
+        query->bindv(
+            trans.get_id(),
+            transaction_timing_step_to_string(timing.get_step()),
+            timing.get_nevra(),
+            timing.get_scriptlet(),
+            timing.get_duration_us());
+        query->step();
+        query->reset();
+    }
+}
+
+
+}  // namespace libdnf5::transaction
@@ -0,0 +1,49 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TRANSACTION_DB_TRANS_TIMING_HPP
+#define LIBDNF5_TRANSACTION_DB_TRANS_TIMING_HPP
+
+
+#include "utils/sqlite3/sqlite3.hpp"
+
+#include "libdnf5/transaction/transaction_timing.hpp"
+
+#include <vector>
+
+
+namespace libdnf5::transaction {
+
+
+class Transaction;
+
+class TransTimingDbUtils {
+public:
+    /// Load the timings of the transaction from the database
+    static std::vector<TransactionTiming> trans_timings_select(libdnf5::utils::SQLite3 & conn, Transaction & trans);
+
+    /// Insert the timings of the transaction into the database
+    static void trans_timings_insert(libdnf5::utils::SQLite3 & conn, Transaction & trans);
+};
+
+}  // namespace libdnf5::transaction
+
+
+#endif  // LIBDNF5_TRANSACTION_DB_TRANS_TIMING_HPP
@@ -21,11 +21,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf5/transaction/transaction.hpp"
 
 #include "db/comps_environment.hpp"
+#include "db/console_output.hpp"
 #include "db/comps_group.hpp"
 #include "db/db.hpp"
 #include "db/rpm.hpp"
 #include "db/trans.hpp"
 #include "db/trans_item.hpp"
+#include "db/trans_timing.hpp"
 
 #include "libdnf5/transaction/comps_environment.hpp"
 #include "libdnf5/transaction/comps_group.hpp"
@@ -92,7 +94,7 @@ std::vector<CompsEnvironment> & Transaction::get_comps_environments() {
     }
 
     comps_environments =
-        CompsEnvironmentDbUtils::get_transaction_comps_environments(*transaction_db_connect(*base), *this);
+        CompsEnvironmentDbUtils::get_transaction_comps_environments(*transaction_db_connect(*base, true), *this);
     return *comps_environments;
 }
 
@@ -112,7 +114,7 @@ std::vector<CompsGroup> & Transaction::get_comps_groups() {
         return *comps_groups;
     }
 
-    comps_groups = CompsGroupDbUtils::get_transaction_comps_groups(*transaction_db_connect(*base), *this);
+    comps_groups = CompsGroupDbUtils::get_transaction_comps_groups(*transaction_db_connect(*base, true), *this);
     return *comps_groups;
 }
 
@@ -132,11 +134,38 @@ std::vector<Package> & Transaction::get_packages() {
         return *packages;
     }
 
-    packages = RpmDbUtils::get_transaction_packages(*transaction_db_connect(*base), *this);
+    packages = RpmDbUtils::get_transaction_packages(*transaction_db_connect(*base, true), *this);
     return *packages;
 }
 
 
+std::vector<TransactionTiming> & Transaction::get_timings() {
+    if (timings) {
+        return *timings;
+    }
+
+    timings = TransTimingDbUtils::trans_timings_select(*transaction_db_connect(*base, true), *this);
+    return *timings;
+}
+
+
+void Transaction::set_console_output(std::string && value) {
+    ConsoleOutputCompressor compressor;
+    compressor.append(value);
+    console_output_chunks = compressor.finish();
+}
+
+
+std::vector<std::string> & Transaction::get_console_output() {
+    if (console_output) {
+        return *console_output;
+    }
+
+    console_output = ConsoleOutputDbUtils::console_output_select(*transaction_db_connect(*base, true), *this);
+    return *console_output;
+}
+
+
 Package & Transaction::new_package() {
     if (!packages) {
         packages.emplace();
@@ -272,6 +301,13 @@ void Transaction::finish(TransactionState state) {
         set_state(state);
         auto query = TransactionDbUtils::trans_update_new_query(*conn);
         TransactionDbUtils::trans_update(*query, *this);
+        if (timings) {
+            TransTimingDbUtils::trans_timings_insert(*conn, *this);
+        }
+        if (!console_output_chunks.empty()) {
+            ConsoleOutputDbUtils::console_output_insert(*conn, *this, console_output_chunks);
+            console_output_chunks.clear();
+        }
         conn->exec("COMMIT");
     } catch (...) {
         conn->exec("ROLLBACK");
@@ -20,10 +20,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf5/transaction/transaction_history.hpp"
 
+#include "db/comps_environment.hpp"
+#include "db/comps_group.hpp"
+#include "db/db.hpp"
+#include "db/rpm.hpp"
 #include "db/trans.hpp"
 
 #include "libdnf5/base/base.hpp"
 
+#include <unordered_set>
+
 
 namespace libdnf5::transaction {
 
@@ -54,6 +60,59 @@ std::vector<Transaction> TransactionHistory::list_all_transactions() {
     return TransactionDbUtils::select_transactions_by_ids(base, {});
 }
 
+std::vector<Transaction> TransactionHistory::list_filtered_transactions(const TransactionListFilter & filter) {
+    return TransactionDbUtils::select_transactions_by_filter(base, filter);
+}
+
+int64_t TransactionHistory::count_filtered_transactions(const TransactionListFilter & filter) {
+    return TransactionDbUtils::count_transactions_by_filter(base, filter);
+}
+
+void TransactionHistory::load_transaction_items(std::vector<Transaction> & transactions) {
+    std::vector<Transaction *> without_packages;
+    std::vector<Transaction *> without_groups;
+    std::vector<Transaction *> without_environments;
+    std::unordered_set<int64_t> seen_ids;
+    for (auto & trans : transactions) {
+        // a duplicate transaction loads its items lazily, the loaded items refer to the first one
+        if (!seen_ids.insert(trans.get_id()).second) {
+            continue;
+        }
+        if (!trans.packages) {
+            without_packages.push_back(&trans);
+        }
+        if (!trans.comps_groups) {
+            without_groups.push_back(&trans);
+        }
+        if (!trans.comps_environments) {
+            without_environments.push_back(&trans);
+        }
+    }
+    if (without_packages.empty() && without_groups.empty() && without_environments.empty()) {
+        return;
+    }
+
+    auto conn = transaction_db_connect(*base, true);
+    if (!without_packages.empty()) {
+        auto packages = RpmDbUtils::get_transactions_packages(*conn, without_packages);
+        for (auto * trans : without_packages) {
+            trans->packages = std::move(packages[trans->get_id()]);
+        }
+    }
+    if (!without_groups.empty()) {
+        auto groups = CompsGroupDbUtils::get_transactions_comps_groups(*conn, without_groups);
+        for (auto * trans : without_groups) {
+            trans->comps_groups = std::move(groups[trans->get_id()]);
+        }
+    }
+    if (!without_environments.empty()) {
+        auto environments = CompsEnvironmentDbUtils::get_transactions_comps_environments(*conn, without_environments);
+        for (auto * trans : without_environments) {
+            trans->comps_environments = std::move(environments[trans->get_id()]);
+        }
+    }
+}
+
 BaseWeakPtr TransactionHistory::get_base() const {
     return base;
 }
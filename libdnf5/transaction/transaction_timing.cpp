@@ -0,0 +1,80 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf5/transaction/transaction_timing.hpp"
+
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <utility>
+
+
+namespace libdnf5::transaction {
+
+InvalidTransactionTimingStep::InvalidTransactionTimingStep(const std::string & step)
+    : libdnf5::Error(M_("Invalid transaction timing step: {}"), step) {}
+
+
+std::string transaction_timing_step_to_string(TransactionTimingStep step) {
+    switch (step) {
+        case TransactionTimingStep::TRANSACTION:
+            return "Transaction";
+        case TransactionTimingStep::PREPARE:
+            return "Prepare";
+        case TransactionTimingStep::VERIFY:
+            return "Verify";
+        case TransactionTimingStep::INSTALL:
+            return "Install";
+        case TransactionTimingStep::ERASE:
+            return "Erase";
+        case TransactionTimingStep::SCRIPTLET:
+            return "Scriptlet";
+    }
+    return "";
+}
+
+
+TransactionTimingStep transaction_timing_step_from_string(const std::string & step) {
+    if (step == "Transaction") {
+        return TransactionTimingStep::TRANSACTION;
+    } else if (step == "Prepare") {
+        return TransactionTimingStep::PREPARE;
+    } else if (step == "Verify") {
+        return TransactionTimingStep::VERIFY;
+    } else if (step == "Install") {
+        return TransactionTimingStep::INSTALL;
+    } else if (step == "Erase") {
+        return TransactionTimingStep::ERASE;
+    } else if (step == "Scriptlet") {
+        return TransactionTimingStep::SCRIPTLET;
+    }
+
+    throw InvalidTransactionTimingStep(step);
+}
+
+
+TransactionTiming::TransactionTiming(
+    TransactionTimingStep step, std::string nevra, std::string scriptlet, int64_t duration_us)
+    : step(step),
+      nevra(std::move(nevra)),
+      scriptlet(std::move(scriptlet)),
+      duration_us(duration_us) {}
+
+
+}  // namespace libdnf5::transaction
@@ -0,0 +1,142 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "background.hpp"
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace libdnf5::utils {
+
+namespace {
+
+// The ioprio_set(2) and ioprio_get(2) constants, glibc provides neither wrappers nor definitions
+constexpr int IOPRIO_WHO_PROCESS = 1;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+
+constexpr int BACKGROUND_NICE = 19;
+
+int get_thread_id() {
+    return static_cast<int>(syscall(SYS_gettid));
+}
+
+std::optional<float> read_memory_pressure(const std::filesystem::path & pressure_path) {
+    std::ifstream file(pressure_path);
+    return parse_memory_pressure(file);
+}
+
+}  // namespace
+
+std::optional<float> parse_memory_pressure(std::istream & stream) {
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.starts_with("some ")) {
+            continue;
+        }
+        auto pos = line.find(" avg10=");
+        if (pos == std::string::npos) {
+            break;
+        }
+        try {
+            std::size_t len{0};
+            auto value = std::stof(line.substr(pos + 7), &len);
+            if (len > 0 && value >= 0) {
+                return value;
+            }
+        } catch (const std::exception &) {
+        }
+        break;
+    }
+    return std::nullopt;
+}
+
+float get_memory_pressure_limit(const ConfigMain & config) {
+    if (!config.get_background_mode_option().get_value()) {
+        return 0;
+    }
+    return config.get_background_memory_pressure_limit_option().get_value();
+}
+
+BackgroundPriority::BackgroundPriority(Logger & logger) : logger(logger) {
+    auto tid = get_thread_id();
+
+    // On Linux the nice value is a property of the thread, PRIO_PROCESS with a thread id changes only the thread
+    errno = 0;
+    auto nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+    if (errno == 0 && nice < BACKGROUND_NICE) {
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), BACKGROUND_NICE) == 0) {
+            old_nice = nice;
+            nice_changed = true;
+        } else {
+            logger.debug("Failed to lower the CPU priority: {}", std::strerror(errno));
+        }
+    }
+
+    auto ioprio = static_cast<int>(syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, tid));
+    if (ioprio != -1) {
+        if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == 0) {
+            old_ioprio = ioprio;
+        } else {
+            logger.debug("Failed to lower the I/O priority: {}", std::strerror(errno));
+        }
+    }
+}
+
+BackgroundPriority::~BackgroundPriority() {
+    auto tid = get_thread_id();
+    if (nice_changed && setpriority(PRIO_PROCESS, static_cast<id_t>(tid), old_nice) != 0) {
+        logger.debug("Failed to restore the CPU priority: {}", std::strerror(errno));
+    }
+    if (old_ioprio != -1 && syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, old_ioprio) != 0) {
+        logger.debug("Failed to restore the I/O priority: {}", std::strerror(errno));
+    }
+}
+
+void wait_for_memory_pressure(
+    Logger & logger, float limit, std::chrono::seconds max_wait, const std::filesystem::path & pressure_path) {
+    if (limit <= 0) {
+        return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + max_wait;
+    bool waiting = false;
+    for (auto pressure = read_memory_pressure(pressure_path); pressure && *pressure > limit;
+         pressure = read_memory_pressure(pressure_path)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            logger.info("Memory pressure {:.2f}% still exceeds {:.2f}%, continuing", *pressure, limit);
+            return;
+        }
+        if (!waiting) {
+            logger.info("Memory pressure {:.2f}% exceeds {:.2f}%, waiting", *pressure, limit);
+            waiting = true;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+}  // namespace libdnf5::utils
@@ -0,0 +1,72 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_UTILS_BACKGROUND_HPP
+#define LIBDNF5_UTILS_BACKGROUND_HPP
+
+#include "libdnf5/conf/config_main.hpp"
+#include "libdnf5/logger/logger.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <istream>
+#include <optional>
+
+namespace libdnf5::utils {
+
+/// Lowers the CPU priority (nice 19) and the I/O priority (idle class) of the calling thread for the lifetime
+/// of the object. The threads created by the calling thread in the meantime inherit the lowered priorities.
+/// The previous priorities of the calling thread are restored by the destructor if the system allows it,
+/// raising the priority again requires privileges. Failures are only logged.
+class BackgroundPriority {
+public:
+    explicit BackgroundPriority(Logger & logger);
+    ~BackgroundPriority();
+
+    BackgroundPriority(const BackgroundPriority &) = delete;
+    BackgroundPriority & operator=(const BackgroundPriority &) = delete;
+
+private:
+    Logger & logger;
+    int old_nice{0};
+    int old_ioprio{-1};
+    bool nice_changed{false};
+};
+
+/// Returns the "some avg10" value of the memory pressure stall information in the format of
+/// /proc/pressure/memory read from `stream`, std::nullopt when it is not present.
+std::optional<float> parse_memory_pressure(std::istream & stream);
+
+/// Returns the memory pressure limit in percent the repository updates wait for, 0 when they do not wait.
+/// Only the background mode waits.
+float get_memory_pressure_limit(const ConfigMain & config);
+
+/// Waits while the "some avg10" memory pressure stall information in `pressure_path` exceeds `limit` percent,
+/// but at most `max_wait` in total. Returns immediately when the `limit` is 0 or the pressure information
+/// is not available. The caller must not hold any lock, others would wait for it as well.
+void wait_for_memory_pressure(
+    Logger & logger,
+    float limit,
+    std::chrono::seconds max_wait = std::chrono::seconds(5 * 60),
+    const std::filesystem::path & pressure_path = "/proc/pressure/memory");
+
+}  // namespace libdnf5::utils
+
+#endif  // LIBDNF5_UTILS_BACKGROUND_HPP
@@ -0,0 +1,78 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf5/utils/bgettext/bgettext-common.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+struct CachedTranslation {
+    const char * domain;
+    const char * translation;
+};
+
+/// Translations looked up by a thread. The message ids are string literals, so they are keyed by their address.
+struct TranslationCache {
+    std::unordered_map<const char *, CachedTranslation> translations;
+    /// Locale passed to b_gettext_cache_use_locale(), empty for the global locale
+    std::string locale;
+    /// False when the locale could not be stored, the next b_gettext_cache_use_locale() call drops the cache
+    bool locale_known{true};
+};
+
+TranslationCache & get_thread_cache() {
+    thread_local TranslationCache cache;
+    return cache;
+}
+
+}  // namespace
+
+extern "C" {
+
+const char * b_dgettext_cached(const char * domain, const char * msgId) {
+    try {
+        auto & cache = get_thread_cache();
+        auto [it, inserted] = cache.translations.try_emplace(msgId, CachedTranslation{domain, nullptr});
+        if (inserted || it->second.domain != domain) {
+            it->second = {domain, dgettext(domain, msgId)};
+        }
+        return it->second.translation;
+    } catch (...) {
+        return dgettext(domain, msgId);
+    }
+}
+
+void b_gettext_cache_use_locale(const char * locale) {
+    auto & cache = get_thread_cache();
+    std::string_view name = locale ? locale : "";
+    if (!cache.locale_known || cache.locale != name) {
+        cache.translations.clear();
+        try {
+            cache.locale = name;
+            cache.locale_known = true;
+        } catch (...) {
+            cache.locale_known = false;
+        }
+    }
+}
+
+}  // extern "C"
@@ -41,7 +41,7 @@ const char * b_dpgettext(const char * domain, const char * context, const char *
 }
 
 const char * b_dpgettext2(const char * domain, const char * ctxMsgId, size_t msgIdOffset) {
-    const char * const translation = dgettext(domain, ctxMsgId);
+    const char * const translation = b_dgettext_cached(domain, ctxMsgId);
     if (translation == ctxMsgId)
         return ctxMsgId + msgIdOffset;
     return translation;
@@ -105,7 +105,7 @@ const char * b_dmgettext(const char * domain, struct BgettextMessage message, un
                 return strchr(msgId, 4) + 1;
             return translation;
         } else {
-            const char * const translation = dgettext(domain, msgId);
+            const char * const translation = b_dgettext_cached(domain, msgId);
             if ((*markedMsg & BGETTEXT_CONTEXT) && (translation == msgId))
                 return strchr(msgId, 4) + 1;
             return translation;
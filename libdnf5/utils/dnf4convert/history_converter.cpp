@@ -0,0 +1,484 @@
+/*
+Copyright (C) 2022 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/dnf5/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "history_converter.hpp"
+
+#include "transaction/db/db.hpp"
+#include "transaction/db/item.hpp"
+#include "transaction/db/repo.hpp"
+
+#include "libdnf5/transaction/transaction.hpp"
+#include "libdnf5/transaction/transaction_item_action.hpp"
+#include "libdnf5/transaction/transaction_item_reason.hpp"
+#include "libdnf5/transaction/transaction_item_state.hpp"
+
+#include <optional>
+#include <string>
+
+
+namespace libdnf5::dnf4convert {
+
+namespace {
+
+using Statement = libdnf5::utils::SQLite3::Statement;
+
+static constexpr const char * SQL_CREATE_CHECKPOINT = R"**(
+    CREATE TABLE IF NOT EXISTS "dnf4_conversion" (
+        "last_trans_id" INTEGER NOT NULL,                 /* id of the last converted dnf4 transaction */
+        "finished" INTEGER NOT NULL                       /* (bool) all the dnf4 transactions are converted */
+    );
+)**";
+
+static constexpr const char * SQL_SELECT_CHECKPOINT = R"**(
+    SELECT "last_trans_id", "finished" FROM "dnf4_conversion"
+)**";
+
+static constexpr const char * SQL_SELECT_CHECKPOINT_TABLE = R"**(
+    SELECT 1 FROM "sqlite_master" WHERE "type" = 'table' AND "name" = 'dnf4_conversion'
+)**";
+
+static constexpr const char * SQL_INSERT_CHECKPOINT = R"**(
+    INSERT INTO "dnf4_conversion" ("last_trans_id", "finished") VALUES (0, ?)
+)**";
+
+static constexpr const char * SQL_UPDATE_CHECKPOINT = R"**(
+    UPDATE "dnf4_conversion" SET "last_trans_id" = ?, "finished" = ?
+)**";
+
+static constexpr const char * SQL_COUNT_TRANS = R"**(
+    SELECT COUNT(*) FROM "main"."trans"
+)**";
+
+static constexpr const char * SQL_SELECT_DNF4_MAX_TRANS_ID = R"**(
+    SELECT MAX("id") FROM "dnf4"."trans"
+)**";
+
+static constexpr const char * SQL_RESERVE_TRANS_IDS = R"**(
+    UPDATE "main"."sqlite_sequence" SET "seq" = MAX("seq", ?) WHERE "name" = 'trans'
+)**";
+
+static constexpr const char * SQL_INSERT_TRANS_SEQUENCE = R"**(
+    INSERT INTO "main"."sqlite_sequence" ("name", "seq") VALUES ('trans', ?)
+)**";
+
+static constexpr const char * SQL_SELECT_DNF4_TRANS_CHUNK = R"**(
+    SELECT
+        "id",
+        "dt_begin",
+        "dt_end",
+        "rpmdb_version_begin",
+        "rpmdb_version_end",
+        "releasever",
+        "user_id",
+        "cmdline",
+        "comment",
+        "state"
+    FROM
+        "dnf4"."trans"
+    WHERE
+        "id" > ?
+    ORDER BY
+        "id"
+    LIMIT ?
+)**";
+
+static constexpr const char * SQL_INSERT_TRANS = R"**(
+    INSERT INTO
+        "main"."trans" (
+            "id",
+            "dt_begin",
+            "dt_end",
+            "rpmdb_version_begin",
+            "rpmdb_version_end",
+            "releasever",
+            "user_id",
+            "description",
+            "comment",
+            "state_id"
+        )
+    VALUES
+        (?, ?, ?, ?, ?, ?, ?, ?, ?, (SELECT "id" FROM "trans_state" WHERE "name" = ?))
+)**";
+
+static constexpr const char * SQL_SELECT_DNF4_RPM_ITEMS = R"**(
+    SELECT
+        "ti"."action",
+        "ti"."reason",
+        "ti"."state",
+        "repo"."repoid",
+        "rpm"."name",
+        "rpm"."epoch",
+        "rpm"."version",
+        "rpm"."release",
+        "rpm"."arch"
+    FROM
+        "dnf4"."trans_item" "ti"
+    JOIN
+        "dnf4"."rpm" "rpm" USING ("item_id")
+    JOIN
+        "dnf4"."repo" "repo" ON ("repo"."id" = "ti"."repo_id")
+    WHERE
+        "ti"."trans_id" = ?
+    ORDER BY
+        "ti"."id"
+)**";
+
+static constexpr const char * SQL_INSERT_PKG_NAME = R"**(
+    INSERT INTO "main"."pkg_name" ("name") VALUES (?) ON CONFLICT DO NOTHING
+)**";
+
+static constexpr const char * SQL_INSERT_ARCH = R"**(
+    INSERT INTO "main"."arch" ("name") VALUES (?) ON CONFLICT DO NOTHING
+)**";
+
+static constexpr const char * SQL_SELECT_RPM_PK = R"**(
+    SELECT
+        "item_id"
+    FROM
+        "main"."rpm"
+    WHERE
+        "name_id" = (SELECT "id" FROM "main"."pkg_name" WHERE "name" = ?)
+        AND "epoch" = ?
+        AND "version" = ?
+        AND "release" = ?
+        AND "arch_id" = (SELECT "id" FROM "main"."arch" WHERE "name" = ?)
+)**";
+
+static constexpr const char * SQL_INSERT_RPM = R"**(
+    INSERT INTO
+        "main"."rpm" (
+            "item_id",
+            "name_id",
+            "epoch",
+            "version",
+            "release",
+            "arch_id"
+        )
+    VALUES
+        (?, (SELECT "id" FROM "pkg_name" WHERE "name" = ?), ?, ?, ?, (SELECT "id" FROM "arch" WHERE "name" = ?))
+)**";
+
+static constexpr const char * SQL_INSERT_TRANS_ITEM = R"**(
+    INSERT INTO
+        "main"."trans_item" (
+            "trans_id",
+            "item_id",
+            "repo_id",
+            "action_id",
+            "reason_id",
+            "state_id"
+        )
+    VALUES (
+        ?,
+        ?,
+        ?,
+        (SELECT "id" FROM "trans_item_action" WHERE "name" = ?),
+        (SELECT "id" FROM "trans_item_reason" WHERE "name" = ?),
+        (SELECT "id" FROM "trans_item_state" WHERE "name" = ?)
+    )
+)**";
+
+static constexpr const char * SQL_CONVERT_CONSOLE_OUTPUT = R"**(
+    INSERT INTO
+        "main"."console_output" ("trans_id", "line")
+    SELECT
+        "trans_id", "line"
+    FROM
+        "dnf4"."console_output"
+    WHERE
+        "trans_id" > ? AND "trans_id" <= ?
+    ORDER BY
+        "id"
+)**";
+
+
+// Convert the dnf4 action of a transaction item, the actions of the packages leaving the system are REPLACED
+std::optional<transaction::TransactionItemAction> convert_action(int dnf4_action) {
+    using Action = transaction::TransactionItemAction;
+    switch (dnf4_action) {
+        case 1:  // INSTALL
+        case 4:  // OBSOLETE
+            return Action::INSTALL;
+        case 2:  // DOWNGRADE
+            return Action::DOWNGRADE;
+        case 6:  // UPGRADE
+            return Action::UPGRADE;
+        case 8:  // REMOVE
+            return Action::REMOVE;
+        case 9:  // REINSTALL
+            return Action::REINSTALL;
+        case 3:   // DOWNGRADED
+        case 5:   // OBSOLETED
+        case 7:   // UPGRADED
+        case 10:  // REINSTALLED
+            return Action::REPLACED;
+        case 11:  // REASON_CHANGE
+            return Action::REASON_CHANGE;
+        default:
+            return std::nullopt;
+    }
+}
+
+
+// dnf4 reasons have the same values as the dnf5 ones up to GROUP
+transaction::TransactionItemReason convert_reason(int dnf4_reason) {
+    using Reason = transaction::TransactionItemReason;
+    if (dnf4_reason < static_cast<int>(Reason::NONE) || dnf4_reason > static_cast<int>(Reason::GROUP)) {
+        return Reason::NONE;
+    }
+    return static_cast<Reason>(dnf4_reason);
+}
+
+
+// dnf4 states of transactions and their items are UNKNOWN (0), DONE (1) and ERROR (2)
+template <typename State>
+State convert_state(int dnf4_state) {
+    switch (dnf4_state) {
+        case 1:
+            return State::OK;
+        case 2:
+            return State::ERROR;
+        default:
+            return State::STARTED;
+    }
+}
+
+
+// Convert the rpm items of the dnf4 transaction `trans_id`
+void convert_rpm_items(libdnf5::utils::SQLite3 & conn, int64_t trans_id) {
+    auto & query_items = conn.get_cached_statement(SQL_SELECT_DNF4_RPM_ITEMS);
+    query_items.bindv(trans_id);
+    while (query_items.step() == Statement::StepResult::ROW) {
+        auto action = convert_action(query_items.get<int>(0));
+        if (!action) {
+            continue;
+        }
+        auto reason = convert_reason(query_items.get<int>(1));
+        auto state = convert_state<transaction::TransactionItemState>(query_items.get<int>(2));
+        auto repoid = query_items.get<std::string>(3);
+        auto name = query_items.get<std::string>(4);
+        auto epoch = query_items.get<int64_t>(5);
+        auto version = query_items.get<std::string>(6);
+        auto release = query_items.get<std::string>(7);
+        auto arch = query_items.get<std::string>(8);
+
+        auto & query_rpm_pk = conn.get_cached_statement(SQL_SELECT_RPM_PK);
+        query_rpm_pk.bindv(name, epoch, version, release, arch);
+        int64_t item_id = 0;
+        if (query_rpm_pk.step() == Statement::StepResult::ROW) {
+            item_id = query_rpm_pk.get<int64_t>(0);
+        }
+        query_rpm_pk.reset();
+
+        if (item_id == 0) {
+            conn.get_cached_statement(SQL_INSERT_PKG_NAME).bindv(name).step();
+            conn.get_cached_statement(SQL_INSERT_ARCH).bindv(arch).step();
+            item_id = transaction::item_insert(conn);
+            conn.get_cached_statement(SQL_INSERT_RPM).bindv(item_id, name, epoch, version, release, arch).step();
+        }
+
+        conn.get_cached_statement(SQL_INSERT_TRANS_ITEM)
+            .bindv(
+                trans_id,
+                item_id,
+                transaction::repo_select_pk_or_insert(conn, repoid),
+                transaction::transaction_item_action_to_string(*action),
+                transaction::transaction_item_reason_to_string(reason),
+                transaction::transaction_item_state_to_string(state))
+            .step();
+    }
+    query_items.reset();
+}
+
+
+// Start the conversion if it hasn't been started yet, returns whether there is something left to convert
+bool init_conversion(libdnf5::utils::SQLite3 & conn) {
+    auto & query_checkpoint = conn.get_cached_statement(SQL_SELECT_CHECKPOINT);
+    if (query_checkpoint.step() == Statement::StepResult::ROW) {
+        bool finished = query_checkpoint.get<bool>(1);
+        query_checkpoint.reset();
+        return !finished;
+    }
+    query_checkpoint.reset();
+
+    // the dnf5 history is already used, the dnf4 transactions are not mixed into it
+    auto & query_count = conn.get_cached_statement(SQL_COUNT_TRANS);
+    query_count.step();
+    bool dnf5_history_used = query_count.get<int64_t>(0) > 0;
+    query_count.reset();
+
+    conn.get_cached_statement(SQL_INSERT_CHECKPOINT).bindv(dnf5_history_used).step();
+    if (dnf5_history_used) {
+        return false;
+    }
+
+    // reserve the ids of the dnf4 transactions
+    auto & query_max_id = conn.get_cached_statement(SQL_SELECT_DNF4_MAX_TRANS_ID);
+    query_max_id.step();
+    auto max_id = query_max_id.get<int64_t>(0);
+    query_max_id.reset();
+    conn.get_cached_statement(SQL_RESERVE_TRANS_IDS).bindv(max_id).step();
+    if (conn.changes() == 0) {
+        conn.get_cached_statement(SQL_INSERT_TRANS_SEQUENCE).bindv(max_id).step();
+    }
+    return true;
+}
+
+
+// Convert the next chunk of transactions, returns whether there is something left to convert
+bool convert_chunk(libdnf5::utils::SQLite3 & conn, std::size_t chunk_size) {
+    // another process could have converted the chunk in the meantime, the checkpoint is read in the transaction
+    auto & query_checkpoint = conn.get_cached_statement(SQL_SELECT_CHECKPOINT);
+    if (query_checkpoint.step() != Statement::StepResult::ROW || query_checkpoint.get<bool>(1)) {
+        query_checkpoint.reset();
+        return false;
+    }
+    auto last_trans_id = query_checkpoint.get<int64_t>(0);
+    query_checkpoint.reset();
+
+    auto first_trans_id = last_trans_id;
+    auto & query_trans = conn.get_cached_statement(SQL_SELECT_DNF4_TRANS_CHUNK);
+    query_trans.bindv(last_trans_id, static_cast<int64_t>(chunk_size));
+    while (query_trans.step() == Statement::StepResult::ROW) {
+        last_trans_id = query_trans.get<int64_t>(0);
+        conn.get_cached_statement(SQL_INSERT_TRANS)
+            .bindv(
+                last_trans_id,
+                query_trans.get<int64_t>(1),
+                query_trans.get<int64_t>(2),
+                query_trans.get<std::string>(3),
+                query_trans.get<std::string>(4),
+                query_trans.get<std::string>(5),
+                query_trans.get<int64_t>(6),
+                query_trans.get<std::string>(7),
+                query_trans.get<std::string>(8),
+                transaction::transaction_state_to_string(
+                    convert_state<transaction::TransactionState>(query_trans.get<int>(9))))
+            .step();
+        convert_rpm_items(conn, last_trans_id);
+    }
+    query_trans.reset();
+
+    bool finished = last_trans_id == first_trans_id;
+    if (!finished) {
+        conn.get_cached_statement(SQL_CONVERT_CONSOLE_OUTPUT).bindv(first_trans_id, last_trans_id).step();
+    }
+    conn.get_cached_statement(SQL_UPDATE_CHECKPOINT).bindv(last_trans_id, finished).step();
+    return !finished;
+}
+
+
+// Whether the dnf5 database records a finished conversion, read by a read-only connection
+bool is_conversion_finished(
+    const std::filesystem::path & dnf5_db_path, libdnf5::utils::SQLite3::OpenOptions dnf5_db_options) {
+    if (!std::filesystem::exists(dnf5_db_path)) {
+        return false;
+    }
+    dnf5_db_options.read_only = true;
+    libdnf5::utils::SQLite3 conn(dnf5_db_path.native(), dnf5_db_options);
+    Statement query_table(conn, SQL_SELECT_CHECKPOINT_TABLE);
+    if (query_table.step() != Statement::StepResult::ROW) {
+        return false;
+    }
+    Statement query_checkpoint(conn, SQL_SELECT_CHECKPOINT);
+    return query_checkpoint.step() == Statement::StepResult::ROW && query_checkpoint.get<bool>(1);
+}
+
+
+// Run `func` in an immediate transaction, which takes the write lock before reading the checkpoint
+template <typename Func>
+bool run_in_transaction(libdnf5::utils::SQLite3 & conn, Func && func) {
+    conn.exec("BEGIN IMMEDIATE");
+    try {
+        bool result = func();
+        conn.exec("COMMIT");
+        return result;
+    } catch (...) {
+        conn.exec("ROLLBACK");
+        throw;
+    }
+}
+
+}  // namespace
+
+
+HistoryConverter::HistoryConverter(
+    std::filesystem::path dnf4_db_path,
+    std::filesystem::path dnf5_db_path,
+    libdnf5::utils::SQLite3::OpenOptions dnf5_db_options)
+    : dnf4_db_path(std::move(dnf4_db_path)),
+      dnf5_db_path(std::move(dnf5_db_path)),
+      dnf5_db_options(std::move(dnf5_db_options)) {}
+
+
+HistoryConverter::~HistoryConverter() {
+    stop();
+}
+
+
+bool HistoryConverter::convert(std::size_t chunk_size) {
+    if (!std::filesystem::exists(dnf4_db_path)) {
+        return true;
+    }
+    // the database is not written, nor locked, once the conversion is finished
+    if (is_conversion_finished(dnf5_db_path, dnf5_db_options)) {
+        return true;
+    }
+
+    auto conn = transaction::transaction_db_connect(dnf5_db_path, dnf5_db_options);
+    conn->exec(SQL_CREATE_CHECKPOINT);
+    Statement query_attach(*conn, "ATTACH DATABASE ? AS \"dnf4\"");
+    query_attach.bindv(dnf4_db_path.string()).step();
+
+    if (!run_in_transaction(*conn, [&conn] { return init_conversion(*conn); })) {
+        return true;
+    }
+    while (!stop_requested) {
+        if (!run_in_transaction(*conn, [&conn, chunk_size] { return convert_chunk(*conn, chunk_size); })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void HistoryConverter::start_background(libdnf5::Logger & logger) {
+    if (thread.joinable()) {
+        return;
+    }
+    stop_requested = false;
+    thread = std::thread([this, &logger] {
+        try {
+            convert();
+        } catch (const std::exception & ex) {
+            // the conversion resumes from the last converted chunk the next time
+            logger.warning("Cannot convert dnf4 transaction history: {}", ex.what());
+        }
+    });
+}
+
+
+void HistoryConverter::stop() {
+    stop_requested = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+}  // namespace libdnf5::dnf4convert
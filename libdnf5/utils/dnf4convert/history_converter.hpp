@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2022 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/dnf5/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_UTILS_DNF4CONVERT_HISTORY_CONVERTER_HPP
+#define LIBDNF5_UTILS_DNF4CONVERT_HISTORY_CONVERTER_HPP
+
+#include "utils/sqlite3/sqlite3.hpp"
+
+#include "libdnf5/logger/logger.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <thread>
+
+
+namespace libdnf5::dnf4convert {
+
+/// Converts the transactions of the dnf4 history database into the dnf5 history database.
+///
+/// The transactions are converted in chunks, each chunk in its own SQLite transaction together with
+/// the update of a checkpoint stored in the dnf5 database, so an interrupted conversion resumes with the next
+/// chunk. Only the rpm items and the console output of the transactions are converted.
+///
+/// The converted transactions keep their ids. The ids up to the last dnf4 transaction are reserved when the
+/// conversion starts, so that the transactions stored by dnf5 during the conversion get greater ids.
+/// The conversion starts only when the dnf5 history database contains no transactions.
+///
+/// The converter doesn't access the `Base`, the conversion can run in a background thread.
+class HistoryConverter {
+public:
+    /// Number of the dnf4 transactions converted in one SQLite transaction
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 100;
+
+    /// @param dnf4_db_path Path to the dnf4 history database.
+    /// @param dnf5_db_path Path to the dnf5 history database.
+    /// @param dnf5_db_options Options of the connection to the dnf5 history database.
+    HistoryConverter(
+        std::filesystem::path dnf4_db_path,
+        std::filesystem::path dnf5_db_path,
+        libdnf5::utils::SQLite3::OpenOptions dnf5_db_options);
+    HistoryConverter(const HistoryConverter &) = delete;
+    HistoryConverter & operator=(const HistoryConverter &) = delete;
+
+    /// Calls `stop()`.
+    ~HistoryConverter();
+
+    /// Converts the remaining dnf4 transactions, `chunk_size` of them in one SQLite transaction.
+    /// A finished conversion is detected by a read-only connection, the dnf5 database is neither written nor locked.
+    /// @return `true` when the conversion is finished or not needed, `false` when it was stopped by `stop()`.
+    /// @exception libdnf5::utils::SQLite3Error When reading or writing a database fails. The conversion can be
+    ///            resumed later, the converted chunks are kept.
+    bool convert(std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /// Runs `convert()` in a background thread. A failed conversion is logged to `logger` and retried by the next run.
+    /// The `logger` has to outlive the thread, `stop()` waits for it.
+    void start_background(libdnf5::Logger & logger);
+
+    /// Stops the conversion after the current chunk and waits for the background thread.
+    void stop();
+
+private:
+    std::filesystem::path dnf4_db_path;
+    std::filesystem::path dnf5_db_path;
+    libdnf5::utils::SQLite3::OpenOptions dnf5_db_options;
+    std::atomic<bool> stop_requested{false};
+    std::thread thread;
+};
+
+}  // namespace libdnf5::dnf4convert
+
+#endif  // LIBDNF5_UTILS_DNF4CONVERT_HISTORY_CONVERTER_HPP
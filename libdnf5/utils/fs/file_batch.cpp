@@ -0,0 +1,114 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "file_batch.hpp"
+
+#include "file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <system_error>
+#include <utility>
+#include <vector>
+
+
+namespace libdnf5::utils::fs {
+
+namespace {
+
+/// Returns whether the file at `path` exists and contains exactly `contents`.
+bool has_contents(const std::filesystem::path & path, const std::string & contents) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec || size != contents.size()) {
+        return false;
+    }
+    try {
+        return File(path, "r").read() == contents;
+    } catch (const std::filesystem::filesystem_error &) {
+        return false;
+    }
+}
+
+void sync_dir(const std::filesystem::path & dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::filesystem::filesystem_error(
+            "cannot open directory", dir, std::error_code(errno, std::system_category()));
+    }
+    int ret = ::fsync(fd);
+    int fsync_errno = errno;
+    ::close(fd);
+    if (ret == -1) {
+        throw std::filesystem::filesystem_error(
+            "cannot sync directory", dir, std::error_code(fsync_errno, std::system_category()));
+    }
+}
+
+}  // namespace
+
+
+void FileBatch::write(const std::string & file_name, std::string contents) {
+    files.insert_or_assign(file_name, std::move(contents));
+}
+
+
+std::size_t FileBatch::flush() {
+    auto scheduled = std::move(files);
+    files.clear();
+
+    // Write all changed files to temporary files first, then rename them, so that an error while writing
+    // leaves all the target files untouched
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> renames;
+    for (const auto & [file_name, contents] : scheduled) {
+        auto path = dir / file_name;
+        if (has_contents(path, contents)) {
+            continue;
+        }
+        if (renames.empty()) {
+            std::filesystem::create_directories(dir);
+        }
+        auto temporary_path = path;
+        temporary_path += ".temp";
+        try {
+            File(temporary_path, "w").write(contents);
+        } catch (...) {
+            for (const auto & [temporary, target] : renames) {
+                std::error_code ec;
+                std::filesystem::remove(temporary, ec);
+            }
+            std::error_code ec;
+            std::filesystem::remove(temporary_path, ec);
+            throw;
+        }
+        renames.emplace_back(std::move(temporary_path), std::move(path));
+    }
+    if (renames.empty()) {
+        return 0;
+    }
+
+    for (const auto & [temporary_path, path] : renames) {
+        std::filesystem::rename(temporary_path, path);
+    }
+    sync_dir(dir);
+    return renames.size();
+}
+
+}  // namespace libdnf5::utils::fs
@@ -0,0 +1,57 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_UTILS_FS_FILE_BATCH_HPP
+#define LIBDNF5_UTILS_FS_FILE_BATCH_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+
+
+namespace libdnf5::utils::fs {
+
+/// Collects the new contents of files in one directory and writes them all at once. Each file is written
+/// to a temporary file which is then renamed over the target file, so a reader sees either the old
+/// or the new contents. The directory is synced once after all the renames. The files whose contents
+/// did not change are not rewritten. Errors are raised as `std::filesystem::filesystem_error`.
+class FileBatch {
+public:
+    /// @param dir  The directory of the files, it is created by `flush()` when it does not exist.
+    explicit FileBatch(std::filesystem::path dir) : dir(std::move(dir)) {}
+
+    /// Schedules writing `contents` to the file `file_name` in the directory.
+    /// A later call for the same file replaces the scheduled contents.
+    void write(const std::string & file_name, std::string contents);
+
+    /// Writes the scheduled files and clears the schedule.
+    ///
+    /// @return The number of written files, the unchanged ones are not counted.
+    std::size_t flush();
+
+private:
+    std::filesystem::path dir;
+    std::map<std::string, std::string> files;
+};
+
+}  // namespace libdnf5::utils::fs
+
+#endif  // LIBDNF5_UTILS_FS_FILE_BATCH_HPP
@@ -19,22 +19,92 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/iniparser.hpp"
 
+#include "utils/fs/file.hpp"
+
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 namespace libdnf5 {
 
 constexpr char DELIMITER = '\n';
 
-IniParser::IniParser(const std::string & file_path) : file(file_path, "r") {}
+IniParser::IniParser(const std::string & file_path, bool keep_raw_items) : keep_raw_items(keep_raw_items) {
+    utils::fs::File file(file_path, "r");
+    auto fd = file.get_fd();
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        auto size = static_cast<std::size_t>(file_stat.st_size);
+        auto * addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            mapped_data = static_cast<const char *>(addr);
+            mapped_size = size;
+            input = std::string_view(mapped_data, mapped_size);
+            return;
+        }
+    }
+
+    // Special files (pipes, files with unknown size) are read into the buffer
+    char chunk[4096];
+    std::size_t length;
+    while ((length = file.read(chunk, sizeof(chunk))) > 0) {
+        buffer.append(chunk, length);
+    }
+    input = buffer;
+}
+
+IniParser::~IniParser() {
+    if (mapped_data) {
+        munmap(const_cast<char *>(mapped_data), mapped_size);
+    }
+}
+
+bool IniParser::read_line() {
+    if (input.empty()) {
+        return false;
+    }
+    auto eol = input.find(DELIMITER);
+    line = input.substr(0, eol);
+    input.remove_prefix(eol == std::string_view::npos ? input.size() : eol + 1);
+    while (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    ++line_number;
+
+    // remove UTF-8 BOM (Byte order mark)
+    constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+    if (line_number == 1 && line.starts_with(utf8_bom)) {
+        line.remove_prefix(utf8_bom.size());
+    }
+    return true;
+}
+
+void IniParser::append_raw_line() {
+    if (keep_raw_items) {
+        raw_item += line;
+        raw_item += DELIMITER;
+    }
+}
+
+void IniParser::append_value_line(std::string_view text) {
+    if (!value_in_buffer) {
+        value_buffer = value;
+        value_in_buffer = true;
+    }
+    value_buffer += DELIMITER;
+    value_buffer += text;
+    value = value_buffer;
+}
 
 void IniParser::trim_value() noexcept {
     auto end = value.find_last_not_of(DELIMITER);
-    if (end != std::string::npos) {
-        value.resize(end + 1);
+    if (end != std::string_view::npos) {
+        value.remove_suffix(value.size() - end - 1);
     }
     if (value.length() > 1 && value.front() == value.back() && (value.front() == '\"' || value.front() == '\'')) {
-        value.erase(--value.end());
-        value.erase(value.begin());
+        value.remove_suffix(1);
+        value.remove_prefix(1);
     }
 }
 
@@ -43,47 +113,33 @@ IniParser::ItemType IniParser::next() {
     raw_item.clear();
     while (true) {
         if (!line_ready) {
-            if (!file.read_line(line)) {
+            if (!read_line()) {
                 if (previous_line_with_key_val) {
                     trim_value();
                     return ItemType::KEY_VAL;
                 }
                 return ItemType::END_OF_INPUT;
             }
-            ++line_number;
             line_ready = true;
         }
 
-        // remove UTF-8 BOM (Byte order mark)
-        constexpr const char * utf8_bom = "\xEF\xBB\xBF";
-        if (line_number == 1 && line.compare(0, 3, utf8_bom) == 0) {
-            line.erase(0, 3);
-        }
-
         if (line.empty() || line[0] == '#' || line[0] == ';') {  // do not support [rR][eE][mM] comment
             if (previous_line_with_key_val) {
                 trim_value();
                 return ItemType::KEY_VAL;
             }
-            if (line.empty()) {
-                line_ready = false;
-                raw_item = DELIMITER;
-                return ItemType::EMPTY_LINE;
-            }
-            raw_item = line + DELIMITER;
+            append_raw_line();
             line_ready = false;
-            return ItemType::COMMENT_LINE;
+            return line.empty() ? ItemType::EMPTY_LINE : ItemType::COMMENT_LINE;
         }
         auto start = line.find_first_not_of(" \t\r");
-        if (start == std::string::npos) {
+        if (start == std::string_view::npos) {
+            append_raw_line();
+            line_ready = false;
             if (previous_line_with_key_val) {
-                value += DELIMITER;
-                raw_item += line + DELIMITER;
-                line_ready = false;
+                append_value_line({});
                 continue;
             }
-            raw_item = line + DELIMITER;
-            line_ready = false;
             return ItemType::EMPTY_LINE;
         }
         auto end = line.find_last_not_of(" \t\r");
@@ -95,7 +151,7 @@ IniParser::ItemType IniParser::next() {
 
         if (line[start] == '[') {
             auto end_sect_pos = line.find(']', ++start);
-            if (end_sect_pos == std::string::npos) {
+            if (end_sect_pos == std::string_view::npos) {
                 throw IniParserMissingBracketError(M_("Missing ']' on line {}"), line_number);
             }
             if (end_sect_pos == start) {
@@ -110,8 +166,8 @@ IniParser::ItemType IniParser::next() {
                     throw IniParserTextAfterSectionError(M_("Text after section on line {}"), line_number);
                 }
             }
-            this->section = line.substr(start, end_sect_pos - start);
-            raw_item = line + DELIMITER;
+            section = line.substr(start, end_sect_pos - start);
+            append_raw_line();
             line_ready = false;
             return ItemType::SECTION;
         }
@@ -124,32 +180,29 @@ IniParser::ItemType IniParser::next() {
             if (!previous_line_with_key_val) {
                 throw IniParserIllegalContinuationLineError(M_("Illegal continuation line on line {}"), line_number);
             }
-            value += DELIMITER + line.substr(start, end - start + 1);
-            raw_item += line + DELIMITER;
-            line_ready = false;
+            append_value_line(line.substr(start, end - start + 1));
         } else {
             if (line[start] == '=') {
                 throw IniParserMissingKeyError(M_("Missing option name on line {}"), line_number);
             }
             auto eql_pos = line.find_first_of('=');
-            if (eql_pos == std::string::npos) {
+            if (eql_pos == std::string_view::npos) {
                 throw IniParserMissingEqualError(M_("Missing '=' on line {}"), line_number);
             }
             auto endkeypos = line.find_last_not_of(" \t", eql_pos - 1);
             auto valuepos = line.find_first_not_of(" \t", eql_pos + 1);
             key = line.substr(start, endkeypos - start + 1);
-            if (valuepos != std::string::npos) {
+            if (valuepos != std::string_view::npos) {
                 value = line.substr(valuepos, end - valuepos + 1);
             } else {
-                value.clear();
+                value = {};
             }
+            value_in_buffer = false;
             previous_line_with_key_val = true;
-            raw_item = line + DELIMITER;
-            line_ready = false;
         }
+        append_raw_line();
+        line_ready = false;
     }
-    trim_value();
-    return previous_line_with_key_val ? ItemType::KEY_VAL : ItemType::END_OF_INPUT;
 }
 
 }  // namespace libdnf5
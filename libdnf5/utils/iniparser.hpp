@@ -20,12 +20,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF5_UTILS_INIPARSER_HPP
 #define LIBDNF5_UTILS_INIPARSER_HPP
 
-#include "utils/fs/file.hpp"
-
 #include "libdnf5/common/exception.hpp"
 
-#include <memory>
 #include <string>
+#include <string_view>
 
 
 namespace libdnf5 {
@@ -85,6 +83,9 @@ public:
 ///
 /// IniParser is lowlevel one pass parser of .ini files designed primary for DNF .ini configuration files.
 /// It parses input text to tokens - SECTION, KEY_VAL, COMMENT_LINE, EMPTY_LINE, and END_OF_INPUT.
+///
+/// The file is mapped into memory and the tokens are views of the mapped text. Only the values spanning multiple
+/// lines are joined into an internal buffer. The raw text of the items is assembled only when it is requested.
 class IniParser {
 public:
     enum class ItemType {
@@ -95,66 +96,56 @@ public:
         END_OF_INPUT
     };
 
-    explicit IniParser(const std::string & file_path);
+    /// @param file_path       Path to the parsed file
+    /// @param keep_raw_items  Whether to assemble the raw text of the items, it is needed only to write the parsed
+    ///                        data back with the original formatting
+    explicit IniParser(const std::string & file_path, bool keep_raw_items = true);
+    ~IniParser();
+
+    IniParser(const IniParser &) = delete;
+    IniParser & operator=(const IniParser &) = delete;
+
     /**
     * @brief Parse one item from input file
     *
     * Returns type of parsed item. Parsed values can be obtained by methods
-    * getSection(), getKey(), getValue().
+    * get_section(), get_key(), get_value(), get_raw_item().
+    * The section is valid for the lifetime of the parser, the other values until the next call.
     *
     * @return IniParser::ItemType Type of parsed value
     */
     ItemType next();
-    const std::string & get_section() const noexcept;
-    const std::string & get_key() const noexcept;
-    std::string & get_key() noexcept;
-    const std::string & get_value() const noexcept;
-    std::string & get_value() noexcept;
-    const std::string & get_raw_item() const noexcept;
-    std::string & get_raw_item() noexcept;
-    const std::string & get_line() const noexcept;
-    void clear_line() noexcept;
-    void trim_value() noexcept;
+    std::string_view get_section() const noexcept { return section; }
+    std::string_view get_key() const noexcept { return key; }
+    std::string_view get_value() const noexcept { return value; }
+    /// Returns the raw text of the last item, it is empty when the raw items are not kept
+    std::string_view get_raw_item() const noexcept { return raw_item; }
 
 private:
-    utils::fs::File file;
+    bool read_line();
+    void append_raw_line();
+    void append_value_line(std::string_view text);
+    void trim_value() noexcept;
+
+    const char * mapped_data{nullptr};
+    std::size_t mapped_size{0};
+    // Content of the file which cannot be mapped
+    std::string buffer;
+    // Not yet parsed part of the file content
+    std::string_view input;
+    bool keep_raw_items;
     int line_number{0};
-    std::string section;
-    std::string key;
-    std::string value;
+    std::string_view section;
+    std::string_view key;
+    std::string_view value;
+    // Joined lines of a multiline value
+    std::string value_buffer;
+    bool value_in_buffer{false};
     std::string raw_item;
-    std::string line;
+    std::string_view line;
     bool line_ready{false};
 };
 
-inline const std::string & IniParser::get_section() const noexcept {
-    return section;
-}
-inline const std::string & IniParser::get_key() const noexcept {
-    return key;
-}
-inline std::string & IniParser::get_key() noexcept {
-    return key;
-}
-inline const std::string & IniParser::get_value() const noexcept {
-    return value;
-}
-inline std::string & IniParser::get_value() noexcept {
-    return value;
-}
-inline const std::string & IniParser::get_raw_item() const noexcept {
-    return raw_item;
-}
-inline std::string & IniParser::get_raw_item() noexcept {
-    return raw_item;
-}
-inline const std::string & IniParser::get_line() const noexcept {
-    return line;
-}
-inline void IniParser::clear_line() noexcept {
-    line.clear();
-}
-
 }  // namespace libdnf5
 
 #endif
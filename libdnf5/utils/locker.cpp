@@ -29,18 +29,20 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf5::utils {
 
-bool Locker::read_lock() {
-    return lock(F_RDLCK);
+bool Locker::read_lock(bool wait) {
+    return lock(F_RDLCK, wait);
 }
 
-bool Locker::write_lock() {
-    return lock(F_WRLCK);
+bool Locker::write_lock(bool wait) {
+    return lock(F_WRLCK, wait);
 }
 
-bool Locker::lock(short int type) {
-    lock_fd = open(path.c_str(), O_CREAT | O_RDWR, 0660);
+bool Locker::lock(short int type, bool wait) {
     if (lock_fd == -1) {
-        throw SystemError(errno, M_("Failed to open lock file \"{}\""), path);
+        lock_fd = open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0660);
+        if (lock_fd == -1) {
+            throw SystemError(errno, M_("Failed to open lock file \"{}\""), path);
+        }
     }
 
     struct flock fl;
@@ -49,8 +51,12 @@ bool Locker::lock(short int type) {
     fl.l_whence = SEEK_SET;
     fl.l_start = 0;
     fl.l_len = 0;
+    // must be 0 for the open file description locks
     fl.l_pid = 0;
-    auto rc = fcntl(lock_fd, F_SETLK, &fl);
+    int rc;
+    do {
+        rc = fcntl(lock_fd, wait ? F_OFD_SETLKW : F_OFD_SETLK, &fl);
+    } while (rc == -1 && errno == EINTR);
     if (rc == -1) {
         if (errno == EACCES || errno == EAGAIN) {
             return false;
@@ -64,10 +70,12 @@ bool Locker::lock(short int type) {
 
 void Locker::unlock() {
     if (lock_fd != -1) {
-        if (close(lock_fd) == -1) {
+        auto fd = lock_fd;
+        lock_fd = -1;
+        if (close(fd) == -1) {
             throw SystemError(errno, M_("Failed to close lock file \"{}\""), path);
         }
-        if (unlink(path.c_str()) == -1) {
+        if (remove_on_unlock && unlink(path.c_str()) == -1) {
             throw SystemError(errno, M_("Failed to delete lock file \"{}\""), path);
         }
     }
@@ -24,18 +24,34 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf5::utils {
 
+/// Advisory lock of a file. The locks are owned by the Locker object (open file description locks), so they
+/// also exclude each other between threads of one process.
 class Locker {
 public:
-    explicit Locker(const std::string & path) : path(path){};
+    /// @param path The lock file, it is created when the lock is obtained.
+    /// @param remove_on_unlock Delete the lock file on unlock. It must not be set for shared locks, another holder
+    ///                         of the lock would keep a deleted file locked while new lockers create a new one.
+    explicit Locker(const std::string & path, bool remove_on_unlock = true)
+        : path(path),
+          remove_on_unlock(remove_on_unlock){};
     ~Locker();
-    bool read_lock();
-    bool write_lock();
+
+    /// Obtains a shared lock. With `wait` it waits until a conflicting exclusive lock is released.
+    /// @return `false` if the lock is held by someone else and `wait` is not set.
+    bool read_lock(bool wait = false);
+
+    /// Obtains an exclusive lock, or converts the shared lock to the exclusive one. With `wait` it waits until
+    /// all conflicting locks are released.
+    /// @return `false` if the lock is held by someone else and `wait` is not set.
+    bool write_lock(bool wait = false);
+
     void unlock();
 
 private:
-    bool lock(short int type);
+    bool lock(short int type, bool wait);
 
     std::string path;
+    bool remove_on_unlock;
     int lock_fd{-1};
 };
 
@@ -62,9 +62,11 @@ const char * SQLite3SQLError::SQLite3SQLError::what() const noexcept {
 
 void SQLite3::open() {
     if (db == nullptr) {
-        auto result = sqlite3_open(path.c_str(), &db);
+        auto flags = options.read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+        auto result = sqlite3_open_v2(path.c_str(), &db, flags, nullptr);
         if (result != SQLITE_OK) {
             sqlite3_close(db);
+            db = nullptr;
             throw SQLite3SQLError(result, M_("Failed to open database \"{}\""), path);
         }
 
@@ -72,18 +74,28 @@ void SQLite3::open() {
         // because even setting PRAGMAs can fail with "database is locked" error
         sqlite3_busy_timeout(db, 10000);
 
+        std::string pragmas = "PRAGMA locking_mode = NORMAL; PRAGMA foreign_keys = ON;";
+        if (!options.synchronous.empty()) {
+            pragmas += fmt::format(" PRAGMA synchronous = {};", options.synchronous);
+        }
+
+        auto journal_mode = options.journal_mode;
 #if SQLITE_VERSION_NUMBER >= 3022000
         int enabled = 1;
         sqlite3_file_control(db, "main", SQLITE_FCNTL_PERSIST_WAL, &enabled);
-        if (sqlite3_db_readonly(db, "main") == 1) {
-            exec("PRAGMA locking_mode = NORMAL; PRAGMA foreign_keys = ON;");
-        } else {
-            exec("PRAGMA locking_mode = NORMAL; PRAGMA journal_mode = WAL; PRAGMA foreign_keys = ON;");
+        if (journal_mode.empty()) {
+            journal_mode = "WAL";
         }
 #else
         // Journal mode WAL in readonly mode is supported from sqlite version 3.22.0
-        exec("PRAGMA locking_mode = NORMAL; PRAGMA journal_mode = TRUNCATE; PRAGMA foreign_keys = ON;");
+        if (journal_mode.empty()) {
+            journal_mode = "TRUNCATE";
+        }
 #endif
+        if (sqlite3_db_readonly(db, "main") != 1) {
+            pragmas += fmt::format(" PRAGMA journal_mode = {};", journal_mode);
+        }
+        exec(pragmas.c_str());
     }
 }
 
@@ -93,6 +105,9 @@ void SQLite3::close() {
         return;
     }
 
+    // the cached statements must be finalized before the database is closed
+    statement_cache.clear();
+
     auto result = sqlite3_close(db);
     if (result == SQLITE_BUSY) {
         sqlite3_stmt * res = nullptr;
@@ -108,6 +123,18 @@ void SQLite3::close() {
 }
 
 
+SQLite3::Statement & SQLite3::get_cached_statement(const std::string & sql) {
+    auto & statement = statement_cache[sql];
+    if (statement) {
+        statement->reset();
+        statement->clear_bindings();
+    } else {
+        statement = std::make_unique<Statement>(*this, sql);
+    }
+    return *statement;
+}
+
+
 void SQLite3::backup(const std::string & output_file) {
     sqlite3 * backup_db = nullptr;
 
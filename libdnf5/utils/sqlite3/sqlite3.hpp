@@ -28,6 +28,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 
@@ -153,6 +155,13 @@ public:
             }
         }
 
+        void bind(int pos, std::string_view val) {
+            auto result = sqlite3_bind_text(stmt, pos, val.data(), static_cast<int>(val.size()), SQLITE_TRANSIENT);
+            if (result != SQLITE_OK) {
+                throw SQLite3StatementSQLError(result, msg_bind_text_failed, get_expanded_sql());
+            }
+        }
+
         void bind(int pos, const Blob & val) {
             auto result = sqlite3_bind_blob(stmt, pos, val.data, static_cast<int>(val.size), SQLITE_TRANSIENT);
             if (result != SQLITE_OK) {
@@ -320,15 +329,35 @@ public:
         static const BgettextMessage msg_column_not_found;
     };
 
+    /// Options applied when the database is opened
+    struct OpenOptions {
+        /// Open the database read-only, the database file must exist
+        bool read_only{false};
+        /// Value of the `journal_mode` pragma, the journal mode is not changed in the read-only mode.
+        /// When empty, WAL is used if supported by SQLite, TRUNCATE otherwise.
+        std::string journal_mode;
+        /// Value of the `synchronous` pragma, the SQLite default is kept when empty
+        std::string synchronous;
+    };
+
     SQLite3(const SQLite3 &) = delete;
     SQLite3 & operator=(const SQLite3 &) = delete;
 
     explicit SQLite3(const std::string & db_path) : path{db_path}, db{nullptr} { open(); }
 
+    SQLite3(const std::string & db_path, OpenOptions options)
+        : path{db_path},
+          db{nullptr},
+          options{std::move(options)} {
+        open();
+    }
+
     ~SQLite3() { close(); }
 
     const std::string & get_path() const { return path; }
 
+    const OpenOptions & get_open_options() const { return options; }
+
     void open();
     void close();
     bool is_open() { return db != nullptr; };
@@ -340,6 +369,11 @@ public:
         }
     }
 
+    /// Returns the statement prepared from `sql` that is cached by the connection, it is prepared by the first call.
+    /// The returned statement is reset and its bindings are cleared. It is valid until the connection is closed.
+    /// The cache suits statements executed repeatedly, e.g. for every item of a transaction.
+    Statement & get_cached_statement(const std::string & sql);
+
     int changes() { return sqlite3_changes(db); }
 
     int64_t last_insert_rowid() { return sqlite3_last_insert_rowid(db); }
@@ -355,6 +389,9 @@ protected:
     sqlite3 * db;
 
 private:
+    OpenOptions options;
+    std::unordered_map<std::string, std::unique_ptr<Statement>> statement_cache;
+
     static const BgettextMessage msg_statement_exec_failed;
 };
 
@@ -0,0 +1,21 @@
+Name:           needs-rpmlib
+Epoch:          0
+Version:        1
+Release:        1
+Vendor:         dnf5-test
+
+License:        Public Domain
+URL:            http://example.com/
+
+Summary:        A dummy package requiring an rpmlib feature no rpm provides
+BuildArch:      noarch
+
+# createrepo_c does not store rpmlib() requires in the repository metadata
+Requires:       rpmlib(Dnf5TestNonexistentFeature) <= 1.0-1
+
+%description
+A dummy package requiring an rpmlib feature no rpm provides.
+
+%files
+
+%changelog
@@ -0,0 +1,207 @@
+# Copyright Contributors to the libdnf project.
+#
+# This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+#
+# Libdnf is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# Libdnf is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Benchmark of the per-invocation latency of common dnf5 commands.
+
+Each command runs many times against the fixture repositories and a fixture rpm database in a temporary installroot,
+from the warm metadata cache. For each command the p50 and p95 wall times, the peak RSS and, when strace is available,
+the number of system calls of one run are reported together with the mean durations of the --timings spans.
+
+The results are printed and appended as JSON lines shaped like the entries of the "benchmarks" array of the Google
+Benchmark JSON output to the file named by the LIBDNF5_BENCHMARK_OUTPUT environment variable, the same as the libdnf5
+benchmarks report them.
+
+Environment variables:
+    PROJECT_BINARY_DIR          the build directory with the test data, set by the "benchmark_dnf5_startup" target
+    DNF5_BINARY                 the dnf5 binary to benchmark, set by the target
+    DNF5_BENCHMARK_ITERATIONS   the number of measured runs of each command, 50 by default
+"""
+
+import json
+import glob
+import math
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+PROJECT_BINARY_DIR = os.environ["PROJECT_BINARY_DIR"]
+DNF5_BINARY = os.environ["DNF5_BINARY"]
+ITERATIONS = int(os.environ.get("DNF5_BENCHMARK_ITERATIONS", "50"))
+
+# name, arguments, accepted exit codes
+COMMANDS = [
+    ("version", ["--version"], (0,)),
+    ("repoquery", ["repoquery"], (0,)),
+    ("list_installed", ["list", "--installed"], (0,)),
+    ("check_upgrade", ["check-upgrade"], (0, 100)),
+    ("complete", ["in"], (0,)),
+]
+
+# the commands whose arguments are completed instead of run
+COMPLETED_COMMANDS = {"complete"}
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, math.ceil(fraction * len(ordered)) - 1)]
+
+
+class Installroot:
+    """A temporary installroot with the fixture rpm database and the configuration of the fixture repositories"""
+
+    def __init__(self):
+        self.path = tempfile.mkdtemp(prefix="dnf5-benchmark-")
+        self.config_file_path = os.path.join(self.path, "etc/dnf/dnf.conf")
+        os.makedirs(os.path.dirname(self.config_file_path))
+        with open(self.config_file_path, "w") as f:
+            f.write("")
+
+        # the packages of the first repository are recorded as installed, only the database is written
+        rpms = glob.glob(os.path.join(PROJECT_BINARY_DIR, "test/data/repos-rpm/rpm-repo1/*.rpm"))
+        rpms = [rpm for rpm in rpms if not rpm.endswith(".src.rpm")]
+        subprocess.run(["rpm", "--root", self.path, "--initdb"], check=True)
+        subprocess.run(
+            ["rpm", "--root", self.path, "--install", "--justdb", "--nodeps", "--noscripts", "--ignorearch"] + rpms,
+            check=True)
+
+    def args(self, command_args, complete=False):
+        global_args = [
+            "--installroot=" + self.path,
+            "--config=" + self.config_file_path,
+            "--setopt=reposdir=" + os.path.join(PROJECT_BINARY_DIR, "test/data/repos-rpm-conf.d"),
+            "--setopt=cachedir=" + os.path.join(self.path, "var/cache/dnf"),
+            "--setopt=pluginconfpath=" + os.path.join(self.path, "etc/dnf/libdnf5-plugins"),
+        ]
+        if complete:
+            # "--complete=<index>" has to be the first argument, it is followed by the completed command line
+            # and the index points to its last argument
+            args = [DNF5_BINARY] + global_args + command_args
+            return [DNF5_BINARY, "--complete={}".format(len(args) - 1)] + args
+        return [DNF5_BINARY] + global_args + command_args
+
+    def cleanup(self):
+        shutil.rmtree(self.path)
+
+
+def run(args, accepted_exit_codes):
+    """Runs the command and returns its wall time in seconds and its peak RSS in KiB"""
+    start = time.perf_counter()
+    process = subprocess.Popen(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    _, status, rusage = os.wait4(process.pid, 0)
+    wall_time = time.perf_counter() - start
+    exit_code = os.waitstatus_to_exitcode(status)
+    if exit_code not in accepted_exit_codes:
+        raise RuntimeError("Command {} failed with exit code {}".format(" ".join(args), exit_code))
+    return wall_time, rusage.ru_maxrss
+
+
+def count_syscalls(args):
+    """Returns the number of system calls of one run of the command including its threads, None without strace"""
+    strace = shutil.which("strace")
+    if not strace:
+        return None
+    with tempfile.NamedTemporaryFile(prefix="dnf5-benchmark-strace-") as output:
+        subprocess.run(
+            [strace, "-f", "-c", "-o", output.name] + args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        with open(output.name) as f:
+            for line in f:
+                # the summary line: "100.00    0.001234           1      1234        12 total"
+                fields = line.split()
+                if fields and fields[-1] == "total":
+                    return int(fields[3])
+    return None
+
+
+def span_durations(args, accepted_exit_codes, trace_path):
+    """Runs the command with a timings trace and returns the total durations of the spans by their names in ms"""
+    run(args[:1] + ["--timings-trace=" + trace_path] + args[1:], accepted_exit_codes)
+    durations = {}
+    try:
+        with open(trace_path) as f:
+            events = json.load(f)["traceEvents"]
+    except (OSError, ValueError, KeyError):
+        # commands finishing before the timings are reported, e.g. --version, write no trace
+        return durations
+    for event in events:
+        name = "span_" + re.sub(r"[^0-9A-Za-z]+", "_", event["name"]).strip("_") + "_ms"
+        durations[name] = durations.get(name, 0) + event["dur"] / 1000
+    return durations
+
+
+def report(name, iterations, counters):
+    result = {"name": name, "iterations": iterations, "real_time": counters.pop("p50_ns"), "time_unit": "ns"}
+    result.update(counters)
+    line = json.dumps(result)
+    print(line)
+    output_path = os.environ.get("LIBDNF5_BENCHMARK_OUTPUT")
+    if output_path:
+        with open(output_path, "a") as f:
+            f.write(line + "\n")
+
+
+def main():
+    installroot = Installroot()
+    try:
+        # the metadata cache is created once, the commands are measured with the warm cache
+        run(installroot.args(["makecache"]), (0,))
+
+        for name, command_args, accepted_exit_codes in COMMANDS:
+            complete = name in COMPLETED_COMMANDS
+            args = installroot.args(command_args, complete)
+            run(args, accepted_exit_codes)  # warm up the page cache
+
+            wall_times = []
+            max_rss = []
+            for _ in range(ITERATIONS):
+                wall_time, rss = run(args, accepted_exit_codes)
+                wall_times.append(wall_time)
+                max_rss.append(rss)
+
+            counters = {
+                "p50_ns": round(percentile(wall_times, 0.5) * 1e9),
+                "p95_ms": round(percentile(wall_times, 0.95) * 1e3, 3),
+                "max_rss_kib": max(max_rss),
+                "median_rss_kib": statistics.median(max_rss),
+            }
+            syscalls = count_syscalls(args)
+            if syscalls is not None:
+                counters["syscalls"] = syscalls
+
+            # the spans are averaged over a few runs, the runs with the recorder enabled are not measured above;
+            # the completion ends before any timings are reported
+            trace_path = os.path.join(installroot.path, "timings-trace.json")
+            span_runs = 0 if complete else min(ITERATIONS, 5)
+            span_totals = {}
+            for _ in range(span_runs):
+                for span, duration in span_durations(args, accepted_exit_codes, trace_path).items():
+                    span_totals[span] = span_totals.get(span, 0) + duration
+            for span, total in sorted(span_totals.items()):
+                counters[span] = round(total / span_runs, 3)
+
+            report("dnf5_startup/" + name, ITERATIONS, counters)
+    finally:
+        installroot.cleanup()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -20,8 +20,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_repoquery.hpp"
 
+#include <fmt/format.h>
 #include <libdnf5-cli/output/repoquery.hpp>
 
+#include <algorithm>
+#include <fstream>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RepoqueryTest);
 
@@ -76,6 +80,13 @@ void RepoqueryTest::test_format_set_with_tags() {
     CPPUNIT_ASSERT_EQUAL(
         std::string("pkg-libs-x86_64-222\npkg-x86_64-222\nunresolvable-noarch-222\n"), std::string(buf));
     free(buf);
+
+    // Duplicate lines are printed once
+    stream = open_memstream(&buf, &len);
+    libdnf5::cli::output::print_pkg_set_with_format(stream, *pkgs, "%{arch}\n");
+    CPPUNIT_ASSERT_EQUAL(fclose(stream), 0);
+    CPPUNIT_ASSERT_EQUAL(std::string("noarch\nx86_64\n"), std::string(buf));
+    free(buf);
 }
 
 
@@ -185,3 +196,58 @@ void RepoqueryTest::test_requires_filelists() {
     CPPUNIT_ASSERT_EQUAL(libdnf5::cli::output::requires_filelists("%{name}"), false);
     CPPUNIT_ASSERT_EQUAL(libdnf5::cli::output::requires_filelists("%{files}"), true);
 }
+
+
+void RepoqueryTest::test_format_set_concurrently() {
+    // Enough packages to be split among the workers, every name is used by two packages
+    std::ofstream repo(temp->get_path() / "large.repo");
+    repo << "=Ver: 3.0\n";
+    for (int idx = 0; idx < 40000; ++idx) {
+        repo << fmt::format("=Pkg: pkg{} {}.0 1.fc40 x86_64\n", idx % 20000, idx / 20000);
+    }
+    repo.close();
+    repo_sack->create_repo_from_libsolv_testcase("large", (temp->get_path() / "large.repo").native());
+    libdnf5::rpm::PackageQuery query(base);
+
+    auto format = [&query](const std::string & queryformat) {
+        char * buf = nullptr;
+        size_t len = 0;
+        FILE * stream = open_memstream(&buf, &len);
+        libdnf5::cli::output::print_pkg_set_with_format(stream, query, queryformat);
+        CPPUNIT_ASSERT_EQUAL(fclose(stream), 0);
+        std::string output(buf, len);
+        free(buf);
+        return output;
+    };
+
+    auto serial_nevras = format("%{name}-%{evr}.%{arch}\n");
+    auto serial_names = format("%-10{name}|\n");
+    base->get_config().get_output_format_threads_option().set(4);
+    CPPUNIT_ASSERT_EQUAL(serial_nevras, format("%{name}-%{evr}.%{arch}\n"));
+    // The lines of the same name are formatted in different chunks and printed once
+    auto concurrent_names = format("%-10{name}|\n");
+    CPPUNIT_ASSERT_EQUAL(serial_names, concurrent_names);
+    auto num_lines = static_cast<std::size_t>(std::count(concurrent_names.begin(), concurrent_names.end(), '\n'));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(20000 + 3), num_lines);
+}
+
+
+void RepoqueryTest::test_format_set_performance() {
+    // 20000 packages formatted the same way as by `repoquery --queryformat`
+    std::ofstream repo(temp->get_path() / "humongous.repo");
+    repo << "=Ver: 3.0\n";
+    for (int idx = 0; idx < 20000; ++idx) {
+        repo << fmt::format("=Pkg: pkg{} {}.0 {}.fc40 x86_64\n", idx, idx % 17, idx % 5);
+        repo << fmt::format("=Sum: Summary of the package number {}\n", idx);
+    }
+    repo.close();
+    repo_sack->create_repo_from_libsolv_testcase("humongous", (temp->get_path() / "humongous.repo").native());
+
+    libdnf5::rpm::PackageQuery query(base);
+    FILE * stream = fopen("/dev/null", "w");
+    for (int i = 0; i < 20; ++i) {
+        libdnf5::cli::output::print_pkg_set_with_format(
+            stream, query, "%{name}-%{epoch}:%{version}-%{release}.%{arch} %{evr} %{summary}\n");
+    }
+    CPPUNIT_ASSERT_EQUAL(fclose(stream), 0);
+}
@@ -34,12 +34,19 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class RepoqueryTest : public BaseTestCase {
     CPPUNIT_TEST_SUITE(RepoqueryTest);
 
+#ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_format_set_with_simple_str);
     CPPUNIT_TEST(test_format_set_with_tags);
     CPPUNIT_TEST(test_format_set_with_invalid_tags);
     CPPUNIT_TEST(test_format_set_with_tags_with_spacing);
     CPPUNIT_TEST(test_pkg_attr_uniq_sorted);
     CPPUNIT_TEST(test_requires_filelists);
+    CPPUNIT_TEST(test_format_set_concurrently);
+#endif
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_format_set_performance);
+#endif
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -52,6 +59,9 @@ public:
     void test_format_set_with_tags_with_spacing();
     void test_pkg_attr_uniq_sorted();
     void test_requires_filelists();
+    void test_format_set_concurrently();
+
+    void test_format_set_performance();
 
 private:
     std::unique_ptr<libdnf5::rpm::PackageQuery> pkgs;
@@ -223,3 +223,47 @@ void ArgumentParserTest::test_argument_parser() {
             arg_parser.parse(std::size(argv), argv), libdnf5::cli::ArgumentParserConflictingArgumentsError);
     }
 }
+
+
+void ArgumentParserTest::test_command_setup() {
+    ArgParser arg_parser;
+
+    ArgParser::Command * test = arg_parser.add_new_command("test");
+    arg_parser.set_root_command(test);
+
+    int install_setup_count = 0;
+    ArgParser::Command * install = arg_parser.add_new_command("install");
+    install->set_setup_func([&arg_parser, install, &install_setup_count]() {
+        ++install_setup_count;
+        install->set_description("Install packages");
+        auto * assumeyes = arg_parser.add_new_named_arg("assumeyes");
+        assumeyes->set_long_name("assumeyes");
+        assumeyes->set_short_name('y');
+        install->register_named_arg(assumeyes);
+    });
+    test->register_command(install);
+
+    int remove_setup_count = 0;
+    ArgParser::Command * remove = arg_parser.add_new_command("remove");
+    remove->set_setup_func([&remove_setup_count]() { ++remove_setup_count; });
+    test->register_command(remove);
+
+    // the commands are not set up until they are needed
+    CPPUNIT_ASSERT_EQUAL(0, install_setup_count);
+    CPPUNIT_ASSERT(install->get_named_args().empty());
+
+    constexpr const char * argv[]{"test", "install", "-y"};
+    arg_parser.parse(std::size(argv), argv);
+    CPPUNIT_ASSERT_EQUAL(install, arg_parser.get_selected_command());
+    CPPUNIT_ASSERT_EQUAL(1, install_setup_count);
+    CPPUNIT_ASSERT_EQUAL(1, arg_parser.get_named_arg("install.assumeyes", false).get_parse_count());
+    CPPUNIT_ASSERT_EQUAL(std::string("Install packages"), install->get_description());
+    CPPUNIT_ASSERT_EQUAL(0, remove_setup_count);
+
+    // the lookup by ID sets up the command, the setup is done only once
+    arg_parser.reset_parse_count();
+    arg_parser.parse(std::size(argv), argv);
+    CPPUNIT_ASSERT_EQUAL(&arg_parser.get_command("remove"), remove);
+    CPPUNIT_ASSERT_EQUAL(1, install_setup_count);
+    CPPUNIT_ASSERT_EQUAL(1, remove_setup_count);
+}
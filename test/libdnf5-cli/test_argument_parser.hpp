@@ -28,11 +28,13 @@ class ArgumentParserTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(ArgumentParserTest);
 
     CPPUNIT_TEST(test_argument_parser);
+    CPPUNIT_TEST(test_command_setup);
 
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_argument_parser();
+    void test_command_setup();
 };
 
 
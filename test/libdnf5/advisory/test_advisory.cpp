@@ -62,6 +62,20 @@ void AdvisoryAdvisoryTest::test_get_severity() {
     CPPUNIT_ASSERT_EQUAL(advisory.get_severity(), std::string("moderate"));
 }
 
+void AdvisoryAdvisoryTest::test_get_title() {
+    // Tests get_title method
+    libdnf5::advisory::AdvisoryQuery advisories(base);
+    advisories.filter_name("DNF-2019-1");
+    libdnf5::advisory::Advisory advisory = *advisories.begin();
+    CPPUNIT_ASSERT_EQUAL(std::string("bugfix_A-1.0-1"), advisory.get_title());
+
+    // The cached advisory fields are read again when more solvables are loaded
+    add_repo_rpm("rpm-repo1");
+    CPPUNIT_ASSERT_EQUAL(std::string("bugfix_A-1.0-1"), advisory.get_title());
+    CPPUNIT_ASSERT_EQUAL(std::string("DNF-2019-1"), advisory.get_name());
+    CPPUNIT_ASSERT_EQUAL(std::string("moderate"), advisory.get_severity());
+}
+
 void AdvisoryAdvisoryTest::test_get_references() {
     // Tests get_references method
     libdnf5::advisory::AdvisoryQuery advisories(base);
@@ -125,3 +139,30 @@ void AdvisoryAdvisoryTest::test_get_collections() {
     CPPUNIT_ASSERT_EQUAL((size_t)1, mods.size());
     CPPUNIT_ASSERT_EQUAL(std::string("perl"), mods[0].get_name());
 }
+
+void AdvisoryAdvisoryTest::test_is_applicable() {
+    // No module stream is active, advisories whose collections all have modules are not applicable
+    libdnf5::advisory::AdvisoryQuery advisories(base);
+    std::set<std::string> applicable;
+    for (const auto & advisory : advisories) {
+        if (advisory.is_applicable()) {
+            applicable.insert(advisory.get_name());
+        }
+    }
+    CPPUNIT_ASSERT((std::set<std::string>{"PKG-NEWER", "PKG-OLDER"}) == applicable);
+
+    // Evaluated in bulk for the whole query
+    advisories.filter_applicable();
+    std::set<std::string> filtered;
+    for (const auto & advisory : advisories) {
+        filtered.insert(advisory.get_name());
+    }
+    CPPUNIT_ASSERT(applicable == filtered);
+
+    auto adv_pkgs = libdnf5::advisory::AdvisoryQuery(base).get_advisory_packages_sorted_by_name_arch_evr(true);
+    CPPUNIT_ASSERT(!adv_pkgs.empty());
+    for (const auto & adv_pkg : adv_pkgs) {
+        CPPUNIT_ASSERT(adv_pkg.get_advisory_collection().is_applicable());
+        CPPUNIT_ASSERT(applicable.contains(adv_pkg.get_advisory().get_name()));
+    }
+}
@@ -33,8 +33,10 @@ class AdvisoryAdvisoryTest : public BaseTestCase {
     CPPUNIT_TEST(test_get_name);
     CPPUNIT_TEST(test_get_type);
     CPPUNIT_TEST(test_get_severity);
+    CPPUNIT_TEST(test_get_title);
     CPPUNIT_TEST(test_get_references);
     CPPUNIT_TEST(test_get_collections);
+    CPPUNIT_TEST(test_is_applicable);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -44,10 +46,12 @@ public:
     void test_get_name();
     void test_get_type();
     void test_get_severity();
+    void test_get_title();
     //void test_filter_package();
 
     void test_get_references();
     void test_get_collections();
+    void test_is_applicable();
 };
 
 
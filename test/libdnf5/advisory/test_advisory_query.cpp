@@ -135,6 +135,23 @@ void AdvisoryAdvisoryQueryTest::test_filter_cve() {
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(adv_query));
 }
 
+void AdvisoryAdvisoryQueryTest::test_filter_cve_batch() {
+    // Tests filter_reference method with many cves looked up in one call
+    std::vector<std::string> cves;
+    for (int i = 0; i < 500; ++i) {
+        cves.push_back("CVE-" + std::to_string(i));
+    }
+    cves.push_back("3333");
+    AdvisoryQuery adv_query(base);
+    adv_query.filter_reference(cves, "cve");
+    std::vector<Advisory> expected = {get_advisory("DNF-2020-1")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(adv_query));
+
+    adv_query = AdvisoryQuery(base);
+    adv_query.filter_reference(cves, "cve", libdnf5::sack::QueryCmp::NEQ);
+    CPPUNIT_ASSERT_EQUAL(AdvisoryQuery(base).size() - 1, adv_query.size());
+}
+
 void AdvisoryAdvisoryQueryTest::test_filter_bugzilla() {
     // Tests filter_reference method with bugzilla
     AdvisoryQuery adv_query(base);
@@ -208,3 +225,32 @@ void AdvisoryAdvisoryQueryTest::test_get_advisory_packages_sorted() {
     CPPUNIT_ASSERT_EQUAL(std::string("pkg"), adv_pkgs[1].get_name());
     CPPUNIT_ASSERT_EQUAL(std::string("0.1-1"), adv_pkgs[1].get_evr());
 }
+
+void AdvisoryAdvisoryQueryTest::test_get_advisory_packages_sorted_by_name_arch_evr() {
+    // The packages of the advisories in the query are taken from the index shared by all queries
+    auto all_pkgs = AdvisoryQuery(base).get_advisory_packages_sorted_by_name_arch_evr();
+    CPPUNIT_ASSERT(!all_pkgs.empty());
+
+    auto adv_query = AdvisoryQuery(base);
+    adv_query.filter_name("PKG-NEWER");
+    std::multiset<std::string> expected;
+    for (auto advisory : adv_query) {
+        for (auto & collection : advisory.get_collections()) {
+            for (auto & adv_pkg : collection.get_packages()) {
+                expected.insert(adv_pkg.get_nevra());
+            }
+        }
+    }
+
+    auto adv_pkgs = adv_query.get_advisory_packages_sorted_by_name_arch_evr();
+    std::multiset<std::string> actual;
+    for (auto & adv_pkg : adv_pkgs) {
+        CPPUNIT_ASSERT_EQUAL(std::string("PKG-NEWER"), adv_pkg.get_advisory().get_name());
+        actual.insert(adv_pkg.get_nevra());
+    }
+    CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+    CPPUNIT_ASSERT(expected == actual);
+
+    // Repeated calls return the same packages
+    CPPUNIT_ASSERT_EQUAL(all_pkgs.size(), AdvisoryQuery(base).get_advisory_packages_sorted_by_name_arch_evr().size());
+}
@@ -34,10 +34,12 @@ class AdvisoryAdvisoryQueryTest : public BaseTestCase {
     CPPUNIT_TEST(test_filter_type);
     CPPUNIT_TEST(test_filter_packages);
     CPPUNIT_TEST(test_filter_cve);
+    CPPUNIT_TEST(test_filter_cve_batch);
     CPPUNIT_TEST(test_filter_bugzilla);
     CPPUNIT_TEST(test_filter_reference);
     CPPUNIT_TEST(test_filter_severity);
     CPPUNIT_TEST(test_get_advisory_packages_sorted);
+    CPPUNIT_TEST(test_get_advisory_packages_sorted_by_name_arch_evr);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -49,10 +51,12 @@ public:
     void test_filter_type();
     void test_filter_packages();
     void test_filter_cve();
+    void test_filter_cve_batch();
     void test_filter_bugzilla();
     void test_filter_reference();
     void test_filter_severity();
     void test_get_advisory_packages_sorted();
+    void test_get_advisory_packages_sorted_by_name_arch_evr();
 };
 
 
@@ -21,11 +21,17 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_goal.hpp"
 
 #include "../shared/utils.hpp"
+#include "utils/fs/file.hpp"
 
 #include <libdnf5/base/goal.hpp>
+#include <libdnf5/base/solver_problems.hpp>
 #include <libdnf5/base/transaction_package.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <set>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BaseGoalTest);
 
@@ -224,6 +230,61 @@ void BaseGoalTest::test_remove_not_installed() {
     CPPUNIT_ASSERT_EQUAL(libdnf5::GoalUsedSetting::UNUSED, first_event.get_job_settings()->get_used_skip_unavailable());
 }
 
+void BaseGoalTest::test_remove_multiple_specs() {
+    add_repo_rpm("rpm-repo1");
+    add_system_pkg("repos-rpm/rpm-repo1/one-1-1.noarch.rpm", TransactionItemReason::DEPENDENCY);
+
+    // the remove specs are resolved together against the installed packages, the upgrade spec between them
+    // against all packages
+    libdnf5::Goal goal(base);
+    goal.add_rpm_remove("not_installed");
+    goal.add_rpm_upgrade("not_available");
+    goal.add_rpm_remove("one");
+    auto transaction = goal.resolve();
+
+    std::vector<libdnf5::base::TransactionPackage> expected = {libdnf5::base::TransactionPackage(
+        get_pkg("one-0:1-1.noarch", true),
+        TransactionItemAction::REMOVE,
+        TransactionItemReason::USER,
+        TransactionItemState::STARTED)};
+    CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+
+    auto & log = transaction.get_resolve_logs();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, log.size());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalAction::REMOVE, log[0].get_action());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NOT_FOUND, log[0].get_problem());
+    CPPUNIT_ASSERT_EQUAL(std::string("not_installed"), *log[0].get_spec());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalAction::UPGRADE, log[1].get_action());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NOT_FOUND, log[1].get_problem());
+    CPPUNIT_ASSERT_EQUAL(std::string("not_available"), *log[1].get_spec());
+}
+
+void BaseGoalTest::test_reason_change_multiple_specs() {
+    add_repo_rpm("rpm-repo1");
+    add_system_pkg("repos-rpm/rpm-repo1/one-1-1.noarch.rpm", TransactionItemReason::DEPENDENCY);
+
+    // the specs are resolved together against the installed packages
+    libdnf5::GoalJobSettings settings;
+    settings.skip_unavailable = libdnf5::GoalSetting::SET_TRUE;
+    libdnf5::Goal goal(base);
+    goal.add_rpm_reason_change(
+        std::vector<std::string>{"not_installed", "one"}, TransactionItemReason::USER, {}, settings);
+    auto transaction = goal.resolve();
+
+    std::vector<libdnf5::base::TransactionPackage> expected = {libdnf5::base::TransactionPackage(
+        get_pkg("one-0:1-1.noarch", true),
+        TransactionItemAction::REASON_CHANGE,
+        TransactionItemReason::USER,
+        TransactionItemState::STARTED)};
+    CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+
+    auto & log = transaction.get_resolve_logs();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, log.size());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalAction::REASON_CHANGE, log[0].get_action());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NOT_FOUND, log[0].get_problem());
+    CPPUNIT_ASSERT_EQUAL(std::string("not_installed"), *log[0].get_spec());
+}
+
 void BaseGoalTest::test_install_installed_pkg() {
     add_repo_rpm("rpm-repo1");
     add_system_pkg("repos-rpm/rpm-repo1/one-1-1.noarch.rpm", TransactionItemReason::DEPENDENCY);
@@ -552,3 +613,253 @@ void BaseGoalTest::test_install_or_reinstall() {
             TransactionItemState::STARTED)};
     CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
 }
+
+void BaseGoalTest::test_resolve_cache() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    base.get_config().get_resolve_cache_option().set(true);
+    auto sack = base.get_rpm_package_sack();
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+
+    std::vector<libdnf5::base::TransactionPackage> expected = {libdnf5::base::TransactionPackage(
+        get_pkg("pkg-0:1.2-3.x86_64"),
+        TransactionItemAction::INSTALL,
+        TransactionItemReason::USER,
+        TransactionItemState::STARTED)};
+    CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+    // the goal is resolved twice, the second time in the strict mode
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, sack->get_resolve_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_resolve_cache_misses());
+
+    // the same goal is resolved from the cache, including the reasons of the packages
+    libdnf5::Goal goal2(base);
+    goal2.add_rpm_install("pkg");
+    auto transaction2 = goal2.resolve();
+    CPPUNIT_ASSERT_EQUAL(expected, transaction2.get_transaction_packages());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_resolve_cache_hits());
+
+    // a different goal runs the solver
+    libdnf5::Goal goal3(base);
+    goal3.add_rpm_install("pkg-libs");
+    goal3.resolve();
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_resolve_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)4, sack->get_resolve_cache_misses());
+
+    // the priority and the cost of the repositories are inputs of the solver
+    repo->set_priority(10);
+    libdnf5::Goal goal4(base);
+    goal4.add_rpm_install("pkg");
+    goal4.resolve();
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_resolve_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)6, sack->get_resolve_cache_misses());
+
+    repo->set_cost(500);
+    libdnf5::Goal goal5(base);
+    goal5.add_rpm_install("pkg");
+    goal5.resolve();
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_resolve_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)8, sack->get_resolve_cache_misses());
+}
+
+void BaseGoalTest::test_resolve_stats() {
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+
+    auto & stats = transaction.get_resolve_stats();
+    // the goal is resolved twice, the second time in the strict mode
+    CPPUNIT_ASSERT_EQUAL(2, stats.solver_runs);
+    CPPUNIT_ASSERT_EQUAL(1, stats.transaction_steps);
+    CPPUNIT_ASSERT_EQUAL(0, stats.solver_problems);
+    CPPUNIT_ASSERT(stats.jobs >= 1);
+    CPPUNIT_ASSERT(stats.decisions >= 1);
+    CPPUNIT_ASSERT(!stats.from_resolve_cache);
+    CPPUNIT_ASSERT(stats.total >= stats.solve);
+}
+
+void BaseGoalTest::test_incremental() {
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.set_incremental(true);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT(!transaction.get_resolve_stats().reused_solver);
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, transaction.get_transaction_packages_count());
+
+    // the next resolve of the same goal with an additional job reuses the solver
+    goal.add_rpm_install("pkg-libs");
+    auto transaction2 = goal.resolve();
+    CPPUNIT_ASSERT(transaction2.get_resolve_stats().reused_solver);
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NO_PROBLEM, transaction2.get_problems());
+
+    std::vector<libdnf5::base::TransactionPackage> expected = {
+        libdnf5::base::TransactionPackage(
+            get_pkg("pkg-0:1.2-3.x86_64"),
+            TransactionItemAction::INSTALL,
+            TransactionItemReason::USER,
+            TransactionItemState::STARTED),
+        libdnf5::base::TransactionPackage(
+            get_pkg("pkg-libs-1:1.3-4.x86_64"),
+            TransactionItemAction::INSTALL,
+            TransactionItemReason::USER,
+            TransactionItemState::STARTED)};
+    CPPUNIT_ASSERT_EQUAL(expected, transaction2.get_transaction_packages());
+
+    // a change of the pool creates a new solver
+    add_repo_solv("solv-repo1");
+    auto transaction3 = goal.resolve();
+    CPPUNIT_ASSERT(!transaction3.get_resolve_stats().reused_solver);
+}
+
+void BaseGoalTest::test_debugdata_job_closure() {
+    auto debug_dir = temp->get_path() / "debugdata";
+    base.get_config().get_debug_solver_option().set(true);
+    base.get_config().get_debugdata_job_closure_option().set(true);
+    base.get_config().get_debugdir_option().set(debug_dir.native());
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    goal.resolve();
+
+    // only the packages reachable from the job are stored in the repository of the testcase
+    std::string repo_content;
+    for (const auto & entry : std::filesystem::directory_iterator(debug_dir / "packages")) {
+        if (entry.path().filename().native().starts_with("repomd-repo1")) {
+            repo_content = libdnf5::utils::fs::File(entry.path(), "r", true).read();
+        }
+    }
+    CPPUNIT_ASSERT(repo_content.find("=Pkg: pkg 1.2 3 x86_64") != std::string::npos);
+    CPPUNIT_ASSERT(repo_content.find("=Pkg: pkg-libs ") == std::string::npos);
+    CPPUNIT_ASSERT(repo_content.find("=Pkg: unresolvable ") == std::string::npos);
+}
+
+void BaseGoalTest::test_installonly_limit() {
+    // the kernel package is matched by two installonly provides, the kernel-core package by one
+    auto write_kernel = [](std::ostream & out, const std::string & version) {
+        out << "=Pkg: kernel " << version << " 1 x86_64\n=Prv: installonlypkg(kernel)\n"
+            << "=Req: kernel-core = " << version << "-1\n"
+            << "=Pkg: kernel-core " << version << " 1 x86_64\n=Prv: installonlypkg(kernel)\n";
+    };
+    auto system_path = temp->get_path() / "system.repo";
+    auto available_path = temp->get_path() / "available.repo";
+    {
+        std::ofstream system_repo(system_path);
+        std::ofstream available_repo(available_path);
+        system_repo << "=Ver: 3.0\n";
+        available_repo << "=Ver: 3.0\n";
+        write_kernel(system_repo, "6.0");
+        write_kernel(system_repo, "6.1");
+        write_kernel(available_repo, "6.2");
+    }
+    repo_sack->get_system_repo()->add_libsolv_testcase(system_path.native());
+    repo_sack->create_repo_from_libsolv_testcase("available", available_path.native());
+    base.get_config().get_installonly_limit_option().set(2);
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("kernel-6.2");
+    auto transaction = goal.resolve();
+
+    // the oldest versions of both names are removed, each package once
+    std::vector<std::string> actions;
+    for (const auto & tspkg : transaction.get_transaction_packages()) {
+        actions.push_back(
+            transaction_item_action_to_string(tspkg.get_action()) + " " + tspkg.get_package().get_nevra());
+    }
+    std::sort(actions.begin(), actions.end());
+    std::vector<std::string> expected = {
+        "Install kernel-6.2-1.x86_64",
+        "Install kernel-core-6.2-1.x86_64",
+        "Remove kernel-6.0-1.x86_64",
+        "Remove kernel-core-6.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, actions);
+}
+
+void BaseGoalTest::test_group_install_shared_packages() {
+    add_repo_repomd("repomd-comps-packages");
+
+    libdnf5::Goal goal(base);
+    goal.add_group_install("group-a", TransactionItemReason::USER);
+    goal.add_group_install("group-b", TransactionItemReason::USER);
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NO_PROBLEM, transaction.get_problems());
+    CPPUNIT_ASSERT_EQUAL((std::size_t)2, transaction.get_transaction_groups().size());
+
+    // the packages of both groups are resolved together, a package of both groups is installed once, the
+    // conditional package is installed only with its installed condition
+    std::vector<std::string> actions;
+    for (const auto & tspkg : transaction.get_transaction_packages()) {
+        actions.push_back(
+            transaction_item_action_to_string(tspkg.get_action()) + " " + tspkg.get_package().get_nevra() + " " +
+            transaction_item_reason_to_string(tspkg.get_reason()));
+    }
+    std::sort(actions.begin(), actions.end());
+    std::vector<std::string> expected = {
+        "Install cond-pkg-1.0-1.noarch Group",
+        "Install cond-trigger-1.0-1.noarch Group",
+        "Install pkg-a-1.0-1.noarch Group",
+        "Install pkg-b-1.0-1.noarch Group",
+        "Install pkg-c-1.0-1.noarch Group"};
+    CPPUNIT_ASSERT_EQUAL(expected, actions);
+
+    // without the group installing the condition, the conditional package and the optional package are skipped
+    libdnf5::Goal goal2(base);
+    goal2.add_group_install("group-a", TransactionItemReason::USER);
+    auto transaction2 = goal2.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NO_PROBLEM, transaction2.get_problems());
+    actions.clear();
+    for (const auto & tspkg : transaction2.get_transaction_packages()) {
+        actions.push_back(tspkg.get_package().get_nevra());
+    }
+    std::sort(actions.begin(), actions.end());
+    expected = {"pkg-a-1.0-1.noarch", "pkg-b-1.0-1.noarch"};
+    CPPUNIT_ASSERT_EQUAL(expected, actions);
+}
+
+
+void BaseGoalTest::test_solver_problems_unique() {
+    add_repo_solv("solv-nothing-provides");
+
+    // Both versions of app require a missing capability, both jobs lead to the same problem
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("app");
+    goal.add_rpm_install("app");
+    auto transaction = goal.resolve();
+
+    CPPUNIT_ASSERT(transaction.get_problems() & libdnf5::GoalProblem::SOLVER_ERROR);
+
+    const libdnf5::base::SolverProblems * solver_problems = nullptr;
+    for (const auto & event : transaction.get_resolve_logs()) {
+        if (event.get_solver_problems()) {
+            solver_problems = event.get_solver_problems();
+        }
+    }
+    CPPUNIT_ASSERT(solver_problems);
+
+    std::set<std::vector<std::string>> unique_problems;
+    for (const auto & problem : solver_problems->get_problems()) {
+        std::vector<std::string> rules;
+        for (const auto & rule : problem) {
+            rules.push_back(libdnf5::base::SolverProblems::problem_to_string(rule));
+        }
+        std::sort(rules.begin(), rules.end());
+
+        // Each rule is rendered once within a problem
+        CPPUNIT_ASSERT(std::adjacent_find(rules.begin(), rules.end()) == rules.end());
+        CPPUNIT_ASSERT(
+            std::find(rules.begin(), rules.end(), "nothing provides nonexistent needed by app-1-1.noarch") !=
+            rules.end());
+        CPPUNIT_ASSERT(
+            std::find(rules.begin(), rules.end(), "nothing provides nonexistent needed by app-2-1.noarch") !=
+            rules.end());
+
+        // The identical problem of the second job is reported once
+        CPPUNIT_ASSERT(unique_problems.insert(std::move(rules)).second);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)1, unique_problems.size());
+}
@@ -42,6 +42,8 @@ class BaseGoalTest : public BaseTestCase {
     CPPUNIT_TEST(test_reinstall_user);
     CPPUNIT_TEST(test_remove);
     CPPUNIT_TEST(test_remove_not_installed);
+    CPPUNIT_TEST(test_remove_multiple_specs);
+    CPPUNIT_TEST(test_reason_change_multiple_specs);
     CPPUNIT_TEST(test_upgrade);
     CPPUNIT_TEST(test_upgrade_from_cmdline);
     CPPUNIT_TEST(test_upgrade_not_downgrade_from_cmdline);
@@ -53,6 +55,13 @@ class BaseGoalTest : public BaseTestCase {
     CPPUNIT_TEST(test_downgrade_user);
     CPPUNIT_TEST(test_distrosync);
     CPPUNIT_TEST(test_distrosync_all);
+    CPPUNIT_TEST(test_resolve_cache);
+    CPPUNIT_TEST(test_resolve_stats);
+    CPPUNIT_TEST(test_incremental);
+    CPPUNIT_TEST(test_debugdata_job_closure);
+    CPPUNIT_TEST(test_installonly_limit);
+    CPPUNIT_TEST(test_group_install_shared_packages);
+    CPPUNIT_TEST(test_solver_problems_unique);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -74,6 +83,8 @@ public:
     void test_reinstall_user();
     void test_remove();
     void test_remove_not_installed();
+    void test_remove_multiple_specs();
+    void test_reason_change_multiple_specs();
     void test_upgrade();
     void test_upgrade_from_cmdline();
     void test_upgrade_not_downgrade_from_cmdline();
@@ -85,6 +96,13 @@ public:
     void test_downgrade_user();
     void test_distrosync();
     void test_distrosync_all();
+    void test_resolve_cache();
+    void test_resolve_stats();
+    void test_incremental();
+    void test_debugdata_job_closure();
+    void test_installonly_limit();
+    void test_group_install_shared_packages();
+    void test_solver_problems_unique();
 };
 
 
@@ -0,0 +1,258 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test_goal_benchmark.hpp"
+
+#include "../shared/benchmark.hpp"
+#include "solv/solv_map.hpp"
+#include "utils/fs/file.hpp"
+
+#include <fmt/format.h>
+#include <libdnf5/base/goal.hpp>
+#include <libdnf5/base/resolve_stats.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BaseGoalBenchmark);
+
+namespace {
+
+/// Number of the installed package names, the available repository contains as many other names
+constexpr std::size_t NAMES = 5000;
+
+/// Number of the installed versions of the kernel packages
+constexpr std::size_t INSTALLED_KERNELS = 3;
+
+/// Number of the available versions of the kernel packages per distribution release
+constexpr std::size_t KERNELS_PER_RELEASE = 20;
+
+/// Writes the package `name` of the distribution `release` in the testtags format. The package provides
+/// a versioned capability and requires the capabilities of two other packages of the same release, which ties
+/// the upgrades of the packages together.
+void write_package(std::ostream & out, std::size_t name, std::size_t release, bool broken) {
+    out << fmt::format(
+        "=Pkg: pkg{0} {1} 1.r{1} x86_64\n=Prv: pkg{0} = {1}-1.r{1}\n=Prv: pkg{0}-cap = {1}\n", name, release);
+    if (name > 0) {
+        out << fmt::format("=Req: pkg{}-cap >= {}\n", name / 2, release);
+    }
+    out << fmt::format("=Req: pkg{}-cap\n", (name * 7919 + 1) % NAMES);
+    if (broken) {
+        out << fmt::format("=Req: missing-cap{}\n", name);
+    }
+}
+
+/// Writes the kernel packages of the `version`, they are installonly by default
+void write_kernel(std::ostream & out, std::size_t version) {
+    out << fmt::format(
+        "=Pkg: kernel 6.{0} 1 x86_64\n=Prv: kernel = 6.{0}-1\n"
+        "=Req: kernel-core = 6.{0}-1\n=Req: kernel-modules = 6.{0}-1\n"
+        "=Pkg: kernel-core 6.{0} 1 x86_64\n=Prv: kernel-core = 6.{0}-1\n"
+        "=Pkg: kernel-modules 6.{0} 1 x86_64\n=Prv: kernel-modules = 6.{0}-1\n=Req: kernel-core = 6.{0}-1\n",
+        version);
+}
+
+}  // namespace
+
+
+void BaseGoalBenchmark::setUp() {
+    BaseTestCase::setUp();
+    // Every iteration has to run the solver
+    base.get_config().get_resolve_cache_option().set(false);
+}
+
+
+void BaseGoalBenchmark::load_distro_repos(std::size_t releases, std::size_t broken_step) {
+    auto system_path = temp->get_path() / "system.repo";
+    auto available_path = temp->get_path() / "available.repo";
+    {
+        std::ofstream system_repo(system_path);
+        std::ofstream available_repo(available_path);
+        system_repo << "=Ver: 3.0\n";
+        available_repo << "=Ver: 3.0\n";
+        for (std::size_t name = 0; name < NAMES * 2; ++name) {
+            if (name < NAMES) {
+                write_package(system_repo, name, 1, false);
+            }
+            for (std::size_t release = 1; release <= releases; ++release) {
+                bool broken = release == releases && broken_step > 0 && name % broken_step == 0;
+                write_package(available_repo, name, release, broken);
+            }
+        }
+        for (std::size_t version = 0; version < INSTALLED_KERNELS; ++version) {
+            write_kernel(system_repo, version);
+        }
+        for (std::size_t version = 0; version < releases * KERNELS_PER_RELEASE; ++version) {
+            write_kernel(available_repo, version);
+        }
+    }
+    repo_sack->get_system_repo()->add_libsolv_testcase(system_path.native());
+    repo_sack->create_repo_from_libsolv_testcase("available", available_path.native());
+}
+
+
+void BaseGoalBenchmark::benchmark(
+    const std::string & name, std::size_t iterations, const std::function<void(libdnf5::Goal &)> & add_jobs) {
+    libdnf5::base::ResolveStats sum;
+    std::size_t packages = 0;
+    std::size_t problems = 0;
+    auto copy_stats = libdnf5::solv::get_solv_map_copy_stats();
+    auto allocations = get_heap_allocation_count();
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        libdnf5::Goal goal(base);
+        add_jobs(goal);
+        auto transaction = goal.resolve();
+        const auto & stats = transaction.get_resolve_stats();
+        sum.spec_resolution += stats.spec_resolution;
+        sum.goal_setup += stats.goal_setup;
+        sum.job_construction += stats.job_construction;
+        sum.solver_init += stats.solver_init;
+        sum.solve += stats.solve;
+        sum.problems += stats.problems;
+        sum.set_transaction += stats.set_transaction;
+        sum.solver_runs += stats.solver_runs;
+        packages = transaction.get_transaction_packages_count();
+        problems = static_cast<std::size_t>(stats.solver_problems);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    allocations = get_heap_allocation_count() - allocations;
+    auto end_copy_stats = libdnf5::solv::get_solv_map_copy_stats();
+    auto shared_copies = end_copy_stats.shared - copy_stats.shared;
+    auto copies_on_write = end_copy_stats.copied_on_write - copy_stats.copied_on_write;
+    // bitmaps shared before the benchmark can be copied during it
+    auto copies_avoided = shared_copies > copies_on_write ? shared_copies - copies_on_write : 0;
+
+    auto mean = [iterations](std::chrono::microseconds duration) {
+        return static_cast<double>(duration.count()) / static_cast<double>(iterations);
+    };
+    auto mean_count = [iterations](std::size_t count) {
+        return static_cast<double>(count) / static_cast<double>(iterations);
+    };
+    report_benchmark(
+        "Goal/" + name,
+        iterations,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+        {{"spec_resolution us", mean(sum.spec_resolution)},
+         {"goal_setup us", mean(sum.goal_setup)},
+         {"job_construction us", mean(sum.job_construction)},
+         {"solver_init us", mean(sum.solver_init)},
+         {"solve us", mean(sum.solve)},
+         {"problems us", mean(sum.problems)},
+         {"set_transaction us", mean(sum.set_transaction)},
+         {"solver_runs", static_cast<double>(sum.solver_runs) / static_cast<double>(iterations)},
+         {"transaction_packages", static_cast<double>(packages)},
+         {"solver_problems", static_cast<double>(problems)},
+         // the package set copies that did not copy the bitmap
+         {"bitmap_copies_avoided", mean_count(copies_avoided)},
+         {"bitmap_copies_on_write", mean_count(copies_on_write)},
+         {"heap_allocations", mean_count(allocations)}});
+}
+
+
+void BaseGoalBenchmark::test_distro_upgrade() {
+    load_distro_repos(2, 0);
+
+    benchmark("distro_upgrade", 5, [](libdnf5::Goal & goal) { goal.add_rpm_upgrade(); });
+}
+
+
+void BaseGoalBenchmark::test_install_many() {
+    load_distro_repos(2, 0);
+
+    // Half of the not installed names, their dependencies pull in upgrades of the installed packages
+    std::vector<std::string> specs;
+    for (std::size_t name = NAMES; name < NAMES * 2; name += 2) {
+        specs.push_back(fmt::format("pkg{}", name));
+    }
+    benchmark("install_many", 5, [&specs](libdnf5::Goal & goal) {
+        for (const auto & spec : specs) {
+            goal.add_rpm_install(spec);
+        }
+    });
+}
+
+
+void BaseGoalBenchmark::test_installonly_kernel() {
+    base.get_config().get_installonly_limit_option().set(3);
+    load_distro_repos(2, 0);
+
+    benchmark("installonly_kernel", 20, [](libdnf5::Goal & goal) {
+        goal.add_rpm_upgrade("kernel");
+        goal.add_rpm_upgrade("kernel-core");
+        goal.add_rpm_upgrade("kernel-modules");
+    });
+}
+
+
+void BaseGoalBenchmark::test_skip_broken() {
+    load_distro_repos(2, 10);
+
+    benchmark("skip_broken_upgrade", 5, [](libdnf5::Goal & goal) {
+        libdnf5::GoalJobSettings settings;
+        settings.skip_broken = libdnf5::GoalSetting::SET_TRUE;
+        goal.add_rpm_upgrade(settings);
+    });
+}
+
+
+void BaseGoalBenchmark::test_broken_problems() {
+    load_distro_repos(2, 10);
+
+    benchmark("broken_problems", 5, [](libdnf5::Goal & goal) {
+        libdnf5::GoalJobSettings settings;
+        settings.best = libdnf5::GoalSetting::SET_TRUE;
+        goal.add_rpm_upgrade(settings);
+    });
+}
+
+
+void BaseGoalBenchmark::test_debugdata_upgrade() {
+    const char * debugdata_dir = std::getenv("LIBDNF5_BENCHMARK_DEBUGDATA");
+    if (!debugdata_dir) {
+        std::cout << "Skipped, LIBDNF5_BENCHMARK_DEBUGDATA is not set" << std::endl;
+        return;
+    }
+
+    // repo <name> <priority> <subpriority> testtags <file>
+    std::filesystem::path dir(debugdata_dir);
+    libdnf5::utils::fs::File testcase(dir / "testcase.t", "r");
+    std::string line;
+    while (testcase.read_line(line)) {
+        std::istringstream fields(line);
+        std::string keyword, name, priority, subpriority, format, file;
+        if (!(fields >> keyword >> name >> priority >> subpriority >> format >> file) || keyword != "repo" ||
+            format != "testtags") {
+            continue;
+        }
+        if (name == "@System") {
+            repo_sack->get_system_repo()->add_libsolv_testcase((dir / file).native());
+        } else {
+            repo_sack->create_repo_from_libsolv_testcase(name, (dir / file).native());
+        }
+    }
+
+    benchmark("debugdata_upgrade", 5, [](libdnf5::Goal & goal) { goal.add_rpm_upgrade(); });
+}
@@ -0,0 +1,83 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_BASE_GOAL_BENCHMARK_HPP
+#define TEST_LIBDNF5_BASE_GOAL_BENCHMARK_HPP
+
+
+#include "../shared/base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+
+/// Benchmarks of `Goal::resolve()` on synthetic repositories in the libsolv testtags format modeling real-world
+/// scenarios. Each result contains the mean durations of the phases from `ResolveStats` and the mean numbers
+/// of the package set bitmap copies avoided and made by copy-on-write, the results are reported
+/// by report_benchmark(). The resolve cache is disabled.
+///
+/// When the LIBDNF5_BENCHMARK_DEBUGDATA environment variable names a directory written by
+/// `RepoSack::dump_debugdata()` or by the `debug_solver` option, the repositories of its testcase are replayed too.
+class BaseGoalBenchmark : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(BaseGoalBenchmark);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_distro_upgrade);
+    CPPUNIT_TEST(test_install_many);
+    CPPUNIT_TEST(test_installonly_kernel);
+    CPPUNIT_TEST(test_skip_broken);
+    CPPUNIT_TEST(test_broken_problems);
+    CPPUNIT_TEST(test_debugdata_upgrade);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    /// Upgrade of all installed packages to the next release of the distribution
+    void test_distro_upgrade();
+    /// Installation of a large set of packages by name, e.g. an environment group
+    void test_install_many();
+    /// Upgrade of a system with the installonly kernel packages limited by `installonly_limit`
+    void test_installonly_kernel();
+    /// Installation of a large set of packages, some of them with broken dependencies, with `skip_broken`
+    void test_skip_broken();
+    /// Installation of a large set of packages, some of them with broken dependencies, producing solver problems
+    void test_broken_problems();
+    /// Upgrade of all packages in the repositories of the debug data named by LIBDNF5_BENCHMARK_DEBUGDATA
+    void test_debugdata_upgrade();
+
+private:
+    /// Loads the synthetic system repository and the available repository with the distribution releases
+    /// `1` to `releases`. A package of each `broken_step`-th name in the newest release requires a missing
+    /// capability, 0 means no broken packages.
+    void load_distro_repos(std::size_t releases, std::size_t broken_step);
+
+    /// Resolves the goal set up by `add_jobs` `iterations` times and reports the mean phase durations under `name`
+    void benchmark(
+        const std::string & name, std::size_t iterations, const std::function<void(libdnf5::Goal &)> & add_jobs);
+};
+
+
+#endif  // TEST_LIBDNF5_BASE_GOAL_BENCHMARK_HPP
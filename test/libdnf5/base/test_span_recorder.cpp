@@ -0,0 +1,118 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_span_recorder.hpp"
+
+#include <json.h>
+#include <libdnf5/base/span_recorder.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SpanRecorderTest);
+
+using SpanRecorder = libdnf5::base::SpanRecorder;
+
+void SpanRecorderTest::test_threads() {
+    SpanRecorder recorder;
+    {
+        SpanRecorder::Scope span(recorder, "disabled");
+    }
+    CPPUNIT_ASSERT(recorder.get_spans().empty());
+
+    recorder.set_enabled(true);
+    if (!recorder.is_enabled()) {
+        // libdnf5 built without the span recording support
+        return;
+    }
+
+    constexpr int num_threads = 4;
+    constexpr int num_spans = 100;
+    {
+        SpanRecorder::Scope span(recorder, "outer");
+        std::vector<std::thread> threads;
+        for (int thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+            threads.emplace_back([&recorder, thread_idx]() {
+                for (int span_idx = 0; span_idx < num_spans; ++span_idx) {
+                    SpanRecorder::Scope span(recorder, "inner", std::to_string(thread_idx));
+                }
+            });
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto spans = recorder.get_spans();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(num_threads * num_spans + 1), spans.size());
+    // The spans are ordered by their end, the outer span ends last
+    CPPUNIT_ASSERT_EQUAL(std::string("outer"), spans.back().name);
+    for (std::size_t idx = 1; idx < spans.size(); ++idx) {
+        CPPUNIT_ASSERT(spans[idx - 1].end <= spans[idx].end);
+    }
+
+    recorder.clear();
+    CPPUNIT_ASSERT(recorder.get_spans().empty());
+}
+
+void SpanRecorderTest::test_otlp_json() {
+    SpanRecorder recorder;
+    recorder.set_enabled(true);
+    if (!recorder.is_enabled()) {
+        // libdnf5 built without the span recording support
+        return;
+    }
+
+    {
+        SpanRecorder::Scope outer(recorder, "outer", "detail");
+        SpanRecorder::Scope inner(recorder, "inner");
+    }
+
+    auto * request = json_tokener_parse(recorder.to_otlp_json("test").c_str());
+    CPPUNIT_ASSERT(request);
+
+    json_object * resource_spans;
+    CPPUNIT_ASSERT(json_object_object_get_ex(request, "resourceSpans", &resource_spans));
+    json_object * scope_spans;
+    CPPUNIT_ASSERT(
+        json_object_object_get_ex(json_object_array_get_idx(resource_spans, 0), "scopeSpans", &scope_spans));
+    json_object * spans;
+    CPPUNIT_ASSERT(json_object_object_get_ex(json_object_array_get_idx(scope_spans, 0), "spans", &spans));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), json_object_array_length(spans));
+
+    // The spans are ordered by their start, the parent goes first
+    auto get_string = [](json_object * span, const char * key) -> std::string {
+        json_object * value;
+        return json_object_object_get_ex(span, key, &value) ? json_object_get_string(value) : "";
+    };
+    auto * outer = json_object_array_get_idx(spans, 0);
+    auto * inner = json_object_array_get_idx(spans, 1);
+    CPPUNIT_ASSERT_EQUAL(std::string("outer"), get_string(outer, "name"));
+    CPPUNIT_ASSERT_EQUAL(std::string("inner"), get_string(inner, "name"));
+    CPPUNIT_ASSERT_EQUAL(get_string(outer, "traceId"), get_string(inner, "traceId"));
+    CPPUNIT_ASSERT_EQUAL(std::string(), get_string(outer, "parentSpanId"));
+    CPPUNIT_ASSERT_EQUAL(get_string(outer, "spanId"), get_string(inner, "parentSpanId"));
+    CPPUNIT_ASSERT(
+        std::stoull(get_string(outer, "startTimeUnixNano")) <= std::stoull(get_string(inner, "startTimeUnixNano")));
+
+    json_object_put(request);
+}
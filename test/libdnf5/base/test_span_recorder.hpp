@@ -17,23 +17,25 @@ You should have received a copy of the GNU Lesser General Public License
 along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#ifndef DNF5_COMMANDS_COPR_TEMPFILE_HPP
-#define DNF5_COMMANDS_COPR_TEMPFILE_HPP
 
-#include <unistd.h>
+#ifndef TEST_LIBDNF5_BASE_SPAN_RECORDER_HPP
+#define TEST_LIBDNF5_BASE_SPAN_RECORDER_HPP
 
-#include <filesystem>
 
-/// TODO: make copr plugin work with libdnf5::utils::fs::TempFile (not a libdnf5 API ATM)
-class TempFile {
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class SpanRecorderTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(SpanRecorderTest);
+    CPPUNIT_TEST(test_threads);
+    CPPUNIT_TEST(test_otlp_json);
+    CPPUNIT_TEST_SUITE_END();
+
 public:
-    std::filesystem::path path;
-    TempFile() {
-        char temp_template[] = "/tmp/dnf5-copr-plugin-XXXXXX";
-        close(mkstemp(temp_template));
-        path = temp_template;
-    }
-    ~TempFile() { unlink(path.c_str()); }
+    void test_threads();
+    void test_otlp_json();
 };
 
-#endif  // DNF5_COMMANDS_COPR_TEMPFILE_HPP
+
+#endif  // TEST_LIBDNF5_BASE_SPAN_RECORDER_HPP
@@ -54,3 +54,58 @@ void BaseTransactionTest::test_check_gpg_signatures_fail() {
     CPPUNIT_ASSERT(!transaction.check_gpg_signatures());
     CPPUNIT_ASSERT(!transaction.get_gpg_signature_problems().empty());
 }
+
+void BaseTransactionTest::test_serialize_deserialize() {
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+    auto serialized = transaction.serialize();
+
+    auto replayed = libdnf5::base::Transaction::deserialize(base.get_weak_ptr(), serialized);
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NO_PROBLEM, replayed.get_problems());
+    CPPUNIT_ASSERT_EQUAL(transaction.get_transaction_packages(), replayed.get_transaction_packages());
+    CPPUNIT_ASSERT_EQUAL(serialized, replayed.serialize());
+}
+
+void BaseTransactionTest::test_deserialize_other_rpmdb() {
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto serialized = goal.resolve().serialize();
+
+    const std::string cookie_key = "\"rpmdb_cookie\":\"";
+    auto cookie_start = serialized.find(cookie_key);
+    CPPUNIT_ASSERT(cookie_start != std::string::npos);
+    cookie_start += cookie_key.size();
+    serialized.replace(cookie_start, serialized.find('"', cookie_start) - cookie_start, "0");
+
+    CPPUNIT_ASSERT_THROW(
+        libdnf5::base::Transaction::deserialize(base.get_weak_ptr(), serialized), libdnf5::base::TransactionError);
+    CPPUNIT_ASSERT_THROW(
+        libdnf5::base::Transaction::deserialize(base.get_weak_ptr(), "[]"), libdnf5::base::TransactionError);
+}
+
+void BaseTransactionTest::test_transaction_packages_view() {
+    add_repo_repomd("repomd-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+
+    auto view = transaction.get_transaction_packages_view();
+    CPPUNIT_ASSERT_EQUAL(transaction.get_transaction_packages_count(), view.size());
+    CPPUNIT_ASSERT_EQUAL(get_pkg("pkg-0:1.2-3.x86_64"), view[0].get_package());
+
+    // the lookup returns the transaction package stored in the transaction, not a copy
+    CPPUNIT_ASSERT_EQUAL(&view[0], transaction.get_transaction_package(view[0].get_package().get_id()));
+    CPPUNIT_ASSERT(transaction.get_transaction_package(get_pkg("pkg-libs-1:1.3-4.x86_64").get_id()) == nullptr);
+
+    // a copied transaction has its own packages and index
+    auto transaction_copy = transaction;
+    auto view_copy = transaction_copy.get_transaction_packages_view();
+    CPPUNIT_ASSERT(view_copy.data() != view.data());
+    CPPUNIT_ASSERT_EQUAL(&view_copy[0], transaction_copy.get_transaction_package(view[0].get_package().get_id()));
+}
@@ -33,6 +33,9 @@ class BaseTransactionTest : public BaseTestCase {
 #ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_check_gpg_signatures_no_gpgcheck);
     CPPUNIT_TEST(test_check_gpg_signatures_fail);
+    CPPUNIT_TEST(test_serialize_deserialize);
+    CPPUNIT_TEST(test_deserialize_other_rpmdb);
+    CPPUNIT_TEST(test_transaction_packages_view);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -43,6 +46,9 @@ class BaseTransactionTest : public BaseTestCase {
 public:
     void test_check_gpg_signatures_no_gpgcheck();
     void test_check_gpg_signatures_fail();
+    void test_serialize_deserialize();
+    void test_deserialize_other_rpmdb();
+    void test_transaction_packages_view();
 };
 
 
@@ -150,3 +150,25 @@ void CompsGroupQueryTest::test_query_filter_package_name() {
     expected = {get_group("critical-path-standard"), get_group("standard")};
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(q_groups));
 }
+
+
+void CompsGroupQueryTest::test_query_index_update() {
+    // A glob without wildcards is looked up in the index the same way as an equal id
+    GroupQuery q_groups(base);
+    q_groups.filter_groupid("core", libdnf5::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, q_groups.size());
+    auto core = q_groups.get();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, core.get_repos().size());
+    // The packages come from the definition in "repomd-comps-core-empty"
+    CPPUNIT_ASSERT(core.get_packages().empty());
+
+    // Loading a new repository updates the index and the group is composed of one more definition
+    add_repo_repomd("repomd-comps-core-v2");
+    q_groups = GroupQuery(base);
+    q_groups.filter_groupid("core", libdnf5::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, q_groups.size());
+    auto core_v2 = q_groups.get();
+    CPPUNIT_ASSERT_EQUAL((size_t)4, core_v2.get_repos().size());
+    // The packages come from the definition in "repomd-comps-core-v2"
+    CPPUNIT_ASSERT_EQUAL((size_t)4, core_v2.get_packages().size());
+}
@@ -57,3 +57,33 @@ void ConfTest::test_config_repo() {
     std::vector<std::string> baseurl = {"http://example.com/value123", "http://example.com/456"};
     CPPUNIT_ASSERT_EQUAL(baseurl, config_repo.get_baseurl_option().get_value());
 }
+
+void ConfTest::test_config_repo_binds() {
+    ConfigParser parser;
+    parser.add_section("repo-1");
+    parser.set_value("repo-1", "cost", "500");
+    parser.set_value("repo-1", "exclude", "pkg1");
+    parser.set_value("repo-1", "excludepkgs", "pkg2");
+    parser.set_value("repo-1", "proxy", "_NONE_");
+    parser.set_value("repo-1", "unknown_option", "value");
+
+    // The options are loaded without the bindings
+    repo::ConfigRepo config_repo(config, "test-repo");
+    config_repo.load_from_parser(parser, "repo-1", *base->get_vars(), logger);
+    CPPUNIT_ASSERT_EQUAL(500, config_repo.get_cost_option().get_value());
+    CPPUNIT_ASSERT_EQUAL(
+        (std::vector<std::string>{"pkg1", "pkg2"}), config_repo.get_excludepkgs_option().get_value());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), config_repo.get_proxy_option().get_value());
+    CPPUNIT_ASSERT_EQUAL(Option::Priority::REPOCONFIG, config_repo.get_proxy_option().get_priority());
+
+    // The bindings are registered on demand, also in a moved configuration
+    repo::ConfigRepo moved_config_repo(std::move(config_repo));
+    auto & binds = moved_config_repo.opt_binds();
+    CPPUNIT_ASSERT(binds.at("exclude").get_is_append_option());
+    CPPUNIT_ASSERT_EQUAL(std::string("500"), binds.at("cost").get_value_string());
+    binds.at("priority").new_string(Option::Priority::COMMANDLINE, "10");
+    CPPUNIT_ASSERT_EQUAL(10, moved_config_repo.get_priority_option().get_value());
+    binds.at("includepkgs").new_string(Option::Priority::COMMANDLINE, "pkg3");
+    CPPUNIT_ASSERT_EQUAL(
+        std::vector<std::string>{"pkg3"}, moved_config_repo.get_includepkgs_option().get_value());
+}
@@ -32,6 +32,7 @@ class ConfTest : public TestCaseFixture {
     CPPUNIT_TEST_SUITE(ConfTest);
     CPPUNIT_TEST(test_config_main);
     CPPUNIT_TEST(test_config_repo);
+    CPPUNIT_TEST(test_config_repo_binds);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,6 +40,7 @@ public:
 
     void test_config_main();
     void test_config_repo();
+    void test_config_repo_binds();
 
     std::unique_ptr<libdnf5::Base> base;
     libdnf5::LogRouter logger;
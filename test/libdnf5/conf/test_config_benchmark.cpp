@@ -0,0 +1,135 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "test_config_benchmark.hpp"
+
+#include "../shared/benchmark.hpp"
+
+#include <fmt/format.h>
+#include <libdnf5/base/base.hpp>
+#include <libdnf5/repo/repo_query.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConfigBenchmark);
+
+namespace {
+
+constexpr std::size_t REPO_FILES = 500;
+constexpr std::size_t REPO_SECTIONS = 1000;
+
+/// Returns the configuration of the repository `idx` using variables and options validated by regular expressions
+std::string get_repo_section(std::size_t idx) {
+    return fmt::format(
+        "# Repository {0}\n"
+        "[repo{0}]\n"
+        "name=Repository {0} - $releasever - $basearch\n"
+        "baseurl=https://mirror.example.com/repo{0}/${{releasever}}/$basearch/os/\n"
+        "        https://backup.example.com/repo{0}/${{releasever:-42}}/$basearch/os/\n"
+        "metalink=https://mirrors.example.com/metalink?repo=repo{0}-$releasever&arch=$basearch\n"
+        "enabled={1}\n"
+        "gpgcheck=1\n"
+        "gpgkey=file:///etc/pki/rpm-gpg/RPM-GPG-KEY-repo{0}-$releasever-$basearch\n"
+        "excludepkgs=excluded{0}*, other-excluded{0}\n"
+        "proxy_auth_method=basic\n"
+        "metadata_expire=6h\n"
+        "skip_if_unavailable=False\n"
+        "countme=1\n",
+        idx,
+        idx % 2);
+}
+
+}  // namespace
+
+
+void ConfigBenchmark::setUp() {
+    TestCaseFixture::setUp();
+    temp = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf5_benchmark");
+    std::filesystem::create_directories(temp->get_path() / "installroot");
+    std::ofstream(temp->get_path() / "dnf.conf") << "[main]\n";
+
+    auto reposdir = temp->get_path() / "repos.d";
+    std::filesystem::create_directories(reposdir);
+    for (std::size_t idx = 0; idx < REPO_FILES; ++idx) {
+        std::ofstream(reposdir / fmt::format("repo{}.repo", idx)) << get_repo_section(idx);
+    }
+
+    auto sections_reposdir = temp->get_path() / "sections.repos.d";
+    std::filesystem::create_directories(sections_reposdir);
+    std::ofstream sections_file(sections_reposdir / "sections.repo");
+    for (std::size_t idx = 0; idx < REPO_SECTIONS; ++idx) {
+        sections_file << get_repo_section(idx);
+    }
+}
+
+
+void ConfigBenchmark::benchmark(
+    const std::string & name,
+    std::size_t iterations,
+    bool use_snapshot,
+    const std::string & reposdir,
+    std::size_t expected_repos) {
+    std::chrono::nanoseconds elapsed{0};
+    std::size_t repos = 0;
+    // The first iteration writes the snapshot, it is not measured
+    for (std::size_t i = 0; i < iterations + (use_snapshot ? 1 : 0); ++i) {
+        libdnf5::Base base;
+        auto & config = base.get_config();
+        config.get_installroot_option().set(temp->get_path() / "installroot");
+        config.get_cachedir_option().set(temp->get_path() / "cache");
+        config.get_config_file_path_option().set(temp->get_path() / "dnf.conf");
+        config.get_reposdir_option().set(std::vector<std::string>{(temp->get_path() / reposdir).native()});
+        config.get_use_host_config_option().set(true);
+        config.get_repo_config_snapshot_option().set(use_snapshot);
+        base.get_vars()->set("arch", "x86_64");
+        base.get_vars()->set("releasever", "42");
+        base.setup();
+
+        auto start = std::chrono::steady_clock::now();
+        base.get_repo_sack()->create_repos_from_system_configuration();
+        auto duration = std::chrono::steady_clock::now() - start;
+        if (use_snapshot && i == 0) {
+            continue;
+        }
+        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+        repos = libdnf5::repo::RepoQuery(base).size();
+    }
+    CPPUNIT_ASSERT_EQUAL(expected_repos, repos);
+    report_benchmark("Config/" + name, iterations, elapsed, {{"repos", static_cast<double>(repos)}});
+}
+
+
+void ConfigBenchmark::test_create_repos() {
+    benchmark("create_repos", 5, false, "repos.d", REPO_FILES);
+}
+
+
+void ConfigBenchmark::test_create_repos_snapshot() {
+    benchmark("create_repos_snapshot", 5, true, "repos.d", REPO_FILES);
+}
+
+
+void ConfigBenchmark::test_create_repos_sections() {
+    benchmark("create_repos_sections", 5, false, "sections.repos.d", REPO_SECTIONS);
+}
@@ -0,0 +1,70 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef TEST_LIBDNF5_CONF_CONFIG_BENCHMARK_HPP
+#define TEST_LIBDNF5_CONF_CONFIG_BENCHMARK_HPP
+
+
+#include "../shared/test_case_fixture.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstddef>
+#include <string>
+
+
+/// Benchmarks of the creation of repositories from 500 repository configuration files, each with one repository
+/// using variables and options validated by regular expressions, and from one file with 1000 such repositories.
+/// Each iteration creates the repositories in a new base, the setup of the base is not measured. The results are
+/// reported by report_benchmark().
+class ConfigBenchmark : public TestCaseFixture {
+    CPPUNIT_TEST_SUITE(ConfigBenchmark);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_create_repos);
+    CPPUNIT_TEST(test_create_repos_snapshot);
+    CPPUNIT_TEST(test_create_repos_sections);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    /// Parses the configuration files
+    void test_create_repos();
+    /// Reads the parsed configuration files from the snapshot, see the "repo_config_snapshot" option
+    void test_create_repos_snapshot();
+    /// Parses one configuration file with 1000 repositories, the sections are looked up by key while parsing
+    void test_create_repos_sections();
+
+private:
+    /// Creates the repositories from `reposdir` in `iterations` new bases and reports the mean time under `name`
+    void benchmark(
+        const std::string & name,
+        std::size_t iterations,
+        bool use_snapshot,
+        const std::string & reposdir,
+        std::size_t expected_repos);
+};
+
+
+#endif  // TEST_LIBDNF5_CONF_CONFIG_BENCHMARK_HPP
@@ -31,6 +31,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/conf/option_string.hpp>
 #include <libdnf5/conf/option_string_list.hpp>
 
+#include <memory>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OptionTest);
 
@@ -395,6 +397,12 @@ void OptionTest::test_options_string_list() {
 
         CPPUNIT_ASSERT_THROW(option.set(Option::Priority::RUNTIME, "donutX, drain"), OptionValueNotAllowedError);
 
+        // A copy of the option validates the values with the same expression
+        std::unique_ptr<OptionStringList> copy(option.clone());
+        copy->set(Option::Priority::RUNTIME, "Dcopyx");
+        CPPUNIT_ASSERT_EQUAL((std::vector<std::string>{"Dcopyx"}), copy->get_value());
+        CPPUNIT_ASSERT_THROW(copy->set(Option::Priority::RUNTIME, "drain"), OptionValueNotAllowedError);
+
         option.lock("option locked by test_option_string_list");
         CPPUNIT_ASSERT_THROW(option.set(Option::Priority::RUNTIME, "doXXnut"), UserAssertionError);
         CPPUNIT_ASSERT_THROW(option.set(Option::Priority::RUNTIME, "invalid"), UserAssertionError);
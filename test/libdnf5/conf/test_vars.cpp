@@ -20,6 +20,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_vars.hpp"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(VarsTest);
 
@@ -76,3 +80,47 @@ void VarsTest::test_vars_env() {
         std::string("foo0-foo1-foo9-testvar1-testvar2-456"),
         base->get_vars()->substitute("${DNF0}-${DNF1}-${DNF9}-${var1}-${var41}-${var2}"));
 }
+
+void VarsTest::test_vars_changed() {
+    base->setup();
+    auto vars = base->get_vars();
+
+    // The memoized results are not used once a variable changes
+    const std::string text = "${var1:-default}-${var1:+a long alternate value of the variable}-$var1";
+    CPPUNIT_ASSERT_EQUAL(std::string("default--$var1"), vars->substitute(text));
+    vars->set("var1", "value");
+    CPPUNIT_ASSERT_EQUAL(std::string("value-a long alternate value of the variable-value"), vars->substitute(text));
+    vars->set("var1", "");
+    CPPUNIT_ASSERT_EQUAL(std::string("default--"), vars->substitute(text));
+    CPPUNIT_ASSERT_EQUAL(std::string("$var1 \\"), vars->substitute("\\$var1 \\\\"));
+}
+
+void VarsTest::test_vars_set_concurrent_substitute() {
+    base->setup();
+    auto vars = base->get_vars();
+    vars->set("var1", "0");
+
+    // substitute() runs while the variable is changed, every result is one of the set values
+    std::atomic<bool> stop{false};
+    std::atomic<bool> unexpected{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&vars, &stop, &unexpected]() {
+            while (!stop) {
+                auto result = vars->substitute("v$var1");
+                if (result != "v0" && result != "v1") {
+                    unexpected = true;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) {
+        vars->set("var1", i % 2 == 0 ? "1" : "0");
+    }
+    stop = true;
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    CPPUNIT_ASSERT(!unexpected);
+    CPPUNIT_ASSERT_EQUAL(std::string("v0"), vars->substitute("v$var1"));
+}
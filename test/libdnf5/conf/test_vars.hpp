@@ -32,6 +32,8 @@ class VarsTest : public TestCaseFixture {
     CPPUNIT_TEST(test_vars);
     CPPUNIT_TEST(test_vars_multiple_dirs);
     CPPUNIT_TEST(test_vars_env);
+    CPPUNIT_TEST(test_vars_changed);
+    CPPUNIT_TEST(test_vars_set_concurrent_substitute);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -40,6 +42,8 @@ public:
     void test_vars();
     void test_vars_multiple_dirs();
     void test_vars_env();
+    void test_vars_changed();
+    void test_vars_set_concurrent_substitute();
 
     std::unique_ptr<libdnf5::Base> base;
 };
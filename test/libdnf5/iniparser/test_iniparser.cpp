@@ -21,6 +21,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "utils/iniparser.hpp"
 
+#include <libdnf5/conf/config_parser.hpp>
+
 #include <memory>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(IniparserTest);
@@ -110,12 +112,12 @@ key1 = value1
     for (std::size_t idx = 0; idx < sizeof(expected_items) / sizeof(expected_items[0]); ++idx) {
         auto readedType = parser.next();
         CPPUNIT_ASSERT_EQUAL(readedType, expected_items[idx].type);
-        CPPUNIT_ASSERT_EQUAL(parser.get_section(), std::string(expected_items[idx].section));
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_section()), std::string(expected_items[idx].section));
         if (readedType == ItemType::KEY_VAL) {
-            CPPUNIT_ASSERT_EQUAL(parser.get_key(), std::string(expected_items[idx].key));
-            CPPUNIT_ASSERT_EQUAL(parser.get_value(), std::string(expected_items[idx].value));
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_key()), std::string(expected_items[idx].key));
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_value()), std::string(expected_items[idx].value));
         }
-        CPPUNIT_ASSERT_EQUAL(parser.get_raw_item(), std::string(expected_items[idx].raw));
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_raw_item()), std::string(expected_items[idx].raw));
     }
 }
 
@@ -165,11 +167,86 @@ key1 = value1)**";
     for (std::size_t idx = 0; idx < sizeof(expected_items) / sizeof(expected_items[0]); ++idx) {
         auto readedType = parser.next();
         CPPUNIT_ASSERT_EQUAL(readedType, expected_items[idx].type);
-        CPPUNIT_ASSERT_EQUAL(parser.get_section(), std::string(expected_items[idx].section));
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_section()), std::string(expected_items[idx].section));
+        if (readedType == ItemType::KEY_VAL) {
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_key()), std::string(expected_items[idx].key));
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_value()), std::string(expected_items[idx].value));
+        }
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_raw_item()), std::string(expected_items[idx].raw));
+    }
+}
+
+void IniparserTest::test_iniparser_without_raw_items() {
+    // Source data with UTF-8 BOM, CRLF line endings and without the final new line
+    const std::string ini_file_content =
+        "\xEF\xBB\xBF# Test comment\r\n[section1]\r\nkey1 = \"value1\"\r\n"
+        "key2 = two line\r\n  value2\r\n\r\nkey3=value3";
+
+    std::filesystem::path ini_path = temp_dir->get_path() / "test.ini";
+    libdnf5::utils::fs::File(ini_path, "w").write(ini_file_content);
+
+    // Expected results from parser
+    const Item expected_items[] = {
+        {ItemType::COMMENT_LINE, "", "", "", ""},
+        {ItemType::SECTION, "section1", "", "", ""},
+        {ItemType::KEY_VAL, "section1", "key1", "value1", ""},
+        {ItemType::KEY_VAL, "section1", "key2", "two line\nvalue2", ""},
+        {ItemType::EMPTY_LINE, "section1", "", "", ""},
+        {ItemType::KEY_VAL, "section1", "key3", "value3", ""},
+        {ItemType::END_OF_INPUT, "section1", "", "", ""}};
+
+    // Parse input
+    libdnf5::IniParser parser(ini_path, false);
+    for (std::size_t idx = 0; idx < sizeof(expected_items) / sizeof(expected_items[0]); ++idx) {
+        auto readedType = parser.next();
+        CPPUNIT_ASSERT_EQUAL(readedType, expected_items[idx].type);
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_section()), std::string(expected_items[idx].section));
         if (readedType == ItemType::KEY_VAL) {
-            CPPUNIT_ASSERT_EQUAL(parser.get_key(), std::string(expected_items[idx].key));
-            CPPUNIT_ASSERT_EQUAL(parser.get_value(), std::string(expected_items[idx].value));
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_key()), std::string(expected_items[idx].key));
+            CPPUNIT_ASSERT_EQUAL(std::string(parser.get_value()), std::string(expected_items[idx].value));
         }
-        CPPUNIT_ASSERT_EQUAL(parser.get_raw_item(), std::string(expected_items[idx].raw));
+        CPPUNIT_ASSERT_EQUAL(std::string(parser.get_raw_item()), std::string(expected_items[idx].raw));
     }
 }
+
+void IniparserTest::test_config_parser_without_raw_items() {
+    const std::string ini_file_content =
+        R"**(# Test comment
+[section1]
+key1 = value1
+# Comment in section
+key2 = two line
+    value2
+
+[section2]
+key1 = value1
+[section1]
+key3 = value3
+)**";
+
+    std::filesystem::path ini_path = temp_dir->get_path() / "test.ini";
+    libdnf5::utils::fs::File(ini_path, "w").write(ini_file_content);
+
+    libdnf5::ConfigParser parser;
+    parser.read(ini_path, false);
+    CPPUNIT_ASSERT_EQUAL(std::string(), parser.get_header());
+
+    const auto & data = parser.get_data();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, data.size());
+    const auto & section1 = data.find("section1")->second;
+    CPPUNIT_ASSERT_EQUAL(std::size_t{3}, section1.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("value1"), section1.find("key1")->second);
+    CPPUNIT_ASSERT_EQUAL(std::string("two line\nvalue2"), section1.find("key2")->second);
+    CPPUNIT_ASSERT_EQUAL(std::string("value3"), section1.find("key3")->second);
+    const auto & section2 = data.find("section2")->second;
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, section2.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("value1"), section2.find("key1")->second);
+
+    // The values written without the raw items keep their content
+    std::filesystem::path written_path = temp_dir->get_path() / "written.ini";
+    parser.write(written_path, false);
+    libdnf5::ConfigParser written_parser;
+    written_parser.read(written_path);
+    CPPUNIT_ASSERT_EQUAL(std::string("two line\nvalue2"), written_parser.get_value("section1", "key2"));
+    CPPUNIT_ASSERT_EQUAL(std::string("value1"), written_parser.get_value("section2", "key1"));
+}
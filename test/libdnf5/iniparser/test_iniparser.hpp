@@ -32,6 +32,8 @@ class IniparserTest : public CppUnit::TestCase {
 #ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_iniparser);
     CPPUNIT_TEST(test_iniparser2);
+    CPPUNIT_TEST(test_iniparser_without_raw_items);
+    CPPUNIT_TEST(test_config_parser_without_raw_items);
 #endif
 
     CPPUNIT_TEST_SUITE_END();
@@ -42,6 +44,8 @@ public:
 
     void test_iniparser();
     void test_iniparser2();
+    void test_iniparser_without_raw_items();
+    void test_config_parser_without_raw_items();
 
     std::unique_ptr<libdnf5::utils::fs::TempDir> temp_dir;
 };
@@ -19,12 +19,23 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_loggers.hpp"
 
+#include "utils/fs/temp.hpp"
+
+#include <libdnf5/logger/async_logger.hpp>
 #include <libdnf5/logger/log_router.hpp>
 #include <libdnf5/logger/memory_buffer_logger.hpp>
 #include <libdnf5/logger/stream_logger.hpp>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 
 using namespace std::chrono_literals;
@@ -134,3 +145,127 @@ void LoggersTest::test_loggers() {
     CPPUNIT_ASSERT_EQUAL(log1_stream_ptr->str(), expected_loggers_content);
     CPPUNIT_ASSERT_EQUAL(log2_stream_ptr->str(), expected_loggers_content);
 }
+
+
+// Messages written by several threads into an AsyncLogger are all passed to the destination logger, messages of each
+// thread in the order they were written.
+void LoggersTest::test_async_logger() {
+    const char * tz = "TZ=UTC";
+    putenv(const_cast<char *>(tz));
+    tzset();
+
+    auto msg_time = std::chrono::system_clock::from_time_t(1582604701);  // "2020-02-25T04:25:01Z"
+    constexpr int num_threads = 4;
+    constexpr int num_messages = 1000;
+
+    auto log_stream = std::make_unique<std::ostringstream>();
+    auto * log_stream_ptr = log_stream.get();
+    // The buffer is large enough to hold all the messages, none of them is dropped
+    auto async_logger = std::make_unique<libdnf5::AsyncLogger>(
+        std::make_unique<libdnf5::StreamLogger>(std::move(log_stream)), num_threads * num_messages);
+    auto * async_logger_ptr = async_logger.get();
+
+    libdnf5::LogRouter log_router;
+    log_router.add_logger(std::move(async_logger));
+
+    std::vector<std::thread> threads;
+    for (int thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+        threads.emplace_back([&log_router, msg_time, thread_idx]() {
+            for (int msg_idx = 0; msg_idx < num_messages; ++msg_idx) {
+                log_router.write(
+                    msg_time,
+                    25,
+                    libdnf5::Logger::Level::INFO,
+                    "Message " + std::to_string(thread_idx) + " " + std::to_string(msg_idx));
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    async_logger_ptr->flush();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), async_logger_ptr->get_dropped_count());
+
+    auto content = log_stream_ptr->str();
+    CPPUNIT_ASSERT_EQUAL(
+        static_cast<std::ptrdiff_t>(num_threads * num_messages), std::count(content.begin(), content.end(), '\n'));
+    for (int thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+        std::size_t prev_pos = 0;
+        for (int msg_idx = 0; msg_idx < num_messages; ++msg_idx) {
+            auto pos = content.find(
+                "[25] INFO Message " + std::to_string(thread_idx) + " " + std::to_string(msg_idx) + "\n", prev_pos);
+            CPPUNIT_ASSERT(pos != std::string::npos);
+            prev_pos = pos;
+        }
+    }
+
+    // A critical message is written before write() returns
+    log_router.critical("Critical message");
+    CPPUNIT_ASSERT(log_stream_ptr->str().ends_with(" CRITICAL Critical message\n"));
+}
+
+
+// A forked child writes its messages directly and destroys the AsyncLogger without joining the parent's writer thread.
+void LoggersTest::test_async_logger_fork() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf5_unittest");
+    auto log_path = temp_dir.get_path() / "async.log";
+
+    auto async_logger = std::make_unique<libdnf5::AsyncLogger>(
+        std::make_unique<libdnf5::StreamLogger>(std::make_unique<std::ofstream>(log_path)));
+    async_logger->info("Parent message");
+    async_logger->flush();
+
+    auto child_pid = fork();
+    CPPUNIT_ASSERT(child_pid != -1);
+    if (child_pid == 0) {
+        async_logger->info("Child message");
+        async_logger.reset();
+        _exit(0);
+    }
+
+    int status;
+    CPPUNIT_ASSERT_EQUAL(child_pid, waitpid(child_pid, &status, 0));
+    CPPUNIT_ASSERT(WIFEXITED(status));
+    CPPUNIT_ASSERT_EQUAL(0, WEXITSTATUS(status));
+
+    // The parent's writer thread keeps working after the fork
+    async_logger->info("Parent message after fork");
+    async_logger.reset();
+
+    std::ifstream log_file(log_path);
+    std::stringstream content_stream;
+    content_stream << log_file.rdbuf();
+    auto content = content_stream.str();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::ptrdiff_t>(3), std::count(content.begin(), content.end(), '\n'));
+    for (const auto * message : {"INFO Parent message\n", "INFO Child message\n", "INFO Parent message after fork\n"}) {
+        CPPUNIT_ASSERT(content.find(message) != std::string::npos);
+    }
+}
+
+
+void LoggersTest::test_memory_buffer_logger_arena() {
+    auto msg_time = std::chrono::system_clock::from_time_t(1582604701);
+
+    // Room for 10 messages, but only for 20 bytes of their texts
+    libdnf5::MemoryBufferLogger logger(10, 0, 20);
+    for (int msg_idx = 0; msg_idx < 5; ++msg_idx) {
+        logger.write(msg_time, 25, libdnf5::Logger::Level::INFO, "Msg " + std::to_string(msg_idx));
+    }
+
+    // Each text has 5 bytes, only the last 4 messages fit
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), logger.get_items_count());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), logger.get_dropped_count());
+    for (std::size_t item_idx = 0; item_idx < 4; ++item_idx) {
+        CPPUNIT_ASSERT_EQUAL("Msg " + std::to_string(item_idx + 1), logger.get_item(item_idx).message);
+    }
+
+    // A text longer than the arena is truncated and replaces all the stored messages
+    logger.write(msg_time, 25, libdnf5::Logger::Level::INFO, std::string(30, 'x'));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), logger.get_items_count());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(5), logger.get_dropped_count());
+    CPPUNIT_ASSERT_EQUAL(std::string(20, 'x'), logger.get_item(0).message);
+
+    logger.clear();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), logger.get_items_count());
+}
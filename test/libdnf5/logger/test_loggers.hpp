@@ -30,6 +30,9 @@ class LoggersTest : public CppUnit::TestCase {
 
 #ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_loggers);
+    CPPUNIT_TEST(test_async_logger);
+    CPPUNIT_TEST(test_async_logger_fork);
+    CPPUNIT_TEST(test_memory_buffer_logger_arena);
 #endif
 
     CPPUNIT_TEST_SUITE_END();
@@ -39,6 +42,9 @@ public:
     void tearDown() override;
 
     void test_loggers();
+    void test_async_logger();
+    void test_async_logger_fork();
+    void test_memory_buffer_logger_arena();
 
 private:
 };
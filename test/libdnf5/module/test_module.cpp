@@ -33,6 +33,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/module/module_query.hpp>
 #include <libdnf5/module/module_sack.hpp>
 #include <libdnf5/module/nsvcap.hpp>
+#include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/utils/format.hpp>
 
 #include <filesystem>
@@ -126,6 +127,54 @@ void ModuleTest::test_resolve_broken_defaults() {
 }
 
 
+void ModuleTest::test_resolve_reuse() {
+    add_repo_repomd("repomd-modules-filtering");
+
+    auto module_sack = base.get_module_sack();
+    auto get_fruit_nevras = [this]() {
+        std::vector<std::string> nevras;
+        libdnf5::rpm::PackageQuery query(base);
+        query.filter_name("fruit");
+        for (const auto & pkg : query) {
+            nevras.push_back(pkg.get_full_nevra());
+        }
+        std::sort(nevras.begin(), nevras.end());
+        return nevras;
+    };
+
+    // No stream of module fruit is enabled, its artifacts are filtered out
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"fruit-0:3-1.noarch"}, get_fruit_nevras());
+
+    // Resolving with unchanged inputs returns the previous result
+    auto first = module_sack->resolve_active_module_items();
+    auto second = module_sack->resolve_active_module_items();
+    CPPUNIT_ASSERT_EQUAL(ModuleSack::ModuleErrorType::NO_ERROR, first.second);
+    CPPUNIT_ASSERT_EQUAL(ModuleSack::ModuleErrorType::NO_ERROR, second.second);
+    CPPUNIT_ASSERT(first.first == second.first);
+    CPPUNIT_ASSERT(module_sack->get_active_modules().empty());
+
+    // Enabling a stream changes the module solving inputs, the previous result is not reused
+    libdnf5::Goal goal(base);
+    goal.add_module_enable("fruit:apple", libdnf5::GoalJobSettings());
+    goal.resolve();
+
+    std::vector<std::string> active_module_specs;
+    for (auto & module_item : module_sack->get_active_modules()) {
+        active_module_specs.push_back(module_item->get_full_identifier());
+    }
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"fruit:apple:1:6c81f848:x86_64"}, active_module_specs);
+
+    // Loading another repository filters the packages again, the excludes are updated by the enabled stream
+    add_repo_repomd("repomd-repo1");
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"fruit-0:1-1.noarch"}, get_fruit_nevras());
+
+    // Packages of the newly loaded repository are not excluded
+    libdnf5::rpm::PackageQuery repo1_query(base);
+    repo1_query.filter_repo_id({"repomd-repo1"});
+    CPPUNIT_ASSERT(!repo1_query.empty());
+}
+
+
 void ModuleTest::test_query() {
     add_repo_repomd("repomd-modules");
 
@@ -657,6 +706,38 @@ void ModuleTest::test_module_enable() {
 }
 
 
+void ModuleTest::test_module_enable_dependencies() {
+    add_repo_repomd("repomd-modules-dependencies");
+
+    // Module stack requires any stream of module base-lib and one of the streams 2 and 3 of module tool
+    libdnf5::Goal goal(base);
+    goal.add_module_enable("stack:main", libdnf5::GoalJobSettings());
+    auto transaction = goal.resolve();
+
+    std::vector<std::string> expected_active_module_specs{
+        "base-lib:1:1:6c81f848:x86_64", "stack:main:1:6c81f848:x86_64", "tool:2:1:6c81f848:x86_64"};
+    std::vector<std::string> active_module_specs;
+    for (auto & module_item : base.get_module_sack()->get_active_modules()) {
+        active_module_specs.push_back(module_item->get_full_identifier());
+    }
+    std::sort(active_module_specs.begin(), active_module_specs.end());
+    CPPUNIT_ASSERT_EQUAL(expected_active_module_specs, active_module_specs);
+
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, transaction.run());
+
+    auto system_state = (base.*get(priv_impl()))->get_system_state();
+
+    // The dependency without streams is satisfied by the only active stream of module base-lib
+    CPPUNIT_ASSERT_EQUAL(
+        libdnf5::system::ModuleState({"1", ModuleStatus::ENABLED, {}}), system_state.get_module_state("base-lib"));
+    // The dependency on streams 2 and 3 is satisfied by the active stream 2, stream 3 does not exist
+    CPPUNIT_ASSERT_EQUAL(
+        libdnf5::system::ModuleState({"2", ModuleStatus::ENABLED, {}}), system_state.get_module_state("tool"));
+    CPPUNIT_ASSERT_EQUAL(
+        libdnf5::system::ModuleState({"main", ModuleStatus::ENABLED, {}}), system_state.get_module_state("stack"));
+}
+
+
 void ModuleTest::test_module_disable() {
     add_repo_repomd("repomd-modules");
 
@@ -32,12 +32,14 @@ class ModuleTest : public BaseTestCase {
     CPPUNIT_TEST(test_load);
     CPPUNIT_TEST(test_resolve);
     CPPUNIT_TEST(test_resolve_broken_defaults);
+    CPPUNIT_TEST(test_resolve_reuse);
     CPPUNIT_TEST(test_query);
     CPPUNIT_TEST(test_query_latest);
     CPPUNIT_TEST(test_nsvcap);
     CPPUNIT_TEST(test_query_spec);
     CPPUNIT_TEST(test_module_db);
     CPPUNIT_TEST(test_module_enable);
+    CPPUNIT_TEST(test_module_enable_dependencies);
     CPPUNIT_TEST(test_module_disable);
     CPPUNIT_TEST(test_module_disable_enabled);
     CPPUNIT_TEST(test_module_reset);
@@ -47,12 +49,14 @@ public:
     void test_load();
     void test_resolve();
     void test_resolve_broken_defaults();
+    void test_resolve_reuse();
     void test_query();
     void test_query_latest();
     void test_nsvcap();
     void test_query_spec();
     void test_module_db();
     void test_module_enable();
+    void test_module_enable_dependencies();
     void test_module_disable();
     void test_module_disable_enabled();
     void test_module_reset();
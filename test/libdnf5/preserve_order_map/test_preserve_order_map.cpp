@@ -21,6 +21,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <libdnf5/common/preserve_order_map.hpp>
 
+#include <iterator>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -264,3 +266,47 @@ void PreserveOrderMapTest::test_iterators() {
         CPPUNIT_ASSERT(result == expected);
     }
 }
+
+
+void PreserveOrderMapTest::test_hashed_lookup() {
+    using Map = libdnf5::PreserveOrderMap<std::string, int>;
+    constexpr int ITEMS = static_cast<int>(Map::INDEX_THRESHOLD) * 4;
+
+    // the map grows over the threshold, the items keep the insertion order
+    Map map1;
+    for (int i = ITEMS - 1; i >= 0; --i) {
+        map1["key" + std::to_string(i)] = i;
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(ITEMS), map1.size());
+    int expected = ITEMS - 1;
+    for (const auto & [key, value] : map1) {
+        CPPUNIT_ASSERT_EQUAL("key" + std::to_string(expected), key);
+        CPPUNIT_ASSERT_EQUAL(expected, value);
+        --expected;
+    }
+    for (int i = 0; i < ITEMS; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, map1.at("key" + std::to_string(i)));
+    }
+    CPPUNIT_ASSERT(!map1.insert({"key3", 100}).second);
+    CPPUNIT_ASSERT_EQUAL(3, map1.at("key3"));
+    CPPUNIT_ASSERT_THROW(map1.at("missing"), std::out_of_range);
+
+    // the positions of the items following the erased ones are updated
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), map1.erase("key40"));
+    map1.erase(map1.find("key20"), map1.find("key10"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(ITEMS - 11), map1.size());
+    CPPUNIT_ASSERT(map1.find("key40") == map1.end());
+    CPPUNIT_ASSERT(map1.find("key15") == map1.end());
+    CPPUNIT_ASSERT_EQUAL(10, map1.find("key10")->second);
+    CPPUNIT_ASSERT_EQUAL(41, map1.at("key41"));
+    CPPUNIT_ASSERT(std::next(map1.find("key21")) == map1.find("key10"));
+
+    // a copy has its own index
+    Map map2 = map1;
+    map1.clear();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), map1.count("key5"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), map2.count("key5"));
+    map1["key5"] = 5;
+    CPPUNIT_ASSERT_EQUAL(5, map1.at("key5"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), map1.size());
+}
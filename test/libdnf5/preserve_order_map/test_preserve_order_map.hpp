@@ -35,6 +35,7 @@ class PreserveOrderMapTest : public CppUnit::TestCase {
     CPPUNIT_TEST(test_access);
     CPPUNIT_TEST(test_erase_clear);
     CPPUNIT_TEST(test_iterators);
+    CPPUNIT_TEST(test_hashed_lookup);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -46,6 +47,7 @@ public:
     void test_access();
     void test_erase_clear();
     void test_iterators();
+    void test_hashed_lookup();
 };
 
 #endif
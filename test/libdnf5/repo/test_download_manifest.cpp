@@ -0,0 +1,147 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_download_manifest.hpp"
+
+#include "repo/checksum_verifier.hpp"
+#include "repo/download_manifest.hpp"
+#include "utils/fs/file.hpp"
+
+#include <chrono>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DownloadManifestTest);
+
+using namespace libdnf5::repo;
+
+namespace {
+
+constexpr const char * CHECKSUM = "sha256:0123456789abcdef";
+constexpr const char * CONTENT = "package content";
+constexpr std::uint64_t SIZE = 15;
+constexpr const char * CONTENT_SHA256 = "830df696604d16c1966d36f166b8635aa0788f09af6df4cc8ba9976d1a1c5dd9";
+
+}  // namespace
+
+
+void DownloadManifestTest::setUp() {
+    CppUnit::TestCase::setUp();
+    temp_dir = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf_test_download_manifest");
+    package_path = temp_dir->get_path() / "package-1.0-1.noarch.rpm";
+    libdnf5::utils::fs::File(package_path, "w").write(CONTENT);
+}
+
+void DownloadManifestTest::tearDown() {
+    temp_dir.reset();
+    CppUnit::TestCase::tearDown();
+}
+
+void DownloadManifestTest::test_is_verified() {
+    DownloadManifest manifest(temp_dir->get_path());
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE));
+
+    manifest.set_verified(package_path, CHECKSUM, SIZE);
+    CPPUNIT_ASSERT(manifest.is_verified(package_path, CHECKSUM, SIZE));
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, "sha256:fedcba9876543210", SIZE));
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE + 1));
+
+    // a file of a different size is not recorded
+    DownloadManifest other_manifest(temp_dir->get_path());
+    other_manifest.set_verified(package_path, CHECKSUM, SIZE + 1);
+    CPPUNIT_ASSERT(!other_manifest.is_verified(package_path, CHECKSUM, SIZE + 1));
+}
+
+void DownloadManifestTest::test_changed_file_is_not_verified() {
+    DownloadManifest manifest(temp_dir->get_path());
+    manifest.set_verified(package_path, CHECKSUM, SIZE);
+
+    std::filesystem::last_write_time(
+        package_path, std::filesystem::last_write_time(package_path) + std::chrono::seconds(10));
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE));
+}
+
+void DownloadManifestTest::test_replaced_file_is_not_verified() {
+    DownloadManifest manifest(temp_dir->get_path());
+    manifest.set_verified(package_path, CHECKSUM, SIZE);
+
+    // a file with the same size and mtime but a different inode was replaced
+    auto mtime = std::filesystem::last_write_time(package_path);
+    auto new_path = temp_dir->get_path() / "new.rpm";
+    libdnf5::utils::fs::File(new_path, "w").write(CONTENT);
+    std::filesystem::rename(new_path, package_path);
+    std::filesystem::last_write_time(package_path, mtime);
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE));
+}
+
+void DownloadManifestTest::test_verify_file_checksums() {
+    constexpr auto SHA256 = libdnf5::rpm::Checksum::Type::SHA256;
+    std::vector<ChecksumCheck> checks{
+        {package_path, SHA256, CONTENT_SHA256, SIZE, false},
+        {package_path, SHA256, CONTENT_SHA256, SIZE + 1, true},
+        {package_path, SHA256, std::string(64, '0'), SIZE, true},
+        {temp_dir->get_path() / "missing.rpm", SHA256, CONTENT_SHA256, SIZE, true}};
+    verify_file_checksums(checks, 2);
+
+    CPPUNIT_ASSERT(checks[0].matches);
+    CPPUNIT_ASSERT(!checks[1].matches);
+    CPPUNIT_ASSERT(!checks[2].matches);
+    CPPUNIT_ASSERT(!checks[3].matches);
+}
+
+void DownloadManifestTest::test_save_load() {
+    {
+        DownloadManifest manifest(temp_dir->get_path());
+        manifest.set_verified(package_path, CHECKSUM, SIZE);
+        manifest.save();
+    }
+    CPPUNIT_ASSERT(std::filesystem::exists(temp_dir->get_path() / DownloadManifest::FILENAME));
+
+    DownloadManifest manifest(temp_dir->get_path());
+    CPPUNIT_ASSERT(manifest.is_verified(package_path, CHECKSUM, SIZE));
+}
+
+void DownloadManifestTest::test_save_drops_missing_files() {
+    {
+        DownloadManifest manifest(temp_dir->get_path());
+        manifest.set_verified(package_path, CHECKSUM, SIZE);
+        manifest.save();
+    }
+    std::filesystem::remove(package_path);
+    {
+        DownloadManifest manifest(temp_dir->get_path());
+        manifest.save();
+    }
+
+    // the recreated file is not verified by the dropped record
+    libdnf5::utils::fs::File(package_path, "w").write(CONTENT);
+    DownloadManifest manifest(temp_dir->get_path());
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE));
+}
+
+void DownloadManifestTest::test_broken_manifest() {
+    libdnf5::utils::fs::File(temp_dir->get_path() / DownloadManifest::FILENAME, "w").write("files = [");
+    DownloadManifest manifest(temp_dir->get_path());
+    CPPUNIT_ASSERT(!manifest.is_verified(package_path, CHECKSUM, SIZE));
+
+    manifest.set_verified(package_path, CHECKSUM, SIZE);
+    manifest.save();
+    CPPUNIT_ASSERT(DownloadManifest(temp_dir->get_path()).is_verified(package_path, CHECKSUM, SIZE));
+}
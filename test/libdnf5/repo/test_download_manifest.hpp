@@ -0,0 +1,61 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_REPO_DOWNLOAD_MANIFEST_HPP
+#define LIBDNF5_TEST_REPO_DOWNLOAD_MANIFEST_HPP
+
+#include "utils/fs/temp.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <filesystem>
+#include <memory>
+
+
+class DownloadManifestTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(DownloadManifestTest);
+    CPPUNIT_TEST(test_is_verified);
+    CPPUNIT_TEST(test_changed_file_is_not_verified);
+    CPPUNIT_TEST(test_replaced_file_is_not_verified);
+    CPPUNIT_TEST(test_verify_file_checksums);
+    CPPUNIT_TEST(test_save_load);
+    CPPUNIT_TEST(test_save_drops_missing_files);
+    CPPUNIT_TEST(test_broken_manifest);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_is_verified();
+    void test_changed_file_is_not_verified();
+    void test_replaced_file_is_not_verified();
+    void test_verify_file_checksums();
+    void test_save_load();
+    void test_save_drops_missing_files();
+    void test_broken_manifest();
+
+private:
+    std::unique_ptr<libdnf5::utils::fs::TempDir> temp_dir;
+    std::filesystem::path package_path;
+};
+
+#endif
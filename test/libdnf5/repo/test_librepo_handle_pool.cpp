@@ -0,0 +1,78 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_librepo_handle_pool.hpp"
+
+#include "repo/librepo.hpp"
+
+#include <libdnf5/conf/config_main.hpp>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LibrepoHandlePoolTest);
+
+using namespace libdnf5::repo;
+
+
+void LibrepoHandlePoolTest::test_released_handle_is_reused() {
+    // The pool is process-wide, a unique user agent keeps the handles of other tests out
+    libdnf5::ConfigMain config;
+    config.get_user_agent_option().set("test_released_handle_is_reused");
+    auto & pool = LibrepoHandlePool::get_instance();
+
+    LrHandle * first;
+    {
+        auto lease = pool.acquire(config);
+        first = lease.get().get();
+    }
+    auto stats = pool.get_stats();
+    auto lease = pool.acquire(config);
+    CPPUNIT_ASSERT_EQUAL(first, lease.get().get());
+    CPPUNIT_ASSERT_EQUAL(stats.created, pool.get_stats().created);
+    CPPUNIT_ASSERT_EQUAL(stats.reused + 1, pool.get_stats().reused);
+}
+
+
+void LibrepoHandlePoolTest::test_leased_handle_is_exclusive() {
+    libdnf5::ConfigMain config;
+    config.get_user_agent_option().set("test_leased_handle_is_exclusive");
+    auto & pool = LibrepoHandlePool::get_instance();
+
+    auto stats = pool.get_stats();
+    auto lease1 = pool.acquire(config);
+    auto lease2 = pool.acquire(config);
+    CPPUNIT_ASSERT(lease1.get().get() != lease2.get().get());
+    CPPUNIT_ASSERT_EQUAL(stats.created + 2, pool.get_stats().created);
+}
+
+
+void LibrepoHandlePoolTest::test_different_settings_use_different_handles() {
+    libdnf5::ConfigMain config;
+    config.get_user_agent_option().set("test_different_settings_use_different_handles");
+    auto & pool = LibrepoHandlePool::get_instance();
+
+    LrHandle * first;
+    {
+        auto lease = pool.acquire(config);
+        first = lease.get().get();
+    }
+    config.get_sslverify_option().set(false);
+    auto lease = pool.acquire(config);
+    CPPUNIT_ASSERT(first != lease.get().get());
+}
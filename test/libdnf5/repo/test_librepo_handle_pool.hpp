@@ -0,0 +1,41 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_REPO_LIBREPO_HANDLE_POOL_HPP
+#define LIBDNF5_TEST_REPO_LIBREPO_HANDLE_POOL_HPP
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class LibrepoHandlePoolTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(LibrepoHandlePoolTest);
+    CPPUNIT_TEST(test_released_handle_is_reused);
+    CPPUNIT_TEST(test_leased_handle_is_exclusive);
+    CPPUNIT_TEST(test_different_settings_use_different_handles);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_released_handle_is_reused();
+    void test_leased_handle_is_exclusive();
+    void test_different_settings_use_different_handles();
+};
+
+#endif
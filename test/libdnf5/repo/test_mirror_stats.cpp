@@ -0,0 +1,112 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_mirror_stats.hpp"
+
+#include "repo/mirror_stats.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MirrorStatsTest);
+
+using namespace libdnf5::repo;
+
+
+void MirrorStatsTest::test_get_mirror_key() {
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("https://mirror.example.com"),
+        MirrorStats::get_mirror_key("https://mirror.example.com/fedora/x86_64/Packages/a/a-1-1.x86_64.rpm"));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("http://mirror.example.com:8080"), MirrorStats::get_mirror_key("http://mirror.example.com:8080"));
+}
+
+
+void MirrorStatsTest::test_sort_urls() {
+    MirrorStats stats(base.get_weak_ptr());
+    // slow: 0.1 s + 1 MiB at 100 KiB/s, fast: 0.1 s + 1 MiB at 10 MiB/s
+    stats.add_success("https://slow.example.com/repo/", 0.1, 100 * 1024);
+    stats.add_success("https://fast.example.com/repo/", 0.1, 10 * 1024 * 1024);
+    stats.add_failure("https://broken.example.com/repo/");
+    stats.add_success("https://working.example.com/repo/", 0, 0);
+
+    std::vector<std::string> urls{
+        "https://broken.example.com/repo/",
+        "https://unknown1.example.com/repo/",
+        "https://slow.example.com/repo/",
+        "https://working.example.com/repo/",
+        "https://unknown2.example.com/repo/",
+        "https://fast.example.com/repo/"};
+    CPPUNIT_ASSERT(stats.sort_urls(urls));
+
+    std::vector<std::string> expected{
+        "https://fast.example.com/repo/",
+        "https://slow.example.com/repo/",
+        "https://working.example.com/repo/",
+        "https://unknown1.example.com/repo/",
+        "https://unknown2.example.com/repo/",
+        "https://broken.example.com/repo/"};
+    CPPUNIT_ASSERT_EQUAL(expected, urls);
+
+    // failures of the fast mirror move it behind the slow one
+    for (int i = 0; i < 5; ++i) {
+        stats.add_failure("https://fast.example.com/other/");
+    }
+    CPPUNIT_ASSERT(stats.sort_urls(urls));
+    CPPUNIT_ASSERT_EQUAL(std::string("https://slow.example.com/repo/"), urls[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("https://fast.example.com/repo/"), urls[1]);
+}
+
+
+void MirrorStatsTest::test_sort_urls_disabled() {
+    base.get_config().get_mirror_stats_option().set(false);
+    MirrorStats stats(base.get_weak_ptr());
+    stats.add_failure("https://broken.example.com/repo/");
+    CPPUNIT_ASSERT(!stats.get_record("https://broken.example.com/repo/"));
+
+    std::vector<std::string> urls{"https://broken.example.com/repo/", "https://other.example.com/repo/"};
+    auto expected = urls;
+    CPPUNIT_ASSERT(!stats.sort_urls(urls));
+    CPPUNIT_ASSERT_EQUAL(expected, urls);
+}
+
+
+void MirrorStatsTest::test_save_load() {
+    {
+        MirrorStats stats(base.get_weak_ptr());
+        stats.add_success("https://mirror.example.com/repo/", 0.5, 2048);
+        stats.add_success("https://mirror.example.com/other/", 1.5, 1024);
+        stats.add_failure("https://mirror.example.com/repo/");
+        stats.save();
+    }
+    CPPUNIT_ASSERT(std::filesystem::exists(
+        std::filesystem::path(base.get_config().get_cachedir_option().get_value()) / MirrorStats::FILENAME));
+
+    MirrorStats stats(base.get_weak_ptr());
+    auto record = stats.get_record("https://mirror.example.com");
+    CPPUNIT_ASSERT(record);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.8, record->latency, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1740.8, record->throughput, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3, record->failure_rate, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(std::int64_t(2), record->successes);
+    CPPUNIT_ASSERT_EQUAL(std::int64_t(1), record->failures);
+}
@@ -0,0 +1,44 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_REPO_MIRROR_STATS_HPP
+#define LIBDNF5_TEST_REPO_MIRROR_STATS_HPP
+
+#include "../shared/base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class MirrorStatsTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(MirrorStatsTest);
+    CPPUNIT_TEST(test_get_mirror_key);
+    CPPUNIT_TEST(test_sort_urls);
+    CPPUNIT_TEST(test_sort_urls_disabled);
+    CPPUNIT_TEST(test_save_load);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_get_mirror_key();
+    void test_sort_urls();
+    void test_sort_urls_disabled();
+    void test_save_load();
+};
+
+#endif
@@ -20,6 +20,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_package_downloader.hpp"
 
 #include "../shared/utils.hpp"
+#include "repo/checksum_verifier.hpp"
+#include "repo/package_store.hpp"
 #include "repo/temp_files_memory.hpp"
 #include "utils/fs/file.hpp"
 #include "utils/string.hpp"
@@ -28,6 +30,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/repo/package_downloader.hpp>
 #include <libdnf5/rpm/package_query.hpp>
 
+#include <algorithm>
 #include <filesystem>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PackageDownloaderTest);
@@ -127,3 +130,100 @@ void PackageDownloaderTest::test_package_downloader_temp_files_memory() {
 
     CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
 }
+
+void PackageDownloaderTest::test_package_downloaded_callback() {
+    add_repo_rpm("rpm-repo1");
+
+    libdnf5::rpm::PackageQuery query(base);
+    query.filter_name({"one"});
+    query.filter_arch({"noarch"});
+    CPPUNIT_ASSERT_EQUAL((size_t)2, query.size());
+
+    auto downloader = libdnf5::repo::PackageDownloader(base);
+    for (const auto & package : query) {
+        downloader.add(package);
+    }
+
+    // the callback is called with every package when its file is ready
+    std::vector<std::string> downloaded;
+    downloader.set_package_downloaded_callback([&downloaded](const libdnf5::rpm::Package & package) {
+        CPPUNIT_ASSERT(std::filesystem::exists(package.get_package_path()));
+        downloaded.push_back(package.get_nevra());
+    });
+    downloader.download();
+
+    std::sort(downloaded.begin(), downloaded.end());
+    const std::vector<std::string> expected = {"one-1-1.noarch", "one-2-1.noarch"};
+    CPPUNIT_ASSERT_EQUAL(expected, downloaded);
+}
+
+void PackageDownloaderTest::test_package_store() {
+    add_repo_rpm("rpm-repo1");
+    auto store_dir = temp->get_path() / "package_store";
+    base.get_config().get_package_store_dir_option().set(store_dir.string());
+
+    libdnf5::rpm::PackageQuery query(base);
+    query.filter_nevra({"one-2-1.noarch"});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    auto package = *query.begin();
+    auto checksum = package.get_checksum();
+    auto stored_path = store_dir / libdnf5::repo::PackageStore::get_relative_path(checksum);
+
+    auto cbs_unique_ptr = std::make_unique<DownloadCallbacks>();
+    auto cbs = cbs_unique_ptr.get();
+    base.set_download_callbacks(std::move(cbs_unique_ptr));
+
+    // the downloaded and verified package is added to the store
+    auto downloader = libdnf5::repo::PackageDownloader(base);
+    downloader.add(package);
+    downloader.download();
+    CPPUNIT_ASSERT_EQUAL(DownloadCallbacks::TransferStatus::SUCCESSFUL, cbs->end_status);
+    CPPUNIT_ASSERT(libdnf5::repo::verify_file_checksum(
+        stored_path, checksum.get_type(), checksum.get_checksum(), package.get_download_size()));
+
+    // a package missing in the destination is linked from the store
+    std::filesystem::remove(package.get_package_path());
+    auto downloader2 = libdnf5::repo::PackageDownloader(base);
+    downloader2.add(package);
+    downloader2.download();
+    CPPUNIT_ASSERT_EQUAL(DownloadCallbacks::TransferStatus::ALREADYEXISTS, cbs->end_status);
+    CPPUNIT_ASSERT_EQUAL(std::string("Found in package store"), cbs->end_msg);
+    CPPUNIT_ASSERT(libdnf5::repo::verify_file_checksum(
+        package.get_package_path(), checksum.get_type(), checksum.get_checksum(), package.get_download_size()));
+}
+
+void PackageDownloaderTest::test_package_store_corrupted_entry() {
+    add_repo_rpm("rpm-repo1");
+    auto store_dir = temp->get_path() / "package_store";
+    base.get_config().get_package_store_dir_option().set(store_dir.string());
+
+    libdnf5::rpm::PackageQuery query(base);
+    query.filter_nevra({"one-2-1.noarch"});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    auto package = *query.begin();
+    auto checksum = package.get_checksum();
+    auto stored_path = store_dir / libdnf5::repo::PackageStore::get_relative_path(checksum);
+
+    // an entry of the right size with a different content
+    std::filesystem::create_directories(stored_path.parent_path());
+    libdnf5::utils::fs::File(stored_path, "w").write(std::string(package.get_download_size(), 'x'));
+    libdnf5::repo::PackageStore store(store_dir);
+    auto linked_path = temp->get_path() / "linked.rpm";
+    CPPUNIT_ASSERT(!store.link_to(checksum, package.get_download_size(), linked_path));
+    CPPUNIT_ASSERT(!std::filesystem::exists(linked_path));
+    CPPUNIT_ASSERT(!std::filesystem::exists(stored_path));
+
+    // the corrupted entry is not used, the package is downloaded and stored again
+    libdnf5::utils::fs::File(stored_path, "w").write(std::string(package.get_download_size(), 'x'));
+    auto cbs_unique_ptr = std::make_unique<DownloadCallbacks>();
+    auto cbs = cbs_unique_ptr.get();
+    base.set_download_callbacks(std::move(cbs_unique_ptr));
+    auto downloader = libdnf5::repo::PackageDownloader(base);
+    downloader.add(package);
+    downloader.download();
+    CPPUNIT_ASSERT_EQUAL(DownloadCallbacks::TransferStatus::SUCCESSFUL, cbs->end_status);
+    CPPUNIT_ASSERT(libdnf5::repo::verify_file_checksum(
+        package.get_package_path(), checksum.get_type(), checksum.get_checksum(), package.get_download_size()));
+    CPPUNIT_ASSERT(libdnf5::repo::verify_file_checksum(
+        stored_path, checksum.get_type(), checksum.get_checksum(), package.get_download_size()));
+}
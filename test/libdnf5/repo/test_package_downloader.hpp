@@ -29,11 +29,17 @@ class PackageDownloaderTest : public BaseTestCase {
     CPPUNIT_TEST_SUITE(PackageDownloaderTest);
     CPPUNIT_TEST(test_package_downloader);
     CPPUNIT_TEST(test_package_downloader_temp_files_memory);
+    CPPUNIT_TEST(test_package_downloaded_callback);
+    CPPUNIT_TEST(test_package_store);
+    CPPUNIT_TEST(test_package_store_corrupted_entry);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_package_downloader();
     void test_package_downloader_temp_files_memory();
+    void test_package_downloaded_callback();
+    void test_package_store();
+    void test_package_store_corrupted_entry();
 };
 
 #endif
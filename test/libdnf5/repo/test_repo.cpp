@@ -19,11 +19,25 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_repo.hpp"
 
+#include "../rpm/synthetic_repo.hpp"
+#include "solv/pool.hpp"
 #include "utils/string.hpp"
 
+#include <libdnf5/advisory/advisory_query.hpp>
 #include <libdnf5/base/base.hpp>
+#include <libdnf5/base/goal.hpp>
+#include <libdnf5/conf/const.hpp>
+#include <libdnf5/repo/repo_errors.hpp>
+#include <libdnf5/rpm/package_query.hpp>
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RepoTest);
@@ -146,3 +160,570 @@ void RepoTest::test_update_and_load_enabled_repos_twice_fails() {
     // calling this again should fail
     CPPUNIT_ASSERT_THROW(repo_sack->update_and_load_enabled_repos(true), libdnf5::UserAssertionError);
 }
+
+void RepoTest::test_memory_usage() {
+    add_repo_repomd("repomd-repo1");
+
+    auto usage = repo_sack->get_memory_usage();
+    auto repo_usage = std::find_if(usage.repos.begin(), usage.repos.end(), [](const auto & repo) {
+        return repo.repo_id == "repomd-repo1";
+    });
+    CPPUNIT_ASSERT(repo_usage != usage.repos.end());
+    CPPUNIT_ASSERT_GREATER(std::size_t{0}, repo_usage->solvables);
+    CPPUNIT_ASSERT_GREATER(std::size_t{0}, repo_usage->solvables_bytes);
+    CPPUNIT_ASSERT_GREATER(std::size_t{0}, repo_usage->primary_bytes);
+    CPPUNIT_ASSERT_GREATER(std::size_t{0}, usage.pool_strings_bytes);
+
+    std::size_t total = usage.pool_strings_bytes + usage.pool_reldeps_bytes + usage.pool_whatprovides_bytes +
+                        usage.comps_pool_bytes + usage.module_pool_bytes + usage.sorted_solvables_bytes +
+                        usage.package_indexes_bytes + usage.considered_maps_bytes + usage.package_caches_bytes +
+                        usage.advisory_caches_bytes;
+    for (const auto & repo : usage.repos) {
+        total += repo.get_total_bytes();
+    }
+    CPPUNIT_ASSERT_EQUAL(total, usage.get_total_bytes());
+}
+
+void RepoTest::test_load_package_details_on_demand() {
+    base.get_config().get_load_package_details_on_demand_option().set(true);
+    auto repo = add_repo_repomd("repomd-repo1");
+
+    // The first load writes the packages split into the core and the details caches
+    auto solv_dir = std::filesystem::path(repo->get_cachedir()) / "solv";
+    CPPUNIT_ASSERT(std::filesystem::exists(solv_dir / "repomd-repo1-core.solvx"));
+    CPPUNIT_ASSERT(std::filesystem::exists(solv_dir / "repomd-repo1-details.solvx"));
+
+    // The next load uses them, the details are loaded when they are requested
+    libdnf5::Base lean_base;
+    lean_base.get_config().get_installroot_option().set(temp->get_path() / "installroot");
+    lean_base.get_config().get_cachedir_option().set(temp->get_path() / "cache");
+    lean_base.get_config().get_load_package_details_on_demand_option().set(true);
+    lean_base.get_vars()->set("arch", "x86_64");
+    lean_base.setup();
+    auto lean_repo = lean_base.get_repo_sack()->create_repo("repomd-repo1");
+    lean_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    lean_base.get_repo_sack()->update_and_load_enabled_repos(false);
+
+    libdnf5::rpm::PackageQuery query(lean_base);
+    query.filter_name({"pkg"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query.size());
+    auto pkg = *query.begin();
+    CPPUNIT_ASSERT_EQUAL(std::string("Description"), pkg.get_description());
+    CPPUNIT_ASSERT_EQUAL(std::string("http://example.com/"), pkg.get_url());
+}
+
+namespace {
+
+/// Wraps the libsolv pool load callback for its lifetime, records the threads that load the stub repodata
+class StubLoadRecorder {
+public:
+    explicit StubLoadRecorder(::Pool * pool)
+        : pool(pool),
+          callback(pool->loadcallback),
+          callback_data(pool->loadcallbackdata) {
+        pool_setloadcallback(pool, &StubLoadRecorder::load, this);
+    }
+    ~StubLoadRecorder() { pool_setloadcallback(pool, callback, callback_data); }
+
+    StubLoadRecorder(const StubLoadRecorder &) = delete;
+    StubLoadRecorder & operator=(const StubLoadRecorder &) = delete;
+
+    std::vector<std::thread::id> get_threads() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return threads;
+    }
+
+private:
+    static int load(::Pool * pool, Repodata * data, void * cbdata) {
+        auto * recorder = static_cast<StubLoadRecorder *>(cbdata);
+        {
+            std::lock_guard<std::mutex> lock(recorder->mutex);
+            recorder->threads.push_back(std::this_thread::get_id());
+        }
+        return recorder->callback ? recorder->callback(pool, data, recorder->callback_data) : 0;
+    }
+
+    ::Pool * pool;
+    int (*callback)(::Pool *, Repodata *, void *);
+    void * callback_data;
+    std::mutex mutex;
+    std::vector<std::thread::id> threads;
+};
+
+}  // namespace
+
+void RepoTest::test_load_filelists_on_demand() {
+    base.get_config().get_load_filelists_on_demand_option().set(true);
+    add_repo_repomd("repomd-repo1");
+    StubLoadRecorder recorder(*libdnf5::get_rpm_pool(base.get_weak_ptr()));
+
+    // Filters not touching the files do not load the filelists
+    libdnf5::rpm::PackageQuery query1(base);
+    query1.filter_name({"pkg"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query1.size());
+    CPPUNIT_ASSERT(recorder.get_threads().empty());
+
+    // The files are not in primary, the first file filter loads the filelists
+    libdnf5::rpm::PackageQuery query2(base);
+    query2.filter_file({"/etc/pkg.conf"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query2.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, recorder.get_threads().size());
+
+    // They are loaded only once
+    libdnf5::rpm::PackageQuery query3(base);
+    query3.filter_file({"/etc/pkg.conf.d"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query3.size());
+    libdnf5::rpm::PackageQuery query4(base);
+    query4.filter_file({"/etc/*"}, libdnf5::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query4.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, recorder.get_threads().size());
+}
+
+void RepoTest::test_load_filelists_on_demand_concurrent_filters() {
+    // Enough packages for the filters to be evaluated by several threads
+    SyntheticRepoOptions options;
+    options.names = 3000;
+    options.versions = 2;
+    options.provides = 1;
+    options.dependencies = 1;
+    options.files = 2;
+    options.advisories = 0;
+    write_synthetic_repomd(temp->get_path() / "synthetic", options);
+
+    base.get_config().get_load_filelists_on_demand_option().set(true);
+    base.get_config().get_query_filter_threads_option().set(4);
+    add_repo("synthetic", temp->get_path() / "synthetic");
+    StubLoadRecorder recorder(*libdnf5::get_rpm_pool(base.get_weak_ptr()));
+
+    // The concurrently evaluated filters do not need the filelists
+    libdnf5::rpm::PackageQuery query1(base);
+    query1.filter_description({"synth12 version"}, libdnf5::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, query1.size());
+    libdnf5::rpm::PackageQuery query2(base);
+    query2.filter_name({"synth1*"}, libdnf5::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2 * 1111}, query2.size());
+    CPPUNIT_ASSERT(recorder.get_threads().empty());
+
+    // The file filter loads the filelists once in the calling thread
+    libdnf5::rpm::PackageQuery query3(base);
+    query3.filter_file({"/usr/share/synth12/file1"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, query3.size());
+    libdnf5::rpm::PackageQuery query4(base);
+    query4.filter_description({"synth12 version"}, libdnf5::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, query4.size());
+    auto threads = recorder.get_threads();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, threads.size());
+    CPPUNIT_ASSERT(threads[0] == std::this_thread::get_id());
+}
+
+void RepoTest::test_load_filelists_on_demand_missing() {
+    base.get_config().get_load_filelists_on_demand_option().set(true);
+    auto repo = add_repo_repomd("repomd-repo1");
+    StubLoadRecorder recorder(*libdnf5::get_rpm_pool(base.get_weak_ptr()));
+
+    // The filelists disappear from the cache before they are needed
+    std::vector<std::filesystem::path> filelists_paths;
+    for (const auto & entry : std::filesystem::recursive_directory_iterator(repo->get_cachedir())) {
+        if (entry.is_regular_file() && entry.path().filename().native().find("filelists") != std::string::npos) {
+            filelists_paths.push_back(entry.path());
+        }
+    }
+    CPPUNIT_ASSERT(!filelists_paths.empty());
+    for (const auto & path : filelists_paths) {
+        std::filesystem::remove(path);
+    }
+
+    // The failed load is reported by a warning, the query finds no package instead of throwing
+    libdnf5::rpm::PackageQuery query1(base);
+    query1.filter_file({"/etc/pkg.conf"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, query1.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, recorder.get_threads().size());
+
+    // libsolv marks the stub as failed, the load is not retried
+    libdnf5::rpm::PackageQuery query2(base);
+    query2.filter_file({"/etc/pkg.conf.d"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, query2.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, recorder.get_threads().size());
+
+    // Other package data are still available
+    libdnf5::rpm::PackageQuery query3(base);
+    query3.filter_name({"pkg"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query3.size());
+}
+
+void RepoTest::test_require_optional_metadata_types() {
+    // Only the primary metadata are declared, the updateinfo enabled by default is not loaded
+    repo_sack->require_optional_metadata_types({});
+    CPPUNIT_ASSERT(repo_sack->get_loaded_optional_metadata_types().empty());
+    add_repo_repomd("repomd-repo1");
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, libdnf5::advisory::AdvisoryQuery(base).size());
+
+    // The updateinfo declared later is loaded into the loaded repository
+    repo_sack->require_optional_metadata_types({libdnf5::METADATA_TYPE_UPDATEINFO});
+    CPPUNIT_ASSERT(
+        (repo_sack->get_loaded_optional_metadata_types() ==
+         std::set<std::string>{libdnf5::METADATA_TYPE_UPDATEINFO}));
+    CPPUNIT_ASSERT_EQUAL(std::size_t{4}, libdnf5::advisory::AdvisoryQuery(base).size());
+
+    // Declaring it again does not load it twice
+    repo_sack->require_optional_metadata_types({libdnf5::METADATA_TYPE_UPDATEINFO});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{4}, libdnf5::advisory::AdvisoryQuery(base).size());
+}
+
+void RepoTest::test_solv_cache_shared_between_bases() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto solv_path = std::filesystem::path(repo->get_cachedir()) / "solv" / "repomd-repo1.solv";
+    CPPUNIT_ASSERT(std::filesystem::exists(solv_path));
+
+    // A base of another installroot with its own cache links the solv cache written by the first one
+    libdnf5::Base other_base;
+    other_base.get_config().get_installroot_option().set(temp->get_path() / "installroot2");
+    other_base.get_config().get_cachedir_option().set(temp->get_path() / "cache2");
+    other_base.get_vars()->set("arch", "x86_64");
+    other_base.setup();
+    auto other_repo = other_base.get_repo_sack()->create_repo("repomd-repo1");
+    other_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    other_base.get_repo_sack()->update_and_load_enabled_repos(false);
+
+    auto other_solv_path = std::filesystem::path(other_repo->get_cachedir()) / "solv" / "repomd-repo1.solv";
+    CPPUNIT_ASSERT(std::filesystem::equivalent(solv_path, other_solv_path));
+
+    libdnf5::rpm::PackageQuery query(other_base);
+    query.filter_name({"pkg"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query.size());
+}
+
+
+namespace {
+
+// Creates the repositories from the reposdir `reposdir` in a new base with the repository configuration snapshot
+// enabled and returns their ids
+std::vector<std::string> create_repos_from_snapshot(
+    const std::filesystem::path & temp_dir, const std::filesystem::path & reposdir) {
+    libdnf5::Base snapshot_base;
+    auto & config = snapshot_base.get_config();
+    config.get_installroot_option().set(temp_dir / "installroot");
+    config.get_cachedir_option().set(temp_dir / "cache");
+    config.get_config_file_path_option().set(temp_dir / "dnf.conf");
+    config.get_reposdir_option().set(std::vector<std::string>{reposdir.string()});
+    config.get_use_host_config_option().set(true);
+    config.get_repo_config_snapshot_option().set(true);
+    snapshot_base.get_vars()->set("arch", "x86_64");
+    snapshot_base.get_vars()->set("releasever", "42");
+    snapshot_base.setup();
+    snapshot_base.get_repo_sack()->create_repos_from_system_configuration();
+
+    std::vector<std::string> repo_ids;
+    libdnf5::repo::RepoQuery repos(snapshot_base);
+    for (const auto & repo : repos) {
+        repo_ids.push_back(repo->get_id() + " " + repo->get_config().get_baseurl_option().get_value().at(0));
+    }
+    std::sort(repo_ids.begin(), repo_ids.end());
+    return repo_ids;
+}
+
+}  // namespace
+
+void RepoTest::test_repo_config_snapshot() {
+    auto reposdir = temp->get_path() / "repos.d";
+    std::filesystem::create_directories(reposdir);
+    std::ofstream(temp->get_path() / "dnf.conf") << "[main]\n";
+    std::ofstream(reposdir / "a.repo") << "[repo-a]\n# comment\nbaseurl=http://example.com/$releasever/a\n";
+
+    // The first base parses the files and stores the snapshot, the second one reads it
+    std::vector<std::string> expected{"repo-a http://example.com/42/a"};
+    CPPUNIT_ASSERT_EQUAL(expected, create_repos_from_snapshot(temp->get_path(), reposdir));
+    CPPUNIT_ASSERT(std::filesystem::exists(temp->get_path() / "cache" / "repo_config.snapshot"));
+    CPPUNIT_ASSERT_EQUAL(expected, create_repos_from_snapshot(temp->get_path(), reposdir));
+
+    // Changed and added files outdate the snapshot
+    std::ofstream(reposdir / "a.repo") << "[repo-a]\nbaseurl=http://example.com/$releasever/changed\n";
+    std::ofstream(reposdir / "b.repo") << "[repo-b]\nbaseurl=http://example.com/b\n";
+    expected = {"repo-a http://example.com/42/changed", "repo-b http://example.com/b"};
+    CPPUNIT_ASSERT_EQUAL(expected, create_repos_from_snapshot(temp->get_path(), reposdir));
+    CPPUNIT_ASSERT_EQUAL(expected, create_repos_from_snapshot(temp->get_path(), reposdir));
+}
+
+
+namespace {
+
+// Creates the repository `repo_id` with the `baseurl` in a new base using only the cache in `cache_dir`
+libdnf5::repo::RepoWeakPtr create_cacheonly_repo(
+    libdnf5::Base & base,
+    const std::filesystem::path & temp_dir,
+    const std::filesystem::path & cache_dir,
+    const std::string & repo_id,
+    const std::vector<std::string> & baseurl) {
+    base.get_config().get_installroot_option().set(temp_dir / "installroot");
+    base.get_config().get_cachedir_option().set(cache_dir);
+    base.get_config().get_cacheonly_option().set("all");
+    base.get_vars()->set("arch", "x86_64");
+    base.setup();
+    auto repo = base.get_repo_sack()->create_repo(repo_id);
+    repo->get_config().get_baseurl_option().set(baseurl);
+    return repo;
+}
+
+}  // namespace
+
+void RepoTest::test_cache_bundle() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto bundle_dir = temp->get_path() / "bundle";
+    repo->export_cache_bundle(bundle_dir);
+    CPPUNIT_ASSERT(std::filesystem::exists(bundle_dir / "bundle.toml"));
+    CPPUNIT_ASSERT(std::filesystem::exists(bundle_dir / "repodata" / "repomd.xml"));
+    CPPUNIT_ASSERT(std::filesystem::exists(bundle_dir / "solv" / "repomd-repo1.solv"));
+
+    // The imported bundle is loaded by a base with an empty cache, nothing can be downloaded
+    libdnf5::Base other_base;
+    auto other_repo = create_cacheonly_repo(
+        other_base,
+        temp->get_path(),
+        temp->get_path() / "cache2",
+        "repomd-repo1",
+        repo->get_config().get_baseurl_option().get_value());
+    other_repo->import_cache_bundle(bundle_dir);
+    CPPUNIT_ASSERT(std::filesystem::exists(std::filesystem::path(other_repo->get_cachedir()) / "solv"));
+    other_base.get_repo_sack()->update_and_load_enabled_repos(false);
+
+    libdnf5::rpm::PackageQuery query(other_base);
+    query.filter_name({"pkg"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, query.size());
+}
+
+void RepoTest::test_cache_bundle_damaged() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto bundle_dir = temp->get_path() / "bundle";
+    repo->export_cache_bundle(bundle_dir);
+
+    libdnf5::Base other_base;
+    auto other_repo = create_cacheonly_repo(
+        other_base,
+        temp->get_path(),
+        temp->get_path() / "cache2",
+        "repomd-repo1",
+        repo->get_config().get_baseurl_option().get_value());
+
+    // A modified file is rejected and the cache is left untouched
+    std::ofstream(bundle_dir / "solv" / "repomd-repo1.solv", std::ios::app) << "damaged";
+    CPPUNIT_ASSERT_THROW(other_repo->import_cache_bundle(bundle_dir), libdnf5::repo::RepoError);
+    CPPUNIT_ASSERT(!std::filesystem::exists(std::filesystem::path(other_repo->get_cachedir()) / "solv"));
+
+    // A bundle of another repository is rejected
+    auto another_repo = other_base.get_repo_sack()->create_repo("another");
+    another_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    CPPUNIT_ASSERT_THROW(another_repo->import_cache_bundle(bundle_dir), libdnf5::repo::RepoError);
+}
+
+namespace {
+
+// Returns the names of the packages in `base` providing the file `path` required by the "requirer" package
+std::vector<std::string> get_file_providers(libdnf5::Base & base, const std::string & path) {
+    libdnf5::rpm::PackageQuery requirers(base);
+    requirers.filter_name({"requirer"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, requirers.size());
+    std::vector<std::string> providers;
+    for (const auto & reldep : (*requirers.begin()).get_requires()) {
+        if (reldep.get_name() != path) {
+            continue;
+        }
+        libdnf5::rpm::PackageQuery query(base);
+        query.filter_provides(reldep);
+        for (const auto & pkg : query) {
+            providers.push_back(pkg.get_name());
+        }
+    }
+    return providers;
+}
+
+std::vector<std::string> read_lines(const std::filesystem::path & path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void write_lines(const std::filesystem::path & path, const std::vector<std::string> & lines) {
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto & line : lines) {
+        file << line << '\n';
+    }
+}
+
+// Returns the line of the file provides cache `lines` starting with the escaped `path` and a tab
+std::string find_fileprovides_line(const std::vector<std::string> & lines, const std::string & path) {
+    for (const auto & line : lines) {
+        if (line.starts_with(path + '\t')) {
+            return line;
+        }
+    }
+    CPPUNIT_FAIL("File provide \"" + path + "\" not found in the file provides cache");
+    return {};
+}
+
+const std::vector<std::string> REQUIRED_FILES{
+    "/usr/share/provider/plain",
+    "/usr/share/provider/tab\tfile",
+    "/usr/share/provider/newline\nfile",
+    "/usr/share/provider/back\\slash"};
+
+}  // namespace
+
+void RepoTest::test_fileprovides_cache() {
+    auto repo = add_repo_repomd("repomd-fileprovides");
+    const std::vector<std::string> expected{"provider"};
+    for (const auto & path : REQUIRED_FILES) {
+        CPPUNIT_ASSERT_EQUAL(expected, get_file_providers(base, path));
+    }
+    CPPUNIT_ASSERT(get_file_providers(base, "/usr/share/missing/file").empty());
+
+    // The added file provides are written next to the main solv cache, the paths are escaped and the provides
+    // without providers in the repo are stored too
+    auto cache_path = std::filesystem::path(repo->get_cachedir()) / "solv" / "repomd-fileprovides.fileprovides";
+    auto lines = read_lines(cache_path);
+    CPPUNIT_ASSERT(lines.size() == REQUIRED_FILES.size() + 2);
+    auto plain_line = find_fileprovides_line(lines, "/usr/share/provider/plain");
+    auto provider_offset = plain_line.substr(plain_line.find('\t') + 1);
+    CPPUNIT_ASSERT_EQUAL(
+        "/usr/share/provider/tab\\tfile\t" + provider_offset,
+        find_fileprovides_line(lines, "/usr/share/provider/tab\\tfile"));
+    CPPUNIT_ASSERT_EQUAL(
+        "/usr/share/provider/newline\\nfile\t" + provider_offset,
+        find_fileprovides_line(lines, "/usr/share/provider/newline\\nfile"));
+    CPPUNIT_ASSERT_EQUAL(
+        "/usr/share/provider/back\\\\slash\t" + provider_offset,
+        find_fileprovides_line(lines, "/usr/share/provider/back\\\\slash"));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("/usr/share/missing/file\t"), find_fileprovides_line(lines, "/usr/share/missing/file"));
+
+    // Another base loads the file provides from the cache, including one that libsolv would not add
+    lines.push_back("/usr/share/provider/from-cache\t" + provider_offset);
+    write_lines(cache_path, lines);
+    libdnf5::Base other_base;
+    create_cacheonly_repo(
+        other_base,
+        temp->get_path(),
+        base.get_config().get_cachedir_option().get_value(),
+        "repomd-fileprovides",
+        repo->get_config().get_baseurl_option().get_value());
+    other_base.get_repo_sack()->update_and_load_enabled_repos(false);
+    for (const auto & path : REQUIRED_FILES) {
+        CPPUNIT_ASSERT_EQUAL(expected, get_file_providers(other_base, path));
+    }
+    CPPUNIT_ASSERT(get_file_providers(other_base, "/usr/share/missing/file").empty());
+    libdnf5::rpm::PackageQuery from_cache(other_base);
+    from_cache.filter_provides({"/usr/share/provider/from-cache"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, from_cache.size());
+}
+
+void RepoTest::test_fileprovides_cache_stale() {
+    auto repo = add_repo_repomd("repomd-fileprovides");
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"provider"}, get_file_providers(base, REQUIRED_FILES[0]));
+
+    // A cache of other metadata is ignored, the header ties it to the checksum of the loaded metadata
+    auto cache_path = std::filesystem::path(repo->get_cachedir()) / "solv" / "repomd-fileprovides.fileprovides";
+    auto lines = read_lines(cache_path);
+    const auto header = lines.at(0);
+    // "dnf-fileprovides <version> <checksum> <number of solvables>"
+    auto checksum_end = header.rfind(' ');
+    auto checksum_start = header.rfind(' ', checksum_end - 1) + 1;
+    auto stale_header = header;
+    stale_header.replace(checksum_start, checksum_end - checksum_start, checksum_end - checksum_start, '0');
+    auto plain_line = find_fileprovides_line(lines, "/usr/share/provider/plain");
+    auto provider_offset = plain_line.substr(plain_line.find('\t') + 1);
+    write_lines(cache_path, {stale_header, "/usr/share/provider/from-cache\t" + provider_offset});
+
+    libdnf5::Base other_base;
+    create_cacheonly_repo(
+        other_base,
+        temp->get_path(),
+        base.get_config().get_cachedir_option().get_value(),
+        "repomd-fileprovides",
+        repo->get_config().get_baseurl_option().get_value());
+    other_base.get_repo_sack()->update_and_load_enabled_repos(false);
+    libdnf5::rpm::PackageQuery from_cache(other_base);
+    from_cache.filter_provides({"/usr/share/provider/from-cache"});
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, from_cache.size());
+
+    // The file provides are searched by libsolv again and the cache is rewritten
+    for (const auto & path : REQUIRED_FILES) {
+        CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"provider"}, get_file_providers(other_base, path));
+    }
+    lines = read_lines(cache_path);
+    CPPUNIT_ASSERT_EQUAL(header, lines.at(0));
+    CPPUNIT_ASSERT(lines.size() == REQUIRED_FILES.size() + 2);
+}
+
+void RepoTest::test_system_repo_cache() {
+    auto repo = add_repo_rpm("rpm-repo1");
+    auto baseurl = repo->get_config().get_baseurl_option().get_value();
+    auto installroot = temp->get_path() / "installroot";
+
+    // Installing a package creates the rpmdb in the installroot
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("one");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, transaction.run());
+
+    auto setup_base = [&](libdnf5::Base & other_base) {
+        other_base.get_config().get_installroot_option().set(installroot);
+        other_base.get_config().get_cachedir_option().set(temp->get_path() / "cache");
+        other_base.get_config().get_system_repo_cache_option().set(true);
+        other_base.get_vars()->set("arch", "x86_64");
+        other_base.setup();
+    };
+    auto get_installed = [](libdnf5::Base & other_base) {
+        std::vector<std::string> nevras;
+        libdnf5::rpm::PackageQuery query(other_base);
+        query.filter_installed();
+        for (const auto & pkg : query) {
+            nevras.push_back(pkg.get_full_nevra());
+        }
+        return nevras;
+    };
+
+    // The first load reads the rpmdb and writes the cache to the system state directory
+    libdnf5::Base first_base;
+    setup_base(first_base);
+    first_base.get_repo_sack()->get_system_repo()->load();
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"one-0:2-1.noarch"}, get_installed(first_base));
+
+    std::filesystem::path system_state_dir{first_base.get_config().get_system_state_dir_option().get_value()};
+    auto cache_path = installroot / system_state_dir.relative_path() / "system_repo.solv";
+    CPPUNIT_ASSERT(std::filesystem::exists(cache_path));
+    auto cache_time = std::filesystem::last_write_time(cache_path);
+
+    // While the rpmdb does not change, the cache is loaded and not rewritten
+    libdnf5::Base cached_base;
+    setup_base(cached_base);
+    cached_base.get_repo_sack()->get_system_repo()->load();
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"one-0:2-1.noarch"}, get_installed(cached_base));
+    CPPUNIT_ASSERT(cache_time == std::filesystem::last_write_time(cache_path));
+
+    // Removing the package changes the rpmdb cookie
+    libdnf5::Base remove_base;
+    setup_base(remove_base);
+    auto remove_repo = remove_base.get_repo_sack()->create_repo("rpm-repo1");
+    remove_repo->get_config().get_baseurl_option().set(baseurl);
+    remove_base.get_repo_sack()->update_and_load_enabled_repos(true);
+    libdnf5::Goal remove_goal(remove_base);
+    remove_goal.add_rpm_remove("one");
+    auto remove_transaction = remove_goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, remove_transaction.run());
+
+    // The outdated cache is not used, the rpmdb is read again
+    libdnf5::Base changed_base;
+    setup_base(changed_base);
+    changed_base.get_repo_sack()->get_system_repo()->load();
+    CPPUNIT_ASSERT(get_installed(changed_base).empty());
+
+    // With the option off, no cache is written
+    std::filesystem::remove(cache_path);
+    libdnf5::Base uncached_base;
+    setup_base(uncached_base);
+    uncached_base.get_config().get_system_repo_cache_option().set(false);
+    uncached_base.get_repo_sack()->get_system_repo()->load();
+    CPPUNIT_ASSERT(!std::filesystem::exists(cache_path));
+}
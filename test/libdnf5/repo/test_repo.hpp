@@ -31,6 +31,19 @@ class RepoTest : public BaseTestCase {
     CPPUNIT_TEST(test_load_repo);
     CPPUNIT_TEST(test_load_repo_nonexistent);
     CPPUNIT_TEST(test_update_and_load_enabled_repos_twice_fails);
+    CPPUNIT_TEST(test_memory_usage);
+    CPPUNIT_TEST(test_load_package_details_on_demand);
+    CPPUNIT_TEST(test_load_filelists_on_demand);
+    CPPUNIT_TEST(test_load_filelists_on_demand_concurrent_filters);
+    CPPUNIT_TEST(test_load_filelists_on_demand_missing);
+    CPPUNIT_TEST(test_require_optional_metadata_types);
+    CPPUNIT_TEST(test_solv_cache_shared_between_bases);
+    CPPUNIT_TEST(test_repo_config_snapshot);
+    CPPUNIT_TEST(test_cache_bundle);
+    CPPUNIT_TEST(test_cache_bundle_damaged);
+    CPPUNIT_TEST(test_fileprovides_cache);
+    CPPUNIT_TEST(test_fileprovides_cache_stale);
+    CPPUNIT_TEST(test_system_repo_cache);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -38,6 +51,19 @@ public:
     void test_load_repo();
     void test_load_repo_nonexistent();
     void test_update_and_load_enabled_repos_twice_fails();
+    void test_memory_usage();
+    void test_load_package_details_on_demand();
+    void test_load_filelists_on_demand();
+    void test_load_filelists_on_demand_concurrent_filters();
+    void test_load_filelists_on_demand_missing();
+    void test_require_optional_metadata_types();
+    void test_solv_cache_shared_between_bases();
+    void test_repo_config_snapshot();
+    void test_cache_bundle();
+    void test_cache_bundle_damaged();
+    void test_fileprovides_cache();
+    void test_fileprovides_cache_stale();
+    void test_system_repo_cache();
 };
 
 #endif
@@ -0,0 +1,191 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test_repo_load_benchmark.hpp"
+
+#include "../rpm/synthetic_repo.hpp"
+#include "../shared/benchmark.hpp"
+#include "throttled_http_server.hpp"
+
+#include <fmt/format.h>
+#include <libdnf5/base/span_recorder.hpp>
+#include <libdnf5/conf/const.hpp>
+#include <libdnf5/repo/repo_query.hpp>
+#include <libdnf5/rpm/package_query.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RepoLoadBenchmark);
+
+namespace {
+
+std::size_t get_env_number(const char * name, std::size_t default_value) {
+    const char * value = std::getenv(name);
+    return value ? std::stoul(value) : default_value;
+}
+
+std::size_t get_repo_count() {
+    return get_env_number("LIBDNF5_BENCHMARK_REPO_COUNT", 4);
+}
+
+SyntheticRepoOptions get_repo_options() {
+    SyntheticRepoOptions options;
+    options.names = get_env_number("LIBDNF5_BENCHMARK_REPO_NAMES", 5000);
+    options.advisories = options.names / 5;
+    return options;
+}
+
+/// Returns the directory with the synthetic repository in the "synthetic" subdirectory, the repository is generated
+/// once per process
+const std::filesystem::path & get_fixture_dir() {
+    static std::unique_ptr<libdnf5::utils::fs::TempDir> fixture_dir;
+    if (!fixture_dir) {
+        fixture_dir = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf5_benchmark");
+        write_synthetic_repomd(fixture_dir->get_path() / "synthetic", get_repo_options());
+    }
+    return fixture_dir->get_path();
+}
+
+std::unique_ptr<ThrottledHttpServer> create_http_server() {
+    return std::make_unique<ThrottledHttpServer>(
+        get_fixture_dir(),
+        std::chrono::milliseconds(get_env_number("LIBDNF5_BENCHMARK_HTTP_LATENCY_MS", 20)),
+        get_env_number("LIBDNF5_BENCHMARK_HTTP_BANDWIDTH", 10 * 1024 * 1024));
+}
+
+std::string get_file_baseurl() {
+    return "file://" + (get_fixture_dir() / "synthetic").native();
+}
+
+}  // namespace
+
+
+void RepoLoadBenchmark::setUp() {
+    TestCaseFixture::setUp();
+    temp = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf5_unittest");
+    // Generate the repository before the first measurement
+    get_fixture_dir();
+}
+
+
+std::unique_ptr<libdnf5::Base> RepoLoadBenchmark::create_base(
+    const std::filesystem::path & cachedir, const std::string & baseurl, const std::string & installroot) {
+    auto base = std::make_unique<libdnf5::Base>();
+    auto & config = base->get_config();
+    if (installroot.empty()) {
+        std::filesystem::create_directories(temp->get_path() / "installroot");
+        config.get_installroot_option().set(temp->get_path() / "installroot");
+    } else {
+        config.get_installroot_option().set(installroot);
+    }
+    config.get_cachedir_option().set(cachedir);
+    config.get_optional_metadata_types_option().set(libdnf5::OPTIONAL_METADATA_TYPES);
+    base->get_vars()->set("arch", "x86_64");
+    base->setup();
+
+    if (!baseurl.empty()) {
+        auto repo_sack = base->get_repo_sack();
+        for (std::size_t idx = 0; idx < get_repo_count(); ++idx) {
+            auto repo = repo_sack->create_repo(fmt::format("synthetic{}", idx));
+            repo->get_config().get_baseurl_option().set(baseurl);
+        }
+    }
+    return base;
+}
+
+
+void RepoLoadBenchmark::load_and_report(const std::string & name, libdnf5::Base & base, bool load_system) {
+    auto & span_recorder = base.get_span_recorder();
+    span_recorder.set_enabled(true);
+    auto start = std::chrono::steady_clock::now();
+    base.get_repo_sack()->update_and_load_enabled_repos(load_system);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    span_recorder.set_enabled(false);
+
+    // The phases of the repositories processed concurrently overlap, their sum can exceed the real time
+    std::map<std::string, double> counters;
+    for (const auto & span : span_recorder.get_spans()) {
+        counters[span.name + " ns"] += static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(span.end - span.start).count());
+    }
+    counters["packages"] = static_cast<double>(libdnf5::rpm::PackageQuery(base).size());
+    std::cout << span_recorder.to_string() << std::endl;
+    report_benchmark("RepoLoad/" + name, 1, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed), counters);
+}
+
+
+void RepoLoadBenchmark::test_cold_file() {
+    auto base = create_base(temp->get_path() / "cache", get_file_baseurl());
+    load_and_report("cold_file", *base, false);
+}
+
+
+void RepoLoadBenchmark::test_cold_http() {
+    auto server = create_http_server();
+    auto base = create_base(temp->get_path() / "cache", server->get_url() + "/synthetic");
+    load_and_report("cold_http", *base, false);
+    CPPUNIT_ASSERT(server->get_request_count() >= get_repo_count());
+}
+
+
+void RepoLoadBenchmark::test_warm() {
+    auto server = create_http_server();
+    auto baseurl = server->get_url() + "/synthetic";
+    create_base(temp->get_path() / "cache", baseurl)->get_repo_sack()->update_and_load_enabled_repos(false);
+
+    auto request_count = server->get_request_count();
+    auto base = create_base(temp->get_path() / "cache", baseurl);
+    load_and_report("warm", *base, false);
+    CPPUNIT_ASSERT_EQUAL(request_count, server->get_request_count());
+}
+
+
+void RepoLoadBenchmark::test_expired_in_sync() {
+    auto server = create_http_server();
+    auto baseurl = server->get_url() + "/synthetic";
+    create_base(temp->get_path() / "cache", baseurl)->get_repo_sack()->update_and_load_enabled_repos(false);
+
+    auto request_count = server->get_request_count();
+    auto base = create_base(temp->get_path() / "cache", baseurl);
+    libdnf5::repo::RepoQuery repos(*base);
+    for (auto & repo : repos) {
+        repo->get_config().get_metadata_expire_option().set(0);
+    }
+    load_and_report("expired_in_sync", *base, false);
+    // Only repomd.xml is downloaded for each repository
+    CPPUNIT_ASSERT_EQUAL(request_count + get_repo_count(), server->get_request_count());
+}
+
+
+void RepoLoadBenchmark::test_system_repo() {
+    const char * root = std::getenv("LIBDNF5_BENCHMARK_SYSTEM_ROOT");
+    std::filesystem::path system_root = root ? root : "/";
+    if (!std::filesystem::exists(system_root / "usr/lib/sysimage/rpm") &&
+        !std::filesystem::exists(system_root / "var/lib/rpm")) {
+        std::cout << fmt::format("Skipped, no rpmdb in \"{}\"", system_root.native()) << std::endl;
+        return;
+    }
+
+    auto base = create_base(temp->get_path() / "cache", {}, system_root);
+    load_and_report("system_repo", *base, true);
+}
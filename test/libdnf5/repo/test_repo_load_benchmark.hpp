@@ -0,0 +1,82 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_REPO_REPO_LOAD_BENCHMARK_HPP
+#define TEST_LIBDNF5_REPO_REPO_LOAD_BENCHMARK_HPP
+
+
+#include "../shared/test_case_fixture.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+
+/// End-to-end benchmarks of `RepoSack::update_and_load_enabled_repos()`. The repositories are copies of a synthetic
+/// repository (see synthetic_repo.hpp) served either from a local directory or by a throttled HTTP server.
+/// Each result contains the total time spent in each phase recorded by the `SpanRecorder` of the base.
+///
+/// The benchmarks are configured by environment variables:
+/// - LIBDNF5_BENCHMARK_REPO_COUNT - number of the repositories, default 4
+/// - LIBDNF5_BENCHMARK_REPO_NAMES - number of package names in a repository, default 5000 (4 versions of each)
+/// - LIBDNF5_BENCHMARK_HTTP_LATENCY_MS - latency of the HTTP responses in milliseconds, default 20
+/// - LIBDNF5_BENCHMARK_HTTP_BANDWIDTH - bandwidth of an HTTP connection in bytes per second, default 10 MiB/s,
+///   0 means unlimited
+/// - LIBDNF5_BENCHMARK_SYSTEM_ROOT - installroot with a prepared rpmdb for the system repository, default "/"
+class RepoLoadBenchmark : public TestCaseFixture {
+    CPPUNIT_TEST_SUITE(RepoLoadBenchmark);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_cold_file);
+    CPPUNIT_TEST(test_cold_http);
+    CPPUNIT_TEST(test_warm);
+    CPPUNIT_TEST(test_expired_in_sync);
+    CPPUNIT_TEST(test_system_repo);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    /// Downloads and parses the metadata of file:// repositories
+    void test_cold_file();
+    /// Downloads and parses the metadata of http:// repositories
+    void test_cold_http();
+    /// Loads the repositories from the solv files of a valid cache
+    void test_warm();
+    /// Checks that the expired cached metadata match the http:// repositories and loads them from the solv files
+    void test_expired_in_sync();
+    /// Loads the system repository from the rpmdb of LIBDNF5_BENCHMARK_SYSTEM_ROOT
+    void test_system_repo();
+
+private:
+    /// Creates a base using the `cachedir` with the benchmark repositories located at `baseurl`
+    std::unique_ptr<libdnf5::Base> create_base(
+        const std::filesystem::path & cachedir, const std::string & baseurl, const std::string & installroot = {});
+
+    /// Runs `update_and_load_enabled_repos()` of the `base` and reports the result under `name`
+    void load_and_report(const std::string & name, libdnf5::Base & base, bool load_system);
+};
+
+
+#endif  // TEST_LIBDNF5_REPO_REPO_LOAD_BENCHMARK_HPP
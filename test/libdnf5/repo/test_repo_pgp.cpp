@@ -0,0 +1,111 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_repo_pgp.hpp"
+
+#include "repo/repo_pgp.hpp"
+#include "utils/fs/file.hpp"
+
+#include <libdnf5/repo/repo_errors.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RepoPgpTest);
+
+using namespace libdnf5::repo;
+
+namespace {
+
+const std::filesystem::path DATA_DIR = PROJECT_SOURCE_DIR "/test/libdnf5/repo/data/repo_pgp";
+const std::filesystem::path KEYRING_DIR = DATA_DIR / "keyring";
+// The same key in a keyring of the previous gpg based verification
+const std::filesystem::path GPG_KEYRING_DIR = DATA_DIR / "gpg_keyring";
+const std::string KEY_FINGERPRINT = "257CE18402DED5C378C1B91F2E81E26EE202D2B5";
+const std::filesystem::path REPOMD_PATH = DATA_DIR / "repomd.xml";
+const std::filesystem::path SIGNATURE_PATH = DATA_DIR / "repomd.xml.asc";
+
+}  // namespace
+
+
+void RepoPgpTest::setUp() {
+    CppUnit::TestCase::setUp();
+    temp_dir = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf_test_repo_pgp");
+}
+
+void RepoPgpTest::tearDown() {
+    temp_dir.reset();
+    CppUnit::TestCase::tearDown();
+}
+
+void RepoPgpTest::test_verify_signature() {
+    CPPUNIT_ASSERT_NO_THROW(RepoPgp::verify_signature(KEYRING_DIR, REPOMD_PATH, SIGNATURE_PATH));
+    // the second verification uses the key parsed by the first one
+    CPPUNIT_ASSERT_NO_THROW(RepoPgp::verify_signature(KEYRING_DIR, REPOMD_PATH, SIGNATURE_PATH));
+}
+
+void RepoPgpTest::test_verify_signature_modified_data() {
+    auto modified_repomd_path = temp_dir->get_path() / "repomd.xml";
+    auto repomd = libdnf5::utils::fs::File(REPOMD_PATH, "r").read();
+    libdnf5::utils::fs::File(modified_repomd_path, "w").write(repomd + " ");
+    CPPUNIT_ASSERT_THROW(RepoPgp::verify_signature(KEYRING_DIR, modified_repomd_path, SIGNATURE_PATH), RepoPgpError);
+}
+
+void RepoPgpTest::test_verify_signature_unknown_key() {
+    auto empty_keyring_dir = temp_dir->get_path() / "keyring";
+    std::filesystem::create_directories(empty_keyring_dir);
+    CPPUNIT_ASSERT_THROW(RepoPgp::verify_signature(empty_keyring_dir, REPOMD_PATH, SIGNATURE_PATH), RepoPgpError);
+}
+
+void RepoPgpTest::test_verify_signature_not_signature() {
+    CPPUNIT_ASSERT_THROW(RepoPgp::verify_signature(KEYRING_DIR, REPOMD_PATH, REPOMD_PATH), RepoPgpError);
+}
+
+void RepoPgpTest::test_migrate_gpg_keyring() {
+    auto keyring_dir = temp_dir->get_path() / "keyring";
+    std::filesystem::create_directories(keyring_dir);
+    std::filesystem::copy_file(GPG_KEYRING_DIR / "pubring.kbx", keyring_dir / "pubring.kbx");
+
+    // The keys of the gpg keyring are exported to the key files on the first use
+    const std::vector<std::string> expected{KEY_FINGERPRINT};
+    CPPUNIT_ASSERT_EQUAL(expected, RepoPgp::load_keyring_fingerprints(keyring_dir));
+    auto key_path = keyring_dir / (KEY_FINGERPRINT + ".asc");
+    CPPUNIT_ASSERT(std::filesystem::exists(key_path));
+    CPPUNIT_ASSERT(libdnf5::utils::fs::File(key_path, "r").read().starts_with("-----BEGIN PGP PUBLIC KEY BLOCK-----"));
+    CPPUNIT_ASSERT_NO_THROW(RepoPgp::verify_signature(keyring_dir, REPOMD_PATH, SIGNATURE_PATH));
+
+    // The exported key files are used from then on
+    CPPUNIT_ASSERT_EQUAL(expected, RepoPgp::load_keyring_fingerprints(keyring_dir));
+}
+
+void RepoPgpTest::test_verify_signature_key_file_mismatch() {
+    // A key file named by the fingerprint of the signing key with another content does not verify the signature,
+    // even after the key of the same name was parsed from another keyring
+    CPPUNIT_ASSERT_NO_THROW(RepoPgp::verify_signature(KEYRING_DIR, REPOMD_PATH, SIGNATURE_PATH));
+    auto keyring_dir = temp_dir->get_path() / "keyring";
+    std::filesystem::create_directories(keyring_dir);
+    auto key_path = keyring_dir / (KEY_FINGERPRINT + ".asc");
+    libdnf5::utils::fs::File(key_path, "w").write("not a key");
+    auto mtime = std::filesystem::last_write_time(KEYRING_DIR / (KEY_FINGERPRINT + ".asc"));
+    std::filesystem::last_write_time(key_path, mtime);
+    CPPUNIT_ASSERT_THROW(RepoPgp::verify_signature(keyring_dir, REPOMD_PATH, SIGNATURE_PATH), RepoPgpError);
+}
@@ -0,0 +1,57 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_REPO_REPO_PGP_HPP
+#define LIBDNF5_TEST_REPO_REPO_PGP_HPP
+
+#include "utils/fs/temp.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+
+
+class RepoPgpTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(RepoPgpTest);
+    CPPUNIT_TEST(test_verify_signature);
+    CPPUNIT_TEST(test_verify_signature_modified_data);
+    CPPUNIT_TEST(test_verify_signature_unknown_key);
+    CPPUNIT_TEST(test_verify_signature_not_signature);
+    CPPUNIT_TEST(test_verify_signature_key_file_mismatch);
+    CPPUNIT_TEST(test_migrate_gpg_keyring);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_verify_signature();
+    void test_verify_signature_modified_data();
+    void test_verify_signature_unknown_key();
+    void test_verify_signature_not_signature();
+    void test_verify_signature_key_file_mismatch();
+    void test_migrate_gpg_keyring();
+
+private:
+    std::unique_ptr<libdnf5::utils::fs::TempDir> temp_dir;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test_solv_cache_writer.hpp"
+
+#include "repo/solv_cache_writer.hpp"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SolvCacheWriterTest);
+
+using namespace libdnf5::repo;
+
+
+void SolvCacheWriterTest::test_finish_runs_all_jobs_in_order() {
+    std::vector<int> done;
+    SolvCacheWriter writer;
+    for (int i = 0; i < 5; ++i) {
+        writer.add_job(nullptr, [&done, i]() { done.push_back(i); });
+    }
+    writer.finish();
+
+    std::vector<int> expected = {0, 1, 2, 3, 4};
+    CPPUNIT_ASSERT_EQUAL(expected, done);
+}
+
+void SolvCacheWriterTest::test_add_job_after_finish() {
+    std::vector<int> done;
+    SolvCacheWriter writer;
+    writer.add_job(nullptr, [&done]() { done.push_back(0); });
+    writer.finish();
+    writer.add_job(nullptr, [&done]() { done.push_back(1); });
+    writer.finish();
+
+    std::vector<int> expected = {0, 1};
+    CPPUNIT_ASSERT_EQUAL(expected, done);
+}
+
+void SolvCacheWriterTest::test_cancel_jobs() {
+    int owner1;
+    int owner2;
+    std::vector<int> done;
+    std::promise<void> started;
+    std::promise<void> release;
+    auto release_future = release.get_future();
+    SolvCacheWriter writer;
+    writer.add_job(&owner1, [&done, &started, &release_future]() {
+        started.set_value();
+        release_future.wait();
+        done.push_back(0);
+    });
+    writer.add_job(&owner2, [&done]() { done.push_back(1); });
+    writer.add_job(&owner1, [&done]() { done.push_back(2); });
+    started.get_future().wait();
+
+    // the queued job of the owner is dropped, the running one is waited for
+    std::thread releaser([&release]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.set_value();
+    });
+    writer.cancel_jobs(&owner1);
+    releaser.join();
+    std::vector<int> expected = {0};
+    CPPUNIT_ASSERT_EQUAL(expected, done);
+
+    // the jobs of other owners continue
+    writer.finish();
+    expected = {0, 1};
+    CPPUNIT_ASSERT_EQUAL(expected, done);
+}
@@ -36,6 +36,7 @@ void TempFilesMemoryTest::setUp() {
     temp_dir = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf_test_filesmemory");
     parent_dir_path = temp_dir->get_path();
     full_path = parent_dir_path / TempFilesMemory::MEMORY_FILENAME;
+    legacy_path = parent_dir_path / TempFilesMemory::LEGACY_MEMORY_FILENAME;
 }
 
 void TempFilesMemoryTest::tearDown() {
@@ -56,22 +57,28 @@ void TempFilesMemoryTest::test_get_files_when_empty_storage() {
 }
 
 void TempFilesMemoryTest::test_get_files_throws_exception_when_invalid_format() {
-    libdnf5::utils::fs::File(full_path, "w").write("");
+    libdnf5::utils::fs::File(legacy_path, "w").write("");
     TempFilesMemory memory_empty(parent_dir_path);
     CPPUNIT_ASSERT_THROW(memory_empty.get_files(), libdnf5::Error);
 
-    libdnf5::utils::fs::File(full_path, "w").write("[\"path1\", \"path2\", \"path3\"]");
+    libdnf5::utils::fs::File(legacy_path, "w").write("[\"path1\", \"path2\", \"path3\"]");
     TempFilesMemory memory_invalid(parent_dir_path);
     CPPUNIT_ASSERT_THROW(memory_invalid.get_files(), libdnf5::Error);
 }
 
 void TempFilesMemoryTest::test_get_files_returns_stored_values() {
-    libdnf5::utils::fs::File(full_path, "w")
-        .write(fmt::format(
-            "{} = [\"path/to/package1.rpm\", \"different/path/to/package2.rpm\"]",
-            TempFilesMemory::FILE_PATHS_TOML_KEY));
+    libdnf5::utils::fs::File(full_path, "w").write("path/to/package1.rpm\n\ndifferent/path/to/package2.rpm\n");
+    TempFilesMemory memory(parent_dir_path);
+    std::vector<std::string> expected = {"different/path/to/package2.rpm", "path/to/package1.rpm"};
+    CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
+}
+
+void TempFilesMemoryTest::test_get_files_reads_legacy_storage() {
+    libdnf5::utils::fs::File(legacy_path, "w")
+        .write(fmt::format("{} = [\"path3\", \"path1\"]", TempFilesMemory::FILE_PATHS_TOML_KEY));
+    libdnf5::utils::fs::File(full_path, "w").write("path2\npath1\n");
     TempFilesMemory memory(parent_dir_path);
-    std::vector<std::string> expected = {"path/to/package1.rpm", "different/path/to/package2.rpm"};
+    std::vector<std::string> expected = {"path1", "path2", "path3"};
     CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
 }
 
@@ -87,8 +94,7 @@ void TempFilesMemoryTest::test_add_files_when_empty_storage() {
 
 void TempFilesMemoryTest::test_add_files_when_existing_storage() {
     std::vector<std::string> new_paths = {"path3", "path4"};
-    libdnf5::utils::fs::File(full_path, "w")
-        .write(fmt::format("{} = [\"path1\", \"path2\"]", TempFilesMemory::FILE_PATHS_TOML_KEY));
+    libdnf5::utils::fs::File(full_path, "w").write("path1\npath2\n");
 
     TempFilesMemory memory(parent_dir_path);
     memory.add_files(new_paths);
@@ -98,30 +104,77 @@ void TempFilesMemoryTest::test_add_files_when_existing_storage() {
 
 void TempFilesMemoryTest::test_add_files_deduplicates_and_sorts_data() {
     std::vector<std::string> new_paths = {"path1", "path2", "path4", "path1"};
-    libdnf5::utils::fs::File(full_path, "w")
+    libdnf5::utils::fs::File(full_path, "w").write("path4\npath1\npath4\npath3\n");
+
+    TempFilesMemory memory(parent_dir_path);
+    memory.add_files(new_paths);
+    std::vector<std::string> expected = {"path1", "path2", "path3", "path4"};
+    CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
+}
+
+void TempFilesMemoryTest::test_add_files_after_interrupted_write() {
+    libdnf5::utils::fs::File(full_path, "w").write("path1\npath2");
+
+    TempFilesMemory memory(parent_dir_path);
+    memory.add_files({"path3"});
+    std::vector<std::string> expected = {"path1", "path2", "path3"};
+    CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
+}
+
+void TempFilesMemoryTest::test_add_files_migrates_legacy_storage() {
+    std::vector<std::string> new_paths = {"path1", "path2", "path4", "path1"};
+    libdnf5::utils::fs::File(legacy_path, "w")
         .write(fmt::format("{} = [\"path4\", \"path1\", \"path4\", \"path3\"]", TempFilesMemory::FILE_PATHS_TOML_KEY));
 
     TempFilesMemory memory(parent_dir_path);
     memory.add_files(new_paths);
+    CPPUNIT_ASSERT(!std::filesystem::exists(legacy_path));
     std::vector<std::string> expected = {"path1", "path2", "path3", "path4"};
     CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
 }
 
+void TempFilesMemoryTest::test_add_files_compacts_duplicates() {
+    std::vector<std::string> new_paths;
+    for (int i = 0; i < 1024; ++i) {
+        new_paths.push_back(fmt::format("/{:0>1024}", i % 4));
+    }
+
+    TempFilesMemory memory(parent_dir_path);
+    memory.add_files(new_paths);
+    memory.add_files(new_paths);
+    CPPUNIT_ASSERT(std::filesystem::file_size(full_path) < 8 * 1024);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{4}, memory.get_files().size());
+}
+
 void TempFilesMemoryTest::test_clear_deletes_storage_content() {
+    libdnf5::utils::fs::File(legacy_path, "w")
+        .write(fmt::format("{} = [\"/path/to/package1.rpm\"]", TempFilesMemory::FILE_PATHS_TOML_KEY));
     libdnf5::utils::fs::File(full_path, "w")
-        .write(fmt::format(
-            "{} = [\"/path/to/package1.rpm\", \"/different-path/to/package2.rpm\", "
-            "\"/another-path/leading/to/pkg3.rpm\"]",
-            TempFilesMemory::FILE_PATHS_TOML_KEY));
+        .write("/different-path/to/package2.rpm\n/another-path/leading/to/pkg3.rpm\n");
     TempFilesMemory memory(parent_dir_path);
     std::vector<std::string> expected = {
-        "/path/to/package1.rpm", "/different-path/to/package2.rpm", "/another-path/leading/to/pkg3.rpm"};
+        "/another-path/leading/to/pkg3.rpm", "/different-path/to/package2.rpm", "/path/to/package1.rpm"};
     CPPUNIT_ASSERT_EQUAL(expected, memory.get_files());
 
     memory.clear();
     CPPUNIT_ASSERT(memory.get_files().empty());
 }
 
+void TempFilesMemoryTest::test_remove_files() {
+    auto file1 = parent_dir_path / "package1.rpm";
+    auto file2 = parent_dir_path / "package2.rpm";
+    libdnf5::utils::fs::File(file1, "w").write("");
+    libdnf5::utils::fs::File(file2, "w").write("");
+
+    TempFilesMemory memory(parent_dir_path);
+    memory.add_files({file1.string(), (parent_dir_path / "missing.rpm").string(), file2.string(), file1.string()});
+    CPPUNIT_ASSERT(memory.remove_files().empty());
+    CPPUNIT_ASSERT(!std::filesystem::exists(file1));
+    CPPUNIT_ASSERT(!std::filesystem::exists(file2));
+    CPPUNIT_ASSERT(!std::filesystem::exists(full_path));
+    CPPUNIT_ASSERT(memory.get_files().empty());
+}
+
 void TempFilesMemoryTest::test_clear_when_empty_storage() {
     TempFilesMemory memory(temp_dir->get_path() / "non-existing/path");
     memory.clear();
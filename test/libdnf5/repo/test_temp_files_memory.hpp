@@ -34,11 +34,16 @@ class TempFilesMemoryTest : public CppUnit::TestCase {
     CPPUNIT_TEST(test_get_files_when_empty_storage);
     CPPUNIT_TEST(test_get_files_throws_exception_when_invalid_format);
     CPPUNIT_TEST(test_get_files_returns_stored_values);
+    CPPUNIT_TEST(test_get_files_reads_legacy_storage);
     CPPUNIT_TEST(test_add_files_when_empty_storage);
     CPPUNIT_TEST(test_add_files_when_existing_storage);
     CPPUNIT_TEST(test_add_files_deduplicates_and_sorts_data);
+    CPPUNIT_TEST(test_add_files_after_interrupted_write);
+    CPPUNIT_TEST(test_add_files_migrates_legacy_storage);
+    CPPUNIT_TEST(test_add_files_compacts_duplicates);
     CPPUNIT_TEST(test_clear_deletes_storage_content);
     CPPUNIT_TEST(test_clear_when_empty_storage);
+    CPPUNIT_TEST(test_remove_files);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -49,16 +54,22 @@ public:
     void test_get_files_when_empty_storage();
     void test_get_files_throws_exception_when_invalid_format();
     void test_get_files_returns_stored_values();
+    void test_get_files_reads_legacy_storage();
     void test_add_files_when_empty_storage();
     void test_add_files_when_existing_storage();
     void test_add_files_deduplicates_and_sorts_data();
+    void test_add_files_after_interrupted_write();
+    void test_add_files_migrates_legacy_storage();
+    void test_add_files_compacts_duplicates();
     void test_clear_deletes_storage_content();
     void test_clear_when_empty_storage();
+    void test_remove_files();
 
 private:
     std::unique_ptr<libdnf5::utils::fs::TempDir> temp_dir;
     std::filesystem::path parent_dir_path;
     std::filesystem::path full_path;
+    std::filesystem::path legacy_path;
 };
 
 #endif
@@ -0,0 +1,194 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "throttled_http_server.hpp"
+
+#include <arpa/inet.h>
+#include <fmt/format.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace {
+
+/// Size of the chunks in which the bandwidth is limited
+constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+
+bool send_all(int fd, const char * data, std::size_t size) {
+    while (size > 0) {
+        auto sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+}  // namespace
+
+
+ThrottledHttpServer::ThrottledHttpServer(
+    std::filesystem::path root_dir, std::chrono::milliseconds latency, std::size_t bandwidth)
+    : root_dir(root_dir.lexically_normal()),
+      latency(latency),
+      bandwidth(bandwidth) {
+    listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error(fmt::format("Cannot create socket: {}", std::strerror(errno)));
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t address_len = sizeof(address);
+    if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd, SOMAXCONN) != 0 ||
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &address_len) != 0) {
+        auto error = errno;
+        ::close(listen_fd);
+        throw std::runtime_error(fmt::format("Cannot listen on the loopback interface: {}", std::strerror(error)));
+    }
+    port = ntohs(address.sin_port);
+    accept_thread = std::thread(&ThrottledHttpServer::accept_connections, this);
+}
+
+
+ThrottledHttpServer::~ThrottledHttpServer() {
+    stopping = true;
+    // Wakes up the blocked accept() and recv() calls
+    ::shutdown(listen_fd, SHUT_RDWR);
+    accept_thread.join();
+    {
+        std::lock_guard lock(connections_mutex);
+        for (auto fd : connection_fds) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto & thread : connection_threads) {
+        thread.join();
+    }
+    ::close(listen_fd);
+}
+
+
+std::string ThrottledHttpServer::get_url() const {
+    return fmt::format("http://127.0.0.1:{}", port);
+}
+
+
+void ThrottledHttpServer::accept_connections() {
+    while (!stopping) {
+        int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+        std::lock_guard lock(connections_mutex);
+        if (stopping) {
+            ::close(fd);
+            break;
+        }
+        connection_fds.insert(fd);
+        connection_threads.emplace_back(&ThrottledHttpServer::handle_connection, this, fd);
+    }
+}
+
+
+void ThrottledHttpServer::handle_connection(int fd) {
+    std::string request;
+    char buffer[4096];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<std::size_t>(received));
+    }
+
+    // Request line: <method> <path> <version>
+    std::string_view request_line(request);
+    request_line = request_line.substr(0, request_line.find("\r\n"));
+    auto path_start = request_line.find(' ');
+    auto path_end = request_line.find(' ', path_start + 1);
+    if (path_start != std::string_view::npos && path_end != std::string_view::npos) {
+        ++request_count;
+        std::this_thread::sleep_for(latency);
+        auto path = request_line.substr(path_start + 1, path_end - path_start - 1);
+        path = path.substr(0, path.find('?'));
+        send_file(fd, (root_dir / std::filesystem::path(path).relative_path()).lexically_normal());
+    }
+
+    {
+        std::lock_guard lock(connections_mutex);
+        connection_fds.erase(fd);
+    }
+    ::close(fd);
+}
+
+
+void ThrottledHttpServer::send_file(int fd, const std::filesystem::path & path) {
+    std::error_code ec;
+    auto root_end = std::mismatch(root_dir.begin(), root_dir.end(), path.begin(), path.end()).first;
+    if (root_end != root_dir.end() || !std::filesystem::is_regular_file(path, ec)) {
+        constexpr std::string_view not_found =
+            "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send_all(fd, not_found.data(), not_found.size());
+        return;
+    }
+
+    auto size = std::filesystem::file_size(path);
+    auto header = fmt::format(
+        "HTTP/1.0 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: {}\r\nConnection: close\r\n\r\n",
+        size);
+    if (!send_all(fd, header.data(), header.size())) {
+        return;
+    }
+
+    std::ifstream file(path, std::ifstream::binary);
+    std::vector<char> chunk(CHUNK_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t file_sent_bytes = 0;
+    while (!stopping && (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0)) {
+        auto chunk_size = static_cast<std::size_t>(file.gcount());
+        if (!send_all(fd, chunk.data(), chunk_size)) {
+            return;
+        }
+        file_sent_bytes += chunk_size;
+        sent_bytes += chunk_size;
+        if (bandwidth > 0) {
+            // Sleep until the time in which the sent bytes would be transferred with the bandwidth
+            std::this_thread::sleep_until(start + std::chrono::microseconds(file_sent_bytes * 1000000 / bandwidth));
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_REPO_THROTTLED_HTTP_SERVER_HPP
+#define TEST_LIBDNF5_REPO_THROTTLED_HTTP_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+
+/// Minimal HTTP/1.0 server of the files in a directory for the benchmarks. It listens on a random port of
+/// the loopback interface and serves each connection in its own thread. The responses are delayed by `latency`
+/// and sent with at most `bandwidth` bytes per second of each connection to simulate a remote mirror.
+class ThrottledHttpServer {
+public:
+    /// @param root_dir   The served directory.
+    /// @param latency    The delay before the response to each request.
+    /// @param bandwidth  The maximum number of bytes per second sent to one connection, 0 means unlimited.
+    ThrottledHttpServer(std::filesystem::path root_dir, std::chrono::milliseconds latency, std::size_t bandwidth);
+    ~ThrottledHttpServer();
+
+    ThrottledHttpServer(const ThrottledHttpServer &) = delete;
+    ThrottledHttpServer & operator=(const ThrottledHttpServer &) = delete;
+
+    /// @return The URL of the root directory, e.g. "http://127.0.0.1:40000"
+    std::string get_url() const;
+
+    /// @return The number of the handled requests.
+    std::size_t get_request_count() const noexcept { return request_count; }
+
+    /// @return The number of the sent bytes of the file contents.
+    std::uint64_t get_sent_bytes() const noexcept { return sent_bytes; }
+
+private:
+    void accept_connections();
+    void handle_connection(int fd);
+    void send_file(int fd, const std::filesystem::path & path);
+
+    std::filesystem::path root_dir;
+    std::chrono::milliseconds latency;
+    std::size_t bandwidth;
+    int listen_fd{-1};
+    std::uint16_t port{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> request_count{0};
+    std::atomic<std::uint64_t> sent_bytes{0};
+    std::mutex connections_mutex;
+    std::unordered_set<int> connection_fds;
+    std::vector<std::thread> connection_threads;
+    std::thread accept_thread;
+};
+
+
+#endif  // TEST_LIBDNF5_REPO_THROTTLED_HTTP_SERVER_HPP
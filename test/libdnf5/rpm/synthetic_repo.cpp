@@ -0,0 +1,270 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "synthetic_repo.hpp"
+
+#include <fmt/format.h>
+
+extern "C" {
+#include <solv/chksum.h>
+#include <solv/util.h>
+}
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+constexpr const char * RELEASE = "1.fc40";
+
+std::string get_name(std::size_t name) {
+    return fmt::format("synth{}", name);
+}
+
+std::string get_version(std::size_t version) {
+    return fmt::format("{}.0", version + 1);
+}
+
+const char * get_arch(std::size_t name) {
+    return name % 10 == 0 ? "noarch" : "x86_64";
+}
+
+/// The checksum of the package, unique for each package
+std::string get_pkgid(const SyntheticRepoOptions & options, std::size_t name, std::size_t version) {
+    return fmt::format("{:064x}", name * options.versions + version + 1);
+}
+
+std::string get_sha256(const std::filesystem::path & path) {
+    auto * chksum = solv_chksum_create(solv_chksum_str2type("sha256"));
+    std::ifstream file(path, std::ifstream::binary);
+    std::vector<char> buffer(1 << 16);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+        solv_chksum_add(chksum, buffer.data(), static_cast<int>(file.gcount()));
+    }
+    int length;
+    const auto * binary = solv_chksum_get(chksum, &length);
+    std::string hex(static_cast<std::size_t>(length) * 2 + 1, '\0');
+    solv_bin2hex(binary, length, hex.data());
+    hex.pop_back();
+    solv_chksum_free(chksum, nullptr);
+    return hex;
+}
+
+void write_primary(const std::filesystem::path & path, const SyntheticRepoOptions & options) {
+    std::ofstream out(path);
+    out << fmt::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<metadata xmlns=\"http://linux.duke.edu/metadata/common\" xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\" "
+        "packages=\"{}\">\n",
+        options.names * options.versions);
+    for (std::size_t name = 0; name < options.names; ++name) {
+        auto pkg_name = get_name(name);
+        const auto * arch = get_arch(name);
+        for (std::size_t version = 0; version < options.versions; ++version) {
+            auto ver = get_version(version);
+            out << fmt::format(
+                "<package type=\"rpm\">\n"
+                "  <name>{0}</name>\n"
+                "  <arch>{1}</arch>\n"
+                "  <version epoch=\"0\" ver=\"{2}\" rel=\"{3}\"/>\n"
+                "  <checksum type=\"sha256\" pkgid=\"YES\">{4}</checksum>\n"
+                "  <summary>Synthetic package {0}</summary>\n"
+                "  <description>Synthetic package {0} version {2} generated for the performance tests.</description>\n"
+                "  <packager>Synthetic Packager</packager>\n"
+                "  <url>https://example.com/{0}</url>\n"
+                "  <time file=\"{5}\" build=\"{5}\"/>\n"
+                "  <size package=\"{6}\" installed=\"{7}\" archive=\"{7}\"/>\n"
+                "  <location href=\"Packages/{0}-{2}-{3}.{1}.rpm\"/>\n"
+                "  <format>\n"
+                "    <rpm:license>MIT</rpm:license>\n"
+                "    <rpm:vendor>Synthetic</rpm:vendor>\n"
+                "    <rpm:group>Unspecified</rpm:group>\n"
+                "    <rpm:buildhost>localhost</rpm:buildhost>\n"
+                "    <rpm:sourcerpm>{0}-{2}-{3}.src.rpm</rpm:sourcerpm>\n"
+                "    <rpm:header-range start=\"4504\" end=\"{6}\"/>\n"
+                "    <rpm:provides>\n"
+                "      <rpm:entry name=\"{0}\" flags=\"EQ\" epoch=\"0\" ver=\"{2}\" rel=\"{3}\"/>\n",
+                pkg_name,
+                arch,
+                ver,
+                RELEASE,
+                get_pkgid(options, name, version),
+                1700000000 + version * 86400,
+                10000 + name % 1000 * 100,
+                40000 + name % 1000 * 400);
+            for (std::size_t cap = 0; cap < options.provides; ++cap) {
+                out << fmt::format(
+                    "      <rpm:entry name=\"{}-cap{}\" flags=\"EQ\" epoch=\"0\" ver=\"{}\"/>\n", pkg_name, cap, ver);
+            }
+            out << "    </rpm:provides>\n";
+            if (name > 0 && options.dependencies > 0) {
+                out << "    <rpm:requires>\n";
+                // The first requirement makes chains towards synth0, the others point across the repository
+                out << fmt::format("      <rpm:entry name=\"{}-cap0\"/>\n", get_name(name / 2));
+                for (std::size_t dep = 1; dep < options.dependencies; ++dep) {
+                    out << fmt::format(
+                        "      <rpm:entry name=\"{}-cap{}\"/>\n",
+                        get_name((name * 7919 + dep * 104729) % options.names),
+                        options.provides > 0 ? dep % options.provides : 0);
+                }
+                out << "    </rpm:requires>\n";
+            }
+            if (options.files > 0) {
+                out << fmt::format("    <file>/usr/bin/{}</file>\n", pkg_name);
+            }
+            out << "  </format>\n</package>\n";
+        }
+    }
+    out << "</metadata>\n";
+}
+
+void write_filelists(const std::filesystem::path & path, const SyntheticRepoOptions & options) {
+    std::ofstream out(path);
+    out << fmt::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<filelists xmlns=\"http://linux.duke.edu/metadata/filelists\" packages=\"{}\">\n",
+        options.names * options.versions);
+    for (std::size_t name = 0; name < options.names; ++name) {
+        auto pkg_name = get_name(name);
+        for (std::size_t version = 0; version < options.versions; ++version) {
+            out << fmt::format(
+                "<package pkgid=\"{}\" name=\"{}\" arch=\"{}\">\n"
+                "  <version epoch=\"0\" ver=\"{}\" rel=\"{}\"/>\n",
+                get_pkgid(options, name, version),
+                pkg_name,
+                get_arch(name),
+                get_version(version),
+                RELEASE);
+            for (std::size_t file = 0; file < options.files; ++file) {
+                if (file == 0) {
+                    out << fmt::format("  <file>/usr/bin/{}</file>\n", pkg_name);
+                } else {
+                    out << fmt::format("  <file>/usr/share/{}/file{}</file>\n", pkg_name, file);
+                }
+            }
+            out << "</package>\n";
+        }
+    }
+    out << "</filelists>\n";
+}
+
+void write_updateinfo(const std::filesystem::path & path, const SyntheticRepoOptions & options) {
+    static constexpr const char * TYPES[] = {"bugfix", "enhancement", "security", "newpackage"};
+    static constexpr const char * SEVERITIES[] = {"None", "Low", "Moderate", "Important", "Critical"};
+    std::ofstream out(path);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<updates>\n";
+    const auto latest = get_version(options.versions - 1);
+    for (std::size_t advisory = 0; advisory < options.advisories; ++advisory) {
+        out << fmt::format(
+            "  <update from=\"synthetic@example.com\" status=\"stable\" type=\"{}\" version=\"2.0\">\n"
+            "    <id>SYNTH-2024-{}</id>\n"
+            "    <title>Synthetic advisory {}</title>\n"
+            "    <issued date=\"2024-01-01 00:00:00\"/>\n"
+            "    <updated date=\"2024-01-02 00:00:00\"/>\n"
+            "    <severity>{}</severity>\n"
+            "    <description>Synthetic advisory generated for the performance tests.</description>\n"
+            "    <references>\n"
+            "      <reference href=\"https://example.com/{}\" id=\"{}\" type=\"bugzilla\" title=\"Bug {}\"/>\n"
+            "    </references>\n"
+            "    <pkglist>\n"
+            "      <collection short=\"synth\">\n"
+            "        <name>Synthetic</name>\n",
+            TYPES[advisory % std::size(TYPES)],
+            advisory,
+            advisory,
+            SEVERITIES[advisory % std::size(SEVERITIES)],
+            advisory,
+            100000 + advisory,
+            100000 + advisory);
+        for (std::size_t idx = 0; idx < options.packages_per_advisory; ++idx) {
+            auto name = (advisory * options.packages_per_advisory + idx) % options.names;
+            auto pkg_name = get_name(name);
+            out << fmt::format(
+                "        <package name=\"{0}\" version=\"{1}\" release=\"{2}\" epoch=\"0\" arch=\"{3}\" "
+                "src=\"{0}-{1}-{2}.src.rpm\">\n"
+                "          <filename>{0}-{1}-{2}.{3}.rpm</filename>\n"
+                "        </package>\n",
+                pkg_name,
+                latest,
+                RELEASE,
+                get_arch(name));
+        }
+        out << "      </collection>\n    </pkglist>\n  </update>\n";
+    }
+    out << "</updates>\n";
+}
+
+}  // namespace
+
+
+void write_synthetic_repomd(const std::filesystem::path & repo_dir, const SyntheticRepoOptions & options) {
+    auto repodata_dir = repo_dir / "repodata";
+    std::filesystem::create_directories(repodata_dir);
+
+    struct Metadata {
+        const char * type;
+        void (*write)(const std::filesystem::path &, const SyntheticRepoOptions &);
+    };
+    const Metadata metadata[] = {
+        {"primary", write_primary}, {"filelists", write_filelists}, {"updateinfo", write_updateinfo}};
+
+    std::ofstream repomd(repodata_dir / "repomd.xml");
+    repomd << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\">\n"
+              "  <revision>1700000000</revision>\n";
+    for (const auto & item : metadata) {
+        auto file_name = fmt::format("{}.xml", item.type);
+        auto path = repodata_dir / file_name;
+        item.write(path, options);
+        auto checksum = get_sha256(path);
+        auto size = std::filesystem::file_size(path);
+        repomd << fmt::format(
+            "  <data type=\"{0}\">\n"
+            "    <checksum type=\"sha256\">{1}</checksum>\n"
+            "    <open-checksum type=\"sha256\">{1}</open-checksum>\n"
+            "    <location href=\"repodata/{2}\"/>\n"
+            "    <timestamp>1700000000</timestamp>\n"
+            "    <size>{3}</size>\n"
+            "    <open-size>{3}</open-size>\n"
+            "  </data>\n",
+            item.type,
+            checksum,
+            file_name,
+            size);
+    }
+    repomd << "</repomd>\n";
+}
+
+
+void write_synthetic_system_repo(
+    const std::filesystem::path & path, const SyntheticRepoOptions & options, std::size_t step) {
+    std::ofstream out(path);
+    out << "=Ver: 3.0\n";
+    for (std::size_t name = 0; name < options.names; name += step) {
+        auto pkg_name = get_name(name);
+        auto ver = get_version(0);
+        out << fmt::format("=Pkg: {} {} {} {}\n", pkg_name, ver, RELEASE, get_arch(name));
+        out << fmt::format("=Prv: {} = {}-{}\n", pkg_name, ver, RELEASE);
+        for (std::size_t cap = 0; cap < options.provides; ++cap) {
+            out << fmt::format("=Prv: {}-cap{} = {}\n", pkg_name, cap, ver);
+        }
+    }
+}
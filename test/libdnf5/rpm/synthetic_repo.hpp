@@ -0,0 +1,58 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_RPM_SYNTHETIC_REPO_HPP
+#define TEST_LIBDNF5_RPM_SYNTHETIC_REPO_HPP
+
+
+#include <cstddef>
+#include <filesystem>
+
+
+/// Shape of a synthetic repository generated for the performance tests. The defaults give a repository
+/// of a realistic size, 100k packages with their provides, requires, files and advisories.
+struct SyntheticRepoOptions {
+    /// Number of package names, the package names are `synth<N>`
+    std::size_t names{25000};
+    /// Number of versions of each package name, the versions are `<V>.0`
+    std::size_t versions{4};
+    /// Number of capabilities `synth<N>-cap<K>` provided by each package besides its name
+    std::size_t provides{8};
+    /// Number of capabilities required by each package. The first one is provided by the package with the half
+    /// of its number, the requires form chains of the depth log2(names).
+    std::size_t dependencies{4};
+    /// Number of files of each package in filelists, the first one is in `/usr/bin` and is also in primary
+    std::size_t files{10};
+    /// Number of advisories, each one fixes the latest version of several packages
+    std::size_t advisories{5000};
+    std::size_t packages_per_advisory{5};
+};
+
+/// Writes the repository metadata (repomd.xml, primary.xml, filelists.xml and updateinfo.xml) of synthetic
+/// packages to `repo_dir`/repodata. The metadata are not compressed.
+void write_synthetic_repomd(const std::filesystem::path & repo_dir, const SyntheticRepoOptions & options);
+
+/// Writes a libsolv testcase repository to `path` with the first version of each `step`-th package name
+/// of a repository generated with `options`. It is used as the system repository, its packages have upgrades.
+void write_synthetic_system_repo(
+    const std::filesystem::path & path, const SyntheticRepoOptions & options, std::size_t step);
+
+
+#endif  // TEST_LIBDNF5_RPM_SYNTHETIC_REPO_HPP
@@ -215,6 +215,53 @@ public:
 }  // namespace
 
 
+void NevraTest::test_nevra_parser() {
+    using Form = libdnf5::rpm::Nevra::Form;
+    const std::string nevra_str = "four-of-fish-8:3.6.9-11.fc100.x86_64";
+    libdnf5::rpm::NevraParser parser(nevra_str);
+    libdnf5::rpm::NevraView nevra;
+
+    CPPUNIT_ASSERT(parser.parse(Form::NEVRA, nevra));
+    CPPUNIT_ASSERT(nevra.get_name() == "four-of-fish");
+    CPPUNIT_ASSERT(nevra.get_epoch() == "8");
+    CPPUNIT_ASSERT(nevra.get_version() == "3.6.9");
+    CPPUNIT_ASSERT(nevra.get_release() == "11.fc100");
+    CPPUNIT_ASSERT(nevra.get_arch() == "x86_64");
+    // the attributes reference the parsed string
+    CPPUNIT_ASSERT(nevra.get_name().data() == nevra_str.data());
+    CPPUNIT_ASSERT_EQUAL(nevra_str, to_full_nevra_string(nevra.to_nevra()));
+
+    CPPUNIT_ASSERT(parser.parse(Form::NEVR, nevra));
+    CPPUNIT_ASSERT(nevra.get_name() == "four-of-fish");
+    CPPUNIT_ASSERT(nevra.get_epoch() == "8");
+    CPPUNIT_ASSERT(nevra.get_version() == "3.6.9");
+    CPPUNIT_ASSERT(nevra.get_release() == "11.fc100.x86_64");
+    CPPUNIT_ASSERT(nevra.get_arch().empty());
+
+    // ':' is not allowed in the name or arch, the view is cleared
+    CPPUNIT_ASSERT(!parser.parse(Form::NA, nevra));
+    CPPUNIT_ASSERT(nevra.get_name().empty());
+    CPPUNIT_ASSERT(!parser.parse(Form::NAME, nevra));
+
+    // the parser splits the forms the same way as Nevra::parse()
+    for (const std::string spec :
+         {"pkg", "pkg.noarch", "pkg-1.2", "pkg-1:1.2-3", "pkg-1.2-3.noarch", "[a-z]*-1.[0-9]"}) {
+        libdnf5::rpm::NevraParser spec_parser(spec);
+        for (auto form : {Form::NEVRA, Form::NEVR, Form::NEV, Form::NA, Form::NAME}) {
+            auto nevras = libdnf5::rpm::Nevra::parse(spec, {form});
+            libdnf5::rpm::NevraView view;
+            CPPUNIT_ASSERT_EQUAL(nevras.size() == 1, spec_parser.parse(form, view));
+            if (!nevras.empty()) {
+                CPPUNIT_ASSERT_EQUAL(nevras[0], view.to_nevra());
+            }
+        }
+    }
+
+    CPPUNIT_ASSERT_THROW(libdnf5::rpm::NevraParser("pkg-8:9:1.2-3"), libdnf5::rpm::NevraIncorrectInputError);
+    CPPUNIT_ASSERT_THROW(libdnf5::rpm::NevraParser("pkg >= 1.2"), libdnf5::rpm::NevraIncorrectInputError);
+}
+
+
 void NevraTest::test_evrcmp() {
     TestPackage foo_0_1_1_noarch("foo-1-1.noarch");
     TestPackage foo_1_1_1_noarch("foo-1:1-1.noarch");
@@ -28,6 +28,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class NevraTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(NevraTest);
     CPPUNIT_TEST(test_nevra);
+    CPPUNIT_TEST(test_nevra_parser);
     CPPUNIT_TEST(test_evrcmp);
     CPPUNIT_TEST(test_cmp_nevra);
     CPPUNIT_TEST(test_cmp_naevr);
@@ -38,6 +39,7 @@ public:
     void tearDown() override;
 
     void test_nevra();
+    void test_nevra_parser();
     void test_evrcmp();
     void test_cmp_nevra();
     void test_cmp_naevr();
@@ -21,8 +21,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_package.hpp"
 
 #include "../shared/utils.hpp"
+#include "rpm/package_reasons.hpp"
 
 #include <libdnf5/rpm/nevra.hpp>
+#include <libdnf5/rpm/package_query.hpp>
+#include <libdnf5/rpm/reldep_span.hpp>
 
 #include <vector>
 
@@ -160,6 +163,24 @@ void RpmPackageTest::test_get_description() {
 }
 
 
+void RpmPackageTest::test_get_views() {
+    for (const auto & nevra : {"pkg-1.2-3.x86_64", "pkg-libs-1:1.3-4.x86_64", "unresolvable-1:2-3.noarch"}) {
+        auto pkg = get_pkg(nevra);
+        CPPUNIT_ASSERT_EQUAL(pkg.get_name(), std::string(pkg.get_name_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_epoch(), std::string(pkg.get_epoch_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_version(), std::string(pkg.get_version_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_release(), std::string(pkg.get_release_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_arch(), std::string(pkg.get_arch_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_evr(), std::string(pkg.get_evr_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_packager(), std::string(pkg.get_packager_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_vendor(), std::string(pkg.get_vendor_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_url(), std::string(pkg.get_url_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_summary(), std::string(pkg.get_summary_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_description(), std::string(pkg.get_description_view()));
+    }
+}
+
+
 void RpmPackageTest::test_get_files() {
     const auto files = get_pkg("pkg-1.2-3.x86_64").get_files();
     const std::vector<std::string> expected = {
@@ -170,6 +191,22 @@ void RpmPackageTest::test_get_files() {
 }
 
 
+void RpmPackageTest::test_for_each_file() {
+    std::vector<std::string> files;
+    get_pkg("pkg-1.2-3.x86_64").for_each_file([&files](std::string_view path) { files.emplace_back(path); });
+    const std::vector<std::string> expected = {
+        "/etc/pkg.conf",
+        "/etc/pkg.conf.d",
+    };
+    CPPUNIT_ASSERT_EQUAL(expected, files);
+
+    // a package without files
+    bool called = false;
+    get_pkg("pkg-libs-1:1.3-4.x86_64").for_each_file([&called](std::string_view) { called = true; });
+    CPPUNIT_ASSERT(!called);
+}
+
+
 void RpmPackageTest::test_get_provides() {
     auto actual = get_pkg("pkg-1.2-3.x86_64").get_provides();
     const std::vector<Reldep> expected = {Reldep(base, "pkg = 1.2-3")};
@@ -322,3 +359,60 @@ void RpmPackageTest::test_to_full_nevra_string() {
     auto pkg2 = get_pkg("pkg-libs-1:1.3-4.x86_64");
     CPPUNIT_ASSERT_EQUAL(std::string("pkg-libs-1:1.3-4.x86_64"), libdnf5::rpm::to_full_nevra_string(pkg2));
 }
+
+
+void RpmPackageTest::test_reldep_span() {
+    using libdnf5::rpm::PackageAttribute;
+    using libdnf5::rpm::ReldepSpan;
+
+    auto pkg = get_pkg("unresolvable-1:2-3.noarch");
+    ReldepSpan requires_span(pkg, PackageAttribute::REQUIRES);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, requires_span.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("req = 1:2-3"), requires_span.to_string(0));
+    CPPUNIT_ASSERT_EQUAL(std::string("prereq"), requires_span.to_string(1));
+    CPPUNIT_ASSERT_EQUAL(Reldep(base, "prereq"), requires_span.get(1));
+
+    // the spans contain the same reldeps as the getters for all packages
+    using Getter = libdnf5::rpm::ReldepList (libdnf5::rpm::Package::*)() const;
+    const std::vector<std::pair<PackageAttribute, Getter>> getters = {
+        {PackageAttribute::PROVIDES, &libdnf5::rpm::Package::get_provides},
+        {PackageAttribute::REQUIRES, &libdnf5::rpm::Package::get_requires},
+        {PackageAttribute::REQUIRES_PRE, &libdnf5::rpm::Package::get_requires_pre},
+        {PackageAttribute::CONFLICTS, &libdnf5::rpm::Package::get_conflicts},
+        {PackageAttribute::OBSOLETES, &libdnf5::rpm::Package::get_obsoletes},
+        {PackageAttribute::RECOMMENDS, &libdnf5::rpm::Package::get_recommends},
+        {PackageAttribute::SUGGESTS, &libdnf5::rpm::Package::get_suggests},
+        {PackageAttribute::ENHANCES, &libdnf5::rpm::Package::get_enhances},
+        {PackageAttribute::SUPPLEMENTS, &libdnf5::rpm::Package::get_supplements},
+    };
+    for (const auto & package : libdnf5::rpm::PackageQuery(base)) {
+        for (const auto & [attribute, getter] : getters) {
+            std::vector<int> expected;
+            for (const auto & reldep : (package.*getter)()) {
+                expected.push_back(reldep.get_id().id);
+            }
+            std::vector<int> actual;
+            ReldepSpan span(package, attribute);
+            for (auto reldep_id : span) {
+                actual.push_back(reldep_id.id);
+            }
+            CPPUNIT_ASSERT_EQUAL(expected, actual);
+            CPPUNIT_ASSERT_EQUAL(expected.size(), span.size());
+        }
+    }
+
+    CPPUNIT_ASSERT_THROW(ReldepSpan(pkg, PackageAttribute::NAME), libdnf5::UserAssertionError);
+}
+
+
+void RpmPackageTest::test_package_reasons() {
+    using libdnf5::transaction::TransactionItemReason;
+    auto installed = add_system_pkg("repos-rpm/rpm-repo1/one-1-1.noarch.rpm", TransactionItemReason::USER);
+
+    // The batched lookup agrees with the reasons of the individual packages, installed or not
+    libdnf5::rpm::PackageReasons reasons(base.get_weak_ptr());
+    for (const auto & package : libdnf5::rpm::PackageQuery(base)) {
+        CPPUNIT_ASSERT_EQUAL(package.get_reason(), reasons.get_reason(package.get_id().id));
+    }
+    CPPUNIT_ASSERT_EQUAL(TransactionItemReason::USER, reasons.get_reason(installed.get_id().id));
+}
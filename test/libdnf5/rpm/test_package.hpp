@@ -51,7 +51,9 @@ class RpmPackageTest : public BaseTestCase {
     CPPUNIT_TEST(test_get_url);
     CPPUNIT_TEST(test_get_summary);
     CPPUNIT_TEST(test_get_description);
+    CPPUNIT_TEST(test_get_views);
     CPPUNIT_TEST(test_get_files);
+    CPPUNIT_TEST(test_for_each_file);
     CPPUNIT_TEST(test_get_provides);
     CPPUNIT_TEST(test_get_requires);
     CPPUNIT_TEST(test_get_requires_pre);
@@ -75,6 +77,8 @@ class RpmPackageTest : public BaseTestCase {
 
     CPPUNIT_TEST(test_to_nevra_string);
     CPPUNIT_TEST(test_to_full_nevra_string);
+    CPPUNIT_TEST(test_reldep_span);
+    CPPUNIT_TEST(test_package_reasons);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -102,7 +106,9 @@ public:
     void test_get_url();
     void test_get_summary();
     void test_get_description();
+    void test_get_views();
     void test_get_files();
+    void test_for_each_file();
     void test_get_provides();
     void test_get_requires();
     void test_get_requires_pre();
@@ -126,6 +132,8 @@ public:
 
     void test_to_nevra_string();
     void test_to_full_nevra_string();
+    void test_reldep_span();
+    void test_package_reasons();
 };
 
 
@@ -20,12 +20,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_package_query.hpp"
 
+#include "../shared/private_accessor.hpp"
 #include "../shared/utils.hpp"
+#include "base/base_impl.hpp"
+#include "rpm/package_sack_impl.hpp"
+#include "system/state.hpp"
 
+#include <fmt/format.h>
 #include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/rpm/package_set.hpp>
 
 #include <filesystem>
+#include <fstream>
 #include <set>
 #include <vector>
 
@@ -36,12 +42,33 @@ using namespace libdnf5::rpm;
 
 namespace {
 
+// Accessors of private Base::p_impl and PackageSack::p_impl, see private_accessor.hpp
+create_private_getter_template;
+create_getter(priv_impl, &libdnf5::Base::p_impl);
+create_getter(sack_priv_impl, &libdnf5::rpm::PackageSack::p_impl);
+
 // make constructor public so we can create Package instances in the tests
 class TestPackage : public Package {
 public:
     TestPackage(const libdnf5::BaseWeakPtr & base, PackageId id) : libdnf5::rpm::Package(base, id) {}
 };
 
+// returns the leaf groups with the NEVRAs of each group joined by spaces
+std::vector<std::string> to_strings(const std::vector<std::vector<Package>> & groups) {
+    std::vector<std::string> result;
+    for (const auto & group : groups) {
+        std::string nevras;
+        for (const auto & package : group) {
+            if (!nevras.empty()) {
+                nevras += ' ';
+            }
+            nevras += package.get_nevra();
+        }
+        result.push_back(std::move(nevras));
+    }
+    return result;
+}
+
 }  // namespace
 
 
@@ -257,6 +284,25 @@ void RpmPackageQueryTest::test_filter_name() {
 
     // ---
 
+    // packages with Name matching "PKG-l*" glob - case insensitive match of the literal prefix
+    PackageQuery query_iglob_prefix(base);
+    query_iglob_prefix.filter_name({"PKG-l*"}, libdnf5::sack::QueryCmp::IGLOB);
+
+    expected = {
+        get_pkg("pkg-libs-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.2-4.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query_iglob_prefix));
+
+    // ---
+
+    // packages with Name matching "PKG-l*" glob - case sensitive match of the literal prefix
+    PackageQuery query_glob_prefix(base);
+    query_glob_prefix.filter_name({"PKG-l*"}, libdnf5::sack::QueryCmp::GLOB);
+
+    expected = {};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query_glob_prefix));
+
+    // ---
+
     // unsupported comparison type (operator)
     CPPUNIT_ASSERT_THROW(query8.filter_name({"pkg"}, libdnf5::sack::QueryCmp::GT), libdnf5::AssertionError);
 
@@ -476,6 +522,22 @@ void RpmPackageQueryTest::test_filter_nevra() {
         std::vector<Package> expected = {};
         CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
     }
+
+    {
+        // Test QueryCmp::GLOB - literal prefix of the pattern spans the name and the version
+        PackageQuery query(base);
+        query.filter_nevra({"pkg-1.2-*"}, libdnf5::sack::QueryCmp::GLOB);
+        std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+    }
+
+    {
+        // Test QueryCmp::IGLOB - literal prefix of the pattern with epoch differs in case
+        PackageQuery query(base);
+        query.filter_nevra({"PKG-LIBS-1:1.?-4.*"}, libdnf5::sack::QueryCmp::IGLOB);
+        std::vector<Package> expected = {get_pkg("pkg-libs-1:1.2-4.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+    }
 }
 
 
@@ -531,7 +593,32 @@ void RpmPackageQueryTest::test_filter_priority() {
 
     PackageQuery query1(base);
     query1.filter_priority();
-    /// TODO(jmracek) Run test with repository with a different priority and check result
+    CPPUNIT_ASSERT_EQUAL((size_t)29, query1.size());
+
+    // the same packages in a repository with a higher priority (a lower value) replace the others
+    auto repo = repo_sack->create_repo_from_libsolv_testcase(
+        "repo1-copy", PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-repo1.repo");
+    repo->set_priority(10);
+    PackageQuery query2(base);
+    query2.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)29, query2.size());
+    PackageQuery query2_copy(base);
+    query2_copy.filter_repo_id({"repo1-copy"});
+    CPPUNIT_ASSERT_EQUAL((size_t)5, query2_copy.size());
+    query2_copy &= query2;
+    CPPUNIT_ASSERT_EQUAL((size_t)5, query2_copy.size());
+
+    // the priority is compared only among the candidates
+    PackageQuery query3(base);
+    query3.filter_repo_id({"solv-repo1"});
+    query3.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)5, query3.size());
+
+    // a change of the priority is reflected
+    repo->set_priority(99);
+    PackageQuery query4(base);
+    query4.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)34, query4.size());
 }
 
 void RpmPackageQueryTest::test_filter_provides() {
@@ -559,6 +646,22 @@ void RpmPackageQueryTest::test_filter_provides() {
 }
 
 
+void RpmPackageQueryTest::test_is_provided() {
+    add_repo_solv("solv-repo1");
+
+    libdnf5::rpm::Reldep libpkg(base, "libpkg.so.0()(64bit)");
+    libdnf5::rpm::Reldep missing(base, "does-not-exist");
+
+    PackageQuery query(base);
+    CPPUNIT_ASSERT(query.is_provided(libpkg.get_id()));
+    CPPUNIT_ASSERT(!query.is_provided(missing.get_id()));
+
+    // the only provider is not in the query
+    query.filter_provides({"libpkg.so.0()(64bit)"}, libdnf5::sack::QueryCmp::NEQ);
+    CPPUNIT_ASSERT(!query.is_provided(libpkg.get_id()));
+}
+
+
 void RpmPackageQueryTest::test_filter_requires() {
     add_repo_solv("solv-repo1");
 
@@ -583,6 +686,277 @@ void RpmPackageQueryTest::test_filter_requires() {
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
 }
 
+void RpmPackageQueryTest::test_filter_requires_package_set() {
+    add_repo_solv("solv-repo1");
+
+    // packages requiring something provided by pkg-libs-1.2-3
+    PackageQuery providers1(base);
+    providers1.filter_nevra({"pkg-libs-0:1.2-3.x86_64"});
+    PackageQuery query1(base);
+    query1.filter_requires(providers1);
+
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // ---
+
+    // pkg-libs-1:1.3-4 does not provide "pkg-libs = 1.2-3"
+    PackageQuery providers2(base);
+    providers2.filter_nevra({"pkg-libs-1:1.3-4.x86_64"});
+    PackageQuery query2(base);
+    query2.filter_requires(providers2);
+
+    expected = {};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // ---
+
+    // packages not requiring anything provided by pkg-libs-1.2-3
+    PackageQuery query3(base);
+    query3.filter_requires(providers1, libdnf5::sack::QueryCmp::NEQ);
+
+    expected = {
+        get_pkg("pkg-0:1.2-3.src"),
+        get_pkg("pkg-libs-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-1:1.2-4.x86_64"),
+        get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+}
+
+void RpmPackageQueryTest::test_filter_summary_text_index() {
+    add_repo_repomd("repomd-repo1");
+    base.get_config().get_text_search_index_option().set(true);
+
+    // all packages in the repository have "Summary" summary
+    PackageQuery query1(base);
+    query1.filter_summary({"MMAR"}, libdnf5::sack::QueryCmp::ICONTAINS);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, query1.size());
+
+    // the index shortlists the packages, the pattern still has to match case-sensitively
+    PackageQuery query2(base);
+    query2.filter_summary({"MMAR"}, libdnf5::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query2.size());
+
+    // all trigrams are present, but not in this order
+    PackageQuery query3(base);
+    query3.filter_summary({"marsum"}, libdnf5::sack::QueryCmp::ICONTAINS);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query3.size());
+
+    // literal parts of the glob provide the trigrams
+    PackageQuery query4(base);
+    query4.filter_summary({"summ*ry"}, libdnf5::sack::QueryCmp::IGLOB);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, query4.size());
+
+    // patterns shorter than a trigram are matched against all packages
+    PackageQuery query5(base);
+    query5.filter_description({"es"}, libdnf5::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, query5.size());
+
+    PackageQuery query6(base);
+    query6.filter_description({"unknown"}, libdnf5::sack::QueryCmp::ICONTAINS);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query6.size());
+}
+
+void RpmPackageQueryTest::test_filter_file_index() {
+    add_repo_repomd("repomd-repo1");
+    base.get_config().get_file_search_index_option().set(true);
+
+    PackageQuery query1(base);
+    query1.filter_file({"/etc/pkg.conf"});
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // the index shortlists the path case-insensitively, the pattern still has to match case-sensitively
+    PackageQuery query2(base);
+    query2.filter_file({"/etc/PKG.conf"});
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query2.size());
+
+    PackageQuery query3(base);
+    query3.filter_file({"/etc/PKG.conf"}, libdnf5::sack::QueryCmp::IEXACT);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    // a prefix of a path is not a match
+    PackageQuery query4(base);
+    query4.filter_file({"/etc/pkg"});
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query4.size());
+
+    // globs are matched against all packages
+    PackageQuery query5(base);
+    query5.filter_file({"/etc/pkg.conf*"}, libdnf5::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query5));
+}
+
+void RpmPackageQueryTest::test_filter_sourcerpm() {
+    add_repo_repomd("repomd-repo1");
+
+    PackageQuery query1(base);
+    query1.filter_sourcerpm({"pkg-1.2-3.src.rpm"});
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // the glob is matched against the distinct source rpm names
+    PackageQuery query2(base);
+    query2.filter_sourcerpm({"pkg-*"}, libdnf5::sack::QueryCmp::GLOB);
+    expected = {get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // or against the candidates when they are fewer
+    PackageQuery query3(base);
+    query3.filter_name({"pkg-libs"});
+    query3.filter_sourcerpm({"pkg-*"}, libdnf5::sack::QueryCmp::GLOB);
+    expected = {get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_sourcerpm({"pkg-1.2-3.src.rpm", "pkg-1.3-4.src.rpm"}, libdnf5::sack::QueryCmp::NEQ);
+    expected = {get_pkg("unresolvable-1:2-3.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query4));
+
+    // the repository has no source packages
+    PackageQuery query5(base);
+    query5.filter_sources_of(query1);
+    CPPUNIT_ASSERT(query5.empty());
+}
+
+void RpmPackageQueryTest::test_filter_upgrades_downgrades() {
+    repo_sack->get_system_repo()->add_libsolv_testcase(
+        PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-upgrades-system.repo");
+    add_repo_solv("solv-upgrades");
+
+    // foo-1-3.i686 is not an upgrade of foo-1-1.x86_64, noarch can be upgraded to x86_64,
+    // the highest installed kernel is compared
+    PackageQuery query1(base);
+    query1.filter_upgrades();
+    std::vector<Package> expected = {
+        get_pkg("foo-0:1-2.x86_64"), get_pkg("bar-0:2-2.x86_64"), get_pkg("kernel-0:3-1.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    PackageQuery query2(base);
+    query2.filter_upgradable();
+    expected = {
+        get_pkg("foo-0:1-1.x86_64", true), get_pkg("bar-0:2-1.noarch", true), get_pkg("kernel-0:2-1.x86_64", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // a downgrade has the same arch, the lowest installed kernel is compared
+    PackageQuery query3(base);
+    query3.filter_downgrades();
+    expected = {get_pkg("foo-0:1-0.x86_64"), get_pkg("bar-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_downgradable();
+    expected = {get_pkg("foo-0:1-1.x86_64", true), get_pkg("bar-0:2-1.noarch", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query4));
+
+    // the index is rebuilt when packages are added
+    repo_sack->create_repo_from_libsolv_testcase(
+        "upgrades-copy", PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-upgrades.repo");
+    PackageQuery query5(base);
+    query5.filter_upgrades();
+    CPPUNIT_ASSERT_EQUAL((size_t)6, query5.size());
+}
+
+void RpmPackageQueryTest::test_filter_leaves() {
+    repo_sack->get_system_repo()->add_libsolv_testcase(
+        PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-leaves-system.repo");
+
+    // the packages required by a cycle are not leaves, a dependency satisfied by more packages adds no edge
+    std::vector<std::string> expected = {
+        "app-1-1.x86_64",
+        "cycle-a-1-1.x86_64 cycle-b-1-1.x86_64",
+        "loop-user-1-1.x86_64",
+        "virt-user-1-1.x86_64",
+        "virt-one-1-1.x86_64",
+        "virt-two-1-1.x86_64",
+        "weak-user-1-1.x86_64"};
+    PackageQuery query1(base);
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(query1.filter_leaves_groups()));
+    CPPUNIT_ASSERT_EQUAL((size_t)8, query1.size());
+
+    // without weak dependencies the recommended package is a leaf
+    base.get_config().get_install_weak_deps_option().set(false);
+    PackageQuery query2(base);
+    query2.filter_leaves();
+    CPPUNIT_ASSERT_EQUAL((size_t)9, query2.size());
+    CPPUNIT_ASSERT(query2.contains(get_pkg("weak-0:1-1.x86_64", true)));
+}
+
+void RpmPackageQueryTest::test_filter_unneeded() {
+    repo_sack->get_system_repo()->add_libsolv_testcase(
+        PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-leaves-system.repo");
+
+    // every cached result is compared with a full recompute
+    ((*base.get_rpm_package_sack()).*get(sack_priv_impl()))->set_validate_unneeded_cache(true);
+
+    auto & state = (base.*get(priv_impl()))->get_system_state();
+    PackageQuery installed(base);
+    installed.filter_installed();
+    for (const auto & pkg : installed) {
+        state.set_package_reason(pkg.get_na(), libdnf5::transaction::TransactionItemReason::DEPENDENCY);
+    }
+    state.set_package_reason("app.x86_64", libdnf5::transaction::TransactionItemReason::USER);
+
+    // only the user installed package and its dependencies are needed
+    for (int i = 0; i < 2; ++i) {
+        PackageQuery query(base);
+        query.filter_unneeded();
+        CPPUNIT_ASSERT_EQUAL((size_t)10, query.size());
+        CPPUNIT_ASSERT(!query.contains(get_pkg("lib-0:1-1.x86_64", true)));
+        CPPUNIT_ASSERT(query.contains(get_pkg("cycle-b-0:1-1.x86_64", true)));
+    }
+
+    // a change of the reasons invalidates the cached result
+    state.set_package_reason("cycle-a.x86_64", libdnf5::transaction::TransactionItemReason::USER);
+    PackageQuery query(base);
+    query.filter_unneeded();
+    CPPUNIT_ASSERT_EQUAL((size_t)8, query.size());
+    CPPUNIT_ASSERT(!query.contains(get_pkg("cycle-b-0:1-1.x86_64", true)));
+}
+
+void RpmPackageQueryTest::test_dependency_closures() {
+    repo_sack->get_system_repo()->add_libsolv_testcase(
+        PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-leaves-system.repo");
+    PackageQuery all(base);
+
+    // the requires are followed transitively, through cycles and to all providers of a dependency
+    PackageQuery query1(base);
+    query1.filter_name({"app", "loop-user", "virt-user"});
+    query1.extend_by_requires_closure(all);
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.x86_64", true),
+        get_pkg("lib-0:1-1.x86_64", true),
+        get_pkg("base-0:1-1.x86_64", true),
+        get_pkg("loop-a-0:1-1.x86_64", true),
+        get_pkg("loop-b-0:1-1.x86_64", true),
+        get_pkg("loop-user-0:1-1.x86_64", true),
+        get_pkg("virt-user-0:1-1.x86_64", true),
+        get_pkg("virt-one-0:1-1.x86_64", true),
+        get_pkg("virt-two-0:1-1.x86_64", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // the packages requiring the query transitively
+    PackageQuery query2(base);
+    query2.filter_name({"base", "loop-a"});
+    query2.extend_by_required_by_closure(all);
+    expected = {
+        get_pkg("app-0:1-1.x86_64", true),
+        get_pkg("lib-0:1-1.x86_64", true),
+        get_pkg("base-0:1-1.x86_64", true),
+        get_pkg("loop-a-0:1-1.x86_64", true),
+        get_pkg("loop-b-0:1-1.x86_64", true),
+        get_pkg("loop-user-0:1-1.x86_64", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // only the candidates are added, the closure does not continue through other packages
+    PackageQuery candidates(base);
+    candidates.filter_name({"lib"}, libdnf5::sack::QueryCmp::NEQ);
+    PackageQuery query3(base);
+    query3.filter_name({"base"});
+    query3.extend_by_required_by_closure(candidates);
+    expected = {get_pkg("base-0:1-1.x86_64", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+}
+
 void RpmPackageQueryTest::test_filter_advisories() {
     add_repo_repomd("repomd-repo1");
 
@@ -665,6 +1039,141 @@ void RpmPackageQueryTest::test_filter_chain() {
 }
 
 
+void RpmPackageQueryTest::test_deferred_filters() {
+    add_repo_solv("solv-repo1");
+
+    PackageQuery query(base);
+    query.defer_filters();
+    query.filter_requires({"foo"}, libdnf5::sack::QueryCmp::NEQ);
+    query.filter_name({"pkg*"}, libdnf5::sack::QueryCmp::GLOB);
+    query.filter_arch({"x86_64"});
+
+    // filter_latest_evr() depends on the input packages, the recorded filters are applied before it
+    query.filter_latest_evr();
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+
+    // recording continues after it
+    query.filter_name({"pkg"});
+    query.apply_deferred_filters();
+    expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+
+    // the recording is stopped
+    query.filter_arch({"src"});
+    CPPUNIT_ASSERT_EQUAL((size_t)0, query.size());
+}
+
+
+void RpmPackageQueryTest::test_deferred_filters_implicit_apply() {
+    add_repo_solv("solv-repo1");
+
+    // iterating the query applies the recorded filters
+    PackageQuery query(base);
+    query.defer_filters();
+    query.filter_name({"pkg-libs"});
+    query.filter_arch({"x86_64"});
+    std::vector<Package> result;
+    for (const auto & pkg : query) {
+        result.push_back(pkg);
+    }
+    std::vector<Package> expected = {
+        get_pkg("pkg-libs-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.2-4.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, result);
+
+    // so do size() and empty()
+    query.filter_version({"1.3"});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    query.filter_arch({"src"});
+    CPPUNIT_ASSERT(query.empty());
+
+    // the set operations apply the filters recorded on the query
+    PackageQuery pkg_libs(base);
+    pkg_libs.filter_name({"pkg-libs"});
+    PackageQuery union_query(base);
+    union_query.defer_filters();
+    union_query.filter_arch({"src"});
+    union_query |= pkg_libs;
+    union_query.apply_deferred_filters();
+    expected = {
+        get_pkg("pkg-0:1.2-3.src"),
+        get_pkg("pkg-libs-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-1:1.2-4.x86_64"),
+        get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(union_query));
+
+    // a query with recorded filters cannot be used as a PackageSet
+    PackageQuery deferred(base);
+    deferred.defer_filters();
+    deferred.filter_arch({"src"});
+    CPPUNIT_ASSERT_THROW(pkg_libs |= deferred, libdnf5::AssertionError);
+    CPPUNIT_ASSERT_THROW(to_vector(deferred), libdnf5::AssertionError);
+}
+
+
+void RpmPackageQueryTest::test_query_cache() {
+    add_repo_solv("solv-repo1");
+    base.get_config().get_query_cache_option().set(true);
+    auto sack = base.get_rpm_package_sack();
+    std::vector<Package> expected = {
+        get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+
+    PackageQuery query1(base);
+    query1.filter_latest_evr();
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)0, sack->get_query_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, sack->get_query_cache_misses());
+
+    // the same filter applied to the same packages is taken from the cache
+    PackageQuery query2(base);
+    query2.filter_latest_evr();
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, sack->get_query_cache_hits());
+
+    // different arguments
+    PackageQuery query3(base);
+    query3.filter_latest_evr(2);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, query3.size());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, sack->get_query_cache_hits());
+
+    // different input packages
+    PackageQuery query4(base);
+    query4.filter_arch({"x86_64"});
+    query4.filter_latest_evr();
+    expected = {get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query4));
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, sack->get_query_cache_hits());
+
+    // changed excludes drop the cached results
+    PackageQuery query5(base, libdnf5::sack::ExcludeFlags::IGNORE_EXCLUDES);
+    query5.filter_latest_evr();
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)4, sack->get_query_cache_misses());
+    sack->add_user_excludes(query4);
+    PackageQuery query6(base, libdnf5::sack::ExcludeFlags::IGNORE_EXCLUDES);
+    query6.filter_latest_evr();
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)1, sack->get_query_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)5, sack->get_query_cache_misses());
+
+    // a change of the repo priorities is reflected
+    auto repo = repo_sack->create_repo_from_libsolv_testcase(
+        "repo1-copy", PROJECT_SOURCE_DIR "/test/data/repos-solv/solv-repo1.repo");
+    repo->set_priority(10);
+    PackageQuery query7(base);
+    query7.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)5, query7.size());
+    repo->set_priority(99);
+    PackageQuery query8(base);
+    query8.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)10, query8.size());
+    repo->set_priority(10);
+    PackageQuery query9(base);
+    query9.filter_priority();
+    CPPUNIT_ASSERT_EQUAL((size_t)5, query9.size());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)2, sack->get_query_cache_hits());
+    CPPUNIT_ASSERT_EQUAL((std::uint64_t)7, sack->get_query_cache_misses());
+}
+
+
 void RpmPackageQueryTest::test_resolve_pkg_spec() {
     add_repo_solv("solv-repo1");
 
@@ -742,6 +1251,64 @@ void RpmPackageQueryTest::test_resolve_pkg_spec() {
 }
 
 
+void RpmPackageQueryTest::test_resolve_pkg_specs() {
+    add_repo_solv("solv-repo1");
+
+    // The name globs without a matching name, like "*4", can still match the full NEVRA
+    std::vector<std::string> specs{
+        "pkg",
+        "Pkg",
+        "pkg-libs",
+        "pkg.x86_64",
+        "libpkg.so.0()(64bit)",
+        "pkg",
+        "unknown",
+        "/etc/pkg.conf",
+        "pkg*",
+        "*libs",
+        "p?g",
+        "P*",
+        "*4",
+        "unknown*"};
+
+    for (bool ignore_case : {false, true}) {
+        for (bool with_src : {false, true}) {
+            libdnf5::ResolveSpecSettings settings{.ignore_case = ignore_case};
+            PackageQuery query(base);
+            std::vector<PackageQuery> queries;
+            auto return_values = query.resolve_pkg_specs(specs, settings, with_src, queries);
+            CPPUNIT_ASSERT_EQUAL(specs.size(), return_values.size());
+            CPPUNIT_ASSERT_EQUAL(specs.size(), queries.size());
+            // The query itself is not modified
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), query.size());
+
+            // The results are the same as the results of resolving the specs one by one
+            for (std::size_t idx = 0; idx < specs.size(); ++idx) {
+                PackageQuery expected_query(base);
+                auto expected_value = expected_query.resolve_pkg_spec(specs[idx], settings, with_src);
+                CPPUNIT_ASSERT_EQUAL(expected_value.first, return_values[idx].first);
+                CPPUNIT_ASSERT_EQUAL(expected_value.second.has_just_name(), return_values[idx].second.has_just_name());
+                CPPUNIT_ASSERT_EQUAL(expected_value.second.get_name(), return_values[idx].second.get_name());
+                CPPUNIT_ASSERT_EQUAL(to_vector(expected_query), to_vector(queries[idx]));
+            }
+        }
+    }
+
+    {
+        // Plain name without the source package
+        PackageQuery query(base);
+        std::vector<PackageQuery> queries;
+        auto return_values = query.resolve_pkg_specs({"pkg", "Pkg"}, libdnf5::ResolveSpecSettings{}, false, queries);
+        CPPUNIT_ASSERT_EQUAL(true, return_values[0].first);
+        CPPUNIT_ASSERT_EQUAL(std::string("pkg"), return_values[0].second.get_name());
+        std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(queries[0]));
+        CPPUNIT_ASSERT_EQUAL(false, return_values[1].first);
+        CPPUNIT_ASSERT(queries[1].empty());
+    }
+}
+
+
 void RpmPackageQueryTest::test_update() {
     add_repo_solv("solv-repo1");
 
@@ -830,3 +1397,53 @@ void RpmPackageQueryTest::test_filter_provides_performance() {
         query.filter_provides({"prv-all"});
     }
 }
+
+
+void RpmPackageQueryTest::test_filter_upgrades_performance() {
+    // 3000 installed packages, 20 available versions of each of them
+    std::ofstream system_repo(temp->get_path() / "system.repo");
+    std::ofstream available_repo(temp->get_path() / "available.repo");
+    system_repo << "=Ver: 3.0\n";
+    available_repo << "=Ver: 3.0\n";
+    for (int name = 0; name < 3000; ++name) {
+        system_repo << fmt::format("=Pkg: pkg{} 10 1 x86_64\n", name);
+        for (int version = 0; version < 20; ++version) {
+            available_repo << fmt::format("=Pkg: pkg{} {} 1 x86_64\n", name, version);
+        }
+    }
+    system_repo.close();
+    available_repo.close();
+    repo_sack->get_system_repo()->add_libsolv_testcase((temp->get_path() / "system.repo").native());
+    repo_sack->create_repo_from_libsolv_testcase("available", (temp->get_path() / "available.repo").native());
+
+    for (int i = 0; i < 100; ++i) {
+        PackageQuery upgrades(base);
+        upgrades.filter_upgrades();
+        PackageQuery downgrades(base);
+        downgrades.filter_downgrades();
+        PackageQuery upgradable(base);
+        upgradable.filter_upgradable();
+        PackageQuery downgradable(base);
+        downgradable.filter_downgradable();
+    }
+}
+
+
+void RpmPackageQueryTest::test_filter_leaves_performance() {
+    // 5000 installed packages requiring two other packages each, some of them form cycles
+    std::ofstream system_repo(temp->get_path() / "system.repo");
+    system_repo << "=Ver: 3.0\n";
+    for (int idx = 0; idx < 5000; ++idx) {
+        system_repo << fmt::format("=Pkg: pkg{} 1 1 x86_64\n=Prv: pkg{} = 1-1\n", idx, idx);
+        if (idx > 0) {
+            system_repo << fmt::format("=Req: pkg{}\n=Req: pkg{}\n", idx / 2, (idx * 7919) % 5000);
+        }
+    }
+    system_repo.close();
+    repo_sack->get_system_repo()->add_libsolv_testcase((temp->get_path() / "system.repo").native());
+
+    for (int i = 0; i < 20; ++i) {
+        PackageQuery query(base);
+        query.filter_leaves();
+    }
+}
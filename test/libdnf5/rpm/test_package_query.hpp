@@ -45,10 +45,23 @@ class RpmPackageQueryTest : public BaseTestCase {
     CPPUNIT_TEST(test_filter_release);
     CPPUNIT_TEST(test_filter_priority);
     CPPUNIT_TEST(test_filter_provides);
+    CPPUNIT_TEST(test_is_provided);
     CPPUNIT_TEST(test_filter_requires);
+    CPPUNIT_TEST(test_filter_requires_package_set);
+    CPPUNIT_TEST(test_filter_summary_text_index);
+    CPPUNIT_TEST(test_filter_file_index);
+    CPPUNIT_TEST(test_filter_sourcerpm);
+    CPPUNIT_TEST(test_filter_upgrades_downgrades);
+    CPPUNIT_TEST(test_filter_leaves);
+    CPPUNIT_TEST(test_filter_unneeded);
+    CPPUNIT_TEST(test_dependency_closures);
     CPPUNIT_TEST(test_filter_advisories);
     CPPUNIT_TEST(test_filter_chain);
+    CPPUNIT_TEST(test_deferred_filters);
+    CPPUNIT_TEST(test_deferred_filters_implicit_apply);
+    CPPUNIT_TEST(test_query_cache);
     CPPUNIT_TEST(test_resolve_pkg_spec);
+    CPPUNIT_TEST(test_resolve_pkg_specs);
     CPPUNIT_TEST(test_update);
     CPPUNIT_TEST(test_intersection);
     CPPUNIT_TEST(test_difference);
@@ -57,6 +70,8 @@ class RpmPackageQueryTest : public BaseTestCase {
 #ifdef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_filter_latest_evr_performance);
     CPPUNIT_TEST(test_filter_provides_performance);
+    CPPUNIT_TEST(test_filter_upgrades_performance);
+    CPPUNIT_TEST(test_filter_leaves_performance);
 #endif
 
     CPPUNIT_TEST_SUITE_END();
@@ -77,23 +92,32 @@ public:
     void test_filter_version();
     void test_filter_release();
     void test_filter_provides();
+    void test_is_provided();
     void test_filter_priority();
     void test_filter_requires();
+    void test_filter_requires_package_set();
+    void test_filter_summary_text_index();
+    void test_filter_file_index();
+    void test_filter_sourcerpm();
+    void test_filter_upgrades_downgrades();
+    void test_filter_leaves();
+    void test_filter_unneeded();
+    void test_dependency_closures();
     void test_filter_advisories();
     void test_filter_chain();
+    void test_deferred_filters();
+    void test_deferred_filters_implicit_apply();
+    void test_query_cache();
     void test_resolve_pkg_spec();
+    void test_resolve_pkg_specs();
     void test_update();
     void test_intersection();
     void test_difference();
 
     void test_filter_latest_evr_performance();
     void test_filter_provides_performance();
-
-    // TODO(jmracek) Add tests when system repo will be available
-    // PackageQuery & filter_upgrades();
-    // PackageQuery & filter_downgrades();
-    // PackageQuery & filter_upgradable();
-    // PackageQuery & filter_downgradable();
+    void test_filter_upgrades_performance();
+    void test_filter_leaves_performance();
 };
 
 
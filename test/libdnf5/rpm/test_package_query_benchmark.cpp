@@ -0,0 +1,360 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test_package_query_benchmark.hpp"
+
+#include "../shared/benchmark.hpp"
+#include "synthetic_repo.hpp"
+
+#include <fmt/format.h>
+#include <libdnf5/advisory/advisory_query.hpp>
+#include <libdnf5/rpm/package_query.hpp>
+#include <libdnf5/rpm/package_set.hpp>
+
+#include <chrono>
+#include <memory>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmPackageQueryBenchmark);
+
+using namespace libdnf5::rpm;
+
+namespace {
+
+const SyntheticRepoOptions REPO_OPTIONS;
+
+/// Every INSTALLED_STEP-th package name has its first version installed
+constexpr std::size_t INSTALLED_STEP = 10;
+
+/// Returns the directory with the synthetic repository, the repository is generated once per process
+const std::filesystem::path & get_synthetic_repo_dir() {
+    static std::unique_ptr<libdnf5::utils::fs::TempDir> repo_dir;
+    if (!repo_dir) {
+        repo_dir = std::make_unique<libdnf5::utils::fs::TempDir>("libdnf5_benchmark");
+        write_synthetic_repomd(repo_dir->get_path() / "synthetic", REPO_OPTIONS);
+        write_synthetic_system_repo(repo_dir->get_path() / "system.repo", REPO_OPTIONS, INSTALLED_STEP);
+    }
+    return repo_dir->get_path();
+}
+
+}  // namespace
+
+
+void RpmPackageQueryBenchmark::setUp() {
+    BaseTestCase::setUp();
+    // Generate the repository before the first measurement
+    get_synthetic_repo_dir();
+}
+
+
+void RpmPackageQueryBenchmark::load_repos() {
+    const auto & repo_dir = get_synthetic_repo_dir();
+    repo_sack->get_system_repo()->add_libsolv_testcase((repo_dir / "system.repo").native());
+    add_repo("synthetic", (repo_dir / "synthetic").native());
+}
+
+
+void RpmPackageQueryBenchmark::benchmark(
+    const std::string & name, std::size_t iterations, const std::function<std::size_t()> & fn) {
+    std::size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        sink += fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    report_benchmark(
+        "PackageQuery/" + name,
+        iterations,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+        {{"items", static_cast<double>(sink / iterations)}});
+}
+
+
+void RpmPackageQueryBenchmark::test_load() {
+    benchmark("load", 1, [this]() {
+        load_repos();
+        return PackageQuery(base).size();
+    });
+    CPPUNIT_ASSERT_EQUAL(
+        REPO_OPTIONS.names * REPO_OPTIONS.versions + REPO_OPTIONS.names / INSTALLED_STEP, PackageQuery(base).size());
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_name() {
+    load_repos();
+
+    benchmark("filter_name", 1000, [this]() {
+        PackageQuery query(base);
+        query.filter_name({"synth12345"});
+        return query.size();
+    });
+    benchmark("filter_name_many", 100, [this]() {
+        std::vector<std::string> names;
+        for (std::size_t name = 0; name < REPO_OPTIONS.names; name += 100) {
+            names.push_back(fmt::format("synth{}", name));
+        }
+        PackageQuery query(base);
+        query.filter_name(names);
+        return query.size();
+    });
+    benchmark("filter_name_glob", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_name({"synth12*"}, libdnf5::sack::QueryCmp::GLOB);
+        return query.size();
+    });
+    benchmark("filter_name_icontains", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_name({"TH123"}, libdnf5::sack::QueryCmp::ICONTAINS);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_nevra() {
+    load_repos();
+
+    benchmark("filter_nevra", 1000, [this]() {
+        PackageQuery query(base);
+        query.filter_nevra({"synth12345-2.0-1.fc40.x86_64"});
+        return query.size();
+    });
+    benchmark("filter_nevra_glob", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_nevra({"synth1234*-2.0-1.fc40.*"}, libdnf5::sack::QueryCmp::GLOB);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_evr() {
+    load_repos();
+
+    benchmark("filter_evr_gt", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_evr({"2.0-1.fc40"}, libdnf5::sack::QueryCmp::GT);
+        return query.size();
+    });
+    benchmark("filter_version", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_version({"3.0"});
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_arch_repo() {
+    load_repos();
+
+    benchmark("filter_arch", 100, [this]() {
+        PackageQuery query(base);
+        query.filter_arch({"noarch"});
+        return query.size();
+    });
+    benchmark("filter_repo_id", 100, [this]() {
+        PackageQuery query(base);
+        query.filter_repo_id({"synthetic"});
+        return query.size();
+    });
+    benchmark("filter_installed", 100, [this]() {
+        PackageQuery query(base);
+        query.filter_installed();
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_provides() {
+    load_repos();
+
+    benchmark("filter_provides", 1000, [this]() {
+        PackageQuery query(base);
+        query.filter_provides({"synth777-cap3"});
+        return query.size();
+    });
+    benchmark("filter_provides_glob", 10, [this]() {
+        PackageQuery query(base);
+        query.filter_provides({"libsynth12*"}, libdnf5::sack::QueryCmp::GLOB);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_requires() {
+    load_repos();
+
+    benchmark("filter_requires", 100, [this]() {
+        PackageQuery query(base);
+        query.filter_requires({"synth777-cap0"});
+        return query.size();
+    });
+    benchmark("filter_requires_package_set", 10, [this]() {
+        PackageQuery providers(base);
+        providers.filter_name({"synth7*"}, libdnf5::sack::QueryCmp::GLOB);
+        PackageQuery query(base);
+        query.filter_requires(providers);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_file() {
+    load_repos();
+
+    benchmark("filter_file", 100, [this]() {
+        PackageQuery query(base);
+        query.filter_file({"/usr/share/synth777/file3"});
+        return query.size();
+    });
+    benchmark("filter_file_glob", 5, [this]() {
+        PackageQuery query(base);
+        query.filter_file({"/usr/bin/synth77*"}, libdnf5::sack::QueryCmp::GLOB);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_summary() {
+    load_repos();
+
+    benchmark("filter_summary_icontains", 10, [this]() {
+        PackageQuery query(base);
+        query.filter_summary({"PACKAGE SYNTH777"}, libdnf5::sack::QueryCmp::ICONTAINS);
+        return query.size();
+    });
+    benchmark("filter_description_contains", 10, [this]() {
+        PackageQuery query(base);
+        query.filter_description({"synth777 version"}, libdnf5::sack::QueryCmp::CONTAINS);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_advisories() {
+    load_repos();
+
+    benchmark("filter_advisories_security", 10, [this]() {
+        libdnf5::advisory::AdvisoryQuery advisories(base);
+        advisories.filter_type("security");
+        PackageQuery query(base);
+        query.filter_advisories(advisories, libdnf5::sack::QueryCmp::GTE);
+        return query.size();
+    });
+    benchmark("filter_advisories_upgrades", 10, [this]() {
+        libdnf5::advisory::AdvisoryQuery advisories(base);
+        PackageQuery query(base);
+        query.filter_upgrades();
+        query.filter_advisories(advisories, libdnf5::sack::QueryCmp::EQ);
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_latest_evr() {
+    load_repos();
+
+    benchmark("filter_latest_evr", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_latest_evr();
+        return query.size();
+    });
+    benchmark("filter_earliest_evr", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_earliest_evr();
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_filter_upgrades() {
+    load_repos();
+
+    benchmark("filter_upgrades", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_upgrades();
+        return query.size();
+    });
+    benchmark("filter_upgradable", 20, [this]() {
+        PackageQuery query(base);
+        query.filter_upgradable();
+        return query.size();
+    });
+    benchmark("filter_leaves", 5, [this]() {
+        PackageQuery query(base);
+        query.filter_leaves();
+        return query.size();
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_resolve_pkg_spec() {
+    load_repos();
+
+    libdnf5::ResolveSpecSettings settings;
+    benchmark("resolve_pkg_spec_name", 100, [this, &settings]() {
+        PackageQuery query(base);
+        return query.resolve_pkg_spec("synth12345", settings, false).first ? query.size() : 0;
+    });
+    benchmark("resolve_pkg_spec_nevra", 100, [this, &settings]() {
+        PackageQuery query(base);
+        return query.resolve_pkg_spec("synth12345-2.0-1.fc40.x86_64", settings, false).first ? query.size() : 0;
+    });
+    benchmark("resolve_pkg_spec_provide", 100, [this, &settings]() {
+        PackageQuery query(base);
+        return query.resolve_pkg_spec("libsynth12345.so.2()(64bit)", settings, false).first ? query.size() : 0;
+    });
+    benchmark("resolve_pkg_spec_file", 100, [this, &settings]() {
+        PackageQuery query(base);
+        return query.resolve_pkg_spec("/usr/bin/synth12345", settings, false).first ? query.size() : 0;
+    });
+
+    libdnf5::ResolveSpecSettings nocase_settings;
+    nocase_settings.ignore_case = true;
+    benchmark("resolve_pkg_spec_glob_nocase", 10, [this, &nocase_settings]() {
+        PackageQuery query(base);
+        return query.resolve_pkg_spec("SYNTH1234?", nocase_settings, false).first ? query.size() : 0;
+    });
+}
+
+
+void RpmPackageQueryBenchmark::test_package_set_algebra() {
+    load_repos();
+
+    PackageQuery noarch(base);
+    noarch.filter_arch({"noarch"});
+    PackageQuery latest(base);
+    latest.filter_latest_evr();
+    PackageQuery installed(base);
+    installed.filter_installed();
+
+    benchmark("package_set_union", 1000, [&]() {
+        PackageSet set(noarch);
+        set |= latest;
+        return set.size();
+    });
+    benchmark("package_set_intersection", 1000, [&]() {
+        PackageSet set(latest);
+        set &= noarch;
+        return set.size();
+    });
+    benchmark("package_set_difference", 1000, [&]() {
+        PackageSet set(latest);
+        set -= installed;
+        return set.size();
+    });
+}
@@ -0,0 +1,86 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_RPM_PACKAGE_QUERY_BENCHMARK_HPP
+#define TEST_LIBDNF5_RPM_PACKAGE_QUERY_BENCHMARK_HPP
+
+
+#include "../shared/base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+
+/// Benchmarks of PackageQuery filters on a synthetic repository with 100000 packages, see synthetic_repo.hpp.
+/// The results are reported by report_benchmark().
+class RpmPackageQueryBenchmark : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmPackageQueryBenchmark);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_load);
+    CPPUNIT_TEST(test_filter_name);
+    CPPUNIT_TEST(test_filter_nevra);
+    CPPUNIT_TEST(test_filter_evr);
+    CPPUNIT_TEST(test_filter_arch_repo);
+    CPPUNIT_TEST(test_filter_provides);
+    CPPUNIT_TEST(test_filter_requires);
+    CPPUNIT_TEST(test_filter_file);
+    CPPUNIT_TEST(test_filter_summary);
+    CPPUNIT_TEST(test_filter_advisories);
+    CPPUNIT_TEST(test_filter_latest_evr);
+    CPPUNIT_TEST(test_filter_upgrades);
+    CPPUNIT_TEST(test_resolve_pkg_spec);
+    CPPUNIT_TEST(test_package_set_algebra);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    void test_load();
+    void test_filter_name();
+    void test_filter_nevra();
+    void test_filter_evr();
+    void test_filter_arch_repo();
+    void test_filter_provides();
+    void test_filter_requires();
+    void test_filter_file();
+    void test_filter_summary();
+    void test_filter_advisories();
+    void test_filter_latest_evr();
+    void test_filter_upgrades();
+    void test_resolve_pkg_spec();
+    void test_package_set_algebra();
+
+private:
+    /// Loads the synthetic repository and the system repository with every 10th package name installed
+    void load_repos();
+
+    /// Runs `fn` `iterations` times and reports the mean time of one run under `name`.
+    /// The results of `fn` are summed so that the evaluation of the queries cannot be skipped.
+    void benchmark(const std::string & name, std::size_t iterations, const std::function<std::size_t()> & fn);
+};
+
+
+#endif  // TEST_LIBDNF5_RPM_PACKAGE_QUERY_BENCHMARK_HPP
@@ -20,13 +20,19 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_package_sack.hpp"
 
+#include "../shared/private_accessor.hpp"
 #include "../shared/utils.hpp"
+#include "rpm/package_sack_impl.hpp"
+#include "solv/pool.hpp"
 
+#include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/rpm/package_sack.hpp>
 #include <libdnf5/rpm/package_set.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <set>
+#include <tuple>
 #include <vector>
 
 
@@ -36,12 +42,25 @@ using namespace libdnf5::rpm;
 
 namespace {
 
+// Accessor of private PackageSack::p_impl, see private_accessor.hpp
+create_private_getter_template;
+create_getter(priv_impl, &libdnf5::rpm::PackageSack::p_impl);
+
 // make constructor public so we can create Package instances in the tests
 class TestPackage : public Package {
 public:
     TestPackage(libdnf5::Base & base, PackageId id) : libdnf5::rpm::Package(base.get_weak_ptr(), id) {}
 };
 
+// the sort keys of the solvables, solvables with identical keys can be sorted in any order
+std::vector<std::tuple<Id, Id, Id>> to_keys(const std::vector<Solvable *> & solvables) {
+    std::vector<std::tuple<Id, Id, Id>> keys;
+    for (const auto * solvable : solvables) {
+        keys.emplace_back(solvable->name, solvable->arch, solvable->evr);
+    }
+    return keys;
+}
+
 }  // namespace
 
 
@@ -123,3 +142,105 @@ void RpmPackageSackTest::test_remove_user_includes() {
     sack->remove_user_includes(*pkgset);
     CPPUNIT_ASSERT(sack->get_user_includes().contains(*pkg0) == false);
 }
+
+
+void RpmPackageSackTest::test_considered_delta_updates() {
+    auto & sack_impl = *((*sack).*get(priv_impl()));
+    std::vector<Package> packages;
+    for (const auto & pkg : PackageQuery(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES)) {
+        packages.push_back(pkg);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)24, packages.size());
+    auto make_set = [&](size_t begin, size_t end) {
+        PackageSet set(base);
+        for (auto idx = begin; idx < end; ++idx) {
+            set.add(packages[idx]);
+        }
+        return set;
+    };
+
+    // the queries use the cached maps updated by the deltas, they must match a full recompute
+    auto check = [&]() {
+        for (auto flags :
+             {PackageQuery::ExcludeFlags::APPLY_EXCLUDES,
+              PackageQuery::ExcludeFlags::IGNORE_MODULAR_EXCLUDES,
+              PackageQuery::ExcludeFlags::IGNORE_REGULAR_USER_EXCLUDES,
+              PackageQuery::ExcludeFlags::IGNORE_EXCLUDES}) {
+            std::set<PackageId> result;
+            for (const auto & pkg : PackageQuery(base, flags)) {
+                result.insert(pkg.get_id());
+            }
+            std::set<PackageId> expected;
+            auto considered = sack_impl.compute_considered_map(flags);
+            for (const auto & pkg : packages) {
+                if (!considered || considered->contains(pkg.get_id().id)) {
+                    expected.insert(pkg.get_id());
+                }
+            }
+            CPPUNIT_ASSERT(expected == result);
+        }
+    };
+
+    sack->set_user_excludes(make_set(0, 5));
+    check();
+    sack->add_user_excludes(make_set(5, 8));
+    check();
+    sack->remove_user_excludes(make_set(3, 6));
+    check();
+
+    sack_impl.set_module_excludes(make_set(10, 12));
+    check();
+    sack_impl.add_module_excludes(make_set(0, 2));
+    check();
+    sack_impl.remove_module_excludes(make_set(0, 1));
+    check();
+
+    sack->set_user_includes(make_set(0, 16));
+    check();
+    sack->remove_user_includes(make_set(0, 4));
+    check();
+    sack->add_user_includes(make_set(20, 22));
+    check();
+    sack->remove_user_excludes(make_set(0, 24));
+    check();
+}
+
+void RpmPackageSackTest::test_sorted_solvables_incremental() {
+    auto & sack_impl = *((*sack).*get(priv_impl()));
+    auto & pool = libdnf5::get_rpm_pool(base.get_weak_ptr());
+
+    CPPUNIT_ASSERT_EQUAL((size_t)24, sack_impl.get_sorted_solvables().size());
+    CPPUNIT_ASSERT_EQUAL((size_t)24, sack_impl.get_sorted_icase_solvables().size());
+    auto generation = sack_impl.get_sorted_solvables_generation();
+
+    // the new solvables are merged into the indices, the result equals a full sort
+    add_repo_solv("solv-repo1");
+    add_repo_solv("solv-humongous");
+    auto & sorted = sack_impl.get_sorted_solvables();
+    CPPUNIT_ASSERT(generation != sack_impl.get_sorted_solvables_generation());
+    CPPUNIT_ASSERT_EQUAL(sack_impl.get_solvables().size(), sorted.size());
+
+    std::vector<Solvable *> expected;
+    for (Id id : sack_impl.get_solvables()) {
+        expected.push_back(pool.id2solvable(id));
+    }
+    std::sort(expected.begin(), expected.end(), nevra_solvable_cmp_key);
+    CPPUNIT_ASSERT(to_keys(expected) == to_keys(sorted));
+
+    std::set<Solvable *> expected_set(expected.begin(), expected.end());
+    CPPUNIT_ASSERT(expected_set == std::set<Solvable *>(sorted.begin(), sorted.end()));
+
+    auto & sorted_icase = sack_impl.get_sorted_icase_solvables();
+    CPPUNIT_ASSERT_EQUAL(sorted.size(), sorted_icase.size());
+    CPPUNIT_ASSERT(std::is_sorted(sorted_icase.begin(), sorted_icase.end(), nevra_solvable_cmp_icase_key));
+    std::set<Solvable *> icase_set;
+    for (const auto & [icase_name, solvable] : sorted_icase) {
+        CPPUNIT_ASSERT_EQUAL(pool.id_to_lowercase_id(solvable->name, false), icase_name);
+        icase_set.insert(solvable);
+    }
+    CPPUNIT_ASSERT(expected_set == icase_set);
+
+    // unchanged pool keeps the generation
+    generation = sack_impl.get_sorted_solvables_generation();
+    CPPUNIT_ASSERT_EQUAL(generation, sack_impl.get_sorted_solvables_generation());
+}
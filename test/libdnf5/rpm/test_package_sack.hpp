@@ -39,6 +39,9 @@ class RpmPackageSackTest : public BaseTestCase {
     CPPUNIT_TEST(test_add_user_includes);
     CPPUNIT_TEST(test_remove_user_includes);
 
+    CPPUNIT_TEST(test_considered_delta_updates);
+    CPPUNIT_TEST(test_sorted_solvables_incremental);
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -52,6 +55,9 @@ public:
     void test_add_user_includes();
     void test_remove_user_includes();
 
+    void test_considered_delta_updates();
+    void test_sorted_solvables_incremental();
+
 private:
     std::unique_ptr<libdnf5::rpm::PackageSet> pkgset;
     std::unique_ptr<libdnf5::rpm::Package> pkg0;
@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_package_set.hpp"
 
 #include <libdnf5/rpm/package.hpp>
+#include <libdnf5/rpm/reldep_list.hpp>
 
 #include <filesystem>
 #include <vector>
@@ -213,3 +214,59 @@ void RpmPackageSetTest::test_iterator() {
         CPPUNIT_ASSERT(result == expected);
     }
 }
+
+
+void RpmPackageSetTest::test_get_columns() {
+    using libdnf5::rpm::PackageAttribute;
+    auto columns = set1->get_columns(
+        {PackageAttribute::NAME,
+         PackageAttribute::EPOCH,
+         PackageAttribute::RELEASE,
+         PackageAttribute::REPO_ID,
+         PackageAttribute::SUMMARY,
+         PackageAttribute::INSTALL_SIZE,
+         PackageAttribute::PROVIDES,
+         PackageAttribute::REQUIRES});
+
+    CPPUNIT_ASSERT_EQUAL(set1->size(), columns.size());
+    auto & names = columns.get_strings(PackageAttribute::NAME);
+    auto & epochs = columns.get_strings(PackageAttribute::EPOCH);
+    auto & releases = columns.get_strings(PackageAttribute::RELEASE);
+    auto & repo_ids = columns.get_strings(PackageAttribute::REPO_ID);
+    auto & summaries = columns.get_strings(PackageAttribute::SUMMARY);
+    auto & install_sizes = columns.get_numbers(PackageAttribute::INSTALL_SIZE);
+    auto & provides = columns.get_reldeps(PackageAttribute::PROVIDES);
+    auto & provides_offsets = columns.get_reldep_offsets(PackageAttribute::PROVIDES);
+    auto & requires_offsets = columns.get_reldep_offsets(PackageAttribute::REQUIRES);
+    CPPUNIT_ASSERT_EQUAL(columns.size() + 1, provides_offsets.size());
+    CPPUNIT_ASSERT_EQUAL(provides.size(), provides_offsets.back());
+
+    // the rows are ordered as the iteration and have the values of the package getters
+    std::size_t row = 0;
+    for (const auto & pkg : *set1) {
+        CPPUNIT_ASSERT_EQUAL(pkg.get_id().id, columns.get_ids()[row].id);
+        CPPUNIT_ASSERT_EQUAL(pkg.get_name(), std::string(names[row]));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_epoch(), std::string(epochs[row]));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_release(), std::string(releases[row]));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_repo_id(), std::string(repo_ids[row]));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_summary(), std::string(summaries[row]));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_install_size(), install_sizes[row]);
+
+        auto pkg_provides = pkg.get_provides();
+        CPPUNIT_ASSERT_EQUAL(
+            static_cast<std::size_t>(pkg_provides.size()), provides_offsets[row + 1] - provides_offsets[row]);
+        for (int idx = 0; idx < pkg_provides.size(); ++idx) {
+            CPPUNIT_ASSERT_EQUAL(
+                pkg_provides.get_id(idx).id, provides[provides_offsets[row] + static_cast<std::size_t>(idx)].id);
+        }
+        CPPUNIT_ASSERT_EQUAL(
+            static_cast<std::size_t>(pkg.get_requires().size()), requires_offsets[row + 1] - requires_offsets[row]);
+        ++row;
+    }
+    CPPUNIT_ASSERT_EQUAL(columns.size(), row);
+
+    // attributes that were not extracted or are of a different kind
+    CPPUNIT_ASSERT_THROW(columns.get_strings(PackageAttribute::ARCH), libdnf5::UserAssertionError);
+    CPPUNIT_ASSERT_THROW(columns.get_strings(PackageAttribute::INSTALL_SIZE), libdnf5::UserAssertionError);
+    CPPUNIT_ASSERT_THROW(columns.get_numbers(PackageAttribute::PROVIDES), libdnf5::UserAssertionError);
+}
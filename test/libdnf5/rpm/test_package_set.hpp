@@ -41,6 +41,7 @@ class RpmPackageSetTest : public BaseTestCase {
     CPPUNIT_TEST(test_intersection);
     CPPUNIT_TEST(test_difference);
     CPPUNIT_TEST(test_iterator);
+    CPPUNIT_TEST(test_get_columns);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -61,6 +62,8 @@ public:
 
     void test_iterator();
 
+    void test_get_columns();
+
 
 private:
     std::unique_ptr<libdnf5::rpm::PackageSet> set1;
@@ -0,0 +1,131 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "test_package_text_index.hpp"
+
+#include "rpm/package_text_index.hpp"
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <libdnf5/rpm/package_query.hpp>
+
+extern "C" {
+#include <solv/knownid.h>
+}
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmPackageTextIndexTest);
+
+using namespace libdnf5::rpm;
+
+namespace {
+
+libdnf5::solv::SolvMap to_solv_map(libdnf5::Base & base, const std::vector<Package> & packages) {
+    libdnf5::solv::SolvMap result(libdnf5::get_rpm_pool(base.get_weak_ptr()).get_nsolvables());
+    for (const auto & pkg : packages) {
+        result.add(pkg.get_id().id);
+    }
+    return result;
+}
+
+libdnf5::solv::SolvMap all_packages(libdnf5::Base & base) {
+    PackageQuery query(base);
+    return to_solv_map(base, std::vector<Package>(query.begin(), query.end()));
+}
+
+}  // namespace
+
+
+void RpmPackageTextIndexTest::setUp() {
+    BaseTestCase::setUp();
+    // all packages in the repository have "Summary" summary and "Description" description
+    add_repo_repomd("repomd-repo1");
+}
+
+
+void RpmPackageTextIndexTest::test_shortlist_substring() {
+    auto packages = all_packages(base);
+    PackageTextIndex index(libdnf5::get_rpm_pool(base.get_weak_ptr()), SOLVABLE_SUMMARY, packages);
+
+    // the index is case-insensitive
+    auto shortlisted = index.shortlist("MMAR", false, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, shortlisted->size());
+
+    shortlisted = index.shortlist("unknown", false, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, shortlisted->size());
+}
+
+
+void RpmPackageTextIndexTest::test_shortlist_glob() {
+    auto packages = all_packages(base);
+    PackageTextIndex index(libdnf5::get_rpm_pool(base.get_weak_ptr()), SOLVABLE_DESCRIPTION, packages);
+
+    // literal parts of the glob provide the trigrams
+    auto shortlisted = index.shortlist("desc*ion", true, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, shortlisted->size());
+
+    shortlisted = index.shortlist("*des[abc]ription*", true, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, shortlisted->size());
+
+    shortlisted = index.shortlist("*unk?own*", true, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, shortlisted->size());
+
+    // without the glob flag the wildcards are a part of the substring
+    shortlisted = index.shortlist("desc*ion", false, packages);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, shortlisted->size());
+
+    // no literal part is long enough to provide a trigram
+    CPPUNIT_ASSERT(!index.shortlist("de*sc?ri", true, packages));
+
+    // an unterminated bracket expression is not understood
+    CPPUNIT_ASSERT(!index.shortlist("description[", true, packages));
+}
+
+
+void RpmPackageTextIndexTest::test_shortlist_short_pattern() {
+    auto packages = all_packages(base);
+    PackageTextIndex index(libdnf5::get_rpm_pool(base.get_weak_ptr()), SOLVABLE_DESCRIPTION, packages);
+
+    // patterns shorter than a trigram have to be matched against all candidates
+    CPPUNIT_ASSERT(!index.shortlist("", false, packages));
+    CPPUNIT_ASSERT(!index.shortlist("es", false, packages));
+    CPPUNIT_ASSERT(!index.shortlist("xy", false, packages));
+    CPPUNIT_ASSERT(!index.shortlist("*es*", true, packages));
+}
+
+
+void RpmPackageTextIndexTest::test_shortlist_candidates() {
+    auto packages = all_packages(base);
+    PackageTextIndex index(libdnf5::get_rpm_pool(base.get_weak_ptr()), SOLVABLE_SUMMARY, packages);
+
+    // only the candidates are shortlisted
+    auto candidates = to_solv_map(base, {get_pkg("pkg-0:1.2-3.x86_64")});
+    auto shortlisted = index.shortlist("summary", false, candidates);
+    CPPUNIT_ASSERT(shortlisted);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, shortlisted->size());
+    CPPUNIT_ASSERT(shortlisted->contains(get_pkg("pkg-0:1.2-3.x86_64").get_id().id));
+}
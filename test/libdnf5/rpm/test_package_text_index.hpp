@@ -0,0 +1,53 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef TEST_LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
+#define TEST_LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
+
+
+#include "../shared/base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RpmPackageTextIndexTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmPackageTextIndexTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_shortlist_substring);
+    CPPUNIT_TEST(test_shortlist_glob);
+    CPPUNIT_TEST(test_shortlist_short_pattern);
+    CPPUNIT_TEST(test_shortlist_candidates);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    void test_shortlist_substring();
+    void test_shortlist_glob();
+    void test_shortlist_short_pattern();
+    void test_shortlist_candidates();
+};
+
+
+#endif  // TEST_LIBDNF5_RPM_PACKAGE_TEXT_INDEX_HPP
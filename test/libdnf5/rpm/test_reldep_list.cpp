@@ -188,3 +188,28 @@ void ReldepListTest::test_add_reldep_with_glob() {
     };
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(list));
 }
+
+
+void ReldepListTest::test_add_reldeps() {
+    add_repo_solv("solv-repo1");
+
+    libdnf5::rpm::ReldepList list(base);
+    CPPUNIT_ASSERT(list.add_reldeps({"pkg-libs", "pkg.conf*", "pkg >= 1.0"}, true));
+    const std::vector<Reldep> expected = {
+        Reldep(base, "pkg-libs"),
+        Reldep(base, "pkg.conf"),
+        Reldep(base, "pkg.conf.d"),
+        Reldep(base, "pkg >= 1.0"),
+    };
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(list));
+
+    // the repeated strings are taken from the cache, the result is the same
+    libdnf5::rpm::ReldepList cached_list(base);
+    CPPUNIT_ASSERT(cached_list.add_reldeps({"pkg-libs", "pkg.conf*", "pkg >= 1.0"}, true));
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(cached_list));
+
+    // without the glob expansion, the globs are added as plain dependencies
+    libdnf5::rpm::ReldepList plain_list(base);
+    CPPUNIT_ASSERT(plain_list.add_reldeps({"pkg.conf*"}));
+    CPPUNIT_ASSERT_EQUAL(std::vector<Reldep>{Reldep(base, "pkg.conf*")}, to_vector(plain_list));
+}
@@ -37,6 +37,7 @@ class ReldepListTest : public BaseTestCase {
     CPPUNIT_TEST(test_append);
     CPPUNIT_TEST(test_iterator);
     CPPUNIT_TEST(test_add_reldep_with_glob);
+    CPPUNIT_TEST(test_add_reldeps);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +48,7 @@ public:
     void test_append();
     void test_iterator();
     void test_add_reldep_with_glob();
+    void test_add_reldeps();
 };
 
 #endif  // TEST_LIBDNF5_RPM_RELDEP_LIST_HPP
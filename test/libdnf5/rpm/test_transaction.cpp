@@ -142,3 +142,65 @@ void RpmTransactionTest::test_transaction_temp_files_cleanup() {
     transaction.run();
     CPPUNIT_ASSERT(!std::filesystem::exists(package_path));
 }
+
+void RpmTransactionTest::test_transaction_preflight_check_pass_rpm_check_fail() {
+    // The rpmlib() requirement of the package is missing in the repository metadata the preflight check uses,
+    // only the check of the transaction run with the package headers finds it.
+    add_repo_rpm("rpm-rpmlib");
+    base.get_config().get_preflight_check_option().set(true);
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("needs-rpmlib");
+
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf5::GoalProblem::NO_PROBLEM, transaction.get_problems());
+
+    transaction.download();
+
+    transaction.set_callbacks(std::make_unique<libdnf5::rpm::TransactionCallbacks>());
+    auto res = transaction.run();
+
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::ERROR_CHECK, res);
+    auto problems = transaction.get_transaction_problems();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, problems.size());
+    CPPUNIT_ASSERT(problems[0].find("rpmlib(Dnf5TestNonexistentFeature)") != std::string::npos);
+}
+
+void RpmTransactionTest::test_transaction_test_then_run() {
+    add_repo_rpm("rpm-repo1");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("one");
+
+    auto transaction = goal.resolve();
+    transaction.download();
+
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, transaction.test());
+    // the result of the test run is reused by a copy of the transaction as well
+    auto copy = transaction;
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, copy.test());
+
+    transaction.set_callbacks(std::make_unique<libdnf5::rpm::TransactionCallbacks>());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::SUCCESS, transaction.run());
+    CPPUNIT_ASSERT(transaction.get_transaction_problems().empty());
+
+    // the rpm database changed, the copy checks the transaction again and finds the package installed
+    copy.set_callbacks(std::make_unique<libdnf5::rpm::TransactionCallbacks>());
+    CPPUNIT_ASSERT(copy.run() != libdnf5::base::Transaction::TransactionRunResult::SUCCESS);
+    CPPUNIT_ASSERT(!copy.get_transaction_problems().empty());
+}
+
+void RpmTransactionTest::test_transaction_test_check_fail_then_run() {
+    add_repo_rpm("rpm-rpmlib");
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("needs-rpmlib");
+
+    auto transaction = goal.resolve();
+    transaction.download();
+
+    // a failed check is not reused, the run checks the transaction again
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::ERROR_CHECK, transaction.test());
+    transaction.set_callbacks(std::make_unique<libdnf5::rpm::TransactionCallbacks>());
+    CPPUNIT_ASSERT_EQUAL(libdnf5::base::Transaction::TransactionRunResult::ERROR_CHECK, transaction.run());
+}
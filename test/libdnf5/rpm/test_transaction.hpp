@@ -31,11 +31,17 @@ class RpmTransactionTest : public BaseTestCase {
     CPPUNIT_TEST_SUITE(RpmTransactionTest);
     CPPUNIT_TEST(test_transaction);
     CPPUNIT_TEST(test_transaction_temp_files_cleanup);
+    CPPUNIT_TEST(test_transaction_preflight_check_pass_rpm_check_fail);
+    CPPUNIT_TEST(test_transaction_test_then_run);
+    CPPUNIT_TEST(test_transaction_test_check_fail_then_run);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_transaction();
     void test_transaction_temp_files_cleanup();
+    void test_transaction_preflight_check_pass_rpm_check_fail();
+    void test_transaction_test_then_run();
+    void test_transaction_test_check_fail_then_run();
 };
 
 #endif
@@ -0,0 +1,103 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_concurrent_filter.hpp"
+
+#include "../shared/utils.hpp"
+#include "solv/concurrent_filter.hpp"
+
+#include <cstddef>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConcurrentFilterTest);
+
+
+namespace {
+
+/// Returns a map of `size` Ids with every third Id set
+libdnf5::solv::SolvMap make_candidates(int size) {
+    libdnf5::solv::SolvMap candidates(size);
+    for (Id id = 0; id < size; id += 3) {
+        candidates.add(id);
+    }
+    return candidates;
+}
+
+std::vector<Id> to_vector(const libdnf5::solv::SolvMap & map) {
+    return std::vector<Id>(map.begin(), map.end());
+}
+
+}  // namespace
+
+
+void ConcurrentFilterTest::test_filter_small_map() {
+    // The map is smaller than CONCURRENT_FILTER_MIN_IDS, it is filtered by the calling thread
+    auto candidates = make_candidates(100);
+    libdnf5::solv::SolvMap result(100);
+    libdnf5::solv::filter_concurrently(candidates, result, 4, [](Id id) { return id % 5 == 0; });
+
+    std::vector<Id> expected;
+    for (Id id = 0; id < 100; id += 15) {
+        expected.push_back(id);
+    }
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(result));
+}
+
+
+void ConcurrentFilterTest::test_filter_concurrently() {
+    // The size is not a multiple of the chunk size, the last chunk is shorter
+    constexpr int size = 100003;
+    auto candidates = make_candidates(size);
+    auto match = [](Id id) { return id % 5 == 0; };
+
+    libdnf5::solv::SolvMap sequential_result(size);
+    libdnf5::solv::filter_concurrently(candidates, sequential_result, 1, match);
+
+    for (std::size_t max_workers : {2, 4, 16, 1000}) {
+        libdnf5::solv::SolvMap result(size);
+        // Already present Ids are kept
+        result.add(1);
+        libdnf5::solv::filter_concurrently(candidates, result, max_workers, match);
+        CPPUNIT_ASSERT(result.contains(1));
+        result.remove(1);
+        CPPUNIT_ASSERT_EQUAL(to_vector(sequential_result), to_vector(result));
+    }
+
+    std::vector<Id> expected;
+    for (Id id = 0; id < size; id += 15) {
+        expected.push_back(id);
+    }
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(sequential_result));
+}
+
+
+void ConcurrentFilterTest::test_filter_worker_state() {
+    // Each worker uses its own copy of the match function, its state is not shared
+    constexpr int size = 50000;
+    auto candidates = make_candidates(size);
+    libdnf5::solv::SolvMap result(size);
+    libdnf5::solv::filter_concurrently(candidates, result, 8, [last_id = Id(-1)](Id id) mutable {
+        // Ids are passed to each worker in ascending order
+        bool ascending = id > last_id;
+        last_id = id;
+        return ascending;
+    });
+    CPPUNIT_ASSERT_EQUAL(to_vector(candidates), to_vector(result));
+}
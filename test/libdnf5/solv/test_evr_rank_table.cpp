@@ -0,0 +1,160 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "test_evr_rank_table.hpp"
+
+#include "solv/evr_rank_table.hpp"
+
+extern "C" {
+#include <solv/evr.h>
+}
+
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EvrRankTableTest);
+
+using libdnf5::solv::EvrRankTable;
+
+
+namespace {
+
+int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+}  // namespace
+
+
+void EvrRankTableTest::setUp() {
+    pool = pool_create();
+    repo = repo_create(pool, "repo");
+}
+
+
+void EvrRankTableTest::tearDown() {
+    pool_free(pool);
+}
+
+
+Id EvrRankTableTest::add_solvable(const char * evr) {
+    Solvable * solvable = pool_id2solvable(pool, repo_add_solvable(repo));
+    solvable->name = pool_str2id(pool, "pkg", 1);
+    solvable->evr = pool_str2id(pool, evr, 1);
+    return solvable->evr;
+}
+
+
+void EvrRankTableTest::test_compare() {
+    std::vector<Id> evrs;
+    for (const char * evr : {"1.2-3", "1:0.1-1", "1.10-1", "1.9-1", "1.01-1", "1.1-1", "1.2~rc1-1", "1.2^git-1"}) {
+        evrs.push_back(add_solvable(evr));
+    }
+
+    EvrRankTable evr_ranks(pool, EvrRankTable::Part::EVR);
+    evr_ranks.update();
+    CPPUNIT_ASSERT_EQUAL(pool->nsolvables, evr_ranks.get_nsolvables());
+
+    for (Id evr1 : evrs) {
+        CPPUNIT_ASSERT(evr_ranks.get_rank(evr1) != EvrRankTable::UNKNOWN_RANK);
+        for (Id evr2 : evrs) {
+            CPPUNIT_ASSERT_EQUAL(
+                sign(pool_evrcmp(pool, evr1, evr2, EVRCMP_COMPARE)), sign(evr_ranks.compare(evr1, evr2)));
+        }
+    }
+
+    // "1.01" and "1.1" compare as equal, they share the rank
+    CPPUNIT_ASSERT_EQUAL(evr_ranks.get_rank(evrs[4]), evr_ranks.get_rank(evrs[5]));
+    CPPUNIT_ASSERT_EQUAL(0, evr_ranks.compare(evrs[4], evrs[5]));
+}
+
+
+void EvrRankTableTest::test_key_rank() {
+    std::vector<Id> evrs;
+    for (const char * evr : {"1.0-1", "2.0-1", "3.0-1"}) {
+        evrs.push_back(add_solvable(evr));
+    }
+
+    EvrRankTable evr_ranks(pool, EvrRankTable::Part::EVR);
+    evr_ranks.update();
+
+    // the key is in the table
+    auto rank = evr_ranks.get_rank("2.0-1");
+    CPPUNIT_ASSERT_EQUAL(evr_ranks.get_rank(evrs[1]), rank);
+    CPPUNIT_ASSERT_EQUAL(0, evr_ranks.compare(evrs[1], "2.0-1", rank));
+
+    // the key is between the ranked EVRs
+    for (const char * key : {"0.5-1", "1.5-1", "2.00-1", "2.5-1", "4-1"}) {
+        rank = evr_ranks.get_rank(key);
+        for (Id evr : evrs) {
+            CPPUNIT_ASSERT_EQUAL(
+                sign(pool_evrcmp_str(pool, pool_id2str(pool, evr), key, EVRCMP_COMPARE)),
+                sign(evr_ranks.compare(evr, key, rank)));
+        }
+    }
+}
+
+
+void EvrRankTableTest::test_outdated_table() {
+    Id evr1 = add_solvable("1.0-1");
+    EvrRankTable evr_ranks(pool, EvrRankTable::Part::EVR);
+
+    // an empty table compares the strings
+    Id evr2 = add_solvable("2.0-1");
+    CPPUNIT_ASSERT_EQUAL(EvrRankTable::UNKNOWN_RANK, evr_ranks.get_rank(evr1));
+    CPPUNIT_ASSERT_EQUAL(-1, sign(evr_ranks.compare(evr1, evr2)));
+
+    evr_ranks.update();
+    Id evr3 = add_solvable("1.5-1");
+    CPPUNIT_ASSERT(evr_ranks.get_nsolvables() != pool->nsolvables);
+
+    // the EVR added after the update is not ranked, it is still compared correctly
+    CPPUNIT_ASSERT_EQUAL(EvrRankTable::UNKNOWN_RANK, evr_ranks.get_rank(evr3));
+    CPPUNIT_ASSERT_EQUAL(1, sign(evr_ranks.compare(evr3, evr1)));
+    CPPUNIT_ASSERT_EQUAL(-1, sign(evr_ranks.compare(evr3, evr2)));
+    CPPUNIT_ASSERT_EQUAL(1, sign(evr_ranks.compare(evr3, "1.2-1", evr_ranks.get_rank("1.2-1"))));
+
+    evr_ranks.update();
+    CPPUNIT_ASSERT(evr_ranks.get_rank(evr3) != EvrRankTable::UNKNOWN_RANK);
+    CPPUNIT_ASSERT_EQUAL(1, sign(evr_ranks.compare(evr3, evr1)));
+}
+
+
+void EvrRankTableTest::test_version_release() {
+    Id evr1 = add_solvable("2:1.0-3");
+    Id evr2 = add_solvable("1.0-10");
+    Id evr3 = add_solvable("0.9-3.fc40");
+
+    EvrRankTable version_ranks(pool, EvrRankTable::Part::VERSION);
+    version_ranks.update();
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0-0"), version_ranks.get_key(evr1));
+    // the epoch is not a part of the version
+    CPPUNIT_ASSERT_EQUAL(0, version_ranks.compare(evr1, evr2));
+    CPPUNIT_ASSERT_EQUAL(1, sign(version_ranks.compare(evr1, evr3)));
+    CPPUNIT_ASSERT_EQUAL(0, version_ranks.compare(evr3, "0.9-0", version_ranks.get_rank("0.9-0")));
+
+    EvrRankTable release_ranks(pool, EvrRankTable::Part::RELEASE);
+    release_ranks.update();
+    CPPUNIT_ASSERT_EQUAL(std::string("0-3"), release_ranks.get_key(evr1));
+    CPPUNIT_ASSERT_EQUAL(std::string("0-3.fc40"), release_ranks.get_key(evr3));
+    CPPUNIT_ASSERT_EQUAL(-1, sign(release_ranks.compare(evr1, evr2)));
+    CPPUNIT_ASSERT_EQUAL(-1, sign(release_ranks.compare(evr1, evr3)));
+    CPPUNIT_ASSERT_EQUAL(1, sign(release_ranks.compare(evr2, "0-4", release_ranks.get_rank("0-4"))));
+}
@@ -0,0 +1,63 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_SOLV_EVR_RANK_TABLE_HPP
+#define LIBDNF5_TEST_SOLV_EVR_RANK_TABLE_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+extern "C" {
+#include <solv/pool.h>
+#include <solv/repo.h>
+}
+
+
+class EvrRankTableTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(EvrRankTableTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_compare);
+    CPPUNIT_TEST(test_key_rank);
+    CPPUNIT_TEST(test_outdated_table);
+    CPPUNIT_TEST(test_version_release);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_compare();
+    void test_key_rank();
+    void test_outdated_table();
+    void test_version_release();
+
+private:
+    /// Adds a solvable with the `evr` to the repo, returns the EVR Id
+    Id add_solvable(const char * evr);
+
+    ::Pool * pool{nullptr};
+    ::Repo * repo{nullptr};
+};
+
+#endif  // LIBDNF5_TEST_SOLV_EVR_RANK_TABLE_HPP
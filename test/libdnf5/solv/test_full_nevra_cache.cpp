@@ -0,0 +1,94 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_full_nevra_cache.hpp"
+
+#include "solv/full_nevra_cache.hpp"
+
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FullNevraCacheTest);
+
+using libdnf5::solv::FullNevraCache;
+
+
+void FullNevraCacheTest::setUp() {
+    pool = pool_create();
+    repo = repo_create(pool, "repo");
+}
+
+
+void FullNevraCacheTest::tearDown() {
+    pool_free(pool);
+}
+
+
+Id FullNevraCacheTest::add_solvable(const char * name, const char * evr, const char * arch) {
+    Id id = repo_add_solvable(repo);
+    Solvable * solvable = pool_id2solvable(pool, id);
+    solvable->name = pool_str2id(pool, name, 1);
+    solvable->evr = pool_str2id(pool, evr, 1);
+    solvable->arch = pool_str2id(pool, arch, 1);
+    return id;
+}
+
+
+void FullNevraCacheTest::test_get() {
+    Id no_epoch = add_solvable("pkg", "1.2-3", "x86_64");
+    Id epoch = add_solvable("pkg-libs", "2:1.2-3", "noarch");
+    Id no_evr = add_solvable("gpg-pubkey", "", "");
+
+    FullNevraCache cache(pool);
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-0:1.2-3.x86_64"), std::string(cache.get(no_epoch)));
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-libs-2:1.2-3.noarch"), std::string(cache.get(epoch)));
+    CPPUNIT_ASSERT_EQUAL(std::string("gpg-pubkey"), std::string(cache.get(no_evr)));
+    CPPUNIT_ASSERT_EQUAL(std::size_t{3}, cache.get_formatted_count());
+
+    // repeated requests return the interned strings
+    auto view = cache.get(no_epoch);
+    for (Id id = 0; id < 1000; ++id) {
+        add_solvable("other", "1-1", "noarch");
+    }
+    CPPUNIT_ASSERT(view.data() == cache.get(no_epoch).data());
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-libs-2:1.2-3.noarch"), std::string(cache.get(epoch)));
+    CPPUNIT_ASSERT_EQUAL(std::size_t{3}, cache.get_formatted_count());
+
+    // the strings of the newly added solvables
+    CPPUNIT_ASSERT_EQUAL(std::string("other-0:1-1.noarch"), std::string(cache.get(pool->nsolvables - 1)));
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-0:1.2-3.x86_64"), std::string(view));
+}
+
+
+void FullNevraCacheTest::test_reused_id() {
+    Id id = add_solvable("pkg", "1.2-3", "x86_64");
+
+    FullNevraCache cache(pool);
+    auto old_view = cache.get(id);
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-0:1.2-3.x86_64"), std::string(old_view));
+
+    // the solvable is freed and its Id is reused for another package
+    repo_free_solvable(repo, id, 1);
+    CPPUNIT_ASSERT_EQUAL(id, add_solvable("pkg", "1:1.2-4", "x86_64"));
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-1:1.2-4.x86_64"), std::string(cache.get(id)));
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, cache.get_formatted_count());
+
+    // a view returned before stays valid
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-0:1.2-3.x86_64"), std::string(old_view));
+}
@@ -0,0 +1,58 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF5_TEST_SOLV_FULL_NEVRA_CACHE_HPP
+#define LIBDNF5_TEST_SOLV_FULL_NEVRA_CACHE_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+extern "C" {
+#include <solv/pool.h>
+#include <solv/repo.h>
+}
+
+
+class FullNevraCacheTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(FullNevraCacheTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_get);
+    CPPUNIT_TEST(test_reused_id);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_get();
+    void test_reused_id();
+
+private:
+    /// Adds a solvable to the repo, returns its Id
+    Id add_solvable(const char * name, const char * evr, const char * arch);
+
+    ::Pool * pool{nullptr};
+    ::Repo * repo{nullptr};
+};
+
+#endif  // LIBDNF5_TEST_SOLV_FULL_NEVRA_CACHE_HPP
@@ -21,6 +21,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_solv_map.hpp"
 
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SolvMapTest);
@@ -249,6 +251,263 @@ void SolvMapTest::test_iterator_sparse() {
 }
 
 
+void SolvMapTest::test_iterator_word_boundaries() {
+    // items at the edges of bytes and 64-bit words, followed by an incomplete word at the end of the map
+    std::vector<Id> expected = {0, 7, 8, 63, 64, 127, 128, 200, 255, 256, 300, 331};
+
+    libdnf5::solv::SolvMap map(332);
+    for (auto it : expected) {
+        map.add(it);
+    }
+
+    std::vector<Id> result(map.begin(), map.end());
+    CPPUNIT_ASSERT(result == expected);
+
+    // jump to the empty space between the items
+    auto it = map.begin();
+    it.jump(9);
+    CPPUNIT_ASSERT_EQUAL(*it, 63);
+    it.jump(129);
+    CPPUNIT_ASSERT_EQUAL(*it, 200);
+    it.jump(301);
+    CPPUNIT_ASSERT_EQUAL(*it, 331);
+    ++it;
+    CPPUNIT_ASSERT(it == map.end());
+    ++it;
+    CPPUNIT_ASSERT(it == map.end());
+}
+
+
+void SolvMapTest::test_size() {
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), map1->size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), map2->size());
+
+    // the size of the map is not a multiple of the word size
+    libdnf5::solv::SolvMap map(1001);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), map.size());
+    CPPUNIT_ASSERT(map.empty());
+    map.add(1000);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), map.size());
+    CPPUNIT_ASSERT(!map.empty());
+    map.set_all();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(map.allocated_size()), map.size());
+}
+
+
+void SolvMapTest::test_operations_different_sizes() {
+    libdnf5::solv::SolvMap large(1000);
+    large.set_all();
+    libdnf5::solv::SolvMap small(64);
+    small.add(3);
+    small.add(40);
+
+    // intersection clears the items beyond the smaller map
+    libdnf5::solv::SolvMap intersection(large);
+    intersection &= small;
+    CPPUNIT_ASSERT((std::vector<Id>(intersection.begin(), intersection.end()) == std::vector<Id>{3, 40}));
+
+    // difference keeps the items beyond the smaller map
+    libdnf5::solv::SolvMap difference(large);
+    difference -= small;
+    CPPUNIT_ASSERT_EQUAL(large.size() - 2, difference.size());
+    CPPUNIT_ASSERT(!difference.contains(3));
+    CPPUNIT_ASSERT(difference.contains(999));
+
+    // union grows the smaller map
+    libdnf5::solv::SolvMap union_map(small);
+    union_map |= large;
+    CPPUNIT_ASSERT_EQUAL(large.allocated_size(), union_map.allocated_size());
+    CPPUNIT_ASSERT_EQUAL(large.size(), union_map.size());
+}
+
+
+void SolvMapTest::test_sparse_representation() {
+    constexpr int max = 10000;
+    constexpr auto max_sparse = static_cast<Id>(libdnf5::solv::SolvMap::SPARSE_MAX_ITEMS);
+
+    // a new map does not allocate the bitmap
+    libdnf5::solv::SolvMap map(max);
+    CPPUNIT_ASSERT(map.is_sparse());
+    CPPUNIT_ASSERT_EQUAL(8 * ((max + 7) / 8), map.allocated_size());
+    CPPUNIT_ASSERT(map.begin() == map.end());
+
+    // the items added in descending order are kept sorted
+    std::vector<Id> expected;
+    for (Id id = max_sparse - 1; id >= 0; --id) {
+        map.add(id * 7);
+        expected.insert(expected.begin(), id * 7);
+    }
+    map.add(7);
+    CPPUNIT_ASSERT(map.is_sparse());
+    CPPUNIT_ASSERT_EQUAL(expected.size(), map.size());
+    CPPUNIT_ASSERT(std::vector<Id>(map.begin(), map.end()) == expected);
+    CPPUNIT_ASSERT(map.contains(14));
+    CPPUNIT_ASSERT(!map.contains(15));
+    auto it = map.begin();
+    it.jump(15);
+    CPPUNIT_ASSERT_EQUAL(21, *it);
+
+    // the map is converted to the bitmap when it grows over the limit
+    libdnf5::solv::SolvMap copy(map);
+    copy.add(max - 1);
+    expected.push_back(max - 1);
+    CPPUNIT_ASSERT(!copy.is_sparse());
+    CPPUNIT_ASSERT(map.is_sparse());
+    CPPUNIT_ASSERT(std::vector<Id>(copy.begin(), copy.end()) == expected);
+
+    // the intersection with a small set is stored in the sorted vector
+    libdnf5::solv::SolvMap small(max);
+    small.add(14);
+    small.add(15);
+    copy &= small;
+    CPPUNIT_ASSERT(copy.is_sparse());
+    CPPUNIT_ASSERT((std::vector<Id>(copy.begin(), copy.end()) == std::vector<Id>{14}));
+
+    // the operations give the same results in both representations
+    libdnf5::solv::SolvMap dense(max);
+    dense.set_all();
+    dense -= small;
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(dense.allocated_size() - 2), dense.size());
+    small |= dense;
+    CPPUNIT_ASSERT(!small.is_sparse());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(small.allocated_size()), small.size());
+    map -= dense;
+    CPPUNIT_ASSERT(map.is_sparse());
+    CPPUNIT_ASSERT((std::vector<Id>(map.begin(), map.end()) == std::vector<Id>{14}));
+
+    // requesting the libsolv Map converts the map to the bitmap
+    const auto & solv_map = map.get_map();
+    CPPUNIT_ASSERT(!map.is_sparse());
+    CPPUNIT_ASSERT(MAPTST(&solv_map, 14));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), map.size());
+
+    // removal of the visited items during the iteration
+    libdnf5::solv::SolvMap removed(max);
+    removed.add(1);
+    removed.add(2);
+    removed.add(3);
+    std::vector<Id> visited;
+    for (auto id : removed) {
+        visited.push_back(id);
+        removed.remove(id);
+    }
+    CPPUNIT_ASSERT((visited == std::vector<Id>{1, 2, 3}));
+    CPPUNIT_ASSERT(removed.empty());
+}
+
+
+void SolvMapTest::test_ranges() {
+    constexpr int max = 1000;
+
+    // compares the map with the expected items checked one by one
+    auto assert_items = [](const libdnf5::solv::SolvMap & map, auto is_expected) {
+        std::vector<Id> expected;
+        for (Id id = 0; id < map.allocated_size(); ++id) {
+            if (is_expected(id)) {
+                expected.push_back(id);
+            }
+        }
+        CPPUNIT_ASSERT(std::vector<Id>(map.begin(), map.end()) == expected);
+    };
+
+    // a small range is kept in the sorted vector
+    libdnf5::solv::SolvMap map(max);
+    map.add(2);
+    map.add_range_unsafe(5, 20);
+    map.add_range_unsafe(7, 7);
+    CPPUNIT_ASSERT(map.is_sparse());
+    assert_items(map, [](Id id) { return id == 2 || (id >= 5 && id < 20); });
+    map.remove_range_unsafe(3, 10);
+    CPPUNIT_ASSERT(map.is_sparse());
+    assert_items(map, [](Id id) { return id == 2 || (id >= 10 && id < 20); });
+
+    // a big range converts the map to the bitmap, the ranges within a single byte and the ranges ending
+    // at the byte boundaries are handled
+    map.add_range_unsafe(100, 900);
+    map.add_range_unsafe(1, 2);
+    map.add_range_unsafe(41, 44);
+    map.add_range_unsafe(56, 64);
+    CPPUNIT_ASSERT(!map.is_sparse());
+    auto is_added = [](Id id) {
+        return (id >= 1 && id <= 2) || (id >= 10 && id < 20) || (id >= 41 && id < 44) || (id >= 56 && id < 64) ||
+               (id >= 100 && id < 900);
+    };
+    assert_items(map, is_added);
+
+    map.remove_range_unsafe(13, 15);
+    map.remove_range_unsafe(101, 899);
+    map.remove_range_unsafe(56, 64);
+    map.remove_range_unsafe(500, 500);
+    assert_items(map, [&is_added](Id id) {
+        return is_added(id) && !(id >= 13 && id < 15) && !(id >= 101 && id < 899) && !(id >= 56 && id < 64);
+    });
+
+    // the whole map
+    map.add_range_unsafe(0, map.allocated_size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(map.allocated_size()), map.size());
+    map.remove_range_unsafe(0, map.allocated_size());
+    CPPUNIT_ASSERT(map.empty());
+}
+
+
+void SolvMapTest::test_copy_on_write() {
+    constexpr int max = 1000;
+    auto stats = libdnf5::solv::get_solv_map_copy_stats();
+
+    libdnf5::solv::SolvMap map(max);
+    map.add_range_unsafe(0, 500);
+
+    // the copies share the bitmap
+    libdnf5::solv::SolvMap copy(map);
+    libdnf5::solv::SolvMap assigned(max);
+    assigned = map;
+    CPPUNIT_ASSERT(!copy.is_sparse());
+    CPPUNIT_ASSERT(map.get_map().map == copy.get_map().map);
+    CPPUNIT_ASSERT(map.get_map().map == assigned.get_map().map);
+    CPPUNIT_ASSERT_EQUAL(stats.shared + 2, libdnf5::solv::get_solv_map_copy_stats().shared);
+
+    // the operations with a copy sharing the bitmap do not copy it
+    copy |= map;
+    copy &= map;
+    CPPUNIT_ASSERT(map.get_map().map == copy.get_map().map);
+    CPPUNIT_ASSERT_EQUAL(stats.copied_on_write, libdnf5::solv::get_solv_map_copy_stats().copied_on_write);
+
+    // a modified copy gets its own bitmap, the other maps are not changed
+    copy.remove(10);
+    copy.add(600);
+    CPPUNIT_ASSERT(map.get_map().map != copy.get_map().map);
+    CPPUNIT_ASSERT_EQUAL(stats.copied_on_write + 1, libdnf5::solv::get_solv_map_copy_stats().copied_on_write);
+    CPPUNIT_ASSERT(map.contains(10));
+    CPPUNIT_ASSERT(!map.contains(600));
+    CPPUNIT_ASSERT(!copy.contains(10));
+    CPPUNIT_ASSERT(copy.contains(600));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(500), assigned.size());
+
+    // the last map sharing the bitmap modifies it in place
+    map.remove(20);
+    CPPUNIT_ASSERT_EQUAL(stats.copied_on_write + 2, libdnf5::solv::get_solv_map_copy_stats().copied_on_write);
+    const auto * bitmap = assigned.get_map().map;
+    assigned.remove(30);
+    CPPUNIT_ASSERT(bitmap == assigned.get_map().map);
+    CPPUNIT_ASSERT_EQUAL(stats.copied_on_write + 2, libdnf5::solv::get_solv_map_copy_stats().copied_on_write);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(499), map.size());
+    CPPUNIT_ASSERT(map.contains(30));
+
+    // the difference with a copy sharing the bitmap is empty
+    libdnf5::solv::SolvMap difference(map);
+    difference -= map;
+    CPPUNIT_ASSERT(difference.empty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(499), map.size());
+
+    // the bitmap that can be modified directly is not shared
+    auto & writable_map = map.get_writable_map();
+    libdnf5::solv::SolvMap writable_copy(map);
+    MAPCLR(&writable_map, 40);
+    CPPUNIT_ASSERT(writable_copy.contains(40));
+    CPPUNIT_ASSERT(!map.contains(40));
+}
+
+
 void SolvMapTest::test_iterator_performance_empty() {
     // initialize a map filed with zeros
     constexpr int max = 1000000;
@@ -291,3 +550,52 @@ void SolvMapTest::test_iterator_performance_4bits() {
         }
     }
 }
+
+
+// Set operations on pool-sized maps with the libsolv functions for comparison with the SolvMap operators
+void SolvMapTest::test_set_operations_performance_libsolv() {
+    constexpr int max = 200000;
+    Map map;
+    Map other;
+    map_init(&map, max);
+    map_init(&other, max);
+    memset(other.map, 0x5a, static_cast<std::size_t>(other.size));
+
+    for (int i = 0; i < 20000; ++i) {
+        map_setall(&map);
+        map_and(&map, &other);
+        map_or(&map, &other);
+        map_subtract(&map, &other);
+    }
+
+    map_free(&map);
+    map_free(&other);
+}
+
+
+void SolvMapTest::test_set_operations_performance() {
+    constexpr int max = 200000;
+    libdnf5::solv::SolvMap map(max);
+    libdnf5::solv::SolvMap other(max);
+    memset(other.get_map().map, 0x5a, static_cast<std::size_t>(other.get_map().size));
+
+    for (int i = 0; i < 20000; ++i) {
+        map.set_all();
+        map &= other;
+        map |= other;
+        map -= other;
+    }
+}
+
+
+void SolvMapTest::test_size_performance() {
+    constexpr int max = 200000;
+    libdnf5::solv::SolvMap map(max);
+    memset(map.get_map().map, 0x5a, static_cast<std::size_t>(map.get_map().size));
+
+    std::size_t size = 0;
+    for (int i = 0; i < 20000; ++i) {
+        size += map.size();
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(20000) * (max / 2), size);
+}
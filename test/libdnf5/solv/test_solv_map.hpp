@@ -42,12 +42,21 @@ class SolvMapTest : public CppUnit::TestCase {
     CPPUNIT_TEST(test_iterator_empty);
     CPPUNIT_TEST(test_iterator_full);
     CPPUNIT_TEST(test_iterator_sparse);
+    CPPUNIT_TEST(test_iterator_word_boundaries);
+    CPPUNIT_TEST(test_size);
+    CPPUNIT_TEST(test_operations_different_sizes);
+    CPPUNIT_TEST(test_sparse_representation);
+    CPPUNIT_TEST(test_ranges);
+    CPPUNIT_TEST(test_copy_on_write);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_iterator_performance_empty);
     CPPUNIT_TEST(test_iterator_performance_full);
     CPPUNIT_TEST(test_iterator_performance_4bits);
+    CPPUNIT_TEST(test_set_operations_performance_libsolv);
+    CPPUNIT_TEST(test_set_operations_performance);
+    CPPUNIT_TEST(test_size_performance);
 #endif
 
     CPPUNIT_TEST_SUITE_END();
@@ -69,11 +78,22 @@ public:
     void test_iterator_empty();
     void test_iterator_full();
     void test_iterator_sparse();
+    void test_iterator_word_boundaries();
+
+    void test_size();
+    void test_operations_different_sizes();
+    void test_sparse_representation();
+    void test_ranges();
+    void test_copy_on_write();
 
     void test_iterator_performance_empty();
     void test_iterator_performance_full();
     void test_iterator_performance_4bits();
 
+    void test_set_operations_performance_libsolv();
+    void test_set_operations_performance();
+    void test_size_performance();
+
 private:
     libdnf5::solv::SolvMap * map1;
     libdnf5::solv::SolvMap * map2;
@@ -0,0 +1,185 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_whatprovides.hpp"
+
+#include "solv/id_queue.hpp"
+#include "solv/whatprovides.hpp"
+
+extern "C" {
+#include <solv/poolarch.h>
+#include <solv/repodata.h>
+}
+
+#include <algorithm>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WhatprovidesTest);
+
+using libdnf5::solv::extend_whatprovides;
+
+
+namespace {
+
+void add_solvable(
+    ::Repo * repo,
+    const char * name,
+    const char * arch,
+    const std::vector<const char *> & provides,
+    const std::vector<const char *> & requires_,
+    const std::vector<std::string> & files) {
+    ::Pool * pool = repo->pool;
+    Id id = repo_add_solvable(repo);
+    Solvable * solvable = pool_id2solvable(pool, id);
+    solvable->name = pool_str2id(pool, name, 1);
+    solvable->evr = pool_str2id(pool, "1.0-1", 1);
+    solvable->arch = pool_str2id(pool, arch, 1);
+    solvable->dep_provides = repo_addid_dep(
+        repo, solvable->dep_provides, pool_rel2id(pool, solvable->name, solvable->evr, REL_EQ, 1), 0);
+    for (auto * provide : provides) {
+        solvable->dep_provides = repo_addid_dep(repo, solvable->dep_provides, pool_str2id(pool, provide, 1), 0);
+    }
+    for (auto * require : requires_) {
+        solvable->dep_requires = repo_addid_dep(repo, solvable->dep_requires, pool_str2id(pool, require, 1), 0);
+    }
+    Repodata * data = repo_last_repodata(repo);
+    for (const auto & file : files) {
+        auto slash = file.rfind('/');
+        Id dir_id = repodata_str2dir(data, file.substr(0, slash).c_str(), 1);
+        repodata_add_dirstr(data, id, SOLVABLE_FILELIST, dir_id, file.substr(slash + 1).c_str());
+    }
+}
+
+}  // namespace
+
+
+::Pool * WhatprovidesTest::create_pool() {
+    ::Pool * pool = pool_create();
+    pool_setarch(pool, "x86_64");
+    ::Repo * repo = repo_create(pool, "base");
+    repo_add_repodata(repo, 0);
+    add_solvable(repo, "a", "noarch", {"/usr/bin/y", "liba"}, {}, {});
+    add_solvable(repo, "b", "x86_64", {}, {"/usr/bin/y", "liba"}, {});
+    add_solvable(repo, "c", "noarch", {}, {"/usr/bin/x"}, {"/usr/bin/z"});
+    add_solvable(repo, "d", "noarch", {}, {}, {"/usr/bin/x", "/etc/d.conf"});
+    add_solvable(repo, "e", "src", {"libe"}, {}, {"/usr/bin/x"});
+    repodata_internalize(repo_last_repodata(repo));
+    return pool;
+}
+
+
+void WhatprovidesTest::add_new_packages(::Pool * pool, const char * require) {
+    // `repo_create()` frees the whatprovides index, the repository is created before the index
+    ::Repo * repo = pool->repos[pool->nrepos - 1];
+    if (std::string(repo->name) != "@commandline") {
+        repo = repo_create(pool, "@commandline");
+    }
+    repo_add_repodata(repo, 0);
+    add_solvable(repo, "n1", "noarch", {"liba", "newcap"}, {"/usr/bin/y", "a"}, {"/usr/bin/x", "/usr/bin/n1"});
+    add_solvable(repo, "n2", "ppc64", {"newcap2"}, {}, {"/usr/bin/x"});
+    add_solvable(repo, "a", "x86_64", {"libe"}, {require}, {});
+    repodata_internalize(repo_last_repodata(repo));
+}
+
+
+std::vector<Id> WhatprovidesTest::add_file_provides(::Pool * pool) {
+    libdnf5::solv::IdQueue file_deps;
+    libdnf5::solv::IdQueue file_deps_installed;
+    pool_addfileprovides_queue(pool, &file_deps.get_queue(), &file_deps_installed.get_queue());
+    std::vector<Id> result(file_deps.begin(), file_deps.end());
+    result.insert(result.end(), file_deps_installed.begin(), file_deps_installed.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+std::vector<std::set<Id>> WhatprovidesTest::dump_provides(::Pool * pool) {
+    std::vector<std::set<Id>> result;
+    for (Id id = 1; id < pool->ss.nstrings; ++id) {
+        result.emplace_back();
+        for (Id * provider = pool_whatprovides_ptr(pool, id); *provider != 0; ++provider) {
+            result.back().insert(*provider);
+        }
+    }
+    for (Id id = 1; id < pool->nrels; ++id) {
+        result.emplace_back();
+        for (Id * provider = pool_whatprovides_ptr(pool, MAKERELDEP(id)); *provider != 0; ++provider) {
+            result.back().insert(*provider);
+        }
+    }
+    for (Id id = 2; id < pool->nsolvables; ++id) {
+        Solvable * solvable = pool_id2solvable(pool, id);
+        result.emplace_back();
+        for (Id * provide = solvable->repo->idarraydata + solvable->dep_provides; *provide != 0; ++provide) {
+            result.back().insert(*provide);
+        }
+    }
+    return result;
+}
+
+
+void WhatprovidesTest::test_extend() {
+    ::Pool * pool = create_pool();
+    repo_create(pool, "@commandline");
+    auto file_deps = add_file_provides(pool);
+    pool_createwhatprovides(pool);
+    // fills the lazily computed providers of the reldeps
+    dump_provides(pool);
+
+    Id first_new_solvable = pool->nsolvables;
+    add_new_packages(pool, "liba");
+    CPPUNIT_ASSERT(extend_whatprovides(pool, first_new_solvable, file_deps));
+
+    // the extended index is the same as the index created for the whole pool
+    ::Pool * expected_pool = create_pool();
+    add_new_packages(expected_pool, "liba");
+    add_file_provides(expected_pool);
+    pool_createwhatprovides(expected_pool);
+    CPPUNIT_ASSERT(dump_provides(expected_pool) == dump_provides(pool));
+
+    pool_free(expected_pool);
+    pool_free(pool);
+}
+
+
+void WhatprovidesTest::test_extend_unknown_file_dep() {
+    ::Pool * pool = create_pool();
+    repo_create(pool, "@commandline");
+    auto file_deps = add_file_provides(pool);
+    pool_createwhatprovides(pool);
+
+    Id first_new_solvable = pool->nsolvables;
+    add_new_packages(pool, "/usr/bin/unknown");
+    Offset * whatprovides = pool->whatprovides;
+    CPPUNIT_ASSERT(!extend_whatprovides(pool, first_new_solvable, file_deps));
+
+    // nothing is changed, the whole index has to be recomputed
+    CPPUNIT_ASSERT(whatprovides == pool->whatprovides);
+    Solvable * new_solvable = pool_id2solvable(pool, first_new_solvable);
+    for (Id * provider = pool_whatprovides_ptr(pool, new_solvable->name); *provider != 0; ++provider) {
+        CPPUNIT_ASSERT(*provider < first_new_solvable);
+    }
+
+    // an index of a pool that has shrunk or was freed cannot be extended
+    CPPUNIT_ASSERT(!extend_whatprovides(pool, pool->nsolvables + 1, file_deps));
+    pool_freewhatprovides(pool);
+    CPPUNIT_ASSERT(!extend_whatprovides(pool, first_new_solvable, file_deps));
+
+    pool_free(pool);
+}
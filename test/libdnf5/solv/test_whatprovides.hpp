@@ -0,0 +1,66 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_SOLV_WHATPROVIDES_HPP
+#define LIBDNF5_TEST_SOLV_WHATPROVIDES_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+extern "C" {
+#include <solv/pool.h>
+#include <solv/repo.h>
+}
+
+#include <set>
+#include <string>
+#include <vector>
+
+
+class WhatprovidesTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(WhatprovidesTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_extend);
+    CPPUNIT_TEST(test_extend_unknown_file_dep);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_extend();
+    void test_extend_unknown_file_dep();
+
+private:
+    /// Creates a pool containing the "base" repository
+    static ::Pool * create_pool();
+
+    /// Appends the "@commandline" repository to the `pool`
+    static void add_new_packages(::Pool * pool, const char * require);
+
+    /// Adds the file provides to the `pool`, returns the sorted Ids of the file dependencies
+    static std::vector<Id> add_file_provides(::Pool * pool);
+
+    /// Returns the providers of all strings and reldeps and the provides of all solvables in the `pool`
+    static std::vector<std::set<Id>> dump_provides(::Pool * pool);
+};
+
+#endif  // LIBDNF5_TEST_SOLV_WHATPROVIDES_HPP
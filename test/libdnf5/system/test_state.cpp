@@ -229,3 +229,112 @@ module-2 = {enabled_stream="stream-2",installed_profiles=[],state="Disabled"}
     CPPUNIT_ASSERT_EQUAL(
         modules_contents_after_remove, trim(libdnf5::utils::fs::File(path / "modules.toml", "r").read()));
 }
+
+void StateTest::test_state_save_changed_files() {
+    const auto & path = temp_dir->get_path();
+    libdnf5::system::State state(path);
+
+    // the missing environments file is created
+    state.save();
+    CPPUNIT_ASSERT(std::filesystem::exists(path / "environments.toml"));
+
+    // setting the same values doesn't change the state
+    std::filesystem::remove(path / "nevras.toml");
+    std::filesystem::remove(path / "groups.toml");
+    state.set_package_from_repo("pkg-1.2-1.x86_64", "repo1");
+    state.set_rpmdb_cookie("foo");
+    state.save();
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "nevras.toml"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "system.toml.temp"));
+
+    // only the file with the changed data is rewritten
+    state.set_package_reason("pkg.x86_64", transaction::TransactionItemReason::DEPENDENCY);
+    state.save();
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "nevras.toml"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "groups.toml"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "packages.toml.temp"));
+
+    const std::string packages_contents_after_change{R"""(version = "1.0"
+[packages]
+"pkg-libs.x86_64" = {reason="Dependency"}
+"pkg.x86_64" = {reason="Dependency"}
+"unresolvable.noarch" = {reason="Dependency"}
+)"""};
+    CPPUNIT_ASSERT_EQUAL(
+        packages_contents_after_change, trim(libdnf5::utils::fs::File(path / "packages.toml", "r").read()));
+}
+
+void StateTest::test_state_snapshot() {
+    const auto & path = temp_dir->get_path();
+
+    // loading the state doesn't write the snapshots
+    libdnf5::system::State state(path);
+    CPPUNIT_ASSERT_EQUAL(std::string("repo1"), state.get_package_from_repo("pkg-1.2-1.x86_64"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "nevras.toml.snapshot"));
+
+    // the snapshot of a saved file is used by the next load
+    state.set_package_from_repo("pkg-1.2-1.x86_64", "repo3");
+    state.save();
+    CPPUNIT_ASSERT(std::filesystem::exists(path / "nevras.toml.snapshot"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "packages.toml.snapshot"));
+    libdnf5::system::State state2(path);
+    CPPUNIT_ASSERT_EQUAL(std::string("repo3"), state2.get_package_from_repo("pkg-1.2-1.x86_64"));
+    CPPUNIT_ASSERT_EQUAL(std::string("repo2"), state2.get_package_from_repo("unresolvable-1.2-1.noarch"));
+
+    // the snapshot is not used once the toml file changes
+    libdnf5::utils::fs::File(path / "nevras.toml", "w").write(R"""(version = "1.0"
+[nevras]
+"pkg-1.2-1.x86_64" = {from_repo="repo4"}
+)""");
+    libdnf5::system::State state3(path);
+    CPPUNIT_ASSERT_EQUAL(std::string("repo4"), state3.get_package_from_repo("pkg-1.2-1.x86_64"));
+    CPPUNIT_ASSERT_THROW(
+        state3.get_package_from_repo("unresolvable-1.2-1.noarch"), libdnf5::system::StateNotFoundError);
+
+    // a file of an unsupported version is reported by the load, the snapshot of another file doesn't change it
+    libdnf5::utils::fs::File(path / "groups.toml", "w").write(R"""(version = "4.0"
+[groups])""");
+    CPPUNIT_ASSERT_THROW(libdnf5::system::State(path), libdnf5::system::UnsupportedVersionError);
+}
+
+void StateTest::test_package_groups_index() {
+    libdnf5::system::State state(temp_dir->get_path());
+    CPPUNIT_ASSERT_EQUAL(std::set<std::string>({"group-1"}), state.get_package_groups("foo"));
+    CPPUNIT_ASSERT_EQUAL(transaction::TransactionItemReason::GROUP, state.get_package_reason("pkg1.x86_64"));
+
+    // the index follows the changes of the groups
+    state.set_group_state(
+        "group-3", {.packages = {"foo", "baz"}, .package_types = libdnf5::comps::PackageType::MANDATORY});
+    state.set_group_state("group-2", {.packages = {"pkg1"}, .package_types = libdnf5::comps::PackageType::MANDATORY});
+    CPPUNIT_ASSERT_EQUAL(std::set<std::string>({"group-1", "group-3"}), state.get_package_groups("foo"));
+    CPPUNIT_ASSERT_EQUAL(std::set<std::string>({"group-3"}), state.get_package_groups("baz"));
+    CPPUNIT_ASSERT(state.get_package_groups("pkg2").empty());
+    CPPUNIT_ASSERT_EQUAL(transaction::TransactionItemReason::NONE, state.get_package_reason("pkg2.x86_64"));
+
+    state.remove_group_state("group-1");
+    state.remove_group_state("group-2");
+    CPPUNIT_ASSERT_EQUAL(std::set<std::string>({"group-3"}), state.get_package_groups("foo"));
+    CPPUNIT_ASSERT_EQUAL(transaction::TransactionItemReason::NONE, state.get_package_reason("pkg1.x86_64"));
+    CPPUNIT_ASSERT_EQUAL(
+        std::set<std::string>({"baz", "foo"}),
+        state.get_packages_by_reason({transaction::TransactionItemReason::GROUP}));
+}
+
+void StateTest::test_running_kernel_nevra() {
+    const auto & path = temp_dir->get_path();
+    libdnf5::system::State state(path);
+    CPPUNIT_ASSERT_EQUAL(std::string(), state.get_running_kernel_nevra("6.1.0", "cookie"));
+
+    // the record is written immediately, the other state files are not touched
+    std::filesystem::remove(path / "system.toml");
+    state.set_running_kernel_nevra("6.1.0", "cookie", "kernel-core-6.1.0-1.x86_64");
+    CPPUNIT_ASSERT(std::filesystem::exists(path / "running_kernel.toml"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(path / "system.toml"));
+
+    // the record is valid only for the same kernel release and installed packages
+    libdnf5::system::State state2(path);
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("kernel-core-6.1.0-1.x86_64"), state2.get_running_kernel_nevra("6.1.0", "cookie"));
+    CPPUNIT_ASSERT_EQUAL(std::string(), state2.get_running_kernel_nevra("6.2.0", "cookie"));
+    CPPUNIT_ASSERT_EQUAL(std::string(), state2.get_running_kernel_nevra("6.1.0", "other-cookie"));
+}
@@ -37,6 +37,10 @@ class StateTest : public BaseTestCase {
     CPPUNIT_TEST(test_state_version);
     CPPUNIT_TEST(test_state_read);
     CPPUNIT_TEST(test_state_write);
+    CPPUNIT_TEST(test_state_save_changed_files);
+    CPPUNIT_TEST(test_state_snapshot);
+    CPPUNIT_TEST(test_package_groups_index);
+    CPPUNIT_TEST(test_running_kernel_nevra);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -46,6 +50,10 @@ public:
     void test_state_version();
     void test_state_read();
     void test_state_write();
+    void test_state_save_changed_files();
+    void test_state_snapshot();
+    void test_package_groups_index();
+    void test_running_kernel_nevra();
 
     std::unique_ptr<libdnf5::utils::fs::TempDir> temp_dir;
 };
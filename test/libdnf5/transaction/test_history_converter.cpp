@@ -0,0 +1,214 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_history_converter.hpp"
+
+#include "../shared/private_accessor.hpp"
+#include "../shared/utils.hpp"
+#include "transaction/db/db.hpp"
+#include "utils/dnf4convert/history_converter.hpp"
+#include "utils/sqlite3/sqlite3.hpp"
+
+#include <libdnf5/transaction/transaction.hpp>
+
+#include <string>
+
+
+using namespace libdnf5::transaction;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HistoryConverterTest);
+
+namespace {
+
+// Allows accessing private methods
+create_private_getter_template;
+create_getter(start, &libdnf5::transaction::Transaction::start);
+create_getter(finish, &libdnf5::transaction::Transaction::finish);
+create_getter(new_transaction, &libdnf5::transaction::TransactionHistory::new_transaction);
+
+// Part of the dnf4 history database schema read by the converter
+constexpr const char * DNF4_HISTORY_DB = R"**(
+    CREATE TABLE trans (
+        id INTEGER PRIMARY KEY,
+        dt_begin INTEGER NOT NULL,
+        dt_end INTEGER,
+        rpmdb_version_begin TEXT,
+        rpmdb_version_end TEXT,
+        releasever TEXT NOT NULL,
+        user_id INTEGER NOT NULL,
+        cmdline TEXT,
+        state INTEGER NOT NULL,
+        comment TEXT
+    );
+    CREATE TABLE repo (
+        id INTEGER PRIMARY KEY,
+        repoid TEXT NOT NULL
+    );
+    CREATE TABLE item (
+        id INTEGER PRIMARY KEY,
+        item_type INTEGER NOT NULL
+    );
+    CREATE TABLE trans_item (
+        id INTEGER PRIMARY KEY,
+        trans_id INTEGER REFERENCES trans(id),
+        item_id INTEGER REFERENCES item(id),
+        repo_id INTEGER REFERENCES repo(id),
+        action INTEGER NOT NULL,
+        reason INTEGER NOT NULL,
+        state INTEGER NOT NULL
+    );
+    CREATE TABLE rpm (
+        item_id INTEGER UNIQUE NOT NULL,
+        name TEXT NOT NULL,
+        epoch INTEGER NOT NULL,
+        version TEXT NOT NULL,
+        release TEXT NOT NULL,
+        arch TEXT NOT NULL,
+        FOREIGN KEY(item_id) REFERENCES item(id)
+    );
+    CREATE TABLE console_output (
+        id INTEGER PRIMARY KEY,
+        trans_id INTEGER REFERENCES trans(id),
+        file_descriptor INTEGER NOT NULL,
+        line TEXT NOT NULL
+    );
+
+    INSERT INTO trans VALUES
+        (2, 100, 110, 'v1', 'v2', '40', 1000, 'dnf install foo', 1, ''),
+        (5, 200, 210, 'v2', 'v3', '40', 1000, 'dnf upgrade foo', 1, ''),
+        (7, 300, 310, 'v3', 'v3', '40', 0, 'dnf remove bar', 2, 'failed');
+    INSERT INTO repo VALUES (1, 'fedora'), (2, 'updates'), (3, '@System');
+    INSERT INTO item VALUES (1, 1), (2, 1), (3, 1);
+    INSERT INTO rpm VALUES
+        (1, 'foo', 0, '1.0', '1.fc40', 'x86_64'),
+        (2, 'foo', 0, '1.1', '1.fc40', 'x86_64'),
+        (3, 'bar', 1, '2.0', '3.fc40', 'noarch');
+    INSERT INTO trans_item VALUES
+        (1, 2, 1, 1, 1, 4, 1),
+        (2, 5, 2, 2, 6, 4, 1),
+        (3, 5, 1, 1, 7, 4, 1),
+        (4, 7, 3, 3, 8, 2, 2);
+    INSERT INTO console_output VALUES
+        (1, 2, 1, 'installing foo'),
+        (2, 7, 2, 'removing bar failed');
+)**";
+
+}  //namespace
+
+
+void HistoryConverterTest::test_convert() {
+    auto base = new_base();
+    auto dnf4_db_path = temp_dir->get_path() / "history.sqlite";
+    libdnf5::utils::SQLite3(dnf4_db_path.string()).exec(DNF4_HISTORY_DB);
+
+    // convert one transaction per chunk to go through the checkpoints
+    libdnf5::dnf4convert::HistoryConverter converter(
+        dnf4_db_path, transaction_db_get_path(*base), transaction_db_get_open_options(*base));
+    CPPUNIT_ASSERT(converter.convert(1));
+
+    auto base2 = new_base();
+    auto ts_list = base2->get_transaction_history()->list_transactions({2, 5, 7});
+    CPPUNIT_ASSERT_EQUAL((size_t)3, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, base2->get_transaction_history()->list_all_transactions().size());
+
+    auto & install = ts_list[0];
+    CPPUNIT_ASSERT_EQUAL((int64_t)2, install.get_id());
+    CPPUNIT_ASSERT_EQUAL(std::string("dnf install foo"), install.get_description());
+    CPPUNIT_ASSERT_EQUAL(TransactionState::OK, install.get_state());
+    CPPUNIT_ASSERT_EQUAL((size_t)1, install.get_packages().size());
+    auto & foo = install.get_packages()[0];
+    CPPUNIT_ASSERT_EQUAL(std::string("foo-0:1.0-1.fc40.x86_64"), foo.to_string());
+    CPPUNIT_ASSERT_EQUAL(std::string("fedora"), foo.get_repoid());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemAction::INSTALL, foo.get_action());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemReason::USER, foo.get_reason());
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>({"installing foo"}), install.get_console_output());
+
+    auto & upgrade = ts_list[1];
+    CPPUNIT_ASSERT_EQUAL((int64_t)5, upgrade.get_id());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, upgrade.get_packages().size());
+    for (auto & pkg : upgrade.get_packages()) {
+        if (pkg.get_action() == TransactionItemAction::UPGRADE) {
+            CPPUNIT_ASSERT_EQUAL(std::string("foo-0:1.1-1.fc40.x86_64"), pkg.to_string());
+            CPPUNIT_ASSERT_EQUAL(std::string("updates"), pkg.get_repoid());
+        } else {
+            CPPUNIT_ASSERT_EQUAL(TransactionItemAction::REPLACED, pkg.get_action());
+            CPPUNIT_ASSERT_EQUAL(std::string("foo-0:1.0-1.fc40.x86_64"), pkg.to_string());
+        }
+    }
+
+    auto & remove = ts_list[2];
+    CPPUNIT_ASSERT_EQUAL((int64_t)7, remove.get_id());
+    CPPUNIT_ASSERT_EQUAL(TransactionState::ERROR, remove.get_state());
+    CPPUNIT_ASSERT_EQUAL(std::string("failed"), remove.get_comment());
+    CPPUNIT_ASSERT_EQUAL((size_t)1, remove.get_packages().size());
+    CPPUNIT_ASSERT_EQUAL(std::string("bar-1:2.0-3.fc40.noarch"), remove.get_packages()[0].to_string());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemAction::REMOVE, remove.get_packages()[0].get_action());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemReason::DEPENDENCY, remove.get_packages()[0].get_reason());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemState::ERROR, remove.get_packages()[0].get_state());
+
+    // a finished conversion is not repeated
+    CPPUNIT_ASSERT(converter.convert());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, new_base()->get_transaction_history()->list_all_transactions().size());
+
+    // the new transactions get ids greater than the converted ones
+    auto trans = (*(base2->get_transaction_history()).*get(new_transaction{}))();
+    (trans.*get(start{}))();
+    (trans.*get(finish{}))(TransactionState::OK);
+    CPPUNIT_ASSERT_EQUAL((int64_t)8, trans.get_id());
+}
+
+
+void HistoryConverterTest::test_convert_skips_used_history() {
+    auto base = new_base();
+    auto dnf4_db_path = temp_dir->get_path() / "history.sqlite";
+    libdnf5::utils::SQLite3(dnf4_db_path.string()).exec(DNF4_HISTORY_DB);
+
+    auto trans = (*(base->get_transaction_history()).*get(new_transaction{}))();
+    (trans.*get(start{}))();
+    (trans.*get(finish{}))(TransactionState::OK);
+
+    libdnf5::dnf4convert::HistoryConverter converter(
+        dnf4_db_path, transaction_db_get_path(*base), transaction_db_get_open_options(*base));
+    CPPUNIT_ASSERT(converter.convert());
+
+    auto ts_list = new_base()->get_transaction_history()->list_all_transactions();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL(trans.get_id(), ts_list[0].get_id());
+}
+
+
+void HistoryConverterTest::test_convert_finished_does_not_lock() {
+    auto base = new_base();
+    auto dnf4_db_path = temp_dir->get_path() / "history.sqlite";
+    libdnf5::utils::SQLite3(dnf4_db_path.string()).exec(DNF4_HISTORY_DB);
+
+    libdnf5::dnf4convert::HistoryConverter converter(
+        dnf4_db_path, transaction_db_get_path(*base), transaction_db_get_open_options(*base));
+    CPPUNIT_ASSERT(converter.convert());
+
+    // another process holds the write lock, a finished conversion returns without waiting for it
+    libdnf5::utils::SQLite3 conn(transaction_db_get_path(*base).native(), transaction_db_get_open_options(*base));
+    conn.exec("BEGIN IMMEDIATE");
+    CPPUNIT_ASSERT(converter.convert());
+    conn.exec("ROLLBACK");
+
+    CPPUNIT_ASSERT_EQUAL((size_t)3, new_base()->get_transaction_history()->list_all_transactions().size());
+}
@@ -0,0 +1,45 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_TRANSACTION_TEST_HISTORY_CONVERTER_HPP
+#define TEST_LIBDNF5_TRANSACTION_TEST_HISTORY_CONVERTER_HPP
+
+
+#include "transaction_test_base.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class HistoryConverterTest : public TransactionTestBase {
+    CPPUNIT_TEST_SUITE(HistoryConverterTest);
+    CPPUNIT_TEST(test_convert);
+    CPPUNIT_TEST(test_convert_skips_used_history);
+    CPPUNIT_TEST(test_convert_finished_does_not_lock);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_convert();
+    void test_convert_skips_used_history();
+    void test_convert_finished_does_not_lock();
+};
+
+
+#endif  // TEST_LIBDNF5_TRANSACTION_TEST_HISTORY_CONVERTER_HPP
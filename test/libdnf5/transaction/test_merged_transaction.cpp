@@ -0,0 +1,205 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_merged_transaction.hpp"
+
+#include "../shared/private_accessor.hpp"
+#include "../shared/utils.hpp"
+#include "transaction/MergedTransaction.hpp"
+
+#include <libdnf5/transaction/transaction.hpp>
+
+#include <string>
+
+
+using namespace libdnf5::transaction;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MergedTransactionTest);
+
+namespace {
+
+// Allows accessing private methods
+create_private_getter_template;
+create_getter(new_package, &libdnf5::transaction::Transaction::new_package);
+create_getter(set_id, &libdnf5::transaction::Transaction::set_id);
+create_getter(new_transaction, &libdnf5::transaction::TransactionHistory::new_transaction);
+
+create_getter(set_name, &libdnf5::transaction::Package::set_name);
+create_getter(set_epoch, &libdnf5::transaction::Package::set_epoch);
+create_getter(set_version, &libdnf5::transaction::Package::set_version);
+create_getter(set_release, &libdnf5::transaction::Package::set_release);
+create_getter(set_arch, &libdnf5::transaction::Package::set_arch);
+create_getter(set_action, &libdnf5::transaction::Package::set_action);
+create_getter(set_reason, &libdnf5::transaction::Package::set_reason);
+
+Transaction new_trans(libdnf5::Base & base, int64_t id) {
+    auto trans = (*(base.get_transaction_history()).*get(new_transaction{}))();
+    (trans.*get(set_id{}))(id);
+    return trans;
+}
+
+void add_package(
+    Transaction & trans,
+    const std::string & name,
+    const std::string & version,
+    TransactionItemAction action,
+    TransactionItemReason reason = TransactionItemReason::USER) {
+    auto & pkg = (trans.*get(new_package{}))();
+    (pkg.*get(set_name{}))(name);
+    (pkg.*get(set_epoch{}))("0");
+    (pkg.*get(set_version{}))(version);
+    (pkg.*get(set_release{}))("1");
+    (pkg.*get(set_arch{}))("x86_64");
+    (pkg.*get(set_action{}))(action);
+    (pkg.*get(set_reason{}))(reason);
+}
+
+// Returns the merged packages as "<action> <nevra>" strings
+std::vector<std::string> to_strings(const std::vector<MergedPackage> & packages) {
+    std::vector<std::string> result;
+    for (const auto & pkg : packages) {
+        result.push_back(transaction_item_action_to_string(pkg.action) + " " + pkg.package->to_string());
+    }
+    return result;
+}
+
+}  //namespace
+
+
+void MergedTransactionTest::test_install_remove() {
+    auto base = new_base();
+    auto trans1 = new_trans(*base, 1);
+    add_package(trans1, "foo", "1.0", TransactionItemAction::INSTALL);
+    auto trans2 = new_trans(*base, 2);
+    add_package(trans2, "foo", "1.0", TransactionItemAction::REMOVE);
+
+    MergedTransaction merged(trans1);
+    merged.merge(trans2);
+    CPPUNIT_ASSERT(merged.get_packages().empty());
+}
+
+
+void MergedTransactionTest::test_install_upgrade() {
+    auto base = new_base();
+    auto trans1 = new_trans(*base, 1);
+    add_package(trans1, "foo", "1.0", TransactionItemAction::INSTALL);
+    auto trans2 = new_trans(*base, 2);
+    add_package(trans2, "foo", "2.0", TransactionItemAction::UPGRADE);
+    add_package(trans2, "foo", "1.0", TransactionItemAction::REPLACED);
+
+    MergedTransaction merged(trans1);
+    merged.merge(trans2);
+    std::vector<std::string> expected{"Install foo-0:2.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(merged.get_packages()));
+}
+
+
+void MergedTransactionTest::test_remove_install() {
+    auto base = new_base();
+    auto trans1 = new_trans(*base, 1);
+    add_package(trans1, "foo", "1.0", TransactionItemAction::REMOVE);
+    add_package(trans1, "bar", "2.0", TransactionItemAction::REMOVE);
+    auto trans2 = new_trans(*base, 2);
+    add_package(trans2, "foo", "1.0", TransactionItemAction::INSTALL);
+    add_package(trans2, "bar", "1.0", TransactionItemAction::INSTALL);
+
+    // the transactions are merged in the order of their ids
+    MergedTransaction merged(trans2);
+    merged.merge(trans1);
+    CPPUNIT_ASSERT_EQUAL((std::vector<int64_t>{1, 2}), merged.list_ids());
+    std::vector<std::string> expected{
+        "Reinstall foo-0:1.0-1.x86_64", "Downgrade bar-0:1.0-1.x86_64", "Replaced bar-0:2.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(merged.get_packages()));
+}
+
+
+void MergedTransactionTest::test_upgrade_upgrade() {
+    auto base = new_base();
+    auto trans1 = new_trans(*base, 1);
+    add_package(trans1, "foo", "2.0", TransactionItemAction::UPGRADE);
+    add_package(trans1, "foo", "1.0", TransactionItemAction::REPLACED);
+    auto trans2 = new_trans(*base, 2);
+    add_package(trans2, "foo", "3.0", TransactionItemAction::UPGRADE);
+    add_package(trans2, "foo", "2.0", TransactionItemAction::REPLACED);
+
+    MergedTransaction merged(trans1);
+    merged.merge(trans2);
+    std::vector<std::string> expected{"Upgrade foo-0:3.0-1.x86_64", "Replaced foo-0:1.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(merged.get_packages()));
+
+    // downgrading back to the original version is a reinstall
+    auto trans3 = new_trans(*base, 3);
+    add_package(trans3, "foo", "1.0", TransactionItemAction::DOWNGRADE);
+    add_package(trans3, "foo", "3.0", TransactionItemAction::REPLACED);
+    merged.merge(trans3);
+    expected = {"Reinstall foo-0:1.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(merged.get_packages()));
+}
+
+
+void MergedTransactionTest::test_reason_change() {
+    auto base = new_base();
+    auto trans1 = new_trans(*base, 1);
+    add_package(trans1, "foo", "1.0", TransactionItemAction::INSTALL, TransactionItemReason::DEPENDENCY);
+    add_package(trans1, "bar", "1.0", TransactionItemAction::REASON_CHANGE, TransactionItemReason::DEPENDENCY);
+    auto trans2 = new_trans(*base, 2);
+    add_package(trans2, "foo", "1.0", TransactionItemAction::REASON_CHANGE, TransactionItemReason::USER);
+    add_package(trans2, "bar", "1.0", TransactionItemAction::REASON_CHANGE, TransactionItemReason::USER);
+
+    MergedTransaction merged(trans1);
+    merged.merge(trans2);
+    auto packages = merged.get_packages();
+    std::vector<std::string> expected{"Install foo-0:1.0-1.x86_64", "Reason Change bar-0:1.0-1.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_strings(packages));
+    CPPUNIT_ASSERT_EQUAL(TransactionItemReason::USER, packages[0].reason);
+    CPPUNIT_ASSERT_EQUAL(TransactionItemReason::USER, packages[1].reason);
+}
+
+
+void MergedTransactionTest::test_merge_large() {
+    // every transaction upgrades all the packages, the merge has to stay linear in the number of items
+    constexpr int num_transactions = 1000;
+    constexpr int num_packages = 100;
+
+    auto base = new_base();
+    std::vector<Transaction> transactions;
+    transactions.reserve(num_transactions);
+    for (int i = 0; i < num_transactions; ++i) {
+        auto & trans = transactions.emplace_back(new_trans(*base, i + 1));
+        for (int j = 0; j < num_packages; ++j) {
+            auto name = "pkg_" + std::to_string(j);
+            add_package(trans, name, std::to_string(i + 1), TransactionItemAction::UPGRADE);
+            add_package(trans, name, std::to_string(i), TransactionItemAction::REPLACED);
+        }
+    }
+
+    MergedTransaction merged(transactions.back());
+    for (int i = 0; i < num_transactions - 1; ++i) {
+        merged.merge(transactions[static_cast<std::size_t>(i)]);
+    }
+
+    auto packages = merged.get_packages();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2 * num_packages), packages.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg_0-0:1000-1.x86_64"), packages[0].package->to_string());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemAction::UPGRADE, packages[0].action);
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg_0-0:0-1.x86_64"), packages[1].package->to_string());
+    CPPUNIT_ASSERT_EQUAL(TransactionItemAction::REPLACED, packages[1].action);
+}
@@ -0,0 +1,51 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_TRANSACTION_TEST_MERGED_TRANSACTION_HPP
+#define TEST_LIBDNF5_TRANSACTION_TEST_MERGED_TRANSACTION_HPP
+
+
+#include "transaction_test_base.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class MergedTransactionTest : public TransactionTestBase {
+    CPPUNIT_TEST_SUITE(MergedTransactionTest);
+    CPPUNIT_TEST(test_install_remove);
+    CPPUNIT_TEST(test_install_upgrade);
+    CPPUNIT_TEST(test_remove_install);
+    CPPUNIT_TEST(test_upgrade_upgrade);
+    CPPUNIT_TEST(test_reason_change);
+    CPPUNIT_TEST(test_merge_large);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_install_remove();
+    void test_install_upgrade();
+    void test_remove_install();
+    void test_upgrade_upgrade();
+    void test_reason_change();
+    void test_merge_large();
+};
+
+
+#endif  // TEST_LIBDNF5_TRANSACTION_TEST_MERGED_TRANSACTION_HPP
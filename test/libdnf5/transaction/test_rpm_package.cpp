@@ -25,8 +25,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf5/common/sack/query_cmp.hpp>
 #include <libdnf5/transaction/rpm_package.hpp>
 #include <libdnf5/transaction/transaction.hpp>
+#include <libdnf5/transaction/transaction_history.hpp>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 
 using namespace libdnf5::transaction;
@@ -52,6 +55,7 @@ create_getter(set_repoid, &libdnf5::transaction::Package::set_repoid);
 create_getter(set_action, &libdnf5::transaction::Package::set_action);
 create_getter(set_reason, &libdnf5::transaction::Package::set_reason);
 create_getter(set_state, &libdnf5::transaction::Package::set_state);
+create_getter(get_item_id, &libdnf5::transaction::TransactionItem::get_item_id);
 
 }  //namespace
 
@@ -110,3 +114,148 @@ void TransactionRpmPackageTest::test_save_load() {
         pkg2_num++;
     }
 }
+
+
+void TransactionRpmPackageTest::test_save_load_large() {
+    // enough packages to split the lookup of the existing records into several chunks
+    constexpr std::size_t num = 2000;
+
+    auto base = new_base();
+
+    std::vector<int64_t> item_ids;
+    for (int round = 0; round < 2; ++round) {
+        auto trans = (*(base->get_transaction_history()).*get(new_transaction{}))();
+        for (std::size_t i = 0; i < num; i++) {
+            auto & pkg = (trans.*get(new_package{}))();
+            // every tenth package has the same name as the previous one and differs only in the arch
+            (pkg.*get(set_name{}))("name_" + std::to_string(i - (i % 10 == 1 ? 1 : 0)));
+            (pkg.*get(set_epoch{}))("0");
+            (pkg.*get(set_version{}))("1.0");
+            (pkg.*get(set_release{}))("1");
+            (pkg.*get(set_arch{}))(i % 10 == 1 ? "noarch" : "x86_64");
+            (pkg.*get(set_repoid{}))("repoid_" + std::to_string(i % 3));
+            (pkg.*get(set_action{}))(TransactionItemAction::INSTALL);
+            (pkg.*get(set_reason{}))(TransactionItemReason::USER);
+            (pkg.*get(set_state{}))(TransactionItemState::OK);
+        }
+        (trans.*get(start{}))();
+        (trans.*get(finish{}))(TransactionState::OK);
+
+        // the second transaction reuses the 'rpm' records created by the first one
+        if (round == 0) {
+            for (auto & pkg : trans.get_packages()) {
+                item_ids.push_back((pkg.*get(get_item_id{}))());
+            }
+            std::sort(item_ids.begin(), item_ids.end());
+            CPPUNIT_ASSERT(std::adjacent_find(item_ids.begin(), item_ids.end()) == item_ids.end());
+        } else {
+            std::vector<int64_t> reused_item_ids;
+            for (auto & pkg : trans.get_packages()) {
+                reused_item_ids.push_back((pkg.*get(get_item_id{}))());
+            }
+            std::sort(reused_item_ids.begin(), reused_item_ids.end());
+            CPPUNIT_ASSERT(item_ids == reused_item_ids);
+        }
+    }
+
+    // create a new Base to force reading the transactions from disk
+    auto base2 = new_base();
+    auto ts_list = base2->get_transaction_history()->list_all_transactions();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, ts_list.size());
+    for (auto & trans2 : ts_list) {
+        auto & packages = trans2.get_packages();
+        CPPUNIT_ASSERT_EQUAL(num, packages.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("name_0"), packages[1].get_name());
+        CPPUNIT_ASSERT_EQUAL(std::string("noarch"), packages[1].get_arch());
+        CPPUNIT_ASSERT_EQUAL(std::string("repoid_1"), packages[1].get_repoid());
+        CPPUNIT_ASSERT_EQUAL(std::string("name_1999"), packages[num - 1].get_name());
+        CPPUNIT_ASSERT_EQUAL(std::string("x86_64"), packages[num - 1].get_arch());
+    }
+}
+
+
+void TransactionRpmPackageTest::test_load_transaction_items() {
+    auto base = new_base();
+
+    // the transaction i has i packages
+    std::vector<int64_t> ids;
+    for (std::size_t i = 0; i < 4; ++i) {
+        auto trans = (*(base->get_transaction_history()).*get(new_transaction{}))();
+        for (std::size_t j = 0; j < i; ++j) {
+            auto & pkg = (trans.*get(new_package{}))();
+            (pkg.*get(set_name{}))("name_" + std::to_string(i) + "_" + std::to_string(j));
+            (pkg.*get(set_epoch{}))("0");
+            (pkg.*get(set_version{}))("1");
+            (pkg.*get(set_release{}))("2");
+            (pkg.*get(set_arch{}))("noarch");
+            (pkg.*get(set_repoid{}))("repoid");
+            (pkg.*get(set_action{}))(TransactionItemAction::INSTALL);
+            (pkg.*get(set_reason{}))(TransactionItemReason::USER);
+            (pkg.*get(set_state{}))(TransactionItemState::OK);
+        }
+        (trans.*get(start{}))();
+        (trans.*get(finish{}))(TransactionState::OK);
+        ids.push_back(trans.get_id());
+    }
+
+    auto base2 = new_base();
+    auto history = base2->get_transaction_history();
+    auto ts_list = history->list_transactions(ids);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, ts_list.size());
+    history->load_transaction_items(ts_list);
+
+    for (auto & trans : ts_list) {
+        auto idx = static_cast<std::size_t>(std::find(ids.begin(), ids.end(), trans.get_id()) - ids.begin());
+        auto & packages = trans.get_packages();
+        CPPUNIT_ASSERT_EQUAL(idx, packages.size());
+        for (std::size_t j = 0; j < packages.size(); ++j) {
+            CPPUNIT_ASSERT_EQUAL("name_" + std::to_string(idx) + "_" + std::to_string(j), packages[j].get_name());
+            CPPUNIT_ASSERT_EQUAL(trans.get_id(), packages[j].get_transaction().get_id());
+        }
+        CPPUNIT_ASSERT(trans.get_comps_groups().empty());
+        CPPUNIT_ASSERT(trans.get_comps_environments().empty());
+    }
+}
+
+
+void TransactionRpmPackageTest::test_select_filter_package_name() {
+    auto base = new_base();
+
+    std::vector<int64_t> ids;
+    for (const auto & names : std::vector<std::vector<std::string>>{{"foo", "bar"}, {"bar"}, {"foo"}, {"baz"}}) {
+        auto trans = (*(base->get_transaction_history()).*get(new_transaction{}))();
+        for (const auto & name : names) {
+            auto & pkg = (trans.*get(new_package{}))();
+            (pkg.*get(set_name{}))(name);
+            (pkg.*get(set_epoch{}))("0");
+            (pkg.*get(set_version{}))("1.0");
+            (pkg.*get(set_release{}))("1");
+            (pkg.*get(set_arch{}))("x86_64");
+            (pkg.*get(set_repoid{}))("repoid");
+            (pkg.*get(set_action{}))(TransactionItemAction::INSTALL);
+            (pkg.*get(set_reason{}))(TransactionItemReason::USER);
+            (pkg.*get(set_state{}))(TransactionItemState::OK);
+        }
+        (trans.*get(start{}))();
+        (trans.*get(finish{}))(TransactionState::OK);
+        ids.push_back(trans.get_id());
+    }
+
+    auto & history = *base->get_transaction_history();
+    TransactionListFilter filter;
+    filter.package_name = "foo";
+    auto ts_list = history.list_filtered_transactions(filter);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL(ids[0], ts_list[0].get_id());
+    CPPUNIT_ASSERT_EQUAL(ids[2], ts_list[1].get_id());
+
+    filter.package_name = "bar";
+    filter.limit = 1;
+    ts_list = history.list_filtered_transactions(filter);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL(ids[0], ts_list[0].get_id());
+    CPPUNIT_ASSERT_EQUAL((int64_t)2, history.count_filtered_transactions(filter));
+
+    filter.package_name = "unknown";
+    CPPUNIT_ASSERT_EQUAL((int64_t)0, history.count_filtered_transactions(filter));
+}
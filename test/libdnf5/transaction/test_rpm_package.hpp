@@ -31,10 +31,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class TransactionRpmPackageTest : public TransactionTestBase {
     CPPUNIT_TEST_SUITE(TransactionRpmPackageTest);
     CPPUNIT_TEST(test_save_load);
+    CPPUNIT_TEST(test_save_load_large);
+    CPPUNIT_TEST(test_select_filter_package_name);
+    CPPUNIT_TEST(test_load_transaction_items);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_save_load();
+    void test_save_load_large();
+    void test_select_filter_package_name();
+    void test_load_transaction_items();
 };
 
 
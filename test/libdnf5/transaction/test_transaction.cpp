@@ -23,8 +23,11 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "../shared/private_accessor.hpp"
 
 #include <libdnf5/transaction/transaction.hpp>
+#include <libdnf5/transaction/transaction_history.hpp>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 
 using namespace libdnf5::transaction;
@@ -47,6 +50,8 @@ create_getter(set_state, &libdnf5::transaction::Transaction::set_state);
 create_getter(set_id, &libdnf5::transaction::Transaction::set_id);
 create_getter(start, &libdnf5::transaction::Transaction::start);
 create_getter(finish, &libdnf5::transaction::Transaction::finish);
+create_getter(set_timings, &libdnf5::transaction::Transaction::set_timings);
+create_getter(set_console_output, &libdnf5::transaction::Transaction::set_console_output);
 create_getter(new_transaction, &libdnf5::transaction::TransactionHistory::new_transaction);
 
 }  //namespace
@@ -92,6 +97,86 @@ void TransactionTest::test_save_load() {
 }
 
 
+void TransactionTest::test_save_load_timings() {
+    auto base = new_base();
+
+    auto trans = create_transaction(*base, 1);
+    (trans.*get(start{}))();
+    std::vector<TransactionTiming> timings;
+    timings.emplace_back(TransactionTimingStep::INSTALL, "foo-0:1.0-1.noarch", "", 1500);
+    timings.emplace_back(TransactionTimingStep::SCRIPTLET, "foo-0:1.0-1.noarch", "post-install", 2500000);
+    timings.emplace_back(TransactionTimingStep::TRANSACTION, "", "", 3000000);
+    (trans.*get(set_timings{}))(std::move(timings));
+    (trans.*get(finish{}))(TransactionState::OK);
+
+    // load the saved transaction from database and compare the timings
+    auto base2 = new_base();
+    auto ts_list = base2->get_transaction_history()->list_transactions({trans.get_id()});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+
+    auto & timings2 = ts_list[0].get_timings();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, timings2.size());
+    CPPUNIT_ASSERT_EQUAL(TransactionTimingStep::INSTALL, timings2[0].get_step());
+    CPPUNIT_ASSERT_EQUAL(std::string("foo-0:1.0-1.noarch"), timings2[0].get_nevra());
+    CPPUNIT_ASSERT_EQUAL(std::string(), timings2[0].get_scriptlet());
+    CPPUNIT_ASSERT_EQUAL((int64_t)1500, timings2[0].get_duration_us());
+    CPPUNIT_ASSERT_EQUAL(TransactionTimingStep::SCRIPTLET, timings2[1].get_step());
+    CPPUNIT_ASSERT_EQUAL(std::string("post-install"), timings2[1].get_scriptlet());
+    CPPUNIT_ASSERT_EQUAL((int64_t)2500000, timings2[1].get_duration_us());
+    CPPUNIT_ASSERT_EQUAL(TransactionTimingStep::TRANSACTION, timings2[2].get_step());
+    CPPUNIT_ASSERT_EQUAL(std::string(), timings2[2].get_nevra());
+
+    // a transaction finished without timings has none
+    auto trans3 = create_transaction(*base, 2);
+    (trans3.*get(start{}))();
+    (trans3.*get(finish{}))(TransactionState::OK);
+    ts_list = base2->get_transaction_history()->list_transactions({trans3.get_id()});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+    CPPUNIT_ASSERT(ts_list[0].get_timings().empty());
+}
+
+
+void TransactionTest::test_save_load_console_output() {
+    auto base = new_base();
+
+    auto trans = create_transaction(*base, 1);
+    (trans.*get(start{}))();
+    (trans.*get(set_console_output{}))("first line\n\nthird line\nunterminated line");
+    (trans.*get(finish{}))(TransactionState::OK);
+
+    // load the saved transaction from database and compare the output lines
+    auto base2 = new_base();
+    auto ts_list = base2->get_transaction_history()->list_transactions({trans.get_id()});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+
+    std::vector<std::string> expected{"first line", "", "third line", "unterminated line"};
+    CPPUNIT_ASSERT(expected == ts_list[0].get_console_output());
+}
+
+
+void TransactionTest::test_save_load_console_output_chunks() {
+    auto base = new_base();
+
+    // the output is larger than one compressed chunk
+    std::vector<std::string> expected;
+    std::string output;
+    for (int i = 0; i < 50000; ++i) {
+        expected.emplace_back("scriptlet output line " + std::to_string(i));
+        output += expected.back() + "\n";
+    }
+
+    auto trans = create_transaction(*base, 1);
+    (trans.*get(start{}))();
+    (trans.*get(set_console_output{}))(std::move(output));
+    (trans.*get(finish{}))(TransactionState::OK);
+
+    auto base2 = new_base();
+    auto ts_list = base2->get_transaction_history()->list_transactions({trans.get_id()});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+    CPPUNIT_ASSERT(expected == ts_list[0].get_console_output());
+}
+
+
 void TransactionTest::test_second_start_raises() {
     auto base = new_base();
     auto trans = (*(base->get_transaction_history()).*get(new_transaction{}))();
@@ -319,3 +404,65 @@ void TransactionTest::test_select_range() {
     CPPUNIT_ASSERT_EQUAL(trans2.get_description(), trans2_loaded.get_description());
     CPPUNIT_ASSERT_EQUAL(trans2.get_state(), trans2_loaded.get_state());
 }
+
+
+void TransactionTest::test_history_db_options() {
+    // listing an empty history creates the database even though the connection is requested read-only
+    auto base = new_base();
+    CPPUNIT_ASSERT(base->get_transaction_history()->list_all_transactions().empty());
+
+    for (const auto & journal_mode : {"delete", "wal"}) {
+        auto base_write = new_base();
+        base_write->get_config().get_history_db_journal_mode_option().set(journal_mode);
+        base_write->get_config().get_history_db_synchronous_option().set("normal");
+        auto trans = create_transaction(*base_write, 1);
+        (trans.*get(start{}))();
+        (trans.*get(finish{}))(TransactionState::OK);
+
+        // the transaction is read by a read-only connection
+        auto base_read = new_base();
+        base_read->get_config().get_history_db_journal_mode_option().set(journal_mode);
+        auto ts_list = base_read->get_transaction_history()->list_transactions({trans.get_id()});
+        CPPUNIT_ASSERT_EQUAL((size_t)1, ts_list.size());
+        CPPUNIT_ASSERT_EQUAL(trans.get_rpmdb_version_end(), ts_list[0].get_rpmdb_version_end());
+    }
+}
+
+
+void TransactionTest::test_select_filter() {
+    auto base = new_base();
+
+    std::vector<int64_t> ids;
+    for (int nr = 1; nr <= 5; ++nr) {
+        auto trans = create_transaction(*base, nr);
+        (trans.*get(start{}))();
+        (trans.*get(finish{}))(TransactionState::OK);
+        ids.push_back(trans.get_id());
+    }
+    auto & history = *base->get_transaction_history();
+
+    // the second page of two transactions from the most recent one
+    TransactionListFilter filter;
+    filter.descending = true;
+    filter.offset = 2;
+    filter.limit = 2;
+    auto ts_list = history.list_filtered_transactions(filter);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL(ids[2], ts_list[0].get_id());
+    CPPUNIT_ASSERT_EQUAL(ids[1], ts_list[1].get_id());
+    CPPUNIT_ASSERT_EQUAL((int64_t)5, history.count_filtered_transactions(filter));
+
+    // transactions started in the [21, 41] range, dt_start of the transaction nr is nr * 10 + 1
+    filter = TransactionListFilter();
+    filter.dt_begin_min = 21;
+    filter.dt_begin_max = 41;
+    ts_list = history.list_filtered_transactions(filter);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, ts_list.size());
+    CPPUNIT_ASSERT_EQUAL(ids[1], ts_list[0].get_id());
+    CPPUNIT_ASSERT_EQUAL(ids[3], ts_list[2].get_id());
+    CPPUNIT_ASSERT_EQUAL((int64_t)3, history.count_filtered_transactions(filter));
+
+    // the offset past the end
+    filter.offset = 3;
+    CPPUNIT_ASSERT(history.list_filtered_transactions(filter).empty());
+}
@@ -31,6 +31,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class TransactionTest : public TransactionTestBase {
     CPPUNIT_TEST_SUITE(TransactionTest);
     CPPUNIT_TEST(test_save_load);
+    CPPUNIT_TEST(test_save_load_timings);
+    CPPUNIT_TEST(test_save_load_console_output);
+    CPPUNIT_TEST(test_save_load_console_output_chunks);
     CPPUNIT_TEST(test_save_with_specified_id_raises);
     CPPUNIT_TEST(test_second_start_raises);
     CPPUNIT_TEST(test_update);
@@ -38,10 +41,15 @@ class TransactionTest : public TransactionTestBase {
     CPPUNIT_TEST(test_select_all);
     CPPUNIT_TEST(test_select_multiple);
     CPPUNIT_TEST(test_select_range);
+    CPPUNIT_TEST(test_history_db_options);
+    CPPUNIT_TEST(test_select_filter);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_save_load();
+    void test_save_load_timings();
+    void test_save_load_console_output();
+    void test_save_load_console_output_chunks();
     void test_save_with_specified_id_raises();
     void test_second_start_raises();
     void test_update();
@@ -49,6 +57,8 @@ public:
     void test_select_all();
     void test_select_multiple();
     void test_select_range();
+    void test_history_db_options();
+    void test_select_filter();
 };
 
 
@@ -0,0 +1,109 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_background.hpp"
+
+#include "utils/background.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+#include <libdnf5/conf/config_main.hpp>
+#include <libdnf5/conf/option.hpp>
+#include <libdnf5/logger/null_logger.hpp>
+
+#include <chrono>
+#include <optional>
+#include <sstream>
+
+
+using namespace libdnf5::utils;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UtilsBackgroundTest);
+
+
+namespace {
+
+std::optional<float> parse(const std::string & content) {
+    std::istringstream stream(content);
+    return parse_memory_pressure(stream);
+}
+
+}  // namespace
+
+
+void UtilsBackgroundTest::test_parse_memory_pressure() {
+    auto pressure = parse(
+        "some avg10=12.34 avg60=5.00 avg300=1.00 total=123456\n"
+        "full avg10=1.00 avg60=0.50 avg300=0.10 total=1234\n");
+    CPPUNIT_ASSERT(pressure);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(12.34, *pressure, 0.001);
+
+    // only the "some" line is used
+    CPPUNIT_ASSERT(!parse("full avg10=1.00 avg60=0.50 avg300=0.10 total=1234\n"));
+    // "avg100" is not "avg10"
+    CPPUNIT_ASSERT(!parse("some avg100=12.34 total=123456\n"));
+
+    CPPUNIT_ASSERT(!parse(""));
+    CPPUNIT_ASSERT(!parse("some avg10=abc avg60=5.00 avg300=1.00 total=123456\n"));
+    CPPUNIT_ASSERT(!parse("some avg10=-1.00 avg60=5.00 avg300=1.00 total=123456\n"));
+}
+
+
+void UtilsBackgroundTest::test_memory_pressure_limit() {
+    libdnf5::ConfigMain config;
+
+    // only the background mode waits for the memory pressure
+    CPPUNIT_ASSERT_EQUAL(0.0f, get_memory_pressure_limit(config));
+    config.get_background_mode_option().set(true);
+    CPPUNIT_ASSERT_EQUAL(10.0f, get_memory_pressure_limit(config));
+    config.get_background_memory_pressure_limit_option().set(25.5f);
+    CPPUNIT_ASSERT_EQUAL(25.5f, get_memory_pressure_limit(config));
+    config.get_background_memory_pressure_limit_option().set(0.0f);
+    CPPUNIT_ASSERT_EQUAL(0.0f, get_memory_pressure_limit(config));
+
+    // the limit is a percentage
+    CPPUNIT_ASSERT_THROW(
+        config.get_background_memory_pressure_limit_option().set(100.5f), libdnf5::OptionValueNotAllowedError);
+    CPPUNIT_ASSERT_THROW(
+        config.get_background_memory_pressure_limit_option().set(-1.0f), libdnf5::OptionValueNotAllowedError);
+}
+
+
+void UtilsBackgroundTest::test_wait_for_memory_pressure() {
+    fs::TempDir temp_dir("libdnf5_unittest");
+    auto pressure_path = temp_dir.get_path() / "memory";
+    fs::File(pressure_path, "w").write("some avg10=50.00 avg60=50.00 avg300=50.00 total=123456\n");
+    libdnf5::NullLogger logger;
+
+    // no wait when the pressure is below the limit, the waiting is disabled or the pressure is not available
+    auto start = std::chrono::steady_clock::now();
+    wait_for_memory_pressure(logger, 60, std::chrono::seconds(60), pressure_path);
+    wait_for_memory_pressure(logger, 0, std::chrono::seconds(60), pressure_path);
+    wait_for_memory_pressure(logger, 10, std::chrono::seconds(60), temp_dir.get_path() / "missing");
+    CPPUNIT_ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+    // the wait is limited by `max_wait`
+    start = std::chrono::steady_clock::now();
+    wait_for_memory_pressure(logger, 10, std::chrono::seconds(1), pressure_path);
+    auto waited = std::chrono::steady_clock::now() - start;
+    CPPUNIT_ASSERT(waited >= std::chrono::seconds(1));
+    CPPUNIT_ASSERT(waited < std::chrono::seconds(10));
+}
@@ -0,0 +1,45 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF5_TEST_UTILS_BACKGROUND_HPP
+#define LIBDNF5_TEST_UTILS_BACKGROUND_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class UtilsBackgroundTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(UtilsBackgroundTest);
+
+    CPPUNIT_TEST(test_parse_memory_pressure);
+    CPPUNIT_TEST(test_memory_pressure_limit);
+    CPPUNIT_TEST(test_wait_for_memory_pressure);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_parse_memory_pressure();
+    void test_memory_pressure_limit();
+    void test_wait_for_memory_pressure();
+};
+
+
+#endif  // LIBDNF5_TEST_UTILS_BACKGROUND_HPP
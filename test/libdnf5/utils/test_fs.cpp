@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_fs.hpp"
 
+#include "utils/fs/file_batch.hpp"
 #include "utils/fs/utils.hpp"
 
 #include <fcntl.h>
@@ -410,3 +411,33 @@ void UtilsFsTest::test_file_flush() {
 
     CPPUNIT_ASSERT_EQUAL(data_w, data_r);
 }
+
+
+void UtilsFsTest::test_file_batch() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_file_batch");
+    auto dir = temp_dir.get_path() / "batch";
+
+    libdnf5::utils::fs::FileBatch batch(dir);
+    batch.write("a.xml", "first a");
+    batch.write("b.xml", "b");
+    batch.write("a.xml", "a");
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, batch.flush());
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), libdnf5::utils::fs::File(dir / "a.xml", "r").read());
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), libdnf5::utils::fs::File(dir / "b.xml", "r").read());
+
+    // the schedule is cleared by flush
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, batch.flush());
+
+    // unchanged files are not rewritten
+    batch.write("a.xml", "a");
+    batch.write("b.xml", "new b");
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, batch.flush());
+    CPPUNIT_ASSERT_EQUAL(std::string("new b"), libdnf5::utils::fs::File(dir / "b.xml", "r").read());
+
+    // no temporary files are left behind
+    std::size_t files_count = 0;
+    for ([[maybe_unused]] const auto & entry : stdfs::directory_iterator(dir)) {
+        ++files_count;
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, files_count);
+}
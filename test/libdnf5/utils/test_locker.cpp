@@ -0,0 +1,73 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "test_locker.hpp"
+
+#include "utils/fs/temp.hpp"
+#include "utils/locker.hpp"
+
+#include <filesystem>
+
+
+using namespace libdnf5::utils;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UtilsLockerTest);
+
+
+void UtilsLockerTest::test_shared_locks() {
+    fs::TempDir temp_dir("libdnf5_unittest");
+    auto path = temp_dir.get_path() / "shared.lock";
+
+    Locker reader1(path, false);
+    Locker reader2(path, false);
+    CPPUNIT_ASSERT(reader1.read_lock());
+    CPPUNIT_ASSERT(reader2.read_lock());
+
+    // the locks are owned by the lockers, not by the process
+    Locker writer(path, false);
+    CPPUNIT_ASSERT(!writer.write_lock());
+
+    reader1.unlock();
+    CPPUNIT_ASSERT(!writer.write_lock());
+    reader2.unlock();
+    CPPUNIT_ASSERT(writer.write_lock());
+    CPPUNIT_ASSERT(!reader1.read_lock());
+
+    // the shared lock does not remove the lock file
+    writer.unlock();
+    CPPUNIT_ASSERT(std::filesystem::exists(path));
+}
+
+
+void UtilsLockerTest::test_exclusive_lock() {
+    fs::TempDir temp_dir("libdnf5_unittest");
+    auto path = temp_dir.get_path() / "exclusive.lock";
+
+    Locker writer(path);
+    CPPUNIT_ASSERT(writer.write_lock());
+    Locker reader(path, false);
+    CPPUNIT_ASSERT(!reader.read_lock());
+
+    writer.unlock();
+    CPPUNIT_ASSERT(!std::filesystem::exists(path));
+    CPPUNIT_ASSERT(reader.read_lock());
+}
@@ -0,0 +1,44 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef LIBDNF5_TEST_UTILS_LOCKER_HPP
+#define LIBDNF5_TEST_UTILS_LOCKER_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class UtilsLockerTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(UtilsLockerTest);
+
+    CPPUNIT_TEST(test_shared_locks);
+    CPPUNIT_TEST(test_exclusive_lock);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_shared_locks();
+    void test_exclusive_lock();
+};
+
+
+#endif  // LIBDNF5_TEST_UTILS_LOCKER_HPP
@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WeakPtrTest);
@@ -279,3 +280,62 @@ void WeakPtrTest::test_weak_ptr_is_owner() {
     CPPUNIT_ASSERT_THROW(static_cast<void>(*item4_weak_ptr->remote_data == "sack1_item1"), libdnf5::AssertionError);
     CPPUNIT_ASSERT_THROW(static_cast<void>(*item6_weak_ptr->remote_data == "sack1_item2"), libdnf5::AssertionError);
 }
+
+
+// In this test the GenerationWeakPtr instances point to data owned by Sack instance.
+void WeakPtrTest::test_generation_weak_ptr() {
+    struct Sack {
+        using DataItemWeakPtr = libdnf5::GenerationWeakPtr<std::string>;
+
+        DataItemWeakPtr add_item_with_return(std::unique_ptr<std::string> && item) {
+            auto ret = DataItemWeakPtr(item.get(), data_guard);
+            data.push_back(std::move(item));
+            return ret;
+        }
+
+        libdnf5::GenerationGuard data_guard;
+        std::vector<std::unique_ptr<std::string>> data;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Sack::DataItemWeakPtr>);
+
+    auto sack1 = std::make_unique<Sack>();
+    auto item1_weak_ptr = sack1->add_item_with_return(std::make_unique<std::string>("sack1_item1"));
+    auto item2_weak_ptr = sack1->add_item_with_return(std::make_unique<std::string>("sack1_item2"));
+    auto sack2 = std::make_unique<Sack>();
+    auto item3_weak_ptr = sack2->add_item_with_return(std::make_unique<std::string>("sack2_item1"));
+
+    CPPUNIT_ASSERT(*item1_weak_ptr.get() == "sack1_item1");
+    CPPUNIT_ASSERT(item2_weak_ptr->compare("sack1_item2") == 0);
+    CPPUNIT_ASSERT(*item3_weak_ptr == "sack2_item1");
+    CPPUNIT_ASSERT_EQUAL(item1_weak_ptr.has_same_guard(item2_weak_ptr), true);
+    CPPUNIT_ASSERT_EQUAL(item1_weak_ptr.has_same_guard(item3_weak_ptr), false);
+
+    // a default constructed pointer is invalid
+    CPPUNIT_ASSERT(!Sack::DataItemWeakPtr().is_valid());
+
+    // copies share the validity of the original
+    auto item4_weak_ptr(item3_weak_ptr);
+    CPPUNIT_ASSERT(item4_weak_ptr == item3_weak_ptr);
+    CPPUNIT_ASSERT(item4_weak_ptr.is_valid());
+
+    // delete sack2, the slot of its guard is reused by a new guard, but the old pointers stay invalid
+    sack2.reset();
+    CPPUNIT_ASSERT(item1_weak_ptr.is_valid());
+    CPPUNIT_ASSERT(!item3_weak_ptr.is_valid());
+    CPPUNIT_ASSERT(!item4_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_THROW(static_cast<void>(*item3_weak_ptr.get() == "sack2_item1"), libdnf5::AssertionError);
+    auto sack3 = std::make_unique<Sack>();
+    auto item5_weak_ptr = sack3->add_item_with_return(std::make_unique<std::string>("sack3_item1"));
+    CPPUNIT_ASSERT(item5_weak_ptr.is_valid());
+    CPPUNIT_ASSERT(!item3_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_EQUAL(item5_weak_ptr.has_same_guard(item3_weak_ptr), false);
+
+    // test GenerationGuard::clear(), it invalidates the existing pointers only
+    sack1->data_guard.clear();
+    CPPUNIT_ASSERT(!item1_weak_ptr.is_valid());
+    CPPUNIT_ASSERT(!item2_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_THROW(static_cast<void>(item2_weak_ptr->compare("sack1_item2") == 0), libdnf5::AssertionError);
+    auto item6_weak_ptr = sack1->add_item_with_return(std::make_unique<std::string>("sack1_item3"));
+    CPPUNIT_ASSERT(*item6_weak_ptr.get() == "sack1_item3");
+}
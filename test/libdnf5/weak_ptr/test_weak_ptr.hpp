@@ -29,6 +29,7 @@ class WeakPtrTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(WeakPtrTest);
     CPPUNIT_TEST(test_weak_ptr);
     CPPUNIT_TEST(test_weak_ptr_is_owner);
+    CPPUNIT_TEST(test_generation_weak_ptr);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +38,7 @@ public:
 
     void test_weak_ptr();
     void test_weak_ptr_is_owner();
+    void test_generation_weak_ptr();
 
 private:
 };
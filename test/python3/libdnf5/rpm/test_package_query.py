@@ -89,6 +89,25 @@ class TestPackageQuery(base_test_case.BaseTestCase):
         self.assertGreaterEqual(
             prev_id, libdnf5.rpm.PackageQuery(self.base).size())
 
+    def test_iterate_package_query_chunks(self):
+        # The packages are fetched in chunks, a small chunk size makes the query span several of them
+        query = libdnf5.rpm.PackageQuery(self.base)
+        expected_ids = []
+        it = query.begin()
+        while it != query.end():
+            expected_ids.append(it.value().get_id().id)
+            it.next()
+
+        chunk_size = libdnf5.common.ChunkedIterator.CHUNK_SIZE
+        libdnf5.common.ChunkedIterator.CHUNK_SIZE = 2
+        try:
+            self.assertEqual([pkg.get_id().id for pkg in query], expected_ids)
+        finally:
+            libdnf5.common.ChunkedIterator.CHUNK_SIZE = chunk_size
+
+        chunk = query.begin().next_chunk(query.end(), 2)
+        self.assertEqual([pkg.get_id().id for pkg in chunk], expected_ids[:2])
+
     def test_filter_name(self):
         # Test QueryCmp::EQ
         query = libdnf5.rpm.PackageQuery(self.base)
@@ -161,3 +180,28 @@ class TestPackageQuery(base_test_case.BaseTestCase):
         self.assertEqual('First change', log.text)
         self.assertEqual('Joe Black', log.author)
         self.assertEqual(1641027600, log.timestamp)
+
+    def test_get_columns(self):
+        query = libdnf5.rpm.PackageQuery(self.base)
+        columns = query.get_columns([
+            libdnf5.rpm.PackageAttribute_NAME,
+            libdnf5.rpm.PackageAttribute_EVR,
+            libdnf5.rpm.PackageAttribute_REPO_ID,
+            libdnf5.rpm.PackageAttribute_DOWNLOAD_SIZE])
+        self.assertEqual(columns.size(), query.size())
+
+        # Each call returns a whole column, the rows are ordered as the packages of the query
+        ids = columns.get_id_column()
+        names = columns.get_string_column(libdnf5.rpm.PackageAttribute_NAME)
+        evrs = columns.get_string_column(libdnf5.rpm.PackageAttribute_EVR)
+        repo_ids = columns.get_string_column(libdnf5.rpm.PackageAttribute_REPO_ID)
+        download_sizes = columns.get_number_column(libdnf5.rpm.PackageAttribute_DOWNLOAD_SIZE)
+        for row, pkg in enumerate(query):
+            self.assertEqual(ids[row], pkg.get_id().id)
+            self.assertEqual(names[row], pkg.get_name())
+            self.assertEqual(evrs[row], pkg.get_evr())
+            self.assertEqual(repo_ids[row], pkg.get_repo_id())
+            self.assertEqual(download_sizes[row], pkg.get_download_size())
+
+        # The attribute was not extracted
+        self.assertRaises(RuntimeError, columns.get_string_column, libdnf5.rpm.PackageAttribute_ARCH)
@@ -0,0 +1,82 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+
+namespace {
+
+std::atomic<std::size_t> heap_allocation_count{0};
+
+}  // namespace
+
+
+// The replaced global allocation functions count the allocations for the benchmarks. The array and nothrow
+// forms without a replacement call these.
+void * operator new(std::size_t size) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void * ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, [[maybe_unused]] std::size_t size) noexcept {
+    std::free(ptr);
+}
+
+
+std::size_t get_heap_allocation_count() noexcept {
+    return heap_allocation_count.load(std::memory_order_relaxed);
+}
+
+
+void report_benchmark(
+    const std::string & name,
+    std::size_t iterations,
+    std::chrono::nanoseconds real_time,
+    const std::map<std::string, double> & counters) {
+    auto result = fmt::format(
+        R"({{"name": "{}", "iterations": {}, "real_time": {:.0f}, "time_unit": "ns")",
+        name,
+        iterations,
+        static_cast<double>(real_time.count()) / static_cast<double>(iterations == 0 ? 1 : iterations));
+    for (const auto & [counter, value] : counters) {
+        result += fmt::format(R"(, "{}": {})", counter, value);
+    }
+    result += '}';
+
+    std::cout << result << std::endl;
+    if (const char * output_path = std::getenv("LIBDNF5_BENCHMARK_OUTPUT")) {
+        std::ofstream output(output_path, std::ofstream::app);
+        output << result << '\n';
+    }
+}
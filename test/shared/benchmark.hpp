@@ -0,0 +1,45 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF5_BENCHMARK_HPP
+#define TEST_LIBDNF5_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+
+
+/// Reports the result of the benchmark `name` that ran `iterations` times in `real_time` in total.
+/// The result is printed as a JSON line shaped like an entry of the "benchmarks" array of the Google Benchmark JSON
+/// output and appended to the file named by the LIBDNF5_BENCHMARK_OUTPUT environment variable. The `counters` are
+/// added as fields of the entry, the time of one iteration is reported.
+void report_benchmark(
+    const std::string & name,
+    std::size_t iterations,
+    std::chrono::nanoseconds real_time,
+    const std::map<std::string, double> & counters = {});
+
+/// Returns the number of the heap allocations by the global `operator new` in the process so far.
+/// Allocations by C libraries, e.g. libsolv, are not counted.
+std::size_t get_heap_allocation_count() noexcept;
+
+
+#endif  // TEST_LIBDNF5_BENCHMARK_HPP